@@ -23,6 +23,13 @@
 #include <stdarg.h>
 #include <time.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #if defined __GNUC__
 #  pragma GCC diagnostic push
 #  pragma GCC diagnostic ignored "-Wsign-conversion"
@@ -52,11 +59,15 @@
 #ifdef WIN32
 #  include <windows.h>
 #  include <io.h>
+#  include <fcntl.h>
+#  include <sys/stat.h>
 #  define strcasecmp _stricmp
 #  pragma warning (disable : 4996) // disable warnings stating that write() and fileno() (POSIX) should be replaced by _write() and _fileno() (allegedly ISO C++)
 #else
 #  include <unistd.h>
 #  include <strings.h>
+#  include <fcntl.h>
+#  include <signal.h>
 #endif
 
 #include <stdio.h>
@@ -65,6 +76,215 @@
 
 using namespace ngcommon;
 
+namespace {
+// Number of messages the async backend queues, a power of two
+const size_t kRingSize = 8192;
+// The background thread writes once this much is batched
+const size_t kBatchSize = 64 * 1024;
+const std::chrono::milliseconds kDrainInterval(20);
+
+void write_all(int fd, const char *data, size_t length)
+{
+  while (length > 0)
+  {
+#ifdef WIN32
+    int n = ::write(fd, data, static_cast<unsigned int>(length));
+#else
+    ssize_t n = ::write(fd, data, length);
+#endif
+    if (n <= 0)
+      return;
+    data += n;
+    length -= static_cast<size_t>(n);
+  }
+}
+
+#ifndef WIN32
+const int kCrashSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+struct sigaction crash_old_actions[sizeof(kCrashSignals) / sizeof(kCrashSignals[0])];
+#endif
+}
+
+/*
+ * The async backend queues the messages on a bounded lock free ring (the
+ * MPMC queue by Dmitry Vyukov), the logging threads never wait for the file.
+ * A background thread writes the queued messages in batches. If the ring is
+ * full the message is dropped and counted, the count is logged by the
+ * background thread.
+ */
+struct Logger::Async_backend
+{
+  struct Slot
+  {
+    std::atomic<size_t> sequence;
+    std::string message;
+  };
+
+  explicit Async_backend(int fd_) : fd(fd_), slots(new Slot[kRingSize]), enqueue_pos(0), dequeue_pos(0),
+    dropped(0), total_dropped(0), stopped(false)
+  {
+    for (size_t i = 0; i < kRingSize; i++)
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    thread = std::thread(&Async_backend::run, this);
+  }
+
+  // Takes the message, leaving the contents of a free slot on it
+  void push(std::string *message)
+  {
+    if (stopped.load(std::memory_order_acquire))
+    {
+      write_all(fd, message->data(), message->size());
+      return;
+    }
+
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+      slot = &slots[pos & (kRingSize - 1)];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+      {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        total_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      else
+      {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->message.swap(*message);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // The background thread wakes up anyway, this makes room sooner
+    if (pos - dequeue_pos.load(std::memory_order_relaxed) == kRingSize / 2)
+      wake.notify_one();
+  }
+
+  Slot *claim(size_t *claimed_pos)
+  {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Slot *slot = &slots[pos & (kRingSize - 1)];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          *claimed_pos = pos;
+          return slot;
+        }
+      }
+      else if (diff < 0)
+      {
+        return NULL;
+      }
+      else
+      {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Writes the queued messages, appending them to batch. Without a batch
+  // each message is written as is, nothing is allocated or locked then so
+  // it can be called from a signal handler.
+  void drain(std::string *batch)
+  {
+    // Consumers write one at a time, so the messages claimed by another
+    // consumer are written once this returns
+    std::unique_lock<std::mutex> lock(drain_mutex, std::defer_lock);
+    if (batch)
+      lock.lock();
+
+    size_t pos;
+    Slot *slot;
+    while ((slot = claim(&pos)) != NULL)
+    {
+      if (batch)
+        batch->append(slot->message);
+      else
+        write_all(fd, slot->message.data(), slot->message.size());
+      slot->sequence.store(pos + kRingSize, std::memory_order_release);
+
+      if (batch && batch->size() >= kBatchSize)
+      {
+        write_all(fd, batch->data(), batch->size());
+        batch->clear();
+      }
+    }
+
+    if (!batch)
+      return;
+
+    size_t count = dropped.exchange(0, std::memory_order_relaxed);
+    if (count > 0)
+    {
+      std::string text = Logger::format("%u log messages were dropped, the log queue was full", static_cast<unsigned int>(count));
+      batch->append(Logger::format_message_common(NULL, text.c_str(), LOG_WARNING));
+      batch->append("\n");
+    }
+
+    if (!batch->empty())
+    {
+      write_all(fd, batch->data(), batch->size());
+      batch->clear();
+    }
+  }
+
+  void run()
+  {
+    std::string batch;
+    batch.reserve(kBatchSize);
+
+    while (!stopped.load(std::memory_order_acquire))
+    {
+      {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.wait_for(lock, kDrainInterval);
+      }
+      drain(&batch);
+    }
+    drain(&batch);
+  }
+
+  void stop()
+  {
+    if (!stopped.exchange(true))
+    {
+      wake.notify_one();
+      thread.join();
+
+      // Messages pushed while stopping
+      std::string batch;
+      drain(&batch);
+    }
+  }
+
+  int fd;
+  std::unique_ptr<Slot[]> slots;
+  std::atomic<size_t> enqueue_pos;
+  std::atomic<size_t> dequeue_pos;
+  std::atomic<size_t> dropped;
+  std::atomic<size_t> total_dropped;
+  std::atomic<bool> stopped;
+  std::mutex drain_mutex;
+  std::mutex wake_mutex;
+  std::condition_variable wake;
+  std::thread thread;
+};
+
 
 Logger* Logger::instance = NULL;
 
@@ -156,9 +376,6 @@ void Logger::log_text(LOG_LEVEL level, const char* domain, const char* text)
     s += "\n";
     const char* buf = s.c_str();
 
-    instance->out.write(buf, (std::streamsize)strlen(buf));
-    instance->out.flush();
-
     if (instance->use_stderr)
     {
       instance->out_to_stderr(buf);
@@ -167,6 +384,8 @@ void Logger::log_text(LOG_LEVEL level, const char* domain, const char* text)
     std::list<Log_hook>::const_iterator myend = instance->hook_list.end();
     for (std::list<Log_hook>::const_iterator it = instance->hook_list.begin(); it != myend; it++)
       (*it)(buf, level, domain);
+
+    instance->out_to_file(&s);
   }
 }
 
@@ -195,9 +414,6 @@ void Logger::log(LOG_LEVEL level, const char* domain, const char* formats, ...)
     s += "\n";
     const char* buf = s.c_str();
 
-    instance->out.write(buf, (std::streamsize)strlen(buf));
-    instance->out.flush();
-
     if (instance->use_stderr)
     {
       instance->out_to_stderr(buf);
@@ -207,6 +423,8 @@ void Logger::log(LOG_LEVEL level, const char* domain, const char* formats, ...)
     for (std::list<Log_hook>::const_iterator it = instance->hook_list.begin(); it != myend; it++)
       (*it)(buf, level, domain);
 
+    instance->out_to_file(&s);
+
     free(mybuf);
   }
 }
@@ -262,6 +480,62 @@ void Logger::out_to_stderr(const char* msg)
 #endif
 }
 
+void Logger::out_to_file(std::string *msg)
+{
+  if (async)
+  {
+    async->push(msg);
+  }
+  else
+  {
+    out.write(msg->data(), (std::streamsize)msg->size());
+    out.flush();
+  }
+}
+
+
+void Logger::flush()
+{
+  if (instance && instance->async)
+  {
+    std::string batch;
+    instance->async->drain(&batch);
+  }
+}
+
+
+size_t Logger::get_dropped_count()
+{
+  if (instance && instance->async)
+    return instance->async->total_dropped.load();
+  return 0;
+}
+
+
+void Logger::stop_async()
+{
+  if (instance && instance->async)
+    instance->async->stop();
+}
+
+
+#ifndef WIN32
+void Logger::on_crash_signal(int sig)
+{
+  if (instance && instance->async)
+    instance->async->drain(NULL);
+
+  // Lets the previous handler, or the default action, deal with the signal
+  for (size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); i++)
+  {
+    if (kCrashSignals[i] == sig)
+      sigaction(sig, &crash_old_actions[i], NULL);
+  }
+  raise(sig);
+}
+#endif
+
+
 /*static*/ std::string Logger::format_message(const char* domain, const char* message, Logger::LOG_LEVEL log_level_)
 {
   return format_message_common(domain, message, log_level_);
@@ -311,9 +585,39 @@ void Logger::out_to_stderr(const char* msg)
   return result;
 }
 
-void Logger::create_instance(const char *filename, bool use_stderr, Logger::LOG_LEVEL log_level)
+void Logger::create_instance(const char *filename, bool use_stderr, Logger::LOG_LEVEL log_level, bool async)
 {
-  instance = new Logger(filename, use_stderr, log_level);
+  Logger *logger = new Logger(filename, use_stderr, log_level);
+
+  if (async && filename != NULL)
+  {
+#ifdef WIN32
+    int fd = ::_open(filename, _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    int fd = ::open(filename, O_WRONLY | O_APPEND | O_CREAT, 0666);
+#endif
+    if (fd < 0)
+      throw std::logic_error(std::string("Error in Logger::create_instance when opening file '") + filename + "' for writing");
+    logger->async = new Async_backend(fd);
+
+    // The queued messages are written at exit, or if the process crashes
+    static bool handlers_installed = false;
+    if (!handlers_installed)
+    {
+      handlers_installed = true;
+      atexit(&Logger::stop_async);
+#ifndef WIN32
+      struct sigaction action;
+      memset(&action, 0, sizeof(action));
+      action.sa_handler = &Logger::on_crash_signal;
+      sigemptyset(&action.sa_mask);
+      for (size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); i++)
+        sigaction(kCrashSignals[i], &action, &crash_old_actions[i]);
+#endif
+    }
+  }
+
+  instance = logger;
 }
 
 
@@ -324,6 +628,7 @@ void Logger::create_instance(const char *filename, bool use_stderr, Logger::LOG_
 
 
 Logger::Logger(const char *filename, bool use_stderr_, Logger::LOG_LEVEL log_level_)
+  : async(NULL)
 {
   this->use_stderr = use_stderr_;
   this->log_level = log_level_;
@@ -338,6 +643,13 @@ Logger::Logger(const char *filename, bool use_stderr_, Logger::LOG_LEVEL log_lev
 
 Logger::~Logger()
 {
+  if (async)
+  {
+    async->stop();
+    ::close(async->fd);
+    delete async;
+  }
+
   if (out.is_open())
     out.close();
 }
@@ -99,8 +99,23 @@ public:
 
   static Logger* singleton();
 
-  // Creates singleton instance with proper parameters
-  static void create_instance(const char *filename, bool use_stderr = false, LOG_LEVEL level = LOG_INFO);
+  // Creates singleton instance with proper parameters, if async the messages
+  // are written to the file by a background thread
+  static void create_instance(const char *filename, bool use_stderr = false, LOG_LEVEL level = LOG_INFO, bool async = false);
+
+  // Returns false if messages of the given level are not logged, so the
+  // caller can skip formatting them
+  static bool is_enabled(LOG_LEVEL level)
+  {
+    // An uninitialized logger reports the attempt from log()
+    return instance == NULL || level <= instance->log_level;
+  }
+
+  // Writes the messages queued by the async backend
+  static void flush();
+
+  // Number of messages the async backend dropped as its queue was full
+  static size_t get_dropped_count();
 
   static LOG_LEVEL get_level_by_name(const std::string& level_name);
 
@@ -111,6 +126,8 @@ public:
   static std::string get_level_range_info();
 
 private:
+  struct Async_backend;
+
   struct Case_insensitive_comp
   {
     bool operator() (const std::string& lhs, const std::string& rhs) const;
@@ -152,6 +169,11 @@ private:
   Logger(const char *filename, bool use_stderr = false, LOG_LEVEL log_level = LOG_INFO);
   ~Logger();
   void out_to_stderr(const char* msg);
+  void out_to_file(std::string *msg);
+  static void stop_async();
+#ifndef WIN32
+  static void on_crash_signal(int sig);
+#endif
   static std::string format_message(const char* domain, const char* message, LOG_LEVEL log_level);
   static std::string format_message(const char* domain, const char*,         const std::exception& exc);
   static std::string format_message_common(const char* domain, const char* message, Logger::LOG_LEVEL log_level);
@@ -165,24 +187,27 @@ private:
   bool use_stderr;
   std::ofstream out;
   std::list<Log_hook> hook_list;
+  Async_backend *async;
 
   friend class tests::LoggerTestProxy;
 };
 
-#define log_internal_error(...) ngcommon::Logger::log(ngcommon::Logger::LOG_INTERNAL_ERROR, LOG_DOMAIN, __VA_ARGS__)
-#define log_unexpected(...)     ngcommon::Logger::log(ngcommon::Logger::LOG_INTERNAL_ERROR, LOG_DOMAIN, __VA_ARGS__)
+#define log_if_enabled(level, ...) do { if (ngcommon::Logger::is_enabled(level)) ngcommon::Logger::log(level, LOG_DOMAIN, __VA_ARGS__); } while (0)
+
+#define log_internal_error(...) log_if_enabled(ngcommon::Logger::LOG_INTERNAL_ERROR, __VA_ARGS__)
+#define log_unexpected(...)     log_if_enabled(ngcommon::Logger::LOG_INTERNAL_ERROR, __VA_ARGS__)
 
 #define log_exception(msg, exc) ngcommon::Logger::log_exc(LOG_DOMAIN, msg, exc)
-#define log_error(...)          ngcommon::Logger::log(ngcommon::Logger::LOG_ERROR,   LOG_DOMAIN, __VA_ARGS__)
-#define log_warning(...)        ngcommon::Logger::log(ngcommon::Logger::LOG_WARNING, LOG_DOMAIN, __VA_ARGS__)
-#define log_info(...)           ngcommon::Logger::log(ngcommon::Logger::LOG_INFO,    LOG_DOMAIN, __VA_ARGS__)
-#define log_debug(...)          ngcommon::Logger::log(ngcommon::Logger::LOG_DEBUG,   LOG_DOMAIN, __VA_ARGS__)
+#define log_error(...)          log_if_enabled(ngcommon::Logger::LOG_ERROR,   __VA_ARGS__)
+#define log_warning(...)        log_if_enabled(ngcommon::Logger::LOG_WARNING, __VA_ARGS__)
+#define log_info(...)           log_if_enabled(ngcommon::Logger::LOG_INFO,    __VA_ARGS__)
+#define log_debug(...)          log_if_enabled(ngcommon::Logger::LOG_DEBUG,   __VA_ARGS__)
 
 #ifdef WITH_DEBUG
-  #define log_debug2(args) ngcommon::Logger::log_text(ngcommon::Logger::LOG_DEBUG2, LOG_DOMAIN, ngcommon::Logger::format args)
-  #define log_debug3(args) ngcommon::Logger::log_text(ngcommon::Logger::LOG_DEBUG3, LOG_DOMAIN, ngcommon::Logger::format args)
+  #define log_debug2(args) do { if (ngcommon::Logger::is_enabled(ngcommon::Logger::LOG_DEBUG2)) ngcommon::Logger::log_text(ngcommon::Logger::LOG_DEBUG2, LOG_DOMAIN, ngcommon::Logger::format args); } while (0)
+  #define log_debug3(args) do { if (ngcommon::Logger::is_enabled(ngcommon::Logger::LOG_DEBUG3)) ngcommon::Logger::log_text(ngcommon::Logger::LOG_DEBUG3, LOG_DOMAIN, ngcommon::Logger::format args); } while (0)
 
-  #define log_secret(...)  ngcommon::Logger::log(ngcommon::Logger::LOG_DEBUG, LOG_DOMAIN, __VA_ARGS__)
+  #define log_secret(...)  log_if_enabled(ngcommon::Logger::LOG_DEBUG, __VA_ARGS__)
 #else
   #define log_debug2(args) do {} while(0)
   #define log_debug3(args) do {} while(0)
@@ -16,8 +16,11 @@
 
 
 #include <cctype>
+#include <cstdio>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "logger.h"
 #include "gtest/gtest.h"
@@ -146,6 +149,72 @@ namespace tests
     }
   }
 
+  size_t count_lines(const std::string &contents, const std::string &text)
+  {
+    size_t count = 0;
+    size_t idx = contents.find(text);
+    while (idx != std::string::npos)
+    {
+      count++;
+      idx = contents.find(text, idx + text.size());
+    }
+    return count;
+  }
+
+  TEST(Logger, is_enabled)
+  {
+    const std::string* filename = get_path("mylog.txt");
+    Logger::create_instance(filename->c_str(), false, Logger::LOG_WARNING);
+
+    EXPECT_TRUE(Logger::is_enabled(Logger::LOG_ERROR));
+    EXPECT_TRUE(Logger::is_enabled(Logger::LOG_WARNING));
+    EXPECT_FALSE(Logger::is_enabled(Logger::LOG_INFO));
+    EXPECT_FALSE(Logger::is_enabled(Logger::LOG_DEBUG3));
+
+    // The arguments of a disabled level are not evaluated
+    int evaluated = 0;
+    log_debug("Value %d", ++evaluated);
+    log_error("Value %d", ++evaluated);
+    EXPECT_EQ(1, evaluated);
+
+    delete filename;
+  }
+
+  TEST(Logger, async)
+  {
+    const std::string* filename = get_path("myasynclog.txt");
+    std::remove(filename->c_str());
+    Logger::create_instance(filename->c_str(), false, Logger::LOG_DEBUG, true);
+
+    const int threads = 4;
+    const int messages = 1000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+      workers.push_back(std::thread([t]() {
+        for (int i = 0; i < messages; i++)
+          Logger::log(Logger::LOG_INFO, "Unit Test Domain", "Async message %d %d", t, i);
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+
+    Logger::flush();
+
+    const std::string* contents = get_file_contents("myasynclog.txt");
+    ASSERT_TRUE(contents != NULL);
+
+    // Messages are only lost if the queue was full
+    size_t written = count_lines(*contents, "Info: Unit Test Domain: Async message");
+    EXPECT_EQ(static_cast<size_t>(threads * messages), written + Logger::get_dropped_count());
+
+    // The messages of a thread stay in order
+    EXPECT_LT(contents->find("Async message 0 1\n"), contents->find("Async message 0 2\n"));
+
+    delete filename;
+    delete contents;
+  }
+
   bool is_timestamp(const char* text)
   {
     // example timestamp: "2015-12-23 09:26:49"
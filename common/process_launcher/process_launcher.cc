@@ -17,6 +17,8 @@
 #include "exception.h"
 
 #include <boost/format.hpp>
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <system_error>
 
@@ -165,12 +167,12 @@ void Process_launcher::close() {
   is_alive = false;
 }
 
-int Process_launcher::read_one_char() {
-  char buf[1];
+int Process_launcher::read_pipe(char *buf, size_t count) {
   BOOL bSuccess = FALSE;
   DWORD dwBytesRead, dwCode;
+  int i = 0;
 
-  while (!(bSuccess = ReadFile(child_out_rd, buf, 1, &dwBytesRead, NULL))) {
+  while (!(bSuccess = ReadFile(child_out_rd, buf, count, &dwBytesRead, NULL))) {
     dwCode = GetLastError();
     if (dwCode == ERROR_NO_DATA) continue;
     if (dwCode == ERROR_BROKEN_PIPE)
@@ -179,24 +181,41 @@ int Process_launcher::read_one_char() {
       report_error(NULL);
   }
 
-  return buf[0];
+  return dwBytesRead;
 }
 
-int Process_launcher::read(char *buf, size_t count) {
-  BOOL bSuccess = FALSE;
-  DWORD dwBytesRead, dwCode;
-  int i = 0;
+bool Process_launcher::pipe_ready(int timeout_ms) {
+  int waited = 0;
+  while (true) {
+    DWORD available = 0;
+    // A broken pipe is ready, the next read reports the end of the output
+    if (!PeekNamedPipe(child_out_rd, NULL, 0, NULL, &available, NULL) || available > 0)
+      return true;
 
-  while (!(bSuccess = ReadFile(child_out_rd, buf, count, &dwBytesRead, NULL))) {
-    dwCode = GetLastError();
-    if (dwCode == ERROR_NO_DATA) continue;
-    if (dwCode == ERROR_BROKEN_PIPE)
-      return EOF;
-    else
-      report_error(NULL);
+    if (timeout_ms >= 0 && waited >= timeout_ms)
+      return false;
+
+    Sleep(10);
+    waited += 10;
   }
+}
 
-  return dwBytesRead;
+std::vector<Process_launcher *> Process_launcher::wait_for_output(const std::vector<Process_launcher *> &processes, int timeout_ms) {
+  // Anonymous pipes have no overlapped I/O, so they are checked in turns
+  std::vector<Process_launcher *> ready;
+  int waited = 0;
+  while (true) {
+    for (auto process : processes) {
+      if (process->eof || process->buffer.find('\n') != std::string::npos || process->pipe_ready(0))
+        ready.push_back(process);
+    }
+
+    if (!ready.empty() || (timeout_ms >= 0 && waited >= timeout_ms))
+      return ready;
+
+    Sleep(10);
+    waited += 10;
+  }
 }
 
 int Process_launcher::write_one_char(int c) {
@@ -374,22 +393,7 @@ void Process_launcher::close()
   is_alive = false;
 }
 
-int Process_launcher::read_one_char()
-{
-  int c;
-  do
-  {
-    if((c = ::read(fd_out[0], &c, 1)) >= 0)
-      return c;
-    if(errno == EAGAIN || errno == EINTR) continue;
-    if(errno == EPIPE) return 0;
-    break;
-  } while(true);
-  report_error(NULL);
-  return -1;
-}
-
-int Process_launcher::read(char *buf, size_t count)
+int Process_launcher::read_pipe(char *buf, size_t count)
 {
   int n;
   do {
@@ -403,6 +407,54 @@ int Process_launcher::read(char *buf, size_t count)
   return -1;
 }
 
+bool Process_launcher::pipe_ready(int timeout_ms)
+{
+  struct pollfd pfd;
+  pfd.fd = fd_out[0];
+  pfd.events = POLLIN;
+
+  int n;
+  while((n = ::poll(&pfd, 1, timeout_ms)) < 0)
+  {
+    if(errno == EINTR) continue;
+    else report_error(NULL);
+  }
+
+  // A closed pipe is ready, the next read reports the end of the output
+  return n > 0;
+}
+
+std::vector<Process_launcher *> Process_launcher::wait_for_output(const std::vector<Process_launcher *> &processes, int timeout_ms)
+{
+  std::vector<Process_launcher *> ready;
+  std::vector<struct pollfd> pfds(processes.size());
+
+  // The ones with buffered output are ready without waiting
+  for(size_t i = 0; i < processes.size(); i++)
+  {
+    if(processes[i]->eof || processes[i]->buffer.find('\n') != std::string::npos)
+      timeout_ms = 0;
+
+    pfds[i].fd = processes[i]->eof ? -1 : processes[i]->fd_out[0];
+    pfds[i].events = POLLIN;
+    pfds[i].revents = 0;
+  }
+
+  while(::poll(pfds.data(), pfds.size(), timeout_ms) < 0)
+  {
+    if(errno == EINTR) continue;
+    else processes[0]->report_error(NULL);
+  }
+
+  for(size_t i = 0; i < processes.size(); i++)
+  {
+    if(pfds[i].revents || processes[i]->eof || processes[i]->buffer.find('\n') != std::string::npos)
+      ready.push_back(processes[i]);
+  }
+
+  return ready;
+}
+
 int Process_launcher::write_one_char(int c)
 {
   int n;
@@ -460,7 +512,7 @@ int Process_launcher::wait()
 
   do
   {
-    ret = ::wait(&status);
+    ret = ::waitpid(childpid, &status, 0);
     exited = WIFEXITED(status);
     exitstatus = WEXITSTATUS(status);
     if(ret == -1)
@@ -492,3 +544,66 @@ uint64_t Process_launcher::get_fd_read()
 void Process_launcher::kill() {
   close();
 }
+
+bool Process_launcher::fill_buffer() {
+  char block[4096];
+  int n = read_pipe(block, sizeof(block));
+
+  if (n <= 0) {
+    eof = true;
+    return false;
+  }
+
+  buffer.append(block, n);
+  return true;
+}
+
+bool Process_launcher::take_line(std::string *line) {
+  size_t end = buffer.find('\n');
+  if (end == std::string::npos) {
+    // The last line of the output may not be ended
+    if (!eof || buffer.empty())
+      return false;
+    end = buffer.size() - 1;
+  }
+
+  line->assign(buffer, 0, end + 1);
+  buffer.erase(0, end + 1);
+  return true;
+}
+
+int Process_launcher::read_one_char() {
+  if (buffer.empty() && (eof || !fill_buffer()))
+    return EOF;
+
+  int c = static_cast<unsigned char>(buffer[0]);
+  buffer.erase(0, 1);
+  return c;
+}
+
+int Process_launcher::read(char *buf, size_t count) {
+  // The output already buffered by read_line comes first
+  if (buffer.empty())
+    return eof ? 0 : read_pipe(buf, count);
+
+  size_t n = std::min(count, buffer.size());
+  memcpy(buf, buffer.data(), n);
+  buffer.erase(0, n);
+  return static_cast<int>(n);
+}
+
+bool Process_launcher::read_line(std::string *line) {
+  while (buffer.find('\n') == std::string::npos && !eof)
+    fill_buffer();
+
+  return take_line(line);
+}
+
+bool Process_launcher::try_read_line(std::string *line, bool *closed) {
+  while (buffer.find('\n') == std::string::npos && !eof && pipe_ready(0))
+    fill_buffer();
+
+  bool ret_val = take_line(line);
+  *closed = eof && buffer.empty();
+  return ret_val;
+}
@@ -27,6 +27,8 @@
 //#  include <poll.h>
 #endif
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 namespace ngcommon {
 // Launches a process as child of current process and exposes the stdin & stdout of the child process
@@ -47,7 +49,7 @@ public:
    * Argument 'args' must have a last entry that is NULL.
    * If redirect_stderr is true, the child's stderr is redirected to the same stream than child's stdout.
    */
-  Process_launcher(const char *cmd_line, const char ** args, bool redirect_stderr = true) : is_alive(false) {
+  Process_launcher(const char *cmd_line, const char ** args, bool redirect_stderr = true) : is_alive(false), eof(false) {
     this->cmd_line = cmd_line;
     this->args = args;
     this->redirect_stderr = redirect_stderr;
@@ -74,6 +76,30 @@ public:
    */
   int read(char *buf, size_t count);
 
+  /**
+   * Reads a line from the stdout of the child process, including its '\n'
+   * unless it is the last one and the child did not end it.
+   * The output is read in blocks, what follows the line is kept for the next reads.
+   * @return false once the child closed its stdout and all of it was read.
+   * Throws an std::system_error in case of error when reading.
+   */
+  bool read_line(std::string *line);
+
+  /**
+   * Same as read_line, but never blocks: only the output already available is read.
+   * @param closed set to true once the child closed its stdout and all of it was read.
+   * @return false if there is no complete line available yet.
+   */
+  bool try_read_line(std::string *line, bool *closed);
+
+  /**
+   * Waits until any of the given processes has output to read or closed its stdout,
+   * so a single thread can serve several child processes with try_read_line.
+   * @param timeout_ms the maximum time to wait, -1 to wait without limit.
+   * @return the processes that are ready, empty on timeout.
+   */
+  static std::vector<Process_launcher *> wait_for_output(const std::vector<Process_launcher *> &processes, int timeout_ms);
+
   /**
    * Write into stdin of child process.
    * Returns an shcore::Exception in case of error when writing.
@@ -125,9 +151,20 @@ private:
   /** Closes child process */
   void close();
 
+  /** Reads from the pipe, bypassing the buffer. Returns 0 or EOF at the end of the output. */
+  int read_pipe(char *buf, size_t count);
+  /** Whether there is output available on the pipe or it was closed, waiting up to timeout_ms for it. */
+  bool pipe_ready(int timeout_ms);
+  /** Reads once from the pipe into the buffer, returns false at the end of the output. */
+  bool fill_buffer();
+  bool take_line(std::string *line);
+
   const char *cmd_line;
   const char **args;
   bool is_alive;
+  // Output read from the pipe but not yet returned, and whether the pipe was closed
+  std::string buffer;
+  bool eof;
 #ifdef WIN32
   HANDLE child_in_rd;
   HANDLE child_in_wr;
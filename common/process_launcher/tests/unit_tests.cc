@@ -21,6 +21,7 @@
 #  include <sys/time.h>
 #endif
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -239,5 +240,65 @@ namespace tests
     p.wait();
     delete path_script;
   }
+
+  // Same than scenario 3, reading the output by lines
+  TEST(Scenario3, ReadLines)
+  {
+    const std::string *path_script = get_path("printn.py");
+    const char *args[] = { "python", path_script->c_str(), NULL };
+    Process_launcher p("python", args);
+    std::string line;
+    int i = 1;
+
+    p.start();
+    p.write("3\n", 2);
+    while (p.read_line(&line))
+    {
+      std::string data = "hello" + std::to_string(i);
+#ifdef WIN32
+      data += "\r\n";
+#else
+      data += "\n";
+#endif
+      EXPECT_STREQ(data.c_str(), line.c_str());
+      i++;
+    }
+    EXPECT_EQ(4, i);
+    p.wait();
+    delete path_script;
+  }
+
+  // Serves the output of two processes from a single thread
+  TEST(Scenario3, WaitForOutput)
+  {
+    const std::string *path_script = get_path("printn.py");
+    const char *args[] = { "python", path_script->c_str(), NULL };
+    Process_launcher p1("python", args);
+    Process_launcher p2("python", args);
+    std::vector<Process_launcher *> open = { &p1, &p2 };
+    int lines = 0;
+
+    p1.start();
+    p2.start();
+    p1.write("2\n", 2);
+    p2.write("3\n", 2);
+    while (!open.empty())
+    {
+      for (auto p : Process_launcher::wait_for_output(open, -1))
+      {
+        std::string line;
+        bool closed = false;
+        while (p->try_read_line(&line, &closed))
+          lines++;
+
+        if (closed)
+          open.erase(std::find(open.begin(), open.end(), p));
+      }
+    }
+    EXPECT_EQ(5, lines);
+    p1.wait();
+    p2.wait();
+    delete path_script;
+  }
 }
 }
@@ -18,6 +18,9 @@
 #ifndef UUID_GEN_INCLUDED
 #define UUID_GEN_INCLUDED
 
+#include <string>
+#include <vector>
+
 #define UUID_LENGTH_BIN 16
 typedef unsigned char uuid_type[UUID_LENGTH_BIN];
 
@@ -25,4 +28,39 @@ void init_uuid(unsigned long);
 void end_uuid();
 void generate_uuid(uuid_type &uuid);
 
+/*
+  Generates count consecutive time based UUIDs taking the generator
+  lock only once
+*/
+void generate_uuid_block(uuid_type *uuids, unsigned int count);
+
+/*
+  Writes the 32 lower case hex digits of the UUID bytes into out, no
+  terminating null character is added
+*/
+void format_uuid_hex(const uuid_type &uuid, char *out);
+
+/*
+  Hands out UUIDs from a block reserved with generate_uuid_block, a new
+  block is reserved once the current one is exhausted.
+  Not thread safe, meant to be owned by a single user (i.e. a session).
+*/
+class Uuid_block
+{
+public:
+  explicit Uuid_block(unsigned int size = 256);
+
+  void next(uuid_type &uuid);
+  std::string next_hex();
+
+private:
+  struct Entry
+  {
+    uuid_type value;
+  };
+
+  std::vector<Entry> m_uuids;
+  size_t m_next;
+};
+
 #endif
\ No newline at end of file
@@ -452,20 +452,27 @@ void end_uuid()
   pthread_mutex_destroy(&LOCK_sql_rand);
 }
 
-void generate_uuid(uuid_type &uuid)
+struct uuid_internal_st
 {
+  uint32 time_low;
+  uint16 time_mid;
+  uint16 time_hi_and_version;
+  uint16 process_id;
+  unsigned char  hw_mac[6];
+};
 
-  struct uuid_internal_st
-  {
-    uint32 time_low;
-    uint16 time_mid;
-    uint16 time_hi_and_version;
-    uint16 process_id;
-    unsigned char  hw_mac[6];
-  };
+static uuid_internal_st uuid_internal;
 
-  static uuid_internal_st uuid_internal;
+/*
+  Reserves count consecutive timestamps for UUID generation under a single
+  lock, the first one is returned and the node data used for all of them is
+  copied into internal.
 
+  Timestamps ahead of the system clock are "borrowed" through nanoseq the
+  same way it is done for several requests on the same tick.
+*/
+static unsigned long long reserve_uuid_time(unsigned int count, uuid_internal_st &internal)
+{
   pthread_mutex_lock(&LOCK_uuid_generator);
 
   if (! uuid_time) /* first UUID() call. initializing data */
@@ -557,12 +564,92 @@ void generate_uuid(uuid_type &uuid)
     }
   }
 
-  uuid_time=tv;
+  /*
+    The rest of the block is borrowed from the future, it is given back
+    on the next calls as the clock advances
+  */
+  if (count > 1)
+    nanoseq+= count - 1;
+
+  uuid_time=tv + count - 1;
+  internal= uuid_internal;
   pthread_mutex_unlock(&LOCK_uuid_generator);
 
-  uuid_internal.time_low=            (uint32) (tv & 0xFFFFFFFF);
-  uuid_internal.time_mid=            (uint16) ((tv >> 32) & 0xFFFF);
-  uuid_internal.time_hi_and_version= (uint16) ((tv >> 48) | UUID_VERSION);
+  return tv;
+}
+
+
+static void build_uuid(unsigned long long tv, uuid_internal_st &internal, uuid_type &uuid)
+{
+  internal.time_low=            (uint32) (tv & 0xFFFFFFFF);
+  internal.time_mid=            (uint16) ((tv >> 32) & 0xFFFF);
+  internal.time_hi_and_version= (uint16) ((tv >> 48) | UUID_VERSION);
+
+  memcpy(uuid, &internal, sizeof(internal));
+}
+
+
+void generate_uuid(uuid_type &uuid)
+{
+  uuid_internal_st internal;
+  unsigned long long tv= reserve_uuid_time(1, internal);
+
+  build_uuid(tv, internal, uuid);
+}
+
+
+void generate_uuid_block(uuid_type *uuids, unsigned int count)
+{
+  if (!count)
+    return;
+
+  uuid_internal_st internal;
+  unsigned long long tv= reserve_uuid_time(count, internal);
+
+  for (unsigned int index= 0; index < count; index++)
+    build_uuid(tv + index, internal, uuids[index]);
+}
+
+
+void format_uuid_hex(const uuid_type &uuid, char *out)
+{
+  static const char hex_digits[]= "0123456789abcdef";
+
+  for (int index= 0; index < UUID_LENGTH_BIN; index++)
+  {
+    *out++= hex_digits[uuid[index] >> 4];
+    *out++= hex_digits[uuid[index] & 0x0F];
+  }
+}
+
+
+Uuid_block::Uuid_block(unsigned int size)
+  : m_uuids(size ? size : 1), m_next(m_uuids.size())
+{
+  // The entries are filled as a contiguous uuid_type array
+  static_assert(sizeof(Entry) == sizeof(uuid_type), "Unexpected padding on Uuid_block entries");
+}
 
-  memcpy(uuid, &uuid_internal, sizeof(uuid_internal));
-}
\ No newline at end of file
+
+void Uuid_block::next(uuid_type &uuid)
+{
+  if (m_next == m_uuids.size())
+  {
+    generate_uuid_block(&m_uuids[0].value, (unsigned int)m_uuids.size());
+    m_next= 0;
+  }
+
+  memcpy(uuid, m_uuids[m_next++].value, UUID_LENGTH_BIN);
+}
+
+
+std::string Uuid_block::next_hex()
+{
+  uuid_type uuid;
+  next(uuid);
+
+  std::string ret_val(UUID_LENGTH_BIN * 2, '0');
+  format_uuid_hex(uuid, &ret_val[0]);
+
+  return ret_val;
+}
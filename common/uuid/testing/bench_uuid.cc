@@ -0,0 +1,95 @@
+/*
+  Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#include <uuid_gen.h>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <set>
+#include <cstdlib>
+
+/*
+  Micro benchmark comparing the document id generation done by
+  CollectionAdd formatting every UUID through a stringstream against
+  the block allocator with the table driven hex formatter
+*/
+
+static std::string stream_uuid()
+{
+  uuid_type uuid;
+  generate_uuid(uuid);
+
+  std::stringstream str;
+  str << std::hex << std::noshowbase << std::setfill('0') << std::setw(2);
+  str << (int)uuid[0] << std::setw(2) << (int)uuid[1] << std::setw(2) << (int)uuid[2] << std::setw(2) << (int)uuid[3];
+  str << std::setw(2) << (int)uuid[4] << std::setw(2) << (int)uuid[5];
+  str << std::setw(2) << (int)uuid[6] << std::setw(2) << (int)uuid[7];
+  str << std::setw(2) << (int)uuid[8] << std::setw(2) << (int)uuid[9];
+  str << std::setw(2) << (int)uuid[10] << std::setw(2) << (int)uuid[11]
+    << std::setw(2) << (int)uuid[12] << std::setw(2) << (int)uuid[13]
+    << std::setw(2) << (int)uuid[14] << std::setw(2) << (int)uuid[15];
+
+  return str.str();
+}
+
+template <class Generator>
+static double run(const char *name, int iterations, Generator generator)
+{
+  std::set<std::string> ids;
+  size_t total_length = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+    total_length += generator().length();
+  auto end = std::chrono::steady_clock::now();
+
+  double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+  // Uniqueness is verified outside of the timed section
+  for (int i = 0; i < 1000; i++)
+    ids.insert(generator());
+
+  std::cout << std::left << std::setw(20) << name
+            << std::right << std::setw(10) << std::fixed << std::setprecision(2) << elapsed << " ms"
+            << std::setw(10) << (elapsed * 1000000 / iterations) << " ns/id"
+            << (ids.size() == 1000 && total_length == (size_t)iterations * 32 ? "" : "  FAILED")
+            << std::endl;
+
+  return elapsed;
+}
+
+int main(int argc, char **argv)
+{
+  init_uuid(365873);
+
+  int iterations = 1000000;
+  if (argc > 1)
+    iterations = std::atoi(argv[1]);
+
+  std::cout << "UUID document id generation, " << iterations << " ids" << std::endl;
+
+  double stream_time = run("stringstream", iterations, stream_uuid);
+
+  Uuid_block block;
+  double block_time = run("Uuid_block", iterations, [&block]() { return block.next_hex(); });
+
+  std::cout << "Speedup: " << std::setprecision(1) << (stream_time / block_time) << "x" << std::endl;
+
+  end_uuid();
+  return 0;
+}
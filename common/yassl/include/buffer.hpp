@@ -164,6 +164,9 @@ public:
     // for passing to reading functions when finished
     const byte* get_buffer() const;
 
+    // for processing the contents in place
+    byte* use_buffer();
+
     // allow write access through [], update current
     // user passes in AUTO as index for ease of use
     byte& operator[](uint i);
@@ -301,6 +301,13 @@ const byte* output_buffer::get_buffer() const
 }
 
 
+// for processing the contents in place
+byte* output_buffer::use_buffer()
+{
+    return buffer_;
+}
+
+
 // allow write access through [], update current
 // user passes in AUTO as index for ease of use
 byte& output_buffer::operator[](uint i) 
@@ -251,16 +251,15 @@ static int sanity_check_message(SSL& ssl, uint msgSz)
 // decrypt input message in place, store size in case needed later
 void decrypt_message(SSL& ssl, input_buffer& input, uint sz)
 {
-    input_buffer plain(sz);
-    opaque*      cipher = input.get_buffer() + input.get_current();
+    opaque* cipher = input.get_buffer() + input.get_current();
 
     if (sanity_check_message(ssl, sz) != 0) {
         ssl.SetError(sanityCipher_error);
         return;
     }
 
-    ssl.useCrypto().use_cipher().decrypt(plain.get_buffer(), cipher, sz);
-    memcpy(cipher, plain.get_buffer(), sz);
+    // in place, the ciphers allow it and it saves a copy of each record
+    ssl.useCrypto().use_cipher().decrypt(cipher, cipher, sz);
     ssl.useSecurity().use_parms().encrypt_size_ = sz;
 
     if (ssl.isTLSv1_1())  // IV
@@ -323,11 +322,9 @@ void cipherFinished(SSL& ssl, Finished& fin, output_buffer& output)
     if (ssl.getSecurity().get_parms().cipher_type_ == block)
         for (uint i = 0; i <= pad; i++) output[AUTO] = pad;   // pad byte gets
                                                               // pad value too
-    input_buffer cipher(rlHeader.length_);
-    ssl.useCrypto().use_cipher().encrypt(cipher.get_buffer(),
+    // in place, the ciphers allow it and it saves a copy of each record
+    ssl.useCrypto().use_cipher().encrypt(output.use_buffer() + RECORD_HEADER,
        output.get_buffer() + RECORD_HEADER, output.get_size() - RECORD_HEADER);
-    output.set_current(RECORD_HEADER);
-    output.write(cipher.get_buffer(), cipher.get_capacity());
 }
 
 
@@ -375,11 +372,9 @@ void buildMessage(SSL& ssl, output_buffer& output, const Message& msg)
     if (ssl.getSecurity().get_parms().cipher_type_ == block)
         for (uint i = 0; i <= pad; i++) output[AUTO] = pad; // pad byte gets
                                                               // pad value too
-    input_buffer cipher(rlHeader.length_);
-    ssl.useCrypto().use_cipher().encrypt(cipher.get_buffer(),
+    // in place, the ciphers allow it and it saves a copy of each record
+    ssl.useCrypto().use_cipher().encrypt(output.use_buffer() + RECORD_HEADER,
        output.get_buffer() + RECORD_HEADER, output.get_size() - RECORD_HEADER);
-    output.set_current(RECORD_HEADER);
-    output.write(cipher.get_buffer(), cipher.get_capacity());
 }
 
 
@@ -46,6 +46,7 @@ void bench_arc4();
 
 void bench_md5();
 void bench_sha();
+void bench_sha256();
 void bench_ripemd();
 
 void bench_rsa();
@@ -70,6 +71,7 @@ int main(int argc, char** argv)
 
     bench_md5();
     bench_sha();
+    bench_sha256();
     bench_ripemd();
 
     printf("\n");
@@ -250,6 +252,28 @@ void bench_sha()
 }
 
 
+void bench_sha256()
+{
+    SHA256 hash;
+    byte digest[SHA256::DIGEST_SIZE];
+
+    double start = current_time();
+
+    
+    for(int i = 0; i < megs; i++)
+        hash.Update(plain, sizeof(plain));
+   
+    hash.Final(digest);
+
+    double total = current_time() - start;
+
+    double persec = 1 / total * megs;
+
+    printf("SHA-256  %d megs took %5.3f seconds, %6.2f MB/s\n", megs, total,
+                                                             persec);
+}
+
+
 void bench_ripemd()
 {
     RIPEMD160 hash;
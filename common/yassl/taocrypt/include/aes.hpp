@@ -31,6 +31,16 @@
     #define DO_AES_ASM
 #endif
 
+// AES-NI through compiler intrinsics, used when the cpu has it
+#if !defined(TAOCRYPT_DISABLE_AESNI) && \
+   ((defined(_MSC_VER) && (_MSC_VER >= 1600) && \
+     (defined(_M_IX86) || defined(_M_X64))) || \
+    ((defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || \
+      (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) && \
+     (defined(__i386__) || defined(__x86_64__))))
+    #define DO_AES_NI
+#endif
+
 
 
 namespace TaoCrypt {
@@ -45,9 +55,9 @@ public:
     enum { BLOCK_SIZE = AES_BLOCK_SIZE };
 
     AES(CipherDir DIR, Mode MODE)
-        : Mode_BASE(BLOCK_SIZE, DIR, MODE) {}
+        : Mode_BASE(BLOCK_SIZE, DIR, MODE), useNi_(false) {}
 
-#ifdef DO_AES_ASM
+#if defined(DO_AES_ASM) || defined(DO_AES_NI)
     void Process(byte*, const byte*, word32);
 #endif
     void SetKey(const byte* key, word32 sz, CipherDir fake = ENCRYPTION);
@@ -57,6 +67,10 @@ private:
 
     word32      rounds_;
     word32      key_[60];                        // max size
+    bool        useNi_;
+#ifdef DO_AES_NI
+    word32      niKey_[60];                      // key_ in byte order
+#endif
 
     static const word32 Te[5][256];
     static const word32 Td[5][256];
@@ -79,6 +93,9 @@ private:
     void AsmDecrypt(const byte*, byte*, void*) const;
 
     void ProcessAndXorBlock(const byte*, const byte*, byte*) const;
+#ifdef DO_AES_NI
+    void NiProcess(byte*, const byte*, word32);
+#endif
 
     AES(const AES&);            // hide copy
     AES& operator=(const AES&); // and assign
@@ -29,6 +29,16 @@
     #define DO_SHA_ASM
 #endif
 
+// SHA extensions through compiler intrinsics, used when the cpu has them
+#if !defined(TAOCRYPT_DISABLE_SHANI) && \
+   ((defined(_MSC_VER) && (_MSC_VER >= 1900) && \
+     (defined(_M_IX86) || defined(_M_X64))) || \
+    ((defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || \
+      (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) && \
+     (defined(__i386__) || defined(__x86_64__))))
+    #define DO_SHA_NI
+#endif
+
 namespace TaoCrypt {
 
 
@@ -44,7 +54,7 @@ public:
     word32    getDigestSize() const { return DIGEST_SIZE; }
     word32    getPadSize()    const { return PAD_SIZE; }
 
-#ifdef DO_SHA_ASM
+#if defined(DO_SHA_ASM) || defined(DO_SHA_NI)
     void Update(const byte* data, word32 len);
 #endif
     void Init();
@@ -76,6 +86,9 @@ public:
     word32    getDigestSize() const { return DIGEST_SIZE; }
     word32    getPadSize()    const { return PAD_SIZE; }
 
+#ifdef DO_SHA_NI
+    void Update(const byte* data, word32 len);
+#endif
     void Init();
 
     SHA256(const SHA256&);
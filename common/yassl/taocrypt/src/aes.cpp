@@ -26,15 +26,187 @@
 #include "runtime.hpp"
 #include "aes.hpp"
 
+#ifdef DO_AES_NI
+    #include <wmmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define AES_NI_TARGET
+    #else
+        #include <cpuid.h>
+        #define AES_NI_TARGET __attribute__((target("aes,sse2")))
+    #endif
+#endif
+
 
 namespace TaoCrypt {
 
 
-#if defined(DO_AES_ASM)
+#if defined(DO_AES_NI)
+
+namespace {
+
+bool HaveAesNi()
+{
+    // cpuid leaf 1, ecx bit 25
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 25)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    return (ecx & (1 << 25)) != 0;
+#endif
+}
+
+
+AES_NI_TARGET
+inline __m128i NiEncrypt(__m128i block, const __m128i* keys, word32 rounds)
+{
+    block = _mm_xor_si128(block, keys[0]);
+    for (word32 i = 1; i < rounds; i++)
+        block = _mm_aesenc_si128(block, keys[i]);
+    return _mm_aesenclast_si128(block, keys[rounds]);
+}
+
+
+AES_NI_TARGET
+inline __m128i NiDecrypt(__m128i block, const __m128i* keys, word32 rounds)
+{
+    block = _mm_xor_si128(block, keys[0]);
+    for (word32 i = 1; i < rounds; i++)
+        block = _mm_aesdec_si128(block, keys[i]);
+    return _mm_aesdeclast_si128(block, keys[rounds]);
+}
+
+
+// Four independent blocks at a time, to keep the aes unit busy
+AES_NI_TARGET
+inline void NiEncrypt4(__m128i* blocks, const __m128i* keys, word32 rounds)
+{
+    for (int b = 0; b < 4; b++)
+        blocks[b] = _mm_xor_si128(blocks[b], keys[0]);
+    for (word32 i = 1; i < rounds; i++)
+        for (int b = 0; b < 4; b++)
+            blocks[b] = _mm_aesenc_si128(blocks[b], keys[i]);
+    for (int b = 0; b < 4; b++)
+        blocks[b] = _mm_aesenclast_si128(blocks[b], keys[rounds]);
+}
+
+
+AES_NI_TARGET
+inline void NiDecrypt4(__m128i* blocks, const __m128i* keys, word32 rounds)
+{
+    for (int b = 0; b < 4; b++)
+        blocks[b] = _mm_xor_si128(blocks[b], keys[0]);
+    for (word32 i = 1; i < rounds; i++)
+        for (int b = 0; b < 4; b++)
+            blocks[b] = _mm_aesdec_si128(blocks[b], keys[i]);
+    for (int b = 0; b < 4; b++)
+        blocks[b] = _mm_aesdeclast_si128(blocks[b], keys[rounds]);
+}
+
+} // namespace
+
+
+// The round keys are the ones of the table version: the decryption ones are
+// already reversed and inverse mixed, as expected by aesdec
+AES_NI_TARGET
+void AES::NiProcess(byte* out, const byte* in, word32 sz)
+{
+    __m128i keys[15];
+    for (word32 i = 0; i <= rounds_; i++)
+        keys[i] = _mm_loadu_si128((const __m128i*)(niKey_ + 4 * i));
+
+    word32 blocks = sz / BLOCK_SIZE;
+    __m128i data[4];
+
+    if (mode_ == ECB) {
+        for (; blocks >= 4; blocks -= 4) {
+            for (int b = 0; b < 4; b++)
+                data[b] = _mm_loadu_si128((const __m128i*)in + b);
+            if (dir_ == ENCRYPTION)
+                NiEncrypt4(data, keys, rounds_);
+            else
+                NiDecrypt4(data, keys, rounds_);
+            for (int b = 0; b < 4; b++)
+                _mm_storeu_si128((__m128i*)out + b, data[b]);
+            out += 4 * BLOCK_SIZE;
+            in  += 4 * BLOCK_SIZE;
+        }
+        while (blocks--) {
+            data[0] = _mm_loadu_si128((const __m128i*)in);
+            if (dir_ == ENCRYPTION)
+                data[0] = NiEncrypt(data[0], keys, rounds_);
+            else
+                data[0] = NiDecrypt(data[0], keys, rounds_);
+            _mm_storeu_si128((__m128i*)out, data[0]);
+            out += BLOCK_SIZE;
+            in  += BLOCK_SIZE;
+        }
+    }
+    else if (mode_ == CBC) {
+        __m128i chain = _mm_loadu_si128((const __m128i*)reg_);
+
+        if (dir_ == ENCRYPTION) {
+            // Each block depends on the previous one
+            while (blocks--) {
+                chain = NiEncrypt(_mm_xor_si128(
+                    _mm_loadu_si128((const __m128i*)in), chain), keys, rounds_);
+                _mm_storeu_si128((__m128i*)out, chain);
+                out += BLOCK_SIZE;
+                in  += BLOCK_SIZE;
+            }
+        }
+        else {
+            __m128i cipher[4];
+
+            for (; blocks >= 4; blocks -= 4) {
+                for (int b = 0; b < 4; b++)
+                    data[b] = cipher[b] =
+                        _mm_loadu_si128((const __m128i*)in + b);
+                NiDecrypt4(data, keys, rounds_);
+                _mm_storeu_si128((__m128i*)out, _mm_xor_si128(data[0], chain));
+                for (int b = 1; b < 4; b++)
+                    _mm_storeu_si128((__m128i*)out + b,
+                                     _mm_xor_si128(data[b], cipher[b - 1]));
+                chain = cipher[3];
+                out += 4 * BLOCK_SIZE;
+                in  += 4 * BLOCK_SIZE;
+            }
+            while (blocks--) {
+                cipher[0] = _mm_loadu_si128((const __m128i*)in);
+                _mm_storeu_si128((__m128i*)out, _mm_xor_si128(
+                    NiDecrypt(cipher[0], keys, rounds_), chain));
+                chain = cipher[0];
+                out += BLOCK_SIZE;
+                in  += BLOCK_SIZE;
+            }
+        }
+
+        _mm_storeu_si128((__m128i*)reg_, chain);
+    }
+}
+
+#endif // DO_AES_NI
+
+
+#if defined(DO_AES_ASM) || defined(DO_AES_NI)
 
-// ia32 optimized version
+// AES-NI or ia32 optimized version
 void AES::Process(byte* out, const byte* in, word32 sz)
 {
+#ifdef DO_AES_NI
+    if (useNi_) {
+        NiProcess(out, in, sz);
+        return;
+    }
+#endif
+
+#ifndef DO_AES_ASM
+    Mode_BASE::Process(out, in, sz);
+#else
     if (!isMMX) {
         Mode_BASE::Process(out, in, sz);
         return;
@@ -68,6 +240,7 @@ void AES::Process(byte* out, const byte* in, word32 sz)
         }
         else {
             while (blocks--) {
+                memcpy(t_, in, BLOCK_SIZE);     // in may be out
                 AsmDecrypt(in, out, (void*)Td0);
                 
                 *(word32*)out        ^= r_[0];
@@ -75,15 +248,16 @@ void AES::Process(byte* out, const byte* in, word32 sz)
                 *(word32*)(out +  8) ^= r_[2];
                 *(word32*)(out + 12) ^= r_[3];
 
-                memcpy(r_, in, BLOCK_SIZE);
+                memcpy(r_, t_, BLOCK_SIZE);
                 out += BLOCK_SIZE;
                 in  += BLOCK_SIZE;
             }
         }
     }
+#endif // DO_AES_ASM
 }
 
-#endif // DO_AES_ASM
+#endif // DO_AES_ASM || DO_AES_NI
 
 
 void AES::SetKey(const byte* userKey, word32 keylen, CipherDir /*dummy*/)
@@ -212,6 +386,13 @@ void AES::SetKey(const byte* userKey, word32 keylen, CipherDir /*dummy*/)
                 Td3[Te4[GETBYTE(rk[3], 0)] & 0xff];
         }
     }
+
+#ifdef DO_AES_NI
+    static const bool aesNi = HaveAesNi();
+    useNi_ = aesNi;
+    if (useNi_)
+        ByteReverse(niKey_, key_, (rounds_ + 1) * BLOCK_SIZE);
+#endif
 }
 
 
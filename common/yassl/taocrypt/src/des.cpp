@@ -426,12 +426,13 @@ void DES_EDE3::Process(byte* out, const byte* in, word32 sz)
             }
         else
             while (blocks--) {
+                memcpy(t_, in, DES_BLOCK_SIZE);  // in may be out
                 AsmProcess(in, out, (void*)Spbox);
                
                 *(word32*)out       ^= r_[0];
                 *(word32*)(out + 4) ^= r_[1];
 
-                memcpy(r_, in, DES_BLOCK_SIZE);
+                memcpy(r_, t_, DES_BLOCK_SIZE);
 
                 out += DES_BLOCK_SIZE;
                 in  += DES_BLOCK_SIZE;
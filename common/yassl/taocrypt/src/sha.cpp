@@ -27,6 +27,17 @@
     #include "algorithm.hpp"
 #endif
 
+#ifdef DO_SHA_NI
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define SHA_NI_TARGET
+    #else
+        #include <cpuid.h>
+        #define SHA_NI_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+    #endif
+#endif
+
 
 namespace STL = STL_NAMESPACE;
 
@@ -34,6 +45,107 @@ namespace STL = STL_NAMESPACE;
 
 namespace TaoCrypt {
 
+
+#ifdef DO_SHA_NI
+
+namespace {
+
+bool HaveShaNi()
+{
+    // cpuid leaf 7 ebx bit 29, with SSSE3 and SSE4.1 from leaf 1 ecx
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 9)) == 0 || (info[2] & (1 << 19)) == 0)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 29)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, 0) < 7)
+        return false;
+    __cpuid(1, eax, ebx, ecx, edx);
+    if ((ecx & (1 << 9)) == 0 || (ecx & (1 << 19)) == 0)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 29)) != 0;
+#endif
+}
+
+
+bool UseShaNi()
+{
+    static const bool shaNi = HaveShaNi();
+    return shaNi;
+}
+
+
+// Four rounds of SHA-1 on the message words of group i, rotating through
+// msg[4] and the two e registers
+#define SHA1_NI_GROUP(i, f)                                                  \
+    if (i == 0)                                                              \
+        e[0] = _mm_add_epi32(e[0], msg[0]);                                  \
+    else                                                                     \
+        e[i % 2] = _mm_sha1nexte_epu32(e[i % 2], msg[i % 4]);                \
+    e[(i + 1) % 2] = abcd;                                                   \
+    if (i >= 3 && i <= 18)                                                   \
+        msg[(i + 1) % 4] = _mm_sha1msg2_epu32(msg[(i + 1) % 4], msg[i % 4]); \
+    abcd = _mm_sha1rnds4_epu32(abcd, e[i % 2], f);                           \
+    if (i >= 1 && i <= 16)                                                   \
+        msg[(i + 3) % 4] = _mm_sha1msg1_epu32(msg[(i + 3) % 4], msg[i % 4]); \
+    if (i >= 2 && i <= 17)                                                   \
+        msg[(i + 2) % 4] = _mm_xor_si128(msg[(i + 2) % 4], msg[i % 4]);
+
+
+// Blocks of message bytes, or of words already in host order when they come
+// from the buffer of the hash
+SHA_NI_TARGET
+void ShaNiTransform(word32* digest, const byte* data, word32 blocks,
+                    bool hostOrder)
+{
+    // The words go to the lanes in reverse order
+    const __m128i order = hostOrder ?
+        _mm_set_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    __m128i abcd = _mm_shuffle_epi32(
+        _mm_loadu_si128((const __m128i*)digest), 0x1B);
+    __m128i e[2] = { _mm_set_epi32(digest[4], 0, 0, 0), _mm_setzero_si128() };
+
+    for (; blocks; blocks--, data += SHA::BLOCK_SIZE) {
+        const __m128i abcdSave = abcd;
+        const __m128i eSave = e[0];
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; i++)
+            msg[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i*)data + i), order);
+
+        SHA1_NI_GROUP( 0, 0) SHA1_NI_GROUP( 1, 0) SHA1_NI_GROUP( 2, 0)
+        SHA1_NI_GROUP( 3, 0) SHA1_NI_GROUP( 4, 0) SHA1_NI_GROUP( 5, 1)
+        SHA1_NI_GROUP( 6, 1) SHA1_NI_GROUP( 7, 1) SHA1_NI_GROUP( 8, 1)
+        SHA1_NI_GROUP( 9, 1) SHA1_NI_GROUP(10, 2) SHA1_NI_GROUP(11, 2)
+        SHA1_NI_GROUP(12, 2) SHA1_NI_GROUP(13, 2) SHA1_NI_GROUP(14, 2)
+        SHA1_NI_GROUP(15, 3) SHA1_NI_GROUP(16, 3) SHA1_NI_GROUP(17, 3)
+        SHA1_NI_GROUP(18, 3) SHA1_NI_GROUP(19, 3)
+
+        e[0] = _mm_sha1nexte_epu32(e[0], eSave);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128((__m128i*)digest, _mm_shuffle_epi32(abcd, 0x1B));
+    digest[4] = _mm_extract_epi32(e[0], 3);
+}
+
+#undef SHA1_NI_GROUP
+
+} // namespace
+
+#endif // DO_SHA_NI
+
 #define blk0(i) (W[i] = buffer_[i])
 #define blk1(i) (W[i&15] = \
                  rotlFixed(W[(i+13)&15]^W[(i+8)&15]^W[(i+2)&15]^W[i&15],1))
@@ -313,12 +425,23 @@ void SHA384::Swap(SHA384& other)
 #endif // WORD64_AVIALABLE
 
 
-#ifdef DO_SHA_ASM
+#if defined(DO_SHA_ASM) || defined(DO_SHA_NI)
 
 // Update digest with data of size len
 void SHA::Update(const byte* data, word32 len)
 {
-    if (!isMMX) {
+#ifdef DO_SHA_NI
+    const bool shaNi = UseShaNi();
+#else
+    const bool shaNi = false;
+#endif
+#ifdef DO_SHA_ASM
+    const bool shaAsm = !shaNi && isMMX;
+#else
+    const bool shaAsm = false;
+#endif
+
+    if (!shaNi && !shaAsm) {
         HASHwithTransform::Update(data, len);
         return;
     }
@@ -342,11 +465,18 @@ void SHA::Update(const byte* data, word32 len)
         }
     }
 
-    // all at once for asm
+    // all at once for asm or the sha extensions
     if (buffLen_ == 0) {
         word32 times = len / BLOCK_SIZE;
         if (times) {
-            AsmTransform(data, times);
+#ifdef DO_SHA_NI
+            if (shaNi)
+                ShaNiTransform(digest_, data, times, false);
+#endif
+#ifdef DO_SHA_ASM
+            if (shaAsm)
+                AsmTransform(data, times);
+#endif
             const word32 add = BLOCK_SIZE * times;
             AddLength(add);
             len  -= add;
@@ -361,11 +491,18 @@ void SHA::Update(const byte* data, word32 len)
     }
 }
 
-#endif // DO_SHA_ASM
+#endif // DO_SHA_ASM || DO_SHA_NI
 
 
 void SHA::Transform()
 {
+#ifdef DO_SHA_NI
+    if (UseShaNi()) {
+        ShaNiTransform(digest_, reinterpret_cast<byte*>(buffer_), 1, true);
+        return;
+    }
+#endif
+
     word32 W[BLOCK_SIZE / sizeof(word32)];
 
     // Copy context->state[] to working vars 
@@ -458,8 +595,78 @@ static const word32 K256[64] = {
 };
 
 
+#ifdef DO_SHA_NI
+
+// Blocks of message bytes, or of words already in host order when they come
+// from the buffer of the hash
+SHA_NI_TARGET
+static void ShaNiTransform256(word32* digest, const byte* data, word32 blocks,
+                              bool hostOrder)
+{
+    const __m128i order = hostOrder ?
+        _mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0) :
+        _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    // The rounds work on the state split as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(
+        _mm_loadu_si128((const __m128i*)digest), 0xB1);          // CDAB
+    __m128i state1 = _mm_shuffle_epi32(
+        _mm_loadu_si128((const __m128i*)(digest + 4)), 0x1B);    // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);            // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);                 // CDGH
+
+    for (; blocks; blocks--, data += SHA256::BLOCK_SIZE) {
+        const __m128i abefSave = state0;
+        const __m128i cdghSave = state1;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; i++)
+            msg[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i*)data + i), order);
+
+        // Four rounds per group, the schedule of the following words is
+        // computed along
+        for (int i = 0; i < 16; i++) {
+            __m128i words = _mm_add_epi32(msg[i % 4],
+                _mm_loadu_si128((const __m128i*)(K256 + 4 * i)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+            if (i >= 3 && i <= 14) {
+                tmp = _mm_alignr_epi8(msg[i % 4], msg[(i + 3) % 4], 4);
+                msg[(i + 1) % 4] = _mm_sha256msg2_epu32(
+                    _mm_add_epi32(msg[(i + 1) % 4], tmp), msg[i % 4]);
+            }
+            words = _mm_shuffle_epi32(words, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, words);
+            if (i >= 1 && i <= 12)
+                msg[(i + 3) % 4] = _mm_sha256msg1_epu32(msg[(i + 3) % 4],
+                                                        msg[i % 4]);
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);                       // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);                    // DCHG
+    _mm_storeu_si128((__m128i*)digest,
+                     _mm_blend_epi16(tmp, state1, 0xF0));        // DCBA
+    _mm_storeu_si128((__m128i*)(digest + 4),
+                     _mm_alignr_epi8(state1, tmp, 8));           // HGFE
+}
+
+#endif // DO_SHA_NI
+
+
 static void Transform256(word32* digest_, word32* buffer_)
 {
+#ifdef DO_SHA_NI
+    if (UseShaNi()) {
+        ShaNiTransform256(digest_, reinterpret_cast<byte*>(buffer_), 1,
+                          true);
+        return;
+    }
+#endif
+
     const  word32* K = K256;
 
     word32 W[16];
@@ -499,6 +706,57 @@ static void Transform256(word32* digest_, word32* buffer_)
 #undef s1
 
 
+#ifdef DO_SHA_NI
+
+// Update digest with data of size len
+void SHA256::Update(const byte* data, word32 len)
+{
+    if (!UseShaNi()) {
+        HASHwithTransform::Update(data, len);
+        return;
+    }
+
+    byte* local = reinterpret_cast<byte*>(buffer_);
+
+    // remove buffered data if possible
+    if (buffLen_)  {
+        word32 add = min(len, BLOCK_SIZE - buffLen_);
+        memcpy(&local[buffLen_], data, add);
+
+        buffLen_ += add;
+        data     += add;
+        len      -= add;
+
+        if (buffLen_ == BLOCK_SIZE) {
+            ByteReverse(local, local, BLOCK_SIZE);
+            Transform();
+            AddLength(BLOCK_SIZE);
+            buffLen_ = 0;
+        }
+    }
+
+    // all at once for the sha extensions
+    if (buffLen_ == 0) {
+        word32 times = len / BLOCK_SIZE;
+        if (times) {
+            ShaNiTransform256(digest_, data, times, false);
+            const word32 add = BLOCK_SIZE * times;
+            AddLength(add);
+            len  -= add;
+            data += add;
+        }
+    }
+
+    // cache any data left
+    if (len) {
+        memcpy(&local[buffLen_], data, len);
+        buffLen_ += len;
+    }
+}
+
+#endif // DO_SHA_NI
+
+
 void SHA256::Transform()
 {
     Transform256(digest_, buffer_);
@@ -24,6 +24,8 @@
 #include "shellcore/shell_core.h"
 
 namespace mysqlsh {
+class ShellBaseResult;
+
 class SHCORE_PUBLIC Base_shell {
 public:
   Base_shell(const Shell_options &options, shcore::Interpreter_delegate *custom_delegate);
@@ -53,7 +55,13 @@ public:
   bool cmd_quit(const std::vector<std::string>& args);
   bool cmd_warnings(const std::vector<std::string>& args);
   bool cmd_nowarnings(const std::vector<std::string>& args);
+  bool cmd_pager(const std::vector<std::string>& args);
+  bool cmd_nopager(const std::vector<std::string>& args);
+  bool cmd_more(const std::vector<std::string>& args);
   bool cmd_status(const std::vector<std::string>& args);
+  bool cmd_stats(const std::vector<std::string>& args);
+  bool cmd_profile(const std::vector<std::string>& args);
+  bool cmd_index_advisor(const std::vector<std::string>& args);
   bool cmd_use(const std::vector<std::string>& args);
 
   void print_connection_message(mysqlsh::SessionType type, const std::string& uri, const std::string& sessionid);
@@ -62,6 +70,9 @@ public:
   void set_log_level(ngcommon::Logger::LOG_LEVEL level) { if (_logger) _logger->set_log_level(level); }
 
   void process_line(const std::string &line);
+  // Text pasted at once on the prompt: the code lines between the shell
+  // commands are given to the interpreter together rather than one by one
+  void process_paste(const std::string &text);
   void abort();
   std::string prompt();
 
@@ -71,8 +82,12 @@ protected:
   mysqlsh::Shell_options _options;
   std::shared_ptr<shcore::Shell_core> _shell;
 
+  // The shells built on this one add their own commands to it
+  shcore::Shell_command_handler _shell_command_handler;
+
 private:
   void process_result(shcore::Value result);
+  void dump_result(std::shared_ptr<mysqlsh::ShellBaseResult> resultset, bool resume = false);
   ngcommon::Logger* _logger;
 
   bool switch_shell_mode(shcore::Shell_core::Mode mode, const std::vector<std::string> &args);
@@ -85,11 +100,15 @@ private:
   bool do_shell_command(const std::string &command);
 private:
   shcore::Interpreter_delegate _delegate;
+  shcore::Interpreter_delegate *_client_delegate;
 
   std::string _input_buffer;
   shcore::Input_state _input_mode;
 
-  shcore::Shell_command_handler _shell_command_handler;
+  // The last result cut by resultPreviewLimit, until anything else is done
+  std::shared_ptr<mysqlsh::ShellBaseResult> _preview_result;
+  shcore::Value _preview_record;
+  size_t _preview_rows;
 };
 }
 #endif
@@ -42,6 +42,8 @@ public:
   std::string schema;
   std::string sock;
   std::string auth_method;
+  // Algorithm of the X protocol compression, empty if disabled
+  std::string compression;
 
   std::string protocol;
 
@@ -56,15 +58,21 @@ public:
   bool print_cmd_line_helper;
   bool print_version;
   bool force;
+  int batch_pipeline;
+  int batch_commit;
   bool interactive;
   bool full_interactive;
   bool passwords_from_stdin;
   bool prompt_password;
   bool recreate_database;
   bool trace_protocol;
+  std::string trace_protocol_file;
   bool log_to_stderr;
   std::string execute_statement;
   std::string execute_dba_statement;
+  // Unix sockets of --daemon and --client, empty when not given
+  std::string daemon_socket;
+  std::string client_socket;
   ngcommon::Logger::LOG_LEVEL log_level;
   bool wizards;
   bool admin_mode;
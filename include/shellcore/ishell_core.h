@@ -73,6 +73,11 @@ public:
   virtual int process_stream(std::istream& stream, const std::string& source,
       std::function<void(shcore::Value)> result_processor,
       const std::vector<std::string> &argv) = 0;
+  // Processes the file mapped in memory, throws std::runtime_error if it
+  // can not be opened
+  virtual int process_file(const std::string& path,
+      std::function<void(shcore::Value)> result_processor,
+      const std::vector<std::string> &argv) = 0;
 
   // Development Session Handling
   virtual std::shared_ptr<mysqlsh::ShellDevelopmentSession> connect_dev_session(const Argument_list &args, mysqlsh::SessionType session_type) = 0;
@@ -23,6 +23,8 @@
 #include "shellcore/types.h"
 #include <shellcore/include_v8.h>
 
+#include <unordered_map>
+
 namespace shcore {
 class JScript_context;
 
@@ -31,6 +33,7 @@ public:
   JScript_array_wrapper(JScript_context *context);
   ~JScript_array_wrapper();
 
+  // The same array always gets the same wrapper while it is alive in JS
   v8::Handle<v8::Object> wrap(std::shared_ptr<Value::Array_type> array);
 
   static bool unwrap(v8::Handle<v8::Object> value, std::shared_ptr<Value::Array_type> &ret_array);
@@ -46,6 +49,7 @@ private:
 private:
   JScript_context *_context;
   v8::Persistent<v8::ObjectTemplate> _array_template;
+  std::unordered_map<Value::Array_type*, Collectable*> _wrappers;
 };
 };
 
@@ -52,6 +52,10 @@ public:
 
   void set_global_item(const std::string& global_name, const std::string& item_name, const Value &value);
 
+  // A step of garbage collection while the shell is idle, taking about the
+  // given milliseconds. Returns false once there is nothing left to collect.
+  bool idle(int milliseconds);
+
 private:
   struct JScript_context_impl;
   JScript_context_impl *_impl;
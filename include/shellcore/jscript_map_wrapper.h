@@ -23,6 +23,8 @@
 #include "shellcore/types.h"
 #include "shellcore/include_v8.h"
 
+#include <unordered_map>
+
 namespace shcore {
 class JScript_context;
 
@@ -31,6 +33,7 @@ public:
   JScript_map_wrapper(JScript_context *context);
   ~JScript_map_wrapper();
 
+  // The same map always gets the same wrapper while it is alive in JS
   v8::Handle<v8::Object> wrap(std::shared_ptr<Value::Map_type> map);
 
   static bool unwrap(v8::Handle<v8::Object> value, std::shared_ptr<Value::Map_type> &ret_map);
@@ -47,6 +50,7 @@ private:
 private:
   JScript_context *_context;
   v8::Persistent<v8::ObjectTemplate> _map_template;
+  std::unordered_map<Value::Map_type*, Collectable*> _wrappers;
 };
 };
 
@@ -20,7 +20,10 @@
 // Provides a generic wrapper for shcore::Object_bridge objects so that they
 // can be used from JavaScript
 
-// new_instance() can be used to create a JS object instance per class
+// The bridger of the context owns one wrapper for the plain objects and one
+// for the indexed ones, each with its object template created once, so
+// wrapping an object (i.e. every row of a result) is just an instance of the
+// template with the object set on its internal fields
 
 #ifndef _JSCRIPT_OBJECT_WRAPPER_H_
 #define _JSCRIPT_OBJECT_WRAPPER_H_
@@ -55,6 +58,8 @@ private:
 
 private:
   JScript_context *_context;
+  // Shared by all the wrapped objects, the members are resolved by the
+  // interceptors on the object itself
   v8::Persistent<v8::ObjectTemplate> _object_template;
 };
 };
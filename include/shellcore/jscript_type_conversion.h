@@ -23,6 +23,8 @@
 #include "shellcore/types.h"
 #include "shellcore/include_v8.h"
 
+#include <unordered_map>
+
 namespace shcore {
 class JScript_context;
 
@@ -45,6 +47,16 @@ struct JScript_type_bridger {
 
   JScript_context *owner;
 
+private:
+  // JS objects and arrays already converted within a single conversion, by
+  // their identity hash, so data referenced from several places is only
+  // converted once
+  typedef std::unordered_multimap<int, std::pair<v8::Handle<v8::Object>, Value> > Converted;
+
+  Value v8_value_to_shcore_value(const v8::Handle<v8::Value> &value, Converted *converted);
+
+public:
+
   class JScript_object_wrapper *object_wrapper;
   class JScript_object_wrapper *indexed_object_wrapper;
   class JScript_function_wrapper *function_wrapper;
@@ -171,6 +171,9 @@ public:
   bool is_module(const std::string& file_name);
   Value execute_module(const std::string& file_name, const std::vector<std::string> &argv);
 
+  // Collects the garbage of the given generation and the younger ones
+  void collect_garbage(int generation);
+
   Value pyobj_to_shcore_value(PyObject *value);
   PyObject *shcore_value_to_pyobj(const Value &value);
 
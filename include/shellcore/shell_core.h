@@ -26,7 +26,12 @@
 #include "shellcore/shell_core_options.h"
 #include "shellcore/shell_notifications.h"
 #include <boost/system/error_code.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <list>
+#include <mutex>
+#include <thread>
 
 #include <iostream>
 
@@ -89,6 +94,13 @@ public:
 
   virtual std::string preprocess_input_line(const std::string &s) { return s; }
   virtual void handle_input(std::string &code, Input_state &state, std::function<void(shcore::Value)> result_processor) = 0;
+  // Handles a whole script held in memory, i.e. a mapped file
+  virtual void handle_script(const char *data, size_t size, Input_state &state, std::function<void(shcore::Value)> result_processor) {
+    std::string code(data, size);
+    handle_input(code, state, result_processor);
+  }
+  // Called once the stream or file being processed ended
+  virtual void end_input(std::function<void(shcore::Value)> UNUSED(result_processor)) {}
   virtual bool handle_shell_command(const std::string &code) { return _shell_command_handler.process(code); }
   virtual std::string get_handled_input() { return _last_handled; }
   virtual std::string prompt() = 0;
@@ -96,7 +108,14 @@ public:
   virtual void abort() = 0;
   virtual bool is_module(const std::string& UNUSED(file_name)) { return false; }
   virtual void execute_module(const std::string& UNUSED(file_name), std::function<void(shcore::Value)> UNUSED(result_processor)) { /* Does Nothing by default*/ }
+  // Work done while the shell waits for input, like collecting the garbage
+  // of the last one. Called after each input with step 0, 1... until it
+  // returns false, each step should take about the given milliseconds.
+  virtual bool idle(int UNUSED(step), int UNUSED(milliseconds)) { return false; }
 protected:
+  // Kills the statement running on the global session, if any
+  void kill_running_query();
+
   bool _killed;
   IShell_core *_owner;
   std::string _last_handled;
@@ -142,6 +161,9 @@ public:
   virtual int process_stream(std::istream& stream, const std::string& source,
       std::function<void(shcore::Value)> result_processor,
       const std::vector<std::string> &argv);
+  virtual int process_file(const std::string& path,
+      std::function<void(shcore::Value)> result_processor,
+      const std::vector<std::string> &argv);
   virtual bool is_module(const std::string &file_name) { return _langs[_mode]->is_module(file_name); }
   virtual void execute_module(const std::string &file_name, std::function<void(shcore::Value)> result_processor, const std::vector<std::string> &argv);
 
@@ -154,6 +176,11 @@ public:
 
   // To be used to stop processing from caller
   void set_error_processing() { _global_return_code = 1; }
+
+  // Runs a step of the idle work of the languages while the shell waits for
+  // input, false once nothing is left until the next input. The heap is
+  // trimmed after the last step.
+  bool idle(int milliseconds);
 public:
   virtual void print(const std::string &s);
   void println(const std::string &s = "", const std::string& tag = "");
@@ -181,12 +208,18 @@ private:
   virtual void handle_notification(const std::string &name, const shcore::Object_bridge_ref& sender, shcore::Value::Map_type_ref data);
   void set_dba_global();
   void set_shell_global();
+  void set_scripting_globals();
   void init_sql();
   void init_js();
   void init_py();
 
   bool reconnect();
 
+  // Keep-alive of the global session, see SHCORE_KEEP_ALIVE_INTERVAL
+  void start_keep_alive();
+  void stop_keep_alive();
+  void keep_alive();
+
 private:
   Object_registry *_registry;
   std::map<std::string, std::pair<Mode, Value> > _globals;
@@ -201,7 +234,22 @@ private:
   Mode _mode;
   int _global_return_code;
   bool _running_query;
-  bool _reconnect_session;
+  std::atomic<bool> _reconnect_session;
+  bool _scripting_globals_set;
+
+  // Held while the global session is in use, the keep-alive only pings it
+  // when it can take it right away
+  std::recursive_mutex _session_mutex;
+  std::chrono::steady_clock::time_point _last_activity;
+  std::atomic<int> _keep_alive_interval;
+  std::thread _keep_alive_thread;
+  std::mutex _keep_alive_mutex;
+  std::condition_variable _keep_alive_cond;
+  bool _keep_alive_stop;
+
+  // The languages with idle work left since the last input
+  std::vector<Shell_language*> _idle_languages;
+  int _idle_step;
 };
 };
 
@@ -36,14 +36,105 @@
 
 #define SHCORE_SANDBOX_DIR "sandboxDir"
 
+// Prints query results as they are fetched instead of buffering them first
+#define SHCORE_OUTPUT_STREAMING "outputStreaming"
+
+// Number of SQL statements sent ahead of their results on batch processing
+#define SHCORE_BATCH_PIPELINE "batchPipeline"
+
+// Number of consecutive DML statements committed together on batch
+// processing, 0 commits each one on its own as the server does
+#define SHCORE_BATCH_COMMIT "batchCommit"
+
+// Seconds of inactivity after which the global session is pinged, and
+// reconnected if it was lost, 0 disables the keep-alive
+#define SHCORE_KEEP_ALIVE_INTERVAL "keepAliveInterval"
+
+// Megabytes of each data set kept in memory when a result is buffered, the
+// rest goes to a temporary file, 0 keeps everything in memory
+#define SHCORE_RESULT_BUFFER_MEMORY "resultBufferMemory"
+
+// Megabytes the buffered results, the values built from results and the
+// JavaScript heap may use together, 0 means no limit. Buffered rows past it
+// go to a temporary file, anything else fails with an error.
+#define SHCORE_MEMORY_BUDGET "memoryBudget"
+
+// Rows of each data set printed by an interactive result, the rest are
+// printed on demand with \more, 0 prints them all
+#define SHCORE_RESULT_PREVIEW_LIMIT "resultPreviewLimit"
+
+// Limits of the values printed by the interactive shell, the nesting
+// depth, the entries of each list or dictionary and the bytes printed, 0
+// means no limit
+#define SHCORE_PRINT_MAX_DEPTH "printMaxDepth"
+#define SHCORE_PRINT_MAX_ELEMENTS "printMaxElements"
+#define SHCORE_PRINT_MAX_BYTES "printMaxBytes"
+
+// Command the interactive results are piped to once fully read, empty
+// prints them directly
+#define SHCORE_PAGER "pager"
+
+// Seconds an AdminAPI operation may take, and each of its steps (a query on
+// an instance, a mysqlprovision command), 0 for no limit
+#define SHCORE_DBA_OPERATION_TIMEOUT "dbaOperationTimeout"
+#define SHCORE_DBA_STEP_TIMEOUT "dbaStepTimeout"
+
+// File the steps of each AdminAPI operation are written to as a Chrome
+// trace, replaced by the next operation, empty disables the tracing
+#define SHCORE_DBA_TRACE_FILE "dbaTraceFile"
+
+// Milliseconds a statement or CRUD operation may take before it is written
+// to the slow statement log, with its plan, 0 disables the log. The log
+// file is rotated once it grows past 10MB, empty writes it to the user
+// config path.
+#define SHCORE_SLOW_STATEMENT_THRESHOLD "slowStatementThreshold"
+#define SHCORE_SLOW_STATEMENT_LOG "slowStatementLog"
+
+// How the values of the binary string columns are printed by the results:
+// hex (0x and two digits per byte), base64 or raw, the bytes as they are
+#define SHCORE_BINARY_AS "binaryAs"
+
 namespace shcore {
+// The options read on every statement or result, kept typed so those paths
+// do not look them up by name
+struct Typed_core_options {
+  // Ndjson is compact JSON with a line for each row of the results
+  enum class Output_format { Table, Vertical, Json, Json_raw, Ndjson, Arrow };
+  enum class Binary_format { Raw, Hex, Base64 };
+
+  bool json() const {
+    return output_format == Output_format::Json || output_format == Output_format::Json_raw ||
+           output_format == Output_format::Ndjson;
+  }
+
+  Output_format output_format;
+  Binary_format binary_as;
+  bool interactive;
+  bool show_warnings;
+  bool batch_continue_on_error;
+  bool output_streaming;
+  int batch_pipeline;
+  int batch_commit;
+  int64_t result_buffer_memory;
+  int64_t result_preview_limit;
+  int64_t slow_statement_threshold;
+};
+
 class SHCORE_PUBLIC  Shell_core_options :public shcore::Cpp_object_bridge {
 public:
   virtual ~Shell_core_options();
 
-  // Retrieves the options directly, to be used from C++
+  // Retrieves the options directly, to be used from C++. The map holds the
+  // options, the typed ones are read again from it once it changes.
   static Value::Map_type_ref get();
 
+  // The typed options, as of the last change to the map
+  static const Typed_core_options &typed();
+
+  // Changes an option from C++ and applies its side effects (i.e. the limit
+  // of the memory budget), unlike set_member() the value is not validated
+  static void set(const std::string &name, const Value &value);
+
   // Exposes the object to JS/PY to allow custom validations on options
   static std::shared_ptr<Shell_core_options> get_instance();
 
@@ -59,9 +150,13 @@ private:
   // Private constructor since this is a singleton
   Shell_core_options();
   void init();
+  void update_typed();
+  void option_changed(const std::string &name);
 
   // Options will be stored on a MAP
   Value::Map_type_ref _options;
+  Typed_core_options _typed;
+  uint64_t _typed_version;
 
   // The only available instance
   static std::shared_ptr<Shell_core_options> _instance;
@@ -35,6 +35,7 @@ public:
 
   virtual std::string prompt();
   virtual void abort();
+  virtual bool idle(int step, int milliseconds);
 private:
   std::shared_ptr<JScript_context> _js;
 };
@@ -23,6 +23,12 @@
 #include "shellcore/common.h"
 #include "shellcore/types.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace shcore {
 class SHCORE_PUBLIC NotificationObserver {
 public:
@@ -35,12 +41,18 @@ private:
   std::list<std::string> _notifications;
 };
 
-typedef std::list<NotificationObserver*> ObserverList;
+typedef std::vector<NotificationObserver*> ObserverList;
 
 class SHCORE_PUBLIC ShellNotifications {
 private:
-  ShellNotifications() {}
-  std::map<std::string, ObserverList*> _observers;
+  ShellNotifications() : _observer_count(0) {}
+
+  // Replaced as a whole on every change, so notifying reads it without
+  // taking a lock, from any thread
+  typedef std::unordered_map<std::string, ObserverList> Observer_map;
+  std::shared_ptr<const Observer_map> _observers;
+  std::mutex _observers_mutex;
+  std::atomic<int> _observer_count;
 
   static ShellNotifications* _instance;
 
@@ -50,15 +62,21 @@ public:
 
   bool add_observer(NotificationObserver *observer, const std::string &notification);
   bool remove_observer(NotificationObserver *observer, const std::string &notification);
+
+  // Lets the senders skip building the data of a notification nobody observes
+  bool has_observers(const std::string &name) const;
+
   void notify(const std::string &name, const shcore::Object_bridge_ref& sender, shcore::Value::Map_type_ref data);
   void notify(const std::string &name, const shcore::Object_bridge_ref& sender);
 };
 };
 
 #define DEBUG_NOTIFICATION(X) {\
-                                 shcore::Value::Map_type_ref data (new shcore::Value::Map_type());\
-                                 (*data)["value"] = shcore::Value(X);\
-                                 shcore::ShellNotifications::get()->notify("SN_DEBUGGER", shcore::Object_bridge_ref(), data);\
+                                 if (shcore::ShellNotifications::get()->has_observers("SN_DEBUGGER")) {\
+                                   shcore::Value::Map_type_ref data (new shcore::Value::Map_type());\
+                                   (*data)["value"] = shcore::Value(X);\
+                                   shcore::ShellNotifications::get()->notify("SN_DEBUGGER", shcore::Object_bridge_ref(), data);\
+                                 }\
                               }
 
 
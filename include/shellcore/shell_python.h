@@ -39,6 +39,7 @@ public:
   virtual void abort();
   virtual bool is_module(const std::string& file_name);
   virtual void execute_module(const std::string& file_name, std::function<void(shcore::Value)> result_processor);
+  virtual bool idle(int step, int milliseconds);
 private:
   std::shared_ptr<Python_context> _py;
 };
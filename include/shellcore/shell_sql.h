@@ -26,6 +26,14 @@
 #include "../utils/utils_mysql_parsing.h"
 #include <boost/system/error_code.hpp>
 #include <stack>
+#include <vector>
+
+namespace mysqlsh {
+class ShellDevelopmentSession;
+namespace mysqlx {
+class BaseSession;
+};
+};
 
 namespace shcore {
 class SHCORE_PUBLIC Shell_sql : public Shell_language {
@@ -36,6 +44,8 @@ public:
   virtual void set_global(const std::string &, const Value &) {}
 
   virtual void handle_input(std::string &code, Input_state &state, std::function<void(shcore::Value)> result_processor);
+  virtual void handle_script(const char *data, size_t size, Input_state &state, std::function<void(shcore::Value)> result_processor);
+  virtual void end_input(std::function<void(shcore::Value)> result_processor);
 
   virtual std::string prompt();
 
@@ -44,15 +54,57 @@ public:
   virtual void abort();
 
 private:
+  // Bytes of a script split at once and statements executed at once
+  static const size_t k_script_window_size = 64 * 1024 * 1024;
+  static const size_t k_script_batch_size = 1000;
+  // Bytes of statements committed together at most with batchCommit
+  static const size_t k_batch_commit_bytes = 16 * 1024 * 1024;
+
+  // The splitter state carried from one input to the next: the text of the
+  // statement not yet terminated, the delimiters and the open quotes and
+  // comments, so every call only scans the new input
   std::string _sql_cache;
   mysql::splitter::Delimiters _delimiters;
   std::stack<std::string> _parsing_context_stack;
 
+  // With batchCommit, the session runs with autocommit off during a run of
+  // DML statements, which are kept until committed to replay them one by
+  // one if any of them fails. Runs are not started within a transaction of
+  // the script. autocommit is -1 when not known.
+  std::weak_ptr<mysqlsh::ShellDevelopmentSession> _batch_session;
+  bool _batch_open;
+  std::vector<std::string> _batch;
+  size_t _batch_bytes;
+  int _autocommit;
+  bool _script_transaction;
+
+  bool add_statements(const char *code, const std::vector<mysql::splitter::Statement_range> &ranges,
+      std::vector<std::pair<std::string, std::string> > &statements);
+
+  Value execute_sql(const std::string &query_str, std::shared_ptr<mysqlsh::ShellDevelopmentSession> session);
+
   Value process_sql(const std::string &query_str,
       mysql::splitter::Delimiters::delim_type_t delimiter,
       std::shared_ptr<mysqlsh::ShellDevelopmentSession> session,
       std::function<void(shcore::Value)> result_processor);
 
+  Value execute_statements(const std::vector<std::pair<std::string, std::string> > &statements,
+      std::shared_ptr<mysqlsh::ShellDevelopmentSession> session,
+      std::function<void(shcore::Value)> result_processor);
+
+  Value process_sql_batched(const std::string &query_str,
+      mysql::splitter::Delimiters::delim_type_t delimiter,
+      std::shared_ptr<mysqlsh::ShellDevelopmentSession> session,
+      std::function<void(shcore::Value)> result_processor);
+  bool begin_batch(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session);
+  bool end_batch(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session);
+  bool replay_batch(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session);
+
+  Value process_sql_pipelined(const std::vector<std::pair<std::string, std::string> > &statements,
+      size_t pipeline_depth,
+      std::shared_ptr<mysqlsh::mysqlx::BaseSession> session,
+      std::function<void(shcore::Value)> result_processor);
+
   void cmd_process_file(const std::vector<std::string>& params);
 };
 };
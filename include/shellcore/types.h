@@ -22,15 +22,20 @@
 
 #include "types_common.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <map>
 #include <set>
 #include <string>
 #include <stdexcept>
+#include <utility>
 
 #include <boost/function.hpp>
 
 #include "shellcore/common.h"
+#include "utils/utils_arena.h"
 #include "utils/utils_json.h"
 
 namespace shcore {
@@ -85,9 +90,14 @@ struct SHCORE_PUBLIC Value {
   typedef std::vector<Value> Array_type;
   typedef std::shared_ptr<Array_type> Array_type_ref;
 
+  // Dictionary of values, stored as a vector of entries sorted by key.
+  // Documents and option maps hold a few keys that are mostly inserted in
+  // bulk and then read, so a single contiguous block searched by bisection
+  // avoids the per node allocations of a tree while keeping the iteration
+  // in key order, i.e. the JSON output does not change.
   class SHCORE_PUBLIC Map_type {
   public:
-    typedef std::map<std::string, Value> container_type;
+    typedef std::vector<std::pair<std::string, Value> > container_type;
     typedef container_type::const_iterator const_iterator;
     typedef container_type::iterator iterator;
 
@@ -116,34 +126,106 @@ struct SHCORE_PUBLIC Value {
       return iter->second.as_object<C>();
     }
 
-    const_iterator find(const std::string &k) const { return _map.find(k); }
-    iterator find(const std::string &k) { return _map.find(k); }
+    const_iterator find(const std::string &k) const {
+      const_iterator iter = lower_bound(k);
+      return (iter != _map.end() && iter->first == k) ? iter : _map.end();
+    }
+    iterator find(const std::string &k) {
+      ++_version;
+      iterator iter = lower_bound(k);
+      return (iter != _map.end() && iter->first == k) ? iter : _map.end();
+    }
 
-    void erase(const std::string &k) { _map.erase(k); }
-    void clear() { _map.clear(); }
+    void erase(const std::string &k) {
+      iterator iter = find(k);
+      if (iter != _map.end())
+        _map.erase(iter);
+    }
+    void clear() { ++_version; _map.clear(); }
 
     const_iterator begin() const { return _map.begin(); }
-    iterator begin() { return _map.begin(); }
+    iterator begin() { ++_version; return _map.begin(); }
 
     const_iterator end() const { return _map.end(); }
     iterator end() { return _map.end(); }
 
-    const container_type::mapped_type& at(const std::string &k) const { return _map.at(k); }
-    container_type::mapped_type& operator [](const std::string &k) { return _map[k]; }
+    const Value& at(const std::string &k) const {
+      const_iterator iter = find(k);
+      if (iter == _map.end())
+        throw std::out_of_range("Map_type::at");
+      return iter->second;
+    }
+    Value& operator [](const std::string &k) {
+      ++_version;
+      iterator iter = lower_bound(k);
+      if (iter == _map.end() || iter->first != k)
+        iter = _map.insert(iter, std::make_pair(k, Value()));
+      return iter->second;
+    }
     bool operator == (const Map_type &other) const { return _map == other._map; }
 
     bool empty() const { return _map.empty(); }
     size_t size() const { return _map.size(); }
-    size_t count(const std::string &k) const { return _map.count(k); }
+    size_t count(const std::string &k) const { return find(k) != end() ? 1 : 0; }
+
+    // Reserves space for the given number of entries
+    void reserve(size_t n) { _map.reserve(n); }
+
+    // Changes on every access that may modify the map, so a copy of its
+    // contents can tell whether it is out of date
+    uint64_t version() const { return _version; }
   private:
+    static bool key_less(const container_type::value_type &entry, const std::string &k) {
+      return entry.first < k;
+    }
+    const_iterator lower_bound(const std::string &k) const { return std::lower_bound(_map.begin(), _map.end(), k, key_less); }
+    iterator lower_bound(const std::string &k) { return std::lower_bound(_map.begin(), _map.end(), k, key_less); }
+
     container_type _map;
+    uint64_t _version = 0;
   };
   typedef std::shared_ptr<Map_type> Map_type_ref;
 
+  // String values are immutable and reference counted, copies of a String
+  // Value share the same data instead of allocating their own copy. Within
+  // an Arena_scope the data comes from the arena of the scope.
+  struct String_data {
+    template <typename... Args>
+    static String_data *create(Args&&... args) {
+      Arena *arena = Arena::current();
+      if (!arena)
+        return new String_data(nullptr, std::forward<Args>(args)...);
+
+      void *memory = arena->allocate(sizeof(String_data), alignof(String_data));
+      return new (memory) String_data(arena, std::forward<Args>(args)...);
+    }
+
+    String_data *acquire() { refs.fetch_add(1, std::memory_order_relaxed); return this; }
+    void release() {
+      if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (Arena *owner = arena) {
+          this->~String_data();
+          owner->deallocate(this);
+        } else {
+          delete this;
+        }
+      }
+    }
+
+    std::atomic<size_t> refs;
+    Arena *const arena;
+    const std::string str;
+
+  private:
+    String_data(Arena *a, const std::string &s) : refs(1), arena(a), str(s) {}
+    String_data(Arena *a, std::string &&s) : refs(1), arena(a), str(std::move(s)) {}
+    String_data(Arena *a, const char *s, size_t n) : refs(1), arena(a), str(s, n) {}
+  };
+
   Value_type type;
   union {
     bool b;
-    std::string *s;
+    String_data *s;
     int64_t i;
     uint64_t ui;
     double d;
@@ -156,8 +238,10 @@ struct SHCORE_PUBLIC Value {
 
   Value() : type(Undefined) {}
   Value(const Value &copy);
+  Value(Value &&other) noexcept : type(other.type), value(other.value) { other.type = Undefined; }
 
   explicit Value(const std::string &s);
+  explicit Value(std::string &&s);
   explicit Value(const char *);
   explicit Value(const char *, size_t n);
   explicit Value(int i);
@@ -177,8 +261,9 @@ struct SHCORE_PUBLIC Value {
   template<class T>
   static Value wrap(T *o) { return Value(std::static_pointer_cast<Object_bridge>(std::shared_ptr<T>(o))); }
 
-  static Value new_array() { return Value(std::shared_ptr<Array_type>(new Array_type())); }
-  static Value new_map() { return Value(std::shared_ptr<Map_type>(new Map_type())); }
+  // Empty containers, from the arena of the current Arena_scope if any
+  static Value new_array();
+  static Value new_map();
 
   static Value Null() { Value v; v.type = shcore::Null; return v; }
   static Value True() { Value v; v.type = shcore::Bool; v.value.b = true; return v; }
@@ -187,14 +272,29 @@ struct SHCORE_PUBLIC Value {
   //! parse a string returned by repr() back into a Value
   static Value parse(const std::string &s);
 
+  //! parse a strict JSON document into a Value, faster than parse() but
+  // without support for the repr() only syntax (single quotes, undefined...)
+  static Value parse_json(const char *data, size_t length);
+  static Value parse_json(const std::string &s) { return parse_json(s.data(), s.size()); }
+
   ~Value();
 
   Value &operator= (const Value &other);
+  Value &operator= (Value &&other) noexcept {
+    std::swap(type, other.type);
+    std::swap(value, other.value);
+    return *this;
+  }
 
   bool operator == (const Value &other) const;
 
   bool operator != (const Value &other) const { return !(*this == other); }
 
+  // Structural hash, consistent with operator ==: numbers equal across types
+  // hash the same, and so do arrays and maps with equal contents. Objects
+  // only hash their class name.
+  size_t hash() const;
+
   operator bool() const {
     return type != Undefined && type != shcore::Null;
   }
@@ -218,7 +318,7 @@ struct SHCORE_PUBLIC Value {
   int64_t as_int() const;
   uint64_t as_uint() const;
   double as_double() const;
-  const std::string &as_string() const { check_type(String); return *value.s; }
+  const std::string &as_string() const { check_type(String); return value.s->str; }
   template<class C>
   std::shared_ptr<C> as_object() const { check_type(Object); return std::dynamic_pointer_cast<C>(*value.o); }
   std::shared_ptr<Object_bridge> as_object() const { check_type(Object); return std::dynamic_pointer_cast<Object_bridge>(*value.o); }
@@ -236,8 +336,45 @@ private:
   static Value parse_number(char **pc);
 };
 
+// Writes the description of a value, formatted as Value::descr(true) does,
+// in chunks to the output rather than into a single string. Printing stops
+// once the output reaches a limit, leaving a summary of what was left out:
+// containers nested deeper than max_depth show their size only, and only
+// the first max_elements entries of a container are shown. A limit of 0
+// means no limit.
+class SHCORE_PUBLIC Descr_printer {
+public:
+  typedef std::function<void(const std::string &chunk)> Output_handler;
+
+  Descr_printer(const Output_handler &output, size_t max_depth, size_t max_elements, size_t max_bytes,
+                size_t chunk_size = JSON_DUMPER_CHUNK_SIZE);
+
+  // Returns false if the description was cut short by a limit
+  bool print(const Value &value);
+
+private:
+  bool append(const Value &value, int indent, int quote_strings);
+  bool append(const std::string &text);
+  bool append_container(const Value &value, int indent);
+  void flush();
+
+  Output_handler _output;
+  size_t _max_depth;
+  size_t _max_elements;
+  size_t _max_bytes;
+  size_t _chunk_size;
+  std::string _buffer;
+  size_t _written;
+  bool _truncated;
+};
+
+// The arguments of a call. The first few are kept in the list itself, so the
+// calls to native functions (which rarely take more) do not allocate, the
+// rest move to the heap once they do not fit.
 class SHCORE_PUBLIC Argument_list {
 public:
+  Argument_list() : _count(0) {}
+
   const std::string &string_at(unsigned int i) const;
   bool bool_at(unsigned int i) const;
   int64_t int_at(unsigned int i) const;
@@ -264,18 +401,64 @@ public:
   void ensure_count(unsigned int minc, unsigned  int maxc, const char *context) const;
   void ensure_at_least(unsigned int minc, const char *context) const;
 
-  void push_back(const Value &value) { _args.push_back(value); }
-  void pop_back() { _args.pop_back(); }
-  size_t size() const { return _args.size(); }
-  const Value &at(size_t i) const { return _args.at(i); }
-  Value &operator [](size_t i) { return _args[i]; }
-  const Value &operator [](size_t i) const { return _args[i]; }
-  void clear() { _args.clear(); }
+  // Builds the argument in place, i.e. from the value of an interpreter
+  template<class... Args>
+  void emplace_back(Args&&... args) {
+    // Built first, the arguments may refer to an element being moved
+    Value value(std::forward<Args>(args)...);
+    if (_heap.empty() && _count < k_inline_args) {
+      _inline[_count++] = std::move(value);
+    } else {
+      spill();
+      _heap.push_back(std::move(value));
+    }
+  }
+  void push_back(const Value &value) { emplace_back(value); }
+  void push_back(Value &&value) { emplace_back(std::move(value)); }
+  void reserve(size_t count) {
+    if (count > k_inline_args)
+      _heap.reserve(count);
+  }
+  void pop_back() {
+    if (_heap.empty())
+      _inline[--_count] = Value();
+    else
+      _heap.pop_back();
+  }
+  size_t size() const { return _heap.empty() ? _count : _heap.size(); }
+  const Value &at(size_t i) const {
+    if (i >= size())
+      throw std::out_of_range("Argument_list::at");
+    return data()[i];
+  }
+  Value &operator [](size_t i) { return data()[i]; }
+  const Value &operator [](size_t i) const { return data()[i]; }
+  void clear() {
+    while (_count > 0)
+      _inline[--_count] = Value();
+    _heap.clear();
+  }
 
-  std::vector<Value>::const_iterator begin() const { return _args.begin(); }
-  std::vector<Value>::const_iterator end() const { return _args.end(); }
+  const Value *begin() const { return data(); }
+  const Value *end() const { return data() + size(); }
 private:
-  std::vector<Value> _args;
+  static const size_t k_inline_args = 4;
+
+  Value *data() { return _heap.empty() ? _inline : _heap.data(); }
+  const Value *data() const { return _heap.empty() ? _inline : _heap.data(); }
+
+  void spill() {
+    if (!_heap.empty())
+      return;
+    _heap.reserve(2 * k_inline_args);
+    for (size_t i = 0; i < _count; i++)
+      _heap.push_back(std::move(_inline[i]));
+    _count = 0;
+  }
+
+  Value _inline[k_inline_args];
+  size_t _count;
+  std::vector<Value> _heap;
 };
 
 class SHCORE_PUBLIC Argument_map
@@ -468,4 +651,11 @@ public:
 bool my_strnicmp(const char *c1, const char *c2, size_t n);
 }
 
+namespace std {
+template<>
+struct hash<shcore::Value> {
+  size_t operator()(const shcore::Value &value) const { return value.hash(); }
+};
+}
+
 #endif // _TYPES_H_
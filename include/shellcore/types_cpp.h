@@ -33,8 +33,8 @@ enum NamingStyle {
 class SHCORE_PUBLIC Cpp_property_name {
 public:
   Cpp_property_name(const std::string &name, bool constant = false);
-  std::string name(const NamingStyle& style);
-  std::string base_name();
+  const std::string &name(const NamingStyle& style) const { return _name[style]; }
+  const std::string &base_name() const { return _name[LowerCamelCase]; }
 
 private:
 
@@ -50,7 +50,7 @@ public:
   virtual ~Cpp_function() {}
 
   virtual std::string name();
-  virtual std::string name(const NamingStyle& style);
+  virtual const std::string &name(const NamingStyle& style) const { return _name[style]; }
 
   virtual std::vector<std::pair<std::string, Value_type> > signature();
 
@@ -62,16 +62,16 @@ public:
 
   virtual bool has_var_args() { return _var_args; }
 
-  static std::shared_ptr<Function_base> create(const std::string &name, const Function &func, const char *arg1_name, Value_type arg1_type = Undefined, ...);
+  static std::shared_ptr<Function_base> create(const std::string &name, Function func, const char *arg1_name, Value_type arg1_type = Undefined, ...);
 
-  static std::shared_ptr<Function_base> create(const std::string &name, const Function &func, const std::vector<std::pair<std::string, Value_type> > &signature);
+  static std::shared_ptr<Function_base> create(const std::string &name, Function func, std::vector<std::pair<std::string, Value_type> > signature);
 
 protected:
   friend class Cpp_object_bridge;
 
-  Cpp_function(const std::string &name, const Function &func, bool var_args);
-  Cpp_function(const std::string &name, const Function &func, const char *arg1_name, Value_type arg1_type = Undefined, ...);
-  Cpp_function(const std::string &name, const Function &func, const std::vector<std::pair<std::string, Value_type> > &signature);
+  Cpp_function(const std::string &name, Function func, bool var_args);
+  Cpp_function(const std::string &name, Function func, const char *arg1_name, Value_type arg1_type = Undefined, ...);
+  Cpp_function(const std::string &name, Function func, std::vector<std::pair<std::string, Value_type> > signature);
 
   // Each instance holds it's names on the different styles
   std::string _name[2];
@@ -150,13 +150,45 @@ protected:
   // Returns the base name of the given member
   std::string get_base_name(const std::string& member) const;
 
-  typedef std::pair< std::string, std::shared_ptr<Cpp_function> > FunctionEntry;
-  std::map<std::string, std::shared_ptr<Cpp_function> > _funcs;
+  typedef std::pair< const std::string, std::shared_ptr<Cpp_function> > FunctionEntry;
+  typedef std::map<std::string, std::shared_ptr<Cpp_function> > FunctionMap;
+  FunctionMap _funcs;
+
+  // Returns the function with the given name on the given naming style, or
+  // _funcs.end() if there is none
+  FunctionMap::const_iterator find_function(const std::string &name, const NamingStyle &style) const;
   std::vector<std::shared_ptr<Cpp_property_name> > _properties;
 
   // The global active naming style
   NamingStyle naming_style;
 };
+
+// Implemented by bridged objects whose data is a contiguous array of fixed
+// size items, so the language bridges can expose it without copying (i.e.
+// through the Python buffer protocol). The data must not change while the
+// object is alive.
+class SHCORE_PUBLIC Cpp_buffer {
+public:
+  virtual ~Cpp_buffer() {}
+
+  virtual const void *buffer_data() const = 0;
+  virtual size_t item_count() const = 0;
+  virtual size_t item_size() const = 0;
+
+  // The item format as used by the Python struct module: q, Q, d or B
+  virtual const char *item_format() const = 0;
+};
+
+// Implemented by bridged objects that produce their values one at a time,
+// so the language bridges can traverse them natively (i.e. through the
+// Python iterator protocol). next_value() returns an undefined Value once
+// there are no more values.
+class SHCORE_PUBLIC Cpp_iterator {
+public:
+  virtual ~Cpp_iterator() {}
+
+  virtual Value next_value() = 0;
+};
 };
 
 #endif
@@ -45,6 +45,7 @@ void Global_dba::init() {
   add_method("createCluster", std::bind(&Global_dba::create_cluster, this, _1), "clusterName", shcore::String, NULL);
   add_method("dropMetadataSchema", std::bind(&Global_dba::drop_metadata_schema, this, _1), "data", shcore::Map, NULL);
   add_method("checkInstanceConfiguration", std::bind(&Global_dba::check_instance_configuration, this, _1), "data", shcore::Map, NULL);
+  add_varargs_method("checkInstancesConfiguration", std::bind(&Global_dba::check_instances_configuration, this, _1));
   add_method("configureLocalInstance", std::bind(&Global_dba::configure_local_instance, this, _1), "data", shcore::Map, NULL);
 }
 
@@ -54,14 +55,8 @@ mysqlsh::dba::ReplicationGroupState Global_dba::check_preconditions(const std::s
   return dba->check_preconditions(function_name);
 }
 
-std::vector<std::pair<std::string, std::string>> Global_dba::get_replicaset_instances_status(std::string *out_cluster_name,
-          const shcore::Value::Map_type_ref &options) const {
-  ScopedStyle ss(_target.get(), naming_style);
-  auto dba = std::dynamic_pointer_cast<mysqlsh::dba::Dba>(_target);
-  return dba->get_replicaset_instances_status(out_cluster_name, options);
-}
-
-void Global_dba::validate_instances_status_reboot_cluster(const shcore::Argument_list &args) const {
+std::vector<mysqlsh::dba::Dba::Instance_state> Global_dba::validate_instances_status_reboot_cluster(
+          const shcore::Argument_list &args) const {
   ScopedStyle ss(_target.get(), naming_style);
   auto dba = std::dynamic_pointer_cast<mysqlsh::dba::Dba>(_target);
   return dba->validate_instances_status_reboot_cluster(args);
@@ -490,12 +485,11 @@ shcore::Value Global_dba::reboot_cluster_from_complete_outage(const shcore::Argu
       println("Reconfiguring the cluster '" + cluster_name + "' from complete outage...");
     }
 
-    // Verify the status of the instances
-    validate_instances_status_reboot_cluster(args);
-
-    // Get the all the instances and their status
-    std::vector<std::pair<std::string, std::string>> instances_status
-        = get_replicaset_instances_status(&cluster_name, options);
+    // Verify the status of the instances, which also gives all the
+    // instances and whether they are reachable
+    std::vector<std::pair<std::string, std::string>> instances_status;
+    for (auto &state : validate_instances_status_reboot_cluster(args))
+      instances_status.emplace_back(state.address, state.error);
 
     // Validate the rejoinInstances list if provided
     if (!confirm_rescan_rejoins) {
@@ -764,6 +758,74 @@ shcore::Value Global_dba::check_instance_configuration(const shcore::Argument_li
   return ret_val;
 }
 
+shcore::Value Global_dba::check_instances_configuration(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+  std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
+
+  args.ensure_count(1, 2, get_function_name("checkInstancesConfiguration").c_str());
+
+  shcore::Value::Map_type_ref options(new shcore::Value::Map_type());
+  if (args.size() == 2)
+    *options = *args.map_at(1);
+
+  // The checks run on other threads and can not prompt, a password missing
+  // on any of the instances is asked once for all of them
+  if (!options->has_key("password") && !options->has_key("dbPassword")) {
+    for (auto &instance : *args.array_at(0)) {
+      shcore::Argument_list instance_args;
+      instance_args.push_back(instance);
+      auto instance_def = mysqlsh::dba::get_instance_options_map(instance_args, mysqlsh::dba::PasswordFormat::NONE);
+
+      if (!instance_def->has_key("password") && !instance_def->has_key("dbPassword")) {
+        std::string answer;
+        if (_delegate->password(_delegate->user_data, "Please provide the password for the instances: ", answer))
+          (*options)["password"] = shcore::Value(answer);
+        break;
+      }
+    }
+  }
+
+  shcore::Argument_list new_args;
+  new_args.push_back(args[0]);
+  if (options->size())
+    new_args.push_back(shcore::Value(options));
+
+  println("Validating instances...");
+  println();
+
+  ret_val = call_target("checkInstancesConfiguration", new_args);
+
+  if (format.find("json") != std::string::npos)
+    print_value(ret_val, "");
+  else {
+    auto instances = ret_val.as_map()->get_map("instances");
+
+    for (auto &instance : *instances) {
+      if (instance.second.as_map()->get_string("status") == "ok")
+        println("The instance '" + instance.first + "' is valid for Cluster usage");
+      else
+        println("The instance '" + instance.first + "' is not valid for Cluster usage.");
+    }
+
+    for (auto &instance : *instances) {
+      auto result = instance.second.as_map();
+      if (result->get_string("status") != "ok") {
+        println();
+        println("Issues found on '" + instance.first + "':");
+        print_validation_results(result);
+      }
+    }
+
+    if (ret_val.as_map()->get_string("status") != "ok") {
+      println();
+      println("Please fix these issues and try again.");
+      println();
+    }
+  }
+
+  return ret_val;
+}
+
 bool Global_dba::resolve_cnf_path(const shcore::Argument_list& connection_args,
                                   const shcore::Value::Map_type_ref& extra_options) {
   // Path is not given, let's try to autodetect it
@@ -24,6 +24,7 @@
 #define _INTERACTIVE_GLOBAL_DBA_H_
 
 #include "shellcore/interactive_object_wrapper.h"
+#include "modules/adminapi/mod_dba.h"
 #include "modules/adminapi/mod_dba_common.h"
 
 namespace shcore {
@@ -45,13 +46,13 @@ public:
   shcore::Value get_cluster(const shcore::Argument_list &args);
   shcore::Value drop_metadata_schema(const shcore::Argument_list &args);
   shcore::Value check_instance_configuration(const shcore::Argument_list &args);
+  shcore::Value check_instances_configuration(const shcore::Argument_list &args);
   shcore::Value configure_local_instance(const shcore::Argument_list &args);
 
 private:
   mysqlsh::dba::ReplicationGroupState check_preconditions(const std::string& function_name) const;
-  std::vector<std::pair<std::string, std::string>> get_replicaset_instances_status(std::string *out_cluster_name,
-          const shcore::Value::Map_type_ref &options) const;
-  void validate_instances_status_reboot_cluster(const shcore::Argument_list &args) const;
+  std::vector<mysqlsh::dba::Dba::Instance_state> validate_instances_status_reboot_cluster(
+          const shcore::Argument_list &args) const;
   shcore::Argument_list check_instance_op_params(const shcore::Argument_list &args, const std::string& function_name);
   shcore::Value perform_instance_operation(const shcore::Argument_list &args, const std::string &fname, const std::string& progressive, const std::string& past);
   void dump_table(const std::vector<std::string>& column_names, const std::vector<std::string>& column_labels, shcore::Value::Array_type_ref documents);
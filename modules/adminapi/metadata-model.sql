@@ -29,7 +29,7 @@ USE mysql_innodb_cluster_metadata;
   The major, minor and patch version of the schema representing the semantic
   version of the schema that is in use
 */
-CREATE VIEW schema_version (major, minor, patch) AS SELECT 1, 0, 1;
+CREATE VIEW schema_version (major, minor, patch) AS SELECT 1, 0, 2;
 
 /*
   This table contain information about the metadata and is used to identify
@@ -151,7 +151,10 @@ CREATE TABLE hosts (
       sshUserName: <..>
     }
   */
-  `admin_user_account` JSON
+  `admin_user_account` JSON,
+  /* The hosts are looked up by name or address when instances are added */
+  INDEX (host_name),
+  INDEX (ip_address)
 ) CHARSET = utf8mb4;
 
 /*
@@ -201,6 +204,13 @@ CREATE TABLE instances (
     }
   */
   `addresses` JSON NOT NULL,
+  /*
+    The mysqlClassic address, the instances are looked up by it. The index
+    is used by the queries comparing JSON_UNQUOTE(addresses->'$.mysqlClassic')
+    as that is the expression of the column.
+  */
+  `mysql_classic_address` VARCHAR(265) CHARACTER SET utf8mb4 COLLATE utf8mb4_bin
+      AS (JSON_UNQUOTE(addresses->'$.mysqlClassic')) VIRTUAL,
   /*
     Contain attributes assigned to the server and is a JSON data type with
     key-value pair. The attributes can be used to tag the servers with custom
@@ -215,6 +225,7 @@ CREATE TABLE instances (
   `version_token` INTEGER UNSIGNED,
   /* An optional brief description of the group. */
   `description` TEXT,
+  INDEX (mysql_classic_address),
   FOREIGN KEY (host_id) REFERENCES hosts(host_id) ON DELETE RESTRICT,
   FOREIGN KEY (replicaset_id) REFERENCES replicasets(replicaset_id) ON DELETE SET NULL
 ) CHARSET = utf8mb4;
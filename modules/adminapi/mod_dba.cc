@@ -18,7 +18,12 @@
  */
 
 #include <string>
+#include <atomic>
 #include <random>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #ifndef WIN32
 #include <sys/un.h>
 #endif
@@ -27,12 +32,14 @@
 //#include "modules/adminapi/mod_dba_instance.h"
 #include "modules/adminapi/mod_dba_common.h"
 #include "modules/mod_mysql_resultset.h"
+#include "modules/session_pool.h"
 #include "utils/utils_general.h"
 #include "shellcore/object_factory.h"
 #include "shellcore/shell_core_options.h"
 #include "../mysqlxtest_utils.h"
 #include "utils/utils_help.h"
 #include "modules/adminapi/mod_dba_sql.h"
+#include "modules/adminapi/mod_dba_gtid_set.h"
 
 #include "logger/logger.h"
 
@@ -46,10 +53,24 @@ using namespace shcore;
 
 #define PASSWORD_LENGHT 16
 
-std::set<std::string> Dba::_deploy_instance_opts = {"portx", "sandboxDir", "password", "dbPassword", "allowRootFrom", "ignoreSslError"};
+// Seconds to wait on every instance when reading their state for a reboot
+#define REBOOT_STATE_TIMEOUT 5
+
+// The profile option of the deployed sandboxes, the option file values of
+// each profile are set by mysqlprovision
+static std::string sandbox_profile(shcore::Argument_map &opt_map) {
+  std::string profile = opt_map.has_key("profile") ? opt_map.string_at("profile") : "default";
+  if (profile != "default" && profile != "dense")
+    throw shcore::Exception::argument_error("Invalid value for 'profile': it must be either 'default' or 'dense'");
+  return profile;
+}
+
+std::set<std::string> Dba::_deploy_instance_opts = {"portx", "sandboxDir", "password", "dbPassword", "allowRootFrom", "ignoreSslError", "profile"};
+std::set<std::string> Dba::_deploy_instances_opts = {"sandboxDir", "password", "dbPassword", "allowRootFrom", "ignoreSslError", "profile", "parallel"};
 std::set<std::string> Dba::_stop_instance_opts = {"sandboxDir", "password", "dbPassword"};
 std::set<std::string> Dba::_default_local_instance_opts = {"sandboxDir"};
 std::set<std::string> Dba::_create_cluster_opts = {"clusterAdminType", "multiMaster", "adoptFromGR", "force", "memberSslMode", "ipWhitelist"};
+std::set<std::string> Dba::_check_instances_opts = {"password", "dbPassword", "mycnfPath", "parallel"};
 std::set<std::string> Dba::_reboot_cluster_opts = {"user", "dbUser", "password", "dbPassword", "removeInstances", "rejoinInstances"};
 
 // Documentation of the DBA Class
@@ -66,7 +87,6 @@ REGISTER_HELP(DBA_VERBOSE_DETAIL2, "@li 1: enables mysqlprovision verbosity");
 REGISTER_HELP(DBA_VERBOSE_DETAIL3, "@li >1: enables mysqlprovision debug verbosity");
 REGISTER_HELP(DBA_VERBOSE_DETAIL4, "@li Boolean: equivalent to assign either 0 or 1");
 
-std::map <std::string, std::shared_ptr<mysqlsh::mysql::ClassicSession> > Dba::_session_cache;
 
 Dba::Dba(IShell_core* owner) :
 _shell_core(owner) {
@@ -86,7 +106,9 @@ void Dba::init() {
   add_method("getCluster", std::bind(&Dba::get_cluster, this, _1), "clusterName", shcore::String, NULL);
   add_method("dropMetadataSchema", std::bind(&Dba::drop_metadata_schema, this, _1), "data", shcore::Map, NULL);
   add_method("checkInstanceConfiguration", std::bind(&Dba::check_instance_configuration, this, _1), "data", shcore::Map, NULL);
+  add_varargs_method("checkInstancesConfiguration", std::bind(&Dba::check_instances_configuration, this, _1));
   add_method("deploySandboxInstance", std::bind(&Dba::deploy_sandbox_instance, this, _1, "deploySandboxInstance"), "data", shcore::Map, NULL);
+  add_varargs_method("deploySandboxInstances", std::bind(&Dba::deploy_sandbox_instances, this, _1));
   add_method("startSandboxInstance", std::bind(&Dba::start_sandbox_instance, this, _1), "data", shcore::Map, NULL);
   add_method("stopSandboxInstance", std::bind(&Dba::stop_sandbox_instance, this, _1), "data", shcore::Map, NULL);
   add_method("deleteSandboxInstance", std::bind(&Dba::delete_sandbox_instance, this, _1), "data", shcore::Map, NULL);
@@ -99,6 +121,12 @@ void Dba::init() {
   _provisioning_interface.reset(new ProvisioningInterface(_shell_core->get_delegate()));
 }
 
+shcore::Value Dba::call(const std::string &name, const shcore::Argument_list &args) {
+  // Every function is an operation that Ctrl-C or the timeouts can stop
+  Operation_scope scope("dba." + name);
+  return Cpp_object_bridge::call(name, args);
+}
+
 void Dba::set_member(const std::string &prop, Value value) {
   if (prop == "verbose") {
     int verbosity;
@@ -177,6 +205,9 @@ shcore::Value Dba::get_cluster(const shcore::Argument_list &args) const {
 
   check_preconditions("getCluster");
 
+  // Nothing is written, the metadata may come from a secondary
+  MetadataStorage::Secondary_reads secondary_reads(_metadata_storage);
+
   std::shared_ptr<mysqlsh::dba::Cluster> cluster;
   bool get_default_cluster = false;
   std::string cluster_name;
@@ -625,9 +656,156 @@ shcore::Value Dba::check_instance_configuration(const shcore::Argument_list &arg
   return ret_val;
 }
 
-shcore::Value Dba::exec_instance_op(const std::string &function, const shcore::Argument_list &args) {
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_BRIEF, "Validates several instances for usage in Group Replication.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_PARAM, "@param instances List with the instance definitions.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_PARAM1, "@param options Optional data for the operation.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_RETURN, "@return A dictionary with the overall status and the result of each instance.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_DETAIL, "This function does the same review of checkInstanceConfiguration() "\
+"on each of the given instances, the instances are checked concurrently. The instance definitions are URI strings or "\
+"connection data dictionaries.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_DETAIL1, "The options dictionary may contain the next options:");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_DETAIL2, "@li mycnfPath: The path of the MySQL configuration file, the same on every instance.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_DETAIL3, "@li password: The password to get connected to the instances.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_DETAIL4, "@li parallel: maximum number of instances checked at the same time, "\
+"by default all of them.");
+REGISTER_HELP(DBA_CHECKINSTANCESCONFIGURATION_DETAIL5, "The returned dictionary has a status, 'ok' only if all of the instances are valid, "\
+"and an instances dictionary with the result of checkInstanceConfiguration() for each host:port. An instance that "\
+"could not be checked has an 'error' status and the failure on its errors list.");
+
+/**
+* $(DBA_CHECKINSTANCESCONFIGURATION_BRIEF)
+*
+* $(DBA_CHECKINSTANCESCONFIGURATION_PARAM)
+* $(DBA_CHECKINSTANCESCONFIGURATION_PARAM1)
+* $(DBA_CHECKINSTANCESCONFIGURATION_RETURN)
+*
+* $(DBA_CHECKINSTANCESCONFIGURATION_DETAIL)
+*
+* $(DBA_CHECKINSTANCESCONFIGURATION_DETAIL1)
+* $(DBA_CHECKINSTANCESCONFIGURATION_DETAIL2)
+* $(DBA_CHECKINSTANCESCONFIGURATION_DETAIL3)
+* $(DBA_CHECKINSTANCESCONFIGURATION_DETAIL4)
+*
+* $(DBA_CHECKINSTANCESCONFIGURATION_DETAIL5)
+*/
+#if DOXYGEN_JS
+Dictionary Dba::checkInstancesConfiguration(List instances, Dictionary options) {}
+#elif DOXYGEN_PY
+dict Dba::check_instances_configuration(list instances, dict options) {}
+#endif
+shcore::Value Dba::check_instances_configuration(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, get_function_name("checkInstancesConfiguration").c_str());
+
+  shcore::Value ret_val;
+
+  try {
+    auto instance_list = args.array_at(0);
+
+    // The options other than parallel apply to every instance
+    shcore::Value::Map_type_ref check_options(new shcore::Value::Map_type());
+    size_t parallel = instance_list->size();
+    if (args.size() == 2) {
+      *check_options = *args.map_at(1);
+      shcore::Argument_map opt_map(*check_options);
+      opt_map.ensure_keys({}, _check_instances_opts, "validation options");
+
+      if (opt_map.has_key("parallel")) {
+        int64_t value = opt_map.int_at("parallel");
+        if (value <= 0)
+          throw shcore::Exception::argument_error("The parallel option must be a positive integer");
+        parallel = static_cast<size_t>(value);
+        check_options->erase("parallel");
+      }
+    }
+
+    // The definitions are validated before any check starts, each one is a
+    // copy as the checks complete them with the credentials
+    std::vector<std::string> endpoints;
+    std::vector<shcore::Value::Map_type_ref> instances;
+    for (auto &value : *instance_list) {
+      shcore::Argument_list instance_args;
+      instance_args.push_back(value);
+      if (check_options->size())
+        instance_args.push_back(shcore::Value(check_options));
+
+      shcore::Value::Map_type_ref instance_def(new shcore::Value::Map_type(
+          *get_instance_options_map(instance_args, mysqlsh::dba::PasswordFormat::OPTIONS)));
+      shcore::Argument_map(*instance_def).ensure_keys({"host", "port"}, _instance_options, "instance definition");
+
+      std::string endpoint = instance_def->get_string("host") + ":" + std::to_string(instance_def->get_int("port"));
+      if (std::find(endpoints.begin(), endpoints.end(), endpoint) != endpoints.end())
+        throw shcore::Exception::argument_error("The instance '" + endpoint + "' is given more than once");
+
+      endpoints.push_back(endpoint);
+      instances.push_back(instance_def);
+    }
+
+    // Every worker has its own mysqlprovision, the sessions come from the
+    // shared pool
+    auto token = shcore::Cancellation_token::current();
+    uint64_t span = shcore::Trace_span::current();
+    std::vector<shcore::Value::Map_type_ref> results(instances.size());
+    std::atomic<size_t> next(0);
+    auto check = [&]() {
+      ProvisioningInterface provisioning(_shell_core->get_delegate());
+      size_t index;
+      while ((index = next++) < instances.size()) {
+        shcore::Trace_span instance_span("check instance", span);
+        instance_span.set("instance", build_connection_string(instances[index], false));
+
+        try {
+          if (token)
+            token->check("checking the instances");
+
+          shcore::Argument_list instance_args;
+          instance_args.push_back(shcore::Value(instances[index]));
+          if (check_options->size())
+            instance_args.push_back(shcore::Value(check_options));
+
+          results[index] = _check_instance_configuration(instance_args, false, &provisioning);
+        } catch (std::exception &e) {
+          shcore::Value::Map_type_ref result(new shcore::Value::Map_type());
+          shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+          errors->push_back(shcore::Value(e.what()));
+          (*result)["status"] = shcore::Value("error");
+          (*result)["errors"] = shcore::Value(errors);
+          (*result)["restart_required"] = shcore::Value(false);
+          results[index] = result;
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t count = 0; count < std::min(parallel, instances.size()); count++)
+      workers.push_back(std::thread(check));
+
+    for (auto &worker : workers)
+      worker.join();
+
+    shcore::Value::Map_type_ref report(new shcore::Value::Map_type());
+    shcore::Value::Map_type_ref instance_results(new shcore::Value::Map_type());
+    bool valid = true;
+    for (size_t index = 0; index < instances.size(); index++) {
+      valid = valid && results[index]->get_string("status") == "ok";
+      (*instance_results)[endpoints[index]] = shcore::Value(results[index]);
+    }
+
+    (*report)["status"] = shcore::Value(valid ? "ok" : "error");
+    (*report)["instances"] = shcore::Value(instance_results);
+    ret_val = shcore::Value(report);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("checkInstancesConfiguration"));
+
+  return ret_val;
+}
+
+shcore::Value Dba::exec_instance_op(const std::string &function, const shcore::Argument_list &args,
+                                    ProvisioningInterface *provisioning) {
   shcore::Value ret_val;
 
+  if (!provisioning)
+    provisioning = _provisioning_interface.get();
+
   shcore::Value::Map_type_ref options; // Map with the connection data
   shcore::Value mycnf_options;
 
@@ -635,6 +813,7 @@ shcore::Value Dba::exec_instance_op(const std::string &function, const shcore::A
   int portx = 0;
   std::string password;
   std::string sandbox_dir;
+  std::string profile;
   bool ignore_ssl_error = true;  // SSL errors are ignored by default.
 
   if (args.size() == 2) {
@@ -659,6 +838,8 @@ shcore::Value Dba::exec_instance_op(const std::string &function, const shcore::A
         password = opt_map.string_at("dbPassword");
       else
         throw shcore::Exception::argument_error("Missing root password for the deployed instance");
+
+      profile = sandbox_profile(opt_map);
     } else if (function == "stop") {
       opt_map.ensure_keys({}, _stop_instance_opts, "the instance data");
       if (opt_map.has_key("password"))
@@ -701,21 +882,23 @@ shcore::Value Dba::exec_instance_op(const std::string &function, const shcore::A
 
   int rc = 0;
   if (function == "deploy") {
-    // First we need to create the instance
-    rc = _provisioning_interface->create_sandbox(port, portx, sandbox_dir, password, mycnf_options, ignore_ssl_error, errors);
+    // First we need to create the instance, its datadir is cloned from the
+    // template of the server version
+    rc = provisioning->create_sandbox(port, portx, sandbox_dir, password, mycnf_options, ignore_ssl_error, true,
+                                      profile, errors);
     if (rc == 0) {
-      rc = _provisioning_interface->start_sandbox(port, sandbox_dir, errors);
+      rc = provisioning->start_sandbox(port, sandbox_dir, errors);
       //std::string uri = "localhost:" + std::to_string(port);
       //ret_val = shcore::Value::wrap<Instance>(new Instance(uri, uri, options));
     }
   } else if (function == "delete")
-      rc = _provisioning_interface->delete_sandbox(port, sandbox_dir, errors);
+      rc = provisioning->delete_sandbox(port, sandbox_dir, errors);
   else if (function == "kill")
-    rc = _provisioning_interface->kill_sandbox(port, sandbox_dir, errors);
+    rc = provisioning->kill_sandbox(port, sandbox_dir, errors);
   else if (function == "stop")
-    rc = _provisioning_interface->stop_sandbox(port, sandbox_dir, password, errors);
+    rc = provisioning->stop_sandbox(port, sandbox_dir, password, errors);
   else if (function == "start")
-    rc = _provisioning_interface->start_sandbox(port, sandbox_dir, errors);
+    rc = provisioning->start_sandbox(port, sandbox_dir, errors);
 
   if (rc != 0) {
     std::vector<std::string> str_errors;
@@ -746,17 +929,27 @@ REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL3, "@li password: password for the
 REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL4, "@li allowRootFrom: create remote root account, restricted to the given address pattern (eg %).");
 REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL5, "@li ignoreSslError: Ignore errors when adding SSL support for the new "\
     "instance, by default: true.");
-REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL6, "If the portx option is not specified, it will be automatically calculated "\
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL6, "@li profile: set of configuration values of the new instance, either "\
+    "default or dense, by default: default.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL7, "If the portx option is not specified, it will be automatically calculated "\
 "as 10 times the value of the provided MySQL port.");
-REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL7, "The password or dbPassword options specify the MySQL root "\
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL8, "The password or dbPassword options specify the MySQL root "\
 "password on the new instance.");
-REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL8, "The sandboxDir must be an existing folder where the new instance will be "\
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL9, "The sandboxDir must be an existing folder where the new instance will be "\
 "deployed. If not specified the new instance will be deployed at:");
-REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL9, "  ~/mysql-sandboxes on Unix-like systems or %userprofile%\\MySQL\\mysql-sandboxes on Windows systems.");
-REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL10, "SSL support is added by "\
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL10, "  ~/mysql-sandboxes on Unix-like systems or %userprofile%\\MySQL\\mysql-sandboxes on Windows systems.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL11, "SSL support is added by "\
     "default if not already available for the new instance, but if it fails to be "\
     "added then the error is ignored. Set the ignoreSslError option to false to ensure the new instance is "\
     "deployed with SSL support.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL12, "The data directory of the new instance is cloned from a template data "\
+"directory, which is initialized by the first instance deployed for the MySQL Server version and kept in the templates "\
+"folder of the sandboxDir. Where the file system supports it the clone shares the data of the template until it is "\
+"written, otherwise it is a copy. Remove the templates folder to have it initialized again.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL13, "The dense profile configures the new instance to use little memory, "\
+"to run many instances on the same host (e.g. for tests): a small InnoDB buffer pool, redo log and binary log cache, "\
+"no performance_schema instruments enabled and the minimum Group Replication message cache. Values given with "\
+"the options of the instance override the ones of the profile.");
 
 /**
 * $(DBA_DEPLOYSANDBOXINSTANCE_BRIEF)
@@ -771,7 +964,6 @@ REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL10, "SSL support is added by "\
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL3)
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL4)
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL5)
-*
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL6)
 *
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL7)
@@ -781,6 +973,12 @@ REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCE_DETAIL10, "SSL support is added by "\
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL9)
 *
 * $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL10)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL11)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL12)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCE_DETAIL13)
 */
 #if DOXYGEN_JS
 Instance Dba::deploySandboxInstance(Integer port, Dictionary options) {}
@@ -795,50 +993,227 @@ shcore::Value Dba::deploy_sandbox_instance(const shcore::Argument_list &args, co
   try {
     ret_val = exec_instance_op("deploy", args);
 
+    if (args.size() == 2)
+      create_remote_root(args.int_at(0), args.map_at(1));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name(fname));
+
+  return ret_val;
+}
+
+void Dba::create_remote_root(int port, const shcore::Value::Map_type_ref &options) {
+  shcore::Argument_map opt_map(*options);
+  // create root@<addr> if needed
+  // Valid values:
+  // allowRootFrom: address
+  // allowRootFrom: %
+  // allowRootFrom: null (that is, disable the option)
+  if (opt_map.has_key("allowRootFrom") && opt_map.at("allowRootFrom").type != shcore::Null) {
+    std::string remote_root = opt_map.string_at("allowRootFrom");
+    if (!remote_root.empty()) {
+      std::string password;
+      std::string uri = "root@localhost:" + std::to_string(port);
+      if (opt_map.has_key("password"))
+        password = opt_map.string_at("password");
+      else if (opt_map.has_key("dbPassword"))
+        password = opt_map.string_at("dbPassword");
+
+      auto session = Session_pool::get()->acquire(uri, password);
+      assert(session);
+
+      log_info("Creating root@%s account for sandbox %i", remote_root.c_str(), port);
+      session->execute_sql("SET sql_log_bin = 0");
+      {
+        sqlstring create_user("CREATE USER root@? IDENTIFIED BY ?", 0);
+        create_user << remote_root << password;
+        create_user.done();
+        session->execute_sql(create_user);
+      }
+      {
+        sqlstring grant("GRANT ALL ON *.* TO root@? WITH GRANT OPTION", 0);
+        grant << remote_root;
+        grant.done();
+        session->execute_sql(grant);
+      }
+      session->execute_sql("SET sql_log_bin = 1");
+
+      Session_pool::get()->release(session);
+    }
+  }
+}
+
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_BRIEF, "Creates several new MySQL Server instances on localhost.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_PARAM, "@param ports List with the ports where the new instances will listen for connections.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_PARAM1, "@param options Optional dictionary with options affecting the new deployed instances.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL, "This function will deploy a new MySQL Server instance for each of the given "\
+"ports, the instances are created and started concurrently. The options are the same of deploySandboxInstance(), "\
+"except for portx, and apply to every instance: ");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL1, "@li sandboxDir: path where the new instances will be deployed.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL2, "@li password: password for the MySQL root user on the new instances.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL3, "@li allowRootFrom: create remote root account, restricted to the given address pattern (eg %).");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL4, "@li ignoreSslError: Ignore errors when adding SSL support for the new "\
+    "instances, by default: true.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL5, "@li profile: set of configuration values of the new instances, either "\
+    "default or dense, by default: default.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL6, "@li parallel: maximum number of instances deployed at the same time, "\
+    "by default all of them.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL7, "As with deploySandboxInstance(), the data directory of the instances is cloned "\
+"from the template data directory of the MySQL Server version.");
+REGISTER_HELP(DBA_DEPLOYSANDBOXINSTANCES_DETAIL8, "A line is printed as each of the instances is deployed, if any of them fails "\
+"the error reports the failure of each instance once all of them finished.");
+
+/**
+* $(DBA_DEPLOYSANDBOXINSTANCES_BRIEF)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCES_PARAM)
+* $(DBA_DEPLOYSANDBOXINSTANCES_PARAM1)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL1)
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL2)
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL3)
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL4)
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL5)
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL6)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL7)
+*
+* $(DBA_DEPLOYSANDBOXINSTANCES_DETAIL8)
+*/
+#if DOXYGEN_JS
+Undefined Dba::deploySandboxInstances(List ports, Dictionary options) {}
+#elif DOXYGEN_PY
+None Dba::deploy_sandbox_instances(list ports, dict options) {}
+#endif
+shcore::Value Dba::deploy_sandbox_instances(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  args.ensure_count(1, 2, get_function_name("deploySandboxInstances").c_str());
+
+  try {
+    auto port_list = args.array_at(0);
+
+    // The options other than parallel apply to every instance
+    shcore::Value::Map_type_ref deploy_options(new shcore::Value::Map_type());
+    size_t parallel = port_list->size();
     if (args.size() == 2) {
-      shcore::Argument_map opt_map(*args.map_at(1));
-      // create root@<addr> if needed
-      // Valid values:
-      // allowRootFrom: address
-      // allowRootFrom: %
-      // allowRootFrom: null (that is, disable the option)
-      if (opt_map.has_key("allowRootFrom") && opt_map.at("allowRootFrom").type != shcore::Null) {
-        std::string remote_root = opt_map.string_at("allowRootFrom");
-        if (!remote_root.empty()) {
-          int port = args.int_at(0);
-          std::string password;
-          std::string uri = "root@localhost:" + std::to_string(port);
-          if (opt_map.has_key("password"))
-            password = opt_map.string_at("password");
-          else if (opt_map.has_key("dbPassword"))
-            password = opt_map.string_at("dbPassword");
-
-          auto session = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(
-                mysqlsh::connect_session(uri, password, mysqlsh::SessionType::Classic));
-          assert(session);
-
-          log_info("Creating root@%s account for sandbox %i", remote_root.c_str(), port);
-          session->execute_sql("SET sql_log_bin = 0");
+      *deploy_options = *args.map_at(1);
+      shcore::Argument_map opt_map(*deploy_options);
+      opt_map.ensure_keys({}, _deploy_instances_opts, "the instance data");
+      sandbox_profile(opt_map);
+
+      if (opt_map.has_key("parallel")) {
+        int64_t value = opt_map.int_at("parallel");
+        if (value <= 0)
+          throw shcore::Exception::argument_error("The parallel option must be a positive integer");
+        parallel = static_cast<size_t>(value);
+        deploy_options->erase("parallel");
+      }
+    }
+
+    if (!deploy_options->has_key("password") && !deploy_options->has_key("dbPassword"))
+      throw shcore::Exception::argument_error("Missing root password for the deployed instances");
+
+    std::vector<int> ports;
+    std::set<int> given_ports;
+    for (auto &value : *port_list) {
+      if (value.type != shcore::Integer && value.type != shcore::UInteger)
+        throw shcore::Exception::argument_error("The ports must be integer values");
+
+      int port = static_cast<int>(value.as_int());
+      if (port < 1024 || port > 65535)
+        throw shcore::Exception::argument_error("Invalid value for 'port': Please use a valid TCP port number >= 1024 and <= 65535");
+      if (!given_ports.insert(port).second)
+        throw shcore::Exception::argument_error("The port " + std::to_string(port) + " is given more than once");
+
+      ports.push_back(port);
+    }
+
+    if (ports.empty())
+      return ret_val;
+
+    // Every worker runs its own mysqlprovision, the progress is printed from
+    // this thread as the deployments finish. Once cancelled, the instances
+    // not started yet fail right away.
+    auto token = shcore::Cancellation_token::current();
+    uint64_t span = shcore::Trace_span::current();
+    std::vector<std::string> errors(ports.size());
+    std::mutex mutex;
+    std::condition_variable finished_cond;
+    std::deque<size_t> finished;
+    size_t next = 0;
+    std::vector<std::thread> workers;
+    for (size_t count = 0; count < std::min(parallel, ports.size()); count++) {
+      workers.push_back(std::thread([&]() {
+        ProvisioningInterface provisioning(_shell_core->get_delegate());
+        while (true) {
+          size_t index;
           {
-            sqlstring create_user("CREATE USER root@? IDENTIFIED BY ?", 0);
-            create_user << remote_root << password;
-            create_user.done();
-            session->execute_sql(create_user);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (next == ports.size())
+              return;
+            index = next++;
           }
-          {
-            sqlstring grant("GRANT ALL ON *.* TO root@? WITH GRANT OPTION", 0);
-            grant << remote_root;
-            grant.done();
-            session->execute_sql(grant);
+
+          shcore::Trace_span instance_span("deploy sandbox instance", span);
+          instance_span.set("port", std::to_string(ports[index]));
+
+          std::string error;
+          try {
+            if (token)
+              token->check("deploying the sandbox instances");
+
+            shcore::Argument_list instance_args;
+            instance_args.push_back(shcore::Value(ports[index]));
+            instance_args.push_back(shcore::Value(deploy_options));
+
+            exec_instance_op("deploy", instance_args, &provisioning);
+            create_remote_root(ports[index], deploy_options);
+          } catch (std::exception &e) {
+            error = e.what();
+          } catch (...) {
+            error = "Unknown error";
           }
-          session->execute_sql("SET sql_log_bin = 1");
 
-          session->close(shcore::Argument_list());
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            errors[index] = error;
+            finished.push_back(index);
+          }
+          finished_cond.notify_one();
         }
+      }));
+    }
+
+    for (size_t count = 1; count <= ports.size(); count++) {
+      size_t index;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished_cond.wait(lock, [&finished]() { return !finished.empty(); });
+        index = finished.front();
+        finished.pop_front();
       }
+
+      std::string progress = " (" + std::to_string(count) + "/" + std::to_string(ports.size()) + ")\n";
+      if (errors[index].empty())
+        _shell_core->print("Instance localhost:" + std::to_string(ports[index]) + " successfully deployed and started" + progress);
+      else
+        _shell_core->print("Instance localhost:" + std::to_string(ports[index]) + " failed to deploy" + progress);
     }
+
+    for (auto &worker : workers)
+      worker.join();
+
+    std::string error;
+    for (size_t index = 0; index < ports.size(); index++) {
+      if (!errors[index].empty())
+        error += "\n" + std::to_string(ports[index]) + ": " + errors[index];
+    }
+    if (!error.empty())
+      throw shcore::Exception::runtime_error("The sandbox instances could not be deployed:" + error);
   }
-  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name(fname));
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("deploySandboxInstances"));
 
   return ret_val;
 }
@@ -1079,31 +1454,20 @@ shcore::Value Dba::configure_local_instance(const shcore::Argument_list &args) {
 }
 
 Dba::~Dba() {
-  Dba::_session_cache.clear();
+  Session_pool::get()->clear();
 }
 
 std::shared_ptr<mysqlsh::mysql::ClassicSession> Dba::get_session(const shcore::Argument_list& args) {
-  std::shared_ptr<mysqlsh::mysql::ClassicSession> ret_val;
-
-  auto options = args.map_at(0);
-
-  std::string session_id = shcore::build_connection_string(options, false);
-
-  if (_session_cache.find(session_id) == _session_cache.end()) {
-    auto session = mysqlsh::connect_session(args, mysqlsh::SessionType::Classic);
-
-    ret_val = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(session);
-
-    // Disabling the session caching for now
-    //_session_cache[session_id] = ret_val;
-  }
-
-  return ret_val;
+  return Session_pool::get()->acquire(args);
 }
 
-shcore::Value::Map_type_ref Dba::_check_instance_configuration(const shcore::Argument_list &args, bool allow_update) {
+shcore::Value::Map_type_ref Dba::_check_instance_configuration(const shcore::Argument_list &args, bool allow_update,
+                                                               ProvisioningInterface *provisioning) {
   shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
 
+  if (!provisioning)
+    provisioning = _provisioning_interface.get();
+
   // Validates the connection options
   shcore::Value::Map_type_ref instance_def = get_instance_options_map(args, mysqlsh::dba::PasswordFormat::OPTIONS);
 
@@ -1155,13 +1519,13 @@ shcore::Value::Map_type_ref Dba::_check_instance_configuration(const shcore::Arg
   GRInstanceType type = get_gr_instance_type(session->connection());
 
   if (type == GRInstanceType::GroupReplication) {
-    session->close(shcore::Argument_list());
+    Session_pool::get()->release(session);
     throw shcore::Exception::runtime_error("The instance '" + uri + "' is already part of a Replication Group");
   }
   // configureLocalInstance is allowed even if the instance is part of the InnoDB cluster
   // checkInstanceConfiguration is not
   else if (type == GRInstanceType::InnoDBCluster && !allow_update) {
-    session->close(shcore::Argument_list());
+    Session_pool::get()->release(session);
     throw shcore::Exception::runtime_error("The instance '" + uri + "' is already part of an InnoDB Cluster");
   }
   else {
@@ -1178,6 +1542,9 @@ shcore::Value::Map_type_ref Dba::_check_instance_configuration(const shcore::Arg
       set_global_variable(session->connection(), "group_replication_group_seeds", peer_seeds);
     }
 
+    // The instance may be restarted by the configuration check
+    Session_pool::get()->release(session);
+
     std::string user;
     std::string password;
     user = instance_def->get_string(instance_def->has_key("user") ? "user" : "dbUser");
@@ -1195,7 +1562,7 @@ shcore::Value::Map_type_ref Dba::_check_instance_configuration(const shcore::Arg
     // Verbose is mandatory for checkInstanceConfiguration
     shcore::Value::Array_type_ref mp_errors;
 
-    if ((_provisioning_interface->check(user, host, port, password, instance_ssl_opts, cnfpath, allow_update, mp_errors) == 0)) {
+    if ((provisioning->check(user, host, port, password, instance_ssl_opts, cnfpath, allow_update, mp_errors) == 0)) {
       (*ret_val)["status"] = shcore::Value("ok");
     } else {
       shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
@@ -1563,13 +1930,13 @@ shcore::Value Dba::reboot_cluster_from_complete_outage(const shcore::Argument_li
     // 4.1 None of the instances can belong to a GR Group
     // 4.2 If any of the instances belongs to a GR group or is already managed by the
     // InnoDB Cluster, so include that information on the error message
-    validate_instances_status_reboot_cluster(args);
+    std::vector<Instance_state> instances_state = validate_instances_status_reboot_cluster(args);
 
     // 5. Verify which of the online instances has the GTID superset.
     // 5.1 Skip the verification on the list of instances to be removed: "removeInstances"
     // 5.2 If the current session instance doesn't have the GTID superset, error out
     // with that information and including on the message the instance with the GTID superset
-    validate_instances_gtid_reboot_cluster(&cluster_name, options, instance_session);
+    validate_instances_gtid_reboot_cluster(instances_state, instance_session);
 
     // Get the group_replication_group_name
     group_replication_group_name = _metadata_storage->get_replicaset_group_name();
@@ -1618,18 +1985,16 @@ ReplicationGroupState Dba::check_preconditions(const std::string& function_name)
 }
 
 /*
- * get_replicaset_instances_status:
+ * get_replicaset_instances_state:
  *
- * Given a cluster id, this function verifies the connectivity status of all the instances
- * of the default replicaSet of the cluster. It returns a list of pairs <instance_id, status>,
- * on which 'status' is empty if the instance is reachable, or if not reachable contains the
- * connection failure error message
+ * Given a cluster id, this function reads the state of all the instances of the default
+ * replicaSet of the cluster but the current session one: whether each is reachable, its GR
+ * instance type and its GLOBAL.GTID_EXECUTED. The instances are read all at once, each with
+ * a short network timeout, so the unreachable ones cost a single timeout altogether.
  */
-std::vector<std::pair<std::string, std::string>> Dba::get_replicaset_instances_status(std::string *out_cluster_name,
+std::vector<Dba::Instance_state> Dba::get_replicaset_instances_state(std::string *out_cluster_name,
           const shcore::Value::Map_type_ref &options) {
-  std::vector<std::pair<std::string, std::string>> instances_status;
-  std::shared_ptr<mysqlsh::ShellDevelopmentSession> session;
-  std::string user, password, host, port, active_session_address, instance_address, conn_status;
+  std::string user, password, host, port, active_session_address;
 
   if (out_cluster_name->empty())
     *out_cluster_name = _metadata_storage->get_default_cluster()->get_name();
@@ -1672,47 +2037,75 @@ std::vector<std::pair<std::string, std::string>> Dba::get_replicaset_instances_s
     password = instance_session->get_password();
   }
 
-  // Iterate on all instances from the metadata
+  // Every instance from the metadata but the current session one
+  std::vector<Instance_state> states;
   for (auto it = instances->begin(); it != instances->end(); ++it) {
     auto row = it->as_object<mysqlsh::Row>();
-    instance_address = row->get_member("host").as_string();
-    conn_status.clear();
-    session = NULL;
+    std::string instance_address = row->get_member("host").as_string();
 
-    // Skip the current session instance
-    if (instance_address == active_session_address) {
-      continue;
+    if (instance_address != active_session_address) {
+      states.emplace_back();
+      states.back().address = instance_address;
+      states.back().type = Standalone;
     }
+  }
 
-    shcore::Argument_list session_args;
-    Value::Map_type_ref instance_options(new shcore::Value::Map_type);
+  std::vector<std::thread> workers;
+  for (auto &state : states) {
+    workers.push_back(std::thread([&state, &user, &password]() {
+      shcore::Connection_options address = shcore::Connection_options::parse(state.address, false);
+      shcore::Connection_options instance_options;
 
-    shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(instance_address);
+      instance_options.host = address.host;
+      instance_options.port = address.port;
+      // We assume the root password is the same on all instances
+      instance_options.user = user;
+      instance_options.password = password;
+      instance_options.has_password = true;
 
-    int instance_port = connection_data->get_int("port");
-    std::string instance_host = connection_data->get_string("host");
+      shcore::Value::Map_type_ref connection_data = instance_options.to_map();
+      (*connection_data)[shcore::kTimeout] = shcore::Value(REBOOT_STATE_TIMEOUT);
+      shcore::Argument_list args;
+      args.push_back(shcore::Value(connection_data));
 
-    (*instance_options)["host"] = shcore::Value(instance_host);
-    (*instance_options)["port"] = shcore::Value(instance_port);
-    // We assume the root password is the same on all instances
-    (*instance_options)["password"] = shcore::Value(password);
-    (*instance_options)["user"] = shcore::Value(user);
-    session_args.push_back(shcore::Value(instance_options));
+      try {
+        log_info("Opening a new session to the instance to determine its status: %s",
+                  state.address.c_str());
+        auto session = Session_pool::get()->acquire(args);
 
-    try {
-      log_info("Opening a new session to the instance to determine its status: %s",
-                instance_address.c_str());
-      session = mysqlsh::connect_session(session_args, mysqlsh::SessionType::Classic);
-      session->close(shcore::Argument_list());
-    } catch (std::exception &e) {
-      conn_status = e.what();
-      log_warning("Could not open connection to %s: %s.", instance_address.c_str(), e.what());
-    }
+        state.type = get_gr_instance_type(session->connection());
+        get_server_variable(session->connection(), "GLOBAL.GTID_EXECUTED", state.gtid_executed);
 
-    // Add the <instance, connection_status> pair to the list
-    instances_status.emplace_back(instance_address, conn_status);
+        // Give the session back to the pool
+        Session_pool::get()->release(session);
+      } catch (std::exception &e) {
+        state.error = e.what();
+        log_warning("Could not read the status of %s: %s.", state.address.c_str(), e.what());
+      }
+    }));
   }
 
+  for (auto &worker : workers)
+    worker.join();
+
+  return states;
+}
+
+/*
+ * get_replicaset_instances_status:
+ *
+ * Given a cluster id, this function verifies the connectivity status of all the instances
+ * of the default replicaSet of the cluster. It returns a list of pairs <instance_id, status>,
+ * on which 'status' is empty if the instance is reachable, or if not reachable contains the
+ * connection failure error message
+ */
+std::vector<std::pair<std::string, std::string>> Dba::get_replicaset_instances_status(std::string *out_cluster_name,
+          const shcore::Value::Map_type_ref &options) {
+  std::vector<std::pair<std::string, std::string>> instances_status;
+
+  for (auto &state : get_replicaset_instances_state(out_cluster_name, options))
+    instances_status.emplace_back(state.address, state.error);
+
   return instances_status;
 }
 
@@ -1725,10 +2118,9 @@ std::vector<std::pair<std::string, std::string>> Dba::get_replicaset_instances_s
  * to a GR group or is already managed by the InnoDB Cluster.cluster_name
  * If not, does the same validation for the remaining reachable instances of the cluster.
  */
-void Dba::validate_instances_status_reboot_cluster(const shcore::Argument_list &args) {
-  std::string cluster_name, user, password, port, host, active_session_address;
+std::vector<Dba::Instance_state> Dba::validate_instances_status_reboot_cluster(const shcore::Argument_list &args) {
+  std::string cluster_name, port, host, active_session_address;
   shcore::Value::Map_type_ref options;
-  std::shared_ptr<mysqlsh::ShellDevelopmentSession> session;
   mysqlsh::mysql::ClassicSession *classic_current;
 
   if (args.size() == 1)
@@ -1753,26 +2145,6 @@ void Dba::validate_instances_status_reboot_cluster(const shcore::Argument_list &
     shcore::Argument_map opt_map(*options);
 
     opt_map.ensure_keys({}, mysqlsh::dba::Dba::_reboot_cluster_opts, "the options");
-
-    // Check if the password is specified on the options and if not prompt it
-    if (opt_map.has_key("password"))
-      password = opt_map.string_at("password");
-    else if (opt_map.has_key("dbPassword"))
-      password = opt_map.string_at("dbPassword");
-    else
-      password = instance_session->get_password();
-
-    // check if the user is specified on the options and it not prompt it
-    if (opt_map.has_key("user"))
-      user = opt_map.string_at("user");
-    else if (opt_map.has_key("dbUser"))
-      user = opt_map.string_at("dbUser");
-    else
-      user = instance_session->get_user();
-
-  } else {
-    user = instance_session->get_user();
-    password = instance_session->get_password();
   }
 
   GRInstanceType type = get_gr_instance_type(classic_current->connection());
@@ -1795,66 +2167,33 @@ void Dba::validate_instances_status_reboot_cluster(const shcore::Argument_list &
   }
 
   // Verify all the remaining online instances for their status
-  std::vector<std::pair<std::string, std::string>> instances_status =
-          get_replicaset_instances_status(&cluster_name, options);
-
-  for (auto &value : instances_status) {
-    mysqlsh::mysql::ClassicSession *classic;
-
-    std::string instance_address = value.first;
-    std::string instance_status = value.second;
+  std::vector<Instance_state> instances_state = get_replicaset_instances_state(&cluster_name, options);
 
-    // if the status is not empty it means the connection failed
+  for (auto &state : instances_state) {
+    // if the error is not empty it means the connection failed
     // so we skip this instance
-    if (!instance_status.empty())
+    if (!state.error.empty())
       continue;
 
-    shcore::Argument_list session_args;
-    Value::Map_type_ref instance_options(new shcore::Value::Map_type);
-
-    shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(instance_address);
-
-    int instance_port = connection_data->get_int("port");
-    std::string instance_host = connection_data->get_string("host");
-
-    (*instance_options)["host"] = shcore::Value(instance_host);
-    (*instance_options)["port"] = shcore::Value(instance_port);
-    // We assume the root password is the same on all instances
-    (*instance_options)["password"] = shcore::Value(password);
-    (*instance_options)["user"] = shcore::Value(user);
-    session_args.push_back(shcore::Value(instance_options));
-
-    try {
-      log_info("Opening a new session to the instance: %s",
-                instance_address.c_str());
-      session = mysqlsh::connect_session(session_args, mysqlsh::SessionType::Classic);
-      classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
-    } catch (std::exception &e) {
-      throw Exception::runtime_error("Could not open connection to " + instance_address + "");
-    }
-
-    GRInstanceType type = get_gr_instance_type(classic->connection());
-
-    // Close the session
-    session->close(shcore::Argument_list());
-
-    switch (type) {
+    switch (state.type) {
       case GRInstanceType::InnoDBCluster:
-        throw Exception::runtime_error("The cluster's instance '" + instance_address + "' belongs "
+        throw Exception::runtime_error("The cluster's instance '" + state.address + "' belongs "
                                        "to an InnoDB Cluster and is reachable. Please use " +
                                        get_member_name("forceQuorumUsingPartitionOf", naming_style) +
                                        "() to restore the quorum loss.");
 
       case GRInstanceType::GroupReplication:
-        throw Exception::runtime_error("The cluster's instance '" + instance_address + "' belongs "
+        throw Exception::runtime_error("The cluster's instance '" + state.address + "' belongs "
                                        "to an unmanaged GR group. ");
 
-      case Standalone:
+      default:
         // We only want to check whether the status if InnoDBCluster or GroupReplication to stop and thrown
         // an exception
         break;
     }
   }
+
+  return instances_state;
 }
 
 /*
@@ -1865,8 +2204,7 @@ void Dba::validate_instances_status_reboot_cluster(const shcore::Argument_list &
  * If the current session instance doesn't have the GTID superset, it errors out with that information
  * and includes on the error message the instance with the GTID superset
  */
-void Dba::validate_instances_gtid_reboot_cluster(std::string *out_cluster_name,
-                                                 const shcore::Value::Map_type_ref &options,
+void Dba::validate_instances_gtid_reboot_cluster(const std::vector<Instance_state> &instances_state,
                                                  const std::shared_ptr<ShellDevelopmentSession> &instance_session) {
   /* GTID verification is done by verifying which instance has the GTID superset.the
    * In order to do so, a union of the global gtid executed and the received transaction
@@ -1889,8 +2227,7 @@ void Dba::validate_instances_gtid_reboot_cluster(std::string *out_cluster_name,
 
   std::pair<std::string, std::string> most_updated_instance;
   mysqlsh::mysql::ClassicSession *classic_current;
-  std::shared_ptr<mysqlsh::ShellDevelopmentSession> session;
-  std::string host, port, active_session_address, user, password;
+  std::string host, port, active_session_address;
 
   // get the current session information
   classic_current = dynamic_cast<mysqlsh::mysql::ClassicSession*>(instance_session.get());
@@ -1902,32 +2239,6 @@ void Dba::validate_instances_gtid_reboot_cluster(std::string *out_cluster_name,
   host = current_session_options->get_string("host");
   active_session_address = host + ":" + port;
 
-  if (options) {
-    shcore::Argument_map opt_map(*options);
-
-    if (opt_map.has_key("password"))
-      password = opt_map.string_at("password");
-    else if (opt_map.has_key("dbPassword"))
-      password = opt_map.string_at("dbPassword");
-    else
-      password = instance_session->get_password();
-
-    if (opt_map.has_key("user"))
-      user = opt_map.string_at("user");
-    else if (opt_map.has_key("dbUser"))
-      user = opt_map.string_at("dbUser");
-    else
-      user = instance_session->get_user();
-
-  } else {
-    user = instance_session->get_user();
-    password = instance_session->get_password();
-  }
-
-  // Get the cluster instances and their status
-  std::vector<std::pair<std::string, std::string>> instances_status =
-        get_replicaset_instances_status(out_cluster_name, options);
-
   // Get @@GLOBAL.GTID_EXECUTED
   std::string gtid_executed_current;
   get_server_variable(classic_current->connection(), "GLOBAL.GTID_EXECUTED", gtid_executed_current);
@@ -1944,64 +2255,30 @@ void Dba::validate_instances_gtid_reboot_cluster(std::string *out_cluster_name,
   // Update most_updated_instance with the current session instance value
   most_updated_instance = std::make_pair(active_session_address, gtid_executed_current);
 
-  for (auto &value : instances_status) {
-    mysqlsh::mysql::ClassicSession *classic;
-    std::string instance_address = value.first;
-    std::string instance_status = value.second;
-
-    // if the status is not empty it means the connection failed
+  // The GLOBAL.GTID_EXECUTED of the other instances was read with their state
+  for (auto &state : instances_state) {
+    // if the error is not empty it means the connection failed
     // so we skip this instance
-    if (!instance_status.empty())
+    if (!state.error.empty())
       continue;
 
-    shcore::Argument_list session_args;
-    Value::Map_type_ref instance_options(new shcore::Value::Map_type);
-
-    shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(instance_address);
-
-    int instance_port = connection_data->get_int("port");
-    std::string instance_host = connection_data->get_string("host");
-
-    (*instance_options)["host"] = shcore::Value(instance_host);
-    (*instance_options)["port"] = shcore::Value(instance_port);
-    // We assume the root password is the same on all instances
-    (*instance_options)["password"] = shcore::Value(password);
-    (*instance_options)["user"] = shcore::Value(user);
-    session_args.push_back(shcore::Value(instance_options));
-
-    // Connect to the instance to obtain the GLOBAL.GTID_EXECUTED
-    try {
-      log_info("Opening a new session to the instance for gtid validations %s",
-                instance_address.c_str());
-      session = mysqlsh::connect_session(session_args, mysqlsh::SessionType::Classic);
-      classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
-    } catch (std::exception &e) {
-      throw Exception::runtime_error("Could not open a connection to " +
-                                      instance_address + ": " + e.what() +
-                                      ".");
-    }
-
-    std::string gtid_executed;
-
-    // Get @@GLOBAL.GTID_EXECUTED
-    get_server_variable(classic->connection(), "GLOBAL.GTID_EXECUTED", gtid_executed);
-
-    // Close the session
-    session->close(shcore::Argument_list());
-
-    std::string msg = "The instance: '" + instance_address + "' GLOBAL.GTID_EXECUTED is: " + gtid_executed;
+    std::string msg = "The instance: '" + state.address + "' GLOBAL.GTID_EXECUTED is: " + state.gtid_executed;
     log_info("%s", msg.c_str());
 
     // Add to the pair vector of gtids
-    gtids.emplace_back(instance_address, gtid_executed);
+    gtids.emplace_back(state.address, state.gtid_executed);
   }
 
-  // Calculate the most up-to-date instance
+  // Calculate the most up-to-date instance, the sets are compared locally
   // TODO: calculate the Total GTID executed. See comment above
+  Gtid_set most_updated_gtids(most_updated_instance.second);
   for (auto &value : gtids) {
-    // Compare the gtid's: SELECT GTID_SUBSET("Total_instance1", "Total_instance2")
-    if (!is_gtid_subset(classic_current->connection(), value.second, most_updated_instance.second))
+    Gtid_set instance_gtids(value.second);
+
+    if (!instance_gtids.is_subset_of(most_updated_gtids)) {
       most_updated_instance = value;
+      most_updated_gtids = instance_gtids;
+    }
   }
 
   // Check if the most updated instance is not the current session instance
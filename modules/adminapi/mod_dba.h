@@ -42,9 +42,11 @@ public:
   virtual ~Dba();
 
   static std::set<std::string> _deploy_instance_opts;
+  static std::set<std::string> _deploy_instances_opts;
   static std::set<std::string> _stop_instance_opts;
   static std::set<std::string> _default_local_instance_opts;
   static std::set<std::string> _create_cluster_opts;
+  static std::set<std::string> _check_instances_opts;
   static std::set<std::string> _reboot_cluster_opts;
 
   virtual std::string class_name() const { return "Dba"; };
@@ -53,6 +55,7 @@ public:
 
   virtual void set_member(const std::string &prop, shcore::Value value);
   virtual shcore::Value get_member(const std::string &prop) const;
+  virtual shcore::Value call(const std::string &name, const shcore::Argument_list &args);
 
   std::shared_ptr<ShellDevelopmentSession> get_active_session() const;
   ReplicationGroupState check_preconditions(const std::string& function_name) const;
@@ -60,7 +63,9 @@ public:
   int get_default_instance_port() { return 3306; }
 
   shcore::Value check_instance_configuration(const shcore::Argument_list &args);
+  shcore::Value check_instances_configuration(const shcore::Argument_list &args);
   shcore::Value deploy_sandbox_instance(const shcore::Argument_list &args, const std::string &fname); // create and start
+  shcore::Value deploy_sandbox_instances(const shcore::Argument_list &args);
   shcore::Value stop_sandbox_instance(const shcore::Argument_list &args);
   shcore::Value delete_sandbox_instance(const shcore::Argument_list &args);
   shcore::Value kill_sandbox_instance(const shcore::Argument_list &args);
@@ -79,12 +84,23 @@ public:
 
   shcore::IShell_core* get_owner() { return _shell_core; }
 
+  // State of an instance of the cluster read for the reboot, error is empty
+  // if the instance was reachable
+  struct Instance_state {
+    std::string address;
+    std::string error;
+    GRInstanceType type;
+    std::string gtid_executed;
+  };
+
+  std::vector<Instance_state> get_replicaset_instances_state(std::string *out_cluster_name,
+          const shcore::Value::Map_type_ref &options);
   std::vector<std::pair<std::string, std::string>> get_replicaset_instances_status(std::string *out_cluster_name,
           const shcore::Value::Map_type_ref &options);
 
-  void validate_instances_status_reboot_cluster(const shcore::Argument_list &args);
-  void validate_instances_gtid_reboot_cluster(std::string *out_cluster_name,
-                                              const shcore::Value::Map_type_ref &options,
+  // Returns the states read from the instances, for the rest of the reboot
+  std::vector<Instance_state> validate_instances_status_reboot_cluster(const shcore::Argument_list &args);
+  void validate_instances_gtid_reboot_cluster(const std::vector<Instance_state> &instances_state,
                                               const std::shared_ptr<ShellDevelopmentSession> &instance_session);
 
 #if DOXYGEN_JS
@@ -92,6 +108,7 @@ public:
   Cluster createCluster(String name, Dictionary options);
   Undefined deleteSandboxInstance(Integer port, Dictionary options);
   Instance deploySandboxInstance(Integer port, Dictionary options);
+  Undefined deploySandboxInstances(List ports, Dictionary options);
   Undefined dropMetadataSchema(Dictionary options);
   Cluster getCluster(String name);
   Undefined killSandboxInstance(Integer port, Dictionary options);
@@ -99,6 +116,7 @@ public:
   Undefined startSandboxInstance(Integer port, Dictionary options);
   Undefined stopSandboxInstance(Integer port, Dictionary options);
   Undefined checkInstanceConfiguration(InstanceDef instance, Dictionary options);
+  Dictionary checkInstancesConfiguration(List instances, Dictionary options);
   Instance configureLocalInstance(InstanceDef instance, Dictionary options);
   Undefined rebootClusterFromCompleteOutage(String clusterName, Dictionary options);
 #elif DOXYGEN_PY
@@ -106,6 +124,7 @@ public:
   Cluster create_cluster(str name, dict options);
   None delete_sandbox_instance(int port, dict options);
   Instance deploy_sandbox_instance(int port, dict options);
+  None deploy_sandbox_instances(list ports, dict options);
   None drop_cluster(str name);
   None drop_metadata_schema(dict options);
   Cluster get_cluster(str name);
@@ -114,10 +133,12 @@ public:
   None start_sandbox_instance(int port, dict options);
   None stop_sandbox_instance(int port, dict options);
   None check_instance_configuration(InstanceDef instance, dict options);
+  dict check_instances_configuration(list instances, dict options);
   JSON configure_local_instance(InstanceDef instance, dict options);
   None reboot_cluster_from_complete_outage(str clusterName, dict options);
 #endif
 
+  // Session from the shared pool, give it back with Session_pool::release
   static std::shared_ptr<mysqlsh::mysql::ClassicSession> get_session(const shcore::Argument_list& args);
 
 protected:
@@ -131,10 +152,11 @@ private:
   uint64_t _connection_id;
   std::shared_ptr<ProvisioningInterface> _provisioning_interface;
 
-  shcore::Value exec_instance_op(const std::string &function, const shcore::Argument_list &args);
-  shcore::Value::Map_type_ref _check_instance_configuration(const shcore::Argument_list &args, bool allow_update);
-
-  static std::map <std::string, std::shared_ptr<mysqlsh::mysql::ClassicSession> > _session_cache;
+  shcore::Value exec_instance_op(const std::string &function, const shcore::Argument_list &args,
+                                 ProvisioningInterface *provisioning = nullptr);
+  void create_remote_root(int port, const shcore::Value::Map_type_ref &options);
+  shcore::Value::Map_type_ref _check_instance_configuration(const shcore::Argument_list &args, bool allow_update,
+                                                            ProvisioningInterface *provisioning = nullptr);
 };
 }
 }
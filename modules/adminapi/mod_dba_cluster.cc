@@ -23,6 +23,9 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <string>
 #include <vector>
 
@@ -34,6 +37,9 @@
 #include "utils/utils_general.h"
 #include "utils/utils_help.h"
 #include "mod_dba_sql.h"
+#include "modules/base_session.h"
+#include "modules/mod_mysql_session.h"
+#include "logger/logger.h"
 
 using namespace std::placeholders;
 using namespace mysqlsh;
@@ -53,7 +59,7 @@ REGISTER_HELP(CLUSTER_NAME_BRIEF, "Cluster name.");
 REGISTER_HELP(CLUSTER_ADMINTYPE_BRIEF, "Cluster Administration type.");
 
 Cluster::Cluster(const std::string &name, std::shared_ptr<MetadataStorage> metadata_storage) :
-_name(name), _metadata_storage(metadata_storage), _dissolved(false) {
+_name(name), _dissolved(false), _metadata_storage(metadata_storage), _next_member(0) {
  init();
 }
 
@@ -68,10 +74,17 @@ bool Cluster::operator == (const Object_bridge &other) const {
   return class_name() == other.class_name() && this == &other;
 }
 
+shcore::Value Cluster::call(const std::string &name, const shcore::Argument_list &args) {
+  // Every function is an operation that Ctrl-C or the timeouts can stop
+  Operation_scope scope("cluster." + name);
+  return Cpp_object_bridge::call(name, args);
+}
+
 void Cluster::init() {
   add_property("name", "getName");
   add_property("adminType", "getAdminType");
   add_method("addInstance", std::bind(&Cluster::add_instance, this, _1), "data");
+  add_varargs_method("addInstances", std::bind(&Cluster::add_instances, this, _1));
   add_method("rejoinInstance", std::bind(&Cluster::rejoin_instance, this, _1), "data");
   add_method("removeInstance", std::bind(&Cluster::remove_instance, this, _1), "data");
   add_method("describe", std::bind(&Cluster::describe, this, _1), NULL);
@@ -79,6 +92,7 @@ void Cluster::init() {
   add_varargs_method("dissolve", std::bind(&Cluster::dissolve, this, _1));
   add_varargs_method("checkInstanceState", std::bind(&Cluster::check_instance_state, this, _1));
   add_varargs_method("rescan", std::bind(&Cluster::rescan, this, _1));
+  add_varargs_method("getSession", std::bind(&Cluster::get_session, this, _1));
   add_varargs_method("forceQuorumUsingPartitionOf", std::bind(&Cluster::force_quorum_using_partition_of, this, _1));
 }
 
@@ -228,20 +242,24 @@ REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL5, "@li name: an identifier for the inst
 REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL6, "@li password: the instance connection password");
 REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL7, "@li memberSslMode: SSL mode used on the instance");
 REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL8, "@li ipWhitelist: The list of hosts allowed to connect to the instance for group replication");
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL9, "@li waitRecovery: boolean, waits for the instance to be ONLINE printing the progress of its recovery");
 
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL9, "The password may be contained on the instance definition, however, it can be overwritten "\
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL10, "The password may be contained on the instance definition, however, it can be overwritten "\
 "if it is specified on the options.");
 
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL10, "The memberSslMode option supports these values:");
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL11, "@li REQUIRED: if used, SSL (encryption) will be enabled for the instance to communicate with other members of the cluster");
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL12, "@li DISABLED: if used, SSL (encryption) will be disabled");
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL13, "@li AUTO: if used, SSL (encryption) will be automatically enabled or disabled based on the cluster configuration");
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL14, "If memberSslMode is not specified AUTO will be used by default.");
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL11, "The memberSslMode option supports these values:");
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL12, "@li REQUIRED: if used, SSL (encryption) will be enabled for the instance to communicate with other members of the cluster");
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL13, "@li DISABLED: if used, SSL (encryption) will be disabled");
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL14, "@li AUTO: if used, SSL (encryption) will be automatically enabled or disabled based on the cluster configuration");
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL15, "If memberSslMode is not specified AUTO will be used by default.");
 
-REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL15, "The ipWhitelist format is a comma separated list of IP addresses or subnet CIDR "\
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL16, "The ipWhitelist format is a comma separated list of IP addresses or subnet CIDR "\
     "notation, for example: 192.168.1.0/24,10.0.0.1. By default the value is set to AUTOMATIC, allowing addresses "\
     "from the instance private network to be automatically set for the whitelist.");
 
+REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL17, "When waitRecovery is true the function returns a dictionary with the recovery metrics: "\
+    "instance, state, seconds, transactions and transactionsPerSecond.");
+
 /**
 * $(CLUSTER_ADDINSTANCE_BRIEF)
 *
@@ -259,16 +277,19 @@ REGISTER_HELP(CLUSTER_ADDINSTANCE_DETAIL15, "The ipWhitelist format is a comma s
 * $(CLUSTER_ADDINSTANCE_DETAIL6)
 * $(CLUSTER_ADDINSTANCE_DETAIL7)
 * $(CLUSTER_ADDINSTANCE_DETAIL8)
-*
 * $(CLUSTER_ADDINSTANCE_DETAIL9)
 *
 * $(CLUSTER_ADDINSTANCE_DETAIL10)
+*
 * $(CLUSTER_ADDINSTANCE_DETAIL11)
 * $(CLUSTER_ADDINSTANCE_DETAIL12)
 * $(CLUSTER_ADDINSTANCE_DETAIL13)
 * $(CLUSTER_ADDINSTANCE_DETAIL14)
-*
 * $(CLUSTER_ADDINSTANCE_DETAIL15)
+*
+* $(CLUSTER_ADDINSTANCE_DETAIL16)
+*
+* $(CLUSTER_ADDINSTANCE_DETAIL17)
 */
 #if DOXYGEN_JS
 Undefined Cluster::addInstance(InstanceDef instance, Dictionary options) {}
@@ -297,6 +318,62 @@ shcore::Value Cluster::add_instance(const shcore::Argument_list &args) {
   return ret_val;
 }
 
+REGISTER_HELP(CLUSTER_ADDINSTANCES_BRIEF, "Adds several Instances to the cluster.");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_PARAM, "@param instances A list of instance definitions.");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_PARAM1, "@param options Optional dictionary with options for the operation.");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL, "This function adds the Instances to the default replica set of the cluster, "\
+"the instance definitions are the same as for addInstance().");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL1, "The checks done before adding an instance are run on several instances at the same time "\
+"and no instance is added unless they pass for all of them. The instances are then joined to the group one at a time.");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL2, "The options dictionary may contain the next attributes:");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL3, "@li parallel: the maximum number of instances checked at the same time, all of them by default");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL4, "@li password: the instances connection password");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL5, "@li memberSslMode: SSL mode used on the instances");
+REGISTER_HELP(CLUSTER_ADDINSTANCES_DETAIL6, "@li ipWhitelist: The list of hosts allowed to connect to the instances for group replication");
+
+/**
+* $(CLUSTER_ADDINSTANCES_BRIEF)
+*
+* $(CLUSTER_ADDINSTANCES_PARAM)
+* $(CLUSTER_ADDINSTANCES_PARAM1)
+*
+* $(CLUSTER_ADDINSTANCES_DETAIL)
+*
+* $(CLUSTER_ADDINSTANCES_DETAIL1)
+*
+* $(CLUSTER_ADDINSTANCES_DETAIL2)
+* $(CLUSTER_ADDINSTANCES_DETAIL3)
+* $(CLUSTER_ADDINSTANCES_DETAIL4)
+* $(CLUSTER_ADDINSTANCES_DETAIL5)
+* $(CLUSTER_ADDINSTANCES_DETAIL6)
+*/
+#if DOXYGEN_JS
+Undefined Cluster::addInstances(List instances, Dictionary options) {}
+#elif DOXYGEN_PY
+None Cluster::add_instances(list instances, dict options) {}
+#endif
+shcore::Value Cluster::add_instances(const shcore::Argument_list &args) {
+  // Throw an error if the cluster has already been dissolved
+  assert_not_dissolved("addInstances");
+
+  args.ensure_count(1, 2, get_function_name("addInstances").c_str());
+
+  check_preconditions("addInstances");
+
+  // Add the Instances to the Default ReplicaSet
+  shcore::Value ret_val;
+  try {
+    // Check if we have a Default ReplicaSet
+    if (!_default_replica_set)
+      throw shcore::Exception::logic_error("ReplicaSet not initialized.");
+
+    ret_val = _default_replica_set->add_instances(args);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("addInstances"));
+
+  return ret_val;
+}
+
 REGISTER_HELP(CLUSTER_REJOININSTANCE_BRIEF, "Rejoins an Instance to the cluster.");
 REGISTER_HELP(CLUSTER_REJOININSTANCE_PARAM, "@param instance An instance definition.");
 REGISTER_HELP(CLUSTER_REJOININSTANCE_PARAM1, "@param options Optional dictionary with options for the operation.");
@@ -512,6 +589,9 @@ shcore::Value Cluster::describe(const shcore::Argument_list &args) {
 
   auto state = check_preconditions("describe");
 
+  // Nothing is written, the metadata may come from a secondary
+  MetadataStorage::Secondary_reads secondary_reads(_metadata_storage);
+
   bool warning = (state.source_state != ManagedInstance::OnlineRW &&
                   state.source_state != ManagedInstance::OnlineRO);
 
@@ -543,30 +623,51 @@ shcore::Value Cluster::describe(const shcore::Argument_list &args) {
 }
 
 REGISTER_HELP(CLUSTER_STATUS_BRIEF, "Describe the status of the cluster.");
+REGISTER_HELP(CLUSTER_STATUS_PARAM, "@param options Optional dictionary with options to include more details on the status.");
 REGISTER_HELP(CLUSTER_STATUS_RETURN, "@return A JSON object describing the status of the cluster.");
 REGISTER_HELP(CLUSTER_STATUS_DETAIL, "This function describes the status of the cluster including its ReplicaSets and Instances.");
+REGISTER_HELP(CLUSTER_STATUS_DETAIL1, "The following options may be given:");
+REGISTER_HELP(CLUSTER_STATUS_DETAIL2, "@li extended: if true, the statistics of each instance are read from the instance itself "\
+"and included in its memberStats, all the instances are queried in parallel.");
+REGISTER_HELP(CLUSTER_STATUS_DETAIL3, "@li timeout: the number of seconds to wait for the statistics of the instances, 5 by default. "\
+"The instances not answering in time are reported with a memberStatsError.");
+REGISTER_HELP(CLUSTER_STATUS_DETAIL4, "@li watch: the number of seconds between samples of the members. Rather than returning the status, "\
+"a JSON line is printed with the status, mode and transactionsInQueue of every member, followed by a line with the fields "\
+"that changed whenever a sample differs from the previous one. The watch ends on Ctrl-C.");
+REGISTER_HELP(CLUSTER_STATUS_DETAIL5, "@li count: with watch, the number of samples to take before returning, 0 (no limit) by default.");
 
 /**
 * $(CLUSTER_STATUS_BRIEF)
 *
+* $(CLUSTER_STATUS_PARAM)
+*
 * $(CLUSTER_STATUS_RETURN)
 *
 * $(CLUSTER_STATUS_DETAIL)
+*
+* $(CLUSTER_STATUS_DETAIL1)
+* $(CLUSTER_STATUS_DETAIL2)
+* $(CLUSTER_STATUS_DETAIL3)
+* $(CLUSTER_STATUS_DETAIL4)
+* $(CLUSTER_STATUS_DETAIL5)
 */
 #if DOXYGEN_JS
-String Cluster::status() {}
+String Cluster::status(Dictionary options) {}
 #elif DOXYGEN_PY
-str Cluster::status() {}
+str Cluster::status(dict options) {}
 #endif
 
 shcore::Value Cluster::status(const shcore::Argument_list &args) {
   // Throw an error if the cluster has already been dissolved
   assert_not_dissolved("status");
 
-  args.ensure_count(0, get_function_name("status").c_str());
+  args.ensure_count(0, 1, get_function_name("status").c_str());
 
   auto state = check_preconditions("status");
 
+  // Nothing is written, the metadata may come from a secondary
+  MetadataStorage::Secondary_reads secondary_reads(_metadata_storage);
+
   bool warning = (state.source_state != ManagedInstance::OnlineRW &&
                   state.source_state != ManagedInstance::OnlineRO);
 
@@ -576,12 +677,50 @@ shcore::Value Cluster::status(const shcore::Argument_list &args) {
 
     auto status = ret_val.as_map();
 
+    bool extended = false;
+    int timeout = 5;
+    if (args.size() == 1) {
+      shcore::Argument_map opt_map(*args.map_at(0));
+
+      opt_map.ensure_keys({}, {"extended", "timeout", "watch", "count"}, "status options");
+
+      if (opt_map.has_key("watch")) {
+        int interval = opt_map.int_at("watch");
+        if (interval <= 0)
+          throw shcore::Exception::argument_error("The watch option must be a positive number of seconds");
+
+        int count = opt_map.has_key("count") ? opt_map.int_at("count") : 0;
+        if (count < 0)
+          throw shcore::Exception::argument_error("The count option must not be negative");
+
+        if (opt_map.has_key("extended") || opt_map.has_key("timeout"))
+          throw shcore::Exception::argument_error("The extended and timeout options cannot be used with watch");
+
+        if (!_default_replica_set)
+          throw shcore::Exception::logic_error("ReplicaSet not initialized.");
+
+        watch_status(interval, count);
+        return shcore::Value();
+      } else if (opt_map.has_key("count")) {
+        throw shcore::Exception::argument_error("The count option is only valid with watch");
+      }
+
+      if (opt_map.has_key("extended"))
+        extended = opt_map.bool_at("extended");
+
+      if (opt_map.has_key("timeout")) {
+        timeout = opt_map.int_at("timeout");
+        if (timeout <= 0)
+          throw shcore::Exception::argument_error("The timeout option must be a positive number of seconds");
+      }
+    }
+
     (*status)["clusterName"] = shcore::Value(_name);
 
     if (!_default_replica_set)
       (*status)["defaultReplicaSet"] = shcore::Value::Null();
     else
-      (*status)["defaultReplicaSet"] = _default_replica_set->get_status(state);
+      (*status)["defaultReplicaSet"] = _default_replica_set->get_status(state, extended, timeout);
 
     if (warning) {
       std::string warning = "The instance status may be inaccurate as it was generated from an instance in ";
@@ -594,6 +733,72 @@ shcore::Value Cluster::status(const shcore::Argument_list &args) {
   return ret_val;
 }
 
+void Cluster::watch_status(int interval, int count) {
+  auto shell = _metadata_storage->get_dba()->get_owner();
+  auto token = shcore::Cancellation_token::current();
+  auto started = std::chrono::steady_clock::now();
+
+  shcore::Value::Map_type_ref last;
+  for (int sample = 0; count == 0 || sample < count; sample++) {
+    if (token && token->cancelled())
+      break;
+
+    auto sampled = std::chrono::steady_clock::now();
+    auto members = _default_replica_set->sample_members();
+
+    // The first line has every member, the next ones only what changed,
+    // null standing for a member that is gone
+    shcore::Value::Map_type_ref changes(new shcore::Value::Map_type());
+    if (!last) {
+      changes = members;
+    } else {
+      for (auto &member : *members) {
+        auto previous = last->find(member.first);
+        if (previous == last->end()) {
+          (*changes)[member.first] = member.second;
+          continue;
+        }
+
+        shcore::Value::Map_type_ref changed(new shcore::Value::Map_type());
+        for (auto &field : *member.second.as_map()) {
+          auto old_field = previous->second.as_map()->find(field.first);
+          if (old_field == previous->second.as_map()->end() || !(old_field->second == field.second))
+            (*changed)[field.first] = field.second;
+        }
+
+        if (!changed->empty())
+          (*changes)[member.first] = shcore::Value(changed);
+      }
+
+      for (auto &member : *last) {
+        if (!members->has_key(member.first))
+          (*changes)[member.first] = shcore::Value::Null();
+      }
+    }
+
+    if (!last || !changes->empty()) {
+      shcore::Value::Map_type_ref line(new shcore::Value::Map_type());
+      (*line)["elapsed"] = shcore::Value(std::chrono::duration<double>(sampled - started).count());
+      (*line)[last ? "changes" : "members"] = shcore::Value(changes);
+      shell->print(shcore::Value(line).json(false) + "\n");
+    }
+
+    last = members;
+
+    if (count && sample + 1 == count)
+      break;
+
+    // Sleeps in short slices, so Ctrl-C ends the watch right away
+    auto next = sampled + std::chrono::seconds(interval);
+    for (auto now = std::chrono::steady_clock::now(); now < next; now = std::chrono::steady_clock::now()) {
+      if (token && token->cancelled())
+        return;
+      std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(next - now,
+                                                                                std::chrono::milliseconds(100)));
+    }
+  }
+}
+
 REGISTER_HELP(CLUSTER_DISSOLVE_BRIEF, "Dissolves the cluster.");
 REGISTER_HELP(CLUSTER_DISSOLVE_PARAM, "@param options Optional parameter to specify if it should deactivate replication and unregister the ReplicaSets from the cluster.");
 REGISTER_HELP(CLUSTER_DISSOLVE_DETAIL, "This function disables replication on the ReplicaSets, unregisters them and the the cluster from the metadata.");
@@ -621,6 +826,15 @@ shcore::Value Cluster::dissolve(const shcore::Argument_list &args) {
 
   args.ensure_count(0, 1, get_function_name("dissolve").c_str());
 
+  // The metadata is gone once only the last instance had to leave the group
+  try {
+    if (_default_replica_set && _default_replica_set->resume_removal_from_gr()) {
+      _dissolved = true;
+      return Value();
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("dissolve"))
+
   check_preconditions("dissolve");
 
   try {
@@ -660,15 +874,15 @@ shcore::Value Cluster::dissolve(const shcore::Argument_list &args) {
         // Gets the instances on the only available replica set
         auto instances = _metadata_storage->get_replicaset_instances(_default_replica_set->get_id());
 
-        _metadata_storage->drop_replicaset(_default_replica_set->get_id());
-
-        // TODO: we only have the Default ReplicaSet, but will have more in the future
-        _metadata_storage->drop_cluster(cluster_name);
+        // The metadata is dropped once only the last instance is on the group
+        _default_replica_set->remove_instances_from_gr(instances, [&]() {
+          _metadata_storage->drop_replicaset(_default_replica_set->get_id());
 
-        tx.commit();
+          // TODO: we only have the Default ReplicaSet, but will have more in the future
+          _metadata_storage->drop_cluster(cluster_name);
 
-        // once the data changes are done, we proceed doing the remove from GR
-        _default_replica_set->remove_instances_from_gr(instances);
+          tx.commit();
+        });
 
         // Set the flag, marking this cluster instance as invalid.
         _dissolved = true;
@@ -726,6 +940,154 @@ shcore::Value::Map_type_ref Cluster::_rescan(const shcore::Argument_list &args)
   return ret_val;
 }
 
+REGISTER_HELP(CLUSTER_GETSESSION_BRIEF, "Opens a session to a member of the cluster.");
+REGISTER_HELP(CLUSTER_GETSESSION_PARAM, "@param options Optional dictionary with the kind of member to connect to.");
+REGISTER_HELP(CLUSTER_GETSESSION_RETURN, "@return A ClassicSession to an ONLINE member of the cluster.");
+REGISTER_HELP(CLUSTER_GETSESSION_DETAIL, "This function opens a session to an ONLINE member of the default ReplicaSet, "\
+"with the credentials of the session used to manage the cluster. Reporting queries can be sent to the secondaries "\
+"through it rather than loading the primary.");
+REGISTER_HELP(CLUSTER_GETSESSION_DETAIL1, "The following options may be given:");
+REGISTER_HELP(CLUSTER_GETSESSION_DETAIL2, "@li mode: 'read' for a secondary, or the primary if no secondary is ONLINE, "\
+"'write' for the primary. 'read' by default.");
+REGISTER_HELP(CLUSTER_GETSESSION_DETAIL3, "@li balance: how the secondaries are chosen, 'round-robin' to take each one in turn "\
+"or 'latency' for the one that took the least time to connect to so far. 'round-robin' by default.");
+REGISTER_HELP(CLUSTER_GETSESSION_DETAIL4, "The members are read from the group on every call, so the members that left it are not used. "\
+"A member that cannot be connected to is skipped in favour of the next one.");
+
+/**
+* $(CLUSTER_GETSESSION_BRIEF)
+*
+* $(CLUSTER_GETSESSION_PARAM)
+*
+* $(CLUSTER_GETSESSION_RETURN)
+*
+* $(CLUSTER_GETSESSION_DETAIL)
+*
+* $(CLUSTER_GETSESSION_DETAIL1)
+* $(CLUSTER_GETSESSION_DETAIL2)
+* $(CLUSTER_GETSESSION_DETAIL3)
+*
+* $(CLUSTER_GETSESSION_DETAIL4)
+*/
+#if DOXYGEN_JS
+ClassicSession Cluster::getSession(Dictionary options) {}
+#elif DOXYGEN_PY
+ClassicSession Cluster::get_session(dict options) {}
+#endif
+
+shcore::Value Cluster::get_session(const shcore::Argument_list &args) {
+  // Throw an error if the cluster has already been dissolved
+  assert_not_dissolved("getSession");
+
+  args.ensure_count(0, 1, get_function_name("getSession").c_str());
+
+  check_preconditions("getSession");
+
+  shcore::Value ret_val;
+  try {
+    std::string mode = "read";
+    std::string balance = "round-robin";
+    if (args.size() == 1) {
+      shcore::Argument_map opt_map(*args.map_at(0));
+
+      opt_map.ensure_keys({}, {"mode", "balance"}, "getSession options");
+
+      if (opt_map.has_key("mode"))
+        mode = opt_map.string_at("mode");
+
+      if (opt_map.has_key("balance"))
+        balance = opt_map.string_at("balance");
+    }
+
+    if (mode != "read" && mode != "write")
+      throw shcore::Exception::argument_error("The mode option must be either 'read' or 'write'");
+
+    if (balance != "round-robin" && balance != "latency")
+      throw shcore::Exception::argument_error("The balance option must be either 'round-robin' or 'latency'");
+
+    if (!_default_replica_set)
+      throw shcore::Exception::logic_error("ReplicaSet not initialized.");
+
+    auto session = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(_metadata_storage
+                        ->get_dba()->get_active_session());
+
+    // On multi-primary groups every member takes writes
+    std::string primary_uuid;
+    if (_default_replica_set->get_topology_type() == ReplicaSet::kTopologyPrimaryMaster)
+      get_status_variable(session->connection(), "group_replication_primary_member", primary_uuid, false);
+
+    std::vector<std::string> primaries;
+    std::vector<std::string> secondaries;
+    for (auto &instance : _default_replica_set->get_topology().instances) {
+      if (!instance.in_group || !instance.in_metadata || instance.member_state != "ONLINE")
+        continue;
+
+      if (primary_uuid.empty() || instance.uuid == primary_uuid)
+        primaries.push_back(instance.host);
+      else
+        secondaries.push_back(instance.host);
+    }
+
+    std::vector<std::string> candidates = (mode == "read" && !secondaries.empty()) ? secondaries : primaries;
+    if (candidates.empty())
+      throw shcore::Exception::runtime_error("There are no ONLINE members to connect to");
+
+    if (balance == "latency") {
+      // The members never connected to go first, so all of them get timed
+      std::stable_sort(candidates.begin(), candidates.end(), [this](const std::string &a, const std::string &b) {
+        auto a_latency = _member_latency.find(a);
+        auto b_latency = _member_latency.find(b);
+        if (b_latency == _member_latency.end())
+          return false;
+        return a_latency == _member_latency.end() || a_latency->second < b_latency->second;
+      });
+    } else {
+      std::rotate(candidates.begin(), candidates.begin() + (_next_member++ % candidates.size()), candidates.end());
+    }
+
+    shcore::SslInfo ssl_info;
+    ssl_info.ca = session->get_ssl_ca();
+    ssl_info.cert = session->get_ssl_cert();
+    ssl_info.key = session->get_ssl_key();
+    ssl_info.skip = ssl_info.ca.empty() && ssl_info.cert.empty() && ssl_info.key.empty();
+
+    std::string last_error;
+    for (auto &address : candidates) {
+      shcore::Connection_options options = shcore::Connection_options::parse(address, false);
+      options.user = session->get_user();
+      options.password = session->get_password();
+      options.has_password = true;
+      options.ssl = ssl_info;
+
+      auto start = std::chrono::steady_clock::now();
+      try {
+        ret_val = shcore::Value(std::dynamic_pointer_cast<shcore::Object_bridge>(
+          mysqlsh::connect_session(options, SessionType::Classic)));
+      } catch (std::exception &e) {
+        log_warning("Unable to connect to the cluster member %s: %s", address.c_str(), e.what());
+        last_error = e.what();
+        _member_latency.erase(address);
+        continue;
+      }
+
+      // Smoothed, so a single slow connect does not rule out a member
+      double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      auto known = _member_latency.find(address);
+      if (known == _member_latency.end())
+        _member_latency[address] = latency;
+      else
+        known->second = 0.7 * known->second + 0.3 * latency;
+
+      break;
+    }
+
+    if (!ret_val)
+      throw shcore::Exception::runtime_error("Unable to connect to any ONLINE member of the cluster: " + last_error);
+  } CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("getSession"));
+
+  return ret_val;
+}
+
 REGISTER_HELP(CLUSTER_FORCEQUORUMUSINGPARTITIONOF_BRIEF, "Restores the cluster from quorum loss.");
 REGISTER_HELP(CLUSTER_FORCEQUORUMUSINGPARTITIONOF_PARAM, "@param instance An instance definition to derive the forced group from.");
 REGISTER_HELP(CLUSTER_FORCEQUORUMUSINGPARTITIONOF_PARAM1, "@param password Optional string with the password for the connection.");
@@ -50,6 +50,7 @@ public:
   virtual bool operator == (const Object_bridge &other) const;
 
   virtual shcore::Value get_member(const std::string &prop) const;
+  virtual shcore::Value call(const std::string &name, const shcore::Argument_list &args);
 
   const uint64_t get_id() { return _id; }
   void set_id(uint64_t id) { _id = id; }
@@ -83,6 +84,7 @@ public:
 
 public:
   shcore::Value add_instance(const shcore::Argument_list &args);
+  shcore::Value add_instances(const shcore::Argument_list &args);
   shcore::Value rejoin_instance(const shcore::Argument_list &args);
   shcore::Value remove_instance(const shcore::Argument_list &args);
   shcore::Value get_replicaset(const shcore::Argument_list &args);
@@ -92,6 +94,7 @@ public:
   shcore::Value check_instance_state(const shcore::Argument_list &args);
   shcore::Value rescan(const shcore::Argument_list &args);
   shcore::Value force_quorum_using_partition_of(const shcore::Argument_list &args);
+  shcore::Value get_session(const shcore::Argument_list &args);
 
   ReplicationGroupState check_preconditions(const std::string& function_name) const;
 
@@ -101,28 +104,32 @@ public:
   String getName();
   String getAdminType();
   Undefined addInstance(InstanceDef instance, Dictionary options);
+  Undefined addInstances(List instances, Dictionary options);
   Undefined rejoinInstance(InstanceDef instance, Dictionary options);
   Undefined removeInstance(InstanceDef instance, String password);
   Dictionary checkInstanceState(InstanceDef instance, String password);
   String describe();
-  String status();
+  String status(Dictionary options);
   Undefined dissolve(Dictionary options);
   Undefined rescan();
   Undefined forceQuorumUsingPartitionOf(InstanceDef instance, String password);
+  ClassicSession getSession(Dictionary options);
 #elif DOXYGEN_PY
   str name; //!< $(CLUSTER_NAME_BRIEF)
   std admin_type; //!< $(CLUSTER_ADMINTYPE_BRIEF)
   str get_name();
   str get_admin_type();
   None add_instance(InstanceDef instance, dict options);
+  None add_instances(list instances, dict options);
   None rejoin_instance(InstanceDef instance, dict options);
   None remove_instance(InstanceDef instance, str password);
   dict check_instance_state(InstanceDef instance, str password);
   str describe();
-  str status();
+  str status(dict options);
   None dissolve(Dictionary options);
   None rescan();
   None force_quorum_using_partition_of(InstanceDef instance, str password);
+  ClassicSession get_session(dict options);
 #endif
 
 protected:
@@ -144,6 +151,13 @@ private:
   void set_account_data(const std::string& account, const std::string& key, const std::string& value);
   std::string get_account_data(const std::string& account, const std::string& key);
   shcore::Value::Map_type_ref _rescan(const shcore::Argument_list &args);
+  // Prints the samples of the members of status({watch}) as JSON lines
+  void watch_status(int interval, int count);
+
+  // The balancing state of getSession(): the turn of the round-robin, and
+  // the smoothed connect time of the members, in seconds
+  size_t _next_member;
+  std::map<std::string, double> _member_latency;
 };
 }
 }
@@ -23,6 +23,7 @@
 #include "modules/adminapi/mod_dba_common.h"
 #include "utils/utils_general.h"
 #include "utils/utils_sqlstring.h"
+#include "shellcore/shell_core_options.h"
 #include "modules/adminapi/mod_dba.h"
 #include "modules/adminapi/mod_dba_sql.h"
 #include "modules/adminapi/mod_dba_metadata_storage.h"
@@ -39,6 +40,7 @@ std::map<std::string, FunctionAvailability> AdminAPI_function_availability = {
 
   // The Replicaset/Cluster functions
   {"Cluster.addInstance", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW}},
+  {"Cluster.addInstances", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW}},
   {"Cluster.removeInstance", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW}},
   {"Cluster.rejoinInstance", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW | ManagedInstance::State::OnlineRO}},
   {"Cluster.describe", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Any, ManagedInstance::State::Any}},
@@ -46,6 +48,7 @@ std::map<std::string, FunctionAvailability> AdminAPI_function_availability = {
   {"Cluster.dissolve", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW}},
   {"Cluster.checkInstanceState", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW | ManagedInstance::State::OnlineRO}},
   {"Cluster.rescan", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Normal, ManagedInstance::State::OnlineRW}},
+  {"Cluster.getSession", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Any, ManagedInstance::State::Any}},
   {"ReplicaSet.status", {GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Any, ManagedInstance::State::Any}},
   {"Cluster.forceQuorumUsingPartitionOf", {GRInstanceType::GroupReplication | GRInstanceType::InnoDBCluster, ReplicationQuorum::State::Any, ManagedInstance::State::OnlineRW | ManagedInstance::State::OnlineRO}}
 };
@@ -121,6 +124,20 @@ void resolve_instance_credentials(const shcore::Value::Map_type_ref& options, sh
   }
 }
 
+static std::chrono::milliseconds option_seconds(const char *name) {
+  return std::chrono::seconds((*shcore::Shell_core_options::get())[name].as_int());
+}
+
+Operation_scope::Operation_scope(const std::string &name)
+    : shcore::Cancellation_scope(option_seconds(SHCORE_DBA_OPERATION_TIMEOUT),
+                                 option_seconds(SHCORE_DBA_STEP_TIMEOUT)) {
+  std::string trace_file = (*shcore::Shell_core_options::get())[SHCORE_DBA_TRACE_FILE].as_string();
+  if (!trace_file.empty())
+    _trace.reset(new shcore::Trace_session(trace_file));
+
+  _span.reset(new shcore::Trace_span(name));
+}
+
 // Parses the argument list to retrieve an instance definition from it
 // It handles loading the pass
 shcore::Value::Map_type_ref get_instance_options_map(const shcore::Argument_list &args,
@@ -216,6 +233,9 @@ ReplicationGroupState check_function_preconditions(const std::string &class_name
   std::string error;
   ReplicationGroupState state;
 
+  // Every call verifies once that the cached metadata is still current
+  metadata->check_snapshot();
+
   // A classic session is required to perform any of the AdminAPI operations
   auto session = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(metadata->get_dba()->get_active_session());
   if (!session)
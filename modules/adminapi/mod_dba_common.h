@@ -24,6 +24,8 @@
 #include "shellcore/lang_base.h"
 #include "modules/mod_mysql_session.h"
 #include "modules/adminapi/mod_dba_provisioning_interface.h"
+#include "utils/utils_cancel.h"
+#include "utils/utils_trace.h"
 
 namespace mysqlsh {
 namespace dba {
@@ -106,6 +108,18 @@ extern const std::set<std::string> _instance_options;
 
 shcore::Value::Map_type_ref get_instance_options_map(const shcore::Argument_list &args, PasswordFormat::Format format);
 void resolve_instance_credentials(const shcore::Value::Map_type_ref& options, shcore::Interpreter_delegate* delegate = nullptr);
+
+// An AdminAPI operation, cancelled by Ctrl-C and bounded by the
+// dbaOperationTimeout and dbaStepTimeout shell options. Its steps are traced
+// to the dbaTraceFile shell option when set.
+class Operation_scope : public shcore::Cancellation_scope {
+public:
+  explicit Operation_scope(const std::string &name);
+
+private:
+  std::unique_ptr<shcore::Trace_session> _trace;
+  std::unique_ptr<shcore::Trace_span> _span;
+};
 std::string get_mysqlprovision_error_string(const shcore::Value::Array_type_ref& errors);
 ReplicationGroupState check_function_preconditions(const std::string& class_name, const std::string& base_function_name, const std::string &function_name, const std::shared_ptr<MetadataStorage>& metadata);
 
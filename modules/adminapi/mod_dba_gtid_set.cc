@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/adminapi/mod_dba_gtid_set.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "shellcore/types.h"
+
+namespace mysqlsh {
+namespace dba {
+namespace {
+bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+std::string trim(const std::string &text) {
+  size_t start = 0;
+  size_t end = text.size();
+
+  while (start < end && is_blank(text[start]))
+    start++;
+
+  while (end > start && is_blank(text[end - 1]))
+    end--;
+
+  return text.substr(start, end - start);
+}
+
+bool is_uuid(const std::string &uuid) {
+  // 8-4-4-4-12 hexadecimal digits
+  if (uuid.size() != 36)
+    return false;
+
+  for (size_t index = 0; index < uuid.size(); index++) {
+    if (index == 8 || index == 13 || index == 18 || index == 23) {
+      if (uuid[index] != '-')
+        return false;
+    } else if (!std::isxdigit(static_cast<unsigned char>(uuid[index]))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool parse_number(const std::string &text, uint64_t *number) {
+  if (text.empty() || text.size() > 19)
+    return false;
+
+  for (char c : text) {
+    if (c < '0' || c > '9')
+      return false;
+  }
+
+  *number = std::strtoull(text.c_str(), nullptr, 10);
+  return true;
+}
+
+shcore::Exception invalid_set(const std::string &gtids) {
+  return shcore::Exception::argument_error("Invalid GTID set: '" + gtids + "'");
+}
+}
+
+Gtid_set::Gtid_set(const std::string &gtids) {
+  size_t start = 0;
+
+  while (start <= gtids.size()) {
+    size_t end = gtids.find(',', start);
+    if (end == std::string::npos)
+      end = gtids.size();
+
+    std::string item = trim(gtids.substr(start, end - start));
+    start = end + 1;
+
+    // The empty set and a trailing comma are accepted by the server
+    if (item.empty()) {
+      if (end < gtids.size())
+        throw invalid_set(gtids);
+      continue;
+    }
+
+    size_t colon = item.find(':');
+    std::string uuid = trim(item.substr(0, colon));
+    if (!is_uuid(uuid) || colon == std::string::npos)
+      throw invalid_set(gtids);
+
+    std::transform(uuid.begin(), uuid.end(), uuid.begin(), ::tolower);
+    Intervals &intervals = _intervals[uuid];
+
+    while (colon != std::string::npos) {
+      size_t next = item.find(':', colon + 1);
+      std::string interval = trim(item.substr(colon + 1, next == std::string::npos ? std::string::npos : next - colon - 1));
+      colon = next;
+
+      size_t dash = interval.find('-');
+      uint64_t first, last;
+      if (!parse_number(interval.substr(0, dash), &first))
+        throw invalid_set(gtids);
+
+      if (dash == std::string::npos)
+        last = first;
+      else if (!parse_number(interval.substr(dash + 1), &last))
+        throw invalid_set(gtids);
+
+      // Transaction numbers start at 1
+      if (first == 0 || last < first)
+        throw invalid_set(gtids);
+
+      intervals.push_back(std::make_pair(first, last));
+    }
+
+    normalize(&intervals);
+  }
+}
+
+void Gtid_set::normalize(Intervals *intervals) {
+  std::sort(intervals->begin(), intervals->end());
+
+  // Merges the overlapping and adjacent intervals
+  size_t last = 0;
+  for (size_t index = 1; index < intervals->size(); index++) {
+    auto &current = (*intervals)[last];
+    const auto &next = (*intervals)[index];
+
+    if (next.first <= current.second + 1)
+      current.second = std::max(current.second, next.second);
+    else
+      (*intervals)[++last] = next;
+  }
+
+  if (!intervals->empty())
+    intervals->resize(last + 1);
+}
+
+uint64_t Gtid_set::count() const {
+  uint64_t ret_val = 0;
+
+  for (auto &uuid : _intervals) {
+    for (auto &interval : uuid.second)
+      ret_val += interval.second - interval.first + 1;
+  }
+
+  return ret_val;
+}
+
+bool Gtid_set::is_subset_of(const Gtid_set &other) const {
+  for (auto &uuid : _intervals) {
+    auto found = other._intervals.find(uuid.first);
+    if (found == other._intervals.end())
+      return false;
+
+    // Every interval must be contained by a single one of other, as they
+    // are merged
+    const Intervals &others = found->second;
+    auto position = others.begin();
+    for (auto &interval : uuid.second) {
+      while (position != others.end() && position->second < interval.first)
+        ++position;
+
+      if (position == others.end() || position->first > interval.first || position->second < interval.second)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+Gtid_set &Gtid_set::add(const Gtid_set &other) {
+  for (auto &uuid : other._intervals) {
+    Intervals &intervals = _intervals[uuid.first];
+    intervals.insert(intervals.end(), uuid.second.begin(), uuid.second.end());
+    normalize(&intervals);
+  }
+
+  return *this;
+}
+
+Gtid_set &Gtid_set::subtract(const Gtid_set &other) {
+  if (&other == this) {
+    _intervals.clear();
+    return *this;
+  }
+
+  for (auto &uuid : other._intervals) {
+    auto found = _intervals.find(uuid.first);
+    if (found == _intervals.end())
+      continue;
+
+    Intervals result;
+    auto removed = uuid.second.begin();
+
+    for (auto interval : found->second) {
+      while (removed != uuid.second.end() && removed->second < interval.first)
+        ++removed;
+
+      // Cuts the removed intervals out of the current one, both are sorted
+      auto position = removed;
+      while (position != uuid.second.end() && position->first <= interval.second) {
+        if (position->first > interval.first)
+          result.push_back(std::make_pair(interval.first, position->first - 1));
+
+        if (position->second >= interval.second) {
+          interval.first = interval.second + 1;
+          break;
+        }
+
+        interval.first = position->second + 1;
+        ++position;
+      }
+
+      if (interval.first <= interval.second)
+        result.push_back(interval);
+    }
+
+    if (result.empty())
+      _intervals.erase(found);
+    else
+      found->second.swap(result);
+  }
+
+  return *this;
+}
+
+std::string Gtid_set::str() const {
+  std::string ret_val;
+
+  for (auto &uuid : _intervals) {
+    if (uuid.second.empty())
+      continue;
+
+    if (!ret_val.empty())
+      ret_val += ",\n";
+
+    ret_val += uuid.first;
+
+    for (auto &interval : uuid.second) {
+      ret_val += ":" + std::to_string(interval.first);
+      if (interval.second != interval.first)
+        ret_val += "-" + std::to_string(interval.second);
+    }
+  }
+
+  return ret_val;
+}
+}
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MODULES_ADMINAPI_MOD_DBA_GTID_SET_
+#define _MODULES_ADMINAPI_MOD_DBA_GTID_SET_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "shellcore/common.h"
+
+namespace mysqlsh {
+namespace dba {
+// A GTID set as in @@gtid_executed, i.e. "uuid:1-5:7,uuid:3", held as the
+// sorted and merged transaction intervals of every server uuid so the
+// comparisons done by the AdminAPI need no round trip to a server.
+class SHCORE_PUBLIC Gtid_set {
+public:
+  Gtid_set() {}
+
+  // Throws an argument error if the text is not a valid GTID set
+  explicit Gtid_set(const std::string &gtids);
+
+  bool empty() const { return _intervals.empty(); }
+
+  // Number of transactions in the set
+  uint64_t count() const;
+
+  // Same as GTID_SUBSET(this, other)
+  bool is_subset_of(const Gtid_set &other) const;
+
+  // Union with other
+  Gtid_set &add(const Gtid_set &other);
+
+  // Same as GTID_SUBTRACT(this, other)
+  Gtid_set &subtract(const Gtid_set &other);
+
+  // The set in the format used by the server, uuids in lower case and
+  // sorted
+  std::string str() const;
+
+  bool operator==(const Gtid_set &other) const { return _intervals == other._intervals; }
+  bool operator!=(const Gtid_set &other) const { return _intervals != other._intervals; }
+
+private:
+  // Closed intervals of transaction numbers, sorted and not adjacent
+  typedef std::vector<std::pair<uint64_t, uint64_t> > Intervals;
+
+  static void normalize(Intervals *intervals);
+
+  std::map<std::string, Intervals> _intervals;
+};
+}
+}
+
+#endif
@@ -21,30 +21,101 @@
 #include "mod_dba_metadata_storage.h"
 #include "modules/adminapi/metadata-model_definitions.h"
 //#include "modules/adminapi/mod_dba_instance.h"
+#include "modules/base_session.h"
+#include "modules/member_latency.h"
 #include "modules/mod_mysql_session.h"
 #include "modules/mod_mysql_resultset.h"
 #include "modules/mysql_connection.h"
 #include "mysqlx_connection.h" // for error codes
 
+#include "utils/utils_cancel.h"
+#include "utils/utils_trace.h"
 #include "utils/utils_file.h"
 #include "utils/utils_general.h"
+#include <boost/algorithm/string/predicate.hpp>
 #include <random>
+#include <set>
 
 #define PASSWORD_LENGTH 16
 
 // How many times to retry a query if it fails because it's SUPER_READ_ONLY
 static const int kMaxReadOnlyRetries = 10;
 
+// How long a verified metadata snapshot is trusted without verifying it again
+static const std::chrono::seconds kSnapshotCheckInterval(1);
+
+// The snapshot version: the server, its group view ID and the last update
+// time of the metadata tables. UPDATE_TIME has a resolution of one second so nothing is
+// kept while the metadata was updated in the last couple of seconds.
+static const char *kSnapshotVersionQuery =
+  "SELECT @@server_uuid, (SELECT VIEW_ID FROM performance_schema.replication_group_member_stats LIMIT 1),"
+  " t.update_time, t.update_time > NOW() - INTERVAL 2 SECOND"
+  " FROM (SELECT MAX(UPDATE_TIME) AS update_time FROM information_schema.tables"
+  " WHERE TABLE_SCHEMA = 'mysql_innodb_cluster_metadata') t";
+
+// How long a secondary may take to apply the transactions of the primary
+// before the metadata is read from the primary instead
+static const int kSecondaryWaitTimeout = 1;
+
+// How long to keep reading from the primary after no secondary could be used
+static const std::chrono::seconds kSecondaryRetryInterval(10);
+
+// The ONLINE members of the group other than the given session's server and
+// the primary, with their addresses
+static const char *kSecondariesQuery =
+  "SELECT JSON_UNQUOTE(i.addresses->'$.mysqlClassic')"
+  " FROM performance_schema.replication_group_members g"
+  " JOIN mysql_innodb_cluster_metadata.instances i ON g.member_id = i.mysql_server_uuid"
+  " WHERE g.member_state = 'ONLINE' AND g.member_id <> @@server_uuid"
+  " AND g.member_id <> IFNULL((SELECT variable_value FROM performance_schema.global_status"
+  " WHERE variable_name = 'group_replication_primary_member'), '')";
+
 using namespace mysqlsh;
 using namespace mysqlsh::dba;
 using namespace shcore;
 
 MetadataStorage::MetadataStorage(Dba* dba) :
-_dba(dba) {}
+_dba(dba), _snapshot_checked(false), _in_transaction(false), _secondary_reads(0),
+_primary_gtid_set_stale(true), _secondary_synced(false) {}
 
 MetadataStorage::~MetadataStorage() {}
 
+// Anything other than a SELECT or SHOW may change the metadata
+static bool is_read_statement(const std::string &sql) {
+  size_t start = sql.find_first_not_of(" \t\r\n(");
+  if (start == std::string::npos)
+    return false;
+
+  std::string statement = sql.substr(start);
+  return boost::istarts_with(statement, "select") || boost::istarts_with(statement, "show");
+}
+
 std::shared_ptr<mysql::ClassicResult> MetadataStorage::execute_sql(const std::string &sql, bool retry, const std::string &log_sql) const {
+  if (!is_read_statement(sql)) {
+    clear_snapshot();
+    _primary_gtid_set_stale = true;
+  }
+
+  return execute_sql(_dba->get_active_session(), sql, retry, log_sql);
+}
+
+std::shared_ptr<mysql::ClassicResult> MetadataStorage::execute_read_sql(const std::string &sql) const {
+  auto session = read_session();
+  try {
+    return execute_sql(session, sql, false, "");
+  } catch (shcore::Exception &e) {
+    if (session != _secondary)
+      throw;
+
+    log_info("DBA: reading the metadata from the primary, the secondary failed: %s", e.what());
+    drop_secondary();
+  }
+
+  return execute_sql(_dba->get_active_session(), sql, false, "");
+}
+
+std::shared_ptr<mysql::ClassicResult> MetadataStorage::execute_sql(const std::shared_ptr<ShellDevelopmentSession> &session,
+                                                                   const std::string &sql, bool retry, const std::string &log_sql) const {
   shcore::Value ret_val;
 
   if (log_sql.empty())
@@ -52,12 +123,20 @@ std::shared_ptr<mysql::ClassicResult> MetadataStorage::execute_sql(const std::st
   else
     log_debug("DBA: execute_sql('%s'", log_sql.c_str());
 
-  auto session = _dba->get_active_session();
   if (!session)
     throw Exception::metadata_error("The Metadata is inaccessible");
 
+  shcore::Trace_span span("metadata query");
+  if (span.recording())
+    span.set("sql", log_sql.empty() ? sql : log_sql);
+
+  auto token = shcore::Cancellation_token::current();
+
   int retry_count = kMaxReadOnlyRetries;
   while (retry_count > 0) {
+    if (token)
+      token->check("querying the metadata");
+
     try {
       ret_val = session->execute_sql(sql, shcore::Argument_list());
 
@@ -86,18 +165,210 @@ std::shared_ptr<mysql::ClassicResult> MetadataStorage::execute_sql(const std::st
   return ret_val.as_object<mysql::ClassicResult>();
 }
 
+std::shared_ptr<ShellDevelopmentSession> MetadataStorage::connect_secondary(
+    const std::shared_ptr<ShellDevelopmentSession> &primary) const {
+  auto records = execute_sql(primary, kSecondariesQuery, false, "")->call("fetchAll", shcore::Argument_list()).as_array();
+
+  shcore::SslInfo ssl_info;
+  ssl_info.ca = primary->get_ssl_ca();
+  ssl_info.cert = primary->get_ssl_cert();
+  ssl_info.key = primary->get_ssl_key();
+  ssl_info.skip = ssl_info.ca.empty() && ssl_info.cert.empty() && ssl_info.key.empty();
+
+  std::vector<std::string> addresses;
+  for (auto &record : *records)
+    addresses.push_back(record.as_object<mysqlsh::Row>()->get_member(0).as_string());
+
+  // With a recent time for the nearest secondary only that one is opened,
+  // otherwise every secondary is timed on a round trip and the fastest one
+  // is kept
+  Member_latency *latencies = Member_latency::get();
+  latencies->sort(addresses);
+  bool known_nearest = false;
+  if (!addresses.empty())
+    latencies->latency(addresses.front(), nullptr, &known_nearest);
+
+  std::shared_ptr<ShellDevelopmentSession> ret_val;
+  double best_latency = 0;
+  for (auto &address : addresses) {
+    shcore::Connection_options options = shcore::Connection_options::parse(address, false);
+    options.user = primary->get_user();
+    options.password = primary->get_password();
+    options.has_password = true;
+    options.ssl = ssl_info;
+
+    try {
+      auto session = mysqlsh::connect_session(options, SessionType::Classic);
+
+      auto start = std::chrono::steady_clock::now();
+      execute_sql(session, "SELECT 1", false, "");
+      auto rtt = std::chrono::steady_clock::now() - start;
+      latencies->record(address, rtt);
+
+      double latency = std::chrono::duration<double>(rtt).count();
+      if (!ret_val || latency < best_latency) {
+        ret_val = session;
+        best_latency = latency;
+      }
+
+      if (known_nearest)
+        break;
+    } catch (std::exception &e) {
+      log_info("DBA: unable to read the metadata from %s: %s", address.c_str(), e.what());
+      latencies->record_failure(address);
+    }
+  }
+
+  return ret_val;
+}
+
+void MetadataStorage::drop_secondary() const {
+  _secondary.reset();
+  _secondary_primary.reset();
+  _secondary_synced = false;
+  _secondary_retry_time = std::chrono::steady_clock::now() + kSecondaryRetryInterval;
+  clear_snapshot();
+}
+
+std::shared_ptr<ShellDevelopmentSession> MetadataStorage::read_session() const {
+  auto session = _dba->get_active_session();
+  if (!session || _secondary_reads == 0 || _in_transaction)
+    return session;
+
+  // The secondary belongs to the session it was chosen for
+  if (_secondary && _secondary_primary.lock() != session)
+    drop_secondary();
+
+  try {
+    if (!_secondary) {
+      if (std::chrono::steady_clock::now() < _secondary_retry_time)
+        return session;
+
+      _secondary = connect_secondary(session);
+      if (!_secondary) {
+        _secondary_retry_time = std::chrono::steady_clock::now() + kSecondaryRetryInterval;
+        return session;
+      }
+      _secondary_primary = session;
+      _secondary_synced = false;
+    }
+
+    if (_primary_gtid_set_stale) {
+      auto row = execute_sql(session, "SELECT @@GLOBAL.GTID_EXECUTED", false, "")->fetch_one();
+      _primary_gtid_set = row ? row->get_value_as_string(0) : "";
+      _primary_gtid_set_stale = false;
+      _secondary_synced = false;
+    }
+
+    if (!_secondary_synced) {
+      shcore::sqlstring query("SELECT WAIT_FOR_EXECUTED_GTID_SET(?, ?)", 0);
+      query << _primary_gtid_set << kSecondaryWaitTimeout;
+      query.done();
+
+      auto row = execute_sql(_secondary, query, false, "")->fetch_one();
+      if (!row || row->get_value(0).as_int() != 0) {
+        log_info("DBA: the secondary is behind the primary, reading the metadata from the primary");
+        return session;
+      }
+      _secondary_synced = true;
+    }
+  } catch (shcore::Exception &e) {
+    log_info("DBA: reading the metadata from the primary, the secondary failed: %s", e.what());
+    drop_secondary();
+    return session;
+  }
+
+  return _secondary;
+}
+
+void MetadataStorage::clear_snapshot() const {
+  _snapshot.clear();
+  _snapshot_version.clear();
+  _snapshot_checked = false;
+}
+
+bool MetadataStorage::snapshot_is_current(const std::shared_ptr<ShellDevelopmentSession> &session) const {
+  auto now = std::chrono::steady_clock::now();
+  if (_snapshot_checked && now - _snapshot_check_time < kSnapshotCheckInterval)
+    return !_snapshot_version.empty();
+
+  std::string version;
+  try {
+    auto row = execute_sql(session, kSnapshotVersionQuery, false, "")->fetch_one();
+    if (row) {
+      auto recent = row->get_value(3);
+      if (!recent || recent.as_int() == 0)
+        version = row->get_value_as_string(0) + "/" + row->get_value(1).descr() + "/" +
+                  row->get_value(2).descr();
+    }
+  } catch (shcore::Exception &e) {
+    log_debug("DBA: unable to verify the metadata snapshot: %s", e.what());
+  }
+
+  if (version != _snapshot_version) {
+    _snapshot.clear();
+    _snapshot_version = version;
+  }
+  _snapshot_checked = true;
+  _snapshot_check_time = now;
+
+  return !_snapshot_version.empty();
+}
+
+std::shared_ptr<shcore::Value::Array_type> MetadataStorage::fetch_all_cached(const std::string &query) const {
+  auto session = read_session();
+  try {
+    return fetch_all_cached(session, query);
+  } catch (shcore::Exception &e) {
+    if (session != _secondary)
+      throw;
+
+    log_info("DBA: reading the metadata from the primary, the secondary failed: %s", e.what());
+    drop_secondary();
+  }
+
+  return fetch_all_cached(_dba->get_active_session(), query);
+}
+
+std::shared_ptr<shcore::Value::Array_type> MetadataStorage::fetch_all_cached(
+    const std::shared_ptr<ShellDevelopmentSession> &session, const std::string &query) const {
+  bool use_snapshot = !_in_transaction && snapshot_is_current(session);
+
+  if (use_snapshot) {
+    auto records = _snapshot.find(query);
+    // A copy so the caller can't alter the snapshot
+    if (records != _snapshot.end())
+      return std::make_shared<shcore::Value::Array_type>(*records->second);
+  }
+
+  auto result = execute_sql(session, query, false, "");
+  auto records = result->call("fetchAll", shcore::Argument_list()).as_array();
+
+  if (use_snapshot)
+    _snapshot[query] = std::make_shared<shcore::Value::Array_type>(*records);
+
+  return records;
+}
+
 void MetadataStorage::start_transaction() {
   auto session = _dba->get_active_session();
+  clear_snapshot();
+  _in_transaction = true;
   session->start_transaction();
 }
 
 void MetadataStorage::commit() {
   auto session = _dba->get_active_session();
+  clear_snapshot();
+  _primary_gtid_set_stale = true;
+  _in_transaction = false;
   session->commit();
 }
 
 void MetadataStorage::rollback() {
   auto session = _dba->get_active_session();
+  clear_snapshot();
+  _in_transaction = false;
   session->rollback();
 }
 
@@ -117,11 +388,33 @@ bool MetadataStorage::metadata_schema_exists() {
 
 void MetadataStorage::create_metadata_schema() {
   if (!metadata_schema_exists()) {
+    // On a classic session the model is sent as a single script, so it
+    // takes one round trip rather than one for each statement
+    auto session = std::dynamic_pointer_cast<mysql::ClassicSession>(_dba->get_active_session());
+    if (session && session->connection()) {
+      log_debug("DBA: creating the metadata schema");
+      clear_snapshot();
+      _primary_gtid_set_stale = true;
+
+      shcore::Trace_span span("metadata query");
+      if (span.recording())
+        span.set("sql", "metadata-model.sql");
+
+      try {
+        session->connection()->run_script(shcore::md_model_sql);
+      } catch (shcore::Exception &e) {
+        log_debug("%s", e.format().c_str());
+        if (CR_SERVER_GONE_ERROR == e.code())
+          throw Exception::metadata_error("The Metadata is inaccessible");
+        throw;
+      }
+      return;
+    }
+
     std::string query = shcore::md_model_sql;
 
     size_t pos = 0;
     std::string token, delimiter = ";\n";
-    auto session = _dba->get_active_session();
     while ((pos = query.find(delimiter)) != std::string::npos) {
       token = query.substr(0, pos);
 
@@ -130,7 +423,49 @@ void MetadataStorage::create_metadata_schema() {
       query.erase(0, pos + delimiter.length());
     }
   } else {
-    // Check the Schema version and update the schema accordingly
+    upgrade_metadata_schema();
+  }
+}
+
+// The statements taking a schema of the given version to the next one
+static const struct {
+  int major, minor, patch;
+  std::vector<std::string> statements;
+} metadata_upgrades[] = {
+  {1, 0, 1, {
+    // Indexes for the lookups by address, so they stay fast with thousands
+    // of clusters on the same metadata server
+    "ALTER TABLE mysql_innodb_cluster_metadata.hosts ADD INDEX (host_name), ADD INDEX (ip_address)",
+    "ALTER TABLE mysql_innodb_cluster_metadata.instances"
+    " ADD COLUMN `mysql_classic_address` VARCHAR(265) CHARACTER SET utf8mb4 COLLATE utf8mb4_bin"
+    " AS (JSON_UNQUOTE(addresses->'$.mysqlClassic')) VIRTUAL AFTER `addresses`,"
+    " ADD INDEX (mysql_classic_address)",
+    "CREATE OR REPLACE VIEW mysql_innodb_cluster_metadata.schema_version (major, minor, patch) AS SELECT 1, 0, 2"
+  }}
+};
+
+void MetadataStorage::upgrade_metadata_schema() {
+  auto row = execute_sql("SELECT major, minor, patch FROM mysql_innodb_cluster_metadata.schema_version")->fetch_one();
+  if (!row)
+    return;
+
+  int major = static_cast<int>(row->get_value(0).as_int());
+  int minor = static_cast<int>(row->get_value(1).as_int());
+  int patch = static_cast<int>(row->get_value(2).as_int());
+
+  // Each upgrade ends updating the version, so the next one applies
+  for (auto &upgrade : metadata_upgrades) {
+    if (upgrade.major == major && upgrade.minor == minor && upgrade.patch == patch) {
+      log_info("Upgrading the metadata schema from version %d.%d.%d", major, minor, patch);
+
+      for (auto &statement : upgrade.statements)
+        execute_sql(statement);
+
+      row = execute_sql("SELECT major, minor, patch FROM mysql_innodb_cluster_metadata.schema_version")->fetch_one();
+      major = static_cast<int>(row->get_value(0).as_int());
+      minor = static_cast<int>(row->get_value(1).as_int());
+      patch = static_cast<int>(row->get_value(2).as_int());
+    }
   }
 }
 
@@ -297,7 +632,8 @@ uint32_t MetadataStorage::insert_host(const shcore::Value::Map_type_ref &options
   return static_cast<uint32_t>(result->get_member("autoIncrementValue").as_int());
 }
 
-void MetadataStorage::insert_instance(const shcore::Value::Map_type_ref& options, uint64_t host_id, uint64_t rs_id) {
+// The values of an instances table row for the given instance definition
+static std::string instance_values(const shcore::Value::Map_type_ref& options, uint64_t host_id, uint64_t rs_id) {
   std::string uri;
 
   std::string mysql_server_uuid;
@@ -342,10 +678,7 @@ void MetadataStorage::insert_instance(const shcore::Value::Map_type_ref& options
   if (options->has_key("description"))
     description = (*options)["description"].as_string();
 
-  // Insert the default ReplicaSet on the replicasets table
-  query = shcore::sqlstring("INSERT INTO mysql_innodb_cluster_metadata.instances"
-                    " (host_id, replicaset_id, mysql_server_uuid, instance_name, role, addresses)"
-                    " VALUES (?, ?, ?, ?, ?, json_object('mysqlClassic', ?, 'mysqlX', ?, 'grLocal', ?))", 0);
+  query = shcore::sqlstring("(?, ?, ?, ?, ?, json_object('mysqlClassic', ?, 'mysqlX', ?, 'grLocal', ?))", 0);
   query << host_id;
   query << rs_id;
   query << mysql_server_uuid;
@@ -356,6 +689,114 @@ void MetadataStorage::insert_instance(const shcore::Value::Map_type_ref& options
   query << grendpoint;
   query.done();
 
+  return query;
+}
+
+static const char *kInsertInstances = "INSERT INTO mysql_innodb_cluster_metadata.instances"
+                    " (host_id, replicaset_id, mysql_server_uuid, instance_name, role, addresses)"
+                    " VALUES ";
+
+void MetadataStorage::insert_instance(const shcore::Value::Map_type_ref& options, uint64_t host_id, uint64_t rs_id) {
+  execute_sql(kInsertInstances + instance_values(options, host_id, rs_id));
+}
+
+// Returns "(?, ?, ...)" with count placeholders
+static std::string placeholders(size_t count) {
+  std::string ret_val = "(";
+  for (size_t index = 0; index < count; index++)
+    ret_val += index ? ", ?" : "?";
+  return ret_val + ")";
+}
+
+std::map<std::string, uint32_t> MetadataStorage::find_hosts(const std::vector<std::string> &host_names,
+                                                            const std::vector<std::string> &ip_addresses) {
+  std::map<std::string, uint32_t> host_ids;
+
+  std::string raw_query = "SELECT host_id, host_name, ip_address"
+                          " FROM mysql_innodb_cluster_metadata.hosts"
+                          " WHERE host_name IN " + placeholders(host_names.size()) +
+                          " OR (ip_address <> '' AND ip_address IN " + placeholders(ip_addresses.size()) + ")";
+  shcore::sqlstring query(raw_query.c_str(), 0);
+  for (auto &host_name : host_names)
+    query << host_name;
+  for (auto &ip_address : ip_addresses)
+    query << ip_address;
+  query.done();
+
+  auto result = execute_sql(query);
+  while (auto row = result->fetch_one()) {
+    uint32_t host_id = static_cast<uint32_t>(row->get_value(0).as_uint());
+    host_ids.insert({row->get_value_as_string(1), host_id});
+
+    std::string ip_address = row->get_value_as_string(2);
+    if (!ip_address.empty())
+      host_ids.insert({ip_address, host_id});
+  }
+
+  return host_ids;
+}
+
+void MetadataStorage::insert_instances(const std::vector<shcore::Value::Map_type_ref> &instances, uint64_t rs_id) {
+  if (instances.empty())
+    return;
+
+  std::vector<std::string> host_names;
+  std::vector<std::string> ip_addresses;
+  std::vector<std::string> locations;
+  for (auto &options : instances) {
+    host_names.push_back(options->has_key("host") ? (*options)["host"].as_string() : "");
+    ip_addresses.push_back(options->has_key("id_address") ? (*options)["id_address"].as_string() : "");
+    locations.push_back(options->has_key("location") ? (*options)["location"].as_string() : "");
+  }
+
+  // Registers the hosts not found on a single insert, a host is found either
+  // by its name or by its IP address, like insert_host() does
+  auto host_ids = find_hosts(host_names, ip_addresses);
+
+  std::set<std::string> new_hosts;
+  std::string raw_insert = "INSERT INTO mysql_innodb_cluster_metadata.hosts (host_name, ip_address, location) VALUES ";
+  std::vector<size_t> new_host_indexes;
+  for (size_t index = 0; index < instances.size(); index++) {
+    if (host_ids.count(host_names[index]) ||
+        (!ip_addresses[index].empty() && host_ids.count(ip_addresses[index])) ||
+        !new_hosts.insert(host_names[index]).second)
+      continue;
+
+    raw_insert += new_host_indexes.empty() ? "(?, ?, ?)" : ", (?, ?, ?)";
+    new_host_indexes.push_back(index);
+  }
+
+  if (!new_host_indexes.empty()) {
+    shcore::sqlstring insert_hosts(raw_insert.c_str(), 0);
+    for (auto index : new_host_indexes)
+      insert_hosts << host_names[index] << ip_addresses[index] << locations[index];
+    insert_hosts.done();
+
+    // execute and keep retrying if the server is super-readonly
+    // possibly because it's recovering
+    execute_sql(insert_hosts, true);
+
+    // The ids of a multi row insert are not consecutive with interleaved
+    // auto increment locking, so they are read back
+    host_ids = find_hosts(host_names, ip_addresses);
+  }
+
+  std::string query = kInsertInstances;
+  for (size_t index = 0; index < instances.size(); index++) {
+    auto host = host_ids.find(host_names[index]);
+    if (host == host_ids.end())
+      host = host_ids.find(ip_addresses[index]);
+    if (host == host_ids.end())
+      throw Exception::metadata_error("Unable to register host " + host_names[index]);
+
+    log_info("Using host entry %u in metadata for host %s (%s)",
+             host->second, host_names[index].c_str(), ip_addresses[index].c_str());
+
+    if (index)
+      query += ", ";
+    query += instance_values(instances[index], host->second, rs_id);
+  }
+
   execute_sql(query);
 }
 
@@ -363,7 +804,7 @@ void MetadataStorage::remove_instance(const std::string &instance_address) {
   shcore::sqlstring query;
 
   // Remove the instance
-  query = shcore::sqlstring("DELETE FROM mysql_innodb_cluster_metadata.instances WHERE addresses->\"$.mysqlClassic\" = ?", 0);
+  query = shcore::sqlstring("DELETE FROM mysql_innodb_cluster_metadata.instances WHERE JSON_UNQUOTE(addresses->'$.mysqlClassic') = ?", 0);
   query << instance_address;
   query.done();
 
@@ -567,18 +1008,24 @@ void MetadataStorage::set_replicaset_group_name(std::shared_ptr<ReplicaSet> repl
 }
 
 std::shared_ptr<ReplicaSet> MetadataStorage::get_replicaset(uint64_t rs_id) {
-  if (!metadata_schema_exists())
-    throw Exception::metadata_error("Metadata Schema does not exist.");
-
   shcore::sqlstring query("SELECT replicaset_name, topology_type"
                           " FROM mysql_innodb_cluster_metadata.replicasets"
                           " WHERE replicaset_id = ?", 0);
   query << rs_id;
-  auto result = execute_sql(query);
-  auto row = result->fetch_one();
-  if (row) {
-    std::string rs_name = row->get_value(0).as_string();
-    std::string topo = row->get_value(1).as_string();
+
+  std::shared_ptr<shcore::Value::Array_type> records;
+  try {
+    records = fetch_all_cached(query);
+  } catch (shcore::Exception &e) {
+    if (!metadata_schema_exists())
+      throw Exception::metadata_error("Metadata Schema does not exist.");
+    throw;
+  }
+
+  if (!records->empty()) {
+    auto row = records->front().as_object<mysqlsh::Row>();
+    std::string rs_name = row->get_member(0).as_string();
+    std::string topo = row->get_member(1).as_string();
 
     // Create a ReplicaSet Object to match the Metadata
     std::shared_ptr<ReplicaSet> rs(new ReplicaSet("name", topo, shared_from_this()));
@@ -594,20 +1041,19 @@ std::shared_ptr<Cluster> MetadataStorage::get_cluster_from_query(const std::stri
   std::shared_ptr<Cluster> cluster;
 
   try {
-    auto result = execute_sql(query);
-    auto row = result->fetch_one();
+    auto records = fetch_all_cached(query);
 
-    if (row) {
-      shcore::Argument_list args;
+    if (!records->empty()) {
+      auto row = records->front().as_object<mysqlsh::Row>();
 
-      cluster.reset(new Cluster(row->get_value(1).as_string(), shared_from_this()));
+      cluster.reset(new Cluster(row->get_member(1).as_string(), shared_from_this()));
 
-      cluster->set_id(row->get_value(0).as_int());
-      cluster->set_description(row->get_value(3).as_string());
-      cluster->set_options(row->get_value(4).as_string());
-      cluster->set_attributes(row->get_value(5).as_string());
+      cluster->set_id(row->get_member(0).as_int());
+      cluster->set_description(row->get_member(3).as_string());
+      cluster->set_options(row->get_member(4).as_string());
+      cluster->set_attributes(row->get_member(5).as_string());
 
-      auto rsetid_val = row->get_value(2);
+      auto rsetid_val = row->get_member(2);
       if (rsetid_val)
         cluster->set_default_replicaset(get_replicaset(rsetid_val.as_int()));
     }
@@ -698,7 +1144,7 @@ bool MetadataStorage::is_replicaset_empty(uint64_t rs_id) {
 bool MetadataStorage::is_instance_on_replicaset(uint64_t rs_id, const std::string &address) {
   shcore::sqlstring query;
 
-  query = shcore::sqlstring("SELECT COUNT(*) as count FROM mysql_innodb_cluster_metadata.instances WHERE replicaset_id = ? AND addresses->\"$.mysqlClassic\" = ?", 0);
+  query = shcore::sqlstring("SELECT COUNT(*) as count FROM mysql_innodb_cluster_metadata.instances WHERE replicaset_id = ? AND JSON_UNQUOTE(addresses->'$.mysqlClassic') = ?", 0);
   query << rs_id;
   query << address;
   query.done();
@@ -746,11 +1192,7 @@ std::shared_ptr<shcore::Value::Array_type> MetadataStorage::get_replicaset_insta
   query << rs_id;
   query.done();
 
-  auto result = execute_sql(query);
-  auto raw_instances = result->call("fetchAll", shcore::Argument_list());
-  auto instances = raw_instances.as_array();
-
-  return instances;
+  return fetch_all_cached(query);
 }
 
 std::shared_ptr<shcore::Value::Array_type> MetadataStorage::get_replicaset_online_instances(uint64_t rs_id) {
@@ -23,7 +23,10 @@
 #include "mod_dba.h"
 #include "mod_dba_cluster.h"
 #include "mod_dba_replicaset.h"
+#include <chrono>
+#include <map>
 #include <string>
+#include <vector>
 
 namespace mysqlsh {
 namespace mysql {
@@ -42,6 +45,8 @@ public:
 
   bool metadata_schema_exists();
   void create_metadata_schema();
+  // Brings a metadata schema created by an older version to the current one
+  void upgrade_metadata_schema();
   void drop_metadata_schema();
   uint64_t get_cluster_id(const std::string &cluster_name);
   uint64_t get_cluster_id(uint64_t rs_id);
@@ -50,6 +55,10 @@ public:
   void insert_replica_set(std::shared_ptr<ReplicaSet> replicaset, bool is_default, bool is_adopted);
   uint32_t insert_host(const shcore::Value::Map_type_ref &options);
   void insert_instance(const shcore::Value::Map_type_ref& options, uint64_t host_id, uint64_t rs_id);
+  // Registers the hosts and instances of several instance definitions with
+  // a fixed number of statements instead of one insert_host() and
+  // insert_instance() per instance
+  void insert_instances(const std::vector<shcore::Value::Map_type_ref> &instances, uint64_t rs_id);
   void remove_instance(const std::string &instance_address);
   void drop_cluster(const std::string &cluster_name);
   bool cluster_has_default_replicaset_only(const std::string &cluster_name);
@@ -78,6 +87,17 @@ public:
 
   std::shared_ptr<mysql::ClassicResult> execute_sql(const std::string &sql, bool retry = false, const std::string &log_sql = "") const;
 
+  // Returns the records of a query that only reads the metadata tables, they
+  // are kept in a snapshot and returned again while the metadata is unchanged
+  std::shared_ptr<shcore::Value::Array_type> fetch_all_cached(const std::string &query) const;
+
+  // Makes the next cached read verify the snapshot is still current
+  void check_snapshot() const { _snapshot_checked = false; }
+
+  // Runs a query that only reads, on a secondary when secondary reads are
+  // enabled, see Secondary_reads
+  std::shared_ptr<mysql::ClassicResult> execute_read_sql(const std::string &sql) const;
+
   class Transaction {
   public:
     explicit Transaction(std::shared_ptr<MetadataStorage> md) : _md(md) {
@@ -97,9 +117,62 @@ public:
   private:
     std::shared_ptr<MetadataStorage> _md;
   };
+
+  // While alive, the reads of the metadata may be served by the ONLINE
+  // secondary with the lowest latency, once it has applied every transaction
+  // the primary had executed when the metadata was last written
+  class Secondary_reads {
+  public:
+    explicit Secondary_reads(std::shared_ptr<MetadataStorage> md) : _md(md) {
+      md->_secondary_reads++;
+    }
+
+    ~Secondary_reads() {
+      _md->_secondary_reads--;
+    }
+  private:
+    std::shared_ptr<MetadataStorage> _md;
+  };
 private:
   Dba* _dba;
 
+  // The records by query, valid while the server, its group view ID and the
+  // last update time of the metadata tables match _snapshot_version
+  mutable std::map<std::string, std::shared_ptr<shcore::Value::Array_type> > _snapshot;
+  mutable std::string _snapshot_version;
+  mutable bool _snapshot_checked;
+  mutable std::chrono::steady_clock::time_point _snapshot_check_time;
+  bool _in_transaction;
+
+  int _secondary_reads;
+  // The secondary read from, for the session it was chosen for
+  mutable std::shared_ptr<ShellDevelopmentSession> _secondary;
+  mutable std::weak_ptr<ShellDevelopmentSession> _secondary_primary;
+  mutable std::chrono::steady_clock::time_point _secondary_retry_time;
+  // The GTID set the secondary must have applied, fetched from the primary
+  // again after the metadata is written
+  mutable std::string _primary_gtid_set;
+  mutable bool _primary_gtid_set_stale;
+  mutable bool _secondary_synced;
+
+  // The host ids by host name and by IP address
+  std::map<std::string, uint32_t> find_hosts(const std::vector<std::string> &host_names,
+                                             const std::vector<std::string> &ip_addresses);
+
+  std::shared_ptr<mysql::ClassicResult> execute_sql(const std::shared_ptr<ShellDevelopmentSession> &session,
+                                                    const std::string &sql, bool retry, const std::string &log_sql) const;
+  std::shared_ptr<shcore::Value::Array_type> fetch_all_cached(const std::shared_ptr<ShellDevelopmentSession> &session,
+                                                              const std::string &query) const;
+
+  // The session for the reads: the secondary when it can be used, otherwise
+  // the active session
+  std::shared_ptr<ShellDevelopmentSession> read_session() const;
+  std::shared_ptr<ShellDevelopmentSession> connect_secondary(const std::shared_ptr<ShellDevelopmentSession> &primary) const;
+  void drop_secondary() const;
+
+  bool snapshot_is_current(const std::shared_ptr<ShellDevelopmentSession> &session) const;
+  void clear_snapshot() const;
+
   void start_transaction();
   void commit();
   void rollback();
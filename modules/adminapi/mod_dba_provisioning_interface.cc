@@ -26,6 +26,8 @@
 #include "utils/utils_general.h"
 #include "common/process_launcher/process_launcher.h"
 #include "utils/utils_file.h"
+#include "utils/utils_cancel.h"
+#include "utils/utils_trace.h"
 
 static const char *kRequiredMySQLProvisionInterfaceVersion = "2.0";
 
@@ -34,99 +36,70 @@ using namespace mysqlsh::dba;
 using namespace shcore;
 
 ProvisioningInterface::ProvisioningInterface(shcore::Interpreter_delegate* deleg) :
-_verbose(0), _delegate(deleg) {}
+_verbose(0), _delegate(deleg), _worker_unavailable(false) {}
 
-ProvisioningInterface::~ProvisioningInterface() {}
-
-int ProvisioningInterface::execute_mysqlprovision(const std::string &cmd, const std::vector<const char *> &args,
-                                     const std::vector<std::string> &passwords,
-                                     shcore::Value::Array_type_ref &errors, int verbose) {
-  std::vector<const char *> args_script;
-  std::string buf;
-  char c;
-  int exit_code = 0;
-  std::string full_output;
-
-  // set _local_mysqlprovision_path if empty
-  if (_local_mysqlprovision_path.empty()) {
-    // 1st try from global options (programmatically set by main program)
-    // 2nd check if the binary is in the same dir as ourselves
-    // 3rd set it to mysqlprovision and hope that it will be in $PATH
-
-    if ((*shcore::Shell_core_options::get()).has_key(SHCORE_GADGETS_PATH))
-      _local_mysqlprovision_path = (*shcore::Shell_core_options::get())[SHCORE_GADGETS_PATH].as_string();
-
-    if (_local_mysqlprovision_path.empty()) {
-      std::string tmp(get_binary_folder());
-#ifdef _WIN32
-      tmp.append("\\mysqlprovision.cmd");
-#else
-      tmp.append("/mysqlprovision");
-#endif
-      if (file_exists(tmp))
-        _local_mysqlprovision_path = tmp;
+ProvisioningInterface::~ProvisioningInterface() {
+  // An empty request ends the worker
+  if (_worker) {
+    try {
+      _worker->write("\n", 1);
+      _worker->wait();
+    } catch (const std::system_error &e) {
+      log_warning("DBA: %s while ending the mysqlprovision worker", e.what());
     }
-
-    // If is not set, we have to assume that it's located on the PATH
-    if (_local_mysqlprovision_path.empty())
-      _local_mysqlprovision_path = "mysqlprovision";
   }
+}
 
-  args_script.push_back(_local_mysqlprovision_path.c_str());
-  args_script.push_back(cmd.c_str());
-
-  args_script.insert(args_script.end(), args.begin(), args.end());
-  // API version check for mysqlprovision
-  args_script.push_back("--log-format=json");
-  args_script.push_back("-xV");
-
-  args_script.push_back(kRequiredMySQLProvisionInterfaceVersion);
-
-  if (verbose > 1)
-    args_script.push_back("--verbose");
-
-  args_script.push_back(NULL);
-
-  std::string cmdline;
-  for (auto s : args_script) {
-    if (s)
-      cmdline.append(s).append(" ");
-  }
-  std::string message = "DBA: mysqlprovision: Executing " + cmdline;
-  log_info("%s", message.c_str());
+/*
+ * Reads a line of the output of the process as read_line() does. Within an
+ * operation that can be cancelled the output is polled, the process is
+ * killed if the operation is cancelled or the step deadline passes.
+ */
+static bool next_line(ngcommon::Process_launcher *process, std::string *line,
+                      shcore::Cancellation_token::Clock::time_point deadline) {
+  auto token = shcore::Cancellation_token::current();
+  if (!token)
+    return process->read_line(line);
+
+  bool closed = false;
+  while (!process->try_read_line(line, &closed)) {
+    if (closed)
+      return false;
+
+    if (token->cancelled() || shcore::Cancellation_token::Clock::now() >= deadline) {
+      process->kill();
+      process->wait();
+      token->check("running mysqlprovision", deadline);
+    }
 
-  if (verbose > 1) {
-    message += "\n";
-    _delegate->print(_delegate->user_data, message.c_str());
+    ngcommon::Process_launcher::wait_for_output({process}, 100);
   }
 
-  if (verbose) {
-    std::string title = " MySQL Provision Output ";
-    std::string half_header((78 - title.size()) / 2, '=');
-    std::string header = half_header + title + half_header + "\n";
-    _delegate->print(_delegate->user_data, header.c_str());
-  }
+  return true;
+}
 
+/*
+ * Reads the JSON formatted output of a mysqlprovision command, printing it
+ * if verbose. Returns true if a frame of the worker protocol ended the
+ * output, for an EXIT frame exit_code gets the exit code of the command.
+ * Returns false once the process closed its output.
+ */
+bool ProvisioningInterface::read_output(ngcommon::Process_launcher *process,
+                                        shcore::Value::Array_type_ref &errors, int verbose,
+                                        std::string *full_output, int *exit_code) {
+  std::string buf;
+  std::string line;
   std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-  std::string stage_action;
-
-  ngcommon::Process_launcher p(args_script[0], &args_script[0]);
-  try {
-    stage_action = "starting";
-    p.start();
-
-    if (!passwords.empty()) {
-      stage_action = "executing";
-      for (size_t i = 0; i < passwords.size(); i++) {
-        p.write(passwords[i].c_str(), passwords[i].length());
-      }
-    }
 
-    stage_action = "reading from";
+  auto token = shcore::Cancellation_token::current();
+  auto deadline = token ? token->step_deadline() : shcore::Cancellation_token::Clock::time_point::max();
 
-    bool last_closed = false;
-    bool json_started = false;
-    while (p.read(&c, 1) > 0) {
+  bool last_closed = false;
+  bool json_started = false;
+  // Read by lines, what follows the last frame stays in the launcher for
+  // the next command
+  while (next_line(process, &line, deadline)) {
+    for (char c : line) {
       // Ignores the initial output (most likely prompts)
       // Until the first { is found, indicating the start of JSON data
       if (!json_started) {
@@ -172,6 +145,12 @@ int ProvisioningInterface::execute_mysqlprovision(const std::string &cmd, const
             std::string type = data->get_string("type");
             std::string info;
 
+            if (type == "EXIT" || type == "READY") {
+              if (type == "EXIT")
+                *exit_code = static_cast<int>(data->get_int("exit_code"));
+              return true;
+            }
+
             if (type == "WARNING" || type == "ERROR") {
               if (!errors)
                 errors.reset(new shcore::Value::Array_type());
@@ -194,7 +173,7 @@ int ProvisioningInterface::execute_mysqlprovision(const std::string &cmd, const
 
           log_debug("DBA: mysqlprovision: %s", buf.c_str());
 
-          full_output.append(buf);
+          full_output->append(buf);
           buf = "";
         } else
           buf += c;
@@ -206,21 +185,212 @@ int ProvisioningInterface::execute_mysqlprovision(const std::string &cmd, const
         last_closed = c == '}';
       }
     }
+  }
+
+  if (!buf.empty()) {
+    if (verbose)
+      _delegate->print(_delegate->user_data, buf.c_str());
 
-    if (!buf.empty()) {
-      if (verbose)
-        _delegate->print(_delegate->user_data, buf.c_str());
+    log_debug("DBA: mysqlprovision: %s", buf.c_str());
 
-      log_debug("DBA: mysqlprovision: %s", buf.c_str());
+    full_output->append(buf);
+  }
 
-      full_output.append(buf);
+  return false;
+}
+
+void ProvisioningInterface::start_worker() {
+#ifdef _WIN32
+  // mysqlprovision needs fork to run as a worker
+  _worker_unavailable = true;
+#else
+  _worker_args = {_local_mysqlprovision_path.c_str(), "--worker", NULL};
+  _worker.reset(new ngcommon::Process_launcher(_worker_args[0], &_worker_args[0]));
+
+  bool started = false;
+  std::string output;
+  try {
+    _worker->start();
+    started = true;
+
+    shcore::Value::Array_type_ref errors;
+    int exit_code = 0;
+    if (read_output(_worker.get(), errors, 0, &output, &exit_code)) {
+      log_info("DBA: mysqlprovision: Started worker");
+      return;
     }
-    stage_action = "terminating";
   } catch (const std::system_error &e) {
-    log_warning("DBA: %s while %s mysqlprovision", e.what(), stage_action.c_str());
+    log_warning("DBA: %s while starting the mysqlprovision worker", e.what());
+  } catch (const shcore::Exception &) {
+    // Cancelled, the worker was killed
+    _worker.reset();
+    throw;
+  }
+
+  // i.e. a mysqlprovision from a version without the worker
+  log_info("DBA: mysqlprovision can not run as a worker, running a process per command: %s",
+           output.c_str());
+  if (started)
+    _worker->wait();
+  _worker.reset();
+  _worker_unavailable = true;
+#endif
+}
+
+/*
+ * Runs a command on the worker, args being the same command line a new
+ * mysqlprovision process would get. Returns false if the worker is not
+ * available, nothing was run then.
+ */
+bool ProvisioningInterface::execute_on_worker(const std::vector<const char *> &args,
+                                              const std::vector<std::string> &passwords,
+                                              shcore::Value::Array_type_ref &errors, int verbose,
+                                              std::string *full_output, int *exit_code) {
+  if (!_worker && !_worker_unavailable)
+    start_worker();
+
+  if (!_worker)
+    return false;
+
+  // The program name is not part of the request
+  shcore::Value::Array_type_ref request_args(new shcore::Value::Array_type());
+  for (size_t index = 1; args[index]; index++)
+    request_args->push_back(shcore::Value(args[index]));
+
+  std::string input;
+  for (auto &password : passwords)
+    input += password;
+
+  shcore::Value::Map_type_ref request(new shcore::Value::Map_type());
+  (*request)["args"] = shcore::Value(request_args);
+  (*request)["stdin"] = shcore::Value(input);
+  std::string line = shcore::Value(request).json(false) + "\n";
+
+  try {
+    _worker->write(line.c_str(), line.length());
+  } catch (const std::system_error &e) {
+    // A new worker is started by the next command
+    log_warning("DBA: %s while writing to the mysqlprovision worker", e.what());
+    _worker->wait();
+    _worker.reset();
+    return false;
+  }
+
+  bool finished = false;
+  try {
+    finished = read_output(_worker.get(), errors, verbose, full_output, exit_code);
+  } catch (const std::system_error &e) {
+    log_warning("DBA: %s while reading from the mysqlprovision worker", e.what());
+  } catch (const shcore::Exception &) {
+    // Cancelled, the worker was killed and a new one is started by the
+    // next command
+    _worker.reset();
+    throw;
+  }
+
+  // The worker ended while running the command
+  if (!finished) {
+    *exit_code = _worker->wait();
+    _worker.reset();
+  }
+
+  return true;
+}
+
+int ProvisioningInterface::execute_mysqlprovision(const std::string &cmd, const std::vector<const char *> &args,
+                                     const std::vector<std::string> &passwords,
+                                     shcore::Value::Array_type_ref &errors, int verbose) {
+  std::vector<const char *> args_script;
+  int exit_code = 0;
+  std::string full_output;
+
+  // set _local_mysqlprovision_path if empty
+  if (_local_mysqlprovision_path.empty()) {
+    // 1st try from global options (programmatically set by main program)
+    // 2nd check if the binary is in the same dir as ourselves
+    // 3rd set it to mysqlprovision and hope that it will be in $PATH
+
+    if ((*shcore::Shell_core_options::get()).has_key(SHCORE_GADGETS_PATH))
+      _local_mysqlprovision_path = (*shcore::Shell_core_options::get())[SHCORE_GADGETS_PATH].as_string();
+
+    if (_local_mysqlprovision_path.empty()) {
+      std::string tmp(get_binary_folder());
+#ifdef _WIN32
+      tmp.append("\\mysqlprovision.cmd");
+#else
+      tmp.append("/mysqlprovision");
+#endif
+      if (file_exists(tmp))
+        _local_mysqlprovision_path = tmp;
+    }
+
+    // If is not set, we have to assume that it's located on the PATH
+    if (_local_mysqlprovision_path.empty())
+      _local_mysqlprovision_path = "mysqlprovision";
+  }
+
+  args_script.push_back(_local_mysqlprovision_path.c_str());
+  args_script.push_back(cmd.c_str());
+
+  args_script.insert(args_script.end(), args.begin(), args.end());
+  // API version check for mysqlprovision
+  args_script.push_back("--log-format=json");
+  args_script.push_back("-xV");
+
+  args_script.push_back(kRequiredMySQLProvisionInterfaceVersion);
+
+  if (verbose > 1)
+    args_script.push_back("--verbose");
+
+  args_script.push_back(NULL);
+
+  std::string cmdline;
+  for (auto s : args_script) {
+    if (s)
+      cmdline.append(s).append(" ");
+  }
+  std::string message = "DBA: mysqlprovision: Executing " + cmdline;
+  log_info("%s", message.c_str());
+
+  shcore::Trace_span span("mysqlprovision " + cmd);
+  span.set("command", cmdline);
+
+  if (verbose > 1) {
+    message += "\n";
+    _delegate->print(_delegate->user_data, message.c_str());
+  }
+
+  if (verbose) {
+    std::string title = " MySQL Provision Output ";
+    std::string half_header((78 - title.size()) / 2, '=');
+    std::string header = half_header + title + half_header + "\n";
+    _delegate->print(_delegate->user_data, header.c_str());
   }
 
-  exit_code = p.wait();
+  if (!execute_on_worker(args_script, passwords, errors, verbose, &full_output, &exit_code)) {
+    std::string stage_action;
+
+    ngcommon::Process_launcher p(args_script[0], &args_script[0]);
+    try {
+      stage_action = "starting";
+      p.start();
+
+      if (!passwords.empty()) {
+        stage_action = "executing";
+        for (size_t i = 0; i < passwords.size(); i++) {
+          p.write(passwords[i].c_str(), passwords[i].length());
+        }
+      }
+
+      stage_action = "reading from";
+      read_output(&p, errors, verbose, &full_output, &exit_code);
+      stage_action = "terminating";
+    } catch (const std::system_error &e) {
+      log_warning("DBA: %s while %s mysqlprovision", e.what(), stage_action.c_str());
+    }
+
+    exit_code = p.wait();
+  }
 
   if (verbose) {
     std::string footer(78, '=');
@@ -388,7 +558,8 @@ int ProvisioningInterface::exec_sandbox_op(const std::string &op, int port, int
 int ProvisioningInterface::create_sandbox(int port, int portx, const std::string &sandbox_dir,
                                           const std::string &password,
                                           const shcore::Value &mycnf_options,
-                                          bool ignore_ssl_error,
+                                          bool ignore_ssl_error, bool use_template,
+                                          const std::string &profile,
                                           shcore::Value::Array_type_ref &errors) {
   std::vector<std::string> extra_args;
   if (mycnf_options) {
@@ -400,6 +571,12 @@ int ProvisioningInterface::create_sandbox(int port, int portx, const std::string
   if (ignore_ssl_error)
     extra_args.push_back("--ignore-ssl-error");
 
+  if (use_template)
+    extra_args.push_back("--use-template");
+
+  if (!profile.empty())
+    extra_args.push_back("--profile=" + profile);
+
   return exec_sandbox_op("create", port, portx, sandbox_dir, password,
                          extra_args, errors);
 }
@@ -20,6 +20,7 @@
 #ifndef MODULES_ADMINAPI_MOD_DBA_PROVISIONING_INTERFACE_H_
 #define MODULES_ADMINAPI_MOD_DBA_PROVISIONING_INTERFACE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,10 @@
 #include "shellcore/shell_core_options.h"
 #include "shellcore/lang_base.h"
 
+namespace ngcommon {
+class Process_launcher;
+}
+
 namespace mysqlsh {
 namespace dba {
 #if DOXYGEN_CPP
@@ -47,7 +52,8 @@ public:
   int create_sandbox(int port, int portx, const std::string &sandbox_dir,
                      const std::string &password,
                      const shcore::Value &mycnf_options,
-                     bool ignore_ssl_error,
+                     bool ignore_ssl_error, bool use_template,
+                     const std::string &profile,
                      shcore::Value::Array_type_ref &errors);
   int delete_sandbox(int port, const std::string &sandbox_dir,
                      shcore::Value::Array_type_ref &errors);
@@ -89,6 +95,21 @@ private:
   shcore::Interpreter_delegate *_delegate;
   std::string _local_mysqlprovision_path;
 
+  // A mysqlprovision process running the commands of the whole session, it
+  // is started by the first command
+  std::unique_ptr<ngcommon::Process_launcher> _worker;
+  std::vector<const char *> _worker_args;
+  bool _worker_unavailable;
+
+  void start_worker();
+  bool execute_on_worker(const std::vector<const char *> &args,
+                         const std::vector<std::string> &passwords,
+                         shcore::Value::Array_type_ref &errors, int verbose,
+                         std::string *full_output, int *exit_code);
+  bool read_output(ngcommon::Process_launcher *process,
+                   shcore::Value::Array_type_ref &errors, int verbose,
+                   std::string *full_output, int *exit_code);
+
   int execute_mysqlprovision(const std::string &cmd, const std::vector<const char *> &args,
                 const std::vector<std::string> &passwords,
                 shcore::Value::Array_type_ref &errors, int verbose);
@@ -24,11 +24,15 @@
 //#include "modules/adminapi/mod_dba_instance.h"
 #include "modules/adminapi/mod_dba_common.h"
 #include "modules/adminapi/mod_dba_sql.h"
+#include "modules/adminapi/mod_dba_gtid_set.h"
 
 #include "modules/mod_mysql_session.h"
 #include "modules/base_session.h"
+#include "modules/member_latency.h"
+#include "modules/session_pool.h"
 
 #include "common/uuid/include/uuid_gen.h"
+#include "utils/utils_file.h"
 #include "utils/utils_general.h"
 #include "modules/mysqlxtest_utils.h"
 #include "xerrmsg.h"
@@ -40,12 +44,19 @@
 #include "logger/logger.h"
 #include "utils/utils_sqlstring.h"
 
+#include <atomic>
+#include <fstream>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <vector>
+#include <set>
 #include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #ifdef _WIN32
 #define strerror_r(errno,buf,len) strerror_s(buf,len,errno)
 #else
@@ -64,13 +75,21 @@ using namespace shcore;
 
 #define PASSWORD_LENGTH 16
 
-std::set<std::string> ReplicaSet::_add_instance_opts = {"label", "password", "dbPassword", "memberSslMode", "ipWhitelist"};
+std::set<std::string> ReplicaSet::_add_instance_opts = {"label", "password", "dbPassword", "memberSslMode", "ipWhitelist", "waitRecovery"};
+std::set<std::string> ReplicaSet::_add_instances_opts = {"password", "dbPassword", "memberSslMode", "ipWhitelist", "parallel"};
 
 char const *ReplicaSet::kTopologyPrimaryMaster = "pm";
 char const *ReplicaSet::kTopologyMultiMaster = "mm";
 
 static const std::string kSandboxDatadir = "sandboxdata";
 
+// Seconds between the samples of the recovery progress
+static const int kRecoverySampleSeconds = 2;
+
+// Time the members that were never timed are given to answer before the
+// peer of a joining instance is chosen
+static const std::chrono::milliseconds kPeerProbeWait(1000);
+
 ReplicaSet::ReplicaSet(const std::string &name, const std::string &topology_type,
                        std::shared_ptr<MetadataStorage> metadata_storage) :
   _name(name), _topology_type(topology_type), _metadata_storage(metadata_storage) {
@@ -176,7 +195,8 @@ void ReplicaSet::verify_topology_type_change() const {
 void ReplicaSet::adopt_from_gr() {
   shcore::Value ret_val;
 
-  auto newly_discovered_instances_list(get_newly_discovered_instances());
+  auto newly_discovered_instances_list(get_newly_discovered_instances(get_topology()));
+  std::vector<shcore::Value::Map_type_ref> instances;
 
   // Add all instances to the cluster metadata
   for (ReplicaSet::NewInstanceInfo &instance : newly_discovered_instances_list) {
@@ -194,8 +214,14 @@ void ReplicaSet::adopt_from_gr() {
     (*newly_discovered_instance)["user"] = shcore::Value(session->get_user());
     (*newly_discovered_instance)["password"] = shcore::Value(session->get_password());
 
-    add_instance_metadata(newly_discovered_instance);
+    load_instance_metadata(newly_discovered_instance, "");
+    instances.push_back(newly_discovered_instance);
   }
+
+  // Registered together, with the same few statements for any number of them
+  MetadataStorage::Transaction tx(_metadata_storage);
+  _metadata_storage->insert_instances(instances, get_id());
+  tx.commit();
 }
 
 /**
@@ -319,57 +345,51 @@ std::string ReplicaSet::resolve_ssl_mode(mysqlsh::mysql::ClassicSession *session
     get_server_variable(peer_session->connection(),
                         "global.group_replication_ssl_mode",
                         gr_ssl_mode);
-    if (gr_ssl_mode.compare("REQUIRED") == 0) {
-      std::string have_ssl;
-      get_server_variable(session->connection(), "global.have_ssl",
-                          have_ssl);
-      if (have_ssl.compare("YES") != 0) {
-        // Instance is not able to enable SSL (not supported).
-        throw shcore::Exception::runtime_error(
-            "Instance does not support SSL and cannot join a cluster with SSL "
-                "(encryption) enabled. Enable SSL support on the instance and "
-                "try again, otherwise it can only be added to a cluster with "
-                "SSL disabled."
-        );
-      }
-      return dba::kMemberSSLModeRequired;
-    } else if (gr_ssl_mode.compare("DISABLED") == 0) {
-      return dba::kMemberSSLModeDisabled;
-    } else {
-      // Only GR SSL mode "REQUIRED" and "DISABLED" are currently supported.
+    return resolve_joiner_ssl_mode(session, gr_ssl_mode);
+  }
+}
+
+/**
+ * Determines the SSL mode of an instance joining a cluster that uses the
+ * given group_replication_ssl_mode.
+ */
+std::string ReplicaSet::resolve_joiner_ssl_mode(mysqlsh::mysql::ClassicSession *session,
+                                                const std::string &gr_ssl_mode) {
+  if (gr_ssl_mode.compare("REQUIRED") == 0) {
+    std::string have_ssl;
+    get_server_variable(session->connection(), "global.have_ssl",
+                        have_ssl);
+    if (have_ssl.compare("YES") != 0) {
+      // Instance is not able to enable SSL (not supported).
       throw shcore::Exception::runtime_error(
-          "Unsupported Group Replication SSL Mode for the cluster: "
-              + gr_ssl_mode + ". If the cluster was created using "
-              "adoptFromGR:true make sure the group_replication_ssl_mode "
-              "variable is set with a supported value (DISABLED or REQUIRED) "
-              "for all cluster members.");
+          "Instance does not support SSL and cannot join a cluster with SSL "
+              "(encryption) enabled. Enable SSL support on the instance and "
+              "try again, otherwise it can only be added to a cluster with "
+              "SSL disabled."
+      );
     }
+    return dba::kMemberSSLModeRequired;
+  } else if (gr_ssl_mode.compare("DISABLED") == 0) {
+    return dba::kMemberSSLModeDisabled;
+  } else {
+    // Only GR SSL mode "REQUIRED" and "DISABLED" are currently supported.
+    throw shcore::Exception::runtime_error(
+        "Unsupported Group Replication SSL Mode for the cluster: "
+            + gr_ssl_mode + ". If the cluster was created using "
+            "adoptFromGR:true make sure the group_replication_ssl_mode "
+            "variable is set with a supported value (DISABLED or REQUIRED) "
+            "for all cluster members.");
   }
 }
 
-shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
-                                       const std::string &existing_replication_user,
-                                       const std::string &existing_replication_password,
-                                       bool overwrite_seed) {
-  shcore::Value ret_val;
-
-  bool seed_instance = false;
-  std::string ssl_mode = dba::kMemberSSLModeAuto; //SSL Mode AUTO by default
-  std::string ip_whitelist;
-  std::string instance_label;
-
-  // NOTE: This function is called from either the add_instance_ on this class
-  //       or the add_instance in Cluster class, hence this just throws exceptions
-  //       and the proper handling is done on the caller functions (to append the called function name)
-
-  // Check if we're on a addSeedInstance or not
-  if (_metadata_storage->is_replicaset_empty(_id)) seed_instance = true;
-
-  // Check if we need to overwrite the seed instance
-  if (overwrite_seed) seed_instance = true;
+ReplicaSet::Joiner ReplicaSet::prepare_joiner(const shcore::Argument_list &args) {
+  Joiner joiner;
+  joiner.ssl_mode = dba::kMemberSSLModeAuto; //SSL Mode AUTO by default
+  joiner.wait_recovery = false;
 
   // Retrieves the instance definition
-  auto instance_def = get_instance_options_map(args, mysqlsh::dba::PasswordFormat::OPTIONS);
+  joiner.instance_def = get_instance_options_map(args, mysqlsh::dba::PasswordFormat::OPTIONS);
+  auto instance_def = joiner.instance_def;
   shcore::Argument_map instance_map(*instance_def);
   instance_map.ensure_keys({"host"}, _instance_options, "instance definition");
 
@@ -386,14 +406,18 @@ shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
     validate_ip_whitelist_option(add_options);
 
     if (add_options->has_key("memberSslMode"))
-      ssl_mode = add_options->get_string("memberSslMode");
+      joiner.ssl_mode = add_options->get_string("memberSslMode");
 
     if (add_options->has_key("ipWhitelist"))
-      ip_whitelist = add_options->get_string("ipWhitelist");
+      joiner.ip_whitelist = add_options->get_string("ipWhitelist");
 
     if (add_options->has_key("label"))
-      instance_label = add_options->get_string("label");
+      joiner.label = add_options->get_string("label");
+
+    if (add_options->has_key("waitRecovery"))
+      joiner.wait_recovery = add_instance_map.bool_at("waitRecovery");
   }
+  boost::to_upper(joiner.ssl_mode);
 
 
   if (!instance_def->has_key("port"))
@@ -401,53 +425,298 @@ shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
 
   // Sets a default user if not specified
   resolve_instance_credentials(instance_def, nullptr);
-  std::string
-      user = instance_def->get_string(instance_def->has_key("user") ? "user" : "dbUser");
-  std::string super_user_password =
+  joiner.user = instance_def->get_string(instance_def->has_key("user") ? "user" : "dbUser");
+  joiner.password =
       instance_def->get_string(instance_def->has_key("password") ? "password"
                                                        : "dbPassword");
-  std::string joiner_host = instance_def->get_string("host");
 
-  std::string instance_address = joiner_host + ":" + std::to_string(instance_def->get_int("port"));
-  bool is_instance_on_md = _metadata_storage->is_instance_on_replicaset(get_id(), instance_address);
+  joiner.address = instance_def->get_string("host") + ":" + std::to_string(instance_def->get_int("port"));
+  joiner.is_instance_on_md = _metadata_storage->is_instance_on_replicaset(get_id(), joiner.address);
+
+  return joiner;
+}
+
+std::string ReplicaSet::get_peer_gr_ssl_mode() {
+  auto peer_session = dynamic_cast<mysqlsh::mysql::ClassicSession*>(
+      _metadata_storage->get_dba()->get_active_session().get());
+  std::string gr_ssl_mode;
+  get_server_variable(peer_session->connection(),
+                      "global.group_replication_ssl_mode",
+                      gr_ssl_mode);
+  return gr_ssl_mode;
+}
+
+void ReplicaSet::check_joiner(Joiner *joiner, bool seed_instance, const std::string &peer_gr_ssl_mode) {
   shcore::Argument_list new_args;
-  new_args.push_back(shcore::Value(instance_def));
+  new_args.push_back(shcore::Value(joiner->instance_def));
   auto session = Dba::get_session(new_args);
 
   // Check whether the address being used is not in a known not-good case
-  validate_instance_address(session, joiner_host, instance_def->get_int("port"));
+  validate_instance_address(session, joiner->instance_def->get_string("host"), joiner->instance_def->get_int("port"));
 
   // Check replication filters before creating the Metadata.
   validate_replication_filters(session.get());
 
   // Resolve the SSL Mode to use to configure the instance.
-  boost::to_upper(ssl_mode);
-  if (ssl_mode.compare(dba::kMemberSSLModeAuto) == 0) {
-    if (seed_instance) {
-      ssl_mode = resolve_ssl_mode(session.get(), nullptr);
-    } else {
-      auto peer_session = dynamic_cast<mysqlsh::mysql::ClassicSession*>(
-          _metadata_storage->get_dba()->get_active_session().get());
-      ssl_mode = resolve_ssl_mode(session.get(), peer_session);
+  if (joiner->ssl_mode.compare(dba::kMemberSSLModeAuto) == 0) {
+    if (seed_instance)
+      joiner->ssl_mode = resolve_ssl_mode(session.get(), nullptr);
+    else
+      joiner->ssl_mode = resolve_joiner_ssl_mode(session.get(), peer_gr_ssl_mode);
+    log_debug("SSL mode used to configure instance: '%s'", joiner->ssl_mode.c_str());
+  }
+
+  joiner->type = get_gr_instance_type(session->connection());
+
+  // Rethieves the new instance UUID
+  if (joiner->type != GRInstanceType::Standalone)
+    get_server_variable(session->connection(), "server_uuid", joiner->uuid);
+
+  Session_pool::get()->release(session);
+}
+
+shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
+                                       const std::string &existing_replication_user,
+                                       const std::string &existing_replication_password,
+                                       bool overwrite_seed) {
+  shcore::Value ret_val;
+
+  bool seed_instance = false;
+
+  // NOTE: This function is called from either the add_instance_ on this class
+  //       or the add_instance in Cluster class, hence this just throws exceptions
+  //       and the proper handling is done on the caller functions (to append the called function name)
+
+  // Check if we're on a addSeedInstance or not
+  if (_metadata_storage->is_replicaset_empty(_id)) seed_instance = true;
+
+  // Check if we need to overwrite the seed instance
+  if (overwrite_seed) seed_instance = true;
+
+  Joiner joiner = prepare_joiner(args);
+
+  std::string peer_gr_ssl_mode;
+  if (!seed_instance && joiner.ssl_mode.compare(dba::kMemberSSLModeAuto) == 0)
+    peer_gr_ssl_mode = get_peer_gr_ssl_mode();
+
+  check_joiner(&joiner, seed_instance, peer_gr_ssl_mode);
+
+  join_instance(joiner, seed_instance, existing_replication_user, existing_replication_password);
+
+  // The seed has nothing to recover
+  if (joiner.wait_recovery && !seed_instance)
+    ret_val = shcore::Value(wait_recovery(joiner));
+
+  return ret_val;
+}
+
+shcore::Value::Map_type_ref ReplicaSet::wait_recovery(const Joiner &joiner) {
+  auto shell = _metadata_storage->get_dba()->get_owner();
+
+  // The transactions to recover are the ones executed by the group when the
+  // instance joined
+  auto peer_session = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(
+      _metadata_storage->get_dba()->get_active_session());
+  std::string group_executed;
+  get_server_variable(peer_session->connection(), "GLOBAL.GTID_EXECUTED", group_executed);
+  Gtid_set target(group_executed);
+
+  shcore::Argument_list session_args;
+  session_args.push_back(shcore::Value(joiner.instance_def));
+  auto session = Session_pool::get()->acquire(session_args);
+
+  std::string query("SELECT MEMBER_STATE, @@GLOBAL.GTID_EXECUTED, "
+                    "(SELECT RECEIVED_TRANSACTION_SET FROM performance_schema.replication_connection_status "
+                    "WHERE CHANNEL_NAME = 'group_replication_recovery') "
+                    "FROM performance_schema.replication_group_members WHERE MEMBER_ID = @@server_uuid");
+
+  auto started = std::chrono::steady_clock::now();
+  uint64_t initial = 0, applied = 0, received = 0, remaining = 0;
+  double rate = 0;
+  std::string state;
+  bool first = true;
+
+  try {
+    while (true) {
+      auto sample = std::chrono::steady_clock::now();
+      auto result = session->connection()->run_sql(query);
+      auto row = result->fetch_one();
+
+      state = row ? row->get_value_as_string(0) : "OFFLINE";
+      if (row) {
+        Gtid_set executed(row->get_value_as_string(1));
+        shcore::Value received_set = row->get_value(2);
+
+        applied = executed.count();
+        if (received_set && received_set.type == shcore::String)
+          received = Gtid_set(received_set.as_string()).count();
+        remaining = Gtid_set(target).subtract(executed).count();
+      }
+
+      if (first) {
+        initial = applied;
+        first = false;
+      }
+
+      double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(sample - started).count() / 1000.0;
+      rate = seconds > 0 ? (applied - initial) / seconds : 0;
+
+      if (state == "ONLINE")
+        break;
+
+      if (state != "RECOVERING")
+        throw shcore::Exception::runtime_error("The instance '" + joiner.address + "' is " + state +
+                                               " instead of recovering, please check its error log");
+
+      std::string progress = "Recovering '" + joiner.address + "': " + std::to_string(remaining) +
+                             " transactions left, " + std::to_string(received) + " received, ";
+      char measures[64];
+      if (rate > 0)
+        snprintf(measures, sizeof(measures), "%.1f trx/s, ETA %.0fs\n", rate, remaining / rate);
+      else
+        snprintf(measures, sizeof(measures), "waiting for the donor\n");
+      shell->print(progress + measures);
+
+      std::this_thread::sleep_until(sample + std::chrono::seconds(kRecoverySampleSeconds));
+    }
+  } catch (...) {
+    Session_pool::get()->release(session);
+    throw;
+  }
+
+  Session_pool::get()->release(session);
+
+  double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count() / 1000.0;
+  shell->print("The instance '" + joiner.address + "' is ONLINE, recovery took " +
+               std::to_string(static_cast<int64_t>(seconds)) + "s\n");
+
+  shcore::Value::Map_type_ref metrics(new shcore::Value::Map_type());
+  (*metrics)["instance"] = shcore::Value(joiner.address);
+  (*metrics)["state"] = shcore::Value(state);
+  (*metrics)["seconds"] = shcore::Value(seconds);
+  (*metrics)["transactions"] = shcore::Value(static_cast<int64_t>(applied - initial));
+  (*metrics)["transactionsPerSecond"] = shcore::Value(seconds > 0 ? (applied - initial) / seconds : 0.0);
+
+  return metrics;
+}
+
+shcore::Value ReplicaSet::add_instances(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  // NOTE: This function is called from the add_instances in Cluster class,
+  //       hence this just throws exceptions
+
+  auto instances = args.array_at(0);
+
+  // The options other than parallel apply to every instance
+  shcore::Value::Map_type_ref add_options(new shcore::Value::Map_type());
+  size_t parallel = instances->size();
+  if (args.size() == 2) {
+    *add_options = *args.map_at(1);
+    shcore::Argument_map opt_map(*add_options);
+    opt_map.ensure_keys({}, _add_instances_opts, "addInstances options");
+
+    if (opt_map.has_key("parallel")) {
+      int64_t value = opt_map.int_at("parallel");
+      if (value <= 0)
+        throw shcore::Exception::argument_error("The parallel option must be a positive integer");
+      parallel = static_cast<size_t>(value);
+      add_options->erase("parallel");
     }
-    log_debug("SSL mode used to configure instance: '%s'", ssl_mode.c_str());
   }
 
-  GRInstanceType type = get_gr_instance_type(session->connection());
+  if (instances->empty())
+    return ret_val;
+
+  if (_metadata_storage->is_replicaset_empty(get_id()))
+    throw shcore::Exception::runtime_error("ReplicaSet not initialized. Please add the Seed Instance using: addSeedInstance().");
+
+  std::vector<Joiner> joiners;
+  std::set<std::string> addresses;
+  bool auto_ssl_mode = false;
+  for (auto &instance : *instances) {
+    shcore::Argument_list instance_args;
+    instance_args.push_back(instance);
+    if (!add_options->empty())
+      instance_args.push_back(shcore::Value(add_options));
+
+    joiners.push_back(prepare_joiner(instance_args));
+    if (!addresses.insert(joiners.back().address).second)
+      throw shcore::Exception::argument_error("The instance '" + joiners.back().address + "' is given more than once");
+
+    if (joiners.back().ssl_mode.compare(dba::kMemberSSLModeAuto) == 0)
+      auto_ssl_mode = true;
+  }
+
+  std::string peer_gr_ssl_mode;
+  if (auto_ssl_mode)
+    peer_gr_ssl_mode = get_peer_gr_ssl_mode();
+
+  // The checks only use the session to each instance so they are done
+  // concurrently, nothing is changed until all of them passed
+  std::vector<std::string> errors(joiners.size());
+  uint64_t span = shcore::Trace_span::current();
+  std::mutex next_mutex;
+  size_t next = 0;
+  std::vector<std::thread> workers;
+  for (size_t count = 0; count < std::min(parallel, joiners.size()); count++) {
+    workers.push_back(std::thread([&]() {
+      while (true) {
+        size_t index;
+        {
+          std::lock_guard<std::mutex> lock(next_mutex);
+          if (next == joiners.size())
+            return;
+          index = next++;
+        }
 
-  if (type != GRInstanceType::Standalone) {
-    // Rethieves the new instance UUID
-    std::string uuid;
-    get_server_variable(session->connection(), "server_uuid", uuid);
-    session->close(shcore::Argument_list());
+        shcore::Trace_span joiner_span("check instance", span);
+        joiner_span.set("instance", joiners[index].address);
 
+        try {
+          check_joiner(&joiners[index], false, peer_gr_ssl_mode);
+        } catch (std::exception &e) {
+          errors[index] = e.what();
+        } catch (...) {
+          errors[index] = "Unknown error";
+        }
+      }
+    }));
+  }
+  for (auto &worker : workers)
+    worker.join();
+
+  std::string error;
+  for (size_t index = 0; index < joiners.size(); index++) {
+    if (!errors[index].empty())
+      error += "\n" + joiners[index].address + ": " + errors[index];
+  }
+  if (!error.empty())
+    throw shcore::Exception::runtime_error("The instances can not be added to the cluster:" + error);
+
+  // Group Replication admits one joining member at a time
+  for (auto &joiner : joiners)
+    join_instance(joiner, false, "", "");
+
+  return ret_val;
+}
+
+void ReplicaSet::join_instance(const Joiner &joiner, bool seed_instance,
+                               const std::string &existing_replication_user,
+                               const std::string &existing_replication_password) {
+  auto instance_def = joiner.instance_def;
+  const std::string &instance_address = joiner.address;
+  const std::string &user = joiner.user;
+  const std::string &super_user_password = joiner.password;
+
+  if (joiner.type != GRInstanceType::Standalone) {
     // Verifies if the instance is part of the cluster replication group
     auto cluster_session = _metadata_storage->get_dba()->get_active_session();
     auto cluster_classic_session = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(cluster_session);
 
     // Verifies if this UUID is part of the current replication group
-    if (is_server_on_replication_group(cluster_classic_session->connection(), uuid)) {
-      if (type == GRInstanceType::InnoDBCluster) {
+    if (is_server_on_replication_group(cluster_classic_session->connection(), joiner.uuid)) {
+      if (joiner.type == GRInstanceType::InnoDBCluster) {
         log_debug("Instance '%s' already managed by InnoDB cluster", instance_address.c_str());
         throw shcore::Exception::runtime_error("The instance '" + instance_address + "' is already part of this InnoDB cluster");
       }
@@ -455,20 +724,18 @@ shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
         log_debug("Instance '%s' is already part of a Replication Group, but not managed", instance_address.c_str());
     }
     else {
-      if (type == GRInstanceType::InnoDBCluster)
+      if (joiner.type == GRInstanceType::InnoDBCluster)
         throw shcore::Exception::runtime_error("The instance '" + instance_address + "' is already part of another InnoDB cluster");
       else
         throw shcore::Exception::runtime_error("The instance '" + instance_address + "' is already part of another Replication Group");
     }
-  } else {
-    session->close(shcore::Argument_list());
   }
 
   log_debug("RS %lu: Adding instance '%s' to replicaset%s",
             static_cast<unsigned long>(_id), instance_address.c_str(),
-            is_instance_on_md ? " (already in MD)" : "");
+            joiner.is_instance_on_md ? " (already in MD)" : "");
 
-  if (type == GRInstanceType::Standalone) {
+  if (joiner.type == GRInstanceType::Standalone) {
     log_debug("Instance '%s' is not yet in the cluster", instance_address.c_str());
 
     std::string replication_user(existing_replication_user);
@@ -501,7 +768,7 @@ shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
                            nullptr,
                           super_user_password,
                           replication_user, replication_user_password,
-                           ssl_mode, ip_whitelist);
+                           joiner.ssl_mode, joiner.ip_whitelist);
     } else {
       // We need to retrieve a peer instance, so let's use the Seed one
       std::string peer_instance = get_peer_instance();
@@ -529,17 +796,15 @@ shcore::Value ReplicaSet::add_instance(const shcore::Argument_list &args,
                            peer_instance_ssl_opts,
                           super_user_password,
                           replication_user, replication_user_password,
-                           ssl_mode, ip_whitelist);
+                           joiner.ssl_mode, joiner.ip_whitelist);
     }
   }
 
   // If the instance is not on the Metadata, we must add it
-  if (!is_instance_on_md)
-    add_instance_metadata(instance_def, instance_label);
+  if (!joiner.is_instance_on_md)
+    add_instance_metadata(instance_def, joiner.label);
 
   log_debug("Instance add finished");
-
-  return ret_val;
 }
 
 bool ReplicaSet::do_join_replicaset(const std::string &instance_url,
@@ -706,7 +971,7 @@ shcore::Value ReplicaSet::rejoin_instance(const shcore::Argument_list &args) {
   try {
     log_info("Opening a new session to the seed instance for validations %s",
              peer_instance.c_str());
-    session = mysqlsh::connect_session(session_args, mysqlsh::SessionType::Classic);
+    session = Session_pool::get()->acquire(session_args);
     classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
   } catch (std::exception &e) {
     log_error("Could not open connection to %s: %s", instance_address.c_str(),
@@ -735,6 +1000,8 @@ shcore::Value ReplicaSet::rejoin_instance(const shcore::Argument_list &args) {
   // Get @@group_replication_local_address
   get_server_variable(classic->connection(), "group_replication_local_address", peer_instance_xcom_address);
 
+  Session_pool::get()->release(session);
+
   // join Instance to cluster
   {
     try {
@@ -742,7 +1009,7 @@ shcore::Value ReplicaSet::rejoin_instance(const shcore::Argument_list &args) {
                instance_address.c_str());
       shcore::Argument_list slave_args;
       slave_args.push_back(shcore::Value(instance_def));
-      session = mysqlsh::connect_session(slave_args, mysqlsh::SessionType::Classic);
+      session = Session_pool::get()->acquire(slave_args);
       classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
     } catch (std::exception &e) {
       log_error("Could not open connection to '%s': %s", instance_address.c_str(),
@@ -782,6 +1049,7 @@ shcore::Value ReplicaSet::rejoin_instance(const shcore::Argument_list &args) {
     temp_args.clear();
     temp_args.push_back(shcore::Value("STOP GROUP_REPLICATION"));
     classic->run_sql(temp_args);
+    Session_pool::get()->release(session);
 
     // Get SSL values to connect to instance
     Value::Map_type_ref instance_ssl_opts(new shcore::Value::Map_type);
@@ -1007,60 +1275,101 @@ shcore::Value ReplicaSet::dissolve(const shcore::Argument_list &args) {
     if (!force && _metadata_storage->is_replicaset_active(get_id()))
       throw shcore::Exception::runtime_error("Cannot dissolve the ReplicaSet: the ReplicaSet is active.");
 
-    MetadataStorage::Transaction tx(_metadata_storage);
-
     uint64_t rset_id = get_id();
 
     // remove all the instances from the ReplicaSet
     auto instances = _metadata_storage->get_replicaset_instances(rset_id);
 
-    _metadata_storage->drop_replicaset(rset_id);
-
-    tx.commit();
-
-    remove_instances_from_gr(instances);
+    remove_instances_from_gr(instances, [this, rset_id]() {
+      MetadataStorage::Transaction tx(_metadata_storage);
+      _metadata_storage->drop_replicaset(rset_id);
+      tx.commit();
+    });
   }
   CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("dissolve"));
 
   return ret_val;
 }
 
-void ReplicaSet::remove_instances_from_gr(const shcore::Value::Array_type_ref &instances) {
-  MetadataStorage::Transaction tx(_metadata_storage);
-  int exit_code;
+std::string ReplicaSet::removal_journal_path() const {
+  return shcore::get_user_config_path() + "gr_removal_" + _cluster->get_name() + "_" + _name + ".json";
+}
+
+bool ReplicaSet::resume_removal_from_gr() {
+  std::string data;
+  if (!shcore::load_text_file(removal_journal_path(), data))
+    return false;
+
+  // Until the metadata is updated the operation itself is run again, the
+  // instances that already left are skipped
+  auto journal = shcore::Value::parse(data).as_map();
+  if (!journal->get_bool("metadataUpdated", false))
+    return false;
 
+  std::vector<std::string> members;
+  for (auto &member : *journal->get_array("members"))
+    members.push_back(member.as_string());
+
+  log_info("DBA: resuming the removal of %zu instances from the group", members.size());
+  leave_replicaset_members(members, journal->get_string("last"), nullptr);
+
+  return true;
+}
+
+/*
+ * Stops Group Replication on the given instances. The metadata updates of
+ * the calling operation are done by before_last, once every instance but
+ * the last one left the group, as until then the group can still take
+ * them. So if an instance fails to leave, running the operation again
+ * resumes the removal.
+ */
+void ReplicaSet::remove_instances_from_gr(const shcore::Value::Array_type_ref &instances,
+                                          const std::function<void()> &before_last) {
   auto instance_session(_metadata_storage->get_dba()->get_active_session());
   auto classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(instance_session.get());
-  std::string instance_admin_user = instance_session->get_user();
-  std::string instance_admin_user_password = instance_session->get_password();
 
   /* This function usually starts by removing from the replicaset the R/W instance, which
    * usually is the first on the instances list, and on primary-master mode that implies
    * a new master election. So to avoid GR BUG#24818604 , we must leave the R/W instance for last.
+   * On multi-master the instance of the session, which the metadata is updated on, is the last one.
    */
+  std::string last_uuid;
+  get_status_variable(classic->connection(), "group_replication_primary_member", last_uuid, false);
+  if (last_uuid.empty())
+    get_server_variable(classic->connection(), "server_uuid", last_uuid, false);
 
-  // Get the R/W instance
-  std::string master_uuid, master_instance;
-  get_status_variable(classic->connection(), "group_replication_primary_member", master_uuid, false);
+  std::vector<std::string> members;
+  std::string last_instance;
+  for (auto value : *instances.get()) {
+    auto row = value.as_object<mysqlsh::Row>();
+    std::string instance = row->get_member("host").as_string();
 
-  if (!master_uuid.empty()) {
-    for (auto value : *instances.get()) {
-      auto row = value.as_object<mysqlsh::Row>();
-      if (row->get_member(0).as_string() == master_uuid) {
-        master_instance = row->get_member("host").as_string();
-      }
-    }
+    if (row->get_member(0).as_string() == last_uuid)
+      last_instance = instance;
+    else
+      members.push_back(instance);
   }
 
+  if (!last_instance.empty())
+    members.push_back(last_instance);
+
+  leave_replicaset_members(members, last_instance, before_last);
+}
+
+void ReplicaSet::leave_replicaset_members(const std::vector<std::string> &members, const std::string &last_instance,
+                                          const std::function<void()> &before_last) {
+  auto instance_session(_metadata_storage->get_dba()->get_active_session());
+  std::string instance_admin_user = instance_session->get_user();
+  std::string instance_admin_user_password = instance_session->get_password();
+
   //Get SSL values to connect to the instances
   //NOTE: It is assumed that the same SSL settings (CA, Cert and Key) are used
   //      to connect to all the cluster instances. Therefore, the SSL settings
   //      can be obtained from the active session (connected to the cluster).
   Value::Map_type_ref instance_ssl_opts(new shcore::Value::Map_type);
-  auto active_session = _metadata_storage->get_dba()->get_active_session();
-  std::string ssl_ca = active_session->get_ssl_ca();
-  std::string ssl_cert = active_session->get_ssl_cert();
-  std::string ssl_key = active_session->get_ssl_key();
+  std::string ssl_ca = instance_session->get_ssl_ca();
+  std::string ssl_cert = instance_session->get_ssl_cert();
+  std::string ssl_key = instance_session->get_ssl_key();
   if (!ssl_ca.empty())
     (*instance_ssl_opts)["sslCa"] = Value(ssl_ca);
   if (!ssl_cert.empty())
@@ -1068,40 +1377,109 @@ void ReplicaSet::remove_instances_from_gr(const shcore::Value::Array_type_ref &i
   if (!ssl_key.empty())
     (*instance_ssl_opts)["sslKey"] = Value(ssl_key);
 
-  for (auto value : *instances.get()) {
-    auto row = value.as_object<mysqlsh::Row>();
+  // The members still in the group, rewritten as they leave
+  std::mutex mutex;
+  std::set<std::string> pending(members.begin(), members.end());
+  bool metadata_updated = !before_last;
+  std::string journal_path = removal_journal_path();
+  auto write_journal = [&]() {
+    shcore::Value::Array_type_ref remaining(new shcore::Value::Array_type());
+    for (auto &member : members) {
+      if (pending.count(member))
+        remaining->push_back(shcore::Value(member));
+    }
 
-    std::string instance = row->get_member("host").as_string();
+    shcore::Value::Map_type_ref journal(new shcore::Value::Map_type());
+    (*journal)["members"] = shcore::Value(remaining);
+    (*journal)["last"] = shcore::Value(last_instance);
+    (*journal)["metadataUpdated"] = shcore::Value(metadata_updated);
 
-    if (instance != master_instance) {
-      std::string instance_url = instance_admin_user + "@" + instance;
-      shcore::Value::Array_type_ref errors;
+    std::ofstream file(journal_path, std::ofstream::trunc);
+    file << shcore::Value(journal).json(false);
+    if (!file.good())
+      log_warning("DBA: unable to write the journal %s: %s", journal_path.c_str(), shcore::get_last_error().c_str());
+  };
+
+  // Leaving the group twice fails, an instance that is no longer on it
+  // is skipped
+  uint64_t span = shcore::Trace_span::current();
+  auto leave = [&](const std::string &instance, ProvisioningInterface *provisioning) {
+    shcore::Trace_span instance_span("leave group", span);
+    instance_span.set("instance", instance);
+
+    std::string instance_url = instance_admin_user + "@" + instance;
 
-      // Leave the replicaset
-      exit_code = _cluster->get_provisioning_interface()->leave_replicaset(instance_url,
-                                                                           instance_ssl_opts,
-                                                                           instance_admin_user_password,
-                                                                           errors);
-      if (exit_code != 0)
+    auto session = Session_pool::get()->acquire(instance_url, instance_admin_user_password);
+    GRInstanceType type = get_gr_instance_type(session->connection());
+    Session_pool::get()->release(session);
+
+    if (type != GRInstanceType::Standalone) {
+      shcore::Value::Array_type_ref errors;
+      if (provisioning->leave_replicaset(instance_url, instance_ssl_opts, instance_admin_user_password, errors) != 0)
         throw shcore::Exception::runtime_error(get_mysqlprovision_error_string(errors));
     }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.erase(instance);
+    write_journal();
+  };
+
+  write_journal();
+
+  // Every instance but the last one leaves at the same time, each worker
+  // with its own mysqlprovision
+  std::vector<std::string> others;
+  for (auto &member : members) {
+    if (member != last_instance)
+      others.push_back(member);
+  }
+
+  std::vector<std::string> errors(others.size());
+  std::atomic<size_t> next(0);
+  auto delegate = _metadata_storage->get_dba()->get_owner()->get_delegate();
+  int verbose = _cluster->get_provisioning_interface()->get_verbose();
+  auto worker = [&]() {
+    ProvisioningInterface provisioning(delegate);
+    provisioning.set_verbose(verbose);
+
+    size_t index;
+    while ((index = next++) < others.size()) {
+      try {
+        leave(others[index], &provisioning);
+      } catch (std::exception &e) {
+        errors[index] = e.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t count = 0; count < others.size(); count++)
+    workers.push_back(std::thread(worker));
+
+  for (auto &thread : workers)
+    thread.join();
+
+  std::string error;
+  for (size_t index = 0; index < others.size(); index++) {
+    if (!errors[index].empty())
+      error += "\n" + others[index] + ": " + errors[index];
   }
 
-  // Remove the master instance
-  if (!master_uuid.empty()) {
-    std::string instance_url = instance_admin_user + "@" + master_instance;
-    shcore::Value::Array_type_ref errors;
+  if (!error.empty())
+    throw shcore::Exception::runtime_error("The following instances failed to leave the group, "
+                                           "run the operation again to retry:" + error);
 
-    // Leave the replicaset
-    exit_code = _cluster->get_provisioning_interface()->leave_replicaset(instance_url,
-                                                                         instance_ssl_opts,
-                                                                         instance_admin_user_password,
-                                                                         errors);
-    if (exit_code != 0)
-      throw shcore::Exception::runtime_error(get_mysqlprovision_error_string(errors));
+  if (before_last) {
+    before_last();
+
+    metadata_updated = true;
+    write_journal();
   }
 
-  tx.commit();
+  if (!last_instance.empty())
+    leave(last_instance, _cluster->get_provisioning_interface().get());
+
+  shcore::delete_file(journal_path);
 }
 
 shcore::Value ReplicaSet::disable(const shcore::Argument_list &args) {
@@ -1110,17 +1488,15 @@ shcore::Value ReplicaSet::disable(const shcore::Argument_list &args) {
   args.ensure_count(0, get_function_name("disable").c_str());
 
   try {
-    MetadataStorage::Transaction tx(_metadata_storage);
-
     // Get all instances of the replicaset
     auto instances = _metadata_storage->get_replicaset_instances(get_id());
 
-    // Update the metadata to turn 'active' off
-    _metadata_storage->disable_replicaset(get_id());
-
-    tx.commit();
-
-    remove_instances_from_gr(instances);
+    remove_instances_from_gr(instances, [this]() {
+      // Update the metadata to turn 'active' off
+      MetadataStorage::Transaction tx(_metadata_storage);
+      _metadata_storage->disable_replicaset(get_id());
+      tx.commit();
+    });
   }
   CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("disable"));
 
@@ -1144,7 +1520,10 @@ shcore::Value::Map_type_ref ReplicaSet::_rescan(const shcore::Argument_list &arg
   // Set the ReplicaSet name on the result map
   (*ret_val)["name"] = shcore::Value(_name);
 
-  std::vector<NewInstanceInfo> newly_discovered_instances_list = get_newly_discovered_instances();
+  // Both lists come from the same view of the group and the metadata
+  Topology_snapshot topology = get_topology();
+
+  std::vector<NewInstanceInfo> newly_discovered_instances_list = get_newly_discovered_instances(topology);
 
   // Creates the newlyDiscoveredInstances map
   shcore::Value::Array_type_ref newly_discovered_instances(new shcore::Value::Array_type());
@@ -1164,7 +1543,7 @@ shcore::Value::Map_type_ref ReplicaSet::_rescan(const shcore::Argument_list &arg
 
   shcore::Value unavailable_instances_result;
 
-  std::vector<MissingInstanceInfo> unavailable_instances_list = get_unavailable_instances();
+  std::vector<MissingInstanceInfo> unavailable_instances_list = get_unavailable_instances(topology);
 
   // Creates the unavailableInstances array
   shcore::Value::Array_type_ref unavailable_instances(new shcore::Value::Array_type());
@@ -1186,8 +1565,17 @@ shcore::Value::Map_type_ref ReplicaSet::_rescan(const shcore::Argument_list &arg
 std::string ReplicaSet::get_peer_instance() {
   std::vector<std::string> result;
 
-  // We need to retrieve a peer instance, so let's use the Seed one
-  auto instances = _metadata_storage->get_replicaset_instances(get_id());
+  // Any online member can be the peer, the nearest one is taken. If the
+  // members can not be told, the first one of the metadata is used.
+  std::shared_ptr<shcore::Value::Array_type> instances;
+  try {
+    instances = _metadata_storage->get_replicaset_online_instances(get_id());
+  } catch (shcore::Exception &e) {
+    log_info("Unable to find the online members of the replicaset: %s", e.what());
+  }
+  if (!instances || instances->empty())
+    instances = _metadata_storage->get_replicaset_instances(get_id());
+
   if (instances) {
     for (auto value : *instances) {
       auto row = value.as_object<mysqlsh::Row>();
@@ -1195,6 +1583,13 @@ std::string ReplicaSet::get_peer_instance() {
       result.push_back(peer_instance);
     }
   }
+
+  if (result.size() > 1) {
+    Member_latency *latencies = Member_latency::get();
+    latencies->probe(result, _metadata_storage->get_dba()->get_active_session(), kPeerProbeWait);
+    latencies->sort(result);
+  }
+
   return result.front();
 }
 
@@ -1240,9 +1635,11 @@ shcore::Value ReplicaSet::retrieve_instance_state(const shcore::Argument_list &a
 
   get_gtid_state_variables(master_session->connection(), master_gtid_executed, master_gtid_purged);
   get_gtid_state_variables(instance_session->connection(), instance_gtid_executed, instance_gtid_purged);
+  Session_pool::get()->release(instance_session);
 
   // Now we perform the validation
-  SlaveReplicationState state = get_slave_replication_state(master_session->connection(), instance_gtid_executed);
+  SlaveReplicationState state = get_slave_replication_state(master_gtid_executed, master_gtid_purged,
+                                                            instance_gtid_executed);
 
   std::string reason;
   std::string status;
@@ -1278,6 +1675,18 @@ void ReplicaSet::add_instance_metadata(const shcore::Value::Map_type_ref &instan
 
   MetadataStorage::Transaction tx(_metadata_storage);
 
+  load_instance_metadata(instance_definition, label);
+
+  // update the metadata with the host
+  uint32_t host_id = _metadata_storage->insert_host(instance_definition);
+
+  // And the instance
+  _metadata_storage->insert_instance(instance_definition, host_id, get_id());
+
+  tx.commit();
+}
+
+void ReplicaSet::load_instance_metadata(const shcore::Value::Map_type_ref &instance_definition, const std::string& label) {
   int xport = instance_definition->get_int("port") * 10;
   std::string local_gr_address;
 
@@ -1296,8 +1705,7 @@ void ReplicaSet::add_instance_metadata(const shcore::Value::Map_type_ref &instan
     try {
       shcore::Argument_list new_args;
       new_args.push_back(shcore::Value(instance_definition));
-      classic = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(
-            mysqlsh::connect_session(new_args, mysqlsh::SessionType::Classic));
+      classic = Session_pool::get()->acquire(new_args);
     } catch (Exception &e) {
       std::stringstream ss;
       ss << "Error opening session to '" << instance_address << "': " << e.what();
@@ -1316,26 +1724,18 @@ void ReplicaSet::add_instance_metadata(const shcore::Value::Map_type_ref &instan
       }
       throw Exception::runtime_error(ss.str());
     }
-    {
-      // Query UUID of the member and its public hostname
-      auto result = classic->execute_sql("SELECT @@server_uuid");
-      auto row = result->fetch_one();
-      if (row) {
-        mysql_server_uuid = row->get_value_as_string(0);
-      } else
-        throw Exception::runtime_error("@@server_uuid could not be queried");
-    }
-    try {
-      auto result = classic->execute_sql("SELECT @@mysqlx_port");
-      auto xport_row = result->fetch_one();
-      if (xport_row)
-        xport = (int)xport_row->get_value(0).as_int();
-    } catch (std::exception &e) {
-      log_info("Could not query xplugin port, using default value: %s", e.what());
-    }
+    // The UUID of the member, its X plugin port and local GR address are
+    // read at once, the last two are missing if their plugins are not loaded
+    Instance_variables variables(classic->connection(),
+                                 {"server_uuid", "mysqlx_port", "group_replication_local_address"});
+
+    mysql_server_uuid = variables.get("server_uuid");
+
+    if (!variables.get("mysqlx_port", xport))
+      log_info("Could not query xplugin port, using default value");
 
     // Loads the local HR host data
-    get_server_variable(classic->connection(), "group_replication_local_address", local_gr_address, false);
+    variables.get("group_replication_local_address", local_gr_address);
 
     if (!mysql_server_address.empty() && mysql_server_address != joiner_host) {
       log_info("Normalized address of '%s' to '%s'", joiner_host.c_str(), mysql_server_address.c_str());
@@ -1343,6 +1743,8 @@ void ReplicaSet::add_instance_metadata(const shcore::Value::Map_type_ref &instan
     } else {
       mysql_server_address = joiner_host;
     }
+
+    Session_pool::get()->release(classic);
   }
   std::string instance_xaddress;
   instance_xaddress = mysql_server_address + ":" + std::to_string(xport);
@@ -1354,14 +1756,6 @@ void ReplicaSet::add_instance_metadata(const shcore::Value::Map_type_ref &instan
   (*instance_definition)["mysql_server_uuid"] = shcore::Value(mysql_server_uuid);
 
   (*instance_definition)["label"] = shcore::Value(label.empty() ? instance_address : label);
-
-  // update the metadata with the host
-  uint32_t host_id = _metadata_storage->insert_host(instance_definition);
-
-  // And the instance
-  _metadata_storage->insert_instance(instance_definition, host_id, get_id());
-
-  tx.commit();
 }
 
 void ReplicaSet::remove_instance_metadata(const shcore::Value::Map_type_ref& instance_def) {
@@ -1381,128 +1775,113 @@ void ReplicaSet::remove_instance_metadata(const shcore::Value::Map_type_ref& ins
   tx.commit();
 }
 
-std::vector<std::string> ReplicaSet::get_instances_gr() {
-  // Get the list of instances belonging to the GR group
-  std::string query = "SELECT member_id FROM performance_schema.replication_group_members";
+ReplicaSet::Topology_snapshot ReplicaSet::get_topology() {
+  // The members of the group, with their metadata if registered, followed by
+  // the instances of the metadata which are not members of the group
+  shcore::sqlstring query("SELECT g.member_id, g.member_host, g.member_port, g.member_state, "
+                          "i.mysql_server_uuid, i.instance_name, "
+                          "JSON_UNQUOTE(JSON_EXTRACT(i.addresses, \"$.mysqlClassic\")) "
+                          "FROM performance_schema.replication_group_members g "
+                          "LEFT JOIN mysql_innodb_cluster_metadata.instances i "
+                          "ON g.member_id = i.mysql_server_uuid AND i.replicaset_id = ? "
+                          "UNION ALL "
+                          "SELECT NULL, NULL, NULL, NULL, i.mysql_server_uuid, i.instance_name, "
+                          "JSON_UNQUOTE(JSON_EXTRACT(i.addresses, \"$.mysqlClassic\")) "
+                          "FROM mysql_innodb_cluster_metadata.instances i "
+                          "WHERE i.replicaset_id = ? AND i.mysql_server_uuid NOT IN "
+                          "(SELECT member_id FROM performance_schema.replication_group_members)", 0);
+  query << _id << _id;
+  query.done();
+
+  auto result = _metadata_storage->execute_read_sql(query);
+
+  Topology_snapshot topology;
+  while (auto row = result->fetch_one()) {
+    Topology_snapshot::Instance instance;
+    instance.in_group = row->get_value(0).type != shcore::Null;
+    instance.in_metadata = row->get_value(4).type != shcore::Null;
+    instance.member_port = 0;
+
+    if (instance.in_group) {
+      instance.uuid = row->get_value(0).as_string();
+      instance.member_host = row->get_value(1).as_string();
+      instance.member_port = row->get_value(2).as_int();
+      instance.member_state = row->get_value(3).as_string();
+    } else {
+      instance.uuid = row->get_value(4).as_string();
+    }
+
+    if (instance.in_metadata) {
+      instance.label = row->get_value(5).as_string();
+      instance.host = row->get_value(6).type == shcore::Null ? "" : row->get_value(6).as_string();
+    }
+
+    topology.instances.push_back(instance);
+  }
 
-  auto result = _metadata_storage->execute_sql(query);
-  auto members_ids = result->call("fetchAll", shcore::Argument_list());
+  return topology;
+}
 
-  // build the instances array
-  auto instances_gr = members_ids.as_array();
+std::vector<std::string> ReplicaSet::get_instances_gr(const Topology_snapshot &topology) {
   std::vector<std::string> instances_gr_array;
 
-  for (auto value : *instances_gr.get()) {
-    auto row = value.as_object<mysqlsh::Row>();
-    instances_gr_array.push_back(row->get_member(0).as_string());
+  for (auto &instance : topology.instances) {
+    if (instance.in_group)
+      instances_gr_array.push_back(instance.uuid);
   }
 
   return instances_gr_array;
 }
 
-std::vector<std::string> ReplicaSet::get_online_instances() {
+std::vector<std::string> ReplicaSet::get_online_instances(const Topology_snapshot &topology) {
   std::vector<std::string> online_instances_array;
 
-  auto online_instances = _metadata_storage->get_replicaset_online_instances(_id);
-
-  for (auto value : *online_instances.get()) {
-    auto row = value.as_object<mysqlsh::Row>();
-
-    std::string instance_host = row->get_member(3).as_string();
-    online_instances_array.push_back(instance_host);
+  for (auto &instance : topology.instances) {
+    if (instance.in_group && instance.in_metadata && instance.member_state == "ONLINE")
+      online_instances_array.push_back(instance.host);
   }
 
   return online_instances_array;
 }
 
-std::vector<std::string> ReplicaSet::get_instances_md() {
-  // Get the list of instances registered on the Metadata
-  shcore::sqlstring query("SELECT mysql_server_uuid FROM mysql_innodb_cluster_metadata.instances " \
-                          "WHERE replicaset_id = ?", 0);
-  query << _id;
-  query.done();
-
-  auto result = _metadata_storage->execute_sql(query);
-  auto mysql_server_uuids = result->call("fetchAll", shcore::Argument_list());
-
-  // build the instances array
-  auto instances_md = mysql_server_uuids.as_array();
+std::vector<std::string> ReplicaSet::get_instances_md(const Topology_snapshot &topology) {
   std::vector<std::string> instances_md_array;
 
-  for (auto value : *instances_md.get()) {
-    auto row = value.as_object<mysqlsh::Row>();
-    instances_md_array.push_back(row->get_member(0).as_string());
+  for (auto &instance : topology.instances) {
+    if (instance.in_metadata)
+      instances_md_array.push_back(instance.uuid);
   }
 
   return instances_md_array;
 }
 
-std::vector<ReplicaSet::NewInstanceInfo> ReplicaSet::get_newly_discovered_instances() {
-  std::vector<std::string> instances_gr_array, instances_md_array;
-  std::string query;
-
-  instances_gr_array = get_instances_gr();
-  instances_md_array = get_instances_md();
-
-  // Check the differences between the two lists
-  std::vector<std::string> new_members;
-
-  // Check if the instances_gr list has more members than the instances_md lists
-  // Meaning that an instance was added to the GR group outside of the AdminAPI
-  std::set_difference(instances_gr_array.begin(), instances_gr_array.end(), instances_md_array.begin(),
-                      instances_md_array.end(), std::inserter(new_members, new_members.begin()));
-
+std::vector<ReplicaSet::NewInstanceInfo> ReplicaSet::get_newly_discovered_instances(const Topology_snapshot &topology) {
+  // Instances added to the GR group outside of the AdminAPI
   std::vector<NewInstanceInfo> ret;
-  for (auto i : new_members) {
-    shcore::sqlstring query("SELECT MEMBER_ID, MEMBER_HOST, MEMBER_PORT " \
-                            "FROM performance_schema.replication_group_members " \
-                            "WHERE MEMBER_ID = ?", 0);
-    query << i;
-    query.done();
-
-    auto result = _metadata_storage->execute_sql(query);
-    auto row = result->fetch_one();
-
-    NewInstanceInfo info;
-    info.member_id = row->get_value(0).as_string();
-    info.host = row->get_value(1).as_string();
-    info.port = row->get_value(2).as_int();
-    ret.push_back(info);
+  for (auto &instance : topology.instances) {
+    if (instance.in_group && !instance.in_metadata) {
+      NewInstanceInfo info;
+      info.member_id = instance.uuid;
+      info.host = instance.member_host;
+      info.port = instance.member_port;
+      ret.push_back(info);
+    }
   }
 
   return ret;
 }
 
-std::vector<ReplicaSet::MissingInstanceInfo> ReplicaSet::get_unavailable_instances() {
-  std::vector<std::string> instances_gr_array, instances_md_array;
-
-  instances_gr_array = get_instances_gr();
-  instances_md_array = get_instances_md();
-
-  // Check the differences between the two lists
-  std::vector<std::string> removed_members;
-
-  // Check if the instances_md list has more members than the instances_gr lists
-  // Meaning that an instance was removed from the GR group outside of the AdminAPI
-  std::set_difference(instances_md_array.begin(), instances_md_array.end(), instances_gr_array.begin(),
-                      instances_gr_array.end(), std::inserter(removed_members, removed_members.begin()));
-
+std::vector<ReplicaSet::MissingInstanceInfo> ReplicaSet::get_unavailable_instances(const Topology_snapshot &topology) {
+  // Instances removed from the GR group outside of the AdminAPI
   std::vector<MissingInstanceInfo> ret;
-  for (auto i : removed_members) {
-    shcore::sqlstring query("SELECT mysql_server_uuid, instance_name, " \
-                            "JSON_UNQUOTE(JSON_EXTRACT(addresses, \"$.mysqlClassic\")) AS host " \
-                            "FROM mysql_innodb_cluster_metadata.instances " \
-                            "WHERE mysql_server_uuid = ?", 0);
-    query << i;
-    query.done();
-
-    auto result = _metadata_storage->execute_sql(query);
-    auto row = result->fetch_one();
-    MissingInstanceInfo info;
-    info.id = row->get_value(0).as_string();
-    info.label = row->get_value(1).as_string();
-    info.host = row->get_value(2).as_string();
-    ret.push_back(info);
+  for (auto &instance : topology.instances) {
+    if (instance.in_metadata && !instance.in_group) {
+      MissingInstanceInfo info;
+      info.id = instance.uuid;
+      info.label = instance.label;
+      info.host = instance.host;
+      ret.push_back(info);
+    }
   }
 
   return ret;
@@ -1590,7 +1969,7 @@ shcore::Value ReplicaSet::force_quorum_using_partition_of(const shcore::Argument
              instance_address.c_str());
     shcore::Argument_list partition_instance_args;
     partition_instance_args.push_back(shcore::Value(instance_def));
-    session = mysqlsh::connect_session(partition_instance_args, mysqlsh::SessionType::Classic);
+    session = Session_pool::get()->acquire(partition_instance_args);
     classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
   } catch (std::exception &e) {
     log_error("Could not open connection to '%s': %s", instance_address.c_str(),
@@ -1618,7 +1997,7 @@ shcore::Value ReplicaSet::force_quorum_using_partition_of(const shcore::Argument
     throw shcore::Exception::runtime_error(message);
   }
 
-  session->close(shcore::Argument_list());
+  Session_pool::get()->release(session);
 
   // Get the online instances of the ReplicaSet to user as group_peers
   auto online_instances = _metadata_storage->get_replicaset_online_instances(rset_id);
@@ -1650,7 +2029,7 @@ shcore::Value ReplicaSet::force_quorum_using_partition_of(const shcore::Argument
     try {
       log_info("Opening a new session to a group_peer instance to obtain the XCOM address %s",
                instance_host.c_str());
-      session = mysqlsh::connect_session(session_args, mysqlsh::SessionType::Classic);
+      session = Session_pool::get()->acquire(session_args);
       classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
     } catch (std::exception &e) {
       log_error("Could not open connection to %s: %s", instance_address.c_str(),
@@ -1665,9 +2044,9 @@ shcore::Value ReplicaSet::force_quorum_using_partition_of(const shcore::Argument
 
     group_peers.append(group_peer_instance_xcom_address);
     group_peers.append(",");
-  }
 
-  session->close(shcore::Argument_list());
+    Session_pool::get()->release(session);
+  }
 
   // Force the reconfiguration of the GR group
   {
@@ -1676,7 +2055,7 @@ shcore::Value ReplicaSet::force_quorum_using_partition_of(const shcore::Argument
                instance_address.c_str());
       shcore::Argument_list partition_instance_args;
       partition_instance_args.push_back(shcore::Value(instance_def));
-      session = mysqlsh::connect_session(partition_instance_args, mysqlsh::SessionType::Classic);
+      session = Session_pool::get()->acquire(partition_instance_args);
       classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
     } catch (std::exception &e) {
       log_error("Could not open connection to '%s': %s", instance_address.c_str(),
@@ -1693,7 +2072,7 @@ shcore::Value ReplicaSet::force_quorum_using_partition_of(const shcore::Argument
 
     set_global_variable(classic->connection(), "group_replication_force_members", group_peers);
 
-    session->close(shcore::Argument_list());
+    Session_pool::get()->release(session);
   }
 
   return ret_val;
@@ -1714,12 +2093,8 @@ shcore::Value ReplicaSet::get_description() const {
   query << _id;
   query.done();
 
-  auto result = _metadata_storage->execute_sql(query);
-
-  auto raw_instances = result->call("fetchAll", shcore::Argument_list());
-
   // First we identify the master instance
-  auto instances = raw_instances.as_array();
+  auto instances = _metadata_storage->fetch_all_cached(query);
 
   (*description)["name"] = shcore::Value(_name);
   (*description)["instances"] = shcore::Value::new_array();
@@ -1741,7 +2116,82 @@ shcore::Value ReplicaSet::get_description() const {
   return ret_val;
 }
 
-shcore::Value ReplicaSet::get_status(const mysqlsh::dba::ReplicationGroupState &state) const {
+// Results of the member statistics being collected by the worker threads
+struct Member_stats_collector {
+  std::mutex mutex;
+  std::condition_variable finished;
+  size_t pending = 0;
+  std::map<std::string, shcore::Value> stats;
+  std::map<std::string, std::string> errors;
+};
+
+/*
+ * Connects to every one of the given members on its own thread and reads
+ * its statistics. Waits up to timeout seconds for all of them, the members
+ * that did not answer by then are reported as timed out. The connections
+ * of the threads time out on their own after as long, so the threads are
+ * joined before returning.
+ */
+static std::shared_ptr<Member_stats_collector> collect_member_stats(const std::vector<std::string> &addresses,
+                                                                    const std::string &user,
+                                                                    const std::string &password,
+                                                                    const shcore::SslInfo &ssl_info,
+                                                                    int timeout) {
+  Member_stats_collector collector;
+  collector.pending = addresses.size();
+
+  std::vector<std::thread> workers;
+  for (auto &address : addresses) {
+    workers.emplace_back([&collector, address, &user, &password, &ssl_info, timeout]() {
+      shcore::Value stats;
+      std::string error;
+
+      try {
+        shcore::Connection_options options = shcore::Connection_options::parse(address, false);
+        mysqlsh::mysql::Connection connection(options.host, options.port, "",
+                                              user, password, "", ssl_info, false, "", -1, timeout);
+
+        stats = shcore::Value(get_member_stats(&connection));
+      } catch (std::exception &e) {
+        error = e.what();
+      }
+
+      std::lock_guard<std::mutex> lock(collector.mutex);
+      if (stats)
+        collector.stats[address] = stats;
+      else
+        collector.errors[address] = error;
+      collector.pending--;
+      collector.finished.notify_one();
+
+      mysql_thread_end();
+    });
+  }
+
+  std::shared_ptr<Member_stats_collector> ret_val(new Member_stats_collector());
+  {
+    std::unique_lock<std::mutex> lock(collector.mutex);
+    collector.finished.wait_for(lock, std::chrono::seconds(timeout), [&collector]() { return collector.pending == 0; });
+
+    ret_val->stats = collector.stats;
+    ret_val->errors = collector.errors;
+  }
+
+  for (auto &address : addresses) {
+    if (!ret_val->stats.count(address) && !ret_val->errors.count(address)) {
+      ret_val->errors[address] = "Timed out after " + std::to_string(timeout) + " seconds";
+      log_warning("Timed out collecting the statistics of %s", address.c_str());
+    }
+  }
+
+  for (auto &worker : workers)
+    worker.join();
+
+  return ret_val;
+}
+
+shcore::Value ReplicaSet::get_status(const mysqlsh::dba::ReplicationGroupState &state,
+                                     bool extended, int timeout) const {
   shcore::Value ret_val = shcore::Value::new_map();
   auto status = ret_val.as_map();
 
@@ -1767,7 +2217,7 @@ shcore::Value ReplicaSet::get_status(const mysqlsh::dba::ReplicationGroupState &
   query << _id;
   query.done();
 
-  auto result = _metadata_storage->execute_sql(query);
+  auto result = _metadata_storage->execute_read_sql(query);
 
   auto raw_instances = result->call("fetchAll", shcore::Argument_list());
 
@@ -1850,6 +2300,24 @@ shcore::Value ReplicaSet::get_status(const mysqlsh::dba::ReplicationGroupState &
   if (single_primary_mode && master)
     (*status)["primary"] = master->get_member(4);
 
+  // The statistics of every member are read from the member itself, all of
+  // them at once so a slow member does not delay the rest
+  std::shared_ptr<Member_stats_collector> member_stats;
+  if (extended) {
+    std::vector<std::string> addresses;
+    for (auto value : *instances.get())
+      addresses.push_back(value.as_object<mysqlsh::Row>()->get_member(4).as_string());
+
+    shcore::SslInfo ssl_info;
+    ssl_info.ca = session->get_ssl_ca();
+    ssl_info.cert = session->get_ssl_cert();
+    ssl_info.key = session->get_ssl_key();
+    ssl_info.skip = ssl_info.ca.empty() && ssl_info.cert.empty() && ssl_info.key.empty();
+
+    member_stats = collect_member_stats(addresses, session->get_user(), session->get_password(),
+                                        ssl_info, timeout);
+  }
+
   // Creates the topology node
   (*status)["topology"] = shcore::Value::new_map();
   auto instance_owner_node = status->get_map("topology");
@@ -1876,6 +2344,67 @@ shcore::Value ReplicaSet::get_status(const mysqlsh::dba::ReplicationGroupState &
                            active_session_instance);
 
     (*instance_node)["readReplicas"] = shcore::Value::new_map();
+
+    if (member_stats) {
+      auto address = row->get_member(4).as_string();
+      if (member_stats->stats.count(address))
+        (*instance_node)["memberStats"] = member_stats->stats[address];
+      else
+        (*instance_node)["memberStatsError"] = shcore::Value(member_stats->errors[address]);
+    }
+  }
+
+  return ret_val;
+}
+
+shcore::Value::Map_type_ref ReplicaSet::sample_members() {
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  auto session = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(_metadata_storage
+                      ->get_dba()->get_active_session());
+
+  std::string primary_uuid;
+  if (_topology_type == kTopologyPrimaryMaster)
+    get_status_variable(session->connection(), "group_replication_primary_member", primary_uuid, false);
+
+  for (auto &instance : get_topology().instances) {
+    std::string address = instance.in_metadata ? instance.host :
+                          instance.member_host + ":" + std::to_string(instance.member_port);
+    std::string label = instance.in_metadata ? instance.label : address;
+
+    shcore::Value::Map_type_ref member(new shcore::Value::Map_type());
+    (*member)["address"] = shcore::Value(address);
+    (*member)["status"] = shcore::Value(instance.in_group ? instance.member_state : "(MISSING)");
+    (*member)["mode"] = shcore::Value(primary_uuid.empty() || instance.uuid == primary_uuid ? "R/W" : "R/O");
+
+    // The lag is only known by the member itself, its session is kept by the
+    // pool from one sample to the next
+    if (instance.in_group && instance.member_state == "ONLINE" && !address.empty()) {
+      try {
+        shcore::Connection_options options = shcore::Connection_options::parse(address, false);
+        options.user = session->get_user();
+        options.password = session->get_password();
+        options.has_password = true;
+        options.ssl.ca = session->get_ssl_ca();
+        options.ssl.cert = session->get_ssl_cert();
+        options.ssl.key = session->get_ssl_key();
+        options.ssl.skip = options.ssl.ca.empty() && options.ssl.cert.empty() && options.ssl.key.empty();
+
+        auto member_session = Session_pool::get()->acquire(options);
+        try {
+          (*member)["transactionsInQueue"] = (*get_member_stats(member_session->connection()))["transactionsInQueue"];
+        } catch (...) {
+          Session_pool::get()->release(member_session);
+          throw;
+        }
+        Session_pool::get()->release(member_session);
+      } catch (std::exception &e) {
+        log_warning("Unable to sample the member %s: %s", address.c_str(), e.what());
+        (*member)["transactionsInQueue"] = shcore::Value::Null();
+      }
+    }
+
+    (*ret_val)[label] = shcore::Value(member);
   }
 
   return ret_val;
@@ -1893,13 +2422,10 @@ void ReplicaSet::remove_instances(const std::vector<std::string> &remove_instanc
       if (_metadata_storage->is_instance_on_replicaset(_id, instance)) {
         Value::Map_type_ref options(new shcore::Value::Map_type);
 
-        shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(instance);
+        shcore::Connection_options address = shcore::Connection_options::parse(instance, false);
 
-        int instance_port = connection_data->get_int("port");
-        std::string instance_host = connection_data->get_string("host");
-
-        (*options)["host"] = shcore::Value(instance_host);
-        (*options)["port"] = shcore::Value(instance_port);
+        (*options)["host"] = shcore::Value(address.host);
+        (*options)["port"] = shcore::Value(address.port);
 
         remove_instance_metadata(options);
       } else {
@@ -1956,15 +2482,12 @@ void ReplicaSet::rejoin_instances(const std::vector<std::string> &rejoin_instanc
 
         std::pair<std::string, int> instance_uri;
 
-        shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(instance);
-
-        int instance_port = connection_data->get_int("port");
-        std::string instance_host = connection_data->get_string("host");
+        shcore::Connection_options address = shcore::Connection_options::parse(instance, false);
 
         (*options)["user"] = shcore::Value(user);
         (*options)["password"] = shcore::Value(password);
-        (*options)["host"] = shcore::Value(instance_host);
-        (*options)["port"] = shcore::Value(instance_port);
+        (*options)["host"] = shcore::Value(address.host);
+        (*options)["port"] = shcore::Value(address.port);
 
         args.push_back(shcore::Value(options));
 
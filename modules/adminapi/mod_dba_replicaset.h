@@ -53,6 +53,7 @@ public:
   virtual ~ReplicaSet();
 
   static std::set<std::string> _add_instance_opts;
+  static std::set<std::string> _add_instances_opts;
 
   virtual std::string class_name() const { return "ReplicaSet"; }
   virtual std::string &append_descr(std::string &s_out, int indent = -1, int quote_strings = 0) const;
@@ -75,9 +76,34 @@ public:
 
   void adopt_from_gr();
 
-  std::vector<std::string> get_instances_gr();
-  std::vector<std::string> get_instances_md();
-  std::vector<std::string> get_online_instances();
+  // The members of the group and the instances registered on the metadata
+  // for the replicaset, read by a single query so that all the lists derived
+  // from it agree with each other
+  struct Topology_snapshot {
+    struct Instance {
+      std::string uuid;
+      bool in_group;
+      bool in_metadata;
+      // As seen by the group
+      std::string member_host;
+      int member_port;
+      std::string member_state;
+      // As registered on the metadata
+      std::string label;
+      std::string host;
+    };
+
+    std::vector<Instance> instances;
+  };
+
+  Topology_snapshot get_topology();
+
+  std::vector<std::string> get_instances_gr() { return get_instances_gr(get_topology()); }
+  std::vector<std::string> get_instances_md() { return get_instances_md(get_topology()); }
+  std::vector<std::string> get_online_instances() { return get_online_instances(get_topology()); }
+  std::vector<std::string> get_instances_gr(const Topology_snapshot &topology);
+  std::vector<std::string> get_instances_md(const Topology_snapshot &topology);
+  std::vector<std::string> get_online_instances(const Topology_snapshot &topology);
 
   static char const *kTopologyPrimaryMaster;
   static char const *kTopologyMultiMaster;
@@ -112,6 +138,7 @@ public:
                              const std::string &existing_replication_user = "",
                              const std::string &existing_replication_password = "",
                              bool overwrite_seed=false);
+  shcore::Value add_instances(const shcore::Argument_list &args);
   shcore::Value check_instance_state(const shcore::Argument_list &args);
   shcore::Value rejoin_instance_(const shcore::Argument_list &args);
   shcore::Value rejoin_instance(const shcore::Argument_list &args);
@@ -123,9 +150,18 @@ public:
   shcore::Value rescan(const shcore::Argument_list &args);
   shcore::Value force_quorum_using_partition_of(const shcore::Argument_list &args);
   shcore::Value force_quorum_using_partition_of_(const shcore::Argument_list &args);
-  shcore::Value get_status(const mysqlsh::dba::ReplicationGroupState &state) const;
-
-  void remove_instances_from_gr(const shcore::Value::Array_type_ref &instances);
+  // When extended, the statistics of the members are collected in parallel,
+  // waiting at most timeout seconds for them
+  shcore::Value get_status(const mysqlsh::dba::ReplicationGroupState &state,
+                           bool extended = false, int timeout = 0) const;
+  // The status, mode and lag of every member by label, read with a query
+  // per member, on the sessions kept by the pool
+  shcore::Value::Map_type_ref sample_members();
+
+  void remove_instances_from_gr(const shcore::Value::Array_type_ref &instances,
+                                const std::function<void()> &before_last);
+  // Resumes a removal from the group that failed part way, false if none
+  bool resume_removal_from_gr();
   ReplicationGroupState check_preconditions(const std::string& function_name) const;
   void remove_instances(const std::vector<std::string> &remove_instances);
   void rejoin_instances(const std::vector<std::string> &rejoin_instances,
@@ -143,8 +179,8 @@ private:
     std::string label;
     std::string host;
   };
-  std::vector<NewInstanceInfo> get_newly_discovered_instances();
-  std::vector<MissingInstanceInfo> get_unavailable_instances();
+  std::vector<NewInstanceInfo> get_newly_discovered_instances(const Topology_snapshot &topology);
+  std::vector<MissingInstanceInfo> get_unavailable_instances(const Topology_snapshot &topology);
 
   shcore::Value get_description() const;
   void verify_topology_type_change() const;
@@ -158,6 +194,37 @@ protected:
 private:
   void init();
 
+  // An instance being added to the replicaset
+  struct Joiner {
+    shcore::Value::Map_type_ref instance_def;
+    std::string address;
+    std::string user;
+    std::string password;
+    std::string ssl_mode;
+    std::string ip_whitelist;
+    std::string label;
+    bool is_instance_on_md;
+    GRInstanceType type;
+    std::string uuid;
+    bool wait_recovery;
+  };
+
+  Joiner prepare_joiner(const shcore::Argument_list &args);
+  // Only uses a session to the joining instance, so it can be called for
+  // several instances at the same time
+  void check_joiner(Joiner *joiner, bool seed_instance, const std::string &peer_gr_ssl_mode);
+  void join_instance(const Joiner &joiner, bool seed_instance,
+                     const std::string &existing_replication_user,
+                     const std::string &existing_replication_password);
+  std::string get_peer_gr_ssl_mode();
+
+  // Samples the distributed recovery of the instance until it is ONLINE,
+  // printing its progress, returns the recovery metrics
+  shcore::Value::Map_type_ref wait_recovery(const Joiner &joiner);
+
+  // Queries the instance for the rest of the data registered in the metadata
+  void load_instance_metadata(const shcore::Value::Map_type_ref &instance_definition, const std::string& label);
+
   bool do_join_replicaset(const std::string &instance_url,
       const shcore::Value::Map_type_ref &instance_ssl,
       const std::string &peer_instance_url,
@@ -173,9 +240,17 @@ private:
                                  const std::string &hostname, int port);
   std::string resolve_ssl_mode(mysqlsh::mysql::ClassicSession *session,
                                mysqlsh::mysql::ClassicSession *peer_session);
+  static std::string resolve_joiner_ssl_mode(mysqlsh::mysql::ClassicSession *session,
+                                             const std::string &gr_ssl_mode);
 
   shcore::Value::Map_type_ref _rescan(const shcore::Argument_list &args);
 
+  // The instances a removal from the group has yet to stop are kept on this
+  // file until all of them left
+  std::string removal_journal_path() const;
+  void leave_replicaset_members(const std::vector<std::string> &members, const std::string &last_instance,
+                                const std::function<void()> &before_last);
+
   std::shared_ptr<Cluster> _cluster;
   std::shared_ptr<MetadataStorage> _metadata_storage;
   std::shared_ptr<ProvisioningInterface> _provisioning_interface;
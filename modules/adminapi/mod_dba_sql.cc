@@ -18,11 +18,130 @@
  */
 
 #include "modules/adminapi/mod_dba_sql.h"
+#include "modules/adminapi/mod_dba_gtid_set.h"
+#include "modules/member_latency.h"
 #include "utils/utils_sqlstring.h"
+#include "utils/utils_general.h"
+#include "utils/utils_trace.h"
+#include <algorithm>
+#include <cctype>
+#include <map>
 #include <string>
 
 namespace mysqlsh {
 namespace dba {
+namespace {
+std::string lower_name(std::string name) {
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  return name;
+}
+
+std::string name_list(const std::vector<std::string> &names) {
+  std::string ret_val;
+
+  for (auto &name : names) {
+    if (!ret_val.empty())
+      ret_val += ", ";
+
+    ret_val += shcore::sqlstring("?", 0) << lower_name(name);
+  }
+
+  return ret_val;
+}
+
+// Every query on the instances is a step of the operation trace
+std::unique_ptr<mysqlsh::mysql::Result> run_sql(mysqlsh::mysql::Connection *connection, const std::string &query) {
+  shcore::Trace_span span("sql");
+  if (span.recording()) {
+    span.set("instance", shcore::strip_password(connection->uri()));
+    span.set("sql", query);
+  }
+
+  return connection->run_sql(query);
+}
+}
+
+Instance_variables::Instance_variables(mysqlsh::mysql::Connection *connection,
+                                       const std::vector<std::string> &globals,
+                                       const std::vector<std::string> &status) {
+  std::string query;
+
+  if (!globals.empty())
+    query = "SELECT 'G', VARIABLE_NAME, VARIABLE_VALUE FROM performance_schema.global_variables "
+            "WHERE VARIABLE_NAME IN (" + name_list(globals) + ")";
+
+  if (!status.empty()) {
+    if (!query.empty())
+      query += " UNION ALL ";
+
+    query += "SELECT 'S', VARIABLE_NAME, VARIABLE_VALUE FROM performance_schema.global_status "
+             "WHERE VARIABLE_NAME IN (" + name_list(status) + ")";
+  }
+
+  if (query.empty())
+    return;
+
+  // Any error will bubble up right away
+  auto result = run_sql(connection, query);
+
+  while (auto row = result->fetch_one()) {
+    std::string name = lower_name(row->get_value_as_string(1));
+    shcore::Value value = row->get_value(2);
+    std::string text = value.type == shcore::Null ? "" : row->get_value_as_string(2);
+
+    if (row->get_value_as_string(0) == "G")
+      _globals[name] = text;
+    else
+      _status[name] = text;
+  }
+}
+
+bool Instance_variables::get(const std::string &name, std::string &value) const {
+  auto found = _globals.find(lower_name(name));
+  if (found == _globals.end())
+    return false;
+
+  value = found->second;
+  return true;
+}
+
+bool Instance_variables::get(const std::string &name, int &value) const {
+  std::string text;
+  if (!get(name, text))
+    return false;
+
+  try {
+    value = std::stoi(text);
+  } catch (std::exception &) {
+    // Booleans are reported as ON and OFF
+    if (lower_name(text) == "on")
+      value = 1;
+    else if (lower_name(text) == "off")
+      value = 0;
+    else
+      return false;
+  }
+
+  return true;
+}
+
+bool Instance_variables::get_status(const std::string &name, std::string &value) const {
+  auto found = _status.find(lower_name(name));
+  if (found == _status.end())
+    return false;
+
+  value = found->second;
+  return true;
+}
+
+std::string Instance_variables::get(const std::string &name) const {
+  std::string value;
+  if (!get(name, value))
+    throw shcore::Exception::runtime_error("'" + name + "' could not be queried");
+
+  return value;
+}
+
 GRInstanceType get_gr_instance_type(mysqlsh::mysql::Connection* connection) {
   GRInstanceType ret_val = GRInstanceType::Standalone;
 
@@ -31,7 +150,7 @@ GRInstanceType get_gr_instance_type(mysqlsh::mysql::Connection* connection) {
                     "where MEMBER_ID = @@server_uuid AND MEMBER_STATE IS NOT NULL AND MEMBER_STATE <> 'OFFLINE';");
 
   try {
-    auto result = connection->run_sql(query);
+    auto result = run_sql(connection, query);
     auto row = result->fetch_one();
 
     if (row) {
@@ -48,7 +167,7 @@ GRInstanceType get_gr_instance_type(mysqlsh::mysql::Connection* connection) {
   if (ret_val == GRInstanceType::GroupReplication) {
     query = "select count(*) from mysql_innodb_cluster_metadata.instances where mysql_server_uuid = @@server_uuid";
     try {
-      auto result = connection->run_sql(query);
+      auto result = run_sql(connection, query);
       auto row = result->fetch_one();
 
       if (row) {
@@ -68,7 +187,7 @@ void get_port_and_datadir(mysqlsh::mysql::Connection* connection, int &port, std
   std::string query("select @@port, @@datadir;");
 
   // Any error will bubble up right away
-  auto result = connection->run_sql(query);
+  auto result = run_sql(connection, query);
   auto row = result->fetch_one();
 
   port = row->get_value(0).as_int();
@@ -76,46 +195,27 @@ void get_port_and_datadir(mysqlsh::mysql::Connection* connection, int &port, std
 }
 
 void get_gtid_state_variables(mysqlsh::mysql::Connection* connection, std::string &executed, std::string &purged) {
-  // Retrieves the
-  std::string query("show global variables where Variable_name in ('gtid_purged', 'gtid_executed')");
+  Instance_variables variables(connection, {"gtid_executed", "gtid_purged"});
 
-  // Any error will bubble up right away
-  auto result = connection->run_sql(query);
-
-  // Selects the gtid_executed value
-  auto row = result->fetch_one();
-  executed = row->get_value(1).as_string();
-
-  // Selects the gtid_purged value
-  row = result->fetch_one();
-  purged = row->get_value(1).as_string();
+  executed = variables.get("gtid_executed");
+  purged = variables.get("gtid_purged");
 }
 
-SlaveReplicationState get_slave_replication_state(mysqlsh::mysql::Connection* connection, std::string &slave_executed) {
+SlaveReplicationState get_slave_replication_state(const std::string &master_executed,
+                                                  const std::string &master_purged,
+                                                  const std::string &slave_executed) {
   SlaveReplicationState ret_val;
 
   if (slave_executed.empty())
     ret_val = SlaveReplicationState::New;
   else {
-    std::string query;
-    query = shcore::sqlstring("select gtid_subset(?, @@global.gtid_executed)", 0) << slave_executed;
+    // The sets are compared locally, no round trip to the master is needed
+    Gtid_set slave(slave_executed);
 
-    auto result = connection->run_sql(query);
-    auto row = result->fetch_one();
-
-    int slave_is_subset = row->get_value(0).as_int();
-
-    if (1 == slave_is_subset) {
+    if (slave.is_subset_of(Gtid_set(master_executed))) {
       // If purged has more gtids than the executed on the slave
       // it means some data will not be recoverable
-      query = shcore::sqlstring("select gtid_subtract(@@global.gtid_purged, ?)", 0) << slave_executed;
-
-      result = connection->run_sql(query);
-      row = result->fetch_one();
-
-      std::string missed = row->get_value(0).as_string();
-
-      if (missed.empty())
+      if (Gtid_set(master_purged).subtract(slave).empty())
         ret_val = SlaveReplicationState::Recoverable;
       else
         ret_val = SlaveReplicationState::Irrecoverable;
@@ -140,14 +240,14 @@ ReplicationGroupState get_replication_group_state(mysqlsh::mysql::Connection* co
   // Gets the session uuid + the master uuid
   std::string uuid_query("SELECT @@server_uuid, VARIABLE_VALUE FROM performance_schema.global_status WHERE VARIABLE_NAME = 'group_replication_primary_member';");
 
-  auto result = connection->run_sql(uuid_query);
+  auto result = run_sql(connection, uuid_query);
   auto row = result->fetch_one();
   ret_val.source = row->get_value(0).as_string();
   ret_val.master = row->get_value(1).as_string();
 
   // Gets the cluster instance status count
   std::string instance_state_query("SELECT MEMBER_STATE FROM performance_schema.replication_group_members WHERE MEMBER_ID = '" + ret_val.source + "'");
-  result = connection->run_sql(instance_state_query);
+  result = run_sql(connection, instance_state_query);
   row = result->fetch_one();
   std::string state = row->get_value(0).as_string();
 
@@ -170,7 +270,7 @@ ReplicationGroupState get_replication_group_state(mysqlsh::mysql::Connection* co
   // The quorum is said to be true if #UNREACHABLE_NODES < (TOTAL_NODES/2)
   std::string state_count_query("SELECT CAST(SUM(IF(member_state = 'UNREACHABLE', 1, 0)) AS SIGNED) AS UNREACHABLE,  COUNT(*) AS TOTAL FROM performance_schema.replication_group_members");
 
-  result = connection->run_sql(state_count_query);
+  result = run_sql(connection, state_count_query);
   row = result->fetch_one();
   int unreachable_count = row->get_value(0).as_int();
   int instance_count = row->get_value(1).as_int();
@@ -188,7 +288,7 @@ std::string get_plugin_status(mysqlsh::mysql::Connection *connection, std::strin
   query = shcore::sqlstring("SELECT PLUGIN_STATUS FROM INFORMATION_SCHEMA.PLUGINS WHERE PLUGIN_NAME = ?", 0) << plugin_name;
 
   // Any error will bubble up right away
-  auto result = connection->run_sql(query);
+  auto result = run_sql(connection, query);
 
   // Selects the PLUGIN_STATUS value
   auto row = result->fetch_one();
@@ -210,7 +310,7 @@ bool is_server_on_replication_group(mysqlsh::mysql::Connection* connection, cons
   query = shcore::sqlstring("select count(*) from performance_schema.replication_group_members where member_id = ?", 0) << uuid;
 
   // Any error will bubble up right away
-  auto result = connection->run_sql(query);
+  auto result = run_sql(connection, query);
 
   // Selects the PLUGIN_STATUS value
   auto row = result->fetch_one();
@@ -231,7 +331,7 @@ bool get_server_variable(mysqlsh::mysql::Connection *connection, const std::stri
   std::string query = "SELECT @@" + name;
 
   try {
-    auto result = connection->run_sql(query);
+    auto result = run_sql(connection, query);
     auto row = result->fetch_one();
 
     if (row)
@@ -256,7 +356,7 @@ bool get_server_variable(mysqlsh::mysql::Connection *connection, const std::stri
   std::string query = "SELECT @@" + name;
 
   try {
-    auto result = connection->run_sql(query);
+    auto result = run_sql(connection, query);
     auto row = result->fetch_one();
 
     if (row)
@@ -280,7 +380,7 @@ void set_global_variable(mysqlsh::mysql::Connection *connection, const std::stri
   std::string query, query_raw = "SET GLOBAL " + name + " = ?";
   query = shcore::sqlstring(query_raw.c_str(), 0) << value;
 
-  auto result = connection->run_sql(query);
+  auto result = run_sql(connection, query);
 }
 
 bool get_status_variable(mysqlsh::mysql::Connection *connection, const std::string &name,
@@ -289,7 +389,7 @@ bool get_status_variable(mysqlsh::mysql::Connection *connection, const std::stri
   std::string query = "SHOW STATUS LIKE '" + name + "'";
 
   try {
-    auto result = connection->run_sql(query);
+    auto result = run_sql(connection, query);
     auto row = result->fetch_one();
 
     if (row) {
@@ -307,23 +407,6 @@ bool get_status_variable(mysqlsh::mysql::Connection *connection, const std::stri
   return ret_val;
 }
 
-bool is_gtid_subset(mysqlsh::mysql::Connection *connection, const std::string &subset, const std::string &set) {
-  int ret_val = 0;
-  std::string query = shcore::sqlstring("SELECT GTID_SUBSET(?, ?)", 0) << subset << set;
-
-  try {
-    auto result = connection->run_sql(query);
-    auto row = result->fetch_one();
-
-    if (row)
-      ret_val = row->get_value(0).as_int();
-  } catch (shcore::Exception& error) {
-      throw;
-  }
-
-  return (ret_val == 1);
-}
-
 /*
  * Get the master status information of the server and return a Map with the
  * retrieved information:
@@ -336,7 +419,7 @@ bool is_gtid_subset(mysqlsh::mysql::Connection *connection, const std::string &s
 shcore::Value get_master_status(mysqlsh::mysql::Connection *connection) {
   shcore::Value::Map_type_ref status(new shcore::Value::Map_type);
   std::string query = "SHOW MASTER STATUS";
-  auto result = connection->run_sql(query);
+  auto result = run_sql(connection, query);
   auto row = result->fetch_one();
 
   if (row) {
@@ -352,34 +435,69 @@ shcore::Value get_master_status(mysqlsh::mysql::Connection *connection) {
 /*
  * Retrieves the list of group replication
  * addresses of the peer instances of
- * instance_host
+ * instance_host, the nearest ones first
  */
 std::vector<std::string> get_peer_seeds(mysqlsh::mysql::Connection *connection, const std::string &instance_host) {
   std::vector<std::string> ret_val;
-  shcore::sqlstring query = shcore::sqlstring("SELECT JSON_UNQUOTE(addresses->\"$.grLocal\") "\
+  shcore::sqlstring query = shcore::sqlstring("SELECT JSON_UNQUOTE(addresses->\"$.grLocal\"), "\
+                                              "JSON_UNQUOTE(addresses->\"$.mysqlClassic\") "\
                                               "FROM mysql_innodb_cluster_metadata.instances "\
                                               "WHERE addresses->\"$.mysqlClassic\" <> ? "\
                                               "AND replicaset_id IN (SELECT replicaset_id "\
                                                                     "FROM mysql_innodb_cluster_metadata.instances "\
-                                                                    "WHERE addresses->\"$.mysqlClassic\" = ?)", 0);
+                                                                    "WHERE JSON_UNQUOTE(addresses->'$.mysqlClassic') = ?)", 0);
 
   query << instance_host.c_str();
   query << instance_host.c_str();
   query.done();
 
   try {
-    auto result = connection->run_sql(query);
+    auto result = run_sql(connection, query);
     auto row = result->fetch_one();
 
+    // The members are timed on their classic address
+    std::vector<std::string> members;
+    std::map<std::string, std::string> seeds;
     while(row) {
-      ret_val.push_back(row->get_value(0).as_string());
+      members.push_back(row->get_value(1).as_string());
+      seeds[members.back()] = row->get_value(0).as_string();
       row = result->fetch_one();
     }
+
+    mysqlsh::Member_latency::get()->sort(members);
+    for (auto &member : members)
+      ret_val.push_back(seeds[member]);
   } catch (shcore::Exception &error) {
     log_warning("Unable to retrieve group seeds for instance '%s': %s", instance_host.c_str(), error.what());
   }
 
   return ret_val;
 }
+
+/*
+ * Returns the statistics the instance keeps about itself as a member of the
+ * replication group, the counters are Null if the instance is not a member
+ */
+shcore::Value::Map_type_ref get_member_stats(mysqlsh::mysql::Connection *connection) {
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  std::string query("SELECT @@global.version, @@global.super_read_only, "
+                    "COUNT_TRANSACTIONS_IN_QUEUE, COUNT_TRANSACTIONS_CHECKED, COUNT_CONFLICTS_DETECTED "
+                    "FROM (SELECT 1) AS instance "
+                    "LEFT JOIN performance_schema.replication_group_member_stats "
+                    "ON MEMBER_ID = @@global.server_uuid");
+
+  // Any error will bubble up right away
+  auto result = run_sql(connection, query);
+  auto row = result->fetch_one();
+
+  (*ret_val)["version"] = row->get_value(0);
+  (*ret_val)["superReadOnly"] = shcore::Value(row->get_value(1).as_int() != 0);
+  (*ret_val)["transactionsInQueue"] = row->get_value(2);
+  (*ret_val)["transactionsChecked"] = row->get_value(3);
+  (*ret_val)["conflictsDetected"] = row->get_value(4);
+
+  return ret_val;
+}
 } // namespace dba
 } // namespace mysh
@@ -24,12 +24,39 @@
 #include "modules/adminapi/mod_dba_common.h"
 #include "shellcore/common.h"
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace mysqlsh {
 namespace dba {
+// Snapshot of global and status variables of an instance, read with a single
+// query so the checks of an operation do not cost a round trip each. The
+// values are kept for the lifetime of the snapshot, i.e. the operation.
+class Instance_variables {
+public:
+  // Variables not known by the server are just missing from the snapshot
+  Instance_variables(mysqlsh::mysql::Connection *connection, const std::vector<std::string> &globals,
+                     const std::vector<std::string> &status = {});
+
+  bool get(const std::string &name, std::string &value) const;
+  bool get(const std::string &name, int &value) const;
+  bool get_status(const std::string &name, std::string &value) const;
+
+  // Throws if the variable is not on the snapshot
+  std::string get(const std::string &name) const;
+
+private:
+  std::map<std::string, std::string> _globals;
+  std::map<std::string, std::string> _status;
+};
+
 GRInstanceType get_gr_instance_type(mysqlsh::mysql::Connection* connection);
 void get_port_and_datadir(mysqlsh::mysql::Connection* connection, int &port, std::string& datadir);
 void get_gtid_state_variables(mysqlsh::mysql::Connection* connection, std::string &executed, std::string &purged);
-SlaveReplicationState get_slave_replication_state(mysqlsh::mysql::Connection* connection, std::string &slave_executed);
+SlaveReplicationState get_slave_replication_state(const std::string &master_executed,
+                                                  const std::string &master_purged,
+                                                  const std::string &slave_executed);
 ReplicationGroupState get_replication_group_state(mysqlsh::mysql::Connection* connection, GRInstanceType source_type);
 bool is_server_on_replication_group(mysqlsh::mysql::Connection* connection, const std::string &uuid);
 std::string get_plugin_status(mysqlsh::mysql::Connection *connection, std::string plugin_name);
@@ -40,9 +67,9 @@ bool SHCORE_PUBLIC get_server_variable(mysqlsh::mysql::Connection *connection, c
 void set_global_variable(mysqlsh::mysql::Connection *connection, const std::string &name, const std::string &value);
 bool get_status_variable(mysqlsh::mysql::Connection *connection, const std::string &name,
                          std::string &value, bool throw_on_error = true);
-bool is_gtid_subset(mysqlsh::mysql::Connection *connection, const std::string &subset, const std::string &set);
 shcore::Value get_master_status(mysqlsh::mysql::Connection *connection);
 std::vector<std::string> get_peer_seeds(mysqlsh::mysql::Connection *connection, const std::string &instance_host);
+shcore::Value::Map_type_ref get_member_stats(mysqlsh::mysql::Connection *connection);
 }
 }
 
@@ -30,6 +30,7 @@
 
 #include <boost/lexical_cast.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 #include <set>
 
 using namespace std::placeholders;
@@ -191,50 +192,63 @@ shcore::Value DatabaseObject::existsInDatabase(const shcore::Argument_list &args
   return ret_val;
 }
 
-void DatabaseObject::update_cache(const std::vector<std::string>& names, const std::function<shcore::Value(const std::string &name)>& generator, Cache target_cache, DatabaseObject* target) {
-  std::set<std::string> existing;
-
-  // Backups the existing items in the collection
-  shcore::Value::Map_type::iterator index, end = target_cache->end();
+void DatabaseObject::update_cache(const std::vector<std::string>& names, const Generator& UNUSED(generator), Cache target_cache, DatabaseObject* target) {
+  // Both sorted, so the new cache is built in a single pass over them and
+  // the objects are only created once they are used
+  std::vector<std::string> sorted(names);
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  shcore::Value::Map_type updated;
+  updated.reserve(sorted.size());
+
+  auto cached = target_cache->begin();
+  for (auto &name : sorted) {
+    // Removes no longer existing items
+    while (cached != target_cache->end() && cached->first < name) {
+      if (target)
+        target->delete_property(cached->first);
+      ++cached;
+    }
 
-  for (auto index = target_cache->begin(); index != end; index++)
-    existing.insert(index->first);
+    if (cached != target_cache->end() && cached->first == name) {
+      updated[name] = cached->second;
+      ++cached;
+      continue;
+    }
 
-  // Ensures the existing items are on the cache
-  for (auto name : names) {
-    if (existing.find(name) == existing.end()) {
-      (*target_cache)[name] = generator(name);
+    updated[name] = shcore::Value();
 
-      if (target && shcore::is_valid_identifier(name)) {
-        // Dynamic properties must keep the name as in the database
-        // i.e. Name must not change to match the python naming style
-        std::string names = name + "|" + name;
-        target->add_property(names);
-      }
+    if (target && shcore::is_valid_identifier(name)) {
+      // Dynamic properties must keep the name as in the database
+      // i.e. Name must not change to match the python naming style
+      std::string names = name + "|" + name;
+      target->add_property(names);
     }
-
-    else
-      existing.erase(name);
   }
 
-  // Removes no longer existing items
-  for (auto name : existing) {
-    target_cache->erase(name);
-
+  for (; cached != target_cache->end(); ++cached) {
     if (target)
-      target->delete_property(name);
+      target->delete_property(cached->first);
   }
+
+  *target_cache = std::move(updated);
 }
 
-void DatabaseObject::update_cache(const std::string& name, const std::function<shcore::Value(const std::string &name)>& generator, bool exists, Cache target_cache, DatabaseObject* target) {
-  if (exists && target_cache->find(name) == target_cache->end()) {
+void DatabaseObject::update_cache(const std::string& name, const Generator& generator, bool exists, Cache target_cache, DatabaseObject* target) {
+  auto cached = target_cache->find(name);
+
+  if (exists && cached == target_cache->end()) {
     (*target_cache)[name] = generator(name);
 
     if (target && shcore::is_valid_identifier(name))
       target->add_property(name);
+  } else if (exists && !cached->second) {
+    // Placeholder left by a full update
+    cached->second = generator(name);
   }
 
-  if (!exists && target_cache->find(name) != target_cache->end()) {
+  if (!exists && cached != target_cache->end()) {
     target_cache->erase(name);
 
     if (target)
@@ -242,24 +256,32 @@ void DatabaseObject::update_cache(const std::string& name, const std::function<s
   }
 }
 
-void DatabaseObject::get_object_list(Cache target_cache, shcore::Value::Array_type_ref list) {
-  for (auto entry : *target_cache)
+void DatabaseObject::get_object_list(Cache target_cache, const Generator& generator, shcore::Value::Array_type_ref list) {
+  for (auto &entry : *target_cache) {
+    if (!entry.second)
+      entry.second = generator(entry.first);
+
     list->push_back(entry.second);
+  }
 }
 
-shcore::Value DatabaseObject::find_in_cache(const std::string& name, Cache target_cache) {
-  Value::Map_type::const_iterator iter = target_cache->find(name);
-  if (iter != target_cache->end())
+shcore::Value DatabaseObject::find_in_cache(const std::string& name, const Generator& generator, Cache target_cache) {
+  Value::Map_type::iterator iter = target_cache->find(name);
+  if (iter != target_cache->end()) {
+    if (!iter->second)
+      iter->second = generator(name);
+
     return Value(std::shared_ptr<Object_bridge>(iter->second.as_object()));
-  else
+  } else {
     return Value();
+  }
 }
 
 bool DatabaseObject::is_base_member(const std::string &prop) const {
   auto style = naming_style;
-  auto method_index = std::find_if(_funcs.begin(), _funcs.end(), [prop, style](const FunctionEntry &f) { return f.second->name(style) == prop; });
+  auto method_index = find_function(prop, style);
 
-  auto prop_index = std::find_if(_properties.begin(), _properties.begin() + (_base_property_count - 1), [prop, style](std::shared_ptr<Cpp_property_name> p) { return p->name(style) == prop; });
+  auto prop_index = std::find_if(_properties.begin(), _properties.begin() + (_base_property_count - 1), [&prop, &style](const std::shared_ptr<Cpp_property_name> &p) { return p->name(style) == prop; });
 
   return (method_index != _funcs.end() || prop_index != _properties.begin() + (_base_property_count - 1));
 }
@@ -86,11 +86,14 @@ private:
   void init();
   // Handling of database object caches
 public:
+  // The objects of the names loaded in bulk are only created when accessed,
+  // until then the name holds an undefined value
   typedef std::shared_ptr<shcore::Value::Map_type> Cache;
-  static void update_cache(const std::vector<std::string>& names, const std::function<shcore::Value(const std::string &name)>& generator, Cache target_cache, DatabaseObject* target = NULL);
-  static void update_cache(const std::string& name, const std::function<shcore::Value(const std::string &name)>& generator, bool exists, Cache target_cache, DatabaseObject* target = NULL);
-  static void get_object_list(Cache target_cache, shcore::Value::Array_type_ref list);
-  static shcore::Value find_in_cache(const std::string& name, Cache target_cache);
+  typedef std::function<shcore::Value(const std::string &name)> Generator;
+  static void update_cache(const std::vector<std::string>& names, const Generator& generator, Cache target_cache, DatabaseObject* target = NULL);
+  static void update_cache(const std::string& name, const Generator& generator, bool exists, Cache target_cache, DatabaseObject* target = NULL);
+  static void get_object_list(Cache target_cache, const Generator& generator, shcore::Value::Array_type_ref list);
+  static shcore::Value find_in_cache(const std::string& name, const Generator& generator, Cache target_cache);
   virtual void update_cache() {}
 };
 };
@@ -23,241 +23,86 @@
 #include "shellcore/shell_core.h"
 #include "shellcore/lang_base.h"
 #include "shellcore/common.h"
+#include "shellcore/shell_core_options.h"
 #include "utils/utils_general.h"
+#include "utils/utils_file.h"
+#include "mysqlxtest_utils.h"
+
+#include <algorithm>
+#include <cstdio>
 
 using namespace mysqlsh;
 using namespace shcore;
 
-const Charset::Charset_entry Charset::item[] = {
-  {0, "", ""},
-  {1, "big5", "big5_chinese_ci"},
-  {2, "latin2", "latin2_czech_cs"},
-  {3, "dec8", "dec8_swedish_ci"},
-  {4, "cp850", "cp850_general_ci"},
-  {5, "latin1", "latin1_german1_ci"},
-  {6, "hp8", "hp8_english_ci"},
-  {7, "koi8r", "koi8r_general_ci"},
-  {8, "latin1", "latin1_swedish_ci"},
-  {9, "latin2", "latin2_general_ci"},
-  {10, "swe7", "swe7_swedish_ci"},
-  {11, "ascii", "ascii_general_ci"},
-  {12, "ujis", "ujis_japanese_ci"},
-  {13, "sjis", "sjis_japanese_ci"},
-  {14, "cp1251", "cp1251_bulgarian_ci"},
-  {15, "latin1", "latin1_danish_ci"},
-  {16, "hebrew", "hebrew_general_ci"},
-  {18, "tis620", "tis620_thai_ci"},
-  {19, "euckr", "euckr_korean_ci"},
-  {20, "latin7", "latin7_estonian_cs"},
-  {21, "latin2", "latin2_hungarian_ci"},
-  {22, "koi8u", "koi8u_general_ci"},
-  {23, "cp1251", "cp1251_ukrainian_ci"},
-  {24, "gb2312", "gb2312_chinese_ci"},
-  {25, "greek", "greek_general_ci"},
-  {26, "cp1250", "cp1250_general_ci"},
-  {27, "latin2", "latin2_croatian_ci"},
-  {28, "gbk", "gbk_chinese_ci"},
-  {29, "cp1257", "cp1257_lithuanian_ci"},
-  {30, "latin5", "latin5_turkish_ci"},
-  {31, "latin1", "latin1_german2_ci"},
-  {32, "armscii8", "armscii8_general_ci"},
-  {33, "utf8", "utf8_general_ci"},
-  {34, "cp1250", "cp1250_czech_cs"},
-  {35, "ucs2", "ucs2_general_ci"},
-  {36, "cp866", "cp866_general_ci"},
-  {37, "keybcs2", "keybcs2_general_ci"},
-  {38, "macce", "macce_general_ci"},
-  {39, "macroman", "macroman_general_ci"},
-  {40, "cp852", "cp852_general_ci"},
-  {41, "latin7", "latin7_general_ci"},
-  {42, "latin7", "latin7_general_cs"},
-  {43, "macce", "macce_bin"},
-  {44, "cp1250", "cp1250_croatian_ci"},
-  {45, "utf8mb4", "utf8mb4_general_ci"},
-  {46, "utf8mb4", "utf8mb4_bin"},
-  {47, "latin1", "latin1_bin"},
-  {48, "latin1", "latin1_general_ci"},
-  {49, "latin1", "latin1_general_cs"},
-  {50, "cp1251", "cp1251_bin"},
-  {51, "cp1251", "cp1251_general_ci"},
-  {52, "cp1251", "cp1251_general_cs"},
-  {53, "macroman", "macroman_bin"},
-  {54, "utf16", "utf16_general_ci"},
-  {55, "utf16", "utf16_bin"},
-  {56, "utf16le", "utf16le_general_ci"},
-  {57, "cp1256", "cp1256_general_ci"},
-  {58, "cp1257", "cp1257_bin"},
-  {59, "cp1257", "cp1257_general_ci"},
-  {60, "utf32", "utf32_general_ci"},
-  {61, "utf32", "utf32_bin"},
-  {62, "utf16le", "utf16le_bin"},
-  {63, "binary", "binary"},
-  {64, "armscii8", "armscii8_bin"},
-  {65, "ascii", "ascii_bin"},
-  {66, "cp1250", "cp1250_bin"},
-  {67, "cp1256", "cp1256_bin"},
-  {68, "cp866", "cp866_bin"},
-  {69, "dec8", "dec8_bin"},
-  {70, "greek", "greek_bin"},
-  {71, "hebrew", "hebrew_bin"},
-  {72, "hp8", "hp8_bin"},
-  {73, "keybcs2", "keybcs2_bin"},
-  {74, "koi8r", "koi8r_bin"},
-  {75, "koi8u", "koi8u_bin"},
-  {77, "latin2", "latin2_bin"},
-  {78, "latin5", "latin5_bin"},
-  {79, "latin7", "latin7_bin"},
-  {80, "cp850", "cp850_bin"},
-  {81, "cp852", "cp852_bin"},
-  {82, "swe7", "swe7_bin"},
-  {83, "utf8", "utf8_bin"},
-  {84, "big5", "big5_bin"},
-  {85, "euckr", "euckr_bin"},
-  {86, "gb2312", "gb2312_bin"},
-  {87, "gbk", "gbk_bin"},
-  {88, "sjis", "sjis_bin"},
-  {89, "tis620", "tis620_bin"},
-  {90, "ucs2", "ucs2_bin"},
-  {91, "ujis", "ujis_bin"},
-  {92, "geostd8", "geostd8_general_ci"},
-  {93, "geostd8", "geostd8_bin"},
-  {94, "latin1", "latin1_spanish_ci"},
-  {95, "cp932", "cp932_japanese_ci"},
-  {96, "cp932", "cp932_bin"},
-  {97, "eucjpms", "eucjpms_japanese_ci"},
-  {98, "eucjpms", "eucjpms_bin"},
-  {99, "cp1250", "cp1250_polish_ci"},
-  {101, "utf16", "utf16_unicode_ci"},
-  {102, "utf16", "utf16_icelandic_ci"},
-  {103, "utf16", "utf16_latvian_ci"},
-  {104, "utf16", "utf16_romanian_ci"},
-  {105, "utf16", "utf16_slovenian_ci"},
-  {106, "utf16", "utf16_polish_ci"},
-  {107, "utf16", "utf16_estonian_ci"},
-  {108, "utf16", "utf16_spanish_ci"},
-  {109, "utf16", "utf16_swedish_ci"},
-  {110, "utf16", "utf16_turkish_ci"},
-  {111, "utf16", "utf16_czech_ci"},
-  {112, "utf16", "utf16_danish_ci"},
-  {113, "utf16", "utf16_lithuanian_ci"},
-  {114, "utf16", "utf16_slovak_ci"},
-  {115, "utf16", "utf16_spanish2_ci"},
-  {116, "utf16", "utf16_roman_ci"},
-  {117, "utf16", "utf16_persian_ci"},
-  {118, "utf16", "utf16_esperanto_ci"},
-  {119, "utf16", "utf16_hungarian_ci"},
-  {120, "utf16", "utf16_sinhala_ci"},
-  {121, "utf16", "utf16_german2_ci"},
-  {122, "utf16", "utf16_croatian_ci"},
-  {123, "utf16", "utf16_unicode_520_ci"},
-  {124, "utf16", "utf16_vietnamese_ci"},
-  {128, "ucs2", "ucs2_unicode_ci"},
-  {129, "ucs2", "ucs2_icelandic_ci"},
-  {130, "ucs2", "ucs2_latvian_ci"},
-  {131, "ucs2", "ucs2_romanian_ci"},
-  {132, "ucs2", "ucs2_slovenian_ci"},
-  {133, "ucs2", "ucs2_polish_ci"},
-  {134, "ucs2", "ucs2_estonian_ci"},
-  {135, "ucs2", "ucs2_spanish_ci"},
-  {136, "ucs2", "ucs2_swedish_ci"},
-  {137, "ucs2", "ucs2_turkish_ci"},
-  {138, "ucs2", "ucs2_czech_ci"},
-  {139, "ucs2", "ucs2_danish_ci"},
-  {140, "ucs2", "ucs2_lithuanian_ci"},
-  {141, "ucs2", "ucs2_slovak_ci"},
-  {142, "ucs2", "ucs2_spanish2_ci"},
-  {143, "ucs2", "ucs2_roman_ci"},
-  {144, "ucs2", "ucs2_persian_ci"},
-  {145, "ucs2", "ucs2_esperanto_ci"},
-  {146, "ucs2", "ucs2_hungarian_ci"},
-  {147, "ucs2", "ucs2_sinhala_ci"},
-  {148, "ucs2", "ucs2_german2_ci"},
-  {149, "ucs2", "ucs2_croatian_ci"},
-  {150, "ucs2", "ucs2_unicode_520_ci"},
-  {151, "ucs2", "ucs2_vietnamese_ci"},
-  {159, "ucs2", "ucs2_general_mysql500_ci"},
-  {160, "utf32", "utf32_unicode_ci"},
-  {161, "utf32", "utf32_icelandic_ci"},
-  {162, "utf32", "utf32_latvian_ci"},
-  {163, "utf32", "utf32_romanian_ci"},
-  {164, "utf32", "utf32_slovenian_ci"},
-  {165, "utf32", "utf32_polish_ci"},
-  {166, "utf32", "utf32_estonian_ci"},
-  {167, "utf32", "utf32_spanish_ci"},
-  {168, "utf32", "utf32_swedish_ci"},
-  {169, "utf32", "utf32_turkish_ci"},
-  {170, "utf32", "utf32_czech_ci"},
-  {171, "utf32", "utf32_danish_ci"},
-  {172, "utf32", "utf32_lithuanian_ci"},
-  {173, "utf32", "utf32_slovak_ci"},
-  {174, "utf32", "utf32_spanish2_ci"},
-  {175, "utf32", "utf32_roman_ci"},
-  {176, "utf32", "utf32_persian_ci"},
-  {177, "utf32", "utf32_esperanto_ci"},
-  {178, "utf32", "utf32_hungarian_ci"},
-  {179, "utf32", "utf32_sinhala_ci"},
-  {180, "utf32", "utf32_german2_ci"},
-  {181, "utf32", "utf32_croatian_ci"},
-  {182, "utf32", "utf32_unicode_520_ci"},
-  {183, "utf32", "utf32_vietnamese_ci"},
-  {192, "utf8", "utf8_unicode_ci"},
-  {193, "utf8", "utf8_icelandic_ci"},
-  {194, "utf8", "utf8_latvian_ci"},
-  {195, "utf8", "utf8_romanian_ci"},
-  {196, "utf8", "utf8_slovenian_ci"},
-  {197, "utf8", "utf8_polish_ci"},
-  {198, "utf8", "utf8_estonian_ci"},
-  {199, "utf8", "utf8_spanish_ci"},
-  {200, "utf8", "utf8_swedish_ci"},
-  {201, "utf8", "utf8_turkish_ci"},
-  {202, "utf8", "utf8_czech_ci"},
-  {203, "utf8", "utf8_danish_ci"},
-  {204, "utf8", "utf8_lithuanian_ci"},
-  {205, "utf8", "utf8_slovak_ci"},
-  {206, "utf8", "utf8_spanish2_ci"},
-  {207, "utf8", "utf8_roman_ci"},
-  {208, "utf8", "utf8_persian_ci"},
-  {209, "utf8", "utf8_esperanto_ci"},
-  {210, "utf8", "utf8_hungarian_ci"},
-  {211, "utf8", "utf8_sinhala_ci"},
-  {212, "utf8", "utf8_german2_ci"},
-  {213, "utf8", "utf8_croatian_ci"},
-  {214, "utf8", "utf8_unicode_520_ci"},
-  {215, "utf8", "utf8_vietnamese_ci"},
-  {223, "utf8", "utf8_general_mysql500_ci"},
-  {224, "utf8mb4", "utf8mb4_unicode_ci"},
-  {225, "utf8mb4", "utf8mb4_icelandic_ci"},
-  {226, "utf8mb4", "utf8mb4_latvian_ci"},
-  {227, "utf8mb4", "utf8mb4_romanian_ci"},
-  {228, "utf8mb4", "utf8mb4_slovenian_ci"},
-  {229, "utf8mb4", "utf8mb4_polish_ci"},
-  {230, "utf8mb4", "utf8mb4_estonian_ci"},
-  {231, "utf8mb4", "utf8mb4_spanish_ci"},
-  {232, "utf8mb4", "utf8mb4_swedish_ci"},
-  {233, "utf8mb4", "utf8mb4_turkish_ci"},
-  {234, "utf8mb4", "utf8mb4_czech_ci"},
-  {235, "utf8mb4", "utf8mb4_danish_ci"},
-  {236, "utf8mb4", "utf8mb4_lithuanian_ci"},
-  {237, "utf8mb4", "utf8mb4_slovak_ci"},
-  {238, "utf8mb4", "utf8mb4_spanish2_ci"},
-  {239, "utf8mb4", "utf8mb4_roman_ci"},
-  {240, "utf8mb4", "utf8mb4_persian_ci"},
-  {241, "utf8mb4", "utf8mb4_esperanto_ci"},
-  {242, "utf8mb4", "utf8mb4_hungarian_ci"},
-  {243, "utf8mb4", "utf8mb4_sinhala_ci"},
-  {244, "utf8mb4", "utf8mb4_german2_ci"},
-  {245, "utf8mb4", "utf8mb4_croatian_ci"},
-  {246, "utf8mb4", "utf8mb4_unicode_520_ci"},
-  {247, "utf8mb4", "utf8mb4_vietnamese_ci"},
-  {248, "gb18030", "gb18030_chinese_ci"},
-  {249, "gb18030", "gb18030_bin"},
-  {250, "gb18030", "gb18030_unicode_520_ci"}
-};
+ShellBaseResult::~ShellBaseResult() {
+  record_timing();
+}
 
 bool ShellBaseResult::operator == (const Object_bridge &other) const {
   return this == &other;
 }
 
+void ShellBaseResult::set_statement(const std::string &statement, uint64_t server_time) {
+  _timing.digest = Statement_stats::digest(statement);
+  _timing.phases[Statement_timing::Server] = server_time;
+}
+
+void ShellBaseResult::watch_slow(const std::string &statement, uint64_t server_time,
+                                 const Slow_statement_log::Explain &explain) {
+  _slow_statement = statement;
+  _timing.phases[Statement_timing::Server] = server_time;
+  _explain = explain;
+}
+
+void ShellBaseResult::record_timing() const {
+  // Each statement is accounted once
+  if (!_timing.digest.empty()) {
+    Statement_stats::get().record(_timing);
+    _timing.digest.clear();
+  }
+
+  if (!_slow_statement.empty()) {
+    try {
+      Slow_statement_log::get().log(_slow_statement, _timing, rows_read(), _explain);
+    } catch (...) {
+      // The log never fails the statement
+    }
+    _slow_statement.clear();
+  }
+}
+
+shcore::Value ShellBaseResult::to_arrow(const shcore::Argument_list &args) const {
+  args.ensure_count(1, get_function_name("toArrow").c_str());
+
+  size_t row_count = 0;
+  try {
+    std::string path = args.string_at(0);
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+      throw shcore::Exception::runtime_error("Unable to open file '" + path + "': " + get_last_error());
+
+    bool failed = false;
+    bool supported = dump_arrow([file, &failed](const char *data, size_t size) {
+      if (!failed && fwrite(data, 1, size, file) != size)
+        failed = true;
+    }, row_count);
+
+    if (fclose(file) != 0)
+      failed = true;
+
+    if (!supported) {
+      std::remove(path.c_str());
+      throw shcore::Exception::runtime_error("The result can not be written as Arrow");
+    }
+
+    if (failed)
+      throw shcore::Exception::runtime_error("Unable to write to file '" + path + "': " + get_last_error());
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("toArrow"));
+
+  return shcore::Value(static_cast<uint64_t>(row_count));
+}
+
 Column::Column(const std::string& schema, const std::string& table_name, const std::string& table_label, const std::string& column_name, const std::string& column_label,
        shcore::Value type, uint64_t length, bool numeric, uint64_t fractional, bool is_signed, const std::string &collation, const std::string &charset, bool padded) :
         _schema(schema), _table_name(table_name), _table_label(table_label), _column_name(column_name), _column_label(column_label), _collation(collation), _charset(charset),
@@ -332,16 +177,78 @@ shcore::Value Column::get_member(const std::string &prop) const {
   return ret_val;
 }
 
-Row::Row() {
+void mysqlsh::append_binary(std::string &out, const char *data, size_t length) {
+  switch (shcore::Shell_core_options::typed().binary_as) {
+    case shcore::Typed_core_options::Binary_format::Hex:
+      shcore::append_hex(out, data, length);
+      break;
+    case shcore::Typed_core_options::Binary_format::Base64:
+      shcore::append_base64(out, data, length);
+      break;
+    case shcore::Typed_core_options::Binary_format::Raw:
+      out.append(data, length);
+      break;
+  }
+}
+
+Row_columns::Row_columns() : _columns(new shcore::Value::Array_type()) {
+}
+
+void Row_columns::add(const std::string &name, shcore::Value column, bool binary) {
+  // Only used to know the members every row has
+  static const Row base_row;
+
+  _names.push_back(name);
+  _binary.push_back(binary);
+
+  if (column)
+    _columns->push_back(column);
+
+  // Values would be retrievable with getMember if the name
+  // is an existing member as long as the name is not duplicate
+  if (_index.find(name) != _index.end())
+    return;
+
+  _index[name] = _names.size() - 1;
+
+  // Values would be available as properties if they are valid identifier
+  // and not base members like lenght and getField
+  // O on this case the values would be available as
+  // row.property
+  if (shcore::is_valid_identifier(name) && !base_row.has_member(name))
+    _properties.push_back(std::shared_ptr<shcore::Cpp_property_name>(new shcore::Cpp_property_name(name)));
+}
+
+bool Row_columns::find(const std::string &name, size_t *index) const {
+  auto iter = _index.find(name);
+  if (iter == _index.end())
+    return false;
+
+  *index = iter->second;
+  return true;
+}
+
+Row::Row() : Row(std::shared_ptr<Row_columns>(new Row_columns())) {
+}
+
+Row::Row(std::shared_ptr<Row_columns> columns) : _columns(columns) {
   add_property("length", "getLength");
   add_method("getField", std::bind(&Row::get_field, this, _1), "field", shcore::String, NULL);
   add_method("getLength", std::bind(&Row::get_member_method, this, _1, "getLength", "length"), NULL);
+  add_method("readField", std::bind(&Row::read_field, this, _1), "field", shcore::Undefined, "offset", shcore::Integer, "length", shcore::Integer, NULL);
+  add_method("writeFieldTo", std::bind(&Row::write_field_to, this, _1), "field", shcore::Undefined, "path", shcore::String, NULL);
+
+  // The properties are shared, only the pointers are copied
+  _properties.insert(_properties.end(), _columns->_properties.begin(), _columns->_properties.end());
+
+  _value_array.reserve(_columns->size());
+  _loaded.reserve(_columns->size());
 }
 
 std::string &Row::append_descr(std::string &s_out, int indent, int UNUSED(quote_strings)) const {
   std::string nl = (indent >= 0) ? "\n" : "";
   s_out += "[";
-  for (size_t index = 0; index < value_array.size(); index++) {
+  for (size_t index = 0; index < _columns->size(); index++) {
     if (index > 0)
       s_out += ",";
 
@@ -350,7 +257,7 @@ std::string &Row::append_descr(std::string &s_out, int indent, int UNUSED(quote_
     if (indent >= 0)
       s_out.append((indent + 1) * 4, ' ');
 
-    value_array[index].append_descr(s_out, indent < 0 ? indent : indent + 1, '"');
+    get_value(index).append_descr(s_out, indent < 0 ? indent : indent + 1, '"');
   }
 
   s_out += nl;
@@ -363,14 +270,44 @@ std::string &Row::append_descr(std::string &s_out, int indent, int UNUSED(quote_
 }
 
 void Row::append_json(shcore::JSON_dumper& dumper) const {
+  bool encode = shcore::Shell_core_options::typed().binary_as != shcore::Typed_core_options::Binary_format::Raw;
+  std::string text;
+
   dumper.start_object();
 
-  for (size_t index = 0; index < value_array.size(); index++)
-    dumper.append_value(names[index], value_array[index]);
+  for (size_t index = 0; index < _columns->size(); index++) {
+    size_t length;
+    const char *data;
+    if (encode && _columns->is_binary(index) && (data = field_data(index, text, length))) {
+      std::string encoded;
+      append_binary(encoded, data, length);
+      dumper.append_value(_columns->name(index), shcore::Value(std::move(encoded)));
+    } else if (raw_data(index, data, length)) {
+      dumper.append_string(_columns->name(index), data, length);
+    } else {
+      dumper.append_value(_columns->name(index), get_value(index));
+    }
+  }
 
   dumper.end_object();
 }
 
+std::string &Row::append_field(std::string &s_out, size_t index) const {
+  size_t length;
+  const char *data;
+  std::string text;
+  if (_columns->is_binary(index) &&
+      shcore::Shell_core_options::typed().binary_as != shcore::Typed_core_options::Binary_format::Raw &&
+      (data = field_data(index, text, length)))
+    append_binary(s_out, data, length);
+  else if (raw_data(index, data, length))
+    s_out.append(data, length);
+  else
+    get_value(index).append_descr(s_out);
+
+  return s_out;
+}
+
 std::string &Row::append_repr(std::string &s_out) const {
   return append_descr(s_out);
 }
@@ -401,13 +338,135 @@ shcore::Value Row::get_field(const shcore::Argument_list &args) {
 }
 
 shcore::Value Row::get_field_(const std::string &field) {
-  auto iter = values.find(field);
-  if (iter != values.end())
-    return iter->second;
+  size_t index;
+  if (_columns->find(field, &index))
+    return get_value(index);
   else
     throw shcore::Exception::argument_error("Row.getField: Field " + field + " does not exist");
 }
 
+//! Returns a part of the data of a field.
+#if DOXYGEN_CPP
+//! \param args : Should contain the name or position of the field, the offset and the length of the part
+#else
+//! \param field : The name or position of the field.
+//! \param offset : The position of the first byte of the part.
+//! \param length : The maximum number of bytes of the part.
+#endif
+/**
+ * The data is taken as received from the server when the field is a BLOB
+ * or TEXT, so a large value can be read in parts without converting it
+ * first. Other fields are read from their value as a string. Returns null
+ * if the field is NULL and an empty string past the end of the data.
+ */
+#if DOXYGEN_JS
+String Row::readField(Any field, Integer offset, Integer length) {}
+#elif DOXYGEN_PY
+str Row::read_field(any field, int offset, int length) {}
+#endif
+shcore::Value Row::read_field(const shcore::Argument_list &args) {
+  args.ensure_count(3, "Row.readField");
+
+  size_t index = field_index(args[0], "Row.readField");
+  uint64_t offset = args.uint_at(1);
+  uint64_t length = args.uint_at(2);
+
+  std::string text;
+  size_t size;
+  const char *data = field_data(index, text, size);
+  if (!data)
+    return shcore::Value::Null();
+
+  if (offset >= size)
+    return shcore::Value("");
+
+  return shcore::Value(data + offset, static_cast<size_t>(std::min<uint64_t>(length, size - offset)));
+}
+
+//! Writes the data of a field to a file.
+#if DOXYGEN_CPP
+//! \param args : Should contain the name or position of the field and the path of the file
+#else
+//! \param field : The name or position of the field.
+//! \param path : The file to be written.
+#endif
+/**
+ * A BLOB or TEXT field is written as received from the server, without
+ * converting it into a value. The file is left empty if the field is NULL.
+ * Returns the number of bytes written.
+ */
+#if DOXYGEN_JS
+Integer Row::writeFieldTo(Any field, String path) {}
+#elif DOXYGEN_PY
+int Row::write_field_to(any field, str path) {}
+#endif
+shcore::Value Row::write_field_to(const shcore::Argument_list &args) {
+  args.ensure_count(2, "Row.writeFieldTo");
+
+  size_t index = field_index(args[0], "Row.writeFieldTo");
+  std::string path = args.string_at(1);
+
+  std::string text;
+  size_t size = 0;
+  const char *data = field_data(index, text, size);
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    throw shcore::Exception::runtime_error("Row.writeFieldTo: Unable to open file '" + path + "': " + get_last_error());
+
+  bool failed = data && size && fwrite(data, 1, size, file) != size;
+  if (fclose(file) != 0)
+    failed = true;
+
+  if (failed)
+    throw shcore::Exception::runtime_error("Row.writeFieldTo: Unable to write to file '" + path + "': " + get_last_error());
+
+  return shcore::Value(static_cast<uint64_t>(data ? size : 0));
+}
+
+size_t Row::field_index(const shcore::Value &field, const std::string &function) const {
+  size_t index;
+  if (field.type == shcore::String) {
+    if (!_columns->find(field.as_string(), &index))
+      throw shcore::Exception::argument_error(function + ": Field " + field.as_string() + " does not exist");
+  } else if (field.type == shcore::Integer || field.type == shcore::UInteger) {
+    index = static_cast<size_t>(field.as_uint());
+    if (index >= _columns->size())
+      throw shcore::Exception::argument_error(function + ": Field " + field.descr() + " does not exist");
+  } else {
+    throw shcore::Exception::argument_error(function + ": Argument #1 is expected to be a string or an integer");
+  }
+
+  return index;
+}
+
+// The strings are taken from the data the row was received in until they
+// are loaded, so printing them does not copy them into values first
+bool Row::raw_data(size_t index, const char *&data, size_t &length) const {
+  return !_loaded[index] && _raw_field && _raw_field(index, data, length);
+}
+
+// The raw data if the row has it and the field was not loaded yet, then the
+// loaded string without copying it, NULL for a NULL field
+const char *Row::field_data(size_t index, std::string &text, size_t &length) const {
+  const char *data;
+  if (raw_data(index, data, length))
+    return data;
+
+  const shcore::Value &value = get_value(index);
+  if (value.type == shcore::Null)
+    return NULL;
+
+  if (value.type == shcore::String) {
+    length = value.as_string().size();
+    return value.as_string().data();
+  }
+
+  text = value.descr();
+  length = text.size();
+  return text.data();
+}
+
 #if DOXYGEN_CPP
 /**
  * Use this function to retrieve an valid member of this class exposed to the scripting languages.
@@ -432,11 +491,11 @@ int Row::get_length() {}
 #endif
 shcore::Value Row::get_member(const std::string &prop) const {
   if (prop == "length")
-    return shcore::Value((int)value_array.size());
+    return shcore::Value((int)_columns->size());
   else {
-    std::map<std::string, shcore::Value>::const_iterator it;
-    if ((it = values.find(prop)) != values.end())
-      return it->second;
+    size_t index;
+    if (_columns->find(prop, &index))
+      return get_value(index);
   }
 
   return shcore::Cpp_object_bridge::get_member(prop);
@@ -448,26 +507,58 @@ shcore::Value Row::get_member(const std::string &prop) const {
  */
 #endif
 shcore::Value Row::get_member(size_t index) const {
-  if (index < value_array.size())
-    return value_array[index];
+  if (index < _columns->size())
+    return get_value(index);
   else
     return shcore::Value();
 }
 
 void Row::add_item(const std::string &key, shcore::Value value) {
-  // All the values are available through index
-  value_array.push_back(value);
-  names.push_back(key);
+  add_name(key);
+  add_value(std::move(value));
+}
 
-  // Values would be available as properties if they are valid identifier
-  // and not base members like lenght and getField
-  // O on this case the values would be available as
-  // row.property
-  if (shcore::is_valid_identifier(key) && !has_member(key))
-    add_property(key);
+void Row::add_value(shcore::Value value) {
+  _value_array.push_back(std::move(value));
+  _loaded.push_back(true);
+}
 
-  // Values would be retrievable with getMember if the name
-  // is an existing member as long as the name is not duplicate
-  if (values.find(key) == values.end())
-    values[key] = value;
+void Row::add_lazy_item(const std::string &key) {
+  add_name(key);
+  add_lazy_value();
+}
+
+void Row::add_lazy_value() {
+  _value_array.push_back(shcore::Value());
+  _loaded.push_back(false);
+}
+
+size_t Row::memory_size() const {
+  size_t size = sizeof(Row) + _value_array.capacity() * sizeof(shcore::Value);
+  for (auto &value : _value_array) {
+    if (value.type == shcore::String)
+      size += value.as_string().capacity();
+  }
+  return size;
+}
+
+const shcore::Value &Row::get_value(size_t index) const {
+  if (!_loaded[index]) {
+    _value_array[index] = _field_loader(index);
+    _loaded[index] = true;
+  }
+
+  return _value_array[index];
+}
+
+void Row::add_name(const std::string &key) {
+  // The columns of a result set are never changed through its rows
+  if (_columns.use_count() > 1)
+    _columns.reset(new Row_columns(*_columns));
+
+  size_t properties = _columns->_properties.size();
+  _columns->add(key);
+
+  if (_columns->_properties.size() > properties)
+    _properties.push_back(_columns->_properties.back());
 }
@@ -26,11 +26,16 @@
 #include "mod_common.h"
 #include "shellcore/types.h"
 #include "shellcore/types_cpp.h"
+#include "utils/utils_arrow.h"
+#include "utils/utils_stats.h"
 
 namespace mysqlsh {
 // This is the Shell Common Base Class for all the resultset classes
 class ShellBaseResult : public shcore::Cpp_object_bridge {
 public:
+  ShellBaseResult() : _hold_timing(false) {}
+  virtual ~ShellBaseResult();
+
   virtual bool operator == (const Object_bridge &other) const;
 
   // Doing nothing by default to avoid impacting the classic result
@@ -38,18 +43,47 @@ public:
   virtual bool rewind() { return false; }
   virtual bool tell(size_t &dataset, size_t &record) { return false; }
   virtual bool seek(size_t dataset, size_t record) { return false; }
-};
-
-class SHCORE_PUBLIC Charset {
-private:
-  typedef struct {
-    uint32_t id;
-    std::string name;
-    std::string collation;
-  } Charset_entry;
 
-public:
-  static const Charset_entry item[];
+  // Appends the remaining records of the active data set to the buffer as
+  // tab separated text, formatted from the protocol data instead of creating
+  // values for them, calling flush after each record. Returns false without
+  // reading anything if the result does not support it.
+  typedef std::function<void(std::string &buffer)> Raw_flush;
+  virtual bool dump_raw(std::string &buffer, const Raw_flush &flush, size_t &row_count) const { return false; }
+
+  // Writes the remaining records of the active data set as an Arrow IPC
+  // stream. Returns false without reading anything if the result does not
+  // support it.
+  virtual bool dump_arrow(const shcore::Arrow_stream_writer::Output &output, size_t &row_count) const { return false; }
+
+  // toArrow(path), writes the remaining records to the file with dump_arrow()
+  shcore::Value to_arrow(const shcore::Argument_list &args) const;
+
+  // Latencies of the SQL statement that produced the result, they are added
+  // to the statement stats once the whole result is read or it is released,
+  // unless they are held by whoever is consuming the result
+  void set_statement(const std::string &statement, uint64_t server_time);
+  shcore::Statement_timing &timing() const { return _timing; }
+  void hold_timing(bool hold) const { _hold_timing = hold; }
+  void record_timing() const;
+
+  // Keeps the statement for the slow statement log, checked once the
+  // timing is recorded, explain being called only if it was slow
+  void watch_slow(const std::string &statement, uint64_t server_time,
+                  const shcore::Slow_statement_log::Explain &explain);
+  // The rows read from the result so far
+  virtual uint64_t rows_read() const { return 0; }
+
+protected:
+  void end_of_data() const {
+    if (!_hold_timing)
+      record_timing();
+  }
+
+  mutable shcore::Statement_timing _timing;
+  mutable bool _hold_timing;
+  mutable std::string _slow_statement;
+  shcore::Slow_statement_log::Explain _explain;
 };
 
 /**
@@ -269,6 +303,43 @@ private:
  */
 #endif
 
+// Appends the bytes of a binary string field as the binaryAs option says, as
+// they are when it is raw
+void SHCORE_PUBLIC append_binary(std::string &out, const char *data, size_t length);
+
+// Description of the columns of a result set, built once and shared by all
+// of its rows, which hold only their values and reference the columns by
+// position
+class SHCORE_PUBLIC Row_columns {
+public:
+  Row_columns();
+
+  // The column object is the one returned on the columns of the result,
+  // binary is for the binary strings, printed as the binaryAs option says
+  void add(const std::string &name, shcore::Value column = shcore::Value(), bool binary = false);
+
+  size_t size() const { return _names.size(); }
+  const std::string &name(size_t index) const { return _names[index]; }
+  bool is_binary(size_t index) const { return _binary[index]; }
+  const std::vector<std::string> &names() const { return _names; }
+
+  // Position of the first column with the given name
+  bool find(const std::string &name, size_t *index) const;
+
+  shcore::Value::Array_type_ref columns() const { return _columns; }
+
+private:
+  friend class Row;
+
+  std::vector<std::string> _names;
+  std::vector<bool> _binary;
+  std::map<std::string, size_t> _index;
+
+  // The row properties of the names that are valid identifiers
+  std::vector<std::shared_ptr<shcore::Cpp_property_name> > _properties;
+  shcore::Value::Array_type_ref _columns;
+};
+
 class SHCORE_PUBLIC Row : public shcore::Cpp_object_bridge {
 public:
 #if DOXYGEN_JS
@@ -281,30 +352,80 @@ public:
 
   int get_length();
   Value get_field(str fieldName);
+#endif
+#if DOXYGEN_JS
+  String readField(Any field, Integer offset, Integer length);
+  Integer writeFieldTo(Any field, String path);
+#elif DOXYGEN_PY
+  str read_field(any field, int offset, int length);
+  int write_field_to(any field, str path);
 #endif
   Row();
+
+  // A row of a result set, its values are added in the order of the columns
+  explicit Row(std::shared_ptr<Row_columns> columns);
+
   virtual std::string class_name() const { return "Row"; }
 
-  std::map<std::string, shcore::Value> values;
-  std::vector<std::string> names;
-  shcore::Value::Array_type value_array;
+  // Decodes the value of the field at the given position, used by rows
+  // whose fields are only converted when they are first accessed
+  typedef std::function<shcore::Value(size_t index)> Field_loader;
+
+  // Points to the data of the field as received, without decoding it, for
+  // rows that keep it. Returns false if the field has to be decoded.
+  typedef std::function<bool(size_t index, const char *&data, size_t &length)> Raw_field;
 
   virtual std::string &append_descr(std::string &s_out, int indent = -1, int quote_strings = 0) const;
   virtual std::string &append_repr(std::string &s_out) const;
   virtual void append_json(shcore::JSON_dumper& dumper) const;
 
+  // The text of the field as printed on the results, the binary strings
+  // encoded from the bytes received as the binaryAs option says
+  std::string &append_field(std::string &s_out, size_t index) const;
+
   shcore::Value get_field(const shcore::Argument_list &args);
   shcore::Value get_field_(const std::string &field);
 
+  // readField(field, offset, length) and writeFieldTo(field, path), they
+  // take the bytes of a BLOB or TEXT field as received when possible
+  shcore::Value read_field(const shcore::Argument_list &args);
+  shcore::Value write_field_to(const shcore::Argument_list &args);
+
   virtual bool operator == (const Object_bridge &other) const;
 
   virtual shcore::Value get_member(const std::string &prop) const;
   shcore::Value get_member(size_t index) const;
 
-  size_t get_length() { return values.size(); }
+  size_t get_length() { return _columns->size(); }
   virtual bool is_indexed() const { return true; }
 
   void add_item(const std::string &key, shcore::Value value);
+  void add_value(shcore::Value value);
+
+  // Adds a field whose value is provided by the field loader
+  void add_lazy_item(const std::string &key);
+  void add_lazy_value();
+  void set_field_loader(const Field_loader &loader) { _field_loader = loader; }
+  void set_raw_field(const Raw_field &raw_field) { _raw_field = raw_field; }
+
+  const shcore::Value &get_value(size_t index) const;
+
+  // The memory held by the values loaded so far, the fields not loaded yet
+  // are kept by the result
+  size_t memory_size() const;
+
+private:
+  void add_name(const std::string &key);
+  size_t field_index(const shcore::Value &field, const std::string &function) const;
+  bool raw_data(size_t index, const char *&data, size_t &length) const;
+  const char *field_data(size_t index, std::string &text, size_t &length) const;
+
+  std::shared_ptr<Row_columns> _columns;
+
+  Field_loader _field_loader;
+  Raw_field _raw_field;
+  mutable shcore::Value::Array_type _value_array;
+  mutable std::vector<bool> _loaded;
 };
 };
 
@@ -48,10 +48,17 @@ using namespace shcore;
 
 std::shared_ptr<mysqlsh::ShellDevelopmentSession> mysqlsh::connect_session(
     const std::string &uri, const std::string &password, SessionType session_type) {
-  Argument_list args;
+  shcore::Connection_options options = shcore::Connection_options::parse(uri);
+  options.password = password;
+  options.has_password = true;
+
+  return connect_session(options, session_type);
+}
 
-  args.push_back(Value(shcore::get_connection_data(uri, true)));
-  (*args.map_at(0))["password"] = Value(password);
+std::shared_ptr<mysqlsh::ShellDevelopmentSession> mysqlsh::connect_session(
+    const shcore::Connection_options &options, SessionType session_type) {
+  Argument_list args;
+  args.push_back(Value(options.to_map()));
 
   return connect_session(args, session_type);
 }
@@ -430,6 +437,10 @@ void ShellDevelopmentSession::rollback() {
     execute_sql("rollback", shcore::Argument_list());
 }
 
+void ShellDevelopmentSession::reset_state() {
+  _tx_deep = 0;
+}
+
 // Returns a schema from the cache if found
 shcore::Value ShellDevelopmentSession::get_cached_schema(const std::string &name) {
   shcore::Value ret_val;
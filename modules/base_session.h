@@ -28,6 +28,8 @@
 #include "shellcore/types_cpp.h"
 #include "shellcore/ishell_core.h"
 #include "utils/utils_connection.h"
+#include "utils/utils_general.h"
+#include "utils/utils_stats.h"
 
 namespace mysqlsh {
 #if DOXYGEN_CPP
@@ -60,11 +62,21 @@ public:
 
   virtual void set_option(const char *option, int value) {}
   virtual uint64_t get_connection_id() const { return 0; }
+  // Kills the statement running on the session, from a connection of its
+  // own that is kept open for the next time
+  virtual void kill_query() {}
+  // Explains the statements logged as slow, on a session opened with the
+  // connection data of this one for each of them, as this one may be busy
+  // or gone by then
+  virtual shcore::Slow_statement_log::Explain slow_statement_explain() const { return nullptr; }
 
   std::string get_user() { return _user; }
   std::string get_password() { return _password; }
   virtual void reconnect();
 
+  // Lightweight round trip to verify the connection is still alive
+  virtual bool ping() { return is_connected(); }
+
   virtual int get_default_port() = 0;
 
   std::string get_ssl_ca() { return _ssl_info.ca; }
@@ -119,6 +131,10 @@ public:
   void start_transaction();
   void commit();
   void rollback();
+  // Clears the state of the session on the server keeping the connection:
+  // the open transaction is rolled back and the variables, temporary tables
+  // and prepared statements are gone, as on a new session
+  virtual void reset_state();
   std::string get_default_schema() { return _default_schema; }
 protected:
   std::string _default_schema;
@@ -132,6 +148,7 @@ private:
 
 std::shared_ptr<mysqlsh::ShellDevelopmentSession> SHCORE_PUBLIC connect_session(const shcore::Argument_list &args, SessionType session_type);
 std::shared_ptr<mysqlsh::ShellDevelopmentSession> SHCORE_PUBLIC connect_session(const std::string &uri, const std::string &password, SessionType session_type);
+std::shared_ptr<mysqlsh::ShellDevelopmentSession> SHCORE_PUBLIC connect_session(const shcore::Connection_options &options, SessionType session_type);
 };
 
 #endif
@@ -82,3 +82,21 @@ using namespace mysqlsh::mysqlx;
 
   return ::mysqlx::DocumentValue();
 }
+
+std::vector< ::mysqlx::DocumentValue> Collection_crud_definition::map_document_list(shcore::Value source) {
+  std::vector< ::mysqlx::DocumentValue> ret_val;
+  for (auto &item : *source.as_array())
+    ret_val.push_back(map_document_value(item));
+
+  return ret_val;
+}
+
+bool Collection_crud_definition::bind_value(::mysqlx::Collection_Statement &statement, const std::string &name, shcore::Value value) {
+  if (value.type == shcore::Array && statement.isListPlaceholder(name)) {
+    statement.bind(name, map_document_list(value));
+    return true;
+  }
+
+  statement.bind(name, map_document_value(value));
+  return false;
+}
@@ -48,6 +48,12 @@ public:
 
 protected:
   ::mysqlx::DocumentValue map_document_value(shcore::Value source);
+  std::vector< ::mysqlx::DocumentValue> map_document_list(shcore::Value source);
+
+  // A list bound to the placeholder that is the list of an IN operator, as
+  // in _id IN :ids, is bound as the items of the IN list, any other value is
+  // bound as a single value. Returns whether it was bound as a list.
+  bool bind_value(::mysqlx::Collection_Statement &statement, const std::string &name, shcore::Value value);
 };
 }
 }
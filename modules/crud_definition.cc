@@ -22,7 +22,11 @@
 
 #include "crud_definition.h"
 #include "base_database_object.h"
+#include "base_resultset.h"
 #include "mod_mysqlx_expression.h"
+#include "mod_mysqlx_session.h"
+#include "mysqlx_crud.h"
+#include "mysqlxtest_utils.h"
 
 using namespace std::placeholders;
 using namespace mysqlsh;
@@ -33,6 +37,7 @@ Crud_definition::Crud_definition(std::shared_ptr<DatabaseObject> owner) : _owner
   try {
     add_method("__shell_hook__", std::bind(&Crud_definition::execute, this, _1), "data");
     add_method("execute", std::bind(&Crud_definition::execute, this, _1), "data");
+    add_method("explain", std::bind(&Crud_definition::explain, this, _1), "data");
   } catch (shcore::Exception &e) {
     // Invalid typecast exception is the only option
     // The exception is recreated with a more explicit message
@@ -51,6 +56,66 @@ shcore::Value Crud_definition::execute(const shcore::Argument_list &UNUSED(args)
   return ret_val;
 }
 
+shcore::Value Crud_definition::explain(const shcore::Argument_list &args) {
+  std::string operation = class_name() + ".explain";
+  args.ensure_count(0, 1, operation.c_str());
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  try {
+    std::string format = "json";
+    if (args.size() == 1) {
+      shcore::Argument_map opt_map(*args.map_at(0));
+      opt_map.ensure_keys({}, {"format"}, "explain options");
+
+      if (opt_map.has_key("format"))
+        format = opt_map.string_at("format");
+
+      if (format != "json" && format != "tree")
+        throw shcore::Exception::argument_error("The format '" + format + "' is not supported");
+    }
+
+    ::mysqlx::Statement *crud_statement = statement();
+    if (!crud_statement)
+      throw shcore::Exception::logic_error("The operation can not be explained");
+
+    std::shared_ptr<DatabaseObject> owner(_owner.lock());
+    auto session = owner ? owner->get_member("session").as_object<BaseSession>() : nullptr;
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    // The X plugin has no message to explain a CRUD operation, the plan is
+    // the one of the SQL it translates the operation into
+    std::string sql = crud_statement->sql();
+    std::shared_ptr< ::mysqlx::Result> result(
+        session->execute_sql(format == "tree" ? "EXPLAIN FORMAT=TREE " + sql : "EXPLAIN FORMAT=JSON " + sql));
+    std::shared_ptr< ::mysqlx::Row> row = result->next();
+    std::string plan = row ? row->stringField(0) : "";
+    result->flush();
+
+    (*ret_val)["sql"] = shcore::Value(sql);
+    (*ret_val)["plan"] = format == "tree" ? shcore::Value(plan) : shcore::Value::parse(plan);
+  }
+  CATCH_AND_TRANSLATE_CRUD_EXCEPTION(operation);
+
+  return shcore::Value(ret_val);
+}
+
+void Crud_definition::watch_slow(ShellBaseResult &result, uint64_t server_time) {
+  ::mysqlx::Statement *crud_statement = statement();
+  std::shared_ptr<DatabaseObject> owner(_owner.lock());
+  if (!crud_statement || !owner)
+    return;
+
+  // The operation was executed, not being logged is no reason to fail it
+  try {
+    auto session = owner->get_member("session").as_object<BaseSession>();
+    if (session)
+      result.watch_slow(crud_statement->sql(), server_time, session->slow_statement_explain());
+  } catch (...) {
+  }
+}
+
 void Crud_definition::parse_string_list(const shcore::Argument_list &args, std::vector<std::string> &data) {
   // When there is 1 argument, it must be either an array of strings or a string
   if (args.size() == 1 && args[0].type != Array && args[0].type != String)
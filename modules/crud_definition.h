@@ -35,8 +35,13 @@
 #define ATTR_UNUSED
 #endif
 
+namespace mysqlx {
+class Statement;
+}
+
 namespace mysqlsh {
 class DatabaseObject;
+class ShellBaseResult;
 namespace mysqlx {
 #if DOXYGEN_CPP
 /**
@@ -53,10 +58,22 @@ public:
 
   // The last step on CRUD operations
   virtual shcore::Value execute(const shcore::Argument_list &args) = 0;
+
+  // The statement execute() runs, for running it in a batch, NULL if it
+  // can only be executed on its own
+  virtual ::mysqlx::Statement *statement() { return NULL; }
+
+  // The plan the server picks for the statement, enabled by the operations
+  // whose statement the X plugin translates to SQL
+  shcore::Value explain(const shcore::Argument_list &args);
 protected:
   std::weak_ptr<DatabaseObject> _owner;
 
   void parse_string_list(const shcore::Argument_list &args, std::vector<std::string> &data);
+
+  // Watches the result for the slow statement log, as the SQL the X plugin
+  // executes for the statement
+  void watch_slow(ShellBaseResult &result, uint64_t server_time);
 };
 }
 }
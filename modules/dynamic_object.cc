@@ -19,6 +19,7 @@
 
 #include "proj_parser.h"
 #include <boost/algorithm/string.hpp>
+#include <mutex>
 
 #include "crud_definition.h"
 #include "base_database_object.h"
@@ -28,11 +29,24 @@ using namespace mysqlsh;
 using namespace mysqlsh::mysqlx;
 using namespace shcore;
 
+namespace {
+std::mutex tables_mutex;
+std::map<std::string, std::shared_ptr<Dynamic_object::Function_table> > tables;
+}
+
+bool Dynamic_object::is_enabled(const std::string &name) const {
+  if (!_table)
+    return false;
+
+  auto slot = _table->slots.find(name);
+  return slot != _table->slots.end() && (_enabled & (uint64_t(1) << slot->second));
+}
+
 std::vector<std::string> Dynamic_object::get_members() const {
   std::vector<std::string> _members;
-  for (auto i : _funcs) {
+  for (const auto &i : _funcs) {
     // Only returns the public enabled functions
-    if (_enabled_functions.find(i.first) != _enabled_functions.end() && _enabled_functions.at(i.first) && i.first != "__shell_hook__")
+    if (is_enabled(i.first) && i.first != "__shell_hook__")
       _members.push_back(i.second->name(naming_style));
   }
   return _members;
@@ -56,30 +70,31 @@ Value Dynamic_object::get_member(const std::string &prop) const {
   std::map<std::string, std::shared_ptr<shcore::Cpp_function> >::const_iterator i;
   if ((i = _funcs.find(prop)) == _funcs.end() || prop == "help")
     throw shcore::Exception::attrib_error("Invalid object member " + prop);
-  else if (!_enabled_functions.at(prop))
+  else if (!is_enabled(prop))
     throw shcore::Exception::logic_error("Forbidden usage of " + prop);
   else
     return Value(std::shared_ptr<shcore::Function_base>(i->second));
 }
 
 bool Dynamic_object::has_member(const std::string &prop) const {
-  bool ret_val = false;
+  // The name as registered is the common case, it skips the search of the
+  // name in the naming style
+  if (_funcs.find(prop) != _funcs.end())
+    return is_enabled(prop);
 
   // A function is considered only if it is enanbled
-  auto i = std::find_if(_funcs.begin(), _funcs.end(), [this, prop](const FunctionEntry &f) { return f.second->name(naming_style) == prop; });
+  auto i = find_function(prop, naming_style);
   if (i != _funcs.end())
-    ret_val = _enabled_functions.find(i->first) != _enabled_functions.end() && _enabled_functions.at(i->first);
-  else
-    ret_val = Cpp_object_bridge::has_member(prop);
+    return is_enabled(i->first);
 
-  return ret_val;
+  return Cpp_object_bridge::has_member(prop);
 }
 
 Value Dynamic_object::call(const std::string &name, const shcore::Argument_list &args) {
   std::map<std::string, std::shared_ptr<shcore::Cpp_function> >::const_iterator i;
   if ((i = _funcs.find(name)) == _funcs.end())
     throw shcore::Exception::attrib_error("Invalid object function " + name);
-  else if (!_enabled_functions.at(name))
+  else if (!is_enabled(name))
     throw shcore::Exception::logic_error("Forbidden usage of " + name);
   return i->second->invoke(args);
 }
@@ -89,28 +104,68 @@ Value Dynamic_object::call(const std::string &name, const shcore::Argument_list
 * Parameters:
 *   - name: indicates the exposed function to be enabled/disabled.
 *   - enable_after: indicate the "states" under which the function should be enabled.
+*
+* The table is built by the first instance of the class, which publishes it
+* on its first update_functions(), the next instances take it as it is.
 */
 void Dynamic_object::register_dynamic_function(const std::string& name, const std::string& enable_after) {
-  // Adds the function to the enabled/disabled state registry
-  _enabled_functions[name] = true;
+  if (!_table) {
+    std::lock_guard<std::mutex> lock(tables_mutex);
+    auto table = tables.find(class_name());
+    if (table != tables.end())
+      _table = table->second;
+    else
+      _table.reset(new Function_table());
+  }
+
+  if (_table->sealed)
+    return;
+
+  // The function is enabled until the first update
+  unsigned slot = static_cast<unsigned>(_table->slots.size());
+  if (_table->slots.count(name))
+    slot = _table->slots[name];
+  else if (slot >= 64)
+    throw shcore::Exception::logic_error("Too many dynamic functions on " + class_name());
+
+  _table->slots[name] = slot;
+  _enabled |= uint64_t(1) << slot;
 
   // Splits the 'enable' states and associates them to the function
   std::vector<std::string> tokens;
   boost::algorithm::split(tokens, enable_after, boost::is_any_of(", "), boost::token_compress_on);
-  std::set<std::string> after(tokens.begin(), tokens.end());
-  _enable_paths[name] = after;
+  for (auto &state : tokens)
+    _table->enabled_after[state] |= uint64_t(1) << slot;
 }
 
 void Dynamic_object::update_functions(const std::string& source) {
-  std::map<std::string, bool>::iterator it, end = _enabled_functions.end();
+  if (!_table) {
+    _enabled = 0;
+    return;
+  }
+
+  if (!_table->sealed) {
+    _table->sealed = true;
 
-  for (it = _enabled_functions.begin(); it != end; it++) {
-    size_t count = _enable_paths[it->first].count(source);
-    enable_function(it->first.c_str(), count > 0);
+    std::lock_guard<std::mutex> lock(tables_mutex);
+    auto published = tables.insert(std::make_pair(class_name(), _table));
+    _table = published.first->second;
   }
+
+  auto state = _table->enabled_after.find(source);
+  _enabled = state != _table->enabled_after.end() ? state->second : 0;
 }
 
 void Dynamic_object::enable_function(const char *name, bool enable) {
-  if (_enabled_functions.find(name) != _enabled_functions.end())
-    _enabled_functions[name] = enable;
+  if (!_table)
+    return;
+
+  auto slot = _table->slots.find(name);
+  if (slot == _table->slots.end())
+    return;
+
+  if (enable)
+    _enabled |= uint64_t(1) << slot->second;
+  else
+    _enabled &= ~(uint64_t(1) << slot->second);
 }
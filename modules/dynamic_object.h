@@ -26,6 +26,8 @@
 #include "shellcore/types_cpp.h"
 #include "shellcore/common.h"
 
+#include <cstdint>
+#include <memory>
 #include <set>
 
 namespace mysqlsh {
@@ -43,14 +45,30 @@ class Dynamic_object : public shcore::Cpp_object_bridge {
   // T the moment will put these since we don't really care about them
   virtual bool operator == (const Object_bridge &) const { return false; }
 
+public:
+  // The dynamic functions of a class and the states enabling them, built by
+  // the first instance and shared by the rest. Every function has a bit,
+  // every state the mask of the functions enabled after it.
+  struct Function_table {
+    Function_table() : sealed(false) {}
+
+    std::map<std::string, unsigned> slots;
+    std::map<std::string, uint64_t> enabled_after;
+    // Once the first instance is done registering
+    bool sealed;
+  };
+
 protected:
-  // Holds the dynamic functions enable/disable status
-  std::map<std::string, bool> _enabled_functions;
+  Dynamic_object() : _enabled(0) {}
+
+  std::shared_ptr<Function_table> _table;
+  // The bits of the functions enabled on this instance
+  uint64_t _enabled;
 
-  // Holds relation of 'enabled' states for every dynamic function
-  std::map<std::string, std::set<std::string> > _enable_paths;
+  bool is_enabled(const std::string &name) const;
 
-  // Registers a dynamic function and it's associated 'enabled' states
+  // Registers a dynamic function and it's associated 'enabled' states, only
+  // done by the first instance of the class
   void register_dynamic_function(const std::string& name, const std::string& enable_after);
 
   // Enable/disable functions based on the received and registered states
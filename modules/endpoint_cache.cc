@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/endpoint_cache.h"
+#include "utils/utils_file.h"
+#include "utils/utils_general.h"
+#include "logger/logger.h"
+
+#include <fstream>
+
+namespace mysqlsh {
+
+// The capabilities are binary, they are stored as hex digits
+static std::string decode_hex(const std::string &hex) {
+  auto digit = [](char c) -> int {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    return -1;
+  };
+
+  std::string data;
+  if (hex.size() < 2 || hex.compare(0, 2, "0x") != 0 || hex.size() % 2 != 0)
+    return data;
+
+  data.reserve(hex.size() / 2 - 1);
+  for (size_t index = 2; index < hex.size(); index += 2) {
+    int high = digit(hex[index]);
+    int low = digit(hex[index + 1]);
+    if (high < 0 || low < 0)
+      return std::string();
+    data.push_back(static_cast<char>(high << 4 | low));
+  }
+
+  return data;
+}
+
+Endpoint_cache *Endpoint_cache::get() {
+  static Endpoint_cache *instance = new Endpoint_cache();
+  return instance;
+}
+
+void Endpoint_cache::set_path(const std::string &path) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _path = path;
+  _path_set = true;
+  _loaded = false;
+  _entries.clear();
+}
+
+// The file is a JSON object with an entry for each endpoint
+void Endpoint_cache::load() {
+  if (_loaded)
+    return;
+  _loaded = true;
+
+  if (!_path_set) {
+    _path = shcore::get_user_config_path() + "endpoints.json";
+    _path_set = true;
+  }
+
+  std::string data;
+  if (_path.empty() || !shcore::load_text_file(_path, data))
+    return;
+
+  try {
+    shcore::Value entries = shcore::Value::parse_json(data);
+    if (entries.type != shcore::Map)
+      return;
+
+    for (auto &entry : *entries.as_map()) {
+      if (entry.second.type != shcore::Map)
+        continue;
+
+      auto fields = entry.second.as_map();
+      Endpoint_info &info = _entries[entry.first];
+      info.server_uuid = fields->get_string("uuid");
+      info.version = fields->get_string("version");
+      info.capabilities = decode_hex(fields->get_string("capabilities"));
+
+      auto methods = fields->get_map("auth");
+      if (methods) {
+        for (auto &method : *methods) {
+          if (method.second.type == shcore::String)
+            info.auth_methods[method.first] = method.second.as_string();
+        }
+      }
+    }
+  } catch (std::exception &e) {
+    // Rewritten on the next change
+    log_warning("Ignoring the endpoint cache at %s: %s", _path.c_str(), e.what());
+    _entries.clear();
+  }
+}
+
+void Endpoint_cache::save() const {
+  if (_path.empty())
+    return;
+
+  shcore::Value::Map_type_ref entries(new shcore::Value::Map_type());
+  for (auto &entry : _entries) {
+    shcore::Value::Map_type_ref fields(new shcore::Value::Map_type());
+    (*fields)["uuid"] = shcore::Value(entry.second.server_uuid);
+    (*fields)["version"] = shcore::Value(entry.second.version);
+
+    std::string capabilities;
+    shcore::append_hex(capabilities, entry.second.capabilities.data(), entry.second.capabilities.size());
+    (*fields)["capabilities"] = shcore::Value(capabilities);
+
+    shcore::Value::Map_type_ref methods(new shcore::Value::Map_type());
+    for (auto &method : entry.second.auth_methods)
+      (*methods)[method.first] = shcore::Value(method.second);
+    (*fields)["auth"] = shcore::Value(methods);
+
+    (*entries)[entry.first] = shcore::Value(fields);
+  }
+
+  std::ofstream file(_path, std::ofstream::trunc);
+  file << shcore::Value(entries).json();
+}
+
+bool Endpoint_cache::find(const std::string &endpoint, Endpoint_info *info) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  load();
+
+  auto entry = _entries.find(endpoint);
+  if (entry == _entries.end())
+    return false;
+
+  *info = entry->second;
+  return true;
+}
+
+bool Endpoint_cache::validate(const std::string &endpoint, const std::string &server_uuid, const std::string &version) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  load();
+
+  auto entry = _entries.find(endpoint);
+  if (entry != _entries.end() && entry->second.server_uuid == server_uuid && entry->second.version == version)
+    return true;
+
+  // An upgraded server may have other capabilities too
+  Endpoint_info &info = _entries[endpoint];
+  info = Endpoint_info();
+  info.server_uuid = server_uuid;
+  info.version = version;
+  save();
+
+  return false;
+}
+
+void Endpoint_cache::set_capabilities(const std::string &endpoint, const std::string &capabilities) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  load();
+
+  auto entry = _entries.find(endpoint);
+  if (entry == _entries.end() || entry->second.capabilities == capabilities)
+    return;
+
+  entry->second.capabilities = capabilities;
+  save();
+}
+
+void Endpoint_cache::set_auth_method(const std::string &endpoint, const std::string &user, const std::string &method) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  load();
+
+  auto entry = _entries.find(endpoint);
+  if (entry == _entries.end())
+    return;
+
+  auto current = entry->second.auth_methods.find(user);
+  if (current != entry->second.auth_methods.end() && current->second == method)
+    return;
+
+  entry->second.auth_methods[user] = method;
+  save();
+}
+
+void Endpoint_cache::forget(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  load();
+
+  if (_entries.erase(endpoint))
+    save();
+}
+};
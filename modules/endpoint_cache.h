@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// What is known of the servers the shell connected to, so the sessions
+// opened later skip asking for it again
+
+#ifndef _MODULES_ENDPOINT_CACHE_H_
+#define _MODULES_ENDPOINT_CACHE_H_
+
+#include "shellcore/types.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace mysqlsh {
+struct Endpoint_info {
+  std::string server_uuid;
+  std::string version;
+  // The Mysqlx.Connection.Capabilities sent by the server, serialized
+  std::string capabilities;
+  // The authentication method that worked for each user
+  std::map<std::string, std::string> auth_methods;
+};
+
+// The entries are kept by endpoint (host:port) in the user configuration
+// folder. Each connection checks the UUID of the server against its entry,
+// which is dropped when another server took the endpoint, so that check is
+// the only query needed to trust the rest of the entry.
+class SHCORE_PUBLIC Endpoint_cache {
+public:
+  static Endpoint_cache *get();
+
+  bool find(const std::string &endpoint, Endpoint_info *info);
+
+  // Checks the server at the endpoint is the one of the entry, a different
+  // UUID or version starts the entry again. Returns false if it was not
+  // the same server or there was no entry.
+  bool validate(const std::string &endpoint, const std::string &server_uuid, const std::string &version);
+
+  // Both need a validated entry, they are ignored otherwise
+  void set_capabilities(const std::string &endpoint, const std::string &capabilities);
+  void set_auth_method(const std::string &endpoint, const std::string &user, const std::string &method);
+
+  void forget(const std::string &endpoint);
+
+  // The file holding the entries, an empty path keeps them in memory only
+  void set_path(const std::string &path);
+
+private:
+  Endpoint_cache() : _loaded(false), _path_set(false) {}
+
+  void load();
+  void save() const;
+
+  mutable std::mutex _mutex;
+  bool _loaded;
+  bool _path_set;
+  std::string _path;
+  std::map<std::string, Endpoint_info> _entries;
+};
+};
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/member_latency.h"
+#include "modules/base_session.h"
+#include "modules/mysql_connection.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace mysqlsh {
+
+// Weight of a new sample on the smoothed time
+static const double kSampleWeight = 0.25;
+
+// Round trips timed on each probe, the fastest one is the sample
+static const int kProbePings = 3;
+
+// Seconds a probe waits on the network, an instance that does not answer
+// by then is as good as unreachable for the choice of a member
+static const int kProbeTimeout = 5;
+
+Member_latency *Member_latency::get() {
+  // Never destroyed, the probes may still be running at exit
+  static Member_latency *instance = new Member_latency();
+  return instance;
+}
+
+void Member_latency::record(const std::string &address, std::chrono::steady_clock::duration rtt) {
+  double sample = std::chrono::duration<double>(rtt).count();
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  Entry &entry = _entries[address];
+  if (entry.timed && !entry.failed)
+    entry.smoothed += kSampleWeight * (sample - entry.smoothed);
+  else
+    entry.smoothed = sample;
+  entry.sampled = std::chrono::steady_clock::now();
+  entry.timed = true;
+  entry.failed = false;
+}
+
+void Member_latency::record_failure(const std::string &address) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  Entry &entry = _entries[address];
+  entry.sampled = std::chrono::steady_clock::now();
+  entry.failed = true;
+}
+
+bool Member_latency::latency(const std::string &address, double *seconds, bool *fresh) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto entry = _entries.find(address);
+  if (entry == _entries.end() || !entry->second.timed || entry->second.failed)
+    return false;
+
+  if (seconds)
+    *seconds = entry->second.smoothed;
+  if (fresh)
+    *fresh = std::chrono::steady_clock::now() - entry->second.sampled < _refresh_interval;
+  return true;
+}
+
+void Member_latency::probe(const std::vector<std::string> &addresses, std::shared_ptr<ShellDevelopmentSession> session,
+                           std::chrono::milliseconds wait) {
+  shcore::SslInfo ssl_info;
+  ssl_info.ca = session->get_ssl_ca();
+  ssl_info.cert = session->get_ssl_cert();
+  ssl_info.key = session->get_ssl_key();
+  ssl_info.skip = ssl_info.ca.empty() && ssl_info.cert.empty() && ssl_info.key.empty();
+
+  auto now = std::chrono::steady_clock::now();
+  std::vector<std::string> untimed;
+
+  for (auto &address : addresses) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      Entry &entry = _entries[address];
+      if (entry.probing || (entry.sampled != std::chrono::steady_clock::time_point() &&
+                            now - entry.sampled < _refresh_interval))
+        continue;
+
+      entry.probing = true;
+      if (!entry.timed)
+        untimed.push_back(address);
+    }
+
+    // The addresses are parsed here, the cache of parsed URIs is not shared
+    // with other threads
+    shcore::Connection_options options = shcore::Connection_options::parse(address, false);
+    options.user = session->get_user();
+    options.password = session->get_password();
+    options.has_password = true;
+    options.ssl = ssl_info;
+
+    std::thread(&Member_latency::run_probe, this, address, options).detach();
+  }
+
+  if (untimed.empty() || wait.count() == 0)
+    return;
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _probed.wait_until(lock, now + wait, [this, &untimed]() {
+    for (auto &address : untimed) {
+      if (_entries[address].probing)
+        return false;
+    }
+    return true;
+  });
+}
+
+void Member_latency::run_probe(const std::string &address, const shcore::Connection_options &options) {
+  try {
+    mysql::Connection connection(options.host, options.port, options.socket, options.user, options.password, "",
+                                 options.ssl, false, "", -1, kProbeTimeout);
+
+    std::chrono::steady_clock::duration best = std::chrono::steady_clock::duration::max();
+    for (int ping = 0; ping < kProbePings; ping++) {
+      auto start = std::chrono::steady_clock::now();
+      if (!connection.ping())
+        throw std::runtime_error("the server did not answer the ping");
+      best = std::min(best, std::chrono::steady_clock::now() - start);
+    }
+
+    connection.close();
+    record(address, best);
+  } catch (std::exception &e) {
+    log_debug("Unable to time the round trip to %s: %s", address.c_str(), e.what());
+    record_failure(address);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries[address].probing = false;
+  }
+  _probed.notify_all();
+
+  mysql_thread_end();
+}
+
+void Member_latency::sort(std::vector<std::string> &addresses) const {
+  std::vector<std::pair<double, std::string> > timed;
+  std::vector<std::string> untimed;
+
+  for (auto &address : addresses) {
+    double seconds;
+    if (latency(address, &seconds))
+      timed.emplace_back(seconds, address);
+    else
+      untimed.push_back(address);
+  }
+
+  std::stable_sort(timed.begin(), timed.end(),
+                   [](const std::pair<double, std::string> &a, const std::pair<double, std::string> &b) {
+                     return a.first < b.first;
+                   });
+
+  addresses.clear();
+  for (auto &entry : timed)
+    addresses.push_back(entry.second);
+  addresses.insert(addresses.end(), untimed.begin(), untimed.end());
+}
+};
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Round trip times from the shell to the instances the AdminAPI works with
+
+#ifndef _MODULES_MEMBER_LATENCY_H_
+#define _MODULES_MEMBER_LATENCY_H_
+
+#include "shellcore/types.h"
+#include "utils/utils_general.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mysqlsh {
+class ShellDevelopmentSession;
+
+// The operations that can use any member of a group (the peer of a joining
+// instance, the secondary the metadata is read from, the order of the group
+// seeds) take the nearest one from here rather than the first one of the
+// metadata. The round trip times are smoothed over the samples, so a single
+// slow reply does not reorder the members, and are timed again in the
+// background once they are older than the refresh interval.
+class SHCORE_PUBLIC Member_latency {
+public:
+  static Member_latency *get();
+
+  // Adds a round trip time measured to the instance at address (host:port)
+  void record(const std::string &address, std::chrono::steady_clock::duration rtt);
+  // The instance did not answer, it goes after the ones that did
+  void record_failure(const std::string &address);
+
+  // The smoothed round trip time to the instance, false if it was never
+  // timed or did not answer the last time. Fresh is set if the time is
+  // more recent than the refresh interval.
+  bool latency(const std::string &address, double *seconds, bool *fresh = nullptr) const;
+
+  // Times the instances with no fresh sample, each on a thread of its own
+  // connecting with the credentials of the session. Waits at most wait for
+  // the instances that were never timed, the rest are refreshed without
+  // waiting.
+  void probe(const std::vector<std::string> &addresses, std::shared_ptr<ShellDevelopmentSession> session,
+             std::chrono::milliseconds wait);
+
+  // Orders the addresses from the nearest, the ones with no time keep their
+  // order after them
+  void sort(std::vector<std::string> &addresses) const;
+
+  void set_refresh_interval(std::chrono::seconds interval) { _refresh_interval = interval; }
+  std::chrono::seconds refresh_interval() const { return _refresh_interval; }
+
+private:
+  Member_latency() : _refresh_interval(30) {}
+
+  struct Entry {
+    Entry() : smoothed(0), timed(false), failed(false), probing(false) {}
+
+    double smoothed;
+    std::chrono::steady_clock::time_point sampled;
+    bool timed;
+    bool failed;
+    bool probing;
+  };
+
+  void run_probe(const std::string &address, const shcore::Connection_options &options);
+
+  mutable std::mutex _mutex;
+  std::condition_variable _probed;
+  std::chrono::seconds _refresh_interval;
+  std::map<std::string, Entry> _entries;
+};
+};
+
+#endif
@@ -22,10 +22,15 @@
 
 #include <string>
 #include <iomanip>
+#include <cstring>
 #include "mod_mysql_resultset.h"
 #include "mysql_connection.h"
+#include "mysqlx_charset.h"
 #include "shellcore/shell_core_options.h"
 #include "utils/utils_help.h"
+#include "utils/utils_sqlstring.h"
+#include "utils/utils_memory.h"
+#include "mysqlxtest_utils.h"
 
 using namespace std::placeholders;
 using namespace mysqlsh;
@@ -52,8 +57,14 @@ ClassicResult::ClassicResult(std::shared_ptr<Result> result)
 
   add_method("fetchOne", std::bind((shcore::Value(ClassicResult::*)(const shcore::Argument_list &)const)&ClassicResult::fetch_one, this, _1), "nothing", shcore::String, NULL);
   add_method("fetchAll", std::bind((shcore::Value(ClassicResult::*)(const shcore::Argument_list &)const)&ClassicResult::fetch_all, this, _1), "nothing", shcore::String, NULL);
+  add_method("fetchMany", std::bind(&ClassicResult::fetch_many, this, _1), "count", shcore::Integer, NULL);
   add_method("nextDataSet", std::bind(&ClassicResult::next_data_set, this, _1), "nothing", shcore::String, NULL);
   add_method("hasData", std::bind(&ClassicResult::has_data, this, _1), "nothing", shcore::String, NULL);
+  add_method("toArrow", std::bind(&ClassicResult::to_arrow, this, _1), "path", shcore::String, NULL);
+}
+
+uint64_t ClassicResult::rows_read() const {
+  return _result ? _result->fetched_row_count() : 0;
 }
 
 // Documentation of the hasData function
@@ -90,23 +101,323 @@ Row ClassicResult::fetch_one() {}
 #endif
 shcore::Value ClassicResult::fetch_one(const shcore::Argument_list &args) const {
   args.ensure_count(0, get_function_name("fetchOne").c_str());
-  auto inner_row = std::unique_ptr<Row>(_result->fetch_one());
 
-  if (inner_row) {
-    mysqlsh::Row *value_row = new mysqlsh::Row();
+  std::unique_ptr<mysql::Row> inner_row;
+  {
+    Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+    inner_row = fetch_row();
+  }
 
-    std::vector<Field> metadata(_result->get_metadata());
+  if (inner_row) {
+    Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+    std::shared_ptr<Row_columns> columns = get_row_columns();
+    mysqlsh::Row *value_row = new mysqlsh::Row(columns);
 
-    for (size_t index = 0; index < metadata.size(); index++)
-      value_row->add_item(metadata[index].name(), inner_row->get_value(index));
+    for (size_t index = 0; index < columns->size(); index++)
+      value_row->add_value(inner_row->get_value(index));
 
     return shcore::Value::wrap(value_row);
   }
+
+  end_of_data();
   return shcore::Value::Null();
 }
 
+bool ClassicResult::dump_raw(std::string &buffer, const Raw_flush &flush, size_t &row_count) const {
+  // The pages are read as they are needed by fetch_row()
+  if (_keyset)
+    return false;
+
+  // The text sent by the server is written as it is for the fields whose
+  // value would be printed the same, the rest are converted into values
+  std::vector<Field> &metadata(_result->get_metadata());
+  std::vector<bool> as_text(metadata.size());
+  for (size_t index = 0; index < metadata.size() && !_result->is_binary(); index++) {
+    switch (metadata[index].type()) {
+      case MYSQL_TYPE_FLOAT:
+      case MYSQL_TYPE_DOUBLE:
+      case MYSQL_TYPE_DATETIME:
+      case MYSQL_TYPE_TIMESTAMP:
+      case MYSQL_TYPE_BIT:
+      case MYSQL_TYPE_ENUM:
+      case MYSQL_TYPE_SET:
+        as_text[index] = false;
+        break;
+      default:
+        as_text[index] = !(metadata[index].flags() & ZEROFILL_FLAG);
+        break;
+    }
+  }
+
+  // The binary strings go through binaryAs, from the bytes received
+  std::shared_ptr<Row_columns> columns = get_row_columns();
+
+  row_count = 0;
+  while (true) {
+    const mysql::Row *row;
+    {
+      Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+      row = _result->fetch_one_view();
+    }
+
+    if (!row)
+      break;
+
+    for (size_t index = 0; index < metadata.size(); index++) {
+      if (index)
+        buffer += '\t';
+
+      if (row->is_null(static_cast<int>(index))) {
+        buffer += "null";
+      } else if (as_text[index]) {
+        size_t length;
+        const char *data = row->get_data(static_cast<int>(index), length);
+        if (columns->is_binary(index))
+          append_binary(buffer, data, length);
+        else
+          buffer.append(data, length);
+      } else {
+        shcore::Value value = row->get_value(static_cast<int>(index));
+        if (columns->is_binary(index) && value.type == shcore::String)
+          append_binary(buffer, value.as_string().data(), value.as_string().size());
+        else
+          value.append_descr(buffer);
+      }
+    }
+    buffer += '\n';
+
+    row_count++;
+    flush(buffer);
+  }
+
+  end_of_data();
+  return true;
+}
+
 std::shared_ptr<mysql::Row> ClassicResult::fetch_one() const {
-  return std::shared_ptr<Row>(_result->fetch_one());
+  return std::shared_ptr<Row>(fetch_row());
+}
+
+// Documentation of toArrow function
+REGISTER_HELP(CLASSICRESULT_TOARROW_BRIEF, "Writes the unread records of the result to a file in the Apache Arrow IPC stream format.");
+REGISTER_HELP(CLASSICRESULT_TOARROW_PARAM, "@param path the file to be written.");
+REGISTER_HELP(CLASSICRESULT_TOARROW_RETURN, "@return The number of records written.");
+REGISTER_HELP(CLASSICRESULT_TOARROW_DETAIL, "Integer and floating point columns are written as Int64, UInt64 and Double, "\
+"binary strings as LargeBinary and the rest of columns as LargeUtf8 with the text of the values.");
+
+/**
+* $(CLASSICRESULT_TOARROW_BRIEF)
+*
+* $(CLASSICRESULT_TOARROW_PARAM)
+*
+* $(CLASSICRESULT_TOARROW_RETURN)
+*
+* $(CLASSICRESULT_TOARROW_DETAIL)
+*/
+#if DOXYGEN_JS
+Integer ClassicResult::toArrow(String path) {};
+#elif DOXYGEN_PY
+int ClassicResult::to_arrow(str path) {};
+#endif
+bool ClassicResult::dump_arrow(const Arrow_stream_writer::Output &output, size_t &row_count) const {
+  std::vector<Field> &metadata(_result->get_metadata());
+  std::vector<Arrow_stream_writer::Field> fields;
+  for (auto &field : metadata) {
+    Arrow_stream_writer::Type type;
+    switch (field.converter()) {
+      case Field::As_integer:
+        type = Arrow_stream_writer::Type::Int64;
+        break;
+      case Field::As_unsigned:
+        type = Arrow_stream_writer::Type::UInt64;
+        break;
+      case Field::As_double:
+        type = Arrow_stream_writer::Type::Double;
+        break;
+      case Field::As_string:
+        type = strcmp(::mysqlx::Charset::charset_name_from_id(static_cast<uint32_t>(field.charset())), "binary") == 0 ?
+          Arrow_stream_writer::Type::Binary : Arrow_stream_writer::Type::Utf8;
+        break;
+      default:
+        type = Arrow_stream_writer::Type::Utf8;
+        break;
+    }
+    fields.emplace_back(field.name(), type);
+  }
+
+  // Nothing is written for the results without data sets
+  row_count = 0;
+  if (fields.empty())
+    return true;
+
+  // The rows arrive one at a time, they are collected into batches of up
+  // to a few MB
+  const size_t kBatchDataSize = 4 * 1024 * 1024;
+
+  Arrow_stream_writer writer(fields, output);
+  Arrow_batch_builder builder(fields);
+  std::unique_ptr<mysql::Row> paged_row;
+  std::string text;
+
+  while (true) {
+    const mysql::Row *row;
+    {
+      Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+      if (_keyset) {
+        paged_row = fetch_row();
+        row = paged_row.get();
+      } else {
+        row = _result->fetch_one_view();
+      }
+    }
+
+    if (!row)
+      break;
+
+    for (size_t index = 0; index < metadata.size(); index++) {
+      int field = static_cast<int>(index);
+      if (row->is_null(field)) {
+        builder.append_null(index);
+        continue;
+      }
+
+      switch (fields[index].type) {
+        case Arrow_stream_writer::Type::Int64:
+          builder.append(index, row->get_value(field).as_int());
+          break;
+        case Arrow_stream_writer::Type::UInt64:
+          builder.append(index, row->get_value(field).as_uint());
+          break;
+        case Arrow_stream_writer::Type::Double:
+          builder.append(index, row->get_value(field).as_double());
+          break;
+        default: {
+          // The text sent by the server, prepared statements have values
+          size_t length;
+          const char *data = row->get_data(field, length);
+          if (data) {
+            builder.append(index, data, length);
+          } else {
+            text.clear();
+            shcore::Value value = row->get_value(field);
+            if (value.type == shcore::String)
+              text = value.as_string();
+            else
+              value.append_descr(text);
+            builder.append(index, text.data(), text.size());
+          }
+          break;
+        }
+      }
+    }
+    builder.end_row();
+
+    row_count++;
+    if (builder.data_size() >= kBatchDataSize)
+      builder.flush(&writer);
+  }
+
+  builder.flush(&writer);
+  writer.finish();
+
+  end_of_data();
+  return true;
+}
+
+std::unique_ptr<mysql::Row> ClassicResult::fetch_row() const {
+  std::unique_ptr<Row> row = _result->fetch_one();
+
+  if (_keyset) {
+    // A full page means there may be more rows, the next page starts
+    // right after the key of the last row read
+    if (!row && _keyset->page_rows == _keyset->page_size) {
+      std::string query = keyset_page_query(_keyset->query, _keyset->key, _keyset->last_key, _keyset->page_size);
+      _result = std::shared_ptr<Result>(_keyset->connection->run_sql(query));
+      _keyset->page_rows = 0;
+
+      row = _result->fetch_one();
+    }
+
+    if (row) {
+      std::vector<Field> &metadata(_result->get_metadata());
+
+      for (size_t index = 0; index < _keyset->positions.size(); index++) {
+        int position = _keyset->positions[index];
+        shcore::Value value = row->get_value(position);
+
+        if (value.type == shcore::Null)
+          throw shcore::Exception::logic_error("Keyset paging found a NULL value on key column '" + _keyset->key[index] + "'");
+
+        // Numbers are used as they come from the server, anything else is quoted
+        std::string raw = row->get_value_as_string(position);
+        if (IS_NUM(metadata[position].type()))
+          _keyset->last_key[index] = raw;
+        else
+          _keyset->last_key[index] = shcore::sqlstring("?", 0) << raw;
+      }
+
+      _keyset->page_rows++;
+    }
+  }
+
+  return row;
+}
+
+void ClassicResult::set_keyset_paging(std::shared_ptr<Connection> connection, const std::string &query,
+                                      const std::vector<std::string> &key, size_t page_size) {
+  std::shared_ptr<Keyset_paging> keyset(new Keyset_paging());
+  keyset->connection = connection;
+  keyset->query = query;
+  keyset->key = key;
+  keyset->last_key.resize(key.size());
+  keyset->page_size = page_size;
+  keyset->page_rows = 0;
+
+  std::vector<Field> &metadata(_result->get_metadata());
+  for (size_t index = 0; index < key.size(); index++) {
+    int position = -1;
+    for (size_t field = 0; field < metadata.size() && position == -1; field++) {
+      if (metadata[field].name() == key[index])
+        position = static_cast<int>(field);
+    }
+
+    if (position == -1)
+      throw shcore::Exception::argument_error("The key column '" + key[index] + "' is not part of the query result");
+
+    keyset->positions.push_back(position);
+  }
+
+  _keyset = keyset;
+}
+
+// The query is used as a derived table so it does not need to be parsed,
+// the server merges it into the outer query, keeping the key predicate
+// in the range used to read the base table
+std::string ClassicResult::keyset_page_query(const std::string &query, const std::vector<std::string> &key,
+                                             const std::vector<std::string> &last_key, size_t page_size) {
+  std::string columns;
+  for (size_t index = 0; index < key.size(); index++) {
+    if (index > 0)
+      columns += ", ";
+    columns += shcore::quote_identifier(key[index], '`');
+  }
+
+  std::string page_query = "SELECT * FROM (" + query + ") AS `keyset_page`";
+
+  if (!last_key.empty() && !last_key[0].empty()) {
+    std::string values;
+    for (size_t index = 0; index < last_key.size(); index++) {
+      if (index > 0)
+        values += ", ";
+      values += last_key[index];
+    }
+
+    page_query += " WHERE (" + columns + ") > (" + values + ")";
+  }
+
+  page_query += " ORDER BY " + columns + " LIMIT " + std::to_string(page_size);
+
+  return page_query;
 }
 
 // Documentation of the nextDataSet function
@@ -127,6 +438,8 @@ bool ClassicResult::next_data_set() {}
 shcore::Value ClassicResult::next_data_set(const shcore::Argument_list &args) {
   args.ensure_count(0, get_function_name("nextDataSet").c_str());
 
+  _row_columns.reset();
+
   return shcore::Value(_result->next_data_set());
 }
 
@@ -156,12 +469,88 @@ shcore::Value ClassicResult::fetch_all(const shcore::Argument_list &args) const
 
   std::shared_ptr<shcore::Value::Array_type> array(new shcore::Value::Array_type);
 
-  shcore::Value record = fetch_one(args);
+  try {
+    // The rows are accounted on the memory budget while they are built
+    shcore::Memory_reservation reservation(shcore::Memory_budget::Values);
+    shcore::Value record = fetch_one(args);
 
-  while (record) {
-    array->push_back(record);
-    record = fetch_one(args);
+    while (record) {
+      reservation.add(record.as_object<mysqlsh::Row>()->memory_size());
+      array->push_back(std::move(record));
+      record = fetch_one(args);
+    }
   }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchAll"));
+
+  return shcore::Value(array);
+}
+
+// Documentation of the fetchMany function
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_BRIEF, "Returns a list of Row objects with up to count records left on the result.");
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_PARAM, "@param count the maximum number of rows to be returned.");
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_PARAM1, "@param options Optional dictionary with options for the fetch.");
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_RETURN, "@return A List of Row objects, empty when no records are left.");
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_DETAIL, "The records are read from the server as they are requested, so "\
+"iterating a result with this function keeps the memory in use bound to the size of a chunk.");
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_DETAIL1, "The options dictionary may contain the following values:");
+REGISTER_HELP(CLASSICRESULT_FETCHMANY_DETAIL2, "@li maxBytes: the list is returned once the data of its rows, as received "\
+"from the server, reaches this size. At least one row is returned if any is left.");
+
+/**
+* $(CLASSICRESULT_FETCHMANY_BRIEF)
+*
+* $(CLASSICRESULT_FETCHMANY_PARAM)
+* $(CLASSICRESULT_FETCHMANY_PARAM1)
+*
+* $(CLASSICRESULT_FETCHMANY_RETURN)
+*
+* $(CLASSICRESULT_FETCHMANY_DETAIL)
+*
+* $(CLASSICRESULT_FETCHMANY_DETAIL1)
+* $(CLASSICRESULT_FETCHMANY_DETAIL2)
+*/
+#if DOXYGEN_JS
+List ClassicResult::fetchMany(Integer count, Map options) {}
+#elif DOXYGEN_PY
+list ClassicResult::fetch_many(int count, dict options) {}
+#endif
+shcore::Value ClassicResult::fetch_many(const shcore::Argument_list &args) const {
+  args.ensure_count(1, 2, get_function_name("fetchMany").c_str());
+
+  std::shared_ptr<shcore::Value::Array_type> array(new shcore::Value::Array_type);
+
+  try {
+    uint64_t count = args.uint_at(0);
+    uint64_t max_bytes = 0;
+
+    if (count == 0)
+      throw shcore::Exception::argument_error("The row count must be greater than 0");
+
+    if (args.size() == 2) {
+      shcore::Argument_map options(*args.map_at(1));
+      options.ensure_keys({}, {"maxBytes"}, "fetch options");
+
+      if (options.has_key("maxBytes"))
+        max_bytes = options.uint_at("maxBytes");
+    }
+
+    std::shared_ptr<Row_columns> columns = get_row_columns();
+    uint64_t bytes = 0;
+
+    while (array->size() < count && (max_bytes == 0 || bytes < max_bytes)) {
+      auto inner_row = fetch_row();
+      if (!inner_row)
+        break;
+
+      mysqlsh::Row *value_row = new mysqlsh::Row(columns);
+      for (size_t index = 0; index < columns->size(); index++)
+        value_row->add_value(inner_row->get_value(index));
+
+      bytes += inner_row->get_data_size();
+      array->push_back(shcore::Value::wrap(value_row));
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchMany"));
 
   return shcore::Value(array);
 }
@@ -170,7 +559,7 @@ std::vector<std::shared_ptr<mysql::Row>> ClassicResult::fetch_all() const {
   std::vector<std::shared_ptr<mysql::Row>> rows;
   std::shared_ptr<mysql::Row> row = fetch_one();
   while (row) {
-    rows.push_back(row);
+    rows.push_back(std::move(row));
     row = fetch_one();
   }
   return rows;
@@ -338,6 +727,11 @@ shcore::Value ClassicResult::get_member(const std::string &prop) const {
     return shcore::Value(_result->warning_count());
 
   if (prop == "warnings") {
+    // SHOW WARNINGS is a round trip of its own, only taken if there is
+    // something to show
+    if (!_result->warning_count())
+      return shcore::Value(shcore::Value::Array_type_ref(new shcore::Value::Array_type()));
+
     auto inner_warnings = _result->query_warnings().release();
     std::shared_ptr<ClassicResult> warnings(new ClassicResult(std::shared_ptr<Result>(inner_warnings)));
     return warnings->fetch_all(shcore::Argument_list());
@@ -359,50 +753,71 @@ shcore::Value ClassicResult::get_member(const std::string &prop) const {
   }
 
   if (prop == "columnNames") {
-    std::vector<Field> metadata(_result->get_metadata());
-
     std::shared_ptr<shcore::Value::Array_type> array(new shcore::Value::Array_type);
 
-    int num_fields = metadata.size();
-
-    for (int i = 0; i < num_fields; i++)
-      array->push_back(shcore::Value(metadata[i].name()));
+    for (auto &name : get_row_columns()->names())
+      array->push_back(shcore::Value(name));
 
     return shcore::Value(array);
   }
 
-  if (prop == "columns") {
-    std::vector<Field> metadata(_result->get_metadata());
+  if (prop == "columns")
+    return shcore::Value(get_row_columns()->columns());
 
-    std::shared_ptr<shcore::Value::Array_type> array(new shcore::Value::Array_type);
+  return ShellBaseResult::get_member(prop);
+}
+
+std::shared_ptr<Row_columns> ClassicResult::get_row_columns() const {
+  if (!_row_columns) {
+    _row_columns.reset(new Row_columns());
+
+    std::vector<Field> &metadata(_result->get_metadata());
 
     int num_fields = metadata.size();
 
     for (int i = 0; i < num_fields; i++) {
       bool numeric = IS_NUM(metadata[i].type());
+      const char *collation = ::mysqlx::Charset::collation_name_from_id(metadata[i].charset());
+      const char *charset = ::mysqlx::Charset::charset_name_from_id(metadata[i].charset());
       std::shared_ptr<mysqlsh::Column> column(new mysqlsh::Column(
         metadata[i].db(),
         metadata[i].org_table(),
         metadata[i].table(),
         metadata[i].org_name(),
         metadata[i].name(),
-  shcore::Value(), //type
+        shcore::Value(), //type
         metadata[i].length(),
-  numeric,
-  metadata[i].decimals(),
-  false, // signed
-  Charset::item[metadata[i].charset()].collation,
-  Charset::item[metadata[i].charset()].name,
+        numeric,
+        metadata[i].decimals(),
+        false, // signed
+        collation,
+        charset,
         false //padded
       ));
 
-      array->push_back(shcore::Value(std::static_pointer_cast<Object_bridge>(column)));
+      // The numbers and temporal types come with the binary charset too
+      bool binary = false;
+      if (metadata[i].charset() == 63) {
+        switch (metadata[i].type()) {
+          case MYSQL_TYPE_STRING:
+          case MYSQL_TYPE_VAR_STRING:
+          case MYSQL_TYPE_VARCHAR:
+          case MYSQL_TYPE_TINY_BLOB:
+          case MYSQL_TYPE_MEDIUM_BLOB:
+          case MYSQL_TYPE_LONG_BLOB:
+          case MYSQL_TYPE_BLOB:
+            binary = true;
+            break;
+          default:
+            break;
+        }
+      }
+
+      _row_columns->add(metadata[i].name(), shcore::Value(std::static_pointer_cast<Object_bridge>(column)), binary);
     }
-
-    return shcore::Value(array);
   }
 
-  return ShellBaseResult::get_member(prop);
+  return _row_columns;
 }
 
 void ClassicResult::append_json(shcore::JSON_dumper& dumper) const {
@@ -411,9 +826,16 @@ void ClassicResult::append_json(shcore::JSON_dumper& dumper) const {
   dumper.append_value("executionTime", get_member("executionTime"));
 
   dumper.append_value("info", get_member("info"));
-  dumper.append_value("rows", fetch_all(shcore::Argument_list()));
-
-  if (Shell_core_options::get()->get_bool(SHCORE_SHOW_WARNINGS)) {
+  // Records are written as they are fetched, so the whole result is not kept
+  // in memory when the dumper is streaming
+  dumper.append_string("rows");
+  dumper.start_array();
+  shcore::Value record;
+  while ((record = fetch_one(shcore::Argument_list())))
+    dumper.append_value(record);
+  dumper.end_array();
+
+  if (Shell_core_options::typed().show_warnings) {
     dumper.append_value("warningCount", get_member("warningCount"));
     dumper.append_value("warnings", get_member("warnings"));
   }
@@ -32,6 +32,7 @@ namespace mysqlsh {
 namespace mysql {
 class Result;
 class Row;
+class Connection;
 
 /**
 * $(CLASSICRESULT_BRIEF)
@@ -41,6 +42,8 @@ class Row;
 class SHCORE_PUBLIC ClassicResult : public ShellBaseResult {
 public:
   ClassicResult(std::shared_ptr<Result> result);
+  // Recorded before the result goes away, rows_read() needs it
+  virtual ~ClassicResult() { record_timing(); }
 
   std::shared_ptr<mysql::Row> fetch_one() const;
   std::vector<std::shared_ptr<mysql::Row>> fetch_all() const;
@@ -52,10 +55,44 @@ public:
   shcore::Value has_data(const shcore::Argument_list &args) const;
   virtual shcore::Value fetch_one(const shcore::Argument_list &args) const;
   virtual shcore::Value fetch_all(const shcore::Argument_list &args) const;
+  shcore::Value fetch_many(const shcore::Argument_list &args) const;
+  virtual bool dump_raw(std::string &buffer, const Raw_flush &flush, size_t &row_count) const;
+  virtual bool dump_arrow(const shcore::Arrow_stream_writer::Output &output, size_t &row_count) const;
   virtual shcore::Value next_data_set(const shcore::Argument_list &args);
+  virtual uint64_t rows_read() const;
+
+  // Turns this result into the first page of a keyset paginated query
+  void set_keyset_paging(std::shared_ptr<Connection> connection, const std::string &query,
+                         const std::vector<std::string> &key, size_t page_size);
+
+  static std::string keyset_page_query(const std::string &query, const std::vector<std::string> &key,
+                                       const std::vector<std::string> &last_key, size_t page_size);
 
 protected:
-  std::shared_ptr<Result> _result;
+  // Replaced by the next page when keyset paging is used
+  mutable std::shared_ptr<Result> _result;
+
+private:
+  struct Keyset_paging {
+    std::shared_ptr<Connection> connection;
+    std::string query;
+    std::vector<std::string> key;
+    std::vector<int> positions;
+    std::vector<std::string> last_key;
+    size_t page_size;
+    size_t page_rows;
+  };
+
+  std::unique_ptr<mysql::Row> fetch_row() const;
+
+  // The columns of the current result set, shared by its rows
+  std::shared_ptr<Row_columns> get_row_columns() const;
+
+  std::shared_ptr<Keyset_paging> _keyset;
+
+  // The pages of a keyset paginated query have the same columns, so it is
+  // only reset by the next result set
+  mutable std::shared_ptr<Row_columns> _row_columns;
 
 #if DOXYGEN_JS
   Integer affectedRowCount; //!< Same as getAffectedItemCount()
@@ -70,6 +107,8 @@ protected:
 
   Row fetchOne();
   List fetchAll();
+  List fetchMany(Integer count, Map options);
+  Integer toArrow(String path);
   Integer getAffectedRowCount();
   Integer getColumnCount();
   List getColumnNames();
@@ -94,6 +133,8 @@ protected:
 
   Row fetch_one();
   list fetch_all();
+  list fetch_many(int count, dict options);
+  int to_arrow(str path);
   int get_affected_row_count();
   int get_column_count();
   list get_column_names();
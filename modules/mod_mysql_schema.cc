@@ -81,59 +81,69 @@ void ClassicSchema::init() {
   _views = Value::new_map().as_map();
 
   // Setups the cache handlers
-  auto table_generator = [this](const std::string& name) {return shcore::Value::wrap<ClassicTable>(new ClassicTable(shared_from_this(), name, false)); };
-  auto view_generator = [this](const std::string& name) {return shcore::Value::wrap<ClassicTable>(new ClassicTable(shared_from_this(), name, true)); };
+  table_generator = [this](const std::string& name) {return shcore::Value::wrap<ClassicTable>(new ClassicTable(shared_from_this(), name, false)); };
+  view_generator = [this](const std::string& name) {return shcore::Value::wrap<ClassicTable>(new ClassicTable(shared_from_this(), name, true)); };
 
-  update_table_cache = [table_generator, this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, table_generator, exists, _tables, this); };
-  update_view_cache = [view_generator, this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, view_generator, exists, _views, this); };
+  update_table_cache = [this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, table_generator, exists, _tables, this); };
+  update_view_cache = [this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, view_generator, exists, _views, this); };
 
-  update_full_table_cache = [table_generator, this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, table_generator, _tables, this); };
-  update_full_view_cache = [view_generator, this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, view_generator, _views, this); };
+  update_full_table_cache = [this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, table_generator, _tables, this); };
+  update_full_view_cache = [this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, view_generator, _views, this); };
 }
 
 ClassicSchema::~ClassicSchema() {}
 
-void ClassicSchema::update_cache() {
+void ClassicSchema::fetch_names(const std::string &pattern, std::vector<std::string> *tables, std::vector<std::string> *views) {
   std::shared_ptr<ClassicSession> sess(std::dynamic_pointer_cast<ClassicSession>(_session.lock()));
-  if (sess) {
-    std::vector<std::string> tables;
-    std::vector<std::string> views;
-    std::vector<std::string> others;
-
-    auto val_result = sess->execute_sql(sqlstring("show full tables in !", 0) << _name, shcore::Argument_list());
-    auto result = val_result.as_object<ClassicResult>();
-    auto val_row = result->fetch_one(shcore::Argument_list());
-
-    if (val_row) {
-      auto row = val_row.as_object<mysqlsh::Row>();
-      while (row) {
-        std::string object_name = row->get_member(0).as_string();
-        std::string object_type = row->get_member(1).as_string();
-
-        if (object_type == "BASE TABLE" || object_type == "LOCAL TEMPORARY")
-          tables.push_back(object_name);
-        else if (object_type == "VIEW" || object_type == "SYSTEM VIEW")
-          views.push_back(object_name);
-        else
-          others.push_back((boost::format("Unexpected Object Retrieved from Database: %s% of type %s%") % object_name % object_type).str());;
-
-        row.reset();
-        val_row = result->fetch_one(shcore::Argument_list());
-
-        if (val_row)
-          row = val_row.as_object<mysqlsh::Row>();
-      }
+  if (!sess)
+    return;
+
+  std::vector<std::string> others;
+
+  std::string query = pattern.empty() ? std::string(sqlstring("show full tables in !", 0) << _name) :
+                                        std::string(sqlstring("show full tables in ! like ?", 0) << _name << pattern);
+  auto val_result = sess->execute_sql(query, shcore::Argument_list());
+  auto result = val_result.as_object<ClassicResult>();
+  auto val_row = result->fetch_one(shcore::Argument_list());
+
+  if (val_row) {
+    auto row = val_row.as_object<mysqlsh::Row>();
+    while (row) {
+      std::string object_name = row->get_member(0).as_string();
+      std::string object_type = row->get_member(1).as_string();
+
+      if (object_type == "BASE TABLE" || object_type == "LOCAL TEMPORARY")
+        tables->push_back(object_name);
+      else if (object_type == "VIEW" || object_type == "SYSTEM VIEW")
+        views->push_back(object_name);
+      else
+        others.push_back((boost::format("Unexpected Object Retrieved from Database: %s% of type %s%") % object_name % object_type).str());;
+
+      row.reset();
+      val_row = result->fetch_one(shcore::Argument_list());
+
+      if (val_row)
+        row = val_row.as_object<mysqlsh::Row>();
     }
+  }
+
+  // Log errors about unexpected object type
+  if (others.size()) {
+    for (size_t index = 0; index < others.size(); index++)
+      log_error("%s", others[index].c_str());
+  }
+}
+
+void ClassicSchema::update_cache() {
+  std::vector<std::string> tables;
+  std::vector<std::string> views;
+
+  if (_session.lock()) {
+    fetch_names("", &tables, &views);
 
     // Updates the cache
     update_full_table_cache(tables);
     update_full_view_cache(views);
-
-    // Log errors about unexpected object type
-    if (others.size()) {
-      for (size_t index = 0; index < others.size(); index++)
-        log_error("%s", others[index].c_str());
-    }
   }
 }
 
@@ -167,11 +177,11 @@ Value ClassicSchema::get_member(const std::string &prop) const {
   // Only checks the cache if the requested member is not a base one
   if (!is_base_member(prop)) {
     // Searches the property in tables
-    ret_val = find_in_cache(prop, _tables);
+    ret_val = find_in_cache(prop, table_generator, _tables);
 
     // Search the property in views
     if (!ret_val)
-      ret_val = find_in_cache(prop, _views);
+      ret_val = find_in_cache(prop, view_generator, _views);
   }
 
   // Search the rest of the properties
@@ -254,14 +264,18 @@ shcore::Value ClassicSchema::get_table(const shcore::Argument_list &args) {
 
 // Documentation of the getTables function
 REGISTER_HELP(CLASSICSCHEMA_GETTABLES_BRIEF, "Returns a list of Tables for this Schema.");
+REGISTER_HELP(CLASSICSCHEMA_GETTABLES_PARAM, "@param pattern Optional LIKE pattern the names of the Tables must match.");
 REGISTER_HELP(CLASSICSCHEMA_GETTABLES_RETURN, "@return A List containing the Table objects available for the Schema.");
 REGISTER_HELP(CLASSICSCHEMA_GETTABLES_DETAIL, "Pulls from the database the available Tables and Views.");
 REGISTER_HELP(CLASSICSCHEMA_GETTABLES_DETAIL1, "Does a full refresh of the Tables and Views cache.");
 REGISTER_HELP(CLASSICSCHEMA_GETTABLES_DETAIL2, "Returns a List of available Table objects.");
+REGISTER_HELP(CLASSICSCHEMA_GETTABLES_DETAIL3, "When a pattern is given only the matching Tables and Views are pulled "\
+"from the database and added to the cache.");
 
 /**
 * $(CLASSICSCHEMA_GETTABLES_BRIEF)
 * \sa ClassicTable
+* $(CLASSICSCHEMA_GETTABLES_PARAM)
 * $(CLASSICSCHEMA_GETTABLES_RETURN)
 *
 * $(CLASSICSCHEMA_GETTABLES_DETAIL)
@@ -269,21 +283,45 @@ REGISTER_HELP(CLASSICSCHEMA_GETTABLES_DETAIL2, "Returns a List of available Tabl
 * $(CLASSICSCHEMA_GETTABLES_DETAIL1)
 *
 * $(CLASSICSCHEMA_GETTABLES_DETAIL2)
+*
+* $(CLASSICSCHEMA_GETTABLES_DETAIL3)
 */
 #if DOXYGEN_JS
-List ClassicSchema::getTables() {}
+List ClassicSchema::getTables(String pattern) {}
 #elif DOXYGEN_PY
-list ClassicSchema::get_tables() {}
+list ClassicSchema::get_tables(str pattern) {}
 #endif
 shcore::Value ClassicSchema::get_tables(const shcore::Argument_list &args) {
-  args.ensure_count(0, get_function_name("getTables").c_str());
-
-  update_cache();
+  args.ensure_count(0, 1, get_function_name("getTables").c_str());
 
   shcore::Value::Array_type_ref list(new shcore::Value::Array_type);
 
-  get_object_list(_tables, list);
-  get_object_list(_views, list);
+  try {
+    std::string pattern = args.size() ? args.string_at(0) : "";
+
+    if (pattern.empty()) {
+      update_cache();
+
+      get_object_list(_tables, table_generator, list);
+      get_object_list(_views, view_generator, list);
+    } else {
+      // The server does the filtering, the rest of the cache is left as is
+      std::vector<std::string> tables;
+      std::vector<std::string> views;
+      fetch_names(pattern, &tables, &views);
+
+      for (auto &name : tables) {
+        update_table_cache(name, true);
+        list->push_back((*_tables)[name]);
+      }
+
+      for (auto &name : views) {
+        update_view_cache(name, true);
+        list->push_back((*_views)[name]);
+      }
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("getTables"));
 
   return shcore::Value(list);
 }
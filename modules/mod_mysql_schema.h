@@ -91,10 +91,10 @@ public:
 
 #if DOXYGEN_JS
   ClassicTable getTable(String name);
-  List getTables();
+  List getTables(String pattern);
 #elif DOXYGEN_PY
   ClassicTable get_table(str name);
-  list get_tables();
+  list get_tables(str pattern);
 #endif
 public:
   shcore::Value get_table(const shcore::Argument_list &args);
@@ -107,8 +107,12 @@ private:
   std::shared_ptr<shcore::Value::Map_type> _tables;
   std::shared_ptr<shcore::Value::Map_type> _views;
 
+  Generator table_generator, view_generator;
   std::function<void(const std::string&, bool exists)> update_table_cache, update_view_cache;
   std::function<void(const std::vector<std::string>&)> update_full_table_cache, update_full_view_cache;
+
+  // Names of the tables and views matching the LIKE pattern, all if empty
+  void fetch_names(const std::string &pattern, std::vector<std::string> *tables, std::vector<std::string> *views);
 };
 };
 };
@@ -44,12 +44,14 @@
 #include "mysql_connection.h"
 #include "mod_mysql_resultset.h"
 #include "mod_mysql_schema.h"
+#include "mod_mysql_statement.h"
 #include "utils/utils_general.h"
 #include "utils/utils_help.h"
 #include "utils/utils_connection.h"
 
 #define MAX_COLUMN_LENGTH 1024
 #define MIN_COLUMN_LENGTH 4
+#define CLASSICSESSION_PAGED_DEFAULT_CHUNK_SIZE 1000
 
 using namespace std::placeholders;
 using namespace mysqlsh;
@@ -63,12 +65,35 @@ REGISTER_HELP(CLASSICSESSION_INTERACTIVE_BRIEF, "Represents the currently open M
 REGISTER_HELP(CLASSICSESSION_BRIEF, "Enables interaction with a MySQL Server using the MySQL Protocol.");
 REGISTER_HELP(CLASSICSESSION_DETAIL, "Provides facilities to execute queries and retrieve database objects.");
 
-ClassicSession::ClassicSession() {
+namespace {
+// Runs the statement keeping the time until its first response as the
+// server time of the statement stats
+std::shared_ptr<ClassicResult> run_statement(const ClassicSession &session, std::shared_ptr<Connection> connection,
+                                             const std::string &query, const std::string &statement) {
+  uint64_t server_time = 0;
+  std::shared_ptr<Result> inner_result;
+  {
+    shcore::Phase_timer server_timer(server_time);
+    inner_result.reset(connection->run_sql(query).release());
+  }
+
+  std::shared_ptr<ClassicResult> result(new ClassicResult(inner_result));
+  result->set_statement(statement, server_time);
+  if (shcore::Slow_statement_log::enabled())
+    result->watch_slow(statement, server_time, session.slow_statement_explain());
+
+  return result;
+}
+}
+
+ClassicSession::ClassicSession() : _connection_id(0), _compression_level(-1), _timeout(0) {
   init();
 }
 
 ClassicSession::ClassicSession(const ClassicSession& session) :
-ShellDevelopmentSession(session), _conn(session._conn) {
+ShellDevelopmentSession(session), _conn(session._conn), _connection_id(session._connection_id),
+_compression(session._compression), _compression_level(session._compression_level),
+_timeout(session._timeout) {
   init();
 }
 
@@ -78,9 +103,16 @@ void ClassicSession::init() {
   add_property("currentSchema", "getCurrentSchema");
 
   add_method("close", std::bind(&ClassicSession::close, this, _1), "data");
+  add_method("reset", std::bind(&ClassicSession::reset, this, _1), "data");
   add_method("runSql", std::bind(&ClassicSession::run_sql, this, _1),
     "stmt", shcore::String,
     NULL);
+  add_method("runSqlPaged", std::bind(&ClassicSession::run_sql_paged, this, _1),
+    "stmt", shcore::String,
+    NULL);
+  add_method("prepare", std::bind(&ClassicSession::prepare, this, _1),
+    "stmt", shcore::String,
+    NULL);
   add_method("setCurrentSchema", std::bind(&ClassicSession::set_current_schema, this, _1), "name", shcore::String, NULL);
   add_method("startTransaction", std::bind(&ClassicSession::startTransaction, this, _1), "data");
   add_method("commit", std::bind(&ClassicSession::commit, this, _1), "data");
@@ -100,6 +132,49 @@ Connection *ClassicSession::connection() {
   return _conn.get();
 }
 
+std::shared_ptr<Connection> ClassicSession::open_connection(bool local_infile) const {
+  return std::shared_ptr<Connection>(new Connection(_host, _port, _sock, _user, _password, _schema, _ssl_info, local_infile, _compression, _compression_level,
+                                                    _timeout));
+}
+
+void ClassicSession::kill_query() {
+  if (!_conn)
+    return;
+
+  std::string sql = "KILL QUERY " + std::to_string(_connection_id);
+
+  // The connection kept since the last time may have been closed by the
+  // server meanwhile, it is opened again once
+  for (int attempt = 0;; attempt++) {
+    try {
+      if (!_kill_conn)
+        _kill_conn = open_connection(false);
+
+      _kill_conn->run_sql(sql);
+      return;
+    } catch (...) {
+      _kill_conn.reset();
+      if (attempt > 0)
+        throw;
+    }
+  }
+}
+
+shcore::Slow_statement_log::Explain ClassicSession::slow_statement_explain() const {
+  std::string host = _host, sock = _sock, user = _user, password = _password, schema = _default_schema;
+  std::string compression = _compression;
+  int port = _port, compression_level = _compression_level;
+  shcore::SslInfo ssl_info = _ssl_info;
+
+  return [=](const std::string &statement) {
+    Connection connection(host, port, sock, user, password, schema, ssl_info, false, compression,
+                          compression_level, 10);
+    std::unique_ptr<Result> result(connection.run_sql("EXPLAIN FORMAT=JSON " + statement));
+    std::unique_ptr<Row> row(result->fetch_one());
+    return row ? row->get_value_as_string(0) : std::string();
+  };
+}
+
 Value ClassicSession::connect(const Argument_list &args) {
   std::string function = class_name() + '.' + "connect";
   args.ensure_count(1, 2, function.c_str());
@@ -108,8 +183,35 @@ Value ClassicSession::connect(const Argument_list &args) {
     // Retrieves the connection data, whatever the source is
     load_connection_data(args);
 
+    _compression.clear();
+    _compression_level = -1;
+    _timeout = 0;
+    if (args[0].type == Map) {
+      shcore::Value::Map_type_ref options = args.map_at(0);
+
+      if (options->has_key(kCompression))
+        _compression = (*options)[kCompression].as_string();
+
+      if (options->has_key(kCompressionLevel)) {
+        int64_t level = (*options)[kCompressionLevel].as_int();
+        if (level < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kCompressionLevel + ", it must be 0 or a positive integer");
+        _compression_level = static_cast<int>(level);
+      }
+
+      if (options->has_key(kTimeout)) {
+        int64_t timeout = (*options)[kTimeout].as_int();
+        if (timeout < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kTimeout + ", it must be 0 or a positive integer");
+        _timeout = static_cast<int>(timeout);
+      }
+    }
+
     // Performs the connection
-    _conn.reset(new Connection(_host, _port, _sock, _user, _password, _schema, _ssl_info));
+    _conn.reset(new Connection(_host, _port, _sock, _user, _password, _schema, _ssl_info, false, _compression, _compression_level,
+                               _timeout));
+    _connection_id = _conn->get_thread_id();
+    _kill_conn.reset();
 
     _default_schema = _schema;
 
@@ -142,12 +244,51 @@ Value ClassicSession::close(const shcore::Argument_list &args) {
     _conn->close();
 
   _conn.reset();
+  _kill_conn.reset();
 
   ShellNotifications::get()->notify("SN_SESSION_CLOSED", shared_from_this());
 
   return shcore::Value();
 }
 
+// Documentation of reset function
+REGISTER_HELP(CLASSICSESSION_RESET_BRIEF, "Clears the state of the session on the server, keeping the connection open.");
+REGISTER_HELP(CLASSICSESSION_RESET_DETAIL, "The open transaction is rolled back, the session and user variables, the temporary "\
+"tables and the prepared statements are dropped, as on a new session, without connecting and authenticating again.");
+REGISTER_HELP(CLASSICSESSION_RESET_DETAIL1, "The ClassicStatement objects prepared on the session can no longer be executed.");
+
+/**
+* $(CLASSICSESSION_RESET_BRIEF)
+*
+* $(CLASSICSESSION_RESET_DETAIL)
+*
+* $(CLASSICSESSION_RESET_DETAIL1)
+*/
+#if DOXYGEN_JS
+Undefined ClassicSession::reset() {}
+#elif DOXYGEN_PY
+None ClassicSession::reset() {}
+#endif
+Value ClassicSession::reset(const shcore::Argument_list &args) {
+  args.ensure_count(0, get_function_name("reset").c_str());
+
+  try {
+    reset_state();
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("reset"));
+
+  return shcore::Value();
+}
+
+void ClassicSession::reset_state() {
+  if (!_conn)
+    throw Exception::logic_error("Not connected.");
+
+  _conn->reset();
+
+  ShellDevelopmentSession::reset_state();
+}
+
 //Documentation of runSql function
 REGISTER_HELP(CLASSICSESSION_RUNSQL_BRIEF, "Executes a query against the database and returns a  ClassicResult object wrapping the result.");
 REGISTER_HELP(CLASSICSESSION_RUNSQL_PARAM, "@param query the SQL query to execute against the database.");
@@ -196,6 +337,132 @@ Value ClassicSession::run_sql(const shcore::Argument_list &args) const {
   return ret_val;
 }
 
+//Documentation of prepare function
+REGISTER_HELP(CLASSICSESSION_PREPARE_BRIEF, "Prepares a statement on the server to be executed any number of times.");
+REGISTER_HELP(CLASSICSESSION_PREPARE_PARAM, "@param query the SQL statement to prepare, with a ? placeholder for each parameter.");
+REGISTER_HELP(CLASSICSESSION_PREPARE_RETURN, "@return A ClassicStatement object.");
+REGISTER_HELP(CLASSICSESSION_PREPARE_DETAIL, "The server parses the statement once, each execution only sends the parameters. "\
+"The rows of its results arrive in the binary protocol, so numbers and dates are not converted from text.");
+
+/**
+* $(CLASSICSESSION_PREPARE_BRIEF)
+*
+* $(CLASSICSESSION_PREPARE_PARAM)
+* $(CLASSICSESSION_PREPARE_RETURN)
+*
+* $(CLASSICSESSION_PREPARE_DETAIL)
+*/
+#if DOXYGEN_JS
+ClassicStatement ClassicSession::prepare(String query) {}
+#elif DOXYGEN_PY
+ClassicStatement ClassicSession::prepare(str query) {}
+#endif
+Value ClassicSession::prepare(const shcore::Argument_list &args) const {
+  args.ensure_count(1, get_function_name("prepare").c_str());
+
+  if (!_conn)
+    throw Exception::logic_error("Not connected.");
+
+  Value ret_val;
+  try {
+    std::string query = args.string_at(0);
+    ret_val = Value::wrap<ClassicStatement>(new ClassicStatement(_conn->prepare(query), query));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("prepare"));
+
+  return ret_val;
+}
+
+//Documentation of runSqlPaged function
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_BRIEF, "Executes a query in pages delimited by a key and returns a ClassicResult object that reads all of them.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_PARAM, "@param query the SQL query to execute against the database, without ORDER BY or LIMIT clauses.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_PARAM1, "@param key the name or list of names of the result columns that uniquely identify a row, i.e. the primary key.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_PARAM2, "@param options Optional dictionary with options for the paging.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_RETURN, "@return A ClassicResult object.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_DETAIL, "Instead of reading a single result stream, the query is executed once for "\
+"every page, ordered by the key and starting right after the key of the last row read on the previous page, "\
+"so no result is held open on the server while the rows of a page are processed.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_DETAIL1, "The rows are returned ordered by the key. The options dictionary may contain the following values:");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_DETAIL2, "@li chunkSize: the number of rows on each page, 1000 by default.");
+REGISTER_HELP(CLASSICSESSION_RUNSQLPAGED_EXCEPTION, "@exception An exception is thrown if an error occurs on the SQL execution or if the key is not part of the result.");
+
+//! $(CLASSICSESSION_RUNSQLPAGED_BRIEF)
+//! $(CLASSICSESSION_RUNSQLPAGED_PARAM)
+//! $(CLASSICSESSION_RUNSQLPAGED_PARAM1)
+//! $(CLASSICSESSION_RUNSQLPAGED_PARAM2)
+/**
+* $(CLASSICSESSION_RUNSQLPAGED_RETURN)
+*
+* $(CLASSICSESSION_RUNSQLPAGED_DETAIL)
+*
+* $(CLASSICSESSION_RUNSQLPAGED_DETAIL1)
+* $(CLASSICSESSION_RUNSQLPAGED_DETAIL2)
+*
+* $(CLASSICSESSION_RUNSQLPAGED_EXCEPTION)
+*/
+#if DOXYGEN_JS
+ClassicResult ClassicSession::runSqlPaged(String query, List key, Map options) {}
+#elif DOXYGEN_PY
+ClassicResult ClassicSession::run_sql_paged(str query, list key, dict options) {}
+#endif
+Value ClassicSession::run_sql_paged(const shcore::Argument_list &args) const {
+  args.ensure_count(2, 3, get_function_name("runSqlPaged").c_str());
+
+  Value ret_val;
+  if (!_conn)
+    throw Exception::logic_error("Not connected.");
+
+  try {
+    std::string query = args.string_at(0);
+    std::vector<std::string> key;
+    size_t chunk_size = CLASSICSESSION_PAGED_DEFAULT_CHUNK_SIZE;
+
+    if (query.empty())
+      throw Exception::argument_error("No query specified.");
+
+    if (args[1].type == shcore::String) {
+      key.push_back(args.string_at(1));
+    } else if (args[1].type == shcore::Array) {
+      for (auto &column : *args.array_at(1)) {
+        if (column.type != shcore::String)
+          throw Exception::argument_error("The key columns must be strings");
+        key.push_back(column.as_string());
+      }
+    } else {
+      throw Exception::argument_error("Argument #2 is expected to be either a string or a list of strings");
+    }
+
+    if (key.empty())
+      throw Exception::argument_error("At least one key column is required");
+
+    if (args.size() == 3) {
+      shcore::Argument_map options(*args.map_at(2));
+      options.ensure_keys({}, {"chunkSize"}, "paging options");
+
+      if (options.has_key("chunkSize")) {
+        chunk_size = options.uint_at("chunkSize");
+        if (chunk_size == 0)
+          throw Exception::argument_error("The value for 'chunkSize' must be greater than 0");
+      }
+    }
+
+    std::string first_page = ClassicResult::keyset_page_query(query, key, std::vector<std::string>(), chunk_size);
+    std::shared_ptr<ClassicResult> result(run_statement(*this, _conn, first_page, query));
+    result->set_keyset_paging(_conn, query, key, chunk_size);
+
+    ret_val = shcore::Value(std::static_pointer_cast<Object_bridge>(result));
+  } catch (shcore::Exception & e) {
+    std::shared_ptr<ClassicSession> myself = std::const_pointer_cast<ClassicSession>(shared_from_this());
+
+    if (e.code() == 2006 || e.code() == 5166 || e.code() == 2013)
+      ShellNotifications::get()->notify("SN_SESSION_CONNECTION_LOST", std::dynamic_pointer_cast<Cpp_object_bridge>(myself));
+
+    throw;
+  }
+
+  return ret_val;
+}
+
 shcore::Value ClassicSession::execute_sql(const std::string& query, const shcore::Argument_list &UNUSED(args)) const {
   Value ret_val;
   if (!_conn)
@@ -204,7 +471,7 @@ shcore::Value ClassicSession::execute_sql(const std::string& query, const shcore
     if (query.empty())
       throw Exception::argument_error("No query specified.");
     else
-      ret_val = Value::wrap(new ClassicResult(std::shared_ptr<Result>(_conn->run_sql(query))));
+      ret_val = Value(std::static_pointer_cast<Object_bridge>(run_statement(*this, _conn, query, query)));
   }
   return ret_val;
 }
@@ -218,7 +485,7 @@ std::shared_ptr<ClassicResult> ClassicSession::execute_sql(const std::string& qu
     if (query.empty())
       throw Exception::argument_error("No query specified.");
     else
-      return std::shared_ptr<ClassicResult>(new ClassicResult(std::shared_ptr<Result>(_conn->run_sql(query))));
+      return run_statement(*this, _conn, query, query);
   }
 }
 #endif
@@ -80,7 +80,11 @@ public:
   // Virtual methods from ISession
   virtual shcore::Value connect(const shcore::Argument_list &args);
   virtual shcore::Value close(const shcore::Argument_list &args);
+  shcore::Value reset(const shcore::Argument_list &args);
+  virtual void reset_state();
   virtual shcore::Value run_sql(const shcore::Argument_list &args) const;
+  shcore::Value run_sql_paged(const shcore::Argument_list &args) const;
+  shcore::Value prepare(const shcore::Argument_list &args) const;
   virtual shcore::Value create_schema(const shcore::Argument_list &args);
   virtual shcore::Value startTransaction(const shcore::Argument_list &args);
   virtual shcore::Value commit(const shcore::Argument_list &args);
@@ -102,7 +106,15 @@ public:
 
   Connection *connection();
 
-  virtual uint64_t get_connection_id() const { return (uint64_t)_conn->get_thread_id(); }
+  // Opens a new connection with the connection data of this session, with
+  // local_infile it accepts LOAD DATA LOCAL through run_load_data_local
+  std::shared_ptr<Connection> open_connection(bool local_infile) const;
+
+  // Taken when connected, asking the connection would discard the result
+  // being read
+  virtual uint64_t get_connection_id() const { return _connection_id; }
+  virtual void kill_query();
+  virtual shcore::Slow_statement_log::Explain slow_statement_explain() const;
 
   virtual shcore::Value execute_sql(const std::string& query, const shcore::Argument_list &args) const;
 
@@ -119,7 +131,10 @@ public:
   List getSchemas();
   String getUri();
   ClassicResult runSql(String query);
+  ClassicResult runSqlPaged(String query, List key, Map options);
+  ClassicStatement prepare(String query);
   Undefined close();
+  Undefined reset();
   ClassicResult startTransaction();
   ClassicResult commit();
   ClassicResult rollback();
@@ -139,7 +154,10 @@ public:
   list get_schemas();
   str get_uri();
   ClassicResult run_sql(str query);
+  ClassicResult run_sql_paged(str query, list key, dict options);
+  ClassicStatement prepare(str query);
   None close();
+  None reset();
   ClassicResult start_transaction();
   ClassicResult commit();
   ClassicResult rollback();
@@ -157,6 +175,7 @@ public:
   bool is_open() {}
 #endif
   virtual bool is_connected() const { return _conn ? true : false; }
+  virtual bool ping() { return _conn && _conn->ping(); }
 
   virtual int get_default_port() { return 3306; };
 
@@ -165,6 +184,16 @@ private:
   std::string _retrieve_current_schema();
   void _remove_schema(const std::string& name);
   std::shared_ptr<Connection> _conn;
+  uint64_t _connection_id;
+  // Opened by kill_query(), not shared with the copies of the session
+  std::shared_ptr<Connection> _kill_conn;
+
+  // Protocol compression given on the connection data, also used on the
+  // connections opened with open_connection
+  std::string _compression;
+  int _compression_level;
+  // Seconds to wait on the network, 0 for the defaults of the client library
+  int _timeout;
 };
 };
 };
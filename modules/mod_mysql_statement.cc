@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mod_mysql_statement.h"
+#include "mod_mysql_resultset.h"
+#include "mysql_connection.h"
+#include "utils/utils_help.h"
+#include "mysqlxtest_utils.h"
+
+using namespace std::placeholders;
+using namespace mysqlsh::mysql;
+
+// Documentation of the ClassicStatement class
+REGISTER_HELP(CLASSICSTATEMENT_BRIEF, "A statement prepared on the server through the MySQL Protocol.");
+REGISTER_HELP(CLASSICSTATEMENT_DETAIL, "The statement is parsed once by the server and can be executed "\
+"any number of times with different parameters, given in place of the ? placeholders. Its rows arrive "\
+"in the binary protocol, so numbers and dates are not converted from text.");
+
+ClassicStatement::ClassicStatement(std::shared_ptr<Statement> statement, const std::string &sql)
+  : _statement(statement), _sql(sql) {
+  add_property("parameterCount", "getParameterCount");
+
+  add_varargs_method("execute", std::bind(&ClassicStatement::execute, this, _1));
+  add_method("bindStream", std::bind(&ClassicStatement::bind_stream, this, _1), "index", shcore::Integer, "path", shcore::String, NULL);
+  add_method("close", std::bind(&ClassicStatement::close, this, _1), "data");
+}
+
+ClassicStatement::~ClassicStatement() {}
+
+shcore::Value ClassicStatement::get_member(const std::string &prop) const {
+  if (prop == "parameterCount")
+    return shcore::Value(static_cast<uint64_t>(_statement->param_count()));
+
+  return Cpp_object_bridge::get_member(prop);
+}
+
+// Documentation of the execute function
+REGISTER_HELP(CLASSICSTATEMENT_EXECUTE_BRIEF, "Executes the statement with the given parameters.");
+REGISTER_HELP(CLASSICSTATEMENT_EXECUTE_PARAM, "@param param The value for each ? placeholder, in order, "\
+"or a single list with all of them.");
+REGISTER_HELP(CLASSICSTATEMENT_EXECUTE_RETURN, "@return A ClassicResult object.");
+REGISTER_HELP(CLASSICSTATEMENT_EXECUTE_DETAIL, "The rows of the result can be read until the statement "\
+"is executed again. Only the first result set of the statement is kept.");
+
+/**
+* $(CLASSICSTATEMENT_EXECUTE_BRIEF)
+*
+* $(CLASSICSTATEMENT_EXECUTE_PARAM)
+* $(CLASSICSTATEMENT_EXECUTE_RETURN)
+*
+* $(CLASSICSTATEMENT_EXECUTE_DETAIL)
+*/
+#if DOXYGEN_JS
+ClassicResult ClassicStatement::execute(Value param, ...) {}
+#elif DOXYGEN_PY
+ClassicResult ClassicStatement::execute(Value param, ...) {}
+#endif
+shcore::Value ClassicStatement::execute(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  try {
+    std::vector<shcore::Value> params(args.begin(), args.end());
+    if (args.size() == 1 && args[0].type == shcore::Array)
+      params.assign(args[0].as_array()->begin(), args[0].as_array()->end());
+
+    uint64_t server_time = 0;
+    std::shared_ptr<Result> inner_result;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      inner_result.reset(_statement->execute(params).release());
+    }
+
+    std::shared_ptr<ClassicResult> result(new ClassicResult(inner_result));
+    result->set_statement(_sql, server_time);
+    // The ? placeholders can't be explained
+    if (shcore::Slow_statement_log::enabled())
+      result->watch_slow(_sql, server_time, nullptr);
+    ret_val = shcore::Value(std::static_pointer_cast<shcore::Object_bridge>(result));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("execute"));
+
+  return ret_val;
+}
+
+// Documentation of the bindStream function
+REGISTER_HELP(CLASSICSTATEMENT_BINDSTREAM_BRIEF, "Sends the contents of a file as a parameter on the next execution.");
+REGISTER_HELP(CLASSICSTATEMENT_BINDSTREAM_PARAM, "@param index The position of the ? placeholder, starting at 0.");
+REGISTER_HELP(CLASSICSTATEMENT_BINDSTREAM_PARAM1, "@param path The file to be sent.");
+REGISTER_HELP(CLASSICSTATEMENT_BINDSTREAM_RETURN, "@return This ClassicStatement object.");
+REGISTER_HELP(CLASSICSTATEMENT_BINDSTREAM_DETAIL, "The file is sent to the server in chunks, so large binary values "\
+"can be inserted without loading them in memory. The value given to execute() for the parameter is ignored, "\
+"null can be used. Only the next execution uses the file.");
+
+/**
+* $(CLASSICSTATEMENT_BINDSTREAM_BRIEF)
+*
+* $(CLASSICSTATEMENT_BINDSTREAM_PARAM)
+* $(CLASSICSTATEMENT_BINDSTREAM_PARAM1)
+* $(CLASSICSTATEMENT_BINDSTREAM_RETURN)
+*
+* $(CLASSICSTATEMENT_BINDSTREAM_DETAIL)
+*/
+#if DOXYGEN_JS
+ClassicStatement ClassicStatement::bindStream(Integer index, String path) {}
+#elif DOXYGEN_PY
+ClassicStatement ClassicStatement::bind_stream(int index, str path) {}
+#endif
+shcore::Value ClassicStatement::bind_stream(const shcore::Argument_list &args) {
+  args.ensure_count(2, get_function_name("bindStream").c_str());
+
+  try {
+    _statement->bind_stream(static_cast<size_t>(args.uint_at(0)), args.string_at(1));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("bindStream"));
+
+  return shcore::Value(std::static_pointer_cast<shcore::Object_bridge>(shared_from_this()));
+}
+
+// Documentation of the close function
+REGISTER_HELP(CLASSICSTATEMENT_CLOSE_BRIEF, "Releases the statement on the server.");
+REGISTER_HELP(CLASSICSTATEMENT_CLOSE_DETAIL, "The statement can not be executed after this. "\
+"It is also released when the object is no longer referenced.");
+
+/**
+* $(CLASSICSTATEMENT_CLOSE_BRIEF)
+*
+* $(CLASSICSTATEMENT_CLOSE_DETAIL)
+*/
+#if DOXYGEN_JS
+Undefined ClassicStatement::close() {}
+#elif DOXYGEN_PY
+None ClassicStatement::close() {}
+#endif
+shcore::Value ClassicStatement::close(const shcore::Argument_list &args) {
+  args.ensure_count(0, get_function_name("close").c_str());
+
+  try {
+    _statement->close();
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("close"));
+
+  return shcore::Value();
+}
+
+// Documentation of the getParameterCount function
+REGISTER_HELP(CLASSICSTATEMENT_GETPARAMETERCOUNT_BRIEF, "Returns the number of ? placeholders of the statement.");
+
+/**
+* $(CLASSICSTATEMENT_GETPARAMETERCOUNT_BRIEF)
+*/
+#if DOXYGEN_JS
+Integer ClassicStatement::getParameterCount() {}
+#elif DOXYGEN_PY
+int ClassicStatement::get_parameter_count() {}
+#endif
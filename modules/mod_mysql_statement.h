@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MOD_MYSQL_STATEMENT_H_
+#define _MOD_MYSQL_STATEMENT_H_
+
+#include "shellcore/types.h"
+#include "shellcore/types_cpp.h"
+
+namespace mysqlsh {
+namespace mysql {
+class Statement;
+class ClassicResult;
+
+/**
+* $(CLASSICSTATEMENT_BRIEF)
+*
+* $(CLASSICSTATEMENT_DETAIL)
+*
+* \code{.js}
+* var stmt = session.prepare("select * from sakila.actor where actor_id = ?");
+* for (var id = 1; id <= 10; id++)
+*   print(stmt.execute(id).fetchOne());
+* stmt.close();
+* \endcode
+*
+* \sa ClassicSession
+*/
+class SHCORE_PUBLIC ClassicStatement : public shcore::Cpp_object_bridge, public std::enable_shared_from_this<ClassicStatement> {
+public:
+  ClassicStatement(std::shared_ptr<Statement> statement, const std::string &sql);
+  virtual ~ClassicStatement();
+
+  virtual std::string class_name() const { return "ClassicStatement"; }
+  virtual bool operator == (const Object_bridge &other) const { return this == &other; }
+
+  virtual shcore::Value get_member(const std::string &prop) const;
+
+  shcore::Value execute(const shcore::Argument_list &args);
+  shcore::Value bind_stream(const shcore::Argument_list &args);
+  shcore::Value close(const shcore::Argument_list &args);
+
+#if DOXYGEN_JS
+  Integer parameterCount; //!< Same as getParameterCount()
+
+  Integer getParameterCount();
+  ClassicResult execute(Value param, ...);
+  ClassicStatement bindStream(Integer index, String path);
+  Undefined close();
+#elif DOXYGEN_PY
+  int parameter_count; //!< Same as get_parameter_count()
+
+  int get_parameter_count();
+  ClassicResult execute(Value param, ...);
+  ClassicStatement bind_stream(int index, str path);
+  None close();
+#endif
+
+private:
+  std::shared_ptr<Statement> _statement;
+  std::string _sql;
+};
+}
+}
+
+#endif
@@ -48,6 +48,7 @@ REGISTER_MODULE(Mysqlx, mysqlx) {
   REGISTER_VARARGS_FUNCTION(Mysqlx, get_node_session, getNodeSession);
   REGISTER_VARARGS_FUNCTION(Mysqlx, date_value, dateValue);
   REGISTER_FUNCTION(Mysqlx, expr, expr, "expression", shcore::String, NULL);
+  REGISTER_FUNCTION(Mysqlx, file_content, fileContent, "path", shcore::String, NULL);
 
   _type.reset(new Type());
   _index_type.reset(new IndexType());
@@ -138,6 +139,26 @@ DEFINE_FUNCTION(Mysqlx, expr) {
   return shcore::Value(Expression::create(args));
 }
 
+REGISTER_HELP(MYSQLX_FILECONTENT_BRIEF, "Creates a FileContent object to insert the contents of a file as a value.");
+REGISTER_HELP(MYSQLX_FILECONTENT_PARAM,  "@param path The file whose contents are the value");
+REGISTER_HELP(MYSQLX_FILECONTENT_DETAIL, "The object can be given as a value to TableInsert.values(), the file is read "\
+"straight into the message sent to the server as binary data, without creating a string for it first.");
+/**
+ * $(MYSQLX_FILECONTENT_BRIEF)
+ *
+ * $(MYSQLX_FILECONTENT_PARAM)
+ *
+ * $(MYSQLX_FILECONTENT_DETAIL)
+ */
+#if DOXYGEN_JS
+FileContent fileContent(String path){}
+#elif DOXYGEN_PY
+FileContent file_content(str path){}
+#endif
+DEFINE_FUNCTION(Mysqlx, file_content) {
+  return shcore::Value(FileContent::create(args));
+}
+
 DEFINE_FUNCTION(Mysqlx, date_value) {
   return shcore::Value(shcore::Date::create(args));
 }
@@ -62,11 +62,13 @@ Types Types; //!< $(MYSQLX_TYPE_BRIEF)
 IndexType IndexType;  //!< $(MYSQLX_INDEXTYPE_BRIEF)
 NodeSession getNodeSession(ConnectionData connectionData, String password);
 Expression expr(String expressionStr);
+FileContent fileContent(String path);
 #elif DOXYGEN_PY
 Types Types; //!< $(MYSQLX_TYPE_BRIEF)
 IndexType IndexType;  //!< $(MYSQLX_INDEXTYPE_BRIEF)
 NodeSession get_node_session(ConnectionData connectionData, str password);
 Expression expr(str expressionStr);
+FileContent file_content(str path);
 #endif
 
 DECLARE_MODULE(Mysqlx, mysqlx);
@@ -74,6 +76,7 @@ DECLARE_MODULE(Mysqlx, mysqlx);
 //DECLARE_FUNCTION(get_session);
 DECLARE_FUNCTION(get_node_session);
 DECLARE_FUNCTION(expr);
+DECLARE_FUNCTION(file_content);
 DECLARE_FUNCTION(date_value);
 
 // We need to hide this from doxygen to avoif warnings
@@ -26,8 +26,12 @@
 #include "mod_mysqlx_collection_modify.h"
 #include "mod_mysqlx_collection_create_index.h"
 #include "mod_mysqlx_collection_drop_index.h"
+#include "mod_mysqlx_session.h"
 #include "utils/utils_help.h"
 
+// Ids on each statement of modifyMany and removeMany when not specified
+#define COLLECTION_MANY_DEFAULT_CHUNK_SIZE 1000
+
 using namespace std::placeholders;
 using namespace mysqlsh;
 using namespace mysqlsh::mysqlx;
@@ -52,6 +56,10 @@ void Collection::init() {
   add_method("remove", std::bind(&Collection::remove_, this, _1), "searchCriteria", shcore::String, NULL);
   add_method("createIndex", std::bind(&Collection::create_index_, this, _1), "searchCriteria", shcore::String, NULL);
   add_method("dropIndex", std::bind(&Collection::drop_index_, this, _1), "searchCriteria", shcore::String, NULL);
+  add_varargs_method("createIndexes", std::bind(&Collection::create_indexes_, this, _1));
+  add_varargs_method("count", std::bind(&Collection::count_, this, _1));
+  add_varargs_method("modifyMany", std::bind(&Collection::modify_many_, this, _1));
+  add_varargs_method("removeMany", std::bind(&Collection::remove_many_, this, _1));
 }
 
 Collection::~Collection() {}
@@ -646,6 +654,10 @@ shcore::Value Collection::create_index_(const shcore::Argument_list &args) {
   return createIndex->create_index(args);
 }
 
+shcore::Value Collection::create_indexes_(const shcore::Argument_list &args) {
+  return CollectionCreateIndex::create_indexes(shared_from_this(), args);
+}
+
 REGISTER_HELP(COLLECTION_DROPINDEX_BRIEF, "Drops an index from a collection.");
 REGISTER_HELP(COLLECTION_DROPINDEX_CHAINED, "CollectionDropIndex.dropIndex.[execute]");
 
@@ -698,3 +710,167 @@ shcore::Value Collection::drop_index_(const shcore::Argument_list &args) {
 
   return dropIndex->drop_index(args);
 }
+
+REGISTER_HELP(COLLECTION_COUNT_BRIEF, "Returns the number of documents in the collection.");
+REGISTER_HELP(COLLECTION_COUNT_PARAM, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTION_COUNT_RETURN, "@return The number of documents in the collection.");
+REGISTER_HELP(COLLECTION_COUNT_DETAIL, "The documents are counted by the server, only the count is sent back. To count the documents matching a search condition use find(searchCondition).count().");
+REGISTER_HELP(COLLECTION_COUNT_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTION_COUNT_DETAIL2, "@li approximate: whether to return the estimate kept by the storage engine instead, "\
+"which is read at once but may be far off, by default false.");
+
+/**
+* $(COLLECTION_COUNT_BRIEF)
+*
+* $(COLLECTION_COUNT_PARAM)
+*
+* $(COLLECTION_COUNT_RETURN)
+*
+* $(COLLECTION_COUNT_DETAIL)
+*
+* $(COLLECTION_COUNT_DETAIL1)
+* $(COLLECTION_COUNT_DETAIL2)
+*/
+#if DOXYGEN_JS
+Integer Collection::count(Dictionary options) {}
+#elif DOXYGEN_PY
+int Collection::count(dict options) {}
+#endif
+shcore::Value Collection::count_(const shcore::Argument_list &args) {
+  args.ensure_count(0, 1, "Collection.count");
+
+  shcore::Value ret_val;
+
+  try {
+    bool approximate = false;
+    if (args.size() == 1) {
+      shcore::Argument_map opt_map(*args.map_at(0));
+      opt_map.ensure_keys({}, {"approximate"}, "count options");
+
+      if (opt_map.has_key("approximate"))
+        approximate = opt_map.bool_at("approximate");
+    }
+
+    if (approximate) {
+      auto session = std::dynamic_pointer_cast<BaseSession>(_session.lock());
+      if (!session)
+        throw shcore::Exception::logic_error("Unable to count the documents of '" + _name + "', no Session available");
+
+      ret_val = shcore::Value(session->estimate_row_count(_collection_impl->schema()->name(), _name));
+    } else {
+      std::shared_ptr<CollectionFind> collectionFind(new CollectionFind(shared_from_this()));
+      collectionFind->find(shcore::Argument_list());
+      ret_val = collectionFind->count(shcore::Argument_list());
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION("Collection.count");
+
+  return ret_val;
+}
+
+namespace {
+size_t chunk_size_option(const shcore::Argument_list &args, const std::string &function) {
+  size_t chunk_size = COLLECTION_MANY_DEFAULT_CHUNK_SIZE;
+  if (args.size() == 2) {
+    shcore::Argument_map opt_map(*args.map_at(1));
+    opt_map.ensure_keys({}, {"chunkSize"}, (function + " options").c_str());
+
+    if (opt_map.has_key("chunkSize"))
+      chunk_size = static_cast<size_t>(opt_map.uint_at("chunkSize"));
+
+    if (chunk_size == 0)
+      throw shcore::Exception::argument_error("The value for 'chunkSize' must be a positive integer");
+  }
+
+  if (args[0].type != shcore::Array)
+    throw shcore::Exception::argument_error("Argument #1 is expected to be a list of document ids");
+
+  return chunk_size;
+}
+}
+
+REGISTER_HELP(COLLECTION_MODIFYMANY_BRIEF, "Creates a collection update handler for the documents with the given ids.");
+REGISTER_HELP(COLLECTION_MODIFYMANY_PARAM, "@param ids The list of the _id of the documents to be updated.");
+REGISTER_HELP(COLLECTION_MODIFYMANY_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTION_MODIFYMANY_RETURN, "@return A CollectionModify object.");
+REGISTER_HELP(COLLECTION_MODIFYMANY_DETAIL, "This is the same as modify('_id IN :ids'), except that execute() sends the ids in chunks, "\
+"each one as a statement of its own, and returns a dictionary with the affectedItemCount and the number of chunks.");
+REGISTER_HELP(COLLECTION_MODIFYMANY_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTION_MODIFYMANY_DETAIL2, "@li chunkSize: the number of ids on each statement, by default 1000.");
+REGISTER_HELP(COLLECTION_MODIFYMANY_DETAIL3, "A transaction should be used if all the documents must be updated or none.");
+
+/**
+* $(COLLECTION_MODIFYMANY_BRIEF)
+*
+* $(COLLECTION_MODIFYMANY_PARAM)
+* $(COLLECTION_MODIFYMANY_PARAM1)
+*
+* $(COLLECTION_MODIFYMANY_RETURN)
+*
+* $(COLLECTION_MODIFYMANY_DETAIL)
+*
+* $(COLLECTION_MODIFYMANY_DETAIL1)
+* $(COLLECTION_MODIFYMANY_DETAIL2)
+*
+* $(COLLECTION_MODIFYMANY_DETAIL3)
+*/
+#if DOXYGEN_JS
+CollectionModify Collection::modifyMany(List ids, Dictionary options) {}
+#elif DOXYGEN_PY
+CollectionModify Collection::modify_many(list ids, dict options) {}
+#endif
+shcore::Value Collection::modify_many_(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, "Collection.modifyMany");
+
+  std::shared_ptr<CollectionModify> collectionModify(new CollectionModify(shared_from_this()));
+
+  try {
+    collectionModify->modify_many(args[0], chunk_size_option(args, "modifyMany"));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION("Collection.modifyMany");
+
+  return shcore::Value(std::static_pointer_cast<Object_bridge>(collectionModify));
+}
+
+REGISTER_HELP(COLLECTION_REMOVEMANY_BRIEF, "Removes the documents with the given ids.");
+REGISTER_HELP(COLLECTION_REMOVEMANY_PARAM, "@param ids The list of the _id of the documents to be removed.");
+REGISTER_HELP(COLLECTION_REMOVEMANY_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTION_REMOVEMANY_RETURN, "@return A dictionary with the affectedItemCount and the number of chunks.");
+REGISTER_HELP(COLLECTION_REMOVEMANY_DETAIL, "The ids are sent in chunks, each one as a remove('_id IN :ids') statement of its own.");
+REGISTER_HELP(COLLECTION_REMOVEMANY_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTION_REMOVEMANY_DETAIL2, "@li chunkSize: the number of ids on each statement, by default 1000.");
+REGISTER_HELP(COLLECTION_REMOVEMANY_DETAIL3, "A transaction should be used if all the documents must be removed or none.");
+
+/**
+* $(COLLECTION_REMOVEMANY_BRIEF)
+*
+* $(COLLECTION_REMOVEMANY_PARAM)
+* $(COLLECTION_REMOVEMANY_PARAM1)
+*
+* $(COLLECTION_REMOVEMANY_RETURN)
+*
+* $(COLLECTION_REMOVEMANY_DETAIL)
+*
+* $(COLLECTION_REMOVEMANY_DETAIL1)
+* $(COLLECTION_REMOVEMANY_DETAIL2)
+*
+* $(COLLECTION_REMOVEMANY_DETAIL3)
+*/
+#if DOXYGEN_JS
+Dictionary Collection::removeMany(List ids, Dictionary options) {}
+#elif DOXYGEN_PY
+dict Collection::remove_many(list ids, dict options) {}
+#endif
+shcore::Value Collection::remove_many_(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, "Collection.removeMany");
+
+  shcore::Value ret_val;
+
+  try {
+    std::shared_ptr<CollectionRemove> collectionRemove(new CollectionRemove(shared_from_this()));
+    ret_val = collectionRemove->remove_many(args[0], chunk_size_option(args, "removeMany"));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION("Collection.removeMany");
+
+  return ret_val;
+}
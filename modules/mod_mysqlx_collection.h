@@ -53,7 +53,11 @@ public:
   CollectionModify modify(String searchCondition);
   CollectionCreateIndex createIndex(String name);
   CollectionCreateIndex createIndex(String name, IndexType type);
+  Result createIndexes(List indexes);
   CollectionDropIndex dropIndex(String name);
+  Integer count(Dictionary options);
+  CollectionModify modifyMany(List ids, Dictionary options);
+  Dictionary removeMany(List ids, Dictionary options);
 #elif DOXYGEN_PY
   CollectionAdd add(...);
   CollectionFind find(...);
@@ -61,14 +65,22 @@ public:
   CollectionModify modify(str search_condition);
   CollectionCreateIndex create_index(str name);
   CollectionCreateIndex create_index(str name, IndexType type);
+  Result create_indexes(list indexes);
   CollectionDropIndex drop_index(str name);
+  int count(dict options);
+  CollectionModify modify_many(list ids, dict options);
+  dict remove_many(list ids, dict options);
 #endif
   shcore::Value add_(const shcore::Argument_list &args);
   shcore::Value find_(const shcore::Argument_list &args);
   shcore::Value modify_(const shcore::Argument_list &args);
   shcore::Value remove_(const shcore::Argument_list &args);
   shcore::Value create_index_(const shcore::Argument_list &args);
+  shcore::Value create_indexes_(const shcore::Argument_list &args);
   shcore::Value drop_index_(const shcore::Argument_list &args);
+  shcore::Value count_(const shcore::Argument_list &args);
+  shcore::Value modify_many_(const shcore::Argument_list &args);
+  shcore::Value remove_many_(const shcore::Argument_list &args);
 
 private:
   void init();
@@ -79,6 +91,7 @@ private:
   friend shcore::Value CollectionFind::find(const shcore::Argument_list &args);
   friend shcore::Value CollectionRemove::remove(const shcore::Argument_list &args);
   friend shcore::Value CollectionModify::modify(const shcore::Argument_list &args);
+  friend shcore::Value CollectionRemove::remove_many(shcore::Value ids, size_t chunk_size);
 };
 }
 }
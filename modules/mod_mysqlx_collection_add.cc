@@ -25,14 +25,125 @@
 #include "utils/utils_time.h"
 #include "utils/utils_help.h"
 
-#include <iomanip>
-#include <sstream>
 #include <boost/format.hpp>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <cstring>
 
 using namespace std::placeholders;
 using namespace mysqlsh::mysqlx;
 using namespace shcore;
 
+// Number of chunks kept in flight by execute when chunkSize is specified
+#define COLLECTIONADD_DEFAULT_PIPELINE_DEPTH 4
+
+namespace {
+// Builds the document expression directly from the shell value, avoiding
+// serializing the document to JSON only to be parsed back by Expr_parser
+Mysqlx::Expr::Expr *value_to_expr(const shcore::Value &value) {
+  switch (value.type) {
+    case shcore::Null:
+      return ::mysqlx::Expr_builder::build_literal_expr(::mysqlx::Expr_builder::build_null_scalar());
+    case shcore::Bool:
+      return ::mysqlx::Expr_builder::build_literal_expr(::mysqlx::Expr_builder::build_bool_scalar(value.as_bool()));
+    case shcore::String:
+      return ::mysqlx::Expr_builder::build_literal_expr(::mysqlx::Expr_builder::build_string_scalar(value.as_string()));
+    case shcore::Integer:
+      return ::mysqlx::Expr_builder::build_literal_expr(::mysqlx::Expr_builder::build_int_scalar(value.as_int()));
+    case shcore::UInteger: {
+      Mysqlx::Datatypes::Scalar *scalar = new Mysqlx::Datatypes::Scalar();
+      scalar->set_type(Mysqlx::Datatypes::Scalar::V_UINT);
+      scalar->set_v_unsigned_int(value.as_uint());
+      return ::mysqlx::Expr_builder::build_literal_expr(scalar);
+    }
+    case shcore::Float:
+      return ::mysqlx::Expr_builder::build_literal_expr(::mysqlx::Expr_builder::build_double_scalar(value.as_double()));
+    case shcore::Map: {
+      std::unique_ptr<Mysqlx::Expr::Expr> expr(new Mysqlx::Expr::Expr());
+      expr->set_type(Mysqlx::Expr::Expr_Type_OBJECT);
+      Mysqlx::Expr::Object *object = expr->mutable_object();
+      for (auto &field : *value.as_map()) {
+        Mysqlx::Expr::Object_ObjectField *object_field = object->add_fld();
+        object_field->set_key(field.first);
+        object_field->set_allocated_value(value_to_expr(field.second));
+      }
+      return expr.release();
+    }
+    case shcore::Array: {
+      std::unique_ptr<Mysqlx::Expr::Expr> expr(new Mysqlx::Expr::Expr());
+      expr->set_type(Mysqlx::Expr::Expr_Type_ARRAY);
+      Mysqlx::Expr::Array *array = expr->mutable_array();
+      for (auto &item : *value.as_array())
+        array->mutable_value()->AddAllocated(value_to_expr(item));
+      return expr.release();
+    }
+    default: {
+      // Anything else is converted the same way it was done through JSON
+      ::mysqlx::Expr_parser parser(value.json(), true);
+      return parser.expr();
+    }
+  }
+}
+
+// SAX handler looking only at the top level members of a JSON document, to
+// find its _id without building the document
+class Id_scanner {
+public:
+  Id_scanner() : object(false), empty(true), has_id(false), string_id(false), _depth(0), _id_key(false) {}
+
+  bool Null() { return value(false); }
+  bool Bool(bool) { return value(false); }
+  bool Int(int) { return value(false); }
+  bool Uint(unsigned) { return value(false); }
+  bool Int64(int64_t) { return value(false); }
+  bool Uint64(uint64_t) { return value(false); }
+  bool Double(double) { return value(false); }
+  bool RawNumber(const char *, rapidjson::SizeType, bool) { return value(false); }
+  bool String(const char *, rapidjson::SizeType, bool) { return value(true); }
+
+  bool StartObject() {
+    if (_depth == 0)
+      object = true;
+    value(false);
+    _depth++;
+    return true;
+  }
+  bool Key(const char *str, rapidjson::SizeType length, bool) {
+    if (_depth == 1) {
+      empty = false;
+      _id_key = length == 3 && memcmp(str, "_id", 3) == 0;
+    }
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType) { _depth--; return true; }
+
+  bool StartArray() {
+    value(false);
+    _depth++;
+    return true;
+  }
+  bool EndArray(rapidjson::SizeType) { _depth--; return true; }
+
+  bool object;
+  bool empty;
+  bool has_id;
+  bool string_id;
+
+private:
+  bool value(bool is_string) {
+    if (_depth == 1 && _id_key) {
+      has_id = true;
+      string_id = is_string;
+      _id_key = false;
+    }
+    return true;
+  }
+
+  int _depth;
+  bool _id_key;
+};
+}
+
 CollectionAdd::CollectionAdd(std::shared_ptr<Collection> owner)
   :Collection_crud_definition(std::static_pointer_cast<DatabaseObject>(owner)) {
   // Exposes the methods available for chaining
@@ -143,7 +254,6 @@ shcore::Value CollectionAdd::add(const shcore::Argument_list &args) {
           for (index = 0; index < size; index++) {
             Value element = shell_docs->at(index);
 
-            ::mysqlx::Document inner_doc;
             Value::Map_type_ref shell_doc;
 
             // Validation of the incoming parameter
@@ -151,7 +261,28 @@ shcore::Value CollectionAdd::add(const shcore::Argument_list &args) {
                shell_doc = element.as_map();
             else if (element.type == Object && element.as_object()->class_name() == "Expression") {
               std::shared_ptr<mysqlx::Expression> expression = std::static_pointer_cast<mysqlx::Expression>(element.as_object());
-              shcore::Value document = shcore::Value::parse(expression->get_data());
+              std::string data = expression->get_data();
+
+              // Strict JSON goes to the server as it is, only the _id is
+              // spliced in when missing. The rest, e.g. single quoted
+              // strings, is parsed into a document as before.
+              rapidjson::MemoryStream stream(data.data(), data.size());
+              rapidjson::Reader reader;
+              Id_scanner scanner;
+              if (!reader.Parse(stream, scanner).IsError() && scanner.object) {
+                if (!scanner.has_id) {
+                  size_t open = data.find('{');
+                  std::string id = "\"_id\":\"" + get_new_uuid() + "\"";
+                  data.insert(open + 1, scanner.empty ? id : id + ",");
+                } else if (!scanner.string_id) {
+                  throw shcore::Exception::argument_error("Invalid data type for _id field, should be a string");
+                }
+
+                _add_statement->addJson(data.data(), data.size());
+                continue;
+              }
+
+              shcore::Value document = shcore::Value::parse(data);
               if (document.type == Map)
                 shell_doc = document.as_map();
               else
@@ -168,11 +299,8 @@ shcore::Value CollectionAdd::add(const shcore::Argument_list &args) {
 
               // No matter how the document was received, gets passed as expression to the
               // backend
-              inner_doc.reset(shcore::Value(shell_doc).json(), true, (*shell_doc)["_id"].as_string());
+              _add_statement->add(value_to_expr(shcore::Value(shell_doc)));
             }
-
-            // We have a document so it gets added!
-            _add_statement->add(inner_doc);
           }
 
           // Updates the exposed functions (since a document has been added)
@@ -187,32 +315,34 @@ shcore::Value CollectionAdd::add(const shcore::Argument_list &args) {
 }
 
 std::string CollectionAdd::get_new_uuid() {
-  uuid_type uuid;
-  generate_uuid(uuid);
-
-  std::stringstream str;
-  str << std::hex << std::noshowbase << std::setfill('0') << std::setw(2);
-  //*
-  str << (int)uuid[0] << std::setw(2) << (int)uuid[1] << std::setw(2) << (int)uuid[2] << std::setw(2) << (int)uuid[3];
-  str << std::setw(2) << (int)uuid[4] << std::setw(2) << (int)uuid[5];
-  str << std::setw(2) << (int)uuid[6] << std::setw(2) << (int)uuid[7];
-  str << std::setw(2) << (int)uuid[8] << std::setw(2) << (int)uuid[9];
-  str << std::setw(2) << (int)uuid[10] << std::setw(2) << (int)uuid[11]
-    << std::setw(2) << (int)uuid[12] << std::setw(2) << (int)uuid[13]
-    << std::setw(2) << (int)uuid[14] << std::setw(2) << (int)uuid[15];
-
-  return str.str();
+  return _uuids.next_hex();
 }
 
 REGISTER_HELP(COLLECTIONADD_EXECUTE_BRIEF, "Executes the add operation, the documents are added to the target collection.");
+REGISTER_HELP(COLLECTIONADD_EXECUTE_PARAM, "@param options Optional dictionary with options for bulk document addition.");
 REGISTER_HELP(COLLECTIONADD_EXECUTE_RETURN, "@return A Result object.");
-REGISTER_HELP(COLLECTIONADD_EXECUTE_SYNTAX, "execute()");
+REGISTER_HELP(COLLECTIONADD_EXECUTE_SYNTAX, "execute([options])");
+REGISTER_HELP(COLLECTIONADD_EXECUTE_DETAIL, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTIONADD_EXECUTE_DETAIL1, "@li chunkSize: maximum number of documents sent to the server on each message, "\
+"by default all the documents are sent in a single message.");
+REGISTER_HELP(COLLECTIONADD_EXECUTE_DETAIL2, "@li pipelineDepth: number of messages sent to the server before waiting for their results, "\
+"by default 4. Only used when chunkSize is specified.");
+REGISTER_HELP(COLLECTIONADD_EXECUTE_DETAIL3, "When the documents are split in several messages each one is processed independently by the server, "\
+"a transaction should be used if all the documents must be added or none.");
 
 /**
 * $(COLLECTIONADD_EXECUTE_BRIEF)
 *
+* $(COLLECTIONADD_EXECUTE_PARAM)
+*
 * $(COLLECTIONADD_EXECUTE_RETURN)
 *
+* $(COLLECTIONADD_EXECUTE_DETAIL)
+* $(COLLECTIONADD_EXECUTE_DETAIL1)
+* $(COLLECTIONADD_EXECUTE_DETAIL2)
+*
+* $(COLLECTIONADD_EXECUTE_DETAIL3)
+*
 * #### Method Chaining
 *
 * This function can be invoked once after:
@@ -241,7 +371,7 @@ REGISTER_HELP(COLLECTIONADD_EXECUTE_SYNTAX, "execute()");
 * $(COLLECTIONADD_ADD_DETAIL10)
 * \snippet js_devapi/scripts/mysqlx_collection_add.js CollectionAdd: Using an Expression
 */
-Result CollectionAdd::execute() {}
+Result CollectionAdd::execute(Dictionary options) {}
 #elif DOXYGEN_PY
 /**
 * #### Using a Document List
@@ -261,18 +391,35 @@ Result CollectionAdd::execute() {}
 * $(COLLECTIONADD_ADD_DETAIL10)
 * \snippet py_devapi/scripts/mysqlx_collection_add.py CollectionAdd: Using an Expression
 */
-Result CollectionAdd::execute() {}
+Result CollectionAdd::execute(dict options) {}
 #endif
 //@}
 shcore::Value CollectionAdd::execute(const shcore::Argument_list &args) {
   mysqlx::Result *result = NULL;
 
   try {
-    args.ensure_count(0, get_function_name("execute").c_str());
+    args.ensure_count(0, 1, get_function_name("execute").c_str());
+
+    size_t chunk_size = 0;
+    size_t pipeline_depth = COLLECTIONADD_DEFAULT_PIPELINE_DEPTH;
+
+    if (args.size() == 1) {
+      shcore::Argument_map options(*args.map_at(0));
+      options.ensure_keys({}, {"chunkSize", "pipelineDepth"}, "execute options");
+
+      if (options.has_key("chunkSize"))
+        chunk_size = options.uint_at("chunkSize");
+
+      if (options.has_key("pipelineDepth")) {
+        pipeline_depth = options.uint_at("pipelineDepth");
+        if (pipeline_depth == 0)
+          throw shcore::Exception::argument_error("The value for 'pipelineDepth' must be greater than 0");
+      }
+    }
 
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_add_statement->execute()));
+    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_add_statement->execute(chunk_size, pipeline_depth)));
     timer.end();
     result->set_execution_time(timer.raw_duration());
   }
@@ -24,6 +24,7 @@
 #define _MOD_CRUD_COLLECTION_ADD_H_
 
 #include "collection_crud_definition.h"
+#include "uuid_gen.h"
 
 namespace mysqlsh {
 namespace mysqlx {
@@ -46,21 +47,25 @@ public:
 
   shcore::Value add(const shcore::Argument_list &args);
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _add_statement.get(); }
 
 #if DOXYGEN_JS
   CollectionAdd add(DocDefinition document[, DocDefinition document, ...]);
   CollectionAdd add(List documents);
-  Result execute();
+  Result execute(Dictionary options);
 #elif DOXYGEN_PY
   CollectionAdd add(DocDefinition document[, DocDefinition document, ...]);
   CollectionAdd add(list documents);
-  Result execute();
+  Result execute(dict options);
 #endif
 
 private:
   std::string get_new_uuid();
 
   std::unique_ptr< ::mysqlx::AddStatement> _add_statement;
+
+  // Ids for documents without _id are taken from a reserved block
+  Uuid_block _uuids;
 };
 }
 }
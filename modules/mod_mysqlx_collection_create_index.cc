@@ -24,8 +24,14 @@
 #include "uuid_gen.h"
 #include "mysqlx_parser.h"
 #include "utils/utils_help.h"
+#include "utils/utils_sqlstring.h"
+#include "utils/utils_time.h"
 
+#include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
+#include <set>
 #include <sstream>
 #include <boost/format.hpp>
 
@@ -224,3 +230,188 @@ shcore::Value CollectionCreateIndex::execute(const shcore::Argument_list &args)
 
   return result;
 }
+
+namespace {
+struct Index_field {
+  std::string path;
+  std::string column;
+  std::string column_type;
+  // Of the key, for TEXT(n)
+  std::string length;
+  bool required;
+};
+
+// The generated columns have the $ix_ prefix of the ones added by
+// createIndex, so dropIndex removes them with the last index using them.
+// The same field and type always get the same column.
+std::string index_column_name(const std::string &path, const std::string &type, bool required) {
+  uint64_t hash = 14695981039346656037ULL;
+  std::string key = path + '\0' + type;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+  return std::string("$ix_") + (required ? "r_" : "") + hex;
+}
+
+Index_field parse_index_field(const shcore::Value &definition) {
+  shcore::Argument_map field(*definition.as_map());
+  field.ensure_keys({"field", "type"}, {"required"}, "index field");
+
+  Index_field ret_val;
+  ret_val.path = "$." + field.string_at("field");
+  ret_val.required = field.has_key("required") && field.bool_at("required");
+
+  std::string type = field.string_at("type");
+  for (auto &c : type) {
+    c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '(' && c != ')' && c != ',' && c != ' ')
+      throw shcore::Exception::argument_error("Invalid index field type: " + field.string_at("type"));
+  }
+
+  // TEXT can only be indexed on a prefix
+  ret_val.column_type = type;
+  if (type.compare(0, 5, "TEXT(") == 0 && type.back() == ')') {
+    ret_val.column_type = "TEXT";
+    ret_val.length = type.substr(5, type.size() - 6);
+  }
+
+  ret_val.column = index_column_name(ret_val.path, type, ret_val.required);
+  return ret_val;
+}
+
+// The value of the field in the type of the column, strings and dates are
+// unquoted first
+std::string index_column_expression(const Index_field &field) {
+  static const char *unquoted[] = {"TEXT", "CHAR", "VARCHAR", "DATE", "TIME", "YEAR"};
+
+  std::string ret_val = shcore::sqlstring("JSON_EXTRACT(doc, ?)", 0) << field.path;
+  for (auto prefix : unquoted) {
+    if (field.column_type.compare(0, strlen(prefix), prefix) == 0)
+      return "JSON_UNQUOTE(" + ret_val + ")";
+  }
+
+  return ret_val;
+}
+}
+
+// Documentation of createIndexes function
+REGISTER_HELP(COLLECTION_CREATEINDEXES_BRIEF, "Creates several indexes on a collection with a single statement.");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_PARAM, "@param indexes A list with the definition of every index.");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_RETURN, "@return A Result object.");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_DETAIL, "Every index is defined by a dictionary with the following attributes:");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_DETAIL1, "@li name: the name of the index.");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_DETAIL2, "@li unique: whether the index is unique, by default false.");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_DETAIL3, "@li fields: a list of dictionaries with the field (document path), the type (a MySQL data type) "\
+"and optionally whether the field is required, as the parameters of CollectionCreateIndex.field().");
+REGISTER_HELP(COLLECTION_CREATEINDEXES_DETAIL4, "The generated columns of the fields and the indexes are added by a single ALTER TABLE, "\
+"so the collection is processed once for all of them instead of once for each index. The columns are virtual and the "\
+"statement requests ALGORITHM=INPLACE, LOCK=NONE, falling back to the default algorithm when the server can not use it.");
+
+/**
+* $(COLLECTION_CREATEINDEXES_BRIEF)
+*
+* $(COLLECTION_CREATEINDEXES_PARAM)
+*
+* $(COLLECTION_CREATEINDEXES_RETURN)
+*
+* $(COLLECTION_CREATEINDEXES_DETAIL)
+* $(COLLECTION_CREATEINDEXES_DETAIL1)
+* $(COLLECTION_CREATEINDEXES_DETAIL2)
+* $(COLLECTION_CREATEINDEXES_DETAIL3)
+*
+* $(COLLECTION_CREATEINDEXES_DETAIL4)
+*/
+#if DOXYGEN_JS
+Result Collection::createIndexes(List indexes) {}
+#elif DOXYGEN_PY
+Result Collection::create_indexes(list indexes) {}
+#endif
+shcore::Value CollectionCreateIndex::create_indexes(std::shared_ptr<Collection> collection, const shcore::Argument_list &args) {
+  mysqlx::Result *result = NULL;
+
+  args.ensure_count(1, "Collection.createIndexes");
+
+  try {
+    std::string schema = collection->get_member("schema").as_object()->get_member("name").as_string();
+    std::string name = collection->get_member("name").as_string();
+    std::shared_ptr<BaseSession> session = std::static_pointer_cast<BaseSession>(collection->get_member("session").as_object());
+
+    // The columns already there, of other indexes, are reused
+    std::set<std::string> columns;
+    {
+      std::shared_ptr< ::mysqlx::Result> existing = session->execute_sql(
+          shcore::sqlstring("SELECT COLUMN_NAME FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?", 0) << schema << name);
+      while (std::shared_ptr< ::mysqlx::Row> row = existing->next())
+        columns.insert(row->stringField(0));
+    }
+
+    std::string clauses;
+    auto add_clause = [&clauses](const std::string &clause) {
+      clauses += (clauses.empty() ? " " : ", ") + clause;
+    };
+
+    shcore::Value::Array_type_ref indexes = args.array_at(0);
+    if (indexes->empty())
+      throw shcore::Exception::argument_error("At least one index must be defined");
+
+    for (auto &index : *indexes) {
+      if (index.type != shcore::Map)
+        throw shcore::Exception::argument_error("Every index is expected to be a dictionary");
+
+      shcore::Argument_map definition(*index.as_map());
+      definition.ensure_keys({"name", "fields"}, {"unique"}, "index definition");
+
+      shcore::Value::Array_type_ref fields = definition.array_at("fields");
+      if (fields->empty())
+        throw shcore::Exception::argument_error("The index '" + definition.string_at("name") + "' has no fields");
+
+      std::string key;
+      for (auto &field_definition : *fields) {
+        if (field_definition.type != shcore::Map)
+          throw shcore::Exception::argument_error("Every index field is expected to be a dictionary");
+
+        Index_field field = parse_index_field(field_definition);
+        if (columns.insert(field.column).second) {
+          add_clause(std::string(shcore::sqlstring("ADD COLUMN ! ", 0) << field.column) + field.column_type +
+                     " GENERATED ALWAYS AS (" + index_column_expression(field) + ") VIRTUAL" +
+                     (field.required ? " NOT NULL" : ""));
+        }
+
+        key += (key.empty() ? "" : ", ") + std::string(shcore::sqlstring("!", 0) << field.column);
+        if (!field.length.empty())
+          key += "(" + field.length + ")";
+      }
+
+      bool unique = definition.has_key("unique") && definition.bool_at("unique");
+      add_clause(std::string(shcore::sqlstring(unique ? "ADD UNIQUE INDEX ! (" : "ADD INDEX ! (", 0) << definition.string_at("name")) + key + ")");
+    }
+
+    std::string sql = shcore::sqlstring("ALTER TABLE !.!", 0) << schema << name;
+    sql += clauses;
+
+    MySQL_timer timer;
+    timer.start();
+    std::shared_ptr< ::mysqlx::Result> altered;
+    try {
+      altered = session->execute_sql(sql + ", ALGORITHM=INPLACE, LOCK=NONE");
+    } catch (::mysqlx::Error &e) {
+      // ER_ALTER_OPERATION_NOT_SUPPORTED(_REASON), the indexes are still
+      // created, only not in place
+      if (e.error() != 1845 && e.error() != 1846)
+        throw;
+
+      altered = session->execute_sql(sql);
+    }
+    timer.end();
+
+    result = new mysqlx::Result(altered);
+    result->set_execution_time(timer.raw_duration());
+  }
+  CATCH_AND_TRANSLATE_CRUD_EXCEPTION("Collection.createIndexes");
+
+  return result ? shcore::Value::wrap(result) : shcore::Value::Null();
+}
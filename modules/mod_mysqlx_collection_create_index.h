@@ -48,6 +48,9 @@ public:
   shcore::Value field(const shcore::Argument_list &args);
   virtual shcore::Value execute(const shcore::Argument_list &args);
 
+  // Creates all the indexes with a single ALTER TABLE
+  static shcore::Value create_indexes(std::shared_ptr<Collection> collection, const shcore::Argument_list &args);
+
 #if DOXYGEN_JS
   CollectionCreateIndex createIndex(String name);
   CollectionCreateIndex createIndex(String name, IndexType type);
@@ -25,6 +25,15 @@
 #include "mysqlxtest/common/expr_parser.h"
 #include "utils/utils_time.h"
 #include "utils/utils_help.h"
+#include "modules/mod_shell_dump.h"
+#include "modules/mod_mysqlx_index_advisor.h"
+
+// Sessions used by exportTo when not specified
+#define EXPORT_DEFAULT_THREADS 4
+
+// Documents on each chunk of exportTo when not specified
+#define EXPORT_DEFAULT_CHUNK_DOCS 500000
+#define EXPORT_DEFAULT_ROW_GROUP_ROWS 100000
 
 using namespace std::placeholders;
 using namespace mysqlsh::mysqlx;
@@ -41,6 +50,8 @@ CollectionFind::CollectionFind(std::shared_ptr<Collection> owner)
   add_method("skip", std::bind(&CollectionFind::skip, this, _1), "data");
   add_method("limit", std::bind(&CollectionFind::limit, this, _1), "data");
   add_method("bind", std::bind(&CollectionFind::bind, this, _1), "data");
+  add_varargs_method("exportTo", std::bind(&CollectionFind::export_to, this, _1));
+  add_method("count", std::bind(&CollectionFind::count, this, _1), NULL);
 
   // Registers the dynamic function behavior
   register_dynamic_function("find", "");
@@ -52,6 +63,9 @@ CollectionFind::CollectionFind(std::shared_ptr<Collection> owner)
   register_dynamic_function("skip", "limit");
   register_dynamic_function("bind", "find, fields, groupBy, having, sort, skip, limit, bind");
   register_dynamic_function("execute", "find, fields, groupBy, having, sort, skip, limit, bind");
+  register_dynamic_function("explain", "find, fields, groupBy, having, sort, skip, limit, bind");
+  register_dynamic_function("exportTo", "find, bind");
+  register_dynamic_function("count", "find, bind");
   register_dynamic_function("__shell_hook__", "find, fields, groupBy, having, sort, skip, limit, bind");
 
   // Initial function update
@@ -109,6 +123,10 @@ shcore::Value CollectionFind::find(const shcore::Argument_list &args) {
         search_condition = args.string_at(0);
 
       _find_statement.reset(new ::mysqlx::FindStatement(collection->_collection_impl->find(search_condition)));
+      _search_condition = search_condition;
+      _sort_criteria.clear();
+      _bindings.clear();
+      _list_bindings.clear();
 
       // Updates the exposed functions
       update_functions("find");
@@ -383,6 +401,7 @@ shcore::Value CollectionFind::sort(const shcore::Argument_list &args) {
       throw shcore::Exception::argument_error("Sort criteria can not be empty");
 
     _find_statement->sort(fields);
+    _sort_criteria = fields;
 
     update_functions("sort");
   }
@@ -532,7 +551,10 @@ shcore::Value CollectionFind::bind(const shcore::Argument_list &args) {
   args.ensure_count(2, "CollectionFind.bind");
 
   try {
-    _find_statement->bind(args.string_at(0), map_document_value(args[1]));
+    if (bind_value(*_find_statement, args.string_at(0), args[1]))
+      _list_bindings.push_back(std::make_pair(args.string_at(0), map_document_list(args[1])));
+    else
+      _bindings.push_back(std::make_pair(args.string_at(0), map_document_value(args[1])));
 
     update_functions("bind");
   }
@@ -542,14 +564,26 @@ shcore::Value CollectionFind::bind(const shcore::Argument_list &args) {
 }
 
 REGISTER_HELP(COLLECTIONFIND_EXECUTE_BRIEF, "Executes the find operation with all the configured options.");
+REGISTER_HELP(COLLECTIONFIND_EXECUTE_PARAM, "@param options Optional dictionary with options for the retrieval of the documents.");
 REGISTER_HELP(COLLECTIONFIND_EXECUTE_RETURNS, "@return A DocResult object that can be used to traverse the documents returned by this operation.");
-REGISTER_HELP(COLLECTIONFIND_EXECUTE_SYNTAX, "execute()");
+REGISTER_HELP(COLLECTIONFIND_EXECUTE_SYNTAX, "execute([options])");
+REGISTER_HELP(COLLECTIONFIND_EXECUTE_DETAIL, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTIONFIND_EXECUTE_DETAIL1, "@li fetchSize: number of documents the server sends at a time, the next ones are "\
+"requested as the result is read. Without it all the documents are sent at once.");
+REGISTER_HELP(COLLECTIONFIND_EXECUTE_DETAIL2, "The fetchSize is ignored by servers without support for cursors.");
 
 /**
 * $(COLLECTIONFIND_EXECUTE_BRIEF)
 *
+* $(COLLECTIONFIND_EXECUTE_PARAM)
+*
 * $(COLLECTIONFIND_EXECUTE_RETURNS)
 *
+* $(COLLECTIONFIND_EXECUTE_DETAIL)
+* $(COLLECTIONFIND_EXECUTE_DETAIL1)
+*
+* $(COLLECTIONFIND_EXECUTE_DETAIL2)
+*
 * #### Method Chaining
 *
 * This function can be invoked after any other function on this class.
@@ -584,7 +618,7 @@ REGISTER_HELP(COLLECTIONFIND_EXECUTE_SYNTAX, "execute()");
 * #### Parameter Binding
 * \snippet js_devapi/scripts/mysqlx_collection_find.js CollectionFind: Parameter Binding
 */
-DocResult CollectionFind::execute() {}
+DocResult CollectionFind::execute(Dictionary options) {}
 #elif DOXYGEN_PY
 /**
 * #### Retrieving All Documents
@@ -612,21 +646,250 @@ DocResult CollectionFind::execute() {}
 * #### Parameter Binding
 * \snippet py_devapi/scripts/mysqlx_collection_find.py CollectionFind: Parameter Binding
 */
-DocResult CollectionFind::execute() {}
+DocResult CollectionFind::execute(dict options) {}
 #endif
 //@}
 shcore::Value CollectionFind::execute(const shcore::Argument_list &args) {
   mysqlx::DocResult *result = NULL;
 
   try {
-    args.ensure_count(0, "CollectionFind.execute");
+    args.ensure_count(0, 1, "CollectionFind.execute");
+
+    uint64_t fetch_size = 0;
+    if (args.size() == 1) {
+      shcore::Argument_map options(*args.map_at(0));
+      options.ensure_keys({}, {"fetchSize"}, "execute options");
+
+      if (options.has_key("fetchSize")) {
+        fetch_size = options.uint_at("fetchSize");
+        if (fetch_size == 0)
+          throw shcore::Exception::argument_error("The value for 'fetchSize' must be greater than 0");
+      }
+    }
+
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::DocResult(std::shared_ptr< ::mysqlx::Result>(_find_statement->execute()));
+    auto started = std::chrono::steady_clock::now();
+    uint64_t server_time = 0;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      result = new mysqlx::DocResult(std::shared_ptr< ::mysqlx::Result>(
+        fetch_size ? _find_statement->execute(fetch_size) : _find_statement->execute()));
+    }
     timer.end();
+    if (Index_advisor::enabled())
+      Index_advisor::get().record(_find_statement->collection(), _search_condition, _sort_criteria, started);
     result->set_execution_time(timer.raw_duration());
+    if (shcore::Slow_statement_log::enabled())
+      watch_slow(*result, server_time);
   }
   CATCH_AND_TRANSLATE_CRUD_EXCEPTION("CollectionFind.execute");
 
   return result ? shcore::Value::wrap(result) : shcore::Value::Null();
 }
+
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_BRIEF, "Writes the documents found to a file, using several sessions in parallel.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_PARAM, "@param path The file to be written, one JSON document per line.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_RETURNS, "@return A dictionary with the number of exported documents and the errors found.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_SYNTAX, "exportTo(path[, options])");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL, "This function opens additional X sessions using the connection data of the session of the collection, "\
+"all of them reading the same consistent snapshot. The collection is split in chunks on ranges of _id and the chunks are "\
+"found by the sessions in parallel, with the search condition and the bound values of this operation. The documents are "\
+"written as sent by the server, in no particular order.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL2, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL3, "@li chunkDocs: the approximate number of documents on each chunk, by default 500000.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL4, "@li compression: none or gzip, by default none.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL5, "@li format: json or parquet, by default json. Parquet files have a single doc "\
+"column with the documents, the compression is applied to their pages.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL6, "@li rowGroupRows: the number of documents on each row group of a Parquet file, by default 100000.");
+REGISTER_HELP(COLLECTIONFIND_EXPORTTO_DETAIL7, "The returned dictionary contains the chunks, documents, bytes (before compression), "\
+"seconds and errors attributes, errors being a list with the error messages of the failed chunks.");
+
+/**
+* $(COLLECTIONFIND_EXPORTTO_BRIEF)
+*
+* $(COLLECTIONFIND_EXPORTTO_PARAM)
+* $(COLLECTIONFIND_EXPORTTO_PARAM1)
+*
+* $(COLLECTIONFIND_EXPORTTO_RETURNS)
+*
+* $(COLLECTIONFIND_EXPORTTO_DETAIL)
+*
+* $(COLLECTIONFIND_EXPORTTO_DETAIL1)
+* $(COLLECTIONFIND_EXPORTTO_DETAIL2)
+* $(COLLECTIONFIND_EXPORTTO_DETAIL3)
+* $(COLLECTIONFIND_EXPORTTO_DETAIL4)
+* $(COLLECTIONFIND_EXPORTTO_DETAIL5)
+* $(COLLECTIONFIND_EXPORTTO_DETAIL6)
+*
+* $(COLLECTIONFIND_EXPORTTO_DETAIL7)
+*
+* #### Method Chaining
+*
+* This function can be invoked after find() and bind().
+*/
+//@{
+#if DOXYGEN_JS
+Dictionary CollectionFind::exportTo(String path, Dictionary options) {}
+#elif DOXYGEN_PY
+dict CollectionFind::export_to(str path, dict options) {}
+#endif
+//@}
+shcore::Value CollectionFind::export_to(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, "CollectionFind.exportTo");
+
+  shcore::Value::Map_type_ref ret_val;
+
+  try {
+    mysqlsh::dump::Export_options options;
+    options.path = args.string_at(0);
+    options.threads = EXPORT_DEFAULT_THREADS;
+    options.chunk_docs = EXPORT_DEFAULT_CHUNK_DOCS;
+    options.compression = "none";
+    options.format = "json";
+    options.row_group_rows = EXPORT_DEFAULT_ROW_GROUP_ROWS;
+
+    if (args.size() == 2) {
+      shcore::Argument_map opt_map(*args.map_at(1));
+      opt_map.ensure_keys({}, {"threads", "chunkDocs", "compression", "format", "rowGroupRows"}, "exportTo options");
+
+      if (opt_map.has_key("threads"))
+        options.threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (options.threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("chunkDocs"))
+        options.chunk_docs = opt_map.uint_at("chunkDocs");
+
+      if (options.chunk_docs == 0)
+        throw shcore::Exception::argument_error("The value for 'chunkDocs' must be a positive integer");
+
+      if (opt_map.has_key("compression"))
+        options.compression = opt_map.string_at("compression");
+
+      if (!mysqlsh::dump::is_compression_supported(options.compression))
+        throw shcore::Exception::argument_error("The compression '" + options.compression + "' is not supported");
+
+      if (opt_map.has_key("format"))
+        options.format = opt_map.string_at("format");
+
+      if (options.format != "json" && options.format != "parquet")
+        throw shcore::Exception::argument_error("The format '" + options.format + "' is not supported");
+
+      if (opt_map.has_key("rowGroupRows"))
+        options.row_group_rows = opt_map.uint_at("rowGroupRows");
+
+      if (options.row_group_rows == 0)
+        throw shcore::Exception::argument_error("The value for 'rowGroupRows' must be a positive integer");
+    }
+
+    std::shared_ptr<Collection> collection(std::static_pointer_cast<Collection>(_owner.lock()));
+    auto session = collection ? collection->get_member("session").as_object<ShellDevelopmentSession>() : nullptr;
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    mysqlsh::dump::Export_query query;
+    query.schema = _find_statement->collection()->schema()->name();
+    query.collection = _find_statement->collection()->name();
+    query.condition = _search_condition;
+    query.bindings = _bindings;
+    query.list_bindings = _list_bindings;
+
+    try {
+      ret_val = mysqlsh::dump::export_documents(session, query, options);
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+  }
+  CATCH_AND_TRANSLATE_CRUD_EXCEPTION("CollectionFind.exportTo");
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(COLLECTIONFIND_COUNT_BRIEF, "Counts the documents matching the search condition, without retrieving them.");
+REGISTER_HELP(COLLECTIONFIND_COUNT_RETURNS, "@return The number of documents found.");
+REGISTER_HELP(COLLECTIONFIND_COUNT_SYNTAX, "count()");
+REGISTER_HELP(COLLECTIONFIND_COUNT_DETAIL, "The documents are counted by the server using the search condition and the bound values "\
+"of this operation, only the count is sent back.");
+
+/**
+* $(COLLECTIONFIND_COUNT_BRIEF)
+*
+* $(COLLECTIONFIND_COUNT_RETURNS)
+*
+* $(COLLECTIONFIND_COUNT_DETAIL)
+*
+* #### Method Chaining
+*
+* This function can be invoked after find() and bind().
+*/
+//@{
+#if DOXYGEN_JS
+Integer CollectionFind::count() {}
+#elif DOXYGEN_PY
+int CollectionFind::count() {}
+#endif
+//@}
+shcore::Value CollectionFind::count(const shcore::Argument_list &args) {
+  args.ensure_count(0, "CollectionFind.count");
+
+  shcore::Value ret_val;
+
+  try {
+    // The result is a single document with the count, every document has
+    // an _id so none is left out
+    ::mysqlx::FindStatement statement(_find_statement->collection(), _search_condition);
+    for (auto &binding : _bindings)
+      statement.bind(binding.first, binding.second);
+    for (auto &binding : _list_bindings)
+      statement.bind(binding.first, binding.second);
+    statement.fields(std::vector<std::string>{"COUNT(_id) AS count"});
+
+    std::shared_ptr< ::mysqlx::Result> result(statement.execute());
+    std::shared_ptr< ::mysqlx::Row> row = result->next();
+    shcore::Value document = shcore::Value::parse(row->stringField(0));
+    result->flush();
+
+    ret_val = document.as_map()->at("count");
+  }
+  CATCH_AND_TRANSLATE_CRUD_EXCEPTION("CollectionFind.count");
+
+  return ret_val;
+}
+
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_BRIEF, "Returns the plan the server picks for the find operation, without executing it.");
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_PARAM, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_RETURNS, "@return A dictionary with the sql and plan attributes.");
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_SYNTAX, "explain([options])");
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_DETAIL, "The X plugin executes the operation as an SQL statement, the sql attribute is that "\
+"statement with the bound values in place and the plan is the one the server gives to EXPLAIN on it.");
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTIONFIND_EXPLAIN_DETAIL2, "@li format: json or tree, by default json. The json plan is returned as a dictionary, "\
+"the tree plan as a string and requires MySQL 8.0.16 or newer.");
+
+/**
+* $(COLLECTIONFIND_EXPLAIN_BRIEF)
+*
+* $(COLLECTIONFIND_EXPLAIN_PARAM)
+*
+* $(COLLECTIONFIND_EXPLAIN_RETURNS)
+*
+* $(COLLECTIONFIND_EXPLAIN_DETAIL)
+*
+* $(COLLECTIONFIND_EXPLAIN_DETAIL1)
+* $(COLLECTIONFIND_EXPLAIN_DETAIL2)
+*
+* #### Method Chaining
+*
+* This function can be invoked at the same points as execute().
+*/
+//@{
+#if DOXYGEN_JS
+Dictionary CollectionFind::explain(Dictionary options) {}
+#elif DOXYGEN_PY
+dict CollectionFind::explain(dict options) {}
+#endif
+//@}
@@ -56,7 +56,10 @@ public:
   CollectionFind limit(Integer numberOfRows);
   CollectionFind skip(Integer offset);
   CollectionFind bind(String name, Value value);
-  DocResult execute();
+  DocResult execute(Dictionary options);
+  Dictionary explain(Dictionary options);
+  Dictionary exportTo(String path, Dictionary options);
+  Integer count();
 #elif DOXYGEN_PY
   CollectionFind find(str searchCondition);
   CollectionFind fields(str fieldDefinition[, str fieldDefinition, ...]);
@@ -70,7 +73,10 @@ public:
   CollectionFind limit(int numberOfRows);
   CollectionFind skip(int offset);
   CollectionFind bind(str name, Value value);
-  DocResult execute();
+  DocResult execute(dict options);
+  dict explain(dict options);
+  dict export_to(str path, dict options);
+  int count();
 #endif
   shcore::Value find(const shcore::Argument_list &args);
   shcore::Value fields(const shcore::Argument_list &args);
@@ -82,9 +88,17 @@ public:
   shcore::Value bind(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _find_statement.get(); }
+  shcore::Value export_to(const shcore::Argument_list &args);
+  shcore::Value count(const shcore::Argument_list &args);
 
 private:
   std::unique_ptr< ::mysqlx::FindStatement> _find_statement;
+  // Kept to repeat the operation on other sessions
+  std::string _search_condition;
+  std::vector<std::string> _sort_criteria;
+  std::vector<std::pair<std::string, ::mysqlx::DocumentValue> > _bindings;
+  std::vector<std::pair<std::string, std::vector< ::mysqlx::DocumentValue> > > _list_bindings;
 };
 };
 };
@@ -19,6 +19,7 @@
 #include "mod_mysqlx_collection_modify.h"
 #include "mod_mysqlx_collection.h"
 #include "mod_mysqlx_resultset.h"
+#include "mod_mysqlx_index_advisor.h"
 #include "utils/utils_time.h"
 #include "utils/utils_help.h"
 
@@ -36,7 +37,7 @@ REGISTER_HELP(COLLECTIONMODIFY_DETAIL, "This object provides the necessary funct
 REGISTER_HELP(COLLECTIONMODIFY_DETAIL1, "This object should only be created by calling the modify function on the collection object on which the documents will be updated.");
 
 CollectionModify::CollectionModify(std::shared_ptr<Collection> owner)
-  :Collection_crud_definition(std::static_pointer_cast<DatabaseObject>(owner)) {
+  :Collection_crud_definition(std::static_pointer_cast<DatabaseObject>(owner)), _chunk_size(0) {
   // Exposes the methods available for chaining
   add_method("modify", std::bind(&CollectionModify::modify, this, _1), "data");
   add_method("set", std::bind(&CollectionModify::set, this, _1), "data");
@@ -61,6 +62,7 @@ CollectionModify::CollectionModify(std::shared_ptr<Collection> owner)
   register_dynamic_function("limit", "operation, sort");
   register_dynamic_function("bind", "operation, sort, limit, bind");
   register_dynamic_function("execute", "operation, sort, limit, bind");
+  register_dynamic_function("explain", "operation, sort, limit, bind");
   register_dynamic_function("__shell_hook__", "operation, sort, limit, bind");
 
   // Initial function update
@@ -132,6 +134,8 @@ shcore::Value CollectionModify::modify(const shcore::Argument_list &args) {
         search_condition = args.string_at(0);
 
       _modify_statement.reset(new ::mysqlx::ModifyStatement(collection->_collection_impl->modify(search_condition)));
+      _search_condition = search_condition;
+      _sort_criteria.clear();
 
       // Updates the exposed functions
       update_functions("modify");
@@ -717,6 +721,7 @@ shcore::Value CollectionModify::sort(const shcore::Argument_list &args) {
       throw shcore::Exception::argument_error("Sort criteria can not be empty");
 
     _modify_statement->sort(fields);
+    _sort_criteria = fields;
 
     update_functions("sort");
   }
@@ -818,7 +823,7 @@ shcore::Value CollectionModify::bind(const shcore::Argument_list &args) {
   args.ensure_count(2, get_function_name("bind").c_str());
 
   try {
-    _modify_statement->bind(args.string_at(0), map_document_value(args[1]));
+    bind_value(*_modify_statement, args.string_at(0), args[1]);
 
     update_functions("bind");
   }
@@ -863,18 +868,94 @@ Result CollectionModify::execute() {}
 */
 Result CollectionModify::execute() {}
 #endif
+void CollectionModify::modify_many(shcore::Value ids, size_t chunk_size) {
+  shcore::Argument_list modify_args;
+  modify_args.push_back(shcore::Value("_id IN :_ids"));
+  modify(modify_args);
+
+  _ids = map_document_list(ids);
+  _chunk_size = chunk_size;
+}
+
 shcore::Value CollectionModify::execute(const shcore::Argument_list &args) {
   mysqlx::Result *result = NULL;
 
+  if (_chunk_size) {
+    shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+    try {
+      args.ensure_count(0, get_function_name("execute").c_str());
+
+      // Every chunk is a statement of its own
+      uint64_t affected = 0;
+      uint64_t chunks = 0;
+      for (size_t start = 0; start < _ids.size(); start += _chunk_size) {
+        std::vector< ::mysqlx::DocumentValue> chunk(_ids.begin() + start, _ids.begin() + std::min(start + _chunk_size, _ids.size()));
+        _modify_statement->bind("_ids", chunk);
+        affected += _modify_statement->execute()->affectedRows();
+        chunks++;
+      }
+
+      (*ret_val)["affectedItemCount"] = shcore::Value(affected);
+      (*ret_val)["chunks"] = shcore::Value(chunks);
+    }
+    CATCH_AND_TRANSLATE_CRUD_EXCEPTION(get_function_name("execute"));
+
+    return shcore::Value(ret_val);
+  }
+
   try {
     args.ensure_count(0, get_function_name("execute").c_str());
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_modify_statement->execute()));
+    auto started = std::chrono::steady_clock::now();
+    uint64_t server_time = 0;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_modify_statement->execute()));
+    }
     timer.end();
+    if (Index_advisor::enabled())
+      Index_advisor::get().record(_modify_statement->collection(), _search_condition, _sort_criteria, started);
     result->set_execution_time(timer.raw_duration());
+    if (shcore::Slow_statement_log::enabled())
+      watch_slow(*result, server_time);
   }
   CATCH_AND_TRANSLATE_CRUD_EXCEPTION(get_function_name("execute"));
 
   return result ? shcore::Value::wrap(result) : shcore::Value::Null();
 }
+
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_BRIEF, "Returns the plan the server picks for the modify operation, without executing it.");
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_PARAM, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_RETURNS, "@return A dictionary with the sql and plan attributes.");
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_SYNTAX, "explain([options])");
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_DETAIL, "The X plugin executes the operation as an SQL statement, the sql attribute is that "\
+"statement with the bound values in place and the plan is the one the server gives to EXPLAIN on it.");
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTIONMODIFY_EXPLAIN_DETAIL2, "@li format: json or tree, by default json. The json plan is returned as a dictionary, "\
+"the tree plan as a string and requires MySQL 8.0.16 or newer.");
+
+/**
+* $(COLLECTIONMODIFY_EXPLAIN_BRIEF)
+*
+* $(COLLECTIONMODIFY_EXPLAIN_PARAM)
+*
+* $(COLLECTIONMODIFY_EXPLAIN_RETURNS)
+*
+* $(COLLECTIONMODIFY_EXPLAIN_DETAIL)
+*
+* $(COLLECTIONMODIFY_EXPLAIN_DETAIL1)
+* $(COLLECTIONMODIFY_EXPLAIN_DETAIL2)
+*
+* #### Method Chaining
+*
+* This function can be invoked at the same points as execute().
+*/
+//@{
+#if DOXYGEN_JS
+Dictionary CollectionModify::explain(Dictionary options) {}
+#elif DOXYGEN_PY
+dict CollectionModify::explain(dict options) {}
+#endif
+//@}
@@ -56,6 +56,7 @@ public:
   CollectionModify skip(Integer limitOffset);
   CollectionFind bind(String name, Value value);
   Result execute();
+  Dictionary explain(Dictionary options);
 #elif DOXYGEN_PY
   CollectionModify modify(str searchCondition);
   CollectionModify set(str attribute, Value value);
@@ -70,6 +71,7 @@ public:
   CollectionModify skip(int limitOffset);
   CollectionFind bind(str name, Value value);
   Result execute();
+  dict explain(dict options);
 #endif
   virtual std::string class_name() const { return "CollectionModify"; }
   static std::shared_ptr<shcore::Object_bridge> create(const shcore::Argument_list &args);
@@ -85,8 +87,17 @@ public:
   shcore::Value bind(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _chunk_size ? NULL : _modify_statement.get(); }
+
+  // Modifies the documents with the ids, sending them in chunks
+  void modify_many(shcore::Value ids, size_t chunk_size);
 private:
   std::unique_ptr< ::mysqlx::ModifyStatement> _modify_statement;
+  // Kept for the index advisor
+  std::string _search_condition;
+  std::vector<std::string> _sort_criteria;
+  std::vector< ::mysqlx::DocumentValue> _ids;
+  size_t _chunk_size;
 };
 };
 };
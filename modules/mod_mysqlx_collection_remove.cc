@@ -47,6 +47,7 @@ CollectionRemove::CollectionRemove(std::shared_ptr<Collection> owner)
   register_dynamic_function("limit", "remove, sort");
   register_dynamic_function("bind", "remove, sort, limit, bind");
   register_dynamic_function("execute", "remove, sort, limit, bind");
+  register_dynamic_function("explain", "remove, sort, limit, bind");
   register_dynamic_function("__shell_hook__", "remove, sort, limit, bind");
 
   // Initial function update
@@ -271,7 +272,7 @@ shcore::Value CollectionRemove::bind(const shcore::Argument_list &args) {
   args.ensure_count(2, get_function_name("bind").c_str());
 
   try {
-    _remove_statement->bind(args.string_at(0), map_document_value(args[1]));
+    bind_value(*_remove_statement, args.string_at(0), args[1]);
 
     update_functions("bind");
   }
@@ -325,11 +326,79 @@ shcore::Value CollectionRemove::execute(const shcore::Argument_list &args) {
     args.ensure_count(0, get_function_name("execute").c_str());
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_remove_statement->execute()));
+    uint64_t server_time = 0;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_remove_statement->execute()));
+    }
     timer.end();
     result->set_execution_time(timer.raw_duration());
+    if (shcore::Slow_statement_log::enabled())
+      watch_slow(*result, server_time);
   }
   CATCH_AND_TRANSLATE_CRUD_EXCEPTION(get_function_name("execute"));
 
   return result ? shcore::Value::wrap(result) : shcore::Value::Null();
 }
+
+shcore::Value CollectionRemove::remove_many(shcore::Value ids, size_t chunk_size) {
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  std::shared_ptr<Collection> collection(std::static_pointer_cast<Collection>(_owner.lock()));
+
+  if (collection) {
+    try {
+      std::vector< ::mysqlx::DocumentValue> values(map_document_list(ids));
+      ::mysqlx::RemoveStatement statement(collection->_collection_impl->remove("_id IN :_ids"));
+
+      // Every chunk is a statement of its own
+      uint64_t affected = 0;
+      uint64_t chunks = 0;
+      for (size_t start = 0; start < values.size(); start += chunk_size) {
+        std::vector< ::mysqlx::DocumentValue> chunk(values.begin() + start, values.begin() + std::min(start + chunk_size, values.size()));
+        statement.bind("_ids", chunk);
+        affected += statement.execute()->affectedRows();
+        chunks++;
+      }
+
+      (*ret_val)["affectedItemCount"] = shcore::Value(affected);
+      (*ret_val)["chunks"] = shcore::Value(chunks);
+    }
+    CATCH_AND_TRANSLATE_CRUD_EXCEPTION("Collection.removeMany");
+  }
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_BRIEF, "Returns the plan the server picks for the remove operation, without executing it.");
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_PARAM, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_RETURNS, "@return A dictionary with the sql and plan attributes.");
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_SYNTAX, "explain([options])");
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_DETAIL, "The X plugin executes the operation as an SQL statement, the sql attribute is that "\
+"statement with the bound values in place and the plan is the one the server gives to EXPLAIN on it.");
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(COLLECTIONREMOVE_EXPLAIN_DETAIL2, "@li format: json or tree, by default json. The json plan is returned as a dictionary, "\
+"the tree plan as a string and requires MySQL 8.0.16 or newer.");
+
+/**
+* $(COLLECTIONREMOVE_EXPLAIN_BRIEF)
+*
+* $(COLLECTIONREMOVE_EXPLAIN_PARAM)
+*
+* $(COLLECTIONREMOVE_EXPLAIN_RETURNS)
+*
+* $(COLLECTIONREMOVE_EXPLAIN_DETAIL)
+*
+* $(COLLECTIONREMOVE_EXPLAIN_DETAIL1)
+* $(COLLECTIONREMOVE_EXPLAIN_DETAIL2)
+*
+* #### Method Chaining
+*
+* This function can be invoked at the same points as execute().
+*/
+//@{
+#if DOXYGEN_JS
+Dictionary CollectionRemove::explain(Dictionary options) {}
+#elif DOXYGEN_PY
+dict CollectionRemove::explain(dict options) {}
+#endif
+//@}
@@ -48,12 +48,14 @@ public:
   CollectionRemove limit(Integer numberOfRows);
   CollectionFind bind(String name, Value value);
   Result execute();
+  Dictionary explain(Dictionary options);
 #elif DOXYGEN_PY
   CollectionRemove remove(str searchCondition);
   CollectionRemove sort(list sortExprStr);
   CollectionRemove limit(int numberOfRows);
   CollectionFind bind(str name, Value value);
   Result execute();
+  dict explain(dict options);
 #endif
   virtual std::string class_name() const { return "CollectionRemove"; }
   static std::shared_ptr<shcore::Object_bridge> create(const shcore::Argument_list &args);
@@ -63,6 +65,10 @@ public:
   shcore::Value bind(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _remove_statement.get(); }
+
+  // Removes the documents with the ids, sending them in chunks
+  shcore::Value remove_many(shcore::Value ids, size_t chunk_size);
 private:
   std::unique_ptr< ::mysqlx::RemoveStatement> _remove_statement;
 };
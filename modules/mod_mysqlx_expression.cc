@@ -70,3 +70,23 @@ std::shared_ptr<shcore::Object_bridge> Expression::create(const shcore::Argument
 
   return expression;
 }
+
+Value FileContent::get_member(const std::string &prop) const {
+  if (prop == "path")
+    return Value(_path);
+
+  return Cpp_object_bridge::get_member(prop);
+}
+
+bool FileContent::operator == (const Object_bridge &other) const {
+  return class_name() == other.class_name() && this == &other;
+}
+
+std::shared_ptr<shcore::Object_bridge> FileContent::create(const shcore::Argument_list &args) {
+  args.ensure_count(1, "mysqlx.fileContent");
+
+  if (args[0].type != shcore::String)
+    throw shcore::Exception::argument_error("mysqlx.fileContent: Argument #1 is expected to be a string");
+
+  return std::shared_ptr<FileContent>(new FileContent(args[0].as_string()));
+}
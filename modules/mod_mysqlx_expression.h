@@ -48,6 +48,26 @@ public:
 private:
   std::string _data;
 };
+
+// The contents of a file given as a value to insert, it is read straight
+// into the message sent to the server when the value is used
+class SHCORE_PUBLIC FileContent : public shcore::Cpp_object_bridge {
+public:
+  FileContent(const std::string &path) { add_property("path"); _path = path; }
+  virtual ~FileContent() {};
+
+  virtual std::string class_name() const { return "FileContent"; };
+  virtual bool operator == (const Object_bridge &other) const;
+
+  virtual shcore::Value get_member(const std::string &prop) const;
+
+  static std::shared_ptr<shcore::Object_bridge> create(const shcore::Argument_list &args);
+
+  const std::string &get_path() const { return _path; };
+
+private:
+  std::string _path;
+};
 };
 };
 
@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/mod_mysqlx_index_advisor.h"
+
+#include "mysqlx.h"
+#include "mysqlx_crud.h"
+#include "mysqlxtest/common/mysqlx_parser.h"
+#include "utils/utils_sqlstring.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace mysqlsh {
+namespace mysqlx {
+std::atomic<bool> Index_advisor::_enabled(false);
+
+namespace {
+// The path of a document path identifier, empty if it has wildcards or is
+// not a document path
+std::string document_path(const Mysqlx::Expr::Expr &expr) {
+  if (expr.type() != Mysqlx::Expr::Expr::IDENT || !expr.identifier().name().empty() ||
+      expr.identifier().document_path_size() == 0)
+    return "";
+
+  std::string path = "$";
+  for (auto &item : expr.identifier().document_path()) {
+    if (item.type() == Mysqlx::Expr::DocumentPathItem::MEMBER) {
+      const std::string &member = item.value();
+      bool plain = !member.empty() && !isdigit(static_cast<unsigned char>(member[0]));
+      for (char c : member)
+        plain = plain && (isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$');
+
+      path += plain ? "." + member : ".\"" + member + "\"";
+    } else if (item.type() == Mysqlx::Expr::DocumentPathItem::ARRAY_INDEX) {
+      path += "[" + std::to_string(item.index()) + "]";
+    } else {
+      return "";
+    }
+  }
+
+  return path;
+}
+
+// MySQL type of an index on a path compared to the literal, empty if the
+// expression is not a literal
+std::string literal_type(const Mysqlx::Expr::Expr &expr) {
+  if (expr.type() != Mysqlx::Expr::Expr::LITERAL)
+    return "";
+
+  switch (expr.literal().type()) {
+    case Mysqlx::Datatypes::Scalar::V_SINT:
+    case Mysqlx::Datatypes::Scalar::V_UINT:
+      return "INTEGER";
+    case Mysqlx::Datatypes::Scalar::V_DOUBLE:
+    case Mysqlx::Datatypes::Scalar::V_FLOAT:
+      return "DOUBLE";
+    case Mysqlx::Datatypes::Scalar::V_STRING:
+    case Mysqlx::Datatypes::Scalar::V_OCTETS:
+      return "TEXT(64)";
+    default:
+      return "";
+  }
+}
+
+// Whether the pattern of a LIKE has a fixed prefix an index can seek to
+bool has_fixed_prefix(const Mysqlx::Expr::Expr &pattern) {
+  if (pattern.type() != Mysqlx::Expr::Expr::LITERAL)
+    return false;
+
+  std::string value;
+  if (pattern.literal().type() == Mysqlx::Datatypes::Scalar::V_STRING)
+    value = pattern.literal().v_string().value();
+  else if (pattern.literal().type() == Mysqlx::Datatypes::Scalar::V_OCTETS)
+    value = pattern.literal().v_octets().value();
+
+  return !value.empty() && value[0] != '%' && value[0] != '_';
+}
+
+void add_field(std::vector<Index_advisor::Field> *fields, const std::string &path,
+               const std::string &usage, const std::string &type) {
+  for (auto &field : *fields) {
+    if (field.path == path) {
+      if (field.type.empty())
+        field.type = type;
+      return;
+    }
+  }
+
+  Index_advisor::Field field;
+  field.path = path;
+  field.usage = usage;
+  field.type = type;
+  fields->push_back(field);
+}
+
+// Collects the comparisons of the AND chain at the top of the criteria
+void collect_comparisons(const Mysqlx::Expr::Expr &expr, std::vector<Index_advisor::Field> *equalities,
+                         std::vector<Index_advisor::Field> *ranges) {
+  if (expr.type() != Mysqlx::Expr::Expr::OPERATOR)
+    return;
+
+  const Mysqlx::Expr::Operator &op = expr.operator_();
+  const std::string &name = op.name();
+
+  if (name == "&&") {
+    for (auto &param : op.param())
+      collect_comparisons(param, equalities, ranges);
+    return;
+  }
+
+  if (op.param_size() < 2)
+    return;
+
+  std::string path = document_path(op.param(0));
+  int value = 1;
+
+  // Comparisons may be written with the literal first, as in 18 < age
+  if (path.empty() && (name == "==" || name == "!=" || name == "<" || name == "<=" ||
+                       name == ">" || name == ">=")) {
+    path = document_path(op.param(1));
+    value = 0;
+  }
+
+  if (path.empty())
+    return;
+
+  std::string type = literal_type(op.param(value));
+
+  if (name == "==" || name == "in" || name == "is")
+    add_field(equalities, path, "equality", type);
+  else if (name == "<" || name == "<=" || name == ">" || name == ">=" || name == "between")
+    add_field(ranges, path, "range", type);
+  else if (name == "like" && has_fixed_prefix(op.param(1)))
+    add_field(ranges, path, "range", "TEXT(64)");
+}
+
+std::string quote(const std::string &text) {
+  std::string ret_val = "'";
+  for (char c : text) {
+    if (c == '\'' || c == '\\')
+      ret_val += '\\';
+    ret_val += c;
+  }
+  return ret_val + "'";
+}
+
+std::string filter_description(const std::string &schema, const std::string &collection,
+                               const std::vector<Index_advisor::Field> &fields) {
+  std::string ret_val = schema + "." + collection + ":";
+
+  if (fields.empty())
+    return ret_val + " no indexable filter";
+
+  for (size_t index = 0; index < fields.size(); ++index)
+    ret_val += (index ? ", " : " ") + fields[index].path + " (" + fields[index].usage + ")";
+
+  return ret_val;
+}
+}  // namespace
+
+Index_advisor &Index_advisor::get() {
+  static Index_advisor instance;
+  return instance;
+}
+
+void Index_advisor::start() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _filters.clear();
+  _sessions.clear();
+  _enabled = true;
+}
+
+void Index_advisor::stop() {
+  _enabled = false;
+}
+
+std::vector<Index_advisor::Field> Index_advisor::index_fields(const std::string &criteria,
+                                                              const std::vector<std::string> &sort) {
+  std::vector<Field> equalities;
+  std::vector<Field> ranges;
+
+  if (!criteria.empty()) {
+    std::vector<std::string> placeholders;
+    std::unique_ptr<Mysqlx::Expr::Expr> expr(::mysqlx::parser::parse_collection_filter(criteria, &placeholders));
+    collect_comparisons(*expr, &equalities, &ranges);
+  }
+
+  std::vector<Field> fields(equalities);
+
+  for (auto &criterion : sort) {
+    google::protobuf::RepeatedPtrField<Mysqlx::Crud::Order> order;
+    ::mysqlx::parser::parse_collection_sort_column(order, criterion);
+
+    std::string path = document_path(order.Get(0).expr());
+    if (path.empty())
+      break;
+
+    // The type is the one of the range on the same path, if any
+    std::string type;
+    for (auto &range : ranges) {
+      if (range.path == path)
+        type = range.type;
+    }
+    add_field(&fields, path, "sort", type);
+  }
+
+  // An index serves a single range, after the equalities and the sort
+  if (!ranges.empty())
+    add_field(&fields, ranges[0].path, ranges[0].usage, ranges[0].type);
+
+  for (auto &field : fields) {
+    if (field.type.empty())
+      field.type = "TEXT(64)";
+  }
+
+  return fields;
+}
+
+std::string Index_advisor::generated_column_path(const std::string &expression) {
+  std::string::size_type start = expression.find("'$");
+  if (start == std::string::npos)
+    return "";
+
+  std::string::size_type end = expression.find('\'', start + 1);
+  if (end == std::string::npos || expression.find("'$", end + 1) != std::string::npos)
+    return "";
+
+  return expression.substr(start + 1, end - start - 1);
+}
+
+std::string Index_advisor::create_index_call(const std::string &schema, const std::string &collection,
+                                             const std::vector<Field> &fields) {
+  std::string name = "ix";
+  for (auto &field : fields) {
+    name += "_";
+    for (char c : field.path.substr(1)) {
+      if (isalnum(static_cast<unsigned char>(c)))
+        name += c;
+      else if (name.back() != '_')
+        name += '_';
+    }
+    if (name.back() == '_')
+      name.pop_back();
+  }
+  name = name.substr(0, 64);
+
+  std::string ret_val = "session.getSchema(" + quote(schema) + ").getCollection(" + quote(collection) +
+                        ").createIndex(" + quote(name) + ")";
+  for (auto &field : fields)
+    ret_val += ".field(" + quote(field.path) + ", " + quote(field.type) + ", false)";
+
+  return ret_val + ".execute()";
+}
+
+void Index_advisor::record(std::shared_ptr< ::mysqlx::Collection> collection, const std::string &criteria,
+                           const std::vector<std::string> &sort, std::chrono::steady_clock::time_point started) {
+  uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - started).count();
+  std::shared_ptr< ::mysqlx::Schema> schema = collection->schema();
+  if (!schema)
+    return;
+
+  std::vector<Field> fields;
+  try {
+    fields = index_fields(criteria, sort);
+  } catch (...) {
+    // The criteria were sent to the server, which found them valid, so any
+    // expression the parser here does not take is just not analyzed
+  }
+
+  std::string key = schema->name() + "." + collection->name();
+  std::string collection_key = key;
+  for (auto &field : fields)
+    key += "\n" + field.path + " " + field.usage;
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  Filter_stats &stats = _filters[key];
+  if (stats.executions == 0) {
+    stats.schema = schema->name();
+    stats.collection = collection->name();
+    stats.fields = fields;
+  }
+  stats.executions++;
+  stats.total += elapsed;
+  stats.max = std::max(stats.max, elapsed);
+
+  _sessions[collection_key] = schema->session();
+}
+
+Index_advisor::Leading_paths Index_advisor::load_indexes(std::shared_ptr< ::mysqlx::Session> session,
+                                                         const std::string &schema, const std::string &collection) {
+  Leading_paths ret_val;
+
+  std::string query = shcore::sqlstring(
+    "SELECT s.INDEX_NAME, c.GENERATION_EXPRESSION FROM information_schema.STATISTICS s "
+    "JOIN information_schema.COLUMNS c ON c.TABLE_SCHEMA = s.TABLE_SCHEMA AND c.TABLE_NAME = s.TABLE_NAME "
+    "AND c.COLUMN_NAME = s.COLUMN_NAME WHERE s.TABLE_SCHEMA = ? AND s.TABLE_NAME = ? AND s.SEQ_IN_INDEX = 1", 0)
+    << schema << collection;
+
+  std::shared_ptr< ::mysqlx::Result> result(session->executeSql(query));
+  while (std::shared_ptr< ::mysqlx::Row> row = result->next()) {
+    if (row->isNullField(1))
+      continue;
+
+    std::string path = generated_column_path(row->stringField(1));
+    if (!path.empty() && ret_val.find(path) == ret_val.end())
+      ret_val[path] = row->stringField(0);
+  }
+
+  return ret_val;
+}
+
+std::string Index_advisor::report() {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  std::vector<const Filter_stats*> filters;
+  for (auto &filter : _filters)
+    filters.push_back(&filter.second);
+  std::sort(filters.begin(), filters.end(), [](const Filter_stats *a, const Filter_stats *b) {
+    return a->total > b->total;
+  });
+
+  std::map<std::string, Leading_paths> indexes;
+  std::map<std::string, std::string> index_errors;
+  char line[256];
+  std::string ret_val;
+
+  snprintf(line, sizeof(line), "%12s %10s %10s  %s\n", "total (ms)", "max (ms)", "executions", "filter");
+  ret_val += line;
+
+  for (auto filter : filters) {
+    std::string collection_key = filter->schema + "." + filter->collection;
+
+    snprintf(line, sizeof(line), "%12.3f %10.3f %10llu  ", filter->total / 1000.0, filter->max / 1000.0,
+             static_cast<unsigned long long>(filter->executions));
+    ret_val += line + filter_description(filter->schema, filter->collection, filter->fields) + "\n";
+
+    if (filter->fields.empty())
+      continue;
+
+    if (indexes.find(collection_key) == indexes.end() && index_errors.find(collection_key) == index_errors.end()) {
+      std::shared_ptr< ::mysqlx::Session> session = _sessions[collection_key].lock();
+
+      try {
+        if (!session)
+          throw std::runtime_error("the session is closed");
+        indexes[collection_key] = load_indexes(session, filter->schema, filter->collection);
+      } catch (std::exception &e) {
+        index_errors[collection_key] = e.what();
+      }
+    }
+
+    std::string indent(37, ' ');
+
+    if (index_errors.find(collection_key) != index_errors.end()) {
+      ret_val += indent + "Unable to read the indexes: " + index_errors[collection_key] + "\n";
+      continue;
+    }
+
+    Leading_paths &leading = indexes[collection_key];
+    Leading_paths::const_iterator index = leading.find(filter->fields[0].path);
+
+    if (index != leading.end())
+      ret_val += indent + "Served by index " + index->second + "\n";
+    else
+      ret_val += indent + "Suggested: " + create_index_call(filter->schema, filter->collection, filter->fields) + "\n";
+  }
+
+  return ret_val;
+}
+}
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MOD_MYSQLX_INDEX_ADVISOR_H_
+#define _MOD_MYSQLX_INDEX_ADVISOR_H_
+
+#include "shellcore/common.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mysqlx {
+class Collection;
+class Session;
+}
+
+namespace mysqlsh {
+namespace mysqlx {
+// Records the document paths used by the criteria and sort of the find()
+// and modify() operations executed while it is on, with their execution
+// times, and suggests the collection indexes that would serve the filters
+// that took the most time.
+//
+// The fields of the index for a filter are ordered the way an index serves
+// them best: the paths compared for equality, then the ones sorted by, then
+// the first one compared by range. Only the comparisons joined by AND at the
+// top of the criteria count, the ones under OR or NOT can't be served by a
+// single index.
+class SHCORE_PUBLIC Index_advisor {
+public:
+  struct Field {
+    std::string path;
+    // equality, sort or range
+    std::string usage;
+    // MySQL type of the indexed values, guessed from the literals the path
+    // is compared to
+    std::string type;
+  };
+
+  static Index_advisor &get();
+
+  static bool enabled() { return _enabled; }
+
+  // Clears the previous recording and starts a new one
+  void start();
+  void stop();
+
+  // Accounts an operation on the collection started at the given time
+  void record(std::shared_ptr< ::mysqlx::Collection> collection, const std::string &criteria,
+              const std::vector<std::string> &sort, std::chrono::steady_clock::time_point started);
+
+  // The filters recorded, sorted by their total time, each with the index
+  // of the collection already serving it or the createIndex() call that
+  // would add one. The indexes are read from the sessions the operations
+  // were executed on.
+  std::string report();
+
+  // The fields of the index that would serve the criteria and sort, empty
+  // if no index would
+  static std::vector<Field> index_fields(const std::string &criteria, const std::vector<std::string> &sort);
+
+  // The document path a generated column is extracted from, empty if the
+  // column is not generated from a single path
+  static std::string generated_column_path(const std::string &expression);
+
+  // The createIndex() call adding an index on the fields
+  static std::string create_index_call(const std::string &schema, const std::string &collection,
+                                       const std::vector<Field> &fields);
+
+private:
+  Index_advisor() {}
+
+  struct Filter_stats {
+    Filter_stats() : executions(0), total(0), max(0) {}
+
+    std::string schema;
+    std::string collection;
+    std::vector<Field> fields;
+    uint64_t executions;
+    uint64_t total;
+    uint64_t max;
+  };
+
+  // Index names by the document path on their first column
+  typedef std::map<std::string, std::string> Leading_paths;
+
+  Leading_paths load_indexes(std::shared_ptr< ::mysqlx::Session> session, const std::string &schema,
+                             const std::string &collection);
+
+  static std::atomic<bool> _enabled;
+
+  std::mutex _mutex;
+  std::map<std::string, Filter_stats> _filters;
+  std::map<std::string, std::weak_ptr< ::mysqlx::Session> > _sessions;
+};
+}
+}
+
+#endif
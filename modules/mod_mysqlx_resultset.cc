@@ -20,17 +20,26 @@
 #include "mod_mysqlx_resultset.h"
 #include "base_constants.h"
 #include "mysqlx.h"
+#include "mysqlx_charset.h"
 #include "shellcore/common.h"
 #include "shellcore/shell_core_options.h"
 #include "shellcore/obj_date.h"
 #include "utils/utils_time.h"
 #include "mysqlxtest_utils.h"
 #include "utils/utils_help.h"
+#include "utils/utils_arena.h"
+#include "utils/utils_memory.h"
+
+#include <cstring>
 
 using namespace std::placeholders;
 using namespace shcore;
 using namespace mysqlsh::mysqlx;
 
+// Number of rows decoded at once by RowResult.fetchAll(), large enough for
+// the rows to be decoded by several threads
+#define FETCH_ALL_BATCH_SIZE 4096
+
 // -----------------------------------------------------------------------
 
 // Documentation of BaseResult class
@@ -140,7 +149,15 @@ uint64_t BaseResult::get_warning_count() const {
 }
 
 void BaseResult::buffer() {
-  _result->buffer();
+  // The rows are kept in memory while they fit in the memory budget too
+  int64_t memory = shcore::Shell_core_options::typed().result_buffer_memory;
+  _result->buffer(static_cast<size_t>(memory) * 1024 * 1024, [](int64_t size) {
+    if (size < 0) {
+      shcore::Memory_budget::get().release(shcore::Memory_budget::Results, static_cast<uint64_t>(-size));
+      return true;
+    }
+    return shcore::Memory_budget::get().reserve(shcore::Memory_budget::Results, static_cast<uint64_t>(size));
+  });
 }
 
 bool BaseResult::rewind() {
@@ -155,6 +172,10 @@ bool BaseResult::seek(size_t dataset, size_t record) {
   return _result->seek(dataset, record);
 }
 
+uint64_t BaseResult::rows_read() const {
+  return _result ? _result->rowsRead() : 0;
+}
+
 void BaseResult::append_json(shcore::JSON_dumper& dumper) const {
   bool create_object = (dumper.deep_level() == 0);
 
@@ -163,7 +184,7 @@ void BaseResult::append_json(shcore::JSON_dumper& dumper) const {
 
   dumper.append_value("executionTime", get_member("executionTime"));
 
-  if (Shell_core_options::get()->get_bool(SHCORE_SHOW_WARNINGS)) {
+  if (Shell_core_options::typed().show_warnings) {
     dumper.append_value("warningCount", get_member("warningCount"));
     dumper.append_value("warnings", get_member("warnings"));
   }
@@ -322,6 +343,7 @@ DocResult::DocResult(std::shared_ptr< ::mysqlx::Result> result) :
 BaseResult(result) {
   add_method("fetchOne", std::bind(&DocResult::fetch_one, this, _1), "nothing", shcore::String, NULL);
   add_method("fetchAll", std::bind(&DocResult::fetch_all, this, _1), "nothing", shcore::String, NULL);
+  add_method("fetchRaw", std::bind(&DocResult::fetch_raw, this, _1), "nothing", shcore::String, NULL);
 }
 
 // Documentation of fetchOne function
@@ -345,9 +367,23 @@ shcore::Value DocResult::fetch_one(const shcore::Argument_list &args) const {
 
   try {
     if (_result->columnMetadata() && _result->columnMetadata()->size()) {
-      std::shared_ptr< ::mysqlx::Row> r(_result->next());
-      if (r.get())
-        ret_val = Value::parse(r->stringField(0));
+      std::shared_ptr< ::mysqlx::Row> r;
+      {
+        Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+        r = _result->next();
+      }
+
+      if (r.get()) {
+        Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+
+        // Documents come from the server as strict JSON, parsed in place
+        // from the row buffer
+        size_t length;
+        const char *document = r->stringField(0, length);
+        ret_val = Value::parse_json(document, length);
+      } else {
+        end_of_data();
+      }
     }
   }
   CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchOne"));
@@ -355,6 +391,50 @@ shcore::Value DocResult::fetch_one(const shcore::Argument_list &args) const {
   return ret_val;
 }
 
+// Documentation of fetchRaw function
+REGISTER_HELP(DOCRESULT_FETCHRAW_BRIEF, "Retrieves the next document on the DocResult as JSON text.");
+REGISTER_HELP(DOCRESULT_FETCHRAW_RETURN, "@return A string with the next document exactly as sent by the server, or Null if there are no more documents.");
+REGISTER_HELP(DOCRESULT_FETCHRAW_DETAIL, "The document is not parsed, so this is the fastest way to read documents that are only written or sent elsewhere.");
+
+/**
+* $(DOCRESULT_FETCHRAW_BRIEF)
+*
+* $(DOCRESULT_FETCHRAW_RETURN)
+*
+* $(DOCRESULT_FETCHRAW_DETAIL)
+*/
+#if DOXYGEN_JS
+String DocResult::fetchRaw() {};
+#elif DOXYGEN_PY
+str DocResult::fetch_raw() {};
+#endif
+shcore::Value DocResult::fetch_raw(const shcore::Argument_list &args) const {
+  Value ret_val = Value::Null();
+
+  args.ensure_count(0, get_function_name("fetchRaw").c_str());
+
+  try {
+    if (_result->columnMetadata() && _result->columnMetadata()->size()) {
+      std::shared_ptr< ::mysqlx::Row> r;
+      {
+        Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+        r = _result->next();
+      }
+
+      if (r.get()) {
+        size_t length;
+        const char *document = r->stringField(0, length);
+        ret_val = Value(document, length);
+      } else {
+        end_of_data();
+      }
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchRaw"));
+
+  return ret_val;
+}
+
 // Documentation of fetchAll function
 REGISTER_HELP(DOCRESULT_FETCHALL_BRIEF, "Returns a list of DbDoc objects which contains an element for every unread document.");
 REGISTER_HELP(DOCRESULT_FETCHALL_RETURN, "@return A List of DbDoc objects.");
@@ -380,12 +460,25 @@ shcore::Value DocResult::fetch_all(const shcore::Argument_list &args) const {
 
   args.ensure_count(0, get_function_name("fetchAll").c_str());
 
-  // Gets the next document
-  Value record = fetch_one(args);
-  while (record) {
-    array->push_back(record);
-    record = fetch_one(args);
+  // The remaining documents are read in batches, the values parsed from a
+  // batch come from an arena of their own that goes away in one operation
+  // once they are all released
+  try {
+    if (_result->columnMetadata() && _result->columnMetadata()->size()) {
+      std::shared_ptr< ::mysqlx::Row_batch> batch;
+      while ((batch = next_batch())) {
+        Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+        shcore::Arena_scope arena_scope;
+
+        for (size_t row = 0; row < batch->size(); row++) {
+          size_t length;
+          const char *document = batch->stringField(row, 0, length);
+          array->push_back(Value::parse_json(document, length));
+        }
+      }
+    }
   }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchAll"));
 
   return Value(array);
 }
@@ -416,8 +509,8 @@ shcore::Value DocResult::get_metadata() const {
       false, // IS NUMERIC
       _result->columnMetadata()->at(0).fractional_digits,
       false, // IS SIGNED
-      Charset::item[_result->columnMetadata()->at(0).collation].collation,
-      Charset::item[_result->columnMetadata()->at(0).collation].name,
+      ::mysqlx::Charset::collation_name_from_id(_result->columnMetadata()->at(0).collation),
+      ::mysqlx::Charset::charset_name_from_id(_result->columnMetadata()->at(0).collation),
       true)); // IS PADDED
 
     _metadata = shcore::Value(std::static_pointer_cast<Object_bridge>(metadata));
@@ -429,7 +522,14 @@ shcore::Value DocResult::get_metadata() const {
 void DocResult::append_json(shcore::JSON_dumper& dumper) const {
   dumper.start_object();
 
-  dumper.append_value("documents", fetch_all(shcore::Argument_list()));
+  // Records are written as they are fetched, so the whole result is not kept
+  // in memory when the dumper is streaming
+  dumper.append_string("documents");
+  dumper.start_array();
+  shcore::Value record;
+  while ((record = fetch_one(shcore::Argument_list())))
+    dumper.append_value(record);
+  dumper.end_array();
 
   BaseResult::append_json(dumper);
 
@@ -438,6 +538,158 @@ void DocResult::append_json(shcore::JSON_dumper& dumper) const {
 
 // -----------------------------------------------------------------------
 
+// Documentation of ColumnValues class
+REGISTER_HELP(COLUMNVALUES_BRIEF, "Holds the values of a numeric column of a RowResult, as returned by RowResult.fetchColumns.");
+REGISTER_HELP(COLUMNVALUES_DETAIL, "The values are stored contiguously as 64 bit integers or doubles, in Python "\
+"they are exposed through the buffer protocol so they can be used by NumPy without being copied.");
+REGISTER_HELP(COLUMNVALUES_LENGTH_BRIEF, "Returns the number of values.");
+REGISTER_HELP(COLUMNVALUES_NULLCOUNT_BRIEF, "Returns the number of null values.");
+REGISTER_HELP(COLUMNVALUES_NULLS_BRIEF, "Returns a ColumnValues object with a true value for each null value, or Null if there are none.");
+REGISTER_HELP(COLUMNVALUES_GETLENGTH_BRIEF, "Returns the number of values.");
+REGISTER_HELP(COLUMNVALUES_GETNULLCOUNT_BRIEF, "Returns the number of null values.");
+REGISTER_HELP(COLUMNVALUES_GETNULLS_BRIEF, "Returns a ColumnValues object with a true value for each null value, or Null if there are none.");
+
+ColumnValues::ColumnValues(shcore::Value_type type) :
+_type(type), _count(0), _null_count(0) {
+  add_property("length", "getLength");
+  add_property("nullCount", "getNullCount");
+  add_property("nulls", "getNulls");
+}
+
+size_t ColumnValues::item_size() const {
+  return _type == shcore::Bool ? sizeof(uint8_t) : sizeof(int64_t);
+}
+
+const char *ColumnValues::item_format() const {
+  switch (_type) {
+    case shcore::Integer:
+      return "q";
+    case shcore::UInteger:
+      return "Q";
+    case shcore::Float:
+      return "d";
+    default:
+      return "B";
+  }
+}
+
+void ColumnValues::append(const void *values, const uint8_t *nulls, size_t count) {
+  size_t offset = _data.size();
+  _data.resize(offset + count * item_size());
+  if (count)
+    memcpy(&_data[offset], values, count * item_size());
+
+  if (nulls) {
+    for (size_t index = 0; index < count; index++) {
+      if (nulls[index]) {
+        if (!_nulls) {
+          _nulls.reset(new ColumnValues(shcore::Bool));
+          std::vector<uint8_t> none(_count, 0);
+          _nulls->append(none.data(), NULL, _count);
+        }
+        _null_count++;
+      }
+    }
+  }
+
+  if (_nulls) {
+    std::vector<uint8_t> flags(count, 0);
+    if (nulls) {
+      for (size_t index = 0; index < count; index++)
+        flags[index] = nulls[index] ? 1 : 0;
+    }
+    _nulls->append(flags.data(), NULL, count);
+  }
+
+  _count += count;
+}
+
+std::string &ColumnValues::append_descr(std::string &s_out, int indent, int quote_strings) const {
+  std::string nl = (indent >= 0) ? "\n" : "";
+  s_out += "[";
+  for (size_t index = 0; index < _count; index++) {
+    if (index > 0)
+      s_out += ",";
+
+    s_out += nl;
+
+    if (indent >= 0)
+      s_out.append((indent + 1) * 4, ' ');
+
+    get_member(index).append_descr(s_out, indent < 0 ? indent : indent + 1, quote_strings);
+  }
+
+  s_out += nl;
+  if (indent > 0)
+    s_out.append(indent * 4, ' ');
+
+  s_out += "]";
+
+  return s_out;
+}
+
+std::string &ColumnValues::append_repr(std::string &s_out) const {
+  return append_descr(s_out);
+}
+
+void ColumnValues::append_json(shcore::JSON_dumper& dumper) const {
+  dumper.start_array();
+
+  for (size_t index = 0; index < _count; index++)
+    dumper.append_value(get_member(index));
+
+  dumper.end_array();
+}
+
+bool ColumnValues::operator == (const Object_bridge &UNUSED(other)) const {
+  return false;
+}
+
+shcore::Value ColumnValues::get_member(const std::string &prop) const {
+  if (prop == "length")
+    return shcore::Value(uint64_t(_count));
+  else if (prop == "nullCount")
+    return shcore::Value(uint64_t(_null_count));
+  else if (prop == "nulls")
+    return _nulls ? shcore::Value(std::static_pointer_cast<Object_bridge>(_nulls)) : shcore::Value::Null();
+
+  return shcore::Cpp_object_bridge::get_member(prop);
+}
+
+shcore::Value ColumnValues::get_member(size_t index) const {
+  if (index >= _count)
+    return shcore::Value();
+
+  if (_nulls && _nulls->_data[index])
+    return shcore::Value::Null();
+
+  const char *item = &_data[index * item_size()];
+  switch (_type) {
+    case shcore::Integer:
+    {
+      int64_t value;
+      memcpy(&value, item, sizeof(value));
+      return shcore::Value(value);
+    }
+    case shcore::UInteger:
+    {
+      uint64_t value;
+      memcpy(&value, item, sizeof(value));
+      return shcore::Value(value);
+    }
+    case shcore::Float:
+    {
+      double value;
+      memcpy(&value, item, sizeof(value));
+      return shcore::Value(value);
+    }
+    default:
+      return shcore::Value(*item != 0);
+  }
+}
+
+// -----------------------------------------------------------------------
+
 // Documentation of RowResult class
 REGISTER_HELP(ROWRESULT_BRIEF, "Allows traversing the Row objects returned by a Table.select operation.");
 
@@ -449,6 +701,10 @@ BaseResult(result) {
 
   add_method("fetchOne", std::bind(&RowResult::fetch_one, this, _1), "nothing", shcore::String, NULL);
   add_method("fetchAll", std::bind(&RowResult::fetch_all, this, _1), "nothing", shcore::String, NULL);
+  add_method("fetchColumns", std::bind(&RowResult::fetch_columns, this, _1), "nothing", shcore::String, NULL);
+  add_method("forEachBatch", std::bind(&RowResult::for_each_batch, this, _1), "callback", shcore::Function, NULL);
+  add_method("batches", std::bind(&RowResult::batches, this, _1), "options", shcore::Map, NULL);
+  add_method("toArrow", std::bind(&RowResult::to_arrow, this, _1), "path", shcore::String, NULL);
 }
 
 shcore::Value RowResult::get_member(const std::string &prop) const {
@@ -458,12 +714,8 @@ shcore::Value RowResult::get_member(const std::string &prop) const {
   else if (prop == "columnNames") {
     std::shared_ptr<shcore::Value::Array_type> array(new shcore::Value::Array_type);
 
-    if (_result->columnMetadata()) {
-      size_t num_fields = _result->columnMetadata()->size();
-
-      for (size_t i = 0; i < num_fields; i++)
-        array->push_back(shcore::Value(_result->columnMetadata()->at(i).name));
-    }
+    for (auto &name : get_row_columns()->names())
+      array->push_back(shcore::Value(name));
 
     ret_val = shcore::Value(array);
   } else if (prop == "columns")
@@ -511,16 +763,7 @@ List RowResult::getColumnNames() {};
 list RowResult::get_column_names() {};
 #endif
 std::vector<std::string> RowResult::get_column_names() const {
-  std::vector<std::string> ret_val;
-
-  if (_result->columnMetadata()) {
-    size_t num_fields = _result->columnMetadata()->size();
-
-    for (size_t i = 0; i < num_fields; i++)
-      ret_val.push_back(_result->columnMetadata()->at(i).name);
-  }
-
-  return ret_val;
+  return get_row_columns()->names();
 }
 
 // Documentation of getColumns function
@@ -538,12 +781,24 @@ List RowResult::getColumns() {};
 list RowResult::get_columns() {};
 #endif
 shcore::Value::Array_type_ref RowResult::get_columns() const {
-  if (!_columns) {
-    _columns.reset(new shcore::Value::Array_type);
+  return get_row_columns()->columns();
+}
+
+// Built once for each result set, the charset lookups and the Column objects
+// are not repeated for the rows or when the columns are requested again
+std::shared_ptr<mysqlsh::Row_columns> RowResult::get_row_columns() const {
+  std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
 
-    size_t num_fields = _result->columnMetadata()->size();
+  // A new result set comes with its own metadata
+  if (!_row_columns || _row_columns_metadata != metadata) {
+    _row_columns.reset(new Row_columns());
+    _row_columns_metadata = metadata;
+
+    size_t num_fields = metadata ? metadata->size() : 0;
     for (size_t i = 0; i < num_fields; i++) {
-      ::mysqlx::FieldType type = _result->columnMetadata()->at(i).type;
+      ::mysqlx::FieldType type = metadata->at(i).type;
+      const char *collation = ::mysqlx::Charset::collation_name_from_id(metadata->at(i).collation);
+      const char *charset = ::mysqlx::Charset::charset_name_from_id(metadata->at(i).collation);
       bool is_numeric = type == ::mysqlx::SINT ||
         type == ::mysqlx::UINT ||
         type == ::mysqlx::DOUBLE ||
@@ -553,11 +808,11 @@ shcore::Value::Array_type_ref RowResult::get_columns() const {
       std::string type_name;
       bool is_signed = false;
       bool is_padded = true;
-      switch (_result->columnMetadata()->at(i).type) {
+      switch (metadata->at(i).type) {
         case ::mysqlx::SINT:
           is_signed = true;
         case ::mysqlx::UINT:
-          switch (_result->columnMetadata()->at(i).length) {
+          switch (metadata->at(i).length) {
             case 3:
             case 4:
               type_name = "TINYINT";
@@ -584,20 +839,20 @@ shcore::Value::Array_type_ref RowResult::get_columns() const {
           break;
         case ::mysqlx::DOUBLE:
           type_name = "DOUBLE";
-          is_signed = !(_result->columnMetadata()->at(i).flags & 0x001);
+          is_signed = !(metadata->at(i).flags & 0x001);
           break;
         case ::mysqlx::FLOAT:
           type_name = "FLOAT";
-          is_signed = !(_result->columnMetadata()->at(i).flags & 0x001);
+          is_signed = !(metadata->at(i).flags & 0x001);
           break;
         case ::mysqlx::DECIMAL:
           type_name = "DECIMAL";
-          is_signed = !(_result->columnMetadata()->at(i).flags & 0x001);
+          is_signed = !(metadata->at(i).flags & 0x001);
           break;
         case ::mysqlx::BYTES:
-          is_padded = is_signed = _result->columnMetadata()->at(i).flags & 0x001;
+          is_padded = is_signed = metadata->at(i).flags & 0x001;
 
-          switch (_result->columnMetadata()->at(i).content_type & 0x0003) {
+          switch (metadata->at(i).content_type & 0x0003) {
             case 1:
               type_name = "GEOMETRY";
               break;
@@ -608,7 +863,7 @@ shcore::Value::Array_type_ref RowResult::get_columns() const {
               type_name = "XML";
               break;
             default:
-              if (Charset::item[_result->columnMetadata()->at(i).collation].collation == "Binary")
+              if (strcmp(collation, "Binary") == 0)
                 type_name = "BYTES";
               else
                 type_name = "STRING";
@@ -619,9 +874,9 @@ shcore::Value::Array_type_ref RowResult::get_columns() const {
           type_name = "TIME";
           break;
         case ::mysqlx::DATETIME:
-          if (_result->columnMetadata()->at(i).flags & 0x001)
+          if (metadata->at(i).flags & 0x001)
             type_name = "TIMESTAMP";
-          else if (_result->columnMetadata()->at(i).length == 10)
+          else if (metadata->at(i).length == 10)
             type_name = "DATE";
           else
             type_name = "DATETIME";
@@ -638,35 +893,324 @@ shcore::Value::Array_type_ref RowResult::get_columns() const {
 
       // the plugin may not send these if they are equal to table/name respectively
       // We need to reconstruct them
-      std::string orig_table = _result->columnMetadata()->at(i).original_table;
-      std::string orig_name = _result->columnMetadata()->at(i).original_name;
+      std::string orig_table = metadata->at(i).original_table;
+      std::string orig_name = metadata->at(i).original_name;
 
       if (orig_table.empty())
-        orig_table = _result->columnMetadata()->at(i).table;
+        orig_table = metadata->at(i).table;
 
       if (orig_name.empty())
-        orig_name = _result->columnMetadata()->at(i).name;
+        orig_name = metadata->at(i).name;
 
       std::shared_ptr<mysqlsh::Column> column(new mysqlsh::Column(
-        _result->columnMetadata()->at(i).schema,
+        metadata->at(i).schema,
         orig_table,
-        _result->columnMetadata()->at(i).table,
+        metadata->at(i).table,
         orig_name,
-        _result->columnMetadata()->at(i).name,
+        metadata->at(i).name,
         data_type,
-        _result->columnMetadata()->at(i).length,
+        metadata->at(i).length,
   is_numeric,
-        _result->columnMetadata()->at(i).fractional_digits,
+        metadata->at(i).fractional_digits,
         is_signed,
-  Charset::item[_result->columnMetadata()->at(i).collation].collation,
-  Charset::item[_result->columnMetadata()->at(i).collation].name,
+        collation,
+        charset,
         is_padded));
 
-      _columns->push_back(shcore::Value(std::static_pointer_cast<Object_bridge>(column)));
+      bool binary = type == ::mysqlx::BYTES && (metadata->at(i).content_type & 0x0003) == 0 &&
+                    strcmp(charset, "binary") == 0;
+      _row_columns->add(metadata->at(i).name,
+                        shcore::Value(std::static_pointer_cast<Object_bridge>(column)), binary);
+    }
+  }
+
+  return _row_columns;
+}
+
+namespace {
+// The fields of a single row and of a row in a batch are read through these
+// accessors, so both convert them with convert_field()
+class Row_field {
+public:
+  Row_field(const ::mysqlx::Row &row, int index) : _row(row), _index(index) {}
+
+  bool is_null() const { return _row.isNullField(_index); }
+  int64_t sint() const { return _row.sInt64Field(_index); }
+  uint64_t uint() const { return _row.uInt64Field(_index); }
+  uint64_t bit() const { return _row.bitField(_index); }
+  double real(::mysqlx::FieldType type) const {
+    return type == ::mysqlx::FLOAT ? _row.floatField(_index) : _row.doubleField(_index);
+  }
+  std::string text(::mysqlx::FieldType type) const {
+    if (type == ::mysqlx::DECIMAL)
+      return _row.decimalField(_index);
+    if (type == ::mysqlx::ENUM)
+      return _row.enumField(_index);
+    return _row.stringField(_index);
+  }
+  ::mysqlx::Time time() const { return _row.timeField(_index); }
+  ::mysqlx::DateTime date_time() const { return _row.dateTimeField(_index); }
+
+private:
+  const ::mysqlx::Row &_row;
+  int _index;
+};
+
+class Batch_field {
+public:
+  Batch_field(const ::mysqlx::Row_batch &batch, size_t row, int index) : _batch(batch), _row(row), _index(index) {}
+
+  bool is_null() const { return _batch.isNullField(_row, _index); }
+  int64_t sint() const { return _batch.sInt64Field(_row, _index); }
+  uint64_t uint() const { return _batch.uInt64Field(_row, _index); }
+  uint64_t bit() const { return _batch.uInt64Field(_row, _index); }
+  double real(::mysqlx::FieldType UNUSED(type)) const { return _batch.doubleField(_row, _index); }
+  std::string text(::mysqlx::FieldType UNUSED(type)) const { return _batch.stringField(_row, _index); }
+  ::mysqlx::Time time() const { return _batch.timeField(_row, _index); }
+  ::mysqlx::DateTime date_time() const { return _batch.dateTimeField(_row, _index); }
+
+private:
+  const ::mysqlx::Row_batch &_batch;
+  size_t _row;
+  int _index;
+};
+
+// Converts a field of the given column into a shell value
+template <class Field>
+Value convert_field(const Field &field, const ::mysqlx::ColumnMetadata &column) {
+  if (field.is_null())
+    return Value::Null();
+
+  switch (column.type) {
+    case ::mysqlx::SINT:
+      return Value(field.sint());
+    case ::mysqlx::UINT:
+      return Value(field.uint());
+    case ::mysqlx::BIT:
+      return Value(field.bit());
+    case ::mysqlx::DOUBLE:
+    case ::mysqlx::FLOAT:
+      return Value(field.real(column.type));
+    case ::mysqlx::BYTES:
+    case ::mysqlx::DECIMAL:
+    case ::mysqlx::ENUM:
+      return Value(field.text(column.type));
+    case ::mysqlx::TIME:
+      return Value(field.time().to_string());
+    case ::mysqlx::DATETIME:
+    {
+      ::mysqlx::DateTime date = field.date_time();
+      auto shell_date = std::make_shared<shcore::Date>(date.year(), date.month(), date.day(), date.hour(), date.minutes(), date.seconds());
+      return Value(std::static_pointer_cast<Object_bridge>(shell_date));
+    }
+      //TODO: Fix the handling of SET
+    case ::mysqlx::SET:
+      break;
+  }
+
+  return Value();
+}
+}
+
+static Value get_row_field(const ::mysqlx::Row &row, const ::mysqlx::ColumnMetadata &column, int index) {
+  return convert_field(Row_field(row, index), column);
+}
+
+static Value get_batch_field(const ::mysqlx::Row_batch &batch, const ::mysqlx::ColumnMetadata &column, size_t row, int index) {
+  return convert_field(Batch_field(batch, row, index), column);
+}
+
+bool RowResult::dump_raw(std::string &buffer, const Raw_flush &flush, size_t &row_count) const {
+  row_count = 0;
+
+  std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
+  if (!metadata || metadata->empty())
+    return true;
+
+  // The fields are written from the batches as they are, only the types
+  // with no plain text form are converted into values and the binary
+  // strings go through binaryAs
+  std::shared_ptr<Row_columns> columns = get_row_columns();
+  std::shared_ptr< ::mysqlx::Row_batch> batch;
+  while ((batch = next_batch())) {
+    for (size_t row = 0; row < batch->size(); row++) {
+      for (int index = 0; index < int(metadata->size()); index++) {
+        if (index)
+          buffer += '\t';
+
+        if (batch->isNullField(row, index)) {
+          buffer += "null";
+          continue;
+        }
+
+        switch (metadata->at(index).type) {
+          case ::mysqlx::SINT:
+            buffer += std::to_string(batch->sInt64Field(row, index));
+            break;
+          case ::mysqlx::UINT:
+          case ::mysqlx::BIT:
+            buffer += std::to_string(batch->uInt64Field(row, index));
+            break;
+          case ::mysqlx::BYTES:
+          case ::mysqlx::DECIMAL:
+          case ::mysqlx::ENUM:
+          {
+            size_t length;
+            const char *data = batch->stringField(row, index, length);
+            if (columns->is_binary(index))
+              append_binary(buffer, data, length);
+            else
+              buffer.append(data, length);
+            break;
+          }
+          case ::mysqlx::TIME:
+            buffer += batch->timeField(row, index).to_string();
+            break;
+          default:
+            get_batch_field(*batch, metadata->at(index), row, index).append_descr(buffer);
+            break;
+        }
+      }
+      buffer += '\n';
+
+      row_count++;
+      flush(buffer);
     }
   }
 
-  return _columns;
+  return true;
+}
+
+// Documentation of toArrow function
+REGISTER_HELP(ROWRESULT_TOARROW_BRIEF, "Writes the unread records of the result to a file in the Apache Arrow IPC stream format.");
+REGISTER_HELP(ROWRESULT_TOARROW_PARAM, "@param path the file to be written.");
+REGISTER_HELP(ROWRESULT_TOARROW_RETURN, "@return The number of records written.");
+REGISTER_HELP(ROWRESULT_TOARROW_DETAIL, "Integer and floating point columns are written as Int64, UInt64 and Double, "\
+"binary strings as LargeBinary and the rest of columns as LargeUtf8 with the text of the values.");
+
+/**
+* $(ROWRESULT_TOARROW_BRIEF)
+*
+* $(ROWRESULT_TOARROW_PARAM)
+*
+* $(ROWRESULT_TOARROW_RETURN)
+*
+* $(ROWRESULT_TOARROW_DETAIL)
+*/
+#if DOXYGEN_JS
+Integer RowResult::toArrow(String path) {};
+#elif DOXYGEN_PY
+int RowResult::to_arrow(str path) {};
+#endif
+bool RowResult::dump_arrow(const Arrow_stream_writer::Output &output, size_t &row_count) const {
+  std::vector<Arrow_stream_writer::Field> fields;
+  std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
+  for (size_t index = 0; metadata && index < metadata->size(); index++) {
+    const ::mysqlx::ColumnMetadata &column = metadata->at(index);
+    Arrow_stream_writer::Type type;
+    switch (column.type) {
+      case ::mysqlx::SINT:
+        type = Arrow_stream_writer::Type::Int64;
+        break;
+      case ::mysqlx::UINT:
+      case ::mysqlx::BIT:
+        type = Arrow_stream_writer::Type::UInt64;
+        break;
+      case ::mysqlx::DOUBLE:
+      case ::mysqlx::FLOAT:
+        type = Arrow_stream_writer::Type::Double;
+        break;
+      case ::mysqlx::BYTES:
+        type = strcmp(::mysqlx::Charset::charset_name_from_id(static_cast<uint32_t>(column.collation)), "binary") == 0 ?
+          Arrow_stream_writer::Type::Binary : Arrow_stream_writer::Type::Utf8;
+        break;
+      default:
+        type = Arrow_stream_writer::Type::Utf8;
+        break;
+    }
+    fields.emplace_back(column.name, type);
+  }
+
+  // Nothing is written for the results without data sets
+  row_count = 0;
+  if (fields.empty())
+    return true;
+
+  Arrow_stream_writer writer(fields, output);
+
+  // The value arrays and string offsets of the batches are the buffers of
+  // the record batches, only the nulls and the dates and times, which are
+  // written as text, are converted
+  std::vector<std::string> bitmaps(fields.size());
+  std::vector<std::vector<int64_t> > offsets(fields.size());
+  std::vector<std::string> texts(fields.size());
+  std::vector<Arrow_stream_writer::Column> columns(fields.size());
+
+  std::shared_ptr< ::mysqlx::Row_batch> batch;
+  while ((batch = next_batch())) {
+    for (int index = 0; index < int(fields.size()); index++) {
+      const ::mysqlx::Row_batch::Column &column = batch->column(index);
+      Arrow_stream_writer::Column &arrow_column = columns[index];
+
+      arrow_column.null_count = Arrow_stream_writer::validity_from_nulls(column.nulls.data(), batch->size(), &bitmaps[index]);
+      arrow_column.validity = bitmaps[index].data();
+
+      switch (column.type) {
+        case ::mysqlx::SINT:
+          arrow_column.values = column.sints.data();
+          arrow_column.values_size = column.sints.size() * sizeof(int64_t);
+          break;
+        case ::mysqlx::UINT:
+        case ::mysqlx::BIT:
+          arrow_column.values = column.uints.data();
+          arrow_column.values_size = column.uints.size() * sizeof(uint64_t);
+          break;
+        case ::mysqlx::DOUBLE:
+        case ::mysqlx::FLOAT:
+          arrow_column.values = column.doubles.data();
+          arrow_column.values_size = column.doubles.size() * sizeof(double);
+          break;
+        case ::mysqlx::BYTES:
+        case ::mysqlx::ENUM:
+        case ::mysqlx::SET:
+        case ::mysqlx::DECIMAL:
+          if (sizeof(size_t) == sizeof(int64_t)) {
+            arrow_column.values = column.offsets.data();
+          } else {
+            offsets[index].assign(column.offsets.begin(), column.offsets.end());
+            arrow_column.values = offsets[index].data();
+          }
+          arrow_column.values_size = column.offsets.size() * sizeof(int64_t);
+          arrow_column.data = column.data.data();
+          arrow_column.data_size = column.data.size();
+          break;
+        default: {
+          offsets[index].assign(1, 0);
+          texts[index].clear();
+          for (size_t row = 0; row < batch->size(); row++) {
+            if (!column.nulls[row]) {
+              if (column.type == ::mysqlx::TIME)
+                texts[index] += column.times[row].to_string();
+              else
+                get_batch_field(*batch, metadata->at(index), row, index).append_descr(texts[index]);
+            }
+            offsets[index].push_back(static_cast<int64_t>(texts[index].size()));
+          }
+          arrow_column.values = offsets[index].data();
+          arrow_column.values_size = offsets[index].size() * sizeof(int64_t);
+          arrow_column.data = texts[index].data();
+          arrow_column.data_size = texts[index].size();
+          break;
+        }
+      }
+    }
+
+    writer.write_batch(batch->size(), columns);
+    row_count += batch->size();
+  }
+
+  writer.finish();
+  return true;
 }
 
 // Documentation of fetchOne function
@@ -690,61 +1234,53 @@ shcore::Value RowResult::fetch_one(const shcore::Argument_list &args) const {
   try {
     std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
     if (metadata->size() > 0) {
-      std::shared_ptr< ::mysqlx::Row>row = _result->next();
+      std::shared_ptr< ::mysqlx::Row> row;
+      {
+        Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+        row = _result->next();
+      }
+
       if (row) {
-        mysqlsh::Row *value_row = new mysqlsh::Row();
-
-        for (int index = 0; index < int(metadata->size()); index++) {
-          Value field_value;
-
-          if (row->isNullField(index))
-            field_value = Value::Null();
-          else {
-            switch (metadata->at(index).type) {
-              case ::mysqlx::SINT:
-                field_value = Value(row->sInt64Field(index));
-                break;
-              case ::mysqlx::UINT:
-                field_value = Value(row->uInt64Field(index));
-                break;
-              case ::mysqlx::DOUBLE:
-                field_value = Value(row->doubleField(index));
-                break;
-              case ::mysqlx::FLOAT:
-                field_value = Value(row->floatField(index));
-                break;
-              case ::mysqlx::BYTES:
-                field_value = Value(row->stringField(index));
-                break;
-              case ::mysqlx::DECIMAL:
-                field_value = Value(row->decimalField(index));
-                break;
-              case ::mysqlx::TIME:
-                field_value = Value(row->timeField(index).to_string());
-                break;
-              case ::mysqlx::DATETIME:
-              {
-                ::mysqlx::DateTime date = row->dateTimeField(index);
-                std::shared_ptr<shcore::Date> shell_date(new shcore::Date(date.year(), date.month(), date.day(), date.hour(), date.minutes(), date.seconds()));
-                field_value = Value(std::static_pointer_cast<Object_bridge>(shell_date));
-                break;
-              }
-              case ::mysqlx::ENUM:
-                field_value = Value(row->enumField(index));
-                break;
-              case ::mysqlx::BIT:
-                field_value = Value(row->bitField(index));
-                break;
-                //TODO: Fix the handling of SET
-              case ::mysqlx::SET:
-                //field_value = Value(row->setField(int(index)));
-                break;
-            }
+        Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+        mysqlsh::Row *value_row = new mysqlsh::Row(get_row_columns());
+
+        // The fields are converted into shell values the first time they
+        // are accessed, the raw row is kept alive by the loader
+        value_row->set_field_loader([row, metadata](size_t index) {
+          shcore::Value field_value;
+          try {
+            field_value = get_row_field(*row, metadata->at(index), int(index));
           }
-          value_row->add_item(metadata->at(index).name, field_value);
-        }
+          CATCH_AND_TRANSLATE();
+
+          return field_value;
+        });
+
+        // Strings and bytes are printed, read or written to files from the
+        // received message, so a large BLOB never has to be converted into
+        // a value
+        value_row->set_raw_field([row, metadata](size_t index, const char *&data, size_t &length) {
+          if (row->isNullField(int(index)))
+            return false;
+
+          switch (metadata->at(index).type) {
+            case ::mysqlx::BYTES:
+              data = row->stringField(int(index), length);
+              return true;
+            case ::mysqlx::ENUM:
+              data = row->enumField(int(index), length);
+              return true;
+            default:
+              return false;
+          }
+        });
+
+        for (size_t index = 0; index < metadata->size(); index++)
+          value_row->add_lazy_value();
 
         ret_val = shcore::Value::wrap(value_row);
+      } else {
+        end_of_data();
       }
     }
   }
@@ -772,16 +1308,368 @@ shcore::Value RowResult::fetch_all(const shcore::Argument_list &args) const {
 
   args.ensure_count(0, get_function_name("fetchAll").c_str());
 
-  // Gets the next row
-  Value record = fetch_one(args);
-  while (record) {
-    array->push_back(record);
-    record = fetch_one(args);
+  // The remaining rows are read in column major batches, so no intermediate
+  // ::mysqlx::Row is created for each of them. The rows are accounted on the
+  // memory budget while they are built.
+  try {
+    shcore::Memory_reservation reservation(shcore::Memory_budget::Values);
+    std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
+    if (metadata && metadata->size() > 0) {
+      std::shared_ptr< ::mysqlx::Row_batch> batch;
+      while ((batch = next_batch())) {
+        Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+        // The values of a batch share an arena
+        shcore::Arena_scope arena_scope;
+        reservation.add(append_rows(*batch, *array));
+      }
+    }
   }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchAll"));
 
   return Value(array);
 }
 
+size_t RowResult::append_rows(const ::mysqlx::Row_batch &batch, Value::Array_type &rows) const {
+  std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
+  std::shared_ptr<Row_columns> columns = get_row_columns();
+  size_t memory_size = 0;
+
+  for (size_t row = 0; row < batch.size(); row++) {
+    mysqlsh::Row *value_row = new mysqlsh::Row(columns);
+
+    for (int index = 0; index < int(metadata->size()); index++)
+      value_row->add_value(get_batch_field(batch, metadata->at(index), row, index));
+
+    rows.push_back(shcore::Value::wrap(value_row));
+    memory_size += value_row->memory_size();
+  }
+
+  return memory_size;
+}
+
+// Organizes the rows of the batches by column, the numeric columns are
+// copied from the batches as they are, the rest are converted into shell
+// values
+namespace {
+class Column_builder {
+public:
+  explicit Column_builder(const std::vector< ::mysqlx::ColumnMetadata> &metadata) :
+  _metadata(metadata), _numeric(metadata.size()), _values(metadata.size()) {
+    for (size_t index = 0; index < metadata.size(); index++) {
+      switch (metadata[index].type) {
+        case ::mysqlx::SINT:
+          _numeric[index].reset(new ColumnValues(shcore::Integer));
+          break;
+        case ::mysqlx::UINT:
+        case ::mysqlx::BIT:
+          _numeric[index].reset(new ColumnValues(shcore::UInteger));
+          break;
+        case ::mysqlx::DOUBLE:
+        case ::mysqlx::FLOAT:
+          _numeric[index].reset(new ColumnValues(shcore::Float));
+          break;
+        default:
+          _values[index].reset(new Value::Array_type());
+          break;
+      }
+    }
+  }
+
+  void append(const ::mysqlx::Row_batch &batch) {
+    for (int index = 0; index < int(_metadata.size()); index++) {
+      const ::mysqlx::Row_batch::Column &column = batch.column(index);
+
+      if (_numeric[index]) {
+        const void *data;
+        if (column.type == ::mysqlx::SINT)
+          data = column.sints.data();
+        else if (column.type == ::mysqlx::DOUBLE || column.type == ::mysqlx::FLOAT)
+          data = column.doubles.data();
+        else
+          data = column.uints.data();
+
+        _numeric[index]->append(data, column.nulls.data(), batch.size());
+      } else {
+        for (size_t row = 0; row < batch.size(); row++)
+          _values[index]->push_back(get_batch_field(batch, _metadata[index], row, index));
+      }
+    }
+  }
+
+  Value::Map_type_ref columns() const {
+    Value::Map_type_ref map(new Value::Map_type());
+
+    for (size_t index = 0; index < _metadata.size(); index++) {
+      if (_numeric[index])
+        (*map)[_metadata[index].name] = Value(std::static_pointer_cast<Object_bridge>(_numeric[index]));
+      else
+        (*map)[_metadata[index].name] = Value(_values[index]);
+    }
+
+    return map;
+  }
+
+private:
+  const std::vector< ::mysqlx::ColumnMetadata> &_metadata;
+  std::vector<std::shared_ptr<ColumnValues> > _numeric;
+  std::vector<Value::Array_type_ref> _values;
+};
+}
+
+// Documentation of fetchColumns function
+REGISTER_HELP(ROWRESULT_FETCHCOLUMNS_BRIEF, "Returns the unread records of the result organized by column.");
+REGISTER_HELP(ROWRESULT_FETCHCOLUMNS_RETURN, "@return A Map with an entry for every column of the result.");
+REGISTER_HELP(ROWRESULT_FETCHCOLUMNS_DETAIL, "The integer and floating point columns are returned as ColumnValues objects "\
+"holding the values contiguously, in Python they support the buffer protocol so numpy.asarray() uses them without "\
+"copying the data. The rest of columns are returned as a List with the value of each record.");
+
+/**
+* $(ROWRESULT_FETCHCOLUMNS_BRIEF)
+*
+* $(ROWRESULT_FETCHCOLUMNS_RETURN)
+*
+* $(ROWRESULT_FETCHCOLUMNS_DETAIL)
+*/
+#if DOXYGEN_JS
+Map RowResult::fetchColumns() {};
+#elif DOXYGEN_PY
+dict RowResult::fetch_columns() {};
+#endif
+shcore::Value RowResult::fetch_columns(const shcore::Argument_list &args) const {
+  Value::Map_type_ref map(new Value::Map_type());
+
+  args.ensure_count(0, get_function_name("fetchColumns").c_str());
+
+  try {
+    std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
+    if (metadata && metadata->size() > 0) {
+      Column_builder builder(*metadata);
+
+      std::shared_ptr< ::mysqlx::Row_batch> batch;
+      while ((batch = next_batch())) {
+        Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+        builder.append(*batch);
+      }
+
+      map = builder.columns();
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("fetchColumns"));
+
+  return Value(map);
+}
+
+Value RowResult::read_batch(size_t size, bool by_column, size_t *row_count) const {
+  std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata = _result->columnMetadata();
+  if (!metadata || metadata->empty())
+    return Value();
+
+  std::shared_ptr< ::mysqlx::Row_batch> batch = next_batch(size);
+  if (!batch)
+    return Value();
+
+  Phase_timer decode_timer(_timing.phases[Statement_timing::Decode]);
+  *row_count = batch->size();
+
+  if (by_column) {
+    Column_builder builder(*metadata);
+    builder.append(*batch);
+    return Value(builder.columns());
+  }
+
+  Value::Array_type_ref rows(new Value::Array_type());
+  {
+    shcore::Arena_scope arena_scope;
+    append_rows(*batch, *rows);
+  }
+  return Value(rows);
+}
+
+void mysqlsh::mysqlx::parse_batch_options(const shcore::Argument_list &args, unsigned int index, size_t *size, bool *by_column) {
+  *size = FETCH_ALL_BATCH_SIZE;
+  *by_column = false;
+
+  if (args.size() > index) {
+    shcore::Argument_map options(*args.map_at(index));
+    options.ensure_keys({}, {"size", "format"}, "batch options");
+
+    if (options.has_key("size")) {
+      *size = options.uint_at("size");
+      if (*size == 0)
+        throw shcore::Exception::argument_error("The value for 'size' must be greater than 0");
+    }
+
+    if (options.has_key("format")) {
+      std::string format = options.string_at("format");
+      if (format == "columns")
+        *by_column = true;
+      else if (format != "rows")
+        throw shcore::Exception::argument_error("The value for 'format' must be either 'rows' or 'columns'");
+    }
+  }
+}
+
+// Documentation of forEachBatch function
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_BRIEF, "Calls a function with each batch of the unread records of the result.");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_PARAM, "@param callback The function receiving each batch.");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_PARAM1, "@param options Optional dictionary with the options for the batches.");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_RETURN, "@return The number of records passed to the function.");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_DETAIL, "Only one batch is held at a time, so a large result can be processed without ""holding all of its records. The iteration stops early if the function returns false.");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_DETAIL2, "@li size: maximum number of records of a batch, 4096 by default.");
+REGISTER_HELP(ROWRESULT_FOREACHBATCH_DETAIL3, "@li format: rows to get each batch as a List of Row objects, the default, or ""columns to get it as a Map like the one returned by fetchColumns().");
+
+/**
+* $(ROWRESULT_FOREACHBATCH_BRIEF)
+*
+* $(ROWRESULT_FOREACHBATCH_PARAM)
+* $(ROWRESULT_FOREACHBATCH_PARAM1)
+*
+* $(ROWRESULT_FOREACHBATCH_RETURN)
+*
+* $(ROWRESULT_FOREACHBATCH_DETAIL)
+*
+* $(ROWRESULT_FOREACHBATCH_DETAIL1)
+* $(ROWRESULT_FOREACHBATCH_DETAIL2)
+* $(ROWRESULT_FOREACHBATCH_DETAIL3)
+*/
+#if DOXYGEN_JS
+Integer RowResult::forEachBatch(Function callback, Map options) {};
+#elif DOXYGEN_PY
+int RowResult::for_each_batch(function callback, dict options) {};
+#endif
+shcore::Value RowResult::for_each_batch(const shcore::Argument_list &args) const {
+  size_t row_count = 0;
+
+  args.ensure_count(1, 2, get_function_name("forEachBatch").c_str());
+
+  try {
+    std::shared_ptr<shcore::Function_base> callback = args.at(0).as_function();
+
+    size_t size;
+    bool by_column;
+    parse_batch_options(args, 1, &size, &by_column);
+
+    RowBatches batches(shared_from_this(), size, by_column);
+    Value batch;
+    while ((batch = batches.next_value()).type != shcore::Undefined) {
+      shcore::Argument_list callback_args;
+      callback_args.push_back(batch);
+
+      Value proceed = callback->invoke(callback_args);
+      if (proceed.type == shcore::Bool && !proceed.as_bool())
+        break;
+    }
+    row_count = batches.row_count();
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("forEachBatch"));
+
+  return Value(uint64_t(row_count));
+}
+
+// Documentation of batches function
+REGISTER_HELP(ROWRESULT_BATCHES_BRIEF, "Returns an object that reads the unread records of the result one batch at a time.");
+REGISTER_HELP(ROWRESULT_BATCHES_PARAM, "@param options Optional dictionary with the options for the batches.");
+REGISTER_HELP(ROWRESULT_BATCHES_RETURN, "@return A RowBatches object.");
+REGISTER_HELP(ROWRESULT_BATCHES_DETAIL, "In Python the returned object is an iterator, so the batches can be traversed with a for loop.");
+REGISTER_HELP(ROWRESULT_BATCHES_DETAIL1, "The options are the same as the ones of forEachBatch().");
+
+/**
+* $(ROWRESULT_BATCHES_BRIEF)
+*
+* $(ROWRESULT_BATCHES_PARAM)
+*
+* $(ROWRESULT_BATCHES_RETURN)
+*
+* $(ROWRESULT_BATCHES_DETAIL)
+*
+* $(ROWRESULT_BATCHES_DETAIL1)
+*/
+#if DOXYGEN_JS
+RowBatches RowResult::batches(Map options) {};
+#elif DOXYGEN_PY
+RowBatches RowResult::batches(dict options) {};
+#endif
+shcore::Value RowResult::batches(const shcore::Argument_list &args) const {
+  Value ret_val;
+
+  args.ensure_count(0, 1, get_function_name("batches").c_str());
+
+  try {
+    size_t size;
+    bool by_column;
+    parse_batch_options(args, 0, &size, &by_column);
+
+    ret_val = shcore::Value::wrap(new RowBatches(shared_from_this(), size, by_column));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("batches"));
+
+  return ret_val;
+}
+
+// -----------------------------------------------------------------------
+
+// Documentation of RowBatches class
+REGISTER_HELP(ROWBATCHES_BRIEF, "Reads the records of a RowResult one batch at a time, as returned by RowResult.batches.");
+REGISTER_HELP(ROWBATCHES_DETAIL, "In Python it is an iterator, the batches can be traversed with a for loop.");
+REGISTER_HELP(ROWBATCHES_NEXT_BRIEF, "Returns the next batch of records, or Null once all the records were read.");
+
+RowBatches::RowBatches(std::shared_ptr<const RowResult> result, size_t size, bool by_column) :
+_result(result), _size(size), _by_column(by_column), _row_count(0) {
+  add_method("next", std::bind(&RowBatches::next, this, _1), NULL);
+}
+
+bool RowBatches::operator == (const Object_bridge &UNUSED(other)) const {
+  return false;
+}
+
+shcore::Value RowBatches::next_value() {
+  size_t row_count = 0;
+  Value batch = _result->read_batch(_size, _by_column, &row_count);
+  _row_count += row_count;
+  return batch;
+}
+
+/**
+* $(ROWBATCHES_NEXT_BRIEF)
+*/
+#if DOXYGEN_JS
+Object RowBatches::next() {};
+#elif DOXYGEN_PY
+object RowBatches::next() {};
+#endif
+shcore::Value RowBatches::next(const shcore::Argument_list &args) {
+  Value ret_val = Value::Null();
+
+  args.ensure_count(0, get_function_name("next").c_str());
+
+  try {
+    Value batch = next_value();
+    if (batch.type != shcore::Undefined)
+      ret_val = batch;
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("next"));
+
+  return ret_val;
+}
+
+std::shared_ptr< ::mysqlx::Row_batch> BaseResult::next_batch() const {
+  return next_batch(FETCH_ALL_BATCH_SIZE);
+}
+
+std::shared_ptr< ::mysqlx::Row_batch> BaseResult::next_batch(size_t rows) const {
+  std::shared_ptr< ::mysqlx::Row_batch> batch;
+  {
+    Phase_timer network_timer(_timing.phases[Statement_timing::Network]);
+    batch = _result->next_batch(rows);
+  }
+
+  if (!batch)
+    end_of_data();
+
+  return batch;
+}
+
 void RowResult::append_json(shcore::JSON_dumper& dumper) const {
   bool create_object = (dumper.deep_level() == 0);
 
@@ -790,7 +1678,14 @@ void RowResult::append_json(shcore::JSON_dumper& dumper) const {
 
   BaseResult::append_json(dumper);
 
-  dumper.append_value("rows", fetch_all(shcore::Argument_list()));
+  // Records are written as they are fetched, so the whole result is not kept
+  // in memory when the dumper is streaming
+  dumper.append_string("rows");
+  dumper.start_array();
+  shcore::Value record;
+  while ((record = fetch_one(shcore::Argument_list())))
+    dumper.append_value(record);
+  dumper.end_array();
 
   if (create_object)
     dumper.end_object();
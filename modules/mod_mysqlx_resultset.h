@@ -27,6 +27,8 @@
 
 namespace mysqlx {
 class Result;
+class Row_batch;
+struct ColumnMetadata;
 }
 
 namespace mysqlsh {
@@ -37,7 +39,8 @@ namespace mysqlx {
 class SHCORE_PUBLIC BaseResult : public mysqlsh::ShellBaseResult {
 public:
   BaseResult(std::shared_ptr< ::mysqlx::Result> result);
-  virtual ~BaseResult() {}
+  // Recorded before the result goes away, rows_read() needs it
+  virtual ~BaseResult() { record_timing(); }
 
   virtual shcore::Value get_member(const std::string &prop) const;
   virtual void append_json(shcore::JSON_dumper& dumper) const;
@@ -52,6 +55,7 @@ public:
   virtual bool rewind();
   virtual bool tell(size_t &dataset, size_t &record);
   virtual bool seek(size_t dataset, size_t record);
+  virtual uint64_t rows_read() const;
 
 #if DOXYGEN_JS
   Integer warningCount; //!< Same as getwarningCount()
@@ -72,6 +76,10 @@ public:
 #endif
 
 protected:
+  // Reads the next batch of rows accounting the time as network time
+  std::shared_ptr< ::mysqlx::Row_batch> next_batch() const;
+  std::shared_ptr< ::mysqlx::Row_batch> next_batch(size_t rows) const;
+
   std::shared_ptr< ::mysqlx::Result> _result;
   unsigned long _execution_time;
 };
@@ -135,6 +143,7 @@ public:
 
   shcore::Value fetch_one(const shcore::Argument_list &args) const;
   shcore::Value fetch_all(const shcore::Argument_list &args) const;
+  shcore::Value fetch_raw(const shcore::Argument_list &args) const;
 
   virtual std::string class_name() const { return "DocResult"; }
   virtual void append_json(shcore::JSON_dumper& dumper) const;
@@ -144,19 +153,79 @@ public:
 #if DOXYGEN_JS
   Document fetchOne();
   List fetchAll();
+  String fetchRaw();
 #elif DOXYGEN_PY
   Document fetch_one();
   list fetch_all();
+  str fetch_raw();
 #endif
 
 private:
   mutable shcore::Value _metadata;
 };
 
+/**
+* $(COLUMNVALUES_BRIEF)
+*/
+class SHCORE_PUBLIC ColumnValues : public shcore::Cpp_object_bridge, public shcore::Cpp_buffer {
+public:
+#if DOXYGEN_JS
+  length; //!< Same as getLength()
+  nullCount; //!< Same as getNullCount()
+  nulls; //!< Same as getNulls()
+
+  Integer getLength();
+  Integer getNullCount();
+  ColumnValues getNulls();
+#elif DOXYGEN_PY
+  length; //!< Same as get_length()
+  null_count; //!< Same as get_null_count()
+  nulls; //!< Same as get_nulls()
+
+  int get_length();
+  int get_null_count();
+  ColumnValues get_nulls();
+#endif
+  // The values are stored as int64_t, uint64_t, double or, for Bool,
+  // as one byte per value
+  ColumnValues(shcore::Value_type type);
+  virtual ~ColumnValues() {}
+
+  virtual std::string class_name() const { return "ColumnValues"; }
+  virtual bool is_indexed() const { return true; }
+
+  virtual std::string &append_descr(std::string &s_out, int indent = -1, int quote_strings = 0) const;
+  virtual std::string &append_repr(std::string &s_out) const;
+  virtual void append_json(shcore::JSON_dumper& dumper) const;
+
+  virtual bool operator == (const Object_bridge &other) const;
+
+  virtual shcore::Value get_member(const std::string &prop) const;
+  virtual shcore::Value get_member(size_t index) const;
+
+  // Appends count values from an array of the column type, nulls holds a
+  // non zero byte for each null value
+  void append(const void *values, const uint8_t *nulls, size_t count);
+
+  virtual const void *buffer_data() const { return _data.data(); }
+  virtual size_t item_count() const { return _count; }
+  virtual size_t item_size() const;
+  virtual const char *item_format() const;
+
+private:
+  shcore::Value_type _type;
+  std::vector<char> _data;
+  size_t _count;
+
+  // Created once the first null value is appended
+  std::shared_ptr<ColumnValues> _nulls;
+  size_t _null_count;
+};
+
 /**
 * $(ROWRESULT_BRIEF)
 */
-class SHCORE_PUBLIC RowResult : public BaseResult {
+class SHCORE_PUBLIC RowResult : public BaseResult, public std::enable_shared_from_this<RowResult> {
 public:
   RowResult(std::shared_ptr< ::mysqlx::Result> result);
 
@@ -164,6 +233,11 @@ public:
 
   shcore::Value fetch_one(const shcore::Argument_list &args) const;
   shcore::Value fetch_all(const shcore::Argument_list &args) const;
+  shcore::Value fetch_columns(const shcore::Argument_list &args) const;
+  shcore::Value for_each_batch(const shcore::Argument_list &args) const;
+  shcore::Value batches(const shcore::Argument_list &args) const;
+  virtual bool dump_raw(std::string &buffer, const Raw_flush &flush, size_t &row_count) const;
+  virtual bool dump_arrow(const shcore::Arrow_stream_writer::Output &output, size_t &row_count) const;
 
   virtual shcore::Value get_member(const std::string &prop) const;
 
@@ -178,6 +252,10 @@ public:
 #if DOXYGEN_JS
   Row fetchOne();
   List fetchAll();
+  Map fetchColumns();
+  Integer forEachBatch(Function callback, Map options);
+  RowBatches batches(Map options);
+  Integer toArrow(String path);
 
   Integer columnCount; //!< Same as getColumnCount()
   List columnNames; //!< Same as getColumnNames()
@@ -189,6 +267,10 @@ public:
 #elif DOXYGEN_PY
   Row fetch_one();
   list fetch_all();
+  dict fetch_columns();
+  int for_each_batch(function callback, dict options);
+  RowBatches batches(dict options);
+  int to_arrow(str path);
 
   int column_count; //!< Same as get_column_count()
   list column_names; //!< Same as get_column_names()
@@ -200,7 +282,60 @@ public:
 #endif
 
 private:
-  mutable shcore::Value::Array_type_ref _columns;
+  friend class RowBatches;
+
+  // The columns of the current result set, shared by its rows
+  std::shared_ptr<Row_columns> get_row_columns() const;
+
+  // Appends a Row object for each row of the batch, returns the memory
+  // taken by them
+  size_t append_rows(const ::mysqlx::Row_batch &batch, shcore::Value::Array_type &rows) const;
+
+  // Reads the next size rows as a List of Row objects or, if by_column is
+  // set, as a Map like the one of fetchColumns(). Returns an undefined
+  // Value once all the rows were read.
+  shcore::Value read_batch(size_t size, bool by_column, size_t *row_count) const;
+
+  mutable std::shared_ptr<Row_columns> _row_columns;
+  mutable std::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > _row_columns_metadata;
+};
+
+// Reads the options of forEachBatch() and batches() from the argument at
+// index, if given: the records of each batch, 4096 by default, and whether
+// the batches are organized by column
+void SHCORE_PUBLIC parse_batch_options(const shcore::Argument_list &args, unsigned int index, size_t *size,
+                                       bool *by_column);
+
+/**
+* $(ROWBATCHES_BRIEF)
+*
+* $(ROWBATCHES_DETAIL)
+*/
+class SHCORE_PUBLIC RowBatches : public shcore::Cpp_object_bridge, public shcore::Cpp_iterator {
+public:
+#if DOXYGEN_JS
+  Object next();
+#elif DOXYGEN_PY
+  object next();
+#endif
+
+  RowBatches(std::shared_ptr<const RowResult> result, size_t size, bool by_column);
+  virtual ~RowBatches() {}
+
+  virtual std::string class_name() const { return "RowBatches"; }
+  virtual bool operator == (const Object_bridge &other) const;
+
+  shcore::Value next(const shcore::Argument_list &args);
+  virtual shcore::Value next_value();
+
+  // Rows read so far
+  size_t row_count() const { return _row_count; }
+
+private:
+  std::shared_ptr<const RowResult> _result;
+  size_t _size;
+  bool _by_column;
+  size_t _row_count;
 };
 
 /**
@@ -80,64 +80,71 @@ void Schema::init() {
   _collections = Value::new_map().as_map();
 
   // Setups the cache handlers
-  auto table_generator = [this](const std::string& name) {return shcore::Value::wrap<Table>(new Table(shared_from_this(), name, false)); };
-  auto view_generator = [this](const std::string& name) {return shcore::Value::wrap<Table>(new Table(shared_from_this(), name, true)); };
-  auto collection_generator = [this](const std::string& name) {return shcore::Value::wrap<Collection>(new Collection(shared_from_this(), name)); };
+  table_generator = [this](const std::string& name) {return shcore::Value::wrap<Table>(new Table(shared_from_this(), name, false)); };
+  view_generator = [this](const std::string& name) {return shcore::Value::wrap<Table>(new Table(shared_from_this(), name, true)); };
+  collection_generator = [this](const std::string& name) {return shcore::Value::wrap<Collection>(new Collection(shared_from_this(), name)); };
 
-  update_table_cache = [table_generator, this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, table_generator, exists, _tables, this); };
-  update_view_cache = [view_generator, this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, view_generator, exists, _views, this); };
-  update_collection_cache = [collection_generator, this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, collection_generator, exists, _collections, this); };
+  update_table_cache = [this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, table_generator, exists, _tables, this); };
+  update_view_cache = [this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, view_generator, exists, _views, this); };
+  update_collection_cache = [this](const std::string &name, bool exists) {DatabaseObject::update_cache(name, collection_generator, exists, _collections, this); };
 
-  update_full_table_cache = [table_generator, this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, table_generator, _tables, this); };
-  update_full_view_cache = [view_generator, this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, view_generator, _views, this); };
-  update_full_collection_cache = [collection_generator, this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, collection_generator, _collections, this); };
+  update_full_table_cache = [this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, table_generator, _tables, this); };
+  update_full_view_cache = [this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, view_generator, _views, this); };
+  update_full_collection_cache = [this](const std::vector<std::string> &names) {DatabaseObject::update_cache(names, collection_generator, _collections, this); };
+}
+
+void Schema::fetch_names(const std::string &pattern, std::vector<std::string> *tables, std::vector<std::string> *views,
+                         std::vector<std::string> *collections) {
+  std::shared_ptr<BaseSession> sess(std::static_pointer_cast<BaseSession>(_session.lock()));
+  if (!sess)
+    return;
+
+  std::vector<std::string> others;
+
+  shcore::Argument_list args;
+  args.push_back(Value(_name));
+  args.push_back(Value(pattern));
+
+  Value myres = sess->executeAdminCommand("list_objects", true, args);
+  std::shared_ptr<mysqlsh::mysqlx::SqlResult> my_res = myres.as_object<mysqlsh::mysqlx::SqlResult>();
+
+  Value raw_entry;
+
+  while ((raw_entry = my_res->fetch_one(shcore::Argument_list()))) {
+    std::shared_ptr<mysqlsh::Row> row = raw_entry.as_object<mysqlsh::Row>();
+    std::string object_name = row->get_member("name").as_string();
+    std::string object_type = row->get_member("type").as_string();
+
+    if (object_type == "TABLE")
+      tables->push_back(object_name);
+    else if (object_type == "VIEW")
+      views->push_back(object_name);
+    else if (object_type == "COLLECTION")
+      collections->push_back(object_name);
+    else
+      others.push_back((boost::format("Unexpected Object Retrieved from Database: %s% of type %s%") % object_name % object_type).str());;
+  }
+
+  // Log errors about unexpected object type
+  if (others.size()) {
+    for (size_t index = 0; index < others.size(); index++)
+      log_error("%s", others[index].c_str());
+  }
 }
 
 void Schema::update_cache() {
   try {
-    std::shared_ptr<BaseSession> sess(std::static_pointer_cast<BaseSession>(_session.lock()));
-    if (sess) {
+    if (_session.lock()) {
       std::vector<std::string> tables;
       std::vector<std::string> collections;
       std::vector<std::string> views;
-      std::vector<std::string> others;
-
-      {
-        shcore::Argument_list args;
-        args.push_back(Value(_name));
-        args.push_back(Value(""));
-
-        Value myres = sess->executeAdminCommand("list_objects", true, args);
-        std::shared_ptr<mysqlsh::mysqlx::SqlResult> my_res = myres.as_object<mysqlsh::mysqlx::SqlResult>();
-
-        Value raw_entry;
-
-        while ((raw_entry = my_res->fetch_one(shcore::Argument_list()))) {
-          std::shared_ptr<mysqlsh::Row> row = raw_entry.as_object<mysqlsh::Row>();
-          std::string object_name = row->get_member("name").as_string();
-          std::string object_type = row->get_member("type").as_string();
-
-          if (object_type == "TABLE")
-            tables.push_back(object_name);
-          else if (object_type == "VIEW")
-            views.push_back(object_name);
-          else if (object_type == "COLLECTION")
-            collections.push_back(object_name);
-          else
-            others.push_back((boost::format("Unexpected Object Retrieved from Database: %s% of type %s%") % object_name % object_type).str());;
-        }
 
-        // Updates the cache
-        update_full_table_cache(tables);
-        update_full_view_cache(views);
-        update_full_collection_cache(collections);
+      fetch_names("", &tables, &views, &collections);
 
-        // Log errors about unexpected object type
-        if (others.size()) {
-          for (size_t index = 0; index < others.size(); index++)
-            log_error("%s", others[index].c_str());
-        }
-      }
+      // Updates the cache
+      update_full_table_cache(tables);
+      update_full_view_cache(views);
+      update_full_collection_cache(collections);
     }
   }
   CATCH_AND_TRANSLATE();
@@ -162,15 +169,15 @@ Value Schema::get_member(const std::string &prop) const {
   // Only checks the cache if the requested member is not a base one
   if (!is_base_member(prop)) {
     // Searches prop as  a table
-    ret_val = find_in_cache(prop, _tables);
+    ret_val = find_in_cache(prop, table_generator, _tables);
 
     // Searches prop as a collection
     if (!ret_val)
-      ret_val = find_in_cache(prop, _collections);
+      ret_val = find_in_cache(prop, collection_generator, _collections);
 
     // Searches prop as a view
     if (!ret_val)
-      ret_val = find_in_cache(prop, _views);
+      ret_val = find_in_cache(prop, view_generator, _views);
   }
 
   if (!ret_val)
@@ -181,16 +188,21 @@ Value Schema::get_member(const std::string &prop) const {
 
 // Documentation of getTables function
 REGISTER_HELP(SCHEMA_GETTABLES_BRIEF, "Returns a list of Tables for this Schema.");
+REGISTER_HELP(SCHEMA_GETTABLES_PARAM, "@param pattern Optional LIKE pattern the names of the Tables must match.");
 REGISTER_HELP(SCHEMA_GETTABLES_RETURN, "@return A List containing the Table objects available for the Schema.");
 REGISTER_HELP(SCHEMA_GETTABLES_DETAIL, "Pulls from the database the available Tables, Views and Collections.");
 REGISTER_HELP(SCHEMA_GETTABLES_DETAIL1, "Does a full refresh of the Tables, Views and Collections cache.");
 REGISTER_HELP(SCHEMA_GETTABLES_DETAIL2, "Returns a List of available Table objects.");
+REGISTER_HELP(SCHEMA_GETTABLES_DETAIL3, "When a pattern is given only the matching objects are pulled "\
+"from the database and added to the cache.");
 
 /**
 * $(SCHEMA_GETTABLES_BRIEF)
 *
 * \sa Table
 *
+* $(SCHEMA_GETTABLES_PARAM)
+*
 * $(SCHEMA_GETTABLES_RETURN)
 *
 * $(SCHEMA_GETTABLES_DETAIL)
@@ -198,37 +210,70 @@ REGISTER_HELP(SCHEMA_GETTABLES_DETAIL2, "Returns a List of available Table objec
 * $(SCHEMA_GETTABLES_DETAIL1)
 *
 * $(SCHEMA_GETTABLES_DETAIL2)
+*
+* $(SCHEMA_GETTABLES_DETAIL3)
 */
 #if DOXYGEN_JS
-List Schema::getTables() {}
+List Schema::getTables(String pattern) {}
 #elif DOXYGEN_PY
-list Schema::get_tables() {}
+list Schema::get_tables(str pattern) {}
 #endif
 shcore::Value Schema::get_tables(const shcore::Argument_list &args) {
-  args.ensure_count(0, get_function_name("getTables").c_str());
-
-  update_cache();
+  args.ensure_count(0, 1, get_function_name("getTables").c_str());
 
   shcore::Value::Array_type_ref list(new shcore::Value::Array_type);
 
-  get_object_list(_tables, list);
-  get_object_list(_views, list);
+  try {
+    std::string pattern = args.size() ? args.string_at(0) : "";
+
+    if (pattern.empty()) {
+      update_cache();
+
+      get_object_list(_tables, table_generator, list);
+      get_object_list(_views, view_generator, list);
+    } else {
+      // The server does the filtering, the rest of the cache is left as is
+      std::vector<std::string> tables;
+      std::vector<std::string> views;
+      std::vector<std::string> collections;
+      fetch_names(pattern, &tables, &views, &collections);
+
+      for (auto &name : tables) {
+        update_table_cache(name, true);
+        list->push_back((*_tables)[name]);
+      }
+
+      for (auto &name : views) {
+        update_view_cache(name, true);
+        list->push_back((*_views)[name]);
+      }
+
+      for (auto &name : collections)
+        update_collection_cache(name, true);
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("getTables"));
 
   return shcore::Value(list);
 }
 
 // Documentation of getCollections function
 REGISTER_HELP(SCHEMA_GETCOLLECTIONS_BRIEF, "Returns a list of Collections for this Schema.");
+REGISTER_HELP(SCHEMA_GETCOLLECTIONS_PARAM, "@param pattern Optional LIKE pattern the names of the Collections must match.");
 REGISTER_HELP(SCHEMA_GETCOLLECTIONS_RETURN, "@return A List containing the Collection objects available for the Schema.");
 REGISTER_HELP(SCHEMA_GETCOLLECTIONS_DETAIL, "Pulls from the database the available Tables, Views and Collections.");
 REGISTER_HELP(SCHEMA_GETCOLLECTIONS_DETAIL1, "Does a full refresh of the Tables, Views and Collections cache.");
 REGISTER_HELP(SCHEMA_GETCOLLECTIONS_DETAIL2, "Returns a List of available Collection objects.");
+REGISTER_HELP(SCHEMA_GETCOLLECTIONS_DETAIL3, "When a pattern is given only the matching objects are pulled "\
+"from the database and added to the cache.");
 
 /**
 * $(SCHEMA_GETCOLLECTIONS_BRIEF)
 *
 * \sa Collection
 *
+* $(SCHEMA_GETCOLLECTIONS_PARAM)
+*
 * $(SCHEMA_GETCOLLECTIONS_RETURN)
 *
 * $(SCHEMA_GETCOLLECTIONS_DETAIL)
@@ -236,20 +281,46 @@ REGISTER_HELP(SCHEMA_GETCOLLECTIONS_DETAIL2, "Returns a List of available Collec
 * $(SCHEMA_GETCOLLECTIONS_DETAIL1)
 *
 * $(SCHEMA_GETCOLLECTIONS_DETAIL2)
+*
+* $(SCHEMA_GETCOLLECTIONS_DETAIL3)
 */
 #if DOXYGEN_JS
-List Schema::getCollections() {}
+List Schema::getCollections(String pattern) {}
 #elif DOXYGEN_PY
-list Schema::get_collections() {}
+list Schema::get_collections(str pattern) {}
 #endif
 shcore::Value Schema::get_collections(const shcore::Argument_list &args) {
-  args.ensure_count(0, get_function_name("getCollections").c_str());
-
-  update_cache();
+  args.ensure_count(0, 1, get_function_name("getCollections").c_str());
 
   shcore::Value::Array_type_ref list(new shcore::Value::Array_type);
 
-  get_object_list(_collections, list);
+  try {
+    std::string pattern = args.size() ? args.string_at(0) : "";
+
+    if (pattern.empty()) {
+      update_cache();
+
+      get_object_list(_collections, collection_generator, list);
+    } else {
+      // The server does the filtering, the rest of the cache is left as is
+      std::vector<std::string> tables;
+      std::vector<std::string> views;
+      std::vector<std::string> collections;
+      fetch_names(pattern, &tables, &views, &collections);
+
+      for (auto &name : tables)
+        update_table_cache(name, true);
+
+      for (auto &name : views)
+        update_view_cache(name, true);
+
+      for (auto &name : collections) {
+        update_collection_cache(name, true);
+        list->push_back((*_collections)[name]);
+      }
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("getCollections"));
 
   return shcore::Value(list);
 }
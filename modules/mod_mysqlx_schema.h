@@ -67,16 +67,16 @@ public:
   friend class Table;
   friend class Collection;
 #if DOXYGEN_JS
-  List getTables();
-  List getCollections();
+  List getTables(String pattern);
+  List getCollections(String pattern);
 
   Table getTable(String name);
   Collection getCollection(String name);
   Table getCollectionAsTable(String name);
   Collection createCollection(String name);
 #elif DOXYGEN_PY
-  list get_tables();
-  list get_collections();
+  list get_tables(str pattern);
+  list get_collections(str pattern);
 
   Table get_table(str name);
   Collection get_collection(str name);
@@ -101,8 +101,13 @@ private:
   std::shared_ptr<shcore::Value::Map_type> _collections;
   std::shared_ptr<shcore::Value::Map_type> _views;
 
+  Generator table_generator, view_generator, collection_generator;
   std::function<void(const std::string&, bool exists)> update_table_cache, update_view_cache, update_collection_cache;
   std::function<void(const std::vector<std::string>&)> update_full_table_cache, update_full_view_cache, update_full_collection_cache;
+
+  // Names of the objects matching the LIKE pattern, all if empty
+  void fetch_names(const std::string &pattern, std::vector<std::string> *tables, std::vector<std::string> *views,
+                   std::vector<std::string> *collections);
 };
 }
 }
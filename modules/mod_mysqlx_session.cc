@@ -27,6 +27,8 @@
 #include "shellcore/shell_core.h"
 #include "shellcore/lang_base.h"
 #include "mod_mysqlx_session_sql.h"
+#include "mod_mysqlx_collection_find.h"
+#include "mod_mysqlx_table_select.h"
 #include "utils/utils_general.h"
 #include "utils/utils_time.h"
 #include "utils/utils_file.h"
@@ -94,7 +96,7 @@ REGISTER_HELP(NODESESSION_BRIEF, "Enables interaction with an X Protocol enabled
 REGISTER_HELP(NODESESSION_DETAIL, "Note that this class inherits the behavior described on the BaseSession class.");
 
 BaseSession::BaseSession()
-  : _case_sensitive_table_names(false) {
+  : _ssl_mode(0), _case_sensitive_table_names(false) {
   init();
 }
 
@@ -112,11 +114,26 @@ bool BaseSession::is_connected() const {
   return _session.is_connected();
 }
 
+// The X Plugin ping admin command, it does not touch any table
+bool BaseSession::ping() {
+  if (!_session.is_connected())
+    return false;
+
+  try {
+    _session.execute_statement("xplugin", "ping", shcore::Argument_list());
+  } catch (std::exception &e) {
+    log_debug("Ping to %s failed: %s", _uri.c_str(), e.what());
+    return false;
+  }
+
+  return true;
+}
+
 std::shared_ptr< ::mysqlx::Session> BaseSession::session_obj() const {
   return _session.get();
 }
 
-BaseSession::BaseSession(const BaseSession& s) : ShellDevelopmentSession(s), _case_sensitive_table_names(false) {
+BaseSession::BaseSession(const BaseSession& s) : ShellDevelopmentSession(s), _ssl_mode(s._ssl_mode), _case_sensitive_table_names(false) {
   init();
 }
 
@@ -124,6 +141,7 @@ void BaseSession::init() {
   _schemas.reset(new shcore::Value::Map_type);
 
   add_method("close", std::bind(&BaseSession::close, this, _1), "data");
+  add_method("reset", std::bind(&BaseSession::reset, this, _1), "data");
   add_method("setFetchWarnings", std::bind(&BaseSession::set_fetch_warnings, this, _1), "data");
   add_method("startTransaction", std::bind(&BaseSession::startTransaction, this, _1), "data");
   add_method("commit", std::bind(&BaseSession::commit, this, _1), "data");
@@ -133,6 +151,9 @@ void BaseSession::init() {
   add_method("dropTable", std::bind(&BaseSession::drop_schema_object, this, _1, "Table"), "data");
   add_method("dropCollection", std::bind(&BaseSession::drop_schema_object, this, _1, "Collection"), "data");
   add_method("dropView", std::bind(&BaseSession::drop_schema_object, this, _1, "View"), "data");
+  add_method("getStats", std::bind(&BaseSession::get_stats, this, _1), NULL);
+  add_varargs_method("runBatch", std::bind(&BaseSession::run_batch, this, _1));
+  add_method("setResultCache", std::bind(&BaseSession::set_result_cache, this, _1), "options", shcore::Map, NULL);
 
   // Prepares the cache handling
   auto generator = [this](const std::string& name) {return shcore::Value::wrap<Schema>(new Schema(_get_shared_this(), name)); };
@@ -156,10 +177,87 @@ Value BaseSession::connect(const Argument_list &args) {
       else
         ssl_mode = static_cast<int>(shcore::SslMode::Preferred);
     }
+    _ssl_mode = ssl_mode;
+
+    // Sizing of the connection buffers, compression, the cancelling of
+    // abandoned results and the reading of rows ahead, given on the
+    // connection data map
+    ::mysqlx::Buffer_config buffer_config;
+    ::mysqlx::Compression_config compression;
+    ::mysqlx::Discard_policy discard_policy;
+    std::size_t prefetch_rows = 0;
+    if (args[0].type == Map) {
+      shcore::Value::Map_type_ref options = args.map_at(0);
+
+      if (options->has_key(kCompression))
+        compression.algorithm = (*options)[kCompression].as_string();
+
+      if (options->has_key(kCompressionLevel)) {
+        int64_t level = (*options)[kCompressionLevel].as_int();
+        if (level < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kCompressionLevel + ", it must be 0 or a positive integer");
+        compression.level = static_cast<int>(level);
+      }
+
+      if (options->has_key(kBufferPageSize)) {
+        int64_t page_size = (*options)[kBufferPageSize].as_int();
+        if (page_size <= 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kBufferPageSize + ", it must be a positive integer");
+        buffer_config.page_size = static_cast<std::size_t>(page_size);
+      }
+
+      if (options->has_key(kBufferMemoryLimit)) {
+        int64_t memory_limit = (*options)[kBufferMemoryLimit].as_int();
+        if (memory_limit < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kBufferMemoryLimit + ", it must be 0 or a positive integer");
+        buffer_config.memory_limit = static_cast<std::size_t>(memory_limit);
+      }
+
+      if (options->has_key(kCancelAbandonedRows)) {
+        int64_t rows = (*options)[kCancelAbandonedRows].as_int();
+        if (rows < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kCancelAbandonedRows + ", it must be 0 or a positive integer");
+        discard_policy.max_rows = static_cast<uint64_t>(rows);
+      }
+
+      if (options->has_key(kCancelAbandonedBytes)) {
+        int64_t bytes = (*options)[kCancelAbandonedBytes].as_int();
+        if (bytes < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kCancelAbandonedBytes + ", it must be 0 or a positive integer");
+        discard_policy.max_bytes = static_cast<uint64_t>(bytes);
+      }
+
+      if (options->has_key(kPrefetchRows)) {
+        int64_t rows = (*options)[kPrefetchRows].as_int();
+        if (rows < 0)
+          throw shcore::Exception::argument_error("Invalid value for " + kPrefetchRows + ", it must be 0 or a positive integer");
+        prefetch_rows = static_cast<std::size_t>(rows);
+      }
+    }
 
     _session.open(_host, _port, _schema, _user, _password, _ssl_info.ca,
       _ssl_info.cert, _ssl_info.key, _ssl_info.capath, _ssl_info.crl, _ssl_info.crlpath,
-      _ssl_info.tls_version, _ssl_info.ciphers, ssl_mode, 60000, _auth_method, true);
+      _ssl_info.tls_version, _ssl_info.ciphers, ssl_mode, 60000, _auth_method, true, compression);
+    _session.set_buffer_config(buffer_config);
+    _session.set_result_prefetch(prefetch_rows);
+
+    // The statement is killed from a session of its own, opened only when
+    // needed
+    if (discard_policy.max_rows || discard_policy.max_bytes) {
+      std::string host = _host, user = _user, password = _password, auth_method = _auth_method;
+      int port = _port;
+      shcore::SslInfo ssl_info = _ssl_info;
+      uint64_t connection_id = _session.get_connection_id();
+      discard_policy.cancel = [=]() {
+        SessionHandle killer;
+        killer.open(host, port, "", user, password, ssl_info.ca, ssl_info.cert, ssl_info.key, ssl_info.capath,
+                    ssl_info.crl, ssl_info.crlpath, ssl_info.tls_version, ssl_info.ciphers, ssl_mode, 10000,
+                    auth_method);
+        killer.execute_sql("KILL QUERY " + std::to_string(connection_id));
+        killer.reset();
+      };
+      _session.set_discard_policy(discard_policy);
+    }
 
     _default_schema = _schema;
     if (!_default_schema.empty())
@@ -178,7 +276,54 @@ void BaseSession::set_option(const char *option, int value) {
 }
 
 uint64_t BaseSession::get_connection_id() const {
-  return _connection_id;
+  return _session.get_connection_id();
+}
+
+void BaseSession::kill_query() {
+  if (!_session.is_connected())
+    return;
+
+  std::string sql = "KILL QUERY " + std::to_string(_session.get_connection_id());
+
+  // The session kept since the last time may have been closed by the
+  // server meanwhile, it is opened again once
+  for (int attempt = 0;; attempt++) {
+    try {
+      if (!_kill_session.is_connected())
+        _kill_session.open(_host, _port, "", _user, _password, _ssl_info.ca, _ssl_info.cert, _ssl_info.key,
+                           _ssl_info.capath, _ssl_info.crl, _ssl_info.crlpath, _ssl_info.tls_version,
+                           _ssl_info.ciphers, _ssl_mode, 10000, _auth_method);
+
+      _kill_session.execute_sql(sql);
+      return;
+    } catch (...) {
+      try {
+        _kill_session.reset();
+      } catch (...) {
+      }
+      if (attempt > 0)
+        throw;
+    }
+  }
+}
+
+shcore::Slow_statement_log::Explain BaseSession::slow_statement_explain() const {
+  std::string host = _host, schema = _default_schema, user = _user, password = _password, auth_method = _auth_method;
+  int port = _port, ssl_mode = _ssl_mode;
+  shcore::SslInfo ssl_info = _ssl_info;
+
+  return [=](const std::string &statement) {
+    SessionHandle session;
+    session.open(host, port, schema, user, password, ssl_info.ca, ssl_info.cert, ssl_info.key, ssl_info.capath,
+                 ssl_info.crl, ssl_info.crlpath, ssl_info.tls_version, ssl_info.ciphers, ssl_mode, 10000,
+                 auth_method);
+    std::shared_ptr< ::mysqlx::Result> result(session.execute_sql("EXPLAIN FORMAT=JSON " + statement));
+    std::shared_ptr< ::mysqlx::Row> row = result->next();
+    std::string plan = row ? row->stringField(0) : "";
+    result->flush();
+    session.reset();
+    return plan;
+  };
 }
 
 bool BaseSession::table_name_compare(const std::string &n1, const std::string &n2) {
@@ -216,11 +361,49 @@ Value BaseSession::close(const shcore::Argument_list &args) {
   return shcore::Value();
 }
 
+// Documentation of reset function
+REGISTER_HELP(BASESESSION_RESET_BRIEF, "Clears the state of the session on the server, keeping the connection open.");
+REGISTER_HELP(BASESESSION_RESET_DETAIL, "The open transaction is rolled back, the session and user variables and the "\
+"temporary tables are dropped and the current schema is the default one again, as on a new session.");
+REGISTER_HELP(BASESESSION_RESET_DETAIL1, "The session is authenticated again with the same credentials, but the connection, "\
+"its TLS and the negotiated capabilities are kept.");
+
+/**
+* $(BASESESSION_RESET_BRIEF)
+*
+* $(BASESESSION_RESET_DETAIL)
+*
+* $(BASESESSION_RESET_DETAIL1)
+*/
+#if DOXYGEN_JS
+Undefined BaseSession::reset() {}
+#elif DOXYGEN_PY
+None BaseSession::reset() {}
+#endif
+Value BaseSession::reset(const shcore::Argument_list &args) {
+  args.ensure_count(0, get_function_name("reset").c_str());
+
+  try {
+    reset_state();
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("reset"));
+
+  return shcore::Value();
+}
+
+void BaseSession::reset_state() {
+  _session.reset_state(_user, _password, _schema, _auth_method);
+  _default_schema = _schema;
+
+  ShellDevelopmentSession::reset_state();
+}
+
 void BaseSession::reset_session() {
   try {
     log_warning("Closing session: %s", _uri.c_str());
 
     _session.reset();
+    _kill_session.reset();
   } catch (std::exception &e) {
     log_warning("Error occurred closing session: %s", e.what());
   }
@@ -405,6 +588,121 @@ std::shared_ptr< ::mysqlx::Result> BaseSession::execute_sql(const std::string &s
   return result;
 }
 
+void BaseSession::send_sql(const std::string &sql) const {
+  try {
+    _session.send_sql(sql);
+    _pending_statements.push_back(sql);
+  } catch (const ::mysqlx::Error &e) {
+    if (e.error() == 2006 || e.error() == 5166 || e.error() == 2013) {
+      std::shared_ptr<BaseSession> myself = std::dynamic_pointer_cast<BaseSession>(_get_shared_this());
+      ShellNotifications::get()->notify("SN_SESSION_CONNECTION_LOST", std::dynamic_pointer_cast<Cpp_object_bridge>(myself));
+    }
+
+    translate_exception();
+  }
+}
+
+shcore::Value BaseSession::recv_sql_result() const {
+  MySQL_timer timer;
+  Value ret_val;
+
+  try {
+    timer.start();
+
+    // The statements were sent before, so the server time of the first
+    // result also includes the time it waited behind the previous ones
+    uint64_t server_time = 0;
+    std::shared_ptr< ::mysqlx::Result> exec_result;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      exec_result = _session.recv_sql_result();
+    }
+
+    timer.end();
+
+    SqlResult *result = new SqlResult(exec_result);
+    result->set_execution_time(timer.raw_duration());
+    ret_val = shcore::Value::wrap(result);
+
+    if (!_pending_statements.empty()) {
+      result->set_statement(_pending_statements.front(), server_time);
+      if (shcore::Slow_statement_log::enabled())
+        result->watch_slow(_pending_statements.front(), server_time, slow_statement_explain());
+      _pending_statements.pop_front();
+    }
+  } catch (const ::mysqlx::Error &e) {
+    if (!_pending_statements.empty())
+      _pending_statements.pop_front();
+
+    if (e.error() == 2006 || e.error() == 5166 || e.error() == 2013) {
+      std::shared_ptr<BaseSession> myself = std::dynamic_pointer_cast<BaseSession>(_get_shared_this());
+      ShellNotifications::get()->notify("SN_SESSION_CONNECTION_LOST", std::dynamic_pointer_cast<Cpp_object_bridge>(myself));
+    }
+
+    translate_exception();
+  }
+
+  return ret_val;
+}
+
+Value BaseSession::execute_sql_async(const std::string &statement, const Argument_list &args) const {
+  uint64_t ticket = 0;
+
+  try {
+    ticket = _session.send_statement_async("sql", statement, args);
+  } catch (const ::mysqlx::Error &e) {
+    if (e.error() == 2006 || e.error() == 5166 || e.error() == 2013) {
+      std::shared_ptr<BaseSession> myself = std::dynamic_pointer_cast<BaseSession>(_get_shared_this());
+      ShellNotifications::get()->notify("SN_SESSION_CONNECTION_LOST", std::dynamic_pointer_cast<Cpp_object_bridge>(myself));
+    }
+
+    translate_exception();
+  }
+
+  return shcore::Value::wrap(new SqlResultFuture(_get_shared_this(), ticket, statement));
+}
+
+shcore::Value BaseSession::recv_async_result(uint64_t ticket, const std::string &statement) const {
+  MySQL_timer timer;
+  Value ret_val;
+
+  try {
+    timer.start();
+
+    // The time includes the wait for the results of the statements sent
+    // before this one
+    uint64_t server_time = 0;
+    std::shared_ptr< ::mysqlx::Result> exec_result;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      exec_result = _session.recv_async_result(ticket);
+    }
+
+    timer.end();
+
+    SqlResult *result = new SqlResult(exec_result);
+    result->set_execution_time(timer.raw_duration());
+    result->set_statement(statement, server_time);
+    if (shcore::Slow_statement_log::enabled())
+      result->watch_slow(statement, server_time, slow_statement_explain());
+    ret_val = shcore::Value::wrap(result);
+  } catch (const ::mysqlx::Error &e) {
+    if (e.error() == 2006 || e.error() == 5166 || e.error() == 2013) {
+      std::shared_ptr<BaseSession> myself = std::dynamic_pointer_cast<BaseSession>(_get_shared_this());
+      ShellNotifications::get()->notify("SN_SESSION_CONNECTION_LOST", std::dynamic_pointer_cast<Cpp_object_bridge>(myself));
+    }
+
+    translate_exception();
+  }
+  CATCH_AND_TRANSLATE();
+
+  return ret_val;
+}
+
+void BaseSession::discard_async_result(uint64_t ticket) const {
+  _session.discard_async_result(ticket);
+}
+
 Value BaseSession::executeAdminCommand(const std::string& command, bool expect_data, const Argument_list &args) const {
   std::string function = class_name() + '.' + "executeAdminCommand";
   args.ensure_at_least(1, function.c_str());
@@ -419,18 +717,28 @@ Value BaseSession::executeStmt(const std::string &domain, const std::string& com
   try {
     timer.start();
 
-    std::shared_ptr< ::mysqlx::Result> exec_result = _session.execute_statement(domain, command, args);
+    uint64_t server_time = 0;
+    std::shared_ptr< ::mysqlx::Result> exec_result;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      exec_result = _session.execute_statement(domain, command, args);
+    }
 
     timer.end();
 
-    if (expect_data) {
-      SqlResult *result = new SqlResult(exec_result);
-      result->set_execution_time(timer.raw_duration());
-      ret_val = shcore::Value::wrap(result);
-    } else {
-      Result *result = new Result(exec_result);
-      result->set_execution_time(timer.raw_duration());
-      ret_val = shcore::Value::wrap(result);
+    BaseResult *result;
+    if (expect_data)
+      result = new SqlResult(exec_result);
+    else
+      result = new Result(exec_result);
+
+    result->set_execution_time(timer.raw_duration());
+    ret_val = shcore::Value::wrap(result);
+
+    if (domain == "sql") {
+      result->set_statement(command, server_time);
+      if (shcore::Slow_statement_log::enabled())
+        result->watch_slow(command, server_time, slow_statement_explain());
     }
   } catch (const ::mysqlx::Error &e) {
     if (e.error() == 2006 || e.error() == 5166 || e.error() == 2013) {
@@ -746,6 +1054,331 @@ std::string BaseSession::db_object_exists(std::string &type, const std::string &
   return _session.db_object_exists(type, name, owner);
 }
 
+uint64_t BaseSession::estimate_row_count(const std::string &schema, const std::string &table) const {
+  // Read from the table statistics, InnoDB only samples some pages for it
+  std::shared_ptr< ::mysqlx::Result> result = execute_sql(sqlstring("SELECT TABLE_ROWS FROM information_schema.TABLES "
+                                                                    "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?", 0) << schema << table);
+  std::shared_ptr< ::mysqlx::Row> row = result->next();
+  if (!row)
+    throw Exception::runtime_error("Unknown table '" + schema + "." + table + "'");
+
+  // Views have no statistics
+  uint64_t ret_val = row->isNullField(0) ? 0 : row->uInt64Field(0);
+  result->flush();
+
+  return ret_val;
+}
+
+// Documentation of getStats function
+REGISTER_HELP(BASESESSION_GETSTATS_BRIEF, "Returns the memory used by the buffers and the traffic of the session connection.");
+REGISTER_HELP(BASESESSION_GETSTATS_RETURN, "@return A dictionary with the memory and traffic statistics of the session.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL, "The dictionary contains the following entries:");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL1, "@li bufferPageSize: the size of the pages the receive buffer grows in.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL2, "@li bufferMemoryLimit: the bytes the buffers may use, 0 if unlimited.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL3, "@li bufferMemoryInUse: the bytes the buffers use now.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL4, "@li bufferMemoryHighWater: the most bytes the buffers used.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL5, "@li bufferAllocationFailures: the times a buffer could not grow.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL6, "The page size and the limit are set with the bufferPageSize and "\
+"bufferMemoryLimit entries of the connection data. A statement needing more memory than the limit fails, "\
+"and the session is closed if the limit is hit receiving data.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL7, "The traffic since the session was opened is on these entries:");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL8, "@li framesSent, bytesSent: the messages sent to the server and their size.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL9, "@li framesReceived, bytesReceived: the messages received from the server and their size.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL10, "@li sentByType, receivedByType: the frames and bytes of each message type.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL11, "@li notices: the notices received.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL12, "@li receiveWaitTime: the microseconds spent waiting for data from the server.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL13, "@li decodeTime: the microseconds spent decoding the messages received.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL14, "@li rowsBuffered: the rows kept on the buffer of a result to be read later.");
+REGISTER_HELP(BASESESSION_GETSTATS_DETAIL15, "@li resultCacheHits, resultCacheMisses, resultCacheInvalidations, resultCacheEntries, "\
+"resultCacheMemory: the activity and size of the result cache, see setResultCache().");
+
+/**
+* $(BASESESSION_GETSTATS_BRIEF)
+*
+* $(BASESESSION_GETSTATS_RETURN)
+*
+* $(BASESESSION_GETSTATS_DETAIL)
+* $(BASESESSION_GETSTATS_DETAIL1)
+* $(BASESESSION_GETSTATS_DETAIL2)
+* $(BASESESSION_GETSTATS_DETAIL3)
+* $(BASESESSION_GETSTATS_DETAIL4)
+* $(BASESESSION_GETSTATS_DETAIL5)
+*
+* $(BASESESSION_GETSTATS_DETAIL6)
+*
+* $(BASESESSION_GETSTATS_DETAIL7)
+* $(BASESESSION_GETSTATS_DETAIL8)
+* $(BASESESSION_GETSTATS_DETAIL9)
+* $(BASESESSION_GETSTATS_DETAIL10)
+* $(BASESESSION_GETSTATS_DETAIL11)
+* $(BASESESSION_GETSTATS_DETAIL12)
+* $(BASESESSION_GETSTATS_DETAIL13)
+* $(BASESESSION_GETSTATS_DETAIL14)
+* $(BASESESSION_GETSTATS_DETAIL15)
+*/
+#if DOXYGEN_JS
+Map BaseSession::getStats() {}
+#elif DOXYGEN_PY
+dict BaseSession::get_stats() {}
+#endif
+shcore::Value BaseSession::get_stats(const shcore::Argument_list &args) const {
+  args.ensure_count(0, get_function_name("getStats").c_str());
+
+  ::mysqlx::Buffer_config config = _session.get_buffer_config();
+  ::mysqlx::Buffer_stats stats = _session.get_buffer_stats();
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type);
+  (*ret_val)["bufferPageSize"] = shcore::Value(static_cast<uint64_t>(config.page_size));
+  (*ret_val)["bufferMemoryLimit"] = shcore::Value(static_cast<uint64_t>(config.memory_limit));
+  (*ret_val)["bufferMemoryInUse"] = shcore::Value(static_cast<uint64_t>(stats.in_use));
+  (*ret_val)["bufferMemoryHighWater"] = shcore::Value(static_cast<uint64_t>(stats.high_water));
+  (*ret_val)["bufferAllocationFailures"] = shcore::Value(stats.allocation_failures);
+
+  for (auto &entry : *get_protocol_stats())
+    (*ret_val)[entry.first] = entry.second;
+
+  ::mysqlx::Result_cache_stats cache = _session.get_result_cache_stats();
+  (*ret_val)["resultCacheHits"] = shcore::Value(cache.hits);
+  (*ret_val)["resultCacheMisses"] = shcore::Value(cache.misses);
+  (*ret_val)["resultCacheInvalidations"] = shcore::Value(cache.invalidations);
+  (*ret_val)["resultCacheEntries"] = shcore::Value(static_cast<uint64_t>(cache.entries));
+  (*ret_val)["resultCacheMemory"] = shcore::Value(static_cast<uint64_t>(cache.memory));
+
+  return shcore::Value(ret_val);
+}
+
+// Documentation of runBatch function
+REGISTER_HELP(BASESESSION_RUNBATCH_BRIEF, "Executes several statements sending them to the server at once.");
+REGISTER_HELP(BASESESSION_RUNBATCH_PARAM, "@param statements A list of SQL strings and CRUD operations ready to be executed.");
+REGISTER_HELP(BASESESSION_RUNBATCH_PARAM1, "@param options Optional dictionary with options for the batch.");
+REGISTER_HELP(BASESESSION_RUNBATCH_RETURN, "@return A list with the result of every statement.");
+REGISTER_HELP(BASESESSION_RUNBATCH_DETAIL, "The statements are sent in a single write and their results are read afterwards, "\
+"so the batch takes a single round trip to the server. The results are fully read, in the order of the statements.");
+REGISTER_HELP(BASESESSION_RUNBATCH_DETAIL1, "The options dictionary may contain the following option:");
+REGISTER_HELP(BASESESSION_RUNBATCH_DETAIL2, "@li atomic: if true the statements run in a transaction inside an expectation block, "\
+"so the server skips the statements after the first one failing and the transaction is rolled back. "\
+"The transaction is started by the batch, so it must not be run within another one. By default false.");
+REGISTER_HELP(BASESESSION_RUNBATCH_DETAIL3, "When a statement fails the error is raised once the replies of the whole batch were read. "\
+"Unless the batch is atomic, the statements after it were still executed.");
+
+/**
+* $(BASESESSION_RUNBATCH_BRIEF)
+*
+* $(BASESESSION_RUNBATCH_PARAM)
+* $(BASESESSION_RUNBATCH_PARAM1)
+*
+* $(BASESESSION_RUNBATCH_RETURN)
+*
+* $(BASESESSION_RUNBATCH_DETAIL)
+*
+* $(BASESESSION_RUNBATCH_DETAIL1)
+* $(BASESESSION_RUNBATCH_DETAIL2)
+*
+* $(BASESESSION_RUNBATCH_DETAIL3)
+*/
+#if DOXYGEN_JS
+List BaseSession::runBatch(List statements, Dictionary options) {}
+#elif DOXYGEN_PY
+list BaseSession::run_batch(list statements, dict options) {}
+#endif
+shcore::Value BaseSession::run_batch(const shcore::Argument_list &args) {
+  shcore::Value::Array_type_ref ret_val(new shcore::Value::Array_type());
+
+  args.ensure_count(1, 2, get_function_name("runBatch").c_str());
+
+  try {
+    bool atomic = false;
+    if (args.size() == 2) {
+      shcore::Argument_map options(*args.map_at(1));
+      options.ensure_keys({}, {"atomic"}, "batch options");
+
+      if (options.has_key("atomic"))
+        atomic = options.bool_at("atomic");
+    }
+
+    // The kind of result of every statement
+    enum Result_type { Sql, Doc, Row, Plain };
+    std::vector<Result_type> types;
+    std::vector<std::pair<int, std::string> > messages;
+
+    for (auto &statement : *args.array_at(0)) {
+      std::pair<int, std::string> message;
+
+      if (statement.type == shcore::String) {
+        Mysqlx::Sql::StmtExecute execute;
+        execute.set_namespace_("sql");
+        execute.set_stmt(statement.as_string());
+        execute.SerializeToString(&message.second);
+        message.first = Mysqlx::ClientMessages::SQL_STMT_EXECUTE;
+        types.push_back(Sql);
+      } else {
+        std::shared_ptr<Crud_definition> crud;
+        if (statement.type == shcore::Object)
+          crud = std::dynamic_pointer_cast<Crud_definition>(statement.as_object());
+
+        if (!crud || !crud->statement())
+          throw shcore::Exception::argument_error("The batch can only contain SQL strings and CRUD operations");
+
+        message.first = crud->statement()->message(message.second);
+        if (std::dynamic_pointer_cast<CollectionFind>(crud))
+          types.push_back(Doc);
+        else if (std::dynamic_pointer_cast<TableSelect>(crud))
+          types.push_back(Row);
+        else
+          types.push_back(Plain);
+      }
+
+      messages.push_back(message);
+    }
+
+    if (messages.empty())
+      throw shcore::Exception::argument_error("The batch has no statements");
+
+    MySQL_timer timer;
+    timer.start();
+    std::vector<std::shared_ptr< ::mysqlx::Result> > results;
+    try {
+      results = _session.execute_batch(messages, atomic);
+    } catch (const ::mysqlx::Error &e) {
+      if (e.error() == 2006 || e.error() == 5166 || e.error() == 2013) {
+        std::shared_ptr<BaseSession> myself = std::dynamic_pointer_cast<BaseSession>(_get_shared_this());
+        ShellNotifications::get()->notify("SN_SESSION_CONNECTION_LOST", std::dynamic_pointer_cast<Cpp_object_bridge>(myself));
+      }
+
+      throw;
+    }
+    timer.end();
+
+    // The time is the one of the whole batch, the statements run together
+    for (size_t index = 0; index < results.size(); index++) {
+      BaseResult *result;
+      switch (types[index]) {
+        case Sql:
+          result = new SqlResult(results[index]);
+          break;
+        case Doc:
+          result = new DocResult(results[index]);
+          break;
+        case Row:
+          result = new RowResult(results[index]);
+          break;
+        default:
+          result = new Result(results[index]);
+      }
+      result->set_execution_time(timer.raw_duration());
+      ret_val->push_back(shcore::Value::wrap(result));
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("runBatch"));
+
+  return shcore::Value(ret_val);
+}
+
+// Documentation of setResultCache function
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_BRIEF, "Keeps the results of the read only statements to answer them again without the server.");
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_PARAM, "@param options Dictionary with the options of the cache.");
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_DETAIL, "The options dictionary may contain the following options:");
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_DETAIL1, "@li ttl: the seconds a result is kept, 0 disables the cache, which is the default.");
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_DETAIL2, "@li memoryLimit: the bytes the results kept may take, by default 16 MB.");
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_DETAIL3, "The results of collection.find(), table.select() and the SQL statements starting with "\
+"SELECT, SHOW, DESCRIBE or EXPLAIN are kept, by the exact statement and its bound values. "\
+"They are read completely when executed, and the same statement executed again gets a copy of them.");
+REGISTER_HELP(BASESESSION_SETRESULTCACHE_DETAIL4, "Modifying a collection or table drops the results read from its schema and those of SQL, "\
+"any other SQL statement drops every result. Changes done by other sessions are only seen once the results expire, "\
+"as are the results of functions like NOW() or RAND().");
+
+/**
+* $(BASESESSION_SETRESULTCACHE_BRIEF)
+*
+* $(BASESESSION_SETRESULTCACHE_PARAM)
+*
+* $(BASESESSION_SETRESULTCACHE_DETAIL)
+* $(BASESESSION_SETRESULTCACHE_DETAIL1)
+* $(BASESESSION_SETRESULTCACHE_DETAIL2)
+*
+* $(BASESESSION_SETRESULTCACHE_DETAIL3)
+*
+* $(BASESESSION_SETRESULTCACHE_DETAIL4)
+*/
+#if DOXYGEN_JS
+Undefined BaseSession::setResultCache(Dictionary options) {}
+#elif DOXYGEN_PY
+None BaseSession::set_result_cache(dict options) {}
+#endif
+shcore::Value BaseSession::set_result_cache(const shcore::Argument_list &args) {
+  args.ensure_count(1, get_function_name("setResultCache").c_str());
+
+  try {
+    shcore::Argument_map options(*args.map_at(0));
+    options.ensure_keys({}, {"ttl", "memoryLimit"}, "result cache options");
+
+    ::mysqlx::Result_cache_config config;
+    if (options.has_key("ttl")) {
+      double ttl = options.double_at("ttl");
+      if (ttl < 0)
+        throw shcore::Exception::argument_error("The value for 'ttl' can not be negative");
+      config.ttl = static_cast<uint64_t>(ttl * 1000);
+    }
+
+    if (options.has_key("memoryLimit"))
+      config.memory_limit = options.uint_at("memoryLimit");
+
+    _session.set_result_cache(config);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("setResultCache"));
+
+  return shcore::Value();
+}
+
+shcore::Value::Map_type_ref BaseSession::get_protocol_stats() const {
+  ::mysqlx::Protocol_stats stats = _session.get_protocol_stats();
+
+  // The counters of every message type and their totals
+  auto traffic = [](const ::mysqlx::Protocol_stats::Traffic (&by_type)[::mysqlx::Protocol_stats::k_message_types],
+                    const std::function<std::string(int)> &type_name,
+                    uint64_t &frames, uint64_t &bytes) {
+    shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type);
+    frames = bytes = 0;
+    for (int mid = 0; mid < ::mysqlx::Protocol_stats::k_message_types; mid++) {
+      if (!by_type[mid].frames)
+        continue;
+
+      shcore::Value::Map_type_ref counters(new shcore::Value::Map_type);
+      (*counters)["frames"] = shcore::Value(by_type[mid].frames);
+      (*counters)["bytes"] = shcore::Value(by_type[mid].bytes);
+      (*ret_val)[type_name(mid)] = shcore::Value(counters);
+
+      frames += by_type[mid].frames;
+      bytes += by_type[mid].bytes;
+    }
+
+    return ret_val;
+  };
+
+  uint64_t frames, bytes;
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type);
+  (*ret_val)["sentByType"] = shcore::Value(traffic(stats.sent, [](int mid) {
+    return Mysqlx::ClientMessages::Type_IsValid(mid) ?
+      Mysqlx::ClientMessages::Type_Name(static_cast<Mysqlx::ClientMessages::Type>(mid)) : std::to_string(mid);
+  }, frames, bytes));
+  (*ret_val)["framesSent"] = shcore::Value(frames);
+  (*ret_val)["bytesSent"] = shcore::Value(bytes);
+
+  (*ret_val)["receivedByType"] = shcore::Value(traffic(stats.received, [](int mid) {
+    return Mysqlx::ServerMessages::Type_IsValid(mid) ?
+      Mysqlx::ServerMessages::Type_Name(static_cast<Mysqlx::ServerMessages::Type>(mid)) : std::to_string(mid);
+  }, frames, bytes));
+  (*ret_val)["framesReceived"] = shcore::Value(frames);
+  (*ret_val)["bytesReceived"] = shcore::Value(bytes);
+
+  (*ret_val)["notices"] = shcore::Value(stats.notices);
+  (*ret_val)["receiveWaitTime"] = shcore::Value(stats.recv_wait_time);
+  (*ret_val)["decodeTime"] = shcore::Value(stats.decode_time);
+  (*ret_val)["rowsBuffered"] = shcore::Value(stats.rows_buffered);
+
+  return ret_val;
+}
+
 shcore::Value BaseSession::get_capability(const std::string& name) {
   return _session.get_capability(name);
 }
@@ -797,6 +1430,7 @@ shcore::Value BaseSession::get_status(const shcore::Argument_list &args) {
     (*status)["SERVER_VERSION"] = shcore::Value(row->isNullField(4) ? "" : row->stringField(4));
 
     //(*status)["SERVER_STATS"] = shcore::Value(_conn->get_stats());
+    (*status)["PROTOCOL_STATS"] = shcore::Value(get_protocol_stats());
 
     // TODO: Review retrieval from charset_info, mysql connection
 
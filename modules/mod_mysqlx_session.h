@@ -28,6 +28,8 @@
 #include "mod_mysqlx_session_handle.h"
 #include "mysqlxtest/mysqlx.h"
 
+#include <deque>
+
 namespace shcore {
 class Proxy_object;
 };
@@ -71,6 +73,7 @@ public:
   List getSchemas();
   String getUri();
   Undefined close();
+  Undefined reset();
   Undefined setFetchWarnings(Bool value);
   Result startTransaction();
   Result commit();
@@ -79,6 +82,9 @@ public:
   Result dropTable(String schema, String name);
   Result dropCollection(String schema, String name);
   Result dropView(String schema, String name);
+  Map getStats();
+  List runBatch(List statements, Dictionary options);
+  Undefined setResultCache(Dictionary options);
   Bool isOpen();
 
 private:
@@ -92,6 +98,7 @@ private:
   list get_schemas();
   str get_uri();
   None close();
+  None reset();
   None set_fetch_warnings(bool value);
   Result start_transaction();
   Result commit();
@@ -100,6 +107,9 @@ private:
   Result drop_table(str schema, str name);
   Result drop_collection(str schema, str name);
   Result drop_view(str schema, str name);
+  dict get_stats();
+  list run_batch(list statements, dict options);
+  None set_result_cache(dict options);
   Bool is_open();
 private:
 #endif
@@ -110,6 +120,8 @@ private:
 
   virtual shcore::Value connect(const shcore::Argument_list &args);
   virtual shcore::Value close(const shcore::Argument_list &args);
+  shcore::Value reset(const shcore::Argument_list &args);
+  virtual void reset_state();
   virtual shcore::Value sql(const shcore::Argument_list &args);
   virtual shcore::Value create_schema(const shcore::Argument_list &args);
   virtual shcore::Value startTransaction(const shcore::Argument_list &args);
@@ -121,7 +133,20 @@ private:
   shcore::Value executeAdminCommand(const std::string& command, bool expect_data, const shcore::Argument_list &args) const;
   virtual shcore::Value execute_sql(const std::string& query, const shcore::Argument_list &args) const;
   std::shared_ptr< ::mysqlx::Result> execute_sql(const std::string &sql) const;
+
+  // Pipelined SQL execution, results are returned in the order the
+  // statements were sent
+  void send_sql(const std::string &sql) const;
+  shcore::Value recv_sql_result() const;
+
+  // Asynchronous SQL execution, returns a SqlResultFuture that retrieves
+  // the result when requested
+  shcore::Value execute_sql_async(const std::string &statement, const shcore::Argument_list &args) const;
+  shcore::Value recv_async_result(uint64_t ticket, const std::string &statement) const;
+  void discard_async_result(uint64_t ticket) const;
+  bool async_result_read(uint64_t ticket) const { return _session.async_result_read(ticket); }
   virtual bool is_connected() const;
+  virtual bool ping();
   virtual shcore::Value get_status(const shcore::Argument_list &args);
   virtual shcore::Value get_capability(const std::string& name);
 
@@ -131,7 +156,15 @@ private:
 
   virtual std::string db_object_exists(std::string &type, const std::string &name, const std::string& owner) const;
 
+  // The number of rows of the table as estimated by the storage engine
+  uint64_t estimate_row_count(const std::string &schema, const std::string &table) const;
+
   shcore::Value set_fetch_warnings(const shcore::Argument_list &args);
+  shcore::Value get_stats(const shcore::Argument_list &args) const;
+  shcore::Value run_batch(const shcore::Argument_list &args);
+  shcore::Value set_result_cache(const shcore::Argument_list &args);
+  // The traffic counters of the connection, in the format of getStats()
+  shcore::Value::Map_type_ref get_protocol_stats() const;
 
   std::shared_ptr< ::mysqlx::Session> session_obj() const;
 
@@ -142,6 +175,8 @@ private:
   virtual void set_option(const char *option, int value);
 
   virtual uint64_t get_connection_id() const;
+  virtual void kill_query();
+  virtual shcore::Slow_statement_log::Explain slow_statement_explain() const;
 
 protected:
   shcore::Value executeStmt(const std::string &domain, const std::string& command, bool expect_data, const shcore::Argument_list &args) const;
@@ -151,10 +186,15 @@ protected:
   virtual int get_default_port() { return 33060; };
 
   SessionHandle _session;
+  // Opened by kill_query(), with the TLS mode the session was opened with
+  SessionHandle _kill_session;
+  int _ssl_mode;
+
+  // Statements sent with send_sql() whose result was not received yet
+  mutable std::deque<std::string> _pending_statements;
 
   bool _case_sensitive_table_names;
   void init();
-  uint64_t _connection_id;
 private:
   void reset_session();
 };
@@ -21,6 +21,7 @@
 #include "mod_mysqlx_session_handle.h"
 #include "mysqlxtest_utils.h"
 #include "mysqlx_connection.h"
+#include "modules/endpoint_cache.h"
 #include "utils/utils_general.h"
 #include <boost/algorithm/string.hpp>
 
@@ -28,6 +29,9 @@ using namespace mysqlsh;
 using namespace shcore;
 using namespace mysqlsh::mysqlx;
 
+// Error of a failed authentication
+static const int kAccessDenied = 1045;
+
 SessionHandle::SessionHandle() :
 _case_sensitive_table_names(false), _connection_id(0), _expired_account(false) {}
 
@@ -39,7 +43,8 @@ void SessionHandle::open(const std::string &host, int port, const std::string &s
 
                           const std::string &ssl_tls_version, const std::string& ssl_ciphers, int ssl_mode,
                           const std::size_t timeout,
-                          const std::string &auth_method, const bool get_caps) {
+                          const std::string &auth_method, const bool get_caps,
+                          const ::mysqlx::Compression_config &compression) {
   ::mysqlx::Ssl_config ssl;
   memset(&ssl, 0, sizeof(ssl));
 
@@ -55,14 +60,83 @@ void SessionHandle::open(const std::string &host, int port, const std::string &s
   ssl.cipher = ssl_ciphers.c_str();
   ssl.mode = ssl_mode;
 
+  // A local server is reached through its Unix socket once known. The
+  // server offers no TLS on those, so not when it is required.
+  bool local = false;
+  bool known = false;
+  std::string local_socket;
+#ifndef _WIN32
+  local = ssl_mode <= SSL_MODE_PREFERRED && port != 0 && shcore::is_local_host(host, true);
+  known = local && shcore::get_local_socket(port, &local_socket);
+#endif
+
+  // The capabilities and the authentication method of an earlier session
+  // to the same server are used rather than found again. A list of hosts
+  // may lead to any of them, so it is not cached.
+  std::string endpoint = host.find(',') == std::string::npos ? host + ":" + std::to_string(port) : "";
+  Endpoint_info cached;
+  bool is_cached = !endpoint.empty() && Endpoint_cache::get()->find(endpoint, &cached);
+
+  Mysqlx::Connection::Capabilities capabilities;
+  bool known_capabilities = is_cached && !cached.capabilities.empty() &&
+                            capabilities.ParseFromString(cached.capabilities);
+
+  // Without a method given, the one that worked for the user is taken and
+  // otherwise MYSQL41 is tried before PLAIN, which the accounts of other
+  // plugins than mysql_native_password need
+  std::string method = auth_method;
+  bool known_method = false;
+  if (method.empty()) {
+    auto cached_method = cached.auth_methods.find(user);
+    known_method = cached_method != cached.auth_methods.end();
+    method = known_method ? cached_method->second : "MYSQL41";
+  }
+
   // TODO: Define a proper timeout for the session creation
   try {
-    _session = ::mysqlx::openSession(host, port, schema, user, pass, ssl, true, timeout, auth_method, true);
+    try {
+      _session = ::mysqlx::openSession(host, port, schema, user, pass, ssl, true, timeout, method, true, &compression,
+                                       local_socket, known_capabilities ? &capabilities : NULL);
+    } catch (const ::mysqlx::Error &error) {
+      // PLAIN sends the password as is, so only over TLS
+      if (!auth_method.empty() || known_method || method != "MYSQL41" || error.error() != kAccessDenied ||
+          ssl_mode == SSL_MODE_DISABLED)
+        throw;
+
+      try {
+        _session = ::mysqlx::openSession(host, port, schema, user, pass, ssl, true, timeout, "PLAIN", true,
+                                         &compression, local_socket, known_capabilities ? &capabilities : NULL);
+        method = "PLAIN";
+      } catch (const ::mysqlx::Error &) {
+        throw error;
+      }
+    }
+    _auth_method = method;
+
+    if (!local_socket.empty() && _session->connection()->local_socket().empty()) {
+      shcore::forget_local_socket(port);
+      known = false;
+    }
 
     // If the account is not expired, retrieves additional session information
     _expired_account = _session->connection()->expired_account();
-    if (!_expired_account)
+    if (!_expired_account) {
       load_session_info();
+
+      if (local && !known)
+        remember_local_sockets(port);
+
+      // An entry of another server is started again, so capabilities taken
+      // from it are asked for on the next session
+      if (!endpoint.empty()) {
+        Endpoint_cache *cache = Endpoint_cache::get();
+        cache->validate(endpoint, _server_uuid, _server_version);
+        if (!known_capabilities)
+          cache->set_capabilities(endpoint, _session->connection()->capabilities().SerializeAsString());
+        if (auth_method.empty())
+          cache->set_auth_method(endpoint, user, method);
+      }
+    }
   } catch (const ::mysqlx::Error& error) {
     if (error.error() == CR_MALFORMED_PACKET &&
       !strcmp(error.what(), "Unknown message received from server 10")) {
@@ -85,6 +159,67 @@ std::shared_ptr< ::mysqlx::Result> SessionHandle::execute_sql(const std::string
   return ret_val;
 }
 
+// Pipelined execution: statements are sent ahead with send_sql and their
+// results are later read with recv_sql_result in the same order
+void SessionHandle::send_sql(const std::string &sql) const {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  _session->connection()->send_sql(sql);
+}
+
+std::shared_ptr< ::mysqlx::Result> SessionHandle::recv_sql_result() const {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  std::shared_ptr< ::mysqlx::Result> ret_val = _session->connection()->recv_result();
+
+  // Calls wait so any error is properly triggered at this point
+  ret_val->wait();
+
+  return ret_val;
+}
+
+uint64_t SessionHandle::send_statement_async(const std::string &domain, const std::string& command, const Argument_list &args) const {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  // Converts the arguments from shcore to mysqlxtest format
+  std::vector< ::mysqlx::ArgumentValue> arguments;
+  for (size_t index = 0; index < args.size(); index++)
+    arguments.push_back(get_argument_value(args[index]));
+
+  return _session->connection()->send_stmt_async(domain, command, arguments);
+}
+
+std::shared_ptr< ::mysqlx::Result> SessionHandle::recv_async_result(uint64_t ticket) const {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  std::shared_ptr< ::mysqlx::Result> ret_val = _session->connection()->recv_async_result(ticket);
+
+  // Calls wait so any error is properly triggered at this point
+  ret_val->wait();
+
+  return ret_val;
+}
+
+std::vector<std::shared_ptr< ::mysqlx::Result> > SessionHandle::execute_batch(const std::vector<std::pair<int, std::string> > &statements, bool atomic) const {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  return _session->connection()->execute_batch(statements, atomic);
+}
+
+void SessionHandle::discard_async_result(uint64_t ticket) const {
+  if (_session)
+    _session->connection()->discard_async_result(ticket);
+}
+
+bool SessionHandle::async_result_read(uint64_t ticket) const {
+  return !_session || _session->connection()->async_result_read(ticket);
+}
+
 void SessionHandle::enable_protocol_trace(bool value) {
   _session->connection()->set_trace_protocol(value);
 }
@@ -97,6 +232,15 @@ void SessionHandle::reset() {
   }
 }
 
+void SessionHandle::reset_state(const std::string &user, const std::string &pass, const std::string &schema,
+                                const std::string &auth_method) {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  _last_result.reset();
+  _session->connection()->reset_session(user, pass, schema, auth_method.empty() ? _auth_method : auth_method);
+}
+
 std::shared_ptr< ::mysqlx::Result> SessionHandle::execute_statement(const std::string &domain, const std::string& command, const Argument_list &args) const {
   // Will return the result of the SQL execution
   // In case of error will be Undefined
@@ -110,6 +254,9 @@ std::shared_ptr< ::mysqlx::Result> SessionHandle::execute_statement(const std::s
     for (size_t index = 0; index < args.size(); index++)
       arguments.push_back(get_argument_value(args[index]));
 
+    // Released first, so the connection knows whether anybody else still
+    // holds the previous result
+    _last_result.reset();
     _last_result = _session->executeStmt(domain, command, arguments);
 
     // Calls wait so any error is properly triggered at execution time
@@ -250,11 +397,80 @@ uint64_t SessionHandle::get_client_id() {
     return 0;
 }
 
+void SessionHandle::set_buffer_config(const ::mysqlx::Buffer_config &config) {
+  if (_session)
+    _session->connection()->set_buffer_config(config);
+}
+
+::mysqlx::Buffer_config SessionHandle::get_buffer_config() const {
+  if (_session)
+    return _session->connection()->buffer_config();
+  else
+    return ::mysqlx::Buffer_config();
+}
+
+::mysqlx::Buffer_stats SessionHandle::get_buffer_stats() const {
+  if (_session)
+    return _session->connection()->buffer_stats();
+  else
+    return ::mysqlx::Buffer_stats();
+}
+
+void SessionHandle::set_discard_policy(const ::mysqlx::Discard_policy &policy) {
+  if (_session)
+    _session->connection()->set_discard_policy(policy);
+}
+
+void SessionHandle::set_result_prefetch(std::size_t max_rows) {
+  if (_session)
+    _session->connection()->set_result_prefetch(max_rows);
+}
+
+void SessionHandle::set_result_cache(const ::mysqlx::Result_cache_config &config) {
+  if (!_session)
+    throw Exception::logic_error("Not connected.");
+
+  _session->connection()->set_result_cache(config);
+}
+
+::mysqlx::Result_cache_stats SessionHandle::get_result_cache_stats() const {
+  if (_session)
+    return _session->connection()->result_cache_stats();
+  else
+    return ::mysqlx::Result_cache_stats();
+}
+
+::mysqlx::Protocol_stats SessionHandle::get_protocol_stats() const {
+  if (_session)
+    return _session->connection()->protocol_stats();
+  else
+    return ::mysqlx::Protocol_stats();
+}
+
+void SessionHandle::remember_local_sockets(int port) const {
+  std::map<std::string, std::string> variables;
+
+  try {
+    std::shared_ptr< ::mysqlx::Result> result = _session->executeSql(shcore::k_local_sockets_query);
+
+    while (std::shared_ptr< ::mysqlx::Row> row = result->next()) {
+      if (!row->isNullField(0) && !row->isNullField(1))
+        variables[row->stringField(0)] = row->stringField(1);
+    }
+  } catch (const ::mysqlx::Error &) {
+    // The sockets just stay unknown
+    return;
+  }
+
+  shcore::remember_local_sockets(port, variables);
+}
+
 void SessionHandle::load_session_info() const {
   try {
     if (is_connected()) {
       // TODO: update this logic properly
-      std::shared_ptr< ::mysqlx::Result> result = _session->executeSql("select @@lower_case_table_names, connection_id()");
+      std::shared_ptr< ::mysqlx::Result> result = _session->executeSql(
+        "select @@lower_case_table_names, connection_id(), @@server_uuid, @@version");
       result->wait();
 
       std::shared_ptr< ::mysqlx::Row>row = result->next();
@@ -262,8 +478,11 @@ void SessionHandle::load_session_info() const {
       auto case_sensitive_table_names = (int)row->uInt64Field(0);
       _case_sensitive_table_names = (case_sensitive_table_names == 0);
 
-      if (!row->isNullField(0))
-        _connection_id = row->uInt64Field(0);
+      if (!row->isNullField(1))
+        _connection_id = row->uInt64Field(1);
+
+      _server_uuid = row->isNullField(2) ? "" : row->stringField(2);
+      _server_version = row->isNullField(3) ? "" : row->stringField(3);
 
       result->flush();
     }
@@ -25,6 +25,7 @@
 #include "shellcore/types_cpp.h"
 #include "shellcore/ishell_core.h"
 #include "mysqlxtest/mysqlx.h"
+#include "mysqlxtest/mysqlx_connection.h"
 
 namespace mysqlsh {
 namespace mysqlx {
@@ -42,28 +43,71 @@ public:
             const std::string &ssl_crl, const std::string &ssl_crl_path,
             const std::string &ssl_tls_version, const std::string& ssl_ciphers, int ssl_mode,
             const std::size_t timeout,
-            const std::string &auth_method = "MYSQL41", const bool get_caps = false);
+            const std::string &auth_method = "MYSQL41", const bool get_caps = false,
+            const ::mysqlx::Compression_config &compression = ::mysqlx::Compression_config());
 
   std::shared_ptr< ::mysqlx::Result> execute_sql(const std::string &sql) const;
+  void send_sql(const std::string &sql) const;
+  std::shared_ptr< ::mysqlx::Result> recv_sql_result() const;
   void enable_protocol_trace(bool value);
   void reset();
+  // Clears the state of the session on the server keeping it open, see
+  // ::mysqlx::Connection::reset_session()
+  void reset_state(const std::string &user, const std::string &pass, const std::string &schema,
+                   const std::string &auth_method);
   std::shared_ptr< ::mysqlx::Result> execute_statement(const std::string &domain, const std::string& command, const shcore::Argument_list &args) const;
 
+  // Asynchronous execution: the statement is sent and the returned ticket
+  // is used to retrieve its result, any other execution reads the pending
+  // results first
+  uint64_t send_statement_async(const std::string &domain, const std::string& command, const shcore::Argument_list &args) const;
+  std::shared_ptr< ::mysqlx::Result> recv_async_result(uint64_t ticket) const;
+  void discard_async_result(uint64_t ticket) const;
+  bool async_result_read(uint64_t ticket) const;
+
+  // Sends the statements together, see ::mysqlx::Connection::execute_batch()
+  std::vector<std::shared_ptr< ::mysqlx::Result> > execute_batch(const std::vector<std::pair<int, std::string> > &statements, bool atomic) const;
+
   std::string db_object_exists(std::string &type, const std::string &name, const std::string& owner) const;
 
   shcore::Value get_capability(const std::string& name);
 
   bool expired_account() { return _expired_account; }
   void load_session_info() const;
+  void remember_local_sockets(int port) const;
 
   uint64_t get_client_id();
+  // The id KILL takes, unlike the client id of the X protocol
+  uint64_t get_connection_id() const { return _connection_id; }
+  const std::string &get_server_uuid() const { return _server_uuid; }
+  const std::string &get_server_version() const { return _server_version; }
+
+  // Sizing and memory accounting of the connection buffers
+  void set_buffer_config(const ::mysqlx::Buffer_config &config);
+  ::mysqlx::Buffer_config get_buffer_config() const;
+  ::mysqlx::Buffer_stats get_buffer_stats() const;
+  ::mysqlx::Protocol_stats get_protocol_stats() const;
+
+  // What is done with the results dropped before being read
+  void set_discard_policy(const ::mysqlx::Discard_policy &policy);
+
+  // The rows the results read ahead while the script goes through them
+  void set_result_prefetch(std::size_t max_rows);
+
+  // Results of the read only statements kept to answer them again
+  void set_result_cache(const ::mysqlx::Result_cache_config &config);
+  ::mysqlx::Result_cache_stats get_result_cache_stats() const;
 
 private:
   mutable std::shared_ptr< ::mysqlx::Result> _last_result;
   std::shared_ptr< ::mysqlx::Session> _session;
   mutable bool _case_sensitive_table_names;
   mutable uint64_t _connection_id;
+  mutable std::string _server_uuid;
+  mutable std::string _server_version;
   mutable bool _expired_account;
+  // The authentication method the session was opened with
+  std::string _auth_method;
 
   ::mysqlx::ArgumentValue get_argument_value(shcore::Value source) const;
 };
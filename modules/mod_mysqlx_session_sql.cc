@@ -39,11 +39,13 @@ Dynamic_object(), _session(owner) {
   add_method("bind", std::bind(&SqlExecute::bind, this, _1), "data");
   add_method("__shell_hook__", std::bind(&SqlExecute::execute, this, _1), "data");
   add_method("execute", std::bind(&SqlExecute::execute, this, _1), "data");
+  add_method("executeAsync", std::bind(&SqlExecute::execute_async, this, _1), "data");
 
   // Registers the dynamic function behavior
   register_dynamic_function("sql", "");
   register_dynamic_function("bind", "sql, bind");
   register_dynamic_function("execute", "sql, bind");
+  register_dynamic_function("executeAsync", "sql, bind");
   register_dynamic_function("__shell_hook__", "sql, bind");
 
   // Initial function update
@@ -222,3 +224,141 @@ shcore::Value SqlExecute::execute(const shcore::Argument_list &args) {
 
   return ret_val;
 }
+
+// Documentation of executeAsync function
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_BRIEF, "Sends the sql statement for execution without waiting for its result.");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_RETURN, "@return A SqlResultFuture object.");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_DETAIL, "The result is retrieved with the get() function of the returned object, "\
+"meanwhile other statements can be sent on this or other sessions so the servers process them concurrently.");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_DETAIL1, "The results of a session are received in the order the statements were sent, "\
+"any other operation on the session receives the pending results first.");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_DETAIL2, "This function can be invoked after:");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_DETAIL3, "@li sql(String statement)");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_DETAIL4, "@li bind(Value value)");
+REGISTER_HELP(SQLEXECUTE_EXECUTEASYNC_DETAIL5, "@li bind(List values)");
+
+/**
+* $(SQLEXECUTE_EXECUTEASYNC_BRIEF)
+*
+* $(SQLEXECUTE_EXECUTEASYNC_RETURN)
+*
+* $(SQLEXECUTE_EXECUTEASYNC_DETAIL)
+*
+* $(SQLEXECUTE_EXECUTEASYNC_DETAIL1)
+*
+* $(SQLEXECUTE_EXECUTEASYNC_DETAIL2)
+* $(SQLEXECUTE_EXECUTEASYNC_DETAIL3)
+* $(SQLEXECUTE_EXECUTEASYNC_DETAIL4)
+* $(SQLEXECUTE_EXECUTEASYNC_DETAIL5)
+*/
+#if DOXYGEN_JS
+SqlResultFuture SqlExecute::executeAsync() {}
+#elif DOXYGEN_PY
+SqlResultFuture SqlExecute::execute_async() {}
+#endif
+shcore::Value SqlExecute::execute_async(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  args.ensure_count(0, get_function_name("executeAsync").c_str());
+
+  try {
+    std::shared_ptr<NodeSession> session(std::static_pointer_cast<NodeSession>(_session.lock()));
+
+    if (session)
+      ret_val = session->execute_sql_async(_sql, _parameters);
+    else
+      throw shcore::Exception::logic_error("Unable to execute sql, no Session available");
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("executeAsync"));
+
+  return ret_val;
+}
+
+// Documentation of SqlResultFuture class
+REGISTER_HELP(SQLRESULTFUTURE_BRIEF, "Handler for the result of a SQL statement sent with SqlExecute.executeAsync().");
+REGISTER_HELP(SQLRESULTFUTURE_DETAIL, "The result is received from the server when get() is called, or before if "\
+"another operation is done on the session.");
+REGISTER_HELP(SQLRESULTFUTURE_DETAIL1, "Futures of several sessions let a script have statements running on many servers "\
+"at the same time from a single thread.");
+
+SqlResultFuture::SqlResultFuture(std::shared_ptr<BaseSession> owner, uint64_t ticket, const std::string &statement) :
+_session(owner), _ticket(ticket), _statement(statement) {
+  add_method("get", std::bind(&SqlResultFuture::get, this, _1), NULL);
+  add_method("isDone", std::bind(&SqlResultFuture::is_done, this, _1), NULL);
+}
+
+SqlResultFuture::~SqlResultFuture() {
+  // The result is read and dropped when its turn comes
+  if (!_result && !_error) {
+    std::shared_ptr<BaseSession> session(_session.lock());
+    if (session) {
+      try {
+        session->discard_async_result(_ticket);
+      } catch (...) {
+      }
+    }
+  }
+}
+
+// Documentation of get function
+REGISTER_HELP(SQLRESULTFUTURE_GET_BRIEF, "Returns the result of the statement, waiting for it if needed.");
+REGISTER_HELP(SQLRESULTFUTURE_GET_RETURN, "@return A SqlResult object.");
+REGISTER_HELP(SQLRESULTFUTURE_GET_DETAIL, "The results of the statements sent before on the same session are received first. "\
+"If the statement failed the error is raised, the same result or error is returned on every call.");
+
+/**
+* $(SQLRESULTFUTURE_GET_BRIEF)
+*
+* $(SQLRESULTFUTURE_GET_RETURN)
+*
+* $(SQLRESULTFUTURE_GET_DETAIL)
+*/
+#if DOXYGEN_JS || DOXYGEN_PY
+SqlResult SqlResultFuture::get() {}
+#endif
+shcore::Value SqlResultFuture::get(const shcore::Argument_list &args) {
+  args.ensure_count(0, get_function_name("get").c_str());
+
+  if (!_result && !_error) {
+    try {
+      std::shared_ptr<BaseSession> session(_session.lock());
+      if (!session)
+        throw shcore::Exception::logic_error("Unable to get the result, no Session available");
+
+      _result = session->recv_async_result(_ticket, _statement);
+    } catch (shcore::Exception &e) {
+      _error.reset(new shcore::Exception(e));
+    }
+  }
+
+  if (_error)
+    throw *_error;
+
+  return _result;
+}
+
+// Documentation of isDone function
+REGISTER_HELP(SQLRESULTFUTURE_ISDONE_BRIEF, "Returns whether the result was already received from the server.");
+REGISTER_HELP(SQLRESULTFUTURE_ISDONE_RETURN, "@return A boolean value, when true get() returns without waiting.");
+
+/**
+* $(SQLRESULTFUTURE_ISDONE_BRIEF)
+*
+* $(SQLRESULTFUTURE_ISDONE_RETURN)
+*/
+#if DOXYGEN_JS
+Bool SqlResultFuture::isDone() {}
+#elif DOXYGEN_PY
+bool SqlResultFuture::is_done() {}
+#endif
+shcore::Value SqlResultFuture::is_done(const shcore::Argument_list &args) {
+  args.ensure_count(0, get_function_name("isDone").c_str());
+
+  bool done = _result || _error;
+  if (!done) {
+    std::shared_ptr<BaseSession> session(_session.lock());
+    done = !session || session->async_result_read(_ticket);
+  }
+
+  return shcore::Value(done);
+}
@@ -24,10 +24,12 @@
 #define _MOD_SQL_EXECUTE_H_
 
 #include "dynamic_object.h"
+#include "shellcore/types_cpp.h"
 
 namespace mysqlsh {
 namespace mysqlx {
 class NodeSession;
+class BaseSession;
 /**
 * $(SQLEXECUTE_BRIEF)
 *
@@ -41,22 +43,59 @@ public:
   SqlExecute bind(Value value);
   SqlExecute bind(List values);
   SqlResult execute();
+  SqlResultFuture executeAsync();
 #elif DOXYGEN_PY
   SqlExecute sql(str statement);
   SqlExecute bind(Value value);
   SqlExecute bind(list values);
   SqlResult execute();
+  SqlResultFuture execute_async();
 #endif
   SqlExecute(std::shared_ptr<NodeSession> owner);
   virtual std::string class_name() const { return "SqlExecute"; }
   shcore::Value sql(const shcore::Argument_list &args);
   shcore::Value bind(const shcore::Argument_list &args);
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  shcore::Value execute_async(const shcore::Argument_list &args);
 private:
   std::weak_ptr<NodeSession> _session;
   std::string _sql;
   shcore::Argument_list _parameters;
 };
+
+/**
+* $(SQLRESULTFUTURE_BRIEF)
+*
+* $(SQLRESULTFUTURE_DETAIL)
+*
+* $(SQLRESULTFUTURE_DETAIL1)
+* \sa SqlExecute
+*/
+class SqlResultFuture : public shcore::Cpp_object_bridge {
+public:
+#if DOXYGEN_JS
+  SqlResult get();
+  Bool isDone();
+#elif DOXYGEN_PY
+  SqlResult get();
+  bool is_done();
+#endif
+  SqlResultFuture(std::shared_ptr<BaseSession> owner, uint64_t ticket, const std::string &statement);
+  virtual ~SqlResultFuture();
+
+  virtual std::string class_name() const { return "SqlResultFuture"; }
+  virtual bool operator == (const Object_bridge &other) const { return this == &other; }
+
+  shcore::Value get(const shcore::Argument_list &args);
+  shcore::Value is_done(const shcore::Argument_list &args);
+private:
+  std::weak_ptr<BaseSession> _session;
+  uint64_t _ticket;
+  std::string _statement;
+  // The result once retrieved, or the error it got
+  shcore::Value _result;
+  std::shared_ptr<shcore::Exception> _error;
+};
 };
 };
 
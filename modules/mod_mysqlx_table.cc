@@ -24,6 +24,7 @@
 #include "mod_mysqlx_table_delete.h"
 #include "mod_mysqlx_table_update.h"
 #include "mod_mysqlx_table_select.h"
+#include "mod_mysqlx_session.h"
 
 #include "utils/utils_help.h"
 
@@ -53,6 +54,7 @@ void Table::init() {
   add_method("select", std::bind(&Table::select_, this, _1), "searchCriteria", shcore::Array, NULL);
   add_method("delete", std::bind(&Table::delete_, this, _1), "tableFields", shcore::Array, NULL);
   add_method("isView", std::bind(&Table::is_view_, this, _1), NULL);
+  add_varargs_method("count", std::bind(&Table::count_, this, _1));
 }
 
 Table::~Table() {}
@@ -284,3 +286,62 @@ shcore::Value Table::is_view_(const shcore::Argument_list &args) {
 
   return Value(_is_view);
 }
+
+REGISTER_HELP(TABLE_COUNT_BRIEF, "Returns the number of rows in the table.");
+REGISTER_HELP(TABLE_COUNT_PARAM, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(TABLE_COUNT_RETURN, "@return The number of rows in the table.");
+REGISTER_HELP(TABLE_COUNT_DETAIL, "The rows are counted by the server with SELECT COUNT(*), only the count is sent back.");
+REGISTER_HELP(TABLE_COUNT_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(TABLE_COUNT_DETAIL2, "@li approximate: whether to return the estimate kept by the storage engine instead, "\
+"which is read at once but may be far off, by default false.");
+
+/**
+* $(TABLE_COUNT_BRIEF)
+*
+* $(TABLE_COUNT_PARAM)
+*
+* $(TABLE_COUNT_RETURN)
+*
+* $(TABLE_COUNT_DETAIL)
+*
+* $(TABLE_COUNT_DETAIL1)
+* $(TABLE_COUNT_DETAIL2)
+*/
+#if DOXYGEN_JS
+Integer Table::count(Dictionary options) {}
+#elif DOXYGEN_PY
+int Table::count(dict options) {}
+#endif
+shcore::Value Table::count_(const shcore::Argument_list &args) {
+  args.ensure_count(0, 1, "Table.count");
+
+  shcore::Value ret_val;
+
+  try {
+    bool approximate = false;
+    if (args.size() == 1) {
+      shcore::Argument_map opt_map(*args.map_at(0));
+      opt_map.ensure_keys({}, {"approximate"}, "count options");
+
+      if (opt_map.has_key("approximate"))
+        approximate = opt_map.bool_at("approximate");
+    }
+
+    if (approximate) {
+      auto session = std::dynamic_pointer_cast<BaseSession>(_session.lock());
+      if (!session)
+        throw shcore::Exception::logic_error("Unable to count the rows of '" + _name + "', no Session available");
+
+      ret_val = shcore::Value(session->estimate_row_count(_table_impl->schema()->name(), _name));
+    } else {
+      ::mysqlx::SelectStatement statement(_table_impl, std::vector<std::string>{"COUNT(*)"});
+      std::shared_ptr< ::mysqlx::Result> result(statement.execute());
+      std::shared_ptr< ::mysqlx::Row> row = result->next();
+      ret_val = shcore::Value(row->sInt64Field(0));
+      result->flush();
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION("Table.count");
+
+  return ret_val;
+}
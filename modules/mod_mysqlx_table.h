@@ -51,6 +51,7 @@ public:
   TableUpdate update();
   TableDelete delete();
   Bool isView();
+  Integer count(Dictionary options);
 #elif DOXYGEN_PY
   TableInsert insert();
   TableInsert insert(list columns);
@@ -60,6 +61,7 @@ public:
   TableUpdate update();
   TableDelete delete();
   bool is_view();
+  int count(dict options);
 #endif
   Table(std::shared_ptr<Schema> owner, const std::string &name, bool is_view = false);
   Table(std::shared_ptr<const Schema> owner, const std::string &name, bool is_view = false);
@@ -75,6 +77,7 @@ public:
   shcore::Value update_(const shcore::Argument_list &args);
   shcore::Value delete_(const shcore::Argument_list &args);
   shcore::Value is_view_(const shcore::Argument_list &args);
+  shcore::Value count_(const shcore::Argument_list &args);
 private:
 
   void init();
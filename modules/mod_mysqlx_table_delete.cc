@@ -42,6 +42,7 @@ TableDelete::TableDelete(std::shared_ptr<Table> owner)
   register_dynamic_function("limit", "delete, where, orderBy");
   register_dynamic_function("bind", "delete, where, orderBy, limit, bind");
   register_dynamic_function("execute", "delete, where, orderBy, limit, bind");
+  register_dynamic_function("explain", "delete, where, orderBy, limit, bind");
   register_dynamic_function("__shell_hook__", "delete, where, orderBy, limit, bind");
 
   // Initial function update
@@ -323,11 +324,32 @@ shcore::Value TableDelete::execute(const shcore::Argument_list &args) {
 
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_delete_statement->execute()));
+    uint64_t server_time = 0;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_delete_statement->execute()));
+    }
     timer.end();
     result->set_execution_time(timer.raw_duration());
+    if (shcore::Slow_statement_log::enabled())
+      watch_slow(*result, server_time);
   }
   CATCH_AND_TRANSLATE_CRUD_EXCEPTION(get_function_name("execute"));
 
   return result ? shcore::Value::wrap(result) : shcore::Value::Null();
 }
+
+/**
+* Returns the plan the server picks for the delete operation, without executing it.
+* \param options Optional dictionary with the format of the plan: json (the default) or tree, which requires MySQL 8.0.16 or newer.
+* \return Dictionary with the SQL statement the X plugin executes for the operation, as sql, and its plan, as plan.
+*
+* #### Method Chaining
+*
+* This function can be invoked at the same points as execute().
+*/
+#if DOXYGEN_JS
+Dictionary TableDelete::explain(Dictionary options) {}
+#elif DOXYGEN_PY
+dict TableDelete::explain(dict options) {}
+#endif
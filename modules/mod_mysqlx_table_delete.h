@@ -45,6 +45,7 @@ public:
   shcore::Value bind(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _delete_statement.get(); }
 #if DOXYGEN_JS
   TableDelete delete();
   TableDelete where(String searchCondition);
@@ -52,6 +53,7 @@ public:
   TableDelete limit(Integer numberOfRows);
   TableDelete bind(String name, Value value);
   Result execute();
+  Dictionary explain(Dictionary options);
 #elif DOXYGEN_PY
   TableDelete delete();
   TableDelete where(str searchCondition);
@@ -59,6 +61,7 @@ public:
   TableDelete limit(int numberOfRows);
   TableDelete bind(str name, Value value);
   Result execute();
+  dict explain(dict options);
 #endif
 private:
   std::unique_ptr< ::mysqlx::DeleteStatement> _delete_statement;
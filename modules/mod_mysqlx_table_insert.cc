@@ -22,11 +22,70 @@
 #include "mod_mysqlx_resultset.h"
 #include <boost/format.hpp>
 #include "utils/utils_time.h"
+#include <fstream>
 
 using namespace std::placeholders;
 using namespace mysqlsh::mysqlx;
 using namespace shcore;
 
+// Defaults for the rows inserted with valuesFrom, the messages are kept well
+// below the default mysqlx_max_allowed_packet of 1M
+#define TABLEINSERT_DEFAULT_BATCH_ROWS 1000
+#define TABLEINSERT_DEFAULT_MAX_BYTES (512 * 1024)
+#define TABLEINSERT_DEFAULT_PIPELINE_DEPTH 4
+
+namespace {
+// Reads the next record of a CSV file into fields, returns false at the end
+// of the file. Fields may be quoted with double quotes, in which case they
+// may contain the separator, line breaks and doubled quotes. Whether each
+// field was quoted is set on quoted_fields.
+bool read_csv_record(std::istream &input, char separator, std::vector<std::string> &fields,
+                     std::vector<bool> &quoted_fields) {
+  fields.clear();
+  quoted_fields.clear();
+
+  int c = input.get();
+  if (c == EOF)
+    return false;
+
+  std::string field;
+  bool quoted = false;
+  bool was_quoted = false;
+
+  for (; c != EOF; c = input.get()) {
+    if (quoted) {
+      if (c == '"') {
+        if (input.peek() == '"')
+          field.append(1, static_cast<char>(input.get()));
+        else
+          quoted = false;
+      } else {
+        field.append(1, static_cast<char>(c));
+      }
+    } else if (c == '"' && field.empty() && !was_quoted) {
+      quoted = true;
+      was_quoted = true;
+    } else if (c == separator) {
+      fields.push_back(field);
+      quoted_fields.push_back(was_quoted);
+      field.clear();
+      was_quoted = false;
+    } else if (c == '\n') {
+      break;
+    } else if (c != '\r') {
+      field.append(1, static_cast<char>(c));
+    }
+  }
+
+  if (quoted)
+    throw shcore::Exception::argument_error("Unterminated quoted field on the CSV file");
+
+  fields.push_back(field);
+  quoted_fields.push_back(was_quoted);
+  return true;
+}
+}
+
 /*
 * Class constructor represents the call to the first method on the
 * call chain, on this case insert.
@@ -37,16 +96,20 @@ using namespace shcore;
 * - Message information that is not provided through the different functions
 */
 TableInsert::TableInsert(std::shared_ptr<Table> owner)
-  :Table_crud_definition(std::static_pointer_cast<DatabaseObject>(owner)) {
+  :Table_crud_definition(std::static_pointer_cast<DatabaseObject>(owner)),
+  _batch_rows(TABLEINSERT_DEFAULT_BATCH_ROWS), _max_bytes(TABLEINSERT_DEFAULT_MAX_BYTES),
+  _pipeline_depth(TABLEINSERT_DEFAULT_PIPELINE_DEPTH), _fields_separator(','), _skip_rows(0) {
   // The values function should not be enabled if values were already given
   add_method("insert", std::bind(&TableInsert::insert, this, _1), "data");
   add_method("values", std::bind(&TableInsert::values, this, _1), "data");
+  add_method("valuesFrom", std::bind(&TableInsert::values_from, this, _1), "data");
 
   // Registers the dynamic function behavior
   register_dynamic_function("insert", "");
   register_dynamic_function("values", "insert, insertFields, values");
-  register_dynamic_function("execute", "insertFieldsAndValues, values, bind");
-  register_dynamic_function("__shell_hook__", "insertFieldsAndValues, values, bind");
+  register_dynamic_function("valuesFrom", "insert, insertFields, values");
+  register_dynamic_function("execute", "insertFieldsAndValues, values, valuesFrom, bind");
+  register_dynamic_function("__shell_hook__", "insertFieldsAndValues, values, valuesFrom, bind");
 
   // Initial function update
   update_functions("");
@@ -269,6 +332,165 @@ shcore::Value TableInsert::values(const shcore::Argument_list &args) {
   return Value(std::static_pointer_cast<Object_bridge>(shared_from_this()));
   }
 
+//! Sets a source of rows to be inserted, the rows are pulled from it on execute().
+//! \param source The source of the rows.
+//! \param options Optional dictionary with options for the insertion.
+/**
+* \return This TableInsert object.
+*
+* The source can be any of:
+* - A list with a list of values for each row.
+* - A function called with no arguments for each row, it returns the list of values for the row or null once
+*   there are no more rows. A JavaScript iterator can be given as function() { var n = it.next(); return n.done ? null : n.value; }
+*   and a Python one as lambda: next(it, None).
+* - The path to a CSV file with a row on each line.
+*
+* The values are handled as the ones given to values(), the ones read from a CSV file are strings except the
+* unquoted \\N, which stands for NULL.
+*
+* The rows are encoded as they are pulled from the source and sent in several messages, the options dictionary
+* may contain the following attributes:
+* - batchRows: maximum number of rows sent on each message, 1000 by default.
+* - maxBytes: maximum size of each message, 512K by default. A single row bigger than this is sent on its own message.
+* - pipelineDepth: number of messages sent to the server before waiting for their results, 4 by default.
+* - fieldsTerminatedBy: the character separating the fields of a CSV file, by default a comma.
+* - skipRows: number of lines skipped at the start of a CSV file, like a header, 0 by default.
+*
+* Each message is processed independently by the server, a transaction should be used if all the rows must be
+* inserted or none.
+*
+* #### Method Chaining
+*
+* This function can be invoked once after:
+* - insert()
+* - insert(List columns)
+* - insert(String col1, String col2, ...)
+* - values(Value value1, Value value2, ...)
+*
+* After this function invocation, the following functions can be invoked:
+*
+* - execute().
+*/
+#if DOXYGEN_JS
+TableInsert TableInsert::valuesFrom(Value source, Dictionary options) {}
+#elif DOXYGEN_PY
+TableInsert TableInsert::values_from(Value source, dict options) {}
+#endif
+shcore::Value TableInsert::values_from(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, get_function_name("valuesFrom").c_str());
+
+  try {
+    if (args[0].type == String) {
+      std::ifstream file(args.string_at(0));
+      if (!file.good())
+        throw shcore::Exception::argument_error("Unable to open the file '" + args.string_at(0) + "'");
+    } else if (args[0].type != Array && args[0].type != Function) {
+      throw shcore::Exception::type_error("Argument #1 is expected to be either a list of rows, a function or a file path");
+    }
+
+    if (args.size() == 2) {
+      shcore::Argument_map options(*args.map_at(1));
+      options.ensure_keys({}, {"batchRows", "maxBytes", "pipelineDepth", "fieldsTerminatedBy", "skipRows"}, "valuesFrom options");
+
+      if (options.has_key("batchRows")) {
+        _batch_rows = options.uint_at("batchRows");
+        if (_batch_rows == 0)
+          throw shcore::Exception::argument_error("The value for 'batchRows' must be greater than 0");
+      }
+
+      if (options.has_key("maxBytes"))
+        _max_bytes = options.uint_at("maxBytes");
+
+      if (options.has_key("pipelineDepth")) {
+        _pipeline_depth = options.uint_at("pipelineDepth");
+        if (_pipeline_depth == 0)
+          throw shcore::Exception::argument_error("The value for 'pipelineDepth' must be greater than 0");
+      }
+
+      if (options.has_key("fieldsTerminatedBy")) {
+        std::string separator = options.string_at("fieldsTerminatedBy");
+        if (separator.size() != 1 || separator[0] == '"' || separator[0] == '\n')
+          throw shcore::Exception::argument_error("The value for 'fieldsTerminatedBy' must be a single character other than a quote or a line break");
+        _fields_separator = separator[0];
+      }
+
+      if (options.has_key("skipRows"))
+        _skip_rows = options.uint_at("skipRows");
+    }
+
+    _values_source = args[0];
+
+    // Updates the exposed functions
+    update_functions("valuesFrom");
+  }
+  CATCH_AND_TRANSLATE_CRUD_EXCEPTION(get_function_name("valuesFrom"));
+
+  return Value(std::static_pointer_cast<Object_bridge>(shared_from_this()));
+}
+
+::mysqlx::Insert_Base::Row_source TableInsert::make_row_source() {
+  auto to_row = [this](const shcore::Value &row, std::vector< ::mysqlx::TableValue> &target, size_t number) {
+    if (row.type != Array)
+      throw shcore::Exception::type_error("Row #" + std::to_string(number) + " is expected to be a list of values");
+
+    for (auto &value : *row.as_array())
+      target.push_back(map_table_value(value));
+  };
+
+  if (_values_source.type == Array) {
+    shcore::Value::Array_type_ref rows(_values_source.as_array());
+    std::shared_ptr<size_t> next(new size_t(0));
+
+    return [rows, next, to_row](std::vector< ::mysqlx::TableValue> &target) {
+      if (*next >= rows->size())
+        return false;
+
+      to_row((*rows)[*next], target, *next + 1);
+      (*next)++;
+      return true;
+    };
+  } else if (_values_source.type == Function) {
+    std::shared_ptr<shcore::Function_base> function(_values_source.as_function());
+    std::shared_ptr<size_t> count(new size_t(0));
+
+    return [function, count, to_row](std::vector< ::mysqlx::TableValue> &target) {
+      shcore::Value row(function->invoke(shcore::Argument_list()));
+      if (row.type == Null || row.type == Undefined)
+        return false;
+
+      to_row(row, target, ++(*count));
+      return true;
+    };
+  } else {
+    std::shared_ptr<std::ifstream> file(new std::ifstream(_values_source.as_string(), std::ios::binary));
+    if (!file->good())
+      throw shcore::Exception::argument_error("Unable to open the file '" + _values_source.as_string() + "'");
+
+    std::shared_ptr<std::vector<std::string> > fields(new std::vector<std::string>());
+    std::shared_ptr<std::vector<bool> > quoted_fields(new std::vector<bool>());
+    char separator = _fields_separator;
+
+    for (size_t line = 0; line < _skip_rows; line++) {
+      if (!read_csv_record(*file, separator, *fields, *quoted_fields))
+        break;
+    }
+
+    return [file, fields, quoted_fields, separator](std::vector< ::mysqlx::TableValue> &target) {
+      if (!read_csv_record(*file, separator, *fields, *quoted_fields))
+        return false;
+
+      // Only an unquoted \N is NULL, "\N" is the text
+      for (size_t index = 0; index < fields->size(); index++) {
+        if (!(*quoted_fields)[index] && (*fields)[index] == "\\N")
+          target.push_back(::mysqlx::TableValue());
+        else
+          target.push_back(::mysqlx::TableValue((*fields)[index]));
+      }
+      return true;
+    };
+  }
+}
+
 /**
 * Executes the record insertion.
 * \return Result A result object that can be used to retrieve the results of the insertion operation.
@@ -305,7 +527,11 @@ shcore::Value TableInsert::execute(const shcore::Argument_list &args) {
 
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_insert_statement->execute()));
+    if (_values_source)
+      result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(
+        _insert_statement->execute(make_row_source(), _batch_rows, _max_bytes, _pipeline_depth)));
+    else
+      result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_insert_statement->execute()));
     timer.end();
     result->set_execution_time(timer.raw_duration());
   }
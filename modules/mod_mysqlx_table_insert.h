@@ -39,12 +39,14 @@ public:
   TableInsert insert(List columns);
   TableInsert insert(String col1, String col2, ...);
   TableInsert values(Value value, Value value, ...);
+  TableInsert valuesFrom(Value source, Dictionary options);
   Result execute();
 #elif DOXYGEN_PY
   TableInsert insert();
   TableInsert insert(list columns);
   TableInsert insert(str col1, str col2, ...);
   TableInsert values(Value value, Value value, ...);
+  TableInsert values_from(Value source, dict options);
   Result execute();
 #endif
   TableInsert(std::shared_ptr<Table> owner);
@@ -52,10 +54,22 @@ public:
   static std::shared_ptr<shcore::Object_bridge> create(const shcore::Argument_list &args);
   shcore::Value insert(const shcore::Argument_list &args);
   shcore::Value values(const shcore::Argument_list &args);
+  shcore::Value values_from(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _values_source ? NULL : _insert_statement.get(); }
 private:
   std::unique_ptr< ::mysqlx::InsertStatement> _insert_statement;
+
+  // The row source given to valuesFrom() and its options
+  shcore::Value _values_source;
+  size_t _batch_rows;
+  size_t _max_bytes;
+  size_t _pipeline_depth;
+  char _fields_separator;
+  size_t _skip_rows;
+
+  ::mysqlx::Insert_Base::Row_source make_row_source();
 };
 };
 };
@@ -50,6 +50,7 @@ public:
   TableSelect offset(Integer limitOffset);
   TableSelect bind(String name, Value value);
   RowResult execute();
+  Dictionary explain(Dictionary options);
 #elif DOXYGEN_PY
   TableSelect select(list searchExprStr);
   TableSelect where(str searchCondition);
@@ -60,6 +61,7 @@ public:
   TableSelect offset(int limitOffset);
   TableSelect bind(str name, Value value);
   RowResult execute();
+  dict explain(dict options);
 #endif
   TableSelect(std::shared_ptr<Table> owner);
   virtual std::string class_name() const { return "TableSelect"; }
@@ -73,6 +75,7 @@ public:
   shcore::Value bind(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _select_statement.get(); }
 private:
   std::unique_ptr< ::mysqlx::SelectStatement> _select_statement;
 };
@@ -46,6 +46,7 @@ TableUpdate::TableUpdate(std::shared_ptr<Table> owner)
   register_dynamic_function("limit", "set, where, orderBy");
   register_dynamic_function("bind", "set, where, orderBy, limit, bind");
   register_dynamic_function("execute", "set, where, orderBy, limit, bind");
+  register_dynamic_function("explain", "set, where, orderBy, limit, bind");
   register_dynamic_function("__shell_hook__", "set, where, orderBy, limit, bind");
 
   // Initial function update
@@ -407,11 +408,32 @@ shcore::Value TableUpdate::execute(const shcore::Argument_list &args) {
     args.ensure_count(0, get_function_name("execute").c_str());
     MySQL_timer timer;
     timer.start();
-    result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_update_statement->execute()));
+    uint64_t server_time = 0;
+    {
+      shcore::Phase_timer server_timer(server_time);
+      result = new mysqlx::Result(std::shared_ptr< ::mysqlx::Result>(_update_statement->execute()));
+    }
     timer.end();
     result->set_execution_time(timer.raw_duration());
+    if (shcore::Slow_statement_log::enabled())
+      watch_slow(*result, server_time);
   }
   CATCH_AND_TRANSLATE_CRUD_EXCEPTION(get_function_name("execute"));
 
   return result ? shcore::Value::wrap(result) : shcore::Value::Null();
 }
+
+/**
+* Returns the plan the server picks for the update operation, without executing it.
+* \param options Optional dictionary with the format of the plan: json (the default) or tree, which requires MySQL 8.0.16 or newer.
+* \return Dictionary with the SQL statement the X plugin executes for the operation, as sql, and its plan, as plan.
+*
+* #### Method Chaining
+*
+* This function can be invoked at the same points as execute().
+*/
+#if DOXYGEN_JS
+Dictionary TableUpdate::explain(Dictionary options) {}
+#elif DOXYGEN_PY
+dict TableUpdate::explain(dict options) {}
+#endif
@@ -48,6 +48,7 @@ public:
   TableUpdate limit(Integer numberOfRows);
   TableUpdate bind(String name, Value value);
   Result execute();
+  Dictionary explain(Dictionary options);
 #elif DOXYGEN_PY
   TableUpdate update();
   TableUpdate set(str attribute, Value value);
@@ -56,6 +57,7 @@ public:
   TableUpdate limit(int numberOfRows);
   TableUpdate bind(str name, Value value);
   Result execute();
+  dict explain(dict options);
 #endif
   TableUpdate(std::shared_ptr<Table> owner);
   virtual std::string class_name() const { return "TableUpdate"; }
@@ -68,6 +70,7 @@ public:
   shcore::Value bind(const shcore::Argument_list &args);
 
   virtual shcore::Value execute(const shcore::Argument_list &args);
+  virtual ::mysqlx::Statement *statement() { return _update_statement.get(); }
 private:
   std::unique_ptr< ::mysqlx::UpdateStatement> _update_statement;
 };
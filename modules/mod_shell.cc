@@ -22,10 +22,86 @@
 #include "shellcore/shell_core_options.h"
 #include "utils/utils_help.h"
 #include "modules/adminapi/mod_dba_common.h"
+#include "modules/base_resultset.h"
 #include "modules/base_session.h"
+#include "modules/mod_mysql_session.h"
+#include "modules/mod_mysqlx_session.h"
+#include "modules/mod_shell_compare.h"
+#include "modules/mod_shell_dump.h"
+#include "modules/mod_shell_parallel.h"
+#include "modules/mod_utils.h"
+#include "modules/mysql_connection.h"
+#include "modules/session_pool.h"
+#include "mysqlx_batch_control.h"
+#include "mysqlx_crud.h"
+#include "uuid_gen.h"
+#include "utils/utils_file.h"
+#include "utils/utils_connection.h"
+#include "utils/utils_mysql_parsing.h"
+#include "utils/utils_stats.h"
+#include "utils/utils_memory.h"
+#include "utils/utils_csv.h"
+#include "utils/utils_json_scan.h"
+#include "utils/utils_sqlstring.h"
+#include <boost/algorithm/string.hpp>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 using namespace std::placeholders;
 
+// Number of sessions used by loadSqlParallel when not specified
+#define LOAD_SQL_PARALLEL_DEFAULT_THREADS 4
+
+// Defaults of importTable: sessions and bytes of the file loaded at once
+#define IMPORT_TABLE_DEFAULT_THREADS 4
+#define IMPORT_TABLE_DEFAULT_CHUNK_SIZE (32 * 1024 * 1024)
+
+// Starting values of the batches importTable sends on X sessions, adjusted
+// as the server answers them, and the bytes of a batch
+#define IMPORT_TABLE_DEFAULT_BATCH_ROWS 1000
+#define IMPORT_TABLE_DEFAULT_PIPELINE_DEPTH 4
+#define IMPORT_TABLE_MAX_BATCH_BYTES (512 * 1024)
+
+// Defaults of importJson: sessions, bytes of the file loaded at once and
+// documents and inserts in flight the batches start with
+#define IMPORT_JSON_DEFAULT_THREADS 4
+#define IMPORT_JSON_DEFAULT_CHUNK_SIZE (32 * 1024 * 1024)
+#define IMPORT_JSON_DEFAULT_BATCH_DOCS 1000
+#define IMPORT_JSON_DEFAULT_PIPELINE_DEPTH 4
+
+// Defaults of dumpSchemas: sessions and rows on each chunk file
+#define DUMP_SCHEMAS_DEFAULT_THREADS 4
+#define DUMP_SCHEMAS_DEFAULT_CHUNK_ROWS 500000
+#define DUMP_SCHEMAS_DEFAULT_ROW_GROUP_ROWS 100000
+
+// Sessions used by loadDump when not specified
+#define LOAD_DUMP_DEFAULT_THREADS 4
+
+// Worker threads used by parallel when not specified
+#define PARALLEL_DEFAULT_WORKERS 4
+
+// Defaults of queryAll: instances queried at once and seconds to wait on the
+// network of each of them
+#define QUERY_ALL_DEFAULT_CONCURRENCY 16
+#define QUERY_ALL_DEFAULT_TIMEOUT 10
+
+// Defaults of compareTables: sessions and rows on each compared chunk
+#define COMPARE_TABLES_DEFAULT_THREADS 4
+#define COMPARE_TABLES_DEFAULT_CHUNK_ROWS 100000
+
+// Defaults of copyTables: sessions on each side and rows on each chunk
+#define COPY_TABLES_DEFAULT_THREADS 4
+#define COPY_TABLES_DEFAULT_CHUNK_ROWS 500000
+
+// Defaults of parallelScan: worker threads and rows on each batch
+#define PARALLEL_SCAN_DEFAULT_THREADS 4
+#define PARALLEL_SCAN_DEFAULT_CHUNK_ROWS 1000
+
 
 namespace mysqlsh {
 
@@ -46,6 +122,19 @@ void Shell::init() {
   add_method("parseUri", std::bind(&Shell::parse_uri, this, _1), "uri", shcore::String, NULL);
   add_varargs_method("prompt", std::bind(&Shell::prompt, this, _1));
   add_varargs_method("connect", std::bind(&Shell::connect, this, _1));
+  add_varargs_method("loadSqlParallel", std::bind(&Shell::load_sql_parallel, this, _1));
+  add_varargs_method("importTable", std::bind(&Shell::import_table, this, _1));
+  add_varargs_method("importJson", std::bind(&Shell::import_json, this, _1));
+  add_varargs_method("dumpSchemas", std::bind(&Shell::dump_schemas, this, _1));
+  add_varargs_method("loadDump", std::bind(&Shell::load_dump, this, _1));
+  add_varargs_method("stats", std::bind(&Shell::stats, this, _1));
+  add_varargs_method("memoryStats", std::bind(&Shell::memory_stats, this, _1));
+  add_varargs_method("parallel", std::bind(&Shell::parallel, this, _1));
+  add_varargs_method("queryAll", std::bind(&Shell::query_all, this, _1));
+  add_varargs_method("distinct", std::bind(&Shell::distinct, this, _1));
+  add_varargs_method("compareTables", std::bind(&Shell::compare_tables, this, _1));
+  add_varargs_method("copyTables", std::bind(&Shell::copy_tables, this, _1));
+  add_varargs_method("parallelScan", std::bind(&Shell::parallel_scan, this, _1));
 }
 
 Shell::~Shell() {}
@@ -302,4 +391,1909 @@ shcore::Value Shell::connect(const shcore::Argument_list &args) {
 
   return shcore::Value();
 }
-}
\ No newline at end of file
+
+namespace {
+// Closes a worker session, its errors are of no interest at this point
+void close_worker(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session) {
+  try {
+    session->close(shcore::Argument_list());
+  } catch (...) {
+  }
+}
+
+// Closes the worker sessions of loadSqlParallel however the load ends
+class Worker_closer {
+public:
+  explicit Worker_closer(std::vector<std::shared_ptr<mysqlsh::ShellDevelopmentSession> > &sessions)
+    : _sessions(sessions) {}
+
+  ~Worker_closer() {
+    for (auto &session : _sessions)
+      close_worker(session);
+  }
+
+private:
+  std::vector<std::shared_ptr<mysqlsh::ShellDevelopmentSession> > &_sessions;
+};
+}
+
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_BRIEF, "Executes the SQL statements on a file using several sessions in parallel.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_PARAM, "@param file The path to the file containing the SQL statements.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_RETURN, "@return A dictionary with the number of executed statements and the errors found.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL, "This function opens additional sessions using the connection data of the global session "\
+"and distributes the statements on the file among them.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL2, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL3, "Consecutive INSERT and REPLACE statements are executed in parallel, USE and SET statements "\
+"are executed on every session and any other statement is executed once all the previous statements completed. "\
+"LOCK TABLES and UNLOCK TABLES statements are ignored.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL4, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL5, "@li executed: the number of statements successfully executed.");
+REGISTER_HELP(SHELL_LOADSQLPARALLEL_DETAIL6, "@li errors: a list with the error messages of the failed statements.");
+
+/**
+ * $(SHELL_LOADSQLPARALLEL_BRIEF)
+ *
+ * $(SHELL_LOADSQLPARALLEL_PARAM)
+ * $(SHELL_LOADSQLPARALLEL_PARAM1)
+ *
+ * $(SHELL_LOADSQLPARALLEL_RETURN)
+ *
+ * $(SHELL_LOADSQLPARALLEL_DETAIL)
+ *
+ * $(SHELL_LOADSQLPARALLEL_DETAIL1)
+ * $(SHELL_LOADSQLPARALLEL_DETAIL2)
+ *
+ * $(SHELL_LOADSQLPARALLEL_DETAIL3)
+ *
+ * $(SHELL_LOADSQLPARALLEL_DETAIL4)
+ * $(SHELL_LOADSQLPARALLEL_DETAIL5)
+ * $(SHELL_LOADSQLPARALLEL_DETAIL6)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::loadSqlParallel(String file, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::load_sql_parallel(str file, dict options){}
+#endif
+shcore::Value Shell::load_sql_parallel(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, get_function_name("loadSqlParallel").c_str());
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  try {
+    std::string path = args.string_at(0);
+    int threads = LOAD_SQL_PARALLEL_DEFAULT_THREADS;
+
+    if (args.size() == 2) {
+      shcore::Argument_map opt_map(*args.map_at(1));
+      opt_map.ensure_keys({}, {"threads"}, "loadSqlParallel options");
+
+      if (opt_map.has_key("threads"))
+        threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+    }
+
+    auto session = _shell_core->get_dev_session();
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    std::string data;
+    if (!shcore::load_text_file(path, data))
+      throw shcore::Exception::runtime_error("Unable to open file '" + path + "': " + shcore::get_last_error());
+
+    std::vector<std::string> statements = split_sql_statements(data);
+
+    // Opens the worker sessions using the connection data of the global session
+    std::vector<std::shared_ptr<mysqlsh::ShellDevelopmentSession> > sessions;
+    Worker_closer closer(sessions);
+    for (int index = 0; index < threads; index++)
+      sessions.push_back(clone_session(session));
+
+    std::atomic<size_t> executed(0);
+    std::mutex errors_mutex;
+    shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+    auto execute = [&](std::shared_ptr<mysqlsh::ShellDevelopmentSession> target, size_t index) {
+      try {
+        target->execute_sql(statements[index], shcore::Argument_list());
+        executed++;
+        return true;
+      } catch (shcore::Exception &e) {
+        std::lock_guard<std::mutex> lock(errors_mutex);
+        errors->push_back(shcore::Value("Statement #" + std::to_string(index + 1) + ": " + e.what()));
+      } catch (std::exception &e) {
+        std::lock_guard<std::mutex> lock(errors_mutex);
+        errors->push_back(shcore::Value("Statement #" + std::to_string(index + 1) + ": " + e.what()));
+      }
+      return false;
+    };
+
+    size_t index = 0;
+    while (index < statements.size()) {
+      Load_statement_type statement_type = get_statement_type(statements[index]);
+
+      if (statement_type == Load_statement_type::Data) {
+        // Consecutive data statements are consumed by the sessions in parallel
+        size_t end = index;
+        while (end < statements.size() && get_statement_type(statements[end]) == Load_statement_type::Data)
+          end++;
+
+        std::atomic<size_t> next(index);
+        std::vector<std::thread> workers;
+        for (auto &target : sessions) {
+          workers.push_back(std::thread([&, target]() {
+            size_t current;
+            while ((current = next++) < end)
+              execute(target, current);
+          }));
+        }
+
+        for (auto &worker : workers)
+          worker.join();
+
+        index = end;
+      } else {
+        if (statement_type == Load_statement_type::Session) {
+          // Session state must be the same on all the sessions, it is counted
+          // once. A session where the statement does not end as on the first
+          // one has a different state and is no longer used.
+          bool applied = execute(sessions[0], index);
+
+          for (size_t session_index = sessions.size() - 1; session_index > 0; session_index--) {
+            std::string error;
+            try {
+              sessions[session_index]->execute_sql(statements[index], shcore::Argument_list());
+            } catch (std::exception &e) {
+              error = e.what();
+            }
+
+            if (applied == error.empty())
+              continue;
+
+            errors->push_back(shcore::Value("Statement #" + std::to_string(index + 1) + " on session #" +
+                std::to_string(session_index + 1) + (error.empty() ? " did not fail as on session #1" : ": " + error) +
+                ", the session is no longer used"));
+
+            close_worker(sessions[session_index]);
+            sessions.erase(sessions.begin() + session_index);
+          }
+        } else if (statement_type == Load_statement_type::Other) {
+          execute(sessions[0], index);
+        }
+
+        index++;
+      }
+    }
+
+    (*ret_val)["executed"] = shcore::Value(static_cast<int64_t>(executed));
+    (*ret_val)["errors"] = shcore::Value(errors);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("loadSqlParallel"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_IMPORTTABLE_BRIEF, "Imports a CSV or TSV file into a table using several sessions in parallel.");
+REGISTER_HELP(SHELL_IMPORTTABLE_PARAM, "@param file The path to the file with the rows.");
+REGISTER_HELP(SHELL_IMPORTTABLE_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_IMPORTTABLE_RETURN, "@return A dictionary with the number of imported rows and the errors found.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL, "This function splits the file in chunks ending on a record boundary and loads them "\
+"on additional sessions opened using the connection data of the global session. On a classic session every "\
+"chunk is loaded with LOAD DATA LOCAL INFILE, on an X session its rows are inserted in batches. The rows of the "\
+"batches and the batches in flight grow while the server answers them quickly and are halved when it slows down or "\
+"fails with lock wait timeouts, deadlocks or packets too large, the progress shows the current values.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL2, "@li schema: the schema of the table, by default the current schema.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL3, "@li table: the target table, by default the name of the file without extension.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL4, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL5, "@li chunkSize: the approximate size in bytes of each chunk, by default 32MB.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL6, "@li dialect: csv (comma separated, optionally enclosed by double quotes) or "\
+"tsv (tab separated with backslash escapes), by default csv.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL7, "@li skipRows: the number of rows to skip at the beginning of the file, by default 0.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL8, "@li showProgress: whether the progress is printed every second, by default true.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL9, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL10, "@li rows: the number of imported rows.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL11, "@li bytes: the number of bytes of the file that were loaded.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL12, "@li chunks: the number of chunks the file was split in.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL13, "@li seconds: the time the import took.");
+REGISTER_HELP(SHELL_IMPORTTABLE_DETAIL14, "@li errors: a list with the error messages of the failed chunks.");
+
+/**
+ * $(SHELL_IMPORTTABLE_BRIEF)
+ *
+ * $(SHELL_IMPORTTABLE_PARAM)
+ * $(SHELL_IMPORTTABLE_PARAM1)
+ *
+ * $(SHELL_IMPORTTABLE_RETURN)
+ *
+ * $(SHELL_IMPORTTABLE_DETAIL)
+ *
+ * $(SHELL_IMPORTTABLE_DETAIL1)
+ * $(SHELL_IMPORTTABLE_DETAIL2)
+ * $(SHELL_IMPORTTABLE_DETAIL3)
+ * $(SHELL_IMPORTTABLE_DETAIL4)
+ * $(SHELL_IMPORTTABLE_DETAIL5)
+ * $(SHELL_IMPORTTABLE_DETAIL6)
+ * $(SHELL_IMPORTTABLE_DETAIL7)
+ * $(SHELL_IMPORTTABLE_DETAIL8)
+ *
+ * $(SHELL_IMPORTTABLE_DETAIL9)
+ * $(SHELL_IMPORTTABLE_DETAIL10)
+ * $(SHELL_IMPORTTABLE_DETAIL11)
+ * $(SHELL_IMPORTTABLE_DETAIL12)
+ * $(SHELL_IMPORTTABLE_DETAIL13)
+ * $(SHELL_IMPORTTABLE_DETAIL14)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::importTable(String file, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::import_table(str file, dict options){}
+#endif
+shcore::Value Shell::import_table(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, get_function_name("importTable").c_str());
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  try {
+    std::string path = args.string_at(0);
+    std::string schema;
+    std::string table;
+    int threads = IMPORT_TABLE_DEFAULT_THREADS;
+    uint64_t chunk_size = IMPORT_TABLE_DEFAULT_CHUNK_SIZE;
+    uint64_t skip_rows = 0;
+    bool show_progress = true;
+    shcore::Text_dialect dialect = shcore::Text_dialect::csv();
+
+    if (args.size() == 2) {
+      shcore::Argument_map opt_map(*args.map_at(1));
+      opt_map.ensure_keys({}, {"schema", "table", "threads", "chunkSize", "dialect", "skipRows", "showProgress"},
+                          "importTable options");
+
+      if (opt_map.has_key("schema"))
+        schema = opt_map.string_at("schema");
+
+      if (opt_map.has_key("table"))
+        table = opt_map.string_at("table");
+
+      if (opt_map.has_key("threads"))
+        threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("chunkSize"))
+        chunk_size = opt_map.uint_at("chunkSize");
+
+      if (chunk_size == 0)
+        throw shcore::Exception::argument_error("The value for 'chunkSize' must be a positive integer");
+
+      if (opt_map.has_key("dialect"))
+        dialect = shcore::Text_dialect::from_name(opt_map.string_at("dialect"));
+
+      if (opt_map.has_key("skipRows"))
+        skip_rows = opt_map.uint_at("skipRows");
+
+      if (opt_map.has_key("showProgress"))
+        show_progress = opt_map.bool_at("showProgress");
+    }
+
+    auto session = _shell_core->get_dev_session();
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    if (schema.empty())
+      schema = session->get_default_schema();
+
+    if (schema.empty())
+      throw shcore::Exception::argument_error("There is no active schema, the target schema must be specified with the 'schema' option");
+
+    if (table.empty()) {
+      // The file name without directory nor extension
+      size_t start = path.find_last_of("/\\");
+      table = path.substr(start == std::string::npos ? 0 : start + 1);
+      table = table.substr(0, table.find('.'));
+    }
+
+    std::unique_ptr<shcore::Mapped_file> file;
+    try {
+      file.reset(new shcore::Mapped_file(path));
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+
+    const char *data = file->data();
+    size_t size = file->size();
+    size_t start = shcore::skip_records(data, size, 0, static_cast<size_t>(skip_rows), dialect);
+    auto chunks = shcore::split_records(data, size, start, static_cast<size_t>(chunk_size), dialect);
+
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<uint64_t> rows(0);
+    std::atomic<uint64_t> bytes(0);
+    std::atomic<int> running(threads);
+    std::mutex errors_mutex;
+    shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+    auto add_error = [&](const std::string &message) {
+      std::lock_guard<std::mutex> lock(errors_mutex);
+      errors->push_back(shcore::Value(message));
+    };
+
+    // The batches of the X sessions are sized as the server answers them,
+    // all the workers share the control
+    ::mysqlx::Batch_control batch_control(IMPORT_TABLE_DEFAULT_BATCH_ROWS, IMPORT_TABLE_DEFAULT_PIPELINE_DEPTH);
+
+    // Every worker opens its own connection first, as the connection data
+    // is only read from the global session here
+    std::vector<std::function<void()> > workers;
+    auto classic = std::dynamic_pointer_cast<mysqlsh::mysql::ClassicSession>(session);
+    if (classic) {
+      std::string sql = shcore::sqlstring("LOAD DATA LOCAL INFILE 'chunk' INTO TABLE !.!", 0) << schema << table;
+      sql += " CHARACTER SET utf8mb4 " + dialect.load_data_clauses();
+
+      for (int index = 0; index < threads; index++) {
+        std::shared_ptr<mysqlsh::mysql::Connection> connection = classic->open_connection(true);
+
+        workers.push_back([&, connection, sql]() {
+          size_t current;
+          while ((current = next_chunk++) < chunks.size()) {
+            try {
+              auto result = connection->run_load_data_local(sql, data + chunks[current].first, chunks[current].second);
+              rows += result->affected_rows();
+              bytes += chunks[current].second;
+            } catch (shcore::Exception &e) {
+              add_error("Chunk #" + std::to_string(current + 1) + ": " + e.what());
+            } catch (std::exception &e) {
+              add_error("Chunk #" + std::to_string(current + 1) + ": " + e.what());
+            }
+          }
+        });
+      }
+    } else {
+      shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(session->uri(), false);
+      (*connection_data)[shcore::kDbPassword] = shcore::Value(session->get_password());
+      if (!session->get_ssl_ca().empty())
+        (*connection_data)[shcore::kSslCa] = shcore::Value(session->get_ssl_ca());
+      if (!session->get_ssl_cert().empty())
+        (*connection_data)[shcore::kSslCert] = shcore::Value(session->get_ssl_cert());
+      if (!session->get_ssl_key().empty())
+        (*connection_data)[shcore::kSslKey] = shcore::Value(session->get_ssl_key());
+
+      for (int index = 0; index < threads; index++) {
+        shcore::Argument_list session_args;
+        session_args.push_back(shcore::Value(connection_data));
+        auto target = std::dynamic_pointer_cast<mysqlsh::mysqlx::BaseSession>(
+            mysqlsh::connect_session(session_args, SessionType::Node));
+
+        workers.push_back([&, target]() {
+          auto x_table = target->session_obj()->getSchema(schema)->getTable(table);
+          std::vector<std::string> fields;
+          std::vector<bool> nulls;
+
+          size_t current;
+          while ((current = next_chunk++) < chunks.size()) {
+            // The rows are decoded in the worker and sent as they are read
+            shcore::Record_reader reader(data + chunks[current].first, chunks[current].second, dialect);
+            auto next_row = [&](std::vector< ::mysqlx::TableValue> &row) {
+              if (!reader.next(fields, nulls))
+                return false;
+
+              for (size_t field = 0; field < fields.size(); field++) {
+                if (nulls[field])
+                  row.push_back(::mysqlx::TableValue());
+                else
+                  row.push_back(::mysqlx::TableValue(fields[field]));
+              }
+              return true;
+            };
+
+            try {
+              auto result = x_table->insert().execute(next_row, batch_control, IMPORT_TABLE_MAX_BATCH_BYTES);
+              rows += result->affectedRows();
+              bytes += chunks[current].second;
+            } catch (::mysqlx::Error &e) {
+              add_error("Chunk #" + std::to_string(current + 1) + ": " + e.what());
+            } catch (std::exception &e) {
+              add_error("Chunk #" + std::to_string(current + 1) + ": " + e.what());
+            }
+          }
+
+          target->close(shcore::Argument_list());
+        });
+      }
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> worker_threads;
+    for (auto &worker : workers) {
+      worker_threads.push_back(std::thread([&, worker]() {
+        // An exception leaving the thread would terminate the shell, the ones
+        // out of the chunks (i.e. the table is not found) are errors too
+        try {
+          worker();
+        } catch (::mysqlx::Error &e) {
+          add_error(e.what());
+        } catch (std::exception &e) {
+          add_error(e.what());
+        }
+        running--;
+      }));
+    }
+
+    // Progress is printed from this thread, the workers never print
+    auto last_print = start_time;
+    uint64_t total = size - start;
+    while (running > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+      auto now = std::chrono::steady_clock::now();
+      if (show_progress && now - last_print >= std::chrono::seconds(1)) {
+        double elapsed = std::chrono::duration<double>(now - start_time).count();
+        char line[128];
+        snprintf(line, sizeof(line), "%.1f%% (%.2f MB / %.2f MB), %.2f MB/s, %.0f rows/s",
+                 total ? 100.0 * bytes / total : 100.0, bytes / 1048576.0, total / 1048576.0,
+                 bytes / 1048576.0 / elapsed, rows / elapsed);
+        _shell_core->print(std::string(line) + (classic ? "" : ", " + batch_control.describe()) + "\n");
+        last_print = now;
+      }
+    }
+
+    for (auto &worker : worker_threads)
+      worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    (*ret_val)["rows"] = shcore::Value(static_cast<uint64_t>(rows));
+    (*ret_val)["bytes"] = shcore::Value(static_cast<uint64_t>(bytes));
+    (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunks.size()));
+    (*ret_val)["seconds"] = shcore::Value(seconds);
+    (*ret_val)["errors"] = shcore::Value(errors);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("importTable"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_IMPORTJSON_BRIEF, "Imports a file of JSON documents into a collection using several sessions in parallel.");
+REGISTER_HELP(SHELL_IMPORTJSON_PARAM, "@param file The path to the file with the documents.");
+REGISTER_HELP(SHELL_IMPORTJSON_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_IMPORTJSON_RETURN, "@return A dictionary with the number of imported documents and the errors found.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL, "The file may contain one document after the other, as in NDJSON, or a single array "\
+"of documents. It is split in chunks ending on a document boundary and the documents of every chunk are inserted "\
+"in batches on additional X sessions opened using the connection data of the global session. The documents are "\
+"sent as they are in the file, for the server to parse them, the ones without _id get a generated one.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL1, "The global session must be an X session and the target collection must exist.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL2, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL3, "@li schema: the schema of the collection, by default the current schema.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL4, "@li collection: the target collection, by default the name of the file without extension.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL5, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL6, "@li chunkSize: the approximate size in bytes of each chunk, by default 32MB.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL7, "@li batchDocs: the number of documents inserted by each statement at first, by default 1000. The documents "\
+"of the batches and the batches in flight grow while the server answers them quickly and are halved when it slows "\
+"down or fails with lock wait timeouts, deadlocks or packets too large, the progress shows the current values.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL8, "@li showProgress: whether the progress is printed every second, by default true.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL9, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL10, "@li documents: the number of imported documents.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL11, "@li bytes: the number of bytes of the file that were loaded.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL12, "@li chunks: the number of chunks the file was split in.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL13, "@li seconds: the time the import took.");
+REGISTER_HELP(SHELL_IMPORTJSON_DETAIL14, "@li errors: a list with the error messages of the failed chunks.");
+
+/**
+ * $(SHELL_IMPORTJSON_BRIEF)
+ *
+ * $(SHELL_IMPORTJSON_PARAM)
+ * $(SHELL_IMPORTJSON_PARAM1)
+ *
+ * $(SHELL_IMPORTJSON_RETURN)
+ *
+ * $(SHELL_IMPORTJSON_DETAIL)
+ *
+ * $(SHELL_IMPORTJSON_DETAIL1)
+ *
+ * $(SHELL_IMPORTJSON_DETAIL2)
+ * $(SHELL_IMPORTJSON_DETAIL3)
+ * $(SHELL_IMPORTJSON_DETAIL4)
+ * $(SHELL_IMPORTJSON_DETAIL5)
+ * $(SHELL_IMPORTJSON_DETAIL6)
+ * $(SHELL_IMPORTJSON_DETAIL7)
+ * $(SHELL_IMPORTJSON_DETAIL8)
+ *
+ * $(SHELL_IMPORTJSON_DETAIL9)
+ * $(SHELL_IMPORTJSON_DETAIL10)
+ * $(SHELL_IMPORTJSON_DETAIL11)
+ * $(SHELL_IMPORTJSON_DETAIL12)
+ * $(SHELL_IMPORTJSON_DETAIL13)
+ * $(SHELL_IMPORTJSON_DETAIL14)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::importJson(String file, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::import_json(str file, dict options){}
+#endif
+shcore::Value Shell::import_json(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, get_function_name("importJson").c_str());
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  try {
+    std::string path = args.string_at(0);
+    std::string schema;
+    std::string collection;
+    int threads = IMPORT_JSON_DEFAULT_THREADS;
+    uint64_t chunk_size = IMPORT_JSON_DEFAULT_CHUNK_SIZE;
+    uint64_t batch_docs = IMPORT_JSON_DEFAULT_BATCH_DOCS;
+    bool show_progress = true;
+
+    if (args.size() == 2) {
+      shcore::Argument_map opt_map(*args.map_at(1));
+      opt_map.ensure_keys({}, {"schema", "collection", "threads", "chunkSize", "batchDocs", "showProgress"},
+                          "importJson options");
+
+      if (opt_map.has_key("schema"))
+        schema = opt_map.string_at("schema");
+
+      if (opt_map.has_key("collection"))
+        collection = opt_map.string_at("collection");
+
+      if (opt_map.has_key("threads"))
+        threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("chunkSize"))
+        chunk_size = opt_map.uint_at("chunkSize");
+
+      if (chunk_size == 0)
+        throw shcore::Exception::argument_error("The value for 'chunkSize' must be a positive integer");
+
+      if (opt_map.has_key("batchDocs"))
+        batch_docs = opt_map.uint_at("batchDocs");
+
+      if (batch_docs == 0)
+        throw shcore::Exception::argument_error("The value for 'batchDocs' must be a positive integer");
+
+      if (opt_map.has_key("showProgress"))
+        show_progress = opt_map.bool_at("showProgress");
+    }
+
+    auto session = _shell_core->get_dev_session();
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    if (!std::dynamic_pointer_cast<mysqlsh::mysqlx::BaseSession>(session))
+      throw shcore::Exception::logic_error("An X session is required to perform this operation.");
+
+    if (schema.empty())
+      schema = session->get_default_schema();
+
+    if (schema.empty())
+      throw shcore::Exception::argument_error("There is no active schema, the target schema must be specified with the 'schema' option");
+
+    if (collection.empty()) {
+      // The file name without directory nor extension
+      size_t start = path.find_last_of("/\\");
+      collection = path.substr(start == std::string::npos ? 0 : start + 1);
+      collection = collection.substr(0, collection.find('.'));
+    }
+
+    std::unique_ptr<shcore::Mapped_file> file;
+    std::vector<std::pair<size_t, size_t> > chunks;
+    try {
+      file.reset(new shcore::Mapped_file(path));
+      chunks = shcore::split_json_documents(file->data(), file->size(), static_cast<size_t>(chunk_size));
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+
+    const char *data = file->data();
+    size_t size = file->size();
+
+    std::atomic<size_t> next_chunk(0);
+    std::atomic<uint64_t> documents(0);
+    std::atomic<uint64_t> bytes(0);
+    std::atomic<int> running(threads);
+    std::mutex errors_mutex;
+    shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+    auto add_error = [&](const std::string &message) {
+      std::lock_guard<std::mutex> lock(errors_mutex);
+      errors->push_back(shcore::Value(message));
+    };
+
+    shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(session->uri(), false);
+    (*connection_data)[shcore::kDbPassword] = shcore::Value(session->get_password());
+    if (!session->get_ssl_ca().empty())
+      (*connection_data)[shcore::kSslCa] = shcore::Value(session->get_ssl_ca());
+    if (!session->get_ssl_cert().empty())
+      (*connection_data)[shcore::kSslCert] = shcore::Value(session->get_ssl_cert());
+    if (!session->get_ssl_key().empty())
+      (*connection_data)[shcore::kSslKey] = shcore::Value(session->get_ssl_key());
+
+    // The batches start with batchDocs documents and are sized as the
+    // server answers them, all the workers share the control
+    ::mysqlx::Batch_limits batch_limits;
+    batch_limits.max_rows = std::max(batch_limits.max_rows, static_cast<size_t>(batch_docs));
+    ::mysqlx::Batch_control batch_control(static_cast<size_t>(batch_docs), IMPORT_JSON_DEFAULT_PIPELINE_DEPTH,
+                                          batch_limits);
+
+    // Every worker opens its own connection first, as the connection data
+    // is only read from the global session here
+    std::vector<std::function<void()> > workers;
+    for (int index = 0; index < threads; index++) {
+      shcore::Argument_list session_args;
+      session_args.push_back(shcore::Value(connection_data));
+      auto target = std::dynamic_pointer_cast<mysqlsh::mysqlx::BaseSession>(
+          mysqlsh::connect_session(session_args, SessionType::Node));
+
+      workers.push_back([&, target]() {
+        auto x_collection = target->session_obj()->getSchema(schema)->getCollection(collection);
+        Uuid_block uuids;
+        std::string with_id;
+
+        size_t current;
+        while ((current = next_chunk++) < chunks.size()) {
+          try {
+            // The documents are copied only to add a missing _id, as the
+            // first member of the object
+            ::mysqlx::AddStatement statement(x_collection);
+            shcore::Json_document_reader reader(data + chunks[current].first, chunks[current].second);
+            const char *document;
+            size_t length;
+            bool has_id;
+            uint64_t count = 0;
+            while (reader.next(&document, &length, &has_id)) {
+              count++;
+              if (*document != '{')
+                throw std::runtime_error("Document #" + std::to_string(count) + " is not a JSON object");
+
+              if (has_id) {
+                statement.addJson(document, length);
+              } else {
+                with_id.assign("{\"_id\":\"").append(uuids.next_hex()).append("\"");
+                size_t member = 1;
+                while (member < length && isspace(static_cast<unsigned char>(document[member])))
+                  member++;
+                if (member < length && document[member] != '}')
+                  with_id.append(",");
+                with_id.append(document + 1, length - 1);
+                statement.addJson(with_id.data(), with_id.size());
+              }
+            }
+
+            auto result = statement.execute(batch_control);
+            documents += result->affectedRows();
+            bytes += chunks[current].second;
+          } catch (::mysqlx::Error &e) {
+            add_error("Chunk #" + std::to_string(current + 1) + ": " + e.what());
+          } catch (std::exception &e) {
+            add_error("Chunk #" + std::to_string(current + 1) + ": " + e.what());
+          }
+        }
+
+        target->close(shcore::Argument_list());
+      });
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> worker_threads;
+    for (auto &worker : workers) {
+      worker_threads.push_back(std::thread([&running, worker]() {
+        worker();
+        running--;
+      }));
+    }
+
+    // Progress is printed from this thread, the workers never print
+    auto last_print = start_time;
+    while (running > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+      auto now = std::chrono::steady_clock::now();
+      if (show_progress && now - last_print >= std::chrono::seconds(1)) {
+        double elapsed = std::chrono::duration<double>(now - start_time).count();
+        char line[128];
+        snprintf(line, sizeof(line), "%.1f%% (%.2f MB / %.2f MB), %.2f MB/s, %.0f documents/s",
+                 size ? 100.0 * bytes / size : 100.0, bytes / 1048576.0, size / 1048576.0,
+                 bytes / 1048576.0 / elapsed, documents / elapsed);
+        _shell_core->print(std::string(line) + ", " + batch_control.describe() + "\n");
+        last_print = now;
+      }
+    }
+
+    for (auto &worker : worker_threads)
+      worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    (*ret_val)["documents"] = shcore::Value(static_cast<uint64_t>(documents));
+    (*ret_val)["bytes"] = shcore::Value(static_cast<uint64_t>(bytes));
+    (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunks.size()));
+    (*ret_val)["seconds"] = shcore::Value(seconds);
+    (*ret_val)["errors"] = shcore::Value(errors);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("importJson"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_DUMPSCHEMAS_BRIEF, "Dumps the data and definitions of schemas into a directory using several sessions in parallel.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_PARAM, "@param schemas The list of schemas to be dumped.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_PARAM1, "@param outDir The directory where the files are written, created if it does not exist.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_PARAM2, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_RETURN, "@return A dictionary with the number of dumped rows and the errors found.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL, "This function opens additional sessions using the connection data of the global session, "\
+"all of them start a transaction with a consistent snapshot while a global read lock is held, so the dump is consistent. "\
+"The lock is released as soon as the transactions are started.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL1, "Tables with an integer primary key are split in chunks on ranges of the key, "\
+"the chunks are written by the sessions in parallel as TSV files that can be loaded with LOAD DATA INFILE or importTable "\
+"using the tsv dialect. The definition of every schema and table is written to a SQL file and the @.json manifest "\
+"describes the columns and the chunk files of every table.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL2, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL3, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL4, "@li chunkRows: the approximate number of rows on each chunk, by default 500000.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL5, "@li compression: none or gzip, by default gzip when the shell is built with zlib.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL6, "@li format: tsv or parquet, by default tsv. Parquet chunks have a typed column for "\
+"every column of the table, dictionary encoded when it has few distinct values, and the compression is applied to "\
+"their pages. Parquet dumps can not be loaded with loadDump.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL7, "@li rowGroupRows: the number of rows on each row group of the Parquet files, by default 100000.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL8, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL9, "@li tables: the number of dumped tables.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL10, "@li chunks: the number of chunk files.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL11, "@li rows: the number of dumped rows.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL12, "@li bytes: the size of the data before compression.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL13, "@li seconds: the time the dump took.");
+REGISTER_HELP(SHELL_DUMPSCHEMAS_DETAIL14, "@li errors: a list with the error messages of the failed chunks.");
+
+/**
+ * $(SHELL_DUMPSCHEMAS_BRIEF)
+ *
+ * $(SHELL_DUMPSCHEMAS_PARAM)
+ * $(SHELL_DUMPSCHEMAS_PARAM1)
+ * $(SHELL_DUMPSCHEMAS_PARAM2)
+ *
+ * $(SHELL_DUMPSCHEMAS_RETURN)
+ *
+ * $(SHELL_DUMPSCHEMAS_DETAIL)
+ *
+ * $(SHELL_DUMPSCHEMAS_DETAIL1)
+ *
+ * $(SHELL_DUMPSCHEMAS_DETAIL2)
+ * $(SHELL_DUMPSCHEMAS_DETAIL3)
+ * $(SHELL_DUMPSCHEMAS_DETAIL4)
+ * $(SHELL_DUMPSCHEMAS_DETAIL5)
+ * $(SHELL_DUMPSCHEMAS_DETAIL6)
+ * $(SHELL_DUMPSCHEMAS_DETAIL7)
+ *
+ * $(SHELL_DUMPSCHEMAS_DETAIL8)
+ * $(SHELL_DUMPSCHEMAS_DETAIL9)
+ * $(SHELL_DUMPSCHEMAS_DETAIL10)
+ * $(SHELL_DUMPSCHEMAS_DETAIL11)
+ * $(SHELL_DUMPSCHEMAS_DETAIL12)
+ * $(SHELL_DUMPSCHEMAS_DETAIL13)
+ * $(SHELL_DUMPSCHEMAS_DETAIL14)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::dumpSchemas(List schemas, String outDir, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::dump_schemas(list schemas, str outDir, dict options){}
+#endif
+shcore::Value Shell::dump_schemas(const shcore::Argument_list &args) {
+  args.ensure_count(2, 3, get_function_name("dumpSchemas").c_str());
+
+  shcore::Value::Map_type_ref ret_val;
+
+  try {
+    dump::Dump_options options;
+    options.output_dir = args.string_at(1);
+    options.threads = DUMP_SCHEMAS_DEFAULT_THREADS;
+    options.chunk_rows = DUMP_SCHEMAS_DEFAULT_CHUNK_ROWS;
+    options.compression = dump::is_compression_supported("gzip") ? "gzip" : "none";
+    options.format = "tsv";
+    options.row_group_rows = DUMP_SCHEMAS_DEFAULT_ROW_GROUP_ROWS;
+
+    for (auto &schema : *args.array_at(0)) {
+      if (schema.type != shcore::String)
+        throw shcore::Exception::argument_error("The schemas must be a list of strings");
+      options.schemas.push_back(schema.as_string());
+    }
+
+    if (options.schemas.empty())
+      throw shcore::Exception::argument_error("At least one schema must be specified");
+
+    if (args.size() == 3) {
+      shcore::Argument_map opt_map(*args.map_at(2));
+      opt_map.ensure_keys({}, {"threads", "chunkRows", "compression", "format", "rowGroupRows"}, "dumpSchemas options");
+
+      if (opt_map.has_key("threads"))
+        options.threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (options.threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("chunkRows"))
+        options.chunk_rows = opt_map.uint_at("chunkRows");
+
+      if (options.chunk_rows == 0)
+        throw shcore::Exception::argument_error("The value for 'chunkRows' must be a positive integer");
+
+      if (opt_map.has_key("compression"))
+        options.compression = opt_map.string_at("compression");
+
+      if (!dump::is_compression_supported(options.compression))
+        throw shcore::Exception::argument_error("The compression '" + options.compression + "' is not supported");
+
+      if (opt_map.has_key("format"))
+        options.format = opt_map.string_at("format");
+
+      if (options.format != "tsv" && options.format != "parquet")
+        throw shcore::Exception::argument_error("The format '" + options.format + "' is not supported");
+
+      if (opt_map.has_key("rowGroupRows"))
+        options.row_group_rows = opt_map.uint_at("rowGroupRows");
+
+      if (options.row_group_rows == 0)
+        throw shcore::Exception::argument_error("The value for 'rowGroupRows' must be a positive integer");
+    }
+
+    auto session = _shell_core->get_dev_session();
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    try {
+      ret_val = dump::dump_schemas(session, options);
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("dumpSchemas"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_LOADDUMP_BRIEF, "Loads a directory written by dumpSchemas using several sessions in parallel.");
+REGISTER_HELP(SHELL_LOADDUMP_PARAM, "@param dir The directory with the dump.");
+REGISTER_HELP(SHELL_LOADDUMP_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_LOADDUMP_RETURN, "@return A dictionary with the number of loaded rows and the errors found.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL, "This function creates the schemas and tables described on the manifest of the dump and "\
+"loads their chunk files on additional sessions opened using the connection data of the global session. The chunks of "\
+"the biggest tables are loaded first, each session taking the next pending chunk once it is done with the previous one.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL1, "Every loaded chunk is recorded on a progress file, an interrupted load can be resumed "\
+"with the resume option to load only the chunks missing.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL2, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL3, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL4, "@li resume: whether the load continues the one recorded on the progress file, by default false.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL5, "@li deferIndexes: whether the secondary indexes are created once the data of the table is "\
+"loaded, by default true. The indexes of tables with foreign keys are always created with the table.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL6, "@li progressFile: the path of the progress file, by default load-progress.txt on the dump directory.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL7, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL8, "@li tables: the number of tables on the dump.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL9, "@li chunks: the number of loaded chunks.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL10, "@li skippedChunks: the number of chunks loaded by a previous load.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL11, "@li rows: the number of loaded rows.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL12, "@li seconds: the time the load took.");
+REGISTER_HELP(SHELL_LOADDUMP_DETAIL13, "@li errors: a list with the error messages of the failed chunks.");
+
+/**
+ * $(SHELL_LOADDUMP_BRIEF)
+ *
+ * $(SHELL_LOADDUMP_PARAM)
+ * $(SHELL_LOADDUMP_PARAM1)
+ *
+ * $(SHELL_LOADDUMP_RETURN)
+ *
+ * $(SHELL_LOADDUMP_DETAIL)
+ *
+ * $(SHELL_LOADDUMP_DETAIL1)
+ *
+ * $(SHELL_LOADDUMP_DETAIL2)
+ * $(SHELL_LOADDUMP_DETAIL3)
+ * $(SHELL_LOADDUMP_DETAIL4)
+ * $(SHELL_LOADDUMP_DETAIL5)
+ * $(SHELL_LOADDUMP_DETAIL6)
+ *
+ * $(SHELL_LOADDUMP_DETAIL7)
+ * $(SHELL_LOADDUMP_DETAIL8)
+ * $(SHELL_LOADDUMP_DETAIL9)
+ * $(SHELL_LOADDUMP_DETAIL10)
+ * $(SHELL_LOADDUMP_DETAIL11)
+ * $(SHELL_LOADDUMP_DETAIL12)
+ * $(SHELL_LOADDUMP_DETAIL13)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::loadDump(String dir, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::load_dump(str dir, dict options){}
+#endif
+shcore::Value Shell::load_dump(const shcore::Argument_list &args) {
+  args.ensure_count(1, 2, get_function_name("loadDump").c_str());
+
+  shcore::Value::Map_type_ref ret_val;
+
+  try {
+    dump::Load_options options;
+    options.input_dir = args.string_at(0);
+    options.threads = LOAD_DUMP_DEFAULT_THREADS;
+    options.resume = false;
+    options.defer_indexes = true;
+
+    if (args.size() == 2) {
+      shcore::Argument_map opt_map(*args.map_at(1));
+      opt_map.ensure_keys({}, {"threads", "resume", "deferIndexes", "progressFile"}, "loadDump options");
+
+      if (opt_map.has_key("threads"))
+        options.threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (options.threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("resume"))
+        options.resume = opt_map.bool_at("resume");
+
+      if (opt_map.has_key("deferIndexes"))
+        options.defer_indexes = opt_map.bool_at("deferIndexes");
+
+      if (opt_map.has_key("progressFile"))
+        options.progress_file = opt_map.string_at("progressFile");
+    }
+
+#ifdef WIN32
+    if (options.progress_file.empty())
+      options.progress_file = options.input_dir + "\\load-progress.txt";
+#else
+    if (options.progress_file.empty())
+      options.progress_file = options.input_dir + "/load-progress.txt";
+#endif
+
+    auto session = _shell_core->get_dev_session();
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error("An open session is required to perform this operation.");
+
+    try {
+      ret_val = dump::load_dump(session, options);
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("loadDump"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_STATS_BRIEF, "Returns latency statistics of the SQL statements executed by the shell.");
+REGISTER_HELP(SHELL_STATS_PARAM, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_STATS_RETURN, "@return A dictionary with an entry for every statement digest.");
+REGISTER_HELP(SHELL_STATS_DETAIL, "The statements are grouped by digest: the statement with the literals replaced by ?, "\
+"the comments removed and the whitespace collapsed.");
+REGISTER_HELP(SHELL_STATS_DETAIL1, "Every entry contains the number of executions and a dictionary with the min, mean, max, "\
+"total, p50, p90, p99 and p999 latencies in microseconds for each of the following phases:");
+REGISTER_HELP(SHELL_STATS_DETAIL2, "@li server: from sending the statement until its first response is read.");
+REGISTER_HELP(SHELL_STATS_DETAIL3, "@li network: waiting for the rest of the result to be read.");
+REGISTER_HELP(SHELL_STATS_DETAIL4, "@li decode: converting the rows into shell values.");
+REGISTER_HELP(SHELL_STATS_DETAIL5, "@li format: printing the result.");
+REGISTER_HELP(SHELL_STATS_DETAIL6, "A statement is accounted once its result is released. The options dictionary may contain "\
+"the following attributes:");
+REGISTER_HELP(SHELL_STATS_DETAIL7, "@li reset: if true the statistics are cleared after being returned.");
+
+/**
+ * $(SHELL_STATS_BRIEF)
+ *
+ * $(SHELL_STATS_PARAM)
+ *
+ * $(SHELL_STATS_RETURN)
+ *
+ * $(SHELL_STATS_DETAIL)
+ *
+ * $(SHELL_STATS_DETAIL1)
+ * $(SHELL_STATS_DETAIL2)
+ * $(SHELL_STATS_DETAIL3)
+ * $(SHELL_STATS_DETAIL4)
+ * $(SHELL_STATS_DETAIL5)
+ *
+ * $(SHELL_STATS_DETAIL6)
+ * $(SHELL_STATS_DETAIL7)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::stats(Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::stats(dict options){}
+#endif
+shcore::Value Shell::stats(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  args.ensure_count(0, 1, get_function_name("stats").c_str());
+
+  try {
+    bool reset = false;
+    if (args.size() == 1) {
+      shcore::Argument_map options(*args.map_at(0));
+      options.ensure_keys({}, {"reset"}, "stats options");
+
+      if (options.has_key("reset"))
+        reset = options.bool_at("reset");
+    }
+
+    ret_val = shcore::Statement_stats::get().get_stats(reset);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("stats"));
+
+  return ret_val;
+}
+
+REGISTER_HELP(SHELL_MEMORYSTATS_BRIEF, "Returns the memory used by the shell and its memory budget.");
+REGISTER_HELP(SHELL_MEMORYSTATS_RETURN, "@return A dictionary with the memory usage in bytes.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL, "The memoryBudget option limits the memory the following subsystems may use "\
+"together, in megabytes. Rows of buffered results that do not fit are kept on a temporary file, anything else "\
+"going past it fails with an error.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL1, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL2, "@li limit: the memory budget, 0 if there is no limit.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL3, "@li used: the memory used by the subsystems below.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL4, "@li peak: the highest memory used by them so far.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL5, "@li results: the rows of buffered results kept in memory.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL6, "@li values: the rows being returned by fetchAll().");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL7, "@li javascript: the JavaScript heap, as of the last garbage collection.");
+REGISTER_HELP(SHELL_MEMORYSTATS_DETAIL8, "@li resident: the resident memory of the whole process, which includes the "\
+"Python heap and the client libraries, 0 if it is unknown.");
+
+/**
+ * $(SHELL_MEMORYSTATS_BRIEF)
+ *
+ * $(SHELL_MEMORYSTATS_RETURN)
+ *
+ * $(SHELL_MEMORYSTATS_DETAIL)
+ *
+ * $(SHELL_MEMORYSTATS_DETAIL1)
+ * $(SHELL_MEMORYSTATS_DETAIL2)
+ * $(SHELL_MEMORYSTATS_DETAIL3)
+ * $(SHELL_MEMORYSTATS_DETAIL4)
+ * $(SHELL_MEMORYSTATS_DETAIL5)
+ * $(SHELL_MEMORYSTATS_DETAIL6)
+ * $(SHELL_MEMORYSTATS_DETAIL7)
+ * $(SHELL_MEMORYSTATS_DETAIL8)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::memoryStats(){}
+#elif DOXYGEN_PY
+dict Shell::memory_stats(){}
+#endif
+shcore::Value Shell::memory_stats(const shcore::Argument_list &args) {
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+
+  args.ensure_count(0, get_function_name("memoryStats").c_str());
+
+  shcore::Memory_budget &budget = shcore::Memory_budget::get();
+  (*ret_val)["limit"] = shcore::Value(budget.limit());
+  (*ret_val)["used"] = shcore::Value(budget.used());
+  (*ret_val)["peak"] = shcore::Value(budget.peak());
+  (*ret_val)["results"] = shcore::Value(budget.used(shcore::Memory_budget::Results));
+  (*ret_val)["values"] = shcore::Value(budget.used(shcore::Memory_budget::Values));
+  (*ret_val)["javascript"] = shcore::Value(budget.used(shcore::Memory_budget::JavaScript));
+  (*ret_val)["resident"] = shcore::Value(shcore::resident_memory());
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_PARALLEL_BRIEF, "Runs JavaScript tasks on several worker threads and returns their results.");
+REGISTER_HELP(SHELL_PARALLEL_PARAM, "@param tasks A list with the tasks to be run.");
+REGISTER_HELP(SHELL_PARALLEL_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_PARALLEL_RETURN, "@return A list with the value returned by each task, in the order of the tasks.");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL, "Each task is either the source of a JavaScript function, to be called without "\
+"arguments, or a dictionary with the following attributes:");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL1, "@li function: the source of a JavaScript function, i.e. String(myFunction).");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL2, "@li args: a list with the arguments the function is called with.");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL3, "Every worker has its own JavaScript context, so the functions only see their "\
+"arguments, the print functions and, if the global session is open, a session global with a session of their own "\
+"opened using the connection data of the global session. The arguments and the returned values are copied between "\
+"the contexts, so they must be plain values: strings, numbers, lists and dictionaries.");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL4, "The tasks are run from any scripting mode, always as JavaScript. If any of them fails "\
+"an error listing the failed tasks is raised once all of them ran.");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL5, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_PARALLEL_DETAIL6, "@li workers: the number of worker threads, by default 4.");
+
+/**
+ * $(SHELL_PARALLEL_BRIEF)
+ *
+ * $(SHELL_PARALLEL_PARAM)
+ * $(SHELL_PARALLEL_PARAM1)
+ *
+ * $(SHELL_PARALLEL_RETURN)
+ *
+ * $(SHELL_PARALLEL_DETAIL)
+ * $(SHELL_PARALLEL_DETAIL1)
+ * $(SHELL_PARALLEL_DETAIL2)
+ *
+ * $(SHELL_PARALLEL_DETAIL3)
+ *
+ * $(SHELL_PARALLEL_DETAIL4)
+ *
+ * $(SHELL_PARALLEL_DETAIL5)
+ * $(SHELL_PARALLEL_DETAIL6)
+ */
+#if DOXYGEN_JS
+List Shell::parallel(List tasks, Dictionary options){}
+#elif DOXYGEN_PY
+list Shell::parallel(list tasks, dict options){}
+#endif
+shcore::Value Shell::parallel(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  args.ensure_count(1, 2, get_function_name("parallel").c_str());
+
+  try {
+    int workers = PARALLEL_DEFAULT_WORKERS;
+
+    if (args.size() == 2) {
+      shcore::Argument_map options(*args.map_at(1));
+      options.ensure_keys({}, {"workers"}, "parallel options");
+
+      if (options.has_key("workers"))
+        workers = static_cast<int>(options.int_at("workers"));
+
+      if (workers < 1)
+        throw shcore::Exception::argument_error("The value for 'workers' must be a positive integer");
+    }
+
+    if (!parallel::is_supported())
+      throw shcore::Exception::runtime_error("This build has no JavaScript support to run the tasks");
+
+    std::vector<parallel::Task> tasks;
+    for (auto &item : *args.array_at(0)) {
+      parallel::Task task;
+
+      if (item.type == shcore::String) {
+        task.code = item.as_string();
+      } else if (item.type == shcore::Map) {
+        shcore::Argument_map task_map(*item.as_map());
+        task_map.ensure_keys({"function"}, {"args"}, "parallel task");
+
+        task.code = task_map.string_at("function");
+        if (task_map.has_key("args"))
+          task.args = task_map.array_at("args");
+      } else {
+        throw shcore::Exception::argument_error("Task #" + std::to_string(tasks.size() + 1) +
+                                                " must be a string or a dictionary");
+      }
+
+      tasks.push_back(task);
+    }
+
+    std::shared_ptr<ShellDevelopmentSession> session = _shell_core->get_dev_session();
+    if (session && !session->is_connected())
+      session.reset();
+
+    ret_val = shcore::Value(parallel::run(tasks, workers, session, _shell_core->get_delegate()));
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("parallel"));
+
+  return ret_val;
+}
+
+REGISTER_HELP(SHELL_QUERYALL_BRIEF, "Executes a SQL statement on several instances at once.");
+REGISTER_HELP(SHELL_QUERYALL_PARAM, "@param instances A list with the URIs or connection dictionaries of the instances.");
+REGISTER_HELP(SHELL_QUERYALL_PARAM1, "@param sql The SQL statement to be executed.");
+REGISTER_HELP(SHELL_QUERYALL_PARAM2, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_QUERYALL_RETURN, "@return A list with the result of every instance or a dictionary with the merged results.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL, "The instances are queried through classic sessions taken from the session pool of the "\
+"shell, several of them at once. The instances whose connection data has no password use the one on the options, or "\
+"the one of the global session.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL2, "@li concurrency: the number of instances queried at once, by default 16.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL3, "@li timeout: the seconds to wait on the network of each instance when connecting, "\
+"sending the statement or reading its result, by default 10.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL4, "@li password: the password for the instances that have none.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL5, "@li merge: if true the rows of all the instances are returned together, by default false.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL6, "Without merge, the returned list contains a dictionary for every instance, in the "\
+"order they were given, with the following attributes:");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL7, "@li instance: the instance, as user@host:port.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL8, "@li columns: a list with the column names of the result.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL9, "@li rows: a list with the rows of the result, each one a list of values.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL10, "@li error: the error found on the instance, instead of the columns and rows.");
+REGISTER_HELP(SHELL_QUERYALL_DETAIL11, "With merge, the returned dictionary contains the columns and rows of all the "\
+"instances, with an instance column added first, and an errors list with a dictionary with the instance and the "\
+"error for every instance that failed.");
+
+/**
+ * $(SHELL_QUERYALL_BRIEF)
+ *
+ * $(SHELL_QUERYALL_PARAM)
+ * $(SHELL_QUERYALL_PARAM1)
+ * $(SHELL_QUERYALL_PARAM2)
+ *
+ * $(SHELL_QUERYALL_RETURN)
+ *
+ * $(SHELL_QUERYALL_DETAIL)
+ *
+ * $(SHELL_QUERYALL_DETAIL1)
+ * $(SHELL_QUERYALL_DETAIL2)
+ * $(SHELL_QUERYALL_DETAIL3)
+ * $(SHELL_QUERYALL_DETAIL4)
+ * $(SHELL_QUERYALL_DETAIL5)
+ *
+ * $(SHELL_QUERYALL_DETAIL6)
+ * $(SHELL_QUERYALL_DETAIL7)
+ * $(SHELL_QUERYALL_DETAIL8)
+ * $(SHELL_QUERYALL_DETAIL9)
+ * $(SHELL_QUERYALL_DETAIL10)
+ *
+ * $(SHELL_QUERYALL_DETAIL11)
+ */
+#if DOXYGEN_JS
+List Shell::queryAll(List instances, String sql, Dictionary options){}
+#elif DOXYGEN_PY
+list Shell::query_all(list instances, str sql, dict options){}
+#endif
+shcore::Value Shell::query_all(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  args.ensure_count(2, 3, get_function_name("queryAll").c_str());
+
+  try {
+    std::string sql = args.string_at(1);
+    int concurrency = QUERY_ALL_DEFAULT_CONCURRENCY;
+    int64_t timeout = QUERY_ALL_DEFAULT_TIMEOUT;
+    bool merge = false;
+    bool has_password = false;
+    std::string password;
+
+    if (args.size() == 3) {
+      shcore::Argument_map options(*args.map_at(2));
+      options.ensure_keys({}, {"concurrency", "timeout", "password", "merge"}, "queryAll options");
+
+      if (options.has_key("concurrency"))
+        concurrency = static_cast<int>(options.int_at("concurrency"));
+
+      if (concurrency < 1)
+        throw shcore::Exception::argument_error("The value for 'concurrency' must be a positive integer");
+
+      if (options.has_key("timeout"))
+        timeout = options.int_at("timeout");
+
+      if (timeout < 0)
+        throw shcore::Exception::argument_error("The value for 'timeout' must be 0 or a positive integer");
+
+      if (options.has_key("password")) {
+        password = options.string_at("password");
+        has_password = true;
+      }
+
+      if (options.has_key("merge"))
+        merge = options.bool_at("merge");
+    }
+
+    if (!has_password) {
+      auto session = _shell_core->get_dev_session();
+      if (session && session->is_connected()) {
+        password = session->get_password();
+        has_password = true;
+      }
+    }
+
+    // The connection data of every instance, completed with the password and
+    // the timeout
+    std::vector<shcore::Value::Map_type_ref> instances;
+    for (auto &item : *args.array_at(0)) {
+      shcore::Value::Map_type_ref connection_data;
+
+      if (item.type == shcore::String) {
+        connection_data = shcore::get_connection_data(item.as_string(), true);
+      } else if (item.type == shcore::Map) {
+        connection_data.reset(new shcore::Value::Map_type(*item.as_map()));
+        shcore::set_default_connection_data(connection_data);
+      } else {
+        throw shcore::Exception::argument_error("Instance #" + std::to_string(instances.size() + 1) +
+                                                " must be an URI or a connection dictionary");
+      }
+
+      if (has_password && !connection_data->has_key(shcore::kDbPassword) &&
+          !connection_data->has_key(shcore::kPassword))
+        (*connection_data)[shcore::kDbPassword] = shcore::Value(password);
+
+      (*connection_data)[shcore::kTimeout] = shcore::Value(timeout);
+      instances.push_back(connection_data);
+    }
+
+    struct Instance_result {
+      std::string instance;
+      std::vector<std::string> columns;
+      std::vector<shcore::Value::Array_type_ref> rows;
+      std::string error;
+    };
+
+    std::vector<Instance_result> results(instances.size());
+    std::atomic<size_t> next(0);
+
+    auto query = [&]() {
+      size_t current;
+      while ((current = next++) < instances.size()) {
+        Instance_result &result = results[current];
+        result.instance = shcore::build_connection_string(instances[current], false);
+
+        try {
+          shcore::Argument_list session_args;
+          session_args.push_back(shcore::Value(instances[current]));
+
+          auto session = Session_pool::get()->acquire(session_args);
+
+          // A failed statement leaves the session as it was, it goes back to
+          // the pool either way
+          try {
+            auto data = session->connection()->run_sql(sql);
+
+            if (data->has_resultset()) {
+              for (auto &field : data->get_metadata())
+                result.columns.push_back(field.name());
+
+              while (auto row = data->fetch_one()) {
+                shcore::Value::Array_type_ref values(new shcore::Value::Array_type());
+                for (size_t index = 0; index < result.columns.size(); index++)
+                  values->push_back(row->get_value(static_cast<int>(index)));
+                result.rows.push_back(values);
+              }
+            }
+
+            // Any other result of a multi statement is discarded
+            while (data->next_data_set()) {
+            }
+          } catch (...) {
+            Session_pool::get()->release(session);
+            throw;
+          }
+
+          Session_pool::get()->release(session);
+        } catch (std::exception &e) {
+          result.error = e.what();
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (int index = 0; index < concurrency && static_cast<size_t>(index) < instances.size(); index++)
+      workers.push_back(std::thread(query));
+
+    for (auto &worker : workers)
+      worker.join();
+
+    if (merge) {
+      shcore::Value::Map_type_ref merged(new shcore::Value::Map_type());
+      shcore::Value::Array_type_ref columns(new shcore::Value::Array_type());
+      shcore::Value::Array_type_ref rows(new shcore::Value::Array_type());
+      shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+      columns->push_back(shcore::Value("instance"));
+
+      for (auto &result : results) {
+        if (!result.error.empty()) {
+          shcore::Value::Map_type_ref error(new shcore::Value::Map_type());
+          (*error)["instance"] = shcore::Value(result.instance);
+          (*error)["error"] = shcore::Value(result.error);
+          errors->push_back(shcore::Value(error));
+          continue;
+        }
+
+        // The columns are taken from the first instance with a result
+        if (columns->size() == 1) {
+          for (auto &column : result.columns)
+            columns->push_back(shcore::Value(column));
+        }
+
+        for (auto &row : result.rows) {
+          row->insert(row->begin(), shcore::Value(result.instance));
+          rows->push_back(shcore::Value(row));
+        }
+      }
+
+      (*merged)["columns"] = shcore::Value(columns);
+      (*merged)["rows"] = shcore::Value(rows);
+      (*merged)["errors"] = shcore::Value(errors);
+      ret_val = shcore::Value(merged);
+    } else {
+      shcore::Value::Array_type_ref list(new shcore::Value::Array_type());
+
+      for (auto &result : results) {
+        shcore::Value::Map_type_ref entry(new shcore::Value::Map_type());
+        (*entry)["instance"] = shcore::Value(result.instance);
+
+        if (result.error.empty()) {
+          shcore::Value::Array_type_ref columns(new shcore::Value::Array_type());
+          for (auto &column : result.columns)
+            columns->push_back(shcore::Value(column));
+
+          shcore::Value::Array_type_ref rows(new shcore::Value::Array_type());
+          for (auto &row : result.rows)
+            rows->push_back(shcore::Value(row));
+
+          (*entry)["columns"] = shcore::Value(columns);
+          (*entry)["rows"] = shcore::Value(rows);
+        } else {
+          (*entry)["error"] = shcore::Value(result.error);
+        }
+
+        list->push_back(shcore::Value(entry));
+      }
+
+      ret_val = shcore::Value(list);
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("queryAll"));
+
+  return ret_val;
+}
+
+REGISTER_HELP(SHELL_DISTINCT_BRIEF, "Returns the distinct values of a list, such as the rows of a result.");
+REGISTER_HELP(SHELL_DISTINCT_PARAM, "@param values The list of values, i.e. the rows returned by fetchAll().");
+REGISTER_HELP(SHELL_DISTINCT_PARAM1, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_DISTINCT_RETURN, "@return A list with the first value found for every distinct key, in the order they were found.");
+REGISTER_HELP(SHELL_DISTINCT_DETAIL, "The key of a row is the list of its field values, and the key of any other value "\
+"is the value itself. Values are compared as with the == operator and are looked up on a hash table, so the time "\
+"taken grows linearly with the number of values.");
+REGISTER_HELP(SHELL_DISTINCT_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_DISTINCT_DETAIL2, "@li fields: a list with the names of the fields making the key of the rows, or of "\
+"the dictionaries, on the list. By default all the fields of a row, and the whole dictionary.");
+REGISTER_HELP(SHELL_DISTINCT_DETAIL3, "@li count: if true, a dictionary with the key and the number of values with that "\
+"key, as key and count, is returned for every key instead of its first value, by default false.");
+
+/**
+ * $(SHELL_DISTINCT_BRIEF)
+ *
+ * $(SHELL_DISTINCT_PARAM)
+ * $(SHELL_DISTINCT_PARAM1)
+ *
+ * $(SHELL_DISTINCT_RETURN)
+ *
+ * $(SHELL_DISTINCT_DETAIL)
+ *
+ * $(SHELL_DISTINCT_DETAIL1)
+ * $(SHELL_DISTINCT_DETAIL2)
+ * $(SHELL_DISTINCT_DETAIL3)
+ */
+#if DOXYGEN_JS
+List Shell::distinct(List values, Dictionary options){}
+#elif DOXYGEN_PY
+list Shell::distinct(list values, dict options){}
+#endif
+shcore::Value Shell::distinct(const shcore::Argument_list &args) {
+  shcore::Value ret_val;
+
+  args.ensure_count(1, 2, get_function_name("distinct").c_str());
+
+  try {
+    std::vector<std::string> fields;
+    bool count = false;
+    if (args.size() == 2) {
+      shcore::Argument_map options(*args.map_at(1));
+      options.ensure_keys({}, {"fields", "count"}, "distinct options");
+
+      if (options.has_key("fields")) {
+        for (auto &field : *options.array_at("fields"))
+          fields.push_back(field.as_string());
+      }
+      if (options.has_key("count"))
+        count = options.bool_at("count");
+    }
+
+    // Rows never compare equal as objects, their values do
+    auto key_of = [&fields](const shcore::Value &value) {
+      if (value.type == shcore::Object) {
+        auto row = value.as_object<mysqlsh::Row>();
+        if (row) {
+          shcore::Value::Array_type_ref key(new shcore::Value::Array_type());
+          if (fields.empty()) {
+            for (size_t index = 0; index < row->get_length(); index++)
+              key->push_back(row->get_member(index));
+          } else {
+            for (auto &field : fields)
+              key->push_back(row->get_field_(field));
+          }
+          return shcore::Value(key);
+        }
+      } else if (value.type == shcore::Map && !fields.empty()) {
+        auto map = value.as_map();
+        shcore::Value::Array_type_ref key(new shcore::Value::Array_type());
+        for (auto &field : fields) {
+          auto entry = map->find(field);
+          key->push_back(entry == map->end() ? shcore::Value::Null() : entry->second);
+        }
+        return shcore::Value(key);
+      }
+
+      return value;
+    };
+
+    shcore::Value::Array_type_ref values = args.array_at(0);
+    shcore::Value::Array_type_ref distinct(new shcore::Value::Array_type());
+    std::unordered_map<shcore::Value, size_t> found;
+    found.reserve(values->size());
+
+    for (auto &value : *values) {
+      shcore::Value key = key_of(value);
+      auto entry = found.find(key);
+      if (entry == found.end()) {
+        found.emplace(key, distinct->size());
+        if (count) {
+          shcore::Value group = shcore::Value::new_map();
+          (*group.as_map())["key"] = key;
+          (*group.as_map())["count"] = shcore::Value(1);
+          distinct->push_back(group);
+        } else {
+          distinct->push_back(value);
+        }
+      } else if (count) {
+        shcore::Value &counter = (*(*distinct)[entry->second].as_map())["count"];
+        counter = shcore::Value(counter.as_int() + 1);
+      }
+    }
+
+    ret_val = shcore::Value(distinct);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("distinct"));
+
+  return ret_val;
+}
+
+namespace {
+// The connection data of an instance given as an URI or a dictionary, with
+// the password of the global session when it has none
+shcore::Value::Map_type_ref instance_connection_data(const shcore::Value &item, const std::string &label,
+                                                     std::shared_ptr<ShellDevelopmentSession> session) {
+  shcore::Value::Map_type_ref connection_data;
+
+  if (item.type == shcore::String) {
+    connection_data = shcore::get_connection_data(item.as_string(), true);
+  } else if (item.type == shcore::Map) {
+    connection_data.reset(new shcore::Value::Map_type(*item.as_map()));
+    shcore::set_default_connection_data(connection_data);
+  } else {
+    throw shcore::Exception::argument_error(label + " must be an URI or a connection dictionary");
+  }
+
+  if (session && session->is_connected() && !connection_data->has_key(shcore::kDbPassword) &&
+      !connection_data->has_key(shcore::kPassword))
+    (*connection_data)[shcore::kDbPassword] = shcore::Value(session->get_password());
+
+  return connection_data;
+}
+}
+
+REGISTER_HELP(SHELL_COMPARETABLES_BRIEF, "Compares the tables of an instance with the ones of other instances using several sessions in parallel.");
+REGISTER_HELP(SHELL_COMPARETABLES_PARAM, "@param source The URI or connection dictionary of the instance with the expected data.");
+REGISTER_HELP(SHELL_COMPARETABLES_PARAM1, "@param targets A list with the URIs or connection dictionaries of the instances to be checked.");
+REGISTER_HELP(SHELL_COMPARETABLES_PARAM2, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_COMPARETABLES_RETURN, "@return A dictionary with the differences and the errors found.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL, "Tables with an integer primary key are split in chunks on ranges of the key, "\
+"the checksum of every chunk is computed on all the instances at once through classic sessions taken from the "\
+"session pool of the shell. Only the chunks with a different checksum are split again, down to ranges of at most "\
+"1000 keys whose rows are compared one by one. The rest of the tables are compared as a whole. The instances whose "\
+"connection data has no password use the one of the global session.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL2, "@li tables: a list with the tables to be compared, as schema.table, or "\
+"schemas to compare all their tables. By default all the schemas of the source but the system ones.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL3, "@li threads: the number of sessions to be used, by default 4.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL4, "@li chunkRows: the approximate number of rows on each chunk, by default 100000.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL5, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL6, "@li tables: the number of compared tables.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL7, "@li chunks: the number of chunks the tables were split in.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL8, "@li differentChunks: the number of chunks different on some target.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL9, "@li differences: a list with a dictionary for every table different on a "\
+"target, with the table, the instance and the lists of keys missing on the target, found only on the target and "\
+"with different rows (at most 100 of each), or the sourceRows and targetRows for the tables compared as a whole.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL10, "@li seconds: the time the comparison took.");
+REGISTER_HELP(SHELL_COMPARETABLES_DETAIL11, "@li errors: a list with the error messages of the failed chunks.");
+
+/**
+ * $(SHELL_COMPARETABLES_BRIEF)
+ *
+ * $(SHELL_COMPARETABLES_PARAM)
+ * $(SHELL_COMPARETABLES_PARAM1)
+ * $(SHELL_COMPARETABLES_PARAM2)
+ *
+ * $(SHELL_COMPARETABLES_RETURN)
+ *
+ * $(SHELL_COMPARETABLES_DETAIL)
+ *
+ * $(SHELL_COMPARETABLES_DETAIL1)
+ * $(SHELL_COMPARETABLES_DETAIL2)
+ * $(SHELL_COMPARETABLES_DETAIL3)
+ * $(SHELL_COMPARETABLES_DETAIL4)
+ *
+ * $(SHELL_COMPARETABLES_DETAIL5)
+ * $(SHELL_COMPARETABLES_DETAIL6)
+ * $(SHELL_COMPARETABLES_DETAIL7)
+ * $(SHELL_COMPARETABLES_DETAIL8)
+ * $(SHELL_COMPARETABLES_DETAIL9)
+ * $(SHELL_COMPARETABLES_DETAIL10)
+ * $(SHELL_COMPARETABLES_DETAIL11)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::compareTables(ConnectionData source, List targets, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::compare_tables(ConnectionData source, list targets, dict options){}
+#endif
+shcore::Value Shell::compare_tables(const shcore::Argument_list &args) {
+  args.ensure_count(2, 3, get_function_name("compareTables").c_str());
+
+  shcore::Value::Map_type_ref ret_val;
+
+  try {
+    compare::Compare_options options;
+    options.threads = COMPARE_TABLES_DEFAULT_THREADS;
+    options.chunk_rows = COMPARE_TABLES_DEFAULT_CHUNK_ROWS;
+
+    if (args.size() == 3) {
+      shcore::Argument_map opt_map(*args.map_at(2));
+      opt_map.ensure_keys({}, {"tables", "threads", "chunkRows"}, "compareTables options");
+
+      if (opt_map.has_key("tables")) {
+        for (auto &table : *opt_map.array_at("tables")) {
+          if (table.type != shcore::String)
+            throw shcore::Exception::argument_error("The tables must be a list of strings");
+          options.tables.push_back(table.as_string());
+        }
+      }
+
+      if (opt_map.has_key("threads"))
+        options.threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (options.threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("chunkRows"))
+        options.chunk_rows = opt_map.uint_at("chunkRows");
+
+      if (options.chunk_rows == 0)
+        throw shcore::Exception::argument_error("The value for 'chunkRows' must be a positive integer");
+    }
+
+    // The source goes first, followed by the targets
+    auto session = _shell_core->get_dev_session();
+    std::vector<shcore::Value::Map_type_ref> instances;
+    instances.push_back(instance_connection_data(args[0], "The source", session));
+
+    for (auto &target : *args.array_at(1))
+      instances.push_back(instance_connection_data(target, "Target #" + std::to_string(instances.size()), session));
+
+    if (instances.size() < 2)
+      throw shcore::Exception::argument_error("At least one target instance must be specified");
+
+    try {
+      ret_val = compare::compare_tables(instances, options);
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("compareTables"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_COPYTABLES_BRIEF, "Copies tables from an instance to another using several sessions in parallel, with no intermediate files.");
+REGISTER_HELP(SHELL_COPYTABLES_PARAM, "@param source The URI or connection dictionary of the instance the tables are read from.");
+REGISTER_HELP(SHELL_COPYTABLES_PARAM1, "@param target The URI or connection dictionary of the instance the tables are copied to.");
+REGISTER_HELP(SHELL_COPYTABLES_PARAM2, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_COPYTABLES_RETURN, "@return A dictionary with the number of copied rows and the errors found.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL, "The schemas and tables are created on the target, which must not have the tables yet. "\
+"Tables with an integer primary key are split in chunks on ranges of the key as done by dumpSchemas, the chunks are "\
+"read by several sessions to the source reading the same consistent snapshot and their rows are loaded by as many "\
+"sessions to the target as they are read. Only a few blocks of rows are held in memory, the readers wait for the "\
+"target when it falls behind. The instances whose connection data has no password use the one of the global session.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL1, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL2, "@li tables: a list with the tables to be copied, as schema.table, or "\
+"schemas to copy all their tables. By default all the schemas of the source but the system ones.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL3, "@li threads: the number of sessions to be used on each instance, by default 4.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL4, "@li chunkRows: the approximate number of rows on each chunk, by default 500000.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL5, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL6, "@li tables: the number of copied tables.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL7, "@li chunks: the number of chunks the tables were split in.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL8, "@li rows: the number of rows loaded on the target.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL9, "@li bytes: the size of the copied data.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL10, "@li seconds: the time the copy took.");
+REGISTER_HELP(SHELL_COPYTABLES_DETAIL11, "@li errors: a list with the error messages of the failed chunks.");
+
+/**
+ * $(SHELL_COPYTABLES_BRIEF)
+ *
+ * $(SHELL_COPYTABLES_PARAM)
+ * $(SHELL_COPYTABLES_PARAM1)
+ * $(SHELL_COPYTABLES_PARAM2)
+ *
+ * $(SHELL_COPYTABLES_RETURN)
+ *
+ * $(SHELL_COPYTABLES_DETAIL)
+ *
+ * $(SHELL_COPYTABLES_DETAIL1)
+ * $(SHELL_COPYTABLES_DETAIL2)
+ * $(SHELL_COPYTABLES_DETAIL3)
+ * $(SHELL_COPYTABLES_DETAIL4)
+ *
+ * $(SHELL_COPYTABLES_DETAIL5)
+ * $(SHELL_COPYTABLES_DETAIL6)
+ * $(SHELL_COPYTABLES_DETAIL7)
+ * $(SHELL_COPYTABLES_DETAIL8)
+ * $(SHELL_COPYTABLES_DETAIL9)
+ * $(SHELL_COPYTABLES_DETAIL10)
+ * $(SHELL_COPYTABLES_DETAIL11)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::copyTables(ConnectionData source, ConnectionData target, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::copy_tables(ConnectionData source, ConnectionData target, dict options){}
+#endif
+shcore::Value Shell::copy_tables(const shcore::Argument_list &args) {
+  args.ensure_count(2, 3, get_function_name("copyTables").c_str());
+
+  shcore::Value::Map_type_ref ret_val;
+
+  try {
+    dump::Copy_options options;
+    options.threads = COPY_TABLES_DEFAULT_THREADS;
+    options.chunk_rows = COPY_TABLES_DEFAULT_CHUNK_ROWS;
+
+    if (args.size() == 3)
+      dump::parse_copy_options(*args.map_at(2), options);
+
+    auto session = _shell_core->get_dev_session();
+    shcore::Argument_list source_args;
+    source_args.push_back(shcore::Value(instance_connection_data(args[0], "The source", session)));
+    shcore::Argument_list target_args;
+    target_args.push_back(shcore::Value(instance_connection_data(args[1], "The target", session)));
+
+    // The sessions of the pool give the connection data of the ones doing
+    // the copy
+    auto source = Session_pool::get()->acquire(source_args);
+    std::shared_ptr<mysql::ClassicSession> target;
+
+    try {
+      target = Session_pool::get()->acquire(target_args);
+      ret_val = dump::copy_tables(source, target, options);
+    } catch (std::runtime_error &e) {
+      Session_pool::get()->release(source);
+      if (target)
+        Session_pool::get()->release(target);
+      throw shcore::Exception::runtime_error(e.what());
+    }
+
+    Session_pool::get()->release(source);
+    Session_pool::get()->release(target);
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("copyTables"));
+
+  return shcore::Value(ret_val);
+}
+
+REGISTER_HELP(SHELL_PARALLELSCAN_BRIEF, "Reads a table using several sessions in parallel, calling a JavaScript function with every batch of rows.");
+REGISTER_HELP(SHELL_PARALLELSCAN_PARAM, "@param table The table to be read, as schema.table.");
+REGISTER_HELP(SHELL_PARALLELSCAN_PARAM1, "@param function The source of the JavaScript function called with every batch, i.e. String(myFunction).");
+REGISTER_HELP(SHELL_PARALLELSCAN_PARAM2, "@param options Optional dictionary with attributes that change the function behavior.");
+REGISTER_HELP(SHELL_PARALLELSCAN_RETURN, "@return A dictionary with the number of rows read, the combined result and the errors found.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL, "The table is split on its partitions and, when its primary key is a single integer "\
+"column, on ranges of the key of about chunkRows rows. The chunks are read by worker threads, each with its own "\
+"JavaScript context as the tasks of parallel, which call the function with lists of at most chunkRows rows, every row "\
+"a dictionary with the values of its columns. Every worker has also a session global, a classic session of its own "\
+"the function can use to write its changes.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL1, "The values returned by the function are combined by the reducer, if given, in no "\
+"particular order: every worker combines the results of its batches and the last one finishing combines the ones of "\
+"all the workers. Like the arguments, they must be plain values.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL2, "The options dictionary may contain the following attributes:");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL3, "@li threads: the number of worker threads, by default 4.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL4, "@li chunkRows: the approximate number of rows on each chunk and the most on "\
+"each batch, by default 1000.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL5, "@li where: a condition the rows given to the function must meet.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL6, "@li reduce: the source of a JavaScript function combining two results into one.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL7, "@li instance: the URI or connection dictionary of the instance, by default the "\
+"one of the global session, which must be a classic session then.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL8, "The returned dictionary contains the following attributes:");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL9, "@li chunks: the number of chunks the table was split in.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL10, "@li batches: the number of times the function was called.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL11, "@li rows: the number of rows given to the function.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL12, "@li seconds: the time the scan took.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL13, "@li result: the combined result, only with a reducer.");
+REGISTER_HELP(SHELL_PARALLELSCAN_DETAIL14, "@li errors: a list with the error messages of the failed chunks, the scan "\
+"stops after 100 of them.");
+
+/**
+ * $(SHELL_PARALLELSCAN_BRIEF)
+ *
+ * $(SHELL_PARALLELSCAN_PARAM)
+ * $(SHELL_PARALLELSCAN_PARAM1)
+ * $(SHELL_PARALLELSCAN_PARAM2)
+ *
+ * $(SHELL_PARALLELSCAN_RETURN)
+ *
+ * $(SHELL_PARALLELSCAN_DETAIL)
+ *
+ * $(SHELL_PARALLELSCAN_DETAIL1)
+ *
+ * $(SHELL_PARALLELSCAN_DETAIL2)
+ * $(SHELL_PARALLELSCAN_DETAIL3)
+ * $(SHELL_PARALLELSCAN_DETAIL4)
+ * $(SHELL_PARALLELSCAN_DETAIL5)
+ * $(SHELL_PARALLELSCAN_DETAIL6)
+ * $(SHELL_PARALLELSCAN_DETAIL7)
+ *
+ * $(SHELL_PARALLELSCAN_DETAIL8)
+ * $(SHELL_PARALLELSCAN_DETAIL9)
+ * $(SHELL_PARALLELSCAN_DETAIL10)
+ * $(SHELL_PARALLELSCAN_DETAIL11)
+ * $(SHELL_PARALLELSCAN_DETAIL12)
+ * $(SHELL_PARALLELSCAN_DETAIL13)
+ * $(SHELL_PARALLELSCAN_DETAIL14)
+ */
+#if DOXYGEN_JS
+Dictionary Shell::parallelScan(String table, String function, Dictionary options){}
+#elif DOXYGEN_PY
+dict Shell::parallel_scan(str table, str function, dict options){}
+#endif
+shcore::Value Shell::parallel_scan(const shcore::Argument_list &args) {
+  args.ensure_count(2, 3, get_function_name("parallelScan").c_str());
+
+  shcore::Value::Map_type_ref ret_val;
+
+  try {
+    parallel::Scan_options options;
+    options.threads = PARALLEL_SCAN_DEFAULT_THREADS;
+    options.chunk_rows = PARALLEL_SCAN_DEFAULT_CHUNK_ROWS;
+
+    std::string table = args.string_at(0);
+    size_t dot = table.find('.');
+    if (dot == std::string::npos || dot == 0 || dot == table.size() - 1)
+      throw shcore::Exception::argument_error("The table must be given as schema.table");
+    options.schema = table.substr(0, dot);
+    options.table = table.substr(dot + 1);
+
+    options.function = args.string_at(1);
+
+    auto session = _shell_core->get_dev_session();
+    shcore::Value::Map_type_ref connection_data;
+
+    if (args.size() == 3) {
+      shcore::Argument_map opt_map(*args.map_at(2));
+      opt_map.ensure_keys({}, {"threads", "chunkRows", "where", "reduce", "instance"}, "parallelScan options");
+
+      if (opt_map.has_key("threads"))
+        options.threads = static_cast<int>(opt_map.int_at("threads"));
+
+      if (options.threads < 1)
+        throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+      if (opt_map.has_key("chunkRows"))
+        options.chunk_rows = opt_map.uint_at("chunkRows");
+
+      if (options.chunk_rows == 0)
+        throw shcore::Exception::argument_error("The value for 'chunkRows' must be a positive integer");
+
+      if (opt_map.has_key("where"))
+        options.where = opt_map.string_at("where");
+
+      if (opt_map.has_key("reduce"))
+        options.reduce = opt_map.string_at("reduce");
+
+      if (opt_map.has_key("instance"))
+        connection_data = instance_connection_data((*args.map_at(2))["instance"], "The instance", session);
+    }
+
+    if (!parallel::is_supported())
+      throw shcore::Exception::runtime_error("This build has no JavaScript support to run the tasks");
+
+    // The workers read through classic sessions of the pool
+    if (!connection_data) {
+      if (!session || !session->is_connected() || !std::dynamic_pointer_cast<mysql::ClassicSession>(session))
+        throw shcore::Exception::argument_error("The instance option is required when the global session "
+                                                "is not an open classic session");
+      connection_data = session_connection_data(session);
+    }
+
+    try {
+      ret_val = parallel::scan(options, connection_data, _shell_core->get_delegate());
+    } catch (std::runtime_error &e) {
+      throw shcore::Exception::runtime_error(e.what());
+    }
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(get_function_name("parallelScan"));
+
+  return shcore::Value(ret_val);
+}
+}
@@ -42,6 +42,19 @@ namespace mysqlsh {
     shcore::Value parse_uri(const shcore::Argument_list &args);
     shcore::Value prompt(const shcore::Argument_list &args);
     shcore::Value connect(const shcore::Argument_list &args);
+    shcore::Value load_sql_parallel(const shcore::Argument_list &args);
+    shcore::Value import_table(const shcore::Argument_list &args);
+    shcore::Value import_json(const shcore::Argument_list &args);
+    shcore::Value dump_schemas(const shcore::Argument_list &args);
+    shcore::Value load_dump(const shcore::Argument_list &args);
+    shcore::Value stats(const shcore::Argument_list &args);
+    shcore::Value memory_stats(const shcore::Argument_list &args);
+    shcore::Value parallel(const shcore::Argument_list &args);
+    shcore::Value query_all(const shcore::Argument_list &args);
+    shcore::Value distinct(const shcore::Argument_list &args);
+    shcore::Value compare_tables(const shcore::Argument_list &args);
+    shcore::Value copy_tables(const shcore::Argument_list &args);
+    shcore::Value parallel_scan(const shcore::Argument_list &args);
 
     #if DOXYGEN_JS
     Dictionary options;
@@ -49,12 +62,34 @@ namespace mysqlsh {
     Dictionary parseUri(String uri);
     String prompt(String message, Dictionary options);
     Undefined connect(ConnectionData connectionData, String password);
+    Dictionary loadSqlParallel(String file, Dictionary options);
+    Dictionary importTable(String file, Dictionary options);
+    Dictionary importJson(String file, Dictionary options);
+    Dictionary dumpSchemas(List schemas, String outDir, Dictionary options);
+    Dictionary loadDump(String dir, Dictionary options);
+    Dictionary stats(Dictionary options);
+    List parallel(List tasks, Dictionary options);
+    List queryAll(List instances, String sql, Dictionary options);
+    Dictionary compareTables(ConnectionData source, List targets, Dictionary options);
+    Dictionary copyTables(ConnectionData source, ConnectionData target, Dictionary options);
+    Dictionary parallelScan(String table, String function, Dictionary options);
     #elif DOXYGEN_PY
     dict options;
     Callback custom_prompt;
     dict parse_uri(str uri);
     str prompt(str message, dict options);
     None connect(ConnectionData connectionData, str password);
+    dict load_sql_parallel(str file, dict options);
+    dict import_table(str file, dict options);
+    dict import_json(str file, dict options);
+    dict dump_schemas(list schemas, str outDir, dict options);
+    dict load_dump(str dir, dict options);
+    dict stats(dict options);
+    list parallel(list tasks, dict options);
+    list query_all(list instances, str sql, dict options);
+    dict compare_tables(ConnectionData source, list targets, dict options);
+    dict copy_tables(ConnectionData source, ConnectionData target, dict options);
+    dict parallel_scan(str table, str function, dict options);
     #endif
 
   protected:
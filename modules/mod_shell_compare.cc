@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/mod_shell_compare.h"
+#include "modules/mod_utils.h"
+#include "modules/mysql_connection.h"
+#include "modules/session_pool.h"
+#include "utils/utils_general.h"
+#include "utils/utils_sqlstring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <thread>
+
+namespace mysqlsh {
+namespace compare {
+namespace {
+// A range with a different checksum spanning at most this many keys has its
+// rows compared one by one, wider ones are split again
+const uint64_t k_row_compare_keys = 1000;
+
+// Parts a range with a different checksum is split in
+const uint64_t k_split_parts = 16;
+
+// Keys listed at most for each kind of difference of a table on a target
+const size_t k_max_listed_keys = 100;
+
+struct Table_info {
+  std::string schema;
+  std::string name;
+  std::string from;          // The quoted schema.table
+  std::string key;           // The quoted primary key column when it is a single integer
+  bool is_unsigned;
+  uint64_t estimated_rows;
+  std::vector<std::string> columns;
+  std::string row_checksum;  // CRC32 of all the values of a row
+};
+
+struct Range {
+  size_t table;
+  bool whole;                // The whole table, it has no integer key or no rows
+  uint64_t first;
+  uint64_t last;
+};
+
+struct Checksum {
+  uint64_t rows;
+  std::string crc;
+};
+
+std::string where(const Table_info &table, const Range &range) {
+  if (range.whole)
+    return "";
+
+  return " WHERE " + table.key + " BETWEEN " + offset_to_key(range.first, table.is_unsigned) + " AND " +
+         offset_to_key(range.last, table.is_unsigned);
+}
+
+std::string describe(const Table_info &table, const Range &range) {
+  return describe_chunk(table.schema, table.name, "", range.whole, offset_to_key(range.first, table.is_unsigned),
+                        offset_to_key(range.last, table.is_unsigned));
+}
+
+typedef std::vector<std::vector<std::string> > Rows;
+
+// Returns the rows of the query as text, NULL values are empty strings
+Rows query(mysql::Connection &connection, const std::string &sql) {
+  Rows rows;
+
+  auto result = connection.run_sql(sql);
+  size_t columns = result->get_metadata().size();
+  while (auto row = result->fetch_one_view()) {
+    std::vector<std::string> values;
+    values.reserve(columns);
+    for (size_t index = 0; index < columns; index++) {
+      size_t length;
+      const char *data = row->get_data(static_cast<int>(index), length);
+      values.push_back(data ? std::string(data, length) : std::string());
+    }
+    rows.push_back(std::move(values));
+  }
+
+  return rows;
+}
+
+// Runs every task on every instance, each thread taking the next pending one
+// on a session of its own to the instance. The sessions come from the pool
+// and go back to it once all the tasks are done. The errors are returned by
+// task and instance, empty for the tasks that succeeded.
+void run_tasks(const std::vector<shcore::Value::Map_type_ref> &instances, int threads, size_t count,
+               const std::function<void(mysql::Connection &, size_t, size_t)> &task,
+               std::vector<std::string> &failures) {
+  size_t total = count * instances.size();
+  failures.assign(total, std::string());
+
+  // The tasks of a range on every instance are consecutive, so all the
+  // instances read the same range at about the same time
+  std::atomic<size_t> next(0);
+
+  auto work = [&]() {
+    std::vector<std::shared_ptr<mysql::ClassicSession> > sessions(instances.size());
+    // An instance the thread could not connect to is not tried again
+    std::vector<std::string> unreachable(instances.size());
+
+    size_t current;
+    while ((current = next++) < total) {
+      size_t instance = current % instances.size();
+      if (!unreachable[instance].empty()) {
+        failures[current] = unreachable[instance];
+        continue;
+      }
+
+      try {
+        if (!sessions[instance]) {
+          shcore::Argument_list args;
+          args.push_back(shcore::Value(instances[instance]));
+          try {
+            sessions[instance] = Session_pool::get()->acquire(args);
+          } catch (std::exception &e) {
+            unreachable[instance] = e.what();
+            throw;
+          }
+        }
+
+        task(*sessions[instance]->connection(), current / instances.size(), instance);
+      } catch (std::exception &e) {
+        failures[current] = e.what();
+      }
+    }
+
+    for (auto &session : sessions) {
+      if (session)
+        Session_pool::get()->release(session);
+    }
+
+    mysql_thread_end();
+  };
+
+  std::vector<std::thread> workers;
+  for (int index = 0; index < threads && static_cast<size_t>(index) < total; index++)
+    workers.push_back(std::thread(work));
+
+  for (auto &worker : workers)
+    worker.join();
+}
+
+// Lists the base tables of the source matching the given names, with their
+// columns and primary key
+std::vector<Table_info> list_tables(mysql::Connection &connection, const std::vector<std::string> &names) {
+  auto rows = query(connection,
+      "SELECT c.TABLE_SCHEMA, c.TABLE_NAME, c.COLUMN_NAME, c.DATA_TYPE, c.COLUMN_TYPE, c.COLUMN_KEY, t.TABLE_ROWS "
+      "FROM information_schema.COLUMNS c JOIN information_schema.TABLES t "
+      "ON t.TABLE_SCHEMA = c.TABLE_SCHEMA AND t.TABLE_NAME = c.TABLE_NAME "
+      "WHERE t.TABLE_TYPE = 'BASE TABLE' AND " + table_filter(names, "c.") + " "
+      "ORDER BY c.TABLE_SCHEMA, c.TABLE_NAME, c.ORDINAL_POSITION");
+
+  static const std::vector<std::string> integer_types = {"tinyint", "smallint", "mediumint", "int", "bigint"};
+
+  std::vector<Table_info> tables;
+  std::vector<size_t> key_columns;
+  for (auto &row : rows) {
+    if (tables.empty() || tables.back().schema != row[0] || tables.back().name != row[1]) {
+      Table_info table;
+      table.schema = row[0];
+      table.name = row[1];
+      table.from = shcore::sqlstring("!.!", 0) << row[0] << row[1];
+      table.is_unsigned = false;
+      // The estimate of the statistics, exact counts would scan every table
+      table.estimated_rows = row[6].empty() ? 0 : std::stoull(row[6]);
+      tables.push_back(table);
+      key_columns.push_back(0);
+    }
+
+    Table_info &table = tables.back();
+    std::string column = shcore::sqlstring("!", 0) << row[2];
+    table.columns.push_back(column);
+
+    if (row[5] == "PRI") {
+      key_columns.back()++;
+      bool is_integer = std::find(integer_types.begin(), integer_types.end(), row[3]) != integer_types.end();
+      table.key = is_integer ? column : "";
+      table.is_unsigned = row[4].find("unsigned") != std::string::npos;
+    }
+  }
+
+  for (size_t index = 0; index < tables.size(); index++) {
+    Table_info &table = tables[index];
+    if (key_columns[index] != 1)
+      table.key.clear();
+
+    // The NULL flags tell a NULL from an empty value
+    std::string nulls;
+    for (auto &column : table.columns)
+      nulls += (nulls.empty() ? "" : ", ") + ("ISNULL(" + column + ")");
+
+    std::string values;
+    for (auto &column : table.columns)
+      values += column + ", ";
+
+    table.row_checksum = "CRC32(CONCAT_WS('#', " + values + "CONCAT(" + nulls + ")))";
+  }
+
+  // Every given name must exist on the source
+  for (auto &name : names) {
+    bool found = std::any_of(tables.begin(), tables.end(), [&name](const Table_info &table) {
+      return table_matches(name, table.schema, table.name);
+    });
+
+    if (!found)
+      throw std::runtime_error("No tables found on the source for '" + name + "'");
+  }
+
+  return tables;
+}
+
+// Splits the tables with an integer key in ranges of about chunk_rows rows,
+// between the lowest and the highest key on all the instances
+std::vector<Range> split_tables(const std::vector<shcore::Value::Map_type_ref> &instances,
+                                const std::vector<Table_info> &tables, const Compare_options &options,
+                                const std::function<void(const std::string &)> &add_error) {
+  std::vector<size_t> keyed;
+  for (size_t index = 0; index < tables.size(); index++) {
+    if (!tables[index].key.empty())
+      keyed.push_back(index);
+  }
+
+  std::vector<std::vector<std::string> > bounds(keyed.size() * instances.size());
+  std::vector<std::string> failures;
+  run_tasks(instances, options.threads, keyed.size(),
+            [&](mysql::Connection &connection, size_t task, size_t instance) {
+              const Table_info &table = tables[keyed[task]];
+              auto rows = query(connection, "SELECT MIN(" + table.key + "), MAX(" + table.key + ") FROM " + table.from);
+              bounds[task * instances.size() + instance] = rows.at(0);
+            },
+            failures);
+
+  std::vector<Range> ranges;
+  size_t next_keyed = 0;
+  for (size_t index = 0; index < tables.size(); index++) {
+    const Table_info &table = tables[index];
+    if (table.key.empty()) {
+      Range range = { index, true, 0, 0 };
+      ranges.push_back(range);
+      continue;
+    }
+
+    size_t task = next_keyed++;
+    bool has_rows = false;
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    for (size_t instance = 0; instance < instances.size(); instance++) {
+      size_t slot = task * instances.size() + instance;
+      if (!failures[slot].empty()) {
+        add_error(shcore::build_connection_string(instances[instance], false) + ": " + table.schema + "." + table.name +
+                  ": " + failures[slot]);
+        continue;
+      }
+
+      auto &values = bounds[slot];
+      if (values.size() < 2 || values[0].empty())
+        continue;
+
+      has_rows = true;
+      first = std::min(first, key_to_offset(values[0], table.is_unsigned));
+      last = std::max(last, key_to_offset(values[1], table.is_unsigned));
+    }
+
+    if (!has_rows) {
+      Range range = { index, true, 0, 0 };
+      ranges.push_back(range);
+      continue;
+    }
+
+    uint64_t count = (table.estimated_rows + options.chunk_rows - 1) / options.chunk_rows;
+    for (auto &offsets : split_offsets(first, last, count)) {
+      Range range = { index, false, offsets.first, offsets.second };
+      ranges.push_back(range);
+    }
+  }
+
+  return ranges;
+}
+
+// Splits a range in k_split_parts parts
+void split_range(const Range &range, std::vector<Range> &parts) {
+  for (auto &offsets : split_offsets(range.first, range.last, k_split_parts)) {
+    Range part = { range.table, false, offsets.first, offsets.second };
+    parts.push_back(part);
+  }
+}
+
+// The differences of a table on a target instance
+struct Difference {
+  Difference() : source_rows(0), target_rows(0) {}
+
+  std::vector<uint64_t> missing;
+  std::vector<uint64_t> extra;
+  std::vector<uint64_t> different;
+  // Only for the tables compared as a whole
+  uint64_t source_rows;
+  uint64_t target_rows;
+};
+
+void add_keys(std::vector<uint64_t> &keys, const std::vector<uint64_t> &found) {
+  for (auto offset : found) {
+    if (keys.size() == k_max_listed_keys)
+      break;
+    keys.push_back(offset);
+  }
+}
+}
+
+Row_differences compare_rows(const Row_checksums &source, const Row_checksums &target) {
+  Row_differences differences;
+
+  for (auto &row : source) {
+    auto found = target.find(row.first);
+    if (found == target.end())
+      differences.missing.push_back(row.first);
+    else if (found->second != row.second)
+      differences.different.push_back(row.first);
+  }
+
+  for (auto &row : target) {
+    if (source.find(row.first) == source.end())
+      differences.extra.push_back(row.first);
+  }
+
+  return differences;
+}
+
+shcore::Value::Map_type_ref compare_tables(const std::vector<shcore::Value::Map_type_ref> &instances,
+                                           const Compare_options &options) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  if (instances.size() < 2)
+    throw std::runtime_error("At least one target instance is required");
+
+  std::vector<std::string> names;
+  for (auto &instance : instances)
+    names.push_back(shcore::build_connection_string(instance, false));
+
+  shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+  auto add_error = [&errors](const std::string &message) { errors->push_back(shcore::Value(message)); };
+
+  std::vector<Table_info> tables;
+  {
+    shcore::Argument_list args;
+    args.push_back(shcore::Value(instances[0]));
+    auto source = Session_pool::get()->acquire(args);
+    try {
+      tables = list_tables(*source->connection(), options.tables);
+    } catch (...) {
+      Session_pool::get()->release(source);
+      throw;
+    }
+    Session_pool::get()->release(source);
+  }
+
+  std::vector<Range> pending = split_tables(instances, tables, options, add_error);
+  size_t chunk_count = pending.size();
+  size_t different_chunks = 0;
+
+  // The differences by table and target instance
+  std::map<std::pair<size_t, size_t>, Difference> differences;
+
+  // The checksums of the ranges are compared on every pass, the different
+  // ones are split for the next pass until they are narrow enough to compare
+  // their rows
+  std::vector<Range> narrowed;
+  for (bool first_pass = true; !pending.empty(); first_pass = false) {
+    std::vector<Checksum> checksums(pending.size() * instances.size());
+    std::vector<std::string> failures;
+    run_tasks(instances, options.threads, pending.size(),
+              [&](mysql::Connection &connection, size_t task, size_t instance) {
+                const Range &range = pending[task];
+                const Table_info &table = tables[range.table];
+                auto rows = query(connection, "SELECT COUNT(*), COALESCE(BIT_XOR(" + table.row_checksum + "), 0) FROM " +
+                                              table.from + where(table, range));
+                Checksum &checksum = checksums[task * instances.size() + instance];
+                checksum.rows = std::stoull(rows.at(0).at(0));
+                checksum.crc = rows.at(0).at(1);
+              },
+              failures);
+
+    std::vector<Range> next;
+    for (size_t task = 0; task < pending.size(); task++) {
+      const Range &range = pending[task];
+      const Table_info &table = tables[range.table];
+      const size_t base = task * instances.size();
+
+      for (size_t instance = 0; instance < instances.size(); instance++) {
+        if (!failures[base + instance].empty())
+          add_error(names[instance] + ": " + describe(table, range) + ": " + failures[base + instance]);
+      }
+
+      // Nothing to compare with
+      if (!failures[base].empty())
+        continue;
+
+      const Checksum &source = checksums[base];
+      bool is_different = false;
+      for (size_t instance = 1; instance < instances.size(); instance++) {
+        const Checksum &target = checksums[base + instance];
+        if (!failures[base + instance].empty() || (target.rows == source.rows && target.crc == source.crc))
+          continue;
+
+        is_different = true;
+        if (range.whole) {
+          Difference &difference = differences[std::make_pair(range.table, instance)];
+          difference.source_rows = source.rows;
+          difference.target_rows = target.rows;
+        }
+      }
+
+      if (!is_different)
+        continue;
+
+      if (first_pass)
+        different_chunks++;
+
+      if (range.whole)
+        continue;
+
+      if (range.last - range.first < k_row_compare_keys)
+        narrowed.push_back(range);
+      else
+        split_range(range, next);
+    }
+
+    pending.swap(next);
+  }
+
+  // The narrowed ranges are compared row by row, by the checksum of every row
+  std::vector<Row_checksums> rows(narrowed.size() * instances.size());
+  std::vector<std::string> failures;
+  run_tasks(instances, options.threads, narrowed.size(),
+            [&](mysql::Connection &connection, size_t task, size_t instance) {
+              const Range &range = narrowed[task];
+              const Table_info &table = tables[range.table];
+              auto &checksums = rows[task * instances.size() + instance];
+              for (auto &row : query(connection, "SELECT " + table.key + ", " + table.row_checksum + " FROM " +
+                                                 table.from + where(table, range)))
+                checksums[key_to_offset(row[0], table.is_unsigned)] = row[1];
+            },
+            failures);
+
+  for (size_t task = 0; task < narrowed.size(); task++) {
+    const Range &range = narrowed[task];
+    const size_t base = task * instances.size();
+
+    for (size_t instance = 0; instance < instances.size(); instance++) {
+      if (!failures[base + instance].empty())
+        add_error(names[instance] + ": " + describe(tables[range.table], range) + ": " + failures[base + instance]);
+    }
+
+    if (!failures[base].empty())
+      continue;
+
+    auto &source = rows[base];
+    for (size_t instance = 1; instance < instances.size(); instance++) {
+      if (!failures[base + instance].empty())
+        continue;
+
+      Row_differences found = compare_rows(source, rows[base + instance]);
+      if (found.missing.empty() && found.extra.empty() && found.different.empty())
+        continue;
+
+      Difference &difference = differences[std::make_pair(range.table, instance)];
+      add_keys(difference.missing, found.missing);
+      add_keys(difference.extra, found.extra);
+      add_keys(difference.different, found.different);
+    }
+  }
+
+  shcore::Value::Array_type_ref found(new shcore::Value::Array_type());
+  for (auto &entry : differences) {
+    const Table_info &table = tables[entry.first.first];
+    const Difference &difference = entry.second;
+
+    shcore::Value::Map_type_ref item(new shcore::Value::Map_type());
+    (*item)["table"] = shcore::Value(table.schema + "." + table.name);
+    (*item)["instance"] = shcore::Value(names[entry.first.second]);
+
+    if (table.key.empty() || (difference.missing.empty() && difference.extra.empty() && difference.different.empty())) {
+      (*item)["sourceRows"] = shcore::Value(difference.source_rows);
+      (*item)["targetRows"] = shcore::Value(difference.target_rows);
+    } else {
+      auto list = [&table](const std::vector<uint64_t> &keys) {
+        shcore::Value::Array_type_ref values(new shcore::Value::Array_type());
+        for (auto offset : keys)
+          values->push_back(offset_to_value(offset, table.is_unsigned));
+        return shcore::Value(values);
+      };
+
+      (*item)["missing"] = list(difference.missing);
+      (*item)["extra"] = list(difference.extra);
+      (*item)["different"] = list(difference.different);
+    }
+
+    found->push_back(shcore::Value(item));
+  }
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  (*ret_val)["tables"] = shcore::Value(static_cast<uint64_t>(tables.size()));
+  (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunk_count));
+  (*ret_val)["differentChunks"] = shcore::Value(static_cast<uint64_t>(different_chunks));
+  (*ret_val)["differences"] = shcore::Value(found);
+  (*ret_val)["seconds"] = shcore::Value(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  (*ret_val)["errors"] = shcore::Value(errors);
+
+  return ret_val;
+}
+}
+}
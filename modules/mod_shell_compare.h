@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Consistency check of the tables of several instances used by
+// shell.compareTables
+
+#ifndef _MOD_SHELL_COMPARE_H_
+#define _MOD_SHELL_COMPARE_H_
+
+#include "shellcore/types.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mysqlsh {
+namespace compare {
+struct Compare_options {
+  // schema.table or a schema for all its tables, all the schemas of the
+  // source but the system ones if empty
+  std::vector<std::string> tables;
+  int threads;
+  uint64_t chunk_rows;
+};
+
+// The checksum of every row of a range of a table, by the offset of its key
+typedef std::map<uint64_t, std::string> Row_checksums;
+
+// The offsets of the keys of the rows that are not the same on a target
+struct Row_differences {
+  std::vector<uint64_t> missing;     // Only on the source
+  std::vector<uint64_t> extra;       // Only on the target
+  std::vector<uint64_t> different;   // On both, with a different checksum
+};
+
+// Compares the rows of a range on the source with the ones on a target
+Row_differences SHCORE_PUBLIC compare_rows(const Row_checksums &source, const Row_checksums &target);
+
+// Compares the tables of the source instance, the first one of the list of
+// connection data, with the ones of the rest of the instances. Tables with
+// an integer primary key are split in chunks on ranges of the key, the
+// checksum of every chunk is computed on all the instances at once by pooled
+// sessions and only the chunks with a different checksum are split again,
+// down to ranges small enough to compare their rows one by one.
+// Returns a dictionary with the totals, the differences and the errors found
+shcore::Value::Map_type_ref SHCORE_PUBLIC compare_tables(const std::vector<shcore::Value::Map_type_ref> &instances,
+                                                         const Compare_options &options);
+}
+}
+
+#endif
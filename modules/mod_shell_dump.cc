@@ -0,0 +1,1671 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/mod_shell_dump.h"
+#include "modules/mod_mysql_session.h"
+#include "modules/mod_mysqlx_session.h"
+#include "modules/mod_utils.h"
+#include "modules/mysql_connection.h"
+#include "utils/utils_csv.h"
+#include "utils/utils_file.h"
+#include "utils/utils_general.h"
+#include "utils/utils_parquet.h"
+#include "utils/utils_sqlstring.h"
+#include "mysqlx.h"
+#include "mysqlx_batch_control.h"
+#include "mysqlx_crud.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef WIN32
+#define DUMP_PATH_SEPARATOR "\\"
+#else
+#define DUMP_PATH_SEPARATOR "/"
+#endif
+
+namespace mysqlsh {
+namespace dump {
+namespace {
+// Size of the data buffered before it is written to a chunk file
+const size_t k_write_buffer_size = 256 * 1024;
+
+// Size of the values of a Parquet row group written before reaching its rows
+const size_t k_max_row_group_size = 64 * 1024 * 1024;
+
+// Rows and messages in flight the inserts of the X sessions start with, the
+// batches are adjusted as the server answers them, and their bytes at most
+const size_t k_default_batch_rows = 1000;
+const size_t k_default_pipeline_depth = 4;
+const size_t k_max_batch_bytes = 512 * 1024;
+
+// A session of the dump, the rows of the queries are read as raw text
+class Dump_session {
+public:
+  // Receives the fields of a row, a NULL data is a NULL value
+  typedef std::function<void(const std::vector<const char*> &data, const std::vector<size_t> &lengths)> Row_handler;
+
+  virtual ~Dump_session() {}
+
+  virtual void execute(const std::string &sql) = 0;
+  virtual void query(const std::string &sql, const Row_handler &on_row) = 0;
+
+  // An expression selecting the given one in the text form of the protocol
+  virtual std::string as_text(const std::string &expression) const = 0;
+
+  // An expression selecting the column as text, in utf8mb4 when it has a
+  // character set
+  virtual std::string column_as_text(const std::string &column, bool has_charset) const {
+    return as_text(shcore::sqlstring("!", 0) << column);
+  }
+};
+
+class Classic_dump_session : public Dump_session {
+public:
+  explicit Classic_dump_session(std::shared_ptr<mysql::Connection> connection) : _connection(connection) {}
+
+  virtual void execute(const std::string &sql) {
+    _connection->run_sql(sql);
+  }
+
+  virtual void query(const std::string &sql, const Row_handler &on_row) {
+    auto result = _connection->run_sql(sql);
+    size_t count = result->get_metadata().size();
+    std::vector<const char*> data(count);
+    std::vector<size_t> lengths(count);
+
+    // The row view points to the client library buffers, nothing is copied
+    while (const mysql::Row *row = result->fetch_one_view()) {
+      for (size_t index = 0; index < count; index++)
+        data[index] = row->get_data(static_cast<int>(index), lengths[index]);
+      on_row(data, lengths);
+    }
+  }
+
+  virtual std::string as_text(const std::string &expression) const {
+    return expression;
+  }
+
+private:
+  std::shared_ptr<mysql::Connection> _connection;
+};
+
+class X_dump_session : public Dump_session {
+public:
+  explicit X_dump_session(std::shared_ptr<mysqlx::BaseSession> session)
+    : _owner(session), _session(session->session_obj()) {}
+
+  ~X_dump_session() {
+    _owner->close(shcore::Argument_list());
+  }
+
+  virtual void execute(const std::string &sql) {
+    _session->executeSql(sql)->flush();
+  }
+
+  virtual void query(const std::string &sql, const Row_handler &on_row) {
+    auto result = _session->executeSql(sql);
+    std::vector<const char*> data;
+    std::vector<size_t> lengths;
+
+    while (auto row = result->next()) {
+      size_t count = static_cast<size_t>(row->numFields());
+      data.resize(count);
+      lengths.resize(count);
+
+      for (size_t index = 0; index < count; index++) {
+        int field = static_cast<int>(index);
+        lengths[index] = 0;
+        data[index] = row->isNullField(field) ? NULL : row->stringField(field, lengths[index]);
+      }
+      on_row(data, lengths);
+    }
+  }
+
+  // X rows are typed, the values are converted to their text form by the
+  // server as binary strings so the bytes of the data are not converted
+  virtual std::string as_text(const std::string &expression) const {
+    return "CAST(" + expression + " AS BINARY)";
+  }
+
+  virtual std::string column_as_text(const std::string &column, bool has_charset) const {
+    if (has_charset)
+      return shcore::sqlstring("CONVERT(! USING utf8mb4)", 0) << column;
+
+    return Dump_session::column_as_text(column, has_charset);
+  }
+
+  std::shared_ptr< ::mysqlx::Session> session() const { return _session; }
+
+private:
+  std::shared_ptr<mysqlx::BaseSession> _owner;
+  std::shared_ptr< ::mysqlx::Session> _session;
+};
+
+// Opens an X session with the connection data of the given one
+std::shared_ptr<mysqlx::BaseSession> open_x_session(std::shared_ptr<ShellDevelopmentSession> session) {
+  shcore::Argument_list session_args;
+  session_args.push_back(shcore::Value(session_connection_data(session)));
+
+  return std::dynamic_pointer_cast<mysqlx::BaseSession>(connect_session(session_args, SessionType::Node));
+}
+
+// Opens a session with the connection data of the given one
+std::unique_ptr<Dump_session> open_session(std::shared_ptr<ShellDevelopmentSession> session) {
+  auto classic = std::dynamic_pointer_cast<mysql::ClassicSession>(session);
+  if (classic)
+    return std::unique_ptr<Dump_session>(new Classic_dump_session(classic->open_connection(false)));
+
+  return std::unique_ptr<Dump_session>(new X_dump_session(open_x_session(session)));
+}
+
+// Starts a transaction on every session while the first one holds the
+// global read lock, so all of them read the same snapshot
+template <class Session>
+void start_consistent_snapshot(const std::vector<std::unique_ptr<Session> > &sessions) {
+  sessions[0]->execute("FLUSH TABLES WITH READ LOCK");
+  try {
+    for (auto &target : sessions) {
+      target->execute("SET NAMES utf8mb4");
+      target->execute("SET SESSION TRANSACTION ISOLATION LEVEL REPEATABLE READ");
+      target->execute("START TRANSACTION WITH CONSISTENT SNAPSHOT");
+    }
+  } catch (...) {
+    sessions[0]->execute("UNLOCK TABLES");
+    throw;
+  }
+  sessions[0]->execute("UNLOCK TABLES");
+}
+
+// Returns the values of the first column of the query
+std::vector<std::string> query_column(Dump_session &session, const std::string &sql) {
+  std::vector<std::string> values;
+
+  session.query(sql, [&values](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+    values.push_back(data[0] ? std::string(data[0], lengths[0]) : std::string());
+  });
+
+  return values;
+}
+
+// A file of the dump, compressed as it is written
+class Output_file {
+public:
+  Output_file(const std::string &path, const std::string &compression) : _path(path), _file(NULL) {
+#ifdef HAVE_ZLIB
+    _gz_file = NULL;
+    if (compression == "gzip") {
+      _gz_file = gzopen(path.c_str(), "wb");
+      if (!_gz_file)
+        throw std::runtime_error("Unable to create file '" + path + "': " + shcore::get_last_error());
+      return;
+    }
+#endif
+    _file = std::fopen(path.c_str(), "wb");
+    if (!_file)
+      throw std::runtime_error("Unable to create file '" + path + "': " + shcore::get_last_error());
+  }
+
+  ~Output_file() {
+    try {
+      close();
+    } catch (...) {
+      // Errors are only reported when the file is explicitly closed
+    }
+  }
+
+  void write(const char *data, size_t length) {
+    bool failed;
+#ifdef HAVE_ZLIB
+    if (_gz_file)
+      failed = gzwrite(_gz_file, data, static_cast<unsigned int>(length)) != static_cast<int>(length);
+    else
+#endif
+      failed = std::fwrite(data, 1, length, _file) != length;
+
+    if (failed)
+      throw std::runtime_error("Error writing file '" + _path + "': " + shcore::get_last_error());
+  }
+
+  void write(const std::string &data) {
+    write(data.data(), data.size());
+  }
+
+  void close() {
+    bool failed = false;
+#ifdef HAVE_ZLIB
+    if (_gz_file) {
+      failed = gzclose(_gz_file) != Z_OK;
+      _gz_file = NULL;
+    }
+#endif
+    if (_file) {
+      failed = std::fclose(_file) != 0;
+      _file = NULL;
+    }
+
+    if (failed)
+      throw std::runtime_error("Error writing file '" + _path + "': " + shcore::get_last_error());
+  }
+
+private:
+  std::string _path;
+  FILE *_file;
+#ifdef HAVE_ZLIB
+  gzFile _gz_file;
+#endif
+};
+
+// The name of an object as part of a file name, any character that may not
+// be valid on a file name is replaced by its code
+std::string encode_name(const std::string &name) {
+  std::string encoded;
+
+  for (auto c : name) {
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-') {
+      encoded.append(1, c);
+    } else {
+      char code[4];
+      snprintf(code, sizeof(code), "%%%02X", static_cast<unsigned char>(c));
+      encoded.append(code);
+    }
+  }
+
+  return encoded;
+}
+
+struct Table_info {
+  std::string schema;
+  std::string name;
+  std::string base_name;     // Prefix of the files of the table
+  std::string ddl;
+  std::vector<std::string> columns;
+  std::vector<shcore::Parquet_writer::Column> parquet_columns;
+  std::string select;        // SELECT ... FROM the table, the chunks add the WHERE
+  size_t first_chunk;
+  size_t chunk_count;
+};
+
+struct Chunk_info {
+  size_t table;
+  std::string where;
+  std::string file;
+  uint64_t rows;
+  uint64_t bytes;
+};
+
+// Splits the table on ranges of its primary key, when it is a single
+// integer column, into chunks of about chunk_rows rows
+void add_table_chunks(Dump_session &session, const Table_info &table, size_t table_index, uint64_t chunk_rows,
+                      const std::string &extension, std::vector<Chunk_info> &chunks) {
+  auto primary = query_column(session, shcore::sqlstring(
+      ("SELECT " + session.as_text("COLUMN_NAME") + " FROM information_schema.STATISTICS "
+      "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? AND INDEX_NAME = 'PRIMARY' ORDER BY SEQ_IN_INDEX").c_str(), 0)
+      << table.schema << table.name);
+
+  std::vector<std::pair<std::string, std::string> > ranges;
+  std::string key;
+  bool is_unsigned = false;
+
+  if (primary.size() == 1) {
+    auto type = query_column(session, shcore::sqlstring(
+        ("SELECT " + session.as_text("COLUMN_TYPE") + " FROM information_schema.COLUMNS "
+        "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? AND COLUMN_NAME = ?").c_str(), 0)
+        << table.schema << table.name << primary[0]);
+
+    if (type.size() == 1 && type[0].find("int") != std::string::npos) {
+      key = shcore::sqlstring("!", 0) << primary[0];
+      is_unsigned = type[0].find("unsigned") != std::string::npos;
+    }
+  }
+
+  if (!key.empty()) {
+    std::vector<std::string> bounds;
+    session.query(shcore::sqlstring(("SELECT " + session.as_text("MIN(!)") + ", " + session.as_text("MAX(!)") +
+        ", " + session.as_text("COUNT(*)") + " FROM !.!").c_str(), 0) << primary[0] << primary[0] << table.schema << table.name,
+        [&bounds](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+      for (size_t index = 0; index < data.size(); index++)
+        bounds.push_back(data[index] ? std::string(data[index], lengths[index]) : std::string());
+    });
+
+    // An empty table goes in a single chunk
+    if (bounds.size() == 3 && !bounds[0].empty())
+      ranges = chunk_key_ranges(bounds[0], bounds[1], is_unsigned, std::stoull(bounds[2]), chunk_rows);
+  }
+
+  if (ranges.empty()) {
+    Chunk_info chunk = { table_index, "", table.base_name + "@0" + extension, 0, 0 };
+    chunks.push_back(chunk);
+    return;
+  }
+
+  for (size_t index = 0; index < ranges.size(); index++) {
+    Chunk_info chunk = { table_index, " WHERE " + key + " BETWEEN " + ranges[index].first + " AND " + ranges[index].second +
+        " ORDER BY " + key, table.base_name + "@" + std::to_string(index) + extension, 0, 0 };
+    chunks.push_back(chunk);
+  }
+}
+
+// The Parquet type a column is written as, from the DATA_TYPE and the
+// COLUMN_TYPE of information_schema.COLUMNS. DECIMAL stays as text so it
+// keeps its precision.
+shcore::Parquet_writer::Type parquet_type(const std::string &data_type, const std::string &column_type) {
+  if (data_type.find("int") != std::string::npos || data_type == "year") {
+    if (column_type.find("unsigned") != std::string::npos)
+      return shcore::Parquet_writer::Type::UInt64;
+    return shcore::Parquet_writer::Type::Int64;
+  }
+
+  if (data_type == "float" || data_type == "double")
+    return shcore::Parquet_writer::Type::Double;
+
+  if (data_type == "json")
+    return shcore::Parquet_writer::Type::Json;
+
+  if (data_type.find("binary") != std::string::npos || data_type.find("blob") != std::string::npos ||
+      data_type == "bit" || data_type == "geometry" || data_type.find("point") != std::string::npos ||
+      data_type.find("linestring") != std::string::npos || data_type.find("polygon") != std::string::npos ||
+      data_type == "geometrycollection")
+    return shcore::Parquet_writer::Type::Binary;
+
+  return shcore::Parquet_writer::Type::Utf8;
+}
+
+// Adds the text form of a value to the row group as the type of its column
+void append_parquet_value(shcore::Parquet_row_group &group, size_t index, const shcore::Parquet_writer::Column &column,
+                          const char *data, size_t length) {
+  if (!data) {
+    group.append_null(index);
+    return;
+  }
+
+  if (column.type == shcore::Parquet_writer::Type::Utf8 || column.type == shcore::Parquet_writer::Type::Json ||
+      column.type == shcore::Parquet_writer::Type::Binary) {
+    group.append(index, data, length);
+    return;
+  }
+
+  std::string text(data, length);
+  char *end = NULL;
+  errno = 0;
+  if (column.type == shcore::Parquet_writer::Type::Int64)
+    group.append(index, static_cast<int64_t>(std::strtoll(text.c_str(), &end, 10)));
+  else if (column.type == shcore::Parquet_writer::Type::UInt64)
+    group.append(index, static_cast<uint64_t>(std::strtoull(text.c_str(), &end, 10)));
+  else
+    group.append(index, std::strtod(text.c_str(), &end));
+
+  if (text.empty() || errno == ERANGE || end != text.c_str() + text.size())
+    throw std::runtime_error("Invalid value '" + text + "' for the column " + column.name);
+}
+
+// Writes the rows of the chunk as a Parquet file, a row group every
+// row_group_rows rows. The compression is applied to the pages of the file.
+void dump_parquet_chunk(Dump_session &session, const Table_info &table, Chunk_info &chunk,
+                        const std::string &output_dir, const Dump_options &options) {
+  Output_file file(output_dir + DUMP_PATH_SEPARATOR + chunk.file, "none");
+  shcore::Parquet_writer writer(table.parquet_columns, options.compression, [&](const char *data, size_t size) {
+    file.write(data, size);
+  });
+  shcore::Parquet_row_group group(table.parquet_columns);
+
+  session.query(table.select + chunk.where, [&](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+    for (size_t index = 0; index < data.size(); index++)
+      append_parquet_value(group, index, table.parquet_columns[index], data[index], lengths[index]);
+    group.end_row();
+    chunk.rows++;
+
+    if (group.rows() >= options.row_group_rows || group.data_size() >= k_max_row_group_size) {
+      chunk.bytes += group.data_size();
+      writer.write(group);
+      group.clear();
+    }
+  });
+
+  chunk.bytes += group.data_size();
+  writer.write(group);
+  writer.finish();
+  file.close();
+}
+
+// Writes the rows of the chunk as TSV, the format LOAD DATA reads by default
+void dump_chunk(Dump_session &session, const Table_info &table, Chunk_info &chunk,
+                const std::string &output_dir, const Dump_options &options) {
+  if (options.format == "parquet") {
+    dump_parquet_chunk(session, table, chunk, output_dir, options);
+    return;
+  }
+
+  Output_file file(output_dir + DUMP_PATH_SEPARATOR + chunk.file, options.compression);
+  shcore::Text_dialect dialect = shcore::Text_dialect::tsv();
+  std::string buffer;
+  buffer.reserve(k_write_buffer_size + 4096);
+
+  session.query(table.select + chunk.where, [&](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+    for (size_t index = 0; index < data.size(); index++) {
+      if (index)
+        buffer.append(1, dialect.fields_terminated_by);
+      shcore::append_field(buffer, data[index], lengths[index], dialect);
+    }
+    buffer.append(1, dialect.lines_terminated_by);
+    chunk.rows++;
+
+    if (buffer.size() >= k_write_buffer_size) {
+      file.write(buffer);
+      chunk.bytes += buffer.size();
+      buffer.clear();
+    }
+  });
+
+  file.write(buffer);
+  chunk.bytes += buffer.size();
+  file.close();
+}
+
+// The documents of an export go to a single file, written a block at a
+// time by all the sessions. Compressed blocks are gzip members of their own,
+// the concatenation of gzip members is a valid gzip file. Parquet files get
+// a row group for every block instead, encoded by the session that read it.
+class Export_writer {
+public:
+  explicit Export_writer(const Export_options &options)
+    : _file(options.path, "none"), _compress(options.compression == "gzip") {
+    if (options.format == "parquet") {
+      _compress = false;
+      _parquet.reset(new shcore::Parquet_writer({ shcore::Parquet_writer::Column("doc", shcore::Parquet_writer::Type::Json) },
+          options.compression, [this](const char *data, size_t size) { _file.write(data, size); }));
+    }
+  }
+
+  bool is_parquet() const { return _parquet != nullptr; }
+
+  const std::vector<shcore::Parquet_writer::Column> &parquet_columns() const {
+    return _parquet->columns();
+  }
+
+  void write(const shcore::Parquet_row_group &group) {
+    if (!group.rows())
+      return;
+
+    auto encoded = _parquet->encode(group);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _parquet->write(*encoded);
+  }
+
+  void write(const std::string &block) {
+    if (block.empty())
+      return;
+
+#ifdef HAVE_ZLIB
+    if (_compress) {
+      std::string member = gzip_member(block);
+      std::lock_guard<std::mutex> lock(_mutex);
+      _file.write(member);
+      return;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(_mutex);
+    _file.write(block);
+  }
+
+  void close() {
+    if (_parquet)
+      _parquet->finish();
+    _file.close();
+  }
+
+private:
+#ifdef HAVE_ZLIB
+  static std::string gzip_member(const std::string &data) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    // 16 added to the window bits writes the gzip header and trailer
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      throw std::runtime_error("Unable to initialize the compression");
+
+    std::string member(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&member[0]);
+    stream.avail_out = static_cast<uInt>(member.size());
+
+    int rc = deflate(&stream, Z_FINISH);
+    member.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (rc != Z_STREAM_END)
+      throw std::runtime_error("Unable to compress the documents");
+
+    return member;
+  }
+#endif
+
+  std::mutex _mutex;
+  Output_file _file;
+  bool _compress;
+  std::unique_ptr<shcore::Parquet_writer> _parquet;
+};
+
+struct Export_chunk {
+  std::string from;
+  std::string to;
+  uint64_t documents;
+  uint64_t bytes;
+};
+
+// Leading hex digits of the _id taken as a number to split the collection
+const size_t k_id_prefix_digits = 15;
+
+bool is_hex_id(const std::string &id) {
+  return !id.empty() && std::all_of(id.begin(), id.end(), [](char c) {
+    return std::isxdigit(static_cast<unsigned char>(c)) != 0;
+  });
+}
+
+uint64_t id_prefix(const std::string &id) {
+  std::string prefix = id.substr(0, k_id_prefix_digits);
+  prefix.append(k_id_prefix_digits - prefix.size(), '0');
+  return std::stoull(prefix, nullptr, 16);
+}
+
+// Splits the collection on ranges of _id into chunks of about chunk_docs
+// documents. The ids the shell generates are hex strings, the range between
+// the first and the last one is split evenly as with the integer keys of the
+// tables. Any other kind of id leaves the collection in a single chunk.
+std::vector<Export_chunk> export_chunks(Dump_session &session, const Export_query &query, uint64_t chunk_docs) {
+  std::vector<std::string> bounds;
+  session.query(shcore::sqlstring(("SELECT " + session.as_text("MIN(_id)") + ", " + session.as_text("MAX(_id)") + ", " +
+      session.as_text("(SELECT TABLE_ROWS FROM information_schema.TABLES WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?)") +
+      " FROM !.!").c_str(), 0) << query.schema << query.collection
+      << query.schema << query.collection,
+      [&bounds](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+    for (size_t index = 0; index < data.size(); index++)
+      bounds.push_back(data[index] ? std::string(data[index], lengths[index]) : std::string());
+  });
+
+  std::vector<Export_chunk> chunks;
+  Export_chunk chunk = { "", "", 0, 0 };
+
+  // The row count is only an estimate, the chunks end up about the size asked
+  if (bounds.size() == 3 && is_hex_id(bounds[0]) && is_hex_id(bounds[1]) && !bounds[2].empty()) {
+    uint64_t first = id_prefix(bounds[0]);
+    uint64_t last = id_prefix(bounds[1]);
+    uint64_t count = std::max<uint64_t>(1, (std::stoull(bounds[2]) + chunk_docs - 1) / chunk_docs);
+    uint64_t step = (last - first) / count + 1;
+
+    for (uint64_t start = first + step; start <= last && start > first; start += step) {
+      char bound[k_id_prefix_digits + 1];
+      snprintf(bound, sizeof(bound), "%015llx", static_cast<unsigned long long>(start));
+      chunk.to = bound;
+      chunks.push_back(chunk);
+      chunk.from = chunk.to;
+    }
+  }
+
+  chunk.to.clear();
+  chunks.push_back(chunk);
+
+  return chunks;
+}
+
+// Writes the documents of the chunk as they come from the server, no value
+// is parsed on the way
+void export_chunk(X_dump_session &session, const Export_query &query, const Export_options &options,
+                  Export_chunk &chunk, Export_writer &writer) {
+  auto schema = std::make_shared< ::mysqlx::Schema>(session.session(), query.schema);
+  ::mysqlx::FindStatement find(schema->getCollection(query.collection), query.condition);
+  for (auto &binding : query.bindings)
+    find.bind(binding.first, binding.second);
+  for (auto &binding : query.list_bindings)
+    find.bind(binding.first, binding.second);
+  find.columnRange("_id", chunk.from, chunk.to);
+
+  auto result = find.execute();
+  if (writer.is_parquet()) {
+    shcore::Parquet_row_group group(writer.parquet_columns());
+    while (auto row = result->next()) {
+      size_t length = 0;
+      const char *document = row->stringField(0, length);
+      group.append(0, document, length);
+      group.end_row();
+      chunk.documents++;
+
+      if (group.rows() >= options.row_group_rows || group.data_size() >= k_max_row_group_size) {
+        chunk.bytes += group.data_size();
+        writer.write(group);
+        group.clear();
+      }
+    }
+
+    chunk.bytes += group.data_size();
+    writer.write(group);
+    return;
+  }
+
+  std::string buffer;
+  buffer.reserve(k_write_buffer_size + 4096);
+
+  while (auto row = result->next()) {
+    size_t length = 0;
+    const char *document = row->stringField(0, length);
+    buffer.append(document, length);
+    buffer.append(1, '\n');
+    chunk.documents++;
+
+    if (buffer.size() >= k_write_buffer_size) {
+      writer.write(buffer);
+      chunk.bytes += buffer.size();
+      buffer.clear();
+    }
+  }
+
+  writer.write(buffer);
+  chunk.bytes += buffer.size();
+}
+
+void write_text_file(const std::string &path, const std::string &data) {
+  Output_file file(path, "none");
+  file.write(data);
+  file.close();
+}
+
+// A session of the load, the chunks are loaded from their TSV data
+class Load_session {
+public:
+  virtual ~Load_session() {}
+
+  virtual void execute(const std::string &sql) = 0;
+
+  // Loads the rows of the data into the table, returns the number of rows
+  virtual uint64_t load(const std::string &schema, const std::string &table,
+                        const std::vector<std::string> &columns, const char *data, size_t size) = 0;
+};
+
+class Classic_load_session : public Load_session {
+public:
+  explicit Classic_load_session(std::shared_ptr<mysql::Connection> connection) : _connection(connection) {}
+
+  virtual void execute(const std::string &sql) {
+    _connection->run_sql(sql);
+  }
+
+  virtual uint64_t load(const std::string &schema, const std::string &table,
+                        const std::vector<std::string> &columns, const char *data, size_t size) {
+    std::string sql = shcore::sqlstring("LOAD DATA LOCAL INFILE 'chunk' INTO TABLE !.! CHARACTER SET utf8mb4 ", 0)
+        << schema << table;
+    sql += shcore::Text_dialect::tsv().load_data_clauses() + " (";
+    for (size_t index = 0; index < columns.size(); index++)
+      sql += (index ? ", " : "") + (shcore::sqlstring("!", 0) << columns[index]).str();
+    sql += ")";
+
+    return _connection->run_load_data_local(sql, data, size)->affected_rows();
+  }
+
+private:
+  std::shared_ptr<mysql::Connection> _connection;
+};
+
+class X_load_session : public Load_session {
+public:
+  // The batches are sized by the control shared by all the sessions
+  X_load_session(std::shared_ptr<mysqlx::BaseSession> session, ::mysqlx::Batch_control &batch_control)
+    : _owner(session), _session(session->session_obj()), _batch_control(batch_control) {}
+
+  ~X_load_session() {
+    _owner->close(shcore::Argument_list());
+  }
+
+  virtual void execute(const std::string &sql) {
+    _session->executeSql(sql)->flush();
+  }
+
+  // The rows are decoded as they are sent in pipelined batches of inserts.
+  // The batches of a chunk are a single transaction as the LOAD DATA of the
+  // classic sessions, a chunk that fails leaves no rows behind to be loaded
+  // again on resume.
+  virtual uint64_t load(const std::string &schema, const std::string &table,
+                        const std::vector<std::string> &columns, const char *data, size_t size) {
+    shcore::Record_reader reader(data, size, shcore::Text_dialect::tsv());
+    std::vector<std::string> fields;
+    std::vector<bool> nulls;
+
+    auto next_row = [&](std::vector< ::mysqlx::TableValue> &row) {
+      if (!reader.next(fields, nulls))
+        return false;
+
+      for (size_t field = 0; field < fields.size(); field++) {
+        if (nulls[field])
+          row.push_back(::mysqlx::TableValue());
+        else
+          row.push_back(::mysqlx::TableValue(fields[field]));
+      }
+      return true;
+    };
+
+    execute("START TRANSACTION");
+    try {
+      auto insert = _session->getSchema(schema)->getTable(table)->insert();
+      auto result = insert.insert(columns).execute(next_row, _batch_control, k_max_batch_bytes);
+      execute("COMMIT");
+
+      return static_cast<uint64_t>(result->affectedRows());
+    } catch (...) {
+      try {
+        execute("ROLLBACK");
+      } catch (std::exception &e) {
+        log_warning("Unable to roll back the failed chunk of %s.%s: %s", schema.c_str(), table.c_str(), e.what());
+      }
+      throw;
+    }
+  }
+
+private:
+  std::shared_ptr<mysqlx::BaseSession> _owner;
+  std::shared_ptr< ::mysqlx::Session> _session;
+  ::mysqlx::Batch_control &_batch_control;
+};
+
+std::unique_ptr<Load_session> open_load_session(std::shared_ptr<ShellDevelopmentSession> session,
+                                                ::mysqlx::Batch_control &batch_control) {
+  auto classic = std::dynamic_pointer_cast<mysql::ClassicSession>(session);
+  if (classic)
+    return std::unique_ptr<Load_session>(new Classic_load_session(classic->open_connection(true)));
+
+  return std::unique_ptr<Load_session>(new X_load_session(open_x_session(session), batch_control));
+}
+
+// The data of a chunk file, mapped or decompressed in memory
+class Input_file {
+public:
+  explicit Input_file(const std::string &path) {
+    if (path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0) {
+#ifdef HAVE_ZLIB
+      gzFile file = gzopen(path.c_str(), "rb");
+      if (!file)
+        throw std::runtime_error("Unable to open file '" + path + "': " + shcore::get_last_error());
+
+      char buffer[256 * 1024];
+      int count;
+      while ((count = gzread(file, buffer, sizeof(buffer))) > 0)
+        _inflated.append(buffer, count);
+
+      gzclose(file);
+
+      if (count < 0)
+        throw std::runtime_error("Error reading compressed file '" + path + "'");
+#else
+      throw std::runtime_error("Unable to read compressed file '" + path + "': the shell was built without zlib");
+#endif
+    } else {
+      _mapped.reset(new shcore::Mapped_file(path));
+    }
+  }
+
+  const char *data() const { return _mapped ? _mapped->data() : _inflated.data(); }
+  size_t size() const { return _mapped ? _mapped->size() : _inflated.size(); }
+
+private:
+  std::unique_ptr<shcore::Mapped_file> _mapped;
+  std::string _inflated;
+};
+
+// Tracks the completed steps of a load on a file, one per line, each line
+// is flushed so it survives an interruption of the load
+class Load_progress {
+public:
+  Load_progress(const std::string &path, bool resume) : _path(path) {
+    std::string data;
+    if (resume && shcore::load_text_file(path, data)) {
+      size_t start = 0;
+      size_t end;
+      while ((end = data.find('\n', start)) != std::string::npos) {
+        _done.insert(data.substr(start, end - start));
+        start = end + 1;
+      }
+    }
+
+    _file = std::fopen(path.c_str(), resume ? "ab" : "wb");
+    if (!_file)
+      throw std::runtime_error("Unable to open progress file '" + path + "': " + shcore::get_last_error());
+  }
+
+  ~Load_progress() {
+    std::fclose(_file);
+  }
+
+  bool is_done(const std::string &step) const {
+    return _done.find(step) != _done.end();
+  }
+
+  void set_done(const std::string &step) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::string line = step + "\n";
+
+    if (std::fwrite(line.data(), 1, line.size(), _file) != line.size() || std::fflush(_file) != 0)
+      throw std::runtime_error("Error writing progress file '" + _path + "': " + shcore::get_last_error());
+  }
+
+private:
+  std::string _path;
+  FILE *_file;
+  std::set<std::string> _done;
+  std::mutex _mutex;
+};
+
+struct Load_table {
+  std::string schema;
+  std::string name;
+  std::string ddl_file;
+  std::vector<std::string> columns;
+  std::vector<std::string> indexes;      // Secondary indexes created after the data
+  uint64_t bytes;
+  std::atomic<size_t> pending_chunks;
+  std::atomic<bool> failed;
+};
+
+struct Load_task {
+  Load_table *table;
+  std::string file;                      // Empty to create the deferred indexes
+  uint64_t bytes;
+};
+
+// Strips the statement terminator written by the dump
+std::string read_statement(const std::string &path) {
+  std::string data;
+  if (!shcore::load_text_file(path, data))
+    throw std::runtime_error("Unable to open file '" + path + "': " + shcore::get_last_error());
+
+  while (!data.empty() && (data.back() == '\n' || data.back() == ';'))
+    data.pop_back();
+
+  return data;
+}
+
+// Statements with IF NOT EXISTS, so a resumed load skips the objects it
+// already created
+std::string add_if_not_exists(const std::string &statement, const std::string &prefix) {
+  if (statement.compare(0, prefix.size(), prefix) == 0)
+    return prefix + "IF NOT EXISTS " + statement.substr(prefix.size());
+
+  return statement;
+}
+
+// Creates the secondary indexes, InnoDB only adds one FULLTEXT index on
+// each ALTER TABLE so they get their own statements
+void create_indexes(Load_session &session, Load_table &table) {
+  std::string prefix = shcore::sqlstring("ALTER TABLE !.! ", 0) << table.schema << table.name;
+  std::string alter;
+
+  for (auto &index : table.indexes) {
+    if (index.compare(0, 9, "FULLTEXT ") == 0) {
+      session.execute(prefix + "ADD " + index);
+    } else {
+      alter += (alter.empty() ? "ADD " : ", ADD ") + index;
+    }
+  }
+
+  if (!alter.empty())
+    session.execute(prefix + alter);
+}
+
+// Size of the blocks of TSV data passed from the readers to the writers of
+// a copy, each one is loaded with a single statement
+const size_t k_copy_block_size = 4 * 1024 * 1024;
+
+// A block of rows of a chunk being copied
+struct Copy_block {
+  size_t table;
+  std::string chunk;
+  std::string data;
+};
+
+// Passes the blocks from the readers to the writers of a copy. Only a few
+// blocks are held, a reader waits for the writers when it is full, so the
+// memory used does not depend on the size of the tables.
+class Copy_queue {
+public:
+  explicit Copy_queue(size_t capacity) : _capacity(capacity), _closed(false) {}
+
+  void push(Copy_block &&block) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_full.wait(lock, [this]() { return _blocks.size() < _capacity; });
+    _blocks.push_back(std::move(block));
+    _not_empty.notify_one();
+  }
+
+  // Returns false once the queue is closed and empty
+  bool pop(Copy_block &block) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_empty.wait(lock, [this]() { return !_blocks.empty() || _closed; });
+    if (_blocks.empty())
+      return false;
+
+    block = std::move(_blocks.front());
+    _blocks.pop_front();
+    _not_full.notify_one();
+    return true;
+  }
+
+  // No more blocks will be pushed
+  void close() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+    _not_empty.notify_all();
+  }
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _not_full;
+  std::condition_variable _not_empty;
+  std::deque<Copy_block> _blocks;
+  size_t _capacity;
+  bool _closed;
+};
+
+// Returns the schema and name of the base tables matching the given names,
+// as selected by table_filter
+std::vector<std::pair<std::string, std::string> > list_tables(Dump_session &session,
+                                                              const std::vector<std::string> &names) {
+  std::vector<std::pair<std::string, std::string> > tables;
+  session.query("SELECT " + session.as_text("TABLE_SCHEMA") + ", " + session.as_text("TABLE_NAME") +
+      " FROM information_schema.TABLES WHERE TABLE_TYPE = 'BASE TABLE' AND " + table_filter(names) +
+      " ORDER BY TABLE_SCHEMA, TABLE_NAME",
+      [&tables](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+    tables.push_back(std::make_pair(std::string(data[0], lengths[0]), std::string(data[1], lengths[1])));
+  });
+
+  for (auto &name : names) {
+    bool found = std::any_of(tables.begin(), tables.end(), [&name](const std::pair<std::string, std::string> &table) {
+      return table_matches(name, table.first, table.second);
+    });
+
+    if (!found)
+      throw std::runtime_error("No tables found for '" + name + "'");
+  }
+
+  return tables;
+}
+}
+
+bool split_secondary_indexes(const std::string &create_table, std::string &without_indexes,
+                             std::vector<std::string> &indexes) {
+  without_indexes = create_table;
+  indexes.clear();
+
+  size_t body_start = create_table.find("(\n");
+  size_t body_end = create_table.rfind("\n)");
+  if (body_start == std::string::npos || body_end == std::string::npos || body_end < body_start)
+    return false;
+
+  std::vector<std::string> kept;
+  std::vector<std::string> found;
+  bool has_primary = false;
+  bool has_auto_increment = false;
+  size_t start = body_start + 2;
+
+  while (start <= body_end) {
+    size_t end = create_table.find('\n', start);
+    std::string line = create_table.substr(start, end - start);
+    start = end + 1;
+
+    if (!line.empty() && line.back() == ',')
+      line.pop_back();
+
+    std::string definition = line.substr(std::min(line.find_first_not_of(' '), line.size()));
+
+    if (definition.compare(0, 11, "CONSTRAINT ") == 0 || definition.find(" FOREIGN KEY ") != std::string::npos)
+      return false;
+
+    if (definition.compare(0, 12, "PRIMARY KEY ") == 0)
+      has_primary = true;
+    else if (definition[0] == '`' && definition.find(" AUTO_INCREMENT") != std::string::npos)
+      has_auto_increment = true;
+
+    if (definition.compare(0, 4, "KEY ") == 0 || definition.compare(0, 11, "UNIQUE KEY ") == 0 ||
+        definition.compare(0, 13, "FULLTEXT KEY ") == 0 || definition.compare(0, 12, "SPATIAL KEY ") == 0)
+      found.push_back(definition);
+    else
+      kept.push_back(line);
+  }
+
+  if (has_auto_increment && !has_primary)
+    return false;
+
+  without_indexes = create_table.substr(0, body_start + 2);
+  for (size_t index = 0; index < kept.size(); index++)
+    without_indexes += kept[index] + (index + 1 < kept.size() ? ",\n" : "");
+  without_indexes += create_table.substr(body_end);
+
+  indexes.swap(found);
+  return true;
+}
+
+bool is_compression_supported(const std::string &compression) {
+#ifdef HAVE_ZLIB
+  if (compression == "gzip")
+    return true;
+#endif
+  return compression == "none";
+}
+
+void parse_copy_options(const shcore::Value::Map_type &map, Copy_options &options) {
+  shcore::Argument_map opt_map(map);
+  opt_map.ensure_keys({}, {"tables", "threads", "chunkRows"}, "copyTables options");
+
+  if (opt_map.has_key("tables")) {
+    options.tables.clear();
+    for (auto &table : *opt_map.array_at("tables")) {
+      if (table.type != shcore::String)
+        throw shcore::Exception::argument_error("The tables must be a list of strings");
+      options.tables.push_back(table.as_string());
+    }
+  }
+
+  if (opt_map.has_key("threads"))
+    options.threads = static_cast<int>(opt_map.int_at("threads"));
+
+  if (options.threads < 1)
+    throw shcore::Exception::argument_error("The value for 'threads' must be a positive integer");
+
+  if (opt_map.has_key("chunkRows"))
+    options.chunk_rows = opt_map.uint_at("chunkRows");
+
+  if (options.chunk_rows == 0)
+    throw shcore::Exception::argument_error("The value for 'chunkRows' must be a positive integer");
+}
+
+std::vector<std::pair<std::string, std::string> > chunk_key_ranges(const std::string &min, const std::string &max,
+                                                                   bool is_unsigned, uint64_t rows, uint64_t chunk_rows) {
+  std::vector<std::pair<std::string, std::string> > ranges;
+  uint64_t first = key_to_offset(min, is_unsigned);
+  uint64_t last = key_to_offset(max, is_unsigned);
+
+  // Rounded up without overflowing on huge chunks
+  uint64_t count = rows / chunk_rows + (rows % chunk_rows ? 1 : 0);
+  for (auto &offsets : split_offsets(first, last, count))
+    ranges.push_back(std::make_pair(offset_to_key(offsets.first, is_unsigned),
+                                    offset_to_key(offsets.second, is_unsigned)));
+
+  return ranges;
+}
+
+shcore::Value::Map_type_ref dump_schemas(std::shared_ptr<ShellDevelopmentSession> session,
+                                         const Dump_options &options) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::string extension = options.format == "parquet" ? ".parquet" : options.compression == "gzip" ? ".tsv.gz" : ".tsv";
+
+  shcore::ensure_dir_exists(options.output_dir);
+
+  std::vector<std::unique_ptr<Dump_session> > sessions;
+  for (int index = 0; index < options.threads; index++)
+    sessions.push_back(open_session(session));
+
+  start_consistent_snapshot(sessions);
+
+  // Reads the definitions on the snapshot and splits the tables in chunks
+  Dump_session &main = *sessions[0];
+  std::vector<Table_info> tables;
+  std::vector<Chunk_info> chunks;
+  shcore::Value::Map_type_ref manifest_schemas(new shcore::Value::Map_type());
+
+  for (auto &schema : options.schemas) {
+    std::string schema_ddl;
+    main.query(shcore::sqlstring("SHOW CREATE DATABASE !", 0) << schema,
+        [&schema_ddl](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+      schema_ddl.assign(data[1], lengths[1]);
+    });
+
+    std::string schema_file = encode_name(schema) + ".sql";
+    write_text_file(options.output_dir + DUMP_PATH_SEPARATOR + schema_file, schema_ddl + ";\n");
+
+    auto names = query_column(main, shcore::sqlstring(("SELECT " + main.as_text("TABLE_NAME") + " FROM information_schema.TABLES "
+        "WHERE TABLE_SCHEMA = ? AND TABLE_TYPE = 'BASE TABLE' ORDER BY TABLE_NAME").c_str(), 0) << schema);
+
+    for (auto &name : names) {
+      Table_info table;
+      table.schema = schema;
+      table.name = name;
+      table.base_name = encode_name(schema) + "@" + encode_name(name);
+
+      main.query(shcore::sqlstring("SHOW CREATE TABLE !.!", 0) << schema << name,
+          [&table](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+        table.ddl.assign(data[1], lengths[1]);
+      });
+      write_text_file(options.output_dir + DUMP_PATH_SEPARATOR + table.base_name + ".sql", table.ddl + ";\n");
+
+      table.select = "SELECT ";
+      main.query(shcore::sqlstring(("SELECT " + main.as_text("COLUMN_NAME") + ", " + main.as_text("CHARACTER_SET_NAME IS NOT NULL") +
+          ", " + main.as_text("DATA_TYPE") + ", " + main.as_text("COLUMN_TYPE") +
+          " FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? ORDER BY ORDINAL_POSITION").c_str(), 0) << schema << name,
+          [&](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+        table.columns.push_back(std::string(data[0], lengths[0]));
+        table.parquet_columns.push_back(shcore::Parquet_writer::Column(table.columns.back(),
+            parquet_type(std::string(data[2], lengths[2]), std::string(data[3], lengths[3]))));
+        if (table.columns.size() > 1)
+          table.select += ", ";
+        table.select += main.column_as_text(table.columns.back(), lengths[1] == 1 && data[1][0] == '1');
+      });
+      table.select += shcore::sqlstring(" FROM !.!", 0) << schema << name;
+
+      table.first_chunk = chunks.size();
+      add_table_chunks(main, table, tables.size(), options.chunk_rows, extension, chunks);
+      table.chunk_count = chunks.size() - table.first_chunk;
+
+      tables.push_back(table);
+    }
+
+    shcore::Value::Map_type_ref schema_map(new shcore::Value::Map_type());
+    (*schema_map)["ddl"] = shcore::Value(schema_file);
+    (*schema_map)["tables"] = shcore::Value(shcore::Value::Map_type_ref(new shcore::Value::Map_type()));
+    (*manifest_schemas)[schema] = shcore::Value(schema_map);
+  }
+
+  // The chunks are consumed by the sessions in parallel
+  std::atomic<size_t> next_chunk(0);
+  std::mutex errors_mutex;
+  shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+  std::vector<std::thread> workers;
+  for (auto &target : sessions) {
+    Dump_session *worker_session = target.get();
+    workers.push_back(std::thread([&, worker_session]() {
+      size_t current;
+      while ((current = next_chunk++) < chunks.size()) {
+        try {
+          dump_chunk(*worker_session, tables[chunks[current].table], chunks[current], options.output_dir, options);
+        } catch (std::exception &e) {
+          std::lock_guard<std::mutex> lock(errors_mutex);
+          errors->push_back(shcore::Value(chunks[current].file + ": " + e.what()));
+        }
+      }
+    }));
+  }
+
+  for (auto &worker : workers)
+    worker.join();
+
+  for (auto &target : sessions) {
+    try {
+      target->execute("COMMIT");
+    } catch (std::exception &) {
+      // The snapshot was only read, there is nothing left to do on it
+    }
+  }
+  sessions.clear();
+
+  // The manifest describes every table and its chunks
+  uint64_t total_rows = 0;
+  uint64_t total_bytes = 0;
+  for (auto &table : tables) {
+    shcore::Value::Array_type_ref columns(new shcore::Value::Array_type());
+    for (auto &column : table.columns)
+      columns->push_back(shcore::Value(column));
+
+    shcore::Value::Array_type_ref table_chunks(new shcore::Value::Array_type());
+    uint64_t table_rows = 0;
+    for (size_t index = table.first_chunk; index < table.first_chunk + table.chunk_count; index++) {
+      shcore::Value::Map_type_ref chunk(new shcore::Value::Map_type());
+      (*chunk)["file"] = shcore::Value(chunks[index].file);
+      (*chunk)["rows"] = shcore::Value(chunks[index].rows);
+      (*chunk)["bytes"] = shcore::Value(chunks[index].bytes);
+      table_chunks->push_back(shcore::Value(chunk));
+
+      table_rows += chunks[index].rows;
+      total_bytes += chunks[index].bytes;
+    }
+    total_rows += table_rows;
+
+    shcore::Value::Map_type_ref table_map(new shcore::Value::Map_type());
+    (*table_map)["ddl"] = shcore::Value(table.base_name + ".sql");
+    (*table_map)["columns"] = shcore::Value(columns);
+    (*table_map)["rows"] = shcore::Value(table_rows);
+    (*table_map)["chunks"] = shcore::Value(table_chunks);
+
+    (*manifest_schemas->get_map(table.schema)->get_map("tables"))[table.name] = shcore::Value(table_map);
+  }
+
+  shcore::Value::Map_type_ref manifest(new shcore::Value::Map_type());
+  (*manifest)["dialect"] = shcore::Value(options.format);
+  (*manifest)["characterSet"] = shcore::Value("utf8mb4");
+  (*manifest)["compression"] = shcore::Value(options.compression);
+  (*manifest)["schemas"] = shcore::Value(manifest_schemas);
+  write_text_file(options.output_dir + DUMP_PATH_SEPARATOR + "@.json", shcore::Value(manifest).json(true) + "\n");
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  (*ret_val)["tables"] = shcore::Value(static_cast<uint64_t>(tables.size()));
+  (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunks.size()));
+  (*ret_val)["rows"] = shcore::Value(total_rows);
+  (*ret_val)["bytes"] = shcore::Value(total_bytes);
+  (*ret_val)["seconds"] = shcore::Value(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  (*ret_val)["errors"] = shcore::Value(errors);
+
+  return ret_val;
+}
+shcore::Value::Map_type_ref export_documents(std::shared_ptr<ShellDevelopmentSession> session,
+                                             const Export_query &query,
+                                             const Export_options &options) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  std::vector<std::unique_ptr<X_dump_session> > sessions;
+  for (int index = 0; index < options.threads; index++)
+    sessions.push_back(std::unique_ptr<X_dump_session>(new X_dump_session(open_x_session(session))));
+
+  // As with the dumps, all the sessions read the same snapshot
+  start_consistent_snapshot(sessions);
+
+  std::vector<Export_chunk> chunks = export_chunks(*sessions[0], query, options.chunk_docs);
+  Export_writer writer(options);
+
+  std::atomic<size_t> next_chunk(0);
+  std::mutex errors_mutex;
+  shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+  std::vector<std::thread> workers;
+  for (auto &target : sessions) {
+    X_dump_session *worker_session = target.get();
+    workers.push_back(std::thread([&, worker_session]() {
+      size_t current;
+      while ((current = next_chunk++) < chunks.size()) {
+        try {
+          export_chunk(*worker_session, query, options, chunks[current], writer);
+        } catch (std::exception &e) {
+          std::lock_guard<std::mutex> lock(errors_mutex);
+          errors->push_back(shcore::Value("_id from '" + chunks[current].from + "' to '" + chunks[current].to + "': " + e.what()));
+        }
+      }
+    }));
+  }
+
+  for (auto &worker : workers)
+    worker.join();
+
+  for (auto &target : sessions) {
+    try {
+      target->execute("COMMIT");
+    } catch (std::exception &) {
+      // The snapshot was only read, there is nothing left to do on it
+    }
+  }
+  sessions.clear();
+
+  writer.close();
+
+  uint64_t total_documents = 0;
+  uint64_t total_bytes = 0;
+  for (auto &chunk : chunks) {
+    total_documents += chunk.documents;
+    total_bytes += chunk.bytes;
+  }
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunks.size()));
+  (*ret_val)["documents"] = shcore::Value(total_documents);
+  (*ret_val)["bytes"] = shcore::Value(total_bytes);
+  (*ret_val)["seconds"] = shcore::Value(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  (*ret_val)["errors"] = shcore::Value(errors);
+
+  return ret_val;
+}
+
+shcore::Value::Map_type_ref load_dump(std::shared_ptr<ShellDevelopmentSession> session,
+                                      const Load_options &options) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::string manifest_path = options.input_dir + DUMP_PATH_SEPARATOR + "@.json";
+  std::string manifest_data;
+
+  if (!shcore::load_text_file(manifest_path, manifest_data))
+    throw std::runtime_error("Unable to open the manifest '" + manifest_path + "': " + shcore::get_last_error());
+
+  shcore::Value manifest = shcore::Value::parse_json(manifest_data);
+  if (manifest.type != shcore::Map || !manifest.as_map()->has_key("schemas"))
+    throw std::runtime_error("The manifest '" + manifest_path + "' is not valid");
+
+  if (manifest.as_map()->has_key("dialect") && manifest.as_map()->get_string("dialect") != "tsv")
+    throw std::runtime_error("The dump in '" + options.input_dir + "' was written as " +
+                             manifest.as_map()->get_string("dialect") + ", only TSV dumps can be loaded");
+
+  Load_progress progress(options.progress_file, options.resume);
+
+  ::mysqlx::Batch_control batch_control(k_default_batch_rows, k_default_pipeline_depth);
+  std::vector<std::unique_ptr<Load_session> > sessions;
+  for (int index = 0; index < options.threads; index++) {
+    sessions.push_back(open_load_session(session, batch_control));
+    sessions.back()->execute("SET NAMES utf8mb4");
+    sessions.back()->execute("SET foreign_key_checks = 0");
+  }
+
+  // Creates the schemas and tables on the first session, the tables that
+  // were dumped with foreign keys keep their indexes
+  Load_session &main = *sessions[0];
+  std::vector<std::unique_ptr<Load_table> > tables;
+  std::vector<Load_task> tasks;
+  uint64_t skipped = 0;
+
+  for (auto &schema_entry : *manifest.as_map()->get_map("schemas")) {
+    auto schema = schema_entry.second.as_map();
+    std::string schema_ddl = read_statement(options.input_dir + DUMP_PATH_SEPARATOR + schema->get_string("ddl"));
+
+    main.execute(options.resume ? add_if_not_exists(schema_ddl, "CREATE DATABASE ") : schema_ddl);
+    main.execute(shcore::sqlstring("USE !", 0) << schema_entry.first);
+
+    for (auto &table_entry : *schema->get_map("tables")) {
+      auto table_map = table_entry.second.as_map();
+      std::unique_ptr<Load_table> table(new Load_table());
+      table->schema = schema_entry.first;
+      table->name = table_entry.first;
+      table->ddl_file = table_map->get_string("ddl");
+      table->bytes = 0;
+      table->pending_chunks = 0;
+      table->failed = false;
+
+      for (auto &column : *table_map->get_array("columns"))
+        table->columns.push_back(column.as_string());
+
+      std::string ddl = read_statement(options.input_dir + DUMP_PATH_SEPARATOR + table->ddl_file);
+      std::string create_ddl = ddl;
+      bool indexes_done = progress.is_done("indexes:" + table->ddl_file);
+
+      if (options.defer_indexes && !split_secondary_indexes(ddl, create_ddl, table->indexes))
+        create_ddl = ddl;
+
+      main.execute(options.resume ? add_if_not_exists(create_ddl, "CREATE TABLE ") : create_ddl);
+
+      for (auto &chunk : *table_map->get_array("chunks")) {
+        auto chunk_map = chunk.as_map();
+        uint64_t bytes = chunk_map->get_uint("bytes");
+        table->bytes += bytes;
+
+        if (progress.is_done(chunk_map->get_string("file"))) {
+          skipped++;
+        } else {
+          Load_task task = { table.get(), chunk_map->get_string("file"), bytes };
+          tasks.push_back(task);
+          table->pending_chunks++;
+        }
+      }
+
+      if (indexes_done)
+        table->indexes.clear();
+
+      // All the data of the table was loaded before the interruption
+      if (table->pending_chunks == 0 && !table->indexes.empty()) {
+        Load_task task = { table.get(), "", 0 };
+        tasks.push_back(task);
+      }
+
+      tables.push_back(std::move(table));
+    }
+  }
+
+  // The biggest tables go first, so they do not end up loading alone
+  std::stable_sort(tasks.begin(), tasks.end(), [](const Load_task &a, const Load_task &b) {
+    return a.table->bytes > b.table->bytes;
+  });
+
+  std::atomic<size_t> next_task(0);
+  std::atomic<uint64_t> rows(0);
+  std::atomic<uint64_t> loaded(0);
+  std::mutex errors_mutex;
+  shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+  auto add_error = [&](const std::string &message) {
+    std::lock_guard<std::mutex> lock(errors_mutex);
+    errors->push_back(shcore::Value(message));
+  };
+
+  auto build_indexes = [&](Load_session &target, Load_table &table) {
+    try {
+      create_indexes(target, table);
+      progress.set_done("indexes:" + table.ddl_file);
+    } catch (std::exception &e) {
+      add_error((shcore::sqlstring("Indexes of !.!: ", 0) << table.schema << table.name).str() + e.what());
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (auto &target : sessions) {
+    Load_session *worker_session = target.get();
+    workers.push_back(std::thread([&, worker_session]() {
+      size_t current;
+      while ((current = next_task++) < tasks.size()) {
+        Load_task &task = tasks[current];
+        if (task.file.empty()) {
+          build_indexes(*worker_session, *task.table);
+          continue;
+        }
+
+        try {
+          Input_file file(options.input_dir + DUMP_PATH_SEPARATOR + task.file);
+          rows += worker_session->load(task.table->schema, task.table->name, task.table->columns, file.data(), file.size());
+          progress.set_done(task.file);
+          loaded++;
+        } catch (std::exception &e) {
+          task.table->failed = true;
+          add_error(task.file + ": " + e.what());
+        }
+
+        // The worker loading the last chunk of a table creates its indexes
+        if (--task.table->pending_chunks == 0 && !task.table->failed && !task.table->indexes.empty())
+          build_indexes(*worker_session, *task.table);
+      }
+    }));
+  }
+
+  for (auto &worker : workers)
+    worker.join();
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  (*ret_val)["tables"] = shcore::Value(static_cast<uint64_t>(tables.size()));
+  (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(loaded));
+  (*ret_val)["skippedChunks"] = shcore::Value(skipped);
+  (*ret_val)["rows"] = shcore::Value(static_cast<uint64_t>(rows));
+  (*ret_val)["seconds"] = shcore::Value(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  (*ret_val)["errors"] = shcore::Value(errors);
+
+  return ret_val;
+}
+
+shcore::Value::Map_type_ref copy_tables(std::shared_ptr<ShellDevelopmentSession> source,
+                                        std::shared_ptr<ShellDevelopmentSession> target,
+                                        const Copy_options &options) {
+  auto start_time = std::chrono::steady_clock::now();
+
+  // The readers read the same snapshot, as the sessions of a dump
+  std::vector<std::unique_ptr<Dump_session> > readers;
+  for (int index = 0; index < options.threads; index++)
+    readers.push_back(open_session(source));
+  start_consistent_snapshot(readers);
+
+  ::mysqlx::Batch_control batch_control(k_default_batch_rows, k_default_pipeline_depth);
+  std::vector<std::unique_ptr<Load_session> > writers;
+  for (int index = 0; index < options.threads; index++) {
+    writers.push_back(open_load_session(target, batch_control));
+    writers.back()->execute("SET NAMES utf8mb4");
+    writers.back()->execute("SET foreign_key_checks = 0");
+  }
+
+  // The tables are created on the target and split in chunks as the ones of
+  // a dump, the chunk names only label the errors
+  Dump_session &main = *readers[0];
+  Load_session &main_writer = *writers[0];
+  std::vector<Table_info> tables;
+  std::vector<Chunk_info> chunks;
+  std::set<std::string> created_schemas;
+
+  for (auto &entry : list_tables(main, options.tables)) {
+    const std::string &schema = entry.first;
+    const std::string &name = entry.second;
+
+    if (created_schemas.insert(schema).second) {
+      std::string schema_ddl;
+      main.query(shcore::sqlstring("SHOW CREATE DATABASE !", 0) << schema,
+          [&schema_ddl](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+        schema_ddl.assign(data[1], lengths[1]);
+      });
+      main_writer.execute(add_if_not_exists(schema_ddl, "CREATE DATABASE "));
+    }
+
+    Table_info table;
+    table.schema = schema;
+    table.name = name;
+    table.base_name = schema + "." + name;
+
+    main.query(shcore::sqlstring("SHOW CREATE TABLE !.!", 0) << schema << name,
+        [&table](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+      table.ddl.assign(data[1], lengths[1]);
+    });
+
+    // An existing table is not overwritten, the error stops the copy
+    main_writer.execute(shcore::sqlstring("USE !", 0) << schema);
+    main_writer.execute(table.ddl);
+
+    table.select = "SELECT ";
+    main.query(shcore::sqlstring(("SELECT " + main.as_text("COLUMN_NAME") + ", " + main.as_text("CHARACTER_SET_NAME IS NOT NULL") +
+        " FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? ORDER BY ORDINAL_POSITION").c_str(), 0) << schema << name,
+        [&](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+      table.columns.push_back(std::string(data[0], lengths[0]));
+      if (table.columns.size() > 1)
+        table.select += ", ";
+      table.select += main.column_as_text(table.columns.back(), lengths[1] == 1 && data[1][0] == '1');
+    });
+    table.select += shcore::sqlstring(" FROM !.!", 0) << schema << name;
+
+    table.first_chunk = chunks.size();
+    add_table_chunks(main, table, tables.size(), options.chunk_rows, "", chunks);
+    table.chunk_count = chunks.size() - table.first_chunk;
+
+    tables.push_back(table);
+  }
+
+  // The readers turn the chunks into blocks of TSV data, loaded by the
+  // writers as they arrive, with no files in between
+  Copy_queue queue(2 * static_cast<size_t>(options.threads));
+  std::atomic<size_t> next_chunk(0);
+  std::atomic<uint64_t> rows(0);
+  std::atomic<uint64_t> bytes(0);
+  std::mutex errors_mutex;
+  shcore::Value::Array_type_ref errors(new shcore::Value::Array_type());
+
+  auto add_error = [&](const std::string &message) {
+    std::lock_guard<std::mutex> lock(errors_mutex);
+    errors->push_back(shcore::Value(message));
+  };
+
+  std::vector<std::thread> reader_threads;
+  for (auto &reader : readers) {
+    Dump_session *reader_session = reader.get();
+    reader_threads.push_back(std::thread([&, reader_session]() {
+      shcore::Text_dialect dialect = shcore::Text_dialect::tsv();
+      size_t current;
+      while ((current = next_chunk++) < chunks.size()) {
+        const Chunk_info &chunk = chunks[current];
+        Copy_block block = { chunk.table, chunk.file, std::string() };
+        block.data.reserve(k_copy_block_size + 4096);
+
+        try {
+          reader_session->query(tables[chunk.table].select + chunk.where,
+              [&](const std::vector<const char*> &data, const std::vector<size_t> &lengths) {
+            for (size_t index = 0; index < data.size(); index++) {
+              if (index)
+                block.data.append(1, dialect.fields_terminated_by);
+              shcore::append_field(block.data, data[index], lengths[index], dialect);
+            }
+            block.data.append(1, dialect.lines_terminated_by);
+
+            if (block.data.size() >= k_copy_block_size) {
+              bytes += block.data.size();
+              queue.push(std::move(block));
+              block = { chunk.table, chunk.file, std::string() };
+              block.data.reserve(k_copy_block_size + 4096);
+            }
+          });
+        } catch (std::exception &e) {
+          // The blocks already queued are still loaded
+          add_error(chunk.file + ": " + e.what() + " (the chunk was partially copied)");
+        }
+
+        if (!block.data.empty()) {
+          bytes += block.data.size();
+          queue.push(std::move(block));
+        }
+      }
+    }));
+  }
+
+  std::vector<std::thread> writer_threads;
+  for (auto &writer : writers) {
+    Load_session *writer_session = writer.get();
+    writer_threads.push_back(std::thread([&, writer_session]() {
+      Copy_block block;
+      while (queue.pop(block)) {
+        const Table_info &table = tables[block.table];
+        try {
+          rows += writer_session->load(table.schema, table.name, table.columns, block.data.data(), block.data.size());
+        } catch (std::exception &e) {
+          add_error(block.chunk + ": " + e.what());
+        }
+      }
+    }));
+  }
+
+  for (auto &thread : reader_threads)
+    thread.join();
+
+  queue.close();
+
+  for (auto &thread : writer_threads)
+    thread.join();
+
+  for (auto &reader : readers) {
+    try {
+      reader->execute("COMMIT");
+    } catch (std::exception &) {
+      // The snapshot was only read, there is nothing left to do on it
+    }
+  }
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  (*ret_val)["tables"] = shcore::Value(static_cast<uint64_t>(tables.size()));
+  (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunks.size()));
+  (*ret_val)["rows"] = shcore::Value(static_cast<uint64_t>(rows));
+  (*ret_val)["bytes"] = shcore::Value(static_cast<uint64_t>(bytes));
+  (*ret_val)["seconds"] = shcore::Value(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  (*ret_val)["errors"] = shcore::Value(errors);
+
+  return ret_val;
+}
+}
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Logical dump of schemas used by shell.dumpSchemas
+
+#ifndef _MOD_SHELL_DUMP_H_
+#define _MOD_SHELL_DUMP_H_
+
+#include "shellcore/types.h"
+#include "modules/base_session.h"
+#include "mysqlx_crud.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mysqlsh {
+namespace dump {
+struct Dump_options {
+  std::vector<std::string> schemas;
+  std::string output_dir;
+  int threads;
+  uint64_t chunk_rows;
+  std::string compression;   // none or gzip
+  std::string format;        // tsv or parquet
+  uint64_t row_group_rows;   // Rows of the row groups of the Parquet files
+};
+
+// Returns whether the compression is supported by this build
+bool SHCORE_PUBLIC is_compression_supported(const std::string &compression);
+
+// Dumps the schemas into the output directory, with the data of every table
+// in TSV chunk files readable by LOAD DATA (or Parquet files), the DDL of every object in a SQL
+// file and a manifest describing them (@.json). The chunks are read on
+// several sessions opened with the connection data of the given one, all of
+// them reading the same consistent snapshot.
+// Returns a dictionary with the totals and the errors found
+shcore::Value::Map_type_ref SHCORE_PUBLIC dump_schemas(std::shared_ptr<ShellDevelopmentSession> session,
+                                                       const Dump_options &options);
+
+struct Load_options {
+  std::string input_dir;
+  int threads;
+  bool resume;
+  bool defer_indexes;
+  std::string progress_file;
+};
+
+// Loads a directory written by dump_schemas on several sessions opened with
+// the connection data of the given one. The chunk files are scheduled from
+// the biggest tables down and every loaded chunk is recorded in the progress
+// file, so an interrupted load can be resumed skipping them.
+// Returns a dictionary with the totals and the errors found
+shcore::Value::Map_type_ref SHCORE_PUBLIC load_dump(std::shared_ptr<ShellDevelopmentSession> session,
+                                                    const Load_options &options);
+
+struct Export_options {
+  std::string path;
+  int threads;
+  uint64_t chunk_docs;
+  std::string compression;   // none or gzip
+  std::string format;        // json or parquet
+  uint64_t row_group_rows;
+};
+
+// The find operation of a collection export: the search condition and the
+// values bound to its placeholders
+struct Export_query {
+  std::string schema;
+  std::string collection;
+  std::string condition;
+  std::vector<std::pair<std::string, ::mysqlx::DocumentValue> > bindings;
+  // Bound to the list of an IN operator, as in _id IN :ids
+  std::vector<std::pair<std::string, std::vector< ::mysqlx::DocumentValue> > > list_bindings;
+};
+
+// Writes the documents found by the query to a file, one JSON document per
+// line as sent by the server, or as the single column of a Parquet file. The collection is split in chunks of about
+// chunk_docs documents on ranges of _id, found by sampling its primary key,
+// and the chunks are found by X sessions opened with the connection data of
+// the given one, reading the same consistent snapshot. The documents of the
+// chunks are interleaved on the file.
+// Returns a dictionary with the totals and the errors found
+shcore::Value::Map_type_ref SHCORE_PUBLIC export_documents(std::shared_ptr<ShellDevelopmentSession> session,
+                                                           const Export_query &query,
+                                                           const Export_options &options);
+
+struct Copy_options {
+  // schema.table or a schema for all its tables, all the schemas but the
+  // system ones if empty
+  std::vector<std::string> tables;
+  int threads;
+  uint64_t chunk_rows;
+};
+
+// Copies the tables from the source to the target with no intermediate
+// files. The tables are created on the target and split in chunks as the
+// ones of a dump, the chunks are read on several sessions opened with the
+// connection data of the source, all of them reading the same consistent
+// snapshot, and their rows are passed as blocks of TSV data through a
+// bounded queue to as many sessions opened with the connection data of the
+// target, which load them as they arrive.
+// Returns a dictionary with the totals and the errors found
+shcore::Value::Map_type_ref SHCORE_PUBLIC copy_tables(std::shared_ptr<ShellDevelopmentSession> source,
+                                                      std::shared_ptr<ShellDevelopmentSession> target,
+                                                      const Copy_options &options);
+
+// Reads the options dictionary of shell.copyTables, the options missing on
+// it keep their values. Throws an argument error for invalid values.
+void SHCORE_PUBLIC parse_copy_options(const shcore::Value::Map_type &map, Copy_options &options);
+
+// The ranges of an integer primary key, from its minimum to its maximum
+// value, for chunks of about chunk_rows of the given rows
+std::vector<std::pair<std::string, std::string> > SHCORE_PUBLIC chunk_key_ranges(const std::string &min,
+    const std::string &max, bool is_unsigned, uint64_t rows, uint64_t chunk_rows);
+
+// Removes the secondary indexes from a CREATE TABLE statement as given by
+// SHOW CREATE TABLE, returning their definitions. Returns false when the
+// indexes can not be created afterwards: the table has foreign keys or an
+// AUTO_INCREMENT column without a primary key
+bool SHCORE_PUBLIC split_secondary_indexes(const std::string &create_table, std::string &without_indexes,
+                                           std::vector<std::string> &indexes);
+}
+}
+
+#endif
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/mod_shell_parallel.h"
+#include "modules/mod_mysql_session.h"
+#include "modules/mod_sys.h"
+#include "modules/mod_utils.h"
+#include "modules/mysql_connection.h"
+#include "modules/session_pool.h"
+#include "shellcore/object_registry.h"
+#include "utils/utils_general.h"
+#include "utils/utils_sqlstring.h"
+#ifdef HAVE_V8
+#include "shellcore/jscript_context.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mysqlsh {
+namespace parallel {
+namespace {
+// The workers print through the delegate of the shell one text at a time
+struct Worker_output {
+  shcore::Interpreter_delegate *target;
+  std::mutex mutex;
+};
+
+void print(void *user_data, const char *text) {
+  Worker_output *output = static_cast<Worker_output*>(user_data);
+  std::lock_guard<std::mutex> lock(output->mutex);
+
+  if (output->target && output->target->print)
+    output->target->print(output->target->user_data, text);
+}
+
+void print_error(void *user_data, const char *text) {
+  Worker_output *output = static_cast<Worker_output*>(user_data);
+  std::lock_guard<std::mutex> lock(output->mutex);
+
+  if (output->target && output->target->print_error)
+    output->target->print_error(output->target->user_data, text);
+}
+
+#ifdef HAVE_V8
+// Copies the lists and dictionaries of a value going into or out of a
+// worker, the ones given to a context are wrapped rather than converted, so
+// each worker gets its own. A function lives in the context that created it
+// and is gone with it, so one anywhere in the value is refused with the
+// error given. Objects are shared as any global of the workers.
+shcore::Value copy_value(const shcore::Value &value, const std::string &function_error) {
+  if (value.type == shcore::Function)
+    throw shcore::Exception::runtime_error(function_error);
+
+  if (value.type == shcore::Array) {
+    shcore::Value::Array_type_ref copy(new shcore::Value::Array_type());
+    for (auto &item : *value.as_array())
+      copy->push_back(copy_value(item, function_error));
+    return shcore::Value(copy);
+  }
+
+  if (value.type == shcore::Map) {
+    shcore::Value::Map_type_ref copy(new shcore::Value::Map_type());
+    for (auto &item : *value.as_map())
+      (*copy)[item.first] = copy_value(item.second, function_error);
+    return shcore::Value(copy);
+  }
+
+  return value;
+}
+
+// Creates the JavaScript context of a worker, V8 is initialized by the first
+// context created, which is not thread safe
+std::unique_ptr<shcore::JScript_context> create_context(shcore::Object_registry *registry,
+                                                        shcore::Interpreter_delegate *delegate,
+                                                        std::mutex &init_mutex) {
+  std::unique_ptr<shcore::JScript_context> context;
+  {
+    std::lock_guard<std::mutex> lock(init_mutex);
+    context.reset(new shcore::JScript_context(registry, delegate));
+  }
+
+  context->set_global("sys", shcore::Value::wrap<mysqlsh::Sys>(new mysqlsh::Sys(nullptr)));
+  return context;
+}
+
+// Errors listed at most by a scan, the chunks left are skipped once reached
+const size_t k_max_scan_errors = 100;
+
+// Seconds the server waits for the reading session while the function runs
+// on a batch, the rest of the chunk is still being sent
+const int k_scan_write_timeout = 3600;
+
+// A part of the table read by a single query
+struct Scan_chunk {
+  std::string partition;     // The quoted partition, empty if not partitioned
+  bool whole;                // The whole partition, the table has no integer key or no rows
+  std::string first;
+  std::string last;
+};
+
+// Returns the values of the first row of the query as text, NULL values are
+// empty strings
+std::vector<std::string> query_row(mysql::Connection &connection, const std::string &sql) {
+  std::vector<std::string> values;
+
+  auto result = connection.run_sql(sql);
+  if (const mysql::Row *row = result->fetch_one_view()) {
+    for (size_t index = 0; index < result->get_metadata().size(); index++) {
+      size_t length;
+      const char *data = row->get_data(static_cast<int>(index), length);
+      values.push_back(data ? std::string(data, length) : std::string());
+    }
+  }
+  while (result->fetch_one_view()) {}
+
+  return values;
+}
+
+// Splits the table on its partitions, or subpartitions, and on ranges of
+// its primary key of about chunk_rows rows from the estimates of the server
+std::vector<Scan_chunk> scan_chunks(mysql::Connection &connection, const Scan_options &options,
+                                    std::string *key) {
+  std::string from = shcore::sqlstring("!.!", 0) << options.schema << options.table;
+
+  std::vector<std::vector<std::string> > partitions;
+  {
+    auto result = connection.run_sql(shcore::sqlstring(
+        "SELECT PARTITION_NAME, SUBPARTITION_NAME, TABLE_ROWS FROM information_schema.PARTITIONS "
+        "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? ORDER BY PARTITION_ORDINAL_POSITION, SUBPARTITION_ORDINAL_POSITION", 0)
+        << options.schema << options.table);
+    while (const mysql::Row *row = result->fetch_one_view()) {
+      std::vector<std::string> values;
+      for (int index = 0; index < 3; index++) {
+        size_t length;
+        const char *data = row->get_data(index, length);
+        values.push_back(data ? std::string(data, length) : std::string());
+      }
+      partitions.push_back(values);
+    }
+  }
+
+  if (partitions.empty())
+    throw shcore::Exception::argument_error("The table " + options.schema + "." + options.table + " does not exist");
+
+  std::vector<std::string> primary;
+  {
+    auto result = connection.run_sql(shcore::sqlstring(
+        "SELECT k.COLUMN_NAME, c.COLUMN_TYPE FROM information_schema.STATISTICS k JOIN information_schema.COLUMNS c "
+        "ON c.TABLE_SCHEMA = k.TABLE_SCHEMA AND c.TABLE_NAME = k.TABLE_NAME AND c.COLUMN_NAME = k.COLUMN_NAME "
+        "WHERE k.TABLE_SCHEMA = ? AND k.TABLE_NAME = ? AND k.INDEX_NAME = 'PRIMARY' ORDER BY k.SEQ_IN_INDEX", 0)
+        << options.schema << options.table);
+    while (const mysql::Row *row = result->fetch_one_view()) {
+      primary.push_back(row->get_value_as_string(0));
+      primary.push_back(row->get_value_as_string(1));
+    }
+  }
+
+  bool is_unsigned = false;
+  key->clear();
+  if (primary.size() == 2 && primary[1].find("int") != std::string::npos) {
+    *key = shcore::sqlstring("!", 0) << primary[0];
+    is_unsigned = primary[1].find("unsigned") != std::string::npos;
+  }
+
+  std::vector<Scan_chunk> chunks;
+  for (auto &partition : partitions) {
+    Scan_chunk chunk;
+    chunk.whole = true;
+    if (!partition[1].empty())
+      chunk.partition = shcore::sqlstring("!", 0) << partition[1];
+    else if (!partition[0].empty())
+      chunk.partition = shcore::sqlstring("!", 0) << partition[0];
+
+    std::vector<std::string> bounds;
+    if (!key->empty())
+      bounds = query_row(connection, "SELECT MIN(" + *key + "), MAX(" + *key + ") FROM " + from +
+                         (chunk.partition.empty() ? "" : " PARTITION (" + chunk.partition + ")"));
+
+    // A partition with no rows, or without an integer key, is read whole
+    if (bounds.size() != 2 || bounds[0].empty()) {
+      chunks.push_back(chunk);
+      continue;
+    }
+
+    uint64_t first = key_to_offset(bounds[0], is_unsigned);
+    uint64_t last = key_to_offset(bounds[1], is_unsigned);
+    uint64_t rows = partition[2].empty() ? 0 : std::stoull(partition[2]);
+
+    chunk.whole = false;
+    for (auto &offsets : split_offsets(first, last, (rows + options.chunk_rows - 1) / options.chunk_rows)) {
+      chunk.first = offset_to_key(offsets.first, is_unsigned);
+      chunk.last = offset_to_key(offsets.second, is_unsigned);
+      chunks.push_back(chunk);
+    }
+  }
+
+  return chunks;
+}
+
+#endif
+}
+
+bool is_supported() {
+#ifdef HAVE_V8
+  return true;
+#else
+  return false;
+#endif
+}
+
+shcore::Value::Array_type_ref run(const std::vector<Task> &tasks, int workers,
+                                  std::shared_ptr<ShellDevelopmentSession> session,
+                                  shcore::Interpreter_delegate *delegate) {
+  shcore::Value::Array_type_ref ret_val(new shcore::Value::Array_type(tasks.size()));
+
+#ifdef HAVE_V8
+  workers = std::max(1, std::min(workers, static_cast<int>(tasks.size())));
+
+  // The sessions are opened upfront, so connection errors are reported
+  // before anything runs
+  std::vector<std::shared_ptr<ShellDevelopmentSession> > sessions;
+  if (session) {
+    for (int index = 0; index < workers; index++)
+      sessions.push_back(clone_session(session));
+  }
+
+  Worker_output output;
+  output.target = delegate;
+
+  shcore::Interpreter_delegate worker_delegate;
+  worker_delegate.user_data = &output;
+  worker_delegate.print = &print;
+  worker_delegate.print_error = &print_error;
+
+  std::atomic<size_t> next(0);
+  std::mutex errors_mutex;
+  std::vector<std::string> errors;
+  std::vector<std::string> task_errors(tasks.size());
+  std::mutex init_mutex;
+
+  auto work = [&](size_t worker) {
+    shcore::Object_registry registry;
+    std::unique_ptr<shcore::JScript_context> context;
+
+    try {
+      context = create_context(&registry, &worker_delegate, init_mutex);
+      if (!sessions.empty())
+        context->set_global("session", shcore::Value(std::static_pointer_cast<shcore::Object_bridge>(sessions[worker])));
+    } catch (std::exception &e) {
+      std::lock_guard<std::mutex> lock(errors_mutex);
+      errors.push_back("Worker #" + std::to_string(worker + 1) + ": " + e.what());
+      return;
+    }
+
+    size_t current;
+    while ((current = next++) < tasks.size()) {
+      try {
+        shcore::Value args(shcore::Value::new_array());
+        if (tasks[current].args)
+          args = copy_value(shcore::Value(tasks[current].args), "A task can not be given a function");
+
+        context->set_global("__task_args", args);
+        shcore::Value result = context->execute("(" + tasks[current].code + ").apply(null, __task_args)",
+                                                "task #" + std::to_string(current + 1));
+
+        (*ret_val)[current] = copy_value(result, "A task can not return a function");
+      } catch (std::exception &e) {
+        task_errors[current] = e.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int index = 0; index < workers; index++)
+    threads.push_back(std::thread(work, static_cast<size_t>(index)));
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (auto &target : sessions)
+    target->close(shcore::Argument_list());
+
+  for (size_t index = 0; index < tasks.size(); index++) {
+    if (!task_errors[index].empty())
+      errors.push_back("Task #" + std::to_string(index + 1) + ": " + task_errors[index]);
+  }
+
+  if (!errors.empty()) {
+    throw shcore::Exception::runtime_error(shcore::join_strings(errors, "\n"));
+  }
+#else
+  (void)workers;
+  (void)session;
+  (void)delegate;
+  throw shcore::Exception::runtime_error("This build has no JavaScript support to run the tasks");
+#endif
+
+  return ret_val;
+}
+
+shcore::Value::Map_type_ref scan(const Scan_options &options, const shcore::Value::Map_type_ref &connection_data,
+                                 shcore::Interpreter_delegate *delegate) {
+#ifdef HAVE_V8
+  auto start_time = std::chrono::steady_clock::now();
+
+  shcore::Argument_list session_args;
+  session_args.push_back(shcore::Value(connection_data));
+
+  std::string key;
+  std::vector<Scan_chunk> chunks;
+  {
+    auto session = Session_pool::get()->acquire(session_args);
+    try {
+      chunks = scan_chunks(*session->connection(), options, &key);
+    } catch (...) {
+      Session_pool::get()->release(session);
+      throw;
+    }
+    Session_pool::get()->release(session);
+  }
+
+  std::string select = shcore::sqlstring("SELECT * FROM !.!", 0) << options.schema << options.table;
+  int workers = std::max(1, std::min(options.threads, static_cast<int>(chunks.size())));
+
+  Worker_output output;
+  output.target = delegate;
+
+  shcore::Interpreter_delegate worker_delegate;
+  worker_delegate.user_data = &output;
+  worker_delegate.print = &print;
+  worker_delegate.print_error = &print_error;
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> total_rows(0);
+  std::atomic<uint64_t> total_batches(0);
+  std::mutex init_mutex;
+
+  // Guards the errors and the results of the workers
+  std::mutex mutex;
+  std::vector<std::string> errors;
+  size_t error_count = 0;
+  int finished = 0;
+  shcore::Value::Array_type_ref partials(new shcore::Value::Array_type());
+  shcore::Value result;
+
+  auto add_error = [&](const std::string &error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (++error_count <= k_max_scan_errors)
+      errors.push_back(error);
+    if (error_count >= k_max_scan_errors)
+      stop = true;
+  };
+
+  auto work = [&](size_t worker) {
+    shcore::Object_registry registry;
+    std::unique_ptr<shcore::JScript_context> context;
+    std::shared_ptr<mysql::ClassicSession> reader;
+    std::shared_ptr<mysql::ClassicSession> writer;
+    shcore::Value accumulated;
+    bool has_result = false;
+
+    try {
+      context = create_context(&registry, &worker_delegate, init_mutex);
+      // The functions are compiled once by every worker
+      context->execute("var __scan_function = (" + options.function + ");", "scan function");
+      if (!options.reduce.empty())
+        context->execute("var __scan_reduce = (" + options.reduce + ");", "scan reducer");
+
+      reader = Session_pool::get()->acquire(session_args);
+      reader->connection()->run_sql("SET SESSION net_write_timeout = " + std::to_string(k_scan_write_timeout));
+      writer = Session_pool::get()->acquire(session_args);
+      context->set_global("session", shcore::Value(std::static_pointer_cast<shcore::Object_bridge>(writer)));
+    } catch (std::exception &e) {
+      add_error("Worker #" + std::to_string(worker + 1) + ": " + e.what());
+      context.reset();
+    }
+
+    // Calls the function with the batch and combines its result with the
+    // ones before
+    auto run_batch = [&](shcore::Value::Array_type_ref batch, size_t chunk) {
+      context->set_global("__scan_batch", shcore::Value(batch));
+      shcore::Value value = copy_value(context->execute("__scan_function(__scan_batch)",
+                                                        "chunk #" + std::to_string(chunk + 1)),
+                                       "The scan function can not return a function");
+
+      if (!options.reduce.empty()) {
+        if (has_result) {
+          context->set_global("__scan_accumulated", accumulated);
+          context->set_global("__scan_value", value);
+          accumulated = copy_value(context->execute("__scan_reduce(__scan_accumulated, __scan_value)", "scan reducer"),
+                                   "The scan reducer can not return a function");
+        } else {
+          accumulated = value;
+          has_result = true;
+        }
+      }
+
+      total_rows += batch->size();
+      total_batches++;
+    };
+
+    size_t current;
+    while (context && !stop && (current = next++) < chunks.size()) {
+      const Scan_chunk &chunk = chunks[current];
+
+      std::string sql = select;
+      if (!chunk.partition.empty())
+        sql += " PARTITION (" + chunk.partition + ")";
+      if (!chunk.whole)
+        sql += " WHERE " + key + " BETWEEN " + chunk.first + " AND " + chunk.last;
+      if (!options.where.empty())
+        sql += (chunk.whole ? " WHERE (" : " AND (") + options.where + ")";
+
+      try {
+        auto rows = reader->connection()->run_sql(sql);
+        std::vector<std::string> columns;
+        for (auto &field : rows->get_metadata())
+          columns.push_back(field.name());
+
+        shcore::Value::Array_type_ref batch(new shcore::Value::Array_type());
+        batch->reserve(static_cast<size_t>(std::min<uint64_t>(options.chunk_rows, 100000)));
+
+        while (const mysql::Row *row = rows->fetch_one_view()) {
+          shcore::Value::Map_type_ref values(new shcore::Value::Map_type());
+          for (size_t index = 0; index < columns.size(); index++)
+            (*values)[columns[index]] = row->get_value(static_cast<int>(index));
+          batch->push_back(shcore::Value(values));
+
+          if (batch->size() >= options.chunk_rows) {
+            run_batch(batch, current);
+            batch.reset(new shcore::Value::Array_type());
+          }
+        }
+
+        if (!batch->empty())
+          run_batch(batch, current);
+      } catch (std::exception &e) {
+        add_error(describe_chunk(options.schema, options.table, chunk.partition, chunk.whole, chunk.first, chunk.last) +
+                  ": " + e.what());
+
+        // The error may have left the reading session unusable, the next
+        // chunks are read by a new one
+        reader->close(shcore::Argument_list());
+        try {
+          reader = Session_pool::get()->acquire(session_args);
+          reader->connection()->run_sql("SET SESSION net_write_timeout = " + std::to_string(k_scan_write_timeout));
+        } catch (std::exception &error) {
+          reader.reset();
+          add_error("Worker #" + std::to_string(worker + 1) + ": " + error.what());
+          break;
+        }
+      }
+    }
+
+    // The results of the workers are combined by the last one finishing,
+    // they are plain values copied between the contexts
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (has_result)
+        partials->push_back(accumulated);
+
+      if (++finished == workers && context && !options.reduce.empty() && !partials->empty()) {
+        try {
+          result = (*partials)[0];
+          for (size_t index = 1; index < partials->size(); index++) {
+            context->set_global("__scan_accumulated", result);
+            context->set_global("__scan_value", (*partials)[index]);
+            result = copy_value(context->execute("__scan_reduce(__scan_accumulated, __scan_value)", "scan reducer"),
+                                "The scan reducer can not return a function");
+          }
+        } catch (std::exception &e) {
+          errors.push_back(std::string("Combining the results of the workers: ") + e.what());
+          result = shcore::Value();
+        }
+      } else if (finished == workers && !context && partials->size() > 1) {
+        errors.push_back("The results of the workers could not be combined");
+      } else if (finished == workers && partials->size() == 1) {
+        result = (*partials)[0];
+      }
+    }
+
+    // The session global goes with the context, before going back to the pool
+    context.reset();
+    if (reader)
+      Session_pool::get()->release(reader);
+    if (writer)
+      Session_pool::get()->release(writer);
+
+    mysql_thread_end();
+  };
+
+  std::vector<std::thread> threads;
+  for (int index = 0; index < workers; index++)
+    threads.push_back(std::thread(work, static_cast<size_t>(index)));
+
+  for (auto &thread : threads)
+    thread.join();
+
+  if (error_count > errors.size())
+    errors.push_back(std::to_string(error_count - errors.size()) + " more errors");
+  if (stop && next < chunks.size())
+    errors.push_back("The scan was stopped after " + std::to_string(k_max_scan_errors) + " errors");
+
+  shcore::Value::Array_type_ref error_list(new shcore::Value::Array_type());
+  for (auto &error : errors)
+    error_list->push_back(shcore::Value(error));
+
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type());
+  (*ret_val)["chunks"] = shcore::Value(static_cast<uint64_t>(chunks.size()));
+  (*ret_val)["batches"] = shcore::Value(static_cast<uint64_t>(total_batches));
+  (*ret_val)["rows"] = shcore::Value(static_cast<uint64_t>(total_rows));
+  (*ret_val)["seconds"] = shcore::Value(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+  if (!options.reduce.empty())
+    (*ret_val)["result"] = result;
+  (*ret_val)["errors"] = shcore::Value(error_list);
+
+  return ret_val;
+#else
+  (void)options;
+  (void)connection_data;
+  (void)delegate;
+  throw shcore::Exception::runtime_error("This build has no JavaScript support to run the tasks");
+#endif
+}
+}
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Worker threads running JavaScript tasks, used by shell.parallel and
+// shell.parallelScan
+
+#ifndef _MOD_SHELL_PARALLEL_H_
+#define _MOD_SHELL_PARALLEL_H_
+
+#include "shellcore/types.h"
+#include "shellcore/lang_base.h"
+#include "modules/base_session.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mysqlsh {
+namespace parallel {
+// The source of a JavaScript function and the arguments it is called with
+struct Task {
+  std::string code;
+  shcore::Value::Array_type_ref args;
+};
+
+// Returns whether the tasks can be run by this build
+bool SHCORE_PUBLIC is_supported();
+
+// Runs the tasks on the given number of worker threads, each with its own
+// JavaScript context. When a session is given every worker also opens its
+// own session with the connection data of that one, available to the tasks
+// as the session global. The output of the tasks goes to the delegate.
+// Returns the values returned by the tasks, in the order of the tasks, once
+// all of them ran. If any task failed an error listing the failures is thrown.
+shcore::Value::Array_type_ref SHCORE_PUBLIC run(const std::vector<Task> &tasks, int workers,
+                                                std::shared_ptr<ShellDevelopmentSession> session,
+                                                shcore::Interpreter_delegate *delegate);
+
+struct Scan_options {
+  std::string schema;
+  std::string table;
+  // The source of the JavaScript function called with every batch of rows
+  std::string function;
+  // The source of the JavaScript function combining two results, optional
+  std::string reduce;
+  // A condition the scanned rows must meet, optional
+  std::string where;
+  int threads;
+  uint64_t chunk_rows;
+};
+
+// Reads the table on the given number of worker threads, each with its own
+// JavaScript context and two classic sessions of the session pool opened
+// with the connection data: one reading the rows and one available to the
+// function as the session global. The table is split on its partitions and,
+// when its primary key is a single integer column, on ranges of the key of
+// about chunk_rows rows. The rows are given to the function in batches of at
+// most chunk_rows rows, as dictionaries. When there is a reducer the results
+// of the function are combined by every worker as they come, then the ones
+// of the workers by the last worker finishing.
+// Returns a dictionary with the totals, the reduced result and the errors
+shcore::Value::Map_type_ref SHCORE_PUBLIC scan(const Scan_options &options,
+                                               const shcore::Value::Map_type_ref &connection_data,
+                                               shcore::Interpreter_delegate *delegate);
+}
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/mod_utils.h"
+#include "modules/mod_mysql_session.h"
+#include "utils/utils_connection.h"
+#include "utils/utils_mysql_parsing.h"
+#include "utils/utils_sqlstring.h"
+
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cctype>
+#include <stack>
+
+namespace mysqlsh {
+namespace {
+const uint64_t k_sign_bit = static_cast<uint64_t>(1) << 63;
+
+// Returns the first keyword of the statement skipping comments, for
+// executable comments (i.e. /*!40101 SET ... */) the inner keyword is used
+std::string get_first_keyword(const std::string &statement) {
+  size_t index = 0;
+  size_t size = statement.size();
+
+  while (index < size) {
+    if (std::isspace(static_cast<unsigned char>(statement[index]))) {
+      index++;
+    } else if (statement.compare(index, 2, "--") == 0 || statement[index] == '#') {
+      index = statement.find('\n', index);
+      if (index == std::string::npos)
+        index = size;
+    } else if (statement.compare(index, 3, "/*!") == 0) {
+      index += 3;
+      while (index < size && std::isdigit(static_cast<unsigned char>(statement[index])))
+        index++;
+    } else if (statement.compare(index, 2, "/*") == 0) {
+      index = statement.find("*/", index + 2);
+      index = (index == std::string::npos) ? size : index + 2;
+    } else {
+      break;
+    }
+  }
+
+  size_t end = index;
+  while (end < size && std::isalpha(static_cast<unsigned char>(statement[end])))
+    end++;
+
+  return boost::to_upper_copy(statement.substr(index, end - index));
+}
+}
+
+shcore::Value::Map_type_ref session_connection_data(std::shared_ptr<ShellDevelopmentSession> session) {
+  shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(session->uri(), false);
+  (*connection_data)[shcore::kDbPassword] = shcore::Value(session->get_password());
+  if (!session->get_ssl_ca().empty())
+    (*connection_data)[shcore::kSslCa] = shcore::Value(session->get_ssl_ca());
+  if (!session->get_ssl_cert().empty())
+    (*connection_data)[shcore::kSslCert] = shcore::Value(session->get_ssl_cert());
+  if (!session->get_ssl_key().empty())
+    (*connection_data)[shcore::kSslKey] = shcore::Value(session->get_ssl_key());
+
+  return connection_data;
+}
+
+std::shared_ptr<ShellDevelopmentSession> clone_session(std::shared_ptr<ShellDevelopmentSession> session) {
+  SessionType type = std::dynamic_pointer_cast<mysql::ClassicSession>(session) ? SessionType::Classic
+                                                                                : SessionType::Node;
+
+  shcore::Argument_list session_args;
+  session_args.push_back(shcore::Value(session_connection_data(session)));
+
+  return connect_session(session_args, type);
+}
+
+uint64_t key_to_offset(const std::string &value, bool is_unsigned) {
+  if (is_unsigned)
+    return std::stoull(value);
+
+  return static_cast<uint64_t>(std::stoll(value)) ^ k_sign_bit;
+}
+
+std::string offset_to_key(uint64_t offset, bool is_unsigned) {
+  if (is_unsigned)
+    return std::to_string(offset);
+
+  return std::to_string(static_cast<int64_t>(offset ^ k_sign_bit));
+}
+
+shcore::Value offset_to_value(uint64_t offset, bool is_unsigned) {
+  if (is_unsigned)
+    return shcore::Value(offset);
+
+  return shcore::Value(static_cast<int64_t>(offset ^ k_sign_bit));
+}
+
+std::vector<std::pair<uint64_t, uint64_t> > split_offsets(uint64_t first, uint64_t last, uint64_t count) {
+  std::vector<std::pair<uint64_t, uint64_t> > ranges;
+
+  uint64_t step = (last - first) / std::max<uint64_t>(1, count);
+  if (step < UINT64_MAX)
+    step++;
+
+  for (uint64_t start = first; ; start += step) {
+    uint64_t end = (last - start < step) ? last : start + step - 1;
+    ranges.push_back(std::make_pair(start, end));
+    if (end == last)
+      break;
+  }
+
+  return ranges;
+}
+
+std::string table_filter(const std::vector<std::string> &names, const std::string &prefix) {
+  if (names.empty())
+    return prefix + "TABLE_SCHEMA NOT IN ('mysql', 'sys', 'information_schema', 'performance_schema', "
+           "'mysql_innodb_cluster_metadata')";
+
+  std::string filter;
+  for (auto &name : names) {
+    filter += filter.empty() ? "(" : " OR ";
+
+    size_t dot = name.find('.');
+    if (dot == std::string::npos)
+      filter += shcore::sqlstring((prefix + "TABLE_SCHEMA = ?").c_str(), 0) << name;
+    else
+      filter += shcore::sqlstring(("(" + prefix + "TABLE_SCHEMA = ? AND " + prefix + "TABLE_NAME = ?)").c_str(), 0)
+                << name.substr(0, dot) << name.substr(dot + 1);
+  }
+
+  return filter + ")";
+}
+
+bool table_matches(const std::string &name, const std::string &schema, const std::string &table) {
+  size_t dot = name.find('.');
+  if (dot == std::string::npos)
+    return schema == name;
+
+  return schema == name.substr(0, dot) && table == name.substr(dot + 1);
+}
+
+std::string describe_chunk(const std::string &schema, const std::string &table, const std::string &partition,
+                           bool whole, const std::string &first, const std::string &last) {
+  std::string description = schema + "." + table;
+  if (!partition.empty())
+    description += " partition " + partition;
+  if (!whole)
+    description += " (" + first + " to " + last + ")";
+  return description;
+}
+
+std::vector<std::string> split_sql_statements(const std::string &data) {
+  std::vector<std::string> statements;
+  shcore::mysql::splitter::Delimiters delimiters({";"});
+  std::stack<std::string> context;
+  auto ranges = shcore::mysql::splitter::determineStatementRanges(data.data(),
+      data.length(), delimiters, "\n", context);
+
+  for (auto &range : ranges) {
+    std::string statement = data.substr(range.offset(), range.length());
+    if (!boost::trim_copy(statement).empty())
+      statements.push_back(statement);
+  }
+
+  return statements;
+}
+
+Load_statement_type get_statement_type(const std::string &statement) {
+  std::string keyword = get_first_keyword(statement);
+
+  if (keyword == "INSERT" || keyword == "REPLACE")
+    return Load_statement_type::Data;
+  else if (keyword == "USE" || keyword == "SET")
+    return Load_statement_type::Session;
+  else if (keyword == "LOCK" || keyword == "UNLOCK")
+    return Load_statement_type::Lock;
+
+  return Load_statement_type::Other;
+}
+}
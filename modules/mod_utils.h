@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Helpers shared by the shell functions working on whole tables:
+// shell.dumpTables, shell.loadTables, shell.compareTables and
+// shell.parallelScan, and the statement handling of shell.loadSqlParallel
+
+#ifndef _MOD_UTILS_H_
+#define _MOD_UTILS_H_
+
+#include "shellcore/types.h"
+#include "modules/base_session.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mysqlsh {
+// The connection data of the session, with its password and SSL options
+shcore::Value::Map_type_ref SHCORE_PUBLIC session_connection_data(std::shared_ptr<ShellDevelopmentSession> session);
+
+// Opens a session of the same type with the connection data of the given one
+std::shared_ptr<ShellDevelopmentSession> SHCORE_PUBLIC clone_session(std::shared_ptr<ShellDevelopmentSession> session);
+
+// Integer primary key values are mapped to unsigned offsets keeping their
+// order, so signed and unsigned keys can be split the same way
+uint64_t SHCORE_PUBLIC key_to_offset(const std::string &value, bool is_unsigned);
+std::string SHCORE_PUBLIC offset_to_key(uint64_t offset, bool is_unsigned);
+shcore::Value SHCORE_PUBLIC offset_to_value(uint64_t offset, bool is_unsigned);
+
+// Splits the offsets from first to last, both included, in count ranges of
+// about the same size, fewer if there are not enough offsets
+std::vector<std::pair<uint64_t, uint64_t> > SHCORE_PUBLIC split_offsets(uint64_t first, uint64_t last, uint64_t count);
+
+// The condition on the TABLE_SCHEMA and TABLE_NAME columns of
+// information_schema selecting the given names, schema.table or a schema for
+// all its tables, all the schemas but the system ones if none is given. The
+// prefix goes before the column names, as the alias of the table.
+std::string SHCORE_PUBLIC table_filter(const std::vector<std::string> &names, const std::string &prefix = "");
+
+// Returns whether the table is selected by the name, schema.table or its
+// schema
+bool SHCORE_PUBLIC table_matches(const std::string &name, const std::string &schema, const std::string &table);
+
+// Describes a part of a table for the errors, schema.table followed by the
+// partition if any and by the range of keys unless it is the whole table
+std::string SHCORE_PUBLIC describe_chunk(const std::string &schema, const std::string &table,
+                                         const std::string &partition, bool whole, const std::string &first,
+                                         const std::string &last);
+
+// Statement kinds as seen by shell.loadSqlParallel
+enum class Load_statement_type {
+  Data,       // INSERT/REPLACE, can run on any session
+  Session,    // USE/SET, must be applied to every session
+  Lock,       // LOCK/UNLOCK TABLES, skipped
+  Other       // Anything else, runs alone on the first session
+};
+
+// Splits a SQL script in its statements, without the delimiters, skipping
+// the empty ones
+std::vector<std::string> SHCORE_PUBLIC split_sql_statements(const std::string &data);
+
+// The kind of the statement by its first keyword, comments are skipped and
+// for executable comments (i.e. /*!40101 SET ... */) the inner keyword is used
+Load_statement_type SHCORE_PUBLIC get_statement_type(const std::string &statement);
+}
+
+#endif
@@ -31,13 +31,167 @@ using namespace mysqlsh::mysql;
 
 #include "shellcore/object_factory.h"
 #include "shellcore/common.h"
+#include "myasio/tls_session_cache.h"
 #include <stdlib.h>
+#include <errmsg.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #define MAX_COLUMN_LENGTH 1024
+
+namespace {
+Field::Converter converter_for(int type, int flags) {
+  switch (type) {
+    case MYSQL_TYPE_NULL:
+      return Field::As_null;
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_TIME:
+#if MYSQL_MAJOR_VERSION > 5 || (MYSQL_MAJOR_VERSION == 5 && MYSQL_MINOR_VERSION >= 7)
+    case MYSQL_TYPE_TIME2:
+#endif
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_GEOMETRY:
+    case MYSQL_TYPE_JSON:
+      return Field::As_string;
+
+    case MYSQL_TYPE_LONGLONG:
+      // The only type whose unsigned values do not fit in an int64_t
+      if (flags & UNSIGNED_FLAG)
+        return Field::As_unsigned;
+      return Field::As_integer;
+
+    case MYSQL_TYPE_YEAR:
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+      return Field::As_integer;
+
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+      return Field::As_double;
+
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+#if MYSQL_MAJOR_VERSION > 5 || (MYSQL_MAJOR_VERSION == 5 && MYSQL_MINOR_VERSION >= 7)
+    case MYSQL_TYPE_DATETIME2:
+    case MYSQL_TYPE_TIMESTAMP2:
+#endif
+      return Field::As_date;
+
+    case MYSQL_TYPE_BIT:
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET:
+      // TODO: Read these types properly
+      break;
+  }
+
+  return Field::As_undefined;
+}
+
+bool is_long_data(int type) {
+  switch (type) {
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+      return true;
+  }
+
+  return false;
+}
+
+// Parses the digits of a value sent as text, false if there is anything
+// else in it or it does not fit
+bool parse_digits(const char *data, size_t length, uint64_t *value) {
+  if (length == 0)
+    return false;
+
+  uint64_t result = 0;
+  for (size_t index = 0; index < length; index++) {
+    unsigned digit = static_cast<unsigned char>(data[index]) - '0';
+    if (digit > 9)
+      return false;
+
+    // 19 digits always fit, the 20th may not
+    if (index >= 19 && (result > UINT64_MAX / 10 || result * 10 > UINT64_MAX - digit))
+      return false;
+
+    result = result * 10 + digit;
+  }
+
+  *value = result;
+  return true;
+}
+
+bool parse_integer(const char *data, size_t length, int64_t *value) {
+  bool negative = length && data[0] == '-';
+  uint64_t magnitude;
+
+  if (!parse_digits(data + negative, length - negative, &magnitude))
+    return false;
+
+  if (negative) {
+    if (magnitude > static_cast<uint64_t>(INT64_MAX) + 1)
+      return false;
+    *value = static_cast<int64_t>(0 - magnitude);
+  } else {
+    if (magnitude > static_cast<uint64_t>(INT64_MAX))
+      return false;
+    *value = static_cast<int64_t>(magnitude);
+  }
+
+  return true;
+}
+
+// Plain decimals with up to 15 significant digits are exact as double, as
+// are the powers of ten up to 1e22, so a single division rounds correctly.
+// Exponents and longer values are left to the generic conversion.
+bool parse_double(const char *data, size_t length, double *value) {
+  static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+  bool negative = length && data[0] == '-';
+  const char *digits = data + negative;
+  const char *end = data + length;
+  const char *point = std::find(digits, end, '.');
+
+  size_t integer_length = point - digits;
+  size_t fraction_length = point == end ? 0 : end - point - 1;
+  if (integer_length + fraction_length > 15 || (integer_length == 0 && fraction_length == 0))
+    return false;
+
+  uint64_t integer = 0, fraction = 0;
+  if (integer_length && !parse_digits(digits, integer_length, &integer))
+    return false;
+  if (fraction_length && !parse_digits(point + 1, fraction_length, &fraction))
+    return false;
+
+  double result = static_cast<double>(integer * static_cast<uint64_t>(powers_of_ten[fraction_length]) + fraction);
+  if (fraction_length)
+    result /= powers_of_ten[fraction_length];
+
+  *value = negative ? -result : result;
+  return true;
+}
+}
+
 #define MIN_COLUMN_LENGTH 4
 
 Result::Result(std::shared_ptr<Connection> owner, my_ulonglong affected_rows_, unsigned int warning_count_, uint64_t last_insert_id, const char *info_)
-  : _connection(owner), _affected_rows(affected_rows_), _last_insert_id(last_insert_id), _warning_count(warning_count_), _fetched_row_count(0), _execution_time(0), _has_resultset(false) {
+  : _connection(owner), _affected_rows(affected_rows_), _last_insert_id(last_insert_id), _warning_count(warning_count_), _fetched_row_count(0), _execution_time(0), _has_resultset(false),
+  _row_view(NULL, NULL, &_metadata), _execution(0) {
   if (info_)
     _info.assign(info_);
 }
@@ -74,31 +228,88 @@ int Result::fetch_metadata() {
 
 Result::~Result() {}
 
-std::unique_ptr<Row> Result::fetch_one() {
-  std::unique_ptr<Row> ret_val = nullptr;
-
+bool Result::fetch_next(MYSQL_ROW &row, unsigned long *&lengths) {
   if (has_resultset()) {
     // Loads the first row
     std::shared_ptr<MYSQL_RES> res = _result.lock();
 
     if (res) {
-      MYSQL_ROW mysql_row = mysql_fetch_row(res.get());
-      if (mysql_row) {
-        unsigned long *lengths;
+      row = mysql_fetch_row(res.get());
+      if (row) {
         lengths = mysql_fetch_lengths(res.get());
 
-        ret_val = std::unique_ptr<Row>(new Row(mysql_row, lengths, &_metadata));
-
         // Each read row increases the count
         _fetched_row_count++;
+        return true;
       }
+
+      _warning_count = _connection->get_warning_count();
     }
   }
 
-  return ret_val;
+  return false;
+}
+
+bool Result::fetch_next(std::vector<shcore::Value> &values, std::vector<unsigned long> &lengths) {
+  if (!_has_resultset)
+    return false;
+
+  if (!_statement->fetch(_execution, values, lengths)) {
+    _warning_count = _connection->get_warning_count();
+    return false;
+  }
+
+  _fetched_row_count++;
+  return true;
+}
+
+std::unique_ptr<Row> Result::fetch_one() {
+  if (_statement) {
+    std::vector<shcore::Value> values;
+    std::vector<unsigned long> lengths;
+
+    if (fetch_next(values, lengths))
+      return std::unique_ptr<Row>(new Row(std::move(values), std::move(lengths), &_metadata));
+
+    return nullptr;
+  }
+
+  MYSQL_ROW mysql_row;
+  unsigned long *lengths;
+
+  if (fetch_next(mysql_row, lengths))
+    return std::unique_ptr<Row>(new Row(mysql_row, lengths, &_metadata));
+
+  return nullptr;
+}
+
+const Row *Result::fetch_one_view() {
+  if (_statement) {
+    std::vector<shcore::Value> values;
+    std::vector<unsigned long> lengths;
+
+    if (!fetch_next(values, lengths))
+      return nullptr;
+
+    _row_view.reset(std::move(values), std::move(lengths));
+    return &_row_view;
+  }
+
+  MYSQL_ROW mysql_row;
+  unsigned long *lengths;
+
+  if (!fetch_next(mysql_row, lengths))
+    return nullptr;
+
+  _row_view.reset(mysql_row, lengths);
+  return &_row_view;
 }
 
 bool Result::next_data_set() {
+  // Prepared statements only keep their first result set
+  if (_statement)
+    return false;
+
   return _connection->next_data_set(this);
 }
 
@@ -115,6 +326,14 @@ void Result::reset(std::shared_ptr<MYSQL_RES> res, unsigned long duration) {
   _execution_time = duration;
 }
 
+void Result::reset(std::shared_ptr<Statement> statement, unsigned long duration) {
+  _statement = statement;
+  _execution = statement->execution();
+  _has_resultset = !statement->get_metadata().empty();
+  _metadata = statement->get_metadata();
+  _execution_time = duration;
+}
+
 Field::Field(const std::string& catalog_, const std::string& db_, const std::string& table_, const std::string& otable, const std::string& name_, const std::string& oname, int length_, int type_, int flags_, int decimals_, int charset_) :
 _catalog(catalog_),
 _db(db_),
@@ -128,75 +347,102 @@ _flags(flags_),
 _decimals(decimals_),
 _charset(charset_),
 _max_length(0),
-_name_length(name_.length()) {}
+_name_length(name_.length()),
+_converter(converter_for(type_, flags_)) {}
 
 Row::Row(MYSQL_ROW row, unsigned long *lengths, std::vector<Field>* metadata) :
 _row(row), _lengths(lengths), _metadata(metadata) {}
 
-shcore::Value Row::get_value(int index) {
+Row::Row(std::vector<shcore::Value> &&values, std::vector<unsigned long> &&lengths, std::vector<Field>* metadata) :
+_row(NULL), _lengths(NULL), _metadata(metadata), _values(std::move(values)), _value_lengths(std::move(lengths)) {}
+
+void Row::reset(std::vector<shcore::Value> &&values, std::vector<unsigned long> &&lengths) {
+  _row = NULL;
+  _lengths = NULL;
+  _values = std::move(values);
+  _value_lengths = std::move(lengths);
+}
+
+bool Row::is_null(int index) const {
+  if (_row)
+    return _row[index] == NULL;
+
+  return _values[index].type == shcore::Null;
+}
+
+shcore::Value Row::get_value(int index) const {
+  if (!_row)
+    return _values[index];
+
   if (_row[index] == NULL)
     return shcore::Value::Null();
-  else {
-    switch ((*_metadata)[index].type()) {
-      case MYSQL_TYPE_NULL:
-        return shcore::Value::Null();
-      case MYSQL_TYPE_DECIMAL:
-      case MYSQL_TYPE_DATE:
-      case MYSQL_TYPE_NEWDATE:
-      case MYSQL_TYPE_TIME:
-#if MYSQL_MAJOR_VERSION > 5 || (MYSQL_MAJOR_VERSION == 5 && MYSQL_MINOR_VERSION >= 7)
-      case MYSQL_TYPE_TIME2:
-#endif
-      case MYSQL_TYPE_STRING:
-      case MYSQL_TYPE_VARCHAR:
-      case MYSQL_TYPE_VAR_STRING:
-      case MYSQL_TYPE_NEWDECIMAL:
-      case MYSQL_TYPE_TINY_BLOB:
-      case MYSQL_TYPE_MEDIUM_BLOB:
-      case MYSQL_TYPE_LONG_BLOB:
-      case MYSQL_TYPE_BLOB:
-      case MYSQL_TYPE_GEOMETRY:
-      case MYSQL_TYPE_JSON:
-
-        return shcore::Value(std::string(_row[index], _lengths[index]));
-
-      case MYSQL_TYPE_YEAR:
-      case MYSQL_TYPE_TINY:
-      case MYSQL_TYPE_SHORT:
-      case MYSQL_TYPE_INT24:
-      case MYSQL_TYPE_LONG:
-      case MYSQL_TYPE_LONGLONG:
-        return shcore::Value(boost::lexical_cast<int64_t>(_row[index]));
-
-      case MYSQL_TYPE_FLOAT:
-      case MYSQL_TYPE_DOUBLE:
-        return shcore::Value(boost::lexical_cast<double>(_row[index]));
-        break;
 
-      case MYSQL_TYPE_DATETIME:
-      case MYSQL_TYPE_TIMESTAMP:
-#if MYSQL_MAJOR_VERSION > 5 || (MYSQL_MAJOR_VERSION == 5 && MYSQL_MINOR_VERSION >= 7)
-      case MYSQL_TYPE_DATETIME2:
-      case MYSQL_TYPE_TIMESTAMP2:
-#endif
-        return shcore::Value(shcore::Date::unrepr(_row[index]));
-        break;
+  const char *data = _row[index];
+  size_t length = _lengths[index];
 
-      case MYSQL_TYPE_BIT:
-      case MYSQL_TYPE_ENUM:
-      case MYSQL_TYPE_SET:
-        // TODO: Read these types properly
-        break;
+  switch ((*_metadata)[index].converter()) {
+    case Field::As_null:
+      return shcore::Value::Null();
+
+    case Field::As_string:
+      return shcore::Value(data, length);
+
+    case Field::As_integer: {
+      int64_t value;
+      if (parse_integer(data, length, &value))
+        return shcore::Value(value);
+      return shcore::Value(boost::lexical_cast<int64_t>(data));
+    }
+
+    case Field::As_unsigned: {
+      // Kept as a signed integer while it fits, like the other integers
+      uint64_t value;
+      if (!parse_digits(data, length, &value))
+        value = boost::lexical_cast<uint64_t>(data);
+
+      if (value <= static_cast<uint64_t>(INT64_MAX))
+        return shcore::Value(static_cast<int64_t>(value));
+      return shcore::Value(value);
+    }
+
+    case Field::As_double: {
+      double value;
+      if (parse_double(data, length, &value))
+        return shcore::Value(value);
+      return shcore::Value(boost::lexical_cast<double>(data));
     }
+
+    case Field::As_date:
+      return shcore::Value(shcore::Date::unrepr(data));
+
+    case Field::As_undefined:
+      break;
   }
 
   return shcore::Value();
 }
 
-std::string Row::get_value_as_string(int index) {
+std::string Row::get_value_as_string(int index) const {
+  if (!_row)
+    return _values[index].type == shcore::Null ? "NULL" : _values[index].descr();
+
   return _row[index] ? _row[index] : "NULL";
 }
 
+size_t Row::get_data_size() const {
+  size_t size = 0;
+
+  if (!_row) {
+    for (auto length : _value_lengths)
+      size += length;
+  } else if (_metadata) {
+    for (size_t index = 0; index < _metadata->size(); index++)
+      size += _lengths[index];
+  }
+
+  return size;
+}
+
 //----------------------------------------------
 void Connection::throw_on_connection_fail() {
   std::string local_error(mysql_error(_mysql));
@@ -239,11 +485,50 @@ Connection::Connection(const std::string &uri_, const char *password)
   }
 }
 
+namespace {
+// Data sent to the server when it asks for the file of a LOAD DATA LOCAL,
+// whatever the name of the file is
+struct Local_infile_data {
+  const char *data;
+  size_t size;
+  size_t offset;
+};
+
+int local_infile_init(void **ptr, const char *, void *userdata) {
+  *ptr = userdata;
+  return userdata ? 0 : 1;
+}
+
+int local_infile_read(void *ptr, char *buffer, unsigned int length) {
+  Local_infile_data *source = static_cast<Local_infile_data*>(ptr);
+  size_t count = std::min<size_t>(length, source->size - source->offset);
+
+  std::memcpy(buffer, source->data + source->offset, count);
+  source->offset += count;
+
+  return static_cast<int>(count);
+}
+
+void local_infile_end(void *) {
+}
+
+int local_infile_error(void *, char *message, unsigned int length) {
+  std::strncpy(message, "LOAD DATA LOCAL is only allowed on the data given by the shell", length);
+  message[length - 1] = '\0';
+  return CR_UNKNOWN_ERROR;
+}
+}
+
 Connection::Connection(const std::string &host, int port, const std::string &socket, const std::string &user, const std::string &password, const std::string &schema,
-  const struct shcore::SslInfo& ssl_info)
+  const struct shcore::SslInfo& ssl_info, bool local_infile,
+  const std::string &compression, int compression_level, int timeout)
 : _mysql(NULL) {
   long flags = CLIENT_MULTI_RESULTS | CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS;
 
+  // Racing the hosts of a list is only done by the X protocol connections
+  if (host.find(',') != std::string::npos)
+    throw shcore::Exception::argument_error("A list of hosts is not supported by classic sessions");
+
   _mysql = mysql_init(NULL);
 
   std::stringstream str;
@@ -254,9 +539,170 @@ Connection::Connection(const std::string &host, int port, const std::string &soc
 
   unsigned int tcp = MYSQL_PROTOCOL_TCP;
   mysql_options(_mysql, MYSQL_OPT_PROTOCOL, &tcp);
-  if (!mysql_real_connect(_mysql, host.c_str(), user.c_str(), password.c_str(), schema.empty() ? NULL : schema.c_str(), port, socket.empty() ? NULL : socket.c_str(), flags)) {
+
+  if (local_infile) {
+    // The handler with no data refuses any request of the server
+    unsigned int enable = 1;
+    mysql_options(_mysql, MYSQL_OPT_LOCAL_INFILE, &enable);
+    mysql_set_local_infile_handler(_mysql, local_infile_init, local_infile_read, local_infile_end, local_infile_error, NULL);
+  }
+
+  setup_compression(compression, compression_level);
+
+  if (timeout > 0) {
+    unsigned int seconds = static_cast<unsigned int>(timeout);
+    mysql_options(_mysql, MYSQL_OPT_CONNECT_TIMEOUT, &seconds);
+    mysql_options(_mysql, MYSQL_OPT_READ_TIMEOUT, &seconds);
+    mysql_options(_mysql, MYSQL_OPT_WRITE_TIMEOUT, &seconds);
+  }
+
+#if MYSQL_VERSION_ID >= 80029
+  // Reconnections to the same server resume the TLS session of the last one
+  std::string session_key = "classic|" + std::to_string(ssl_info.mode) + "|" + ssl_info.tls_version + "|" + ssl_info.ciphers + "|" +
+                            ssl_info.ca + "|" + ssl_info.capath + "|" + ssl_info.crl + "|" + ssl_info.crlpath + "|" +
+                            ssl_info.cert + "|" + ssl_info.key + "@" + host + ":" + std::to_string(port) + ":" + socket;
+  std::string session_data;
+
+  if (ngs::Tls_session_cache::instance().get(session_key, session_data))
+    mysql_options(_mysql, MYSQL_OPT_SSL_SESSION_DATA, session_data.c_str());
+#endif
+
+  // A local server is reached through its socket (its named pipe on
+  // Windows) once known, falling back to TCP when it does not work
+  bool local = socket.empty() && port != 0 && shcore::is_local_host(host, true);
+  std::string local_socket;
+  bool known = local && shcore::get_local_socket(port, &local_socket);
+  bool connected = false;
+
+  if (!local_socket.empty()) {
+#ifdef _WIN32
+    unsigned int protocol = MYSQL_PROTOCOL_PIPE;
+    const char *local_host = ".";
+#else
+    unsigned int protocol = MYSQL_PROTOCOL_SOCKET;
+    const char *local_host = "localhost";
+#endif
+    mysql_options(_mysql, MYSQL_OPT_PROTOCOL, &protocol);
+    connected = mysql_real_connect(_mysql, local_host, user.c_str(), password.c_str(), schema.empty() ? NULL : schema.c_str(), 0, local_socket.c_str(), flags) != NULL;
+
+    if (!connected) {
+      // Errors of the server, like a wrong password, would be the same over TCP
+      unsigned int error = mysql_errno(_mysql);
+      if (error < CR_MIN_ERROR || error > CR_MAX_ERROR)
+        throw_on_connection_fail();
+
+      shcore::forget_local_socket(port);
+      known = false;
+      mysql_options(_mysql, MYSQL_OPT_PROTOCOL, &tcp);
+    }
+  }
+
+  if (!connected && !mysql_real_connect(_mysql, host.c_str(), user.c_str(), password.c_str(), schema.empty() ? NULL : schema.c_str(), port, socket.empty() ? NULL : socket.c_str(), flags)) {
     throw_on_connection_fail();
   }
+
+  if (local && !known)
+    remember_local_sockets(port);
+
+#if MYSQL_VERSION_ID >= 80029
+  // No data when the connection is not encrypted
+  void *data = mysql_get_ssl_session_data(_mysql, 0, NULL);
+  if (data) {
+    ngs::Tls_session_cache::instance().put(session_key, static_cast<const char*>(data));
+    mysql_free_ssl_session_data(_mysql, data);
+  }
+#endif
+}
+
+void Connection::remember_local_sockets(int port) {
+  // The sockets just stay unknown when the query fails, like it does for
+  // the accounts with an expired password
+  if (mysql_query(_mysql, shcore::k_local_sockets_query))
+    return;
+
+  MYSQL_RES *result = mysql_store_result(_mysql);
+  if (!result)
+    return;
+
+  std::map<std::string, std::string> variables;
+  while (MYSQL_ROW row = mysql_fetch_row(result)) {
+    if (row[0] && row[1])
+      variables[row[0]] = row[1];
+  }
+  mysql_free_result(result);
+
+  shcore::remember_local_sockets(port, variables);
+}
+
+void Connection::run_script(const std::string &script) {
+  discard_results();
+
+  if (mysql_set_server_option(_mysql, MYSQL_OPTION_MULTI_STATEMENTS_ON) != 0)
+    throw shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql));
+
+  // mysql_next_result() returns -1 after the last result and a positive
+  // value if the next statement failed
+  int status = mysql_real_query(_mysql, script.c_str(), script.length());
+  if (status == 0) {
+    do {
+      MYSQL_RES *result = mysql_store_result(_mysql);
+      if (result)
+        mysql_free_result(result);
+    } while ((status = mysql_next_result(_mysql)) == 0);
+  }
+
+  std::unique_ptr<shcore::Exception> error;
+  if (status > 0)
+    error.reset(new shcore::Exception(
+      shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql))));
+
+  mysql_set_server_option(_mysql, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+
+  if (error)
+    throw *error;
+}
+
+std::unique_ptr<Result> Connection::run_load_data_local(const std::string &sql, const char *data, size_t size) {
+  Local_infile_data source = { data, size, 0 };
+
+  mysql_set_local_infile_handler(_mysql, local_infile_init, local_infile_read, local_infile_end, local_infile_error, &source);
+
+  std::unique_ptr<Result> result;
+  try {
+    result = run_sql(sql);
+  } catch (...) {
+    mysql_set_local_infile_handler(_mysql, local_infile_init, local_infile_read, local_infile_end, local_infile_error, NULL);
+    throw;
+  }
+
+  mysql_set_local_infile_handler(_mysql, local_infile_init, local_infile_read, local_infile_end, local_infile_error, NULL);
+
+  return result;
+}
+
+void Connection::setup_compression(const std::string &algorithm, int level) {
+  if (algorithm.empty())
+    return;
+
+  if (algorithm != "auto" && algorithm != "zlib" && algorithm != "zstd")
+    throw shcore::Exception::argument_error("Invalid compression algorithm '" + algorithm + "', it must be any of [auto, zlib, zstd]");
+
+#if MYSQL_VERSION_ID >= 80018
+  // Newer client libraries negotiate the algorithm, auto prefers zstd
+  std::string algorithms = algorithm == "auto" ? "zstd,zlib" : algorithm;
+  mysql_options(_mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS, algorithms.c_str());
+
+  if (level >= 0 && algorithm != "zlib") {
+    unsigned int zstd_level = static_cast<unsigned int>(level);
+    mysql_options(_mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL, &zstd_level);
+  }
+#else
+  if (algorithm == "zstd")
+    throw shcore::Exception::argument_error("The zstd compression is not supported by the MySQL client library");
+
+  // The zlib level is not configurable in the classic protocol
+  mysql_options(_mysql, MYSQL_OPT_COMPRESS, NULL);
+#endif
 }
 
 bool Connection::setup_ssl(const struct shcore::SslInfo& ssl_info) {
@@ -310,7 +756,7 @@ void Connection::close() {
   _mysql = NULL;
 }
 
-std::unique_ptr<Result> Connection::run_sql(const std::string &query) {
+void Connection::discard_results() {
   if (_prev_result) {
     _prev_result.reset();
 
@@ -319,6 +765,17 @@ std::unique_ptr<Result> Connection::run_sql(const std::string &query) {
       mysql_free_result(trailing_result);
     }
   }
+}
+
+void Connection::reset() {
+  discard_results();
+
+  if (mysql_reset_connection(_mysql) != 0)
+    throw shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql));
+}
+
+std::unique_ptr<Result> Connection::run_sql(const std::string &query) {
+  discard_results();
 
   _timer.start();
 
@@ -334,6 +791,26 @@ std::unique_ptr<Result> Connection::run_sql(const std::string &query) {
   return result;
 }
 
+std::shared_ptr<Statement> Connection::prepare(const std::string &sql) {
+  discard_results();
+
+  MYSQL_STMT *stmt = mysql_stmt_init(_mysql);
+  if (!stmt)
+    throw shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql));
+
+  if (mysql_stmt_prepare(stmt, sql.c_str(), sql.length()) != 0) {
+    shcore::Exception error(shcore::Exception::mysql_error_with_code_and_state(mysql_stmt_error(stmt), mysql_stmt_errno(stmt), mysql_stmt_sqlstate(stmt)));
+    mysql_stmt_close(stmt);
+    throw error;
+  }
+
+  // The buffers of the string columns are sized from the longest value
+  my_bool update_max_length = 1;
+  mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &update_max_length);
+
+  return std::shared_ptr<Statement>(new Statement(shared_from_this(), stmt));
+}
+
 template <class T>
 static void free_result(T* result) {
   mysql_free_result(result);
@@ -382,3 +859,349 @@ Connection::~Connection() {
   _prev_result.reset();
   close();
 }
+
+Statement::Statement(std::shared_ptr<Connection> owner, MYSQL_STMT *stmt)
+  : _connection(owner), _stmt(stmt), _param_count(mysql_stmt_param_count(stmt)), _execution(0), _has_result(false) {}
+
+Statement::~Statement() {
+  close();
+}
+
+void Statement::close() {
+  if (_stmt) {
+    discard_result();
+    mysql_stmt_close(_stmt);
+    _stmt = NULL;
+  }
+}
+
+void Statement::throw_error() {
+  throw shcore::Exception::mysql_error_with_code_and_state(mysql_stmt_error(_stmt), mysql_stmt_errno(_stmt), mysql_stmt_sqlstate(_stmt));
+}
+
+void Statement::discard_result() {
+  if (_has_result) {
+    _has_result = false;
+
+    mysql_stmt_free_result(_stmt);
+    while (mysql_stmt_next_result(_stmt) == 0)
+      mysql_stmt_free_result(_stmt);
+  }
+}
+
+std::unique_ptr<Result> Statement::execute(const std::vector<shcore::Value> &params) {
+  if (!_stmt)
+    throw shcore::Exception::logic_error("The statement is closed");
+
+  if (params.size() != _param_count)
+    throw shcore::Exception::argument_error((boost::format("The statement expects %1% parameters, %2% given") % _param_count % params.size()).str());
+
+  // The rows of the previous execution are gone once it runs again
+  discard_result();
+  _connection->discard_results();
+  _execution++;
+
+  // The parameters are sent from where they are, only the numbers and dates
+  // need a place of their own
+  std::vector<MYSQL_BIND> binds(params.size());
+  std::vector<int64_t> integers(params.size());
+  std::vector<double> numbers(params.size());
+  std::vector<MYSQL_TIME> times(params.size());
+  std::vector<unsigned long> lengths(params.size());
+
+  for (size_t index = 0; index < params.size(); index++) {
+    const shcore::Value &param = params[index];
+    MYSQL_BIND &bind = binds[index];
+    memset(&bind, 0, sizeof(bind));
+
+    if (_streams.count(index)) {
+      bind.buffer_type = MYSQL_TYPE_BLOB;
+      continue;
+    }
+
+    switch (param.type) {
+      case shcore::Null:
+      case shcore::Undefined:
+        bind.buffer_type = MYSQL_TYPE_NULL;
+        break;
+      case shcore::Bool:
+        integers[index] = param.as_bool() ? 1 : 0;
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &integers[index];
+        break;
+      case shcore::Integer:
+        integers[index] = param.as_int();
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &integers[index];
+        break;
+      case shcore::UInteger:
+        integers[index] = static_cast<int64_t>(param.as_uint());
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &integers[index];
+        bind.is_unsigned = 1;
+        break;
+      case shcore::Float:
+        numbers[index] = param.as_double();
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &numbers[index];
+        break;
+      case shcore::String: {
+        const std::string &data = param.as_string();
+        lengths[index] = static_cast<unsigned long>(data.size());
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = const_cast<char*>(data.data());
+        bind.buffer_length = lengths[index];
+        bind.length = &lengths[index];
+        break;
+      }
+      case shcore::Object: {
+        std::shared_ptr<shcore::Date> date = param.as_object<shcore::Date>();
+        if (date) {
+          MYSQL_TIME &time = times[index];
+          memset(&time, 0, sizeof(time));
+          time.year = date->get_year();
+          time.month = date->get_month();
+          time.day = date->get_day();
+          time.hour = date->get_hour();
+          time.minute = date->get_min();
+          time.second = static_cast<unsigned int>(date->get_sec());
+          time.second_part = static_cast<unsigned long>((date->get_sec() - time.second) * 1000000);
+          time.time_type = MYSQL_TIMESTAMP_DATETIME;
+
+          bind.buffer_type = MYSQL_TYPE_DATETIME;
+          bind.buffer = &time;
+          break;
+        }
+      }
+      // Fall through
+      default:
+        throw shcore::Exception::argument_error((boost::format("Unsupported value received for parameter %1%: %2%") % (index + 1) % param.descr()).str());
+    }
+  }
+
+  if (!binds.empty() && mysql_stmt_bind_param(_stmt, binds.data()))
+    throw_error();
+
+  // The streams are only used once
+  std::map<size_t, std::string> streams;
+  streams.swap(_streams);
+  try {
+    for (auto &stream : streams)
+      send_long_data(stream.first, stream.second);
+  } catch (...) {
+    // Drops the data already sent, it would be used on the next execution
+    mysql_stmt_reset(_stmt);
+    throw;
+  }
+
+  MySQL_timer timer;
+  timer.start();
+
+  if (mysql_stmt_execute(_stmt) != 0)
+    throw_error();
+
+  MYSQL *mysql = _connection->_mysql;
+  std::unique_ptr<Result> result(new Result(_connection, mysql_stmt_affected_rows(_stmt), mysql_warning_count(mysql),
+                                            mysql_stmt_insert_id(_stmt), mysql_info(mysql)));
+
+  _metadata.clear();
+  if (mysql_stmt_field_count(_stmt)) {
+    // Buffered, so the connection is free for other statements while the
+    // rows are read
+    if (mysql_stmt_store_result(_stmt) != 0)
+      throw_error();
+
+    _has_result = true;
+    bind_result();
+  }
+
+  timer.end();
+  result->reset(shared_from_this(), timer.raw_duration());
+
+  return result;
+}
+
+void Statement::bind_result() {
+  std::shared_ptr<MYSQL_RES> res(mysql_stmt_result_metadata(_stmt), &mysql_free_result);
+  unsigned int num_fields = mysql_num_fields(res.get());
+  MYSQL_FIELD *fields = mysql_fetch_fields(res.get());
+
+  _columns.resize(num_fields);
+  _binds.resize(num_fields);
+
+  for (unsigned int index = 0; index < num_fields; index++) {
+    _metadata.push_back(Field(fields[index].catalog,
+      fields[index].db,
+      fields[index].table,
+      fields[index].org_table,
+      fields[index].name,
+      fields[index].org_name,
+      fields[index].length,
+      fields[index].type,
+      fields[index].flags,
+      fields[index].decimals,
+      fields[index].charsetnr));
+
+    // The client library converts each value to the type of its buffer
+    Column_buffer &column = _columns[index];
+    MYSQL_BIND &bind = _binds[index];
+    memset(&bind, 0, sizeof(bind));
+    bind.length = &column.length;
+    bind.is_null = &column.is_null;
+    bind.error = &column.error;
+
+    switch (_metadata.back().converter()) {
+      case Field::As_integer:
+      case Field::As_unsigned:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &column.integer;
+        bind.is_unsigned = _metadata.back().converter() == Field::As_unsigned;
+        break;
+      case Field::As_double:
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &column.number;
+        break;
+      case Field::As_date:
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &column.time;
+        break;
+      case Field::As_string:
+        column.long_data = is_long_data(fields[index].type);
+        if (column.long_data) {
+          // Only the length is fetched with the row
+          bind.buffer_type = MYSQL_TYPE_BLOB;
+          break;
+        }
+
+        // Room for the longest value of the result and its terminator
+        column.data.resize(fields[index].max_length + 1);
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = &column.data[0];
+        bind.buffer_length = static_cast<unsigned long>(column.data.size());
+        break;
+      case Field::As_null:
+      case Field::As_undefined:
+        bind.buffer_type = MYSQL_TYPE_NULL;
+        break;
+    }
+  }
+
+  if (mysql_stmt_bind_result(_stmt, _binds.data()))
+    throw_error();
+}
+
+bool Statement::fetch(uint64_t execution, std::vector<shcore::Value> &values, std::vector<unsigned long> &lengths) {
+  if (!_has_result || execution != _execution)
+    return false;
+
+  // The long data columns are always reported as truncated
+  int status = mysql_stmt_fetch(_stmt);
+  if (status == MYSQL_NO_DATA)
+    return false;
+  else if (status == 1)
+    throw_error();
+
+  values.resize(_columns.size());
+  lengths.resize(_columns.size());
+
+  for (size_t index = 0; index < _columns.size(); index++) {
+    Column_buffer &column = _columns[index];
+    lengths[index] = column.length;
+
+    if (column.is_null) {
+      values[index] = shcore::Value::Null();
+      continue;
+    }
+
+    switch (_metadata[index].converter()) {
+      case Field::As_null:
+        values[index] = shcore::Value::Null();
+        break;
+      case Field::As_integer:
+        values[index] = shcore::Value(column.integer);
+        break;
+      case Field::As_unsigned:
+        // Kept as a signed integer while it fits, like on the text protocol
+        if (column.integer >= 0)
+          values[index] = shcore::Value(column.integer);
+        else
+          values[index] = shcore::Value(static_cast<uint64_t>(column.integer));
+        break;
+      case Field::As_double:
+        values[index] = shcore::Value(column.number);
+        break;
+      case Field::As_date:
+        values[index] = shcore::Value(std::shared_ptr<shcore::Object_bridge>(new shcore::Date(column.time.year, column.time.month, column.time.day,
+          column.time.hour, column.time.minute, column.time.second + column.time.second_part / 1000000.0f)));
+        break;
+      case Field::As_string:
+        if (column.long_data)
+          values[index] = shcore::Value(fetch_long_data(index, column.length));
+        else
+          values[index] = shcore::Value(column.data.data(), column.length);
+        break;
+      case Field::As_undefined:
+        values[index] = shcore::Value();
+        break;
+    }
+  }
+
+  return true;
+}
+
+void Statement::bind_stream(size_t index, const std::string &path) {
+  if (!_stmt)
+    throw shcore::Exception::logic_error("The statement is closed");
+
+  if (index >= _param_count)
+    throw shcore::Exception::argument_error((boost::format("The statement has no parameter at position %1%") % index).str());
+
+  _streams[index] = path;
+}
+
+// The file goes to the server in chunks, which it puts together, so it
+// never has to be held in memory as a whole
+void Statement::send_long_data(size_t index, const std::string &path) {
+  static const size_t k_chunk_size = 1024 * 1024;
+
+  std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(path.c_str(), "rb"), &fclose);
+  if (!file)
+    throw shcore::Exception::runtime_error("Unable to open file '" + path + "'");
+
+  std::vector<char> chunk(k_chunk_size);
+  size_t size;
+  while ((size = fread(chunk.data(), 1, chunk.size(), file.get())) > 0) {
+    if (mysql_stmt_send_long_data(_stmt, static_cast<unsigned int>(index), chunk.data(), static_cast<unsigned long>(size)))
+      throw_error();
+  }
+
+  if (ferror(file.get()))
+    throw shcore::Exception::runtime_error("Unable to read file '" + path + "'");
+}
+
+// The BLOB and TEXT values are copied from the client library straight into
+// their string, in chunks, instead of through a buffer as large as the
+// longest value of the result
+std::string Statement::fetch_long_data(size_t index, unsigned long length) {
+  static const unsigned long k_chunk_size = 1024 * 1024;
+
+  std::string data(length, '\0');
+  unsigned long offset = 0;
+
+  while (offset < length) {
+    unsigned long fetched = 0;
+    MYSQL_BIND bind;
+    memset(&bind, 0, sizeof(bind));
+    bind.buffer_type = MYSQL_TYPE_BLOB;
+    bind.buffer = &data[offset];
+    bind.buffer_length = std::min(k_chunk_size, length - offset);
+    bind.length = &fetched;
+
+    if (mysql_stmt_fetch_column(_stmt, &bind, static_cast<unsigned int>(index), offset))
+      throw_error();
+
+    offset += bind.buffer_length;
+  }
+
+  return data;
+}
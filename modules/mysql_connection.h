@@ -47,6 +47,18 @@ namespace mysql {
 
 class SHCORE_PUBLIC Field {
 public:
+  // How the values of the column are turned into shell values, decided once
+  // from the type and flags rather than on every value
+  enum Converter {
+    As_null,
+    As_string,
+    As_integer,
+    As_unsigned,
+    As_double,
+    As_date,
+    As_undefined
+  };
+
   Field(const std::string& catalog, const std::string& db, const std::string& table, const std::string& otable, const std::string& name, const std::string& oname, int length, int type, int flags, int decimals, int charset);
 
   const std::string& catalog() { return _catalog; };
@@ -60,6 +72,7 @@ public:
   int flags() { return _flags; }
   int decimals() { return _decimals; }
   int charset() { return _charset; }
+  Converter converter() const { return _converter; }
 
   long max_length() { return _max_length; }
   void max_length(int length_) { _max_length = length_; }
@@ -81,22 +94,44 @@ private:
 
   long _max_length;
   long _name_length;
+  Converter _converter;
 };
 
 class Row {
 public:
   Row(MYSQL_ROW row, unsigned long *lengths, std::vector<Field>* metadata = NULL);
+  // A row of a prepared statement, whose values arrive already typed
+  Row(std::vector<shcore::Value> &&values, std::vector<unsigned long> &&lengths, std::vector<Field>* metadata);
   virtual ~Row() {}
 
-  virtual shcore::Value get_value(int index);
-  virtual std::string get_value_as_string(int index);
+  virtual shcore::Value get_value(int index) const;
+  virtual std::string get_value_as_string(int index) const;
+
+  bool is_null(int index) const;
+
+  // Size in bytes of the data of the row as received from the server
+  size_t get_data_size() const;
+
+  // The field as received from the server as text, NULL for a NULL value
+  // and on the rows of prepared statements
+  const char *get_data(int index, size_t &length) const { length = _row ? _lengths[index] : 0; return _row ? _row[index] : NULL; }
+
+  // Points the row to other data of the same result
+  void reset(MYSQL_ROW row, unsigned long *lengths) { _row = row; _lengths = lengths; }
+  void reset(std::vector<shcore::Value> &&values, std::vector<unsigned long> &&lengths);
 
 private:
   MYSQL_ROW _row;
   unsigned long *_lengths;
   std::vector<Field> *_metadata;
+
+  // Only used by the rows of prepared statements
+  std::vector<shcore::Value> _values;
+  std::vector<unsigned long> _value_lengths;
 };
 
+class Statement;
+
 class Connection;
 class SHCORE_PUBLIC Result {
 public:
@@ -104,12 +139,20 @@ public:
   virtual ~Result();
 
   void reset(std::shared_ptr<MYSQL_RES> res, unsigned long duration);
+  // Turns this into the rows of the last execution of the statement
+  void reset(std::shared_ptr<Statement> statement, unsigned long duration);
+
+  // Whether the rows come from a prepared statement, in the binary protocol
+  bool is_binary() const { return _statement != nullptr; }
 
 public:
   std::vector<Field>& get_metadata() { return _metadata; };
 
   // Data Retrieving
   std::unique_ptr<Row> fetch_one();
+  // Fetches the next row into a view owned by the result, it references the
+  // data of the client library in place and is valid until the next fetch
+  const Row *fetch_one_view();
   bool next_data_set();
   std::unique_ptr<Result> query_warnings();
 
@@ -118,6 +161,7 @@ public:
   // Metadata retrieving
   uint64_t affected_rows() { return _affected_rows; }
   uint64_t fetched_row_count() { return _fetched_row_count; }
+  // Known once the rows were read, the server sends it after them
   int warning_count() { return _warning_count; }
   unsigned long execution_time() { return _execution_time; }
   uint64_t last_insert_id() { return _last_insert_id; }
@@ -139,18 +183,101 @@ private:
   std::string _info;
   unsigned long _execution_time;
   bool _has_resultset;
+  Row _row_view;
+
+  std::shared_ptr<Statement> _statement;
+  uint64_t _execution;
+
+  bool fetch_next(MYSQL_ROW &row, unsigned long *&lengths);
+  bool fetch_next(std::vector<shcore::Value> &values, std::vector<unsigned long> &lengths);
+};
+
+// A statement prepared on the server, which can be executed any number of
+// times with different parameters. The statement is only parsed once, and
+// its rows arrive in the binary protocol, so numbers and dates are decoded
+// without going through text.
+class SHCORE_PUBLIC Statement : public std::enable_shared_from_this<Statement> {
+public:
+  ~Statement();
+
+  size_t param_count() const { return _param_count; }
+
+  // The result is buffered on the client, its rows can be read until the
+  // statement is executed again. Only the first result set is kept.
+  std::unique_ptr<Result> execute(const std::vector<shcore::Value> &params);
+  void close();
+
+  // The parameter at the position is sent from the file on the next
+  // execution, in chunks, instead of the value given for it
+  void bind_stream(size_t index, const std::string &path);
+
+  const std::vector<Field> &get_metadata() const { return _metadata; }
+
+  // Decodes the next row of the given execution, false at the end or when
+  // the statement was executed again since
+  bool fetch(uint64_t execution, std::vector<shcore::Value> &values, std::vector<unsigned long> &lengths);
+  uint64_t execution() const { return _execution; }
+
+private:
+  friend class Connection;
+  Statement(std::shared_ptr<Connection> owner, MYSQL_STMT *stmt);
+
+  // Where the value of each column is fetched into, the one used depends
+  // on the converter of the column
+  struct Column_buffer {
+    int64_t integer;
+    double number;
+    MYSQL_TIME time;
+    std::string data;
+    unsigned long length;
+    my_bool is_null;
+    my_bool error;
+    // BLOB and TEXT columns have no buffer, see fetch_long_data()
+    bool long_data;
+  };
+
+  void throw_error();
+  void bind_result();
+  std::string fetch_long_data(size_t index, unsigned long length);
+  void send_long_data(size_t index, const std::string &path);
+  void discard_result();
+
+  std::shared_ptr<Connection> _connection;
+  MYSQL_STMT *_stmt;
+  size_t _param_count;
+  uint64_t _execution;
+  bool _has_result;
+
+  std::vector<Field> _metadata;
+  std::vector<Column_buffer> _columns;
+  std::vector<MYSQL_BIND> _binds;
+  std::map<size_t, std::string> _streams;
 };
 
 class SHCORE_PUBLIC Connection : public std::enable_shared_from_this<Connection> {
 public:
   Connection(const std::string &uri, const char *password = NULL);
+  // With local_infile the connection accepts LOAD DATA LOCAL, whose data
+  // only comes from run_load_data_local, never from a file. The protocol is
+  // compressed with the given algorithm: zlib, zstd or auto for any the
+  // server supports, and not compressed if empty. A timeout other than 0 is
+  // the seconds to wait on the network when connecting, reading or writing
   Connection(const std::string &host, int port, const std::string &socket, const std::string &user, const std::string &password, const std::string &schema, 
-    const struct shcore::SslInfo& ssl_info);
+    const struct shcore::SslInfo& ssl_info, bool local_infile = false,
+    const std::string &compression = "", int compression_level = -1, int timeout = 0);
   Connection(const Connection& conn) : Connection(conn._uri, NULL) {}
   ~Connection();
 
   void close();
   std::unique_ptr<Result> run_sql(const std::string &sql);
+  // Prepares the statement on the server, it is bound to this connection
+  std::shared_ptr<Statement> prepare(const std::string &sql);
+  // Runs the statements of the script, separated by ;, on a single round
+  // trip. Their results are discarded, the error of the first statement
+  // failing is thrown and the statements after it are not run.
+  void run_script(const std::string &script);
+  // Runs a LOAD DATA LOCAL INFILE statement sending the given data as the file
+  std::unique_ptr<Result> run_load_data_local(const std::string &sql, const char *data, size_t size);
   bool next_data_set(Result *target, bool first_result = false);
   std::string uri() { return _uri; }
 
@@ -161,10 +288,24 @@ public:
   const char* get_server_info() { _prev_result.reset(); return mysql_get_server_info(_mysql); }
   const char* get_stats() { _prev_result.reset(); return mysql_stat(_mysql); }
   const char* get_ssl_cipher() { _prev_result.reset(); return mysql_get_ssl_cipher(_mysql); }
+  // Whether the server still answers on this connection
+  bool ping() { _prev_result.reset(); return mysql_ping(_mysql) == 0; }
+  // Clears the state of the session with COM_RESET_CONNECTION, without
+  // authenticating again. The prepared statements are closed by the server.
+  void reset();
+  // Of the last statement, the rows of a result may still add to it until
+  // they are all read
+  unsigned int get_warning_count() { return mysql_warning_count(_mysql); }
 
 private:
+  friend class Statement;
+
+  // Reads away the rest of the last result, so the connection can be used
+  void discard_results();
   bool setup_ssl(const struct shcore::SslInfo& ssl_info);
+  void setup_compression(const std::string &algorithm, int level);
   void throw_on_connection_fail();
+  void remember_local_sockets(int port);
   std::string _uri;
   MYSQL *_mysql;
   MySQL_timer _timer;
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "modules/session_pool.h"
+#include "modules/mysql_connection.h"
+#include "utils/utils_cancel.h"
+#include "utils/utils_general.h"
+#include "utils/utils_trace.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+
+namespace mysqlsh {
+
+Session_pool *Session_pool::get() {
+  static Session_pool instance;
+  return &instance;
+}
+
+std::shared_ptr<mysql::ClassicSession> Session_pool::acquire(const std::string &uri, const std::string &password) {
+  shcore::Connection_options options = shcore::Connection_options::parse(uri);
+  options.password = password;
+  options.has_password = true;
+
+  return acquire(options);
+}
+
+std::shared_ptr<mysql::ClassicSession> Session_pool::acquire(const shcore::Connection_options &options) {
+  shcore::Argument_list args;
+  args.push_back(shcore::Value(options.to_map()));
+
+  return lease(options.uri(true), args);
+}
+
+std::shared_ptr<mysql::ClassicSession> Session_pool::acquire(const shcore::Argument_list &args) {
+  std::string key = shcore::build_connection_string(args.map_at(0), true);
+
+  // Sessions with other network timeouts are not interchangeable
+  if (args.map_at(0)->has_key(shcore::kTimeout))
+    key.append(" timeout=").append((*args.map_at(0))[shcore::kTimeout].descr());
+
+  return lease(key, args);
+}
+
+std::shared_ptr<mysql::ClassicSession> Session_pool::lease(const std::string &key, const shcore::Argument_list &args) {
+  std::shared_ptr<mysql::ClassicSession> ret_val;
+
+  // Within an operation with a step timeout, the sessions opened without a
+  // timeout of their own get it, so a query to an unreachable instance
+  // fails once the step is over rather than after the TCP timeout
+  std::string timed_key = key;
+  shcore::Argument_list timed_args = args;
+  if (auto token = shcore::Cancellation_token::current()) {
+    token->check("connecting to " + shcore::build_connection_string(args.map_at(0), false));
+
+    auto step_timeout = std::chrono::duration_cast<std::chrono::seconds>(token->step_timeout());
+    if (step_timeout.count() > 0 && !args.map_at(0)->has_key(shcore::kTimeout)) {
+      shcore::Value::Map_type_ref data(new shcore::Value::Map_type(*args.map_at(0)));
+      (*data)[shcore::kTimeout] = shcore::Value(static_cast<int64_t>(step_timeout.count()));
+      timed_args[0] = shcore::Value(data);
+      timed_key.append(" timeout=").append((*data)[shcore::kTimeout].descr());
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    expire(std::chrono::steady_clock::now());
+
+    auto idle = _idle.find(timed_key);
+    if (idle != _idle.end()) {
+      ret_val = idle->second.session;
+      _idle.erase(idle);
+    }
+  }
+
+  // The reset clears what the previous user left on the session, in the
+  // same round trip that finds whether the server dropped it while idle
+  if (ret_val) {
+    try {
+      ret_val->reset_state();
+    } catch (std::exception &e) {
+      log_debug("Dropping a pooled session to %s, it can not be reset: %s", ret_val->uri().c_str(), e.what());
+      ret_val->close(shcore::Argument_list());
+      ret_val.reset();
+    }
+  }
+
+  if (!ret_val) {
+    shcore::Trace_span span("connect");
+    if (span.recording())
+      span.set("instance", shcore::build_connection_string(timed_args.map_at(0), false));
+
+    ret_val = std::dynamic_pointer_cast<mysql::ClassicSession>(
+      connect_session(timed_args, SessionType::Classic));
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // Forgets the sessions that were never released
+  _leased.erase(std::remove_if(_leased.begin(), _leased.end(),
+                               [](const std::pair<std::weak_ptr<mysql::ClassicSession>, std::string> &leased) {
+                                 return leased.first.expired();
+                               }),
+                _leased.end());
+
+  _leased.emplace_back(ret_val, timed_key);
+
+  return ret_val;
+}
+
+void Session_pool::release(std::shared_ptr<ShellDevelopmentSession> session) {
+  auto classic = std::dynamic_pointer_cast<mysql::ClassicSession>(session);
+  if (!classic)
+    return;
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto leased = std::find_if(_leased.begin(), _leased.end(),
+                             [&classic](const std::pair<std::weak_ptr<mysql::ClassicSession>, std::string> &leased) {
+                               return leased.first.lock() == classic;
+                             });
+
+  // Sessions not opened by the pool are closed as they used to
+  if (leased == _leased.end()) {
+    lock.unlock();
+    classic->close(shcore::Argument_list());
+    return;
+  }
+
+  if (classic->is_connected()) {
+    Idle_session idle = { classic, std::chrono::steady_clock::now() };
+    _idle.emplace(leased->second, idle);
+  }
+
+  _leased.erase(leased);
+}
+
+void Session_pool::clear() {
+  std::multimap<std::string, Idle_session> idle;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    idle.swap(_idle);
+  }
+
+  for (auto &entry : idle)
+    entry.second.session->close(shcore::Argument_list());
+}
+
+void Session_pool::expire(std::chrono::steady_clock::time_point now) {
+  for (auto idle = _idle.begin(); idle != _idle.end();) {
+    if (now - idle->second.since > _idle_timeout) {
+      // Closing only sends COM_QUIT, it does not wait for the server
+      idle->second.session->close(shcore::Argument_list());
+      idle = _idle.erase(idle);
+    } else {
+      ++idle;
+    }
+  }
+}
+};
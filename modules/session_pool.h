@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Pool of the classic sessions the AdminAPI and the utilities open to the
+// instances they work with
+
+#ifndef _MODULES_SESSION_POOL_H_
+#define _MODULES_SESSION_POOL_H_
+
+#include "shellcore/types.h"
+#include "modules/mod_mysql_session.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mysqlsh {
+// Sessions released to the pool are kept open and handed to the next
+// acquire with the same connection data, so an operation talking several
+// times to the same instance only connects once. Idle sessions are closed
+// once they exceed the idle timeout and are reset before being reused, so
+// the transaction and the session variables a previous user left are gone.
+// A session dropped without release is just closed when the last reference
+// goes away.
+class SHCORE_PUBLIC Session_pool {
+public:
+  static Session_pool *get();
+
+  // Returns an open session to the instance of the connection data (a map),
+  // an idle one of the pool if any is alive or a new one otherwise
+  std::shared_ptr<mysql::ClassicSession> acquire(const shcore::Argument_list &args);
+  std::shared_ptr<mysql::ClassicSession> acquire(const std::string &uri, const std::string &password);
+  std::shared_ptr<mysql::ClassicSession> acquire(const shcore::Connection_options &options);
+
+  // Gives the session back to the pool, a closed session is just dropped
+  void release(std::shared_ptr<ShellDevelopmentSession> session);
+
+  // Closes all the idle sessions
+  void clear();
+
+  void set_idle_timeout(std::chrono::seconds timeout) { _idle_timeout = timeout; }
+  std::chrono::seconds idle_timeout() const { return _idle_timeout; }
+
+private:
+  Session_pool() : _idle_timeout(60) {}
+
+  struct Idle_session {
+    std::shared_ptr<mysql::ClassicSession> session;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  // The key is the connection string of the arguments, with the password
+  std::shared_ptr<mysql::ClassicSession> lease(const std::string &key, const shcore::Argument_list &args);
+  void expire(std::chrono::steady_clock::time_point now);
+
+  std::mutex _mutex;
+  std::chrono::seconds _idle_timeout;
+  // Idle sessions by the connection string including the credentials
+  std::multimap<std::string, Idle_session> _idle;
+  // Sessions handed out by the pool, with their connection string
+  std::vector<std::pair<std::weak_ptr<mysql::ClassicSession>, std::string> > _leased;
+};
+};
+
+#endif
@@ -61,6 +61,12 @@ using namespace mysqlsh::mysqlx;
             return ::mysqlx::TableValue(expr_data, ::mysqlx::TableValue::TExpression);
         }
       }
+      if (object_class == "FileContent") {
+        std::shared_ptr<FileContent> content = std::dynamic_pointer_cast<FileContent>(object);
+
+        if (content)
+          return ::mysqlx::TableValue(content->get_path(), ::mysqlx::TableValue::TFile);
+      }
       if (object_class == "Date") {
         std::string data = source.descr();
         return ::mysqlx::TableValue(data);
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "expr_cache.h"
+
+using namespace mysqlx;
+
+const size_t Expr_cache::k_default_capacity;
+
+Expr_cache::Expr_cache(size_t capacity)
+  : m_capacity(capacity), m_hits(0), m_misses(0)
+{
+}
+
+Mysqlx::Expr::Expr *Expr_cache::parse_filter(const std::string &source, bool document_mode,
+                                             std::vector<std::string> *placeholders)
+{
+  if (!placeholders || !placeholders->empty() || !m_capacity)
+  {
+    Expr_parser parser(source, document_mode, false, placeholders);
+    return parser.expr();
+  }
+
+  // The same text is a different expression on each mode
+  std::string key(1, document_mode ? 'D' : 'T');
+  key.append(source);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<std::string, Entry>::iterator entry = m_entries.find(key);
+    if (entry != m_entries.end())
+    {
+      m_lru.splice(m_lru.begin(), m_lru, entry->second.lru);
+      m_hits++;
+
+      *placeholders = entry->second.placeholders;
+      return new Mysqlx::Expr::Expr(*entry->second.expr);
+    }
+
+    m_misses++;
+  }
+
+  // Parsing errors are thrown before anything is cached
+  Expr_parser parser(source, document_mode, false, placeholders);
+  std::unique_ptr<Mysqlx::Expr::Expr> expr(parser.expr());
+  Mysqlx::Expr::Expr *result = new Mysqlx::Expr::Expr(*expr);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_entries.find(key) == m_entries.end())
+  {
+    if (m_entries.size() >= m_capacity)
+    {
+      m_entries.erase(m_lru.back());
+      m_lru.pop_back();
+    }
+
+    m_lru.push_front(key);
+
+    Entry &entry = m_entries[key];
+    entry.expr = std::move(expr);
+    entry.placeholders = *placeholders;
+    entry.lru = m_lru.begin();
+  }
+
+  return result;
+}
+
+size_t Expr_cache::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+void Expr_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_lru.clear();
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _EXPR_CACHE_H_
+#define _EXPR_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expr_parser.h"
+
+namespace mysqlx
+{
+  // LRU cache of the parsed CRUD criteria, so statements executed over and
+  // over with different bound values skip the parsing.
+  //
+  // The placeholder positions in a parsed expression depend on the ones the
+  // statement already had, so only the expressions parsed into an empty
+  // placeholder list are cached, which is the case of the find(), modify(),
+  // remove(), where() criteria.
+  class Expr_cache
+  {
+  public:
+    static const size_t k_default_capacity = 256;
+
+    explicit Expr_cache(size_t capacity = k_default_capacity);
+
+    // Returns a new copy of the parsed filter, adding its placeholders to
+    // the given list, same as parser::parse_collection_filter() and
+    // parser::parse_table_filter()
+    Mysqlx::Expr::Expr *parse_filter(const std::string &source, bool document_mode,
+                                     std::vector<std::string> *placeholders);
+
+    size_t size() const;
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+    void clear();
+
+  private:
+    struct Entry
+    {
+      std::unique_ptr<Mysqlx::Expr::Expr> expr;
+      std::vector<std::string> placeholders;
+      std::list<std::string>::iterator lru;
+    };
+
+    size_t m_capacity;
+    size_t m_hits;
+    size_t m_misses;
+    mutable std::mutex m_mutex;
+
+    // Most recently used keys first
+    std::list<std::string> m_lru;
+    std::unordered_map<std::string, Entry> m_entries;
+  };
+};
+
+#endif
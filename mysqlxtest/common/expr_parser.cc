@@ -521,17 +521,14 @@ Mysqlx::Expr::Expr* Expr_parser::array_()
 
   if (!_tokenizer.cur_token_type_is(Token::RSQBRACKET))
   {
-    Memory_new<Mysqlx::Expr::Expr>::Unique_ptr e(my_expr());
-    Mysqlx::Expr::Expr *item = a->add_value();
-    item->CopyFrom(*e);
-    e.reset();
+    // The items are moved into the array, copying them would duplicate
+    // every node of their subtree
+    a->mutable_value()->AddAllocated(my_expr());
 
     while (_tokenizer.cur_token_type_is(Token::COMMA))
     {
       _tokenizer.consume_token(Token::COMMA);
-      e.reset(my_expr());
-      item = a->add_value();
-      item->CopyFrom(*e);
+      a->mutable_value()->AddAllocated(my_expr());
     }
   }
 
@@ -900,7 +897,7 @@ Mysqlx::Expr::Expr* Expr_parser::comp_expr()
 }
 
 /*
- * ilri_expr ::= comp_expr [ NOT ] (( IS [ NOT ] comp_expr ) | ( IN paren_expr_list ) |
+ * ilri_expr ::= comp_expr [ NOT ] (( IS [ NOT ] comp_expr ) | ( IN ( paren_expr_list | placeholder ) ) |
  *   ( LIKE comp_expr [ ESCAPE comp_expr ] ) | ( BETWEEN comp_expr AND comp_expr ) | ( REGEXP comp_expr )
  */
 Mysqlx::Expr::Expr* Expr_parser::ilri_expr()
@@ -953,6 +950,13 @@ Mysqlx::Expr::Expr* Expr_parser::ilri_expr()
         }
         _tokenizer.consume_token(Token::RSQBRACKET);
       }
+      else if (_tokenizer.cur_token_type_is(Token::COLON) || _tokenizer.cur_token_type_is(Token::PLACEHOLDER))
+      {
+        // The whole list is bound to the placeholder
+        Memory_new<Mysqlx::Expr::Expr>::Unique_ptr ptr(placeholder());
+        params->AddAllocated(ptr.get());
+        ptr.release();
+      }
       else
       {
         paren_expr_list(params);
@@ -0,0 +1,564 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "sql_generator.h"
+
+#include <cctype>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+using namespace mysqlx;
+
+namespace
+{
+  const uint32_t CONTENT_TYPE_JSON = 0x0002;
+
+  bool is_plain_member(const std::string& member)
+  {
+    if (member.empty() || isdigit(static_cast<unsigned char>(member[0])))
+      return false;
+
+    for (std::string::const_iterator c = member.begin(); c != member.end(); ++c)
+    {
+      if (!isalnum(static_cast<unsigned char>(*c)) && *c != '_' && *c != '$')
+        return false;
+    }
+
+    return true;
+  }
+
+  std::string join(const std::vector<std::string>& items, const char* separator)
+  {
+    std::string ret_val;
+    for (size_t index = 0; index < items.size(); ++index)
+    {
+      if (index)
+        ret_val += separator;
+      ret_val += items[index];
+    }
+    return ret_val;
+  }
+
+  // The text of a literal that is a keyword of the SQL around it, as the
+  // type of a CAST or the unit of an INTERVAL
+  std::string keyword(const Mysqlx::Expr::Expr& expr)
+  {
+    if (expr.type() == Mysqlx::Expr::Expr::LITERAL)
+    {
+      if (expr.literal().type() == Mysqlx::Datatypes::Scalar::V_OCTETS)
+        return expr.literal().v_octets().value();
+      if (expr.literal().type() == Mysqlx::Datatypes::Scalar::V_STRING)
+        return expr.literal().v_string().value();
+    }
+
+    throw Sql_generator_error("Expected a literal keyword in the expression");
+  }
+}
+
+std::string Sql_generator::quote_identifier(const std::string& id)
+{
+  std::string ret_val = "`";
+  for (std::string::const_iterator c = id.begin(); c != id.end(); ++c)
+  {
+    if (*c == '`')
+      ret_val += '`';
+    ret_val += *c;
+  }
+  return ret_val + "`";
+}
+
+std::string Sql_generator::quote_string(const std::string& s)
+{
+  std::string ret_val = "'";
+  for (std::string::const_iterator c = s.begin(); c != s.end(); ++c)
+  {
+    switch (*c)
+    {
+      case '\0': ret_val += "\\0"; break;
+      case '\n': ret_val += "\\n"; break;
+      case '\r': ret_val += "\\r"; break;
+      case '\032': ret_val += "\\Z"; break;
+      case '\'':
+      case '\\':
+        ret_val += '\\';
+        ret_val += *c;
+        break;
+      default:
+        ret_val += *c;
+    }
+  }
+  return ret_val + "'";
+}
+
+std::string Sql_generator::scalar(const Mysqlx::Datatypes::Scalar& scalar)
+{
+  std::ostringstream stream;
+
+  switch (scalar.type())
+  {
+    case Mysqlx::Datatypes::Scalar::V_SINT:
+      stream << scalar.v_signed_int();
+      return stream.str();
+
+    case Mysqlx::Datatypes::Scalar::V_UINT:
+      stream << scalar.v_unsigned_int();
+      return stream.str();
+
+    case Mysqlx::Datatypes::Scalar::V_NULL:
+      return "NULL";
+
+    case Mysqlx::Datatypes::Scalar::V_OCTETS:
+      if (scalar.v_octets().content_type() == CONTENT_TYPE_JSON)
+        return "CAST(" + quote_string(scalar.v_octets().value()) + " AS JSON)";
+      return quote_string(scalar.v_octets().value());
+
+    case Mysqlx::Datatypes::Scalar::V_DOUBLE:
+      stream.precision(std::numeric_limits<double>::digits10 + 2);
+      stream << scalar.v_double();
+      return stream.str();
+
+    case Mysqlx::Datatypes::Scalar::V_FLOAT:
+      stream.precision(std::numeric_limits<float>::digits10 + 2);
+      stream << scalar.v_float();
+      return stream.str();
+
+    case Mysqlx::Datatypes::Scalar::V_BOOL:
+      return scalar.v_bool() ? "TRUE" : "FALSE";
+
+    case Mysqlx::Datatypes::Scalar::V_STRING:
+      return quote_string(scalar.v_string().value());
+  }
+
+  throw Sql_generator_error("Invalid value in the expression");
+}
+
+std::string Sql_generator::document_path(const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Expr::DocumentPathItem>& path)
+{
+  std::string ret_val = "$";
+
+  for (int index = 0; index < path.size(); ++index)
+  {
+    const Mysqlx::Expr::DocumentPathItem& item = path.Get(index);
+    switch (item.type())
+    {
+      case Mysqlx::Expr::DocumentPathItem::MEMBER:
+        ret_val += is_plain_member(item.value()) ? "." + item.value() : ".\"" + item.value() + "\"";
+        break;
+      case Mysqlx::Expr::DocumentPathItem::MEMBER_ASTERISK:
+        ret_val += ".*";
+        break;
+      case Mysqlx::Expr::DocumentPathItem::ARRAY_INDEX:
+      {
+        std::ostringstream stream;
+        stream << "[" << item.index() << "]";
+        ret_val += stream.str();
+        break;
+      }
+      case Mysqlx::Expr::DocumentPathItem::ARRAY_INDEX_ASTERISK:
+        ret_val += "[*]";
+        break;
+      case Mysqlx::Expr::DocumentPathItem::DOUBLE_ASTERISK:
+        ret_val += "**";
+        break;
+    }
+  }
+
+  return ret_val;
+}
+
+std::string Sql_generator::placeholder(uint32_t position) const
+{
+  if (position >= static_cast<uint32_t>(m_args.size()))
+    throw Sql_generator_error("Missing value bindings for the placeholders of the expression");
+
+  return scalar(m_args.Get(position));
+}
+
+std::string Sql_generator::identifier(const Mysqlx::Expr::ColumnIdentifier& column) const
+{
+  std::string column_name;
+
+  if (!column.name().empty())
+  {
+    if (!column.schema_name().empty())
+      column_name += quote_identifier(column.schema_name()) + ".";
+    if (!column.table_name().empty())
+      column_name += quote_identifier(column.table_name()) + ".";
+    column_name += quote_identifier(column.name());
+  }
+  else if (m_document_mode)
+  {
+    column_name = "doc";
+  }
+  else
+  {
+    throw Sql_generator_error("Column name is required in the expressions of tables");
+  }
+
+  if (column.document_path_size() == 0)
+    return column_name;
+
+  return "JSON_EXTRACT(" + column_name + "," + quote_string(document_path(column.document_path())) + ")";
+}
+
+std::string Sql_generator::function_call(const Mysqlx::Expr::FunctionCall& call) const
+{
+  // CAST is parsed as a function, the type is not an expression though
+  if (call.name().schema_name().empty() && call.name().name() == "cast" && call.param_size() == 2)
+    return "CAST(" + generate(call.param(0)) + " AS " + keyword(call.param(1)) + ")";
+
+  std::string name;
+  if (!call.name().schema_name().empty())
+    name = quote_identifier(call.name().schema_name()) + "." + quote_identifier(call.name().name());
+  else
+    name = call.name().name();
+
+  std::vector<std::string> params;
+  for (int index = 0; index < call.param_size(); ++index)
+    params.push_back(generate(call.param(index)));
+
+  return name + "(" + join(params, ",") + ")";
+}
+
+std::string Sql_generator::operator_(const Mysqlx::Expr::Operator& op) const
+{
+  static std::map<std::string, std::string> binary_operators;
+  if (binary_operators.empty())
+  {
+    const char* const operators[][2] = {
+      { "==", "=" }, { "!=", "!=" }, { ">", ">" }, { ">=", ">=" }, { "<", "<" }, { "<=", "<=" },
+      { "&", "&" }, { "|", "|" }, { "^", "^" }, { "<<", "<<" }, { ">>", ">>" },
+      { "+", "+" }, { "-", "-" }, { "*", "*" }, { "/", "/" }, { "div", "DIV" }, { "%", "%" },
+      { "is", "IS" }, { "is_not", "IS NOT" }, { "regexp", "REGEXP" }, { "not_regexp", "NOT REGEXP" },
+      { "&&", "AND" }, { "||", "OR" }, { "xor", "XOR" }
+    };
+    for (size_t index = 0; index < sizeof(operators) / sizeof(operators[0]); ++index)
+      binary_operators[operators[index][0]] = operators[index][1];
+  }
+
+  const std::string& name = op.name();
+  std::vector<std::string> params;
+  for (int index = 0; index < op.param_size(); ++index)
+  {
+    // The type of a CAST and the unit of an INTERVAL are not expressions
+    if (index == 1 && (name == "cast" || name == "interval"))
+      params.push_back(keyword(op.param(index)));
+    else if (index == 2 && (name == "date_add" || name == "date_sub"))
+      params.push_back(keyword(op.param(index)));
+    else
+      params.push_back(generate(op.param(index)));
+  }
+
+  std::map<std::string, std::string>::const_iterator binary = binary_operators.find(name);
+  if (binary != binary_operators.end())
+  {
+    if (params.size() == 0 && name == "*")
+      return "*";
+    if (params.size() < 2)
+      throw Sql_generator_error("Operator " + name + " expects two operands");
+    return "(" + join(params, (" " + binary->second + " ").c_str()) + ")";
+  }
+
+  if ((name == "not" || name == "!") && params.size() == 1)
+    return "(NOT " + params[0] + ")";
+  if (name == "sign_plus" && params.size() == 1)
+    return "(+" + params[0] + ")";
+  if (name == "sign_minus" && params.size() == 1)
+    return "(-" + params[0] + ")";
+  if (name == "~" && params.size() == 1)
+    return "(~" + params[0] + ")";
+
+  if ((name == "in" || name == "not_in") && params.size() >= 2)
+  {
+    std::vector<std::string> list(params.begin() + 1, params.end());
+    return "(" + params[0] + (name == "in" ? " IN (" : " NOT IN (") + join(list, ",") + "))";
+  }
+
+  if ((name == "like" || name == "not_like") && (params.size() == 2 || params.size() == 3))
+    return "(" + params[0] + (name == "like" ? " LIKE " : " NOT LIKE ") + params[1] +
+           (params.size() == 3 ? " ESCAPE " + params[2] : "") + ")";
+
+  if ((name == "between" || name == "not_between" || name == "between_not") && params.size() == 3)
+    return "(" + params[0] + (name == "between" ? " BETWEEN " : " NOT BETWEEN ") + params[1] + " AND " + params[2] + ")";
+
+  if (name == "cast" && params.size() == 2)
+    return "CAST(" + params[0] + " AS " + params[1] + ")";
+
+  if (name == "interval" && params.size() == 2)
+    return "INTERVAL " + params[0] + " " + params[1];
+
+  if ((name == "date_add" || name == "date_sub") && params.size() == 3)
+    return (name == "date_add" ? "DATE_ADD(" : "DATE_SUB(") + params[0] + ", INTERVAL " + params[1] + " " + params[2] + ")";
+
+  if (name == "default" && params.empty())
+    return "DEFAULT";
+
+  throw Sql_generator_error("Invalid operator " + name + " in the expression");
+}
+
+std::string Sql_generator::object(const Mysqlx::Expr::Object& object) const
+{
+  std::vector<std::string> fields;
+  for (int index = 0; index < object.fld_size(); ++index)
+    fields.push_back(quote_string(object.fld(index).key()) + "," + generate(object.fld(index).value()));
+
+  return "JSON_OBJECT(" + join(fields, ",") + ")";
+}
+
+std::string Sql_generator::array(const Mysqlx::Expr::Array& array) const
+{
+  std::vector<std::string> values;
+  for (int index = 0; index < array.value_size(); ++index)
+    values.push_back(generate(array.value(index)));
+
+  return "JSON_ARRAY(" + join(values, ",") + ")";
+}
+
+std::string Sql_generator::generate(const Mysqlx::Expr::Expr& expr) const
+{
+  switch (expr.type())
+  {
+    case Mysqlx::Expr::Expr::IDENT:
+      return identifier(expr.identifier());
+    case Mysqlx::Expr::Expr::LITERAL:
+      return scalar(expr.literal());
+    case Mysqlx::Expr::Expr::FUNC_CALL:
+      return function_call(expr.function_call());
+    case Mysqlx::Expr::Expr::OPERATOR:
+      return operator_(expr.operator_());
+    case Mysqlx::Expr::Expr::PLACEHOLDER:
+      return placeholder(expr.position());
+    case Mysqlx::Expr::Expr::OBJECT:
+      return object(expr.object());
+    case Mysqlx::Expr::Expr::ARRAY:
+      return array(expr.array());
+    case Mysqlx::Expr::Expr::VARIABLE:
+      break;
+  }
+
+  throw Sql_generator_error("Invalid expression type");
+}
+
+std::string Sql_generator::collection(const Mysqlx::Crud::Collection& collection) const
+{
+  if (collection.schema().empty())
+    return quote_identifier(collection.name());
+
+  return quote_identifier(collection.schema()) + "." + quote_identifier(collection.name());
+}
+
+std::string Sql_generator::filter(const Mysqlx::Expr::Expr& criteria) const
+{
+  return " WHERE " + generate(criteria);
+}
+
+std::string Sql_generator::order(const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Crud::Order>& order) const
+{
+  if (order.size() == 0)
+    return "";
+
+  std::vector<std::string> items;
+  for (int index = 0; index < order.size(); ++index)
+  {
+    const Mysqlx::Crud::Order& item = order.Get(index);
+    items.push_back(generate(item.expr()) + (item.direction() == Mysqlx::Crud::Order::DESC ? " DESC" : ""));
+  }
+
+  return " ORDER BY " + join(items, ",");
+}
+
+std::string Sql_generator::limit(const Mysqlx::Crud::Limit& limit, bool with_offset) const
+{
+  std::ostringstream stream;
+
+  stream << " LIMIT ";
+  if (limit.has_offset() && limit.offset())
+  {
+    if (!with_offset)
+      throw Sql_generator_error("Invalid parameter: offset is only supported by find operations");
+    stream << limit.offset() << ",";
+  }
+  stream << limit.row_count();
+
+  return stream.str();
+}
+
+std::string Sql_generator::operations(const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Crud::UpdateOperation>& operations) const
+{
+  // The value of every column after the operations on it, nested in order
+  std::vector<std::string> columns;
+  std::map<std::string, std::string> values;
+
+  for (int index = 0; index < operations.size(); ++index)
+  {
+    const Mysqlx::Crud::UpdateOperation& operation = operations.Get(index);
+    const Mysqlx::Expr::ColumnIdentifier& source = operation.source();
+
+    std::string column;
+    if (m_document_mode)
+    {
+      if (!source.name().empty() || operation.operation() == Mysqlx::Crud::UpdateOperation::SET)
+        throw Sql_generator_error("Invalid update operation on a collection");
+      column = "doc";
+    }
+    else
+    {
+      if (source.name().empty())
+        throw Sql_generator_error("Column name is required in the update operations of tables");
+      column = quote_identifier(source.name());
+    }
+
+    if (values.find(column) == values.end())
+    {
+      columns.push_back(column);
+      values[column] = column;
+    }
+
+    std::string &target = values[column];
+    std::string path = quote_string(document_path(source.document_path()));
+    std::string value = operation.has_value() ? generate(operation.value()) : "NULL";
+
+    switch (operation.operation())
+    {
+      case Mysqlx::Crud::UpdateOperation::SET:
+        if (source.document_path_size())
+          throw Sql_generator_error("Invalid document path in a SET operation");
+        target = value;
+        break;
+      case Mysqlx::Crud::UpdateOperation::ITEM_REMOVE:
+        target = "JSON_REMOVE(" + target + "," + path + ")";
+        break;
+      case Mysqlx::Crud::UpdateOperation::ITEM_SET:
+        target = "JSON_SET(" + target + "," + path + "," + value + ")";
+        break;
+      case Mysqlx::Crud::UpdateOperation::ITEM_REPLACE:
+        target = "JSON_REPLACE(" + target + "," + path + "," + value + ")";
+        break;
+      case Mysqlx::Crud::UpdateOperation::ITEM_MERGE:
+        target = "JSON_MERGE(" + target + "," + value + ")";
+        break;
+      case Mysqlx::Crud::UpdateOperation::ARRAY_INSERT:
+        target = "JSON_ARRAY_INSERT(" + target + "," + path + "," + value + ")";
+        break;
+      case Mysqlx::Crud::UpdateOperation::ARRAY_APPEND:
+        target = "JSON_ARRAY_APPEND(" + target + "," + path + "," + value + ")";
+        break;
+    }
+  }
+
+  std::vector<std::string> assignments;
+  for (size_t index = 0; index < columns.size(); ++index)
+    assignments.push_back(columns[index] + "=" + values[columns[index]]);
+
+  return join(assignments, ",");
+}
+
+std::string Sql_generator::expression(const Mysqlx::Expr::Expr& expr, bool document_mode,
+                                      const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar>& args)
+{
+  return Sql_generator(document_mode, args).generate(expr);
+}
+
+std::string Sql_generator::find(const Mysqlx::Crud::Find& find)
+{
+  Sql_generator generator(find.data_model() == Mysqlx::Crud::DOCUMENT, find.args());
+  std::vector<std::string> projection;
+
+  for (int index = 0; index < find.projection_size(); ++index)
+  {
+    const Mysqlx::Crud::Projection& item = find.projection(index);
+    if (generator.m_document_mode)
+    {
+      if (item.alias().empty())
+        throw Sql_generator_error("Invalid projection target name");
+      projection.push_back(quote_string(item.alias()) + "," + generator.generate(item.source()));
+    }
+    else
+    {
+      projection.push_back(generator.generate(item.source()) +
+                           (item.alias().empty() ? "" : " AS " + quote_identifier(item.alias())));
+    }
+  }
+
+  std::string sql = "SELECT ";
+  if (generator.m_document_mode)
+    sql += projection.empty() ? "doc" : "JSON_OBJECT(" + join(projection, ",") + ") AS doc";
+  else
+    sql += projection.empty() ? "*" : join(projection, ",");
+
+  sql += " FROM " + generator.collection(find.collection());
+
+  if (find.has_criteria())
+    sql += generator.filter(find.criteria());
+
+  if (find.grouping_size())
+  {
+    std::vector<std::string> grouping;
+    for (int index = 0; index < find.grouping_size(); ++index)
+      grouping.push_back(generator.generate(find.grouping(index)));
+    sql += " GROUP BY " + join(grouping, ",");
+  }
+
+  if (find.has_grouping_criteria())
+    sql += " HAVING " + generator.generate(find.grouping_criteria());
+
+  sql += generator.order(find.order());
+
+  if (find.has_limit())
+    sql += generator.limit(find.limit(), true);
+
+  return sql;
+}
+
+std::string Sql_generator::update(const Mysqlx::Crud::Update& update)
+{
+  Sql_generator generator(update.data_model() == Mysqlx::Crud::DOCUMENT, update.args());
+
+  std::string sql = "UPDATE " + generator.collection(update.collection()) + " SET " +
+                    generator.operations(update.operation());
+
+  if (update.has_criteria())
+    sql += generator.filter(update.criteria());
+
+  sql += generator.order(update.order());
+
+  if (update.has_limit())
+    sql += generator.limit(update.limit(), false);
+
+  return sql;
+}
+
+std::string Sql_generator::remove(const Mysqlx::Crud::Delete& remove)
+{
+  Sql_generator generator(remove.data_model() == Mysqlx::Crud::DOCUMENT, remove.args());
+
+  std::string sql = "DELETE FROM " + generator.collection(remove.collection());
+
+  if (remove.has_criteria())
+    sql += generator.filter(remove.criteria());
+
+  sql += generator.order(remove.order());
+
+  if (remove.has_limit())
+    sql += generator.limit(remove.limit(), false);
+
+  return sql;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _SQL_GENERATOR_H_
+#define _SQL_GENERATOR_H_
+
+#include <string>
+#include <stdexcept>
+
+// Avoid warnings from includes of other project and protobuf
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#elif defined _MSC_VER
+#pragma warning (push)
+#pragma warning (disable : 4018 4996)
+#endif
+
+#include "ngs_common/protocol_protobuf.h"
+
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
+#pragma GCC diagnostic pop
+#elif defined _MSC_VER
+#pragma warning (pop)
+#endif
+
+namespace mysqlx
+{
+  class Sql_generator_error : public std::runtime_error
+  {
+  public:
+    Sql_generator_error(const std::string& msg) : std::runtime_error(msg) {}
+  };
+
+  // The SQL statements the X plugin translates the CRUD messages into, with
+  // the bound arguments in place of the placeholders. Used to have the server
+  // explain the plan of a CRUD operation, so they follow the translation of
+  // the plugin where it matters to the optimizer: the document paths are
+  // extracted with JSON_EXTRACT(doc, path), which the optimizer matches with
+  // the generated columns of the collection indexes.
+  class Sql_generator
+  {
+  public:
+    static std::string find(const Mysqlx::Crud::Find& find);
+    static std::string update(const Mysqlx::Crud::Update& update);
+    static std::string remove(const Mysqlx::Crud::Delete& remove);
+
+    // The expression as SQL, the placeholders replaced by the arguments
+    static std::string expression(const Mysqlx::Expr::Expr& expr, bool document_mode,
+                                  const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar>& args);
+
+  private:
+    Sql_generator(bool document_mode, const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar>& args)
+      : m_document_mode(document_mode), m_args(args) {}
+
+    std::string generate(const Mysqlx::Expr::Expr& expr) const;
+    std::string identifier(const Mysqlx::Expr::ColumnIdentifier& column) const;
+    std::string function_call(const Mysqlx::Expr::FunctionCall& call) const;
+    std::string operator_(const Mysqlx::Expr::Operator& op) const;
+    std::string object(const Mysqlx::Expr::Object& object) const;
+    std::string array(const Mysqlx::Expr::Array& array) const;
+    std::string placeholder(uint32_t position) const;
+
+    std::string collection(const Mysqlx::Crud::Collection& collection) const;
+    std::string filter(const Mysqlx::Expr::Expr& criteria) const;
+    std::string order(const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Crud::Order>& order) const;
+    std::string limit(const Mysqlx::Crud::Limit& limit, bool with_offset) const;
+    std::string operations(const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Crud::UpdateOperation>& operations) const;
+
+    static std::string scalar(const Mysqlx::Datatypes::Scalar& scalar);
+    static std::string document_path(const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Expr::DocumentPathItem>& path);
+    static std::string quote_identifier(const std::string& id);
+    static std::string quote_string(const std::string& s);
+
+    bool m_document_mode;
+    const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar>& m_args;
+  };
+};
+
+#endif
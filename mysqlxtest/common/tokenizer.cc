@@ -156,12 +156,80 @@ Tokenizer::Maps::Maps()
   unary_operator_names["-"] = "sign_minus";
   unary_operator_names["~"] = "~";
   unary_operator_names["not"] = "not";
+
+  _reserved_words_by_length.resize(k_max_reserved_word_length + 1);
+  for (reserved_words_t::const_iterator it = reserved_words.begin(); it != reserved_words.end(); ++it)
+  {
+    if (it->first.size() <= k_max_reserved_word_length)
+      _reserved_words_by_length[it->first.size()].push_back(*it);
+  }
+
+  for (int c = 0; c < 256; c++)
+  {
+    char_class[c] = Other;
+    single_char_tokens[c] = 0;
+
+    // Only ASCII characters are part of the grammar
+    if (c < 128)
+    {
+      if (std::isspace(c))
+        char_class[c] = Space;
+      else if (std::isdigit(c))
+        char_class[c] = Digit;
+      else if (std::isalpha(c) || c == '_')
+        char_class[c] = Ident_start;
+    }
+  }
+
+  single_char_tokens[(unsigned char)'?'] = Token::PLACEHOLDER;
+  single_char_tokens[(unsigned char)'+'] = Token::PLUS;
+  single_char_tokens[(unsigned char)'/'] = Token::DIV;
+  single_char_tokens[(unsigned char)'$'] = Token::DOLLAR;
+  single_char_tokens[(unsigned char)'%'] = Token::MOD;
+  single_char_tokens[(unsigned char)'='] = Token::EQ;
+  single_char_tokens[(unsigned char)'&'] = Token::BITAND;
+  single_char_tokens[(unsigned char)'|'] = Token::BITOR;
+  single_char_tokens[(unsigned char)'('] = Token::LPAREN;
+  single_char_tokens[(unsigned char)')'] = Token::RPAREN;
+  single_char_tokens[(unsigned char)'['] = Token::LSQBRACKET;
+  single_char_tokens[(unsigned char)']'] = Token::RSQBRACKET;
+  single_char_tokens[(unsigned char)'{'] = Token::LCURLY;
+  single_char_tokens[(unsigned char)'}'] = Token::RCURLY;
+  single_char_tokens[(unsigned char)'~'] = Token::NEG;
+  single_char_tokens[(unsigned char)','] = Token::COMMA;
+  single_char_tokens[(unsigned char)':'] = Token::COLON;
+}
+
+bool Tokenizer::Maps::find_reserved_word(const char *word, size_t length, Token::TokenType &type) const
+{
+  if (length > k_max_reserved_word_length)
+    return false;
+
+  char lower[k_max_reserved_word_length];
+  for (size_t index = 0; index < length; index++)
+    lower[index] = static_cast<char>(std::tolower(static_cast<unsigned char>(word[index])));
+
+  const std::vector<std::pair<std::string, Token::TokenType> > &words(_reserved_words_by_length[length]);
+  for (size_t index = 0; index < words.size(); index++)
+  {
+    if (std::memcmp(words[index].first.data(), lower, length) == 0)
+    {
+      type = words[index].second;
+      return true;
+    }
+  }
+
+  return false;
 }
 
 Token::Token(Token::TokenType type, const std::string& text, int cur_pos) : _type(type), _text(text), _pos(cur_pos)
 {
 }
 
+Token::Token(Token::TokenType type, const char *text, size_t length, int cur_pos) : _type(type), _text(text, length), _pos(cur_pos)
+{
+}
+
 struct Tokenizer::Maps map;
 
 Tokenizer::Tokenizer(const std::string& input) : _input(input)
@@ -223,15 +291,21 @@ void Tokenizer::get_tokens()
 {
   bool arrow_last = false;
   bool inside_arrow = false;
+
+  // Most tokens take at least a couple of characters with their separator
+  _tokens.reserve(_input.size() / 2 + 1);
+
+  const char *input = _input.data();
   for (size_t i = 0; i < _input.size(); ++i)
   {
     char c = _input[i];
-    if (std::isspace(c))
+    unsigned char char_class = map.char_class[static_cast<unsigned char>(c)];
+    if (char_class == Maps::Space)
     {
       // do nothing
       continue;
     }
-    else if (std::isdigit(c))
+    else if (char_class == Maps::Digit)
     {
       // numerical literal
       int start = i;
@@ -258,25 +332,22 @@ void Tokenizer::get_tokens()
           if (i == j)
             throw Parser_error((boost::format("Tokenizer: Missing exponential value for floating point at char %d") % i).str());
         }
-        _tokens.push_back(Token(Token::LNUM, std::string(_input, start, i - start), i));
+        _tokens.push_back(Token(Token::LNUM, input + start, i - start, i));
       }
       else
       {
-        _tokens.push_back(Token(Token::LINTEGER, std::string(_input, start, i - start), i));
+        _tokens.push_back(Token(Token::LINTEGER, input + start, i - start, i));
       }
       if (i < _input.size())
         --i;
     }
-    else if (!std::isalpha(c) && c != '_')
+    else if (char_class != Maps::Ident_start)
     {
       // # non-identifier, e.g. operator or quoted literal
-      if (c == '?')
-      {
-        _tokens.push_back(Token(Token::PLACEHOLDER, std::string(1, c), i));
-      }
-      else if (c == '+')
+      int single_char_token = map.single_char_tokens[static_cast<unsigned char>(c)];
+      if (single_char_token)
       {
-        _tokens.push_back(Token(Token::PLUS, std::string(1, c), i));
+        _tokens.push_back(Token(Token::TokenType(single_char_token), input + i, 1, i));
       }
       else if (c == '-')
       {
@@ -302,66 +373,6 @@ void Tokenizer::get_tokens()
           _tokens.push_back(Token(Token::MUL, std::string(1, c), i));
         }
       }
-      else if (c == '/')
-      {
-        _tokens.push_back(Token(Token::DIV, std::string(1, c), i));
-      }
-      else if (c == '$')
-      {
-        _tokens.push_back(Token(Token::DOLLAR, std::string(1, c), i));
-      }
-      else if (c == '%')
-      {
-        _tokens.push_back(Token(Token::MOD, std::string(1, c), i));
-      }
-      else if (c == '=')
-      {
-        _tokens.push_back(Token(Token::EQ, std::string(1, c), i));
-      }
-      else if (c == '&')
-      {
-        _tokens.push_back(Token(Token::BITAND, std::string(1, c), i));
-      }
-      else if (c == '|')
-      {
-        _tokens.push_back(Token(Token::BITOR, std::string(1, c), i));
-      }
-      else if (c == '(')
-      {
-        _tokens.push_back(Token(Token::LPAREN, std::string(1, c), i));
-      }
-      else if (c == ')')
-      {
-        _tokens.push_back(Token(Token::RPAREN, std::string(1, c), i));
-      }
-      else if (c == '[')
-      {
-        _tokens.push_back(Token(Token::LSQBRACKET, std::string(1, c), i));
-      }
-      else if (c == ']')
-      {
-        _tokens.push_back(Token(Token::RSQBRACKET, std::string(1, c), i));
-      }
-      else if (c == '{')
-      {
-        _tokens.push_back(Token(Token::LCURLY, std::string(1, c), i));
-      }
-      else if (c == '}')
-      {
-        _tokens.push_back(Token(Token::RCURLY, std::string(1, c), i));
-      }
-      else if (c == '~')
-      {
-        _tokens.push_back(Token(Token::NEG, std::string(1, c), i));
-      }
-      else if (c == ',')
-      {
-        _tokens.push_back(Token(Token::COMMA, std::string(1, c), i));
-      }
-      else if (c == ':')
-      {
-        _tokens.push_back(Token(Token::COLON, std::string(1, c), i));
-      }
       else if (c == '!')
       {
         if (next_char_is(i, '='))
@@ -437,7 +448,7 @@ void Tokenizer::get_tokens()
             if (i == j)
               throw Parser_error((boost::format("Tokenizer: Missing exponential value for floating point at char %d") % i).str());
           }
-          _tokens.push_back(Token(Token::LNUM, std::string(_input, start, i - start), i));
+          _tokens.push_back(Token(Token::LNUM, input + start, i - start, i));
           if (i < _input.size())
             --i;
         }
@@ -504,18 +515,11 @@ void Tokenizer::get_tokens()
     else
     {
       size_t start = i;
-      while (i < _input.size() && (std::isalnum(_input[i]) || _input[i] == '_'))
+      while (i < _input.size() && (map.char_class[static_cast<unsigned char>(_input[i])] & Maps::Ident))
         ++i;
-      std::string val(_input, start, i - start);
-      Maps::reserved_words_t::const_iterator it = map.reserved_words.find(val);
-      if (it != map.reserved_words.end())
-      {
-        _tokens.push_back(Token(it->second, val, i));
-      }
-      else
-      {
-        _tokens.push_back(Token(Token::IDENT, val, i));
-      }
+      Token::TokenType type = Token::IDENT;
+      map.find_reserved_word(input + start, i - start, type);
+      _tokens.push_back(Token(type, input + start, i - start, i));
       --i;
     }
   }
@@ -139,6 +139,7 @@ namespace mysqlx
     };
 
     Token(Token::TokenType type, const std::string& text, int cur_pos);
+    Token(Token::TokenType type, const char *text, size_t length, int cur_pos);
 
     const std::string& get_text() const { return _text; }
     TokenType get_type() const { return _type; }
@@ -192,13 +193,36 @@ namespace mysqlx
 
     struct Maps
     {
+      enum Char_class
+      {
+        Other = 0,
+        Space = 1,
+        Digit = 2,
+        Ident_start = 4,
+        Ident = Digit | Ident_start
+      };
+
       typedef std::map<std::string, Token::TokenType, Cmp_icase> reserved_words_t;
       reserved_words_t reserved_words;
       std::set<Token::TokenType> interval_units;
       std::map<std::string, std::string, Cmp_icase> operator_names;
       std::map<std::string, std::string, Cmp_icase> unary_operator_names;
 
+      // Lookup tables used by the lexer, indexed by the unsigned char value:
+      // the class of each character and the type of the tokens made of a
+      // single character with no possible continuation (0 for the rest)
+      unsigned char char_class[256];
+      int single_char_tokens[256];
+
       Maps();
+
+      // Finds a reserved word without building a string out of the input,
+      // the words are kept in lower case and grouped by length
+      bool find_reserved_word(const char *word, size_t length, Token::TokenType &type) const;
+
+    private:
+      static const size_t k_max_reserved_word_length = 16;
+      std::vector<std::vector<std::pair<std::string, Token::TokenType> > > _reserved_words_by_length;
     };
 
   public:
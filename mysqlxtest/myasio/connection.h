@@ -45,6 +45,11 @@ public:
   virtual IOptions_session_ptr options() = 0;
 
   virtual void async_connect(const Endpoint &endpoint, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_read_callback) = 0;
+  // Connects to the Unix socket at the path instead, not every transport has them
+  virtual void async_connect_local(const std::string &, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &)
+  {
+    on_connect_callback(boost::system::errc::make_error_code(boost::system::errc::not_supported));
+  }
   virtual void async_accept(boost::asio::ip::tcp::acceptor &acceptor, const On_asio_status_callback &on_accept_callback, const On_asio_status_callback &on_read_callback) = 0;
   virtual void async_write(const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback) = 0;
   virtual void async_read(const Mutable_buffer_sequence &data, const On_asio_data_callback &on_read_callback) = 0;
@@ -94,6 +94,13 @@ void Connection_dynamic_tls::async_connect(const Endpoint &endpoint,
   m_operational_mode->async_connect(endpoint, on_connect_callback, on_ready_callback);
 }
 
+void Connection_dynamic_tls::async_connect_local(const std::string &path,
+                                                 const On_asio_status_callback &on_connect_callback,
+                                                 const On_asio_status_callback &on_ready_callback)
+{
+  m_operational_mode->async_connect_local(path, on_connect_callback, on_ready_callback);
+}
+
 void Connection_dynamic_tls::async_accept(boost::asio::ip::tcp::acceptor &acceptor,
                                           const On_asio_status_callback &on_accept_callback,
                                           const On_asio_status_callback &on_ready_callback)
@@ -44,6 +44,7 @@ public:
 
   // Read, write SDU (service data unit)
   virtual void async_connect(const Endpoint &, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
+  virtual void async_connect_local(const std::string &path, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
   virtual void async_accept(boost::asio::ip::tcp::acceptor &, const On_asio_status_callback &on_accept_callback, const On_asio_status_callback &on_ready_callback);
   virtual void async_write(const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback);
   virtual void async_read(const Mutable_buffer_sequence &data, const On_asio_data_callback &on_read_callback);
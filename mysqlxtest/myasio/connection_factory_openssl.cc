@@ -24,6 +24,7 @@
 
 #include <boost/asio/ssl.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include "myasio/connection_factory_openssl.h"
 #include "myasio/connection_openssl.h"
@@ -43,6 +44,12 @@ Connection_openssl_factory::Connection_openssl_factory(const std::string &ssl_ke
   : m_context(new boost::asio::ssl::context(static_cast<boost::asio::ssl::context::method>(get_tls_method(ssl_tls_version, is_client)))),
   m_is_client(is_client)
 {
+  if (is_client)
+  {
+    m_session_cache_key = boost::lexical_cast<std::string>(ssl_mode) + "|" + ssl_tls_version + "|" + ssl_cipher + "|" +
+                          ssl_ca + "|" + ssl_ca_path + "|" + ssl_crl + "|" + ssl_crl_path + "|" + ssl_cert + "|" + ssl_key;
+  }
+
   try
   {
     m_context->set_options(boost::asio::ssl::context::default_workarounds |
@@ -101,7 +108,7 @@ Connection_openssl_factory::~Connection_openssl_factory()
 IConnection_unique_ptr Connection_openssl_factory::create_connection(boost::asio::io_service &io_service)
 {
   return IConnection_unique_ptr(new Connection_dynamic_tls(IConnection_unique_ptr(
-                                    new Connection_openssl(io_service, boost::ref(*m_context), m_is_client))));
+                                    new Connection_openssl(io_service, boost::ref(*m_context), m_is_client, m_session_cache_key))));
 }
 
 
@@ -23,6 +23,7 @@
 
 
 #include <boost/scoped_ptr.hpp>
+#include <string>
 
 #include "myasio/connection_factory.h"
 
@@ -62,6 +63,9 @@ private:
   int get_tls_method(const std::string& tls_version, bool is_client = true) const;
   boost::asio::ssl::context *m_context;
   const bool m_is_client;
+  // TLS configuration of the context, the sessions are resumed only
+  // by connections with the same one
+  std::string m_session_cache_key;
 };
 
 
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#if defined(HAVE_IO_URING)
+
+#include "myasio/connection_factory_uring.h"
+
+#include "myasio/connection_uring.h"
+#include "myasio/uring.h"
+
+namespace ngs
+{
+
+  bool Connection_uring_factory::is_supported()
+  {
+    return Uring::is_supported();
+  }
+
+  IConnection_unique_ptr Connection_uring_factory::create_connection(boost::asio::io_service &io_service)
+  {
+    return IConnection_unique_ptr(new Connection_uring(io_service));
+  }
+
+  IOptions_context_ptr Connection_uring_factory::create_ssl_context_options()
+  {
+    return IOptions_context_ptr();
+  }
+
+} // namespace ngs
+
+#endif // defined(HAVE_IO_URING)
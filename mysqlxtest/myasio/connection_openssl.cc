@@ -22,21 +22,25 @@
 #if !defined(HAVE_YASSL)
 
 #include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include "myasio/connection_openssl.h"
 #include "myasio/connection_raw.h"
 #include "myasio/callback.h"
 #include "myasio/options_ssl.h"
+#include "myasio/tls_session_cache.h"
 
 
 using namespace ngs;
 
 
-Connection_openssl::Connection_openssl(boost::asio::io_service &service, boost::asio::ssl::context &context, const bool is_client)
+Connection_openssl::Connection_openssl(boost::asio::io_service &service, boost::asio::ssl::context &context, const bool is_client,
+                                       const std::string &session_cache_key)
 : m_handshake_type(is_client ? boost::asio::ssl::stream_base::client : boost::asio::ssl::stream_base::server),
   m_asio_socket(service, context),
   m_asio_strand(service),
-  m_state(State_handshake)
+  m_state(State_handshake),
+  m_session_cache_key(is_client ? session_cache_key : "")
 {
 }
 
@@ -127,6 +131,20 @@ void Connection_openssl::async_activate_tls(const On_asio_status_callback on_sta
     m_ready_callback = on_status;
   }
 
+  std::string session_data;
+  if (!m_session_cache_key.empty() &&
+      Tls_session_cache::instance().get(get_session_cache_key(), session_data))
+  {
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(session_data.data());
+    SSL_SESSION *session = d2i_SSL_SESSION(NULL, &data, static_cast<long>(session_data.size()));
+
+    if (session)
+    {
+      SSL_set_session(m_asio_socket.native_handle(), session);
+      SSL_SESSION_free(session);
+    }
+  }
+
   m_asio_socket.async_handshake(m_handshake_type, m_asio_strand.wrap(boost::bind(&Connection_openssl::on_handshake, this, boost::asio::placeholders::error)));
 }
 
@@ -193,12 +211,44 @@ void Connection_openssl::on_connect_try_handshake(const boost::system::error_cod
   async_activate_tls(On_asio_status_callback());
 }
 
+std::string Connection_openssl::get_session_cache_key() const
+{
+  boost::system::error_code ec;
+  Endpoint endpoint = m_asio_socket.lowest_layer().remote_endpoint(ec);
+
+  return m_session_cache_key + "@" + endpoint.address().to_string(ec) + ":" + boost::lexical_cast<std::string>(endpoint.port());
+}
+
 void Connection_openssl::on_handshake(const boost::system::error_code &error)
 {
   Callback_post callback(boost::bind(&Connection_openssl::post, this, _1));
   m_state = error ? State_stop :
                     State_running;
 
+  if (!m_session_cache_key.empty())
+  {
+    std::string key = get_session_cache_key();
+
+    if (error)
+      Tls_session_cache::instance().remove(key);
+    else
+    {
+      SSL_SESSION *session = SSL_get1_session(m_asio_socket.native_handle());
+      int size = session ? i2d_SSL_SESSION(session, NULL) : 0;
+
+      if (size > 0)
+      {
+        std::string session_data(size, '\0');
+        unsigned char *data = reinterpret_cast<unsigned char*>(&session_data[0]);
+        i2d_SSL_SESSION(session, &data);
+        Tls_session_cache::instance().put(key, session_data);
+      }
+
+      if (session)
+        SSL_SESSION_free(session);
+    }
+  }
+
 
   callback.call_status_function(m_ready_callback, error);
 }
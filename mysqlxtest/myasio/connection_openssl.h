@@ -33,7 +33,10 @@ namespace ngs
 class Connection_openssl : public IConnection
 {
 public:
-  Connection_openssl(boost::asio::io_service &socket, boost::asio::ssl::context &context, const bool is_client = false);
+  // Client connections with a session cache key resume the TLS sessions
+  // of previous connections to the same endpoint with that key
+  Connection_openssl(boost::asio::io_service &socket, boost::asio::ssl::context &context, const bool is_client = false,
+                     const std::string &session_cache_key = "");
   virtual ~Connection_openssl();
 
   virtual Endpoint    get_remote_endpoint() const;
@@ -65,6 +68,7 @@ private:
   void on_connect_try_handshake(const boost::system::error_code &ec);
   void on_accept_try_handshake(boost::asio::io_service &acceptor, const boost::system::error_code &ec);
   void on_handshake(const boost::system::error_code &ec);
+  std::string get_session_cache_key() const;
 
   handshake_type m_handshake_type;
   stream         m_asio_socket;
@@ -74,6 +78,7 @@ private:
   On_asio_status_callback m_ready_callback;
 
   State m_state;
+  std::string m_session_cache_key;
 };
 
 }  // namespace ngs
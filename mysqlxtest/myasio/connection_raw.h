@@ -30,6 +30,14 @@
 #include <boost/type_traits/remove_reference.hpp>
 #include "myasio/connection.h"
 
+#if !defined(_WIN32)
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 #define LOG_DOMAIN "ngs.protocol"
 #include "ngs/log.h"
 
@@ -85,6 +93,7 @@ public:
   virtual IOptions_session_ptr options();
 
   virtual void async_connect(const Endpoint &endpoint, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
+  virtual void async_connect_local(const std::string &path, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
   virtual void async_accept(boost::asio::ip::tcp::acceptor &, const On_asio_status_callback &on_accept_callback,
                             const On_asio_status_callback &on_ready_callback);
   virtual void async_write(const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback);
@@ -106,6 +115,7 @@ private:
 
   void on_accept(boost::asio::io_service &service, const boost::system::error_code &ec);
   void on_connect(const boost::system::error_code &ec);
+  void on_connect_local(const boost::system::error_code &ec);
 
   Socket_type          m_asio_socket;
   boost::asio::strand  m_asio_strand;
@@ -166,6 +176,47 @@ void Connection_raw<Socket_type>::async_connect(const Endpoint &endpoint,
 }
 
 
+template <typename Socket_type>
+void Connection_raw<Socket_type>::async_connect_local(const std::string &path,
+                                                     const On_asio_status_callback &on_connect_callback,
+                                                     const On_asio_status_callback &on_ready_callback)
+{
+  m_on_accept_callback = on_connect_callback;
+  m_on_ready_callback = on_ready_callback;
+
+  boost::system::error_code ec = boost::system::errc::make_error_code(boost::system::errc::not_supported);
+
+#if !defined(_WIN32)
+  // Local connections are immediate, the socket connected here is then
+  // used through asio like any other
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(address.sun_path))
+  {
+    ec = boost::system::errc::make_error_code(boost::system::errc::filename_too_long);
+  }
+  else
+  {
+    memcpy(address.sun_path, path.c_str(), path.size());
+
+    int socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (socket < 0 || ::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+      ec = boost::system::error_code(errno, boost::system::system_category());
+    else
+      m_asio_socket.assign(boost::asio::ip::tcp::v4(), socket, ec);
+
+    if (ec && socket >= 0)
+      ::close(socket);
+  }
+#endif
+
+  m_asio_strand.post(boost::bind(&Connection_raw<Socket_type>::on_connect_local, this, ec));
+}
+
+
 template <typename Socket_type>
 void Connection_raw<Socket_type>::async_accept(boost::asio::ip::tcp::acceptor &acceptor,
                                       const On_asio_status_callback &on_accept_callback,
@@ -274,6 +325,20 @@ void Connection_raw<Socket_type>::on_connect(const boost::system::error_code &ec
   m_on_ready_callback.clear();
 }
 
+template <typename Socket_type>
+void Connection_raw<Socket_type>::on_connect_local(const boost::system::error_code &ec)
+{
+  // Unlike on_connect() there is no TCP_NODELAY to set
+  Callback_post callback(boost::bind(&Connection_raw<Socket_type>::post, this, _1));
+
+  callback.call_status_function(m_on_accept_callback, ec);
+
+  if (!ec)
+    callback.call_status_function(m_on_ready_callback, ec);
+
+  m_on_ready_callback.clear();
+}
+
 }  // namespace ngs
 
 
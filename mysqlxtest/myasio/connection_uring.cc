@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#if defined(HAVE_IO_URING)
+
+#include "myasio/connection_uring.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include "myasio/connection_raw.h"
+#include "myasio/uring.h"
+#include "ngs/protocol/page_pool.h"
+
+
+namespace ngs
+{
+
+namespace
+{
+
+// A request and the read of its response need a few entries at most
+const unsigned k_ring_entries = 8;
+const uint32_t k_write_page_size = 64 * 1024;
+
+// Longest wait for the ring before letting the io_service run its other
+// handlers
+const int k_wait_slice_ms = 100;
+
+// Longest wait for the pending writes on shutdown and close
+const int k_flush_timeout_ms = 1000;
+
+boost::system::error_code error_from_result(const int result)
+{
+  if (result == -ECANCELED)
+    return boost::asio::error::operation_aborted;
+
+  if (result < 0)
+    return boost::system::error_code(-result, boost::system::system_category());
+
+  return boost::system::error_code();
+}
+
+void keep_connection(IConnection *)
+{
+}
+
+} // namespace
+
+
+struct Connection_uring::State
+{
+  State()
+  : ring_error(0), socket(-1), address_length(0), write_page(k_write_page_size),
+    write_offset(0), write_id(0), write_error(0), fixed_buffer(false), closed(false), operation_id(0)
+  {
+    if (ring.open(k_ring_entries))
+      fixed_buffer = ring.register_buffer(write_page.data, write_page.capacity);
+    else
+      ring_error = errno ? errno : ENOSYS;
+  }
+
+  ~State()
+  {
+    if (socket >= 0)
+      ::close(socket);
+  }
+
+  bool writing() const { return write_id != 0; }
+  bool unsent() const { return write_offset < write_page.length; }
+
+  int              ring_error;
+  int              socket;
+  sockaddr_storage address;
+  socklen_t        address_length;
+
+  // Written data waiting for a full page or the next read. The page may
+  // not be registered when it goes past RLIMIT_MEMLOCK, then it is sent
+  // with plain writes.
+  Page     write_page;
+  uint32_t write_offset;
+  uint64_t write_id;
+  int      write_error;
+  bool     fixed_buffer;
+
+  bool     closed;
+  uint64_t operation_id;
+
+  // Last, so it is closed before the page registered with it is freed
+  Uring ring;
+};
+
+
+struct Connection_uring::Operation
+{
+  Operation() : done(false), result(0) {}
+
+  bool done;
+  int  result;
+};
+
+
+Connection_uring::Connection_uring(boost::asio::io_service &service)
+: m_service(service),
+  m_state(boost::make_shared<State>())
+{
+}
+
+
+Connection_uring::~Connection_uring()
+{
+  close();
+}
+
+
+int Connection_uring::get_socket_id()
+{
+  return m_state->socket;
+}
+
+
+Endpoint Connection_uring::get_remote_endpoint() const
+{
+  Endpoint result;
+  socklen_t length = static_cast<socklen_t>(result.capacity());
+
+  if (0 == getpeername(m_state->socket, result.data(), &length))
+    result.resize(length);
+
+  return result;
+}
+
+
+IOptions_session_ptr Connection_uring::options()
+{
+  static IOptions_session_ptr result(boost::make_shared<Options_default>());
+  return result;
+}
+
+
+IConnection_ptr Connection_uring::get_lowest_layer()
+{
+  return IConnection_ptr(this, &keep_connection);
+}
+
+
+void Connection_uring::async_connect(const Endpoint &endpoint,
+                                     const On_asio_status_callback &on_connect_callback,
+                                     const On_asio_status_callback &on_ready_callback)
+{
+  start_connect(endpoint.data(), static_cast<socklen_t>(endpoint.size()), endpoint.protocol().protocol(),
+                on_connect_callback, on_ready_callback);
+}
+
+
+void Connection_uring::async_connect_local(const std::string &path,
+                                           const On_asio_status_callback &on_connect_callback,
+                                           const On_asio_status_callback &on_ready_callback)
+{
+  sockaddr_un address;
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(address.sun_path))
+  {
+    m_service.post(boost::bind(&Connection_uring::on_connect, m_state, on_connect_callback, on_ready_callback, -ENAMETOOLONG));
+    return;
+  }
+
+  memcpy(address.sun_path, path.c_str(), path.size());
+  start_connect(reinterpret_cast<const sockaddr*>(&address), sizeof(address), 0, on_connect_callback, on_ready_callback);
+}
+
+
+void Connection_uring::start_connect(const sockaddr *address, const socklen_t address_length, const int protocol,
+                                     const On_asio_status_callback &on_connect_callback,
+                                     const On_asio_status_callback &on_ready_callback)
+{
+  State &state = *m_state;
+  int error = state.ring_error;
+
+  if (!error && state.socket < 0)
+  {
+    state.socket = ::socket(address->sa_family, SOCK_STREAM | SOCK_CLOEXEC, protocol);
+    if (state.socket < 0)
+      error = errno;
+  }
+
+  if (error)
+  {
+    m_service.post(boost::bind(&Connection_uring::on_connect, m_state, on_connect_callback, on_ready_callback, -error));
+    return;
+  }
+
+  state.closed = false;
+  memcpy(&state.address, address, address_length);
+  state.address_length = address_length;
+
+  Operation_ptr operation(boost::make_shared<Operation>());
+  io_uring_sqe *sqe = state.ring.prepare(boost::bind(&Connection_uring::on_operation, operation, _1), &state.operation_id);
+
+  sqe->opcode = IORING_OP_CONNECT;
+  sqe->fd = state.socket;
+  sqe->addr = reinterpret_cast<uint64_t>(&state.address);
+  sqe->off = state.address_length;
+
+  m_service.post(boost::bind(&Connection_uring::wait, boost::ref(m_service), m_state, operation,
+                             On_result(boost::bind(&Connection_uring::on_connect, m_state, on_connect_callback, on_ready_callback, _1))));
+}
+
+
+void Connection_uring::async_accept(boost::asio::ip::tcp::acceptor &,
+                                    const On_asio_status_callback &on_accept_callback,
+                                    const On_asio_status_callback &)
+{
+  m_service.post(boost::bind(on_accept_callback, boost::system::errc::make_error_code(boost::system::errc::not_supported)));
+}
+
+
+void Connection_uring::async_write(const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback)
+{
+  m_service.post(boost::bind(&Connection_uring::write, boost::ref(m_service), m_state, data, on_write_callback));
+}
+
+
+void Connection_uring::async_read(const Mutable_buffer_sequence &data, const On_asio_data_callback &on_read_callback)
+{
+  State &state = *m_state;
+
+  if (state.socket < 0 || state.write_error)
+  {
+    const int error = state.socket < 0 ? EBADF : state.write_error;
+
+    state.write_error = 0;
+    m_service.post(boost::bind(&Connection_uring::on_read, m_state, on_read_callback, -error));
+    return;
+  }
+
+  Mutable_buffer_sequence::const_iterator buffer = data.begin();
+
+  while (buffer != data.end() && 0 == boost::asio::buffer_size(*buffer))
+    ++buffer;
+
+  if (buffer == data.end())
+  {
+    m_service.post(boost::bind(on_read_callback, boost::system::error_code(), 0));
+    return;
+  }
+
+  // The pending writes go to the kernel along with the read
+  if (!state.writing() && state.unsent())
+    start_write(&state);
+
+  Operation_ptr operation(boost::make_shared<Operation>());
+  io_uring_sqe *sqe = state.ring.prepare(boost::bind(&Connection_uring::on_operation, operation, _1), &state.operation_id);
+
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = state.socket;
+  sqe->addr = reinterpret_cast<uint64_t>(boost::asio::buffer_cast<char*>(*buffer));
+  sqe->len = static_cast<uint32_t>(std::min<std::size_t>(boost::asio::buffer_size(*buffer), UINT32_MAX));
+
+  m_service.post(boost::bind(&Connection_uring::wait, boost::ref(m_service), m_state, operation,
+                             On_result(boost::bind(&Connection_uring::on_read, m_state, on_read_callback, _1))));
+}
+
+
+void Connection_uring::async_activate_tls(const On_asio_status_callback on_status)
+{
+  on_status(boost::system::errc::make_error_code(boost::system::errc::not_supported));
+}
+
+
+void Connection_uring::post(const boost::function<void ()> &calee)
+{
+  m_service.post(calee);
+}
+
+
+bool Connection_uring::thread_in_connection_strand()
+{
+  // The handlers of the connection are not serialized by a strand, it is
+  // meant for the thread running its io_service
+  return true;
+}
+
+
+void Connection_uring::shutdown(boost::asio::socket_base::shutdown_type how_to_shutdown, boost::system::error_code &ec)
+{
+  State &state = *m_state;
+
+  if (how_to_shutdown != boost::asio::socket_base::shutdown_receive)
+    flush(&state);
+
+  if (::shutdown(state.socket, static_cast<int>(how_to_shutdown)) < 0)
+    ec = boost::system::error_code(errno, boost::system::system_category());
+  else
+    ec = boost::system::error_code();
+}
+
+
+void Connection_uring::cancel()
+{
+  State &state = *m_state;
+
+  if (state.operation_id)
+    cancel_operation(&state, state.operation_id);
+
+  if (state.write_id)
+    cancel_operation(&state, state.write_id);
+
+  if (state.ring_error == 0)
+    state.ring.enter(0, 0);
+}
+
+
+void Connection_uring::close()
+{
+  State &state = *m_state;
+
+  if (state.socket < 0)
+    return;
+
+  flush(&state);
+
+  // What is still in flight completes as aborted
+  state.closed = true;
+  cancel();
+
+  ::close(state.socket);
+  state.socket = -1;
+}
+
+
+void Connection_uring::start_write(State *state)
+{
+  io_uring_sqe *sqe = state->ring.prepare(boost::bind(&Connection_uring::on_write, state, _1), &state->write_id);
+
+  sqe->opcode = state->fixed_buffer ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  sqe->fd = state->socket;
+  sqe->addr = reinterpret_cast<uint64_t>(state->write_page.data + state->write_offset);
+  sqe->len = state->write_page.length - state->write_offset;
+  sqe->buf_index = 0;
+}
+
+
+void Connection_uring::on_write(State *state, const int result)
+{
+  // The ring runs the callbacks only from enter(), called by the owners of
+  // the state, so it is alive here
+  state->write_id = 0;
+
+  if (result < 0)
+  {
+    state->write_error = -result;
+    state->write_page.length = state->write_offset = 0;
+    return;
+  }
+
+  state->write_offset += result;
+
+  // The rest of a short write goes with the next enter()
+  if (state->unsent())
+    start_write(state);
+  else
+    state->write_page.length = state->write_offset = 0;
+}
+
+
+void Connection_uring::flush(State *state)
+{
+  if (state->ring_error || state->socket < 0)
+    return;
+
+  if (!state->writing() && state->unsent())
+    start_write(state);
+
+  for (int waited = 0; state->writing() && waited < k_flush_timeout_ms; waited += k_wait_slice_ms)
+  {
+    if (state->ring.enter(1, k_wait_slice_ms))
+      break;
+  }
+}
+
+
+void Connection_uring::cancel_operation(State *state, const uint64_t id)
+{
+  io_uring_sqe *sqe = state->ring.prepare(Uring::On_complete());
+
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = id;
+}
+
+
+void Connection_uring::on_operation(Operation_ptr operation, const int result)
+{
+  operation->done = true;
+  operation->result = result;
+}
+
+
+void Connection_uring::wait(boost::asio::io_service &service, State_ptr state, Operation_ptr operation, const On_result &on_result)
+{
+  if (!operation->done)
+  {
+    // A write in flight completes along with the operation
+    const int error = state->ring.enter(state->writing() ? 2 : 1, k_wait_slice_ms);
+
+    if (error)
+      on_operation(operation, error);
+  }
+
+  if (!operation->done)
+  {
+    service.post(boost::bind(&Connection_uring::wait, boost::ref(service), state, operation, on_result));
+    return;
+  }
+
+  state->operation_id = 0;
+  on_result(state->closed ? -ECANCELED : operation->result);
+}
+
+
+void Connection_uring::write(boost::asio::io_service &service, State_ptr state, const Const_buffer_sequence &data,
+                             const On_asio_data_callback &on_write_callback)
+{
+  if (state->socket < 0 || state->write_error)
+  {
+    const int error = state->socket < 0 ? EBADF : state->write_error;
+
+    state->write_error = 0;
+    on_write_callback(error_from_result(-error), 0);
+    return;
+  }
+
+  // The page is not touched while it is sent
+  if (state->writing())
+  {
+    const int error = state->ring.enter(1, k_wait_slice_ms);
+
+    if (error)
+      on_write_callback(error_from_result(error), 0);
+    else
+      service.post(boost::bind(&Connection_uring::write, boost::ref(service), state, data, on_write_callback));
+    return;
+  }
+
+  Page &page = state->write_page;
+  std::size_t written = 0;
+
+  for (Const_buffer_sequence::const_iterator buffer = data.begin(); buffer != data.end() && page.get_free_bytes(); ++buffer)
+  {
+    const std::size_t size = std::min<std::size_t>(boost::asio::buffer_size(*buffer), page.get_free_bytes());
+
+    memcpy(page.get_free_ptr(), boost::asio::buffer_cast<const char*>(*buffer), size);
+    page.length += static_cast<uint32_t>(size);
+    written += size;
+  }
+
+  // A full page goes out right away, its completion is reaped later
+  if (!page.get_free_bytes())
+  {
+    start_write(state.get());
+
+    const int error = state->ring.enter(0, 0);
+
+    if (error)
+    {
+      on_write_callback(error_from_result(error), 0);
+      return;
+    }
+  }
+
+  on_write_callback(boost::system::error_code(), written);
+}
+
+
+void Connection_uring::on_connect(State_ptr state, const On_asio_status_callback &on_connect_callback,
+                                  const On_asio_status_callback &on_ready_callback, const int result)
+{
+  const boost::system::error_code ec = error_from_result(result);
+
+  if (!ec && state->address.ss_family != AF_UNIX)
+  {
+    const int no_delay = 1;
+
+    if (setsockopt(state->socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) < 0)
+      log_warning("Setting socket option failed with message: %s", strerror(errno));
+  }
+
+  if (on_connect_callback)
+    on_connect_callback(ec);
+
+  if (!ec && on_ready_callback)
+    on_ready_callback(ec);
+}
+
+
+void Connection_uring::on_read(State_ptr, const On_asio_data_callback &on_read_callback, const int result)
+{
+  if (result == 0)
+    on_read_callback(boost::asio::error::eof, 0);
+  else if (result < 0)
+    on_read_callback(error_from_result(result), 0);
+  else
+    on_read_callback(boost::system::error_code(), result);
+}
+
+} // namespace ngs
+
+#endif // defined(HAVE_IO_URING)
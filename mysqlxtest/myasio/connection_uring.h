@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+
+#ifndef _NGS_ASIO_CONNECTION_URING_H_
+#define _NGS_ASIO_CONNECTION_URING_H_
+
+#if defined(HAVE_IO_URING)
+
+#include <sys/socket.h>
+#include <boost/shared_ptr.hpp>
+#include "myasio/connection.h"
+
+
+namespace ngs
+{
+
+// A plain TCP connection doing its I/O through an io_uring of its own.
+// Writes are copied into a page registered with the ring and coalesced
+// there: the page is sent once full or together with the next read, so a
+// request and the read of its response cost a single system call. Reads go
+// straight into the buffer of the caller.
+//
+// The ring is waited for from handlers posted to the io_service, in slices
+// short enough for the other handlers of the service to run meanwhile, like
+// the timeouts of Mysqlx_sync_connection.
+class Connection_uring : public IConnection
+{
+public:
+  Connection_uring(boost::asio::io_service &service);
+  virtual ~Connection_uring();
+
+  virtual Endpoint    get_remote_endpoint() const;
+  virtual int         get_socket_id();
+  virtual IOptions_session_ptr options();
+
+  virtual void async_connect(const Endpoint &endpoint, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
+  virtual void async_connect_local(const std::string &path, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
+  virtual void async_accept(boost::asio::ip::tcp::acceptor &, const On_asio_status_callback &on_accept_callback,
+                            const On_asio_status_callback &on_ready_callback);
+  virtual void async_write(const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback);
+  virtual void async_read(const Mutable_buffer_sequence &data, const On_asio_data_callback &on_read_callback);
+  virtual void async_activate_tls(const On_asio_status_callback on_status);
+
+  virtual IConnection_ptr get_lowest_layer();
+
+  virtual void post(const boost::function<void ()> &calee);
+  virtual bool thread_in_connection_strand();
+
+  virtual void shutdown(boost::asio::socket_base::shutdown_type how_to_shutdown, boost::system::error_code &ec);
+  virtual void cancel();
+  virtual void close();
+
+private:
+  struct State;
+  struct Operation;
+  typedef boost::shared_ptr<State>     State_ptr;
+  typedef boost::shared_ptr<Operation> Operation_ptr;
+  typedef boost::function<void (int result)> On_result;
+
+  void start_connect(const sockaddr *address, const socklen_t address_length, const int protocol,
+                     const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback);
+
+  static void start_write(State *state);
+  static void on_write(State *state, const int result);
+  static void flush(State *state);
+  static void cancel_operation(State *state, const uint64_t id);
+  static void on_operation(Operation_ptr operation, const int result);
+  static void wait(boost::asio::io_service &service, State_ptr state, Operation_ptr operation, const On_result &on_result);
+  static void write(boost::asio::io_service &service, State_ptr state, const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback);
+  static void on_connect(State_ptr state, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &on_ready_callback, const int result);
+  static void on_read(State_ptr state, const On_asio_data_callback &on_read_callback, const int result);
+
+  boost::asio::io_service &m_service;
+  State_ptr m_state;
+};
+
+} // namespace ngs
+
+#endif // defined(HAVE_IO_URING)
+
+#endif // _NGS_ASIO_CONNECTION_URING_H_
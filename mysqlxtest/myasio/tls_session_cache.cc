@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "myasio/tls_session_cache.h"
+
+
+using namespace ngs;
+
+Tls_session_cache &Tls_session_cache::instance()
+{
+  static Tls_session_cache cache;
+  return cache;
+}
+
+bool Tls_session_cache::get(const std::string &key, std::string &session)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (!m_enabled)
+    return false;
+
+  std::map<std::string, std::string>::const_iterator found = m_sessions.find(key);
+  if (found == m_sessions.end())
+    return false;
+
+  session = found->second;
+  return true;
+}
+
+void Tls_session_cache::put(const std::string &key, const std::string &session)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (!m_enabled || session.empty())
+    return;
+
+  if (m_sessions.find(key) != m_sessions.end())
+    m_order.remove(key);
+  else if (m_sessions.size() >= k_max_sessions)
+  {
+    m_sessions.erase(m_order.front());
+    m_order.pop_front();
+  }
+
+  m_sessions[key] = session;
+  m_order.push_back(key);
+}
+
+void Tls_session_cache::remove(const std::string &key)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_sessions.erase(key))
+    m_order.remove(key);
+}
+
+void Tls_session_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_sessions.clear();
+  m_order.clear();
+}
+
+void Tls_session_cache::set_enabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_enabled = enabled;
+  if (!enabled)
+  {
+    m_sessions.clear();
+    m_order.clear();
+  }
+}
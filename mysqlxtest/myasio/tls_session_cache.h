@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _NGS_ASIO_TLS_SESSION_CACHE_H_
+#define _NGS_ASIO_TLS_SESSION_CACHE_H_
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+
+namespace ngs
+{
+
+// Client side TLS sessions of the process, serialized by the TLS library,
+// so a reconnection to the same endpoint with the same TLS configuration
+// resumes the session with an abbreviated handshake.
+// The key must identify both, resuming skips the certificate verification.
+class Tls_session_cache
+{
+public:
+  static Tls_session_cache &instance();
+
+  bool get(const std::string &key, std::string &session);
+  void put(const std::string &key, const std::string &session);
+  void remove(const std::string &key);
+  void clear();
+
+  // While disabled nothing is stored nor returned
+  void set_enabled(bool enabled);
+  bool enabled() const { return m_enabled; }
+
+private:
+  Tls_session_cache() : m_enabled(true) {}
+
+  static const std::size_t k_max_sessions = 128;
+
+  std::mutex m_mutex;
+  bool m_enabled;
+  std::map<std::string, std::string> m_sessions;
+  // Keys from the oldest to the newest stored, the oldest is evicted first
+  std::list<std::string> m_order;
+};
+
+} // namespace ngs
+
+#endif // _NGS_ASIO_TLS_SESSION_CACHE_H_
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#if defined(HAVE_IO_URING)
+
+#include "myasio/uring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace ngs
+{
+
+Uring::Uring()
+: m_fd(-1), m_features(0), m_ring(MAP_FAILED), m_ring_size(0),
+  m_sqes(NULL), m_sqes_size(0), m_next_id(0)
+{
+}
+
+
+Uring::~Uring()
+{
+  if (m_sqes)
+    munmap(m_sqes, m_sqes_size);
+  if (m_ring != MAP_FAILED)
+    munmap(m_ring, m_ring_size);
+  if (m_fd >= 0)
+    ::close(m_fd);
+}
+
+
+bool Uring::open(const unsigned entries)
+{
+  io_uring_params params;
+
+  memset(&params, 0, sizeof(params));
+  m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (m_fd < 0)
+    return false;
+
+  m_features = params.features;
+
+  // Both queues share one mapping since Linux 5.4, older kernels lack
+  // the timeouts of enter() anyway
+  if (!(m_features & IORING_FEAT_SINGLE_MMAP))
+    return false;
+
+  m_ring_size = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                         params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  m_ring = mmap(NULL, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+  if (m_ring == MAP_FAILED)
+    return false;
+
+  m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED)
+    return false;
+  m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+  char *ring = static_cast<char*>(m_ring);
+
+  m_sq_head    = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+  m_sq_tail    = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+  m_sq_mask    = reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+  m_sq_entries = reinterpret_cast<unsigned*>(ring + params.sq_off.ring_entries);
+  m_sq_array   = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+
+  m_cq_head = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+  m_cq_tail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+  m_cq_mask = reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+  m_cqes    = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+
+  return true;
+}
+
+
+bool Uring::probe()
+{
+  Uring ring;
+
+  if (!ring.open(2))
+    return false;
+
+  const uint32_t features = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+
+  if ((ring.m_features & features) != features)
+    return false;
+
+  const unsigned ops_count = 256;
+  std::vector<char> buffer(sizeof(io_uring_probe) + ops_count * sizeof(io_uring_probe_op));
+  io_uring_probe *probe = reinterpret_cast<io_uring_probe*>(&buffer[0]);
+
+  if (syscall(__NR_io_uring_register, ring.m_fd, IORING_REGISTER_PROBE, probe, ops_count) < 0)
+    return false;
+
+  const int ops[] = { IORING_OP_CONNECT, IORING_OP_WRITE_FIXED, IORING_OP_WRITE,
+                      IORING_OP_RECV, IORING_OP_ASYNC_CANCEL };
+
+  for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); ++i)
+  {
+    if (ops[i] > probe->last_op || !(probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED))
+      return false;
+  }
+
+  return true;
+}
+
+
+bool Uring::is_supported()
+{
+  static const bool supported = probe();
+
+  return supported;
+}
+
+
+bool Uring::register_buffer(void *data, const uint32_t length)
+{
+  iovec buffer;
+
+  buffer.iov_base = data;
+  buffer.iov_len = length;
+
+  return syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, &buffer, 1) == 0;
+}
+
+
+io_uring_sqe *Uring::prepare(const On_complete &on_complete, uint64_t *id)
+{
+  // A full queue goes to the kernel to make room
+  if (*m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) == *m_sq_entries)
+    enter(0, 0);
+
+  const unsigned tail = *m_sq_tail;
+  const unsigned index = tail & *m_sq_mask;
+  io_uring_sqe *sqe = &m_sqes[index];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->user_data = ++m_next_id;
+  m_callbacks[m_next_id] = on_complete;
+  if (id)
+    *id = m_next_id;
+
+  // The kernel reads the entries only from enter(), on this same thread,
+  // so the caller fills this one in time
+  m_sq_array[index] = index;
+  __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  return sqe;
+}
+
+
+int Uring::enter(const unsigned min_complete, const int timeout_ms)
+{
+  __kernel_timespec timeout;
+  io_uring_getevents_arg arg;
+
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+  memset(&arg, 0, sizeof(arg));
+  arg.ts = reinterpret_cast<uint64_t>(&timeout);
+
+  const unsigned flags = IORING_ENTER_EXT_ARG | (min_complete ? IORING_ENTER_GETEVENTS : 0);
+
+  for (;;)
+  {
+    const unsigned to_submit = *m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+    const long result = syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, flags, &arg, sizeof(arg));
+    const int error = result < 0 ? errno : 0;
+
+    reap();
+
+    switch (error)
+    {
+    case 0:
+    case ETIME:
+      return 0;
+
+    case EINTR:
+      break;
+
+    // Completions the kernel could not post yet, they fit once reaped
+    case EBUSY:
+    case EAGAIN:
+      if (!min_complete)
+        return 0;
+      break;
+
+    default:
+      return -error;
+    }
+  }
+}
+
+
+void Uring::reap()
+{
+  // The head is read again on every entry since the callbacks may prepare
+  // new operations, which reaps from a nested enter() on a full queue
+  for (;;)
+  {
+    const unsigned head = *m_cq_head;
+
+    if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+      break;
+
+    const io_uring_cqe &cqe = m_cqes[head & *m_cq_mask];
+    const uint64_t id = cqe.user_data;
+    const int result = cqe.res;
+
+    __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+
+    std::map<uint64_t, On_complete>::iterator callback = m_callbacks.find(id);
+
+    if (callback == m_callbacks.end())
+      continue;
+
+    On_complete on_complete;
+
+    on_complete.swap(callback->second);
+    m_callbacks.erase(callback);
+
+    if (on_complete)
+      on_complete(result);
+  }
+}
+
+} // namespace ngs
+
+#endif // defined(HAVE_IO_URING)
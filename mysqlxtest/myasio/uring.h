@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+
+#ifndef _NGS_ASIO_URING_H_
+#define _NGS_ASIO_URING_H_
+
+#if defined(HAVE_IO_URING)
+
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <map>
+
+#include <boost/core/noncopyable.hpp>
+#include <boost/function.hpp>
+
+
+namespace ngs
+{
+
+// An io_uring instance driven with the raw system calls. Operations are
+// prepared as submission entries, each with the callback that gets its
+// result, and all the prepared ones go to the kernel with the next enter(),
+// which also runs the callbacks of the completed ones.
+class Uring : private boost::noncopyable
+{
+public:
+  typedef boost::function<void (int result)> On_complete;
+
+  Uring();
+  ~Uring();
+
+  // Creates the ring, false when the kernel does not provide one
+  bool open(const unsigned entries);
+
+  // Whether the kernel supports the ring and the operations of
+  // Connection_uring, checked once per process
+  static bool is_supported();
+
+  // Registers the memory as the fixed buffer 0 of IORING_OP_WRITE_FIXED
+  bool register_buffer(void *data, const uint32_t length);
+
+  // An empty entry for the caller to fill, its id is the user_data to
+  // cancel it with
+  io_uring_sqe *prepare(const On_complete &on_complete, uint64_t *id = NULL);
+
+  // Submits the prepared entries and waits up to timeout_ms for at least
+  // min_complete completions, running the callbacks of all the completed
+  // ones. Returns 0 also when the time runs out, -errno on errors of the ring.
+  int enter(const unsigned min_complete, const int timeout_ms);
+
+private:
+  static bool probe();
+  void reap();
+
+  int      m_fd;
+  uint32_t m_features;
+
+  void    *m_ring;
+  size_t   m_ring_size;
+  io_uring_sqe *m_sqes;
+  size_t   m_sqes_size;
+
+  unsigned *m_sq_head;
+  unsigned *m_sq_tail;
+  unsigned *m_sq_mask;
+  unsigned *m_sq_entries;
+  unsigned *m_sq_array;
+
+  unsigned *m_cq_head;
+  unsigned *m_cq_tail;
+  unsigned *m_cq_mask;
+  io_uring_cqe *m_cqes;
+
+  uint64_t m_next_id;
+  std::map<uint64_t, On_complete> m_callbacks;
+};
+
+} // namespace ngs
+
+#endif // defined(HAVE_IO_URING)
+
+#endif // _NGS_ASIO_URING_H_
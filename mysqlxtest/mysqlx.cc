@@ -32,6 +32,7 @@
 #include "mysqlx.h"
 #include "mysqlx_connection.h"
 #include "mysqlx_crud.h"
+#include "expr_cache.h"
 #include "mysqlx_row.h"
 #include "xpl_error.h"
 
@@ -79,10 +80,18 @@ namespace mysqlx {
 #ifndef WIN32
 #include <netdb.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
 #endif
 #include <string>
 #include <iostream>
 #include <limits>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
 #include "compilerutils.h"
 #include "ngs_common/xdecimal.h"
 
@@ -172,12 +181,25 @@ Error::~Error()
 {
 }
 
+// Ends the statements killed while their results were being discarded
+static const int ER_QUERY_INTERRUPTED = 1317;
+
+// Replies the messages the server does not know
+static const int ER_UNKNOWN_COM_ERROR = 1047;
+
 static void throw_server_error(const Mysqlx::Error &error)
 {
   throw Error(error.code(), error.msg());
 }
 
+static void build_stmt(Mysqlx::Sql::StmtExecute &exec, const std::string &ns, const std::string &sql, const std::vector<ArgumentValue> &args);
+
+// Condition of Mysqlx.Expect.Open failing the rest of the block once a
+// message got an error
+static const uint32_t EXPECT_NO_ERROR = 1;
+
 Session::Session(const mysqlx::Ssl_config &ssl_config, const std::size_t timeout)
+  : m_expr_cache(new Expr_cache())
 {
   m_connection.reset(new Connection(ssl_config, timeout));
 }
@@ -202,13 +224,24 @@ std::shared_ptr<Session> mysqlx::openSession(const std::string &host, int port,
                                              const mysqlx::Ssl_config &ssl_config, const bool cap_expired_password,
                                              const std::size_t timeout,
                                              const std::string &auth_method,
-                                             const bool get_caps)
+                                             const bool get_caps,
+                                             const mysqlx::Compression_config *compression,
+                                             const std::string &local_socket,
+                                             const Mysqlx::Connection::Capabilities *capabilities)
 {
   const std::string my_auth_method = auth_method.empty() ? "MYSQL41" : auth_method;
   std::shared_ptr<Session> session(new Session(ssl_config, timeout));
+  session->connection()->set_local_socket(local_socket);
   session->connection()->connect(host, port, cap_expired_password);
 
-  if (get_caps)
+  if (compression)
+    session->connection()->set_compression(*compression);
+
+  // The capabilities known from an earlier connection to the server save
+  // asking for them
+  if (capabilities)
+    session->connection()->set_capabilities(*capabilities);
+  else if (get_caps)
     session->connection()->fetch_capabilities();
   session->connection()->authenticate(user, pass, schema, ssl_config.mode, my_auth_method);  
   return session;
@@ -220,8 +253,14 @@ Connection::Connection(const Ssl_config &ssl_config, const std::size_t timeout,
                     ssl_config.tls_version, ssl_config.mode, timeout),
     m_account_expired(false),
     m_deadline(m_ios), m_client_id(0),
-    m_trace_packets(false), m_closed(true),
-    m_dont_wait_for_disconnect(dont_wait_for_disconnect)
+    m_trace_packets(false), m_trace_file(Protocol_trace::current()), m_closed(true),
+    m_dont_wait_for_disconnect(dont_wait_for_disconnect),
+    m_connect_timeout(timeout),
+    m_async_sent(0), m_async_read(0),
+    m_recv_begin(0), m_recv_end(0),
+    m_row_pool(new Row_pool()),
+    m_statements_ended(0), m_result_prefetch(0), m_cursors_supported(true), m_last_cursor_id(0),
+    m_inflated_begin(0), m_inflated_end(0)
 {
   if (getenv("MYSQLX_TRACE_CONNECTION"))
     m_trace_packets = true;
@@ -274,30 +313,269 @@ void Connection::connect(const std::string &uri, const std::string &pass, const
   authenticate(user, pass.empty() ? password : pass, schema);
 }
 
+namespace
+{
+  // Delay between the start of two connection attempts, from RFC 8305
+  const long k_connection_attempt_delay = 250;
+
+  typedef std::vector<std::pair<std::string, std::string> > Host_list;
+
+  // Splits a list of host[:port] entries, IPv6 addresses with a port come
+  // in brackets: [::1]:33060
+  Host_list split_host_list(const std::string &hosts, const std::string &default_port)
+  {
+    Host_list ret_val;
+    std::string::size_type start = 0;
+
+    while (start <= hosts.size())
+    {
+      std::string::size_type end = hosts.find(',', start);
+      if (end == std::string::npos)
+        end = hosts.size();
+
+      std::string host = hosts.substr(start, end - start);
+      std::string port = default_port;
+
+      if (!host.empty() && host[0] == '[')
+      {
+        std::string::size_type closing = host.find(']');
+        if (closing != std::string::npos)
+        {
+          if (closing + 1 < host.size() && host[closing + 1] == ':')
+            port = host.substr(closing + 2);
+          host = host.substr(1, closing - 1);
+        }
+      }
+      else if (std::count(host.begin(), host.end(), ':') == 1)
+      {
+        std::string::size_type colon = host.find(':');
+        port = host.substr(colon + 1);
+        host = host.substr(0, colon);
+      }
+
+      if (!host.empty())
+        ret_val.push_back(std::make_pair(host, port));
+
+      start = end + 1;
+    }
+
+    return ret_val;
+  }
+
+  // Races the connection to the endpoints: an attempt is started every
+  // k_connection_attempt_delay ms, or as soon as the last one fails, and the
+  // first one established wins, the others are cancelled
+  class Connect_race
+  {
+  public:
+    Connect_race(boost::asio::io_service &ios, const std::vector<boost::asio::ip::tcp::endpoint> &endpoints)
+    : m_ios(ios), m_endpoints(endpoints), m_delay(ios), m_deadline(ios),
+      m_next(0), m_pending(0), m_done(false), m_error(boost::asio::error::host_unreachable)
+    {
+    }
+
+    // Returns the endpoint that accepted the connection first
+    bool run(const std::size_t timeout, boost::asio::ip::tcp::endpoint &winner, boost::system::error_code &error)
+    {
+      if (timeout)
+      {
+        m_deadline.expires_from_now(boost::posix_time::milliseconds(timeout));
+        m_deadline.async_wait(boost::bind(&Connect_race::on_timeout, this, boost::asio::placeholders::error));
+      }
+
+      start_next();
+
+      m_ios.reset();
+      m_ios.run();
+
+      winner = m_winner;
+      error = m_error;
+      return !m_error;
+    }
+
+  private:
+    void start_next()
+    {
+      if (m_done || m_next == m_endpoints.size())
+        return;
+
+      std::size_t index = m_next++;
+      m_sockets.push_back(boost::shared_ptr<boost::asio::ip::tcp::socket>(new boost::asio::ip::tcp::socket(m_ios)));
+      m_sockets.back()->async_connect(m_endpoints[index],
+                                      boost::bind(&Connect_race::on_connect, this, index, boost::asio::placeholders::error));
+      m_pending++;
+
+      if (m_next < m_endpoints.size())
+      {
+        m_delay.expires_from_now(boost::posix_time::milliseconds(k_connection_attempt_delay));
+        m_delay.async_wait(boost::bind(&Connect_race::on_delay, this, boost::asio::placeholders::error));
+      }
+    }
+
+    void on_delay(const boost::system::error_code &error)
+    {
+      if (!error)
+        start_next();
+    }
+
+    void on_connect(std::size_t index, const boost::system::error_code &error)
+    {
+      m_pending--;
+
+      if (m_done)
+        return;
+
+      if (!error)
+      {
+        m_winner = m_endpoints[index];
+        m_error = error;
+        finish();
+      }
+      else
+      {
+        m_error = error;
+
+        if (m_next < m_endpoints.size())
+        {
+          m_delay.cancel();
+          start_next();
+        }
+        else if (m_pending == 0)
+          finish();
+      }
+    }
+
+    void on_timeout(const boost::system::error_code &error)
+    {
+      if (error || m_done)
+        return;
+
+      m_error = boost::asio::error::timed_out;
+      finish();
+    }
+
+    void finish()
+    {
+      boost::system::error_code ignored;
+
+      m_done = true;
+      m_delay.cancel(ignored);
+      m_deadline.cancel(ignored);
+
+      for (std::size_t index = 0; index < m_sockets.size(); index++)
+        m_sockets[index]->close(ignored);
+    }
+
+    boost::asio::io_service &m_ios;
+    std::vector<boost::asio::ip::tcp::endpoint> m_endpoints;
+    std::vector<boost::shared_ptr<boost::asio::ip::tcp::socket> > m_sockets;
+    boost::asio::deadline_timer m_delay;
+    boost::asio::deadline_timer m_deadline;
+    std::size_t m_next;
+    std::size_t m_pending;
+    bool m_done;
+    boost::asio::ip::tcp::endpoint m_winner;
+    boost::system::error_code m_error;
+  };
+
+  void on_resolve(const boost::system::error_code &error, boost::asio::ip::tcp::resolver::iterator iterator,
+                  boost::system::error_code &out_error, std::vector<boost::asio::ip::tcp::endpoint> &out_endpoints)
+  {
+    out_error = error;
+
+    for (boost::asio::ip::tcp::resolver::iterator end; !error && iterator != end; ++iterator)
+      out_endpoints.push_back(*iterator);
+  }
+}
+
+std::vector<boost::asio::ip::tcp::endpoint> Connection::resolve_hosts(const std::string &hosts, int port)
+{
+  char ports[8];
+  snprintf(ports, sizeof(ports), "%i", port);
+
+  Host_list list = split_host_list(hosts, ports);
+  if (list.empty())
+    throw Error(CR_UNKNOWN_HOST, "No host given to connect to");
+
+  // The names are resolved concurrently
+  std::vector<boost::shared_ptr<tcp::resolver> > resolvers;
+  std::vector<boost::system::error_code> errors(list.size());
+  std::vector<std::vector<tcp::endpoint> > resolved(list.size());
+
+  for (std::size_t index = 0; index < list.size(); index++)
+  {
+    resolvers.push_back(boost::shared_ptr<tcp::resolver>(new tcp::resolver(m_ios)));
+    resolvers.back()->async_resolve(tcp::resolver::query(list[index].first, list[index].second),
+                                    boost::bind(&on_resolve, boost::asio::placeholders::error, boost::asio::placeholders::iterator,
+                                                boost::ref(errors[index]), boost::ref(resolved[index])));
+  }
+
+  m_ios.reset();
+  m_ios.run();
+
+  // The hosts are tried in the given order, the addresses of each one
+  // alternating the IPv6 and IPv4 families
+  std::vector<tcp::endpoint> endpoints;
+  for (std::size_t index = 0; index < list.size(); index++)
+  {
+    std::vector<tcp::endpoint> v6, v4;
+    for (std::size_t e = 0; e < resolved[index].size(); e++)
+      (resolved[index][e].address().is_v6() ? v6 : v4).push_back(resolved[index][e]);
+
+    bool v6_first = !resolved[index].empty() && resolved[index].front().address().is_v6();
+    std::vector<tcp::endpoint> &first = v6_first ? v6 : v4;
+    std::vector<tcp::endpoint> &second = v6_first ? v4 : v6;
+    for (std::size_t e = 0; e < first.size() || e < second.size(); e++)
+    {
+      if (e < first.size())
+        endpoints.push_back(first[e]);
+      if (e < second.size())
+        endpoints.push_back(second[e]);
+    }
+  }
+
+  if (endpoints.empty())
+    throw Error(CR_UNKNOWN_HOST, errors.front().message());
+
+  return endpoints;
+}
+
 void Connection::connect(const std::string &host, int port, const bool cap_expired_password)
 {
-  tcp::resolver resolver(m_ios);
   char ports[8];
   snprintf(ports, sizeof(ports), "%i", port);
-  tcp::resolver::query query(host, ports);
 
   boost::system::error_code error;
-  tcp::resolver::iterator endpoint_iterator = resolver.resolve(query, error);
-  tcp::resolver::iterator end;
 
-  if (error)
-    throw Error(CR_UNKNOWN_HOST, error.message());
+  if (!m_local_socket.empty())
+  {
+    m_sync_connection.close();
+    error = m_sync_connection.connect_local(m_local_socket);
 
-  error = boost::asio::error::fault;
+    if (error)
+      m_local_socket.clear();
+  }
 
-  while (error && endpoint_iterator != end)
+  if (m_local_socket.empty())
   {
+    std::vector<tcp::endpoint> endpoints = resolve_hosts(host, port);
+    tcp::endpoint target = endpoints.front();
+
+    // The race only finds the endpoint to use, the session is then opened
+    // on it through the TLS capable connection
+    if (endpoints.size() > 1)
+    {
+      Connect_race race(m_ios, endpoints);
+      if (!race.run(m_connect_timeout, target, error))
+        throw Error(CR_CONNECTION_ERROR, error.message() + " connecting to " + host + ":" + ports);
+    }
+
     m_sync_connection.close();
-    error = m_sync_connection.connect(*endpoint_iterator++);
-  }
+    error = m_sync_connection.connect(target);
 
-  if (error)
-    throw Error(CR_CONNECTION_ERROR, error.message() + " connecting to " + host + ":" + ports);
+    if (error)
+      throw Error(CR_CONNECTION_ERROR, error.message() + " connecting to " + host + ":" + ports);
+  }
 
   if (cap_expired_password) {
     try {
@@ -335,6 +613,11 @@ void Connection::authenticate(const std::string &user, const std::string &pass,
     enable_tls();
     }
   }
+
+  // The server starts compressing once the session is authenticated
+  if (!m_compression_config.algorithm.empty())
+    negotiate_compression();
+
   if (auth_method == "PLAIN")
     authenticate_plain(user, pass, schema);
   else
@@ -351,6 +634,85 @@ void Connection::fetch_capabilities()
   m_capabilities = *static_cast<Mysqlx::Connection::Capabilities*>(message.get());
 }
 
+void Connection::negotiate_compression()
+{
+  if (m_capabilities.capabilities_size() == 0)
+    fetch_capabilities();
+
+  // The algorithms offered by the server come in the compression capability
+  std::set<std::string> server_algorithms;
+  for (int c = 0; c < m_capabilities.capabilities_size(); c++)
+  {
+    const Mysqlx::Connection::Capability &cap = m_capabilities.capabilities(c);
+    if (cap.name() != "compression" || !cap.value().has_obj())
+      continue;
+
+    const Mysqlx::Datatypes::Object &obj = cap.value().obj();
+    for (int f = 0; f < obj.fld_size(); f++)
+    {
+      if (obj.fld(f).key() != "algorithm" || !obj.fld(f).value().has_array())
+        continue;
+
+      const Mysqlx::Datatypes::Array &array = obj.fld(f).value().array();
+      for (int v = 0; v < array.value_size(); v++)
+      {
+        if (array.value(v).has_scalar() && array.value(v).scalar().has_v_string())
+          server_algorithms.insert(array.value(v).scalar().v_string().value());
+      }
+    }
+  }
+
+  if (server_algorithms.empty())
+    throw Error(CR_UNKNOWN_ERROR, "The server does not support X protocol compression");
+
+  std::string algorithm;
+  std::vector<std::string> client_algorithms(Decompressor::algorithms());
+  if (m_compression_config.algorithm == "auto")
+  {
+    for (std::vector<std::string>::const_iterator a = client_algorithms.begin(); a != client_algorithms.end() && algorithm.empty(); ++a)
+    {
+      if (server_algorithms.count(*a))
+        algorithm = *a;
+    }
+
+    if (algorithm.empty())
+      throw Error(CR_UNKNOWN_ERROR, "None of the compression algorithms of the server is supported");
+  }
+  else
+  {
+    algorithm = m_compression_config.algorithm;
+
+    if (std::find(client_algorithms.begin(), client_algorithms.end(), algorithm) == client_algorithms.end())
+      throw Error(CR_UNKNOWN_ERROR, "Compression algorithm '" + algorithm + "' is not supported");
+    if (!server_algorithms.count(algorithm))
+      throw Error(CR_UNKNOWN_ERROR, "Compression algorithm '" + algorithm + "' is not supported by the server");
+  }
+
+  Mysqlx::Datatypes::Any value;
+  value.set_type(Mysqlx::Datatypes::Any_Type_OBJECT);
+
+  Mysqlx::Datatypes::Object_ObjectField *fld = value.mutable_obj()->add_fld();
+  fld->set_key("algorithm");
+  fld->mutable_value()->set_type(Mysqlx::Datatypes::Any_Type_SCALAR);
+  fld->mutable_value()->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar_Type_V_STRING);
+  fld->mutable_value()->mutable_scalar()->mutable_v_string()->set_value(algorithm);
+
+  if (m_compression_config.level >= 0)
+  {
+    fld = value.mutable_obj()->add_fld();
+    fld->set_key("level");
+    fld->mutable_value()->set_type(Mysqlx::Datatypes::Any_Type_SCALAR);
+    fld->mutable_value()->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar_Type_V_SINT);
+    fld->mutable_value()->mutable_scalar()->set_v_signed_int(m_compression_config.level);
+  }
+
+  int error;
+  std::string msg;
+  setup_capability("compression", value, error, msg, true);
+
+  m_decompressor.reset(Decompressor::create(algorithm));
+}
+
 void Connection::enable_tls()
 {
   boost::system::error_code ec = m_sync_connection.activate_tls();
@@ -377,6 +739,9 @@ void Connection::close()
 {
   if (!m_closed)
   {
+    pause_read_ahead();
+    read_async_results(m_async_sent);
+
     if (m_last_result)
       m_last_result->buffer();
 
@@ -400,6 +765,46 @@ void Connection::close()
   }
 }
 
+void Connection::reset_session(const std::string &user, const std::string &pass, const std::string &schema,
+                               const std::string &auth_method)
+{
+  pause_read_ahead();
+  read_async_results(m_async_sent);
+
+  if (m_last_result)
+    m_last_result->buffer();
+
+  send(Mysqlx::Session::Reset());
+
+  bool done = false;
+  while (!done)
+  {
+    int mid;
+    boost::scoped_ptr<Message> message(recv_raw(mid));
+    switch (mid)
+    {
+      case Mysqlx::ServerMessages::OK:
+        done = true;
+        break;
+
+      case Mysqlx::ServerMessages::NOTICE:
+        dispatch_notice(static_cast<Mysqlx::Notice::Frame*>(message.get()));
+        break;
+
+      case Mysqlx::ServerMessages::ERROR:
+        throw_server_error(*static_cast<Mysqlx::Error*>(message.get()));
+
+      default:
+        throw Error(CR_COMMANDS_OUT_OF_SYNC, "Unexpected message received in response to Session.Reset");
+    }
+  }
+
+  if (auth_method == "PLAIN")
+    authenticate_plain(user, pass, schema);
+  else
+    authenticate_mysql41(user, pass, schema);
+}
+
 void Connection::perform_close()
 {
   if (m_dont_wait_for_disconnect)
@@ -417,119 +822,483 @@ void Connection::perform_close()
   throw Error(CR_COMMANDS_OUT_OF_SYNC, s.str());
 }
 
-std::shared_ptr<Result> Connection::recv_result()
+std::shared_ptr<Result> Connection::recv_result(bool expect_data)
 {
-  return new_result(true);
+  return new_result(expect_data);
+}
+
+void Connection::send_sql(const std::string &sql)
+{
+  Mysqlx::Sql::StmtExecute exec;
+  exec.set_namespace_("sql");
+  exec.set_stmt(sql);
+  send(exec);
 }
 
 std::shared_ptr<Result> Connection::execute_sql(const std::string &sql)
 {
-  {
-    Mysqlx::Sql::StmtExecute exec;
-    exec.set_namespace_("sql");
-    exec.set_stmt(sql);
-    send(exec);
-  }
+  if (m_result_cache)
+    return execute_stmt("sql", sql, std::vector<ArgumentValue>());
+
+  send_sql(sql);
 
   return new_result(true);
 }
 
 std::shared_ptr<Result> Connection::execute_stmt(const std::string &ns, const std::string &sql, const std::vector<ArgumentValue> &args)
 {
+  if (m_result_cache)
   {
     Mysqlx::Sql::StmtExecute exec;
-    exec.set_namespace_(ns);
-    exec.set_stmt(sql);
-
-    for (std::vector<ArgumentValue>::const_iterator iter = args.begin();
-         iter != args.end(); ++iter)
-    {
-      Mysqlx::Datatypes::Any *any = exec.mutable_args()->Add();
+    build_stmt(exec, ns, sql, args);
 
-      any->set_type(Mysqlx::Datatypes::Any::SCALAR);
-      switch (iter->type())
-      {
-        case ArgumentValue::TInteger:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_SINT);
-          any->mutable_scalar()->set_v_signed_int(*iter);
-          break;
-        case ArgumentValue::TUInteger:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_UINT);
-          any->mutable_scalar()->set_v_unsigned_int(*iter);
-          break;
-        case ArgumentValue::TNull:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_NULL);
-          break;
-        case ArgumentValue::TDouble:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_DOUBLE);
-          any->mutable_scalar()->set_v_double(*iter);
-          break;
-        case ArgumentValue::TFloat:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_FLOAT);
-          any->mutable_scalar()->set_v_float(*iter);
-          break;
-        case ArgumentValue::TBool:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_BOOL);
-          any->mutable_scalar()->set_v_bool(*iter);
-          break;
-        case ArgumentValue::TString:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_STRING);
-          any->mutable_scalar()->mutable_v_string()->set_value(*iter);
-          break;
-        case ArgumentValue::TOctets:
-          any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_OCTETS);
-          any->mutable_scalar()->mutable_v_octets()->set_value(*iter);
-          break;
-      }
-    }
-    send(exec);
+    std::string payload;
+    exec.SerializeToString(&payload);
+    return execute_serialized(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, payload, true);
   }
 
-  return new_result(true);
+  send_stmt_async(ns, sql, args);
+
+  return recv_async_result(m_async_sent);
 }
 
-std::shared_ptr<Result> Connection::execute_find(const Mysqlx::Crud::Find &m)
+static void build_stmt(Mysqlx::Sql::StmtExecute &exec, const std::string &ns, const std::string &sql, const std::vector<ArgumentValue> &args)
 {
-  send(m);
+  exec.set_namespace_(ns);
+  exec.set_stmt(sql);
 
-  return new_result(true);
+  for (std::vector<ArgumentValue>::const_iterator iter = args.begin();
+       iter != args.end(); ++iter)
+  {
+    Mysqlx::Datatypes::Any *any = exec.mutable_args()->Add();
+
+    any->set_type(Mysqlx::Datatypes::Any::SCALAR);
+    switch (iter->type())
+    {
+      case ArgumentValue::TInteger:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_SINT);
+        any->mutable_scalar()->set_v_signed_int(*iter);
+        break;
+      case ArgumentValue::TUInteger:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_UINT);
+        any->mutable_scalar()->set_v_unsigned_int(*iter);
+        break;
+      case ArgumentValue::TNull:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_NULL);
+        break;
+      case ArgumentValue::TDouble:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_DOUBLE);
+        any->mutable_scalar()->set_v_double(*iter);
+        break;
+      case ArgumentValue::TFloat:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_FLOAT);
+        any->mutable_scalar()->set_v_float(*iter);
+        break;
+      case ArgumentValue::TBool:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_BOOL);
+        any->mutable_scalar()->set_v_bool(*iter);
+        break;
+      case ArgumentValue::TString:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_STRING);
+        any->mutable_scalar()->mutable_v_string()->set_value(*iter);
+        break;
+      case ArgumentValue::TOctets:
+        any->mutable_scalar()->set_type(Mysqlx::Datatypes::Scalar::V_OCTETS);
+        any->mutable_scalar()->mutable_v_octets()->set_value(*iter);
+        break;
+    }
+  }
 }
 
-std::shared_ptr<Result> Connection::execute_update(const Mysqlx::Crud::Update &m)
+uint64_t Connection::send_stmt_async(const std::string &ns, const std::string &sql, const std::vector<ArgumentValue> &args)
 {
-  send(m);
+  {
+    Mysqlx::Sql::StmtExecute exec;
+    build_stmt(exec, ns, sql, args);
+    send(exec);
+  }
 
-  return new_result(false);
+  // The statement goes out right away so the server runs it while the
+  // caller does something else
+  flush();
+
+  return ++m_async_sent;
 }
 
-std::shared_ptr<Result> Connection::execute_insert(const Mysqlx::Crud::Insert &m)
+std::shared_ptr<Result> Connection::recv_async_result(uint64_t ticket)
 {
-  send(m);
+  if (ticket > m_async_sent)
+    throw std::logic_error("Unknown asynchronous result");
 
-  return new_result(false);
+  pause_read_ahead();
+
+  // The results of the statements sent before are buffered
+  read_async_results(ticket - 1);
+
+  if (ticket == m_async_read + 1)
+  {
+    m_async_read++;
+
+    return create_result(true);
+  }
+
+  std::map<uint64_t, Async_result>::iterator entry = m_async_results.find(ticket);
+  if (entry == m_async_results.end())
+    throw std::logic_error("The asynchronous result was already retrieved");
+
+  Async_result async_result = entry->second;
+  m_async_results.erase(entry);
+
+  if (async_result.error)
+    throw *async_result.error;
+
+  return async_result.result;
 }
 
-std::shared_ptr<Result> Connection::execute_delete(const Mysqlx::Crud::Delete &m)
+void Connection::discard_async_result(uint64_t ticket)
 {
-  send(m);
-
-  return new_result(false);
+  if (ticket <= m_async_read)
+    m_async_results.erase(ticket);
+  else if (ticket <= m_async_sent)
+    m_discarded_results.insert(ticket);
 }
 
-void Connection::setup_capability(const std::string &name, const bool value, int& out_error, std::string &out_error_msg, bool should_throw /*= false*/)
+void Connection::read_async_results(uint64_t last_ticket)
 {
-  Mysqlx::Connection::CapabilitiesSet capSet;
-  Mysqlx::Connection::Capability     *cap = capSet.mutable_capabilities()->add_capabilities();
-  ::Mysqlx::Datatypes::Scalar        *scalar = cap->mutable_value()->mutable_scalar();
+  while (m_async_read < last_ticket && m_async_read < m_async_sent)
+  {
+    uint64_t ticket = ++m_async_read;
+    std::shared_ptr<Result> result(create_result(true));
+    bool discarded = m_discarded_results.erase(ticket) > 0;
 
-  cap->set_name(name);
-  cap->mutable_value()->set_type(Mysqlx::Datatypes::Any_Type_SCALAR);
-  scalar->set_type(Mysqlx::Datatypes::Scalar_Type_V_BOOL);
-  scalar->set_v_bool(value);
-  send(capSet);
+    try
+    {
+      result->buffer();
 
-  if (m_last_result)
-    m_last_result->buffer();
+      if (!discarded)
+        m_async_results[ticket].result = result;
+    }
+    catch (Error &e)
+    {
+      // Client errors (the CR_ range) leave the connection unusable, server
+      // errors belong to the statement that got them
+      if (e.error() >= 2000 && e.error() < 3000)
+        throw;
+
+      if (!discarded)
+        m_async_results[ticket].error.reset(new Error(e));
+    }
+  }
+}
+
+std::shared_ptr<Result> Connection::execute_serialized(int mid, const std::string &payload, bool expect_data)
+{
+  std::string schema;
+  if (m_result_cache && Result_cache::cacheable(mid, payload, &schema))
+    return execute_cached(mid, payload, schema);
+
+  send(mid, payload);
+
+  return new_result(expect_data);
+}
+
+std::shared_ptr<Result> Connection::execute_cached(int mid, const std::string &payload, const std::string &schema)
+{
+  std::shared_ptr<Result> result(m_result_cache->find(mid, payload));
+  if (result)
+    return result;
+
+  send(mid, payload);
+  result = new_result(true);
+  result->buffer();
+  m_result_cache->store(mid, payload, schema, result);
+
+  return result;
+}
+
+void Connection::set_result_cache(const Result_cache_config &config)
+{
+  if (config.ttl)
+    m_result_cache.reset(new Result_cache(config));
+  else
+    m_result_cache.reset();
+}
+
+Result_cache_stats Connection::result_cache_stats() const
+{
+  return m_result_cache ? m_result_cache->stats() : Result_cache_stats();
+}
+
+std::vector<std::shared_ptr<Result> > Connection::execute_batch(const std::vector<std::pair<int, std::string> > &statements, bool atomic)
+{
+  // The replies read next must be the ones of the batch
+  pause_read_ahead();
+  read_async_results(m_async_sent);
+  end_last_result();
+
+  if (atomic)
+  {
+    Mysqlx::Expect::Open open;
+    open.set_op(Mysqlx::Expect::Open::EXPECT_CTX_EMPTY);
+    open.add_cond()->set_condition_key(EXPECT_NO_ERROR);
+    send(Mysqlx::ClientMessages::EXPECT_OPEN, open);
+    send_sql("START TRANSACTION");
+  }
+
+  for (std::vector<std::pair<int, std::string> >::const_iterator statement = statements.begin();
+       statement != statements.end(); ++statement)
+    send(statement->first, statement->second);
+
+  if (atomic)
+  {
+    send_sql("COMMIT");
+    send(Mysqlx::ClientMessages::EXPECT_CLOSE, Mysqlx::Expect::Close());
+  }
+
+  flush();
+
+  // Every reply is read even after an error, so the connection is left in
+  // sync, the error kept is the one of the first statement failing
+  std::shared_ptr<Error> error;
+  std::size_t failed = 0;
+
+  auto read_expect_ok = [&]()
+  {
+    int mid;
+    boost::scoped_ptr<Message> reply(recv_next(mid));
+    if (mid == Mysqlx::ServerMessages::ERROR)
+    {
+      if (!error)
+      {
+        const Mysqlx::Error &server_error = static_cast<const Mysqlx::Error&>(*reply);
+        error.reset(new Error(server_error.code(), server_error.msg()));
+      }
+    }
+    else if (mid != Mysqlx::ServerMessages::OK)
+      throw Error(CR_COMMANDS_OUT_OF_SYNC, "Unexpected message received from server reading results");
+  };
+
+  auto read_result = [&](std::size_t index) -> std::shared_ptr<Result>
+  {
+    std::shared_ptr<Result> result(create_result(true));
+    try
+    {
+      result->buffer();
+    }
+    catch (Error &e)
+    {
+      // Client errors leave the connection unusable
+      if (e.error() >= 2000 && e.error() < 3000)
+        throw;
+
+      if (!error)
+      {
+        error.reset(new Error(e));
+        failed = index;
+      }
+      result.reset();
+    }
+    return result;
+  };
+
+  std::vector<std::shared_ptr<Result> > results;
+  if (atomic)
+  {
+    read_expect_ok();
+    read_result(0);
+  }
+
+  for (std::size_t index = 1; index <= statements.size(); index++)
+    results.push_back(read_result(index));
+
+  if (atomic)
+  {
+    read_result(statements.size() + 1);
+    read_expect_ok();
+
+    // The statements done before the failure are undone
+    if (error)
+      execute_sql("ROLLBACK")->flush();
+  }
+
+  if (error)
+  {
+    if (failed >= 1 && failed <= statements.size())
+    {
+      std::stringstream message;
+      message << "Statement " << failed << " of the batch failed: " << error->what();
+      throw Error(error->error(), message.str());
+    }
+    throw *error;
+  }
+
+  return results;
+}
+
+std::shared_ptr<Result> Connection::execute_find(const Mysqlx::Crud::Find &m)
+{
+  send(m);
+
+  return new_result(true);
+}
+
+std::shared_ptr<Result> Connection::execute_cursor(const std::string &payload, uint64_t fetch_rows)
+{
+  if (!m_cursors_supported)
+    return execute_serialized(Mysqlx::ClientMessages::CRUD_FIND, payload, true);
+
+  uint32_t id = ++m_last_cursor_id;
+
+  Mysqlx::Prepare::Prepare prepare;
+  prepare.set_stmt_id(id);
+  prepare.mutable_stmt()->set_type(Mysqlx::Prepare::Prepare::OneOfMessage::FIND);
+  Mysqlx::Crud::Find *find = prepare.mutable_stmt()->mutable_find();
+  if (!find->ParseFromString(payload))
+    throw std::logic_error("Invalid find message");
+
+  Mysqlx::Cursor::Open open;
+  open.set_cursor_id(id);
+  open.set_fetch_rows(fetch_rows);
+  open.mutable_stmt()->set_type(Mysqlx::Cursor::Open::OneOfMessage::PREPARE_EXECUTE);
+  Mysqlx::Prepare::Execute *execute = open.mutable_stmt()->mutable_prepare_execute();
+  execute->set_stmt_id(id);
+
+  // The bound values go with the execution of the prepared find
+  for (int index = 0; index < find->args_size(); index++)
+  {
+    Mysqlx::Datatypes::Any *arg = execute->add_args();
+    arg->set_type(Mysqlx::Datatypes::Any::SCALAR);
+    arg->mutable_scalar()->CopyFrom(find->args(index));
+  }
+  find->clear_args();
+
+  pause_read_ahead();
+  read_async_results(m_async_sent);
+  end_last_result();
+
+  send(prepare);
+  if (!read_ok("Prepare.Prepare"))
+  {
+    m_cursors_supported = false;
+    return execute_serialized(Mysqlx::ClientMessages::CRUD_FIND, payload, true);
+  }
+
+  send(open);
+
+  std::shared_ptr<Result> result(new_result(true));
+  result->set_cursor(id, fetch_rows);
+
+  return result;
+}
+
+bool Connection::read_ok(const char *request)
+{
+  for (;;)
+  {
+    int mid;
+    boost::scoped_ptr<Message> message(recv_raw(mid));
+    switch (mid)
+    {
+      case Mysqlx::ServerMessages::OK:
+        return true;
+
+      case Mysqlx::ServerMessages::NOTICE:
+        dispatch_notice(static_cast<Mysqlx::Notice::Frame*>(message.get()));
+        break;
+
+      case Mysqlx::ServerMessages::ERROR:
+      {
+        const Mysqlx::Error &error = *static_cast<Mysqlx::Error*>(message.get());
+        if (error.code() == ER_UNKNOWN_COM_ERROR)
+          return false;
+        throw_server_error(error);
+      }
+
+      default:
+        throw Error(CR_COMMANDS_OUT_OF_SYNC, std::string("Unexpected message received in response to ") + request);
+    }
+  }
+}
+
+void Connection::fetch_cursor(uint32_t cursor_id, uint64_t fetch_rows)
+{
+  Mysqlx::Cursor::Fetch fetch;
+  fetch.set_cursor_id(cursor_id);
+  fetch.set_fetch_rows(fetch_rows);
+  send(fetch);
+}
+
+void Connection::close_cursor(uint32_t cursor_id)
+{
+  Mysqlx::Cursor::Close close;
+  close.set_cursor_id(cursor_id);
+  send(close);
+
+  Mysqlx::Prepare::Deallocate deallocate;
+  deallocate.set_stmt_id(cursor_id);
+  send(deallocate);
+
+  // Both are replied, even if the cursor was already closed
+  for (int reply = 0; reply < 2; reply++)
+  {
+    try
+    {
+      read_ok(reply ? "Prepare.Deallocate" : "Cursor.Close");
+    }
+    catch (const Error &error)
+    {
+      if (error.error() == CR_COMMANDS_OUT_OF_SYNC || error.error() == CR_SERVER_GONE_ERROR)
+        throw;
+    }
+  }
+}
+
+std::shared_ptr<Result> Connection::execute_update(const Mysqlx::Crud::Update &m)
+{
+  send(m);
+
+  return new_result(false);
+}
+
+std::shared_ptr<Result> Connection::execute_insert(const Mysqlx::Crud::Insert &m)
+{
+  send(m);
+
+  return new_result(false);
+}
+
+std::shared_ptr<Result> Connection::execute_delete(const Mysqlx::Crud::Delete &m)
+{
+  send(m);
+
+  return new_result(false);
+}
+
+void Connection::setup_capability(const std::string &name, const bool value, int& out_error, std::string &out_error_msg, bool should_throw /*= false*/)
+{
+  Mysqlx::Datatypes::Any any;
+  ::Mysqlx::Datatypes::Scalar *scalar = any.mutable_scalar();
+
+  any.set_type(Mysqlx::Datatypes::Any_Type_SCALAR);
+  scalar->set_type(Mysqlx::Datatypes::Scalar_Type_V_BOOL);
+  scalar->set_v_bool(value);
+
+  setup_capability(name, any, out_error, out_error_msg, should_throw);
+}
+
+void Connection::setup_capability(const std::string &name, const Mysqlx::Datatypes::Any &value, int& out_error, std::string &out_error_msg, bool should_throw /*= false*/)
+{
+  Mysqlx::Connection::CapabilitiesSet capSet;
+  Mysqlx::Connection::Capability     *cap = capSet.mutable_capabilities()->add_capabilities();
+
+  cap->set_name(name);
+  cap->mutable_value()->CopyFrom(value);
+  send(capSet);
+
+  read_async_results(m_async_sent);
+
+  if (m_last_result)
+    m_last_result->buffer();
 
   int mid;
   boost::scoped_ptr<Message> msg(recv_raw(mid));
@@ -696,41 +1465,170 @@ void Connection::authenticate_plain(const std::string &user, const std::string &
 
 void Connection::send_bytes(const std::string &data)
 {
+  pause_read_ahead();
+  flush();
+
   boost::system::error_code error = m_sync_connection.write(data.data(), data.size());
   throw_mysqlx_error(error);
 }
 
-void Connection::send(int mid, const Message &msg)
+// The queued frames are written once they add up to this size even if the
+// connection does not read, which also fills the TLS records
+static const std::size_t k_send_buffer_flush_size = 64 * 1024;
+
+void Connection::queue_frame_header(int mid, std::size_t payload_size)
 {
-  boost::system::error_code error;
   uint8_t buf[5];
-  *(uint32_t*)buf = msg.ByteSize() + 1;
+  *(uint32_t*)buf = static_cast<uint32_t>(payload_size + 1);
 #ifdef WORDS_BIGENDIAN
   std::swap(buf[0], buf[3]);
   std::swap(buf[1], buf[2]);
 #endif
   buf[4] = mid;
 
+  m_send_buffer.append(reinterpret_cast<const char*>(buf), 5);
+
+  Protocol_stats::Traffic &traffic = m_protocol_stats.sent[Protocol_stats::slot(mid)];
+  ++traffic.frames;
+  traffic.bytes += 5 + payload_size;
+}
+
+void Connection::send(int mid, const Message &msg)
+{
+  pause_read_ahead();
+
+  int size = msg.ByteSize();
+
   if (m_trace_packets)
   {
     std::string out;
     google::protobuf::TextFormat::Printer p;
     p.SetInitialIndentLevel(1);
     p.PrintToString(msg, &out);
-    std::cout << ">>>> SEND " << msg.ByteSize() + 1 << " " << msg.GetDescriptor()->full_name() << " {\n" << out << "}\n";
+    std::cout << ">>>> SEND " << size + 1 << " " << msg.GetDescriptor()->full_name() << " {\n" << out << "}\n";
   }
 
-  error = m_sync_connection.write(buf, 5);
-  if (!error)
+  // The message is serialized right after its header on the queue
+  reserve_send_buffer(5 + size);
+  queue_frame_header(mid, size);
+  std::size_t offset = m_send_buffer.size();
+  m_send_buffer.resize(offset + size);
+  if (size)
+    msg.SerializeWithCachedSizesToArray(reinterpret_cast<google::protobuf::uint8*>(&m_send_buffer[offset]));
+
+  if (m_trace_file)
+    m_trace_file->record(Protocol_trace::Send, mid, m_send_buffer.data() + offset, size);
+
+  if (m_result_cache)
+    m_result_cache->sent(mid, m_send_buffer.data() + offset, size);
+
+  if (m_send_buffer.size() >= k_send_buffer_flush_size)
+    flush();
+}
+
+void Connection::send(int mid, const std::string &payload)
+{
+  pause_read_ahead();
+
+  if (m_trace_packets)
+    std::cout << ">>>> SEND " << payload.length() + 1 << " serialized message type " << mid << "\n";
+
+  reserve_send_buffer(5 + payload.length());
+  queue_frame_header(mid, payload.length());
+  m_send_buffer.append(payload);
+
+  if (m_trace_file)
+    m_trace_file->record(Protocol_trace::Send, mid, payload.data(), payload.length());
+
+  if (m_result_cache)
+    m_result_cache->sent(mid, payload.data(), payload.length());
+
+  if (m_send_buffer.size() >= k_send_buffer_flush_size)
+    flush();
+}
+
+void Connection::flush()
+{
+  if (m_send_buffer.empty())
+    return;
+
+  boost::system::error_code error = m_sync_connection.write(m_send_buffer.data(), m_send_buffer.length());
+
+  // Big frames do not keep their memory around
+  if (m_send_buffer.capacity() > k_send_buffer_flush_size * 2)
+    std::string().swap(m_send_buffer);
+  else
+    m_send_buffer.clear();
+  update_buffer_stats();
+
+  throw_mysqlx_error(error);
+}
+
+// Makes room for a frame on the send buffer, when the limit does not allow
+// it the frames queued are sent first so the buffer starts over
+void Connection::reserve_send_buffer(std::size_t frame_size)
+{
+  if (m_buffer_config.memory_limit &&
+      m_recv_buffer.capacity() + m_send_buffer.size() + frame_size > m_buffer_config.memory_limit)
+  {
+    flush();
+    std::string().swap(m_send_buffer);
+    update_buffer_stats();
+  }
+
+  std::size_t needed = m_send_buffer.size() + frame_size;
+  if (needed <= m_send_buffer.capacity())
+    return;
+
+  check_buffer_memory(m_recv_buffer.capacity(), needed);
+  try
   {
-    std::string mbuf;
-    msg.SerializeToString(&mbuf);
+    m_send_buffer.reserve(needed);
+  }
+  catch (const std::bad_alloc &)
+  {
+    ++m_buffer_stats.allocation_failures;
+    throw Error(CR_OUT_OF_MEMORY, "Unable to allocate the send buffer");
+  }
+  update_buffer_stats();
+}
 
-    if (0 != mbuf.length())
-      error = m_sync_connection.write(mbuf.data(), mbuf.length());
+void Connection::set_buffer_config(const Buffer_config &config)
+{
+  m_buffer_config = config;
+
+  if (0 == m_buffer_config.page_size)
+    m_buffer_config.page_size = Buffer_config().page_size;
+
+  // Without unread data the receive buffer is released to grow again in
+  // pages of the new size
+  if (m_recv_begin == m_recv_end)
+  {
+    m_recv_begin = m_recv_end = 0;
+    std::vector<char>().swap(m_recv_buffer);
+    update_buffer_stats();
   }
+}
 
-  throw_mysqlx_error(error);
+// Throws if buffers of the given sizes would go past the memory limit
+void Connection::check_buffer_memory(std::size_t recv_size, std::size_t send_size)
+{
+  if (0 == m_buffer_config.memory_limit || recv_size + send_size <= m_buffer_config.memory_limit)
+    return;
+
+  ++m_buffer_stats.allocation_failures;
+
+  std::stringstream ss;
+  ss << "Connection buffers need " << recv_size + send_size << " bytes, over the limit of "
+     << m_buffer_config.memory_limit << " bytes";
+  throw Error(CR_OUT_OF_MEMORY, ss.str());
+}
+
+void Connection::update_buffer_stats()
+{
+  m_buffer_stats.in_use = m_recv_buffer.capacity() + m_send_buffer.capacity() + m_inflated_buffer.capacity();
+  if (m_buffer_stats.in_use > m_buffer_stats.high_water)
+    m_buffer_stats.high_water = m_buffer_stats.in_use;
 }
 
 void Connection::push_local_notice_handler(Local_notice_handler handler)
@@ -801,6 +1699,12 @@ Message *Connection::recv_next(int &mid)
 
 Message *Connection::recv_raw_with_deadline(int &mid, const std::size_t deadline_miliseconds)
 {
+  // A frame already buffered does not wait for the socket
+  if (m_recv_end > m_recv_begin || m_inflated_end > m_inflated_begin)
+    return recv_raw(mid);
+
+  flush();
+
   char header_buffer[5];
   std::size_t data = sizeof(header_buffer);
   boost::system::error_code error = m_sync_connection.read_with_timeout(header_buffer, data, deadline_miliseconds);
@@ -816,90 +1720,268 @@ Message *Connection::recv_raw_with_deadline(int &mid, const std::size_t deadline
   return recv_message_with_header(mid, header_buffer, sizeof(header_buffer));
 }
 
-Message *Connection::recv_payload(const int mid, const std::size_t msglen)
+// The receive buffer grows in pages of the configured size, frames bigger
+// than the retain size are still read into it but it is released afterwards
+// instead of being kept around
+static const std::size_t k_recv_buffer_retain_size = 1024 * 1024;
+
+// Makes the next length bytes available on the receive buffer from
+// m_recv_begin, reading from the socket as much as it has
+boost::system::error_code Connection::fill_recv_buffer(const std::size_t length)
 {
   boost::system::error_code error;
-  Message* ret_val = NULL;
-  char *mbuf = new char[msglen];
+  std::size_t buffered = m_recv_end - m_recv_begin;
 
-  error = m_sync_connection.read(mbuf, msglen);
+  if (buffered >= length)
+    return error;
 
-  if (!error)
+  // The server can only answer what it received
+  flush();
+
+  // The unread data is moved to the front, growing the buffer if the frame
+  // does not fit
+  if (m_recv_buffer.size() - m_recv_begin < length)
   {
-    switch (mid)
-    {
-      case Mysqlx::ServerMessages::OK:
-        ret_val = new Mysqlx::Ok();
-        break;
-      case Mysqlx::ServerMessages::ERROR:
-        ret_val = new Mysqlx::Error();
-        break;
-      case Mysqlx::ServerMessages::NOTICE:
-        ret_val = new Mysqlx::Notice::Frame();
-        break;
-      case Mysqlx::ServerMessages::CONN_CAPABILITIES:
-        ret_val = new Mysqlx::Connection::Capabilities();
-        break;
-      case Mysqlx::ServerMessages::SESS_AUTHENTICATE_CONTINUE:
-        ret_val = new Mysqlx::Session::AuthenticateContinue();
-        break;
-      case Mysqlx::ServerMessages::SESS_AUTHENTICATE_OK:
-        ret_val = new Mysqlx::Session::AuthenticateOk();
-        break;
-      case Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA:
-        ret_val = new Mysqlx::Resultset::ColumnMetaData();
-        break;
-      case Mysqlx::ServerMessages::RESULTSET_ROW:
-        ret_val = new Mysqlx::Resultset::Row();
-        break;
-      case Mysqlx::ServerMessages::RESULTSET_FETCH_DONE:
-        ret_val = new Mysqlx::Resultset::FetchDone();
-        break;
-      case Mysqlx::ServerMessages::RESULTSET_FETCH_DONE_MORE_RESULTSETS:
-        ret_val = new Mysqlx::Resultset::FetchDoneMoreResultsets();
-        break;
-      case Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK:
-        ret_val = new Mysqlx::Sql::StmtExecuteOk();
-        break;
-    }
+    if (buffered && m_recv_begin)
+      memmove(&m_recv_buffer[0], &m_recv_buffer[m_recv_begin], buffered);
+    m_recv_begin = 0;
+    m_recv_end = buffered;
 
-    if (!ret_val)
+    if (m_recv_buffer.size() < length)
     {
-      delete[] mbuf;
-      std::stringstream ss;
-      ss << "Unknown message received from server ";
-      ss << mid;
-      throw Error(CR_MALFORMED_PACKET, ss.str());
-    }
+      const std::size_t page_size = m_buffer_config.page_size;
+      const std::size_t size = (length + page_size - 1) / page_size * page_size;
 
-    // Parses the received message
-    ret_val->ParseFromString(std::string(mbuf, msglen));
+      try
+      {
+        check_buffer_memory(size, m_send_buffer.capacity());
+
+        // A new allocation of the exact size so the accounting is not off
+        // by the vector growth
+        std::vector<char> grown(size);
+        if (buffered)
+          memcpy(&grown[0], &m_recv_buffer[0], buffered);
+        m_recv_buffer.swap(grown);
+      }
+      catch (const std::bad_alloc &)
+      {
+        ++m_buffer_stats.allocation_failures;
+        m_sync_connection.close();
+        m_closed = true;
+        throw Error(CR_OUT_OF_MEMORY, "Unable to allocate the receive buffer");
+      }
+      catch (const Error &)
+      {
+        // The frame can not be read, so the connection can not go on
+        m_sync_connection.close();
+        m_closed = true;
+        throw;
+      }
+      update_buffer_stats();
+    }
+  }
+
+  const std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+  while (!error && m_recv_end - m_recv_begin < length)
+  {
+    std::size_t data_read = 0;
+    error = m_sync_connection.read_some(&m_recv_buffer[m_recv_end], m_recv_buffer.size() - m_recv_end, data_read);
+    m_recv_end += data_read;
+  }
+  m_protocol_stats.recv_wait_time += std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - wait_start).count();
+
+  return error;
+}
+
+Message *Connection::recv_payload(const int mid, const std::size_t msglen)
+{
+  boost::system::error_code error;
+
+  // The payload is parsed straight from the receive buffer, which grows to
+  // fit the largest frame received so far
+  error = fill_recv_buffer(msglen);
+  throw_mysqlx_error(error);
+
+  char *mbuf = msglen ? &m_recv_buffer[m_recv_begin] : NULL;
+  m_recv_begin += msglen;
+
+  Message *ret_val = parse_message(mid, mbuf, msglen);
+
+  if (m_recv_begin == m_recv_end)
+  {
+    m_recv_begin = m_recv_end = 0;
 
-    if (m_trace_packets)
+    if (m_recv_buffer.size() > std::max(k_recv_buffer_retain_size, m_buffer_config.page_size))
     {
-      std::string out;
-      google::protobuf::TextFormat::Printer p;
-      p.SetInitialIndentLevel(1);
-      p.PrintToString(*ret_val, &out);
-      std::cout << "<<<< RECEIVE " << msglen << " " << ret_val->GetDescriptor()->full_name() << " {\n" << out << "}\n";
+      std::vector<char>().swap(m_recv_buffer);
+      update_buffer_stats();
     }
+  }
+
+  return ret_val;
+}
+
+Message *Connection::parse_message(const int mid, const char *mbuf, const std::size_t msglen)
+{
+  Message* ret_val = NULL;
+
+  if (m_trace_file)
+    m_trace_file->record(Protocol_trace::Receive, mid, mbuf, msglen);
+
+  switch (mid)
+  {
+    case Mysqlx::ServerMessages::OK:
+      ret_val = new Mysqlx::Ok();
+      break;
+    case Mysqlx::ServerMessages::ERROR:
+      ret_val = new Mysqlx::Error();
+      break;
+    case Mysqlx::ServerMessages::NOTICE:
+      ret_val = new Mysqlx::Notice::Frame();
+      break;
+    case Mysqlx::ServerMessages::CONN_CAPABILITIES:
+      ret_val = new Mysqlx::Connection::Capabilities();
+      break;
+    case Mysqlx::ServerMessages::SESS_AUTHENTICATE_CONTINUE:
+      ret_val = new Mysqlx::Session::AuthenticateContinue();
+      break;
+    case Mysqlx::ServerMessages::SESS_AUTHENTICATE_OK:
+      ret_val = new Mysqlx::Session::AuthenticateOk();
+      break;
+    case Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA:
+      ret_val = new Mysqlx::Resultset::ColumnMetaData();
+      break;
+    case Mysqlx::ServerMessages::RESULTSET_ROW:
+      ret_val = m_row_pool->acquire();
+      break;
+    case Mysqlx::ServerMessages::RESULTSET_FETCH_DONE:
+      ret_val = new Mysqlx::Resultset::FetchDone();
+      break;
+    case Mysqlx::ServerMessages::RESULTSET_FETCH_DONE_MORE_RESULTSETS:
+      ret_val = new Mysqlx::Resultset::FetchDoneMoreResultsets();
+      break;
+    case Mysqlx::ServerMessages::RESULTSET_FETCH_SUSPENDED:
+      ret_val = new Mysqlx::Resultset::FetchSuspended();
+      break;
+    case Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK:
+      ret_val = new Mysqlx::Sql::StmtExecuteOk();
+      break;
+    case Mysqlx::ServerMessages::COMPRESSION:
+      ret_val = new Mysqlx::Connection::Compression();
+      break;
+  }
+
+  if (!ret_val)
+  {
+    std::stringstream ss;
+    ss << "Unknown message received from server ";
+    ss << mid;
+    throw Error(CR_MALFORMED_PACKET, ss.str());
+  }
+
+  Protocol_stats::Traffic &traffic = m_protocol_stats.received[Protocol_stats::slot(mid)];
+  ++traffic.frames;
+  traffic.bytes += 5 + msglen;
+  if (mid == Mysqlx::ServerMessages::NOTICE)
+    ++m_protocol_stats.notices;
+
+  // Parses the received message straight from the buffer it was read into
+  const std::chrono::steady_clock::time_point decode_start = std::chrono::steady_clock::now();
+  ret_val->ParseFromArray(mbuf, static_cast<int>(msglen));
+  m_protocol_stats.decode_time += std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - decode_start).count();
+
+  if (m_trace_packets)
+  {
+    std::string out;
+    google::protobuf::TextFormat::Printer p;
+    p.SetInitialIndentLevel(1);
+    p.PrintToString(*ret_val, &out);
+    std::cout << "<<<< RECEIVE " << msglen << " " << ret_val->GetDescriptor()->full_name() << " {\n" << out << "}\n";
+  }
+
+  if (!ret_val->IsInitialized())
+  {
+    std::string err("Message is not properly initialized: ");
+    err += ret_val->InitializationErrorString();
+    delete ret_val;
+    throw Error(CR_MALFORMED_PACKET, err);
+  }
 
-    if (!ret_val->IsInitialized())
+  return ret_val;
+}
+
+// Uncompresses the frames of a Compression message into the inflated buffer
+void Connection::inflate_frames(const Mysqlx::Connection::Compression &compression)
+{
+  if (!m_decompressor)
+    throw Error(CR_MALFORMED_PACKET, "Compressed message received but compression was not enabled");
+
+  if (m_inflated_begin == m_inflated_end)
+    m_inflated_begin = m_inflated_end = 0;
+
+  const std::string &payload(compression.payload());
+  bool decompressed;
+  try
+  {
+    // The size announced by the server is reserved upfront
+    std::size_t needed = m_inflated_end + static_cast<std::size_t>(compression.uncompressed_size());
+    if (needed > m_inflated_buffer.size())
     {
-      delete[] mbuf;
-      delete ret_val;
-      std::string err("Message is not properly initialized: ");
-      err += ret_val->InitializationErrorString();
-      throw Error(CR_MALFORMED_PACKET, err);
+      check_buffer_memory(m_recv_buffer.capacity() + needed, m_send_buffer.capacity());
+      m_inflated_buffer.resize(needed);
     }
+
+    decompressed = m_decompressor->decompress(payload.data(), payload.size(), m_inflated_buffer, m_inflated_end);
   }
-  else
+  catch (const std::bad_alloc &)
   {
-    delete[] mbuf;
-    throw_mysqlx_error(error);
+    ++m_buffer_stats.allocation_failures;
+    decompressed = false;
+  }
+  catch (const Error &)
+  {
+    m_sync_connection.close();
+    m_closed = true;
+    throw;
+  }
+  update_buffer_stats();
+
+  if (!decompressed)
+  {
+    // The stream can not go on after data it was not able to decode
+    m_sync_connection.close();
+    m_closed = true;
+    throw Error(CR_MALFORMED_PACKET, "Unable to decompress the message received from server");
   }
+}
+
+// Parses the next frame of the inflated buffer
+Message *Connection::recv_inflated(int &mid)
+{
+  std::size_t available = m_inflated_end - m_inflated_begin;
+  const char *frame = available ? &m_inflated_buffer[m_inflated_begin] : NULL;
+  std::size_t msglen;
+
+  if (!read_inflated_frame(frame, available, mid, msglen))
+    throw Error(CR_MALFORMED_PACKET, "Invalid or truncated frame in compressed message");
 
-  delete[] mbuf;
+  const char *mbuf = frame + 5;
+  m_inflated_begin += 5 + msglen;
+
+  Message *ret_val = parse_message(mid, mbuf, msglen);
+
+  if (m_inflated_begin == m_inflated_end)
+  {
+    m_inflated_begin = m_inflated_end = 0;
+
+    if (m_inflated_buffer.size() > std::max(k_recv_buffer_retain_size, m_buffer_config.page_size))
+    {
+      std::vector<char>().swap(m_inflated_buffer);
+      update_buffer_stats();
+    }
+  }
 
   return ret_val;
 }
@@ -908,6 +1990,9 @@ Message *Connection::recv_raw(int &mid)
 {
   char buf[5];
 
+  if (m_inflated_end > m_inflated_begin)
+    return recv_inflated(mid);
+
   return recv_message_with_header(mid, buf, 0);
 }
 
@@ -916,7 +2001,12 @@ Message *Connection::recv_message_with_header(int &mid, char(&header_buffer)[5],
   Message* ret_val = NULL;
   boost::system::error_code error;
 
-  error = m_sync_connection.read(header_buffer + header_offset, 5 - header_offset);
+  error = fill_recv_buffer(5 - header_offset);
+  if (!error && header_offset < 5)
+  {
+    memcpy(header_buffer + header_offset, &m_recv_buffer[m_recv_begin], 5 - header_offset);
+    m_recv_begin += 5 - header_offset;
+  }
 
 #ifdef WORDS_BIGENDIAN
   std::swap(header_buffer[0], header_buffer[3]);
@@ -929,6 +2019,14 @@ Message *Connection::recv_message_with_header(int &mid, char(&header_buffer)[5],
     mid = header_buffer[4];
 
     ret_val = recv_payload(mid, msglen);
+
+    // The frames of a compressed message are returned one by one
+    if (mid == Mysqlx::ServerMessages::COMPRESSION)
+    {
+      boost::scoped_ptr<Message> compression(ret_val);
+      inflate_frames(*static_cast<Mysqlx::Connection::Compression*>(compression.get()));
+      ret_val = recv_inflated(mid);
+    }
   }
   else
   {
@@ -964,11 +2062,55 @@ void Connection::throw_mysqlx_error(const boost::system::error_code &error)
 }
 
 std::shared_ptr<Result> Connection::new_result(bool expect_data)
+{
+  // The results pending from asynchronous statements come first
+  pause_read_ahead();
+  read_async_results(m_async_sent);
+
+  return create_result(expect_data);
+}
+
+void Connection::pause_read_ahead()
 {
   if (m_last_result)
-    m_last_result->buffer();
+    m_last_result->pause_prefetch();
+}
+
+uint64_t Connection::statements_pending() const
+{
+  static const int statements[] = {
+    Mysqlx::ClientMessages::SQL_STMT_EXECUTE, Mysqlx::ClientMessages::CRUD_FIND,
+    Mysqlx::ClientMessages::CRUD_INSERT, Mysqlx::ClientMessages::CRUD_UPDATE,
+    Mysqlx::ClientMessages::CRUD_DELETE, Mysqlx::ClientMessages::CURSOR_OPEN,
+    Mysqlx::ClientMessages::CURSOR_FETCH
+  };
+
+  uint64_t sent = 0;
+  for (std::size_t index = 0; index < sizeof(statements) / sizeof(statements[0]); index++)
+    sent += m_protocol_stats.sent[Protocol_stats::slot(statements[index])].frames;
+
+  return sent > m_statements_ended ? sent - m_statements_ended : 0;
+}
+
+void Connection::end_last_result()
+{
+  // The previous result is kept for whoever still holds it, else nobody is
+  // going to read it
+  if (m_last_result)
+  {
+    if (m_last_result.use_count() == 1)
+      m_last_result->flush();
+    else
+      m_last_result->buffer();
+  }
+}
+
+std::shared_ptr<Result> Connection::create_result(bool expect_data)
+{
+  end_last_result();
 
   m_last_result.reset(new Result(shared_from_this(), expect_data));
+  m_last_result->set_prefetch(m_result_prefetch);
 
   return m_last_result;
 }
@@ -1033,18 +2175,48 @@ void Document::reset(const std::string &doc, bool expression, const std::string
 }
 
 Result::Result(std::shared_ptr<Connection>owner, bool expect_data, bool expect_ok)
-  : current_message(NULL), m_owner(owner), m_last_insert_id(-1), m_affected_rows(-1),
-  m_result_index(0), m_state(expect_data ? ReadMetadataI : expect_ok ? ReadStmtOkI : ReadDone), m_buffered(false), m_buffering(false), m_has_doc_ids(false)
+  : current_message(NULL), m_owner(owner), m_row_pool(owner->row_pool()), m_last_insert_id(-1), m_affected_rows(-1),
+  m_rows_read(0), m_result_index(0), m_buffer_memory_limit(0), m_prefetch_rows(0), m_cursor_id(0), m_cursor_fetch_rows(0),
+  m_cursor_suspended(false), m_cursor_closing(false), m_state(expect_data ? ReadMetadataI : expect_ok ? ReadStmtOkI : ReadDone),
+  m_buffered(false), m_buffering(false), m_has_doc_ids(false)
 {
 }
 
 Result::Result()
-  : current_message(NULL), m_state(ReadDone), m_buffered(false), m_buffering(false)
+  : current_message(NULL), m_rows_read(0), m_buffer_memory_limit(0), m_prefetch_rows(0), m_cursor_id(0), m_cursor_fetch_rows(0),
+  m_cursor_suspended(false), m_cursor_closing(false), m_state(ReadDone), m_buffered(false), m_buffering(false)
 {
 }
 
+// The rows read by the thread wait on the queue, only the thread touches the
+// connection until it is stopped and joined
+struct Result::Prefetch
+{
+  Prefetch() : stop(false), done(false) {}
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<Mysqlx::Resultset::Row *> rows;
+  // Asked to stop, or finished reading the rows
+  bool stop;
+  bool done;
+  std::exception_ptr error;
+};
+
 Result::~Result()
 {
+  try
+  {
+    end_prefetch(NULL);
+  }
+  catch (...)
+  {
+  }
+
+  // The cursor is closed rather than fetched to the end
+  m_cursor_closing = true;
+
   // flush the resultset from the pipe
   while (m_state != ReadError && m_state != ReadDone)
     nextDataSet();
@@ -1079,6 +2251,42 @@ void Result::wait()
     read_stmt_ok();
 }
 
+std::shared_ptr<Result> Result::clone() const
+{
+  if (!m_buffered && m_state != ReadDone)
+    throw std::logic_error("Only buffered results can be copied");
+
+  std::shared_ptr<Result> ret_val(new Result());
+  ret_val->m_columns = m_columns;
+  ret_val->m_last_insert_id = m_last_insert_id;
+  ret_val->m_last_document_ids = m_last_document_ids;
+  ret_val->m_affected_rows = m_affected_rows;
+  ret_val->m_info_message = m_info_message;
+  ret_val->m_warnings = m_warnings;
+  ret_val->m_has_doc_ids = m_has_doc_ids;
+
+  if (m_buffered)
+  {
+    for (std::size_t index = 0; index < m_result_cache.size(); index++)
+      ret_val->m_result_cache.push_back(m_result_cache[index]->clone());
+
+    ret_val->m_buffered = true;
+    ret_val->m_result_index = 0;
+    ret_val->nextDataSet();
+  }
+
+  return ret_val;
+}
+
+std::size_t Result::buffered_size() const
+{
+  std::size_t ret_val = 0;
+  for (std::size_t index = 0; index < m_result_cache.size(); index++)
+    ret_val += m_result_cache[index]->memory_size();
+
+  return ret_val;
+}
+
 void Result::mark_error()
 {
   m_state = ReadError;
@@ -1167,7 +2375,42 @@ int Result::get_message_id()
 
     try
     {
-      current_message = owner->recv_next(current_message_id);
+      for (;;)
+      {
+        if (m_cursor_suspended)
+        {
+          m_cursor_suspended = false;
+          owner->fetch_cursor(m_cursor_id, m_cursor_fetch_rows);
+        }
+
+        current_message = owner->recv_next(current_message_id);
+        if (current_message_id != Mysqlx::ServerMessages::RESULTSET_FETCH_SUSPENDED)
+          break;
+
+        // Each batch of rows of a cursor ends with FetchSuspended and the
+        // StmtExecuteOk of the Open or Fetch
+        delete current_message;
+        current_message = owner->recv_next(current_message_id);
+        if (current_message_id != Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK)
+          break;
+
+        ++owner->m_statements_ended;
+        if (m_state == ReadMetadata)
+          m_state = ReadRows;
+
+        if (m_cursor_closing)
+        {
+          // What is left of the rows is dropped with the cursor
+          m_state = ReadDone;
+          owner->pop_local_notice_handler();
+          end_cursor();
+          return current_message_id;
+        }
+
+        delete current_message;
+        current_message = NULL;
+        m_cursor_suspended = true;
+      }
     }
     catch (...)
     {
@@ -1182,7 +2425,22 @@ int Result::get_message_id()
   // error messages that can be received in any state
   if (current_message_id == Mysqlx::ServerMessages::ERROR)
   {
+    if (owner)
+      ++owner->m_statements_ended;
+
     m_state = ReadError;
+
+    // The statement of the failed cursor is still prepared
+    if (m_cursor_id)
+    {
+      try
+      {
+        end_cursor();
+      }
+      catch (...)
+      {
+      }
+    }
     throw_server_error(static_cast<const Mysqlx::Error&>(*current_message));
   }
 
@@ -1193,6 +2451,8 @@ int Result::get_message_id()
       switch (current_message_id)
       {
         case Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK:
+          if (owner)
+            ++owner->m_statements_ended;
           m_state = ReadDone;
           return current_message_id;
 
@@ -1247,7 +2507,11 @@ int Result::get_message_id()
       switch (current_message_id)
       {
         case Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK:
+          if (owner)
+            ++owner->m_statements_ended;
           m_state = ReadDone;
+          if (m_cursor_id)
+            end_cursor();
           return current_message_id;
       }
       break;
@@ -1268,6 +2532,16 @@ int Result::get_message_id()
   throw Error(CR_COMMANDS_OUT_OF_SYNC, "Unexpected message received from server reading results");
 }
 
+void Result::end_cursor()
+{
+  uint32_t cursor_id = m_cursor_id;
+  m_cursor_id = 0;
+  m_cursor_suspended = false;
+
+  if (std::shared_ptr<Connection> owner = m_owner.lock())
+    owner->close_cursor(cursor_id);
+}
+
 mysqlx::Message* Result::pop_message()
 {
   mysqlx::Message *result = current_message;
@@ -1303,6 +2577,14 @@ void Result::setLastDocumentIDs(const std::vector<std::string>& document_ids)
   std::copy(document_ids.begin(), document_ids.end(), std::back_inserter(m_last_document_ids));
 }
 
+void Result::merge(const Result &other)
+{
+  if (other.m_affected_rows > 0)
+    m_affected_rows = std::max<int64_t>(m_affected_rows, 0) + other.m_affected_rows;
+
+  m_warnings.insert(m_warnings.begin(), other.m_warnings.begin(), other.m_warnings.end());
+}
+
 static ColumnMetadata unwrap_column_metadata(const Mysqlx::Resultset::ColumnMetaData &column_data)
 {
   ColumnMetadata column;
@@ -1408,7 +2690,7 @@ std::shared_ptr<Row> Result::read_row()
 
   if (mid == Mysqlx::ServerMessages::RESULTSET_ROW)
   {
-    ret_val.reset(new Row(m_columns, static_cast<Mysqlx::Resultset::Row*>(pop_message())));
+    ret_val.reset(new Row(m_columns, static_cast<Mysqlx::Resultset::Row*>(pop_message()), m_row_pool));
 
     // If caching adds it to the cache instead
     if (m_buffering)
@@ -1497,6 +2779,138 @@ bool Result::has_data()
   return ret_val;
 }
 
+void Result::set_prefetch(std::size_t max_rows)
+{
+  if (!max_rows)
+  {
+    std::vector<Mysqlx::Resultset::Row *> rows;
+    end_prefetch(&rows);
+    release_rows(rows);
+  }
+
+  m_prefetch_rows = max_rows;
+}
+
+void Result::prefetch_rows()
+{
+  Prefetch &prefetch = *m_prefetch;
+
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(prefetch.mutex);
+      prefetch.cond.wait(lock, [&]() { return prefetch.stop || prefetch.rows.size() < m_prefetch_rows; });
+      if (prefetch.stop)
+        break;
+    }
+
+    Mysqlx::Resultset::Row *row;
+    try
+    {
+      // The message ending the rows stays for the caller to read
+      if (m_state != ReadRows || get_message_id() != Mysqlx::ServerMessages::RESULTSET_ROW)
+        break;
+
+      row = static_cast<Mysqlx::Resultset::Row*>(pop_message());
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(prefetch.mutex);
+      prefetch.error = std::current_exception();
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(prefetch.mutex);
+      prefetch.rows.push_back(row);
+    }
+    prefetch.cond.notify_all();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(prefetch.mutex);
+    prefetch.done = true;
+  }
+  prefetch.cond.notify_all();
+}
+
+// The next row read ahead, NULL once there are no more on the data set
+Mysqlx::Resultset::Row *Result::next_prefetched()
+{
+  for (;;)
+  {
+    if (!m_prefetch)
+    {
+      if (m_state != ReadRows)
+        return NULL;
+
+      m_prefetch.reset(new Prefetch());
+      m_prefetch->thread = std::thread(&Result::prefetch_rows, this);
+    }
+
+    Prefetch &prefetch = *m_prefetch;
+    {
+      std::unique_lock<std::mutex> lock(prefetch.mutex);
+      prefetch.cond.wait(lock, [&]() { return !prefetch.rows.empty() || prefetch.done; });
+
+      if (!prefetch.rows.empty())
+      {
+        Mysqlx::Resultset::Row *row = prefetch.rows.front();
+        prefetch.rows.pop_front();
+        lock.unlock();
+        prefetch.cond.notify_all();
+        return row;
+      }
+    }
+
+    // Paused threads are started again, the others ended the rows
+    bool paused = prefetch.stop;
+    std::exception_ptr error = prefetch.error;
+    if (prefetch.thread.joinable())
+      prefetch.thread.join();
+    m_prefetch.reset();
+
+    if (error)
+      std::rethrow_exception(error);
+
+    if (!paused)
+      return NULL;
+  }
+}
+
+void Result::pause_prefetch()
+{
+  if (!m_prefetch || !m_prefetch->thread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_prefetch->mutex);
+    m_prefetch->stop = true;
+  }
+  m_prefetch->cond.notify_all();
+  m_prefetch->thread.join();
+}
+
+void Result::end_prefetch(std::vector<Mysqlx::Resultset::Row *> *rows)
+{
+  if (!m_prefetch)
+    return;
+
+  pause_prefetch();
+
+  std::vector<Mysqlx::Resultset::Row *> read(m_prefetch->rows.begin(), m_prefetch->rows.end());
+  std::exception_ptr error = m_prefetch->error;
+  m_prefetch.reset();
+
+  if (rows)
+    rows->insert(rows->end(), read.begin(), read.end());
+  else
+    release_rows(read);
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
 bool Result::nextDataSet()
 {
   if (m_buffered)
@@ -1510,6 +2924,8 @@ bool Result::nextDataSet()
   }
   else
   {
+    end_prefetch(NULL);
+
     // flush left over rows
     while (m_state == ReadRows)
       read_row();
@@ -1522,7 +2938,7 @@ bool Result::nextDataSet()
         // If caching adds this new resultset to the cache
         if (m_buffering)
         {
-          m_current_result.reset(new ResultData(m_columns));
+          m_current_result.reset(new ResultData(m_columns, m_buffer_memory_limit, m_buffer_accounting));
           m_result_cache.push_back(m_current_result);
         }
         return true;
@@ -1542,6 +2958,20 @@ std::shared_ptr<Row> Result::next()
     ret_val = m_current_result->next();
   else
   {
+    // The state belongs to the reading thread while there is one
+    if (m_prefetch || (m_prefetch_rows && ready() && m_state == ReadRows))
+    {
+      if (Mysqlx::Resultset::Row *data = next_prefetched())
+      {
+        m_rows_read++;
+        return std::shared_ptr<Row>(new Row(m_columns, data, m_row_pool));
+      }
+
+      // The data set ended, the next one is up to nextDataSet()
+      if (m_state == ReadMetadata)
+        return ret_val;
+    }
+
     if (!ready())
       wait();
 
@@ -1557,21 +2987,188 @@ std::shared_ptr<Row> Result::next()
     }
   }
 
+  if (ret_val)
+    m_rows_read++;
+
   return ret_val;
 }
 
-// Flush will read all the messages from the IO
+std::shared_ptr<Row_batch> Result::next_batch(std::size_t max_rows)
+{
+  std::shared_ptr<Row_batch> ret_val;
+
+  if (m_buffered)
+  {
+    if (!m_current_result)
+      return ret_val;
+
+    ret_val.reset(new Row_batch(m_current_result->columnMetadata(), max_rows));
+
+    std::vector<std::shared_ptr<Row> > rows;
+    std::vector<Mysqlx::Resultset::Row *> data;
+
+    std::shared_ptr<Row> row;
+    while (rows.size() < max_rows && (row = m_current_result->next()))
+    {
+      rows.push_back(row);
+      data.push_back(row->m_data);
+    }
+
+    if (!data.empty())
+      ret_val->append(&data[0], data.size());
+  }
+  else
+  {
+    // The rows read ahead come first
+    std::vector<Mysqlx::Resultset::Row *> rows;
+    rows.reserve(max_rows);
+
+    try
+    {
+      end_prefetch(&rows);
+    }
+    catch (...)
+    {
+      release_rows(rows);
+      throw;
+    }
+
+    if (!ready())
+      wait();
+
+    if (m_state == ReadStmtOk && rows.empty())
+      read_stmt_ok();
+
+    if (m_state != ReadRows && rows.empty())
+      return ret_val;
+
+    ret_val.reset(new Row_batch(m_columns, max_rows));
+
+    // The row messages of the batch are decoded together and go back to
+    // the pool without ever being wrapped into a Row
+    try
+    {
+      while (m_state == ReadRows && rows.size() < max_rows)
+      {
+        if (get_message_id() != Mysqlx::ServerMessages::RESULTSET_ROW)
+          break;
+
+        rows.push_back(static_cast<Mysqlx::Resultset::Row*>(pop_message()));
+      }
+
+      if (!rows.empty())
+        ret_val->append(&rows[0], rows.size());
+    }
+    catch (...)
+    {
+      release_rows(rows);
+      throw;
+    }
+
+    release_rows(rows);
+
+    if (m_state == ReadStmtOk)
+      read_stmt_ok();
+  }
+
+  if (!ret_val->size())
+    ret_val.reset();
+  else
+    m_rows_read += ret_val->size();
+
+  return ret_val;
+}
+
+void Result::release_rows(const std::vector<Mysqlx::Resultset::Row *> &rows)
+{
+  for (std::size_t index = 0; index < rows.size(); ++index)
+  {
+    if (m_row_pool)
+      m_row_pool->release(rows[index]);
+    else
+      delete rows[index];
+  }
+}
+
+// Flush will read all the messages from the IO
 // If caching is enabled the data will be cached, if not
 // it will be just discarded
 void Result::flush()
 {
+  std::shared_ptr<Connection> owner = m_owner.lock();
+
+  end_prefetch(NULL);
+
+  // Only the rows already sent by a cursor are read
+  m_cursor_closing = true;
+
   // Flushes the leftover data only if it was not previously cached
-  wait();
-  while (nextDataSet());
+  if (m_buffered || m_buffering || !owner || !owner->m_discard_policy.cancel)
+  {
+    wait();
+    while (nextDataSet());
+    return;
+  }
+
+  // The rows are counted as they are dropped, until the policy says the
+  // statement is better cancelled than read to the end
+  const Discard_policy &policy = owner->m_discard_policy;
+  const Protocol_stats::Traffic &rows_received =
+      owner->m_protocol_stats.received[Protocol_stats::slot(Mysqlx::ServerMessages::RESULTSET_ROW)];
+  const uint64_t first_row_bytes = rows_received.bytes;
+  uint64_t rows = 0;
+  bool cancelled = false;
+
+  try
+  {
+    wait();
+    do
+    {
+      while (m_state == ReadRows)
+      {
+        if (!cancelled &&
+            ((policy.max_rows && rows >= policy.max_rows) ||
+             (policy.max_bytes && rows_received.bytes - first_row_bytes >= policy.max_bytes)) &&
+            owner->statements_pending() == 1)
+        {
+          // If the statement can not be killed, it is read to the end
+          cancelled = true;
+          try
+          {
+            policy.cancel();
+          }
+          catch (...)
+          {
+          }
+        }
+
+        read_row();
+        rows++;
+      }
+    } while (nextDataSet());
+  }
+  catch (const Error &error)
+  {
+    // The killed statement ends with this error, which nobody asked for
+    if (!cancelled || error.error() != ER_QUERY_INTERRUPTED)
+      throw;
+  }
 }
 
-Result& Result::buffer()
+Result& Result::buffer(std::size_t memory_limit, const Memory_accounting &accounting)
 {
+  // The rows already read ahead are the first ones buffered
+  std::vector<Mysqlx::Resultset::Row *> rows;
+  try
+  {
+    end_prefetch(&rows);
+  }
+  catch (...)
+  {
+    release_rows(rows);
+    throw;
+  }
+
   if (!ready())
   wait();
 
@@ -1580,16 +3177,27 @@ Result& Result::buffer()
   if (m_state != ReadDone)
   {
     m_buffering = true;
+    m_buffer_memory_limit = memory_limit;
+    m_buffer_accounting = accounting;
 
     // This will enable data caching
-    m_current_result.reset(new ResultData(m_columns));
+    m_current_result.reset(new ResultData(m_columns, m_buffer_memory_limit, m_buffer_accounting));
     m_result_cache.push_back(m_current_result);
 
+    for (std::size_t index = 0; index < rows.size(); index++)
+      m_current_result->add_row(std::shared_ptr<Row>(new Row(m_columns, rows[index], m_row_pool)));
+
     // This will actually cache the data
     while (nextDataSet())
       ;
 
     m_buffering = false;
+
+    if (std::shared_ptr<Connection> owner = m_owner.lock())
+    {
+      for (std::size_t index = 0; index < m_result_cache.size(); index++)
+        owner->m_protocol_stats.rows_buffered += m_result_cache[index]->size();
+    }
     m_buffered = true;
 
     m_result_index = 1;
@@ -1598,14 +3206,124 @@ Result& Result::buffer()
   return *this;
 }
 
-ResultData::ResultData(std::shared_ptr<std::vector<ColumnMetadata> > columns) :
-m_columns(columns), m_row_index(0)
+ResultData::ResultData(std::shared_ptr<std::vector<ColumnMetadata> > columns, std::size_t memory_limit,
+                       const Memory_accounting &accounting) :
+m_columns(columns), m_row_index(0), m_memory_limit(memory_limit), m_memory_size(0), m_accounting(accounting),
+m_accounted_size(0), m_spill_file(NULL), m_spill_size(0), m_spill_mapping(NULL), m_spill_mapped_size(0)
 {
 }
 
+ResultData::~ResultData()
+{
+  if (m_accounting && m_accounted_size)
+    m_accounting(-static_cast<int64_t>(m_accounted_size));
+
+  unmap_spill();
+
+  // The temporary file is deleted when closed
+  if (m_spill_file)
+    fclose(m_spill_file);
+}
+
 void ResultData::add_row(std::shared_ptr<Row> row)
 {
-  m_rows.push_back(row);
+  // Once spilling starts every following row goes to the file, so the rows
+  // on memory are always the first ones
+  if (!m_spill_file)
+  {
+    std::size_t row_size = sizeof(Row) + row->m_data->ByteSize();
+
+    if ((!m_memory_limit || m_memory_size + row_size <= m_memory_limit) &&
+        (!m_accounting || m_accounting(static_cast<int64_t>(row_size))))
+    {
+      m_memory_size += row_size;
+      if (m_accounting)
+        m_accounted_size += row_size;
+      m_rows.push_back(row);
+      return;
+    }
+
+    m_spill_file = tmpfile();
+    if (!m_spill_file)
+      throw std::runtime_error("Unable to create a temporary file to buffer the result");
+  }
+
+  spill_row(*row);
+}
+
+void ResultData::spill_row(const Row &row)
+{
+  std::string data;
+  if (!row.m_data->SerializeToString(&data))
+    throw std::runtime_error("Unable to serialize a row of the buffered result");
+
+  uint32_t length = static_cast<uint32_t>(data.size());
+  if (fwrite(&length, sizeof(length), 1, m_spill_file) != 1 ||
+      (length && fwrite(data.data(), length, 1, m_spill_file) != 1))
+    throw std::runtime_error("Unable to write the buffered result into a temporary file");
+
+  m_spill_offsets.push_back(m_spill_size);
+  m_spill_size += sizeof(length) + length;
+}
+
+void ResultData::unmap_spill()
+{
+#ifndef WIN32
+  if (m_spill_mapping)
+    munmap(const_cast<char*>(m_spill_mapping), m_spill_mapped_size);
+#endif
+
+  m_spill_mapping = NULL;
+  m_spill_mapped_size = 0;
+}
+
+std::shared_ptr<Row> ResultData::read_spilled_row(size_t index)
+{
+  uint64_t offset = m_spill_offsets[index];
+  uint32_t length = 0;
+  std::string buffer;
+  const char *data = NULL;
+
+  if (fflush(m_spill_file) != 0)
+    throw std::runtime_error("Unable to read the buffered result from a temporary file");
+
+#ifndef WIN32
+  // The file is complete once the rows are read back, mapped again only if
+  // rows were added since
+  if (m_spill_mapped_size != m_spill_size)
+  {
+    unmap_spill();
+
+    void *mapping = mmap(NULL, static_cast<std::size_t>(m_spill_size), PROT_READ, MAP_PRIVATE, fileno(m_spill_file), 0);
+    if (mapping == MAP_FAILED)
+      throw std::runtime_error("Unable to map the temporary file of the buffered result");
+
+    m_spill_mapping = static_cast<const char*>(mapping);
+    m_spill_mapped_size = static_cast<std::size_t>(m_spill_size);
+  }
+
+  memcpy(&length, m_spill_mapping + offset, sizeof(length));
+  data = m_spill_mapping + offset + sizeof(length);
+#else
+  if (_fseeki64(m_spill_file, static_cast<__int64>(offset), SEEK_SET) != 0 ||
+      fread(&length, sizeof(length), 1, m_spill_file) != 1)
+    throw std::runtime_error("Unable to read the buffered result from a temporary file");
+
+  buffer.resize(length);
+  if (length && fread(&buffer[0], length, 1, m_spill_file) != 1)
+    throw std::runtime_error("Unable to read the buffered result from a temporary file");
+
+  data = buffer.data();
+
+  // Later rows are appended at the end
+  fseek(m_spill_file, 0, SEEK_END);
+#endif
+
+  std::unique_ptr<Mysqlx::Resultset::Row> row(new Mysqlx::Resultset::Row());
+  if (!row->ParseFromArray(data, static_cast<int>(length)))
+    throw std::runtime_error("Unable to parse a row of the buffered result");
+
+  return std::shared_ptr<Row>(new Row(m_columns, row.release()));
 }
 
 std::shared_ptr<Row> ResultData::next()
@@ -1614,10 +3332,23 @@ std::shared_ptr<Row> ResultData::next()
 
   if (m_row_index < m_rows.size())
     ret_val = m_rows[m_row_index++];
+  else if (m_row_index < size())
+    ret_val = read_spilled_row(m_row_index++ - m_rows.size());
 
   return ret_val;
 }
 
+std::shared_ptr<ResultData> ResultData::clone() const
+{
+  if (m_spill_file)
+    throw std::logic_error("Unable to copy a result buffered on disk");
+
+  std::shared_ptr<ResultData> ret_val(new ResultData(m_columns, m_memory_limit));
+  ret_val->m_rows = m_rows;
+  ret_val->m_memory_size = m_memory_size;
+  return ret_val;
+}
+
 void ResultData::rewind()
 {
   m_row_index = 0;
@@ -1630,20 +3361,473 @@ void ResultData::tell(size_t &record)
 
 void ResultData::seek(size_t record)
 {
-  m_row_index = m_rows.size();
+  m_row_index = size();
 
   if (record < m_row_index)
     m_row_index = record;
 }
 
-Row::Row(std::shared_ptr<std::vector<ColumnMetadata> > columns, Mysqlx::Resultset::Row *data)
-  : m_columns(columns), m_data(data)
+Row_batch::Row_batch(std::shared_ptr<std::vector<ColumnMetadata> > columns, std::size_t capacity)
+  : m_metadata(columns), m_size(0)
+{
+  if (columns)
+  {
+    m_columns.resize(columns->size());
+    for (std::size_t index = 0; index < columns->size(); ++index)
+    {
+      Column &column = m_columns[index];
+      column.type = columns->at(index).type;
+      column.nulls.reserve(capacity);
+
+      switch (column.type)
+      {
+        case SINT:
+          column.sints.reserve(capacity);
+          break;
+        case UINT:
+        case BIT:
+          column.uints.reserve(capacity);
+          break;
+        case DOUBLE:
+        case FLOAT:
+          column.doubles.reserve(capacity);
+          break;
+        case DATETIME:
+          column.datetimes.reserve(capacity);
+          break;
+        case TIME:
+          column.times.reserve(capacity);
+          break;
+        case BYTES:
+        case ENUM:
+        case SET:
+        case DECIMAL:
+          column.offsets.reserve(capacity + 1);
+          column.offsets.push_back(0);
+          break;
+      }
+    }
+  }
+}
+
+namespace
+{
+  // Rows of a batch handed to each decoding thread at the least, smaller
+  // batches are decoded by the caller alone
+  const std::size_t k_min_rows_per_range = 1024;
+
+  // The threads decoding the row ranges of large batches, started on first
+  // use and kept until the process ends. The thread running the tasks takes
+  // part, so there is one thread less than the tasks run at once.
+  class Decode_pool
+  {
+  public:
+    static Decode_pool &get()
+    {
+      static Decode_pool pool;
+      return pool;
+    }
+
+    std::size_t size() const { return m_threads.size() + 1; }
+
+    // Runs the tasks and returns once all ended, rethrowing the first error
+    void run(std::vector<std::function<void()> > &tasks)
+    {
+      Job job;
+      job.pending = tasks.size();
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::size_t index = 1; index < tasks.size(); ++index)
+          m_queue.push_back(std::make_pair(&tasks[index], &job));
+      }
+      m_cond.notify_all();
+
+      execute(tasks[0], job);
+
+      // Helps with whatever is waiting, the tasks of this job left included
+      std::pair<std::function<void()> *, Job *> task;
+      while (pop(task, false))
+        execute(*task.first, *task.second);
+
+      std::unique_lock<std::mutex> lock(job.mutex);
+      job.done.wait(lock, [&]() { return job.pending == 0; });
+
+      if (job.error)
+        std::rethrow_exception(job.error);
+    }
+
+  private:
+    struct Job
+    {
+      std::mutex mutex;
+      std::condition_variable done;
+      std::size_t pending;
+      std::exception_ptr error;
+    };
+
+    Decode_pool() : m_stop(false)
+    {
+      unsigned threads = std::min(std::thread::hardware_concurrency(), 4u);
+      for (unsigned index = 1; index < threads; ++index)
+        m_threads.push_back(std::thread(&Decode_pool::work, this));
+    }
+
+    ~Decode_pool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_cond.notify_all();
+
+      for (auto &thread : m_threads)
+        thread.join();
+    }
+
+    bool pop(std::pair<std::function<void()> *, Job *> &task, bool wait)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (wait)
+        m_cond.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+
+      if (m_queue.empty())
+        return false;
+
+      task = m_queue.front();
+      m_queue.pop_front();
+      return true;
+    }
+
+    static void execute(std::function<void()> &task, Job &job)
+    {
+      std::exception_ptr error;
+      try
+      {
+        task();
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(job.mutex);
+      if (error && !job.error)
+        job.error = error;
+      if (--job.pending == 0)
+        job.done.notify_all();
+    }
+
+    void work()
+    {
+      std::pair<std::function<void()> *, Job *> task;
+      while (pop(task, true))
+        execute(*task.first, *task.second);
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::pair<std::function<void()> *, Job *> > m_queue;
+    bool m_stop;
+  };
+
+  void decode_rows(std::vector<Row_batch::Column> &columns, const Mysqlx::Resultset::Row *const *rows, std::size_t count)
+  {
+    // The rows are decoded one column at a time, integer columns are handed
+    // to the bulk varint decoders in a single call
+    std::vector<const std::string *> fields(count);
+
+    for (std::size_t index = 0; index < columns.size(); ++index)
+    {
+      Row_batch::Column &column = columns[index];
+
+      for (std::size_t row = 0; row < count; ++row)
+      {
+        fields[row] = &rows[row]->field(static_cast<int>(index));
+        column.nulls.push_back(fields[row]->empty() ? 1 : 0);
+      }
+
+      switch (column.type)
+      {
+        case SINT:
+        {
+          std::size_t offset = column.sints.size();
+          column.sints.resize(offset + count);
+          Row_decoder::s64_from_buffers(&fields[0], count, &column.sints[offset]);
+          continue;
+        }
+        case UINT:
+        case BIT:
+        {
+          std::size_t offset = column.uints.size();
+          column.uints.resize(offset + count);
+          Row_decoder::u64_from_buffers(&fields[0], count, &column.uints[offset]);
+          continue;
+        }
+        default:
+          break;
+      }
+
+      for (std::size_t row = 0; row < count; ++row)
+      {
+        const std::string &field_val = *fields[row];
+        bool is_null = field_val.empty();
+
+        switch (column.type)
+        {
+          case DOUBLE:
+            column.doubles.push_back(is_null ? 0 : Row_decoder::double_from_buffer(field_val));
+            break;
+          case FLOAT:
+            column.doubles.push_back(is_null ? 0 : Row_decoder::float_from_buffer(field_val));
+            break;
+          case DATETIME:
+            column.datetimes.push_back(is_null ? DateTime() : Row_decoder::datetime_from_buffer(field_val));
+            break;
+          case TIME:
+            column.times.push_back(is_null ? Time() : Row_decoder::time_from_buffer(field_val));
+            break;
+          case BYTES:
+          case ENUM:
+            if (!is_null)
+            {
+              std::size_t length;
+              const char *data = Row_decoder::string_from_buffer(field_val, length);
+              column.data.append(data, length);
+            }
+            column.offsets.push_back(column.data.size());
+            break;
+          case SET:
+            if (!is_null)
+              column.data.append(Row_decoder::set_from_buffer_as_str(field_val));
+            column.offsets.push_back(column.data.size());
+            break;
+          case DECIMAL:
+            if (!is_null)
+              Row_decoder::decimal_from_buffer_as_str(field_val, column.data);
+            column.offsets.push_back(column.data.size());
+            break;
+          default:
+            break;
+        }
+      }
+    }
+  }
+}
+
+void Row_batch::append(const Mysqlx::Resultset::Row *const *rows, std::size_t count)
+{
+  if (count == 0)
+    return;
+
+  Decode_pool &pool = Decode_pool::get();
+  std::size_t ranges = std::min(pool.size(), count / k_min_rows_per_range);
+  if (ranges < 2)
+  {
+    decode_rows(m_columns, rows, count);
+    m_size += count;
+    return;
+  }
+
+  // Large batches are split into row ranges decoded in parallel into
+  // columns of their own, then appended in order
+  std::vector<std::vector<Column> > parts(ranges);
+  std::vector<std::function<void()> > tasks;
+  std::size_t begin = 0;
+  for (std::size_t range = 0; range < ranges; ++range)
+  {
+    std::size_t end = count * (range + 1) / ranges;
+    std::vector<Column> &part = parts[range];
+
+    part.resize(m_columns.size());
+    for (std::size_t index = 0; index < m_columns.size(); ++index)
+    {
+      part[index].type = m_columns[index].type;
+      part[index].offsets.push_back(0);
+    }
+
+    tasks.push_back([&part, rows, begin, end]() { decode_rows(part, rows + begin, end - begin); });
+    begin = end;
+  }
+
+  pool.run(tasks);
+
+  for (std::size_t index = 0; index < m_columns.size(); ++index)
+  {
+    Column &column = m_columns[index];
+    for (auto &part : parts)
+    {
+      Column &decoded = part[index];
+      column.nulls.insert(column.nulls.end(), decoded.nulls.begin(), decoded.nulls.end());
+      column.sints.insert(column.sints.end(), decoded.sints.begin(), decoded.sints.end());
+      column.uints.insert(column.uints.end(), decoded.uints.begin(), decoded.uints.end());
+      column.doubles.insert(column.doubles.end(), decoded.doubles.begin(), decoded.doubles.end());
+      column.datetimes.insert(column.datetimes.end(), decoded.datetimes.begin(), decoded.datetimes.end());
+      column.times.insert(column.times.end(), decoded.times.begin(), decoded.times.end());
+
+      // The offsets of the range start at 0, past the data already appended
+      std::size_t base = column.data.size();
+      for (std::size_t row = 1; row < decoded.offsets.size(); ++row)
+        column.offsets.push_back(base + decoded.offsets[row]);
+      column.data.append(decoded.data);
+    }
+  }
+
+  m_size += count;
+}
+
+void Row_batch::check_row(std::size_t row, int field) const
+{
+  if (field < 0 || field >= (int)m_columns.size())
+    throw std::range_error("invalid field index");
+
+  if (row >= m_size)
+    throw std::range_error("invalid row index");
+}
+
+const Row_batch::Column &Row_batch::column(int field) const
+{
+  if (field < 0 || field >= (int)m_columns.size())
+    throw std::range_error("invalid field index");
+
+  return m_columns[field];
+}
+
+bool Row_batch::isNullField(std::size_t row, int field) const
+{
+  check_row(row, field);
+
+  return m_columns[field].nulls[row] != 0;
+}
+
+int64_t Row_batch::sInt64Field(std::size_t row, int field) const
+{
+  check_row(row, field);
+  if (m_columns[field].type != SINT)
+    throw std::range_error("invalid field type");
+
+  return m_columns[field].sints[row];
+}
+
+uint64_t Row_batch::uInt64Field(std::size_t row, int field) const
+{
+  check_row(row, field);
+  if (m_columns[field].type != UINT && m_columns[field].type != BIT)
+    throw std::range_error("invalid field type");
+
+  return m_columns[field].uints[row];
+}
+
+double Row_batch::doubleField(std::size_t row, int field) const
+{
+  check_row(row, field);
+  if (m_columns[field].type != DOUBLE && m_columns[field].type != FLOAT)
+    throw std::range_error("invalid field type");
+
+  return m_columns[field].doubles[row];
+}
+
+DateTime Row_batch::dateTimeField(std::size_t row, int field) const
+{
+  check_row(row, field);
+  if (m_columns[field].type != DATETIME)
+    throw std::range_error("invalid field type");
+
+  return m_columns[field].datetimes[row];
+}
+
+Time Row_batch::timeField(std::size_t row, int field) const
+{
+  check_row(row, field);
+  if (m_columns[field].type != TIME)
+    throw std::range_error("invalid field type");
+
+  return m_columns[field].times[row];
+}
+
+const char *Row_batch::stringField(std::size_t row, int field, std::size_t &rlength) const
+{
+  check_row(row, field);
+
+  const Column &column = m_columns[field];
+  if (column.offsets.empty())
+    throw std::range_error("invalid field type");
+
+  rlength = column.offsets[row + 1] - column.offsets[row];
+  return column.data.data() + column.offsets[row];
+}
+
+std::string Row_batch::stringField(std::size_t row, int field) const
+{
+  std::size_t length;
+  const char *data = stringField(row, field, length);
+
+  return std::string(data, length);
+}
+
+Row_pool::Row_pool(std::size_t max_cached, std::size_t max_row_size)
+  : m_max_cached(max_cached), m_max_row_size(max_row_size)
+{
+  m_free.reserve(max_cached);
+}
+
+Row_pool::~Row_pool()
+{
+  for (std::vector<Mysqlx::Resultset::Row*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+    delete *it;
+}
+
+Mysqlx::Resultset::Row *Row_pool::acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_free.empty())
+    {
+      Mysqlx::Resultset::Row *row = m_free.back();
+      m_free.pop_back();
+      return row;
+    }
+  }
+
+  return new Mysqlx::Resultset::Row();
+}
+
+void Row_pool::release(Mysqlx::Resultset::Row *row)
+{
+  // Rows holding big fields are not cached, their cleared strings would
+  // retain the memory of the largest value ever read through the pool
+  std::size_t size = 0;
+  for (int index = 0; index < row->field_size(); ++index)
+    size += row->field(index).capacity();
+
+  if (size <= m_max_row_size)
+  {
+    row->Clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_free.size() < m_max_cached)
+    {
+      m_free.push_back(row);
+      return;
+    }
+  }
+
+  delete row;
+}
+
+Row::Row(std::shared_ptr<std::vector<ColumnMetadata> > columns, Mysqlx::Resultset::Row *data,
+         std::shared_ptr<Row_pool> pool)
+  : m_columns(columns), m_data(data), m_pool(pool)
 {
 }
 
 Row::~Row()
 {
-  delete m_data;
+  if (m_pool)
+    m_pool->release(m_data);
+  else
+    delete m_data;
 }
 
 void Row::check_field(int field, FieldType type) const
@@ -1710,11 +3894,7 @@ uint64_t Row::bitField(int field) const
 std::string Row::stringField(int field) const
 {
   size_t length;
-  check_field(field, BYTES);
-
-  const std::string& field_val = m_data->field(field);
-
-  const char* res = Row_decoder::string_from_buffer(field_val, length);
+  const char* res = stringField(field, length);
   return std::string(res, length);
 }
 
@@ -1724,9 +3904,10 @@ std::string Row::decimalField(int field) const
 
   const std::string& field_val = m_data->field(field);
 
-  mysqlx::Decimal decimal = Row_decoder::decimal_from_buffer(field_val);
+  std::string decimal;
+  Row_decoder::decimal_from_buffer_as_str(field_val, decimal);
 
-  return std::string(decimal.str());
+  return decimal;
 }
 
 std::string Row::setFieldStr(int field) const
@@ -1752,11 +3933,7 @@ std::set<std::string> Row::setField(int field) const
 std::string Row::enumField(int field) const
 {
   size_t length;
-  check_field(field, ENUM);
-
-  const std::string& field_val = m_data->field(field);
-
-  const char* res = Row_decoder::string_from_buffer(field_val, length);
+  const char* res = enumField(field, length);
   return std::string(res, length);
 }
 
@@ -1769,6 +3946,15 @@ const char *Row::stringField(int field, size_t &rlength) const
   return Row_decoder::string_from_buffer(field_val, rlength);
 }
 
+const char *Row::enumField(int field, size_t &rlength) const
+{
+  check_field(field, ENUM);
+
+  const std::string& field_val = m_data->field(field);
+
+  return Row_decoder::string_from_buffer(field_val, rlength);
+}
+
 float Row::floatField(int field) const
 {
   check_field(field, FLOAT);
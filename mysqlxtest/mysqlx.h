@@ -23,11 +23,14 @@
 #ifndef _MYSQLX_CONNECTOR_H_
 #define _MYSQLX_CONNECTOR_H_
 
+#include <cstdio>
+#include <functional>
 #include <stdexcept>
 #include <vector>
 #include <map>
 #include <set>
 #include <memory>
+#include <mutex>
 
 #include "ngs_common/xdatetime.h"
 #include "mysqlx_common.h"
@@ -38,6 +41,10 @@ namespace Mysqlx
   {
     class Row;
   }
+  namespace Connection
+  {
+    class Capabilities;
+  }
 }
 
 namespace google { namespace protobuf { class Message; template <typename Element> class RepeatedPtrField; } }
@@ -68,6 +75,7 @@ namespace mysqlx
   class Schema;
   class Connection;
   struct Ssl_config;
+  struct Compression_config;
 
   class ArgumentValue
   {
@@ -206,6 +214,8 @@ namespace mysqlx
     } m_value;
   };
 
+  class Expr_cache;
+
   class Session : public std::enable_shared_from_this < Session >
   {
   public:
@@ -220,10 +230,14 @@ namespace mysqlx
 
     std::shared_ptr<Connection> connection() { return m_connection; }
 
+    // Parsed criteria of the CRUD statements created on this session
+    Expr_cache &expr_cache() { return *m_expr_cache; }
+
     void close();
   private:
     std::shared_ptr<Connection> m_connection;
     std::map<std::string, std::shared_ptr<Schema> > m_schemas;
+    std::shared_ptr<Expr_cache> m_expr_cache;
   };
   typedef std::shared_ptr<Session> SessionRef;
 
@@ -233,7 +247,10 @@ namespace mysqlx
                          const std::string &user, const std::string &pass,
                          const mysqlx::Ssl_config &ssl_config, const bool cap_expired_password, 
                          const std::size_t timeout,
-                         const std::string &auth_method = "MYSQL41", const bool get_caps = false);
+                         const std::string &auth_method = "MYSQL41", const bool get_caps = false,
+                         const mysqlx::Compression_config *compression = NULL,
+                         const std::string &local_socket = "",
+                         const Mysqlx::Connection::Capabilities *capabilities = NULL);
 
   enum FieldType
   {
@@ -275,6 +292,28 @@ namespace mysqlx
     uint32_t content_type;
   };
 
+  // Recycles Mysqlx::Resultset::Row messages between reads.
+  // A cleared protobuf message keeps the storage of its repeated fields, so
+  // in steady state parsing a row into a recycled message does not allocate.
+  class MYSQLXTEST_PUBLIC Row_pool
+  {
+  public:
+    Row_pool(std::size_t max_cached = 256, std::size_t max_row_size = 64 * 1024);
+    ~Row_pool();
+
+    Mysqlx::Resultset::Row *acquire();
+    void release(Mysqlx::Resultset::Row *row);
+
+  private:
+    Row_pool(const Row_pool &);
+    void operator=(const Row_pool &);
+
+    std::vector<Mysqlx::Resultset::Row *> m_free;
+    const std::size_t m_max_cached;
+    const std::size_t m_max_row_size;
+    std::mutex m_mutex;
+  };
+
   class Document
   {
   public:
@@ -309,7 +348,9 @@ namespace mysqlx
     std::string setFieldStr(int field) const;
     std::set<std::string> setField(int field) const;
     std::string enumField(int field) const;
+    // The data of the field in the received message, valid while the row is
     const char *stringField(int field, size_t &rlength) const;
+    const char *enumField(int field, size_t &rlength) const;
     float floatField(int field) const;
     double doubleField(int field) const;
     DateTime dateTimeField(int field) const;
@@ -319,28 +360,115 @@ namespace mysqlx
 
   private:
     friend class Result;
-    Row(std::shared_ptr<std::vector<ColumnMetadata> > columns, Mysqlx::Resultset::Row *data);
+    friend class Row_batch;
+    friend class ResultData;
+    Row(std::shared_ptr<std::vector<ColumnMetadata> > columns, Mysqlx::Resultset::Row *data,
+        std::shared_ptr<Row_pool> pool = std::shared_ptr<Row_pool>());
 
     void check_field(int field, FieldType type) const;
 
     std::shared_ptr<std::vector<ColumnMetadata> > m_columns;
     Mysqlx::Resultset::Row *m_data;
+    std::shared_ptr<Row_pool> m_pool;
   };
 
+  // A set of consecutive rows decoded into column major storage.
+  // Fixed width values are stored in one array per column, variable length
+  // values (BYTES, ENUM, SET and DECIMAL, the last two in their string form)
+  // are appended to a single buffer per column and located by offset.
+  // Null fields keep a default value on the arrays so row indexes match.
+  class MYSQLXTEST_PUBLIC Row_batch
+  {
+  public:
+    struct Column
+    {
+      FieldType type;
+      std::vector<uint8_t> nulls;
+      std::vector<int64_t> sints;        // SINT
+      std::vector<uint64_t> uints;       // UINT, BIT
+      std::vector<double> doubles;       // DOUBLE, FLOAT
+      std::vector<DateTime> datetimes;   // DATETIME
+      std::vector<Time> times;           // TIME
+      std::vector<std::size_t> offsets;  // BYTES, ENUM, SET, DECIMAL
+      std::string data;
+    };
+
+    Row_batch(std::shared_ptr<std::vector<ColumnMetadata> > columns, std::size_t capacity);
+
+    std::shared_ptr<std::vector<ColumnMetadata> > columnMetadata() const { return m_metadata; }
+    std::size_t size() const { return m_size; }
+    int numFields() const { return static_cast<int>(m_columns.size()); }
+    const Column &column(int field) const;
+
+    bool isNullField(std::size_t row, int field) const;
+    int64_t sInt64Field(std::size_t row, int field) const;
+    uint64_t uInt64Field(std::size_t row, int field) const;
+    double doubleField(std::size_t row, int field) const;
+    DateTime dateTimeField(std::size_t row, int field) const;
+    Time timeField(std::size_t row, int field) const;
+    const char *stringField(std::size_t row, int field, std::size_t &rlength) const;
+    std::string stringField(std::size_t row, int field) const;
+
+  private:
+    friend class Result;
+    void append(const Mysqlx::Resultset::Row *const *rows, std::size_t count);
+    void check_row(std::size_t row, int field) const;
+
+    std::shared_ptr<std::vector<ColumnMetadata> > m_metadata;
+    std::vector<Column> m_columns;
+    std::size_t m_size;
+  };
+
+  // Accounts the rows buffered results keep in memory: called with the size
+  // of every row before it is kept, the row goes to disk when it returns
+  // false, and with the negated total once the rows are released.
+  typedef std::function<bool(int64_t size)> Memory_accounting;
+
+  // The rows of a buffered data set. Once the rows kept in memory reach
+  // memory_limit bytes (0 is no limit) the following ones are appended to a
+  // temporary file as length prefixed protobuf messages, which is mapped in
+  // memory to read them back.
   class MYSQLXTEST_PUBLIC ResultData
   {
   public:
-    ResultData(std::shared_ptr<std::vector<ColumnMetadata> > columns);
+    ResultData(std::shared_ptr<std::vector<ColumnMetadata> > columns, std::size_t memory_limit = 0,
+               const Memory_accounting &accounting = Memory_accounting());
+    ~ResultData();
     std::shared_ptr<std::vector<ColumnMetadata> > columnMetadata(){ return m_columns; }
     void add_row(std::shared_ptr<Row> row);
     void rewind();
     void tell(size_t &record);
     void seek(size_t record);
     std::shared_ptr<Row> next();
+
+    size_t size() const { return m_rows.size() + m_spill_offsets.size(); }
+    bool spilled() const { return m_spill_file != NULL; }
+    std::size_t memory_size() const { return m_memory_size; }
+
+    // Another reader of the same rows, which must be on memory
+    std::shared_ptr<ResultData> clone() const;
+
   private:
+    ResultData(const ResultData &);
+    void operator=(const ResultData &);
+
+    void spill_row(const Row &row);
+    std::shared_ptr<Row> read_spilled_row(size_t index);
+    void unmap_spill();
+
     std::shared_ptr<std::vector<ColumnMetadata> > m_columns;
     std::vector<std::shared_ptr<Row> > m_rows;
     size_t m_row_index;
+
+    std::size_t m_memory_limit;
+    std::size_t m_memory_size;
+    Memory_accounting m_accounting;
+    std::size_t m_accounted_size;
+    FILE *m_spill_file;
+    std::vector<uint64_t> m_spill_offsets;
+    uint64_t m_spill_size;
+    const char *m_spill_mapping;
+    std::size_t m_spill_mapped_size;
   };
 
   class MYSQLXTEST_PUBLIC Result
@@ -354,15 +482,30 @@ namespace mysqlx
     const std::vector<std::string>& lastDocumentIds();
     int64_t affectedRows() const { return m_affected_rows; }
     std::string infoMessage() const { return m_info_message; }
+    // The rows returned by next() and next_batch() so far
+    uint64_t rowsRead() const { return m_rows_read; }
 
     bool ready();
     void wait();
 
     std::shared_ptr<Row> next();
+    // Reads up to max_rows rows from the current data set, returns NULL once
+    // there are no more rows
+    std::shared_ptr<Row_batch> next_batch(std::size_t max_rows);
     bool nextDataSet();
     void flush();
 
-    Result& buffer();
+    // Rows are read ahead by a thread of their own while the caller goes
+    // through the ones already read with next(), up to max_rows of them are
+    // kept waiting (0 reads as needed). Anything else done with the result
+    // or its connection stops the reading first. The warnings are complete
+    // once the rows were read.
+    void set_prefetch(std::size_t max_rows);
+
+    // Reads the rest of the result so it can be rewound, the rows past
+    // memory_limit bytes of each data set (0 is no limit), or refused by the
+    // accounting, are kept on disk
+    Result& buffer(std::size_t memory_limit = 0, const Memory_accounting &accounting = Memory_accounting());
 
     // Return true if the operation was successfully executed
     bool rewind();
@@ -373,6 +516,11 @@ namespace mysqlx
 
     void mark_error();
 
+    // Another reader of the buffered result, whose rows must be on memory
+    std::shared_ptr<Result> clone() const;
+    // The memory taken by the rows of the buffered result
+    std::size_t buffered_size() const;
+
     struct Warning
     {
       std::string text;
@@ -381,6 +529,10 @@ namespace mysqlx
     };
     const std::vector<Warning> &getWarnings() const { return m_warnings; }
     void setLastDocumentIDs(const std::vector<std::string>& document_ids);
+
+    // Accumulates the affected rows and warnings of other into this result,
+    // used when a statement is sent to the server in several messages
+    void merge(const Result &other);
   private:
     Result();
     Result(const Result &o);
@@ -390,9 +542,23 @@ namespace mysqlx
     std::shared_ptr<Row> read_row();
     void read_stmt_ok();
 
+    // The rows come from a cursor, see Connection::execute_cursor()
+    void set_cursor(uint32_t cursor_id, uint64_t fetch_rows) { m_cursor_id = cursor_id; m_cursor_fetch_rows = fetch_rows; }
+    void end_cursor();
+
     bool handle_notice(int32_t type, const std::string &data);
 
+    struct Prefetch;
+    void prefetch_rows();
+    Mysqlx::Resultset::Row *next_prefetched();
+    // Stops the reading thread, the rows read are kept for the next call
+    void pause_prefetch();
+    // Stops the reading thread and takes the rows read, dropped if rows is
+    // NULL
+    void end_prefetch(std::vector<Mysqlx::Resultset::Row *> *rows);
+
     int get_message_id();
+    void release_rows(const std::vector<Mysqlx::Resultset::Row *> &rows);
     mysqlx::Message* pop_message();
 
     mysqlx::Message* current_message;
@@ -400,10 +566,12 @@ namespace mysqlx
 
     friend class Connection;
     std::weak_ptr<Connection>m_owner;
+    std::shared_ptr<Row_pool> m_row_pool;
     std::shared_ptr<std::vector<ColumnMetadata> > m_columns;
     int64_t m_last_insert_id;
     std::vector<std::string> m_last_document_ids;
     int64_t m_affected_rows;
+    uint64_t m_rows_read;
     std::string m_info_message;
 
     std::vector<Warning> m_warnings;
@@ -411,6 +579,17 @@ namespace mysqlx
     std::vector<std::shared_ptr<ResultData> > m_result_cache;
     std::shared_ptr<ResultData> m_current_result;
     size_t m_result_index;
+    std::size_t m_buffer_memory_limit;
+    Memory_accounting m_buffer_accounting;
+    std::size_t m_prefetch_rows;
+    std::unique_ptr<Prefetch> m_prefetch;
+
+    // The open cursor, 0 if none. A suspended cursor is fetched from again
+    // when the next message is needed, unless the rows are being dropped
+    uint32_t m_cursor_id;
+    uint64_t m_cursor_fetch_rows;
+    bool m_cursor_suspended;
+    bool m_cursor_closing;
 
     enum {
       ReadStmtOkI, // initial state
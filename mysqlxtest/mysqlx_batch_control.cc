@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+#include "mysqlx_batch_control.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace mysqlx;
+
+namespace
+{
+  // ER_NET_PACKET_TOO_LARGE, ER_LOCK_WAIT_TIMEOUT and ER_LOCK_DEADLOCK
+  const int k_size_errors[] = { 1153, 1205, 1213 };
+
+  // Batches answered in time before one more is kept in flight
+  const std::size_t k_depth_period = 8;
+}
+
+Batch_control::Batch_control(std::size_t rows, std::size_t depth, const Batch_limits &limits)
+  : m_limits(limits), m_good_batches(0)
+{
+  m_rows = std::min(std::max(rows, m_limits.min_rows), m_limits.max_rows);
+  m_depth = std::min(std::max(depth, m_limits.min_depth), m_limits.max_depth);
+
+  // A tenth of the starting size, so it takes ten batches to double it
+  m_rows_step = std::max<std::size_t>(1, m_rows / 10);
+}
+
+std::size_t Batch_control::rows() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_rows;
+}
+
+std::size_t Batch_control::depth() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_depth;
+}
+
+void Batch_control::on_batch(std::chrono::steady_clock::duration latency)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (latency > m_limits.target_latency)
+  {
+    decrease();
+    return;
+  }
+
+  m_rows = std::min(m_rows + m_rows_step, m_limits.max_rows);
+
+  if (++m_good_batches >= k_depth_period)
+  {
+    m_good_batches = 0;
+    m_depth = std::min(m_depth + 1, m_limits.max_depth);
+  }
+}
+
+bool Batch_control::on_error(int error)
+{
+  if (!is_size_error(error))
+    return false;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  decrease();
+  return true;
+}
+
+bool Batch_control::is_size_error(int error)
+{
+  return std::find(std::begin(k_size_errors), std::end(k_size_errors), error) != std::end(k_size_errors);
+}
+
+std::string Batch_control::describe() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return "batch " + std::to_string(m_rows) + " rows x " + std::to_string(m_depth);
+}
+
+void Batch_control::decrease()
+{
+  m_rows = std::max(m_rows / 2, m_limits.min_rows);
+  m_depth = std::max(m_depth / 2, m_limits.min_depth);
+  m_good_batches = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_BATCH_CONTROL_H_
+#define _MYSQLX_BATCH_CONTROL_H_
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+namespace mysqlx
+{
+  // Bounds of the values chosen by a Batch_control
+  struct Batch_limits
+  {
+    Batch_limits()
+    {
+      min_rows = 1;
+      max_rows = 16000;
+      min_depth = 1;
+      max_depth = 16;
+      target_latency = std::chrono::milliseconds(500);
+    }
+
+    std::size_t min_rows;
+    std::size_t max_rows;
+    std::size_t min_depth;
+    std::size_t max_depth;
+    // Batches the server takes longer than this on are too big
+    std::chrono::milliseconds target_latency;
+  };
+
+  // Sizes the batches of a bulk insert and the number of them kept in
+  // flight from what the server does with them: both grow additively while
+  // the batches are answered within the target latency and are halved when
+  // one takes longer or fails with an error smaller batches avoid (lock wait
+  // timeouts, deadlocks and packets too large). A control is shared by all
+  // the sessions of an operation, each batch reads the current values.
+  class Batch_control
+  {
+  public:
+    Batch_control(std::size_t rows, std::size_t depth, const Batch_limits &limits = Batch_limits());
+
+    std::size_t rows() const;
+    std::size_t depth() const;
+
+    // The time the server took on a batch, since it got it
+    void on_batch(std::chrono::steady_clock::duration latency);
+
+    // A batch failed, returns whether the error was caused by its size
+    bool on_error(int error);
+
+    static bool is_size_error(int error);
+
+    // The current values for the progress output, as in "batch 1000 rows x 4"
+    std::string describe() const;
+
+  private:
+    void decrease();
+
+    mutable std::mutex m_mutex;
+    Batch_limits m_limits;
+    std::size_t m_rows;
+    std::size_t m_depth;
+    // Rows added on each batch answered in time
+    std::size_t m_rows_step;
+    // Batches answered in time since the depth last changed
+    std::size_t m_good_batches;
+  };
+} // namespace mysqlx
+
+#endif // _MYSQLX_BATCH_CONTROL_H_
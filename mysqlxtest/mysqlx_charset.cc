@@ -18,6 +18,10 @@
  */
 
 #include "mysqlx_charset.h"
+
+#include <unordered_map>
+#include <vector>
+
 using namespace mysqlx;
 
 const Charset::Charset_entry Charset::m_charsets_info[] = {
@@ -247,50 +251,49 @@ const Charset::Charset_entry Charset::m_charsets_info[] = {
 };
 
 
-std::string Charset::charset_name_from_id(uint32_t id)
+const char *Charset::charset_name_from_id(uint32_t id)
 {
-  return field_from_id(id, &Charset_entry::name);
+  if (id == 0)
+    return "";
+
+  const Charset_entry *entry = entry_from_id(id);
+  return entry ? entry->name : "?";
 }
 
-std::string Charset::collation_name_from_id(uint32_t id)
+const char *Charset::collation_name_from_id(uint32_t id)
 {
-  return field_from_id(id, &Charset_entry::collation);
+  if (id == 0)
+    return "";
+
+  const Charset_entry *entry = entry_from_id(id);
+  return entry ? entry->collation : "?";
 }
 
-std::string Charset::field_from_id(uint32_t id, std::string Charset_entry::*field)
+const Charset::Charset_entry *Charset::entry_from_id(uint32_t id)
 {
-  std::string result = (id == 0) ? "" : "?";
-
-  for (size_t i = 0;
-    i < sizeof(m_charsets_info) / sizeof(m_charsets_info[0]);
-    ++i)
-  {
-    if (m_charsets_info[i].id == id)
-    {
-      result = m_charsets_info[i].*field;
-      break;
-    }
-  }
+  // Looked up for every column of every result, so it is indexed by id
+  // rather than scanned, the ids on the table are all below 256
+  static const std::vector<const Charset_entry*> by_id = []() {
+    std::vector<const Charset_entry*> entries(256, NULL);
+    for (const Charset_entry &entry : m_charsets_info)
+      entries[entry.id] = &entry;
+    return entries;
+  }();
 
-  return result;
+  return id < by_id.size() ? by_id[id] : NULL;
 }
 
 uint32_t Charset::id_from_collation_name(const std::string& collation_name)
 {
-  uint32_t result = 0;
-
-  for (size_t i = 0;
-    i < sizeof(m_charsets_info) / sizeof(m_charsets_info[0]);
-    ++i)
-  {
-    if (m_charsets_info[i].collation == collation_name)
-    {
-      result = m_charsets_info[i].id;
-      break;
-    }
-  }
+  static const std::unordered_map<std::string, uint32_t> by_collation = []() {
+    std::unordered_map<std::string, uint32_t> ids;
+    for (const Charset_entry &entry : m_charsets_info)
+      ids.emplace(entry.collation, entry.id);
+    return ids;
+  }();
 
-  return result;
+  auto id = by_collation.find(collation_name);
+  return id == by_collation.end() ? 0 : id->second;
 }
 
 //--------------------------------------------------------------
@@ -25,24 +25,27 @@
 
 namespace mysqlx
 {
+  // The names are those of a static table, 0 has empty ones and the ids
+  // missing on the table have "?"
   class Charset
   {
   public:
-    static std::string charset_name_from_id(uint32_t id);
-    static std::string collation_name_from_id(uint32_t id);
+    static const char *charset_name_from_id(uint32_t id);
+    static const char *collation_name_from_id(uint32_t id);
+    // 0 if the collation is unknown
     static uint32_t id_from_collation_name(const std::string& collation_name);
 
   private:
 
     typedef struct {
       uint32_t id;
-      std::string name;
-      std::string collation;
+      const char *name;
+      const char *collation;
     } Charset_entry;
 
     static const Charset_entry  m_charsets_info[];
 
-    static std::string field_from_id(uint32_t id, std::string Charset_entry::*field);
+    static const Charset_entry *entry_from_id(uint32_t id);
   };
 }
 
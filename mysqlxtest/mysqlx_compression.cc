@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mysqlx_compression.h"
+#include "mysqlx.pb.h"
+
+#include <algorithm>
+#include <stdint.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace mysqlx;
+
+namespace
+{
+#ifdef HAVE_ZLIB
+  // A single zlib stream spanning all the messages, each one ends at a sync
+  // flush point so it decompresses completely on arrival
+  class Deflate_stream_decompressor : public Decompressor
+  {
+  public:
+    Deflate_stream_decompressor()
+    : m_valid(false)
+    {
+      m_stream.zalloc = Z_NULL;
+      m_stream.zfree = Z_NULL;
+      m_stream.opaque = Z_NULL;
+      m_stream.next_in = Z_NULL;
+      m_stream.avail_in = 0;
+      m_valid = inflateInit(&m_stream) == Z_OK;
+    }
+
+    ~Deflate_stream_decompressor()
+    {
+      if (m_valid)
+        inflateEnd(&m_stream);
+    }
+
+    virtual bool decompress(const char *data, std::size_t length,
+                            std::vector<char> &out, std::size_t &out_end)
+    {
+      if (!m_valid)
+        return false;
+
+      m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+      m_stream.avail_in = static_cast<uInt>(length);
+
+      for (;;)
+      {
+        // The output grows at least by the compressed size each round
+        if (out.size() - out_end < std::max<std::size_t>(length, k_min_free))
+          out.resize(out_end + std::max<std::size_t>(length * 2, k_min_free));
+
+        m_stream.next_out = reinterpret_cast<Bytef*>(&out[out_end]);
+        m_stream.avail_out = static_cast<uInt>(out.size() - out_end);
+
+        int ret = inflate(&m_stream, Z_SYNC_FLUSH);
+        out_end = out.size() - m_stream.avail_out;
+
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+          return false;
+
+        // Done once the input is consumed and the output did not fill up
+        if (m_stream.avail_in == 0 && m_stream.avail_out != 0)
+          return true;
+
+        if (ret == Z_BUF_ERROR && m_stream.avail_out != 0)
+          return false;
+      }
+    }
+
+  private:
+    static const std::size_t k_min_free = 16 * 1024;
+
+    z_stream m_stream;
+    bool m_valid;
+  };
+
+  const std::size_t Deflate_stream_decompressor::k_min_free;
+#endif
+} // namespace
+
+Decompressor *Decompressor::create(const std::string &algorithm)
+{
+#ifdef HAVE_ZLIB
+  if (algorithm == "deflate_stream")
+    return new Deflate_stream_decompressor();
+#endif
+
+  return NULL;
+}
+
+std::vector<std::string> Decompressor::algorithms()
+{
+  std::vector<std::string> ret_val;
+
+#ifdef HAVE_ZLIB
+  ret_val.push_back("deflate_stream");
+#endif
+
+  return ret_val;
+}
+
+bool mysqlx::read_inflated_frame(const char *data, std::size_t length, int &mid, std::size_t &payload_length)
+{
+  const std::size_t header_length = 5;
+  if (length < header_length)
+    return false;
+
+  // The length is little endian and counts the message id
+  const unsigned char *header = reinterpret_cast<const unsigned char*>(data);
+  uint32_t frame_length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+  mid = header[4];
+
+  if (frame_length < 1 || frame_length - 1 > length - header_length || mid == Mysqlx::ServerMessages::COMPRESSION)
+    return false;
+
+  payload_length = frame_length - 1;
+  return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_COMPRESSION_H_
+#define _MYSQLX_COMPRESSION_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mysqlx
+{
+  // Decodes the payloads of the Compression messages sent by the server.
+  // Stream algorithms keep their state from one message to the next, so a
+  // decompressor lives as long as the connection it was agreed on.
+  class Decompressor
+  {
+  public:
+    virtual ~Decompressor() {}
+
+    // Appends the uncompressed data to out from out_end, growing it as
+    // needed and moving out_end past the data. Returns false if the data is
+    // corrupt
+    virtual bool decompress(const char *data, std::size_t length,
+                            std::vector<char> &out, std::size_t &out_end) = 0;
+
+    // NULL if the algorithm is not supported by this build
+    static Decompressor *create(const std::string &algorithm);
+
+    // Names of the algorithms this build decompresses, most preferred first
+    static std::vector<std::string> algorithms();
+  };
+
+  // Reads the header of the frame at the start of the uncompressed data of
+  // Compression messages. Returns false if the header or the payload is
+  // truncated or the frame is another Compression message.
+  bool read_inflated_frame(const char *data, std::size_t length, int &mid, std::size_t &payload_length);
+} // namespace mysqlx
+
+#endif // _MYSQLX_COMPRESSION_H_
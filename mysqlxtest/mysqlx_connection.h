@@ -35,11 +35,14 @@
 #include "mysqlx.pb.h"
 #include "mysqlx_connection.pb.h"
 #include "mysqlx_crud.pb.h"
+#include "mysqlx_cursor.pb.h"
 #include "mysqlx_datatypes.pb.h"
 #include "mysqlx_expr.pb.h"
 #include "mysqlx_expect.pb.h"
+#include "mysqlx_prepare.pb.h"
 #include "mysqlx_session.pb.h"
 #include "mysqlx_sql.pb.h"
+#include "mysqlx_result_cache.h"
 #include "mysqlx.h"
 
 #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
@@ -50,16 +53,23 @@
 
 #include <boost/asio.hpp>
 #include <boost/function.hpp>
+#include <algorithm>
 #include <list>
+#include <map>
+#include <set>
+#include <vector>
 
 #include "mysqlx_sync_connection.h"
+#include "mysqlx_compression.h"
 #include "mysqlx_common.h"
+#include "mysqlx_trace.h"
 #include "mysql.h"
 
 #define CR_UNKNOWN_ERROR        2000
 #define CR_CONNECTION_ERROR     2002
 #define CR_UNKNOWN_HOST         2005
 #define CR_SERVER_GONE_ERROR    2006
+#define CR_OUT_OF_MEMORY        2008
 #define CR_WRONG_HOST_INFO      2009
 #define CR_COMMANDS_OUT_OF_SYNC 2014
 #define CR_SSL_CONNECTION_ERROR 2026
@@ -97,6 +107,109 @@ namespace mysqlx
     int mode;
   };
 
+  // Sizing of the connection buffers: the receive buffer grows in pages of
+  // page_size bytes and the receive and send buffers together may not go
+  // past memory_limit bytes, 0 meaning unlimited
+  struct Buffer_config
+  {
+    Buffer_config()
+    {
+      page_size = 64 * 1024;
+      memory_limit = 0;
+    }
+
+    std::size_t page_size;
+    std::size_t memory_limit;
+  };
+
+  // Compression of the messages sent by the server, agreed on with the
+  // compression capability before authenticating
+  struct Compression_config
+  {
+    Compression_config()
+    {
+      level = -1;
+    }
+
+    // Empty for no compression, "auto" picks the first algorithm supported
+    // by both sides
+    std::string algorithm;
+    // Level the server compresses with, -1 for its default
+    int level;
+  };
+
+  // Memory held by the connection buffers, the most it ever held and the
+  // times a buffer could not grow, either for the limit or bad_alloc
+  struct Buffer_stats
+  {
+    Buffer_stats()
+    {
+      in_use = 0;
+      high_water = 0;
+      allocation_failures = 0;
+    }
+
+    std::size_t in_use;
+    std::size_t high_water;
+    uint64_t allocation_failures;
+  };
+
+  // Traffic of the connection, always counted, so a slow client shows
+  // without a profiler. The frames sent are counted by their client message
+  // type and the ones received by their server type, the frames inside a
+  // Compression message included. Times are in microseconds
+  struct Protocol_stats
+  {
+    // Types past the last slot are counted on it
+    enum { k_message_types = 64 };
+
+    struct Traffic
+    {
+      Traffic() : frames(0), bytes(0) {}
+
+      uint64_t frames;
+      uint64_t bytes;
+    };
+
+    Protocol_stats()
+    {
+      notices = 0;
+      recv_wait_time = 0;
+      decode_time = 0;
+      rows_buffered = 0;
+    }
+
+    static int slot(int mid) { return std::min(std::max(mid, 0), static_cast<int>(k_message_types) - 1); }
+
+    Traffic sent[k_message_types];
+    Traffic received[k_message_types];
+    uint64_t notices;
+    // Blocked reading the socket, and parsing the payloads received
+    uint64_t recv_wait_time;
+    uint64_t decode_time;
+    // Rows read into the buffer of a result rather than by the caller
+    uint64_t rows_buffered;
+  };
+
+  // The rows of a result flushed or dropped before being read are read and
+  // dropped. Past max_rows rows or max_bytes bytes of them (0 is no limit)
+  // the statement is cancelled through cancel, which is expected to kill
+  // the query from another connection, so the rest of the rows is never
+  // sent. It is only done while no other statement is pending on the
+  // connection, so the kill can not hit the wrong one
+  struct Discard_policy
+  {
+    Discard_policy()
+    {
+      max_rows = 0;
+      max_bytes = 0;
+    }
+
+    uint64_t max_rows;
+    uint64_t max_bytes;
+    boost::function<void()> cancel;
+  };
+
   class MYSQLXTEST_PUBLIC Connection : public std::enable_shared_from_this<Connection>
   {
   public:
@@ -105,27 +218,53 @@ namespace mysqlx
 
     uint64_t client_id() const { return m_client_id; }
     const Mysqlx::Connection::Capabilities &capabilities() const { return m_capabilities; }
+    void set_capabilities(const Mysqlx::Connection::Capabilities &capabilities) { m_capabilities = capabilities; }
 
     void push_local_notice_handler(Local_notice_handler handler);
     void pop_local_notice_handler();
 
     void connect(const std::string &uri, const std::string &pass, const bool cap_expired_password = false); //XXX capabilities flags
+    // The host may also be a list of host[:port] entries separated by
+    // commas, those without port use the given one. The addresses of all
+    // of them are raced and the first one accepting the connection is used
     void connect(const std::string &host, int port, const bool cap_expired_password = false);
 
+    // The Unix socket of a local server, tried by connect() before TCP.
+    // It is cleared when the connection can not go through it.
+    void set_local_socket(const std::string &path) { m_local_socket = path; }
+    const std::string &local_socket() const { return m_local_socket; }
+
     void close();
     void set_closed();
     bool is_closed() const { return m_closed; }
 
+    // Clears the state of the session on the server with Session.Reset:
+    // transactions, variables, temporary tables and the current schema go
+    // away while the connection, its TLS and its capabilities are kept.
+    // The server takes the session back to authentication after the reset,
+    // so it is authenticated again with the given credentials.
+    void reset_session(const std::string &user, const std::string &pass, const std::string &schema,
+                       const std::string &auth_method = "MYSQL41");
+
     void enable_tls();
+    // Compression is negotiated by authenticate(), so it must be configured
+    // before
+    void set_compression(const Compression_config &config) { m_compression_config = config; }
 
+    // The messages sent are queued and written together when the
+    // connection reads from the server, the queue gets big or flush() is
+    // called, so a pipeline of statements goes out in a single write
     void send(int mid, const Message &msg);
+    // Sends a message already serialized
+    void send(int mid, const std::string &payload);
+    void flush();
     Message *recv_next(int &mid);
 
     Message *recv_raw(int &mid);
     Message *recv_payload(const int mid, const std::size_t msglen);
     Message *recv_raw_with_deadline(int &mid, const std::size_t deadline_miliseconds);
 
-    std::shared_ptr<Result> recv_result();
+    std::shared_ptr<Result> recv_result(bool expect_data = true);
 
     // Overrides for Client Session Messages
     void send(const Mysqlx::Session::AuthenticateStart &m) { send(Mysqlx::ClientMessages::SESS_AUTHENTICATE_START, m); };
@@ -142,6 +281,13 @@ namespace mysqlx
     void send(const Mysqlx::Crud::Update &m) { send(Mysqlx::ClientMessages::CRUD_UPDATE, m); };
     void send(const Mysqlx::Crud::Delete &m) { send(Mysqlx::ClientMessages::CRUD_DELETE, m); };
 
+    // Overrides for prepared statements and cursors
+    void send(const Mysqlx::Prepare::Prepare &m) { send(Mysqlx::ClientMessages::PREPARE_PREPARE, m); };
+    void send(const Mysqlx::Prepare::Deallocate &m) { send(Mysqlx::ClientMessages::PREPARE_DEALLOCATE, m); };
+    void send(const Mysqlx::Cursor::Open &m) { send(Mysqlx::ClientMessages::CURSOR_OPEN, m); };
+    void send(const Mysqlx::Cursor::Fetch &m) { send(Mysqlx::ClientMessages::CURSOR_FETCH, m); };
+    void send(const Mysqlx::Cursor::Close &m) { send(Mysqlx::ClientMessages::CURSOR_CLOSE, m); };
+
     // Overrides for Connection
     void send(const Mysqlx::Connection::CapabilitiesGet &m) { send(Mysqlx::ClientMessages::CON_CAPABILITIES_GET, m); };
     void send(const Mysqlx::Connection::CapabilitiesSet &m) { send(Mysqlx::ClientMessages::CON_CAPABILITIES_SET, m); };
@@ -150,9 +296,39 @@ namespace mysqlx
     //    boost::asio::ip::tcp::socket &socket() { return m_socket; }
   public:
     std::shared_ptr<Result> execute_sql(const std::string &sql);
+    // Sends the statement without waiting for its result, which must be
+    // later retrieved with recv_result() in the same order it was sent
+    void send_sql(const std::string &sql);
     std::shared_ptr<Result> execute_stmt(const std::string &ns, const std::string &sql, const std::vector<ArgumentValue> &args);
 
+    // Asynchronous execution: the statement is sent and the returned ticket
+    // retrieves its result later with recv_async_result(). The results are
+    // read in the order the statements were sent, so the ones before the
+    // requested result are buffered, and any other execution on the
+    // connection reads the pending results first. A server error is thrown
+    // when the result of the failed statement is retrieved
+    uint64_t send_stmt_async(const std::string &ns, const std::string &sql, const std::vector<ArgumentValue> &args);
+    std::shared_ptr<Result> recv_async_result(uint64_t ticket);
+    // The result of the ticket is not going to be retrieved
+    void discard_async_result(uint64_t ticket);
+    // Whether the result of the ticket was already read from the server
+    bool async_result_read(uint64_t ticket) const { return ticket <= m_async_read; }
+
+    std::shared_ptr<Result> execute_serialized(int mid, const std::string &payload, bool expect_data);
+
+    // Sends the statements, given as message id and serialized payload, in
+    // a single write and reads their results, which are buffered. When
+    // atomic they run in a transaction inside an Expect block with the
+    // no_error condition, so the server skips the ones after the first
+    // failure and the transaction is rolled back. The first error is thrown
+    // once every reply was read
+    std::vector<std::shared_ptr<Result> > execute_batch(const std::vector<std::pair<int, std::string> > &statements, bool atomic);
     std::shared_ptr<Result> execute_find(const Mysqlx::Crud::Find &m);
+    // Executes the serialized find through a server side cursor, the rows
+    // are sent fetch_rows at a time and the next ones are asked for once
+    // the result runs out of them. On servers without cursors the find is
+    // executed as execute_serialized() does
+    std::shared_ptr<Result> execute_cursor(const std::string &payload, uint64_t fetch_rows);
     std::shared_ptr<Result> execute_update(const Mysqlx::Crud::Update &m);
     std::shared_ptr<Result> execute_insert(const Mysqlx::Crud::Insert &m);
     std::shared_ptr<Result> execute_delete(const Mysqlx::Crud::Delete &m);
@@ -160,6 +336,7 @@ namespace mysqlx
     void fetch_capabilities();
     void setup_capability(const std::string &name, const bool value);
     void setup_capability(const std::string &name, const bool value, int& out_error, std::string &out_error_msg, bool should_throw = false);
+    void setup_capability(const std::string &name, const Mysqlx::Datatypes::Any &value, int& out_error, std::string &out_error_msg, bool should_throw = false);
 
     void authenticate(const std::string &user, const std::string &pass, const std::string &schema,
       int ssl_mode = SSL_MODE_PREFERRED, const std::string& auth_method = "MYSQL41");
@@ -172,16 +349,64 @@ namespace mysqlx
 
     bool expired_account() { return m_account_expired; }
     std::shared_ptr<Result> new_empty_result();
+
+    std::shared_ptr<Row_pool> row_pool() const { return m_row_pool; }
+
+    void set_buffer_config(const Buffer_config &config);
+    const Buffer_config &buffer_config() const { return m_buffer_config; }
+    const Buffer_stats &buffer_stats() const { return m_buffer_stats; }
+    const Protocol_stats &protocol_stats() const { return m_protocol_stats; }
+
+    void set_discard_policy(const Discard_policy &policy) { m_discard_policy = policy; }
+    const Discard_policy &discard_policy() const { return m_discard_policy; }
+    // Statements sent whose result did not end yet
+    uint64_t statements_pending() const;
+
+    // The rows the results read ahead, see Result::set_prefetch()
+    void set_result_prefetch(std::size_t max_rows) { m_result_prefetch = max_rows; }
+
+    // Keeps the results of the read only statements executed, see
+    // Result_cache. The cached results are read completely when executed
+    void set_result_cache(const Result_cache_config &config);
+    Result_cache_stats result_cache_stats() const;
   private:
+    friend class Result;
+
     void perform_close();
     void dispatch_notice(Mysqlx::Notice::Frame *frame);
     Message *recv_message_with_header(int &mid, char(&header_buffer)[5], const std::size_t header_offset);
+    Message *parse_message(const int mid, const char *mbuf, const std::size_t msglen);
+    Message *recv_inflated(int &mid);
+    void inflate_frames(const Mysqlx::Connection::Compression &compression);
+    void negotiate_compression();
+    boost::system::error_code fill_recv_buffer(const std::size_t length);
     void throw_mysqlx_error(const boost::system::error_code &ec);
+    void queue_frame_header(int mid, std::size_t payload_size);
+    void check_buffer_memory(std::size_t recv_size, std::size_t send_size);
+    void reserve_send_buffer(std::size_t frame_size);
+    void update_buffer_stats();
     std::shared_ptr<Result> new_result(bool expect_data);
+    std::shared_ptr<Result> create_result(bool expect_data);
+    // Reads the rest of the last result, buffered if someone still holds it
+    void end_last_result();
+    // The result of the message from the cache, or executed and cached
+    std::shared_ptr<Result> execute_cached(int mid, const std::string &payload, const std::string &schema);
+    void read_async_results(uint64_t last_ticket);
+    // The last result may be reading rows ahead, which is stopped before
+    // the connection is used for anything else
+    void pause_read_ahead();
+    // Reads the Ok replying a prepare or cursor message, false if the server
+    // does not know the message
+    bool read_ok(const char *request);
+    void fetch_cursor(uint32_t cursor_id, uint64_t fetch_rows);
+    // Closes the cursor and deallocates its statement, ignoring the errors
+    void close_cursor(uint32_t cursor_id);
 
   private:
     typedef boost::asio::ip::tcp tcp;
 
+    std::vector<tcp::endpoint> resolve_hosts(const std::string &hosts, int port);
+
     std::list<Local_notice_handler> m_local_notice_handlers;
     Mysqlx::Connection::Capabilities m_capabilities;
 
@@ -191,9 +416,58 @@ namespace mysqlx
     uint64_t m_client_id;
     bool m_account_expired;
     bool m_trace_packets;
+    // Binary trace file the frames are recorded to, if one was opened
+    std::shared_ptr<Protocol_trace> m_trace_file;
     bool m_closed;
     const bool m_dont_wait_for_disconnect;
+    const std::size_t m_connect_timeout;
+    std::string m_local_socket;
     std::shared_ptr<Result> m_last_result;
+
+    // Tickets of the last asynchronous statement sent and read, and the
+    // results read before being retrieved, or the error they got
+    struct Async_result
+    {
+      std::shared_ptr<Result> result;
+      std::shared_ptr<Error> error;
+    };
+    uint64_t m_async_sent;
+    uint64_t m_async_read;
+    std::map<uint64_t, Async_result> m_async_results;
+    std::set<uint64_t> m_discarded_results;
+
+    // Receive buffer the socket is read into as much as is available, the
+    // frames are parsed from it so a stream of small ones is read with a
+    // single syscall, and the pool of row messages the payloads of
+    // RESULTSET_ROW frames are parsed into
+    std::vector<char> m_recv_buffer;
+    std::size_t m_recv_begin;
+    std::size_t m_recv_end;
+
+    // Frames queued to be sent
+    std::string m_send_buffer;
+    std::unique_ptr<Result_cache> m_result_cache;
+    std::shared_ptr<Row_pool> m_row_pool;
+
+    Buffer_config m_buffer_config;
+    Buffer_stats m_buffer_stats;
+    Protocol_stats m_protocol_stats;
+    Discard_policy m_discard_policy;
+    // Counted by the results, as they read the end of their statement
+    uint64_t m_statements_ended;
+    std::size_t m_result_prefetch;
+    // Cleared once the server refused a prepare message. Each cursor has the
+    // id of its prepared statement
+    bool m_cursors_supported;
+    uint32_t m_last_cursor_id;
+
+    // Frames uncompressed from the Compression messages, served before
+    // reading from the socket again
+    Compression_config m_compression_config;
+    std::shared_ptr<Decompressor> m_decompressor;
+    std::vector<char> m_inflated_buffer;
+    std::size_t m_inflated_begin;
+    std::size_t m_inflated_end;
   };
 
   typedef std::shared_ptr<Connection> ConnectionRef;
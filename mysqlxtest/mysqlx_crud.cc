@@ -19,12 +19,21 @@
 
 #include "mysqlx_crud.h"
 #include "mysqlx_connection.h"
+#include "mysqlx_batch_control.h"
 #include "ngs_common/protocol_protobuf.h"
 
 #include "mysqlx_parser.h"
+#include "expr_cache.h"
+#include "sql_generator.h"
 
 #include "compilerutils.h"
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <stdexcept>
 
 #define CONTENT_TYPE_GEOMETRY 0x0001
 #define CONTENT_TYPE_JSON 0x0002
@@ -32,6 +41,21 @@
 
 using namespace mysqlx;
 
+namespace
+{
+  // Criteria are parsed through the cache of the session, if still open
+  Mysqlx::Expr::Expr *parse_filter(std::shared_ptr<Schema> schema, const std::string &source, bool document_mode,
+                                   std::vector<std::string> *placeholders)
+  {
+    std::shared_ptr<Session> session = schema ? schema->session() : std::shared_ptr<Session>();
+    if (session)
+      return session->expr_cache().parse_filter(source, document_mode, placeholders);
+
+    Expr_parser parser(source, document_mode, false, placeholders);
+    return parser.expr();
+  }
+}
+
 Schema::Schema(std::shared_ptr<Session> conn, const std::string &name_)
   : m_sess(conn), m_name(name_)
 {
@@ -111,8 +135,14 @@ RemoveStatement Collection::remove(const std::string &searchCondition)
   return tmp;
 }
 
+Statement::Statement() :
+m_serialized(new Serialized_message())
+{
+  m_serialized->message = NULL;
+}
+
 Statement::Statement(const Statement& other) :
-m_placeholders(other.m_placeholders), m_bound_values(other.m_bound_values)
+m_placeholders(other.m_placeholders), m_bound_values(other.m_bound_values), m_serialized(other.m_serialized)
 {
 }
 
@@ -120,13 +150,48 @@ Statement::~Statement()
 {
 }
 
+int Statement::message(std::string &)
+{
+  throw std::logic_error("The statement can only be executed on its own");
+}
+
+std::string Statement::sql()
+{
+  std::string payload;
+  int mid = message(payload);
+
+  switch (mid)
+  {
+    case Mysqlx::ClientMessages::CRUD_FIND:
+    {
+      Mysqlx::Crud::Find find;
+      find.ParseFromString(payload);
+      return Sql_generator::find(find);
+    }
+    case Mysqlx::ClientMessages::CRUD_UPDATE:
+    {
+      Mysqlx::Crud::Update update;
+      update.ParseFromString(payload);
+      return Sql_generator::update(update);
+    }
+    case Mysqlx::ClientMessages::CRUD_DELETE:
+    {
+      Mysqlx::Crud::Delete remove;
+      remove.ParseFromString(payload);
+      return Sql_generator::remove(remove);
+    }
+  }
+
+  throw std::logic_error("Only find, update and delete statements have an SQL to explain");
+}
+
 void Statement::init_bound_values()
 {
   // Initializes the bound values array on the first call to bind
   if (!m_bound_values.size())
   {
     for (size_t index = 0; index < m_placeholders.size(); index++)
-      m_bound_values.push_back(NULL);
+      m_bound_values.push_back(std::string());
   }
 }
 
@@ -138,7 +203,35 @@ void Statement::validate_bind_placeholder(const std::string& name)
     throw std::logic_error("Unable to bind value for unexisting placeholder: " + name);
 }
 
-void Statement::insert_bound_values(::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar >* target)
+void Statement::set_bound_value(const std::string& name, Mysqlx::Datatypes::Scalar *value)
+{
+  std::unique_ptr<Mysqlx::Datatypes::Scalar> scalar(value);
+
+  // The value is encoded right away, the executions only copy it
+  std::vector<std::string>::iterator index = std::find(m_placeholders.begin(), m_placeholders.end(), name);
+  scalar->SerializeToString(&m_bound_values[index - m_placeholders.begin()]);
+}
+
+void Statement::message_changed()
+{
+  m_serialized->message = NULL;
+  m_serialized->data.clear();
+}
+
+namespace
+{
+  void append_varint(std::string &target, uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      target.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    target.push_back(static_cast<char>(value));
+  }
+}
+
+std::string Statement::serialize(::google::protobuf::Message &message, int args_field_number, const char *statement_name)
 {
   // First validates that all the placeholders have a bound value
   std::string str_undefined;
@@ -149,7 +242,7 @@ void Statement::insert_bound_values(::google::protobuf::RepeatedPtrField< ::Mysq
     std::vector<std::string> undefined;
     for (size_t index = 0; index < m_bound_values.size(); index++)
     {
-      if (!m_bound_values[index])
+      if (m_bound_values[index].empty())
         undefined.push_back(m_placeholders[index]);
     }
 
@@ -160,11 +253,26 @@ void Statement::insert_bound_values(::google::protobuf::RepeatedPtrField< ::Mysq
   if (!str_undefined.empty())
     throw std::logic_error("Missing value bindings for the next placeholders: " + str_undefined);
 
-  // No errors, proceeds to set the values if any
-  target->Clear();
-  std::vector<Mysqlx::Datatypes::Scalar*>::const_iterator index, end = m_bound_values.end();
-  for (index = m_bound_values.begin(); index != end; index++)
-    target->AddAllocated(*index);
+  if (m_serialized->message != &message)
+  {
+    if (!message.IsInitialized())
+      throw std::logic_error(std::string(statement_name) + " is not completely initialized: " + message.InitializationErrorString());
+
+    message.SerializeToString(&m_serialized->data);
+    m_serialized->message = &message;
+  }
+
+  // The arguments are a repeated field, which is valid after the rest of
+  // fields of the message as well
+  std::string payload(m_serialized->data);
+  for (std::vector<std::string>::const_iterator index = m_bound_values.begin(); index != m_bound_values.end(); ++index)
+  {
+    append_varint(payload, (static_cast<uint32_t>(args_field_number) << 3) | 2);
+    append_varint(payload, index->size());
+    payload.append(*index);
+  }
+
+  return payload;
 }
 
 Collection_Statement::Collection_Statement(std::shared_ptr<Collection> coll)
@@ -184,12 +292,129 @@ Collection_Statement &Collection_Statement::bind(const std::string &name, const
   validate_bind_placeholder(name);
 
   // Now sets the right value on the position of the indicated placeholder
+  set_bound_value(name, convert_document_value(value));
+
+  // A list bound before is replaced by the placeholder again
+  uint32_t position = static_cast<uint32_t>(std::find(m_placeholders.begin(), m_placeholders.end(), name) - m_placeholders.begin());
+  if (m_bound_lists.erase(position))
+    expand_lists();
+
+  return *this;
+}
+
+namespace
+{
+  // Calls the function with the IN operators of the expression whose list
+  // is a single placeholder
+  void for_each_list_placeholder(Mysqlx::Expr::Expr &expr, const std::function<void(Mysqlx::Expr::Operator &)> &function)
+  {
+    switch (expr.type())
+    {
+      case Mysqlx::Expr::Expr::OPERATOR:
+      {
+        Mysqlx::Expr::Operator *op = expr.mutable_operator_();
+        if (op->name() == "in" && op->param_size() == 2 && op->param(1).type() == Mysqlx::Expr::Expr::PLACEHOLDER)
+          function(*op);
+        else
+        {
+          for (int index = 0; index < op->param_size(); index++)
+            for_each_list_placeholder(*op->mutable_param(index), function);
+        }
+        break;
+      }
+      case Mysqlx::Expr::Expr::FUNC_CALL:
+        for (int index = 0; index < expr.function_call().param_size(); index++)
+          for_each_list_placeholder(*expr.mutable_function_call()->mutable_param(index), function);
+        break;
+      case Mysqlx::Expr::Expr::OBJECT:
+        for (int index = 0; index < expr.object().fld_size(); index++)
+          for_each_list_placeholder(*expr.mutable_object()->mutable_fld(index)->mutable_value(), function);
+        break;
+      case Mysqlx::Expr::Expr::ARRAY:
+        for (int index = 0; index < expr.array().value_size(); index++)
+          for_each_list_placeholder(*expr.mutable_array()->mutable_value(index), function);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+bool Collection_Statement::isListPlaceholder(const std::string &name)
+{
   std::vector<std::string>::iterator index = std::find(m_placeholders.begin(), m_placeholders.end(), name);
-  m_bound_values[index - m_placeholders.begin()] = convert_document_value(value);
+  Mysqlx::Expr::Expr *expr = m_parsed_criteria ? m_parsed_criteria.get() : criteria();
+  if (index == m_placeholders.end() || !expr)
+    return false;
+
+  uint32_t position = static_cast<uint32_t>(index - m_placeholders.begin());
+  bool found = false;
+  for_each_list_placeholder(*expr, [position, &found](Mysqlx::Expr::Operator &op)
+  {
+    if (op.param(1).position() == position)
+      found = true;
+  });
+
+  return found;
+}
+
+Collection_Statement &Collection_Statement::bind(const std::string &name, const std::vector<DocumentValue> &values)
+{
+  init_bound_values();
+
+  validate_bind_placeholder(name);
+
+  if (!isListPlaceholder(name))
+    throw std::logic_error("Unable to bind a list of values to placeholder: " + name + ", it must be the list of an IN operator");
+
+  if (values.empty())
+    throw std::logic_error("Unable to bind an empty list of values to placeholder: " + name);
+
+  if (!m_parsed_criteria)
+    m_parsed_criteria.reset(new Mysqlx::Expr::Expr(*criteria()));
+
+  uint32_t position = static_cast<uint32_t>(std::find(m_placeholders.begin(), m_placeholders.end(), name) - m_placeholders.begin());
+  std::vector<std::shared_ptr<Mysqlx::Datatypes::Scalar> > &list = m_bound_lists[position];
+  list.clear();
+  for (std::vector<DocumentValue>::const_iterator value = values.begin(); value != values.end(); ++value)
+    list.push_back(std::shared_ptr<Mysqlx::Datatypes::Scalar>(convert_document_value(*value)));
+
+  // The placeholder is no longer in the criteria, but the server expects a
+  // value on every position
+  Mysqlx::Datatypes::Scalar *unused = new Mysqlx::Datatypes::Scalar();
+  unused->set_type(Mysqlx::Datatypes::Scalar::V_NULL);
+  set_bound_value(name, unused);
+
+  expand_lists();
 
   return *this;
 }
 
+void Collection_Statement::expand_lists()
+{
+  if (!m_parsed_criteria)
+    return;
+
+  message_changed();
+
+  Mysqlx::Expr::Expr *expr = criteria();
+  expr->CopyFrom(*m_parsed_criteria);
+  for_each_list_placeholder(*expr, [this](Mysqlx::Expr::Operator &op)
+  {
+    std::map<uint32_t, std::vector<std::shared_ptr<Mysqlx::Datatypes::Scalar> > >::const_iterator list = m_bound_lists.find(op.param(1).position());
+    if (list == m_bound_lists.end())
+      return;
+
+    op.mutable_param()->RemoveLast();
+    for (size_t index = 0; index < list->second.size(); index++)
+    {
+      Mysqlx::Expr::Expr *item = op.add_param();
+      item->set_type(Mysqlx::Expr::Expr::LITERAL);
+      item->mutable_literal()->CopyFrom(*list->second[index]);
+    }
+  });
+}
+
 Mysqlx::Datatypes::Scalar* Collection_Statement::convert_document_value(const DocumentValue& value)
 {
   Mysqlx::Datatypes::Scalar *my_scalar = new Mysqlx::Datatypes::Scalar;
@@ -239,20 +464,30 @@ Find_Base::Find_Base(const Find_Base &other)
 
 Find_Base &Find_Base::operator = (const Find_Base &other)
 {
+  message_changed();
   m_find = other.m_find;
   return *this;
 }
 
-std::shared_ptr<Result> Find_Base::execute()
+Mysqlx::Expr::Expr *Find_Base::criteria()
 {
-  insert_bound_values(m_find->mutable_args());
+  return m_find->has_criteria() ? m_find->mutable_criteria() : NULL;
+}
 
-  if (!m_find->IsInitialized())
-    throw std::logic_error("FindStatement is not completely initialized: " + m_find->InitializationErrorString());
+int Find_Base::message(std::string &payload)
+{
+  payload = serialize(*m_find, Mysqlx::Crud::Find::kArgsFieldNumber, "FindStatement");
+  return Mysqlx::ClientMessages::CRUD_FIND;
+}
+
+std::shared_ptr<Result> Find_Base::execute()
+{
+  std::string payload;
+  int mid = message(payload);
 
   SessionRef session(m_coll->schema()->session());
 
-  std::shared_ptr<Result> result(session->connection()->execute_find(*m_find));
+  std::shared_ptr<Result> result(session->connection()->execute_serialized(mid, payload, true));
 
   // wait for results (at least metadata) to arrive
   result->wait();
@@ -260,20 +495,80 @@ std::shared_ptr<Result> Find_Base::execute()
   return result;
 }
 
+std::shared_ptr<Result> Find_Base::execute(uint64_t fetch_rows)
+{
+  std::string payload;
+  message(payload);
+
+  SessionRef session(m_coll->schema()->session());
+
+  std::shared_ptr<Result> result(session->connection()->execute_cursor(payload, fetch_rows));
+
+  result->wait();
+
+  return result;
+}
+
+static Mysqlx::Expr::Expr *operator_expr(const char *name, Mysqlx::Expr::Expr *left, Mysqlx::Expr::Expr *right)
+{
+  Mysqlx::Expr::Expr *expr = new Mysqlx::Expr::Expr();
+  expr->set_type(Mysqlx::Expr::Expr::OPERATOR);
+  expr->mutable_operator_()->set_name(name);
+  expr->mutable_operator_()->mutable_param()->AddAllocated(left);
+  expr->mutable_operator_()->mutable_param()->AddAllocated(right);
+  return expr;
+}
+
+static Mysqlx::Expr::Expr *column_compare(const char *name, const std::string &column, const std::string &value)
+{
+  Mysqlx::Expr::Expr *ident = new Mysqlx::Expr::Expr();
+  ident->set_type(Mysqlx::Expr::Expr::IDENT);
+  ident->mutable_identifier()->set_name(column);
+
+  Mysqlx::Expr::Expr *literal = new Mysqlx::Expr::Expr();
+  literal->set_type(Mysqlx::Expr::Expr::LITERAL);
+  literal->mutable_literal()->set_type(Mysqlx::Datatypes::Scalar::V_OCTETS);
+  literal->mutable_literal()->mutable_v_octets()->set_value(value);
+
+  return operator_expr(name, ident, literal);
+}
+
+Find_Base &Find_Base::columnRange(const std::string &column, const std::string &from, const std::string &to)
+{
+  message_changed();
+
+  if (!from.empty())
+  {
+    Mysqlx::Expr::Expr *bound = column_compare(">=", column, from);
+    m_find->set_allocated_criteria(m_find->has_criteria() ? operator_expr("&&", m_find->release_criteria(), bound) : bound);
+  }
+
+  if (!to.empty())
+  {
+    Mysqlx::Expr::Expr *bound = column_compare("<", column, to);
+    m_find->set_allocated_criteria(m_find->has_criteria() ? operator_expr("&&", m_find->release_criteria(), bound) : bound);
+  }
+
+  return *this;
+}
+
 Find_Base &Find_Skip::skip(uint64_t skip_)
 {
+  message_changed();
   m_find->mutable_limit()->set_offset(skip_);
   return *this;
 }
 
 Find_Skip &Find_Limit::limit(uint64_t limit_)
 {
+  message_changed();
   m_find->mutable_limit()->set_row_count(limit_);
   return *this;
 }
 
 Find_Limit &Find_Sort::sort(const std::vector<std::string> &sortFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = sortFields.end();
 
   for (index = sortFields.begin(); index != end; index++)
@@ -284,14 +579,16 @@ Find_Limit &Find_Sort::sort(const std::vector<std::string> &sortFields)
 
 Find_Sort &Find_Having::having(const std::string &searchCondition)
 {
+  message_changed();
   if (!searchCondition.empty())
-    m_find->set_allocated_grouping_criteria(parser::parse_collection_filter(searchCondition, &m_placeholders));
+    m_find->set_allocated_grouping_criteria(parse_filter(m_coll->schema(), searchCondition, true, &m_placeholders));
 
   return *this;
 }
 
 Find_Having &Find_GroupBy::groupBy(const std::vector<std::string> &searchFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = searchFields.end();
 
   for (index = searchFields.begin(); index != end; index++)
@@ -302,6 +599,7 @@ Find_Having &Find_GroupBy::groupBy(const std::vector<std::string> &searchFields)
 
 Find_GroupBy &FindStatement::fields(const std::string& projection)
 {
+  message_changed();
   ::mysqlx::Expr_parser parser(projection, true, false, &m_placeholders);
 
   Mysqlx::Expr::Expr *expr_obj = parser.expr();
@@ -313,6 +611,7 @@ Find_GroupBy &FindStatement::fields(const std::string& projection)
 
 Find_GroupBy &FindStatement::fields(const std::vector<std::string> &searchFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = searchFields.end();
 
   for (index = searchFields.begin(); index != end; index++)
@@ -329,7 +628,7 @@ FindStatement::FindStatement(std::shared_ptr<Collection> coll, const std::string
   m_find->set_data_model(Mysqlx::Crud::DOCUMENT);
 
   if (!searchCondition.empty())
-    m_find->set_allocated_criteria(parser::parse_collection_filter(searchCondition, &m_placeholders));
+    m_find->set_allocated_criteria(parse_filter(m_coll->schema(), searchCondition, true, &m_placeholders));
 }
 
 //----------------------------------
@@ -350,6 +649,20 @@ Add_Base &Add_Base::operator = (const Add_Base &other)
   return *this;
 }
 
+int Add_Base::message(std::string &payload)
+{
+  if (!m_insert->IsInitialized())
+    throw std::logic_error("AddStatement is not completely initialized: " + m_insert->InitializationErrorString());
+
+  if (!m_insert->row_size())
+    throw std::logic_error("AddStatement has no documents to add");
+
+  // The ids of the documents are only reported by execute()
+  m_insert->SerializeToString(&payload);
+  m_last_document_ids.clear();
+  return Mysqlx::ClientMessages::CRUD_INSERT;
+}
+
 std::shared_ptr<Result> Add_Base::execute()
 {
   // TODO: Inserte MUST have mustable_args to enable parameter binding so this will be hidden for now
@@ -375,6 +688,175 @@ std::shared_ptr<Result> Add_Base::execute()
   return result;
 }
 
+namespace
+{
+  // The rows of a chunk are borrowed from the statement, they are
+  // released from the chunk message on any exit path so they are not deleted
+  class Chunk_rows_releaser
+  {
+  public:
+    Chunk_rows_releaser(Mysqlx::Crud::Insert &chunk) : m_chunk(chunk) {}
+    ~Chunk_rows_releaser()
+    {
+      while (m_chunk.row_size())
+        m_chunk.mutable_row()->ReleaseLast();
+    }
+
+  private:
+    Mysqlx::Crud::Insert &m_chunk;
+  };
+
+  // Sends the messages produced by send_next, which returns false once there
+  // is nothing left to send, keeping up to pipeline_depth of them in flight,
+  // or the depth of the control which is told how long the server took on
+  // each message. Returns the results of all of them merged
+  std::shared_ptr<Result> execute_pipelined(Connection &connection, const std::function<bool()> &send_next, size_t pipeline_depth,
+                                            Batch_control *control = NULL)
+  {
+    std::shared_ptr<Result> result;
+    std::exception_ptr first_error;
+    bool done = false;
+    size_t in_flight = 0;
+
+    // The server starts on a message once it is sent and the previous one
+    // was answered
+    std::deque<std::chrono::steady_clock::time_point> sent;
+    std::chrono::steady_clock::time_point last_answer;
+
+    while (!done || in_flight)
+    {
+      size_t depth = std::max<size_t>(control ? control->depth() : pipeline_depth, 1);
+
+      while (!done && in_flight < depth && !first_error)
+      {
+        try
+        {
+          if (send_next())
+          {
+            in_flight++;
+            sent.push_back(std::chrono::steady_clock::now());
+          }
+          else
+            done = true;
+        }
+        catch (...)
+        {
+          // Whatever was already sent is still answered by the server
+          first_error = std::current_exception();
+          done = true;
+        }
+      }
+
+      if (!in_flight)
+        break;
+
+      // Results arrive in the same order the messages were sent, an error is
+      // the answer to its message too
+      std::chrono::steady_clock::time_point sent_time = sent.front();
+      sent.pop_front();
+      in_flight--;
+
+      std::shared_ptr<Result> chunk_result;
+      try
+      {
+        chunk_result = connection.recv_result(false);
+        chunk_result->wait();
+
+        auto now = std::chrono::steady_clock::now();
+        if (control)
+          control->on_batch(now - std::max(sent_time, last_answer));
+        last_answer = now;
+
+        if (result)
+          chunk_result->merge(*result);
+
+        result = chunk_result;
+      }
+      catch (Error &e)
+      {
+        if (control)
+          control->on_error(e.error());
+
+        // Chunks already sent are still processed by the server, their results
+        // are consumed before reporting the first error
+        if (!first_error)
+          first_error = std::current_exception();
+        done = true;
+      }
+    }
+
+    if (first_error)
+      std::rethrow_exception(first_error);
+
+    if (!result)
+      result = connection.new_empty_result();
+
+    return result;
+  }
+}
+
+std::shared_ptr<Result> Add_Base::execute(size_t chunk_size, size_t pipeline_depth)
+{
+  return execute_chunks(chunk_size, pipeline_depth, NULL);
+}
+
+std::shared_ptr<Result> Add_Base::execute(Batch_control &control)
+{
+  return execute_chunks(control.rows(), control.depth(), &control);
+}
+
+std::shared_ptr<Result> Add_Base::execute_chunks(size_t chunk_size, size_t pipeline_depth, Batch_control *control)
+{
+  int total = m_insert->row_size();
+
+  if (chunk_size == 0 || total <= static_cast<int>(chunk_size))
+    return execute();
+
+  if (!m_insert->IsInitialized())
+    throw std::logic_error("AddStatement is not completely initialized: " + m_insert->InitializationErrorString());
+
+  SessionRef session(m_coll->schema()->session());
+  std::shared_ptr<Connection> connection(session->connection());
+
+  Mysqlx::Crud::Insert chunk;
+  chunk.mutable_collection()->CopyFrom(m_insert->collection());
+  chunk.set_data_model(m_insert->data_model());
+
+  int next_row = 0;
+  std::shared_ptr<Result> result;
+  try
+  {
+    // Each chunk is serialized as it is sent so the rows can be returned to
+    // the statement right after
+    result = execute_pipelined(*connection, [&]()
+    {
+      if (next_row >= total)
+        return false;
+
+      Chunk_rows_releaser releaser(chunk);
+      if (control)
+        chunk_size = control->rows();
+      int last_row = std::min(total, next_row + static_cast<int>(chunk_size));
+
+      for (; next_row < last_row; next_row++)
+        chunk.mutable_row()->AddAllocated(m_insert->mutable_row(next_row));
+
+      connection->send(chunk);
+      return true;
+    }, pipeline_depth, control);
+  }
+  catch (...)
+  {
+    m_last_document_ids.clear();
+    throw;
+  }
+
+  result->setLastDocumentIDs(m_last_document_ids);
+  m_last_document_ids.clear();
+
+  return result;
+}
+
 AddStatement::AddStatement(std::shared_ptr<Collection> coll)
   : Add_Base(coll)
 {
@@ -395,7 +877,13 @@ AddStatement::AddStatement(std::shared_ptr<Collection> coll, const Document &doc
 AddStatement &AddStatement::add(const Document &doc)
 {
   ::mysqlx::Expr_parser parser(doc.str(), true, false, &m_placeholders);
-  Mysqlx::Expr::Expr *expr_obj = parser.expr();
+
+  return add(parser.expr());
+}
+
+AddStatement &AddStatement::add(Mysqlx::Expr::Expr *document)
+{
+  std::unique_ptr<Mysqlx::Expr::Expr> expr_obj(document);
 
   if (expr_obj->type() == Mysqlx::Expr::Expr_Type_OBJECT)
   {
@@ -424,12 +912,25 @@ AddStatement &AddStatement::add(const Document &doc)
     else
       throw std::logic_error("Missing document _id");
 
-    m_insert->mutable_row()->Add()->mutable_field()->AddAllocated(expr_obj);
+    m_insert->mutable_row()->Add()->mutable_field()->AddAllocated(expr_obj.release());
   }
 
   return *this;
 }
 
+AddStatement &AddStatement::addJson(const char *document, size_t length)
+{
+  message_changed();
+
+  Mysqlx::Expr::Expr *expr = m_insert->mutable_row()->Add()->mutable_field()->Add();
+  expr->set_type(Mysqlx::Expr::Expr::LITERAL);
+  expr->mutable_literal()->set_type(Mysqlx::Datatypes::Scalar::V_OCTETS);
+  expr->mutable_literal()->mutable_v_octets()->set_content_type(CONTENT_TYPE_JSON);
+  expr->mutable_literal()->mutable_v_octets()->set_value(document, length);
+
+  return *this;
+}
+
 //--------------------------------------------------------------
 
 Remove_Base::Remove_Base(std::shared_ptr<Collection> coll)
@@ -444,20 +945,30 @@ Remove_Base::Remove_Base(const Remove_Base &other)
 
 Remove_Base &Remove_Base::operator = (const Remove_Base &other)
 {
+  message_changed();
   m_delete = other.m_delete;
   return *this;
 }
 
-std::shared_ptr<Result> Remove_Base::execute()
+Mysqlx::Expr::Expr *Remove_Base::criteria()
+{
+  return m_delete->has_criteria() ? m_delete->mutable_criteria() : NULL;
+}
+
+int Remove_Base::message(std::string &payload)
 {
-  insert_bound_values(m_delete->mutable_args());
+  payload = serialize(*m_delete, Mysqlx::Crud::Delete::kArgsFieldNumber, "RemoveStatement");
+  return Mysqlx::ClientMessages::CRUD_DELETE;
+}
 
-  if (!m_delete->IsInitialized())
-    throw std::logic_error("RemoveStatement is not completely initialized: " + m_delete->InitializationErrorString());
+std::shared_ptr<Result> Remove_Base::execute()
+{
+  std::string payload;
+  int mid = message(payload);
 
   SessionRef session(m_coll->schema()->session());
 
-  std::shared_ptr<Result> result(session->connection()->execute_delete(*m_delete));
+  std::shared_ptr<Result> result(session->connection()->execute_serialized(mid, payload, false));
 
   result->wait();
 
@@ -466,6 +977,7 @@ std::shared_ptr<Result> Remove_Base::execute()
 
 Remove_Base &Remove_Limit::limit(uint64_t limit_)
 {
+  message_changed();
   m_delete->mutable_limit()->set_row_count(limit_);
   return *this;
 }
@@ -478,11 +990,12 @@ RemoveStatement::RemoveStatement(std::shared_ptr<Collection> coll, const std::st
   m_delete->set_data_model(Mysqlx::Crud::DOCUMENT);
 
   if (!searchCondition.empty())
-    m_delete->set_allocated_criteria(parser::parse_collection_filter(searchCondition, &m_placeholders));
+    m_delete->set_allocated_criteria(parse_filter(m_coll->schema(), searchCondition, true, &m_placeholders));
 }
 
 Remove_Limit &RemoveStatement::sort(const std::vector<std::string> &sortFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = sortFields.end();
 
   for (index = sortFields.begin(); index != end; index++)
@@ -505,21 +1018,31 @@ Modify_Base::Modify_Base(const Modify_Base &other)
 
 Modify_Base &Modify_Base::operator = (const Modify_Base &other)
 {
+  message_changed();
   m_coll = other.m_coll;
   m_update = other.m_update;
   return *this;
 }
 
-std::shared_ptr<Result> Modify_Base::execute()
+Mysqlx::Expr::Expr *Modify_Base::criteria()
 {
-  insert_bound_values(m_update->mutable_args());
+  return m_update->has_criteria() ? m_update->mutable_criteria() : NULL;
+}
 
-  if (!m_update->IsInitialized())
-    throw std::logic_error("ModifyStatement is not completely initialized: " + m_update->InitializationErrorString());
+int Modify_Base::message(std::string &payload)
+{
+  payload = serialize(*m_update, Mysqlx::Crud::Update::kArgsFieldNumber, "ModifyStatement");
+  return Mysqlx::ClientMessages::CRUD_UPDATE;
+}
+
+std::shared_ptr<Result> Modify_Base::execute()
+{
+  std::string payload;
+  int mid = message(payload);
 
   SessionRef session(m_coll->schema()->session());
 
-  std::shared_ptr<Result> result(session->connection()->execute_update(*m_update));
+  std::shared_ptr<Result> result(session->connection()->execute_serialized(mid, payload, false));
 
   result->wait();
 
@@ -528,12 +1051,14 @@ std::shared_ptr<Result> Modify_Base::execute()
 
 Modify_Base &Modify_Limit::limit(uint64_t limit_)
 {
+  message_changed();
   m_update->mutable_limit()->set_row_count(limit_);
   return *this;
 }
 
 Modify_Limit &Modify_Sort::sort(const std::vector<std::string> &sortFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = sortFields.end();
 
   for (index = sortFields.begin(); index != end; index++)
@@ -544,12 +1069,13 @@ Modify_Limit &Modify_Sort::sort(const std::vector<std::string> &sortFields)
 
 Modify_Operation &Modify_Operation::set_operation(int type, const std::string &path, const DocumentValue *value, bool validate_array)
 {
+  message_changed();
   // Sets the operation
   Mysqlx::Crud::UpdateOperation * operation = m_update->mutable_operation()->Add();
   operation->set_operation(Mysqlx::Crud::UpdateOperation_UpdateType(type));
 
-  Mysqlx::Expr::Expr *docpath = parser::parse_column_identifier(path.empty() ? "$" : path);
-  Mysqlx::Expr::ColumnIdentifier identifier(docpath->identifier());
+  std::unique_ptr<Mysqlx::Expr::Expr> docpath(parser::parse_column_identifier(path.empty() ? "$" : path));
+  const Mysqlx::Expr::ColumnIdentifier &identifier(docpath->identifier());
 
   // Validates the source is an array item
   int size = identifier.document_path().size();
@@ -564,8 +1090,8 @@ Modify_Operation &Modify_Operation::set_operation(int type, const std::string &p
   else if (type != Mysqlx::Crud::UpdateOperation::ITEM_MERGE)
     throw std::logic_error("Invalid document path");
 
-  // Sets the source
-  operation->mutable_source()->CopyFrom(identifier);
+  // Sets the source, moving it out of the parsed expression
+  operation->set_allocated_source(docpath->release_identifier());
 
   // Sets the value if applicable
   if (value)
@@ -585,8 +1111,6 @@ Modify_Operation &Modify_Operation::set_operation(int type, const std::string &p
     }
   }
 
-  delete docpath;
-
   return *this;
 }
 
@@ -633,7 +1157,7 @@ ModifyStatement::ModifyStatement(std::shared_ptr<Collection> coll, const std::st
   m_update->set_data_model(Mysqlx::Crud::DOCUMENT);
 
   if (!searchCondition.empty())
-    m_update->set_allocated_criteria(parser::parse_collection_filter(searchCondition, &m_placeholders));
+    m_update->set_allocated_criteria(parse_filter(m_coll->schema(), searchCondition, true, &m_placeholders));
 }
 
 //--------------------------------------------------------------
@@ -655,17 +1179,37 @@ Table_Statement &Table_Statement::bind(const std::string &name, const TableValue
   validate_bind_placeholder(name);
 
   // Now sets the right value on the position of the indicated placeholder
-  std::vector<std::string>::iterator index = std::find(m_placeholders.begin(), m_placeholders.end(), name);
-  m_bound_values[index - m_placeholders.begin()] = convert_table_value(value);
+  set_bound_value(name, convert_table_value(value));
 
   return *this;
 }
 
+namespace
+{
+  // The file is read once, into the message that is sent
+  void read_file(const std::string &path, std::string &data)
+  {
+    std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(path.c_str(), "rb"), &fclose);
+    if (!file)
+      throw std::runtime_error("Unable to open the file '" + path + "'");
+
+    fseek(file.get(), 0, SEEK_END);
+    long size = ftell(file.get());
+    fseek(file.get(), 0, SEEK_SET);
+    if (size < 0)
+      throw std::runtime_error("Unable to read the file '" + path + "'");
+
+    data.resize(static_cast<size_t>(size));
+    if (size && fread(&data[0], 1, data.size(), file.get()) != data.size())
+      throw std::runtime_error("Unable to read the file '" + path + "'");
+  }
+}
+
 Mysqlx::Datatypes::Scalar* Table_Statement::convert_table_value(const TableValue& value)
 {
   Mysqlx::Datatypes::Scalar *my_scalar = new Mysqlx::Datatypes::Scalar;
 
-  mysqlx::TableValue column_value(value);
+  const mysqlx::TableValue &column_value(value);
 
   switch (value.type())
   {
@@ -700,6 +1244,10 @@ Mysqlx::Datatypes::Scalar* Table_Statement::convert_table_value(const TableValue
       my_scalar->set_type(Mysqlx::Datatypes::Scalar::V_STRING);
       my_scalar->mutable_v_string()->set_value(column_value);
       break;
+    case TableValue::TFile:
+      my_scalar->set_type(Mysqlx::Datatypes::Scalar::V_OCTETS);
+      read_file(column_value, *my_scalar->mutable_v_octets()->mutable_value());
+      break;
     case TableValue::TExpression:
       //XXX TODO
       break;
@@ -725,20 +1273,25 @@ Delete_Base::Delete_Base(const Delete_Base &other)
 
 Delete_Base &Delete_Base::operator = (const Delete_Base &other)
 {
+  message_changed();
   m_delete = other.m_delete;
   return *this;
 }
 
-std::shared_ptr<Result> Delete_Base::execute()
+int Delete_Base::message(std::string &payload)
 {
-  insert_bound_values(m_delete->mutable_args());
+  payload = serialize(*m_delete, Mysqlx::Crud::Delete::kArgsFieldNumber, "DeleteStatement");
+  return Mysqlx::ClientMessages::CRUD_DELETE;
+}
 
-  if (!m_delete->IsInitialized())
-    throw std::logic_error("DeleteStatement is not completely initialized: " + m_delete->InitializationErrorString());
+std::shared_ptr<Result> Delete_Base::execute()
+{
+  std::string payload;
+  int mid = message(payload);
 
   SessionRef session(m_table->schema()->session());
 
-  std::shared_ptr<Result> result(session->connection()->execute_delete(*m_delete));
+  std::shared_ptr<Result> result(session->connection()->execute_serialized(mid, payload, false));
 
   result->wait();
 
@@ -747,12 +1300,14 @@ std::shared_ptr<Result> Delete_Base::execute()
 
 Delete_Base &Delete_Limit::limit(uint64_t limit_)
 {
+  message_changed();
   m_delete->mutable_limit()->set_row_count(limit_);
   return *this;
 }
 
 Delete_Limit &Delete_OrderBy::orderBy(const std::vector<std::string> &sortFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = sortFields.end();
 
   for (index = sortFields.begin(); index != end; index++)
@@ -771,8 +1326,9 @@ DeleteStatement::DeleteStatement(std::shared_ptr<Table> table)
 
 Delete_OrderBy &DeleteStatement::where(const std::string& searchCondition)
 {
+  message_changed();
   if (!searchCondition.empty())
-    m_delete->set_allocated_criteria(parser::parse_table_filter(searchCondition, &m_placeholders));
+    m_delete->set_allocated_criteria(parse_filter(m_table->schema(), searchCondition, false, &m_placeholders));
 
   return *this;
 }
@@ -791,20 +1347,25 @@ Update_Base::Update_Base(const Update_Base &other)
 
 Update_Base &Update_Base::operator = (const Update_Base &other)
 {
+  message_changed();
   m_update = other.m_update;
   return *this;
 }
 
-std::shared_ptr<Result> Update_Base::execute()
+int Update_Base::message(std::string &payload)
 {
-  insert_bound_values(m_update->mutable_args());
+  payload = serialize(*m_update, Mysqlx::Crud::Update::kArgsFieldNumber, "UpdateStatement");
+  return Mysqlx::ClientMessages::CRUD_UPDATE;
+}
 
-  if (!m_update->IsInitialized())
-    throw std::logic_error("UpdateStatement is not completely initialized: " + m_update->InitializationErrorString());
+std::shared_ptr<Result> Update_Base::execute()
+{
+  std::string payload;
+  int mid = message(payload);
 
   SessionRef session(m_table->schema()->session());
 
-  std::shared_ptr<Result> result(session->connection()->execute_update(*m_update));
+  std::shared_ptr<Result> result(session->connection()->execute_serialized(mid, payload, false));
 
   result->wait();
 
@@ -813,12 +1374,14 @@ std::shared_ptr<Result> Update_Base::execute()
 
 Update_Base &Update_Limit::limit(uint64_t limit_)
 {
+  message_changed();
   m_update->mutable_limit()->set_row_count(limit_);
   return *this;
 }
 
 Update_Limit &Update_OrderBy::orderBy(const std::vector<std::string> &sortFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = sortFields.end();
 
   for (index = sortFields.begin(); index != end; index++)
@@ -829,14 +1392,16 @@ Update_Limit &Update_OrderBy::orderBy(const std::vector<std::string> &sortFields
 
 Update_OrderBy &Update_Where::where(const std::string& searchCondition)
 {
+  message_changed();
   if (!searchCondition.empty())
-    m_update->set_allocated_criteria(parser::parse_table_filter(searchCondition, &m_placeholders));
+    m_update->set_allocated_criteria(parse_filter(m_table->schema(), searchCondition, false, &m_placeholders));
 
   return *this;
 }
 
 Update_Set &Update_Set::set(const std::string &field, const TableValue& value)
 {
+  message_changed();
   Mysqlx::Crud::UpdateOperation *operation = m_update->mutable_operation()->Add();
 
   operation->mutable_source()->set_name(field);
@@ -850,6 +1415,7 @@ Update_Set &Update_Set::set(const std::string &field, const TableValue& value)
 
 Update_Set &Update_Set::set(const std::string &field, const std::string& expression)
 {
+  message_changed();
   Mysqlx::Crud::UpdateOperation *operation = m_update->mutable_operation()->Add();
 
   operation->mutable_source()->set_name(field);
@@ -884,20 +1450,25 @@ Select_Base::Select_Base(const Select_Base &other)
 
 Select_Base &Select_Base::operator = (const Select_Base &other)
 {
+  message_changed();
   m_find = other.m_find;
   return *this;
 }
 
-std::shared_ptr<Result> Select_Base::execute()
+int Select_Base::message(std::string &payload)
 {
-  insert_bound_values(m_find->mutable_args());
+  payload = serialize(*m_find, Mysqlx::Crud::Find::kArgsFieldNumber, "SelectStatement");
+  return Mysqlx::ClientMessages::CRUD_FIND;
+}
 
-  if (!m_find->IsInitialized())
-    throw std::logic_error("SelectStatement is not completely initialized: " + m_find->InitializationErrorString());
+std::shared_ptr<Result> Select_Base::execute()
+{
+  std::string payload;
+  int mid = message(payload);
 
   SessionRef session(m_table->schema()->session());
 
-  std::shared_ptr<Result> result(session->connection()->execute_find(*m_find));
+  std::shared_ptr<Result> result(session->connection()->execute_serialized(mid, payload, true));
 
   // wait for results (at least metadata) to arrive
   result->wait();
@@ -907,18 +1478,21 @@ std::shared_ptr<Result> Select_Base::execute()
 
 Select_Base &Select_Offset::offset(uint64_t offset_)
 {
+  message_changed();
   m_find->mutable_limit()->set_offset(offset_);
   return *this;
 }
 
 Select_Offset &Select_Limit::limit(uint64_t limit_)
 {
+  message_changed();
   m_find->mutable_limit()->set_row_count(limit_);
   return *this;
 }
 
 Select_Limit &Select_OrderBy::orderBy(const std::vector<std::string> &sortFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = sortFields.end();
 
   for (index = sortFields.begin(); index != end; index++)
@@ -929,14 +1503,16 @@ Select_Limit &Select_OrderBy::orderBy(const std::vector<std::string> &sortFields
 
 Select_OrderBy &Select_Having::having(const std::string &searchCondition)
 {
+  message_changed();
   if (!searchCondition.empty())
-    m_find->set_allocated_grouping_criteria(parser::parse_table_filter(searchCondition, &m_placeholders));
+    m_find->set_allocated_grouping_criteria(parse_filter(m_table->schema(), searchCondition, false, &m_placeholders));
 
   return *this;
 }
 
 Select_Having &Select_GroupBy::groupBy(const std::vector<std::string> &searchFields)
 {
+  message_changed();
   std::vector<std::string>::const_iterator index, end = searchFields.end();
 
   for (index = searchFields.begin(); index != end; index++)
@@ -963,8 +1539,9 @@ SelectStatement::SelectStatement(std::shared_ptr<Table> table, const std::vector
 
 Select_GroupBy &SelectStatement::where(const std::string &searchCondition)
 {
+  message_changed();
   if (!searchCondition.empty())
-    m_find->set_allocated_criteria(parser::parse_table_filter(searchCondition, &m_placeholders));
+    m_find->set_allocated_criteria(parse_filter(m_table->schema(), searchCondition, false, &m_placeholders));
 
   return *this;
 }
@@ -987,6 +1564,15 @@ Insert_Base &Insert_Base::operator = (const Insert_Base &other)
   return *this;
 }
 
+int Insert_Base::message(std::string &payload)
+{
+  if (!m_insert->IsInitialized())
+    throw std::logic_error("InsertStatement is not completely initialized: " + m_insert->InitializationErrorString());
+
+  m_insert->SerializeToString(&payload);
+  return Mysqlx::ClientMessages::CRUD_INSERT;
+}
+
 std::shared_ptr<Result> Insert_Base::execute()
 {
   if (!m_insert->IsInitialized())
@@ -1006,9 +1592,88 @@ Insert_Values::Insert_Values(std::shared_ptr<Table> table)
 {
 }
 
-Insert_Values &Insert_Values::values(const std::vector<TableValue> &row_data)
+std::shared_ptr<Result> Insert_Base::execute(const Row_source &next_row, size_t batch_rows, size_t max_bytes, size_t pipeline_depth)
+{
+  return execute_batches(next_row, batch_rows, max_bytes, pipeline_depth, NULL);
+}
+
+std::shared_ptr<Result> Insert_Base::execute(const Row_source &next_row, Batch_control &control, size_t max_bytes)
+{
+  return execute_batches(next_row, control.rows(), max_bytes, control.depth(), &control);
+}
+
+std::shared_ptr<Result> Insert_Base::execute_batches(const Row_source &next_row, size_t batch_rows, size_t max_bytes,
+                                                     size_t pipeline_depth, Batch_control *control)
+{
+  if (!m_insert->IsInitialized())
+    throw std::logic_error("InsertStatement is not completely initialized: " + m_insert->InitializationErrorString());
+
+  if (batch_rows == 0)
+    batch_rows = 1;
+
+  SessionRef session(m_table->schema()->session());
+  std::shared_ptr<Connection> connection(session->connection());
+
+  // Every chunk carries the rows given with values() followed by the rows
+  // pulled from the source, the rows of a sent chunk are cleared but kept
+  // allocated so the next chunk reuses them
+  Mysqlx::Crud::Insert chunk;
+  chunk.mutable_collection()->CopyFrom(m_insert->collection());
+  chunk.set_data_model(m_insert->data_model());
+  chunk.mutable_projection()->CopyFrom(m_insert->projection());
+
+  int header_size = chunk.ByteSize();
+  chunk.mutable_row()->CopyFrom(m_insert->row());
+  std::vector<TableValue> row_data;
+  std::unique_ptr<Mysqlx::Crud::Insert_TypedRow> pending_row;
+  bool source_done = false;
+
+  return execute_pipelined(*connection, [&]()
+  {
+    size_t bytes = chunk.ByteSize() - header_size;
+    if (control)
+      batch_rows = std::max<size_t>(control->rows(), 1);
+
+    if (pending_row)
+    {
+      bytes += pending_row->ByteSize();
+      chunk.mutable_row()->AddAllocated(pending_row.release());
+    }
+
+    while (!source_done && static_cast<size_t>(chunk.row_size()) < batch_rows && bytes < max_bytes)
+    {
+      row_data.clear();
+      if (!next_row(row_data))
+      {
+        source_done = true;
+        break;
+      }
+
+      Mysqlx::Crud::Insert_TypedRow *row = chunk.mutable_row()->Add();
+      encode_row(row_data, *row);
+
+      // The row that does not fit in the message goes on the next one
+      size_t row_bytes = row->ByteSize() + 5;
+      if (bytes + row_bytes > max_bytes && chunk.row_size() > 1)
+      {
+        pending_row.reset(chunk.mutable_row()->ReleaseLast());
+        break;
+      }
+
+      bytes += row_bytes;
+    }
+
+    if (!chunk.row_size())
+      return false;
+
+    connection->send(chunk);
+    chunk.mutable_row()->Clear();
+    return true;
+  }, pipeline_depth, control);
+}
+
+void Insert_Base::encode_row(const std::vector<TableValue> &row_data, Mysqlx::Crud::Insert_TypedRow &row)
 {
-  Mysqlx::Crud::Insert_TypedRow* row = m_insert->mutable_row()->Add();
   std::vector<TableValue>::const_iterator index, end = row_data.end();
 
   for (index = row_data.begin(); index != end; index++)
@@ -1017,17 +1682,20 @@ Insert_Values &Insert_Values::values(const std::vector<TableValue> &row_data)
     {
       TableValue expression(*index);
       Expr_parser parser(expression, false, false, &m_placeholders);
-      row->mutable_field()->AddAllocated(parser.expr());
+      row.mutable_field()->AddAllocated(parser.expr());
     }
     else
     {
-      Mysqlx::Expr::Expr* expr = new Mysqlx::Expr::Expr();
+      Mysqlx::Expr::Expr* expr = row.mutable_field()->Add();
       expr->set_type(Mysqlx::Expr::Expr::LITERAL);
-      Mysqlx::Datatypes::Scalar* scalar = convert_table_value(*index);
-      expr->set_allocated_literal(scalar);
-      row->mutable_field()->AddAllocated(expr);
+      expr->set_allocated_literal(convert_table_value(*index));
     }
   }
+}
+
+Insert_Values &Insert_Values::values(const std::vector<TableValue> &row_data)
+{
+  encode_row(row_data, *m_insert->mutable_row()->Add());
 
   return *this;
 }
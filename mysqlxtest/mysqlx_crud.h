@@ -22,6 +22,8 @@
 
 #include "mysqlx.h"
 
+#include <functional>
+
 namespace Mysqlx
 {
   namespace Crud
@@ -29,6 +31,7 @@ namespace Mysqlx
     class Find;
     class Update;
     class Insert;
+    class Insert_TypedRow;
     class Delete;
   }
 
@@ -37,12 +40,18 @@ namespace Mysqlx
     class Any;
     class Scalar;
   }
+
+  namespace Expr
+  {
+    class Expr;
+  }
 }
 
 namespace mysqlx
 {
   class Table;
   class Collection;
+  class Batch_control;
 
   typedef std::shared_ptr<Table> TableRef;
   typedef std::shared_ptr<Collection> CollectionRef;
@@ -69,17 +78,42 @@ namespace mysqlx
   class Statement
   {
   public:
-    Statement(){};
+    Statement();
     Statement(const Statement& other);
     virtual ~Statement();
     virtual std::shared_ptr<Result> execute() = 0;
 
+    // The message executing the statement, for sending it along with others
+    // (see Connection::execute_batch()), returns its id
+    virtual int message(std::string &payload);
+
+    // The SQL the X plugin executes for the message, to have it explained
+    // by the server. Only for find, update and delete messages.
+    std::string sql();
+
   protected:
     std::vector<std::string> m_placeholders;
-    std::vector<Mysqlx::Datatypes::Scalar*> m_bound_values;
-    void insert_bound_values(::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar >* target);
+    // Serialized Scalar bound to each placeholder, empty if not bound yet
+    std::vector<std::string> m_bound_values;
     void init_bound_values();
     void validate_bind_placeholder(const std::string& name);
+    void set_bound_value(const std::string& name, Mysqlx::Datatypes::Scalar *value);
+
+    // The statement message is serialized on the first execution with no
+    // arguments and reused by the next ones, appending the bound values to it.
+    // Every change on the message must call message_changed().
+    std::string serialize(::google::protobuf::Message &message, int args_field_number, const char *statement_name);
+    void message_changed();
+
+  private:
+    struct Serialized_message
+    {
+      const ::google::protobuf::Message *message;
+      std::string data;
+    };
+
+    // Shared by the copies of the statement, as they share the message
+    std::shared_ptr<Serialized_message> m_serialized;
   };
 
   // -------------------------------------------------------
@@ -98,13 +132,16 @@ namespace mysqlx
       TString,
       TOctets,
       TExpression,
+      // The contents of the file at the path, read straight into the
+      // message as octets when it is encoded
+      TFile,
     };
 
     TableValue(const TableValue &other)
     {
       m_type = other.m_type;
       m_value = other.m_value;
-      if (m_type == TString || m_type == TOctets || m_type == TExpression)
+      if (m_type == TString || m_type == TOctets || m_type == TExpression || m_type == TFile)
         m_value.s = new std::string(*other.m_value.s);
     }
 
@@ -151,7 +188,7 @@ namespace mysqlx
 
     ~TableValue()
     {
-      if (m_type == TString || m_type == TOctets || m_type == TExpression)
+      if (m_type == TString || m_type == TOctets || m_type == TExpression || m_type == TFile)
         delete m_value.s;
     }
 
@@ -194,7 +231,7 @@ namespace mysqlx
 
     inline operator const std::string & () const
     {
-      if (m_type != TString && m_type != TOctets && m_type != TExpression)
+      if (m_type != TString && m_type != TOctets && m_type != TExpression && m_type != TFile)
         throw std::logic_error("type error");
       return *m_value.s;
     }
@@ -353,6 +390,7 @@ namespace mysqlx
     Select_Base &operator = (const Select_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
   protected:
     std::shared_ptr<Mysqlx::Crud::Find> m_find;
   };
@@ -427,7 +465,24 @@ namespace mysqlx
     Insert_Base &operator = (const Insert_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
+
+    // Produces the next row to insert, returns false when there are no more
+    typedef std::function<bool(std::vector<TableValue> &row)> Row_source;
+
+    // Inserts the rows pulled from next_row after the ones given with values(),
+    // they are encoded as they arrive and sent in messages of at most
+    // batch_rows rows and about max_bytes, keeping up to pipeline_depth
+    // messages in flight
+    std::shared_ptr<Result> execute(const Row_source &next_row, size_t batch_rows, size_t max_bytes, size_t pipeline_depth);
+    // The same with the rows of every message and the messages in flight
+    // chosen by the control as the server answers
+    std::shared_ptr<Result> execute(const Row_source &next_row, Batch_control &control, size_t max_bytes);
   protected:
+    std::shared_ptr<Result> execute_batches(const Row_source &next_row, size_t batch_rows, size_t max_bytes,
+                                            size_t pipeline_depth, Batch_control *control);
+    void encode_row(const std::vector<TableValue> &row_data, Mysqlx::Crud::Insert_TypedRow &row);
+
     std::shared_ptr<Mysqlx::Crud::Insert> m_insert;
   };
 
@@ -459,6 +514,7 @@ namespace mysqlx
     Delete_Base &operator = (const Delete_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
   protected:
     std::shared_ptr<Mysqlx::Crud::Delete> m_delete;
   };
@@ -501,6 +557,7 @@ namespace mysqlx
     Update_Base &operator = (const Update_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
   protected:
     std::shared_ptr<Mysqlx::Crud::Update> m_update;
   };
@@ -581,12 +638,29 @@ namespace mysqlx
     Collection_Statement(const Collection_Statement& other);
     Collection_Statement &bind(const std::string &name, const DocumentValue &value);
 
+    // Binds the values to a placeholder that is the whole list of an IN
+    // operator of the criteria, as in _id IN :ids, the values are sent as
+    // the items of the list
+    Collection_Statement &bind(const std::string &name, const std::vector<DocumentValue> &values);
+    bool isListPlaceholder(const std::string &name);
+
     std::shared_ptr<Collection> collection() const { return m_coll; }
 
   protected:
     Mysqlx::Datatypes::Scalar* convert_document_value(const DocumentValue& value);
 
+    // The criteria of the message, NULL if it has none
+    virtual Mysqlx::Expr::Expr *criteria() { return NULL; }
+
     std::shared_ptr<Collection> m_coll;
+
+  private:
+    void expand_lists();
+
+    // The criteria as parsed, the one on the message has the bound lists
+    // in place of their placeholders
+    std::shared_ptr<Mysqlx::Expr::Expr> m_parsed_criteria;
+    std::map<uint32_t, std::vector<std::shared_ptr<Mysqlx::Datatypes::Scalar> > > m_bound_lists;
   };
 
   class Find_Base : public Collection_Statement
@@ -597,7 +671,20 @@ namespace mysqlx
     Find_Base &operator = (const Find_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
+
+    // Reads the documents through a server cursor, fetch_rows at a time, so
+    // they are not all sent at once. Plain execution if the server has no
+    // cursors
+    std::shared_ptr<Result> execute(uint64_t fetch_rows);
+
+    // Restricts the documents to the ones whose column (not a document path,
+    // so an index on it is used) is from <= column < to, an empty bound is
+    // no bound
+    Find_Base &columnRange(const std::string &column, const std::string &from, const std::string &to);
   protected:
+    virtual Mysqlx::Expr::Expr *criteria();
+
     std::shared_ptr<Mysqlx::Crud::Find> m_find;
   };
 
@@ -675,7 +762,18 @@ namespace mysqlx
     Add_Base &operator = (const Add_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
+
+    // Sends the documents in messages of at most chunk_size documents, keeping
+    // up to pipeline_depth of them in flight, a chunk_size of 0 sends all the
+    // documents in a single message
+    std::shared_ptr<Result> execute(size_t chunk_size, size_t pipeline_depth);
+    // The same with the documents of every message and the messages in
+    // flight chosen by the control as the server answers
+    std::shared_ptr<Result> execute(Batch_control &control);
   protected:
+    std::shared_ptr<Result> execute_chunks(size_t chunk_size, size_t pipeline_depth, Batch_control *control);
+
     std::shared_ptr<Mysqlx::Crud::Insert> m_insert;
   };
 
@@ -688,6 +786,13 @@ namespace mysqlx
     AddStatement &operator = (const AddStatement &other) { Add_Base::operator=(other); return *this; }
 
     AddStatement &add(const Document &doc);
+
+    // Adds an already built document expression, takes ownership of document
+    AddStatement &add(Mysqlx::Expr::Expr *document);
+
+    // Adds a document given as JSON text, sent as is for the server to parse
+    // it. The document must have its _id.
+    AddStatement &addJson(const char *document, size_t length);
   };
 
   // -------------------------------------------------------
@@ -700,7 +805,10 @@ namespace mysqlx
     Modify_Base &operator = (const Modify_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
   protected:
+    virtual Mysqlx::Expr::Expr *criteria();
+
     std::shared_ptr<Mysqlx::Crud::Update> m_update;
   };
 
@@ -761,7 +869,10 @@ namespace mysqlx
     Remove_Base &operator = (const Remove_Base &other);
 
     virtual std::shared_ptr<Result> execute();
+    virtual int message(std::string &payload);
   protected:
+    virtual Mysqlx::Expr::Expr *criteria();
+
     std::shared_ptr<Mysqlx::Crud::Delete> m_delete;
   };
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mysqlx_result_cache.h"
+#include "mysqlx.h"
+#include "mysqlx_connection.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <set>
+#include <vector>
+
+using namespace mysqlx;
+
+namespace
+{
+  std::string cache_key(int mid, const std::string &payload)
+  {
+    std::string key(1, static_cast<char>(mid));
+    key.append(payload);
+    return key;
+  }
+
+  std::string to_upper(const std::string &text)
+  {
+    std::string ret_val(text);
+    std::transform(ret_val.begin(), ret_val.end(), ret_val.begin(), ::toupper);
+    return ret_val;
+  }
+
+  // The words and symbols of a statement, the words in upper case. Quoted
+  // strings and identifiers and the comments are skipped, so what they hold
+  // is never taken for a word.
+  std::vector<std::string> sql_tokens(const std::string &sql)
+  {
+    std::vector<std::string> tokens;
+    std::size_t index = 0;
+    while (index < sql.size())
+    {
+      unsigned char c = static_cast<unsigned char>(sql[index]);
+      if (isspace(c))
+        index++;
+      else if (c == '\'' || c == '"' || c == '`')
+      {
+        for (index++; index < sql.size() && sql[index] != static_cast<char>(c); index++)
+        {
+          if (sql[index] == '\\' && c != '`')
+            index++;
+        }
+        index++;
+        tokens.push_back(std::string(1, static_cast<char>(c)));
+      }
+      else if (sql.compare(index, 2, "/*") == 0)
+      {
+        std::size_t end = sql.find("*/", index + 2);
+        index = end == std::string::npos ? sql.size() : end + 2;
+      }
+      else if (c == '#' || sql.compare(index, 3, "-- ") == 0)
+      {
+        std::size_t end = sql.find('\n', index);
+        index = end == std::string::npos ? sql.size() : end + 1;
+      }
+      else if (isalnum(c) || c == '_' || c == '$')
+      {
+        std::size_t start = index;
+        while (index < sql.size() && (isalnum(static_cast<unsigned char>(sql[index])) || sql[index] == '_' ||
+                                      sql[index] == '$'))
+          index++;
+        tokens.push_back(to_upper(sql.substr(start, index - start)));
+      }
+      else
+      {
+        tokens.push_back(std::string(1, static_cast<char>(c)));
+        index++;
+      }
+    }
+
+    return tokens;
+  }
+
+  // Statements that only read, and whose result does not depend on the
+  // locks they take, on the session or on when they run
+  bool read_only_sql(const std::string &sql)
+  {
+    std::vector<std::string> tokens(sql_tokens(sql));
+
+    std::size_t start = 0;
+    while (start < tokens.size() && tokens[start] == "(")
+      start++;
+    if (start == tokens.size())
+      return false;
+
+    static const std::set<std::string> readers = {"SELECT", "SHOW", "DESCRIBE", "DESC", "EXPLAIN"};
+    if (!readers.count(tokens[start]))
+      return false;
+
+    // Functions with side effects or whose result changes from a call to
+    // the next one
+    static const std::set<std::string> volatile_words = {
+      "GET_LOCK", "RELEASE_LOCK", "RELEASE_ALL_LOCKS", "IS_FREE_LOCK", "IS_USED_LOCK", "SLEEP", "BENCHMARK",
+      "LAST_INSERT_ID", "FOUND_ROWS", "ROW_COUNT", "CONNECTION_ID", "RAND", "UUID", "UUID_SHORT",
+      "NOW", "SYSDATE", "CURDATE", "CURTIME", "CURRENT_DATE", "CURRENT_TIME", "CURRENT_TIMESTAMP",
+      "LOCALTIME", "LOCALTIMESTAMP", "UNIX_TIMESTAMP", "UTC_DATE", "UTC_TIME", "UTC_TIMESTAMP",
+      "INTO"
+    };
+
+    for (std::size_t index = start; index < tokens.size(); index++)
+    {
+      const std::string &token = tokens[index];
+      const std::string next = index + 1 < tokens.size() ? tokens[index + 1] : "";
+
+      // Variables, which may also be assigned
+      if (token == "@" || (token == ":" && next == "="))
+        return false;
+
+      // FOR UPDATE, FOR SHARE and LOCK IN SHARE MODE
+      if ((token == "FOR" && (next == "UPDATE" || next == "SHARE")) || (token == "LOCK" && next == "IN"))
+        return false;
+
+      if (volatile_words.count(token))
+        return false;
+    }
+
+    return true;
+  }
+
+  // Admin commands that change nothing
+  bool read_only_command(const std::string &command)
+  {
+    return command == "ping" || command == "list_objects" || command == "list_clients" ||
+           command == "list_notices";
+  }
+}
+
+Result_cache::Result_cache(const Result_cache_config &config)
+: m_config(config)
+{
+}
+
+bool Result_cache::cacheable(int mid, const std::string &payload, std::string *schema)
+{
+  if (mid == Mysqlx::ClientMessages::CRUD_FIND)
+  {
+    Mysqlx::Crud::Find find;
+    if (!find.ParseFromString(payload))
+      return false;
+
+    *schema = find.collection().schema();
+    return true;
+  }
+
+  if (mid == Mysqlx::ClientMessages::SQL_STMT_EXECUTE)
+  {
+    Mysqlx::Sql::StmtExecute execute;
+    if (!execute.ParseFromString(payload) || execute.namespace_() != "sql")
+      return false;
+
+    schema->clear();
+    return read_only_sql(execute.stmt());
+  }
+
+  return false;
+}
+
+std::shared_ptr<Result> Result_cache::find(int mid, const std::string &payload)
+{
+  std::shared_ptr<Result> ret_val;
+
+  std::unordered_map<std::string, Entry_list::iterator>::iterator found = m_index.find(cache_key(mid, payload));
+  if (found != m_index.end())
+  {
+    if (found->second->expires > Clock::now())
+    {
+      m_entries.splice(m_entries.begin(), m_entries, found->second);
+      ret_val = found->second->result->clone();
+    }
+    else
+      erase(found->second);
+  }
+
+  if (ret_val)
+    m_stats.hits++;
+  else
+    m_stats.misses++;
+
+  return ret_val;
+}
+
+void Result_cache::store(int mid, const std::string &payload, const std::string &schema, std::shared_ptr<Result> result)
+{
+  std::size_t size = payload.size() + result->buffered_size();
+  if (size > m_config.memory_limit)
+    return;
+
+  std::string key(cache_key(mid, payload));
+  std::unordered_map<std::string, Entry_list::iterator>::iterator found = m_index.find(key);
+  if (found != m_index.end())
+    erase(found->second);
+
+  while (!m_entries.empty() && m_stats.memory + size > m_config.memory_limit)
+    erase(--m_entries.end());
+
+  Entry entry;
+  entry.key = key;
+  entry.schema = schema;
+  entry.result = result->clone();
+  entry.size = size;
+  entry.expires = Clock::now() + std::chrono::milliseconds(m_config.ttl);
+  m_entries.push_front(entry);
+  m_index[key] = m_entries.begin();
+
+  m_stats.entries++;
+  m_stats.memory += size;
+}
+
+void Result_cache::sent(int mid, const char *payload, std::size_t length)
+{
+  if (m_entries.empty())
+    return;
+
+  switch (mid)
+  {
+    case Mysqlx::ClientMessages::CRUD_INSERT:
+    {
+      Mysqlx::Crud::Insert insert;
+      invalidate(insert.ParseFromArray(payload, static_cast<int>(length)) ? insert.collection().schema() : std::string());
+      break;
+    }
+
+    case Mysqlx::ClientMessages::CRUD_UPDATE:
+    {
+      Mysqlx::Crud::Update update;
+      invalidate(update.ParseFromArray(payload, static_cast<int>(length)) ? update.collection().schema() : std::string());
+      break;
+    }
+
+    case Mysqlx::ClientMessages::CRUD_DELETE:
+    {
+      Mysqlx::Crud::Delete remove;
+      invalidate(remove.ParseFromArray(payload, static_cast<int>(length)) ? remove.collection().schema() : std::string());
+      break;
+    }
+
+    case Mysqlx::ClientMessages::SQL_STMT_EXECUTE:
+    {
+      Mysqlx::Sql::StmtExecute execute;
+      if (!execute.ParseFromArray(payload, static_cast<int>(length)))
+        invalidate("");
+      else if (execute.namespace_() == "sql" ? !read_only_sql(execute.stmt()) : !read_only_command(execute.stmt()))
+        invalidate("");
+      break;
+    }
+
+    case Mysqlx::ClientMessages::SESS_RESET:
+    case Mysqlx::ClientMessages::SESS_AUTHENTICATE_START:
+      invalidate("");
+      break;
+  }
+}
+
+void Result_cache::invalidate(const std::string &schema)
+{
+  m_stats.invalidations++;
+
+  for (Entry_list::iterator entry = m_entries.begin(); entry != m_entries.end();)
+  {
+    Entry_list::iterator next = entry;
+    ++next;
+
+    if (schema.empty() || entry->schema.empty() || entry->schema == schema)
+      erase(entry);
+
+    entry = next;
+  }
+}
+
+void Result_cache::clear()
+{
+  m_entries.clear();
+  m_index.clear();
+  m_stats.entries = 0;
+  m_stats.memory = 0;
+}
+
+void Result_cache::erase(Entry_list::iterator entry)
+{
+  m_stats.entries--;
+  m_stats.memory -= entry->size;
+  m_index.erase(entry->key);
+  m_entries.erase(entry);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_RESULT_CACHE_H_
+#define _MYSQLX_RESULT_CACHE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <stdint.h>
+
+namespace mysqlx
+{
+  class Result;
+
+  // The results kept are dropped after ttl milliseconds (0 disables the
+  // cache) or when they do not fit in memory_limit bytes, oldest used first
+  struct Result_cache_config
+  {
+    Result_cache_config()
+    {
+      ttl = 0;
+      memory_limit = 16 * 1024 * 1024;
+    }
+
+    uint64_t ttl;
+    std::size_t memory_limit;
+  };
+
+  struct Result_cache_stats
+  {
+    Result_cache_stats()
+    {
+      hits = 0;
+      misses = 0;
+      invalidations = 0;
+      entries = 0;
+      memory = 0;
+    }
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;
+    std::size_t entries;
+    std::size_t memory;
+  };
+
+  // Buffered results of read only statements, by the message that produced
+  // them, bound values included. The same message sent again is answered
+  // with a copy of the result without going to the server. Every message
+  // sent that may change data drops the results of its schema, the SQL
+  // ones drop everything as their schema is unknown, and the results of SQL
+  // statements are dropped by any change as they may read any schema.
+  class Result_cache
+  {
+  public:
+    explicit Result_cache(const Result_cache_config &config);
+
+    const Result_cache_config &config() const { return m_config; }
+    const Result_cache_stats &stats() const { return m_stats; }
+
+    // Whether the result of the message may be kept, and the schema it
+    // reads, empty for SQL
+    static bool cacheable(int mid, const std::string &payload, std::string *schema);
+
+    // A copy of the result of the message, NULL if there is none
+    std::shared_ptr<Result> find(int mid, const std::string &payload);
+    // The result must be buffered, it is copied when found
+    void store(int mid, const std::string &payload, const std::string &schema, std::shared_ptr<Result> result);
+
+    // Called with every message sent
+    void sent(int mid, const char *payload, std::size_t length);
+
+    void clear();
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry
+    {
+      std::string key;
+      std::string schema;
+      std::shared_ptr<Result> result;
+      std::size_t size;
+      Clock::time_point expires;
+    };
+    typedef std::list<Entry> Entry_list;
+
+    // Drops the results of the schema and the ones of SQL statements
+    void invalidate(const std::string &schema);
+    void erase(Entry_list::iterator entry);
+
+    Result_cache_config m_config;
+    Result_cache_stats m_stats;
+    // Most recently used first
+    Entry_list m_entries;
+    std::unordered_map<std::string, Entry_list::iterator> m_index;
+  };
+} // namespace mysqlx
+
+#endif // _MYSQLX_RESULT_CACHE_H_
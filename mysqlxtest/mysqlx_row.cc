@@ -29,6 +29,93 @@
 #include <sstream>
 using namespace mysqlx;
 
+namespace
+{
+  // Continuation bits expected on the first 8 bytes of a varint of 1 to 9
+  // or more bytes
+  const uint64_t k_varint_continuation[] = {
+    0, 0, 0x80ULL, 0x8080ULL, 0x808080ULL, 0x80808080ULL, 0x8080808080ULL,
+    0x808080808080ULL, 0x80808080808080ULL, 0x8080808080808080ULL
+  };
+
+  // Decodes a varint that takes the whole buffer, as the fields of a row do,
+  // so the length of the varint is known upfront. The first 8 bytes are
+  // loaded into a single word and their 7 bit groups are packed together in
+  // three steps, halving the number of groups on each step, the 9th and 10th
+  // bytes are added afterwards. Returns false if the buffer does not hold
+  // such a varint so the caller can use the generic decoder.
+  inline bool varint_from_word(const std::string &buffer, uint64_t &value)
+  {
+    const std::size_t length = buffer.length();
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(buffer.data());
+
+    if (length == 1)
+    {
+      value = data[0];
+      return data[0] < 0x80;
+    }
+
+    if (length == 0 || length > 10)
+      return false;
+
+    const std::size_t word_length = length < 8 ? length : 8;
+    uint64_t word = 0;
+    for (std::size_t index = 0; index < word_length; ++index)
+      word |= static_cast<uint64_t>(data[index]) << (8 * index);
+
+    if ((word & 0x8080808080808080ULL) != k_varint_continuation[length < 9 ? length : 9])
+      return false;
+
+    word &= 0x7f7f7f7f7f7f7f7fULL;
+    word = ((word & 0x7f007f007f007f00ULL) >> 1) | (word & 0x007f007f007f007fULL);
+    word = ((word & 0x3fff00003fff0000ULL) >> 2) | (word & 0x00003fff00003fffULL);
+    word = ((word & 0x0fffffff00000000ULL) >> 4) | (word & 0x000000000fffffffULL);
+
+    if (length > 8)
+    {
+      if (length == 9 && data[8] >= 0x80)
+        return false;
+
+      // The 10th byte may only carry the highest bit of the value
+      if (length == 10 && (data[8] < 0x80 || data[9] > 1))
+        return false;
+
+      word |= static_cast<uint64_t>(data[8] & 0x7f) << 56;
+      if (length == 10)
+        word |= static_cast<uint64_t>(data[9]) << 63;
+    }
+
+    value = word;
+    return true;
+  }
+
+  // Reads the next varint of a field holding several of them, as temporal
+  // fields do, false once the field ends
+  inline bool next_varint(const unsigned char *&position, const unsigned char *end, uint64_t &value)
+  {
+    uint64_t result = 0;
+    for (int shift = 0; position < end && shift < 64; shift += 7)
+    {
+      unsigned char byte = *(position++);
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (byte < 0x80)
+      {
+        value = result;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // The two digits of every value from 0 to 99, so a BCD byte holding two
+  // digits is written at once
+  const char k_digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+}
+
 int64_t Row_decoder::s64_from_buffer(const std::string& buffer)
 {
   std::string& _buf = const_cast<std::string&>(buffer);
@@ -63,6 +150,35 @@ uint64_t Row_decoder::u64_from_buffer(const std::string& buffer)
   return value;
 }
 
+void Row_decoder::u64_from_buffers(const std::string *const *buffers, std::size_t count, uint64_t *result)
+{
+  for (std::size_t index = 0; index < count; ++index)
+  {
+    const std::string &buffer = *buffers[index];
+
+    if (buffer.empty())
+      result[index] = 0;
+    else if (!varint_from_word(buffer, result[index]))
+      result[index] = u64_from_buffer(buffer);
+  }
+}
+
+void Row_decoder::s64_from_buffers(const std::string *const *buffers, std::size_t count, int64_t *result)
+{
+  for (std::size_t index = 0; index < count; ++index)
+  {
+    const std::string &buffer = *buffers[index];
+    uint64_t value;
+
+    if (buffer.empty())
+      result[index] = 0;
+    else if (varint_from_word(buffer, value))
+      result[index] = google::protobuf::internal::WireFormatLite::ZigZagDecode64(value);
+    else
+      result[index] = s64_from_buffer(buffer);
+  }
+}
+
 const char *Row_decoder::string_from_buffer(const std::string& buffer, size_t &rlength)
 {
   /*Last byte contains trailing '\0' that we want to skip here*/
@@ -179,46 +295,19 @@ double Row_decoder::double_from_buffer(const std::string& buffer)
 }
 
 
-void Row_decoder::read_required_uint64(
-  google::protobuf::io::CodedInputStream& input_buffer,
-  google::protobuf::uint64& result
-  )
-{
-  google::protobuf::uint64 uint64;
-  bool ret = input_buffer.ReadVarint64(&uint64);
-  if (!ret)
-  {
-    throw std::invalid_argument("error reading value");
-  }
-  result = uint64;
-}
-
 DateTime Row_decoder::datetime_from_buffer(const std::string& buffer)
 {
-  google::protobuf::uint64 year, month, day, hour = 0, minutes = 0, seconds = 0, useconds = 0, tmp = 0;
-  std::string& _buf = const_cast<std::string&>(buffer);
-  google::protobuf::uint8* field_buff = reinterpret_cast<google::protobuf::uint8*>(&_buf[0]);
+  const unsigned char *position = reinterpret_cast<const unsigned char*>(buffer.data());
+  const unsigned char *end = position + buffer.length();
+  uint64_t year, month, day, hour = 0, minutes = 0, seconds = 0, useconds = 0;
 
-  google::protobuf::io::CodedInputStream input_buffer(field_buff, static_cast<int>(buffer.length()));
+  if (!next_varint(position, end, year) || !next_varint(position, end, month) || !next_varint(position, end, day))
+    throw std::invalid_argument("error reading value");
+
+  // The time is optional, and so is each of its parts after the first missing
+  if (next_varint(position, end, hour) && next_varint(position, end, minutes) && next_varint(position, end, seconds))
+    next_varint(position, end, useconds);
 
-  read_required_uint64(input_buffer, year);
-  read_required_uint64(input_buffer, month);
-  read_required_uint64(input_buffer, day);
-
-  bool has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  hour = tmp;
-  has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  minutes = tmp;
-  has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  seconds = tmp;
-  has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  useconds = tmp;
-
-RETURN:
   return DateTime(
     static_cast<uint16_t>(year),
     static_cast<uint8_t>(month),
@@ -232,29 +321,16 @@ RETURN:
 
 Time Row_decoder::time_from_buffer(const std::string& buffer)
 {
-  google::protobuf::uint64 hour = 0, minutes = 0, seconds = 0, useconds = 0, tmp = 0;
-  std::string& _buf = const_cast<std::string&>(buffer);
-  google::protobuf::uint8* field_buff = reinterpret_cast<google::protobuf::uint8*>(&_buf[0]);
+  const unsigned char *position = reinterpret_cast<const unsigned char*>(buffer.data());
+  const unsigned char *end = position + buffer.length();
+  uint64_t hour = 0, minutes = 0, seconds = 0, useconds = 0;
 
-  google::protobuf::io::CodedInputStream input_buffer(field_buff, static_cast<int>(buffer.length()));
+  bool negative = position < end && *(position++) != 0x00;
+
+  if (next_varint(position, end, hour) && next_varint(position, end, minutes) && next_varint(position, end, seconds))
+    next_varint(position, end, useconds);
 
-  google::protobuf::uint8 sign;
-  input_buffer.ReadRaw(&sign, 1);
-  bool has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  hour = tmp;
-  has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  minutes = tmp;
-  has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  seconds = tmp;
-  has_more = input_buffer.ReadVarint64(&tmp);
-  if (!has_more) goto RETURN;
-  useconds = tmp;
-
-RETURN:
-  return Time((sign != 0x00),
+  return Time(negative,
     static_cast<uint32_t>(hour),
     static_cast<uint8_t>(minutes),
     static_cast<uint8_t>(seconds),
@@ -269,5 +345,55 @@ Decimal Row_decoder::decimal_from_buffer(const std::string& buffer)
   return dec;
 }
 
+void Row_decoder::decimal_from_buffer_as_str(const std::string& buffer, std::string& result)
+{
+  // The scale, then the digits in BCD ending with the sign nibble, the
+  // same format Decimal::str() reads
+  if (buffer.empty())
+    throw invalid_value("Invalid decimal value " + buffer);
+
+  const std::size_t scale = static_cast<unsigned char>(buffer[0]);
+  const std::size_t start = result.length();
+  bool negative = false;
+
+  result.reserve(start + 2 * buffer.length() + 1);
+  for (std::size_t index = 1; index < buffer.length(); ++index)
+  {
+    const unsigned char byte = static_cast<unsigned char>(buffer[index]);
+    const unsigned high = byte >> 4;
+    const unsigned low = byte & 0xf;
+
+    if (high <= 9 && low <= 9)
+    {
+      result.append(k_digit_pairs + 2 * (high * 10 + low), 2);
+      continue;
+    }
+
+    if (high <= 9)
+    {
+      result.push_back(static_cast<char>('0' + high));
+      negative = (low == 0xb || low == 0xd);
+    }
+    else
+    {
+      negative = (high == 0xb || high == 0xd);
+    }
+    break;
+  }
+
+  const std::size_t digits = result.length() - start;
+  if (scale > digits)
+  {
+    result.resize(start);
+    throw invalid_value("Invalid decimal value " + buffer);
+  }
+
+  if (scale > 0)
+    result.insert(result.end() - scale, '.');
+
+  if (negative)
+    result.insert(result.begin() + start, '-');
+}
+
 
 //--------------------------------------------------------------
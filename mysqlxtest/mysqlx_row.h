@@ -20,6 +20,7 @@
 #ifndef _MYSQLX_ROW_H_
 #define _MYSQLX_ROW_H_
 
+#include <cstddef>
 #include <string>
 #include <set>
 #include <stdint.h>
@@ -43,15 +44,15 @@ namespace mysqlx
     static DateTime datetime_from_buffer(const std::string& buffer);
     static Time time_from_buffer(const std::string& buffer);
     static Decimal decimal_from_buffer(const std::string& buffer);
+    /* appends the decimal as text to the result, without building a Decimal */
+    static void decimal_from_buffer_as_str(const std::string& buffer, std::string& result);
     static void set_from_buffer(const std::string& buffer, std::set<std::string>& result);
     static std::string set_from_buffer_as_str(const std::string& buffer);
 
-  private:
-
-    static void read_required_uint64(
-      google::protobuf::io::CodedInputStream& input_buffer,
-      google::protobuf::uint64& result
-      );
+    /* bulk decoding of integer fields, as found on a column of a row batch,
+       empty buffers (null fields) are decoded as 0 */
+    static void u64_from_buffers(const std::string *const *buffers, std::size_t count, uint64_t *result);
+    static void s64_from_buffers(const std::string *const *buffers, std::size_t count, int64_t *result);
   };
 };
 
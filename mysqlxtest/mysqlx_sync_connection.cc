@@ -28,6 +28,7 @@
 #include "myasio/connection_factory_openssl.h"
 #include "myasio/connection_factory_yassl.h"
 #include "myasio/connection_factory_raw.h"
+#include "myasio/connection_factory_uring.h"
 #include "mysqlx_sync_connection.h"
 #include "mysql.h"
 
@@ -81,6 +82,12 @@ public:
     async_connection->async_connect(endpoint, get_status_callback(), On_asio_status_callback());
   }
 
+  void connect_local(ngs::IConnection_ptr async_connection, const std::string &path)
+  {
+    preproces(async_connection);
+    async_connection->async_connect_local(path, get_status_callback(), On_asio_status_callback());
+  }
+
   void accept(ngs::IConnection_ptr async_connection, boost::asio::ip::tcp::acceptor &acceptor)
   {
     preproces(async_connection);
@@ -240,6 +247,11 @@ ngs::Connection_factory_ptr Mysqlx_sync_connection::get_async_connection_factory
 #endif // !defined(DISABLE_SSL_ON_XPLUGIN)
   }
 
+#if defined(HAVE_IO_URING)
+  if (ngs::Connection_uring_factory::is_supported())
+    return boost::make_shared<ngs::Connection_uring_factory>();
+#endif
+
   return boost::make_shared<ngs::Connection_raw_factory>();
 }
 
@@ -252,6 +264,14 @@ error_code Mysqlx_sync_connection::connect(const Endpoint &ep)
 }
 
 
+error_code Mysqlx_sync_connection::connect_local(const std::string &path)
+{
+  details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
+  executor->connect_local(m_async_connection, path);
+  return executor->wait();
+}
+
+
 error_code Mysqlx_sync_connection::accept(const Endpoint &ep)
 {
   boost::asio::ip::tcp::acceptor acceptor(m_service, ep);
@@ -318,6 +338,20 @@ error_code Mysqlx_sync_connection::read(void *data, const std::size_t data_lengt
 }
 
 
+error_code Mysqlx_sync_connection::read_some(void *data, const std::size_t data_length, std::size_t &data_read)
+{
+  details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
+  Mutable_buffer_sequence buffers;
+
+  buffers.push_back(boost::asio::buffer(data, data_length));
+  executor->read(m_async_connection, buffers);
+  error_code error = executor->wait();
+  data_read = executor->get_number_of_bytes();
+
+  return error;
+}
+
+
 error_code Mysqlx_sync_connection::read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds)
 {
   error_code error;
@@ -44,12 +44,15 @@ public:
                          const std::size_t timeout = 0l);
 
   boost::system::error_code connect(const ngs::Endpoint &);
+  boost::system::error_code connect_local(const std::string &path);
   boost::system::error_code accept(const ngs::Endpoint &);
   boost::system::error_code activate_tls();
   boost::system::error_code shutdown(boost::asio::socket_base::shutdown_type how_to_shutdown);
 
   boost::system::error_code write(const void *data, const std::size_t data_length);
   boost::system::error_code read(void *data, const std::size_t data_length);
+  // Reads whatever is available, at least one byte and up to data_length
+  boost::system::error_code read_some(void *data, const std::size_t data_length, std::size_t &data_read);
   boost::system::error_code read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds);
 
   void close();
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mysqlx_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace mysqlx;
+
+const char Protocol_trace::k_magic[8] = { 'M', 'Y', 'X', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t Protocol_trace::k_version;
+const std::size_t Protocol_trace::k_default_capacity;
+
+namespace
+{
+  std::mutex g_current_mutex;
+  std::shared_ptr<Protocol_trace> g_current;
+
+  inline uint64_t aligned_size(uint64_t size)
+  {
+    return (size + 7) & ~uint64_t(7);
+  }
+
+  inline int64_t steady_now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  std::string system_error(const std::string &context, const std::string &path)
+  {
+#ifdef _WIN32
+    return context + " " + path + ": error " + std::to_string(GetLastError());
+#else
+    return context + " " + path + ": " + strerror(errno);
+#endif
+  }
+}
+
+void Protocol_trace::open(const std::string &path, std::size_t capacity)
+{
+  std::shared_ptr<Protocol_trace> trace(new Protocol_trace(path, capacity));
+
+  std::lock_guard<std::mutex> lock(g_current_mutex);
+  g_current = trace;
+}
+
+void Protocol_trace::close()
+{
+  std::lock_guard<std::mutex> lock(g_current_mutex);
+  g_current.reset();
+}
+
+std::shared_ptr<Protocol_trace> Protocol_trace::current()
+{
+  std::lock_guard<std::mutex> lock(g_current_mutex);
+  return g_current;
+}
+
+Protocol_trace::Protocol_trace(const std::string &path, std::size_t capacity)
+  : m_header(NULL), m_ring(NULL)
+{
+  // A record must always fit in the ring, so it is never smaller than the
+  // largest record header plus some payload
+  capacity = static_cast<std::size_t>(aligned_size(std::max<std::size_t>(capacity, 4096)));
+  m_mapped_size = sizeof(Trace_file_header) + capacity;
+
+  void *mapping = NULL;
+#ifdef _WIN32
+  m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                       CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m_file == INVALID_HANDLE_VALUE)
+    throw std::runtime_error(system_error("Unable to create the trace file", path));
+
+  uint64_t size = m_mapped_size;
+  m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                 static_cast<DWORD>(size & 0xffffffff), NULL);
+  if (m_mapping)
+    mapping = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_mapped_size);
+
+  if (!mapping)
+  {
+    std::string error = system_error("Unable to map the trace file", path);
+    if (m_mapping)
+      CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    throw std::runtime_error(error);
+  }
+#else
+  m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0640);
+  if (m_fd < 0)
+    throw std::runtime_error(system_error("Unable to create the trace file", path));
+
+  if (ftruncate(m_fd, static_cast<off_t>(m_mapped_size)) == 0)
+    mapping = mmap(NULL, m_mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+  if (!mapping || mapping == MAP_FAILED)
+  {
+    std::string error = system_error("Unable to map the trace file", path);
+    ::close(m_fd);
+    throw std::runtime_error(error);
+  }
+#endif
+
+  m_header = static_cast<Trace_file_header*>(mapping);
+  m_ring = static_cast<char*>(mapping) + sizeof(Trace_file_header);
+
+  std::memset(m_header, 0, sizeof(Trace_file_header));
+  std::memcpy(m_header->magic, k_magic, sizeof(k_magic));
+  m_header->version = k_version;
+  m_header->header_size = sizeof(Trace_file_header);
+  m_header->capacity = capacity;
+  m_header->start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+  m_steady_start = steady_now();
+}
+
+Protocol_trace::~Protocol_trace()
+{
+#ifdef _WIN32
+  UnmapViewOfFile(m_header);
+  CloseHandle(m_mapping);
+  CloseHandle(m_file);
+#else
+  munmap(m_header, m_mapped_size);
+  ::close(m_fd);
+#endif
+}
+
+void Protocol_trace::record(Direction direction, int type, const void *payload, std::size_t length)
+{
+  Trace_record_header record;
+  record.timestamp = static_cast<uint64_t>(steady_now() - m_steady_start);
+  record.frame_size = static_cast<uint32_t>(length);
+  record.direction = static_cast<uint8_t>(direction);
+  record.type = static_cast<uint8_t>(type);
+  std::memset(record.reserved, 0, sizeof(record.reserved));
+
+  // Big frames are truncated so a single one does not wipe the whole ring
+  const uint64_t capacity = m_header->capacity;
+  const uint64_t max_captured = capacity / 8 - sizeof(Trace_record_header);
+  record.captured = static_cast<uint32_t>(std::min<uint64_t>(length, max_captured));
+
+  const uint64_t size = aligned_size(sizeof(Trace_record_header) + record.captured);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  while (m_header->head + size - m_header->tail > capacity)
+  {
+    Trace_record_header oldest;
+    read_ring(m_header->tail, &oldest, sizeof(oldest));
+    m_header->tail += aligned_size(sizeof(Trace_record_header) + oldest.captured);
+    m_header->record_count--;
+  }
+
+  write_ring(m_header->head, &record, sizeof(record));
+  write_ring(m_header->head + sizeof(record), payload, record.captured);
+
+  m_header->head += size;
+  m_header->record_count++;
+}
+
+void Protocol_trace::write_ring(uint64_t offset, const void *data, std::size_t length)
+{
+  const uint64_t capacity = m_header->capacity;
+  std::size_t position = static_cast<std::size_t>(offset % capacity);
+  std::size_t first = std::min<std::size_t>(length, static_cast<std::size_t>(capacity - position));
+
+  std::memcpy(m_ring + position, data, first);
+  if (first < length)
+    std::memcpy(m_ring, static_cast<const char*>(data) + first, length - first);
+}
+
+void Protocol_trace::read_ring(uint64_t offset, void *data, std::size_t length) const
+{
+  const uint64_t capacity = m_header->capacity;
+  std::size_t position = static_cast<std::size_t>(offset % capacity);
+  std::size_t first = std::min<std::size_t>(length, static_cast<std::size_t>(capacity - position));
+
+  std::memcpy(data, m_ring + position, first);
+  if (first < length)
+    std::memcpy(static_cast<char*>(data) + first, m_ring, length - first);
+}
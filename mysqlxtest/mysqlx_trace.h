@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_TRACE_H_
+#define _MYSQLX_TRACE_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <stdint.h>
+
+namespace mysqlx
+{
+  /*
+   * Layout of a binary protocol trace file, the values are stored in the
+   * byte order of the host that wrote the trace.
+   *
+   * The file is a Trace_file_header followed by a ring of capacity bytes
+   * holding the records. head and tail are offsets that only grow, the
+   * position of a record in the ring is its offset modulo capacity. When a
+   * new record does not fit, the oldest records are dropped by moving tail.
+   *
+   * Each record is a Trace_record_header followed by captured bytes of the
+   * frame payload, padded to a multiple of 8 bytes. A record may wrap
+   * around the end of the ring.
+   */
+  struct Trace_file_header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t record_count;
+    // Wall clock time in nanoseconds since the epoch when the file was
+    // created, record timestamps are nanoseconds from this point
+    int64_t start_time;
+  };
+
+  struct Trace_record_header
+  {
+    uint64_t timestamp;
+    uint32_t frame_size;
+    uint32_t captured;
+    uint8_t direction;
+    uint8_t type;
+    uint8_t reserved[6];
+  };
+
+  // Records the frames sent and received by the connections into a memory
+  // mapped ring file. Writing a record is a copy into the mapping, so it can
+  // be left enabled under load, the file is read with mysqlxtrace.
+  class Protocol_trace
+  {
+  public:
+    enum Direction
+    {
+      Send = 0,
+      Receive = 1
+    };
+
+    static const char k_magic[8];
+    static const uint32_t k_version = 1;
+    static const std::size_t k_default_capacity = 64 * 1024 * 1024;
+
+    // Creates the trace file used by the connections opened afterwards,
+    // throws std::runtime_error if the file can not be created
+    static void open(const std::string &path, std::size_t capacity = k_default_capacity);
+    static void close();
+    static std::shared_ptr<Protocol_trace> current();
+
+    ~Protocol_trace();
+
+    void record(Direction direction, int type, const void *payload, std::size_t length);
+
+  private:
+    Protocol_trace(const std::string &path, std::size_t capacity);
+
+    void write_ring(uint64_t offset, const void *data, std::size_t length);
+    void read_ring(uint64_t offset, void *data, std::size_t length) const;
+
+    std::mutex m_mutex;
+    Trace_file_header *m_header;
+    char *m_ring;
+    std::size_t m_mapped_size;
+    int64_t m_steady_start;
+#ifdef _WIN32
+    void *m_file;
+    void *m_mapping;
+#else
+    int m_fd;
+#endif
+  };
+}
+
+#endif
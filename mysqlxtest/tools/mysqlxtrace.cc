@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Decodes a binary protocol trace written with --trace-proto-file, printing
+// one line per frame with its time, the time since the previous frame, the
+// direction and the message type. With --messages the payload of every frame
+// is printed in protobuf text format as done by --trace-proto.
+
+#undef ERROR //Needed to avoid conflict with ERROR in mysqlx.pb.h
+
+#include "ngs_common/protocol_protobuf.h"
+#include "mysqlx.pb.h"
+#include "mysqlx_connection.pb.h"
+#include "mysqlx_crud.pb.h"
+#include "mysqlx_expect.pb.h"
+#include "mysqlx_notice.pb.h"
+#include "mysqlx_resultset.pb.h"
+#include "mysqlx_session.pb.h"
+#include "mysqlx_sql.pb.h"
+#include "mysqlx_trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mysqlx
+{
+  typedef google::protobuf::Message Message;
+}
+
+typedef mysqlx::Message *(*Message_factory)();
+typedef std::map<int, std::pair<Message_factory, std::string> > Message_by_id;
+typedef std::map<std::string, std::pair<Message_factory, int> > Message_by_name;
+typedef std::map<std::string, std::string> Message_by_full_name;
+
+static Message_by_id server_msgs_by_id;
+static Message_by_name server_msgs_by_name;
+static Message_by_full_name server_msgs_by_full_name;
+static Message_by_id client_msgs_by_id;
+static Message_by_name client_msgs_by_name;
+static Message_by_full_name client_msgs_by_full_name;
+
+#include "mysqlx_all_msgs.h"
+
+namespace
+{
+  class Trace_reader
+  {
+  public:
+    explicit Trace_reader(const std::string &path)
+    {
+      std::ifstream file(path.c_str(), std::ios::binary);
+      if (!file)
+        throw std::runtime_error("Unable to open " + path);
+
+      file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+      if (!file || memcmp(m_header.magic, mysqlx::Protocol_trace::k_magic, sizeof(m_header.magic)) != 0)
+        throw std::runtime_error(path + " is not a protocol trace file");
+
+      if (m_header.version != mysqlx::Protocol_trace::k_version)
+        throw std::runtime_error(path + " has an unsupported trace format version");
+
+      m_ring.resize(static_cast<size_t>(m_header.capacity));
+      file.seekg(m_header.header_size);
+      file.read(&m_ring[0], m_ring.size());
+      if (!file)
+        throw std::runtime_error(path + " is truncated");
+
+      m_offset = m_header.tail;
+    }
+
+    const mysqlx::Trace_file_header &header() const { return m_header; }
+
+    bool next(mysqlx::Trace_record_header &record, std::string &payload)
+    {
+      if (m_offset + sizeof(record) > m_header.head)
+        return false;
+
+      read(m_offset, &record, sizeof(record));
+      payload.resize(record.captured);
+      if (record.captured)
+        read(m_offset + sizeof(record), &payload[0], record.captured);
+
+      m_offset += (sizeof(record) + record.captured + 7) & ~uint64_t(7);
+      return true;
+    }
+
+  private:
+    void read(uint64_t offset, void *data, size_t length) const
+    {
+      size_t position = static_cast<size_t>(offset % m_header.capacity);
+      size_t first = std::min(length, m_ring.size() - position);
+
+      memcpy(data, &m_ring[position], first);
+      if (first < length)
+        memcpy(static_cast<char*>(data) + first, &m_ring[0], length - first);
+    }
+
+    mysqlx::Trace_file_header m_header;
+    std::vector<char> m_ring;
+    uint64_t m_offset;
+  };
+
+  std::string format_time(int64_t nanoseconds)
+  {
+    time_t seconds = static_cast<time_t>(nanoseconds / 1000000000);
+    struct tm tm;
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char buffer[64];
+    size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    snprintf(buffer + length, sizeof(buffer) - length, ".%06d",
+             static_cast<int>((nanoseconds % 1000000000) / 1000));
+    return buffer;
+  }
+
+  void print_usage()
+  {
+    std::cerr << "Usage: mysqlxtrace [--messages] <trace file>\n";
+  }
+}
+
+int main(int argc, char **argv)
+{
+  bool print_messages = false;
+  std::string path;
+
+  for (int index = 1; index < argc; index++)
+  {
+    if (strcmp(argv[index], "--messages") == 0)
+      print_messages = true;
+    else if (path.empty() && argv[index][0] != '-')
+      path = argv[index];
+    else
+    {
+      print_usage();
+      return 1;
+    }
+  }
+
+  if (path.empty())
+  {
+    print_usage();
+    return 1;
+  }
+
+  try
+  {
+    Trace_reader reader(path);
+    mysqlx::Trace_record_header record;
+    std::string payload;
+    uint64_t previous = 0;
+    bool first = true;
+
+    google::protobuf::TextFormat::Printer printer;
+    printer.SetInitialIndentLevel(1);
+
+    while (reader.next(record, payload))
+    {
+      bool sent = record.direction == mysqlx::Protocol_trace::Send;
+      const Message_by_id &messages = sent ? client_msgs_by_id : server_msgs_by_id;
+      Message_by_id::const_iterator message = messages.find(record.type);
+
+      double delta = first ? 0.0 : static_cast<double>(record.timestamp - previous) / 1000.0;
+      first = false;
+      previous = record.timestamp;
+
+      char elapsed[32];
+      snprintf(elapsed, sizeof(elapsed), " +%12.3fus ", delta);
+
+      std::cout << format_time(reader.header().start_time + static_cast<int64_t>(record.timestamp));
+      std::cout << elapsed << (sent ? ">>>> SEND " : "<<<< RECEIVE ") << record.frame_size << " ";
+      if (message != messages.end())
+        std::cout << message->second.second;
+      else
+        std::cout << "UNKNOWN(" << static_cast<int>(record.type) << ")";
+      if (record.captured < record.frame_size)
+        std::cout << " (" << record.captured << " bytes captured)";
+      std::cout << "\n";
+
+      if (print_messages && message != messages.end() && record.captured == record.frame_size)
+      {
+        std::unique_ptr<mysqlx::Message> msg(message->second.first());
+        std::string out;
+        if (msg->ParsePartialFromString(payload))
+          printer.PrintToString(*msg, &out);
+        std::cout << msg->GetDescriptor()->full_name() << " {\n" << out << "}\n";
+      }
+    }
+  }
+  catch (std::exception &e)
+  {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -35,20 +35,26 @@ check_connector_python()
 
 # pylint: disable=wrong-import-position,wrong-import-order
 import argparse
+import json
 import logging
 import os
 import sys
+import traceback
+
+try:
+    from StringIO import StringIO
+except ImportError:
+    from io import StringIO
 
 from mysql_gadgets.common import options, logger
 from mysql_gadgets.common.group_replication import \
     OPT_SKIP_CHECK_GR_SCHEMA_COMPLIANCE, GR_SSL_DISABLED
 from mysql_gadgets.command.gr_admin import check, CHECK, join, health, \
     HEALTH, leave, STATUS, start
-from mysql_gadgets.command.clone import clone_server
 from mysql_gadgets.command.sandbox import create_sandbox, stop_sandbox, \
     kill_sandbox, delete_sandbox, start_sandbox, DEFAULT_SANDBOX_DIR, \
     SANDBOX_TIMEOUT, SANDBOX, SANDBOX_CREATE, SANDBOX_DELETE, SANDBOX_KILL, \
-    SANDBOX_START, SANDBOX_STOP
+    SANDBOX_START, SANDBOX_STOP, SANDBOX_PROFILES
 from mysql_gadgets.common.constants import PATH_ENV_VAR
 from mysql_gadgets.adapters import MYSQL_DEST, MYSQL_SOURCE
 from mysql_gadgets.exceptions import GadgetError
@@ -190,6 +196,15 @@ _SAND_IGNORE_SSL_HELP = ("Create sandbox tries to add SSL support by default "
                          "if not already available. Use this option to allow "
                          "the sandbox instance to be created without SSL "
                          "support.")
+_SAND_USE_TEMPLATE_HELP = ("Create the data directory of the sandbox as a "
+                           "copy of a template data directory kept in the "
+                           "sandbox base path for the server version, instead "
+                           "of initializing a new one. The template is "
+                           "initialized by the first sandbox using it.")
+_SAND_PROFILE_HELP = ("Set of option file values the sandbox is created "
+                      "with, before the ones given with --opt. The 'dense' "
+                      "profile keeps the memory used by the sandbox small, "
+                      "to run many sandboxes on the same host.")
 
 _EPILOGUE = (
     """Introduction
@@ -271,7 +286,8 @@ _ERROR_NO_SSL_SUPPORT_SESSION = (
     "without using any SSL certificate options and re-execute the command "
     "again.")
 
-if __name__ == "__main__":
+def main():
+    """Runs the command given on the command line."""
     # retrieve logger
     _LOGGER = logging.getLogger(_SCRIPT_NAME)
 
@@ -600,6 +616,18 @@ if __name__ == "__main__":
                                            action="store_true",
                                            help=_SAND_IGNORE_SSL_HELP)
 
+    # Add use template option
+    sub_parser_sandbox_create.add_argument("--use-template",
+                                           dest="use_template",
+                                           action="store_true",
+                                           help=_SAND_USE_TEMPLATE_HELP)
+
+    # Add profile option
+    sub_parser_sandbox_create.add_argument("--profile", dest="profile",
+                                           choices=sorted(SANDBOX_PROFILES),
+                                           default="default",
+                                           help=_SAND_PROFILE_HELP)
+
     # add option to read passwords from stdin
     options.add_stdin_password_option(sub_parser_sandbox_create)
     options.add_stdin_password_option(sub_parser_sandbox_stop)
@@ -875,6 +903,8 @@ if __name__ == "__main__":
             check(**cmd_options)
 
         elif command == CLONE:
+            # Only this command needs it
+            from mysql_gadgets.command.clone import clone_server
             command_error_msg = "cloning instance"
             clone_server(connection_dict, adapter_name)
 
@@ -932,3 +962,72 @@ if __name__ == "__main__":
 
     # Operation completed with success.
     sys.exit(0)
+
+
+def _write_frame(frame):
+    """Writes a worker protocol frame to stdout.
+
+    :param frame: The frame, a JSON object on its own line.
+    :type frame: dict
+    """
+    sys.stdout.write(json.dumps(frame) + "\n")
+    sys.stdout.flush()
+
+
+def run_worker():
+    """Runs the commands requested on stdin, one at a time.
+
+    Every request is a line with a JSON object holding the command line
+    arguments ("args") and the data the command reads from stdin ("stdin"),
+    an empty line ends the worker. Each command runs on a forked copy of this
+    process, so the interpreter startup and the imports are paid only once,
+    and its output is followed by a frame of type EXIT with its exit code.
+    The worker writes a frame of type READY once it accepts requests.
+    """
+    _write_frame({"type": "READY"})
+    while True:
+        line = sys.stdin.readline()
+        if not line.strip():
+            break
+
+        request = json.loads(line)
+        pid = os.fork()
+        if pid == 0:
+            exit_code = 0
+            try:
+                sys.stdin = StringIO(request.get("stdin", ""))
+                sys.argv = [sys.argv[0]] + [
+                    arg if isinstance(arg, str) else arg.encode("utf-8")
+                    for arg in request["args"]]
+                main()
+            except SystemExit:
+                _, err, _ = sys.exc_info()
+                if err.code is None:
+                    exit_code = 0
+                elif isinstance(err.code, int):
+                    exit_code = err.code
+                else:
+                    sys.stderr.write("{0}\n".format(err.code))
+                    exit_code = 1
+            except Exception:  # pylint: disable=broad-except
+                traceback.print_exc()
+                exit_code = 1
+            sys.stdout.flush()
+            sys.stderr.flush()
+            os._exit(exit_code)  # pylint: disable=protected-access
+
+        _, status = os.waitpid(pid, 0)
+        if os.WIFEXITED(status):
+            exit_code = os.WEXITSTATUS(status)
+        else:
+            exit_code = 1
+        _write_frame({"type": "EXIT", "exit_code": exit_code})
+
+
+if __name__ == "__main__":
+    # The shell keeps a worker for the whole session instead of starting
+    # a process per command, it is not available without fork
+    if sys.argv[1:] == ["--worker"] and hasattr(os, "fork"):
+        run_worker()
+    else:
+        main()
@@ -17,9 +17,11 @@
 """Adapter module for mysqldump."""
 
 import logging
+import multiprocessing
 import os
 import subprocess
 import shlex
+import threading
 
 from mysql_gadgets.adapters import (StreamClone, ImageClone, WithValidation,
                                     MYSQL_DEST, MYSQL_SOURCE)
@@ -41,6 +43,33 @@ _MYSQLDUMP_STREAM_BACKUP_CMD = (
     "--ignore-table=mysql.general_log "
     "--ignore-table=mysql.slow_log")
 
+# Dump of the mysql schema, which carries the accounts and the GTID state of
+# the source. It is applied before the other databases, since it recreates
+# the tables holding their routines and events.
+_MYSQLDUMP_STREAM_SYSTEM_BACKUP_CMD = (
+    "{quote}{mysqldump_exec}{quote} --defaults-file={quote}{config_file}"
+    "{quote} --triggers --events --routines --opt "
+    "--flush-privileges --set-gtid-purged=AUTO --ignore-table=mysql.plugin "
+    "--ignore-table=mysql.slave_relay_log_info "
+    "--ignore-table=mysql.slave_master_info "
+    "--ignore-table=mysql.general_log "
+    "--ignore-table=mysql.slow_log --databases mysql")
+
+# Dump of a subset of the user databases, followed by their names. Each of
+# these streams is applied with the binary log disabled, so the destination
+# only gets the GTID set of the source.
+_MYSQLDUMP_STREAM_DATA_BACKUP_CMD = (
+    "{quote}{mysqldump_exec}{quote} --defaults-file={quote}{config_file}"
+    "{quote} --triggers --events --routines --opt --set-gtid-purged=OFF "
+    "--databases")
+
+_MYSQLDUMP_STREAM_DATA_RESTORE_OPTS = (
+    "--init-command={quote}SET SESSION sql_log_bin = 0{quote}")
+
+_GET_DATABASE_SIZES = (
+    "SELECT TABLE_SCHEMA, SUM(DATA_LENGTH + INDEX_LENGTH) "
+    "FROM INFORMATION_SCHEMA.TABLES GROUP BY TABLE_SCHEMA")
+
 _MYSQLDUMP_STREAM_RESTORE_CMD = (
     "{quote}{mysqlc_exec}{quote} --defaults-file={quote}{config_file}{quote}")
 
@@ -53,6 +82,83 @@ _MYSQLDUMP_IMAGE_RESTORE_CMD = (
 )
 
 
+def _split_databases(source_server, databases, max_streams):
+    """Split the databases into streams of a similar size.
+
+    :param source_server: Server holding the databases.
+    :type source_server: Server
+    :param databases: names of the databases to split.
+    :type databases: list
+    :param max_streams: maximum number of streams.
+    :type max_streams: int
+    :return: list with the database names of each stream.
+    :rtype: list
+    """
+    sizes = {}
+    for row in source_server.exec_query(_GET_DATABASE_SIZES):
+        sizes[row[0]] = int(row[1] or 0)
+
+    streams = [[] for _ in range(max(1, min(max_streams, len(databases))))]
+    stream_sizes = [0] * len(streams)
+    # Largest databases first, each one to the smallest stream so far
+    for database in sorted(databases, key=lambda name: sizes.get(name, 0),
+                           reverse=True):
+        index = stream_sizes.index(min(stream_sizes))
+        streams[index].append(database)
+        stream_sizes[index] += sizes.get(database, 0)
+
+    return [stream for stream in streams if stream]
+
+
+def _run_stream(backup_cmd, restore_cmd):
+    """Pipe the output of a mysqldump command into a mysql client command.
+
+    :param backup_cmd: command list of the dump.
+    :type backup_cmd: list
+    :param restore_cmd: command list of the restore.
+    :type restore_cmd: list
+    :return: the errors of the processes, empty if both succeeded.
+    :rtype: str
+    """
+    _LOGGER.debug("Dumping contents of source server using command: "
+                  "%s", " ".join(backup_cmd))
+
+    dump_process = subprocess.Popen(backup_cmd, stdout=subprocess.PIPE,
+                                    stderr=subprocess.PIPE,
+                                    universal_newlines=True)
+    _LOGGER.debug("Restoring contents to destination server using "
+                  "command: %s", " ".join(restore_cmd))
+    restore_process = subprocess.Popen(restore_cmd,
+                                       stdin=dump_process.stdout,
+                                       stdout=subprocess.PIPE,
+                                       stderr=subprocess.PIPE,
+                                       universal_newlines=True)
+    # We call dump_process.stdout.close before
+    # restore_process.communicate so that if restore_process dies
+    # prematurely the SIGPIPE signal can be processed by dump_process
+    # allowing it to exit.
+    dump_process.stdout.close()
+    # Wait for restore process to end and get the output.
+    _, err = restore_process.communicate()
+    dump_process.wait()
+    error_msg = ""
+    if dump_process.returncode:
+        error_msg = (
+            "mysqldump exited with error code '{0}' and message: "
+            "'{1}'. ".format(dump_process.returncode,
+                             dump_process.stderr.read().strip()))
+    else:
+        _LOGGER.info("Dump process successfully completed.")
+    if restore_process.returncode:
+        error_msg += (
+            "MySQL client exited with error code '{0}' and message: "
+            "'{1}'".format(restore_process.returncode, err.strip()))
+    else:
+        _LOGGER.info("Restore process successfully completed.")
+
+    return error_msg
+
+
 class MySQLDump(StreamClone, ImageClone, WithValidation):
     """"Stream server clone using mysqldump."""
     @staticmethod
@@ -119,19 +225,22 @@ class MySQLDump(StreamClone, ImageClone, WithValidation):
         client_config_file = Server.to_config_file(destination_server,
                                                    "client")
 
-        # Create command list to create the backup
-        backup_cmd = shlex.split(
-            _MYSQLDUMP_STREAM_BACKUP_CMD.format(mysqldump_exec=mysqldump_exe,
-                                                config_file=dump_config_file,
-                                                quote=QUOTE_CHAR))
-
-        # Create command list to restore the backup
+        # Create command list to restore the backups
         restore_cmd = shlex.split(
             _MYSQLDUMP_STREAM_RESTORE_CMD.format(
                 mysqlc_exec=mysqlc_exe, config_file=client_config_file,
                 quote=QUOTE_CHAR
             ))
 
+        # The client protocol compression only pays off when the data
+        # crosses the network
+        compress_opts = []
+        if not source_server.is_alias("localhost"):
+            compress_opts.append("--compress")
+        dest_compress_opts = []
+        if not destination_server.is_alias("localhost"):
+            dest_compress_opts.append("--compress")
+
         # enable global read_lock
         _LOGGER.debug("Locking global read lock on source server to prevent "
                       "modifications during clone.")
@@ -139,43 +248,51 @@ class MySQLDump(StreamClone, ImageClone, WithValidation):
         _LOGGER.debug("Source server locked (read-only=ON)")
 
         try:
-            _LOGGER.debug("Dumping contents of source server using command: "
-                          "%s", " ".join(backup_cmd))
+            # The source is read only until the end of the clone, so all the
+            # streams dump the same contents
+            system_backup_cmd = shlex.split(
+                _MYSQLDUMP_STREAM_SYSTEM_BACKUP_CMD.format(
+                    mysqldump_exec=mysqldump_exe,
+                    config_file=dump_config_file, quote=QUOTE_CHAR))
+            error_msg = _run_stream(
+                system_backup_cmd[:2] + compress_opts + system_backup_cmd[2:],
+                restore_cmd[:2] + dest_compress_opts + restore_cmd[2:])
+            if error_msg:
+                raise exceptions.GadgetError(error_msg)
 
-            dump_process = subprocess.Popen(backup_cmd, stdout=subprocess.PIPE,
-                                            stderr=subprocess.PIPE,
-                                            universal_newlines=True)
-            _LOGGER.debug("Restoring contents to destination server using "
-                          "command: %s", " ".join(restore_cmd))
-            restore_process = subprocess.Popen(restore_cmd,
-                                               stdin=dump_process.stdout,
-                                               stdout=subprocess.PIPE,
-                                               stderr=subprocess.PIPE,
-                                               universal_newlines=True)
-            # We call dump_process.stdout.close before
-            # restore_process.communicate so that if restore_process dies
-            # prematurely the SIGPIPE signal can be processed by dump_process
-            # allowing it to exit.
-            dump_process.stdout.close()
-            # Wait for restore process to end and get the output.
-            _, err = restore_process.communicate()
-            dump_process.wait()
-            error_msg = ""
-            if dump_process.returncode:
-                error_msg = (
-                    "mysqldump exited with error code '{0}' and message: "
-                    "'{1}'. ".format(dump_process.returncode,
-                                     dump_process.stderr.read().strip()))
-            else:
-                _LOGGER.info("Dump process successfully completed.")
-            if restore_process.returncode:
-                error_msg += (
-                    "MySQL client exited with error code '{0}' and message: "
-                    "'{1}'".format(restore_process.returncode, err.strip()))
-            else:
-                _LOGGER.info("Restore process successfully completed.")
+            databases = [row[0] for row in source_server.get_all_databases()
+                         if row[0] != "mysql"]
+            streams = _split_databases(source_server, databases,
+                                       multiprocessing.cpu_count())
+            _LOGGER.debug("Cloning %d databases using %d parallel streams.",
+                          len(databases), len(streams))
+
+            data_backup_cmd = shlex.split(
+                _MYSQLDUMP_STREAM_DATA_BACKUP_CMD.format(
+                    mysqldump_exec=mysqldump_exe,
+                    config_file=dump_config_file, quote=QUOTE_CHAR))
+            data_restore_cmd = (
+                restore_cmd[:2] + dest_compress_opts + shlex.split(
+                    _MYSQLDUMP_STREAM_DATA_RESTORE_OPTS.format(
+                        quote=QUOTE_CHAR)) + restore_cmd[2:])
+
+            errors = [""] * len(streams)
+
+            def run_data_stream(index):
+                """Run the dump and restore of the databases of a stream."""
+                errors[index] = _run_stream(
+                    data_backup_cmd[:2] + compress_opts +
+                    data_backup_cmd[2:] + streams[index], data_restore_cmd)
+
+            threads = [threading.Thread(target=run_data_stream, args=(index,))
+                       for index in range(len(streams))]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
 
             # If there were errors, raise an exception to warn the user.
+            error_msg = " ".join(error for error in errors if error)
             if error_msg:
                 raise exceptions.GadgetError(error_msg)
         finally:
@@ -106,7 +106,9 @@ _WARN_DRY_RUN_USED = ("None of the previous changes were made. Changes are "
                       "--dry-run option.")
 
 max_screen_width = get_max_display_width()
-# Define how much time wait before check for super_read_only to be unset
+# Define how much time wait before check for super_read_only to be unset,
+# the wait starts at FIRST_WAIT_SECONDS and doubles up to WAIT_SECONDS
+FIRST_WAIT_SECONDS = 0.05
 WAIT_SECONDS = 1
 # Define for how long time wait super_read_only to be unset
 TIME_OUT = 15 * 60  # 15 minutes
@@ -456,10 +458,14 @@ def start(server_info, **kwargs):
         super_read_only = server.select_variable("super_read_only", 'global')
         _LOGGER.debug("super_read_only: %s", super_read_only)
         waiting_time = 0
+        wait_seconds = FIRST_WAIT_SECONDS
         informed = False
         while int(super_read_only) and waiting_time < TIME_OUT:
-            time.sleep(WAIT_SECONDS)
-            waiting_time += WAIT_SECONDS
+            # The wait grows from a short one, so the start is noticed as
+            # soon as it happens instead of on the next full second
+            time.sleep(wait_seconds)
+            waiting_time += wait_seconds
+            wait_seconds = min(wait_seconds * 2, WAIT_SECONDS)
             _LOGGER.debug("have been waiting %s seconds", waiting_time)
             # inform what are we waiting for
             if waiting_time >= 10 and not informed:
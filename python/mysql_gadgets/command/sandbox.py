@@ -21,12 +21,16 @@
 from __future__ import print_function
 import errno
 import getpass
+import hashlib
 import logging
 import os
 import time
 import shutil
 import subprocess
 import sys
+# pylint: disable=E0401
+if os.name == "posix":
+    import fcntl
 
 from mysql_gadgets.common import tools, server
 from mysql_gadgets.common.constants import PATH_ENV_VAR, QUOTE_CHAR
@@ -56,9 +60,46 @@ _MAX_RMTREE_RETRIES = 5
 DEFAULT_SANDBOX_DIR = "~/mysql-sandboxes"
 
 _LOCKFILE_NAME = "lockfile"
+_TEMPLATES_DIR_NAME = "templates"
+# ioctl request of Linux to share the extents of a file (reflink)
+_FICLONE = 0x40049409
+# Timeout to wait for the template datadir to be initialized by other sandbox
+_TEMPLATE_TIMEOUT = 300
 _SERVER_READY_LOG_MESSAGES = ("mysqld: ready for connections.",
                               "mysqld.exe: ready for connections.")
 
+# Option file values of each sandbox profile, they go over the defaults of
+# the sandbox and under the options given with --opt.
+# The dense profile is for hosts running many sandboxes (i.e. test suites):
+# the buffers and caches sized by default for a single server on the host
+# are kept to a few MB, performance_schema keeps the tables the AdminAPI
+# reads (replication_group_members) but with no instruments enabled and
+# small sizes, and the message cache of Group Replication gets its minimum.
+SANDBOX_PROFILES = {
+    "default": {},
+    "dense": {
+        "innodb_buffer_pool_size": "32M",
+        "innodb_log_buffer_size": "1M",
+        "innodb_log_file_size": "8M",
+        "innodb_page_cleaners": "1",
+        "innodb_purge_threads": "1",
+        "innodb_read_io_threads": "1",
+        "innodb_write_io_threads": "1",
+        "binlog_cache_size": "32K",
+        "key_buffer_size": "1M",
+        "max_connections": "50",
+        "table_open_cache": "200",
+        "table_definition_cache": "400",
+        "thread_cache_size": "4",
+        "performance_schema_instrument": "'%=OFF'",
+        "performance_schema_digests_size": "100",
+        "performance_schema_max_table_instances": "100",
+        "performance_schema_max_sql_text_length": "256",
+        "performance_schema_max_digest_length": "256",
+        "loose_group_replication_message_cache_size": "128M",
+    },
+}
+
 # Sandbox commands
 SANDBOX = "sandbox"
 SANDBOX_START = "start"
@@ -333,6 +374,196 @@ def sandbox_exists(**kwargs):
     return os.path.isdir(sandbox_dir) and os.listdir(sandbox_dir)
 
 
+def _get_initialize_cmd(mysqld_path, config_file):
+    """Get the command to initialize a data directory.
+
+    :param mysqld_path: Path to the mysqld executable.
+    :type mysqld_path: str
+    :param config_file: Option file with the datadir to initialize.
+    :type config_file: str
+    :return: The command string.
+    :rtype: str
+    """
+    init_cmd = _CREATE_SANDBOX_CMD.format(
+        quote=QUOTE_CHAR, mysqld_path=mysqld_path,
+        config_file=os.path.normpath(config_file))
+
+    # If we are running the script as root , the --user=root option is needed
+    if os.name == "posix" and getpass.getuser() == "root":
+        init_cmd = "{0} --user=root".format(init_cmd)
+
+    return init_cmd
+
+
+def _get_template_dir(sandbox_base_dir, mysqld_ver, version_str,
+                      mysqld_opts):
+    """Get the path of the template datadir for a server version.
+
+    The name starts with the server version, followed by a digest of the
+    complete version string (builds of the same version may differ) and of
+    the options given with --opt, as some of them (i.e. innodb_page_size)
+    change the contents of the initialized datadir.
+
+    :param sandbox_base_dir: Base path of the MySQL sandbox instances.
+    :type sandbox_base_dir: str
+    :param mysqld_ver: Version of the mysqld executable.
+    :type mysqld_ver: tuple
+    :param version_str: Version string of the mysqld executable.
+    :type version_str: str
+    :param mysqld_opts: Options given for the [mysqld] section.
+    :type mysqld_opts: list
+    :return: The path of the template datadir.
+    :rtype: str
+    """
+    digest = hashlib.sha1("\n".join([version_str] + sorted(mysqld_opts))
+                          .encode("utf-8")).hexdigest()
+    name = "{0}-{1}".format(".".join(str(i) for i in mysqld_ver), digest[:8])
+    return os.path.join(sandbox_base_dir, _TEMPLATES_DIR_NAME, name)
+
+
+def _create_template_datadir(template_dir, mysqld_path, opt_dict):
+    """Initialize the template datadir if it does not exist yet.
+
+    Sandboxes created at the same time share the template, the first one
+    initializes it while the others wait for the initialization to finish.
+
+    :param template_dir: Path of the template datadir.
+    :type template_dir: str
+    :param mysqld_path: Path to the mysqld executable.
+    :type mysqld_path: str
+    :param opt_dict: Option file dictionary of the sandbox being created.
+    :type opt_dict: dict
+
+    :raises GadgetError: If the template datadir can not be initialized.
+    """
+    lock_dir = "{0}.lock".format(template_dir)
+    deadline = time.time() + _TEMPLATE_TIMEOUT
+    # The template appears (or the lock goes away) in the parent directory
+    with tools.FileWatcher(os.path.dirname(template_dir)) as watcher:
+        while not os.path.isdir(template_dir):
+            try:
+                os.makedirs(lock_dir)
+                break
+            except OSError as err:
+                if err.errno != errno.EEXIST:
+                    raise exceptions.GadgetError(
+                        _ERROR_CREATE_DIR.format(dir="template",
+                                                 dir_path=lock_dir,
+                                                 error=str(err)))
+            if time.time() >= deadline:
+                raise exceptions.GadgetError(
+                    "Timeout waiting for the template datadir '{0}' to be "
+                    "initialized. Remove '{1}' if no sandbox is being "
+                    "created.".format(template_dir, lock_dir))
+            watcher.wait(min(deadline - time.time(), 1))
+        else:
+            return
+
+    try:
+        # Another sandbox may have finished the initialization in between
+        if os.path.isdir(template_dir):
+            return
+
+        _LOGGER.debug("Initializing template datadir '%s'.", template_dir)
+        init_datadir = os.path.join(lock_dir, "sandboxdata")
+        init_opt_dict = {"mysqld": dict(opt_dict["mysqld"])}
+        init_opt_dict["mysqld"].update({
+            "datadir": init_datadir.replace("\\", "/"),
+            "log_error": os.path.join(lock_dir,
+                                      "error.log").replace("\\", "/"),
+            "pid_file": os.path.join(lock_dir,
+                                     "mysqld.pid").replace("\\", "/"),
+        })
+        optf_path = tools.create_option_file(init_opt_dict, "my.cnf",
+                                             lock_dir)
+
+        init_proc = tools.run_subprocess(
+            _get_initialize_cmd(mysqld_path, optf_path), shell=False)
+        init_proc.wait()
+        if init_proc.returncode != 0:
+            raise exceptions.GadgetError(
+                "Error initializing template datadir '{0}'. Initialize "
+                "process failed with return code '{1}'. Check error log "
+                "file '{2}'.".format(template_dir, init_proc.returncode,
+                                     os.path.join(lock_dir, "error.log")))
+
+        # The rename makes the template visible only once it is complete
+        os.rename(init_datadir, template_dir)
+        _LOGGER.debug("Template datadir initialized.")
+    finally:
+        shutil.rmtree(lock_dir, ignore_errors=True)
+
+
+def _clone_file(source, target):
+    """Create a file of a sandbox datadir from the template datadir file.
+
+    The file is cloned with a reflink if the file system supports it (i.e.
+    Btrfs or XFS), the clone shares the data of the template until either of
+    them is written. Otherwise the file is copied. Nothing is hard linked,
+    the server of a sandbox may write to any of the files of its datadir.
+
+    :param source: Path of the template datadir file.
+    :type source: str
+    :param target: Path of the file to create.
+    :type target: str
+    """
+    if sys.platform.startswith("linux"):
+        with open(source, "rb") as source_file:
+            with open(target, "wb") as target_file:
+                try:
+                    fcntl.ioctl(target_file.fileno(), _FICLONE,
+                                source_file.fileno())
+                    cloned = True
+                except (IOError, OSError):
+                    cloned = False
+        if cloned:
+            shutil.copystat(source, target)
+            return
+
+    shutil.copy2(source, target)
+
+
+def _copy_template_datadir(template_dir, datadir):
+    """Create the datadir of a sandbox as a clone of the template datadir.
+
+    The server UUID and the binary logs written by the initialization are
+    not copied, the server creates new ones at startup.
+
+    :param template_dir: Path of the template datadir.
+    :type template_dir: str
+    :param datadir: Path of the datadir to create.
+    :type datadir: str
+
+    :raises GadgetError: If the template datadir can not be copied.
+    """
+    skipped = set(["auto.cnf", "error.log"])
+    for name in os.listdir(template_dir):
+        if name.endswith(".index") and \
+                os.path.isfile(os.path.join(template_dir, name)):
+            skipped.add(name)
+            with open(os.path.join(template_dir, name)) as index_file:
+                for line in index_file:
+                    skipped.add(os.path.basename(line.strip()))
+
+    _LOGGER.debug("Cloning template datadir '%s' to '%s'.", template_dir,
+                  datadir)
+    try:
+        for path, _, names in os.walk(template_dir):
+            relative_path = os.path.relpath(path, template_dir)
+            target_path = os.path.normpath(os.path.join(datadir,
+                                                        relative_path))
+            os.makedirs(target_path)
+            for name in names:
+                if relative_path == os.curdir and name in skipped:
+                    continue
+                _clone_file(os.path.join(path, name),
+                            os.path.join(target_path, name))
+    except (IOError, OSError, shutil.Error) as err:
+        raise exceptions.GadgetError(
+            "Unable to copy template datadir '{0}' to '{1}': '{2}'."
+            "".format(template_dir, datadir, str(err)))
+
+
 # pylint: disable=R0915, R0914
 def create_sandbox(**kwargs):
     """Create a new MySQL sandbox.
@@ -368,6 +599,14 @@ def create_sandbox(**kwargs):
                                if SSL support cannot be added. If true no error
                                will be issued if SSL support cannot be provided
                                and SSL support will be skipped.
+                     use_template: If true the datadir is created as a clone
+                                   of a template datadir kept under
+                                   sandbox_base_dir for the server version,
+                                   which is initialized by the first sandbox
+                                   using it. Default is False.
+                     profile: Name of the profile in SANDBOX_PROFILES
+                              giving the option file values of the
+                              sandbox. Default is "default".
     :type kwargs:    dict
     """
     # get mandatory values
@@ -392,7 +631,14 @@ def create_sandbox(**kwargs):
             "(by default, portx = port * 10), or use the 'portx' "
             "option to specify a custom value.".format(mysqlx_port))
 
-    _, sandbox_dir = _get_sandbox_dirs(**kwargs)
+    profile = kwargs.get("profile") or "default"
+    if profile not in SANDBOX_PROFILES:
+        raise exceptions.GadgetError(
+            "Invalid sandbox profile '{0}', it must be one of: {1}."
+            "".format(profile, ", ".join(sorted(SANDBOX_PROFILES))))
+    profile_opts = SANDBOX_PROFILES[profile]
+
+    sandbox_base_dir, sandbox_dir = _get_sandbox_dirs(**kwargs)
     # Check if sandbox_dir is empty
     if os.path.isdir(sandbox_dir) and os.listdir(sandbox_dir):
         raise exceptions.GadgetError("The sandbox dir '{0}' is not empty."
@@ -530,6 +776,10 @@ def create_sandbox(**kwargs):
         "user": "root",
         "protocol": "TCP",
     }}
+    if profile_opts:
+        _LOGGER.debug("Using the option file values of the '%s' profile.",
+                      profile)
+        opt_dict["mysqld"].update(profile_opts)
     if opt_override_dict:
         # If port is one of the options to override raise exception
         _LOGGER.debug("Adding/Overriding option file values.")
@@ -556,23 +806,26 @@ def create_sandbox(**kwargs):
     else:
         local_mysqld_path = mysqld_path
 
-    # Get the command string
-    create_cmd = _CREATE_SANDBOX_CMD.format(
-        quote=QUOTE_CHAR, mysqld_path=local_mysqld_path,
-        config_file=os.path.normpath(optf_path))
-
-    # If we are running the script as root , the --user=root option is needed
     if os.name == "posix" and getpass.getuser() == "root":
         _LOGGER.warning("Creating a sandbox as root is not recommended.")
-        create_cmd = "{0} --user=root".format(create_cmd)
 
-    init_proc = tools.run_subprocess(create_cmd, shell=False)
-    init_proc.wait()
-    if init_proc.returncode != 0:
-        raise exceptions.GadgetError(
-            "Error initializing MySQL sandbox '{0}'. Initialize process "
-            "failed with return code '{1}'.".format(port,
-                                                    init_proc.returncode))
+    if kwargs.get("use_template", False):
+        # The profile sizes the redo log, which the template is created with
+        template_dir = _get_template_dir(
+            sandbox_base_dir, mysqld_ver, version_str,
+            ["{0}={1}".format(opt, val) for opt, val in profile_opts.items()]
+            + mysqld_opts)
+        _create_template_datadir(template_dir, local_mysqld_path, opt_dict)
+        _copy_template_datadir(template_dir, datadir)
+    else:
+        init_proc = tools.run_subprocess(
+            _get_initialize_cmd(local_mysqld_path, optf_path), shell=False)
+        init_proc.wait()
+        if init_proc.returncode != 0:
+            raise exceptions.GadgetError(
+                "Error initializing MySQL sandbox '{0}'. Initialize process "
+                "failed with return code '{1}'.".format(port,
+                                                        init_proc.returncode))
 
     # Change root password if one was provided
     # start the server
@@ -603,19 +856,19 @@ def create_sandbox(**kwargs):
 
         _LOGGER.debug("Launching mysqld to change the root password")
         server_proc = tools.run_subprocess(start_cmd)
-        # wait until server is listening on the given port
-        i = 0
+        # wait until server is listening on the given port, or has exited
         _LOGGER.debug("Waiting for MySQL sandbox to start listening for "
                       "connections on port '%i'", port)
-        while i < timeout:
-            if not tools.is_listening("localhost", port):
-                time.sleep(1)
-                i += 1
-            else:
-                # port is listening, break out of loop
-                _LOGGER.debug("MySQL sandbox is listening for connections on "
-                              "port '%i'", port)
-                break
+        if tools.wait_for_port("localhost", port, timeout,
+                               abort=lambda: server_proc.poll() is not None):
+            _LOGGER.debug("MySQL sandbox is listening for connections on "
+                          "port '%i'", port)
+        elif server_proc.poll() is not None:
+            raise exceptions.GadgetError(
+                "Cannot change root password. Server stopped unexpectedly "
+                "with return code '{0}'. Check error log file '{1}'."
+                "".format(server_proc.returncode,
+                          os.path.join(datadir, "error.log")))
         else:
             # timeout occurred, send signal to terminate process
             try:
@@ -721,6 +974,82 @@ def create_sandbox(**kwargs):
         os.path.normpath(start_path), os.path.normpath(stop_path)))
 
 
+def _follow_error_log(error_log_path, start_pos, port, watcher, server_proc,
+                      deadline):
+    """Reads the error log of a starting sandbox until it is ready.
+
+    The lines written from start_pos on are checked for the messages of a
+    server ready for connections, the errors found are logged as warnings.
+    Reading waits on the watcher of the log directory whenever the end of the
+    file is reached.
+
+    :param error_log_path: Path of the error log.
+    :type error_log_path: str
+    :param start_pos: Position of the log where the current start begins.
+    :type start_pos: int
+    :param port: Port of the sandbox.
+    :type port: int
+    :param watcher: Watcher of the directory of the error log.
+    :type watcher: tools.FileWatcher
+    :param server_proc: The mysqld process.
+    :type server_proc: subprocess.Popen
+    :param deadline: Time at which the wait ends.
+    :type deadline: float
+
+    :return: True if the server is ready for connections, False if the
+             deadline passed or the process exited first.
+    :rtype: bool
+    :raises GadgetError: If the server reported it is aborting.
+    """
+    started_ok = False
+    exited = False
+    if not os.path.isfile(error_log_path):
+        return False
+
+    with open(error_log_path, 'r') as f:
+        # jump to current session position
+        f.seek(start_pos)
+        while time.time() < deadline:
+            # save last read position (start of line)
+            last_pos = f.tell()
+            line = f.readline()
+            if not line or "\n" not in line:
+                # go back to the start of the line not completely written
+                f.seek(last_pos)
+                if started_ok or exited:
+                    # Nothing else to read
+                    break
+                if server_proc.poll() is not None:
+                    # the lines written before exiting are read once more
+                    exited = True
+                    continue
+                watcher.wait(deadline - time.time())
+                continue
+            if not started_ok:
+                # if we didn't find the ready_message yet, keep looking
+                # for it.
+                for server_ready_msg in _SERVER_READY_LOG_MESSAGES:
+                    if server_ready_msg in line:
+                        _LOGGER.debug(
+                            "MySQL sandbox is listening for "
+                            "connections on port '%i'", port)
+                        started_ok = True
+                        break
+            if "[ERROR] Aborting\n" in line:
+                # critical error, server won't start but will shutdown
+                # on its own.
+                raise exceptions.GadgetError(
+                    "Unable to start server on port '{0}'. For more "
+                    "information, check error log '{1}'".format(
+                        port, error_log_path))
+
+            if "[ERROR]" in line:
+                _LOGGER.warning(
+                    "Error found during server startup: "
+                    "'%s'", line.strip())
+    return started_ok
+
+
 def start_sandbox(**kwargs):
     """Starts a MySQL sandbox.
 
@@ -888,90 +1217,61 @@ def start_sandbox(**kwargs):
 
         server_proc = tools.run_subprocess(start_cmd, shell=False)
         started_at = time.time()
-        started_ok = False
         _LOGGER.debug("Waiting for MySQL sandbox to start listening for "
                       "connections on port '%i'", port)
 
-        # Wait for the log file to be created by the server
-        # in case it does not exist.
-        i = 0
-        while i < timeout:
-            if not os.path.isfile(error_log_path):
-                # Wait for the log file to be created by the server.
-                time.sleep(1)
-                i += 1
-            else:
-                # Log file created by the server and available.
-                break
-        else:
-            raise exceptions.GadgetError(
-                "Timeout waiting for the MySQL log error file to be "
-                "available: '{0}'. Please check configuration for 'log_error' "
-                "in '{1}' file and that the log file is accessible."
-                "".format(error_log_path, optf_path))
-
-        with open(error_log_path, 'r') as f:
-            # jump to current session position
-            f.seek(error_log_end_pos)
-            # Check that server has started correctly:
-            while time.time() - started_at < timeout:
-                # save last read position (start of line)
-                last_pos = f.tell()
-                line = f.readline()
-                if not line:
-                    if not started_ok:
-                        # if nothing to read, wait a bit
-                        time.sleep(1)
-                        continue
-                    else:
-                        # Started ok and nothing else to read, exit loop.
-                        break
-                if "\n" not in line:
-                    # if we didn't read a whole line, go back to saved position
-                    f.seek(last_pos)
-                    continue
-                if not started_ok:
-                    # if we didn't find the ready_message yet, keep looking
-                    # for it.
-                    for server_ready_msg in _SERVER_READY_LOG_MESSAGES:
-                        if server_ready_msg in line:
-                            _LOGGER.debug(
-                                "MySQL sandbox is listening for "
-                                "connections on port '%i'", port)
-                            started_ok = True
-                            break
-                if "[ERROR] Aborting\n" in line:
-                    # critical error, server won't start but will shutdown
-                    # on its own.
+        # The error log is followed as the server writes it, the waits end
+        # on every change of the files of its directory
+        watcher = tools.FileWatcher(os.path.dirname(error_log_path))
+        try:
+            # Wait for the log file to be created by the server
+            # in case it does not exist.
+            while not os.path.isfile(error_log_path):
+                if time.time() - started_at >= timeout:
                     raise exceptions.GadgetError(
-                        "Unable to start server on port '{0}'. For more "
-                        "information, check error log '{1}'".format(
-                            port, error_log_path))
+                        "Timeout waiting for the MySQL log error file to be "
+                        "available: '{0}'. Please check configuration for "
+                        "'log_error' in '{1}' file and that the log file is "
+                        "accessible.".format(error_log_path, optf_path))
+                if server_proc.poll() is not None:
+                    break
+                watcher.wait(timeout - (time.time() - started_at))
 
-                if "[ERROR]" in line:
-                    _LOGGER.warning(
-                        "Error found during server startup: "
-                        "'%s'", line.strip())
+            started_ok = _follow_error_log(error_log_path, error_log_end_pos,
+                                           port, watcher, server_proc,
+                                           started_at + timeout)
+        finally:
+            watcher.close()
 
-            if not started_ok:
-                # timeout occurred, send signal to terminate process
-                try:
-                    server_proc.terminate()
-                except Exception as err:
-                    raise exceptions.GadgetError(
-                        "Timeout waiting for sandbox mysqld process with "
-                        "pid '{0}' to start and we got error '{1}' while "
-                        "trying to terminate it. You might need to "
-                        "terminate it manually."
-                        "".format(server_proc.pid, str(err)))
-                else:
-                    # server was successfully terminated
-                    raise exceptions.GadgetError(
-                        "Timeout waiting for sandbox mysqld process with "
-                        "pid '{0}' to start. For more information, check "
-                        "error log '{1}'.".format(server_proc.pid,
-                                                  error_log_path))
+        if not started_ok and server_proc.poll() is not None:
+            raise exceptions.GadgetError(
+                "Unable to start server on port '{0}', mysqld exited with "
+                "return code '{1}'. For more information, check error log "
+                "'{2}'".format(port, server_proc.returncode, error_log_path))
 
+        if not started_ok:
+            # timeout occurred, send signal to terminate process
+            try:
+                server_proc.terminate()
+            except Exception as err:
+                raise exceptions.GadgetError(
+                    "Timeout waiting for sandbox mysqld process with "
+                    "pid '{0}' to start and we got error '{1}' while "
+                    "trying to terminate it. You might need to "
+                    "terminate it manually."
+                    "".format(server_proc.pid, str(err)))
+            else:
+                # server was successfully terminated
+                raise exceptions.GadgetError(
+                    "Timeout waiting for sandbox mysqld process with "
+                    "pid '{0}' to start. For more information, check "
+                    "error log '{1}'.".format(server_proc.pid,
+                                              error_log_path))
+
+        # The server is up, the port follows right away
+        tools.wait_for_port("localhost", port,
+                            max(started_at + timeout - time.time(), 0),
+                            abort=lambda: server_proc.poll() is not None)
         _LOGGER.info("MySQL sandbox running on port '%i' with process ID: "
                      "'%i'", port, server_proc.pid)
     except OSError as err:
@@ -1054,19 +1354,12 @@ def stop_sandbox(**kwargs):
             except exceptions.GadgetQueryError:
                 # ignore query timeout or connection lost errors.
                 pass
-            # Wait for server to stop (listening on port).
-            i = 0
+            # Wait for the server process to end, which also releases its
+            # port and files.
             _LOGGER.debug("Waiting for MySQL sandbox on port '%i' to stop.",
                           port)
-            while i < timeout:
-                if tools.is_listening("localhost", port):
-                    time.sleep(1)
-                    i += 1
-                else:
-                    # port is listening, break out of loop
-                    _LOGGER.debug(
-                        "MySQL sandbox on port '%i' stopped.", port)
-                    break
+            if tools.wait_for_pid_exit(pid, timeout):
+                _LOGGER.debug("MySQL sandbox on port '%i' stopped.", port)
             else:
                 # Timeout occurred, issue an error
                 raise exceptions.GadgetError(
@@ -1221,9 +1514,19 @@ def delete_sandbox(**kwargs):
                             "sandbox listening on port '%i'. Sandbox will "
                             "still be deleted.", port)
             # When deleting the sandbox, some files might still be in use as
-            # the server might be shutting down. To account for this, we try
-            # several times to delete the sandbox dir with increasing timeout
-            # times. If we still fails, an exception is thrown.
+            # the server might be shutting down. The server process is waited
+            # for first, then we try several times to delete the sandbox dir
+            # with increasing timeout times. If we still fails, an exception
+            # is thrown.
+            try:
+                with open(pidf_path) as f:
+                    pid = int(f.readline().strip())
+            except (IOError, ValueError):
+                pid = None
+            if pid is not None and not tools.wait_for_pid_exit(
+                    pid, kwargs.get("timeout", SANDBOX_TIMEOUT)):
+                _LOGGER.warning("The mysqld process with pid '%i' is still "
+                                "running.", pid)
             err = None
             for i in range(1, _MAX_RMTREE_RETRIES + 1):
                 try:
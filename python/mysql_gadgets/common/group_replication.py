@@ -1414,19 +1414,11 @@ def check_peer_ssl_compatibility(peer_server, ssl_mode):
     """
     # Checking SSL compatibility:
     # Get GR ssl modes from peer
-    peer_gr_recovery_ssl = None
-    peer_gr_ssl_mode = None
-
-    try:
-        peer_gr_recovery_ssl = peer_server.select_variable(GR_RECOVERY_USE_SSL)
-    except GadgetQueryError:
-        # variable does not exist, GR SSL is not enabled
-        pass
-    try:
-        peer_gr_ssl_mode = peer_server.select_variable(GR_SSL_MODE)
-    except GadgetQueryError:
-        # variable does not exist, GR SSL is not enabled
-        pass
+    # The variables do not exist (None) if GR SSL is not enabled
+    peer_ssl_vars = peer_server.select_variables([GR_RECOVERY_USE_SSL,
+                                                  GR_SSL_MODE])
+    peer_gr_recovery_ssl = peer_ssl_vars[GR_RECOVERY_USE_SSL]
+    peer_gr_ssl_mode = peer_ssl_vars[GR_SSL_MODE]
 
     # group_replication_ssl_mode values other than "DISABLED" or "REQUIRED"
     # are not supported.
@@ -300,6 +300,11 @@ class RequirementChecker(object):
         results = {}
         valid = True
 
+        # All the values are read at once
+        cur_values = server.select_variables(
+            [var_name for var_name, value in var_values.items()
+             if isinstance(value, dict)])
+
         for var_name, value in var_values.items():
             # Value of type Dictionary can hold more complex requirements
             # (namely unwanted values or one of...):
@@ -312,13 +317,13 @@ class RequirementChecker(object):
             # the comparison.
             if isinstance(value, dict):
                 _LOGGER.debug("Checking option: '%s' ", var_name)
-                try:
-                    cur_val = server.select_variable(var_name)
-                    _LOGGER.debug("Option current value: '%s' ", cur_val)
-                except GadgetQueryError:
+                cur_val = cur_values[var_name]
+                if cur_val is None:
                     cur_val = "<not set>"
                     _LOGGER.debug("Option '%s' does not exists on server %s",
                                   var_name, server)
+                else:
+                    _LOGGER.debug("Option current value: '%s' ", cur_val)
 
                 if cur_val == "" or cur_val is None:
                     _LOGGER.debug('Option found but with empty value')
@@ -669,14 +674,21 @@ class RequirementChecker(object):
 
         peer_server = peer_values["peer"]
         peer_variables = peer_values["peer_variables"]
+        peer_var_values = peer_server.select_variables(peer_variables,
+                                                       "global")
+        cur_values = server.select_variables(peer_variables, "global")
         for peer_var in peer_variables:
             _LOGGER.debug("Checking option: '%s' ", peer_var)
-            peer_var_value = peer_server.select_variable(peer_var, "global")
-            try:
-                cur_val = server.select_variable(peer_var, "global")
-            except GadgetQueryError as err:
-                _LOGGER.warning("Could not get the value of option %s, "
-                                "cause: %s", peer_var, err)
+            peer_var_value = peer_var_values[peer_var]
+            if peer_var_value is None:
+                raise GadgetQueryError("Unknown system variable '{0}'"
+                                       "".format(peer_var),
+                                       "SELECT @@global.{0}".format(peer_var),
+                                       server=peer_server)
+            cur_val = cur_values[peer_var]
+            if cur_val is None:
+                _LOGGER.warning("Could not get the value of option %s on "
+                                "server %s", peer_var, server)
                 # the option needs to be set:
                 missing[peer_var] = peer_var_value
                 valid = False
@@ -54,6 +54,10 @@ _GTID_ERROR = ("The server {host}:{port} does not comply to the latest GTID "
 
 _LOGGER = logging.getLogger(__name__)
 
+# Servers connected by get_server() in this run, by their connection values,
+# so the checks of a command share one connection per server.
+_SERVER_CACHE = {}
+
 
 def _to_str(value, charset="utf-8"):
     """Cast value to str except when None
@@ -263,6 +267,7 @@ def get_server(server_info, ssl_dict=None, connect=True):
     if server_info is None:
         return server_info
 
+    cacheable = connect
     if isinstance(server_info, dict) and 'host' in server_info:
         # Don't update server_info if already has any ssl certificate.
         if (ssl_dict is not None and
@@ -277,6 +282,7 @@ def get_server(server_info, ssl_dict=None, connect=True):
 
     elif isinstance(server_info, Server):
         server = server_info
+        cacheable = False
 
     elif isinstance(server_info, str):
         # parse the string
@@ -288,9 +294,21 @@ def get_server(server_info, ssl_dict=None, connect=True):
         raise GadgetCnxInfoError("Cannot determine connection information"
                                  " type.")
 
+    if cacheable:
+        key = server.cache_key()
+        cached = _SERVER_CACHE.get(key)
+        if cached is not None and cached.db_conn is not None:
+            _LOGGER.debug("Reusing the connection to %s", cached)
+            cached.cache_refs += 1
+            return cached
+
     if connect:
         server.connect()
 
+    if cacheable:
+        server.cache_refs = 1
+        _SERVER_CACHE[key] = server
+
     return server
 
 
@@ -440,6 +458,9 @@ class Server(object):
         self.grants_enabled = None
         self._version = None
         self._version_full = None
+        # Holders of the server returned by get_server(), the connection is
+        # closed when the last of them disconnects
+        self.cache_refs = 0
 
     @staticmethod
     def to_config_file(server, section_name="client", prefix_dir=None):
@@ -815,12 +836,14 @@ class Server(object):
         """
         try:
             self.db_conn = self.get_connection()
+            variables = self.select_variables(["character_set_client",
+                                               "read_only"])
             # If no charset provided, get it from the "character_set_client"
             # server variable.
             if not self.charset:
-                res = self.show_server_variable('character_set_client')
-                self.db_conn.set_charset_collation(charset=res[0][1])
-                self.charset = res[0][1]
+                charset = variables["character_set_client"]
+                self.db_conn.set_charset_collation(charset=charset)
+                self.charset = charset
             if self.ssl:
                 res = self.exec_query("SHOW STATUS LIKE 'Ssl_cipher'")
                 if res[0][1] == '':
@@ -832,7 +855,7 @@ class Server(object):
             self.db_conn = None
             raise
         self.connect_error = None
-        self.read_only = self.show_server_variable("READ_ONLY")[0][1]
+        self.read_only = variables["read_only"]
 
     def get_connection(self):
         """Return a new connection to the server.
@@ -898,12 +921,33 @@ class Server(object):
             # Might be raised by mysql.connector.connect()
             raise GadgetCnxError(str(err), cause=err, server=self)
 
+    def cache_key(self):
+        """Return the connection values identifying the server on the cache
+        of get_server().
+
+        :return: The connection values.
+        :rtype:  tuple
+        """
+        return (self.user, self.passwd, self.host, str(self.port),
+                self.socket, self.ssl_ca, self.ssl_cert, self.ssl_key,
+                self.ssl)
+
     def disconnect(self):
         """Disconnect from the server.
+
+        A server shared through get_server() stays connected until all of
+        the callers that got it disconnect.
         """
         if self.db_conn is None:
             raise GadgetCnxError("Cannot disconnect from a not connected"
                                  "server. You must use connect() first.")
+        if self.cache_refs > 1:
+            self.cache_refs -= 1
+            return
+        if self.cache_refs == 1:
+            self.cache_refs = 0
+            if _SERVER_CACHE.get(self.cache_key()) is self:
+                del _SERVER_CACHE[self.cache_key()]
         try:
             self.db_conn.disconnect()
         except mysql.connector.Error:
@@ -1261,6 +1305,69 @@ class Server(object):
         res = self.exec_query("SELECT @@{0}{1}".format(var_type, var_name))
         return res[0][0]
 
+    def select_variables(self, var_names, var_type=None):
+        """Get the values of several server system variables at once.
+
+        The variables are read with a single query on the global_variables
+        (or session_variables) table of the performance_schema, instead of a
+        round trip per variable. The variables not found there, i.e. if the
+        performance_schema is disabled or missing in the server, are read
+        with select_variable().
+
+        Note: the values are the ones shown by SHOW VARIABLES, e.g. 'ON' for
+        boolean variables, where select_variable() returns '1'.
+
+        :param var_names: Names of the variables to get.
+        :type  var_names: list of strings
+        :param var_type: Type of the variables ('session' or 'global'). By
+                         default None, meaning that the session value is
+                         returned if it exists and the global value otherwise.
+        :type  var_type: 'session', 'global', '', or None
+
+        :return: dictionary with the given variable names as keys and their
+                 values, None for the variables the server does not have.
+        :rtype:  dict
+
+        :raise GadgetServerError: If an unsupported variable type is
+                                  specified.
+        """
+        if var_type is None or var_type.lower() in ('session', ''):
+            table = "session_variables"
+        elif var_type.lower() == 'global':
+            table = "global_variables"
+        else:
+            raise GadgetServerError(
+                "Invalid variable type: {0}. Supported types: "
+                "'global' and 'session'.".format(var_type), server=self)
+
+        values = {}
+        if not var_names:
+            return values
+
+        found = {}
+        try:
+            res = self.exec_query(
+                "SELECT VARIABLE_NAME, VARIABLE_VALUE "
+                "FROM performance_schema.{0} WHERE VARIABLE_NAME IN ({1})"
+                "".format(table, ", ".join(["%s"] * len(var_names))),
+                {"params": tuple(var_names)})
+            for row in res:
+                found[row[0].lower()] = row[1]
+        except GadgetQueryError as err:
+            _LOGGER.debug("Unable to read the variables from the "
+                          "performance_schema: %s", err)
+
+        for var_name in var_names:
+            if var_name.lower() in found:
+                values[var_name] = found[var_name.lower()]
+                continue
+            try:
+                values[var_name] = self.select_variable(var_name, var_type)
+            except GadgetQueryError:
+                values[var_name] = None
+
+        return values
+
     def flush_logs(self, log_type=None):
         """Execute the FLUSH [log_type] LOGS statement.
 
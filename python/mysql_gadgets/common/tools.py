@@ -20,13 +20,18 @@ This module contains methods for working with mysql server tools.
 """
 import shlex
 from contextlib import closing
+import ctypes
+import ctypes.util
+import errno
 import logging
 import os
+import select
 import signal
 import socket
 import subprocess
 import sys
 import tempfile
+import time
 
 
 from mysql_gadgets.exceptions import GadgetError
@@ -316,6 +321,176 @@ def is_listening(host, port):
         return False
 
 
+def wait_for_port(host, port, timeout, listening=True, abort=None):
+    """Waits for a port to be listening, or to stop listening.
+
+    The port is probed with connection attempts retried after short, growing
+    intervals, so the wait ends shortly after the port changes.
+
+    :param host: hostname of the port.
+    :type host: str
+    :param port: port number to check.
+    :type port: int
+    :param timeout: number of seconds to wait at most.
+    :type timeout: float
+    :param listening: if True waits for the port to be listening, otherwise
+                      for it to stop listening.
+    :type listening: bool
+    :param abort: optional function called between attempts, the wait ends
+                  when it returns True.
+    :type abort: function
+    :return: True if the port reached the expected state, False otherwise
+    :rtype: bool
+    """
+    deadline = time.time() + timeout
+    delay = 0.01
+    while True:
+        if is_listening(host, port) == listening:
+            return True
+        if (abort is not None and abort()) or time.time() >= deadline:
+            return False
+        time.sleep(min(delay, max(deadline - time.time(), 0)))
+        delay = min(delay * 2, 0.25)
+
+
+def _pid_exists(pid):
+    """Checks if a process with the given pid exists (posix only)."""
+    try:
+        os.kill(pid, 0)
+    except OSError as err:
+        # the process exists but belongs to another user
+        return err.errno == errno.EPERM
+    return True
+
+
+def wait_for_pid_exit(pid, timeout):
+    """Waits for the process with the given pid to end.
+
+    The process is waited on directly where the platform allows it (a pid file
+    descriptor on Linux, the process handle on Windows), elsewhere its
+    existence is checked after short, growing intervals.
+
+    :param pid: pid of the process.
+    :type pid: int
+    :param timeout: number of seconds to wait at most.
+    :type timeout: float
+    :return: True if the process ended, False if it is still running
+    :rtype: bool
+    """
+    if os.name == "nt":
+        # pylint: disable=E1101
+        kernel32 = ctypes.windll.kernel32
+        synchronize, wait_object_0 = 0x00100000, 0
+        handle = kernel32.OpenProcess(synchronize, False, pid)
+        if not handle:
+            return True
+        try:
+            return kernel32.WaitForSingleObject(
+                handle, int(timeout * 1000)) == wait_object_0
+        finally:
+            kernel32.CloseHandle(handle)
+
+    if sys.platform.startswith("linux") and _LIBC is not None:
+        # pidfd_open, readable once the process ends
+        pidfd = _LIBC.syscall(434, pid, 0)
+        if pidfd >= 0:
+            try:
+                readable, _, _ = select.select([pidfd], [], [], timeout)
+                return bool(readable)
+            finally:
+                os.close(pidfd)
+        elif ctypes.get_errno() == errno.ESRCH:
+            return True
+
+    deadline = time.time() + timeout
+    delay = 0.01
+    while _pid_exists(pid):
+        if time.time() >= deadline:
+            return False
+        time.sleep(min(delay, max(deadline - time.time(), 0)))
+        delay = min(delay * 2, 0.1)
+    return True
+
+
+class FileWatcher(object):
+    """Waits for the files of a directory to change.
+
+    Uses inotify on Linux. Elsewhere, or when inotify is not available,
+    wait() returns after a short interval, so callers must check whatever
+    they are waiting for after each call anyway.
+    """
+    _POLL_INTERVAL = 0.1
+    # IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE
+    _EVENTS = 0x002 | 0x008 | 0x080 | 0x100 | 0x200
+
+    def __init__(self, directory):
+        """Constructor
+
+        :param directory: directory whose files are watched.
+        :type directory: str
+        """
+        self._fd = -1
+        if sys.platform.startswith("linux") and _LIBC is not None:
+            # IN_NONBLOCK | IN_CLOEXEC
+            fd = _LIBC.inotify_init1(0o4000 | 0o2000000)
+            if fd >= 0:
+                path = os.path.abspath(directory)
+                if not isinstance(path, bytes):
+                    path = path.encode(sys.getfilesystemencoding())
+                if _LIBC.inotify_add_watch(fd, path, self._EVENTS) >= 0:
+                    self._fd = fd
+                else:
+                    os.close(fd)
+        if self._fd < 0:
+            _LOGGER.debug("Polling directory '%s' for changes.", directory)
+
+    def wait(self, timeout):
+        """Waits for a change of the files, or for timeout seconds at most.
+
+        :param timeout: number of seconds to wait at most.
+        :type timeout: float
+        """
+        timeout = max(timeout, 0)
+        if self._fd < 0:
+            time.sleep(min(timeout, self._POLL_INTERVAL))
+            return
+
+        readable, _, _ = select.select([self._fd], [], [], timeout)
+        if readable:
+            try:
+                # the events only wake the wait, they are dropped
+                os.read(self._fd, 4096)
+            except OSError as err:
+                if err.errno != errno.EAGAIN:
+                    raise
+
+    def close(self):
+        """Stops watching the directory."""
+        if self._fd >= 0:
+            os.close(self._fd)
+            self._fd = -1
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+
+def _load_libc():
+    """Loads the C library for the system calls not wrapped by the os module.
+    """
+    if os.name == "nt":
+        return None
+    try:
+        return ctypes.CDLL(ctypes.util.find_library("c"), use_errno=True)
+    except OSError:
+        return None
+
+
+_LIBC = _load_libc()
+
+
 def is_executable(exec_path):
     """ Checks if a given path belongs to an executable file
 
@@ -114,6 +114,16 @@ class MockServer(object):
         else:
             return self.server.select_variable(var_name, var_type)
 
+    def select_variables(self, var_names, var_type=None):
+        """mocked select_variables method"""
+        values = self.server.select_variables(
+            [var_name for var_name in var_names
+             if var_name not in self.frozen_variables.keys()], var_type)
+        for var_name in var_names:
+            if var_name in self.frozen_variables.keys():
+                values[var_name] = self.frozen_variables[var_name]
+        return values
+
     def __str__(self):
         """mocked string representation of the class Server
 
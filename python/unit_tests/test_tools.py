@@ -18,9 +18,11 @@
 Unit tests for mysql_gadgets.common.tools module.
 """
 import os
+import shutil
 import stat
 import subprocess
 import sys
+import tempfile
 import time
 import unittest
 
@@ -332,6 +334,44 @@ class TestTools(GadgetsTestCase):
         # but a free port should not be listening
         self.assertFalse(tools.is_listening("not_a_valid_host", 1234))
 
+    def test_wait_for_port(self):
+        """test wait_for_port function"""
+        # the port of the server is listening already
+        self.assertTrue(tools.wait_for_port("localhost", self.server.port, 1))
+        self.assertFalse(tools.wait_for_port("localhost", self.server.port,
+                                             0.2, listening=False))
+        # aborting ends the wait before the timeout
+        start = time.time()
+        self.assertFalse(tools.wait_for_port("not_a_valid_host", 1234, 30,
+                                             abort=lambda: True))
+        self.assertLess(time.time() - start, 5)
+
+    def test_wait_for_pid_exit(self):
+        """test wait_for_pid_exit function"""
+        if os.name == "nt":
+            cmd = "ping 127.0.0.1 -n 2 > NUL"
+        else:
+            cmd = "sleep 1"
+        proc = tools.run_subprocess(cmd, shell=True)
+        # the process is still running
+        self.assertFalse(tools.wait_for_pid_exit(proc.pid, 0.1))
+        proc.wait()
+        self.assertTrue(tools.wait_for_pid_exit(proc.pid, 5))
+
+    def test_file_watcher(self):
+        """test FileWatcher class"""
+        watch_dir = tempfile.mkdtemp()
+        try:
+            with tools.FileWatcher(watch_dir) as watcher:
+                with open(os.path.join(watch_dir, "error.log"), "w") as f:
+                    f.write("ready for connections\n")
+                # the change of the file ends the wait right away
+                start = time.time()
+                watcher.wait(10)
+                self.assertLess(time.time() - start, 5)
+        finally:
+            shutil.rmtree(watch_dir, ignore_errors=True)
+
     def test_is_executable(self):
         """Test is_executable function"""
         # python is an executable file
@@ -0,0 +1,34 @@
+// Latency of cluster.status() measured by perf_runner.py, on the cluster of
+// the instance of the global session.
+//
+// Usage: mysqlsh --js --classic --uri <uri> -f perf_cluster.js <iterations>
+//
+// The measure is printed as: PERF {json}
+
+var iterations = parseInt(sys.argv[1]);
+var cluster = dba.getCluster();
+
+// The first call loads the metadata, it is not accounted
+cluster.status();
+
+var times = [];
+for (var index = 0; index < iterations; index++) {
+  var started = Date.now();
+  cluster.status();
+  times.push(Date.now() - started);
+}
+
+times.sort(function(a, b) { return a - b; });
+
+var total = 0;
+for (var index = 0; index < times.length; index++)
+  total += times[index];
+
+println('PERF ' + JSON.stringify({
+  protocol: 'classic',
+  'case': 'cluster_status',
+  count: iterations,
+  seconds: total / 1000,
+  per_second: total > 0 ? iterations * 1000 / total : 0,
+  median_ms: times[Math.floor(times.length / 2)]
+}));
@@ -0,0 +1,186 @@
+"""
+Throughput benchmark of the shell against a live server.
+
+Deploys a sandbox instance, loads a reproducible dataset and measures, on
+the classic and X protocols:
+
+  - the ingestion of a SQL script (the dataset itself)
+  - the streaming of a SELECT of the whole dataset
+  - bulk inserts with collection.add (X protocol)
+  - collection.find with bound values (X protocol)
+  - the latency of cluster.status(), on a cluster of three sandboxes (--cluster)
+
+The results are written as JSON, for the regression tracking of nightly runs.
+
+Usage: python perf_runner.py [--config perf_runner.json] [--output results.json]
+                             [--shell path] [--rows N] [--no-deploy] [--cluster]
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+class Runner(object):
+    def __init__(self, config, shell, rows):
+        self.config = config
+        self.shell = shell
+        self.rows = rows
+        self.sandbox = config["sandbox"]
+        self.sandbox_dir = config["general"].get("sandbox_dir", "")
+        self.results = []
+
+    def uri(self, port, protocol="classic"):
+        if protocol == "x":
+            port = port * 10
+        return "%s:%s@%s:%d" % (self.sandbox["user"], self.sandbox["password"], self.sandbox["host"], port)
+
+    def run_shell(self, args):
+        command = [self.shell] + args
+        process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        output = process.communicate()[0].decode("utf-8", "replace")
+        if process.returncode != 0:
+            raise RuntimeError("Failed running %s:\n%s" % (" ".join(command), output))
+        return output
+
+    def run_js(self, code):
+        return self.run_shell(["--js", "--execute", code])
+
+    def sandbox_options(self):
+        options = {"password": self.sandbox["password"], "allowRootFrom": "%"}
+        if self.sandbox_dir:
+            options["sandboxDir"] = self.sandbox_dir
+        return json.dumps(options)
+
+    def deploy(self, port):
+        self.run_js("dba.deploySandboxInstance(%d, %s)" % (port, self.sandbox_options()))
+
+    def destroy(self, port):
+        options = json.dumps({"sandboxDir": self.sandbox_dir} if self.sandbox_dir else {})
+        try:
+            self.run_js("dba.killSandboxInstance(%d, %s)" % (port, options))
+        except RuntimeError:
+            pass
+        self.run_js("dba.deleteSandboxInstance(%d, %s)" % (port, options))
+
+    def collect(self, output):
+        for line in output.splitlines():
+            if line.startswith("PERF "):
+                result = json.loads(line[5:])
+                self.results.append(result)
+                print("%-8s %-16s %12.1f/s" % (result["protocol"], result["case"], result["per_second"]))
+
+    def dataset(self, directory):
+        # The contents only depend on the row number, so every run loads the
+        # same data
+        path = os.path.join(directory, "dataset.sql")
+        with open(path, "w") as script:
+            script.write("DROP SCHEMA IF EXISTS perf_bench;\n")
+            script.write("CREATE SCHEMA perf_bench;\n")
+            script.write("CREATE TABLE perf_bench.items (id INT PRIMARY KEY, name VARCHAR(64), "
+                         "amount DECIMAL(10,2), created DATETIME, payload VARCHAR(255));\n")
+            for start in range(0, self.rows, 500):
+                values = []
+                for id in range(start, min(start + 500, self.rows)):
+                    values.append("(%d,'name_%d',%d.%02d,'2017-01-01 00:00:00' + INTERVAL %d SECOND,'%s')" %
+                                  (id, id, id % 100000, id % 100, id, ("payload_%d_" % id) * 8))
+                script.write("INSERT INTO perf_bench.items VALUES %s;\n" % ",".join(values))
+        return path
+
+    def measure_ingestion(self, path, protocol):
+        mode = "--sqlc" if protocol == "classic" else "--sqln"
+        started = time.time()
+        self.run_shell([mode, "--uri", self.uri(self.sandbox["port"], protocol), "-f", path])
+        seconds = time.time() - started
+        self.collect("PERF " + json.dumps({"protocol": protocol, "case": "sql_ingestion", "count": self.rows,
+                                           "seconds": seconds, "per_second": self.rows / seconds}))
+
+    def measure_workload(self, protocol):
+        mode = "--classic" if protocol == "classic" else "--node"
+        self.collect(self.run_shell(["--js", mode, "--uri", self.uri(self.sandbox["port"], protocol),
+                                     "-f", os.path.join(HERE, "perf_workload.js"), protocol, str(self.rows),
+                                     str(self.config["workload"]["iterations"])]))
+
+    def measure_cluster(self):
+        ports = self.sandbox["cluster_ports"]
+        for port in ports:
+            self.deploy(port)
+
+        try:
+            script = "shell.connect('%s'); var cluster = dba.createCluster('perf');" % self.uri(ports[0])
+            for port in ports[1:]:
+                script += "cluster.addInstance('%s');" % self.uri(port)
+            self.run_js(script)
+
+            self.collect(self.run_shell(["--js", "--classic", "--uri", self.uri(ports[0]),
+                                         "-f", os.path.join(HERE, "perf_cluster.js"),
+                                         str(self.config["workload"]["status_iterations"])]))
+        finally:
+            for port in ports:
+                self.destroy(port)
+
+    def run(self, deploy, cluster):
+        directory = tempfile.mkdtemp()
+        path = self.dataset(directory)
+
+        if deploy:
+            self.deploy(self.sandbox["port"])
+
+        try:
+            for protocol in ["classic", "x"]:
+                self.measure_ingestion(path, protocol)
+                self.measure_workload(protocol)
+        finally:
+            if deploy:
+                self.destroy(self.sandbox["port"])
+            os.remove(path)
+            os.rmdir(directory)
+
+        if cluster:
+            self.measure_cluster()
+
+    def report(self):
+        version = self.run_shell(["--version"]).strip()
+        return {
+            "shell": version,
+            "date": datetime.datetime.utcnow().isoformat() + "Z",
+            "platform": platform.platform(),
+            "rows": self.rows,
+            "results": self.results
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Throughput benchmark of the shell against a sandbox")
+    parser.add_argument("--config", default=os.path.join(HERE, "perf_runner.json"))
+    parser.add_argument("--output", default="perf_results.json")
+    parser.add_argument("--shell", help="path of the shell binary, overrides the configuration")
+    parser.add_argument("--rows", type=int, help="rows of the dataset, overrides the configuration")
+    parser.add_argument("--no-deploy", action="store_true", help="use the instance already running on the port")
+    parser.add_argument("--cluster", action="store_true", help="measure cluster.status() on three more sandboxes")
+    args = parser.parse_args()
+
+    with open(args.config) as config_file:
+        config = json.load(config_file)
+
+    runner = Runner(config, args.shell or config["general"]["shell_path"],
+                    args.rows or config["workload"]["rows"])
+    runner.run(not args.no_deploy, args.cluster)
+
+    with open(args.output, "w") as output:
+        json.dump(runner.report(), output, indent=2, sort_keys=True)
+
+    print("Results written to %s" % args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,65 @@
+// Throughput workload run by perf_runner.py inside the shell, on the global
+// session, which is a ClassicSession or a NodeSession depending on the
+// protocol being measured.
+//
+// Usage: mysqlsh --js --classic|--node --uri <uri> -f perf_workload.js <protocol> <rows> <iterations>
+//
+// Each measure is printed on its own line as: PERF {json}
+
+var protocol = sys.argv[1];
+var rows = parseInt(sys.argv[2]);
+var iterations = parseInt(sys.argv[3]);
+
+function report(name, count, started) {
+  var seconds = (Date.now() - started) / 1000;
+  println('PERF ' + JSON.stringify({
+    protocol: protocol,
+    'case': name,
+    count: count,
+    seconds: seconds,
+    per_second: seconds > 0 ? count / seconds : 0
+  }));
+}
+
+function run_sql(sql) {
+  if (protocol == 'classic')
+    return session.runSql(sql);
+  else
+    return session.sql(sql).execute();
+}
+
+// Streaming of the whole table, row by row
+var started = Date.now();
+var result = run_sql('select * from perf_bench.items');
+var count = 0;
+while (result.fetchOne())
+  count++;
+report('select_stream', count, started);
+
+if (protocol == 'x') {
+  var schema = session.getSchema('perf_bench');
+
+  try {
+    schema.dropCollection('docs');
+  } catch (err) {
+  }
+
+  var collection = schema.createCollection('docs');
+
+  // Bulk inserts of documents, in batches of 1000
+  started = Date.now();
+  for (var start = 0; start < rows; start += 1000) {
+    var docs = [];
+    for (var id = start; id < start + 1000 && id < rows; id++)
+      docs.push({ _id: 'doc_' + id, num: id % 1000, name: 'name_' + id, tags: ['a', 'b', 'c'] });
+
+    collection.add(docs).execute();
+  }
+  report('collection_add', rows, started);
+
+  // Lookups with bound values, one statement per iteration
+  started = Date.now();
+  for (var index = 0; index < iterations; index++)
+    collection.find('num = :num').bind('num', index % 1000).execute().fetchAll();
+  report('find_bind', iterations, started);
+}
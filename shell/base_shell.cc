@@ -19,19 +19,25 @@
 
 #include "shell/base_shell.h"
 #include "modules/base_session.h"
+#include "modules/mod_mysqlx_index_advisor.h"
 #include "utils/utils_file.h"
 #include "utils/utils_general.h"
 #include "shellcore/shell_core_options.h" // <---
 #include "shellcore/shell_notifications.h"
 #include "modules/base_resultset.h"
 #include "shell_resultset_dumper.h"
+#include "shell_output_spool.h"
 #include "utils/utils_time.h"
+#include "utils/utils_stats.h"
+#include "utils/utils_profile.h"
 #include "utils/utils_help.h"
 #include "logger/logger.h"
+#include "mysqlxtest/mysqlx_trace.h"
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <fstream>
 
 // TODO: This should be ported from the server, not used from there (see comment bellow)
 //const int MAX_READLINE_BUF = 65536;
@@ -39,7 +45,7 @@ extern char *mysh_get_tty_password(const char *opt_message);
 
 namespace mysqlsh {
 Base_shell::Base_shell(const Shell_options &options, shcore::Interpreter_delegate *custom_delegate) :
-_options(options) {
+_options(options), _client_delegate(custom_delegate), _preview_rows(0) {
   std::string log_path = shcore::get_user_config_path();
   log_path += "mysqlsh.log";
 
@@ -50,24 +56,34 @@ _options(options) {
   try {
     _logger = ngcommon::Logger::singleton();
   } catch (std::logic_error &e) {
-    ngcommon::Logger::create_instance(log_path.c_str(), _options.log_to_stderr, _options.log_level);
+    // The log file is written from a background thread, so logging at the
+    // debug levels does not slow down the operations being traced
+    ngcommon::Logger::create_instance(log_path.c_str(), _options.log_to_stderr, _options.log_level, true);
     _logger = ngcommon::Logger::singleton();
   }
 
   _input_mode = shcore::Input_state::Ok;
 
-  // Sets the global options
-  shcore::Value::Map_type_ref shcore_options = shcore::Shell_core_options::get();
-
   // Updates shell core options that changed upon initialization
-  (*shcore_options)[SHCORE_BATCH_CONTINUE_ON_ERROR] = shcore::Value(_options.force);
-  (*shcore_options)[SHCORE_INTERACTIVE] = shcore::Value(_options.interactive);
-  (*shcore_options)[SHCORE_USE_WIZARDS] = shcore::Value(_options.wizards);
+  shcore::Shell_core_options::set(SHCORE_BATCH_CONTINUE_ON_ERROR, shcore::Value(_options.force));
+  shcore::Shell_core_options::set(SHCORE_BATCH_PIPELINE, shcore::Value(_options.batch_pipeline));
+  shcore::Shell_core_options::set(SHCORE_BATCH_COMMIT, shcore::Value(_options.batch_commit));
+  shcore::Shell_core_options::set(SHCORE_INTERACTIVE, shcore::Value(_options.interactive));
+  shcore::Shell_core_options::set(SHCORE_USE_WIZARDS, shcore::Value(_options.wizards));
   if (!_options.output_format.empty())
-    (*shcore_options)[SHCORE_OUTPUT_FORMAT] = shcore::Value(_options.output_format);
+    shcore::Shell_core_options::set(SHCORE_OUTPUT_FORMAT, shcore::Value(_options.output_format));
 
   _shell.reset(new shcore::Shell_core(custom_delegate));
 
+  // The X protocol frames of every session are recorded into the trace file
+  if (!_options.trace_protocol_file.empty()) {
+    try {
+      ::mysqlx::Protocol_trace::open(_options.trace_protocol_file);
+    } catch (std::runtime_error &e) {
+      print_error(std::string(e.what()) + "\n");
+    }
+  }
+
   std::string cmd_help_connect =
     "SYNTAX:\n"
     "   \\connect [-<TYPE>] <URI>\n\n"
@@ -112,9 +128,67 @@ _options(options) {
   SET_SHELL_COMMAND("\\connect|\\c", "Connect to a server.", cmd_help_connect, Base_shell::cmd_connect);
   SET_SHELL_COMMAND("\\warnings|\\W", "Show warnings after every statement.", "", Base_shell::cmd_warnings);
   SET_SHELL_COMMAND("\\nowarnings|\\w", "Don't show warnings after every statement.", "", Base_shell::cmd_nowarnings);
+
+  std::string cmd_help_pager =
+    "SYNTAX:\n"
+    "   \\pager [<command>]\n\n"
+    "EXAMPLES:\n"
+    "   \\pager less -S\n\n"
+    "Sends the results of the statements to the given command, or to $PAGER\n"
+    "(less if not set) when none is given. The result is read completely\n"
+    "before the pager is started, so the server is not kept waiting on the\n"
+    "terminal, big results are kept in a temporary file meanwhile.\n";
+
+  SET_SHELL_COMMAND("\\pager|\\P", "Page the results through a command.", cmd_help_pager, Base_shell::cmd_pager);
+  SET_SHELL_COMMAND("\\nopager", "Print the results directly.", "", Base_shell::cmd_nopager);
+
+  std::string cmd_help_more =
+    "SYNTAX:\n"
+    "   \\more\n\n"
+    "Prints the next rows of the last result, when the resultPreviewLimit\n"
+    "option cut it short. Any other input abandons the rest of the result,\n"
+    "which X sessions cancel according to the cancelAbandonedRows and\n"
+    "cancelAbandonedBytes connection options.\n";
+
+  SET_SHELL_COMMAND("\\more", "Print the next rows of the last result.", cmd_help_more, Base_shell::cmd_more);
   SET_SHELL_COMMAND("\\status|\\s", "Print information about the current global connection.", "", Base_shell::cmd_status);
   SET_SHELL_COMMAND("\\use|\\u", "Set the current schema for the global session.", cmd_help_use, Base_shell::cmd_use);
 
+  std::string cmd_help_stats =
+    "SYNTAX:\n"
+    "   \\stats [reset]\n\n"
+    "Prints as JSON the latency statistics of the SQL statements executed by\n"
+    "the shell, grouped by statement digest, the same returned by shell.stats().\n"
+    "When reset is given the statistics are cleared after being printed.\n";
+
+  SET_SHELL_COMMAND("\\stats", "Print the latency statistics of the executed statements.", cmd_help_stats, Base_shell::cmd_stats);
+
+  std::string cmd_help_profile =
+    "SYNTAX:\n"
+    "   \\profile on|off\n"
+    "   \\profile report [<collapsed_stacks_file>]\n\n"
+    "Profiles the time spent by the shell on the statements, the calls into\n"
+    "the native objects (as Class.method), the value conversions to and from\n"
+    "JavaScript and Python and the printing of results.\n\n"
+    "on starts a new profile and off stops it. report prints a flat profile\n"
+    "with the self and total times of every frame and, when a file is given,\n"
+    "writes the profile as collapsed stacks, the input of flamegraph.pl.\n";
+
+  SET_SHELL_COMMAND("\\profile", "Profile the time spent by the shell.", cmd_help_profile, Base_shell::cmd_profile);
+
+  std::string cmd_help_index_advisor =
+    "SYNTAX:\n"
+    "   \\indexadvisor on|off|report\n\n"
+    "Records the document paths used by the search conditions and the sort of\n"
+    "the collection find() and modify() operations executed, with their\n"
+    "execution times.\n\n"
+    "on starts a new recording and off stops it. report prints the filters\n"
+    "recorded, the slowest first, each with the index of the collection that\n"
+    "already serves it or the createIndex() call that would add one: the paths\n"
+    "compared for equality first, then the ones sorted by, then a range.\n";
+
+  SET_SHELL_COMMAND("\\indexadvisor", "Suggest indexes for the filters of collection operations.", cmd_help_index_advisor, Base_shell::cmd_index_advisor);
+
   const std::string cmd_help_store_connection =
     "SYNTAX:\n"
     "   \\savecon [-f] <SESSION_CONFIG_NAME> <URI>\n\n"
@@ -224,6 +298,9 @@ bool Base_shell::connect(bool primary_session) {
       if (_options.auth_method == "PLAIN")
         println("mysqlx: [Warning] PLAIN authentication method is NOT secure!");
 
+      if (!_options.compression.empty())
+        (*connection_data)[shcore::kCompression] = shcore::Value(_options.compression);
+
       if (!secure_password)
         println("mysqlx: [Warning] Using a password on the command line interface can be insecure.");
     }
@@ -644,7 +721,7 @@ bool Base_shell::cmd_quit(const std::vector<std::string>& UNUSED(args)) {
 }
 
 bool Base_shell::cmd_warnings(const std::vector<std::string>& UNUSED(args)) {
-  (*shcore::Shell_core_options::get())[SHCORE_SHOW_WARNINGS] = shcore::Value::True();
+  shcore::Shell_core_options::set(SHCORE_SHOW_WARNINGS, shcore::Value::True());
 
   println("Show warnings enabled.");
 
@@ -652,13 +729,108 @@ bool Base_shell::cmd_warnings(const std::vector<std::string>& UNUSED(args)) {
 }
 
 bool Base_shell::cmd_nowarnings(const std::vector<std::string>& UNUSED(args)) {
-  (*shcore::Shell_core_options::get())[SHCORE_SHOW_WARNINGS] = shcore::Value::False();
+  shcore::Shell_core_options::set(SHCORE_SHOW_WARNINGS, shcore::Value::False());
 
   println("Show warnings disabled.");
 
   return true;
 }
 
+bool Base_shell::cmd_pager(const std::vector<std::string>& args) {
+  // The first argument is the command itself
+  std::string pager;
+  for (size_t index = 1; index < args.size(); index++) {
+    if (index > 1)
+      pager += " ";
+    pager += args[index];
+  }
+
+  if (pager.empty()) {
+    const char *env_pager = getenv("PAGER");
+    pager = env_pager && *env_pager ? env_pager : "less";
+  }
+
+  shcore::Shell_core_options::set(SHCORE_PAGER, shcore::Value(pager));
+
+  println("Pager has been set to '" + pager + "'.");
+
+  return true;
+}
+
+bool Base_shell::cmd_nopager(const std::vector<std::string>& UNUSED(args)) {
+  shcore::Shell_core_options::set(SHCORE_PAGER, shcore::Value(""));
+
+  println("Pager has been disabled.");
+
+  return true;
+}
+
+bool Base_shell::cmd_more(const std::vector<std::string>& UNUSED(args)) {
+  if (!_preview_result) {
+    println("There are no more rows to print.");
+    return true;
+  }
+
+  dump_result(_preview_result, true);
+
+  return true;
+}
+
+bool Base_shell::cmd_stats(const std::vector<std::string>& args) {
+  // The first argument is the command itself
+  if (args.size() > 2 || (args.size() == 2 && args[1] != "reset")) {
+    print_error("\\stats [reset]\n");
+    return true;
+  }
+
+  println(shcore::Statement_stats::get().get_stats(args.size() == 2).json(true));
+
+  return true;
+}
+
+bool Base_shell::cmd_profile(const std::vector<std::string>& args) {
+  // The first argument is the command itself
+  std::string action = args.size() > 1 ? args[1] : "";
+
+  if (args.size() == 2 && action == "on") {
+    shcore::Profiler::get().start();
+  } else if (args.size() == 2 && action == "off") {
+    shcore::Profiler::get().stop();
+  } else if ((args.size() == 2 || args.size() == 3) && action == "report") {
+    println(shcore::Profiler::get().flat_report());
+
+    if (args.size() == 3) {
+      std::ofstream file(args[2].c_str(), std::ios::out | std::ios::trunc);
+      file << shcore::Profiler::get().collapsed_stacks();
+
+      if (file.fail())
+        print_error("Unable to write the profile to " + args[2] + ": " + shcore::get_last_error() + "\n");
+      else
+        println("Collapsed stacks written to " + args[2]);
+    }
+  } else {
+    print_error("\\profile on|off|report [<collapsed_stacks_file>]\n");
+  }
+
+  return true;
+}
+
+bool Base_shell::cmd_index_advisor(const std::vector<std::string>& args) {
+  // The first argument is the command itself
+  std::string action = args.size() == 2 ? args[1] : "";
+
+  if (action == "on")
+    mysqlx::Index_advisor::get().start();
+  else if (action == "off")
+    mysqlx::Index_advisor::get().stop();
+  else if (action == "report")
+    println(mysqlx::Index_advisor::get().report());
+  else
+    print_error("\\indexadvisor on|off|report\n");
+
+  return true;
+}
+
 bool Base_shell::cmd_status(const std::vector<std::string>& UNUSED(args)) {
   std::string version_msg("MySQL Shell Version ");
   version_msg += MYSH_VERSION;
@@ -740,6 +912,20 @@ bool Base_shell::cmd_status(const std::vector<std::string>& UNUSED(args)) {
           println("");
           println(stats.substr(end + 2));
         }
+
+        if (status->has_key("PROTOCOL_STATS")) {
+          shcore::Value::Map_type_ref stats = (*status)["PROTOCOL_STATS"].as_map();
+          auto count = [&stats](const char *name) { return (*stats)[name].descr(true); };
+
+          println((boost::format(format) % "Frames sent/received: " %
+                   (count("framesSent") + " / " + count("framesReceived"))).str());
+          println((boost::format(format) % "Bytes sent/received: " %
+                   (count("bytesSent") + " / " + count("bytesReceived"))).str());
+          println((boost::format(format) % "Notices received: " % count("notices")).str());
+          println((boost::format(format) % "Receive wait time (us): " % count("receiveWaitTime")).str());
+          println((boost::format(format) % "Decode time (us): " % count("decodeTime")).str());
+          println((boost::format(format) % "Rows buffered: " % count("rowsBuffered")).str());
+        }
       }
     }
   } else
@@ -815,6 +1001,13 @@ void Base_shell::process_line(const std::string &line) {
   bool handled_as_command = false;
   std::string to_history;
 
+  // The rest of a previewed result is abandoned before anything else runs,
+  // so it is not buffered when the next statement is sent
+  if (_preview_result && boost::trim_copy(line) != "\\more") {
+    _preview_result.reset();
+    _preview_record = shcore::Value();
+  }
+
   // check if the line is an escape/shell command
   if (_input_buffer.empty() && !line.empty() && _input_mode == shcore::Input_state::Ok) {
     try {
@@ -865,7 +1058,7 @@ void Base_shell::process_line(const std::string &line) {
     }
   }
 
-  if (!to_history.empty()) {
+  if (!to_history.empty() && shcore::ShellNotifications::get()->has_observers("SN_STATEMENT_EXECUTED")) {
     shcore::Value::Map_type_ref data(new shcore::Value::Map_type());
     (*data)["statement"] = shcore::Value(to_history);
     shcore::ShellNotifications::get()->notify("SN_STATEMENT_EXECUTED", nullptr, data);
@@ -874,6 +1067,39 @@ void Base_shell::process_line(const std::string &line) {
   _shell->reconnect_if_needed();
 }
 
+void Base_shell::process_paste(const std::string &text) {
+  std::vector<std::string> lines;
+  boost::split(lines, text, boost::is_any_of("\n"));
+  if (!lines.empty() && lines.back().empty())
+    lines.pop_back();
+
+  std::string code;
+  auto flush_code = [this, &code]() {
+    if (!code.empty()) {
+      process_line(code);
+      code.clear();
+    }
+  };
+
+  for (auto &line : lines) {
+    // Python runs a statement at a time, and a block only ends with an
+    // empty line, so those are fed as if typed
+    if (_shell->interactive_mode() == shcore::Shell_core::Mode::Python || _input_mode == shcore::Input_state::ContinuedBlock) {
+      flush_code();
+      process_line(line);
+    } else if (boost::trim_left_copy(line).compare(0, 1, "\\") == 0) {
+      flush_code();
+      process_line(line);
+    } else {
+      if (!code.empty())
+        code.append("\n");
+      code.append(line);
+    }
+  }
+
+  flush_code();
+}
+
 void Base_shell::abort() {
   if (!_shell) return;
 
@@ -887,7 +1113,7 @@ void Base_shell::abort() {
 }
 
 void Base_shell::process_result(shcore::Value result) {
-  if ((*shcore::Shell_core_options::get())[SHCORE_INTERACTIVE].as_bool()
+  if (shcore::Shell_core_options::typed().interactive
       || _shell->interactive_mode() == shcore::Shell_core::Mode::SQL) {
     if (result) {
       shcore::Value shell_hook;
@@ -912,9 +1138,7 @@ void Base_shell::process_result(shcore::Value result) {
         if (object && object->class_name().find("Result") != std::string::npos) {
           std::shared_ptr<mysqlsh::ShellBaseResult> resultset = std::static_pointer_cast<mysqlsh::ShellBaseResult> (object);
 
-          // Result buffering will be done ONLY if on any of the scripting interfaces
-          ResultsetDumper dumper(resultset, _shell->get_delegate(), _shell->interactive_mode() != shcore::IShell_core::Mode::SQL);
-          dumper.dump();
+          dump_result(resultset);
         } else {
           // In JSON mode: the json representation is used for Object, Array and Map
           // For anything else a map is printed with the "value" key
@@ -933,6 +1157,63 @@ void Base_shell::process_result(shcore::Value result) {
   _shell->set_error_processing();
 }
 
+void Base_shell::dump_result(std::shared_ptr<mysqlsh::ShellBaseResult> resultset, bool resume) {
+  std::string pager = (*shcore::Shell_core_options::get())[SHCORE_PAGER].as_string();
+
+  // Result buffering will be done ONLY if on any of the scripting interfaces
+  ResultsetDumper dumper(resultset, _shell->get_delegate(), _shell->interactive_mode() != shcore::IShell_core::Mode::SQL);
+  if (resume)
+    dumper.resume(_preview_rows, _preview_record);
+
+  // Kept for \more if the preview stopped before the end of the rows
+  auto keep_preview = [this, &dumper, resultset]() {
+    if (dumper.has_more()) {
+      _preview_result = resultset;
+      _preview_record = dumper.pending_record();
+      _preview_rows = dumper.rows_printed();
+    } else {
+      _preview_result.reset();
+      _preview_record = shcore::Value();
+    }
+  };
+
+  if (pager.empty() || !_options.interactive || !_client_delegate) {
+    dumper.dump();
+    keep_preview();
+    return;
+  }
+
+  // The result is read into the spool at full speed and paged afterwards,
+  // so a slow reader does not keep the server waiting on the result
+  Output_spool spool;
+  auto print = _client_delegate->print;
+  auto user_data = _client_delegate->user_data;
+
+  _client_delegate->print = &Output_spool::print;
+  _client_delegate->user_data = &spool;
+
+  try {
+    dumper.dump();
+  } catch (...) {
+    _client_delegate->print = print;
+    _client_delegate->user_data = user_data;
+    throw;
+  }
+
+  _client_delegate->print = print;
+  _client_delegate->user_data = user_data;
+  keep_preview();
+
+  if (!spool.page(pager)) {
+    log_warning("Unable to start the pager '%s', printing the result directly", pager.c_str());
+
+    spool.replay([print, user_data](const char *data, size_t length) {
+      print(user_data, std::string(data, length).c_str());
+      return true;
+    });
+  }
+}
+
 int Base_shell::process_file(const std::string& file, const std::vector<std::string> &argv) {
   // Default return value will be 1 indicating there were errors
   int ret_val = 1;
@@ -941,9 +1222,20 @@ int Base_shell::process_file(const std::string& file, const std::vector<std::str
     print_error("Usage: \\. <filename> | \\source <filename>\n");
   else if (_shell->is_module(file))
     _shell->execute_module(file, _result_processor, argv);
-  else
-    //TODO: do path expansion (in case ~ is used in linux)
-  {
+  //TODO: do path expansion (in case ~ is used in linux)
+  else if (!_options.interactive) {
+    // The file is mapped in memory instead of being read through a stream
+    try {
+      ret_val = _shell->process_file(file, _result_processor, argv);
+
+      // When force is used, we do not care of the processing
+      // errors
+      if (_options.force)
+        ret_val = 0;
+    } catch (std::runtime_error &) {
+      print_error((boost::format("Failed to open file '%s', error: %d\n") % file % errno).str());
+    }
+  } else {
     std::ifstream s(file.c_str());
 
     if (!s.fail()) {
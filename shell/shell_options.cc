@@ -38,6 +38,8 @@ Shell_options::Shell_options() {
   print_cmd_line_helper = false;
   print_version = false;
   force = false;
+  batch_pipeline = 1;
+  batch_commit = 0;
   interactive = false;
   full_interactive = false;
   passwords_from_stdin = false;
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "shell/shell_output_spool.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef WIN32
+#define popen _popen
+#define pclose _pclose
+#else
+#include <signal.h>
+#endif
+
+namespace mysqlsh {
+Output_spool::Output_spool(size_t memory_limit)
+  : _memory_limit(memory_limit), _file(nullptr), _size(0) {
+}
+
+Output_spool::~Output_spool() {
+  // The temporary file is deleted when closed
+  if (_file)
+    std::fclose(_file);
+}
+
+void Output_spool::append(const char *text, size_t length) {
+  _size += length;
+
+  if (!_file && _buffer.size() + length > _memory_limit) {
+    _file = std::tmpfile();
+
+    // Without a temporary file everything is kept in memory
+    if (_file) {
+      if (!_buffer.empty() && std::fwrite(_buffer.data(), 1, _buffer.size(), _file) != _buffer.size())
+        throw std::runtime_error("Unable to write the output into a temporary file");
+
+      _buffer.clear();
+      _buffer.shrink_to_fit();
+    }
+  }
+
+  if (_file) {
+    if (std::fwrite(text, 1, length, _file) != length)
+      throw std::runtime_error("Unable to write the output into a temporary file");
+  } else {
+    _buffer.append(text, length);
+  }
+}
+
+bool Output_spool::replay(const std::function<bool(const char *data, size_t length)> &writer) {
+  if (!_file)
+    return _buffer.empty() || writer(_buffer.data(), _buffer.size());
+
+  std::fflush(_file);
+  std::rewind(_file);
+
+  char chunk[64 * 1024];
+  size_t length;
+  while ((length = std::fread(chunk, 1, sizeof(chunk), _file)) > 0) {
+    if (!writer(chunk, length))
+      return false;
+  }
+
+  return true;
+}
+
+bool Output_spool::page(const std::string &pager) {
+  std::FILE *pipe = popen(pager.c_str(), "w");
+  if (!pipe)
+    return false;
+
+#ifndef WIN32
+  // Quitting the pager before the end closes the pipe, which must not end
+  // the shell
+  struct sigaction ignore, previous;
+  memset(&ignore, 0, sizeof(ignore));
+  ignore.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &ignore, &previous);
+#endif
+
+  replay([pipe](const char *data, size_t length) {
+    return std::fwrite(data, 1, length, pipe) == length;
+  });
+
+  pclose(pipe);
+
+#ifndef WIN32
+  sigaction(SIGPIPE, &previous, nullptr);
+#endif
+
+  return true;
+}
+
+void Output_spool::print(void *self, const char *text) {
+  static_cast<Output_spool*>(self)->append(text, std::strlen(text));
+}
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _SHELL_OUTPUT_SPOOL_H_
+#define _SHELL_OUTPUT_SPOOL_H_
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "shellcore/common.h"
+
+namespace mysqlsh {
+// Keeps the output of a statement so it can be printed once the statement
+// is done, i.e. through a pager. Writing to it never waits for the terminal,
+// so the result is read at full speed and its server resources released
+// right away. Past the memory limit the output is spilled into a temporary
+// file.
+class SHCORE_PUBLIC Output_spool {
+public:
+  explicit Output_spool(size_t memory_limit = 4 * 1024 * 1024);
+  ~Output_spool();
+
+  void append(const char *text, size_t length);
+  void append(const std::string &text) { append(text.data(), text.size()); }
+
+  size_t size() const { return _size; }
+  bool spilled() const { return _file != nullptr; }
+
+  // Passes the output to the writer in the order it was appended, the
+  // writer returns false to stop, i.e. when the pager was closed
+  bool replay(const std::function<bool(const char *data, size_t length)> &writer);
+
+  // Prints the output through the pager command, returns false if the
+  // pager could not be started
+  bool page(const std::string &pager);
+
+  // Matches the print callback of shcore::Interpreter_delegate
+  static void print(void *self, const char *text);
+
+private:
+  size_t _memory_limit;
+  std::string _buffer;
+  std::FILE *_file;
+  size_t _size;
+};
+}
+
+#endif
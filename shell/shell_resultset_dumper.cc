@@ -20,49 +20,348 @@
 #include "shell/shell_resultset_dumper.h"
 #include "shellcore/shell_core_options.h"
 #include <boost/format.hpp>
-#include <boost/lexical_cast.hpp>
 #include "modules/mod_mysql_resultset.h"
 #include "modules/mod_mysqlx_resultset.h"
+#include "utils/utils_general.h"
+#include "utils/utils_json.h"
+#include "utils/utils_profile.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #define MAX_COLUMN_LENGTH 1024
 #define MIN_COLUMN_LENGTH 4
 
+// Number of rows used to calculate the column widths on streamed table output
+#define STREAMING_SAMPLE_SIZE 1000
+
+// Size of the chunks printed by the raw tabbed output
+#define RAW_OUTPUT_CHUNK_SIZE (64 * 1024)
+
+// Records formatted together by a thread on table and vertical output
+#define FORMAT_CHUNK_SIZE 256
+
+// Threads used to format the table and vertical output
+#define MAX_FORMAT_THREADS 4
+
 using options = shcore::Shell_core_options;
+using Format = shcore::Typed_core_options::Output_format;
+
+namespace {
+// Formats chunks of records on a pool of threads while the next ones are
+// fetched. The chunks are printed in order by the thread submitting them,
+// which is also the only one creating and releasing the records as the
+// results are not thread safe.
+class Format_pipeline {
+public:
+  typedef shcore::Value::Array_type Records;
+  typedef std::function<std::string(const Records &records, size_t first)> Formatter;
+  typedef std::function<void(const std::string &text)> Printer;
+
+  Format_pipeline(const Formatter &formatter, const Printer &printer)
+    : _formatter(formatter), _printer(printer), _stop(false) {
+    _thread_count = std::min<size_t>(std::thread::hardware_concurrency(), MAX_FORMAT_THREADS);
+  }
+
+  ~Format_pipeline() {
+    // Pending chunks are still formatted, so their records are not in use
+    // once they are released
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _condition.notify_all();
+
+    for (auto &worker : _workers)
+      worker.join();
+  }
+
+  // The first record is the position of the chunk on the whole output
+  void submit(std::shared_ptr<Records> records, size_t first) {
+    if (records->empty())
+      return;
+
+    Chunk chunk;
+    chunk.records = records;
+    chunk.first = first;
+
+    if (_thread_count < 2) {
+      _printer(_formatter(*records, first));
+      return;
+    }
+
+    // Nothing is started for results with a single chunk
+    if (!_deferred.records) {
+      if (_workers.empty()) {
+        _deferred = std::move(chunk);
+        return;
+      }
+    } else {
+      for (size_t index = 0; index < _thread_count; index++)
+        _workers.push_back(std::thread(&Format_pipeline::work, this));
+
+      queue(std::move(_deferred));
+      _deferred = Chunk();
+    }
+
+    queue(std::move(chunk));
+
+    // The formatted chunks are printed as soon as possible, waiting for the
+    // oldest one when too many are in flight to bound the memory in use
+    while (!_pending.empty() &&
+           (_pending.size() > 2 * _thread_count ||
+            _pending.front().text.wait_for(std::chrono::seconds(0)) == std::future_status::ready))
+      print_next();
+  }
+
+  void finish() {
+    if (_deferred.records) {
+      _printer(_formatter(*_deferred.records, _deferred.first));
+      _deferred = Chunk();
+    }
+
+    while (!_pending.empty())
+      print_next();
+  }
+
+private:
+  struct Chunk {
+    std::shared_ptr<Records> records;
+    size_t first;
+    std::future<std::string> text;
+  };
+
+  void queue(Chunk chunk) {
+    // The task only references the records, they are owned by the chunk
+    const Records *records = chunk.records.get();
+    size_t first = chunk.first;
+    std::shared_ptr<std::packaged_task<std::string()> > task(new std::packaged_task<std::string()>(
+      [this, records, first]() { return _formatter(*records, first); }));
+
+    chunk.text = task->get_future();
+    _pending.push_back(std::move(chunk));
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _tasks.push_back([task]() { (*task)(); });
+    }
+    _condition.notify_one();
+  }
+
+  void print_next() {
+    Chunk chunk = std::move(_pending.front());
+    _pending.pop_front();
+
+    // Errors formatting the chunk are raised here
+    _printer(chunk.text.get());
+  }
+
+  void work() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+
+        if (_tasks.empty())
+          return;
+
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+      }
+
+      task();
+    }
+  }
+
+  Formatter _formatter;
+  Printer _printer;
+  size_t _thread_count;
+
+  Chunk _deferred;
+  std::deque<Chunk> _pending;
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::deque<std::function<void()> > _tasks;
+  std::vector<std::thread> _workers;
+  bool _stop;
+};
+
+// Appends the text padded with spaces up to the given display width
+void append_cell(std::string &out, const std::string &text, size_t width, bool right_align) {
+  size_t text_width = shcore::display_width(text);
+  size_t padding = width > text_width ? width - text_width : 0;
+
+  if (right_align)
+    out.append(padding, ' ');
+
+  out += text;
+
+  if (!right_align)
+    out.append(padding, ' ');
+}
+
+// Splits the records into the chunks formatted by the pipeline
+void submit_records(Format_pipeline &pipeline, const shcore::Value::Array_type &records) {
+  for (size_t start = 0; start < records.size(); start += FORMAT_CHUNK_SIZE) {
+    size_t end = std::min<size_t>(start + FORMAT_CHUNK_SIZE, records.size());
+    std::shared_ptr<shcore::Value::Array_type> chunk(new shcore::Value::Array_type(records.begin() + start,
+                                                                                   records.begin() + end));
+    pipeline.submit(chunk, start);
+  }
+}
+}
 
 ResultsetDumper::ResultsetDumper(std::shared_ptr<mysqlsh::ShellBaseResult> target, shcore::Interpreter_delegate *output_handler, bool buffer_data) :
 _resultset(target), _output_handler(output_handler), _buffer_data(buffer_data) {
-  _format = options::get()->get_string(SHCORE_OUTPUT_FORMAT);
-  _interactive = options::get()->get_bool(SHCORE_INTERACTIVE);
-  _show_warnings = options::get()->get_bool(SHCORE_SHOW_WARNINGS);
+  const shcore::Typed_core_options &typed = options::typed();
+  _format = typed.output_format;
+  _interactive = typed.interactive;
+  _show_warnings = typed.show_warnings;
+
+  // Streaming consumes the result as it is printed so it is incompatible
+  // with buffering the data
+  _streaming = typed.output_streaming;
+  if (_streaming || _format == Format::Ndjson)
+    _buffer_data = false;
+
+  // The preview leaves the rest of the rows unread
+  _preview_limit = _interactive ? static_cast<size_t>(typed.result_preview_limit) : 0;
+  if (_preview_limit)
+    _buffer_data = false;
+  _row_offset = 0;
+}
+
+void ResultsetDumper::resume(size_t rows_printed, shcore::Value pending_record) {
+  _row_offset = rows_printed;
+  _pending_record = pending_record;
 }
 
 void ResultsetDumper::dump() {
+  shcore::Profile_frame frame("print result");
   std::string type = _resultset->class_name();
 
-  // Buffers the data remaining on the record
-  size_t rset, record;
-  bool buffered = false;;
-  if (_buffer_data) {
-    _resultset->buffer();
+  // The time fetching the result while it is printed is accounted by the
+  // result itself, the rest is the time formatting it
+  shcore::Statement_timing &timing = _resultset->timing();
+  uint64_t fetch_time = timing.phases[shcore::Statement_timing::Network] +
+                        timing.phases[shcore::Statement_timing::Decode];
+  uint64_t dump_time = 0;
+  _resultset->hold_timing(true);
+
+  {
+    shcore::Phase_timer dump_timer(dump_time);
+
+    // Buffers the data remaining on the record
+    size_t rset, record;
+    bool buffered = false;;
+    if (_buffer_data) {
+      {
+        shcore::Phase_timer network_timer(timing.phases[shcore::Statement_timing::Network]);
+        _resultset->buffer();
+      }
+
+      // Stores the current data set/record position on the result
+      buffered = _resultset->tell(rset, record);
+    }
+
+    if (_format == Format::Json || _format == Format::Json_raw)
+      dump_json();
+    else if (_format == Format::Ndjson)
+      dump_ndjson();
+    else if (_format == Format::Arrow)
+      dump_arrow();
+    else
+      dump_normal();
 
-    // Stores the current data set/record position on the result
-    buffered = _resultset->tell(rset, record);
+    // Restores the data set/record positions on the result
+    if (buffered)
+      _resultset->seek(rset, record);
   }
 
-  if (_format.find("json") == 0)
-    dump_json();
-  else
-    dump_normal();
+  fetch_time = timing.phases[shcore::Statement_timing::Network] +
+               timing.phases[shcore::Statement_timing::Decode] - fetch_time;
+  if (dump_time > fetch_time)
+    timing.phases[shcore::Statement_timing::Format] += dump_time - fetch_time;
 
-  // Restores the data set/record positions on the result
-  if (buffered)
-    _resultset->seek(rset, record);
+  // A printed result is consumed, even when not all its rows were read
+  _resultset->hold_timing(false);
+  _resultset->record_timing();
 }
 
 void ResultsetDumper::dump_json() {
   shcore::Value resultset(std::static_pointer_cast<shcore::Object_bridge>(_resultset));
 
-  _output_handler->print_value(_output_handler->user_data, resultset, "");
+  // The JSON is printed in chunks while the records are fetched instead of
+  // creating the whole document first
+  shcore::JSON_dumper dumper(_format == Format::Json, [this](const std::string &chunk) {
+    _output_handler->print(_output_handler->user_data, chunk.c_str());
+  });
+
+  dumper.append_value(resultset);
+  dumper.flush();
+
+  _output_handler->print(_output_handler->user_data, "\n");
+}
+
+void ResultsetDumper::dump_ndjson() {
+  // Every record is printed on a line of its own as soon as it is fetched,
+  // then a line with the summary of its data set, so nothing is kept
+  bool has_records = _resultset->has_member("fetchOne");
+  bool has_data_sets = _resultset->has_member("nextDataSet");
+
+  do {
+    // Statements without rows only get their summary
+    bool has_data = has_records &&
+      (!_resultset->has_member("hasData") || _resultset->call("hasData", shcore::Argument_list()).as_bool());
+
+    uint64_t count = 0;
+    if (has_data) {
+      shcore::Value record;
+      while ((record = _resultset->call("fetchOne", shcore::Argument_list()))) {
+        std::string line = record.json(false);
+        line += "\n";
+        _output_handler->print(_output_handler->user_data, line.c_str());
+        count++;
+      }
+    }
+
+    shcore::JSON_dumper dumper(false);
+    dumper.start_object();
+    dumper.append_string("summary");
+    dumper.start_object();
+    if (has_data)
+      dumper.append_value(_resultset->class_name() == "DocResult" ? "documentCount" : "rowCount", shcore::Value(count));
+
+    for (const char *member : {"affectedItemCount", "affectedRowCount", "autoIncrementValue", "info", "executionTime", "warningCount"}) {
+      if (_resultset->has_member(member))
+        dumper.append_value(member, _resultset->get_member(member));
+    }
+
+    if (_show_warnings && _resultset->has_member("warnings"))
+      dumper.append_value("warnings", _resultset->get_member("warnings"));
+
+    dumper.end_object();
+    dumper.end_object();
+    _output_handler->print(_output_handler->user_data, (dumper.str() + "\n").c_str());
+  } while (has_data_sets && _resultset->call("nextDataSet", shcore::Argument_list()).as_bool());
+}
+
+void ResultsetDumper::dump_arrow() {
+  // Every result is written as a stream of its own, the stream is binary
+  // so it does not go through the output handler
+  size_t row_count;
+  bool dumped = _resultset->dump_arrow([](const char *data, size_t size) {
+    std::cout.write(data, size);
+  }, row_count);
+  std::cout.flush();
+
+  if (!dumped)
+    _output_handler->print_error(_output_handler->user_data, "The result can not be written as Arrow\n");
 }
 
 void ResultsetDumper::dump_normal() {
@@ -119,7 +418,7 @@ void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysql::ClassicResult>
     // Prints the warnings if there were any
     if (warning_count && _show_warnings)
       dump_warnings(true);
-  } while (result->next_data_set(shcore::Argument_list()).as_bool());
+  } while (!has_more() && result->next_data_set(shcore::Argument_list()).as_bool());
 }
 
 void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysqlx::SqlResult> result) {
@@ -141,7 +440,7 @@ void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysqlx::SqlResult> re
       if (warning_count && _show_warnings)
         dump_warnings();
     }
-  } while (result->next_data_set(shcore::Argument_list()).as_bool());
+  } while (!has_more() && result->next_data_set(shcore::Argument_list()).as_bool());
 }
 
 void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysqlx::RowResult> result) {
@@ -164,14 +463,19 @@ void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysqlx::RowResult> re
 void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysqlx::DocResult> result) {
   std::string output;
 
-  shcore::Value documents = result->fetch_all(shcore::Argument_list());
+  shcore::Value documents = _preview_limit ? shcore::Value(fetch_preview()) : result->fetch_all(shcore::Argument_list());
   shcore::Value::Array_type_ref array_docs = documents.as_array();
+  if (_preview_limit)
+    _row_offset += array_docs->size();
 
   if (array_docs->size()) {
     _output_handler->print_value(_output_handler->user_data, documents, "");
 
-    int row_count = int(array_docs->size());
-    output = (boost::format("%lld %s in set") % row_count % (row_count == 1 ? "document" : "documents")).str();
+    size_t row_count = _preview_limit ? _row_offset : array_docs->size();
+    if (has_more())
+      output = (boost::format("%lld documents shown, \\more for the next ones") % row_count).str();
+    else
+      output = (boost::format("%lld %s in set") % row_count % (row_count == 1 ? "document" : "documents")).str();
   } else
     output = "Empty set";
 
@@ -202,146 +506,190 @@ void ResultsetDumper::dump_normal(std::shared_ptr<mysqlsh::mysqlx::Result> resul
 }
 
 void ResultsetDumper::dump_tabbed(shcore::Value::Array_type_ref records) {
+  print_tabbed_header();
+
+  // Now prints the records
+  for (size_t row_index = 0; row_index < records->size(); row_index++)
+    print_tabbed_row((*records)[row_index]);
+}
+
+void ResultsetDumper::print_tabbed_header() {
   std::shared_ptr<shcore::Value::Array_type> metadata = _resultset->get_member("columns").as_array();
 
   size_t index = 0;
   size_t field_count = metadata->size();
-  std::vector<std::string> formats(field_count, "%-");
 
-  // Prints the initial separator line and the column headers
+  // Prints the column headers
   // TODO: Consider the charset information on the length calculations
   for (index = 0; index < field_count; index++) {
     std::shared_ptr<mysqlsh::Column> column = std::static_pointer_cast<mysqlsh::Column>(metadata->at(index).as_object());
     _output_handler->print(_output_handler->user_data, column->get_column_label().c_str());
     _output_handler->print(_output_handler->user_data, index < (field_count - 1) ? "\t" : "\n");
   }
+}
 
-  // Now prints the records
-  for (size_t row_index = 0; row_index < records->size(); row_index++) {
-    std::shared_ptr<mysqlsh::Row> row = (*records)[row_index].as_object<mysqlsh::Row>();
+void ResultsetDumper::print_tabbed_row(shcore::Value record) {
+  std::shared_ptr<mysqlsh::Row> row = record.as_object<mysqlsh::Row>();
+  size_t field_count = row->get_length();
 
-    for (size_t field_index = 0; field_index < field_count; field_index++) {
-      std::string raw_value = row->get_member(field_index).descr();
-      _output_handler->print(_output_handler->user_data, raw_value.c_str());
-      _output_handler->print(_output_handler->user_data, field_index < (field_count - 1) ? "\t" : "\n");
-    }
+  for (size_t field_index = 0; field_index < field_count; field_index++) {
+    std::string raw_value;
+    row->append_field(raw_value, field_index);
+    _output_handler->print(_output_handler->user_data, raw_value.c_str());
+    _output_handler->print(_output_handler->user_data, field_index < (field_count - 1) ? "\t" : "\n");
   }
 }
 
 void ResultsetDumper::dump_vertical(shcore::Value::Array_type_ref records) {
+  std::vector<std::string> labels = get_column_labels();
+
+  // Rows of a resumed preview continue the numbering
+  size_t offset = _row_offset;
+  Format_pipeline pipeline([&labels, offset](const shcore::Value::Array_type &chunk, size_t first) {
+    return format_vertical_rows(labels, chunk, offset + first + 1);
+  }, [this](const std::string &text) {
+    _output_handler->print(_output_handler->user_data, text.c_str());
+  });
+
+  submit_records(pipeline, *records);
+  pipeline.finish();
+}
+
+std::vector<std::string> ResultsetDumper::get_column_labels() {
   std::shared_ptr<shcore::Value::Array_type> metadata = _resultset->get_member("columns").as_array();
-  auto field_count = metadata->size();
-  std::string star_separator(27, '*');
+  std::vector<std::string> labels;
 
-  // Calculate length of a longest column description, used to right align
-  // column descriptions
-  std::size_t max_col_len = 0;
-  for (int col_index = 0; col_index < metadata->size(); col_index++) {
+  for (size_t col_index = 0; col_index < metadata->size(); col_index++) {
     std::shared_ptr<mysqlsh::Column> column =
         std::static_pointer_cast<mysqlsh::Column>(metadata->at(col_index).as_object());
-    max_col_len = std::max(max_col_len,  column->get_column_label().length());
+    labels.push_back(column->get_column_label());
   }
 
-  for (int row_index = 0; row_index < records->size(); row_index++) {
-    std::string row_header = star_separator + " " + std::to_string(row_index + 1) +
-      ". row " + star_separator + "\n";
+  return labels;
+}
 
-    _output_handler->print(_output_handler->user_data, row_header.c_str());
+std::string ResultsetDumper::format_vertical_rows(const std::vector<std::string> &labels,
+                                                  const shcore::Value::Array_type &records, size_t row_number) {
+  // Calculate length of a longest column description, used to right align
+  // column descriptions
+  size_t max_col_len = 0;
+  for (auto &label : labels)
+    max_col_len = std::max(max_col_len, shcore::display_width(label));
 
-    for (int col_index = 0; col_index < metadata->size(); col_index++) {
-      std::shared_ptr<mysqlsh::Column> column =
-          std::static_pointer_cast<mysqlsh::Column>(metadata->at(col_index).as_object());
+  std::string star_separator(27, '*');
+  std::string text;
 
-      std::shared_ptr<mysqlsh::Row> row = records->at(row_index).as_object<mysqlsh::Row>();
-      std::string padding(max_col_len - column->get_column_label().size(), ' ');
-      std::string value_row = padding + column->get_column_label() + ": " +
-          row->get_member(col_index).descr() + "\n";
+  for (auto &record : records) {
+    text += star_separator + " " + std::to_string(row_number++) + ". row " + star_separator + "\n";
 
-      _output_handler->print(_output_handler->user_data, value_row.c_str());
+    std::shared_ptr<mysqlsh::Row> row = record.as_object<mysqlsh::Row>();
+    for (size_t col_index = 0; col_index < labels.size(); col_index++) {
+      append_cell(text, labels[col_index], max_col_len, true);
+      text += ": ";
+      row->append_field(text, col_index);
+      text += "\n";
     }
   }
+
+  return text;
 }
 
 void ResultsetDumper::dump_table(shcore::Value::Array_type_ref records) {
+  Table_layout layout = get_table_layout(records, false);
+
+  print_table_header(layout);
+
+  // Now prints the records
+  Format_pipeline pipeline([&layout](const shcore::Value::Array_type &chunk, size_t) {
+    return format_table_rows(layout, chunk);
+  }, [this](const std::string &text) {
+    _output_handler->print(_output_handler->user_data, text.c_str());
+  });
+
+  submit_records(pipeline, *records);
+  pipeline.finish();
+
+  _output_handler->print(_output_handler->user_data, layout.separator.c_str());
+}
+
+ResultsetDumper::Table_layout ResultsetDumper::get_table_layout(shcore::Value::Array_type_ref records, bool use_metadata) {
   std::shared_ptr<shcore::Value::Array_type> metadata = _resultset->get_member("columns").as_array();
-  std::vector<uint64_t> max_lengths;
-  std::vector<std::string> column_names;
-  std::vector<bool> numerics;
+  Table_layout layout;
 
   size_t field_count = metadata->size();
 
-  // Updates the max_length array with the maximum length between column name, min column length and column max length
+  // Updates the widths with the maximum length between column name, min column length and column max length
   for (size_t field_index = 0; field_index < field_count; field_index++) {
     std::shared_ptr<mysqlsh::Column> column = std::static_pointer_cast<mysqlsh::Column>(metadata->at(field_index).as_object());
 
-    column_names.push_back(column->get_column_label());
-    numerics.push_back(column->is_numeric());
+    layout.column_names.push_back(column->get_column_label());
+    layout.numerics.push_back(column->is_numeric());
+    layout.widths.push_back(shcore::display_width(column->get_column_label()));
 
-    max_lengths.push_back(0);
-    max_lengths[field_index] = std::max<uint64_t>(max_lengths[field_index], column->get_column_label().length());
+    // When the records are only a sample of the result, the display length
+    // on the metadata (bounded) is used for the numeric columns, for them it
+    // is reliable and the rows not sampled will most likely fit
+    if (use_metadata && column->is_numeric())
+      layout.widths[field_index] = std::max<size_t>(layout.widths[field_index],
+                                                    std::min<uint64_t>(column->get_length(), MAX_COLUMN_LENGTH));
   }
 
   // Now updates the length with the real column data lengths
-  size_t row_index;
-  for (row_index = 0; row_index < records->size(); row_index++) {
+  std::string value;
+  for (size_t row_index = 0; row_index < records->size(); row_index++) {
     std::shared_ptr<mysqlsh::Row> row = (*records)[row_index].as_object<mysqlsh::Row>();
-    for (size_t field_index = 0; field_index < field_count; field_index++)
-      max_lengths[field_index] = std::max<uint64_t>(max_lengths[field_index], row->get_member(field_index).descr().length());
+    for (size_t field_index = 0; field_index < field_count; field_index++) {
+      value.clear();
+      row->append_field(value, field_index);
+      layout.widths[field_index] = std::max(layout.widths[field_index], shcore::display_width(value));
+    }
   }
 
-  //-----------
-
-  size_t index = 0;
-  std::vector<std::string> formats(field_count, "%-");
-
-  // Calculates the max column widths and constructs the separator line.
-  std::string separator("+");
-  for (index = 0; index < field_count; index++) {
-    // Creates the format string to print each field
-    formats[index].append(boost::lexical_cast<std::string>(max_lengths[index]));
-    if (index == field_count - 1)
-      formats[index].append("s |");
-    else
-      formats[index].append("s | ");
-
-    std::string field_separator(max_lengths[index] + 2, '-');
-    field_separator.append("+");
-    separator.append(field_separator);
+  // Constructs the separator line with the column widths
+  layout.separator = "+";
+  for (size_t index = 0; index < field_count; index++) {
+    layout.separator.append(layout.widths[index] + 2, '-');
+    layout.separator.append("+");
   }
-  separator.append("\n");
+  layout.separator.append("\n");
 
-  // Prints the initial separator line and the column headers
-  // TODO: Consider the charset information on the length calculations
-  _output_handler->print(_output_handler->user_data, separator.c_str());
-  _output_handler->print(_output_handler->user_data, +"| ");
-  for (index = 0; index < field_count; index++) {
-    std::string data = (boost::format(formats[index]) % column_names[index]).str();
-    _output_handler->print(_output_handler->user_data, data.c_str());
+  return layout;
+}
 
-    // Once the header is printed, updates the numeric fields formats
-    // so they are right aligned
-    if (numerics[index])
-    formats[index] = formats[index].replace(1, 1, "");
+void ResultsetDumper::print_table_header(const Table_layout &layout) {
+  // Prints the initial separator line and the column headers, which are
+  // left aligned even for the numeric columns
+  std::string header = layout.separator + "|";
+  for (size_t index = 0; index < layout.widths.size(); index++) {
+    header += " ";
+    append_cell(header, layout.column_names[index], layout.widths[index], false);
+    header += " |";
   }
-  _output_handler->print(_output_handler->user_data, "\n");
-  _output_handler->print(_output_handler->user_data, separator.c_str());
+  header += "\n" + layout.separator;
 
-  // Now prints the records
-  for (row_index = 0; row_index < records->size(); row_index++) {
-    _output_handler->print(_output_handler->user_data, "| ");
+  _output_handler->print(_output_handler->user_data, header.c_str());
+}
 
-    std::shared_ptr<mysqlsh::Row> row = (*records)[row_index].as_object<mysqlsh::Row>();
+std::string ResultsetDumper::format_table_rows(const Table_layout &layout, const shcore::Value::Array_type &records) {
+  std::string text;
+  std::string value;
 
-    for (size_t field_index = 0; field_index < field_count; field_index++) {
-      std::string raw_value = row->get_member(field_index).descr();
-      std::string data = (boost::format(formats[field_index]) % (raw_value)).str();
+  for (auto &record : records) {
+    std::shared_ptr<mysqlsh::Row> row = record.as_object<mysqlsh::Row>();
 
-      _output_handler->print(_output_handler->user_data, data.c_str());
+    text += "|";
+    for (size_t field_index = 0; field_index < layout.widths.size(); field_index++) {
+      value.clear();
+      row->append_field(value, field_index);
+
+      text += " ";
+      append_cell(text, value, layout.widths[field_index], layout.numerics[field_index]);
+      text += " |";
     }
-    _output_handler->print(_output_handler->user_data, "\n");
+    text += "\n";
   }
 
-  _output_handler->print(_output_handler->user_data, separator.c_str());
+  return text;
 }
 
 std::string ResultsetDumper::get_affected_stats(const std::string& member, const std::string &legend) {
@@ -376,15 +724,80 @@ int ResultsetDumper::get_warning_and_execution_time_stats(std::string& output_st
   return warning_count;
 }
 
+// The rows of the preview, starting with the one kept by the previous
+// dump, and one more is read to know whether there are others
+shcore::Value::Array_type_ref ResultsetDumper::fetch_preview() {
+  shcore::Value::Array_type_ref records(new shcore::Value::Array_type());
+  if (_pending_record)
+    records->push_back(_pending_record);
+
+  shcore::Value record;
+  while (records->size() < _preview_limit &&
+         (record = _resultset->call("fetchOne", shcore::Argument_list())))
+    records->push_back(record);
+
+  _pending_record = shcore::Value();
+  if (records->size() == _preview_limit)
+    _pending_record = _resultset->call("fetchOne", shcore::Argument_list());
+
+  return records;
+}
+
 void ResultsetDumper::dump_records(std::string& output_stats) {
+  if (_preview_limit) {
+    shcore::Value::Array_type_ref records = fetch_preview();
+    if (records->size()) {
+      if (_format == Format::Vertical)
+        dump_vertical(records);
+      else
+        dump_table(records);
+    }
+
+    _row_offset += records->size();
+    if (has_more()) {
+      output_stats = (boost::format("%lld rows shown, \\more for the next ones") % _row_offset).str();
+    } else {
+      if (_row_offset)
+        output_stats = (boost::format("%lld %s in set") % _row_offset % (_row_offset == 1 ? "row" : "rows")).str();
+      else
+        output_stats = "Empty set";
+
+      // The next data set is numbered from the start
+      _row_offset = 0;
+    }
+
+    return;
+  }
+
+  size_t raw_count;
+  if (dump_records_raw(raw_count)) {
+    if (raw_count)
+      output_stats = (boost::format("%lld %s in set") % raw_count % (raw_count == 1 ? "row" : "rows")).str();
+    else
+      output_stats = "Empty set";
+
+    return;
+  }
+
+  if (_streaming) {
+    size_t row_count = dump_records_streamed();
+
+    if (row_count)
+      output_stats = (boost::format("%lld %s in set") % row_count % (row_count == 1 ? "row" : "rows")).str();
+    else
+      output_stats = "Empty set";
+
+    return;
+  }
+
   shcore::Value records = _resultset->call("fetchAll", shcore::Argument_list());
   shcore::Value::Array_type_ref array_records = records.as_array();
 
   if (array_records->size()) {
     // print rows from result, with stats etc
-    if (_format == "vertical")
+    if (_format == Format::Vertical)
       dump_vertical(array_records);
-    else if (_interactive || _format == "table")
+    else if (_interactive || _format == Format::Table)
       dump_table(array_records);
     else
       dump_tabbed(array_records);
@@ -395,6 +808,119 @@ void ResultsetDumper::dump_records(std::string& output_stats) {
     output_stats = "Empty set";
 }
 
+size_t ResultsetDumper::dump_records_streamed() {
+  size_t row_count = 0;
+  shcore::Value record;
+
+  Format_pipeline::Printer printer = [this](const std::string &text) {
+    _output_handler->print(_output_handler->user_data, text.c_str());
+  };
+
+  // The records are fetched here while the previous chunks are formatted
+  auto fetch_chunks = [this, &record, &row_count](Format_pipeline &pipeline) {
+    std::shared_ptr<shcore::Value::Array_type> chunk(new shcore::Value::Array_type());
+    while ((record = _resultset->call("fetchOne", shcore::Argument_list()))) {
+      chunk->push_back(record);
+
+      if (chunk->size() == FORMAT_CHUNK_SIZE) {
+        pipeline.submit(chunk, row_count);
+        row_count += chunk->size();
+        chunk.reset(new shcore::Value::Array_type());
+      }
+    }
+
+    pipeline.submit(chunk, row_count);
+    row_count += chunk->size();
+    pipeline.finish();
+  };
+
+  if (_format == Format::Vertical) {
+    std::vector<std::string> labels = get_column_labels();
+
+    Format_pipeline pipeline([&labels](const shcore::Value::Array_type &chunk, size_t first) {
+      return format_vertical_rows(labels, chunk, first + 1);
+    }, printer);
+
+    fetch_chunks(pipeline);
+  } else if (_interactive || _format == Format::Table) {
+    // The column widths are calculated using a bounded window of rows, the
+    // rest of the rows are printed as they are fetched
+    shcore::Value::Array_type_ref sample(new shcore::Value::Array_type());
+    while (sample->size() < STREAMING_SAMPLE_SIZE &&
+           (record = _resultset->call("fetchOne", shcore::Argument_list())))
+      sample->push_back(record);
+
+    if (sample->size()) {
+      Table_layout layout = get_table_layout(sample, true);
+
+      print_table_header(layout);
+
+      Format_pipeline pipeline([&layout](const shcore::Value::Array_type &chunk, size_t) {
+        return format_table_rows(layout, chunk);
+      }, printer);
+
+      submit_records(pipeline, *sample);
+      row_count = sample->size();
+      sample.reset();
+
+      fetch_chunks(pipeline);
+
+      _output_handler->print(_output_handler->user_data, layout.separator.c_str());
+    }
+  } else {
+    // Tabbed output has no width calculation at all
+    while ((record = _resultset->call("fetchOne", shcore::Argument_list()))) {
+      if (!row_count)
+        print_tabbed_header();
+
+      print_tabbed_row(record);
+      row_count++;
+    }
+  }
+
+  return row_count;
+}
+
+// The non interactive tabbed output, used when exporting data, is written by
+// the result straight from the protocol data in big chunks, no Row objects
+// are created for the records
+bool ResultsetDumper::dump_records_raw(size_t &row_count) {
+  if (_interactive || _buffer_data || _format == Format::Vertical || _format == Format::Table)
+    return false;
+
+  std::string header;
+  std::shared_ptr<shcore::Value::Array_type> metadata = _resultset->get_member("columns").as_array();
+  for (size_t index = 0; index < metadata->size(); index++) {
+    std::shared_ptr<mysqlsh::Column> column = std::static_pointer_cast<mysqlsh::Column>(metadata->at(index).as_object());
+    header += column->get_column_label();
+    header += index < (metadata->size() - 1) ? "\t" : "\n";
+  }
+
+  // The header is only printed if there are records
+  std::string buffer;
+  buffer.reserve(RAW_OUTPUT_CHUNK_SIZE + MAX_COLUMN_LENGTH);
+  bool header_printed = false;
+  auto print = [this, &header, &header_printed](std::string &chunk) {
+    if (!header_printed) {
+      _output_handler->print(_output_handler->user_data, header.c_str());
+      header_printed = true;
+    }
+
+    _output_handler->print(_output_handler->user_data, chunk.c_str());
+    chunk.clear();
+  };
+
+  bool dumped = _resultset->dump_raw(buffer, [&print](std::string &chunk) {
+    if (chunk.size() >= RAW_OUTPUT_CHUNK_SIZE)
+      print(chunk);
+  }, row_count);
+
+  if (dumped && !buffer.empty())
+    print(buffer);
+
+  return dumped;
+}
+
 void ResultsetDumper::dump_warnings(bool classic) {
   shcore::Value warnings = _resultset->get_member("warnings");
 
@@ -25,6 +25,7 @@
 #include "cmdline_options.h"
 #include "modules/base_resultset.h"
 #include "shellcore/lang_base.h"
+#include "shellcore/shell_core_options.h"
 
 namespace mysqlsh {
 namespace mysqlx {
@@ -43,15 +44,35 @@ public:
   ResultsetDumper(std::shared_ptr<mysqlsh::ShellBaseResult>target, shcore::Interpreter_delegate *output_handler, bool buffer_data);
   virtual void dump();
 
+  // With resultPreviewLimit, the interactive results print that many rows
+  // of a data set at a time, the next row read is kept to resume with it
+  bool has_more() const { return _pending_record ? true : false; }
+  shcore::Value pending_record() const { return _pending_record; }
+  size_t rows_printed() const { return _row_offset; }
+  void resume(size_t rows_printed, shcore::Value pending_record);
+
 protected:
   shcore::Interpreter_delegate *_output_handler;
   std::shared_ptr<mysqlsh::ShellBaseResult>_resultset;
-  std::string _format;
+  shcore::Typed_core_options::Output_format _format;
   bool _show_warnings;
   bool _interactive;
   bool _buffer_data;
+  bool _streaming;
+  size_t _preview_limit;
+  size_t _row_offset;
+  shcore::Value _pending_record;
+
+  struct Table_layout {
+    std::vector<std::string> column_names;
+    std::vector<bool> numerics;
+    std::vector<size_t> widths;
+    std::string separator;
+  };
 
   void dump_json();
+  void dump_ndjson();
+  void dump_arrow();
   void dump_normal();
   void dump_normal(std::shared_ptr<mysqlsh::mysql::ClassicResult> result);
   void dump_normal(std::shared_ptr<mysqlsh::mysqlx::SqlResult> result);
@@ -62,9 +83,23 @@ protected:
   std::string get_affected_stats(const std::string& member, const std::string &legend);
   int get_warning_and_execution_time_stats(std::string& output_stats);
   void dump_records(std::string& output_stats);
+  shcore::Value::Array_type_ref fetch_preview();
   void dump_tabbed(shcore::Value::Array_type_ref records);
   void dump_table(shcore::Value::Array_type_ref records);
   void dump_vertical(shcore::Value::Array_type_ref records);
+  size_t dump_records_streamed();
+  bool dump_records_raw(size_t &row_count);
+
+  void print_tabbed_header();
+  void print_tabbed_row(shcore::Value record);
+  std::vector<std::string> get_column_labels();
+  Table_layout get_table_layout(shcore::Value::Array_type_ref records, bool use_metadata);
+  void print_table_header(const Table_layout &layout);
+
+  // Used from the formatting threads, they only read the records
+  static std::string format_vertical_rows(const std::vector<std::string> &labels,
+                                          const shcore::Value::Array_type &records, size_t row_number);
+  static std::string format_table_rows(const Table_layout &layout, const shcore::Value::Array_type &records);
   void dump_warnings(bool classic = false);
 };
 #endif
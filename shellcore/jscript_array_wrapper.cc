@@ -49,15 +49,24 @@ JScript_array_wrapper::JScript_array_wrapper(JScript_context *context)
 }
 
 JScript_array_wrapper::~JScript_array_wrapper() {
+  // Wrappers collected after this point have nothing to unregister from
+  for (auto &wrapper : _wrappers)
+    wrapper.second->owner = NULL;
+
   _array_template.Reset();
 }
 
 struct shcore::JScript_array_wrapper::Collectable {
   std::shared_ptr<Value::Array_type> data;
   v8::Persistent<v8::Object> handle;
+  JScript_array_wrapper *owner;
 };
 
 v8::Handle<v8::Object> JScript_array_wrapper::wrap(std::shared_ptr<Value::Array_type> array) {
+  auto cached = _wrappers.find(array.get());
+  if (cached != _wrappers.end())
+    return v8::Local<v8::Object>::New(_context->isolate(), cached->second->handle);
+
   v8::Handle<v8::ObjectTemplate> templ = v8::Local<v8::ObjectTemplate>::New(_context->isolate(), _array_template);
 
   v8::Handle<v8::Object> obj(templ->NewInstance());
@@ -66,20 +75,25 @@ v8::Handle<v8::Object> JScript_array_wrapper::wrap(std::shared_ptr<Value::Array_
 
   Collectable *tmp = new Collectable();
   tmp->data = array;
+  tmp->owner = this;
   obj->SetAlignedPointerInInternalField(1, tmp);
   obj->SetAlignedPointerInInternalField(2, this);
 
   // marks the persistent instance to be garbage collectable, with a callback called on deletion
-  tmp->handle.Reset(_context->isolate(), v8::Persistent<v8::Object>(_context->isolate(), obj));
+  tmp->handle.Reset(_context->isolate(), obj);
   tmp->handle.SetWeak(tmp, wrapper_deleted);
   tmp->handle.MarkIndependent();
 
+  _wrappers[array.get()] = tmp;
+
   return obj;
 }
 
 void JScript_array_wrapper::wrapper_deleted(const v8::WeakCallbackData<v8::Object, Collectable>& data) {
   // the JS wrapper object was deleted, so we also free the shared-ref to the object
   v8::HandleScope hscope(data.GetIsolate());
+  if (data.GetParameter()->owner)
+    data.GetParameter()->owner->_wrappers.erase(data.GetParameter()->data.get());
   data.GetParameter()->data.reset();
   data.GetParameter()->handle.Reset();
   delete data.GetParameter();
@@ -41,12 +41,16 @@
 #include "shellcore/jscript_map_wrapper.h"
 #include "shellcore/jscript_array_wrapper.h"
 #include "utils/utils_general.h"
+#include "utils/utils_memory.h"
 
 #include "shellcore/jscript_type_conversion.h"
 #include "shellcore/jscript_core_definitions.h"
 #include <boost/format.hpp>
 #include <boost/system/error_code.hpp>
 #include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
@@ -58,6 +62,97 @@
 using namespace shcore;
 using namespace boost::system;
 
+// Free space of the heap after the idle collections that is worth a low
+// memory notification to give it back
+static const size_t kIdleReleasedHeap = 16 * 1024 * 1024;
+
+namespace {
+// Compiled code of the script files, kept on disk so running the same file
+// again skips parsing and compiling it. Every file has one entry, named by
+// the hash of its path, with the V8 version and the hash of the code it
+// was compiled from, so a changed file or another V8 replaces the entry.
+class Code_cache {
+public:
+  Code_cache(const std::string &path, const std::string &code)
+    : _code_hash(fnv1a(code)) {
+    try {
+      std::string dir = shcore::get_user_config_path();
+      if (!dir.empty()) {
+        dir += "jscache";
+        shcore::ensure_dir_exists(dir);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(fnv1a(path)));
+        _path = dir + "/" + name;
+      }
+    } catch (std::exception &e) {
+      log_debug("JavaScript code cache disabled: %s", e.what());
+    }
+  }
+
+  // The compiled code of the entry, if it is the one of this code
+  bool load(std::string *data) const {
+    if (_path.empty())
+      return false;
+
+    std::ifstream file(_path, std::ios::binary);
+    std::string header;
+    if (!file.good() || !std::getline(file, header) || header != this->header())
+      return false;
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    *data = contents.str();
+    return !data->empty();
+  }
+
+  // Written to a file of its own and renamed, so other shells running the
+  // same script never read half an entry
+  void store(const uint8_t *data, int length) const {
+    if (_path.empty() || length <= 0)
+      return;
+
+#ifdef WIN32
+    std::string temp_path = _path + "." + std::to_string(GetCurrentProcessId());
+#else
+    std::string temp_path = _path + "." + std::to_string(getpid());
+#endif
+    {
+      std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+      file << header() << "\n";
+      file.write(reinterpret_cast<const char*>(data), length);
+      if (!file.good()) {
+        file.close();
+        std::remove(temp_path.c_str());
+        return;
+      }
+    }
+
+    if (std::rename(temp_path.c_str(), _path.c_str()) != 0)
+      std::remove(temp_path.c_str());
+  }
+
+private:
+  static uint64_t fnv1a(const std::string &data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  std::string header() const {
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(_code_hash));
+    return std::string("mysqlsh-jscache ") + v8::V8::GetVersion() + " " + hash;
+  }
+
+  std::string _path;
+  uint64_t _code_hash;
+};
+}
+
 struct JScript_context::JScript_context_impl {
   JScript_context *owner;
   JScript_type_bridger types;
@@ -69,11 +164,21 @@ struct JScript_context::JScript_context_impl {
 
   Interpreter_delegate *delegate;
 
+  // Scripts running, and whether the one running was terminated for going
+  // past the memory budget
+  int running;
+  bool memory_exceeded;
+  uint64_t heap_size;
+
   JScript_context_impl(JScript_context *owner_, Interpreter_delegate *deleg)
-    : owner(owner_), types(owner_), isolate(v8::Isolate::New()), delegate(deleg) {
+    : owner(owner_), types(owner_), isolate(v8::Isolate::New()), delegate(deleg), running(0), memory_exceeded(false),
+      heap_size(0) {
     v8::Isolate::Scope isolate_scope(isolate);
     v8::HandleScope handle_scope(isolate);
 
+    isolate->SetData(0, this);
+    isolate->AddGCEpilogueCallback(&JScript_context_impl::on_gc_epilogue);
+
     v8::Local<v8::ObjectTemplate> globals = v8::ObjectTemplate::New(isolate);
     v8::Local<v8::External> client_data(v8::External::New(isolate, this));
 
@@ -119,6 +224,9 @@ struct JScript_context::JScript_context_impl {
     globals->Set(v8::String::NewFromUtf8(isolate, "__build_module"),
       v8::FunctionTemplate::New(isolate, &JScript_context_impl::f_build_module, client_data));
 
+    // The context is built from the template on every launch: V8 3.28 only
+    // boots from its own builtins snapshot (v8_snapshot), custom startup
+    // snapshots require V8::CreateSnapshotDataBlob(), available from V8 4.3
     v8::Local<v8::Context> lcontext = v8::Context::New(isolate, NULL, globals);
     context.Reset(isolate, lcontext);
 
@@ -153,6 +261,34 @@ struct JScript_context::JScript_context_impl {
       throw shcore::Exception::runtime_error("Unable to load the core module!!");
   }
 
+  // The heap is measured for the memory budget after every collection, the
+  // script running is terminated if the budget is exceeded: the heap limit
+  // of V8 is fixed when the isolate is created and going past it aborts
+  static void on_gc_epilogue(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags) {
+    JScript_context_impl *self = static_cast<JScript_context_impl*>(isolate->GetData(0));
+    v8::HeapStatistics statistics;
+    isolate->GetHeapStatistics(&statistics);
+
+    Memory_budget &budget = Memory_budget::get();
+    budget.update(Memory_budget::JavaScript, self->heap_size, statistics.used_heap_size());
+    self->heap_size = statistics.used_heap_size();
+    if (budget.exceeded() && self->running > 0 && !self->memory_exceeded) {
+      self->memory_exceeded = true;
+      v8::V8::TerminateExecution(isolate);
+    }
+  }
+
+  // The error of a script terminated by on_gc_epilogue(), empty if it was
+  // not. The isolate can run scripts again afterwards.
+  std::string take_memory_error() {
+    if (!memory_exceeded)
+      return "";
+
+    memory_exceeded = false;
+    v8::V8::CancelTerminateExecution(isolate);
+    return Memory_budget::get().exceeded_message(Memory_budget::JavaScript) + "\n";
+  }
+
   ~JScript_context_impl() {
     for (std::map<std::string, v8::Persistent<v8::Object>* >::iterator i = factory_packages.begin(); i != factory_packages.end(); ++i)
       delete i->second;
@@ -162,6 +298,7 @@ struct JScript_context::JScript_context_impl {
     // Releases the context
     context.Reset();
     isolate->Dispose();
+    Memory_budget::get().update(Memory_budget::JavaScript, heap_size, 0);
   }
 
   // Factory interface implementation
@@ -383,6 +520,31 @@ struct JScript_context::JScript_context_impl {
     }
   }
 
+  // Compiles the code, through the code cache when it comes from a file
+  v8::Local<v8::Script> compile(v8::Handle<v8::String> code, v8::ScriptOrigin &origin, const std::string &path) {
+    if (path.empty() || !shcore::file_exists(path))
+      return v8::Script::Compile(code, &origin);
+
+    Code_cache cache(path, *v8::String::Utf8Value(code));
+    std::string cached;
+    if (cache.load(&cached)) {
+      // The buffer stays owned by the string, the source only frees the
+      // CachedData holding it
+      v8::ScriptCompiler::Source source(code, origin, new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(cached.data()), static_cast<int>(cached.size()),
+        v8::ScriptCompiler::CachedData::BufferNotOwned));
+      return v8::ScriptCompiler::Compile(isolate, &source, v8::ScriptCompiler::kConsumeCodeCache);
+    }
+
+    v8::ScriptCompiler::Source source(code, origin);
+    v8::Local<v8::Script> script = v8::ScriptCompiler::Compile(isolate, &source, v8::ScriptCompiler::kProduceCodeCache);
+    const v8::ScriptCompiler::CachedData *produced = source.GetCachedData();
+    if (!script.IsEmpty() && produced)
+      cache.store(produced->data, produced->length);
+
+    return script;
+  }
+
   v8::Local<v8::Value> _build_module(v8::Handle<v8::String> origin, v8::Handle<v8::String> source) {
     v8::Local<v8::Value> result;
     // makes _isolate the default isolate for this context
@@ -392,8 +554,8 @@ struct JScript_context::JScript_context_impl {
     // set _context to be the default context for everything in this scope
     v8::Context::Scope context_scope(v8::Local<v8::Context>::New(isolate, context));
 
-    v8::Local<v8::Script> script;
-    script = v8::Script::Compile(source, origin);
+    v8::ScriptOrigin script_origin(origin);
+    v8::Local<v8::Script> script = compile(source, script_origin, *v8::String::Utf8Value(origin));
     if (!script.IsEmpty())
       result = script->Run();
 
@@ -424,8 +586,9 @@ struct JScript_context::JScript_context_impl {
   Argument_list convert_args(const v8::FunctionCallbackInfo<v8::Value>& args) {
     Argument_list r;
 
+    r.reserve(args.Length());
     for (int c = args.Length(), i = 0; i < c; i++) {
-      r.push_back(types.v8_value_to_shcore_value(args[i]));
+      r.emplace_back(types.v8_value_to_shcore_value(args[i]));
     }
     return r;
   }
@@ -564,7 +727,8 @@ struct JScript_context::JScript_context_impl {
 
 /** Initializer for JS stuff
 
- Must be called once when the program is started.
+ Called when the first JavaScript context is created, so V8 is not
+ initialized at all when JavaScript is not used.
  */
 void SHCORE_PUBLIC JScript_context_init() {
   static bool inited = false;
@@ -578,7 +742,7 @@ void SHCORE_PUBLIC JScript_context_init() {
 }
 
 JScript_context::JScript_context(Object_registry *registry, Interpreter_delegate *deleg)
-  : _impl(new JScript_context_impl(this, deleg)), _registry(registry) {
+  : _impl((JScript_context_init(), new JScript_context_impl(this, deleg))), _registry(registry) {
   // initialize type conversion class now that everything is ready
     {
       v8::Isolate::Scope isolate_scope(_impl->isolate);
@@ -637,6 +801,23 @@ Value JScript_context::get_global(const std::string &name) {
   return _impl->types.v8_value_to_shcore_value(_impl->get_global(name));
 }
 
+bool JScript_context::idle(int milliseconds) {
+  v8::Isolate::Scope isolate_scope(_impl->isolate);
+  v8::HandleScope handle_scope(_impl->isolate);
+
+  if (!_impl->isolate->IdleNotification(milliseconds))
+    return true;
+
+  // The pages V8 keeps after the collections are only given back to the
+  // system on a low memory notification, which takes full collections
+  v8::HeapStatistics statistics;
+  _impl->isolate->GetHeapStatistics(&statistics);
+  if (statistics.total_heap_size() - statistics.used_heap_size() > kIdleReleasedHeap)
+    _impl->isolate->LowMemoryNotification();
+
+  return false;
+}
+
 v8::Isolate *JScript_context::isolate() const {
   return _impl->isolate;
 }
@@ -670,7 +851,7 @@ Value JScript_context::execute(const std::string &code_str, const std::string& s
   v8::Context::Scope context_scope(v8::Local<v8::Context>::New(_impl->isolate, _impl->context));
   v8::ScriptOrigin origin(v8::String::NewFromUtf8(_impl->isolate, source.c_str()));
   v8::Handle<v8::String> code = v8::String::NewFromUtf8(_impl->isolate, code_str.c_str());
-  v8::Handle<v8::Script> script = v8::Script::Compile(code, &origin);
+  v8::Handle<v8::Script> script = _impl->compile(code, origin, source);
 
   // Since ret_val can't be used to check whether all was ok or not
   // Will use a boolean flag
@@ -685,7 +866,9 @@ Value JScript_context::execute(const std::string &code_str, const std::string& s
   }
 
   if (!script.IsEmpty()) {
+    _impl->running++;
     v8::Handle<v8::Value> result = script->Run();
+    _impl->running--;
     if (!result.IsEmpty()) {
       ret_val = v8_value_to_shcore_value(result);
       executed_ok = true;
@@ -693,7 +876,10 @@ Value JScript_context::execute(const std::string &code_str, const std::string& s
   }
 
   if (!executed_ok) {
-    if (try_catch.HasCaught()) {
+    std::string memory_error = _impl->take_memory_error();
+    if (!memory_error.empty()) {
+      throw shcore::Exception::runtime_error(memory_error);
+    } else if (try_catch.HasCaught()) {
       Value e = get_v8_exception_data(&try_catch, false);
 
       throw Exception::scripting_error(format_exception(e));
@@ -731,8 +917,13 @@ Value JScript_context::execute_interactive(const std::string &code_str, Input_st
     else
       _impl->print_exception(format_exception(get_v8_exception_data(&try_catch, true)));
   } else {
+    _impl->running++;
     v8::Handle<v8::Value> result = script->Run();
-    if (result.IsEmpty())
+    _impl->running--;
+    std::string memory_error = _impl->take_memory_error();
+    if (!memory_error.empty())
+      _impl->print_exception(memory_error);
+    else if (result.IsEmpty())
       _impl->print_exception(format_exception(get_v8_exception_data(&try_catch, true)));
     else {
       try {
@@ -53,7 +53,7 @@ v8::Handle<v8::Object> JScript_function_wrapper::wrap(std::shared_ptr<Function_b
   obj->SetAlignedPointerInInternalField(2, this);
 
   // marks the persistent instance to be garbage collectable, with a callback called on deletion
-  tmp->handle.Reset(_context->isolate(), v8::Persistent<v8::Object>(_context->isolate(), obj));
+  tmp->handle.Reset(_context->isolate(), obj);
   tmp->handle.SetWeak(tmp, wrapper_deleted);
   tmp->handle.MarkIndependent();
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, 2016, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2014, 2017, Oracle and/or its affiliates. All rights reserved.
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License as
@@ -31,6 +31,7 @@
 #include "shellcore/types_jscript.h"
 
 #include "shellcore/obj_date.h"
+#include "utils/utils_profile.h"
 
 #include <fstream>
 #include <cerrno>
@@ -124,6 +125,30 @@ Object_bridge_ref JScript_type_bridger::js_object_to_native(v8::Handle<v8::Objec
 }
 
 Value JScript_type_bridger::v8_value_to_shcore_value(const v8::Handle<v8::Value> &value) {
+  Profile_frame frame("convert js to value");
+
+  // JS data can change between two calls into the shell, so what was
+  // converted is only reused within this conversion
+  Converted converted;
+  return v8_value_to_shcore_value(value, &converted);
+}
+
+Value JScript_type_bridger::v8_value_to_shcore_value(const v8::Handle<v8::Value> &value, Converted *converted) {
+  // Plain JS objects and arrays are the only values converted in depth
+  bool convert_in_depth = value->IsArray() || (value->IsObject() && !value->IsFunction());
+  int hash = 0;
+
+  if (convert_in_depth) {
+    v8::Handle<v8::Object> jsobject = value->ToObject();
+    hash = jsobject->GetIdentityHash();
+
+    auto range = converted->equal_range(hash);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+      if (entry->second.first == jsobject)
+        return entry->second.second;
+    }
+  }
+
   if (value->IsUndefined())
     return Value();
   else if (value->IsNull())
@@ -144,8 +169,9 @@ Value JScript_type_bridger::v8_value_to_shcore_value(const v8::Handle<v8::Value>
     std::shared_ptr<Value::Array_type> array(new Value::Array_type(jsarray->Length()));
     for (int32_t c = jsarray->Length(), i = 0; i < c; i++) {
       v8::Local<v8::Value> item(jsarray->Get(i));
-      (*array)[i] = v8_value_to_shcore_value(item);
+      (*array)[i] = v8_value_to_shcore_value(item, converted);
     }
+    converted->insert({hash, {value->ToObject(), Value(array)}});
     return Value(array);
   } else if (value->IsFunction()) {
     v8::Handle<v8::Function> v8_function = v8::Handle<v8::Function>::Cast(value);
@@ -180,8 +206,9 @@ Value JScript_type_bridger::v8_value_to_shcore_value(const v8::Handle<v8::Value>
         v8::Local<v8::Value> k(pnames->Get(i));
         v8::Local<v8::Value> v(jsobject->Get(k));
         v8::String::Utf8Value kstr(k);
-        (*map_ptr)[*kstr] = v8_value_to_shcore_value(v);
+        (*map_ptr)[*kstr] = v8_value_to_shcore_value(v, converted);
       }
+      converted->insert({hash, {jsobject, Value(map_ptr)}});
       return Value(map_ptr);
     }
   } else {
@@ -192,6 +219,8 @@ Value JScript_type_bridger::v8_value_to_shcore_value(const v8::Handle<v8::Value>
 }
 
 v8::Handle<v8::Value> JScript_type_bridger::shcore_value_to_v8_value(const Value &value) {
+  Profile_frame frame("convert value to js");
+
   v8::Handle<v8::Value> r;
   switch (value.type) {
     case Undefined:
@@ -203,7 +232,7 @@ v8::Handle<v8::Value> JScript_type_bridger::shcore_value_to_v8_value(const Value
       r = v8::Boolean::New(owner->isolate(), value.value.b);
       break;
     case String:
-      r = v8::String::NewFromUtf8(owner->isolate(), value.value.s->c_str());
+      r = v8::String::NewFromUtf8(owner->isolate(), value.value.s->str.c_str());
       break;
     case Integer:
       r = v8::Integer::New(owner->isolate(), value.value.i);
@@ -20,8 +20,10 @@
 #include "shellcore/obj_date.h"
 #include "shellcore/common.h"
 
-#include <boost/format.hpp>
+#include <algorithm>
+#include <cctype>
 #include <cstdio>
+#include <cstdlib>
 
 using namespace shcore;
 
@@ -52,10 +54,16 @@ bool Date::operator == (const Date &other) const {
 std::string &Date::append_descr(std::string &s_out, int UNUSED(indent), int quote_strings) const {
   if (quote_strings)
     s_out.push_back((char)quote_strings);
+  // Printed for every temporal value of a result, snprintf() is much faster
+  // than boost::format here
+  char buffer[64];
+  int length;
   if ((float)(int)_sec != _sec)
-    s_out.append((boost::format("%04i-%02i-%02i %i:%02i:%02.3f") % _year % (_month + 1) % _day % _hour % _min % _sec).str());
+    length = snprintf(buffer, sizeof(buffer), "%04i-%02i-%02i %i:%02i:%02.3f", _year, _month + 1, _day, _hour, _min, (double)_sec);
   else
-    s_out.append((boost::format("%1$04d-%2$02i-%3$02i %4$i:%5$02i:%6$02i") % _year % (_month + 1) % _day % _hour % _min % (int)_sec).str());
+    length = snprintf(buffer, sizeof(buffer), "%04i-%02i-%02i %i:%02i:%02i", _year, _month + 1, _day, _hour, _min, (int)_sec);
+  if (length > 0)
+    s_out.append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
   if (quote_strings)
     s_out.push_back((char)quote_strings);
   return s_out;
@@ -106,7 +114,24 @@ Object_bridge_ref Date::unrepr(const std::string &s) {
   int min = 0;
   float sec = 0.0;
 
-  sscanf(s.c_str(), "%i-%i-%i %i:%i:%f", &year, &month, &day, &hour, &min, &sec);
+  // Parsed by hand, it runs for every temporal value of a classic result.
+  // The numbers are decimal even with leading zeros, which sscanf("%i")
+  // read as octal.
+  const char *next = s.c_str();
+  int *fields[] = {&year, &month, &day, &hour, &min};
+  for (int *field : fields) {
+    if (!isdigit(static_cast<unsigned char>(*next)))
+      break;
+
+    while (isdigit(static_cast<unsigned char>(*next)))
+      *field = *field * 10 + (*next++ - '0');
+
+    if (*next)
+      next++;
+  }
+
+  if (isdigit(static_cast<unsigned char>(*next)))
+    sec = strtof(next, nullptr);
   return Object_bridge_ref(new Date(year, month - 1, day, hour, min, sec));
 }
 
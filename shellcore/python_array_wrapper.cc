@@ -102,7 +102,7 @@ int list_assign(PyShListObject *self, Py_ssize_t index, PyObject *value) {
     if (value == NULL)
       array->erase(array->begin() + index);
     else
-      array->insert(array->begin() + index, ctx->pyobj_to_shcore_value(value));
+      (*array)[index] = ctx->pyobj_to_shcore_value(value);
     return 0;
   } catch (std::exception &exc) {
     Python_context::set_python_error(PyExc_RuntimeError, exc.what());
@@ -130,16 +130,28 @@ PyObject *list_inplace_concat(PyShListObject *self, PyObject *other) {
   Python_context *ctx = Python_context::get_and_check();
   if (!ctx) return NULL;
 
-  other = PySequence_Fast(other, "argument to += must be a sequence");
-  if (!other)
+  PyObject *items = PySequence_Fast(other, "argument to += must be a sequence");
+  if (!items)
     return NULL;
 
-  shcore::Value::Array_type *array;
-  array = self->array->get();
+  try {
+    // Converted aside, so a failed item leaves the list untouched
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(items);
+    shcore::Value::Array_type values;
+    values.reserve(count);
+
+    for (Py_ssize_t index = 0; index < count; index++)
+      values.push_back(ctx->pyobj_to_shcore_value(PySequence_Fast_GET_ITEM(items, index)));
 
-  shcore::Value::Array_type *array_other = new Value::Array_type(ctx->pyobj_to_shcore_value(other));
+    shcore::Value::Array_type *array = self->array->get();
+    array->insert(array->end(), values.begin(), values.end());
+  } catch (std::exception &exc) {
+    Py_DECREF(items);
+    Python_context::set_python_error(exc);
+    return NULL;
+  }
 
-  std::copy(array_other->begin(), array_other->end(), std::back_inserter(*array));
+  Py_DECREF(items);
 
   Py_INCREF(self);
   return (PyObject*)self;
@@ -203,7 +215,13 @@ PyObject *list_remove(PyShListObject *self, PyObject *v) {
     shcore::Value::Array_type *array;
     array = self->array->get();
 
-    std::remove(array->begin(), array->end(), ctx->pyobj_to_shcore_value(v));
+    auto item = std::find(array->begin(), array->end(), ctx->pyobj_to_shcore_value(v));
+    if (item == array->end()) {
+      Python_context::set_python_error(PyExc_ValueError, "list.remove(x): x not in list");
+      return NULL;
+    }
+
+    array->erase(item);
     Py_RETURN_NONE;
   } catch (std::exception &exc) {
     Python_context::set_python_error(exc);
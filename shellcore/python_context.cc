@@ -758,6 +758,17 @@ bool Python_context::is_module(const std::string& file_name) {
   return ret_val;
 }
 
+void Python_context::collect_garbage(int generation) {
+  // The C API only collects the oldest generation
+  PyObject *gc = PyImport_ImportModule("gc");
+  PyObject *collected = gc ? PyObject_CallMethod(gc, (char*)"collect", (char*)"i", generation) : NULL;
+
+  Py_XDECREF(collected);
+  Py_XDECREF(gc);
+  if (PyErr_Occurred())
+    PyErr_Clear();
+}
+
 Value Python_context::execute_module(const std::string& file_name, const std::vector<std::string> &argv) {
   shcore::Value ret_val;
 
@@ -64,14 +64,13 @@ static PyObject *method_call(PyShFuncObject *self, PyObject *args, PyObject *kw)
   Argument_list r;
 
   if (kw)
-    r.push_back(ctx->pyobj_to_shcore_value(kw));
+    r.emplace_back(ctx->pyobj_to_shcore_value(kw));
   else if (args) {
     for (size_t c = (size_t)PyTuple_Size(args), i = 0; i < c; i++) {
       PyObject *argval = PyTuple_GetItem(args, i);
 
       try {
-        Value v = ctx->pyobj_to_shcore_value(argval);
-        r.push_back(v);
+        r.emplace_back(ctx->pyobj_to_shcore_value(argval));
       } catch (std::exception &exc) {
         Python_context::set_python_error(exc);
         return NULL;
@@ -82,7 +81,8 @@ static PyObject *method_call(PyShFuncObject *self, PyObject *args, PyObject *kw)
   try {
     Value result;
     {
-      std::shared_ptr<shcore::Python_function> pfunc(std::static_pointer_cast<shcore::Python_function>(func));
+      // Only native functions run without the GIL
+      std::shared_ptr<shcore::Python_function> pfunc(std::dynamic_pointer_cast<shcore::Python_function>(func));
 
       if (pfunc)
         result = func->invoke(r);
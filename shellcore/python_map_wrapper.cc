@@ -251,7 +251,13 @@ static PyObject *dict_subscript(PyShDictObject *self, PyObject *key) {
     return NULL;
 
   try {
-    return ctx->shcore_value_to_pyobj((self->map->get()->find(k))->second);
+    Value::Map_type::const_iterator iter = self->map->get()->find(k);
+    if (iter == self->map->get()->end()) {
+      Python_context::set_python_error(PyExc_KeyError, k);
+      return NULL;
+    }
+
+    return ctx->shcore_value_to_pyobj(iter->second);
   } catch (std::exception &exc) {
     Python_context::set_python_error(exc);
   }
@@ -291,6 +297,29 @@ static int dict_as_subscript(PyShDictObject *self, PyObject *key, PyObject *valu
   return -1;
 }
 
+static int dict_contains(PyShDictObject *self, PyObject *key) {
+  AutoPyObject tmp;
+  if (PyUnicode_Check(key))
+    key = tmp = PyUnicode_AsUTF8String(key);
+
+  if (!PyString_Check(key))
+    return 0;
+
+  return self->map->get()->has_key(PyString_AsString(key)) ? 1 : 0;
+}
+
+// Iterates over the keys, taken when the iteration starts like a dict would
+// refuse to go on after the keys change
+static PyObject *dict_iter(PyShDictObject *self) {
+  PyObject *keys = dict_keys(self, NULL);
+  if (!keys)
+    return NULL;
+
+  PyObject *iter = PyObject_GetIter(keys);
+  Py_DECREF(keys);
+  return iter;
+}
+
 static PyObject *dict_getattro(PyShDictObject *self, PyObject *attr_name) {
   AutoPyObject tmp;
   if (PyUnicode_Check(attr_name))
@@ -357,6 +386,21 @@ static PyMappingMethods PyShDictObject_as_mapping =
   (objobjargproc)dict_as_subscript  // objobjargproc mp_ass_subscript;
 };
 
+// Only used for the in operator, items are reached through the mapping
+static PySequenceMethods PyShDictObject_as_sequence =
+{
+  0,  // lenfunc sq_length;
+  0,  // binaryfunc sq_concat;
+  0,  // ssizeargfunc sq_repeat;
+  0,  // ssizeargfunc sq_item;
+  0,  // ssizessizeargfunc sq_slice;
+  0,  // ssizeobjargproc sq_ass_item;
+  0,  // ssizessizeobjargproc sq_ass_slice;
+  (objobjproc)dict_contains,  // objobjproc sq_contains;
+  0,  // binaryfunc sq_inplace_concat;
+  0  // ssizeargfunc sq_inplace_repeat;
+};
+
 static PyTypeObject PyShDictObjectType =
 {
   PyObject_HEAD_INIT(&PyType_Type)  // PyObject_VAR_HEAD
@@ -376,7 +420,7 @@ static PyTypeObject PyShDictObjectType =
   /* Method suites for standard classes */
 
   0,  // PyNumberMethods *tp_as_number;
-  0,  // PySequenceMethods *tp_as_sequence;
+  &PyShDictObject_as_sequence,  // PySequenceMethods *tp_as_sequence;
   &PyShDictObject_as_mapping,  // PyMappingMethods *tp_as_mapping;
 
   /* More standard operations (here for binary compatibility) */
@@ -411,7 +455,7 @@ static PyTypeObject PyShDictObjectType =
 
   /* Added in release 2.2 */
   /* Iterators */
-  0,  // getiterfunc tp_iter;
+  (getiterfunc)dict_iter,  // getiterfunc tp_iter;
   0,  // iternextfunc tp_iternext;
 
   /* Attribute descriptor and subclassing stuff */
@@ -61,7 +61,7 @@ static PyObject *call_object_method(std::shared_ptr<Cpp_object_bridge> object, c
     PyObject *argval = PyTuple_GetItem(args, a);
 
     try {
-      arglist.push_back(ctx->pyobj_to_shcore_value(argval));
+      arglist.emplace_back(ctx->pyobj_to_shcore_value(argval));
     } catch (Exception &e) {
       char buffer[100];
       snprintf(buffer, sizeof(buffer), "argument #" PY_SIZE_T_FMT, a);
@@ -71,8 +71,13 @@ static PyObject *call_object_method(std::shared_ptr<Cpp_object_bridge> object, c
   }
 
   try {
-    WillLeavePython lock;
-    return ctx->shcore_value_to_pyobj(object->call_advanced(method, arglist, shcore::LowerCaseUnderscores));
+    Value result;
+    {
+      // The call may wait on the network, other Python threads run meanwhile
+      WillLeavePython lock;
+      result = object->call_advanced(method, arglist, shcore::LowerCaseUnderscores);
+    }
+    return ctx->shcore_value_to_pyobj(result);
   } catch (Exception &e) {
     Python_context::set_python_error(e);
     return NULL;
@@ -251,6 +256,8 @@ static PyObject *object_getattro(PyShObjObject *self, PyObject *attr_name) {
     shcore::Value member;
     bool error_handled = false;
     try {
+      // Some properties query the server, i.e. the current schema of a session
+      WillLeavePython lock;
       member = cobj->get_member_advanced(attrname, shcore::LowerCaseUnderscores);
     } catch (Exception &exc) {
       if (!exc.is_attribute()) {
@@ -338,8 +345,7 @@ static PyObject *call_object_method(std::shared_ptr<shcore::Object_bridge> objec
     PyObject *argval = PyTuple_GetItem(args, i);
 
     try {
-      Value v = ctx->pyobj_to_shcore_value(argval);
-      r.push_back(v);
+      r.emplace_back(ctx->pyobj_to_shcore_value(argval));
     } catch (std::exception &exc) {
       Python_context::set_python_error(exc);
       return NULL;
@@ -634,6 +640,118 @@ static PyTypeObject PyShObjIndexedObjectType =
 #endif
 };
 
+// Objects holding a contiguous array of numbers are exposed through the
+// buffer protocol, NumPy and the array module can use their data in place
+static Cpp_buffer *object_buffer(PyShObjObject *self) {
+  return dynamic_cast<Cpp_buffer*>(self->object->get());
+}
+
+static Py_ssize_t buffer_getreadbuffer(PyShObjObject *self, Py_ssize_t segment, void **ptrptr) {
+  if (segment != 0) {
+    Python_context::set_python_error(PyExc_SystemError, "accessing non-existent buffer segment");
+    return -1;
+  }
+
+  Cpp_buffer *buffer = object_buffer(self);
+  *ptrptr = const_cast<void*>(buffer->buffer_data());
+  return buffer->item_count() * buffer->item_size();
+}
+
+static Py_ssize_t buffer_getsegcount(PyShObjObject *self, Py_ssize_t *lenp) {
+  if (lenp) {
+    Cpp_buffer *buffer = object_buffer(self);
+    *lenp = buffer->item_count() * buffer->item_size();
+  }
+  return 1;
+}
+
+static int buffer_getbuffer(PyShObjObject *self, Py_buffer *view, int flags) {
+  Cpp_buffer *buffer = object_buffer(self);
+
+  if (PyBuffer_FillInfo(view, reinterpret_cast<PyObject*>(self), const_cast<void*>(buffer->buffer_data()),
+                        buffer->item_count() * buffer->item_size(), 1, flags) < 0)
+    return -1;
+
+  view->itemsize = buffer->item_size();
+  if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT)
+    view->format = const_cast<char*>(buffer->item_format());
+
+  // The shape is released with the view
+  if ((flags & PyBUF_ND) == PyBUF_ND) {
+    Py_ssize_t *shape = new Py_ssize_t[1];
+    shape[0] = buffer->item_count();
+    view->shape = shape;
+    view->internal = shape;
+  }
+
+  return 0;
+}
+
+static void buffer_releasebuffer(PyShObjObject *UNUSED(self), Py_buffer *view) {
+  delete[] static_cast<Py_ssize_t*>(view->internal);
+  view->internal = NULL;
+}
+
+static PyBufferProcs PyShObject_as_buffer =
+{
+  (readbufferproc)buffer_getreadbuffer,  // readbufferproc bf_getreadbuffer;
+  0,  // writebufferproc bf_getwritebuffer;
+  (segcountproc)buffer_getsegcount,  // segcountproc bf_getsegcount;
+  0,  // charbufferproc bf_getcharbuffer;
+  (getbufferproc)buffer_getbuffer,  // getbufferproc bf_getbuffer;
+  (releasebufferproc)buffer_releasebuffer  // releasebufferproc bf_releasebuffer;
+};
+
+// The remaining slots are inherited from the indexed object type
+static PyTypeObject PyShObjBufferObjectType =
+{
+  PyObject_HEAD_INIT(&PyType_Type)  // PyObject_VAR_HEAD
+  0,
+  "shell.BufferObject",  // char *tp_name; /* For printing, in format "<module>.<name>" */
+  sizeof(PyShObjObject), 0,  // int tp_basicsize, tp_itemsize; /* For allocation */
+};
+
+// Objects producing their values one at a time are exposed through the
+// iterator protocol, so they can be traversed with a for loop
+static PyObject *iterator_iter(PyShObjObject *self) {
+  Py_INCREF(self);
+  return reinterpret_cast<PyObject*>(self);
+}
+
+static PyObject *iterator_next(PyShObjObject *self) {
+  Python_context *ctx = Python_context::get_and_check();
+  if (!ctx)
+    return NULL;
+
+  try {
+    Value next;
+    {
+      WillLeavePython lock;
+
+      next = dynamic_cast<Cpp_iterator*>(self->object->get())->next_value();
+    }
+
+    // Returning NULL with no error set ends the iteration
+    if (next.type == shcore::Undefined)
+      return NULL;
+
+    return ctx->shcore_value_to_pyobj(next);
+  } catch (std::exception &exc) {
+    Python_context::set_python_error(exc);
+  }
+
+  return NULL;
+}
+
+// The remaining slots are inherited from the object type
+static PyTypeObject PyShObjIteratorObjectType =
+{
+  PyObject_HEAD_INIT(&PyType_Type)  // PyObject_VAR_HEAD
+  0,
+  "shell.IteratorObject",  // char *tp_name; /* For printing, in format "<module>.<name>" */
+  sizeof(PyShObjObject), 0,  // int tp_basicsize, tp_itemsize; /* For allocation */
+};
+
 void Python_context::init_shell_object_type() {
   // Initializes the normal object
   PyShObjObjectType.tp_new = PyType_GenericNew;
@@ -656,13 +774,45 @@ void Python_context::init_shell_object_type() {
   PyModule_AddObject(get_shell_python_support_module(), "IndexedObject", reinterpret_cast<PyObject *>(&PyShObjIndexedObjectType));
 
   _shell_indexed_object_class = PyDict_GetItemString(PyModule_GetDict(get_shell_python_support_module()), "IndexedObject");
+
+  // Initializes the indexed object exposing a buffer
+  PyShObjBufferObjectType.tp_base = &PyShObjIndexedObjectType;
+  PyShObjBufferObjectType.tp_as_buffer = &PyShObject_as_buffer;
+  PyShObjBufferObjectType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+  PyShObjBufferObjectType.tp_doc = PyShObjDoc;
+  PyShObjBufferObjectType.tp_new = PyType_GenericNew;
+  if (PyType_Ready(&PyShObjBufferObjectType) < 0) {
+    throw std::runtime_error("Could not initialize Shcore Buffer Object type in python");
+  }
+
+  Py_INCREF(&PyShObjBufferObjectType);
+  PyModule_AddObject(get_shell_python_support_module(), "BufferObject", reinterpret_cast<PyObject *>(&PyShObjBufferObjectType));
+
+  // Initializes the object that can be iterated
+  PyShObjIteratorObjectType.tp_base = &PyShObjObjectType;
+  PyShObjIteratorObjectType.tp_iter = (getiterfunc)iterator_iter;
+  PyShObjIteratorObjectType.tp_iternext = (iternextfunc)iterator_next;
+  PyShObjIteratorObjectType.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyShObjIteratorObjectType.tp_doc = PyShObjDoc;
+  PyShObjIteratorObjectType.tp_new = PyType_GenericNew;
+  if (PyType_Ready(&PyShObjIteratorObjectType) < 0) {
+    throw std::runtime_error("Could not initialize Shcore Iterator Object type in python");
+  }
+
+  Py_INCREF(&PyShObjIteratorObjectType);
+  PyModule_AddObject(get_shell_python_support_module(), "IteratorObject", reinterpret_cast<PyObject *>(&PyShObjIteratorObjectType));
 }
 
 PyObject *shcore::wrap(std::shared_ptr<Object_bridge> object) {
   PyShObjObject *wrapper;
 
-  if (object->is_indexed())
-    wrapper = PyObject_New(PyShObjObject, &PyShObjIndexedObjectType);
+  if (object->is_indexed()) {
+    if (dynamic_cast<Cpp_buffer*>(object.get()))
+      wrapper = PyObject_New(PyShObjObject, &PyShObjBufferObjectType);
+    else
+      wrapper = PyObject_New(PyShObjObject, &PyShObjIndexedObjectType);
+  } else if (dynamic_cast<Cpp_iterator*>(object.get()))
+    wrapper = PyObject_New(PyShObjObject, &PyShObjIteratorObjectType);
   else
     wrapper = PyObject_New(PyShObjObject, &PyShObjObjectType);
 
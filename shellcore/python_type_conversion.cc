@@ -23,6 +23,7 @@
 #include "shellcore/python_function_wrapper.h"
 #include "shellcore/python_type_conversion.h"
 #include "shellcore/types_python.h"
+#include "utils/utils_profile.h"
 
 using namespace shcore;
 
@@ -40,6 +41,8 @@ PyObject *Python_type_bridger::native_object_to_py(Object_bridge_ref object)
 */
 
 Value Python_type_bridger::pyobj_to_shcore_value(PyObject *py) const {
+  Profile_frame frame("convert py to value");
+
   // Some conversions yield errors, in that case a temporary result is assigned to retval and check_err is set
   bool check_err = false;
   Value retval;
@@ -147,6 +150,8 @@ Value Python_type_bridger::pyobj_to_shcore_value(PyObject *py) const {
 }
 
 PyObject *Python_type_bridger::shcore_value_to_pyobj(const Value &value) {
+  Profile_frame frame("convert value to py");
+
   PyObject *r;
   switch (value.type) {
     case Undefined:
@@ -161,7 +166,7 @@ PyObject *Python_type_bridger::shcore_value_to_pyobj(const Value &value) {
       r = PyBool_FromLong(value.value.b);
       break;
     case String:
-      r = PyString_FromString(value.value.s->c_str());
+      r = PyString_FromString(value.value.s->str.c_str());
       break;
     case Integer:
       r = PyInt_FromSsize_t(value.value.i);
@@ -30,11 +30,16 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include "modules/mod_mysqlx.h"
+#include "modules/mod_mysqlx_session.h"
 #include "modules/mod_mysql.h"
 #include "modules/mod_shell.h"
 #include "modules/mod_sys.h"
 #include "utils/utils_general.h"
 #include "utils/base_tokenizer.h"
+#include "utils/utils_file.h"
+#include "utils/utils_profile.h"
+#include "utils/utils_cancel.h"
+#include "utils/utils_memory.h"
 
 #include "interactive/interactive_global_dba.h"
 #include "modules/adminapi/mod_dba.h"
@@ -48,6 +53,7 @@
 #include "shellcore/lang_base.h"
 #include "uuid_gen.h"
 #include <fstream>
+#include <sstream>
 #include <locale>
 #ifdef WIN32
 #include <windows.h>
@@ -57,10 +63,9 @@ using namespace std::placeholders;
 using namespace shcore;
 
 Shell_core::Shell_core(Interpreter_delegate *shdelegate)
-  : IShell_core(), _client_delegate(shdelegate), _running_query(false), _reconnect_session(false) {
-  INIT_MODULE(mysqlsh::mysqlx::Mysqlx);
-  INIT_MODULE(mysqlsh::mysql::Mysql);
-
+  : IShell_core(), _client_delegate(shdelegate), _running_query(false), _reconnect_session(false),
+  _scripting_globals_set(false), _last_activity(std::chrono::steady_clock::now()), _keep_alive_interval(0),
+  _keep_alive_stop(false), _idle_step(0) {
   // Use a random seed for UUIDs
   std::time_t now = std::time(NULL);
   boost::uniform_int<> dist(INT_MIN, INT_MAX);
@@ -78,17 +83,10 @@ Shell_core::Shell_core(Interpreter_delegate *shdelegate)
   if ((*Shell_core_options::get())[SHCORE_USE_WIZARDS].as_bool()) {
     set_global("db", shcore::Value::wrap<Global_schema>(new Global_schema(*this)), Mode::Scripting);
     set_global("session", shcore::Value::wrap<Global_session>(new Global_session(*this)));
-    set_global("dba", shcore::Value::wrap<Global_dba>(new Global_dba(*this)), Mode::Scripting);
-    set_global("shell", shcore::Value::wrap<Global_shell>(new Global_shell(*this)), Mode::Scripting);
   }
 
-  set_dba_global();
-  set_shell_global();
-
-  // The sys global is for JavaScript only
-
-  std::shared_ptr<mysqlsh::Sys>sys(new mysqlsh::Sys(this));
-  set_global("sys", shcore::Value(std::dynamic_pointer_cast<Object_bridge>(sys)), Mode::JScript);
+  // The scripting only globals and modules are created when a scripting
+  // language is first initialized, see set_scripting_globals()
 
   observe_notification("SN_SESSION_CONNECTION_LOST");
 
@@ -104,6 +102,8 @@ Shell_core::Shell_core(Interpreter_delegate *shdelegate)
 }
 
 Shell_core::~Shell_core() {
+  stop_keep_alive();
+
   delete _registry;
 
   if (_langs[Mode::JScript])
@@ -130,8 +130,7 @@ void Shell_core::println(const std::string &s, const std::string& tag) {
 
   // When using JSON output ALL must be JSON
   if (!s.empty()) {
-    std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-    if (format.find("json") != std::string::npos) {
+    if (Shell_core_options::typed().json()) {
       output = format_json_output(output, tag.empty() ? "info" : tag);
       add_new_line = false;
     }
@@ -169,7 +168,7 @@ std::string Shell_core::format_json_output(const std::string &info, const std::s
 }
 
 std::string Shell_core::format_json_output(const shcore::Value &info, const std::string& tag) {
-  shcore::JSON_dumper dumper((*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string() == "json");
+  shcore::JSON_dumper dumper(Shell_core_options::typed().output_format == Typed_core_options::Output_format::Json);
   dumper.start_object();
   dumper.append_value(tag, info);
   dumper.end_object();
@@ -180,8 +179,7 @@ std::string Shell_core::format_json_output(const shcore::Value &info, const std:
 void Shell_core::print_error(const std::string &s) {
   std::string output;
   // When using JSON output ALL must be JSON
-  std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-  if (format.find("json") != std::string::npos)
+  if (Shell_core_options::typed().json())
     output = format_json_output(output, "error");
   else
     output = s;
@@ -193,8 +191,7 @@ bool Shell_core::password(const std::string &s, std::string &ret_pass) {
   std::string prompt(s);
 
   // When using JSON output ALL must be JSON
-  std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-  if (format.find("json") != std::string::npos)
+  if (Shell_core_options::typed().json())
     prompt = format_json_output(prompt, "password");
 
   return _client_delegate->password(_client_delegate->user_data, prompt.c_str(), ret_pass);
@@ -204,11 +201,10 @@ bool Shell_core::prompt(const std::string &s, std::string &ret_val) {
   std::string prompt(s);
 
   // When using JSON output ALL must be JSON
-  std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-  if (format.find("json") != std::string::npos)
+  if (Shell_core_options::typed().json())
     prompt = format_json_output(prompt, "prompt");
 
-    return _client_delegate->prompt(_client_delegate->user_data, prompt.c_str(), ret_val);
+  return _client_delegate->prompt(_client_delegate->user_data, prompt.c_str(), ret_val);
 }
 
 std::string Shell_core::preprocess_input_line(const std::string &s) {
@@ -216,16 +212,72 @@ std::string Shell_core::preprocess_input_line(const std::string &s) {
 }
 
 void Shell_core::handle_input(std::string &code, Input_state &state, std::function<void(shcore::Value)> result_processor) {
+  std::lock_guard<std::recursive_mutex> lock(_session_mutex);
+  Profile_frame frame(_mode == Mode::SQL ? "sql statement" : _mode == Mode::JScript ? "js statement" : "py statement");
+
+  // The garbage left by the input is collected once the shell waits again
+  _idle_languages.clear();
+  for (auto &lang : _langs) {
+    if (lang.second)
+      _idle_languages.push_back(lang.second);
+  }
+  _idle_step = 0;
+
   try {
     _running_query = true;
     _langs[_mode]->handle_input(code, state, result_processor);
   } catch (...) {
     _running_query = false;
+    _last_activity = std::chrono::steady_clock::now();
+    start_keep_alive();
     throw;
   }
+
+  _last_activity = std::chrono::steady_clock::now();
+  start_keep_alive();
+}
+
+bool Shell_core::idle(int milliseconds) {
+  if (_idle_languages.empty())
+    return false;
+
+  auto lang = _idle_languages.begin();
+  while (lang != _idle_languages.end()) {
+    if ((*lang)->idle(_idle_step, milliseconds))
+      ++lang;
+    else
+      lang = _idle_languages.erase(lang);
+  }
+  _idle_step++;
+
+  if (!_idle_languages.empty())
+    return true;
+
+  // What the languages and the results released goes back to the system
+  trim_heap();
+  return false;
+}
+
+void Shell_language::kill_running_query() {
+  // A second Ctrl-C while the first one is being handled does nothing
+  static std::atomic<bool> killing(false);
+  if (killing.exchange(true))
+    return;
+
+  try {
+    auto session = _owner->get_dev_session();
+    if (session && session->is_connected() && session->get_connection_id() != 0)
+      session->kill_query();
+  } catch (std::exception &e) {
+    log_warning("Unable to kill the running statement: %s", e.what());
+  }
+
+  killing = false;
 }
 
 void Shell_core::abort() {
+  // The AdminAPI operations stop at their next step
+  Cancellation_token::cancel_all();
   _langs[_mode]->abort();
 }
 
@@ -258,9 +310,23 @@ int Shell_core::process_stream(std::istream& stream, const std::string& source,
 
       std::getline(stream, line);
 
+      // When pipelining is enabled on an X session, several lines are handled
+      // at once so the statements on them can be sent to the server together.
+      // Classic sessions keep handling a line at a time, stopping at the first
+      // error.
+      int pipeline_depth = 1;
+      if (std::dynamic_pointer_cast<mysqlsh::mysqlx::BaseSession>(get_dev_session()))
+        pipeline_depth = Shell_core_options::typed().batch_pipeline;
+
+      for (int index = 1; index < pipeline_depth && !stream.eof(); index++) {
+        std::string next_line;
+        std::getline(stream, next_line);
+        line.append("\n").append(next_line);
+      }
+
       handle_input(line, state, result_processor);
 
-      if (_global_return_code && !(*Shell_core_options::get())[SHCORE_BATCH_CONTINUE_ON_ERROR].as_bool())
+      if (_global_return_code && !Shell_core_options::typed().batch_continue_on_error)
         break;
     }
 
@@ -268,15 +334,18 @@ int Shell_core::process_stream(std::istream& stream, const std::string& source,
       std::string delimiter = ";";
       handle_input(delimiter, state, result_processor);
     }
+
+    _langs[_mode]->end_input(result_processor);
   } else {
     std::string data;
     if (&std::cin == &stream) {
-      while (!stream.eof()) {
-        std::string line;
-
-        std::getline(stream, line);
-        data.append(line).append("\n");
-      }
+      // Read at once from the buffer of the stream, the last line is
+      // terminated as when it was read line by line
+      std::ostringstream buffer;
+      buffer << stream.rdbuf();
+      data = buffer.str();
+      if (data.empty() || data.back() != '\n')
+        data.append("\n");
     } else {
       stream.seekg(0, stream.end);
       std::streamsize fsize = stream.tellg();
@@ -299,6 +368,48 @@ int Shell_core::process_stream(std::istream& stream, const std::string& source,
   return _global_return_code;
 }
 
+/*
+* process_file maps the file in memory: the SQL splitter works on the mapped
+* data and the scripting languages take a single copy of it.
+* Return values as process_stream.
+*/
+int Shell_core::process_file(const std::string& path,
+                             std::function<void(shcore::Value)> result_processor,
+                             const std::vector<std::string> &argv) {
+  Mapped_file file(path);
+  Input_state state = Input_state::Ok;
+  _global_return_code = 0;
+
+  _input_source = path;
+  _input_args = argv;
+
+  if (_mode == Shell_core::Mode::SQL) {
+    if (file.size())
+      _langs[_mode]->handle_script(file.data(), file.size(), state, result_processor);
+
+    if (state != Input_state::Ok) {
+      std::string delimiter = ";";
+      handle_input(delimiter, state, result_processor);
+    }
+
+    _langs[_mode]->end_input(result_processor);
+  } else {
+    std::string data(file.data() ? file.data() : "", file.size());
+
+    // When processing JavaScript files, validates the very first line to start with #!
+    // If that's the case, it is replaced by a comment indicator //
+    if (_mode == IShell_core::Mode::JScript && data.size() > 1 && data[0] == '#' && data[1] == '!')
+      data.replace(0, 2, "//");
+
+    handle_input(data, state, result_processor);
+  }
+
+  _input_source.clear();
+  _input_args.clear();
+
+  return _global_return_code;
+}
+
 bool Shell_core::switch_mode(Mode mode, bool &lang_initialized) {
   lang_initialized = false;
 
@@ -330,8 +441,32 @@ void Shell_core::init_sql() {
   _langs[Mode::SQL] = new Shell_sql(this);
 }
 
+void Shell_core::set_scripting_globals() {
+  if (_scripting_globals_set)
+    return;
+
+  _scripting_globals_set = true;
+
+  INIT_MODULE(mysqlsh::mysqlx::Mysqlx);
+  INIT_MODULE(mysqlsh::mysql::Mysql);
+
+  if ((*Shell_core_options::get())[SHCORE_USE_WIZARDS].as_bool()) {
+    set_global("dba", shcore::Value::wrap<Global_dba>(new Global_dba(*this)), Mode::Scripting);
+    set_global("shell", shcore::Value::wrap<Global_shell>(new Global_shell(*this)), Mode::Scripting);
+  }
+
+  set_dba_global();
+  set_shell_global();
+
+  // The sys global is for JavaScript only
+  std::shared_ptr<mysqlsh::Sys>sys(new mysqlsh::Sys(this));
+  set_global("sys", shcore::Value(std::dynamic_pointer_cast<Object_bridge>(sys)), Mode::JScript);
+}
+
 void Shell_core::init_js() {
 #ifdef HAVE_V8
+  set_scripting_globals();
+
   Shell_javascript *js;
   _langs[Mode::JScript] = js = new Shell_javascript(this);
 
@@ -345,6 +480,8 @@ void Shell_core::init_js() {
 
 void Shell_core::init_py() {
 #ifdef HAVE_PYTHON
+  set_scripting_globals();
+
   Shell_python *py;
   _langs[Mode::Python] = py = new Shell_python(this);
 
@@ -384,12 +521,18 @@ void Shell_core::set_global(const std::string &name, const Value &value, Mode mo
 }
 
 Value Shell_core::get_global(const std::string &name) {
+  if (!_globals.count(name))
+    set_scripting_globals();
+
   return (_globals.count(name) > 0) ? _globals[name].second : Value();
 }
 
 std::vector<std::string> Shell_core::get_global_objects(Mode mode) {
   std::vector<std::string> globals;
 
+  if (mode & Mode::Scripting)
+    set_scripting_globals();
+
   for (auto entry : _globals) {
     if (entry.second.first & mode && entry.second.second.type == shcore::Object)
       globals.push_back(entry.first);
@@ -446,6 +589,7 @@ std::shared_ptr<mysqlsh::ShellDevelopmentSession> Shell_core::connect_dev_sessio
 * If there's a selected schema on the received session, it will be made available to the scripting interfaces on the global *db* variable
 */
 std::shared_ptr<mysqlsh::ShellDevelopmentSession> Shell_core::set_dev_session(const std::shared_ptr<mysqlsh::ShellDevelopmentSession>& session) {
+  std::lock_guard<std::recursive_mutex> lock(_session_mutex);
   _global_dev_session = session;
 
   shcore::Value currentSchema = session->get_cached_schema(session->get_default_schema());
@@ -584,6 +728,8 @@ bool Shell_core::reconnect() {
 }
 
 bool Shell_core::reconnect_if_needed() {
+  std::lock_guard<std::recursive_mutex> lock(_session_mutex);
+
   bool ret_val = false;
   if (_reconnect_session) {
     {
@@ -624,7 +770,69 @@ bool Shell_core::reconnect_if_needed() {
   return ret_val;
 }
 
+/**
+* Starts the keep-alive thread once the option is enabled, the option is
+* read here so the thread never touches the shell options
+*/
+void Shell_core::start_keep_alive() {
+  _keep_alive_interval = (*Shell_core_options::get())[SHCORE_KEEP_ALIVE_INTERVAL].as_int();
+
+  if (_keep_alive_interval > 0 && !_keep_alive_thread.joinable())
+    _keep_alive_thread = std::thread(&Shell_core::keep_alive, this);
+}
+
+void Shell_core::stop_keep_alive() {
+  if (_keep_alive_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(_keep_alive_mutex);
+      _keep_alive_stop = true;
+    }
+
+    _keep_alive_cond.notify_all();
+    _keep_alive_thread.join();
+  }
+}
+
+/**
+* Pings the global session once it has been idle for the keep-alive interval
+* so the server does not drop it, if it is lost anyway it gets reconnected
+* right away, while the user is not waiting for it.
+*/
+void Shell_core::keep_alive() {
+  std::unique_lock<std::mutex> lock(_keep_alive_mutex);
+
+  while (!_keep_alive_cond.wait_for(lock, std::chrono::seconds(1), [this]() { return _keep_alive_stop; })) {
+    int interval = _keep_alive_interval;
+    if (interval == 0)
+      continue;
+
+    // The session is in use
+    std::unique_lock<std::recursive_mutex> session_lock(_session_mutex, std::try_to_lock);
+    if (!session_lock.owns_lock())
+      continue;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!_global_dev_session || !_global_dev_session->is_connected() ||
+        now - _last_activity < std::chrono::seconds(interval))
+      continue;
+
+    _last_activity = now;
+
+    if (!_global_dev_session->ping()) {
+      log_info("The global session to '%s' was lost, reconnecting", _global_dev_session->uri().c_str());
+
+      // If it fails, the next statement goes through the interactive
+      // reconnection
+      if (reconnect())
+        _reconnect_session = false;
+      else
+        _reconnect_session = true;
+    }
+  }
+}
+
 void Shell_core::execute_module(const std::string &file_name, std::function<void(shcore::Value)> result_processor, const std::vector<std::string> &argv) {
+  std::lock_guard<std::recursive_mutex> lock(_session_mutex);
   _input_args = argv;
 
   _langs[_mode]->execute_module(file_name, result_processor);
@@ -636,8 +844,7 @@ void Shell_core::deleg_print(void *self, const char *text) {
   std::string output(text);
 
   // When using JSON output ALL must be JSON
-  std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-  if (format.find("json") != std::string::npos)
+  if (Shell_core_options::typed().json())
     output = shcore->format_json_output(output, "info");
 
   auto deleg = shcore->_client_delegate;
@@ -654,8 +861,7 @@ void Shell_core::deleg_print_error(void *self, const char *text) {
     output.assign(text);
 
   // When using JSON output ALL must be JSON
-  std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-  if (format.find("json") != std::string::npos)
+  if (Shell_core_options::typed().json())
     output = shcore->format_json_output(output, "error");
 
   if (output.length() && output[output.length() - 1] != '\n')
@@ -698,11 +904,10 @@ void Shell_core::deleg_print_value(void *self, const shcore::Value &value, const
     std::string output;
     bool add_new_line = true;
     // When using JSON output ALL must be JSON
-    std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
-    if (format.find("json") != std::string::npos) {
+    if (Shell_core_options::typed().json()) {
       // If no tag is provided, prints the JSON representation of the Value
       if (mtag.empty()) {
-        output = value.json((*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string() == "json");
+        output = value.json(Shell_core_options::typed().output_format == Typed_core_options::Output_format::Json);
       } else {
         if (value.type == shcore::String)
           output = shcore->format_json_output(value.as_string(), mtag);
@@ -730,8 +935,18 @@ void Shell_core::deleg_print_value(void *self, const shcore::Value &value, const
           output.append((*error_map)["message"].as_string());
         else
           output.append("?");
-      } else
+      } else if (mtag.empty() && Shell_core_options::typed().interactive) {
+        // Printed as it is formatted and within the limits, so echoing a
+        // huge value does not hold the shell
+        auto options = Shell_core_options::get();
+        shcore::Descr_printer printer([deleg](const std::string &chunk) { deleg->print(deleg->user_data, chunk.c_str()); },
+                                      (*options)[SHCORE_PRINT_MAX_DEPTH].as_int(),
+                                      (*options)[SHCORE_PRINT_MAX_ELEMENTS].as_int(),
+                                      (*options)[SHCORE_PRINT_MAX_BYTES].as_int());
+        printer.print(value);
+      } else {
         output = value.descr(true);
+      }
     }
 
     if (add_new_line)
@@ -748,17 +963,17 @@ void Shell_core::deleg_print_value(void *self, const shcore::Value &value, const
 std::vector<std::string> Shell_command_handler::split_command_line(const std::string &command_line) {
   shcore::BaseTokenizer _tokenizer;
 
-  std::vector<std::string> escaped_quotes = {"\\", "\""};
-  std::string quote("\"");
+  enum { Escaped_quote = shcore::Token_first_custom, Quote, Space };
 
-  _tokenizer.set_complex_token("escaped-quote", escaped_quotes);
-  _tokenizer.set_complex_token("quote", quote);
-  _tokenizer.set_complex_token("space", [](const std::string& input, size_t& index, std::string& text)->bool {
+  _tokenizer.set_complex_token(Escaped_quote, "escaped-quote", {"\\", "\""});
+  _tokenizer.set_complex_token(Quote, "quote", std::string("\""));
+  _tokenizer.set_complex_token(Space, "space", [](const std::string& input, size_t& index)->bool {
     std::locale locale;
+    size_t start = index;
     while (std::isspace(input[index], locale))
-      text += input[index++];
+      index++;
 
-    return !text.empty();
+    return index > start;
   });
   _tokenizer.set_allow_unknown_tokens(true);;
   _tokenizer.set_allow_spaces(true);
@@ -771,17 +986,17 @@ std::vector<std::string> Shell_command_handler::split_command_line(const std::st
   std::string param;
 
   while (_tokenizer.tokens_available()) {
-    if (_tokenizer.cur_token_type_is("quote"))
+    if (_tokenizer.cur_token_type_is(Quote))
       quoted_param = !quoted_param;
 
     // Quoted params will get accumulated into a single
     // command argument
     if (quoted_param)
-      param += _tokenizer.consume_any_token().get_text();
+      _tokenizer.consume_any_token().append_text(param);
     else {
-      auto token = _tokenizer.consume_any_token();
-      if (token.get_type() != "space")
-        param += token.get_text();
+      const shcore::BaseToken &token = _tokenizer.consume_any_token();
+      if (token.get_type() != Space)
+        token.append_text(param);
       else {
         if (!param.empty()) {
           ret_val.push_back(param);
@@ -21,6 +21,7 @@
 #include "shellcore/shell_core_options.h"
 #include "utils/utils_file.h"
 #include "utils/utils_general.h"
+#include "utils/utils_memory.h"
 
 using namespace shcore;
 
@@ -66,22 +67,43 @@ void Shell_core_options::set_member(const std::string &prop, Value value) {
   if (_options->has_key(prop)) {
     if (prop == SHCORE_OUTPUT_FORMAT) {
       std::string format = value.as_string();
-      if (format != "table" && format != "json" && format != "json/raw" && format != "vertical")
+      if (format != "table" && format != "json" && format != "json/raw" && format != "json/ndjson" && format != "vertical")
         throw shcore::Exception::value_error((boost::format(
-            "The option %s must be one of: table, vertical, json or json/raw.") % prop).str());
+            "The option %s must be one of: table, vertical, json, json/raw or json/ndjson.") % prop).str());
+    } else if (prop == SHCORE_BINARY_AS) {
+      std::string format = value.type == shcore::String ? value.as_string() : "";
+      if (format != "hex" && format != "base64" && format != "raw")
+        throw shcore::Exception::value_error((boost::format("The option %s must be one of: hex, base64 or raw.") % prop).str());
     } else if (prop == SHCORE_INTERACTIVE || prop == SHCORE_BATCH_CONTINUE_ON_ERROR)
       throw shcore::Exception::value_error((boost::format("The option %s is read only.") % prop).str());
 
-    else if (prop == SHCORE_SHOW_WARNINGS && value.type != shcore::Bool)
+    else if ((prop == SHCORE_SHOW_WARNINGS || prop == SHCORE_OUTPUT_STREAMING) && value.type != shcore::Bool)
         throw shcore::Exception::value_error((boost::format("The option %s requires a boolean value.") % prop).str());
 
+    else if (prop == SHCORE_BATCH_PIPELINE && (value.type != shcore::Integer || value.as_int() < 1))
+        throw shcore::Exception::value_error((boost::format("The option %s requires a positive integer value.") % prop).str());
+
+    else if ((prop == SHCORE_KEEP_ALIVE_INTERVAL || prop == SHCORE_RESULT_BUFFER_MEMORY || prop == SHCORE_BATCH_COMMIT ||
+              prop == SHCORE_MEMORY_BUDGET ||
+              prop == SHCORE_RESULT_PREVIEW_LIMIT || prop == SHCORE_PRINT_MAX_DEPTH ||
+              prop == SHCORE_PRINT_MAX_ELEMENTS || prop == SHCORE_PRINT_MAX_BYTES ||
+              prop == SHCORE_DBA_OPERATION_TIMEOUT || prop == SHCORE_DBA_STEP_TIMEOUT ||
+              prop == SHCORE_SLOW_STATEMENT_THRESHOLD) &&
+             (value.type != shcore::Integer || value.as_int() < 0))
+        throw shcore::Exception::value_error((boost::format("The option %s requires a non negative integer value.") % prop).str());
+
+    else if ((prop == SHCORE_PAGER || prop == SHCORE_DBA_TRACE_FILE || prop == SHCORE_SLOW_STATEMENT_LOG) &&
+             value.type != shcore::String)
+        throw shcore::Exception::value_error((boost::format("The option %s requires a string value.") % prop).str());
+
     (*_options)[prop] = value;
+    option_changed(prop);
   } else
     throw shcore::Exception::attrib_error("Unable to set the property " + prop + " on the shell object.");
 }
 
 Shell_core_options::Shell_core_options() :
-_options(new shcore::Value::Map_type) {
+_options(new shcore::Value::Map_type), _typed_version(0) {
 
   init();
 
@@ -91,6 +113,23 @@ _options(new shcore::Value::Map_type) {
   (*_options)[SHCORE_BATCH_CONTINUE_ON_ERROR] = Value::False();
   (*_options)[SHCORE_MULTIPLE_INSTANCES] = Value::False();
   (*_options)[SHCORE_USE_WIZARDS] = Value::True();
+  (*_options)[SHCORE_OUTPUT_STREAMING] = Value::False();
+  (*_options)[SHCORE_BATCH_PIPELINE] = Value(1);
+  (*_options)[SHCORE_BATCH_COMMIT] = Value(0);
+  (*_options)[SHCORE_KEEP_ALIVE_INTERVAL] = Value(0);
+  (*_options)[SHCORE_RESULT_BUFFER_MEMORY] = Value(256);
+  (*_options)[SHCORE_MEMORY_BUDGET] = Value(0);
+  (*_options)[SHCORE_RESULT_PREVIEW_LIMIT] = Value(0);
+  (*_options)[SHCORE_PRINT_MAX_DEPTH] = Value(0);
+  (*_options)[SHCORE_PRINT_MAX_ELEMENTS] = Value(0);
+  (*_options)[SHCORE_PRINT_MAX_BYTES] = Value(1024 * 1024);
+  (*_options)[SHCORE_PAGER] = Value("");
+  (*_options)[SHCORE_DBA_OPERATION_TIMEOUT] = Value(0);
+  (*_options)[SHCORE_DBA_STEP_TIMEOUT] = Value(0);
+  (*_options)[SHCORE_DBA_TRACE_FILE] = Value("");
+  (*_options)[SHCORE_SLOW_STATEMENT_THRESHOLD] = Value(0);
+  (*_options)[SHCORE_SLOW_STATEMENT_LOG] = Value("");
+  (*_options)[SHCORE_BINARY_AS] = Value("raw");
 
   std::string home = shcore::get_home_dir();
 
@@ -101,6 +140,51 @@ _options(new shcore::Value::Map_type) {
 #endif
 
   (*_options)[SHCORE_SANDBOX_DIR] = Value(home.c_str());
+
+  update_typed();
+}
+
+void Shell_core_options::update_typed() {
+  std::string format = _options->get_string(SHCORE_OUTPUT_FORMAT);
+  if (format == "vertical")
+    _typed.output_format = Typed_core_options::Output_format::Vertical;
+  else if (format == "json")
+    _typed.output_format = Typed_core_options::Output_format::Json;
+  else if (format == "json/raw")
+    _typed.output_format = Typed_core_options::Output_format::Json_raw;
+  else if (format == "json/ndjson")
+    _typed.output_format = Typed_core_options::Output_format::Ndjson;
+  else if (format == "arrow")
+    _typed.output_format = Typed_core_options::Output_format::Arrow;
+  else
+    _typed.output_format = Typed_core_options::Output_format::Table;
+
+  std::string binary_as = _options->get_string(SHCORE_BINARY_AS);
+  if (binary_as == "hex")
+    _typed.binary_as = Typed_core_options::Binary_format::Hex;
+  else if (binary_as == "base64")
+    _typed.binary_as = Typed_core_options::Binary_format::Base64;
+  else
+    _typed.binary_as = Typed_core_options::Binary_format::Raw;
+
+  _typed.interactive = _options->get_bool(SHCORE_INTERACTIVE);
+  _typed.show_warnings = _options->get_bool(SHCORE_SHOW_WARNINGS);
+  _typed.batch_continue_on_error = _options->get_bool(SHCORE_BATCH_CONTINUE_ON_ERROR);
+  _typed.output_streaming = _options->get_bool(SHCORE_OUTPUT_STREAMING);
+  _typed.batch_pipeline = static_cast<int>(_options->get_int(SHCORE_BATCH_PIPELINE));
+  _typed.batch_commit = static_cast<int>(_options->get_int(SHCORE_BATCH_COMMIT));
+  _typed.result_buffer_memory = _options->get_int(SHCORE_RESULT_BUFFER_MEMORY);
+  _typed.result_preview_limit = _options->get_int(SHCORE_RESULT_PREVIEW_LIMIT);
+  _typed.slow_statement_threshold = _options->get_int(SHCORE_SLOW_STATEMENT_THRESHOLD);
+
+  _typed_version = _options->version();
+}
+
+// Applies the options that take effect outside of the shell core when they
+// are set through set_member() or set()
+void Shell_core_options::option_changed(const std::string &name) {
+  if (name == SHCORE_MEMORY_BUDGET)
+    Memory_budget::get().set_limit(static_cast<uint64_t>(_options->get_int(SHCORE_MEMORY_BUDGET)) * 1024 * 1024);
 }
 
 void Shell_core_options::init() {
@@ -120,6 +204,40 @@ void Shell_core_options::init() {
   add_property(option + "|" + option);
   option.assign(SHCORE_SANDBOX_DIR);
   add_property(option + "|" + option);
+  option.assign(SHCORE_OUTPUT_STREAMING);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_BATCH_PIPELINE);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_BATCH_COMMIT);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_KEEP_ALIVE_INTERVAL);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_RESULT_BUFFER_MEMORY);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_RESULT_PREVIEW_LIMIT);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_MEMORY_BUDGET);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_PRINT_MAX_DEPTH);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_PRINT_MAX_ELEMENTS);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_PRINT_MAX_BYTES);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_PAGER);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_DBA_OPERATION_TIMEOUT);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_DBA_STEP_TIMEOUT);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_DBA_TRACE_FILE);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_SLOW_STATEMENT_THRESHOLD);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_SLOW_STATEMENT_LOG);
+  add_property(option + "|" + option);
+  option.assign(SHCORE_BINARY_AS);
+  add_property(option + "|" + option);
 }
 
 Shell_core_options::~Shell_core_options() {
@@ -134,6 +252,22 @@ Value::Map_type_ref Shell_core_options::get() {
   return _instance->_options;
 }
 
+const Typed_core_options &Shell_core_options::typed() {
+  if (!_instance)
+    _instance.reset(new Shell_core_options());
+
+  if (_instance->_typed_version != _instance->_options->version())
+    _instance->update_typed();
+
+  return _instance->_typed;
+}
+
+void Shell_core_options::set(const std::string &name, const Value &value) {
+  auto instance = get_instance();
+  (*instance->_options)[name] = value;
+  instance->option_changed(name);
+}
+
 std::shared_ptr<Shell_core_options> Shell_core_options::get_instance() {
   if (!_instance)
     _instance.reset(new Shell_core_options());
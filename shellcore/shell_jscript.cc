@@ -25,6 +25,9 @@
 
 using namespace shcore;
 
+// Idle steps of the garbage collector after an input, at most
+static const int kMaxIdleSteps = 100;
+
 Shell_javascript::Shell_javascript(Shell_core *shcore)
   : Shell_language(shcore) {
   _js = std::shared_ptr<JScript_context>(new JScript_context(shcore->registry(), shcore->get_delegate()));
@@ -76,40 +79,12 @@ void Shell_javascript::set_global(const std::string &name, const Value &value) {
   _js->set_global(name, value);
 }
 
+bool Shell_javascript::idle(int step, int milliseconds) {
+  // V8 may keep asking for more steps on a heap that is still growing
+  return step < kMaxIdleSteps && _js->idle(milliseconds);
+}
+
 void Shell_javascript::abort() {
-  /*
-  // TODO: this way to gather the session is wrong in JS, because there sessions are typically created with getNodeSession
-
-  Value session_wrapper = _owner->active_session();
-  std::shared_ptr<mysqlsh::ShellBaseSession> session = session_wrapper.as_object<mysqlsh::ShellBaseSession>();
-  // duplicate the connection
-  std::shared_ptr<mysqlsh::mysqlx::BaseSession> kill_session = NULL;
-  mysqlsh::mysqlx::NodeSession* node_session = dynamic_cast<mysqlsh::mysqlx::NodeSession*>(session.get());
-  mysqlsh::mysqlx::XSession* x_session = dynamic_cast<mysqlsh::mysqlx::XSession*>(session.get());
-
-  if (node_session != NULL)
-  {
-  kill_session.reset(new mysqlsh::mysqlx::NodeSession(*node_session));
-  }
-  else if (x_session != NULL)
-  {
-  kill_session.reset(new mysqlsh::mysqlx::XSession(*x_session));
-  }
-  else
-  throw std::runtime_error("Unexpected session type");
-
-  uint64_t connection_id = session->get_connection_id();
-  if (connection_id != 0)
-  {
-  shcore::Argument_list a;
-  a.push_back(shcore::Value(""));
-  kill_session->connect(a);
-  if (!kill_session)
-  {
-  throw std::runtime_error(boost::format().str());
-  }
-  std::string cmd = (boost::format("kill query %u") % connection_id).str();
-  a.clear();
-  kill_session->execute_sql(cmd, a);
-  }*/
+  // The script gets the error of the statement, as if the server failed it
+  kill_running_query();
 }
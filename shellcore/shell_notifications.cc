@@ -19,6 +19,8 @@
 
 #include "shellcore/shell_notifications.h"
 
+#include <algorithm>
+
 namespace shcore {
 ShellNotifications* ShellNotifications::_instance = NULL;
 
@@ -51,58 +53,70 @@ ShellNotifications *ShellNotifications::get() {
 ShellNotifications::~ShellNotifications() {}
 
 bool ShellNotifications::add_observer(NotificationObserver *observer, const std::string &notification) {
-  bool ret_val = false;
+  std::lock_guard<std::mutex> lock(_observers_mutex);
 
-  // Gets the observer list for the given notification
-  // creates the list if it is the first observer
-  if (_observers.find(notification) == _observers.end())
-    _observers[notification] = new ObserverList();
+  std::shared_ptr<Observer_map> observers(_observers ? new Observer_map(*_observers) : new Observer_map());
 
   // Adds the observer if it does not exists already
-  ObserverList *list = _observers[notification];
-  ret_val = std::find(list->begin(), list->end(), observer) == list->end();
-  if (ret_val)
-    _observers[notification]->push_back(observer);
+  ObserverList &list = (*observers)[notification];
+  if (std::find(list.begin(), list.end(), observer) != list.end())
+    return false;
+
+  list.push_back(observer);
+
+  std::atomic_store(&_observers, std::shared_ptr<const Observer_map>(observers));
+  _observer_count++;
 
-  return ret_val;
+  return true;
 }
 
 bool ShellNotifications::remove_observer(NotificationObserver *observer, const std::string &notification) {
-  bool ret_val = false;
-
-  if (_observers.find(notification) != _observers.end()) {
-    ObserverList *list = _observers[notification];
-
-    ObserverList::iterator it = list->begin();
-    while (it != list->end()) {
-      if (*it == observer) {
-        ret_val = true;
-        list->erase(it);
-        break;
-      } else
-        it++;
-    }
-
-    if (list->size() == 0) {
-      delete list;
-      _observers.erase(notification);
-    }
-  }
-
-  return ret_val;
+  std::lock_guard<std::mutex> lock(_observers_mutex);
+
+  if (!_observers || !_observers->count(notification))
+    return false;
+
+  std::shared_ptr<Observer_map> observers(new Observer_map(*_observers));
+
+  ObserverList &list = (*observers)[notification];
+  ObserverList::iterator it = std::find(list.begin(), list.end(), observer);
+  if (it == list.end())
+    return false;
+
+  list.erase(it);
+  if (list.empty())
+    observers->erase(notification);
+
+  std::atomic_store(&_observers, std::shared_ptr<const Observer_map>(observers));
+  _observer_count--;
+
+  return true;
+}
+
+bool ShellNotifications::has_observers(const std::string &name) const {
+  if (_observer_count == 0)
+    return false;
+
+  std::shared_ptr<const Observer_map> observers = std::atomic_load(&_observers);
+  return observers && observers->count(name) != 0;
 }
 
 void ShellNotifications::notify(const std::string &name, const shcore::Object_bridge_ref& sender, shcore::Value::Map_type_ref data) {
-  if (_observers.find(name) != _observers.end()) {
-    ObserverList *list = _observers[name];
-
-    ObserverList::iterator it = list->begin();
-    while (it != list->end()) {
-      (*it)->handle_notification(name, sender, data);
-      it++;
-    }
-  }
-};
+  if (_observer_count == 0)
+    return;
+
+  // Observers added or removed meanwhile only see the next notifications
+  std::shared_ptr<const Observer_map> observers = std::atomic_load(&_observers);
+  if (!observers)
+    return;
+
+  Observer_map::const_iterator list = observers->find(name);
+  if (list == observers->end())
+    return;
+
+  for (NotificationObserver *observer : list->second)
+    observer->handle_notification(name, sender, data);
+}
 
 void ShellNotifications::notify(const std::string &name, const shcore::Object_bridge_ref& sender) {
   notify(name, sender, shcore::Value::Map_type_ref());
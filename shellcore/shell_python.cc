@@ -116,7 +116,16 @@ void Shell_python::set_global(const std::string &name, const Value &value) {
 }
 
 void Shell_python::abort() {
-  // TODO:
+  // The script gets the error of the statement, as if the server failed it
+  kill_running_query();
+}
+
+bool Shell_python::idle(int step, int UNUSED(milliseconds)) {
+  // A generation on each step, the youngest ones are the quickest
+  WillEnterPython lock;
+  _py->collect_garbage(step);
+
+  return step < 2;
 }
 
 bool Shell_python::is_module(const std::string& file_name) {
@@ -21,15 +21,65 @@
 #include "../modules/base_session.h"
 #include "../modules/mod_mysql_session.h"
 #include "../modules/mod_mysqlx_session.h"
+#include "../modules/base_resultset.h"
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <cstring>
 #include <fstream>
 
 using namespace shcore;
 using namespace boost::system;
 
+namespace {
+enum class Statement_kind { Dml, Transaction_start, Transaction_end, Other };
+
+// Reads the statement kind from its first words, comments before them are
+// skipped except the executable ones
+Statement_kind statement_kind(const std::string &statement) {
+  std::vector<std::string> words;
+  size_t index = 0;
+  while (index < statement.size() && words.size() < 2) {
+    char c = statement[index];
+    if (isspace(static_cast<unsigned char>(c))) {
+      index++;
+    } else if (c == '#' || statement.compare(index, 3, "-- ") == 0) {
+      index = statement.find('\n', index);
+    } else if (statement.compare(index, 2, "/*") == 0 && statement.compare(index, 3, "/*!") != 0) {
+      index = statement.find("*/", index + 2);
+      if (index != std::string::npos)
+        index += 2;
+    } else if (isalpha(static_cast<unsigned char>(c))) {
+      size_t end = index;
+      while (end < statement.size() && (isalnum(static_cast<unsigned char>(statement[end])) || statement[end] == '_'))
+        end++;
+      words.push_back(boost::to_upper_copy(statement.substr(index, end - index)));
+      index = end;
+    } else {
+      break;
+    }
+  }
+
+  if (words.empty())
+    return Statement_kind::Other;
+
+  const std::string &first = words[0];
+  const std::string second = words.size() > 1 ? words[1] : "";
+  if (first == "INSERT" || first == "REPLACE" || first == "UPDATE" || first == "DELETE")
+    return Statement_kind::Dml;
+  if (first == "BEGIN" || (first == "START" && second == "TRANSACTION") ||
+      (first == "XA" && (second == "START" || second == "BEGIN")))
+    return Statement_kind::Transaction_start;
+  if (first == "COMMIT" || (first == "ROLLBACK" && second != "TO") ||
+      (first == "XA" && (second == "COMMIT" || second == "ROLLBACK")))
+    return Statement_kind::Transaction_end;
+
+  return Statement_kind::Other;
+}
+}
+
 Shell_sql::Shell_sql(IShell_core *owner)
-  : Shell_language(owner), _delimiters({";", "\\G", "\\g"})
+  : Shell_language(owner), _delimiters({";", "\\G", "\\g"}), _batch_open(false), _batch_bytes(0),
+  _autocommit(-1), _script_transaction(false)
 {
   static const std::string cmd_help_G =
       "SYNTAX:\n"
@@ -50,36 +100,43 @@ Shell_sql::Shell_sql(IShell_core *owner)
   SET_CUSTOM_SHELL_COMMAND("\\g", "Send command to mysql server.", cmd_help_g, Shell_command_function());
 }
 
+Value Shell_sql::execute_sql(const std::string &query_str,
+    std::shared_ptr<mysqlsh::ShellDevelopmentSession> session) {
+  shcore::Argument_list query;
+  query.push_back(Value(query_str));
+
+  // ClassicSession has runSql and returns a ClassicResult object
+  if (session->has_member("runSql"))
+    return session->call("runSql", query);
+
+  // NodeSession uses SqlExecute object in which we need to call
+  // .execute() to get the Resultset object
+  if (session->has_member("sql"))
+    return session->call("sql", query).as_object()->call("execute",
+                         shcore::Argument_list());
+
+  throw shcore::Exception::logic_error("The current session type (" +
+      session->class_name() + ") can't be used for SQL execution.");
+}
+
 Value Shell_sql::process_sql(const std::string &query_str,
     mysql::splitter::Delimiters::delim_type_t delimiter,
     std::shared_ptr<mysqlsh::ShellDevelopmentSession> session,
     std::function<void(shcore::Value)> result_processor) {
   Value ret_val;
   try {
-    shcore::Argument_list query;
-    query.push_back(Value(query_str));
-
-    // ClassicSession has runSql and returns a ClassicResult object
-    if (session->has_member("runSql"))
-      ret_val = session->call("runSql", query);
-
-    // NodeSession uses SqlExecute object in which we need to call
-    // .execute() to get the Resultset object
-    else if (session->has_member("sql"))
-      ret_val = session->call("sql", query).as_object()->call("execute",
-                              shcore::Argument_list());
-    else
-      throw shcore::Exception::logic_error("The current session type (" +
-          session->class_name() + ") can't be used for SQL execution.");
+    ret_val = execute_sql(query_str, session);
 
     // If reached this point, processes the returned result object
     if (!_killed) {
-      auto shcore_options = Shell_core_options::get();
-      auto old_format = (*shcore_options)[SHCORE_OUTPUT_FORMAT];
-      if (delimiter == "\\G")
-        (*shcore_options)[SHCORE_OUTPUT_FORMAT] = Value("vertical");
-      result_processor(ret_val);
-      (*shcore_options)[SHCORE_OUTPUT_FORMAT] = old_format;
+      if (delimiter == "\\G") {
+        auto old_format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT];
+        Shell_core_options::set(SHCORE_OUTPUT_FORMAT, Value("vertical"));
+        result_processor(ret_val);
+        Shell_core_options::set(SHCORE_OUTPUT_FORMAT, old_format);
+      } else {
+        result_processor(ret_val);
+      }
     }
     _killed = false;
   } catch (shcore::Exception &exc) {
@@ -91,6 +148,354 @@ Value Shell_sql::process_sql(const std::string &query_str,
   return ret_val;
 }
 
+/*
+ * Executes the statements sending up to pipeline_depth of them to the server
+ * before reading their results, which are processed in the same order the
+ * statements were sent.
+ *
+ * Errors are reported per statement, if batchContinueOnError is not set, no
+ * more statements are sent after a failure but the ones already sent are
+ * still processed.
+ *
+ * Returns Undefined if any of the statements failed.
+ */
+Value Shell_sql::process_sql_pipelined(const std::vector<std::pair<std::string, std::string> > &statements,
+    size_t pipeline_depth,
+    std::shared_ptr<mysqlsh::mysqlx::BaseSession> session,
+    std::function<void(shcore::Value)> result_processor) {
+  Value ret_val;
+  bool failed = false;
+  bool continue_on_error = Shell_core_options::typed().batch_continue_on_error;
+  size_t sent = 0;
+  size_t received = 0;
+
+  while (received < statements.size()) {
+    try {
+      // Keeps the pipeline full unless there was an error
+      while (sent < statements.size() && sent - received < pipeline_depth &&
+             (!failed || continue_on_error) && !_killed) {
+        session->send_sql(statements[sent].first);
+        sent++;
+      }
+    } catch (shcore::Exception &exc) {
+      // The statement could not be sent, the connection is unusable
+      print_exception(exc);
+      failed = true;
+      break;
+    }
+
+    if (received == sent)
+      break;
+
+    const std::string &delimiter = statements[received].second;
+    try {
+      ret_val = session->recv_sql_result();
+
+      if (!_killed) {
+        if (delimiter == "\\G") {
+          auto old_format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT];
+          Shell_core_options::set(SHCORE_OUTPUT_FORMAT, Value("vertical"));
+          result_processor(ret_val);
+          Shell_core_options::set(SHCORE_OUTPUT_FORMAT, old_format);
+        } else {
+          result_processor(ret_val);
+        }
+      }
+    } catch (shcore::Exception &exc) {
+      failed = true;
+      print_exception(exc);
+
+      if (!session->is_connected())
+        break;
+    }
+
+    _last_handled += statements[received].first + delimiter;
+    received++;
+  }
+
+  _killed = false;
+
+  if (failed)
+    ret_val = Value();
+
+  return ret_val;
+}
+
+/*
+ * Executes a statement with batchCommit: consecutive DML statements run in a
+ * transaction committed every batchCommit of them, any other statement
+ * commits the run first so it sees the same data as without batching.
+ *
+ * A failed statement rolls the run back, and the statements before it are
+ * executed again one by one, so the rows left are the same ones autocommit
+ * would have left. Without autocommit, or within a transaction of the
+ * script, statements are executed as they are.
+ */
+Value Shell_sql::process_sql_batched(const std::string &query_str,
+    mysql::splitter::Delimiters::delim_type_t delimiter,
+    std::shared_ptr<mysqlsh::ShellDevelopmentSession> session,
+    std::function<void(shcore::Value)> result_processor) {
+  if (_batch_session.lock() != session) {
+    _batch_session = session;
+    _batch_open = false;
+    _batch.clear();
+    _batch_bytes = 0;
+    _autocommit = -1;
+    _script_transaction = false;
+  }
+
+  Statement_kind kind = statement_kind(query_str);
+  if (kind != Statement_kind::Dml) {
+    if (!end_batch(session))
+      return Value();
+
+    if (kind == Statement_kind::Transaction_start)
+      _script_transaction = true;
+    else if (kind == Statement_kind::Transaction_end)
+      _script_transaction = false;
+    else if (boost::icontains(query_str, "autocommit"))
+      _autocommit = -1;
+
+    return process_sql(query_str, delimiter, session, result_processor);
+  }
+
+  if (!_batch_open && !_script_transaction && !begin_batch(session))
+    return Value();
+
+  Value ret_val = process_sql(query_str, delimiter, session, result_processor);
+
+  if (_batch_open) {
+    if (ret_val.type == Undefined) {
+      replay_batch(session);
+    } else {
+      _batch.push_back(query_str);
+      _batch_bytes += query_str.size();
+
+      if (_batch.size() >= static_cast<size_t>(Shell_core_options::typed().batch_commit) ||
+          _batch_bytes >= k_batch_commit_bytes) {
+        try {
+          execute_sql("COMMIT", session);
+          _batch.clear();
+          _batch_bytes = 0;
+        } catch (shcore::Exception &exc) {
+          print_exception(exc);
+          replay_batch(session);
+          ret_val = Value();
+        }
+      }
+    }
+  }
+
+  return ret_val;
+}
+
+// Turns autocommit off, if it is on, rather than starting a transaction
+// which would release the tables locked by the script
+bool Shell_sql::begin_batch(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session) {
+  try {
+    if (_autocommit < 0) {
+      Value row = execute_sql("SELECT @@autocommit", session).as_object()->call("fetchOne", shcore::Argument_list());
+      _autocommit = row.as_object<mysqlsh::Row>()->get_member(0).as_int() ? 1 : 0;
+    }
+
+    if (_autocommit) {
+      execute_sql("SET autocommit = 0", session);
+      _batch_open = true;
+    }
+  } catch (shcore::Exception &exc) {
+    print_exception(exc);
+    return false;
+  }
+
+  return true;
+}
+
+// Turning autocommit back on commits the run
+bool Shell_sql::end_batch(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session) {
+  if (!_batch_open)
+    return true;
+
+  try {
+    execute_sql("SET autocommit = 1", session);
+    _batch_open = false;
+    _batch.clear();
+    _batch_bytes = 0;
+  } catch (shcore::Exception &exc) {
+    print_exception(exc);
+    return replay_batch(session);
+  }
+
+  return true;
+}
+
+bool Shell_sql::replay_batch(std::shared_ptr<mysqlsh::ShellDevelopmentSession> session) {
+  std::vector<std::string> batch;
+  batch.swap(_batch);
+  _batch_bytes = 0;
+  _batch_open = false;
+
+  try {
+    execute_sql("ROLLBACK", session);
+    execute_sql("SET autocommit = 1", session);
+
+    for (auto &statement : batch)
+      execute_sql(statement, session);
+  } catch (shcore::Exception &exc) {
+    print_exception(exc);
+    return false;
+  }
+
+  return true;
+}
+
+void Shell_sql::end_input(std::function<void(shcore::Value)> result_processor) {
+  auto session = _batch_session.lock();
+  if (session && session == _owner->get_dev_session() && !end_batch(session))
+    result_processor(Value());
+}
+
+Value Shell_sql::execute_statements(const std::vector<std::pair<std::string, std::string> > &statements,
+    std::shared_ptr<mysqlsh::ShellDevelopmentSession> session,
+    std::function<void(shcore::Value)> result_processor) {
+  Value ret_val;
+  auto x_session = std::dynamic_pointer_cast<mysqlsh::mysqlx::BaseSession>(session);
+  int pipeline_depth = Shell_core_options::typed().batch_pipeline;
+  bool batch_commit = Shell_core_options::typed().batch_commit > 0 &&
+                      !Shell_core_options::typed().interactive;
+
+  // Batched commits need the outcome of each statement before sending the
+  // next one. Classic sessions always execute one statement at a time: a
+  // multi-statement batch is aborted by the server on the first failure
+  // which would prevent reporting the errors per statement
+  if (batch_commit) {
+    for (auto &statement : statements)
+      ret_val = process_sql_batched(statement.first, statement.second, session, result_processor);
+  } else if (x_session && pipeline_depth > 1 && statements.size() > 1)
+    ret_val = process_sql_pipelined(statements, pipeline_depth, x_session, result_processor);
+  else {
+    for (auto &statement : statements)
+      ret_val = process_sql(statement.first, statement.second, session, result_processor);
+  }
+
+  return ret_val;
+}
+
+/*
+ * Adds the statements terminated on the ranges of code, the text of a range
+ * without delimiter is kept on the cache and prepended to the next range so
+ * statements spanning several inputs are assembled without scanning them
+ * again. Returns whether any statement was terminated.
+ */
+bool Shell_sql::add_statements(const char *code, const std::vector<mysql::splitter::Statement_range> &ranges,
+    std::vector<std::pair<std::string, std::string> > &statements) {
+  bool terminated = false;
+
+  for (auto &range : ranges) {
+    if (range.get_delimiter().empty()) {
+      // There is no delimiter, partial command added to cache
+      size_t length = range.length();
+      while (length > 0 && code[range.offset() + length - 1] == '\n')
+        length--;
+
+      if (!_sql_cache.empty())
+        _sql_cache.append("\n");
+      _sql_cache.append(code + range.offset(), length);
+    } else {
+      terminated = true;
+      if (!_sql_cache.empty()) {
+        _sql_cache.append("\n").append(code + range.offset(), range.length());
+        statements.push_back(std::make_pair(std::move(_sql_cache), range.get_delimiter()));
+        _sql_cache.clear();
+      } else {
+        statements.push_back(std::make_pair(std::string(code + range.offset(), range.length()),
+            range.get_delimiter()));
+      }
+    }
+  }
+
+  return terminated;
+}
+
+/*
+ * Executes the statements on a block of data such as a mapped file, the
+ * splitter works on the data itself a window at a time and resumes on the
+ * next window where it stopped, so every byte is scanned once and only the
+ * statements are copied to be executed.
+ *
+ * A statement left incomplete at the end of the data is cached as on
+ * handle_input.
+ */
+void Shell_sql::handle_script(const char *data, size_t size, Input_state &state,
+    std::function<void(shcore::Value)> result_processor) {
+  auto session = _owner->get_dev_session();
+
+  if (!session) {
+    Shell_language::handle_script(data, size, state, result_processor);
+    return;
+  }
+
+  state = Input_state::Ok;
+  _last_handled.clear();
+
+  bool continue_on_error = Shell_core_options::typed().batch_continue_on_error;
+  std::vector<std::pair<std::string, std::string> > statements;
+  bool stop = false;
+
+  auto flush_statements = [&]() {
+    Value ret_val = execute_statements(statements, session, result_processor);
+    statements.clear();
+
+    if (ret_val.type == Undefined) {
+      result_processor(ret_val);
+      stop = !continue_on_error;
+    }
+  };
+
+  auto scan = [&](const char *code, size_t length) {
+    auto ranges = shcore::mysql::splitter::determineStatementRanges(code,
+        length, _delimiters, "\n", _parsing_context_stack);
+
+    add_statements(code, ranges, statements);
+
+    if (statements.size() >= k_script_batch_size)
+      flush_statements();
+  };
+
+  // The splitter looks a few bytes ahead of the position it scans, which on
+  // the mapped data is safe only before a line break: a last line without
+  // one is scanned from a copy
+  size_t mapped_size = size;
+  while (mapped_size > 0 && data[mapped_size - 1] != '\n')
+    mapped_size--;
+
+  size_t offset = 0;
+  while (offset < mapped_size && !stop) {
+    // Windows end on a line break so DELIMITER commands are never split
+    size_t end = mapped_size;
+    if (mapped_size - offset > k_script_window_size) {
+      const void *line_end = std::memchr(data + offset + k_script_window_size - 1, '\n',
+          mapped_size - offset - k_script_window_size + 1);
+      end = static_cast<const char *>(line_end) - data + 1;
+    }
+
+    scan(data + offset, end - offset);
+    offset = end;
+  }
+
+  if (mapped_size < size && !stop) {
+    std::string last_line(data + mapped_size, size - mapped_size);
+    scan(last_line.data(), last_line.size());
+  }
+
+  if (!statements.empty() && !stop)
+    flush_statements();
+
+  if (_parsing_context_stack.empty())
+    state = Input_state::Ok;
+  else
+    state = Input_state::ContinuedSingle;
+}
+
 void Shell_sql::handle_input(std::string &code, Input_state &state, std::function<void(shcore::Value)> result_processor) {
   Value ret_val;
   state = Input_state::Ok;
@@ -122,44 +527,17 @@ void Shell_sql::handle_input(std::string &code, Input_state &state, std::functio
         code.length(), _delimiters, "\n", _parsing_context_stack);
     //}
 
-    int range_index = 0;
+    // Complete statements found on the input, executed after the
+    // ranges are processed
+    std::vector<std::pair<std::string, std::string> > statements;
 
-    for (; range_index < ranges.size(); range_index++)
-    {
-      if (ranges[range_index].get_delimiter().empty()) {
-        // There is no delimiter, partial command added to cache
-        std::string line = code.substr(ranges[range_index].offset(),
-            ranges[range_index].length());
+    if (add_statements(code.data(), ranges, statements))
+      no_query_executed = false;
 
-        boost::trim_right_if(line, boost::is_any_of("\n"));
-        if (_sql_cache.empty())
-          _sql_cache = line;
-        else
-          _sql_cache.append("\n").append(line);
-      } else {
-        no_query_executed = false;
-        if (!_sql_cache.empty()){
-          no_query_executed = false;
-          std::string cached_query = _sql_cache + "\n" +
-              code.substr(ranges[range_index].offset(),
-              ranges[range_index].length());
-
-          _sql_cache.clear();
-
-          ret_val = process_sql(cached_query,
-              ranges[range_index].get_delimiter(),
-              session, result_processor);
-        }
-        else {
-          ret_val = process_sql(code.substr(ranges[range_index].offset(),
-              ranges[range_index].length()),
-              ranges[range_index].get_delimiter(),
-              session, result_processor);
-        }
-      }
-    }
     code = _sql_cache;
 
+    ret_val = execute_statements(statements, session, result_processor);
+
     if (_parsing_context_stack.empty())
       state = Input_state::Ok;
     else
@@ -226,46 +604,6 @@ void Shell_sql::print_exception(const shcore::Exception &e) {
 }
 
 void Shell_sql::abort() {
-  std::shared_ptr<mysqlsh::ShellBaseSession> session = _owner->get_dev_session();
-  if (!session) {
-    return;
-  }
-
-  // duplicate the connection
-  std::shared_ptr<mysqlsh::mysql::ClassicSession> kill_session;
-  std::shared_ptr<mysqlsh::mysqlx::NodeSession> kill_session2;
-  mysqlsh::mysql::ClassicSession* classic = NULL;
-  mysqlsh::mysqlx::NodeSession* node = NULL;
-  classic = dynamic_cast<mysqlsh::mysql::ClassicSession*>(session.get());
-  node = dynamic_cast<mysqlsh::mysqlx::NodeSession*>(session.get());
-  if (classic) {
-    kill_session.reset(new mysqlsh::mysql::ClassicSession(*dynamic_cast<mysqlsh::mysql::ClassicSession*>(classic)));
-  } else if (node) {
-    kill_session2.reset(new mysqlsh::mysqlx::NodeSession(*dynamic_cast<mysqlsh::mysqlx::NodeSession*>(node)));
-  }
-  uint64_t connection_id = session->get_connection_id();
-  if (connection_id != 0) {
-    shcore::Argument_list a;
-    a.push_back(shcore::Value(""));
-    if (classic) {
-      kill_session->connect(a);
-      if (!kill_session) {
-        throw std::runtime_error(boost::format("Error duplicating classic connection").str());
-      }
-      std::string cmd = (boost::format("kill query %u") % connection_id).str();
-      a.clear();
-      a.push_back(shcore::Value(cmd));
-      kill_session->run_sql(a);
-    } else if (node) {
-      kill_session2->connect(a);
-      if (!kill_session2) {
-        throw std::runtime_error(boost::format("Error duplicating xplugin connection").str());
-      }
-
-      std::string cmd = (boost::format("kill query %u") % connection_id).str();
-      a.clear();
-      shcore::Value v = kill_session2->execute_sql(cmd, a);
-    }
-    _killed = true;
-  }
+  kill_running_query();
+  _killed = true;
 }
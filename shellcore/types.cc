@@ -30,6 +30,9 @@
 #include <cstring>
 #include <sstream>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/error/en.h>
 #include <limits>
 
 // These is* functions have undefined behavior if the passed value
@@ -39,6 +42,34 @@
 
 using namespace shcore;
 
+namespace {
+// The shared pointers of container, object and function values live in a
+// box of their own, which comes from the arena of the current Arena_scope
+// if any. The box starts with the arena it came from, so the value that
+// frees it does not need to know.
+template <class P, class A>
+P *new_box(A &&ptr) {
+  static_assert(alignof(P) <= sizeof(Arena *), "box header breaks the alignment");
+
+  Arena *arena = Arena::current();
+  void *memory = arena ? arena->allocate(sizeof(Arena *) + sizeof(P), sizeof(Arena *))
+                       : ::operator new(sizeof(Arena *) + sizeof(P));
+  Arena **header = static_cast<Arena **>(memory);
+  *header = arena;
+  return new (header + 1) P(std::forward<A>(ptr));
+}
+
+template <class P>
+void delete_box(P *ptr) {
+  Arena **header = reinterpret_cast<Arena **>(ptr) - 1;
+  ptr->~P();
+  if (*header)
+    (*header)->deallocate(header);
+  else
+    ::operator delete(header);
+}
+}
+
 // --
 
 Exception::Exception(const std::shared_ptr<Value::Map_type> e)
@@ -140,14 +171,14 @@ Exception Exception::parser_error(const std::string &message) {
 const char *Exception::what() const BOOST_NOEXCEPT_OR_NOTHROW
 {
   if ((*_error)["message"].type == String)
-  return (*_error)["message"].value.s->c_str();
+  return (*_error)["message"].value.s->str.c_str();
   return "?";
 }
 
 const char *Exception::type() const BOOST_NOEXCEPT_OR_NOTHROW
 {
   if ((*_error)["type"].type == String)
-  return (*_error)["type"].value.s->c_str();
+  return (*_error)["type"].value.s->str.c_str();
   return "Exception";
 }
 
@@ -340,13 +371,18 @@ Value::Value(const Value &copy)
 
 Value::Value(const std::string &s)
   : type(String) {
-  value.s = new std::string(s);
+  value.s = String_data::create(s);
+}
+
+Value::Value(std::string &&s)
+  : type(String) {
+  value.s = String_data::create(std::move(s));
 }
 
 Value::Value(const char *s) {
   if (s) {
     type = String;
-    value.s = new std::string(s);
+    value.s = String_data::create(s);
   } else {
     type = shcore::Null;
   }
@@ -355,7 +391,7 @@ Value::Value(const char *s) {
 Value::Value(const char *s, size_t n) {
   if (s) {
     type = String;
-    value.s = new std::string(s, n);
+    value.s = String_data::create(s, n);
   } else {
     type = shcore::Null;
   }
@@ -388,27 +424,27 @@ Value::Value(bool b)
 
 Value::Value(std::shared_ptr<Function_base> f)
   : type(Function) {
-  value.func = new std::shared_ptr<Function_base>(f);
+  value.func = new_box<std::shared_ptr<Function_base>>(f);
 }
 
 Value::Value(std::shared_ptr<Object_bridge> n)
   : type(Object) {
-  value.o = new std::shared_ptr<Object_bridge>(n);
+  value.o = new_box<std::shared_ptr<Object_bridge>>(n);
 }
 
 Value::Value(Map_type_ref n)
   : type(Map) {
-  value.map = new std::shared_ptr<Map_type>(n);
+  value.map = new_box<std::shared_ptr<Map_type>>(n);
 }
 
 Value::Value(std::weak_ptr<Map_type> n)
   : type(MapRef) {
-  value.mapref = new std::weak_ptr<Map_type>(n);
+  value.mapref = new_box<std::weak_ptr<Map_type>>(n);
 }
 
 Value::Value(Array_type_ref n)
   : type(Array) {
-  value.array = new std::shared_ptr<Array_type>(n);
+  value.array = new_box<std::shared_ptr<Array_type>>(n);
 }
 
 Value &Value::operator= (const Value &other) {
@@ -431,7 +467,10 @@ Value &Value::operator= (const Value &other) {
         value.d = other.value.d;
         break;
       case String:
-        *value.s = *other.value.s;
+        if (value.s != other.value.s) {
+          value.s->release();
+          value.s = other.value.s->acquire();
+        }
         break;
       case Object:
         *value.o = *other.value.o;
@@ -459,22 +498,22 @@ Value &Value::operator= (const Value &other) {
       case Float:
         break;
       case String:
-        delete value.s;
+        value.s->release();
         break;
       case Object:
-        delete value.o;
+        delete_box(value.o);
         break;
       case Array:
-        delete value.array;
+        delete_box(value.array);
         break;
       case Map:
-        delete value.map;
+        delete_box(value.map);
         break;
       case MapRef:
-        delete value.mapref;
+        delete_box(value.mapref);
         break;
       case Function:
-        delete value.func;
+        delete_box(value.func);
         break;
     }
     type = other.type;
@@ -495,30 +534,43 @@ Value &Value::operator= (const Value &other) {
         value.d = other.value.d;
         break;
       case String:
-        value.s = new std::string(*other.value.s);
+        value.s = other.value.s->acquire();
         break;
       case Object:
-        value.o = new std::shared_ptr<Object_bridge>(*other.value.o);
+        value.o = new_box<std::shared_ptr<Object_bridge>>(*other.value.o);
         break;
       case Array:
-        value.array = new std::shared_ptr<Array_type>(*other.value.array);
+        value.array = new_box<std::shared_ptr<Array_type>>(*other.value.array);
         break;
       case Map:
-        value.map = new std::shared_ptr<Map_type>(*other.value.map);
+        value.map = new_box<std::shared_ptr<Map_type>>(*other.value.map);
         break;
       case MapRef:
-        value.mapref = new std::weak_ptr<Map_type>(*other.value.mapref);
+        value.mapref = new_box<std::weak_ptr<Map_type>>(*other.value.mapref);
         break;
       case Function:
-        value.func = new std::shared_ptr<Function_base>(*other.value.func);
+        value.func = new_box<std::shared_ptr<Function_base>>(*other.value.func);
         break;
     }
   }
   return *this;
 }
 
+Value Value::new_array() {
+  if (Arena *arena = Arena::current())
+    return Value(std::allocate_shared<Array_type>(Arena_allocator<Array_type>(arena)));
+  return Value(std::shared_ptr<Array_type>(new Array_type()));
+}
+
+Value Value::new_map() {
+  if (Arena *arena = Arena::current())
+    return Value(std::allocate_shared<Map_type>(Arena_allocator<Map_type>(arena)));
+  return Value(std::shared_ptr<Map_type>(new Map_type()));
+}
+
 Value Value::parse_map(char **pc) {
-  Map_type_ref map(new Map_type());
+  Value ret_val = new_map();
+  Map_type *map = ret_val.value.map->get();
 
   // Skips the opening {
   ++*pc;
@@ -551,7 +603,7 @@ Value Value::parse_map(char **pc) {
 
       value = parse(pc);
 
-      (*map)[key.as_string()] = value;
+      (*map)[key.as_string()] = std::move(value);
 
       // Skips the spaces
       while (**pc == ' ' || **pc == '\t' || **pc == '\n')++*pc;
@@ -571,11 +623,12 @@ Value Value::parse_map(char **pc) {
     }
   }
 
-  return Value(map);
+  return ret_val;
 }
 
 Value Value::parse_array(char **pc) {
-  Array_type_ref array(new Array_type());
+  Value ret_val = new_array();
+  Array_type *array = ret_val.value.array->get();
 
   // Skips the opening [
   ++*pc;
@@ -608,7 +661,7 @@ Value Value::parse_array(char **pc) {
     while (**pc == ' ' || **pc == '\t' || **pc == '\n')++*pc;
   }
 
-  return Value(array);
+  return ret_val;
 }
 
 Value Value::parse_string(char **pc, char quote) {
@@ -679,7 +732,7 @@ Value Value::parse_string(char **pc, char quote) {
   // Skips the closing quote
   ++*pc;
 
-  return Value(s);
+  return Value(std::move(s));
 }
 
 Value Value::parse_single_quoted_string(char **pc) {
@@ -808,6 +861,124 @@ Value Value::parse(char **pc) {
   return Value();
 }
 
+namespace {
+// SAX handler building the Value tree directly while rapidjson reads the
+// document, skipping the intermediate rapidjson::Document. The members of
+// the open containers are collected on frames kept by the thread, so the
+// containers are created with their final size once they are complete.
+class Value_builder {
+public:
+  bool Null() { return add(Value::Null()); }
+  bool Bool(bool b) { return add(Value(b)); }
+  bool Int(int i) { return add(Value(static_cast<int64_t>(i))); }
+  bool Uint(unsigned i) { return add(Value(static_cast<int64_t>(i))); }
+  bool Int64(int64_t i) { return add(Value(i)); }
+  bool Uint64(uint64_t ui) {
+    // Integers are Integer values like in parse(), only the ones outside of
+    // the int64_t range are kept as UInteger
+    if (ui > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+      return add(Value(ui));
+    return add(Value(static_cast<int64_t>(ui)));
+  }
+  bool Double(double d) { return add(Value(d)); }
+  bool String(const char *str, rapidjson::SizeType length, bool) { return add(Value(str, length)); }
+
+  bool StartObject() { return open(true); }
+  bool Key(const char *str, rapidjson::SizeType length, bool) {
+    _frames[_depth - 1].key.assign(str, length);
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType) {
+    Frame &frame = _frames[_depth - 1];
+    Value map = Value::new_map();
+    Value::Map_type &members = **map.value.map;
+    members.reserve(frame.members.size());
+    for (auto &member : frame.members)
+      members[member.first] = std::move(member.second);
+
+    return close(std::move(map));
+  }
+
+  bool StartArray() { return open(false); }
+  bool EndArray(rapidjson::SizeType) {
+    Frame &frame = _frames[_depth - 1];
+    Value array = Value::new_array();
+    Value::Array_type &items = **array.value.array;
+    items.reserve(frame.items.size());
+    for (auto &item : frame.items)
+      items.push_back(std::move(item));
+
+    return close(std::move(array));
+  }
+
+  Value &result() { return _result; }
+
+  ~Value_builder() {
+    // The frames keep their buffers for the next document, not the values
+    for (size_t index = 0; index < _depth; index++) {
+      _frames[index].members.clear();
+      _frames[index].items.clear();
+    }
+  }
+
+private:
+  struct Frame {
+    bool is_map;
+    std::string key;
+    std::vector<std::pair<std::string, Value> > members;
+    Value::Array_type items;
+  };
+
+  bool open(bool is_map) {
+    if (_depth == _frames.size())
+      _frames.emplace_back();
+    _frames[_depth].is_map = is_map;
+    _depth++;
+    return true;
+  }
+
+  bool add(Value &&value) {
+    if (_depth == 0) {
+      _result = std::move(value);
+    } else {
+      Frame &frame = _frames[_depth - 1];
+      if (frame.is_map)
+        frame.members.emplace_back(frame.key, std::move(value));
+      else
+        frame.items.push_back(std::move(value));
+    }
+    return true;
+  }
+
+  bool close(Value &&container) {
+    Frame &frame = _frames[_depth - 1];
+    frame.members.clear();
+    frame.items.clear();
+    _depth--;
+    return add(std::move(container));
+  }
+
+  static thread_local std::vector<Frame> _frames;
+  size_t _depth = 0;
+  Value _result;
+};
+
+thread_local std::vector<Value_builder::Frame> Value_builder::_frames;
+}
+
+Value Value::parse_json(const char *data, size_t length) {
+  rapidjson::MemoryStream stream(data, length);
+  rapidjson::Reader reader;
+  Value_builder builder;
+
+  rapidjson::ParseResult result = reader.Parse<rapidjson::kParseFullPrecisionFlag>(stream, builder);
+  if (result.IsError())
+    throw Exception::parser_error((boost::format("Error parsing JSON: %1% at offset %2%")
+                                   % rapidjson::GetParseError_En(result.Code()) % result.Offset()).str());
+
+  return std::move(builder.result());
+}
+
 bool Value::operator == (const Value &other) const {
   if (type == other.type) {
     switch (type) {
@@ -824,7 +995,7 @@ bool Value::operator == (const Value &other) const {
       case Float:
         return value.d == other.value.d;
       case String:
-        return *value.s == *other.value.s;
+        return value.s == other.value.s || value.s->str == other.value.s->str;
       case Object:
         return **value.o == **other.value.o;
       case Array:
@@ -901,6 +1072,192 @@ bool Value::operator == (const Value &other) const {
   return false;
 }
 
+namespace {
+size_t combine_hash(size_t seed, size_t hash) {
+  return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+// Bool, Integer, UInteger and Float compare equal when they hold the same
+// number, so all of them hash the number as a double
+size_t number_hash(double number) {
+  // 0.0 == -0.0
+  return std::hash<double>()(number == 0.0 ? 0.0 : number);
+}
+}
+
+size_t Value::hash() const {
+  switch (type) {
+    case Undefined:
+      return 0;
+    case shcore::Null:
+      return 1;
+    case Bool:
+      return number_hash(value.b ? 1.0 : 0.0);
+    case Integer:
+      return number_hash(static_cast<double>(value.i));
+    case UInteger:
+      return number_hash(static_cast<double>(value.ui));
+    case Float:
+      return number_hash(value.d);
+    case String:
+      return std::hash<std::string>()(value.s->str);
+    case Object:
+      return std::hash<std::string>()((*value.o)->class_name());
+    case Array: {
+      size_t seed = (*value.array)->size();
+      for (auto &item : **value.array)
+        seed = combine_hash(seed, item.hash());
+      return seed;
+    }
+    case Map:
+    case MapRef: {
+      Map_type_ref map = type == Map ? *value.map : value.mapref->lock();
+      if (!map)
+        return 0;
+
+      size_t seed = map->size();
+      for (auto &entry : *map) {
+        seed = combine_hash(seed, std::hash<std::string>()(entry.first));
+        seed = combine_hash(seed, entry.second.hash());
+      }
+      return seed;
+    }
+    case Function:
+      return 2;
+  }
+
+  return 0;
+}
+
+Descr_printer::Descr_printer(const Output_handler &output, size_t max_depth, size_t max_elements, size_t max_bytes,
+                             size_t chunk_size)
+  : _output(output), _max_depth(max_depth), _max_elements(max_elements), _max_bytes(max_bytes),
+  _chunk_size(chunk_size), _written(0), _truncated(false) {}
+
+bool Descr_printer::print(const Value &value) {
+  bool complete = append(value, 0, 0);
+
+  if (!complete)
+    _buffer += "\n... (output truncated after " + std::to_string(_max_bytes) +
+               " bytes, print() shows the whole value)";
+
+  flush();
+  return complete;
+}
+
+void Descr_printer::flush() {
+  if (!_buffer.empty()) {
+    _output(_buffer);
+    _buffer.clear();
+  }
+}
+
+bool Descr_printer::append(const std::string &text) {
+  if (_truncated)
+    return false;
+
+  size_t length = text.length();
+  if (_max_bytes && _written + length > _max_bytes) {
+    length = _max_bytes - _written;
+    _truncated = true;
+  }
+
+  _buffer.append(text, 0, length);
+  _written += length;
+  if (_buffer.size() >= _chunk_size)
+    flush();
+
+  return !_truncated;
+}
+
+bool Descr_printer::append(const Value &value, int indent, int quote_strings) {
+  switch (value.type) {
+    case Array:
+    case Map:
+      return append_container(value, indent);
+
+    case String:
+      // Without copying the string, which may be the huge part of the value
+      if (quote_strings && !append(std::string(1, static_cast<char>(quote_strings))))
+        return false;
+      if (!append(value.value.s->str))
+        return false;
+      if (quote_strings)
+        return append(std::string(1, static_cast<char>(quote_strings)));
+      return true;
+
+    default: {
+      std::string descr;
+      value.append_descr(descr, indent, quote_strings);
+      return append(descr);
+    }
+  }
+}
+
+bool Descr_printer::append_container(const Value &value, int indent) {
+  const bool is_array = value.type == Array;
+  if (is_array ? !value.value.array || !*value.value.array : !value.value.map || !*value.value.map)
+    throw Exception::value_error(is_array ? "Invalid array value encountered" : "Invalid map value encountered");
+
+  const size_t size = is_array ? (*value.value.array)->size() : (*value.value.map)->size();
+  const char *open = is_array ? "[" : "{";
+  const char *close = is_array ? "]" : "}";
+
+  if (size && _max_depth && static_cast<size_t>(indent) >= _max_depth)
+    return append(std::string(open) + "... " + std::to_string(size) + (is_array ? " items" : " keys") + close);
+
+  if (!append(open))
+    return false;
+
+  // The same layout as Value::append_descr() with indentation
+  const std::string item_indent((indent + 1) * 4, ' ');
+  size_t count = 0;
+  auto append_entry = [&](const std::string *key, const Value &item) {
+    if (count && !append(is_array ? "," : ", "))
+      return false;
+    if ((is_array || count) && !append("\n"))
+      return false;
+    if (!append(item_indent))
+      return false;
+    if (key && !append("\"" + *key + "\": "))
+      return false;
+    count++;
+    return append(item, indent + 1, '"');
+  };
+
+  if (!is_array && size && !append("\n"))
+    return false;
+
+  if (is_array) {
+    for (auto &item : **value.value.array) {
+      if (_max_elements && count == _max_elements)
+        break;
+      if (!append_entry(nullptr, item))
+        return false;
+    }
+  } else {
+    for (auto &entry : **value.value.map) {
+      if (_max_elements && count == _max_elements)
+        break;
+      if (!append_entry(&entry.first, entry.second))
+        return false;
+    }
+  }
+
+  if (count < size &&
+      !append(std::string(is_array ? ",\n" : ", \n") + item_indent + "... " + std::to_string(size - count) + " more"))
+    return false;
+
+  if (size) {
+    if (!append("\n"))
+      return false;
+    if (indent > 0 && !append(std::string(indent * 4, ' ')))
+      return false;
+  }
+
+  return append(close);
+}
+
 std::string Value::json(bool pprint) const {
   std::stringstream s;
   JSON_dumper dumper(pprint);
@@ -960,9 +1317,9 @@ std::string &Value::append_descr(std::string &s_out, int indent, int quote_strin
     break;
     case String:
       if (quote_strings)
-        s_out += (char)quote_strings + *value.s + (char)quote_strings;
+        s_out += (char)quote_strings + value.s->str + (char)quote_strings;
       else
-        s_out += *value.s;
+        s_out += value.s->str;
       break;
     case Object:
       if (!value.o || !*value.o)
@@ -1073,7 +1430,7 @@ std::string &Value::append_repr(std::string &s_out) const {
     break;
     case String:
     {
-      std::string &s = *value.s;
+      const std::string &s = value.s->str;
       s_out += "\"";
       for (size_t i = 0; i < s.length(); i++) {
         char c = s[i];
@@ -1169,22 +1526,22 @@ Value::~Value() {
     case Float:
       break;
     case String:
-      delete value.s;
+      value.s->release();
       break;
     case Object:
-      delete value.o;
+      delete_box(value.o);
       break;
     case Array:
-      delete value.array;
+      delete_box(value.array);
       break;
     case Map:
-      delete value.map;
+      delete_box(value.map);
       break;
     case MapRef:
-      delete value.mapref;
+      delete_box(value.mapref);
       break;
     case Function:
-      delete value.func;
+      delete_box(value.func);
       break;
   }
 }
@@ -1245,7 +1602,7 @@ const std::string &Argument_list::string_at(unsigned int i) const {
     throw Exception::argument_error("Insufficient number of arguments");
   switch (at(i).type) {
     case String:
-      return *at(i).value.s;
+      return at(i).value.s->str;
     default:
       throw Exception::type_error((boost::format("Argument #%1% is expected to be a string") % (i + 1)).str());
   };
@@ -1363,7 +1720,7 @@ const std::string &Argument_map::string_at(const std::string &key) const {
   const Value &v(at(key));
   switch (v.type) {
     case String:
-      return *v.value.s;
+      return v.value.s->str;
     default:
       throw Exception::type_error(std::string("Argument ").append(key).append(" is expected to be a string"));
   }
@@ -21,6 +21,7 @@
 #include "shellcore/common.h"
 #include "utils/utils_help.h"
 #include "utils/utils_general.h"
+#include "utils/utils_profile.h"
 #include <cstdarg>
 #include <cctype>
 
@@ -56,10 +57,10 @@ std::vector<std::string> Cpp_object_bridge::get_members_advanced(const NamingSty
 std::vector<std::string> Cpp_object_bridge::get_members() const {
   std::vector<std::string> members;
 
-  for (auto prop : _properties)
+  for (auto &prop : _properties)
     members.push_back(prop->name(naming_style));
 
-  for (auto func : _funcs)
+  for (auto &func : _funcs)
     members.push_back(func.second->name(naming_style));
 
   return members;
@@ -69,11 +70,11 @@ std::string Cpp_object_bridge::get_base_name(const std::string& member) const {
   std::string ret_val;
   auto style = naming_style;
 
-  auto func = std::find_if(_funcs.begin(), _funcs.end(), [member, style](const FunctionEntry &f) { return f.second->name(style) == member; });
+  auto func = find_function(member, style);
   if (func != _funcs.end()) {
     ret_val = (*func).second->name(NamingStyle::LowerCamelCase);
   } else {
-    auto prop = std::find_if(_properties.begin(), _properties.end(), [member, style](std::shared_ptr<Cpp_property_name> p) { return p->name(style) == member; });
+    auto prop = std::find_if(_properties.begin(), _properties.end(), [&member, &style](const std::shared_ptr<Cpp_property_name> &p) { return p->name(style) == member; });
     if (prop != _properties.end())
       ret_val = (*prop)->name(NamingStyle::LowerCamelCase);
   }
@@ -97,13 +98,13 @@ shcore::Value Cpp_object_bridge::get_member_method(const shcore::Argument_list &
 Value Cpp_object_bridge::get_member_advanced(const std::string &prop, const NamingStyle &style) {
   Value ret_val;
 
-  auto func = std::find_if(_funcs.begin(), _funcs.end(), [prop, style](const FunctionEntry &f) { return f.second->name(style) == prop; });
+  auto func = find_function(prop, style);
 
   if (func != _funcs.end()) {
     ScopedStyle ss(this, style);
     ret_val = get_member(func->first);
   } else {
-    auto prop_index = std::find_if(_properties.begin(), _properties.end(), [prop, style](std::shared_ptr<Cpp_property_name> p) { return p->name(style) == prop; });
+    auto prop_index = std::find_if(_properties.begin(), _properties.end(), [&prop, &style](const std::shared_ptr<Cpp_property_name> &p) { return p->name(style) == prop; });
     if (prop_index != _properties.end()) {
       ScopedStyle ss(this, style);
       ret_val = get_member((*prop_index)->base_name());
@@ -122,23 +123,24 @@ Value Cpp_object_bridge::get_member(const std::string &prop) const {
 }
 
 bool Cpp_object_bridge::has_member_advanced(const std::string &prop, const NamingStyle &style) {
-  auto method_index = std::find_if(_funcs.begin(), _funcs.end(), [prop, style](const FunctionEntry &f) { return f.second->name(style) == prop; });
+  if (find_function(prop, style) != _funcs.end())
+    return true;
 
-  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [prop, style](std::shared_ptr<Cpp_property_name> p) { return p->name(style) == prop; });
+  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [&prop, &style](const std::shared_ptr<Cpp_property_name> &p) { return p->name(style) == prop; });
 
-  return (method_index != _funcs.end() || prop_index != _properties.end());
+  return prop_index != _properties.end();
 }
 
 bool Cpp_object_bridge::has_member(const std::string &prop) const {
-  auto method_index = std::find_if(_funcs.begin(), _funcs.end(), [prop](const FunctionEntry &f) { return f.first == prop; });
+  auto method_index = _funcs.find(prop);
 
-  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [prop](std::shared_ptr<Cpp_property_name> p) { return p->base_name() == prop; });
+  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [&prop](const std::shared_ptr<Cpp_property_name> &p) { return p->base_name() == prop; });
 
   return (method_index != _funcs.end() || prop_index != _properties.end());
 }
 
 void Cpp_object_bridge::set_member_advanced(const std::string &prop, Value value, const NamingStyle &style) {
-  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [prop, style](std::shared_ptr<Cpp_property_name> p) { return p->name(style) == prop; });
+  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [&prop, &style](const std::shared_ptr<Cpp_property_name> &p) { return p->name(style) == prop; });
   if (prop_index != _properties.end()) {
     ScopedStyle ss(this, style);
 
@@ -170,7 +172,7 @@ bool Cpp_object_bridge::has_method(const std::string &name) const {
 }
 
 bool Cpp_object_bridge::has_method_advanced(const std::string &name, const NamingStyle &style) {
-  auto method_index = std::find_if(_funcs.begin(), _funcs.end(), [name, style](const FunctionEntry &f) { return f.second->name(style) == name; });
+  auto method_index = find_function(name, style);
 
   return method_index != _funcs.end();
 }
@@ -196,12 +198,12 @@ void Cpp_object_bridge::add_method(const std::string &name, Cpp_function::Functi
     va_end(l);
   }
 
-  auto function = std::shared_ptr<Cpp_function>(new Cpp_function(name, func, signature));
+  auto function = std::shared_ptr<Cpp_function>(new Cpp_function(name, std::move(func), std::move(signature)));
   _funcs[name.substr(0, name.find("|"))] = function;
 }
 
 void Cpp_object_bridge::add_varargs_method(const std::string &name, Cpp_function::Function func) {
-  auto function = std::shared_ptr<Cpp_function>(new Cpp_function(name, func, true));
+  auto function = std::shared_ptr<Cpp_function>(new Cpp_function(name, std::move(func), true));
   _funcs[name.substr(0, name.find("|"))] = function;
 }
 
@@ -217,7 +219,7 @@ void Cpp_object_bridge::add_property(const std::string &name, const std::string
 }
 
 void Cpp_object_bridge::delete_property(const std::string &name, const std::string &getter) {
-  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [name](std::shared_ptr<Cpp_property_name> p) { return p->base_name() == name; });
+  auto prop_index = std::find_if(_properties.begin(), _properties.end(), [&name](const std::shared_ptr<Cpp_property_name> &p) { return p->base_name() == name; });
   if (prop_index != _properties.end()) {
     _properties.erase(prop_index);
 
@@ -227,7 +229,7 @@ void Cpp_object_bridge::delete_property(const std::string &name, const std::stri
 }
 
 Value Cpp_object_bridge::call_advanced(const std::string &name, const Argument_list &args, const NamingStyle &style) {
-  auto func = std::find_if(_funcs.begin(), _funcs.end(), [name, style](const FunctionEntry &f) { return f.second->name(style) == name; });
+  auto func = find_function(name, style);
 
   Value ret_val;
 
@@ -241,10 +243,27 @@ Value Cpp_object_bridge::call_advanced(const std::string &name, const Argument_l
   return ret_val;
 }
 
+Cpp_object_bridge::FunctionMap::const_iterator Cpp_object_bridge::find_function(const std::string &name, const NamingStyle &style) const {
+  // The LowerCamelCase name is the key of the function, the other styles
+  // compare against the names cached on each function
+  if (style == LowerCamelCase)
+    return _funcs.find(name);
+
+  auto func = _funcs.begin();
+  for (; func != _funcs.end(); ++func) {
+    if (func->second->name(style) == name)
+      break;
+  }
+
+  return func;
+}
+
 Value Cpp_object_bridge::call(const std::string &name, const Argument_list &args) {
   std::map<std::string, std::shared_ptr<Cpp_function> >::const_iterator i;
   if ((i = _funcs.find(name)) == _funcs.end())
       throw Exception::attrib_error("Invalid object function " + name);
+
+  Profile_frame frame(Profiler::enabled() ? class_name() + "." + name : std::string());
   return i->second->invoke(args);
 }
 
@@ -402,7 +421,7 @@ std::shared_ptr<Cpp_object_bridge::ScopedStyle> Cpp_object_bridge::set_scoped_na
 }
 
 //-------
-Cpp_function::Cpp_function(const std::string &name, const Function &func, bool var_args) :_func(func) {
+Cpp_function::Cpp_function(const std::string &name, Function func, bool var_args) :_func(std::move(func)) {
   // The | separator is used when specific names are given for a function
   // Otherwise the function name is retrieved based on the style
   auto index = name.find("|");
@@ -416,8 +435,8 @@ Cpp_function::Cpp_function(const std::string &name, const Function &func, bool v
   _var_args = var_args;
 }
 
-Cpp_function::Cpp_function(const std::string &name_, const Function &func, const std::vector<std::pair<std::string, Value_type> > &signature_)
-  : _func(func), _signature(signature_) {
+Cpp_function::Cpp_function(const std::string &name_, Function func, std::vector<std::pair<std::string, Value_type> > signature_)
+  : _func(std::move(func)), _signature(std::move(signature_)) {
   // The | separator is used when specific names are given for a function
   // Otherwise the function name is retrieved based on the style
   auto index = name_.find("|");
@@ -431,8 +450,8 @@ Cpp_function::Cpp_function(const std::string &name_, const Function &func, const
   _var_args = false;
 }
 
-Cpp_function::Cpp_function(const std::string &name_, const Function &func, const char *arg1_name, Value_type arg1_type, ...)
-  : _func(func) {
+Cpp_function::Cpp_function(const std::string &name_, Function func, const char *arg1_name, Value_type arg1_type, ...)
+  : _func(std::move(func)) {
   _var_args = false;
   // The | separator is used when specific names are given for a function
   // Otherwise the function name is retrieved based on the style
@@ -468,10 +487,6 @@ std::string Cpp_function::name() {
   return _name[LowerCamelCase];
 }
 
-std::string Cpp_function::name(const NamingStyle& style) {
-  return _name[style];
-}
-
 std::vector<std::pair<std::string, Value_type> > Cpp_function::signature() {
   return _signature;
 }
@@ -489,7 +504,7 @@ Value Cpp_function::invoke(const Argument_list &args) {
   return _func(args);
 }
 
-std::shared_ptr<Function_base> Cpp_function::create(const std::string &name, const Function &func, const char *arg1_name, Value_type arg1_type, ...) {
+std::shared_ptr<Function_base> Cpp_function::create(const std::string &name, Function func, const char *arg1_name, Value_type arg1_type, ...) {
   va_list l;
   std::vector<std::pair<std::string, Value_type> > signature;
 
@@ -509,12 +524,12 @@ std::shared_ptr<Function_base> Cpp_function::create(const std::string &name, con
     } while (n && t != Undefined);
     va_end(l);
   }
-  return std::shared_ptr<Function_base>(new Cpp_function(name, func, signature));
+  return std::shared_ptr<Function_base>(new Cpp_function(name, std::move(func), std::move(signature)));
 }
 
-std::shared_ptr<Function_base> Cpp_function::create(const std::string &name, const Function &func,
-                                                      const std::vector<std::pair<std::string, Value_type> > &signature) {
-  return std::shared_ptr<Function_base>(new Cpp_function(name, func, signature));
+std::shared_ptr<Function_base> Cpp_function::create(const std::string &name, Function func,
+                                                      std::vector<std::pair<std::string, Value_type> > signature) {
+  return std::shared_ptr<Function_base>(new Cpp_function(name, std::move(func), std::move(signature)));
 }
 
 Cpp_property_name::Cpp_property_name(const std::string &name, bool constant) {
@@ -530,10 +545,3 @@ Cpp_property_name::Cpp_property_name(const std::string &name, bool constant) {
   }
 }
 
-std::string Cpp_property_name::name(const NamingStyle& style) {
-  return _name[style];
-}
-
-std::string Cpp_property_name::base_name() {
-  return _name[LowerCamelCase];
-}
@@ -20,6 +20,7 @@
 #include "shellcore/types_python.h"
 #include "shellcore/object_factory.h"
 #include "shellcore/common.h"
+#include "shellcore/python_utils.h"
 
 using namespace shcore;
 
@@ -55,6 +56,9 @@ bool Python_function::operator != (const Function_base &UNUSED(other)) const {
 }
 
 Value Python_function::invoke(const Argument_list &args) {
+  // Native code calls back into Python without holding the GIL
+  WillEnterPython lock;
+
   PyObject *argv = PyTuple_New(args.size());
 
 
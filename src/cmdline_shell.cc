@@ -27,6 +27,13 @@
 #include "utils/utils_help.h"
 #include "logger/logger.h"
 
+#ifndef WIN32
+#  include <unistd.h>
+#  include <poll.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -35,10 +42,137 @@
 //const int MAX_READLINE_BUF = 65536;
 extern char *mysh_get_tty_password(const char *opt_message);
 
+// Matches offered for a single word, more are not useful on screen
+#define MAX_COMPLETION_MATCHES 1000
+
+// Entries of the history file given to libedit for the arrow keys and its
+// own search, \history searches the whole file
+#define HISTORY_LOADED_ENTRIES 1000
+#define HISTORY_SEARCH_MATCHES 50
+
+// The idle work of the shell starts once no key was pressed for the delay,
+// so it does not slow down typing, and is run in steps of about this long
+#define IDLE_START_DELAY_MS 500
+#define IDLE_STEP_MS 10
+
 namespace mysqlsh {
-Command_line_shell::Command_line_shell(const Shell_options &options) : mysqlsh::Base_shell(options, &_delegate) {
+// The completion callbacks of libedit take no user data
+static Command_line_shell *completion_shell = NULL;
+
 #ifndef WIN32
+// On bracketed paste mode the terminal sends the pasted text between these,
+// it is read in blocks rather than edited by libedit a key at a time
+static const char kPasteStart[] = "\033[200~";
+static const char kPasteEnd[] = "\033[201~";
+
+// Bytes read ahead of what libedit was given
+static std::string pending_input;
+static size_t pending_position = 0;
+// The text pasted while reading the last line
+static std::string pasted_text;
+
+static int read_byte() {
+  unsigned char c;
+  ssize_t count;
+  do {
+    count = ::read(STDIN_FILENO, &c, 1);
+  } while (count < 0 && errno == EINTR);
+
+  return count == 1 ? c : -1;
+}
+
+static void read_paste() {
+  char block[65536];
+  size_t end = std::string::npos;
+  while (end == std::string::npos) {
+    ssize_t count = ::read(STDIN_FILENO, block, sizeof(block));
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      break;
+
+    // The end marker may be split between two blocks
+    size_t from = pasted_text.size() > sizeof(kPasteEnd) ? pasted_text.size() - sizeof(kPasteEnd) : 0;
+    pasted_text.append(block, count);
+    end = pasted_text.find(kPasteEnd, from);
+  }
+
+  // What was typed after the paste, read in the same block
+  if (end != std::string::npos) {
+    pending_input.assign(pasted_text, end + sizeof(kPasteEnd) - 1, std::string::npos);
+    pending_position = 0;
+    pasted_text.resize(end);
+  }
+
+  // Terminals send the new lines of the paste as carriage returns
+  boost::replace_all(pasted_text, "\r\n", "\n");
+  std::replace(pasted_text.begin(), pasted_text.end(), '\r', '\n');
+}
+
+// Runs the idle work of the shell, like collecting the garbage of the
+// languages, until a key is pressed or nothing is left to do
+static void wait_for_input() {
+  if (!completion_shell)
+    return;
+
+  auto shell = completion_shell->shell_context();
+  struct pollfd input = { STDIN_FILENO, POLLIN, 0 };
+  int timeout = IDLE_START_DELAY_MS;
+  while (::poll(&input, 1, timeout) == 0 && shell->idle(IDLE_STEP_MS))
+    timeout = 0;
+}
+
+// Given to libedit as rl_getc_function, a paste ends the line being read
+static int paste_getc(FILE *UNUSED(stream)) {
+  if (pending_position < pending_input.size())
+    return static_cast<unsigned char>(pending_input[pending_position++]);
+
+  wait_for_input();
+  int c = read_byte();
+  if (c != kPasteStart[0])
+    return c;
+
+  // Other escape sequences are given to libedit as read
+  std::string sequence(1, static_cast<char>(c));
+  while (sequence.size() < sizeof(kPasteStart) - 1) {
+    int next = read_byte();
+    if (next == -1)
+      break;
+
+    sequence.push_back(static_cast<char>(next));
+    if (sequence.back() != kPasteStart[sequence.size() - 1])
+      break;
+  }
+
+  if (sequence == kPasteStart) {
+    read_paste();
+    return '\n';
+  }
+
+  pending_input = sequence.substr(1);
+  pending_position = 0;
+  return c;
+}
+
+static bool bracketed_paste = false;
+#endif
+
+Command_line_shell::Command_line_shell(const Shell_options &options)
+  : mysqlsh::Base_shell(options, &_delegate), _completion_stale(false) {
+#ifndef WIN32
+  // Read by libedit when initialized
+  if (_options.interactive && isatty(STDIN_FILENO) && isatty(STDOUT_FILENO)) {
+    rl_getc_function = &paste_getc;
+    bracketed_paste = true;
+  }
+
   rl_initialize();
+
+  completion_shell = this;
+  rl_attempted_completion_function = &Command_line_shell::complete;
+  // Qualified names are completed a part at a time
+  static char word_breaks[] = " \t\n\"\\'`@$><=;|&{(,.";
+  rl_completer_word_break_characters = word_breaks;
 #endif
 
   _delegate.user_data = this;
@@ -51,9 +185,59 @@ Command_line_shell::Command_line_shell(const Shell_options &options) : mysqlsh::
 
   observe_notification("SN_STATEMENT_EXECUTED");
 
+  std::string cmd_help_history =
+    "SYNTAX:\n"
+    "   \\history [<text>]\n\n"
+    "EXAMPLES:\n"
+    "   \\history create table\n\n"
+    "Prints the last statements typed on the shell, or the ones containing the\n"
+    "given text, newest last. The history is kept across sessions in the\n"
+    "history file of the user configuration path.\n";
+
+  SET_SHELL_COMMAND("\\history", "Print or search the statement history.", cmd_help_history, Command_line_shell::cmd_history);
+
+  if (_options.interactive)
+    load_history();
+
   finish_init();
 }
 
+void Command_line_shell::load_history() {
+  try {
+    _history.reset(new shcore::History_store(shcore::get_user_config_path() + "history"));
+
+#ifndef WIN32
+    for (auto &entry : _history->last(HISTORY_LOADED_ENTRIES))
+      add_history(entry.c_str());
+#endif
+  } catch (std::exception &e) {
+    _history.reset();
+    log_warning("Unable to load the statement history: %s", e.what());
+  }
+}
+
+bool Command_line_shell::cmd_history(const std::vector<std::string>& args) {
+  if (!_history) {
+    print_error("The statement history is not available.\n");
+    return true;
+  }
+
+  // The first argument is the command itself
+  std::vector<std::string> entries;
+  if (args.size() > 1) {
+    std::vector<std::string> words(args.begin() + 1, args.end());
+    entries = _history->search(shcore::join_strings(words, " "), HISTORY_SEARCH_MATCHES);
+    std::reverse(entries.begin(), entries.end());
+  } else {
+    entries = _history->last(HISTORY_SEARCH_MATCHES);
+  }
+
+  for (auto &entry : entries)
+    println(entry);
+
+  return true;
+}
+
 void Command_line_shell::deleg_print(void *cdata, const char *text) {
   std::cout << text << std::flush;
 }
@@ -85,7 +269,15 @@ char *Command_line_shell::readline(const char *prompt) {
       std::cout << all_lines << std::flush;
   }
 
+  if (bracketed_paste)
+    std::cout << "\033[?2004h" << std::flush;
+
   tmp = ::readline(prompt_line.c_str());
+
+  // Turned off while the input is processed, so nothing started from the
+  // shell gets the markers
+  if (bracketed_paste)
+    std::cout << "\033[?2004l" << std::flush;
 #else
   std::string line;
   std::cout << prompt << std::flush;
@@ -107,9 +299,21 @@ bool Command_line_shell::deleg_prompt(void *UNUSED(cdata), const char *prompt, s
   ret = tmp;
   free(tmp);
 
+  // Only the first line of a paste answers the prompt
+  std::string pasted = take_paste();
+  ret.append(pasted, 0, pasted.find('\n'));
+
   return true;
 }
 
+std::string Command_line_shell::take_paste() {
+  std::string ret_val;
+#ifndef WIN32
+  ret_val.swap(pasted_text);
+#endif
+  return ret_val;
+}
+
 bool Command_line_shell::deleg_password(void *cdata, const char *prompt, std::string &ret) {
   Command_line_shell *self = (Command_line_shell*)cdata;
   char *tmp = self->_options.passwords_from_stdin ? shcore::mysh_get_stdin_password(prompt) : mysh_get_tty_password(prompt);
@@ -156,11 +360,20 @@ void Command_line_shell::command_loop() {
   }
 
   while (_options.interactive) {
+    update_completion();
+
     char *cmd = Command_line_shell::readline(prompt().c_str());
     if (!cmd)
       break;
 
-    process_line(cmd);
+    // A paste is processed at once, completing the line typed before it
+    std::string pasted = take_paste();
+    if (pasted.empty()) {
+      process_line(cmd);
+    } else {
+      std::cout << pasted << (pasted.back() == '\n' ? "" : "\n") << std::flush;
+      process_paste(cmd + pasted);
+    }
     free(cmd);
   }
 
@@ -218,13 +431,22 @@ void Command_line_shell::print_cmd_line_helper() {
   println("  --sqln                   Start in SQL mode using a node session.");
   println("  --js                     Start in JavaScript mode.");
   println("  --py                     Start in Python mode.");
-  println("  --json                   Produce output in JSON format.");
+  println("  --json[=format]          Produce output in JSON format: pretty (default), raw for compact JSON or");
+  println("                           ndjson for one line per row or document, written as it is fetched, and");
+  println("                           a summary line after the rows of each result.");
   println("  --table                  Produce output in table format (default for interactive mode).");
   println("                           This option can be used to force that format when running in batch mode.");
   println("  -E, --vertical           Print the output of a query (rows) vertically.");
+  println("  --output-format=format   Produce output in the given format: table, vertical, json, json/raw,");
+  println("                           json/ndjson or arrow, which writes the rows of every result as an Apache");
+  println("                           Arrow IPC stream.");
   println("  -i, --interactive[=full] To use in batch mode, it forces emulation of interactive mode processing.");
   println("                           Each line on the batch is processed as if it were in interactive mode.");
   println("  --force                  To use in SQL batch mode, forces processing to continue if an error is found.");
+  println("  --batch-pipeline=#       To use in SQL batch mode with node sessions, number of statements sent to the");
+  println("                           server ahead of their results.");
+  println("  --batch-commit=#         To use in SQL batch mode, number of consecutive INSERT, REPLACE, UPDATE and");
+  println("                           DELETE statements committed together instead of one by one.");
   println("  --log-level=value        The log level." + ngcommon::Logger::get_level_range_info());
   println("  --version                Prints the version of MySQL Shell.");
   println("  --ssl                    Enable SSL for connection(automatically enabled with other flags).");
@@ -238,9 +460,16 @@ void Command_line_shell::print_cmd_line_helper() {
   println("  --tls-version=version    TLS version to use, permitted values are : TLSv1, TLSv1.1.");
   println("  --passwords-from-stdin   Read passwords from stdin instead of the tty.");
   println("  --auth-method=method     Authentication method to use.");
+  println("  --compress               Use X protocol compression for the data sent by the server, with the");
+  println("                           first algorithm supported by both sides.");
   println("  --show-warnings          Automatically display SQL warnings on SQL mode if available.");
   println("  --dba enableXProtocol    Enable the X Protocol in the server connected to. Must be used with --classic.");
   println("  --no-wizard              Disables wizard mode.");
+  println("  --daemon[=socket]        Keep running with the session open, executing the statements, files or");
+  println("                           standard input sent by --client through the Unix socket, by default");
+  println("                           mysqlsh.sock in the configuration directory of the shell.");
+  println("  --client[=socket]        Send the --execute statement, the --file script or the standard input to");
+  println("                           the shell started with --daemon and print its output.");
 
   println("");
   println("Usage examples:");
@@ -252,12 +481,74 @@ void Command_line_shell::print_cmd_line_helper() {
 }
 
 void Command_line_shell::handle_notification(const std::string &name, const shcore::Object_bridge_ref& sender, shcore::Value::Map_type_ref data){
-#ifndef WIN32
   if(name=="SN_STATEMENT_EXECUTED"){
     std::string executed = data->get_string("statement");
+#ifndef WIN32
     add_history(executed.c_str());
+#endif
+
+    // Statements that may carry a password are not kept on disk, the same
+    // the mysql client does
+    std::string lower = boost::algorithm::to_lower_copy(executed);
+    if (_history && lower.find("identified") == std::string::npos && lower.find("password") == std::string::npos) {
+      try {
+        _history->append(executed);
+      } catch (std::exception &e) {
+        log_warning("Unable to save the statement history: %s", e.what());
+      }
+    }
+
+    if (Completion_index::changes_schema(executed))
+      _completion_stale = true;
+  }
+}
+
+void Command_line_shell::update_completion() {
+#ifndef WIN32
+  auto session = _shell->get_dev_session();
+  if (!session || !session->is_connected()) {
+    if (!_completion_session.expired()) {
+      _completion.clear();
+      _completion_session.reset();
+    }
+    return;
+  }
+
+  if (session != _completion_session.lock() || _completion_stale) {
+    _completion_session = session;
+    _completion_stale = false;
+
+    try {
+      _completion.load(session);
+    } catch (std::exception &e) {
+      log_warning("Could not load the names for completion: %s", e.what());
+    }
   }
 #endif
 }
 
+#ifndef WIN32
+char **Command_line_shell::complete(const char *text, int UNUSED(start), int UNUSED(end)) {
+  // No file names when there is no match
+  rl_attempted_completion_over = 1;
+
+  return rl_completion_matches(text, &Command_line_shell::complete_next);
+}
+
+char *Command_line_shell::complete_next(const char *text, int state) {
+  static std::vector<std::string> matches;
+  static size_t next;
+
+  if (state == 0) {
+    matches = completion_shell->_completion.complete(text, MAX_COMPLETION_MATCHES);
+    next = 0;
+  }
+
+  if (next < matches.size())
+    return strdup(matches[next++].c_str());
+
+  return NULL;
+}
+#endif
+
 }
@@ -27,6 +27,10 @@
 #include "shellcore/shell_notifications.h"
 #include "shellcore/types.h"
 #include "shellcore/shell_core.h"
+#include "completion_index.h"
+#include "utils/utils_history.h"
+
+#include <memory>
 
 namespace mysqlsh {
 class Command_line_shell :public mysqlsh::Base_shell, public shcore::NotificationObserver {
@@ -37,15 +41,35 @@ public:
   void print_cmd_line_helper();
   void print_banner();
 
+  bool cmd_history(const std::vector<std::string>& args);
+
 private:
   shcore::Interpreter_delegate _delegate;
   static char *readline(const char *prompt);
+  // The text pasted while the last line was read, cleared when taken
+  static std::string take_paste();
 
   static void deleg_print(void *self, const char *text);
   static void deleg_print_error(void *self, const char *text);
   static bool deleg_prompt(void *self, const char *text, std::string &ret);
   static bool deleg_password(void *self, const char *text, std::string &ret);
   static void deleg_source(void *self, const char *module);
+
+  // Loads the names to complete when the global session changes
+  void update_completion();
+#ifndef WIN32
+  static char **complete(const char *text, int start, int end);
+  static char *complete_next(const char *text, int state);
+#endif
+
+  void load_history();
+
+  // Every statement typed, kept across sessions
+  std::unique_ptr<shcore::History_store> _history;
+
+  Completion_index _completion;
+  std::weak_ptr<ShellDevelopmentSession> _completion_session;
+  bool _completion_stale;
   
   virtual void handle_notification(const std::string &name, const shcore::Object_bridge_ref& sender, shcore::Value::Map_type_ref data);
 };
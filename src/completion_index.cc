@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "completion_index.h"
+#include "modules/base_resultset.h"
+#include "modules/mod_mysql_session.h"
+#include "modules/mod_mysqlx_session.h"
+#include "utils/utils_general.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <thread>
+#include <boost/algorithm/string.hpp>
+
+// Distinct names, so a column name found in many tables is only sent once
+#define COMPLETION_NAMES_QUERY \
+  "SELECT schema_name FROM information_schema.schemata " \
+  "UNION SELECT table_name FROM information_schema.tables " \
+  "UNION SELECT column_name FROM information_schema.columns"
+
+namespace mysqlsh {
+Completion_index::Completion_index() : _state(new State()) {}
+
+void Completion_index::load(std::shared_ptr<ShellDevelopmentSession> session) {
+  bool classic = false;
+#ifdef HAVE_LIBMYSQLCLIENT
+  classic = std::dynamic_pointer_cast<mysql::ClassicSession>(session) != nullptr;
+#endif
+
+  // The connection data is taken here, the session belongs to this thread
+  shcore::Value::Map_type_ref connection_data = shcore::get_connection_data(session->uri(), false);
+  (*connection_data)[shcore::kDbPassword] = shcore::Value(session->get_password());
+  if (!session->get_ssl_ca().empty())
+    (*connection_data)[shcore::kSslCa] = shcore::Value(session->get_ssl_ca());
+  if (!session->get_ssl_cert().empty())
+    (*connection_data)[shcore::kSslCert] = shcore::Value(session->get_ssl_cert());
+  if (!session->get_ssl_key().empty())
+    (*connection_data)[shcore::kSslKey] = shcore::Value(session->get_ssl_key());
+
+  unsigned generation;
+  {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    generation = ++_state->generation;
+  }
+
+  // Not joined, a load that is no longer needed finishes on its own and its
+  // names are discarded
+  std::shared_ptr<State> state(_state);
+  std::thread([state, generation, connection_data, classic]() {
+    try {
+      std::shared_ptr<const Names> names = fetch_names(connection_data, classic);
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->generation == generation)
+        state->names = names;
+    } catch (std::exception &e) {
+      log_warning("Could not load the names for completion: %s", e.what());
+    }
+  }).detach();
+}
+
+void Completion_index::clear() {
+  std::lock_guard<std::mutex> lock(_state->mutex);
+  _state->generation++;
+  _state->names.reset();
+}
+
+std::shared_ptr<const Completion_index::Names> Completion_index::fetch_names(shcore::Value::Map_type_ref connection_data,
+                                                                             bool classic) {
+  // Opened without connect_session(), whose notifications are meant for the
+  // sessions of the user
+  std::shared_ptr<ShellDevelopmentSession> session;
+#ifdef HAVE_LIBMYSQLCLIENT
+  if (classic)
+    session.reset(new mysql::ClassicSession());
+  else
+#endif
+    session.reset(new mysqlx::NodeSession());
+
+  shcore::Argument_list args;
+  args.push_back(shcore::Value(connection_data));
+  session->connect(args);
+
+  // The session is disconnected when released, not by close(), which also
+  // notifies
+  std::shared_ptr<Names> names(new Names());
+  auto result = session->execute_sql(COMPLETION_NAMES_QUERY, shcore::Argument_list()).as_object();
+
+  shcore::Value record;
+  while ((record = result->call("fetchOne", shcore::Argument_list()))) {
+    shcore::Value name = record.as_object<Row>()->get_member(0);
+    if (name.type == shcore::String)
+      names->push_back(name.as_string());
+  }
+
+  // Names differing only in case are distinct to the server
+  std::sort(names->begin(), names->end());
+  names->erase(std::unique(names->begin(), names->end()), names->end());
+  names->shrink_to_fit();
+
+  return names;
+}
+
+std::vector<std::string> Completion_index::complete(const std::string &prefix, size_t max_matches) const {
+  std::shared_ptr<const Names> names;
+  {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    names = _state->names;
+  }
+
+  std::vector<std::string> ret_val;
+  if (!names)
+    return ret_val;
+
+  for (auto name = std::lower_bound(names->begin(), names->end(), prefix);
+       name != names->end() && ret_val.size() < max_matches && name->compare(0, prefix.size(), prefix) == 0; ++name)
+    ret_val.push_back(*name);
+
+  return ret_val;
+}
+
+bool Completion_index::changes_schema(const std::string &statement) {
+  // Also catches the calls of the scripting APIs, like createCollection()
+  std::string lower = boost::algorithm::to_lower_copy(statement);
+  for (const char *keyword : {"create", "drop", "alter", "rename"}) {
+    if (lower.find(keyword) != std::string::npos)
+      return true;
+  }
+
+  return false;
+}
+}
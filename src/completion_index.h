@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _COMPLETION_INDEX_H_
+#define _COMPLETION_INDEX_H_
+
+#include "modules/base_session.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mysqlsh {
+// Names of the schemas, tables, collections and columns of a server, used
+// to complete the words typed on the command line. The names are loaded in
+// the background through a session of their own, so completing never waits
+// on the server.
+class Completion_index {
+public:
+  Completion_index();
+
+  // Starts loading the names of the server of the session, the ones loaded
+  // so far are used until it is done
+  void load(std::shared_ptr<ShellDevelopmentSession> session);
+  void clear();
+
+  // Names starting with the prefix, in order
+  std::vector<std::string> complete(const std::string &prefix, size_t max_matches) const;
+
+  // Whether the statement may create, drop or rename schema objects
+  static bool changes_schema(const std::string &statement);
+
+private:
+  // Sorted and without duplicates, so the names with a prefix are a range
+  // found by binary search
+  typedef std::vector<std::string> Names;
+
+  struct State {
+    State() : generation(0) {}
+
+    std::mutex mutex;
+    std::shared_ptr<const Names> names;
+    unsigned generation;
+  };
+
+  static std::shared_ptr<const Names> fetch_names(shcore::Value::Map_type_ref connection_data, bool classic);
+
+  // Shared with the loaders, which may outlive the index
+  std::shared_ptr<State> _state;
+};
+}
+
+#endif
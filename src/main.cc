@@ -19,6 +19,7 @@
 
 #include "cmdline_shell.h"
 #include "shell_cmdline_options.h"
+#include "shell_daemon.h"
 #include "shell/shell_options.h"
 #include <sys/stat.h>
 #include <sstream>
@@ -192,15 +193,19 @@ int main(int argc, char **argv) {
   if (options.exit_code != 0)
     return options.exit_code;
 
-#ifdef HAVE_V8
-  extern void JScript_context_init();
-
-  JScript_context_init();
-#endif
+  // The client only forwards the job, so it starts no interpreter at all
+  if (!options.client_socket.empty())
+    return mysqlsh::daemon::run_client(options, options.client_socket);
 
   {
     bool from_stdin = false;
-    std::string error = detect_interactive(options, from_stdin);
+    std::string error;
+
+    // The daemon reads its jobs from the socket, never from the terminal
+    if (!options.daemon_socket.empty())
+      options.interactive = false;
+    else
+      error = detect_interactive(options, from_stdin);
 
     // Usage of wizards will be disabled if running in non interactive mode
     if (!options.interactive)
@@ -236,7 +241,9 @@ int main(int argc, char **argv) {
 
       shell_ptr = &shell;
 
-      if (!options.execute_statement.empty()) {
+      if (!options.daemon_socket.empty()) {
+        ret_val = mysqlsh::daemon::serve(shell, options, options.daemon_socket);
+      } else if (!options.execute_statement.empty()) {
         std::stringstream stream(options.execute_statement);
         ret_val = shell.process_stream(stream, "(command line)", {});
       } else if (!options.execute_dba_statement.empty()) {
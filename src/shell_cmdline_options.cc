@@ -23,6 +23,7 @@
 #include "shell_cmdline_options.h"
 #include "utils/utils_general.h"
 #include "utils/utils_connection.h"
+#include "shell_daemon.h"
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -83,6 +84,10 @@ Shell_command_line_options::Shell_command_line_options(int argc, char **argv)
       _options.recreate_database = true;
     else if (check_arg_with_value(argv, i, "--execute", "-e", value))
       _options.execute_statement = value;
+    else if (check_arg_with_value(argv, i, "--daemon", NULL, value, true))
+      _options.daemon_socket = value ? value : mysqlsh::daemon::default_socket_path();
+    else if (check_arg_with_value(argv, i, "--client", NULL, value, true))
+      _options.client_socket = value ? value : mysqlsh::daemon::default_socket_path();
     else if (check_arg_with_value(argv, i, "--dba", NULL, value))
       _options.execute_dba_statement = value;
     else if ((arg_format = check_arg_with_value(argv, i, "--dbpassword", NULL, value, true))) {
@@ -210,6 +215,8 @@ _options.ssl_info.skip = false;
         }
       }
     }
+    else if (check_arg(argv, i, "--compress", NULL))
+      _options.compression = "auto";
     else if (check_arg(argv, i, "--node", "--node"))
       override_session_type(mysqlsh::SessionType::Node, "--node");
     else if (check_arg(argv, i, "--classic", "--classic"))
@@ -243,13 +250,25 @@ _options.ssl_info.skip = false;
         _options.output_format = "json";
       else if (strcmp(value, "raw") == 0)
         _options.output_format = "json/raw";
+      else if (strcmp(value, "ndjson") == 0)
+        _options.output_format = "json/ndjson";
       else {
-        std::cerr << "Value for --json must be either pretty or raw.\n";
+        std::cerr << "Value for --json must be one of pretty, raw or ndjson.\n";
         exit_code = 1;
         break;
       }
+    } else if (check_arg_with_value(argv, i, "--output-format", NULL, value)) {
+      if (strcmp(value, "table") != 0 && strcmp(value, "vertical") != 0 && strcmp(value, "json") != 0 &&
+          strcmp(value, "json/raw") != 0 && strcmp(value, "json/ndjson") != 0 && strcmp(value, "arrow") != 0) {
+        std::cerr << "Value for --output-format must be one of table, vertical, json, json/raw, json/ndjson or arrow.\n";
+        exit_code = 1;
+        break;
+      }
+      _options.output_format = value;
     } else if (check_arg(argv, i, "--table", "--table"))
       _options.output_format = "table";
+    else if (check_arg_with_value(argv, i, "--trace-proto-file", NULL, value))
+      _options.trace_protocol_file = value;
     else if (check_arg(argv, i, "--trace-proto", NULL))
       _options.trace_protocol = true;
     else if (check_arg(argv, i, "--help", "--help")) {
@@ -260,6 +279,22 @@ _options.ssl_info.skip = false;
       exit_code = 0;
     } else if (check_arg(argv, i, "--force", "--force"))
       _options.force = true;
+    else if (check_arg_with_value(argv, i, "--batch-pipeline", NULL, value)) {
+      _options.batch_pipeline = atoi(value);
+      if (_options.batch_pipeline < 1) {
+        std::cerr << "Value for --batch-pipeline must be a positive integer.\n";
+        exit_code = 1;
+        break;
+      }
+    }
+    else if (check_arg_with_value(argv, i, "--batch-commit", NULL, value)) {
+      _options.batch_commit = atoi(value);
+      if (_options.batch_commit < 1) {
+        std::cerr << "Value for --batch-commit must be a positive integer.\n";
+        exit_code = 1;
+        break;
+      }
+    }
     else if (check_arg(argv, i, "--no-wizard", "--nw"))
       _options.wizards = false;
     else if (check_arg_with_value(argv, i, "--interactive", "-i", value, true)) {
@@ -319,6 +354,11 @@ _options.ssl_info.skip = false;
     }
   }
 
+  if (exit_code == 0 && !_options.daemon_socket.empty() && !_options.client_socket.empty()) {
+    std::cerr << "The --daemon and --client options can not be used together.\n";
+    exit_code = 1;
+  }
+
   _options.exit_code = exit_code;
 }
 
@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "shell_daemon.h"
+
+#include "modules/base_session.h"
+#include "shellcore/shell_core_options.h"
+#include "utils/utils_file.h"
+#include "logger/logger.h"
+
+#include <stdint.h>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifndef WIN32
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace mysqlsh {
+namespace daemon {
+
+std::string default_socket_path() {
+  return shcore::get_user_config_path() + "mysqlsh.sock";
+}
+
+#ifndef WIN32
+namespace {
+volatile sig_atomic_t stop_requested = 0;
+
+void handle_stop_signal(int) {
+  stop_requested = 1;
+}
+
+bool write_all(int fd, const char *data, size_t length) {
+  while (length > 0) {
+    ssize_t written = ::write(fd, data, length);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += written;
+    length -= written;
+  }
+  return true;
+}
+
+bool read_all(int fd, char *data, size_t length) {
+  while (length > 0) {
+    ssize_t got = ::read(fd, data, length);
+    if (got < 0 && errno == EINTR)
+      continue;
+    if (got <= 0)
+      return false;
+    data += got;
+    length -= got;
+  }
+  return true;
+}
+
+bool write_frame(int fd, char type, const char *data, size_t length) {
+  char header[5];
+  header[0] = type;
+  header[1] = static_cast<char>((length >> 24) & 0xff);
+  header[2] = static_cast<char>((length >> 16) & 0xff);
+  header[3] = static_cast<char>((length >> 8) & 0xff);
+  header[4] = static_cast<char>(length & 0xff);
+
+  return write_all(fd, header, sizeof(header)) && write_all(fd, data, length);
+}
+}  // namespace
+
+bool write_frame(int fd, char type, const std::string &data) {
+  return write_frame(fd, type, data.data(), data.size());
+}
+
+bool read_frame(int fd, char *type, std::string *data) {
+  unsigned char header[5];
+  if (!read_all(fd, reinterpret_cast<char*>(header), sizeof(header)))
+    return false;
+
+  uint32_t length = (static_cast<uint32_t>(header[1]) << 24) |
+                    (static_cast<uint32_t>(header[2]) << 16) |
+                    (static_cast<uint32_t>(header[3]) << 8) |
+                    static_cast<uint32_t>(header[4]);
+  if (length > k_max_frame)
+    return false;
+
+  *type = static_cast<char>(header[0]);
+  data->resize(length);
+  return length == 0 || read_all(fd, &(*data)[0], length);
+}
+
+namespace {
+bool make_address(const std::string &path, sockaddr_un *address) {
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address->sun_path))
+    return false;
+  strcpy(address->sun_path, path.c_str());
+  return true;
+}
+
+// Sends what is written to it to the client as frames of the given type.
+// Once the client is gone the output is dropped, the job still runs to its
+// end since stopping it half way would leave the session in an unknown state.
+class Frame_streambuf : public std::streambuf {
+public:
+  Frame_streambuf(int fd, char type) : _fd(fd), _type(type) {}
+
+protected:
+  virtual int_type overflow(int_type c) {
+    if (c != traits_type::eof()) {
+      char ch = traits_type::to_char_type(c);
+      xsputn(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  virtual std::streamsize xsputn(const char *s, std::streamsize n) {
+    if (_fd >= 0 && n > 0 && !write_frame(_fd, _type, s, static_cast<size_t>(n)))
+      _fd = -1;
+    return n;
+  }
+
+private:
+  int _fd;
+  char _type;
+};
+
+// Points std::cout and std::cerr, where the shell prints, to the client
+// for as long as it lives
+class Output_redirect {
+public:
+  explicit Output_redirect(int fd)
+      : _out(fd, k_stdout), _err(fd, k_stderr),
+        _old_out(std::cout.rdbuf(&_out)), _old_err(std::cerr.rdbuf(&_err)) {}
+
+  ~Output_redirect() {
+    std::cout.flush();
+    std::cerr.flush();
+    std::cout.rdbuf(_old_out);
+    std::cerr.rdbuf(_old_err);
+  }
+
+private:
+  Frame_streambuf _out;
+  Frame_streambuf _err;
+  std::streambuf *_old_out;
+  std::streambuf *_old_err;
+};
+
+bool is_same_user(int fd) {
+#if defined(SO_PEERCRED)
+  struct ucred credentials;
+  socklen_t length = sizeof(credentials);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0)
+    return false;
+  return credentials.uid == getuid();
+#else
+  uid_t uid;
+  gid_t gid;
+  if (getpeereid(fd, &uid, &gid) != 0)
+    return false;
+  return uid == getuid();
+#endif
+}
+
+// The global session of the daemon is reopened when a job closed it or the
+// server dropped it, so the next jobs find it as it was when started
+void check_session(Base_shell &shell, Shell_options options) {
+  if (!options.has_connection_data())
+    return;
+
+  auto session = shell.shell_context()->get_dev_session();
+  if (session && session->is_connected())
+    return;
+
+  try {
+    shell.connect(true);
+  } catch (std::exception &e) {
+    shell.print_error(std::string(e.what()) + "\n");
+  }
+}
+
+int run_job(Base_shell &shell, int fd) {
+  std::string output_format;
+  std::vector<std::string> argv;
+  char type;
+  std::string data;
+
+  for (;;) {
+    if (!read_frame(fd, &type, &data))
+      return -1;
+
+    if (type == k_output_format)
+      output_format = data;
+    else if (type == k_argument)
+      argv.push_back(data);
+    else if (type == k_statement || type == k_file || type == k_stdin)
+      break;
+    else
+      return -1;
+  }
+
+  Output_redirect redirect(fd);
+  auto options = shcore::Shell_core_options::get();
+  shcore::Value saved_format = (*options)[SHCORE_OUTPUT_FORMAT];
+  int exit_code = 1;
+
+  if (!output_format.empty())
+    shcore::Shell_core_options::set(SHCORE_OUTPUT_FORMAT, shcore::Value(output_format));
+
+  try {
+    if (type == k_file) {
+      argv.insert(argv.begin(), data);
+      exit_code = shell.process_file(data, argv);
+    } else {
+      std::stringstream stream(data);
+      exit_code = shell.process_stream(stream, type == k_statement ? "(command line)" : "STDIN", argv);
+    }
+  } catch (std::exception &e) {
+    shell.print_error(std::string(e.what()) + "\n");
+  }
+
+  if (!output_format.empty())
+    shcore::Shell_core_options::set(SHCORE_OUTPUT_FORMAT, saved_format);
+
+  return exit_code;
+}
+}  // namespace
+
+bool free_socket_path(const std::string &path, std::string *error) {
+  struct stat info;
+  if (lstat(path.c_str(), &info) != 0) {
+    if (errno == ENOENT)
+      return true;
+    *error = "Unable to check the daemon socket " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  // Anything else at the path is most likely a mistyped one
+  if (!S_ISSOCK(info.st_mode)) {
+    *error = "The path of the daemon socket exists and is not a socket: " + path;
+    return false;
+  }
+
+  sockaddr_un address;
+  if (!make_address(path, &address)) {
+    *error = "The path of the daemon socket is too long: " + path;
+    return false;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    *error = std::string("Unable to create the daemon socket: ") + strerror(errno);
+    return false;
+  }
+
+  bool listening = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+  ::close(fd);
+
+  if (listening) {
+    *error = "A shell daemon is already listening on " + path;
+    return false;
+  }
+
+  if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+    *error = "Unable to remove the daemon socket " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  return true;
+}
+
+int serve(Base_shell &shell, const Shell_options &options, const std::string &path) {
+  sockaddr_un address;
+  if (!make_address(path, &address)) {
+    shell.print_error("The path of the daemon socket is too long: " + path + "\n");
+    return 1;
+  }
+
+  std::string error;
+  if (!free_socket_path(path, &error)) {
+    shell.print_error(error + "\n");
+    return 1;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  // The jobs run with the session of the daemon, so no one else may connect
+  mode_t old_mask = umask(077);
+  int bound = fd < 0 ? -1 : bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  umask(old_mask);
+
+  if (bound != 0 || listen(fd, 16) != 0) {
+    shell.print_error("Unable to listen on " + path + ": " + strerror(errno) + "\n");
+    if (fd >= 0)
+      ::close(fd);
+    return 1;
+  }
+
+  // Without SA_RESTART, so the signals interrupt accept()
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = handle_stop_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGTERM, &action, NULL);
+  sigaction(SIGINT, &action, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  log_info("Shell daemon listening on %s", path.c_str());
+
+  while (!stop_requested) {
+    int client = accept(fd, NULL, NULL);
+    if (client < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      shell.print_error(std::string("Unable to accept jobs: ") + strerror(errno) + "\n");
+      break;
+    }
+
+    if (is_same_user(client)) {
+      check_session(shell, options);
+
+      int exit_code = run_job(shell, client);
+      if (exit_code >= 0)
+        write_frame(client, k_exit_code, boost::lexical_cast<std::string>(exit_code));
+    }
+
+    ::close(client);
+  }
+
+  ::close(fd);
+  unlink(path.c_str());
+  log_info("Shell daemon stopped");
+
+  return 0;
+}
+
+int run_client(const Shell_options &options, const std::string &path) {
+  sockaddr_un address;
+  if (!make_address(path, &address)) {
+    std::cerr << "The path of the daemon socket is too long: " << path << "\n";
+    return 1;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    std::cerr << "Unable to connect to the shell daemon at " << path << ": " << strerror(errno) << "\n";
+    if (fd >= 0)
+      ::close(fd);
+    return 1;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  bool sent = options.output_format.empty() || write_frame(fd, k_output_format, options.output_format);
+
+  if (!options.execute_statement.empty()) {
+    sent = sent && write_frame(fd, k_statement, options.execute_statement);
+  } else if (!options.run_file.empty()) {
+    // The daemon runs in a directory of its own
+    char *real_path = realpath(options.run_file.c_str(), NULL);
+    std::string file = real_path ? real_path : options.run_file;
+    free(real_path);
+
+    for (size_t i = 1; i < options.script_argv.size(); ++i)
+      sent = sent && write_frame(fd, k_argument, options.script_argv[i]);
+    sent = sent && write_frame(fd, k_file, file);
+  } else {
+    std::stringstream input;
+    input << std::cin.rdbuf();
+    sent = sent && write_frame(fd, k_stdin, input.str());
+  }
+
+  if (!sent) {
+    std::cerr << "Unable to send the job to the shell daemon: " << strerror(errno) << "\n";
+    ::close(fd);
+    return 1;
+  }
+
+  char type;
+  std::string data;
+  int exit_code = -1;
+
+  while (exit_code < 0 && read_frame(fd, &type, &data)) {
+    if (type == k_stdout)
+      std::cout << data << std::flush;
+    else if (type == k_stderr)
+      std::cerr << data << std::flush;
+    else if (type == k_exit_code)
+      exit_code = atoi(data.c_str());
+  }
+
+  ::close(fd);
+
+  if (exit_code < 0) {
+    std::cerr << "The shell daemon closed the connection before the job ended\n";
+    return 1;
+  }
+
+  return exit_code;
+}
+
+#else
+
+int serve(Base_shell &shell, const Shell_options &options, const std::string &path) {
+  shell.print_error("The shell daemon is not available on Windows\n");
+  return 1;
+}
+
+int run_client(const Shell_options &options, const std::string &path) {
+  std::cerr << "The shell daemon is not available on Windows\n";
+  return 1;
+}
+
+#endif
+
+}  // namespace daemon
+}  // namespace mysqlsh
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _SHELL_DAEMON_H_
+#define _SHELL_DAEMON_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "shell/base_shell.h"
+#include "shell/shell_options.h"
+
+namespace mysqlsh {
+// A shell kept running with mysqlsh --daemon, its interpreters loaded and
+// its session open, runs the jobs of mysqlsh --client sent through a Unix
+// socket. A job is the statement, file or standard input the client was
+// given, its output is streamed back to the client as it is printed.
+//
+// Every message on the socket is a frame: a type byte, the length of the
+// data as 4 bytes in network order and the data.
+namespace daemon {
+
+// Frames from the client: the output format and the arguments of the job
+// come first, the frame with the job runs it
+const char k_output_format = 'o';
+const char k_argument = 'a';
+const char k_statement = 'e';
+const char k_file = 'f';
+const char k_stdin = 's';
+
+// Frames from the daemon: the output of the job and its exit code, last
+const char k_stdout = '1';
+const char k_stderr = '2';
+const char k_exit_code = 'x';
+
+// Jobs larger than this are refused rather than buffered
+const uint32_t k_max_frame = 256 * 1024 * 1024;
+
+// The socket used when --daemon or --client are given without one
+std::string default_socket_path();
+
+// Runs the jobs sent to the socket one after the other, until the process
+// gets SIGTERM or SIGINT. Only the user running the daemon may connect.
+int serve(Base_shell &shell, const Shell_options &options, const std::string &path);
+
+// Sends the statement, file or standard input of the options to the daemon
+// listening on the socket and prints its output, returns the exit code of
+// the job
+int run_client(const Shell_options &options, const std::string &path);
+
+#ifndef WIN32
+// Write and read a whole frame on the socket, false if it failed or the
+// other end closed it first
+bool write_frame(int fd, char type, const std::string &data);
+bool read_frame(int fd, char *type, std::string *data);
+
+// Frees the path for the socket of a new daemon, removing the socket file
+// left by a daemon that did not stop cleanly. Fails, leaving the path as it
+// is, when a daemon still listens there or what is there is not a socket.
+bool free_socket_path(const std::string &path, std::string *error);
+#endif
+
+}  // namespace daemon
+}  // namespace mysqlsh
+
+#endif
@@ -0,0 +1,211 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "utils/base_tokenizer.h"
+
+namespace shcore {
+namespace base_tokenizer_tests {
+enum { Digits = Token_first_custom, Quoted_id, Escaped_quote, Quote, Pct_encoded, Rest };
+
+// Lists the tokens as kind:position:text, the simple tokens by their char
+std::string print_tokens(const BaseTokenizer &tokenizer) {
+  std::stringstream out;
+  for (auto it = tokenizer.begin(); it != tokenizer.end(); ++it) {
+    if (it != tokenizer.begin())
+      out << " ";
+    if (it->get_type() < Token_unknown)
+      out << static_cast<char>(it->get_type());
+    else
+      out << it->get_type() - Token_first_custom;
+    out << ":" << it->get_pos() << ":" << it->get_text();
+  }
+  return out.str();
+}
+
+// Checks every token is a span of the input of the tokenizer at its
+// position, the text of the tokens is not copied
+void assert_spans(BaseTokenizer &tokenizer, const std::string &input) {
+  ASSERT_EQ(input, tokenizer.get_input());
+  for (auto it = tokenizer.begin(); it != tokenizer.end(); ++it) {
+    ASSERT_LE(it->get_pos() + it->get_length(), input.size());
+    ASSERT_EQ(tokenizer.get_input().data() + it->get_pos(), it->get_data());
+  }
+}
+
+// A backtick quoted identifier, where a doubled backtick is an escaped one
+bool quoted_id(const std::string &input, size_t &index) {
+  if (input[index] != '`')
+    return false;
+
+  for (size_t end = index + 1; end < input.size(); end++) {
+    if (input[end] == '`') {
+      if (end + 1 < input.size() && input[end + 1] == '`')
+        end++;
+      else {
+        index = end + 1;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+TEST(BaseTokenizer, simple_tokens) {
+  BaseTokenizer tokenizer;
+  std::string input = "a.b:c";
+  tokenizer.set_simple_tokens(".:");
+  tokenizer.set_allow_unknown_tokens(true);
+  tokenizer.set_input(input);
+  tokenizer.process({0, input.size()});
+
+  // The kind of a simple token is its char, the chars with no rule are
+  // joined in unknown tokens
+  EXPECT_EQ("-1:0:a .:1:. -1:2:b ::3:: -1:4:c", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+
+  EXPECT_TRUE(tokenizer.cur_token_type_is(Token_unknown));
+  EXPECT_TRUE(tokenizer.next_token_type('.'));
+  EXPECT_TRUE(tokenizer.next_token_type(':', 3));
+  EXPECT_EQ("unknown", tokenizer.type_name(Token_unknown));
+  EXPECT_EQ(".", tokenizer.type_name('.'));
+}
+
+TEST(BaseTokenizer, numeric_literals) {
+  BaseTokenizer tokenizer;
+  std::string input = "12.345:6";
+  tokenizer.set_simple_tokens(".:");
+  tokenizer.set_complex_token(Digits, "digits", "0123456789");
+  tokenizer.set_input(input);
+
+  // At the start and at the end of the input
+  tokenizer.process({0, input.size()});
+  EXPECT_EQ("0:0:12 .:2:. 0:3:345 ::6:: 0:7:6", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+
+  // At the start and at the end of a range, the positions are still the
+  // ones on the input
+  tokenizer.process({3, 5});
+  EXPECT_EQ("0:3:345", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+
+  tokenizer.process({2, 7});
+  EXPECT_EQ(".:2:. 0:3:345 ::6:: 0:7:6", print_tokens(tokenizer));
+
+  // A range past the input stops at its end
+  tokenizer.process({7, 100});
+  EXPECT_EQ("0:7:6", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+
+  // A single digit at both edges of the input
+  input = "1";
+  tokenizer.set_input(input);
+  tokenizer.process({0, input.size()});
+  EXPECT_EQ("0:0:1", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+
+  EXPECT_EQ("digits", tokenizer.type_name(Digits));
+  EXPECT_EQ('1', *tokenizer.consume_token(Digits).get_data());
+  EXPECT_FALSE(tokenizer.tokens_available());
+}
+
+TEST(BaseTokenizer, quoted_identifiers) {
+  BaseTokenizer tokenizer;
+  std::string input = "`a.b`.`c``d`.``";
+  tokenizer.set_simple_tokens(".");
+  tokenizer.set_complex_token(Quoted_id, "quoted-id", quoted_id);
+  tokenizer.set_input(input);
+  tokenizer.process({0, input.size()});
+
+  // The quotes and the escaped quotes are part of the span
+  EXPECT_EQ("1:0:`a.b` .:5:. 1:6:`c``d` .:12:. 1:13:``", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+
+  // An unterminated quote is not an identifier
+  input = "`a``";
+  tokenizer.set_input(input);
+  try {
+    tokenizer.process({0, input.size()});
+    ADD_FAILURE() << "The unterminated quote was accepted";
+  } catch (std::runtime_error &e) {
+    EXPECT_STREQ("Illegal character [`] found at position 0", e.what());
+  }
+}
+
+TEST(BaseTokenizer, escapes) {
+  BaseTokenizer tokenizer;
+  std::string input = "\"a\\\"b\" \\\"\\";
+  tokenizer.set_complex_token(Escaped_quote, "escaped-quote", {"\\", "\""});
+  tokenizer.set_complex_token(Quote, "quote", std::string("\""));
+  tokenizer.set_allow_unknown_tokens(true);
+  tokenizer.set_input(input);
+  tokenizer.process({0, input.size()});
+
+  // The escaped quote is a single token, the backslash at the end of the
+  // input is unknown as it has no quote after it
+  EXPECT_EQ("3:0:\" -1:1:a 2:2:\\\" -1:4:b 3:5:\" -1:6:  2:7:\\\" -1:9:\\", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+}
+
+TEST(BaseTokenizer, groups_and_final_token) {
+  BaseTokenizer tokenizer;
+  std::string input = "%41%4g=x&y";
+  tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", "0123456789ABCDEFabcdef", "0123456789ABCDEFabcdef"});
+  tokenizer.set_final_token_group(Rest, "rest", "=&");
+  tokenizer.set_allow_unknown_tokens(true);
+  tokenizer.set_input(input);
+  tokenizer.process({0, input.size()});
+
+  // A partial group is not a token, and the final token spans the rest of
+  // the input
+  EXPECT_EQ("4:0:%41 -1:3:%4g 5:6:=x&y", print_tokens(tokenizer));
+  assert_spans(tokenizer, input);
+  EXPECT_EQ("rest", tokenizer.type_name(Rest));
+}
+
+TEST(BaseTokenizer, errors) {
+  BaseTokenizer tokenizer;
+  std::string input = "12 :";
+  tokenizer.set_simple_tokens(":");
+  tokenizer.set_complex_token(Digits, "digits", "0123456789");
+  tokenizer.set_allow_spaces(false);
+  tokenizer.set_input(input);
+
+  try {
+    tokenizer.process({0, input.size()});
+    ADD_FAILURE() << "The space was accepted";
+  } catch (std::runtime_error &e) {
+    EXPECT_STREQ("Illegal space found at position 2", e.what());
+  }
+
+  // The kinds are named in the errors
+  tokenizer.process({0, 1});
+  try {
+    tokenizer.consume_token(':');
+    ADD_FAILURE() << "The digits were consumed as a colon";
+  } catch (std::runtime_error &e) {
+    EXPECT_STREQ("Expected token type : at position 0 but found type digits (12)", e.what());
+  }
+
+  EXPECT_EQ("12", tokenizer.consume_token(Digits).get_text());
+  EXPECT_THROW(tokenizer.consume_any_token(), std::runtime_error);
+}
+}
+}
@@ -0,0 +1,87 @@
+/*
+  Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../mysqlxtest/common/expr_parser.h"
+#include "../mysqlxtest/common/proj_parser.h"
+
+/*
+  Measures the expression parsers of the X DevAPI on the inputs that stress
+  them the most: a fields() call with many projections, each one parsed on
+  its own, and a filter with a long IN list.
+
+  Usage: bench_expr_parser [iterations]
+*/
+
+static void run(const std::string &name, int iterations, const std::function<void()> &function) {
+  // The first run warms up the allocator and the caches, it is not accounted
+  function();
+
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < iterations; index++)
+    function();
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << std::chrono::duration<double, std::micro>(end - start).count() / iterations << "\n";
+}
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+  if (iterations < 1)
+    iterations = 1;
+
+  std::vector<std::string> fields;
+  for (int index = 0; index < 1000; index++)
+    fields.push_back("$.address.field_" + std::to_string(index) + " as alias_" + std::to_string(index));
+
+  std::string in_list = "age in (";
+  for (int index = 0; index < 10000; index++)
+    in_list += (index ? ", " : "") + std::to_string(index);
+  in_list += ") and name like :name";
+
+  std::cout << std::left << std::setw(32) << "input" << std::right << std::setw(14) << "time (us)" << "\n";
+
+  run("tokenize 1000 fields", iterations, [&fields]() {
+    for (auto &field : fields)
+      mysqlx::Tokenizer(field).get_tokens();
+  });
+
+  run("parse 1000 fields", iterations, [&fields]() {
+    ::google::protobuf::RepeatedPtrField< ::Mysqlx::Crud::Projection > projection;
+    for (auto &field : fields)
+      mysqlx::Proj_parser(field, true).parse(projection);
+  });
+
+  run("tokenize IN list of 10000", iterations, [&in_list]() {
+    mysqlx::Tokenizer(in_list).get_tokens();
+  });
+
+  run("parse IN list of 10000", iterations, [&in_list]() {
+    std::vector<std::string> placeholders;
+    delete mysqlx::Expr_parser(in_list, true, false, &placeholders).expr();
+  });
+
+  return 0;
+}
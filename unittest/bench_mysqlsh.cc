@@ -0,0 +1,389 @@
+/*
+  Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "../mysqlxtest/common/expr_parser.h"
+#include "../mysqlxtest/mysqlx_row.h"
+#include "../mysqlxtest/ngs_common/xdatetime.h"
+#include "../utils/utils_mysql_parsing.h"
+#include "../shell/shell_resultset_dumper.h"
+#include "modules/base_resultset.h"
+#include "shellcore/lang_base.h"
+#include "shellcore/obj_date.h"
+#include "shellcore/shell_core_options.h"
+#include "shellcore/types.h"
+
+#ifdef HAVE_V8
+#include "shellcore/jscript_context.h"
+#include "shellcore/object_registry.h"
+#endif
+
+#ifdef HAVE_PYTHON
+#include "shellcore/python_context.h"
+#include "shellcore/python_utils.h"
+#endif
+
+/*
+  Measures the hot paths of the shell that do not need a server: statement
+  splitting, Value parsing and JSON serialization, the X DevAPI expression
+  parser, the decoding of X protocol row fields, the formatting of results
+  and the conversion of values to and from the scripting languages.
+
+  The inputs are built in place with fixed contents and seeds, and each
+  case reports the median time of several repetitions, so the numbers of
+  two builds can be compared line by line.
+
+  Usage: bench_mysqlsh [iterations] [filter]
+
+  The splitting of a real dump is measured as well when MYSQLSH_BENCH_DUMP
+  names a file written by mysqldump.
+*/
+
+namespace {
+const int k_repetitions = 5;
+
+std::string g_filter;
+
+void run(const std::string &name, int iterations, const std::function<void()> &function) {
+  if (!g_filter.empty() && name.find(g_filter) == std::string::npos)
+    return;
+
+  // The first run warms up the allocator and the caches, it is not accounted
+  function();
+
+  std::vector<double> times;
+  for (int repetition = 0; repetition < k_repetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int index = 0; index < iterations; index++)
+      function();
+    auto end = std::chrono::steady_clock::now();
+
+    times.push_back(std::chrono::duration<double, std::micro>(end - start).count() / iterations);
+  }
+
+  std::sort(times.begin(), times.end());
+
+  std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << times[k_repetitions / 2]
+            << std::setw(14) << times.front() << "\n";
+}
+
+std::string encode_varint(uint64_t value) {
+  std::string buffer;
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+  return buffer;
+}
+
+// Result with fixed columns and rows, as the dumper gets them from a query
+class Canned_result : public mysqlsh::ShellBaseResult {
+public:
+  Canned_result(size_t rows) : _columns(new shcore::Value::Array_type()), _rows(new shcore::Value::Array_type()) {
+    const char *names[] = { "id", "name", "email", "balance", "created" };
+    const bool numerics[] = { true, false, false, true, false };
+
+    for (size_t index = 0; index < 5; index++) {
+      _columns->push_back(shcore::Value(std::shared_ptr<shcore::Object_bridge>(new mysqlsh::Column(
+        "bench", "accounts", "accounts", names[index], names[index], shcore::Value(), numerics[index] ? 11 : 64,
+        numerics[index], 0, true, "utf8mb4_general_ci", "utf8mb4", false))));
+    }
+
+    std::mt19937 random(11);
+    for (size_t index = 0; index < rows; index++) {
+      std::shared_ptr<mysqlsh::Row> row(new mysqlsh::Row());
+      row->add_item("id", shcore::Value(int(index)));
+      row->add_item("name", shcore::Value("name_" + std::to_string(random() % 100000)));
+      row->add_item("email", shcore::Value("user" + std::to_string(random() % 100000) + "@example.com"));
+      row->add_item("balance", shcore::Value(double(random() % 10000000) / 100));
+      row->add_item("created", shcore::Value("2017-03-" + std::to_string(10 + index % 20) + " 10:20:30"));
+      _rows->push_back(shcore::Value(std::static_pointer_cast<shcore::Object_bridge>(row)));
+    }
+  }
+
+  virtual std::string class_name() const { return "CannedResult"; }
+
+  virtual shcore::Value get_member(const std::string &prop) const {
+    if (prop == "columns")
+      return shcore::Value(_columns);
+
+    return mysqlsh::ShellBaseResult::get_member(prop);
+  }
+
+  shcore::Value::Array_type_ref rows() const { return _rows; }
+
+private:
+  shcore::Value::Array_type_ref _columns;
+  shcore::Value::Array_type_ref _rows;
+};
+
+// Gives access to the formatting of the records, the rest of the dumper
+// fetches them from a live result
+class Bench_dumper : public ResultsetDumper {
+public:
+  Bench_dumper(std::shared_ptr<Canned_result> result, shcore::Interpreter_delegate *output)
+    : ResultsetDumper(result, output, false), _result(result) {}
+
+  void table() { dump_table(_result->rows()); }
+  void vertical() { dump_vertical(_result->rows()); }
+  void tabbed() { dump_tabbed(_result->rows()); }
+
+private:
+  std::shared_ptr<Canned_result> _result;
+};
+
+void discard(void *, const char *) {}
+}
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+  if (iterations < 1)
+    iterations = 1;
+
+  if (argc > 2)
+    g_filter = argv[2];
+
+  std::cout << std::left << std::setw(40) << "case" << std::right << std::setw(14) << "median (us)"
+            << std::setw(14) << "min (us)" << "\n";
+
+  // Statement splitting, on a script of 5000 statements with comments,
+  // quoted delimiters and a delimiter change
+  std::string script;
+  for (int index = 0; index < 5000; index++) {
+    script += "-- statement " + std::to_string(index) + "\n";
+    script += "insert into t values (" + std::to_string(index) + ", 'a;b', \"c\\\"d\", `e;f`);\n";
+  }
+  script += "delimiter $$\ncreate procedure p() begin select 1; select 2; end$$\ndelimiter ;\n";
+
+  run("split 5000 statements", iterations, [&script]() {
+    shcore::mysql::splitter::Delimiters delimiters({ ";", "\\G", "\\g" });
+    std::stack<std::string> context;
+    shcore::mysql::splitter::determineStatementRanges(script.data(), script.size(), delimiters, "\n", context);
+  });
+
+  // The same on the output of mysqldump: version comments, table
+  // definitions and long extended inserts, about 5MB
+  std::string dump = "-- MySQL dump 10.13  Distrib 5.7.19, for Linux (x86_64)\n--\n-- Host: localhost    Database: test\n"
+                     "-- ------------------------------------------------------\n"
+                     "/*!40101 SET @OLD_CHARACTER_SET_CLIENT=@@CHARACTER_SET_CLIENT */;\n"
+                     "/*!40101 SET NAMES utf8 */;\n/*!40014 SET @OLD_UNIQUE_CHECKS=@@UNIQUE_CHECKS, UNIQUE_CHECKS=0 */;\n";
+  for (int table = 0; table < 20; table++) {
+    std::string name = "`t" + std::to_string(table) + "`";
+    dump += "\n--\n-- Table structure for table " + name + "\n--\n\nDROP TABLE IF EXISTS " + name + ";\n"
+            "/*!40101 SET @saved_cs_client     = @@character_set_client */;\n"
+            "CREATE TABLE " + name + " (\n  `id` int(11) NOT NULL AUTO_INCREMENT,\n  `name` varchar(64) DEFAULT NULL,\n"
+            "  `notes` text,\n  PRIMARY KEY (`id`)\n) ENGINE=InnoDB DEFAULT CHARSET=utf8;\n"
+            "/*!40101 SET character_set_client = @saved_cs_client */;\n\n"
+            "LOCK TABLES " + name + " WRITE;\n/*!40000 ALTER TABLE " + name + " DISABLE KEYS */;\n";
+    for (int statement = 0; statement < 20; statement++) {
+      dump += "INSERT INTO " + name + " VALUES ";
+      for (int row = 0; row < 100; row++) {
+        int id = statement * 100 + row;
+        dump += (row ? ",(" : "(") + std::to_string(id) + ",'name " + std::to_string(id) +
+                "','It\\'s a note of row " + std::to_string(id) +
+                " with a few words; and a line\\nbreak, as dumped by mysqldump -- not a comment')";
+      }
+      dump += ";\n";
+    }
+    dump += "/*!40000 ALTER TABLE " + name + " ENABLE KEYS */;\nUNLOCK TABLES;\n";
+  }
+  dump += "/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;\n\n-- Dump completed\n";
+
+  run("split mysqldump output", iterations, [&dump]() {
+    shcore::mysql::splitter::Delimiters delimiters({ ";", "\\G", "\\g" });
+    std::stack<std::string> context;
+    shcore::mysql::splitter::determineStatementRanges(dump.data(), dump.size(), delimiters, "\n", context);
+  });
+
+  if (const char *dump_file = std::getenv("MYSQLSH_BENCH_DUMP")) {
+    std::ifstream file(dump_file, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.empty())
+      std::cerr << "MYSQLSH_BENCH_DUMP: " << dump_file << " could not be read\n";
+
+    run("split MYSQLSH_BENCH_DUMP", iterations, [&data]() {
+      shcore::mysql::splitter::Delimiters delimiters({ ";", "\\G", "\\g" });
+      std::stack<std::string> context;
+      shcore::mysql::splitter::determineStatementRanges(data.data(), data.size(), delimiters, "\n", context);
+    });
+  }
+
+  // Values: a document of 1000 nested entries
+  shcore::Value::Map_type_ref document(new shcore::Value::Map_type());
+  for (int index = 0; index < 1000; index++) {
+    shcore::Value::Map_type_ref entry(new shcore::Value::Map_type());
+    (*entry)["id"] = shcore::Value(index);
+    (*entry)["name"] = shcore::Value("item \"" + std::to_string(index) + "\"\n");
+    (*entry)["price"] = shcore::Value(index * 1.25);
+    shcore::Value::Array_type_ref tags(new shcore::Value::Array_type());
+    tags->push_back(shcore::Value("red"));
+    tags->push_back(shcore::Value("green"));
+    (*entry)["tags"] = shcore::Value(tags);
+    (*document)["item_" + std::to_string(index)] = shcore::Value(entry);
+  }
+  shcore::Value value(document);
+  std::string json = value.json();
+  std::string repr = value.repr();
+
+  run("Value::json 1000 entries", iterations, [&value]() { value.json(); });
+  run("Value::json pretty 1000 entries", iterations, [&value]() { value.json(true); });
+  run("Value::repr 1000 entries", iterations, [&value]() { value.repr(); });
+  run("Value::parse 1000 entries", iterations, [&repr]() { shcore::Value::parse(repr); });
+  run("Value::parse_json 1000 entries", iterations, [&json]() { shcore::Value::parse_json(json); });
+
+  // Expression parser, on a filter as the CRUD operations send them
+  std::string filter = "name like :name and (age between 18 and 65 or vip = true)";
+  for (int index = 0; index < 100; index++)
+    filter += " and $.attributes.field_" + std::to_string(index) + " in (1, 2, 3, 'four')";
+
+  run("Expr_parser 100 conditions", iterations, [&filter]() {
+    std::vector<std::string> placeholders;
+    delete mysqlx::Expr_parser(filter, true, false, &placeholders).expr();
+  });
+
+  // Row decoding, on the fields of 10000 rows of a batch
+  std::mt19937_64 random(5);
+  std::vector<std::string> integers, doubles, strings;
+  for (int index = 0; index < 10000; index++) {
+    integers.push_back(encode_varint(random() >> (random() % 64)));
+
+    double number = double(random() % 1000000) / 3;
+    doubles.push_back(std::string(reinterpret_cast<const char*>(&number), sizeof(number)));
+
+    strings.push_back("value_" + std::to_string(random()) + std::string(1, '\0'));
+  }
+
+  std::vector<const std::string*> integer_pointers;
+  for (auto &buffer : integers)
+    integer_pointers.push_back(&buffer);
+
+  run("Row_decoder u64 10000 fields", iterations, [&integers]() {
+    uint64_t sum = 0;
+    for (auto &buffer : integers)
+      sum += mysqlx::Row_decoder::u64_from_buffer(buffer);
+    if (sum == 1)
+      std::cout << "";
+  });
+
+  run("Row_decoder u64 bulk 10000 fields", iterations, [&integer_pointers]() {
+    std::vector<uint64_t> result(integer_pointers.size());
+    mysqlx::Row_decoder::u64_from_buffers(&integer_pointers[0], integer_pointers.size(), &result[0]);
+  });
+
+  run("Row_decoder double 10000 fields", iterations, [&doubles]() {
+    double sum = 0;
+    for (auto &buffer : doubles)
+      sum += mysqlx::Row_decoder::double_from_buffer(buffer);
+    if (sum == 1)
+      std::cout << "";
+  });
+
+  run("Row_decoder string 10000 fields", iterations, [&strings]() {
+    size_t total = 0;
+    for (auto &buffer : strings) {
+      size_t length;
+      mysqlx::Row_decoder::string_from_buffer(buffer, length);
+      total += length;
+    }
+    if (total == 1)
+      std::cout << "";
+  });
+
+  std::vector<std::string> decimals, datetimes;
+  for (int index = 0; index < 10000; index++) {
+    // Scale 2, the BCD digits and the sign nibble
+    std::string decimal(1, '\x02');
+    for (int digit = 0; digit < 6; digit++)
+      decimal.push_back(static_cast<char>((random() % 10) << 4 | (random() % 10)));
+    decimal.push_back(static_cast<char>(0xc0));
+    decimals.push_back(decimal);
+
+    datetimes.push_back(encode_varint(2000 + random() % 30) + encode_varint(1 + random() % 12) +
+                        encode_varint(1 + random() % 28) + encode_varint(random() % 24) +
+                        encode_varint(random() % 60) + encode_varint(random() % 60));
+  }
+
+  run("Row_decoder decimal 10000 fields", iterations, [&decimals]() {
+    std::string text;
+    for (auto &buffer : decimals)
+      mysqlx::Row_decoder::decimal_from_buffer_as_str(buffer, text);
+  });
+
+  run("Row_decoder datetime 10000 fields", iterations, [&datetimes]() {
+    std::string text;
+    for (auto &buffer : datetimes) {
+      mysqlx::DateTime date = mysqlx::Row_decoder::datetime_from_buffer(buffer);
+      shcore::Date(date.year(), date.month(), date.day(), date.hour(), date.minutes(), date.seconds()).append_descr(text);
+    }
+  });
+
+  // Result formatting, of 1000 rows
+  shcore::Interpreter_delegate output;
+  output.print = &discard;
+  output.print_error = &discard;
+
+  (*shcore::Shell_core_options::get())[SHCORE_OUTPUT_FORMAT] = shcore::Value("table");
+  Bench_dumper dumper(std::make_shared<Canned_result>(1000), &output);
+
+  run("ResultsetDumper table 1000 rows", iterations, [&dumper]() { dumper.table(); });
+  run("ResultsetDumper vertical 1000 rows", iterations, [&dumper]() { dumper.vertical(); });
+  run("ResultsetDumper tabbed 1000 rows", iterations, [&dumper]() { dumper.tabbed(); });
+
+#ifdef HAVE_V8
+  {
+    shcore::Object_registry registry;
+    shcore::JScript_context js(&registry, &output);
+
+    v8::Isolate::Scope isolate_scope(js.isolate());
+    v8::HandleScope handle_scope(js.isolate());
+    v8::Context::Scope context_scope(v8::Local<v8::Context>::New(js.isolate(), js.context()));
+
+    run("JS bridging 1000 entries", iterations, [&js, &value]() {
+      v8::HandleScope scope(js.isolate());
+      js.v8_value_to_shcore_value(js.shcore_value_to_v8_value(value));
+    });
+  }
+#endif
+
+#ifdef HAVE_PYTHON
+  {
+    shcore::Python_context py(&output);
+    WillEnterPython lock;
+
+    run("Python bridging 1000 entries", iterations, [&py, &value]() {
+      PyObject *object = py.shcore_value_to_pyobj(value);
+      py.pyobj_to_shcore_value(object);
+      Py_XDECREF(object);
+    });
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*
+  Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+  Measures the cold start of the shell on each mode, running it with an
+  empty statement and no connection, so the time is the whole cost of
+  starting and exiting the process.
+
+  Usage: bench_startup <path to mysqlsh> [iterations]
+*/
+
+#ifdef _WIN32
+static const char *k_null_output = " > NUL 2>&1";
+#else
+static const char *k_null_output = " > /dev/null 2>&1";
+#endif
+
+static double run_once(const std::string &command) {
+  auto start = std::chrono::steady_clock::now();
+  int status = std::system(command.c_str());
+  auto end = std::chrono::steady_clock::now();
+
+  if (status != 0)
+    return -1;
+
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <path to mysqlsh> [iterations]\n";
+    return 1;
+  }
+
+  std::string shell = std::string("\"") + argv[1] + "\"";
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+  if (iterations < 1)
+    iterations = 1;
+
+  const char *modes[] = { "--sql", "--js", "--py" };
+
+  std::cout << std::left << std::setw(8) << "mode" << std::right
+            << std::setw(12) << "min (ms)" << std::setw(12) << "median (ms)" << std::setw(12) << "max (ms)" << "\n";
+
+  for (auto mode : modes) {
+    std::string command = shell + " " + mode + " -e \"\"" + k_null_output;
+
+    // The first run warms up the file system cache, it is not accounted
+    if (run_once(command) < 0) {
+      std::cout << std::left << std::setw(8) << mode << "  not supported\n";
+      continue;
+    }
+
+    std::vector<double> times;
+    for (int index = 0; index < iterations; index++)
+      times.push_back(run_once(command));
+
+    std::sort(times.begin(), times.end());
+
+    std::cout << std::left << std::setw(8) << mode << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << times.front() << std::setw(12) << times[times.size() / 2]
+              << std::setw(12) << times.back() << "\n";
+  }
+
+  return 0;
+}
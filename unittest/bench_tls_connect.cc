@@ -0,0 +1,97 @@
+/*
+  Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../mysqlxtest/mysqlx.h"
+#include "../mysqlxtest/mysqlx_connection.h"
+#include "../mysqlxtest/myasio/tls_session_cache.h"
+
+/*
+  Measures the time to open and close an X protocol session over TLS, with
+  full handshakes on every connection and with the TLS session of the
+  previous connection resumed. The server is the one of the test suite,
+  given by MYSQL_URI, MYSQLX_PORT and MYSQL_PWD.
+
+  Usage: bench_tls_connect [iterations]
+*/
+
+static bool measure(const std::string &uri, const std::string &password, int iterations,
+                    bool resume, std::vector<double> &times) {
+  ngs::Tls_session_cache::instance().set_enabled(resume);
+
+  mysqlx::Ssl_config ssl_config;
+  ssl_config.mode = SSL_MODE_REQUIRED;
+
+  try {
+    // The first connection does the full handshake in both cases
+    mysqlx::openSession(uri, password, ssl_config, false, 10000)->close();
+
+    for (int index = 0; index < iterations; index++) {
+      auto start = std::chrono::steady_clock::now();
+      mysqlx::openSession(uri, password, ssl_config, false, 10000)->close();
+      auto end = std::chrono::steady_clock::now();
+
+      times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+  } catch (std::exception &e) {
+    std::cerr << "Error connecting to " << uri << ": " << e.what() << "\n";
+    return false;
+  }
+
+  std::sort(times.begin(), times.end());
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *uri = std::getenv("MYSQL_URI");
+  const char *xport = std::getenv("MYSQLX_PORT");
+  const char *pwd = std::getenv("MYSQL_PWD");
+
+  if (!uri) {
+    std::cerr << "The MYSQL_URI, MYSQLX_PORT and MYSQL_PWD environment variables must be set\n";
+    return 1;
+  }
+
+  std::string xuri = std::string(uri) + ":" + (xport ? xport : "33060");
+  std::string password(pwd ? pwd : "");
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+  if (iterations < 1)
+    iterations = 1;
+
+  std::cout << std::left << std::setw(20) << "handshake" << std::right
+            << std::setw(12) << "min (ms)" << std::setw(12) << "median (ms)" << std::setw(12) << "max (ms)" << "\n";
+
+  for (int resume = 0; resume < 2; resume++) {
+    std::vector<double> times;
+    if (!measure(xuri, password, iterations, resume != 0, times))
+      return 1;
+
+    std::cout << std::left << std::setw(20) << (resume ? "resumed" : "full") << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << times.front() << std::setw(12) << times[times.size() / 2]
+              << std::setw(12) << times.back() << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,256 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+
+#if defined(HAVE_IO_URING)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "myasio/connection_factory_uring.h"
+#include "myasio/connection_uring.h"
+
+namespace ngs {
+// A Connection_uring to a socket listening on the loopback interface, the
+// test plays the server on the accepted socket
+class Connection_uring_test : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    _listener = -1;
+    _peer = -1;
+
+    // The kernel of the build machine may not provide io_uring
+    if (!Connection_uring_factory::is_supported())
+      return;
+
+    _listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, _listener);
+
+    sockaddr_in address = sockaddr_in();
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(0, ::bind(_listener, reinterpret_cast<sockaddr*>(&address), length));
+    ASSERT_EQ(0, ::listen(_listener, 1));
+    ASSERT_EQ(0, ::getsockname(_listener, reinterpret_cast<sockaddr*>(&address), &length));
+
+    _connection.reset(new Connection_uring(_service));
+
+    boost::system::error_code connected = boost::asio::error::not_connected;
+    _connection->async_connect(Endpoint(boost::asio::ip::address_v4::loopback(), ntohs(address.sin_port)),
+                               [&connected](const boost::system::error_code &error) { connected = error; },
+                               On_asio_status_callback());
+    run();
+    ASSERT_FALSE(connected) << connected.message();
+
+    _peer = ::accept(_listener, NULL, NULL);
+    ASSERT_LE(0, _peer);
+  }
+
+  virtual void TearDown() {
+    _connection.reset();
+
+    if (_peer >= 0)
+      ::close(_peer);
+    if (_listener >= 0)
+      ::close(_listener);
+  }
+
+  bool supported() const {
+    return _listener >= 0;
+  }
+
+  void run() {
+    _service.reset();
+    _service.run();
+  }
+
+  // Writes all the data, the connection may take it in several calls
+  boost::system::error_code write(const std::string &data) {
+    boost::system::error_code ret_val;
+    std::size_t offset = 0;
+
+    while (!ret_val && offset < data.size()) {
+      Const_buffer_sequence buffers(1, boost::asio::buffer(data.data() + offset, data.size() - offset));
+      _connection->async_write(buffers, [&ret_val, &offset](const boost::system::error_code &error, std::size_t size) {
+        ret_val = error;
+        offset += size;
+      });
+      run();
+    }
+
+    return ret_val;
+  }
+
+  // A single read of at most size bytes
+  boost::system::error_code read(std::size_t size, std::string *data) {
+    boost::system::error_code ret_val;
+    std::string buffer(size, '\0');
+
+    Mutable_buffer_sequence buffers(1, boost::asio::buffer(&buffer[0], size));
+    _connection->async_read(buffers, [&](const boost::system::error_code &error, std::size_t received) {
+      ret_val = error;
+      data->assign(buffer.data(), received);
+    });
+    run();
+
+    return ret_val;
+  }
+
+  // Reads from the server side until the connection shuts its side down
+  std::string peer_read_all() {
+    std::string ret_val;
+    char buffer[4096];
+    ssize_t received;
+
+    while ((received = ::recv(_peer, buffer, sizeof(buffer), 0)) > 0)
+      ret_val.append(buffer, received);
+
+    return ret_val;
+  }
+
+  void peer_send(const std::string &data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), ::send(_peer, data.data(), data.size(), 0));
+  }
+
+  boost::asio::io_service _service;
+  std::unique_ptr<Connection_uring> _connection;
+  int _listener;
+  int _peer;
+};
+
+TEST_F(Connection_uring_test, send) {
+  if (!supported())
+    return;
+
+  // Larger than the write page, so it is sent in several parts
+  std::string data;
+  for (int index = 0; data.size() < 200 * 1024; index++)
+    data += std::to_string(index) + ",";
+
+  std::string received;
+  std::thread reader([this, &received]() { received = peer_read_all(); });
+
+  boost::system::error_code error = write(data);
+  boost::system::error_code shutdown_error;
+  _connection->shutdown(boost::asio::socket_base::shutdown_send, shutdown_error);
+  reader.join();
+
+  EXPECT_FALSE(error) << error.message();
+  EXPECT_FALSE(shutdown_error) << shutdown_error.message();
+  EXPECT_EQ(data, received);
+}
+
+TEST_F(Connection_uring_test, request_and_response) {
+  if (!supported())
+    return;
+
+  // The request waits in the write page, it goes out with the read
+  ASSERT_FALSE(write("ping"));
+
+  std::thread server([this]() {
+    char buffer[4];
+    ssize_t received = 0;
+    while (received < 4) {
+      ssize_t size = ::recv(_peer, buffer + received, sizeof(buffer) - received, 0);
+      if (size <= 0)
+        return;
+      received += size;
+    }
+    if (std::string(buffer, 4) == "ping")
+      peer_send("pong");
+  });
+
+  std::string data;
+  boost::system::error_code error = read(16, &data);
+  server.join();
+
+  EXPECT_FALSE(error) << error.message();
+  EXPECT_EQ("pong", data);
+}
+
+TEST_F(Connection_uring_test, receive) {
+  if (!supported())
+    return;
+
+  peer_send("response");
+
+  std::string data;
+  EXPECT_FALSE(read(8, &data));
+  EXPECT_EQ("response", data);
+}
+
+TEST_F(Connection_uring_test, partial_reads) {
+  if (!supported())
+    return;
+
+  peer_send("abcdef");
+
+  // The read takes no more than the buffer, the rest stays for the next one
+  std::string data;
+  EXPECT_FALSE(read(4, &data));
+  EXPECT_EQ("abcd", data);
+
+  // The read returns what is there, without waiting for the buffer to fill
+  EXPECT_FALSE(read(16, &data));
+  EXPECT_EQ("ef", data);
+
+  peer_send("g");
+  EXPECT_FALSE(read(16, &data));
+  EXPECT_EQ("g", data);
+}
+
+TEST_F(Connection_uring_test, closed_by_peer) {
+  if (!supported())
+    return;
+
+  peer_send("last");
+  ::close(_peer);
+  _peer = -1;
+
+  std::string data;
+  EXPECT_FALSE(read(16, &data));
+  EXPECT_EQ("last", data);
+
+  EXPECT_EQ(boost::asio::error::eof, read(16, &data));
+  EXPECT_EQ("", data);
+}
+
+TEST_F(Connection_uring_test, close) {
+  if (!supported())
+    return;
+
+  // The pending writes are flushed before the socket is closed
+  ASSERT_FALSE(write("bye"));
+  _connection->close();
+  EXPECT_EQ(-1, _connection->get_socket_id());
+  EXPECT_EQ("bye", peer_read_all());
+
+  std::string data;
+  EXPECT_TRUE(read(16, &data));
+  EXPECT_TRUE(write("more"));
+}
+}
+
+#endif  // defined(HAVE_IO_URING)
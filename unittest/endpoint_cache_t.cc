@@ -0,0 +1,78 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "modules/endpoint_cache.h"
+#include "utils/utils_file.h"
+
+namespace mysqlsh {
+TEST(Endpoint_cache, validate) {
+  Endpoint_cache *cache = Endpoint_cache::get();
+  cache->set_path("");
+  Endpoint_info info;
+
+  // Nothing is kept until the server is known
+  cache->set_auth_method("db:33060", "root", "PLAIN");
+  EXPECT_FALSE(cache->find("db:33060", &info));
+
+  EXPECT_FALSE(cache->validate("db:33060", "uuid-1", "5.7.19"));
+  cache->set_capabilities("db:33060", std::string("\x0a\x00\xff", 3));
+  cache->set_auth_method("db:33060", "root", "PLAIN");
+  EXPECT_TRUE(cache->validate("db:33060", "uuid-1", "5.7.19"));
+
+  ASSERT_TRUE(cache->find("db:33060", &info));
+  EXPECT_EQ(std::string("\x0a\x00\xff", 3), info.capabilities);
+  EXPECT_EQ("PLAIN", info.auth_methods["root"]);
+
+  // Another server on the endpoint, or the same one upgraded, starts over
+  EXPECT_FALSE(cache->validate("db:33060", "uuid-1", "5.7.20"));
+  ASSERT_TRUE(cache->find("db:33060", &info));
+  EXPECT_TRUE(info.capabilities.empty());
+  EXPECT_TRUE(info.auth_methods.empty());
+
+  cache->forget("db:33060");
+  EXPECT_FALSE(cache->find("db:33060", &info));
+}
+
+TEST(Endpoint_cache, persistence) {
+  std::string path = shcore::get_binary_folder() + "/endpoint_cache_test.json";
+  std::remove(path.c_str());
+
+  Endpoint_cache *cache = Endpoint_cache::get();
+  cache->set_path(path);
+  cache->validate("db:33060", "uuid-1", "8.0.3");
+  cache->set_capabilities("db:33060", std::string("\x01\x02\xab", 3));
+  cache->set_auth_method("db:33060", "admin", "MYSQL41");
+
+  // Loaded again from the file
+  cache->set_path(path);
+  Endpoint_info info;
+  ASSERT_TRUE(cache->find("db:33060", &info));
+  EXPECT_EQ("uuid-1", info.server_uuid);
+  EXPECT_EQ("8.0.3", info.version);
+  EXPECT_EQ(std::string("\x01\x02\xab", 3), info.capabilities);
+  EXPECT_EQ("MYSQL41", info.auth_methods["admin"]);
+
+  cache->set_path("");
+  std::remove(path.c_str());
+}
+}
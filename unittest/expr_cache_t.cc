@@ -0,0 +1,98 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "../mysqlxtest/common/expr_cache.h"
+
+#include "mysqlx_expr.pb.h"
+
+using namespace mysqlx;
+
+namespace shcore {
+namespace expr_cache_tests {
+std::string parse(Expr_cache &cache, const std::string &source, bool document_mode,
+                  std::vector<std::string> *placeholders) {
+  std::unique_ptr<Mysqlx::Expr::Expr> expr(cache.parse_filter(source, document_mode, placeholders));
+  return Expr_unparser::expr_to_string(*expr);
+}
+
+TEST(Expr_cache, reuses_parsed_expressions) {
+  Expr_cache cache;
+  std::vector<std::string> placeholders;
+
+  std::string parsed = parse(cache, "name = :name and age > :age", true, &placeholders);
+  EXPECT_EQ(1u, cache.misses());
+  EXPECT_EQ(1u, cache.size());
+
+  std::vector<std::string> expected = { "name", "age" };
+  EXPECT_EQ(expected, placeholders);
+
+  // The copy returned from the cache is the same expression
+  std::vector<std::string> second;
+  EXPECT_EQ(parsed, parse(cache, "name = :name and age > :age", true, &second));
+  EXPECT_EQ(1u, cache.hits());
+  EXPECT_EQ(expected, second);
+
+  // Table mode is a different expression
+  std::vector<std::string> table;
+  parse(cache, "name = :name and age > :age", false, &table);
+  EXPECT_EQ(2u, cache.misses());
+  EXPECT_EQ(2u, cache.size());
+}
+
+TEST(Expr_cache, bypassed_with_previous_placeholders) {
+  Expr_cache cache;
+
+  // The placeholder positions follow the ones already there
+  std::vector<std::string> placeholders = { "x" };
+  EXPECT_EQ("(a == :1)", parse(cache, "a = :a", false, &placeholders));
+
+  std::vector<std::string> expected = { "x", "a" };
+  EXPECT_EQ(expected, placeholders);
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.hits());
+}
+
+TEST(Expr_cache, evicts_least_recently_used) {
+  Expr_cache cache(2);
+  std::vector<std::string> placeholders;
+
+  parse(cache, "a = 1", false, &placeholders);
+  parse(cache, "b = 1", false, &placeholders);
+  parse(cache, "a = 1", false, &placeholders);
+  parse(cache, "c = 1", false, &placeholders);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(1u, cache.hits());
+
+  // b was evicted, a was used more recently
+  parse(cache, "a = 1", false, &placeholders);
+  EXPECT_EQ(2u, cache.hits());
+  parse(cache, "b = 1", false, &placeholders);
+  EXPECT_EQ(2u, cache.hits());
+}
+
+TEST(Expr_cache, errors_are_not_cached) {
+  Expr_cache cache;
+  std::vector<std::string> placeholders;
+
+  EXPECT_ANY_THROW(parse(cache, "a = ", false, &placeholders));
+  EXPECT_EQ(0u, cache.size());
+}
+}
+}
@@ -228,6 +228,10 @@ TEST(Expr_parser_tests, x_test_5) {
     "[19, 25, 79, 76]", "(name == :0)");
   parse_and_assert_expr(":1 > now() + interval (2 + :x) MiNuTe",
     "[79, 76, 27, 19, 6, 7, 36, 16, 6, 76, 36, 79, 19, 7, 46]", "(:0 > (now() + INTERVAL (2 + :1) MiNuTe))");
+  parse_and_assert_expr("_id in :ids",
+    "[19, 14, 79, 19]", "_id IN (:0)");
+  parse_and_assert_expr("_id not in :ids",
+    "[19, 1, 14, 79, 19]", "NOT ( _id IN (:0))");
 }
 
 TEST(Expr_parser_tests, arrow_operator) {
@@ -242,6 +246,7 @@ TEST(Expr_parser_tests, x_test_6) {
   parse_and_assert_expr("count(*)", "[19, 6, 38, 7]", "count(*)");
   parse_and_assert_expr("[]", "[8, 9]", "[  ]");
   parse_and_assert_expr("[\"item1\", \"item2\", \"item3\"]", "[8, 20, 24, 20, 24, 20, 9]", "[ \"item1\", \"item2\", \"item3\" ]");
+  parse_and_assert_expr("[1, [2, 3]]", "[8, 76, 24, 8, 76, 24, 76, 9, 9]", "[ 1, [ 2, 3 ] ]");
 
   parse_and_assert_expr("$.geography.Region = :geo and $.geography.SurfaceArea = :area", "[77, 22, 19, 22, 19, 25, 79, 19, 2, 77, 22, 19, 22, 19, 25, 79, 19]", "(($.geography.Region == :0) && ($.geography.SurfaceArea == :1))", true);
   parse_and_assert_expr("geography.Region = :geo and geography.SurfaceArea = :area", "[19, 22, 19, 25, 79, 19, 2, 19, 22, 19, 25, 79, 19]", "(($.geography.Region == :0) && ($.geography.SurfaceArea == :1))", true);
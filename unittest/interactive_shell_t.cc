@@ -142,6 +142,52 @@ TEST_F(Interactive_shell_test, shell_command_connect_classic) {
   output_handler.wipe_all();
 }
 
+TEST_F(Interactive_shell_test, js_load_sql_parallel) {
+  create_file("load_sql_parallel.sql",
+              "DROP SCHEMA IF EXISTS load_sql_parallel;\n"
+              "CREATE SCHEMA load_sql_parallel;\n"
+              "USE load_sql_parallel;\n"
+              "CREATE TABLE t (id INT PRIMARY KEY);\n"
+              "/*!40101 SET @saved_id = 1 */;\n"
+              "LOCK TABLES t WRITE;\n"
+              "INSERT INTO t VALUES (1);\n"
+              "INSERT INTO t VALUES (2);\n"
+              "INSERT INTO t VALUES (3);\n"
+              "INSERT INTO t VALUES (4);\n"
+              "INSERT INTO t VALUES (5);\n"
+              "INSERT INTO t VALUES (6);\n"
+              "UNLOCK TABLES;\n"
+              "USE load_sql_parallel_missing;\n"
+              "INSERT INTO t VALUES (7);\n"
+              "INSERT INTO t VALUES (1);\n");
+
+  execute("\\connect -c " + _mysql_uri);
+  output_handler.wipe_all();
+
+  // The failed USE fails on every session, it is reported once and all the
+  // sessions keep loading on the schema set before
+  execute("var result = shell.loadSqlParallel('load_sql_parallel.sql', {threads: 3});");
+  execute("print(result.executed, result.errors.length)");
+  MY_EXPECT_STDOUT_CONTAINS("12 2");
+  output_handler.wipe_all();
+
+  execute("print(result.errors[0])");
+  MY_EXPECT_STDOUT_CONTAINS("Statement #14: ");
+  output_handler.wipe_all();
+
+  execute("print(result.errors[1])");
+  MY_EXPECT_STDOUT_CONTAINS("Statement #16: ");
+  output_handler.wipe_all();
+
+  execute("print(session.runSql('select count(*) from load_sql_parallel.t').fetchOne()[0])");
+  MY_EXPECT_STDOUT_CONTAINS("7");
+  output_handler.wipe_all();
+
+  execute("session.runSql('drop schema load_sql_parallel')");
+  execute("session.close()");
+  std::remove("load_sql_parallel.sql");
+}
+
 TEST_F(Interactive_shell_test, shell_command_connect_auto) {
   // Session type determined from connection success
   {
@@ -384,6 +430,36 @@ TEST_F(Interactive_shell_test, shell_command_no_warnings) {
   output_handler.wipe_all();
 }
 
+TEST_F(Interactive_shell_test, shell_command_stats) {
+  execute("\\connect -c " + _mysql_uri);
+  execute("\\stats reset");
+  output_handler.wipe_all();
+
+  execute("session.runSql('select 1 /* first */').fetchAll()");
+  execute("session.runSql('select  2').fetchAll()");
+  output_handler.wipe_all();
+
+  // Both statements share the digest
+  execute("\\stats reset");
+  MY_EXPECT_STDOUT_CONTAINS("\"select ?\": {");
+  MY_EXPECT_STDOUT_CONTAINS("\"count\": 2");
+  MY_EXPECT_STDOUT_CONTAINS("\"server\": {");
+  MY_EXPECT_STDOUT_CONTAINS("\"network\": {");
+  MY_EXPECT_STDOUT_CONTAINS("\"decode\": {");
+  MY_EXPECT_STDOUT_CONTAINS("\"format\": {");
+  output_handler.wipe_all();
+
+  execute("\\stats");
+  EXPECT_STREQ("{}\n", output_handler.std_out.c_str());
+  output_handler.wipe_all();
+
+  execute("\\stats all");
+  MY_EXPECT_STDERR_CONTAINS("\\stats [reset]");
+  output_handler.wipe_all();
+
+  execute("session.close()");
+}
+
 TEST_F(Interactive_shell_test, shell_command_help_js) {
   // Cleanup for the test
   execute("\\?");
@@ -400,6 +476,7 @@ TEST_F(Interactive_shell_test, shell_command_help_js) {
   MY_EXPECT_STDOUT_CONTAINS("\\nowarnings (\\w)       Don't show warnings after every statement.");
   MY_EXPECT_STDOUT_CONTAINS("\\status     (\\s)       Print information about the current global connection.");
   MY_EXPECT_STDOUT_CONTAINS("\\use        (\\u)       Set the current schema for the global session.");
+  MY_EXPECT_STDOUT_CONTAINS("\\stats                 Print the latency statistics of the executed statements.");
   MY_EXPECT_STDOUT_CONTAINS("For help on a specific command use the command as \\? <command>");
 
   execute("\\help \\source");
@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/member_latency.h"
+
+namespace mysqlsh {
+TEST(Member_latency, smoothing) {
+  Member_latency *latencies = Member_latency::get();
+  double seconds = 0;
+  bool fresh = false;
+
+  EXPECT_FALSE(latencies->latency("smoothing:3306", &seconds));
+
+  latencies->record("smoothing:3306", std::chrono::milliseconds(100));
+  EXPECT_TRUE(latencies->latency("smoothing:3306", &seconds, &fresh));
+  EXPECT_DOUBLE_EQ(0.1, seconds);
+  EXPECT_TRUE(fresh);
+
+  // A single slow reply moves the time by a quarter of the difference
+  latencies->record("smoothing:3306", std::chrono::milliseconds(500));
+  EXPECT_TRUE(latencies->latency("smoothing:3306", &seconds));
+  EXPECT_DOUBLE_EQ(0.2, seconds);
+
+  // After a failure the next sample starts over
+  latencies->record_failure("smoothing:3306");
+  EXPECT_FALSE(latencies->latency("smoothing:3306", &seconds));
+  latencies->record("smoothing:3306", std::chrono::milliseconds(10));
+  EXPECT_TRUE(latencies->latency("smoothing:3306", &seconds));
+  EXPECT_DOUBLE_EQ(0.01, seconds);
+}
+
+TEST(Member_latency, sort) {
+  Member_latency *latencies = Member_latency::get();
+  latencies->record("far:3306", std::chrono::milliseconds(150));
+  latencies->record("near:3306", std::chrono::milliseconds(2));
+  latencies->record("down:3306", std::chrono::milliseconds(1));
+  latencies->record_failure("down:3306");
+
+  // The members with no time keep the order of the metadata after the rest
+  std::vector<std::string> addresses = { "down:3306", "unknown:3306", "far:3306", "other:3306", "near:3306" };
+  latencies->sort(addresses);
+  EXPECT_EQ((std::vector<std::string>{ "near:3306", "far:3306", "down:3306", "unknown:3306", "other:3306" }),
+            addresses);
+}
+}
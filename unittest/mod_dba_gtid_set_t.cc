@@ -0,0 +1,89 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "modules/adminapi/mod_dba_gtid_set.h"
+#include "shellcore/types.h"
+
+namespace mysqlsh {
+namespace dba {
+namespace {
+const std::string uuid1 = "8a94f357-aab4-11df-86ab-c80aa9429562";
+const std::string uuid2 = "b9d6b66e-0a3f-11e7-9c5f-080027d03a57";
+}
+
+TEST(Gtid_set, parse) {
+  EXPECT_TRUE(Gtid_set("").empty());
+  EXPECT_EQ("", Gtid_set("").str());
+
+  // Intervals are sorted and merged, uuids lower cased
+  Gtid_set set(" B9D6B66E-0A3F-11E7-9C5F-080027D03A57:7:1-3:4-5,\n" + uuid1 + ":10-20:15-30");
+  EXPECT_EQ(uuid1 + ":10-30,\n" + uuid2 + ":1-5:7", set.str());
+  EXPECT_EQ(27u, set.count());
+
+  EXPECT_THROW(Gtid_set("abc:1"), shcore::Exception);
+  EXPECT_THROW(Gtid_set set(uuid1), shcore::Exception);
+  EXPECT_THROW(Gtid_set(uuid1 + ":"), shcore::Exception);
+  EXPECT_THROW(Gtid_set(uuid1 + ":0"), shcore::Exception);
+  EXPECT_THROW(Gtid_set(uuid1 + ":5-3"), shcore::Exception);
+  EXPECT_THROW(Gtid_set(uuid1 + ":1-x"), shcore::Exception);
+  EXPECT_THROW(Gtid_set("," + uuid1 + ":1"), shcore::Exception);
+}
+
+TEST(Gtid_set, is_subset_of) {
+  Gtid_set set(uuid1 + ":1-100:200-300," + uuid2 + ":1-10");
+
+  EXPECT_TRUE(Gtid_set().is_subset_of(set));
+  EXPECT_TRUE(set.is_subset_of(set));
+  EXPECT_TRUE(Gtid_set(uuid1 + ":5-10:100:250").is_subset_of(set));
+  EXPECT_TRUE(Gtid_set(uuid2 + ":10").is_subset_of(set));
+
+  EXPECT_FALSE(set.is_subset_of(Gtid_set()));
+  EXPECT_FALSE(Gtid_set(uuid1 + ":100-200").is_subset_of(set));
+  EXPECT_FALSE(Gtid_set(uuid1 + ":301").is_subset_of(set));
+  EXPECT_FALSE(Gtid_set(uuid2 + ":1-11").is_subset_of(set));
+  EXPECT_FALSE(Gtid_set("00000000-0000-0000-0000-000000000000:1").is_subset_of(set));
+}
+
+TEST(Gtid_set, add) {
+  Gtid_set set(uuid1 + ":1-10:20");
+  set.add(Gtid_set(uuid1 + ":11-19:30," + uuid2 + ":5"));
+
+  EXPECT_EQ(uuid1 + ":1-20:30,\n" + uuid2 + ":5", set.str());
+  EXPECT_EQ(22u, set.count());
+}
+
+TEST(Gtid_set, subtract) {
+  Gtid_set set(uuid1 + ":1-100," + uuid2 + ":1-10");
+  set.subtract(Gtid_set(uuid1 + ":1-5:10:50-60:100-200," + uuid2 + ":1-10"));
+
+  EXPECT_EQ(uuid1 + ":6-9:11-49:61-99", set.str());
+  EXPECT_EQ(82u, set.count());
+
+  EXPECT_TRUE(set.subtract(set).empty());
+
+  // Subtracting a subset leaves nothing, as GTID_SUBTRACT
+  Gtid_set purged(uuid1 + ":1-50");
+  EXPECT_TRUE(Gtid_set(purged).subtract(Gtid_set(uuid1 + ":1-60")).empty());
+  EXPECT_EQ(Gtid_set(uuid1 + ":41-50"), Gtid_set(purged).subtract(Gtid_set(uuid1 + ":1-40")));
+}
+}
+}
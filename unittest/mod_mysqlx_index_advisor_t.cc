@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/mod_mysqlx_index_advisor.h"
+
+namespace mysqlsh {
+namespace mysqlx {
+static std::string fields_text(const std::vector<Index_advisor::Field> &fields) {
+  std::string text;
+  for (auto &field : fields)
+    text += (text.empty() ? "" : ", ") + field.path + " " + field.usage + " " + field.type;
+  return text;
+}
+
+TEST(mod_mysqlx_index_advisor, index_fields) {
+  std::vector<std::string> no_sort;
+
+  EXPECT_EQ("", fields_text(Index_advisor::index_fields("", no_sort)));
+  EXPECT_EQ("$.name equality TEXT(64)", fields_text(Index_advisor::index_fields("name = 'x'", no_sort)));
+  EXPECT_EQ("$.age range INTEGER", fields_text(Index_advisor::index_fields("18 < age", no_sort)));
+
+  // Equalities first, then the sort, then a single range
+  EXPECT_EQ("$.country equality TEXT(64), $.name sort TEXT(64), $.age range DOUBLE",
+            fields_text(Index_advisor::index_fields("age > 1.5 and country = :country and height < 2",
+                                                    std::vector<std::string>{"name desc"})));
+
+  // Placeholders give no type, the path is taken as text
+  EXPECT_EQ("$.address.city equality TEXT(64)",
+            fields_text(Index_advisor::index_fields("address.city in (:a, :b)", no_sort)));
+
+  // Nothing under OR can be served by a single index
+  EXPECT_EQ("", fields_text(Index_advisor::index_fields("name = 'a' or age = 1", no_sort)));
+
+  // Only the patterns with a fixed prefix seek on the index
+  EXPECT_EQ("$.name range TEXT(64)", fields_text(Index_advisor::index_fields("name like 'ab%'", no_sort)));
+  EXPECT_EQ("", fields_text(Index_advisor::index_fields("name like '%ab'", no_sort)));
+
+  // Paths with wildcards are not indexable
+  EXPECT_EQ("", fields_text(Index_advisor::index_fields("tags.* = 'a'", no_sort)));
+}
+
+TEST(mod_mysqlx_index_advisor, generated_column_path) {
+  EXPECT_EQ("$._id", Index_advisor::generated_column_path("json_unquote(json_extract(`doc`,_utf8mb4'$._id'))"));
+  EXPECT_EQ("$.age", Index_advisor::generated_column_path("json_extract(`doc`,_utf8mb4'$.age')"));
+  EXPECT_EQ("", Index_advisor::generated_column_path(""));
+  EXPECT_EQ("", Index_advisor::generated_column_path("concat(json_extract(`doc`,'$.a'),json_extract(`doc`,'$.b'))"));
+}
+
+TEST(mod_mysqlx_index_advisor, create_index_call) {
+  std::vector<Index_advisor::Field> fields(2);
+  fields[0].path = "$.address.city";
+  fields[0].type = "TEXT(64)";
+  fields[1].path = "$.age";
+  fields[1].type = "INTEGER";
+
+  EXPECT_EQ("session.getSchema('test').getCollection('people').createIndex('ix_address_city_age')"
+            ".field('$.address.city', 'TEXT(64)', false).field('$.age', 'INTEGER', false).execute()",
+            Index_advisor::create_index_call("test", "people", fields));
+}
+}
+}
@@ -0,0 +1,97 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "modules/mod_mysqlx_resultset.h"
+
+namespace mysqlsh {
+namespace mysqlx {
+TEST(mod_mysqlx_resultset, parse_batch_options) {
+  size_t size = 0;
+  bool by_column = true;
+
+  // Without options the defaults are used
+  shcore::Argument_list args;
+  parse_batch_options(args, 0, &size, &by_column);
+  EXPECT_EQ(4096u, size);
+  EXPECT_FALSE(by_column);
+
+  // The options are read from the given index only
+  shcore::Value::Map_type_ref options(new shcore::Value::Map_type());
+  (*options)["size"] = shcore::Value(3);
+  (*options)["format"] = shcore::Value("columns");
+  args.push_back(shcore::Value("callback"));
+  args.push_back(shcore::Value(options));
+  parse_batch_options(args, 1, &size, &by_column);
+  EXPECT_EQ(3u, size);
+  EXPECT_TRUE(by_column);
+
+  parse_batch_options(args, 2, &size, &by_column);
+  EXPECT_EQ(4096u, size);
+  EXPECT_FALSE(by_column);
+
+  // Each option is optional
+  (*options).erase("size");
+  parse_batch_options(args, 1, &size, &by_column);
+  EXPECT_EQ(4096u, size);
+  EXPECT_TRUE(by_column);
+
+  (*options)["size"] = shcore::Value(1);
+  (*options)["format"] = shcore::Value("rows");
+  parse_batch_options(args, 1, &size, &by_column);
+  EXPECT_EQ(1u, size);
+  EXPECT_FALSE(by_column);
+}
+
+TEST(mod_mysqlx_resultset, parse_batch_options_invalid) {
+  auto invalid = [](const std::string &key, const shcore::Value &value, const std::string &error) {
+    shcore::Value::Map_type_ref options(new shcore::Value::Map_type());
+    (*options)[key] = value;
+    shcore::Argument_list args;
+    args.push_back(shcore::Value(options));
+
+    size_t size;
+    bool by_column;
+    try {
+      parse_batch_options(args, 0, &size, &by_column);
+      ADD_FAILURE() << key << " was accepted";
+    } catch (shcore::Exception &e) {
+      EXPECT_NE(std::string::npos, std::string(e.what()).find(error)) << e.what();
+    }
+  };
+
+  invalid("size", shcore::Value(0), "The value for 'size' must be greater than 0");
+  invalid("size", shcore::Value(-1), "is expected to be an unsigned int");
+  invalid("size", shcore::Value("10"), "is expected to be an unsigned int");
+  invalid("format", shcore::Value("table"), "The value for 'format' must be either 'rows' or 'columns'");
+  invalid("format", shcore::Value("Columns"), "The value for 'format' must be either 'rows' or 'columns'");
+  invalid("format", shcore::Value(1), "is expected to be a string");
+  invalid("rows", shcore::Value(2), "Invalid values in batch options: rows");
+
+  // The options must be a dictionary
+  shcore::Argument_list args;
+  args.push_back(shcore::Value(2));
+  size_t size;
+  bool by_column;
+  EXPECT_THROW(parse_batch_options(args, 0, &size, &by_column), shcore::Exception);
+}
+}
+}
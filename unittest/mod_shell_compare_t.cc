@@ -0,0 +1,90 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/mod_shell_compare.h"
+
+namespace mysqlsh {
+namespace compare {
+TEST(mod_shell_compare, compare_rows_equal) {
+  Row_checksums source = { {1, "100"}, {2, "200"}, {5, "500"} };
+  Row_checksums target(source);
+
+  Row_differences differences = compare_rows(source, target);
+  EXPECT_TRUE(differences.missing.empty());
+  EXPECT_TRUE(differences.extra.empty());
+  EXPECT_TRUE(differences.different.empty());
+
+  differences = compare_rows(Row_checksums(), Row_checksums());
+  EXPECT_TRUE(differences.missing.empty());
+  EXPECT_TRUE(differences.extra.empty());
+  EXPECT_TRUE(differences.different.empty());
+}
+
+TEST(mod_shell_compare, compare_rows_different) {
+  Row_checksums source = { {1, "100"}, {2, "200"}, {3, "300"} };
+  Row_checksums target = { {1, "100"}, {2, "201"}, {3, "0"} };
+
+  Row_differences differences = compare_rows(source, target);
+  EXPECT_TRUE(differences.missing.empty());
+  EXPECT_TRUE(differences.extra.empty());
+  EXPECT_EQ(std::vector<uint64_t>({2, 3}), differences.different);
+}
+
+TEST(mod_shell_compare, compare_rows_missing_on_target) {
+  Row_checksums source = { {1, "100"}, {2, "200"}, {3, "300"} };
+  Row_checksums target = { {2, "200"} };
+
+  Row_differences differences = compare_rows(source, target);
+  EXPECT_EQ(std::vector<uint64_t>({1, 3}), differences.missing);
+  EXPECT_TRUE(differences.extra.empty());
+  EXPECT_TRUE(differences.different.empty());
+
+  differences = compare_rows(source, Row_checksums());
+  EXPECT_EQ(std::vector<uint64_t>({1, 2, 3}), differences.missing);
+}
+
+TEST(mod_shell_compare, compare_rows_missing_on_source) {
+  Row_checksums source = { {2, "200"} };
+  Row_checksums target = { {1, "100"}, {2, "200"}, {4, "400"} };
+
+  Row_differences differences = compare_rows(source, target);
+  EXPECT_TRUE(differences.missing.empty());
+  EXPECT_EQ(std::vector<uint64_t>({1, 4}), differences.extra);
+  EXPECT_TRUE(differences.different.empty());
+
+  differences = compare_rows(Row_checksums(), target);
+  EXPECT_EQ(std::vector<uint64_t>({1, 2, 4}), differences.extra);
+}
+
+TEST(mod_shell_compare, compare_rows_mixed) {
+  Row_checksums source = { {1, "100"}, {2, "200"}, {3, "300"} };
+  Row_checksums target = { {2, "222"}, {3, "300"}, {9, "900"} };
+
+  Row_differences differences = compare_rows(source, target);
+  EXPECT_EQ(std::vector<uint64_t>({1}), differences.missing);
+  EXPECT_EQ(std::vector<uint64_t>({9}), differences.extra);
+  EXPECT_EQ(std::vector<uint64_t>({2}), differences.different);
+}
+}
+}
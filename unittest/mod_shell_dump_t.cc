@@ -0,0 +1,155 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/mod_shell_dump.h"
+
+namespace mysqlsh {
+namespace dump {
+TEST(mod_shell_dump, split_secondary_indexes) {
+  std::string create_table =
+    "CREATE TABLE `t1` (\n"
+    "  `id` int(11) NOT NULL AUTO_INCREMENT,\n"
+    "  `name` varchar(10) DEFAULT NULL,\n"
+    "  `body` text,\n"
+    "  PRIMARY KEY (`id`),\n"
+    "  UNIQUE KEY `name` (`name`),\n"
+    "  KEY `name_id` (`name`,`id`),\n"
+    "  FULLTEXT KEY `body` (`body`)\n"
+    ") ENGINE=InnoDB DEFAULT CHARSET=latin1";
+
+  std::string without_indexes;
+  std::vector<std::string> indexes;
+  ASSERT_TRUE(split_secondary_indexes(create_table, without_indexes, indexes));
+
+  EXPECT_EQ(
+    "CREATE TABLE `t1` (\n"
+    "  `id` int(11) NOT NULL AUTO_INCREMENT,\n"
+    "  `name` varchar(10) DEFAULT NULL,\n"
+    "  `body` text,\n"
+    "  PRIMARY KEY (`id`)\n"
+    ") ENGINE=InnoDB DEFAULT CHARSET=latin1", without_indexes);
+
+  ASSERT_EQ(3u, indexes.size());
+  EXPECT_EQ("UNIQUE KEY `name` (`name`)", indexes[0]);
+  EXPECT_EQ("KEY `name_id` (`name`,`id`)", indexes[1]);
+  EXPECT_EQ("FULLTEXT KEY `body` (`body`)", indexes[2]);
+}
+
+TEST(mod_shell_dump, split_secondary_indexes_kept) {
+  std::string without_indexes;
+  std::vector<std::string> indexes;
+
+  // The index of a foreign key must exist when the table is created
+  std::string foreign_key =
+    "CREATE TABLE `child` (\n"
+    "  `id` int(11) NOT NULL,\n"
+    "  `parent` int(11) DEFAULT NULL,\n"
+    "  PRIMARY KEY (`id`),\n"
+    "  KEY `parent` (`parent`),\n"
+    "  CONSTRAINT `child_ibfk_1` FOREIGN KEY (`parent`) REFERENCES `parent` (`id`)\n"
+    ") ENGINE=InnoDB";
+  EXPECT_FALSE(split_secondary_indexes(foreign_key, without_indexes, indexes));
+  EXPECT_EQ(foreign_key, without_indexes);
+  EXPECT_TRUE(indexes.empty());
+
+  // An AUTO_INCREMENT column needs its index
+  std::string auto_increment =
+    "CREATE TABLE `t2` (\n"
+    "  `id` int(11) NOT NULL AUTO_INCREMENT,\n"
+    "  KEY `id` (`id`)\n"
+    ") ENGINE=InnoDB";
+  EXPECT_FALSE(split_secondary_indexes(auto_increment, without_indexes, indexes));
+  EXPECT_EQ(auto_increment, without_indexes);
+}
+
+TEST(mod_shell_dump, chunk_key_ranges) {
+  typedef std::vector<std::pair<std::string, std::string> > Ranges;
+
+  EXPECT_EQ(Ranges({{"1", "4"}, {"5", "8"}, {"9", "10"}}), chunk_key_ranges("1", "10", false, 10, 4));
+  EXPECT_EQ(Ranges({{"-5", "-1"}, {"0", "4"}}), chunk_key_ranges("-5", "4", false, 10, 5));
+
+  // A chunk holds the whole table when it has fewer rows, even with the
+  // biggest chunk size
+  EXPECT_EQ(Ranges({{"1", "100"}}), chunk_key_ranges("1", "100", false, 50, 1000));
+  EXPECT_EQ(Ranges({{"1", "100"}}), chunk_key_ranges("1", "100", false, 50, UINT64_MAX));
+  EXPECT_EQ(Ranges({{"7", "7"}}), chunk_key_ranges("7", "7", false, 1, 1));
+
+  // The ranges cover every key up to the limits of the types
+  EXPECT_EQ(Ranges({{"0", "9223372036854775807"}, {"9223372036854775808", "18446744073709551615"}}),
+            chunk_key_ranges("0", "18446744073709551615", true, 2, 1));
+  EXPECT_EQ(Ranges({{"-9223372036854775808", "-1"}, {"0", "9223372036854775807"}}),
+            chunk_key_ranges("-9223372036854775808", "9223372036854775807", false, 2, 1));
+
+  // Sparse keys are split by their values, not by the rows
+  Ranges ranges = chunk_key_ranges("1", "1000000", false, 3, 1);
+  ASSERT_EQ(3u, ranges.size());
+  EXPECT_EQ("1", ranges.front().first);
+  EXPECT_EQ("1000000", ranges.back().second);
+}
+
+TEST(mod_shell_dump, parse_copy_options) {
+  Copy_options options;
+  options.threads = 4;
+  options.chunk_rows = 500000;
+
+  // The missing options keep their values
+  parse_copy_options(shcore::Value::Map_type(), options);
+  EXPECT_TRUE(options.tables.empty());
+  EXPECT_EQ(4, options.threads);
+  EXPECT_EQ(500000u, options.chunk_rows);
+
+  shcore::Value::Array_type_ref tables(new shcore::Value::Array_type());
+  tables->push_back(shcore::Value("world"));
+  tables->push_back(shcore::Value("sakila.actor"));
+
+  shcore::Value::Map_type map;
+  map["tables"] = shcore::Value(tables);
+  map["threads"] = shcore::Value(2);
+  map["chunkRows"] = shcore::Value(1000);
+  parse_copy_options(map, options);
+  EXPECT_EQ(std::vector<std::string>({"world", "sakila.actor"}), options.tables);
+  EXPECT_EQ(2, options.threads);
+  EXPECT_EQ(1000u, options.chunk_rows);
+
+  auto invalid = [options](const std::string &key, const shcore::Value &value, const std::string &error) {
+    Copy_options copy = options;
+    shcore::Value::Map_type map;
+    map[key] = value;
+    try {
+      parse_copy_options(map, copy);
+      ADD_FAILURE() << key << " was accepted";
+    } catch (shcore::Exception &e) {
+      EXPECT_NE(std::string::npos, std::string(e.what()).find(error)) << e.what();
+    }
+  };
+
+  tables->push_back(shcore::Value(1));
+  invalid("tables", shcore::Value(tables), "The tables must be a list of strings");
+  invalid("threads", shcore::Value(0), "The value for 'threads' must be a positive integer");
+  invalid("threads", shcore::Value(-1), "The value for 'threads' must be a positive integer");
+  invalid("chunkRows", shcore::Value(0), "The value for 'chunkRows' must be a positive integer");
+  invalid("chunkRows", shcore::Value(-1), "is expected to be an unsigned int");
+  invalid("chunkSize", shcore::Value(1), "Invalid values in copyTables options: chunkSize");
+}
+}
+}
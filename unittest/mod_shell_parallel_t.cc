@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/mod_shell_parallel.h"
+
+namespace mysqlsh {
+namespace parallel {
+namespace {
+Task make_task(const std::string &code, const std::vector<shcore::Value> &args = {}) {
+  Task task;
+  task.code = code;
+  task.args.reset(new shcore::Value::Array_type(args.begin(), args.end()));
+  return task;
+}
+
+// Runs the tasks, returns the error message or an empty string
+std::string run_tasks(const std::vector<Task> &tasks, int workers, shcore::Value::Array_type_ref *results) {
+  try {
+    *results = run(tasks, workers, nullptr, nullptr);
+  } catch (std::exception &e) {
+    return e.what();
+  }
+  return "";
+}
+}
+
+#ifdef HAVE_V8
+TEST(mod_shell_parallel, ordered_results) {
+  ASSERT_TRUE(is_supported());
+
+  std::vector<Task> tasks;
+  for (int index = 0; index < 20; index++)
+    tasks.push_back(make_task("function(a, b) { var s = 0; for (var i = 0; i < (20 - a) * 1000; i++) s++; "
+                              "return a * b; }", {shcore::Value(index), shcore::Value(2)}));
+
+  shcore::Value::Array_type_ref results;
+  ASSERT_EQ("", run_tasks(tasks, 4, &results));
+  ASSERT_EQ(tasks.size(), results->size());
+  for (int index = 0; index < 20; index++)
+    EXPECT_EQ(index * 2, (*results)[index].as_int());
+}
+
+TEST(mod_shell_parallel, plain_values) {
+  std::vector<Task> tasks;
+  tasks.push_back(make_task("function() { return {a: [1, 'two', {b: null}]}; }"));
+  tasks.push_back(make_task("function(list) { list.push(3); return list; }",
+                            {shcore::Value(shcore::Value::new_array())}));
+
+  shcore::Value::Array_type_ref results;
+  ASSERT_EQ("", run_tasks(tasks, 2, &results));
+  EXPECT_EQ("{\"a\":[1,\"two\",{\"b\":null}]}", (*results)[0].json());
+  EXPECT_EQ("[3]", (*results)[1].json());
+}
+
+TEST(mod_shell_parallel, task_errors) {
+  std::vector<Task> tasks;
+  tasks.push_back(make_task("function() { return 1; }"));
+  tasks.push_back(make_task("function() { throw 'failed on purpose'; }"));
+  tasks.push_back(make_task("function() { return 3; }"));
+  tasks.push_back(make_task("function() { return undefined_name; }"));
+
+  shcore::Value::Array_type_ref results;
+  std::string error = run_tasks(tasks, 2, &results);
+
+  EXPECT_EQ(std::string::npos, error.find("Task #1:"));
+  EXPECT_NE(std::string::npos, error.find("Task #2:"));
+  EXPECT_NE(std::string::npos, error.find("failed on purpose"));
+  EXPECT_EQ(std::string::npos, error.find("Task #3:"));
+  EXPECT_NE(std::string::npos, error.find("Task #4:"));
+  EXPECT_NE(std::string::npos, error.find("undefined_name"));
+}
+
+TEST(mod_shell_parallel, functions_rejected) {
+  const std::vector<std::string> codes = {
+    "function() { return function() {}; }",
+    "function() { return [1, function() {}]; }",
+    "function() { return {cb: function() {}}; }",
+    "function() { return {list: [{deep: function() {}}]}; }"
+  };
+
+  for (auto &code : codes) {
+    SCOPED_TRACE(code);
+    shcore::Value::Array_type_ref results;
+    std::string error = run_tasks({make_task(code)}, 1, &results);
+    EXPECT_NE(std::string::npos, error.find("Task #1: A task can not return a function"));
+  }
+}
+
+TEST(mod_shell_parallel, arguments_copied) {
+  // Every task gets its own copy of the arguments, even when they are the
+  // same list
+  shcore::Value list(shcore::Value::new_array());
+  std::vector<Task> tasks;
+  for (int index = 0; index < 8; index++)
+    tasks.push_back(make_task("function(l) { l.push(1); return l.length; }", {list}));
+
+  shcore::Value::Array_type_ref results;
+  ASSERT_EQ("", run_tasks(tasks, 4, &results));
+  for (auto &result : *results)
+    EXPECT_EQ(1, result.as_int());
+  EXPECT_TRUE(list.as_array()->empty());
+}
+#else
+TEST(mod_shell_parallel, not_supported) {
+  EXPECT_FALSE(is_supported());
+
+  shcore::Value::Array_type_ref results;
+  EXPECT_NE("", run_tasks({make_task("function() { return 1; }")}, 1, &results));
+}
+#endif
+}
+}
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/mod_utils.h"
+
+namespace mysqlsh {
+TEST(mod_utils, key_offsets) {
+  EXPECT_LT(key_to_offset("-9223372036854775808", false), key_to_offset("-1", false));
+  EXPECT_LT(key_to_offset("-1", false), key_to_offset("0", false));
+  EXPECT_LT(key_to_offset("0", false), key_to_offset("9223372036854775807", false));
+
+  for (auto key : {"-9223372036854775808", "-1", "0", "42", "9223372036854775807"})
+    EXPECT_EQ(key, offset_to_key(key_to_offset(key, false), false));
+
+  EXPECT_EQ(18446744073709551615ULL, key_to_offset("18446744073709551615", true));
+  EXPECT_EQ("18446744073709551615", offset_to_key(18446744073709551615ULL, true));
+  EXPECT_EQ(-5, offset_to_value(key_to_offset("-5", false), false).as_int());
+}
+
+TEST(mod_utils, split_offsets) {
+  std::vector<std::pair<uint64_t, uint64_t> > expected = { {1, 4}, {5, 8}, {9, 10} };
+  EXPECT_EQ(expected, split_offsets(1, 10, 3));
+
+  expected = { {7, 7} };
+  EXPECT_EQ(expected, split_offsets(7, 7, 4));
+  EXPECT_EQ(expected, split_offsets(7, 7, 0));
+
+  // Every offset is covered once, even the whole range
+  auto ranges = split_offsets(0, UINT64_MAX, 2);
+  ASSERT_EQ(2u, ranges.size());
+  EXPECT_EQ(0u, ranges[0].first);
+  EXPECT_EQ(ranges[0].second + 1, ranges[1].first);
+  EXPECT_EQ(UINT64_MAX, ranges[1].second);
+}
+
+TEST(mod_utils, table_matches) {
+  EXPECT_TRUE(table_matches("world", "world", "city"));
+  EXPECT_TRUE(table_matches("world.city", "world", "city"));
+  EXPECT_FALSE(table_matches("world.country", "world", "city"));
+  EXPECT_FALSE(table_matches("sakila", "world", "city"));
+}
+
+TEST(mod_utils, table_filter) {
+  EXPECT_EQ("c.TABLE_SCHEMA NOT IN ('mysql', 'sys', 'information_schema', 'performance_schema', "
+            "'mysql_innodb_cluster_metadata')", table_filter({}, "c."));
+  EXPECT_EQ("(TABLE_SCHEMA = 'world' OR (TABLE_SCHEMA = 'sakila' AND TABLE_NAME = 'actor'))",
+            table_filter({"world", "sakila.actor"}));
+}
+
+TEST(mod_utils, describe_chunk) {
+  EXPECT_EQ("world.city", describe_chunk("world", "city", "", true, "", ""));
+  EXPECT_EQ("world.city (-5 to 10)", describe_chunk("world", "city", "", false, "-5", "10"));
+  EXPECT_EQ("world.city partition `p1`", describe_chunk("world", "city", "`p1`", true, "", ""));
+  EXPECT_EQ("world.city partition `p1` (1 to 9)", describe_chunk("world", "city", "`p1`", false, "1", "9"));
+}
+
+TEST(mod_utils, split_sql_statements) {
+  std::vector<std::string> expected = { "INSERT INTO t VALUES (1, ';')", "USE `a;b`",
+                                        "INSERT INTO t VALUES (2, \"x\\\";\")" };
+  EXPECT_EQ(expected, split_sql_statements("INSERT INTO t VALUES (1, ';');\nUSE `a;b`;\n"
+                                           "INSERT INTO t VALUES (2, \"x\\\";\");\n"));
+
+  // Empty statements are skipped, the last one needs no delimiter
+  expected = { "SELECT 1", "SELECT 2" };
+  EXPECT_EQ(expected, split_sql_statements(";  ;SELECT 1;\nSELECT 2"));
+  EXPECT_TRUE(split_sql_statements("  \n").empty());
+}
+
+TEST(mod_utils, get_statement_type) {
+  EXPECT_EQ(Load_statement_type::Data, get_statement_type("INSERT INTO t VALUES (1)"));
+  EXPECT_EQ(Load_statement_type::Data, get_statement_type("  replace into t values (1)"));
+  EXPECT_EQ(Load_statement_type::Session, get_statement_type("use world"));
+  EXPECT_EQ(Load_statement_type::Session, get_statement_type("SET NAMES utf8"));
+  EXPECT_EQ(Load_statement_type::Lock, get_statement_type("LOCK TABLES t WRITE"));
+  EXPECT_EQ(Load_statement_type::Lock, get_statement_type("UNLOCK TABLES"));
+  EXPECT_EQ(Load_statement_type::Other, get_statement_type("CREATE TABLE t (a INT)"));
+  EXPECT_EQ(Load_statement_type::Other, get_statement_type("INSERTED"));
+  EXPECT_EQ(Load_statement_type::Other, get_statement_type(""));
+
+  // Comments are skipped, executable ones are classified by their content
+  EXPECT_EQ(Load_statement_type::Data, get_statement_type("-- dump\n# of t\n/* rows */ INSERT INTO t VALUES (1)"));
+  EXPECT_EQ(Load_statement_type::Session, get_statement_type("/*!40101 SET character_set_client = utf8 */"));
+  EXPECT_EQ(Load_statement_type::Lock, get_statement_type("/*!40000 UNLOCK TABLES */"));
+  EXPECT_EQ(Load_statement_type::Other, get_statement_type("/*!40000 ALTER TABLE t DISABLE KEYS */"));
+  EXPECT_EQ(Load_statement_type::Other, get_statement_type("-- only a comment"));
+  EXPECT_EQ(Load_statement_type::Other, get_statement_type("/* unterminated INSERT"));
+}
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+#include "mysqlx_batch_control.h"
+
+namespace mysqlx {
+namespace batch_control_tests {
+const std::chrono::milliseconds fast(10);
+const std::chrono::milliseconds slow(2000);
+
+TEST(Batch_control, grows_while_fast) {
+  Batch_control control(100, 2);
+  EXPECT_EQ(100u, control.rows());
+  EXPECT_EQ(2u, control.depth());
+
+  for (int batch = 0; batch < 8; batch++)
+    control.on_batch(fast);
+
+  EXPECT_EQ(180u, control.rows());
+  EXPECT_EQ(3u, control.depth());
+  EXPECT_EQ("batch 180 rows x 3", control.describe());
+}
+
+TEST(Batch_control, halves_when_slow) {
+  Batch_control control(100, 4);
+  control.on_batch(slow);
+  EXPECT_EQ(50u, control.rows());
+  EXPECT_EQ(2u, control.depth());
+
+  // The step of the growth is kept
+  control.on_batch(fast);
+  EXPECT_EQ(60u, control.rows());
+}
+
+TEST(Batch_control, size_errors) {
+  Batch_control control(100, 4);
+  EXPECT_TRUE(control.on_error(1205));
+  EXPECT_TRUE(control.on_error(1213));
+  EXPECT_EQ(25u, control.rows());
+  EXPECT_EQ(1u, control.depth());
+
+  EXPECT_TRUE(control.on_error(1153));
+  EXPECT_EQ(12u, control.rows());
+
+  // Errors unrelated to the size change nothing
+  EXPECT_FALSE(control.on_error(1062));
+  EXPECT_EQ(12u, control.rows());
+}
+
+TEST(Batch_control, limits) {
+  Batch_limits limits;
+  limits.min_rows = 10;
+  limits.max_rows = 120;
+  limits.max_depth = 2;
+
+  Batch_control control(1000, 8, limits);
+  EXPECT_EQ(120u, control.rows());
+  EXPECT_EQ(2u, control.depth());
+
+  for (int batch = 0; batch < 16; batch++)
+    control.on_batch(fast);
+  EXPECT_EQ(120u, control.rows());
+  EXPECT_EQ(2u, control.depth());
+
+  for (int batch = 0; batch < 8; batch++)
+    control.on_batch(slow);
+  EXPECT_EQ(10u, control.rows());
+  EXPECT_EQ(1u, control.depth());
+}
+}
+}
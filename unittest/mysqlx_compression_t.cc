@@ -0,0 +1,231 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "mysqlx_compression.h"
+#include "mysqlx.pb.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace mysqlx {
+namespace compression_tests {
+// An X protocol frame as sent by the server
+std::string frame(int mid, const std::string &payload) {
+  uint32_t length = static_cast<uint32_t>(payload.size() + 1);
+  std::string ret_val;
+  for (int shift = 0; shift < 32; shift += 8)
+    ret_val.push_back(static_cast<char>((length >> shift) & 0xff));
+  ret_val.push_back(static_cast<char>(mid));
+  return ret_val + payload;
+}
+
+std::string ok_frame(const std::string &msg) {
+  Mysqlx::Ok ok;
+  ok.set_msg(msg);
+  return frame(Mysqlx::ServerMessages::OK, ok.SerializeAsString());
+}
+
+// Parses the frames of the uncompressed data of a Compression message as
+// the connection does, stopping at the first invalid one
+std::vector<std::string> parse_frames(const char *data, std::size_t size, bool *valid) {
+  std::vector<std::string> messages;
+  std::size_t offset = 0;
+  *valid = true;
+
+  while (offset < size) {
+    int mid;
+    std::size_t length;
+    if (!read_inflated_frame(data + offset, size - offset, mid, length)) {
+      *valid = false;
+      break;
+    }
+
+    const char *payload = data + offset + 5;
+    if (mid == Mysqlx::ServerMessages::OK) {
+      Mysqlx::Ok ok;
+      EXPECT_TRUE(ok.ParseFromArray(payload, static_cast<int>(length)));
+      messages.push_back("ok:" + ok.msg());
+    } else if (mid == Mysqlx::ServerMessages::ERROR) {
+      Mysqlx::Error error;
+      EXPECT_TRUE(error.ParseFromArray(payload, static_cast<int>(length)));
+      messages.push_back("error:" + error.msg());
+    } else {
+      messages.push_back("mid:" + std::to_string(mid) + ":" + std::to_string(length));
+    }
+
+    offset += 5 + length;
+  }
+
+  return messages;
+}
+
+std::vector<std::string> parse_frames(const std::string &data, bool *valid) {
+  // Copied so reading past the data is caught by the memory checkers
+  std::vector<char> copy(data.begin(), data.end());
+  return parse_frames(copy.empty() ? NULL : &copy[0], copy.size(), valid);
+}
+
+TEST(Mysqlx_compression, several_messages) {
+  Mysqlx::Error error;
+  error.set_code(1045);
+  error.set_sql_state("28000");
+  error.set_msg("denied");
+
+  // One of the messages has no payload
+  std::string data = ok_frame("first") + frame(Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, "") +
+                     frame(Mysqlx::ServerMessages::ERROR, error.SerializeAsString()) + ok_frame("last");
+  bool valid;
+  std::vector<std::string> expected = {"ok:first", "mid:17:0", "error:denied", "ok:last"};
+  EXPECT_EQ(expected, parse_frames(data, &valid));
+  EXPECT_TRUE(valid);
+}
+
+TEST(Mysqlx_compression, truncated_frames) {
+  std::string data = ok_frame("first") + ok_frame("last");
+  std::vector<std::string> expected = {"ok:first"};
+  bool valid;
+
+  // Cut in the header and in the payload of the last frame
+  for (std::size_t cut : {std::size_t(1), std::size_t(3), std::size_t(5), std::size_t(6), ok_frame("last").size() - 1}) {
+    EXPECT_EQ(expected, parse_frames(data.substr(0, data.size() - cut), &valid)) << cut;
+    EXPECT_FALSE(valid) << cut;
+  }
+
+  int mid;
+  std::size_t length;
+  EXPECT_FALSE(read_inflated_frame(NULL, 0, mid, length));
+}
+
+TEST(Mysqlx_compression, corrupt_frames) {
+  bool valid;
+
+  // The length of the inner frame goes past the data of the message
+  std::string corrupt = ok_frame("first");
+  corrupt[0] = static_cast<char>(corrupt[0] + 1);
+  EXPECT_TRUE(parse_frames(corrupt, &valid).empty());
+  EXPECT_FALSE(valid);
+
+  corrupt = ok_frame("first");
+  corrupt[3] = '\x80';
+  EXPECT_TRUE(parse_frames(corrupt, &valid).empty());
+  EXPECT_FALSE(valid);
+
+  corrupt = std::string(4, '\xff') + ok_frame("first");
+  EXPECT_TRUE(parse_frames(corrupt, &valid).empty());
+  EXPECT_FALSE(valid);
+
+  // A length of zero does not even hold the message id
+  corrupt = std::string(4, '\0') + ok_frame("first");
+  EXPECT_TRUE(parse_frames(corrupt, &valid).empty());
+  EXPECT_FALSE(valid);
+
+  // Compression messages are not nested
+  corrupt = frame(Mysqlx::ServerMessages::COMPRESSION, "") + ok_frame("first");
+  EXPECT_TRUE(parse_frames(corrupt, &valid).empty());
+  EXPECT_FALSE(valid);
+}
+
+TEST(Mysqlx_compression, algorithms) {
+  EXPECT_EQ(NULL, Decompressor::create("unknown"));
+
+  std::vector<std::string> algorithms = Decompressor::algorithms();
+  for (std::size_t index = 0; index < algorithms.size(); index++) {
+    std::unique_ptr<Decompressor> decompressor(Decompressor::create(algorithms[index]));
+    EXPECT_TRUE(decompressor.get() != NULL) << algorithms[index];
+  }
+}
+
+#ifdef HAVE_ZLIB
+// Compresses the messages as the server does, on a single stream flushed at
+// the end of each message
+class Deflate_stream {
+public:
+  Deflate_stream() {
+    m_stream.zalloc = Z_NULL;
+    m_stream.zfree = Z_NULL;
+    m_stream.opaque = Z_NULL;
+    deflateInit(&m_stream, Z_DEFAULT_COMPRESSION);
+  }
+
+  ~Deflate_stream() { deflateEnd(&m_stream); }
+
+  std::string compress(const std::string &data) {
+    std::string ret_val;
+    char buffer[4096];
+
+    m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    m_stream.avail_in = static_cast<uInt>(data.size());
+    do {
+      m_stream.next_out = reinterpret_cast<Bytef*>(buffer);
+      m_stream.avail_out = sizeof(buffer);
+      deflate(&m_stream, Z_SYNC_FLUSH);
+      ret_val.append(buffer, sizeof(buffer) - m_stream.avail_out);
+    } while (m_stream.avail_out == 0);
+
+    return ret_val;
+  }
+
+private:
+  z_stream m_stream;
+};
+
+TEST(Mysqlx_compression, deflate_stream_round_trip) {
+  std::unique_ptr<Decompressor> decompressor(Decompressor::create("deflate_stream"));
+  ASSERT_TRUE(decompressor.get() != NULL);
+  Deflate_stream stream;
+
+  // The second message depends on the first one through the stream, and
+  // is bigger than the space left on the output
+  std::string first = ok_frame("first") + ok_frame("second");
+  std::string second;
+  for (int index = 0; index < 10000; index++)
+    second += ok_frame("row " + std::to_string(index));
+
+  std::string compressed = stream.compress(first);
+  std::vector<char> out(3, 'x');
+  std::size_t out_end = 3;
+  ASSERT_TRUE(decompressor->decompress(compressed.data(), compressed.size(), out, out_end));
+  EXPECT_EQ("xxx" + first, std::string(&out[0], out_end));
+
+  compressed = stream.compress(second);
+  EXPECT_LT(compressed.size(), second.size());
+  ASSERT_TRUE(decompressor->decompress(compressed.data(), compressed.size(), out, out_end));
+  EXPECT_EQ("xxx" + first + second, std::string(&out[0], out_end));
+
+  bool valid;
+  std::vector<std::string> messages = parse_frames(&out[3], out_end - 3, &valid);
+  EXPECT_TRUE(valid);
+  ASSERT_EQ(10002u, messages.size());
+  EXPECT_EQ("ok:second", messages[1]);
+  EXPECT_EQ("ok:row 9999", messages.back());
+}
+
+TEST(Mysqlx_compression, deflate_stream_corrupt) {
+  std::unique_ptr<Decompressor> decompressor(Decompressor::create("deflate_stream"));
+  std::vector<char> out;
+  std::size_t out_end = 0;
+
+  std::string garbage("\xff\xff\xff\xff not deflate data");
+  EXPECT_FALSE(decompressor->decompress(garbage.data(), garbage.size(), out, out_end));
+}
+#endif
+}
+}
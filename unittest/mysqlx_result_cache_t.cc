@@ -0,0 +1,89 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "mysqlx_connection.h"
+#include "mysqlx_result_cache.h"
+
+namespace mysqlx {
+namespace result_cache_tests {
+std::string sql(const std::string &statement, const std::string &ns = "sql") {
+  Mysqlx::Sql::StmtExecute execute;
+  execute.set_namespace_(ns);
+  execute.set_stmt(statement);
+  return execute.SerializeAsString();
+}
+
+TEST(Result_cache, cacheable_sql) {
+  std::string schema = "unchanged";
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("select 1"), &schema));
+  EXPECT_EQ("", schema);
+
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("  (SELECT a FROM t)"), &schema));
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("show tables"), &schema));
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("DESC t"), &schema));
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT 'now() into @a' FROM t"), &schema));
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT `sleep` FROM t /* FOR UPDATE */"), &schema));
+
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT * FROM t FOR UPDATE"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT 1 INTO @a"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT 1\nINTO @a"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT a FROM t\tINTO OUTFILE 'x'"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT * FROM t LOCK IN SHARE MODE"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT @a := 1"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT @@session.sql_mode"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT GET_LOCK('a', 1)"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT sleep(1)"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT NOW()"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT RAND()"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT LAST_INSERT_ID()"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT FOUND_ROWS()"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECT UUID()"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("SELECTED"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("DELETE FROM t"), &schema));
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, sql("list_objects", "xplugin"), &schema));
+}
+
+TEST(Result_cache, cacheable_crud) {
+  Mysqlx::Crud::Find find;
+  find.mutable_collection()->set_schema("world");
+  find.mutable_collection()->set_name("city");
+
+  std::string schema;
+  EXPECT_TRUE(Result_cache::cacheable(Mysqlx::ClientMessages::CRUD_FIND, find.SerializeAsString(), &schema));
+  EXPECT_EQ("world", schema);
+
+  Mysqlx::Crud::Delete remove;
+  remove.mutable_collection()->set_schema("world");
+  remove.mutable_collection()->set_name("city");
+  EXPECT_FALSE(Result_cache::cacheable(Mysqlx::ClientMessages::CRUD_DELETE, remove.SerializeAsString(), &schema));
+}
+
+TEST(Result_cache, empty) {
+  Result_cache_config config;
+  config.ttl = 1000;
+  Result_cache cache(config);
+
+  std::string payload = sql("SELECT 1");
+  cache.sent(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, payload.data(), payload.size());
+  EXPECT_FALSE(cache.find(Mysqlx::ClientMessages::SQL_STMT_EXECUTE, payload));
+  EXPECT_EQ(0u, cache.stats().hits);
+  EXPECT_EQ(1u, cache.stats().misses);
+  EXPECT_EQ(0u, cache.stats().entries);
+}
+}
+}
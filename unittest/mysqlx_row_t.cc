@@ -0,0 +1,173 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "mysqlx_row.h"
+
+namespace mysqlx {
+namespace row_decoder_tests {
+std::string encode_varint(uint64_t value) {
+  std::string buffer;
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<char>(value));
+  return buffer;
+}
+
+uint64_t zigzag_encode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+std::vector<const std::string *> pointers(const std::vector<std::string> &buffers) {
+  std::vector<const std::string *> ret_val;
+  for (size_t index = 0; index < buffers.size(); index++)
+    ret_val.push_back(&buffers[index]);
+  return ret_val;
+}
+
+TEST(Row_decoder, u64_from_buffers) {
+  std::vector<uint64_t> values;
+  for (int bits = 0; bits < 64; bits++) {
+    values.push_back(uint64_t(1) << bits);
+    values.push_back((uint64_t(1) << bits) - 1);
+  }
+  values.push_back(std::numeric_limits<uint64_t>::max());
+
+  std::mt19937_64 random(5);
+  for (int index = 0; index < 1000; index++)
+    values.push_back(random() >> (random() % 64));
+
+  std::vector<std::string> buffers;
+  for (size_t index = 0; index < values.size(); index++)
+    buffers.push_back(encode_varint(values[index]));
+
+  std::vector<uint64_t> result(values.size());
+  Row_decoder::u64_from_buffers(&pointers(buffers)[0], buffers.size(), &result[0]);
+
+  for (size_t index = 0; index < values.size(); index++) {
+    EXPECT_EQ(values[index], result[index]);
+    EXPECT_EQ(Row_decoder::u64_from_buffer(buffers[index]), result[index]);
+  }
+}
+
+TEST(Row_decoder, s64_from_buffers) {
+  std::vector<int64_t> values = {
+    0, 1, -1, 63, -64, 64, -65, 8191, -8192,
+    std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()
+  };
+
+  std::mt19937_64 random(7);
+  for (int index = 0; index < 1000; index++)
+    values.push_back(static_cast<int64_t>(random()) >> (random() % 64));
+
+  std::vector<std::string> buffers;
+  for (size_t index = 0; index < values.size(); index++)
+    buffers.push_back(encode_varint(zigzag_encode(values[index])));
+
+  std::vector<int64_t> result(values.size());
+  Row_decoder::s64_from_buffers(&pointers(buffers)[0], buffers.size(), &result[0]);
+
+  for (size_t index = 0; index < values.size(); index++) {
+    EXPECT_EQ(values[index], result[index]);
+    EXPECT_EQ(Row_decoder::s64_from_buffer(buffers[index]), result[index]);
+  }
+}
+
+TEST(Row_decoder, bulk_nulls_and_padding) {
+  // Null fields are empty buffers, a varint followed by extra bytes is
+  // decoded the same way the single field decoder does
+  std::vector<std::string> buffers = {
+    "", encode_varint(300), "", encode_varint(5) + std::string("\x01", 1)
+  };
+
+  std::vector<uint64_t> result(buffers.size(), 99);
+  Row_decoder::u64_from_buffers(&pointers(buffers)[0], buffers.size(), &result[0]);
+
+  EXPECT_EQ(0u, result[0]);
+  EXPECT_EQ(300u, result[1]);
+  EXPECT_EQ(0u, result[2]);
+  EXPECT_EQ(5u, result[3]);
+}
+
+// Compares decoding a result of integer columns field by field against the
+// bulk decoding done by Row_batch. The columns resemble an analytics export:
+// an auto increment id, a small status code, a signed delta, a timestamp in
+// microseconds and a 64 bit hash.
+// Run with --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST(Row_decoder, DISABLED_bench_integer_columns) {
+  const size_t rows = 200000;
+  std::mt19937_64 random(11);
+
+  std::vector<std::vector<std::string> > columns(5);
+  for (size_t row = 0; row < rows; row++) {
+    columns[0].push_back(encode_varint(row + 1));
+    columns[1].push_back(encode_varint(random() % 16));
+    columns[2].push_back(encode_varint(zigzag_encode(int64_t(random() % 20001) - 10000)));
+    columns[3].push_back(encode_varint(1480000000000000ULL + random() % 100000000000ULL));
+    columns[4].push_back(encode_varint(random()));
+  }
+
+  std::vector<std::vector<const std::string *> > fields;
+  for (size_t column = 0; column < columns.size(); column++)
+    fields.push_back(pointers(columns[column]));
+
+  std::vector<uint64_t> result(rows);
+  std::vector<int64_t> sresult(rows);
+  uint64_t checksum_single = 0;
+  uint64_t checksum_bulk = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t column = 0; column < columns.size(); column++) {
+    for (size_t row = 0; row < rows; row++) {
+      if (column == 2)
+        checksum_single += Row_decoder::s64_from_buffer(columns[column][row]);
+      else
+        checksum_single += Row_decoder::u64_from_buffer(columns[column][row]);
+    }
+  }
+  auto single = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t column = 0; column < columns.size(); column++) {
+    if (column == 2) {
+      Row_decoder::s64_from_buffers(&fields[column][0], rows, &sresult[0]);
+      for (size_t row = 0; row < rows; row++)
+        checksum_bulk += sresult[row];
+    } else {
+      Row_decoder::u64_from_buffers(&fields[column][0], rows, &result[0]);
+      for (size_t row = 0; row < rows; row++)
+        checksum_bulk += result[row];
+    }
+  }
+  auto bulk = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(checksum_single, checksum_bulk);
+
+  double count = double(rows * columns.size());
+  std::printf("single field: %.2f ns/field, bulk: %.2f ns/field\n",
+    std::chrono::duration<double, std::nano>(single).count() / count,
+    std::chrono::duration<double, std::nano>(bulk).count() / count);
+}
+}
+}
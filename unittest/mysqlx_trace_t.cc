@@ -0,0 +1,130 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "mysqlx_trace.h"
+
+namespace mysqlx {
+namespace trace_tests {
+struct Record {
+  Trace_record_header header;
+  std::string payload;
+};
+
+// Reads the records of a trace file from the oldest to the newest one
+std::vector<Record> read_trace(const std::string &path, Trace_file_header *header) {
+  std::ifstream file(path.c_str(), std::ios::binary);
+  file.read(reinterpret_cast<char *>(header), sizeof(*header));
+
+  std::vector<char> ring(header->capacity);
+  file.read(&ring[0], ring.size());
+
+  std::vector<Record> records;
+  uint64_t offset = header->tail;
+  while (offset < header->head) {
+    std::string bytes;
+    for (uint64_t index = 0; index < sizeof(Trace_record_header); index++)
+      bytes.push_back(ring[(offset + index) % header->capacity]);
+
+    Record record;
+    std::memcpy(&record.header, bytes.data(), sizeof(record.header));
+    for (uint64_t index = 0; index < record.header.captured; index++)
+      record.payload.push_back(ring[(offset + sizeof(Trace_record_header) + index) % header->capacity]);
+
+    records.push_back(record);
+    offset += (sizeof(Trace_record_header) + record.header.captured + 7) & ~uint64_t(7);
+  }
+
+  return records;
+}
+
+TEST(Protocol_trace, records_frames) {
+  std::string path = "mysqlx_trace_t.trace";
+  Protocol_trace::open(path, 4096);
+
+  std::shared_ptr<Protocol_trace> trace = Protocol_trace::current();
+  ASSERT_TRUE(trace.get() != nullptr);
+
+  trace->record(Protocol_trace::Send, 12, "select 1", 8);
+  trace->record(Protocol_trace::Receive, 13, "\x08\x01", 2);
+  trace->record(Protocol_trace::Receive, 0, "", 0);
+  Protocol_trace::close();
+  trace.reset();
+
+  Trace_file_header header;
+  std::vector<Record> records = read_trace(path, &header);
+
+  EXPECT_EQ(0, std::memcmp(header.magic, Protocol_trace::k_magic, sizeof(header.magic)));
+  EXPECT_EQ(3u, header.record_count);
+  ASSERT_EQ(3u, records.size());
+
+  EXPECT_EQ(Protocol_trace::Send, records[0].header.direction);
+  EXPECT_EQ(12, records[0].header.type);
+  EXPECT_EQ("select 1", records[0].payload);
+  EXPECT_EQ(Protocol_trace::Receive, records[1].header.direction);
+  EXPECT_EQ(std::string("\x08\x01", 2), records[1].payload);
+  EXPECT_EQ(0u, records[2].header.frame_size);
+  EXPECT_LE(records[0].header.timestamp, records[1].header.timestamp);
+  EXPECT_LE(records[1].header.timestamp, records[2].header.timestamp);
+
+  std::remove(path.c_str());
+}
+
+TEST(Protocol_trace, ring_wraps_and_truncates) {
+  std::string path = "mysqlx_trace_t.trace";
+  Protocol_trace::open(path, 4096);
+  std::shared_ptr<Protocol_trace> trace = Protocol_trace::current();
+
+  // Only the newest records are kept once the ring is full
+  for (int index = 0; index < 1000; index++) {
+    std::string payload(static_cast<size_t>(index % 50), static_cast<char>('a' + index % 26));
+    trace->record(Protocol_trace::Send, 17, payload.data(), payload.size());
+  }
+
+  // A frame much bigger than the ring is truncated
+  std::string big(100000, 'x');
+  trace->record(Protocol_trace::Receive, 13, big.data(), big.size());
+  Protocol_trace::close();
+  trace.reset();
+
+  Trace_file_header header;
+  std::vector<Record> records = read_trace(path, &header);
+
+  ASSERT_EQ(header.record_count, records.size());
+  ASSERT_GT(records.size(), 2u);
+  EXPECT_LE(header.head - header.tail, header.capacity);
+
+  const Record &last = records.back();
+  EXPECT_EQ(big.size(), last.header.frame_size);
+  EXPECT_LT(last.header.captured, last.header.frame_size);
+  EXPECT_EQ(std::string(last.header.captured, 'x'), last.payload);
+
+  // The records before it are the last ones written, in order
+  int index = 999;
+  for (size_t record = records.size() - 1; record-- > 0; index--) {
+    std::string payload(static_cast<size_t>(index % 50), static_cast<char>('a' + index % 26));
+    EXPECT_EQ(payload, records[record].payload);
+  }
+
+  std::remove(path.c_str());
+}
+}
+}
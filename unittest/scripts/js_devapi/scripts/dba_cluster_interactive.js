@@ -19,6 +19,7 @@ validateMember(members, 'getName');
 validateMember(members, 'adminType');
 validateMember(members, 'getAdminType');
 validateMember(members, 'addInstance');
+validateMember(members, 'addInstances');
 validateMember(members, 'removeInstance');
 validateMember(members, 'rejoinInstance');
 validateMember(members, 'checkInstanceState');
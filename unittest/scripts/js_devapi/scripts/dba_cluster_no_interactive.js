@@ -19,6 +19,7 @@ validateMember(members, 'getName');
 validateMember(members, 'adminType');
 validateMember(members, 'getAdminType');
 validateMember(members, 'addInstance');
+validateMember(members, 'addInstances');
 validateMember(members, 'removeInstance');
 validateMember(members, 'rejoinInstance');
 validateMember(members, 'checkInstanceState');
@@ -46,6 +47,13 @@ Cluster.addInstance({dbUser: "root", host: "localhost", port:__mysql_sandbox_por
 add_instance_options['port'] = __mysql_sandbox_port1;
 Cluster.addInstance(add_instance_options, add_instance_extra_opts);
 
+//@# Cluster: addInstances errors
+Cluster.addInstances()
+Cluster.addInstances(5)
+Cluster.addInstances([], {parallel: 0})
+Cluster.addInstances([], {label: 'second'})
+Cluster.addInstances([{dbUser: "root", host: "localhost", port:__mysql_sandbox_port2}, {dbUser: "root", host: "localhost", port:__mysql_sandbox_port2}], {password: "root"})
+
 //@ Cluster: addInstance 2
 add_instance_to_cluster(Cluster, __mysql_sandbox_port2, 'second');
 
@@ -62,6 +70,17 @@ Cluster.describe()
 //@<OUT> Cluster: status cluster with instance
 Cluster.status()
 
+//@ Cluster: status errors
+Cluster.status(1,2);
+Cluster.status({extended: true, foo: 1});
+Cluster.status({timeout: 0});
+
+//@ Cluster: status extended
+var extended = Cluster.status({extended: true, timeout: 10});
+var member = extended.defaultReplicaSet.topology[localhost + ":" + __mysql_sandbox_port1];
+print("Member stats:", Object.keys(member.memberStats).sort().join(", "), "\n");
+print("Super read only:", member.memberStats.superReadOnly, "\n");
+
 //@ Cluster: removeInstance errors
 Cluster.removeInstance();
 Cluster.removeInstance(1,2,3);
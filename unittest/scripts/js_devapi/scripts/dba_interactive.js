@@ -9,6 +9,7 @@ print("Session Members:", members.length);
 validateMember(members, 'createCluster');
 validateMember(members, 'deleteSandboxInstance');
 validateMember(members, 'deploySandboxInstance');
+validateMember(members, 'deploySandboxInstances');
 validateMember(members, 'dropMetadataSchema');
 validateMember(members, 'getCluster');
 validateMember(members, 'help');
@@ -16,6 +17,7 @@ validateMember(members, 'killSandboxInstance');
 validateMember(members, 'resetSession');
 validateMember(members, 'startSandboxInstance');
 validateMember(members, 'checkInstanceConfiguration');
+validateMember(members, 'checkInstancesConfiguration');
 validateMember(members, 'stopSandboxInstance');
 validateMember(members, 'configureLocalInstance');
 validateMember(members, 'verbose');
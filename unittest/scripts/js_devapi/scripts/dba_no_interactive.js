@@ -9,6 +9,7 @@ print("Session Members:", members.length);
 validateMember(members, 'createCluster');
 validateMember(members, 'deleteSandboxInstance');
 validateMember(members, 'deploySandboxInstance');
+validateMember(members, 'deploySandboxInstances');
 validateMember(members, 'dropMetadataSchema');
 validateMember(members, 'getCluster');
 validateMember(members, 'help');
@@ -16,6 +17,7 @@ validateMember(members, 'killSandboxInstance');
 validateMember(members, 'resetSession');
 validateMember(members, 'startSandboxInstance');
 validateMember(members, 'checkInstanceConfiguration');
+validateMember(members, 'checkInstancesConfiguration');
 validateMember(members, 'stopSandboxInstance');
 validateMember(members, 'configureLocalInstance');
 validateMember(members, 'verbose');
@@ -98,3 +100,21 @@ var c2 = dba.getCluster('devCluster');
 
 //@ Dba: getCluster
 print(c2);
+
+//@# Dba: deploySandboxInstances errors
+dba.deploySandboxInstances();
+dba.deploySandboxInstances(5);
+dba.deploySandboxInstances([5000], {portx: 50000, password: 'root'});
+dba.deploySandboxInstances([5000]);
+dba.deploySandboxInstances([5000], {password: 'root', parallel: 0});
+dba.deploySandboxInstances([5000, 'bad'], {password: 'root'});
+dba.deploySandboxInstances([5000, 80], {password: 'root'});
+dba.deploySandboxInstances([5000, 5000], {password: 'root'});
+
+//@# Dba: checkInstancesConfiguration errors
+dba.checkInstancesConfiguration();
+dba.checkInstancesConfiguration('localhost:3306');
+dba.checkInstancesConfiguration(['localhost:3306'], {portx: 3306});
+dba.checkInstancesConfiguration(['localhost:3306'], {parallel: 0});
+dba.checkInstancesConfiguration(['localhost:3306', 5]);
+dba.checkInstancesConfiguration(['localhost:3306', {host: 'localhost', port: 3306}]);
@@ -29,8 +29,10 @@ validateMember(members, 'getColumns');
 validateMember(members, 'getInfo');
 validateMember(members, 'fetchOne');
 validateMember(members, 'fetchAll');
+validateMember(members, 'fetchMany');
 validateMember(members, 'hasData');
 validateMember(members, 'nextDataSet');
+validateMember(members, 'toArrow');
 validateMember(members, 'affectedRowCount');
 validateMember(members, 'autoIncrementValue');
 validateMember(members, 'getAffectedRowCount');
@@ -101,4 +103,83 @@ println("Name with property: " +  row.alias);
 println("Age with property: " +  row.age);
 println("Unable to get length with property: " +  row.length);
 
+//@ Resultset fetchMany
+var result = mySession.runSql('select name from buffer_table order by name');
+var rows = result.fetchMany(3);
+print('First chunk:', rows.length, rows[0].name, rows[2].name);
+rows = result.fetchMany(3);
+print('Second chunk:', rows.length, rows[0].name, rows[2].name);
+rows = result.fetchMany(3);
+print('Third chunk:', rows.length, rows[0].name);
+rows = result.fetchMany(3);
+print('Last chunk:', rows.length);
+
+//@ Resultset fetchMany with maxBytes
+var result = mySession.runSql('select name from buffer_table order by name');
+var rows = result.fetchMany(5, {maxBytes: 8});
+print('Rows within limit:', rows.length);
+
+//@# Resultset fetchMany errors
+var result = mySession.runSql('select name from buffer_table order by name');
+result.fetchMany();
+result.fetchMany(0);
+result.fetchMany(1, {rows: 1});
+
+//@ Session runSqlPaged
+var result = mySession.runSqlPaged('select name, age from buffer_table', 'name', {chunkSize: 2});
+var rows = result.fetchAll();
+var names = [];
+for (var index = 0; index < rows.length; index++)
+  names.push(rows[index].name);
+print('Paged rows:', rows.length, names.join(','));
+
+//@ Session runSqlPaged with composite key and fetchMany
+var result = mySession.runSqlPaged('select age, name from buffer_table', ['age', 'name'], {chunkSize: 3});
+var rows = result.fetchMany(4);
+print('First chunk:', rows.length, rows[0].name, rows[3].name);
+rows = result.fetchMany(4);
+print('Second chunk:', rows.length, rows[0].name, rows[2].name);
+
+//@# Session runSqlPaged errors
+mySession.runSqlPaged('select name from buffer_table');
+mySession.runSqlPaged('select name from buffer_table', 5);
+mySession.runSqlPaged('select name from buffer_table', []);
+mySession.runSqlPaged('select name from buffer_table', 'age');
+mySession.runSqlPaged('select name from buffer_table', 'name', {chunkSize: 0});
+
+//@ Session prepare
+var stmt = mySession.prepare('select name, age from buffer_table where name = ?');
+print('Parameters:', stmt.parameterCount);
+var row = stmt.execute('alma').fetchOne();
+print('First execution:', row.name, typeof row.age);
+row = stmt.execute(['jack']).fetchOne();
+print('Second execution:', row.name);
+stmt.close();
+
+//@# Session prepare errors
+mySession.prepare('select name from unexisting_table');
+var stmt = mySession.prepare('select name from buffer_table where name = ?');
+stmt.execute();
+stmt.close();
+stmt.execute('alma');
+
+//@ Session prepare with long data
+var stmt = mySession.prepare("select name, repeat('x', 3000000) as data from buffer_table where name = ?");
+var row = stmt.execute('alma').fetchOne();
+print('Data length:', row.data.length);
+print('Data part:', row.readField('data', 2999998, 10));
+stmt.close();
+
+//@ Session prepare with a stream
+var row = mySession.runSql("select repeat('ab', 1500000) as data").fetchOne();
+print('Written:', row.writeFieldTo('data', 'blob_stream.bin'));
+mySession.runSql('create table js_shell_test.blob_table (id integer, data longblob)');
+var stmt = mySession.prepare('insert into js_shell_test.blob_table values (?, ?)');
+stmt.bindStream(1, 'blob_stream.bin').execute(1, null);
+stmt.execute(2, null);
+stmt.close();
+var result = mySession.runSql('select id, length(data), substr(data, 2999999) from js_shell_test.blob_table order by id');
+print('Streamed:', result.fetchOne());
+print('Not streamed:', result.fetchOne());
+
 mySession.close()
@@ -53,6 +53,10 @@ print('schema:', schema.schema);
 var mySchema = mySession.getSchema('js_shell_test');
 print('getTables():', mySchema.getTables()[0]);
 
+//@ Testing tables retrieval by pattern
+print('getTables("view%"):', mySchema.getTables('view%').length, mySchema.getTables('view%')[0]);
+print('getTables("none%"):', mySchema.getTables('none%').length);
+
 //@ Testing specific object retrieval
 print('Retrieving a table:', mySchema.getTable('table1'));
 print('.<table>:', mySchema.table1);
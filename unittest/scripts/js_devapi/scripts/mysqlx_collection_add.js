@@ -139,6 +139,17 @@ var result = collection.add({ "name": 'my eigth', "passed": 'yep', "count": 6 },
 print("Affected Rows Multiple Params:", result.affectedItemCount, "\n")
 //! [CollectionAdd: Multiple Parameters]
 
+//@ Collection.add execution in chunks
+var result = collection.add([{ name: 'chunk 1', count: 7 }, { name: 'chunk 2', count: 7 }, { name: 'chunk 3', count: 7 },
+                             { name: 'chunk 4', count: 7 }, { name: 'chunk 5', count: 7 }]).execute({chunkSize: 2, pipelineDepth: 2});
+print("Affected Rows Chunked:", result.affectedItemCount, "\n");
+print("#lastDocumentIds Chunked:", result.lastDocumentIds.length, "\n");
+
+//@# CollectionAdd: Error conditions on execute
+crud = collection.add({ name: 'sample' });
+crud.execute({ chunkSize: 2, invalid: 1 });
+crud.execute({ pipelineDepth: 0 });
+
 // Cleanup
 mySession.dropSchema('js_shell_test');
 mySession.close();
@@ -27,6 +27,8 @@ validateMember(sqlMembers, 'getColumnNames');
 validateMember(sqlMembers, 'getColumns');
 validateMember(sqlMembers, 'fetchOne');
 validateMember(sqlMembers, 'fetchAll');
+validateMember(sqlMembers, 'fetchColumns');
+validateMember(sqlMembers, 'toArrow');
 validateMember(sqlMembers, 'hasData');
 validateMember(sqlMembers, 'nextDataSet');
 validateMember(sqlMembers, 'affectedRowCount');
@@ -82,6 +84,10 @@ validateMember(rowResultMembers, 'getColumnNames');
 validateMember(rowResultMembers, 'getColumns');
 validateMember(rowResultMembers, 'fetchOne');
 validateMember(rowResultMembers, 'fetchAll');
+validateMember(rowResultMembers, 'fetchColumns');
+validateMember(rowResultMembers, 'forEachBatch');
+validateMember(rowResultMembers, 'batches');
+validateMember(rowResultMembers, 'toArrow');
 
 //@ DocResult member validation
 var result = collection.find().execute();
@@ -95,6 +101,7 @@ validateMember(docResultMembers, 'getWarningCount');
 validateMember(docResultMembers, 'getWarnings');
 validateMember(docResultMembers, 'fetchOne');
 validateMember(docResultMembers, 'fetchAll');
+validateMember(docResultMembers, 'fetchRaw');
 
 
 //@ Resultset hasData false
@@ -228,4 +235,64 @@ println("Unable to get gender from alias: " +  row.getField('alias'));
 println("Name with property: " +  row.alias);
 println("Age with property: " +  row.age);
 println("Unable to get length with property: " +  row.length);
+
+//@ Resultset row fields after the result is consumed
+var result = mySession.sql('select name, age from buffer_table where name = "jack"').execute();
+var row = result.fetchOne();
+var remaining = result.fetchAll();
+println("Remaining rows: " + remaining.length);
+println("Fields from consumed result: " + row.name + " " + row[1]);
+println("Fields read again: " + row.getField('name') + " " + row.age);
+
+//@ DocResult fetchRaw
+collection.add({ _id: 'raw', name: 'jack', tags: ['a', 'b'] }).execute();
+var result = collection.find('_id = "raw"').execute();
+var raw = result.fetchRaw();
+println("Raw type: " + typeof raw);
+println("Raw parsed: " + JSON.parse(raw).name + " " + JSON.parse(raw).tags.length);
+println("Raw after last: " + result.fetchRaw());
+
+//@ Row readField
+var result = mySession.sql("select name, repeat('x', 100000) as data, null as nothing from buffer_table where name = 'jack'").execute();
+var row = result.fetchOne();
+println("Part: " + row.readField('data', 99998, 10));
+println("Part length: " + row.readField(1, 0, 1000).length);
+println("Past end: [" + row.readField('data', 200000, 10) + "]");
+println("Null: " + row.readField('nothing', 0, 10));
+println("Name: " + row.readField(0, 1, 2));
+
+//@ RowResult forEachBatch
+var result = mySession.sql('select name, age from buffer_table order by name').execute();
+var sizes = [];
+var read = result.forEachBatch(function(batch) { sizes.push(batch.length); }, {size: 3});
+println("Batch sizes: " + sizes.join(",") + " of " + read);
+
+var result = mySession.sql('select name, age from buffer_table order by name').execute();
+var first = [];
+var read = result.forEachBatch(function(batch) { first.push(batch[0].name); return first.length < 2; }, {size: 2});
+println("Stopped after: " + first.join(",") + " of " + read);
+println("Left: " + result.fetchAll().length);
+
+//@ RowResult batches by column
+var result = mySession.sql('select name, age from buffer_table order by name').execute();
+var batches = result.batches({size: 4, format: 'columns'});
+var batch = batches.next();
+println("First: " + batch.name.join(",") + " " + batch.age.length);
+var batch = batches.next();
+println("Second: " + batch.name.join(",") + " " + batch.age.length);
+println("Last: " + batches.next());
+
+//@ RowResult batches with invalid options
+var result = mySession.sql('select name from buffer_table').execute();
+result.batches({size: 0});
+result.batches({format: 'table'});
+result.forEachBatch(function(batch) {}, {rows: 2});
+
+//@ TableInsert with a file content
+println("Written: " + row.writeFieldTo('data', 'blob_content.bin'));
+mySession.sql('create table js_shell_test.blob_table (id integer, data longblob)').execute();
+var table = schema.getTable('blob_table');
+table.insert('id', 'data').values(1, mysqlx.fileContent('blob_content.bin')).execute();
+var row = mySession.sql('select id, length(data), substr(data, 99999) from js_shell_test.blob_table').execute().fetchOne();
+println("Inserted: " + row.id + " " + row[1] + " " + row[2]);
 mySession.close()
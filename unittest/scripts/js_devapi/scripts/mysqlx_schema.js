@@ -62,6 +62,11 @@ var mySchema = mySession.getSchema('js_shell_test');
 print('getTables():', mySchema.getTables()[0]);
 print('getCollections():', mySchema.getCollections()[0]);
 
+//@ Testing tables and collection retrieval by pattern
+print('getTables("table%"):', mySchema.getTables('table%').length, mySchema.getTables('table%')[0]);
+print('getCollections("coll%"):', mySchema.getCollections('coll%').length, mySchema.getCollections('coll%')[0]);
+print('getTables("none%"):', mySchema.getTables('none%').length);
+
 //@ Testing specific object retrieval
 print('Retrieving a table:', mySchema.getTable('table1'));
 print('.<table>:', mySchema.table1);
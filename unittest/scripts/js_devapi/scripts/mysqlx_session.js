@@ -12,6 +12,7 @@ validateMember(nodeSessionMembers, 'getCurrentSchema');
 validateMember(nodeSessionMembers, 'getDefaultSchema');
 validateMember(nodeSessionMembers, 'getSchema');
 validateMember(nodeSessionMembers, 'getSchemas');
+validateMember(nodeSessionMembers, 'getStats');
 validateMember(nodeSessionMembers, 'getUri');
 validateMember(nodeSessionMembers, 'setCurrentSchema');
 validateMember(nodeSessionMembers, 'setFetchWarnings');
@@ -128,5 +129,63 @@ print(nodeSession.quoteName('`sample`'));
 print(nodeSession.quoteName('`sample'));
 print(nodeSession.quoteName('sample`'));
 
+//@ NodeSession: executeAsync
+var otherSession = mysqlx.getNodeSession(__uripwd);
+var first = nodeSession.sql('select sleep(0.1), ? as one').bind(1).executeAsync();
+var second = otherSession.sql('select 2 as two').executeAsync();
+var failed = nodeSession.sql('select * from unexisting.tbl').executeAsync();
+var third = nodeSession.sql('select 3 as three').executeAsync();
+print(third.get().fetchOne().three);
+print(first.isDone());
+print(first.get().fetchOne().one);
+print(second.get().fetchOne().two);
+otherSession.close();
+
+//@ NodeSession: executeAsync failed statement
+failed.get();
+
+//@ NodeSession: getStats
+var stats = nodeSession.getStats();
+print(stats.bufferPageSize);
+print(stats.bufferMemoryLimit);
+print(stats.bufferMemoryHighWater >= stats.bufferMemoryInUse);
+print(stats.bufferAllocationFailures);
+
+//@ NodeSession: getStats with a buffer memory limit
+var limitedSession = mysqlx.getNodeSession({ host: __host, port: __port, dbUser: __user, dbPassword: __pwd,
+                                             bufferPageSize: 4096, bufferMemoryLimit: 65536 });
+limitedSession.sql('select 1').execute();
+stats = limitedSession.getStats();
+print(stats.bufferPageSize);
+print(stats.bufferMemoryLimit);
+print(stats.bufferMemoryInUse <= 65536);
+
+//@ NodeSession: getStats traffic
+stats = limitedSession.getStats();
+print(stats.framesSent > stats.sentByType.SQL_STMT_EXECUTE.frames);
+print(stats.receivedByType.RESULTSET_ROW.frames > 0);
+print(stats.bytesReceived > stats.framesReceived * 5);
+print(stats.rowsBuffered >= 0);
+
+//@ NodeSession: statement over the buffer memory limit
+limitedSession.sql('select ?').bind(Array(100000).join('x')).execute();
+
+//@ NodeSession: getStats allocation failures
+print(limitedSession.getStats().bufferAllocationFailures);
+limitedSession.close();
+
+//@ NodeSession: rows read ahead
+var prefetchSession = mysqlx.getNodeSession({ host: __host, port: __port, dbUser: __user, dbPassword: __pwd,
+                                              prefetchRows: 2 });
+var rows = prefetchSession.sql('select 1 as a union all select 2 union all select 3 union all select 4').execute();
+var total = rows.fetchOne().a + rows.fetchOne().a;
+// Another statement in the middle stops the reading, the rest is still there
+print(prefetchSession.sql('select 10 as b').execute().fetchOne().b);
+var row;
+while (row = rows.fetchOne())
+  total += row.a;
+print(total);
+prefetchSession.close();
+
 // Cleanup
 nodeSession.close();
\ No newline at end of file
@@ -20,27 +20,27 @@ table = schema.getTable('table1');
 // ---------------------------------------------
 //@ TableInsert: valid operations after empty insert
 var crud = table.insert();
-validate_crud_functions(crud, ['values']);
+validate_crud_functions(crud, ['values', 'valuesFrom']);
 
 //@ TableInsert: valid operations after empty insert and values
 var crud = crud.values('john', 25, 'male');
-validate_crud_functions(crud, ['values', 'execute']);
+validate_crud_functions(crud, ['values', 'valuesFrom', 'execute']);
 
 //@ TableInsert: valid operations after empty insert and values 2
 var crud = crud.values('alma', 23, 'female');
-validate_crud_functions(crud, ['values', 'execute']);
+validate_crud_functions(crud, ['values', 'valuesFrom', 'execute']);
 
 //@ TableInsert: valid operations after insert with field list
 var crud = table.insert(['name', 'age', 'gender']);
-validate_crud_functions(crud, ['values']);
+validate_crud_functions(crud, ['values', 'valuesFrom']);
 
 //@ TableInsert: valid operations after insert with field list and values
 var crud = crud.values('john', 25, 'male');
-validate_crud_functions(crud, ['values', 'execute']);
+validate_crud_functions(crud, ['values', 'valuesFrom', 'execute']);
 
 //@ TableInsert: valid operations after insert with field list and values 2
 var crud = crud.values('alma', 23, 'female');
-validate_crud_functions(crud, ['values', 'execute']);
+validate_crud_functions(crud, ['values', 'valuesFrom', 'execute']);
 
 //@ TableInsert: valid operations after insert with fields and values
 var crud = table.insert({ name: 'john', age: 25, gender: 'male' });
@@ -112,6 +112,23 @@ catch (err) {
   print("getLastDocumentIds():", err.message, "\n");
 }
 
+//@ Table.insert valuesFrom execution
+result = table.insert('name', 'age', 'gender').valuesFrom([['ann', 31, 'female'], ['bob', 32, 'male'], ['cid', 33, 'male']], { batchRows: 2 }).execute();
+print("Affected Rows From List:", result.affectedItemCount, "\n");
+
+var next_age = 40;
+result = table.insert('name', 'age', 'gender').values('dan', 39, 'male').valuesFrom(function() {
+  return next_age < 45 ? ['dan', next_age++, 'male'] : null;
+}, { batchRows: 2, pipelineDepth: 1 }).execute();
+print("Affected Rows From Function:", result.affectedItemCount, "\n");
+
+try {
+  table.insert('name', 'age', 'gender').valuesFrom(5);
+}
+catch (err) {
+  print(err.message, "\n");
+}
+
 //@ Table.insert execution on a View
 var view = schema.getTable('view1');
 var result = view.insert({ 'my_age': 15, 'my_name': 'jhonny', 'my_gender': 'male' }).execute();
@@ -1,12 +1,13 @@
 //@<OUT> Cluster: getCluster with interaction
 
 //@ Cluster: validating members
-|Cluster Members: 14|
+|Cluster Members: 15|
 |name: OK|
 |getName: OK|
 |adminType: OK|
 |getAdminType: OK|
 |addInstance: OK|
+|addInstances: OK|
 |removeInstance: OK|
 |rejoinInstance: OK|
 |checkInstanceState: OK|
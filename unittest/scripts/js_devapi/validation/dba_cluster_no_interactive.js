@@ -1,10 +1,11 @@
 //@ Cluster: validating members
-|Cluster Members: 14|
+|Cluster Members: 15|
 |name: OK|
 |getName: OK|
 |adminType: OK|
 |getAdminType: OK|
 |addInstance: OK|
+|addInstances: OK|
 |removeInstance: OK|
 |rejoinInstance: OK|
 |checkInstanceState: OK|
@@ -30,6 +31,13 @@
 ||Cluster.addInstance: The instance '<<<hostname>>>:<<<__mysql_sandbox_port1>>>' is already part of this InnoDB cluster
 ||Invalid value for ipWhitelist, string value cannot be empty.
 
+//@# Cluster: addInstances errors
+||Invalid number of arguments in Cluster.addInstances, expected 1 to 2 but got 0
+||Cluster.addInstances: Argument #1 is expected to be an array
+||Cluster.addInstances: The parallel option must be a positive integer
+||Cluster.addInstances: Invalid values in addInstances options: label
+||Cluster.addInstances: The instance 'localhost:<<<__mysql_sandbox_port2>>>' is given more than once
+
 //@ Cluster: addInstance 2
 ||
 
@@ -95,6 +103,15 @@
     }
 }
 
+//@ Cluster: status errors
+||Invalid number of arguments in Cluster.status, expected 0 to 1 but got 2
+||Cluster.status: Invalid values in status options: foo
+||Cluster.status: The timeout option must be a positive number of seconds
+
+//@ Cluster: status extended
+|Member stats: conflictsDetected, superReadOnly, transactionsChecked, transactionsInQueue, version|
+|Super read only: false|
+
 //@ Cluster: removeInstance errors
 ||Invalid number of arguments in Cluster.removeInstance, expected 1 to 2 but got 0
 ||Invalid number of arguments in Cluster.removeInstance, expected 1 to 2 but got 3
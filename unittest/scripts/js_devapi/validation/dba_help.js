@@ -11,6 +11,8 @@ The following functions are currently supported.
 
  - checkInstanceConfiguration      Validates an instance for usage in Group
                                    Replication.
+ - checkInstancesConfiguration     Validates several instances for usage in
+                                   Group Replication.
  - configureLocalInstance          Validates and configures an instance for
                                    cluster usage.
  - createCluster                   Creates a MySQL InnoDB cluster.
@@ -18,6 +20,8 @@ The following functions are currently supported.
                                    localhost.
  - deploySandboxInstance           Creates a new MySQL Server instance on
                                    localhost.
+ - deploySandboxInstances          Creates several new MySQL Server instances
+                                   on localhost.
  - dropMetadataSchema              Drops the Metadata Schema.
  - getCluster                      Retrieves a cluster from the Metadata Store.
  - help                            Provides help about this class and it's
@@ -151,6 +155,8 @@ affected by the provided options:
    pattern (eg %).
  - ignoreSslError: Ignore errors when adding SSL support for the new instance,
    by default: true.
+ - profile: set of configuration values of the new instance, either default or
+   dense, by default: default.
 
 If the portx option is not specified, it will be automatically calculated as 10
 times the value of the provided MySQL port.
@@ -168,6 +174,19 @@ SSL support is added by default if not already available for the new instance,
 but if it fails to be added then the error is ignored. Set the ignoreSslError
 option to false to ensure the new instance is deployed with SSL support.
 
+The data directory of the new instance is cloned from a template data
+directory, which is initialized by the first instance deployed for the MySQL
+Server version and kept in the templates folder of the sandboxDir. Where the
+file system supports it the clone shares the data of the template until it is
+written, otherwise it is a copy. Remove the templates folder to have it
+initialized again.
+
+The dense profile configures the new instance to use little memory, to run many
+instances on the same host (e.g. for tests): a small InnoDB buffer pool, redo
+log and binary log cache, no performance_schema instruments enabled and the
+minimum Group Replication message cache. Values given with the options of the
+instance override the ones of the profile.
+
 
 //@<OUT> Drop Metadata
 Drops the Metadata Schema.
@@ -1,14 +1,16 @@
 //@ Session: validating members
-|Session Members: 14|
+|Session Members: 16|
 |createCluster: OK|
 |deleteSandboxInstance: OK|
 |deploySandboxInstance: OK|
+|deploySandboxInstances: OK|
 |getCluster: OK|
 |help: OK|
 |killSandboxInstance: OK|
 |resetSession: OK|
 |startSandboxInstance: OK|
 |checkInstanceConfiguration: OK|
+|checkInstancesConfiguration: OK|
 |stopSandboxInstance: OK|
 |dropMetadataSchema: OK|
 |configureLocalInstance: OK|
@@ -1,14 +1,16 @@
 //@ Session: validating members
-|Session Members: 14|
+|Session Members: 16|
 |createCluster: OK|
 |deleteSandboxInstance: OK|
 |deploySandboxInstance: OK|
+|deploySandboxInstances: OK|
 |getCluster: OK|
 |help: OK|
 |killSandboxInstance: OK|
 |resetSession: OK|
 |startSandboxInstance: OK|
 |checkInstanceConfiguration: OK|
+|checkInstancesConfiguration: OK|
 |stopSandboxInstance: OK|
 |dropMetadataSchema: OK|
 |configureLocalInstance: OK|
@@ -157,3 +159,21 @@
 
 //@ Dba: getCluster
 |<Cluster:devCluster>|
+
+//@# Dba: deploySandboxInstances errors
+||Invalid number of arguments in Dba.deploySandboxInstances, expected 1 to 2 but got 0
+||Dba.deploySandboxInstances: Argument #1 is expected to be an array
+||Dba.deploySandboxInstances: Invalid values in the instance data: portx
+||Dba.deploySandboxInstances: Missing root password for the deployed instances
+||Dba.deploySandboxInstances: The parallel option must be a positive integer
+||Dba.deploySandboxInstances: The ports must be integer values
+||Dba.deploySandboxInstances: Invalid value for 'port': Please use a valid TCP port number >= 1024 and <= 65535
+||Dba.deploySandboxInstances: The port 5000 is given more than once
+
+//@# Dba: checkInstancesConfiguration errors
+||Invalid number of arguments in Dba.checkInstancesConfiguration, expected 1 to 2 but got 0
+||Dba.checkInstancesConfiguration: Argument #1 is expected to be an array
+||Dba.checkInstancesConfiguration: Invalid values in validation options: portx
+||Dba.checkInstancesConfiguration: The parallel option must be a positive integer
+||Dba.checkInstancesConfiguration: Invalid connection options, expected either a URI or a Dictionary
+||Dba.checkInstancesConfiguration: The instance 'localhost:3306' is given more than once
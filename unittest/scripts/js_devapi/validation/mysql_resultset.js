@@ -15,6 +15,7 @@
 |getInfo: OK|
 |fetchOne: OK|
 |fetchAll: OK|
+|fetchMany: OK|
 |hasData: OK|
 |nextDataSet: OK|
 |affectedRowCount: OK|
@@ -63,4 +64,51 @@
 // Resultset property access
 |Name with property: jack|
 |Age with property: 17|
-|Unable to get length with property: 4|
\ No newline at end of file
+|Unable to get length with property: 4|
+
+//@ Resultset fetchMany
+|First chunk: 3 adam angel|
+|Second chunk: 3 brian donna|
+|Third chunk: 1 jack|
+|Last chunk: 0|
+
+//@ Resultset fetchMany with maxBytes
+|Rows within limit: 2|
+
+//@# Resultset fetchMany errors
+||Invalid number of arguments in ClassicResult.fetchMany, expected 1 to 2 but got 0
+||ClassicResult.fetchMany: The row count must be greater than 0
+||ClassicResult.fetchMany: Invalid values in fetch options: rows
+
+//@ Session runSqlPaged
+|Paged rows: 7 adam,alma,angel,brian,carol,donna,jack|
+
+//@ Session runSqlPaged with composite key and fetchMany
+|First chunk: 4 alma carol|
+|Second chunk: 3 adam jack|
+
+//@# Session runSqlPaged errors
+||Invalid number of arguments in ClassicSession.runSqlPaged, expected 2 to 3 but got 1
+||Argument #2 is expected to be either a string or a list of strings
+||At least one key column is required
+||The key column 'age' is not part of the query result
+||The value for 'chunkSize' must be greater than 0
+
+//@ Session prepare
+|Parameters: 1|
+|First execution: alma number|
+|Second execution: jack|
+
+//@# Session prepare errors
+||unexisting_table' doesn't exist
+||The statement expects 1 parameters, 0 given
+||The statement is closed
+
+//@ Session prepare with long data
+|Data length: 3000000|
+|Data part: xx|
+
+//@ Session prepare with a stream
+|Written: 3000000|
+|Streamed: [1,3000000,"ab"]|
+|Not streamed: [2,null,null]|
@@ -32,6 +32,10 @@
 //@ Testing tables, views and collection retrieval
 |getTables(): <ClassicTable:|
 
+//@ Testing tables retrieval by pattern
+|getTables("view%"): 1 <ClassicTable:view1>|
+|getTables("none%"): 0|
+
 //@ Testing specific object retrieval
 |Retrieving a table: <ClassicTable:table1>|
 |.<table>: <ClassicTable:table1>|
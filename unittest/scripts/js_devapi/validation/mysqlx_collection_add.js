@@ -65,3 +65,11 @@
 |Affected Rows Single Expression: 1|
 |Affected Rows Mixed List: 2|
 |Affected Rows Multiple Params: 2|
+
+//@ Collection.add execution in chunks
+|Affected Rows Chunked: 5|
+|#lastDocumentIds Chunked: 5|
+
+//@# CollectionAdd: Error conditions on execute
+||CollectionAdd.execute: Invalid values in execute options: invalid
+||CollectionAdd.execute: The value for 'pipelineDepth' must be greater than 0
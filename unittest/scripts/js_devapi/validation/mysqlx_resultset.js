@@ -13,6 +13,7 @@
 |getColumns: OK|
 |fetchOne: OK|
 |fetchAll: OK|
+|fetchColumns: OK|
 |hasData: OK|
 |nextDataSet: OK|
 |affectedRowCount: OK|
@@ -50,6 +51,9 @@
 |getColumns: OK|
 |fetchOne: OK|
 |fetchAll: OK|
+|fetchColumns: OK|
+|forEachBatch: OK|
+|batches: OK|
 
 //@ DocResult member validation
 |executionTime: OK|
@@ -60,6 +64,7 @@
 |getWarnings: OK|
 |fetchOne: OK|
 |fetchAll: OK|
+|fetchRaw: OK|
 
 //@ Resultset hasData false
 |hasData: false|
@@ -143,4 +148,40 @@
 // Resultset property access
 |Name with property: jack|
 |Age with property: 17|
-|Unable to get length with property: 4|
\ No newline at end of file
+|Unable to get length with property: 4|
+
+//@ Resultset row fields after the result is consumed
+|Remaining rows: 0|
+|Fields from consumed result: jack 17|
+|Fields read again: jack 17|
+
+//@ DocResult fetchRaw
+|Raw type: string|
+|Raw parsed: jack 2|
+|Raw after last: null|
+
+//@ Row readField
+|Part: xx|
+|Part length: 1000|
+|Past end: []|
+|Null: null|
+|Name: ac|
+
+//@ RowResult forEachBatch
+|Batch sizes: 3,3,1 of 7|
+|Stopped after: adam,angel of 4|
+|Left: 3|
+
+//@ RowResult batches by column
+|First: adam,alma,angel,brian 4|
+|Second: carol,donna,jack 3|
+|Last: null|
+
+//@ RowResult batches with invalid options
+||RowResult.batches: The value for 'size' must be greater than 0
+||RowResult.batches: The value for 'format' must be either 'rows' or 'columns'
+||RowResult.forEachBatch: Invalid values in batch options: rows
+
+//@ TableInsert with a file content
+|Written: 100000|
+|Inserted: 1 100000 xx|
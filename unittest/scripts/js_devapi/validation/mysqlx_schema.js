@@ -38,6 +38,11 @@
 |getTables(): <Table:table1>|
 |getCollections(): <Collection:collection1>|
 
+//@ Testing tables and collection retrieval by pattern
+|getTables("table%"): 1 <Table:table1>|
+|getCollections("coll%"): 1 <Collection:collection1>|
+|getTables("none%"): 0|
+
 //@ Testing specific object retrieval
 |Retrieving a table: <Table:table1>|
 |.<table>: <Table:table1>|
@@ -5,6 +5,7 @@
 |getDefaultSchema: OK|
 |getSchema: OK|
 |getSchemas: OK|
+|getStats: OK|
 |getUri: OK|
 |setCurrentSchema: OK|
 |setFetchWarnings: OK|
@@ -75,3 +76,39 @@
 |```sample```|
 |```sample`|
 |`sample```|
+
+//@ NodeSession: executeAsync
+|3|
+|true|
+|1|
+|2|
+
+//@ NodeSession: executeAsync failed statement
+||Table 'unexisting.tbl' doesn't exist
+
+//@ NodeSession: getStats
+|65536|
+|0|
+|true|
+|0|
+
+//@ NodeSession: getStats with a buffer memory limit
+|4096|
+|65536|
+|true|
+
+//@ NodeSession: getStats traffic
+|true|
+|true|
+|true|
+|true|
+
+//@ NodeSession: statement over the buffer memory limit
+||over the limit of 65536 bytes
+
+//@ NodeSession: getStats allocation failures
+|1|
+
+//@ NodeSession: rows read ahead
+|10|
+|10|
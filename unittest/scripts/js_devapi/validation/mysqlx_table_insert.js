@@ -49,5 +49,10 @@
 |lastDocumentIds: Result.getLastDocumentIds: document ids are not available.|
 |getLastDocumentIds(): Result.getLastDocumentIds: document ids are not available.|
 
+//@ Table.insert valuesFrom execution
+|Affected Rows From List: 3|
+|Affected Rows From Function: 6|
+|TableInsert.valuesFrom: Argument #1 is expected to be either a list of rows, a function or a file path|
+
 //@ Table.insert execution on a View
 |Affected Rows Through View: 1|
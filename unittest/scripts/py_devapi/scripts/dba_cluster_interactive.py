@@ -24,6 +24,7 @@ validateMember(members, 'get_name');
 validateMember(members, 'admin_type');
 validateMember(members, 'get_admin_type');
 validateMember(members, 'add_instance');
+validateMember(members, 'add_instances');
 validateMember(members, 'remove_instance');
 validateMember(members, 'rejoin_instance');
 validateMember(members, 'check_instance_state');
@@ -16,6 +16,7 @@ print "Session Members: %d" % len(members)
 validateMember(members, 'create_cluster');
 validateMember(members, 'delete_sandbox_instance');
 validateMember(members, 'deploy_sandbox_instance');
+validateMember(members, 'deploy_sandbox_instances');
 validateMember(members, 'drop_metadata_schema');
 validateMember(members, 'get_cluster');
 validateMember(members, 'help');
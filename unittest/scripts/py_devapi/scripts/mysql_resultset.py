@@ -29,6 +29,7 @@ validateMember(members, 'get_columns')
 validateMember(members, 'get_info')
 validateMember(members, 'fetch_one')
 validateMember(members, 'fetch_all')
+validateMember(members, 'fetch_many')
 validateMember(members, 'has_data')
 validateMember(members, 'next_data_set')
 validateMember(members, 'affected_row_count')
@@ -112,4 +113,46 @@ print "Name with property: %s" % row.alias
 print "Age with property: %s" % row.age
 print "Unable to get length with property: %s" %  row.length
 
+#@ Resultset fetch_many
+result = mySession.run_sql('select name from buffer_table order by name')
+rows = result.fetch_many(3)
+print 'First chunk:', len(rows), rows[0].name, rows[2].name
+rows = result.fetch_many(3)
+print 'Second chunk:', len(rows), rows[0].name, rows[2].name
+rows = result.fetch_many(3)
+print 'Third chunk:', len(rows), rows[0].name
+rows = result.fetch_many(3)
+print 'Last chunk:', len(rows)
+
+#@ Resultset fetch_many with maxBytes
+result = mySession.run_sql('select name from buffer_table order by name')
+rows = result.fetch_many(5, {'maxBytes': 8})
+print 'Rows within limit:', len(rows)
+
+#@# Resultset fetch_many errors
+result = mySession.run_sql('select name from buffer_table order by name')
+result.fetch_many()
+result.fetch_many(0)
+result.fetch_many(1, {'rows': 1})
+
+#@ Session run_sql_paged
+result = mySession.run_sql_paged('select name, age from buffer_table', 'name', {'chunkSize': 2})
+rows = result.fetch_all()
+names = [row.name for row in rows]
+print 'Paged rows:', len(rows), ','.join(names)
+
+#@ Session run_sql_paged with composite key and fetch_many
+result = mySession.run_sql_paged('select age, name from buffer_table', ['age', 'name'], {'chunkSize': 3})
+rows = result.fetch_many(4)
+print 'First chunk:', len(rows), rows[0].name, rows[3].name
+rows = result.fetch_many(4)
+print 'Second chunk:', len(rows), rows[0].name, rows[2].name
+
+#@# Session run_sql_paged errors
+mySession.run_sql_paged('select name from buffer_table')
+mySession.run_sql_paged('select name from buffer_table', 5)
+mySession.run_sql_paged('select name from buffer_table', [])
+mySession.run_sql_paged('select name from buffer_table', 'age')
+mySession.run_sql_paged('select name from buffer_table', 'name', {'chunkSize': 0})
+
 mySession.close()
@@ -130,6 +130,17 @@ result = collection.add({ "name": 'my eigth', "passed": 'yep', "count": 6 }, mys
 print "Affected Rows Multiple Params:", result.affected_item_count, "\n"
 //! [CollectionAdd: Multiple Parameters]
 
+#@ Collection.add execution in chunks
+result = collection.add([{ 'name': 'chunk 1', 'count': 7 }, { 'name': 'chunk 2', 'count': 7 }, { 'name': 'chunk 3', 'count': 7 },
+                         { 'name': 'chunk 4', 'count': 7 }, { 'name': 'chunk 5', 'count': 7 }]).execute({'chunkSize': 2, 'pipelineDepth': 2})
+print "Affected Rows Chunked:", result.affected_item_count, "\n"
+print "#last_document_ids Chunked:", len(result.last_document_ids), "\n"
+
+#@# CollectionAdd: Error conditions on execute
+crud = collection.add({ 'name': 'sample' })
+crud.execute({ 'chunkSize': 2, 'invalid': 1 })
+crud.execute({ 'pipelineDepth': 0 })
+
 # Cleanup
 mySession.drop_schema('js_shell_test')
 mySession.close()
@@ -27,6 +27,8 @@ validateMember(sqlMembers, 'get_column_names')
 validateMember(sqlMembers, 'get_columns')
 validateMember(sqlMembers, 'fetch_one')
 validateMember(sqlMembers, 'fetch_all')
+validateMember(sqlMembers, 'fetch_columns')
+validateMember(sqlMembers, 'to_arrow')
 validateMember(sqlMembers, 'has_data')
 validateMember(sqlMembers, 'next_data_set')
 validateMember(sqlMembers, 'affected_row_count')
@@ -81,6 +83,8 @@ validateMember(rowResultMembers, 'get_column_names')
 validateMember(rowResultMembers, 'get_columns')
 validateMember(rowResultMembers, 'fetch_one')
 validateMember(rowResultMembers, 'fetch_all')
+validateMember(rowResultMembers, 'fetch_columns')
+validateMember(rowResultMembers, 'to_arrow')
 
 #@ DocResult member validation
 result = collection.find().execute()
@@ -94,6 +98,7 @@ validateMember(docResultMembers, 'get_warning_count')
 validateMember(docResultMembers, 'get_warnings')
 validateMember(docResultMembers, 'fetch_one')
 validateMember(docResultMembers, 'fetch_all')
+validateMember(docResultMembers, 'fetch_raw')
 
 #@ Resultset has_data() False
 result = mySession.sql('use js_shell_test').execute()
@@ -241,4 +246,35 @@ print "Name with property: %s" % row.alias
 print "Age with property: %s" % row.age
 print "Unable to get length with property: %s" %  row.length
 
+#@ Resultset row fields after the result is consumed
+result = mySession.sql('select name, age from buffer_table where name = "jack"').execute()
+row = result.fetch_one()
+remaining = result.fetch_all()
+print "Remaining rows: %s" % len(remaining)
+print "Fields from consumed result: %s %s" % (row.name, row[1])
+print "Fields read again: %s %s" % (row.get_field('name'), row.age)
+
+#@ Resultset fetch_columns
+result = mySession.sql('select name, age from buffer_table order by name').execute()
+columns = result.fetch_columns()
+ages = columns['age']
+print "Column values: %s %s" % (len(columns['name']), ages.length)
+print "Null count: %s %s" % (ages.null_count, ages.nulls)
+print "First values: %s %s" % (columns['name'][0], ages[0])
+
+import struct
+view = memoryview(ages)
+print "Buffer format: %s %s %s" % (view.format, view.itemsize, len(view))
+print "Buffer values: %s" % list(struct.unpack('%dq' % len(view), view.tobytes()))
+print "Remaining rows: %s" % len(result.fetch_all())
+
+#@ DocResult fetch_raw
+import json
+collection.add({'_id': 'raw', 'name': 'jack', 'tags': ['a', 'b']}).execute()
+result = collection.find('_id = "raw"').execute()
+raw = result.fetch_raw()
+print "Raw type: %s" % type(raw).__name__
+print "Raw parsed: %s %s" % (json.loads(raw)['name'], len(json.loads(raw)['tags']))
+print "Raw after last: %s" % result.fetch_raw()
+
 mySession.close()
@@ -19,6 +19,7 @@ validateMember(nodeSessionMembers, 'get_current_schema')
 validateMember(nodeSessionMembers, 'get_default_schema')
 validateMember(nodeSessionMembers, 'get_schema')
 validateMember(nodeSessionMembers, 'get_schemas')
+validateMember(nodeSessionMembers, 'get_stats')
 validateMember(nodeSessionMembers, 'get_uri')
 validateMember(nodeSessionMembers, 'set_current_schema')
 validateMember(nodeSessionMembers, 'set_fetch_warnings')
@@ -133,5 +134,20 @@ print nodeSession.quote_name('`sample`')
 print nodeSession.quote_name('`sample')
 print nodeSession.quote_name('sample`')
 
+#@ NodeSession: execute_async
+otherSession = mysqlx.get_node_session(__uripwd)
+first = nodeSession.sql('select sleep(0.1), ? as one').bind(1).execute_async()
+second = otherSession.sql('select 2 as two').execute_async()
+failed = nodeSession.sql('select * from unexisting.tbl').execute_async()
+third = nodeSession.sql('select 3 as three').execute_async()
+print third.get().fetch_one().three
+print first.is_done()
+print first.get().fetch_one().one
+print second.get().fetch_one().two
+otherSession.close()
+
+#@ NodeSession: execute_async failed statement
+failed.get()
+
 # Cleanup
 nodeSession.close()
\ No newline at end of file
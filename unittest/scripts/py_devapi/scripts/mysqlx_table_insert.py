@@ -20,27 +20,27 @@ table = schema.get_table('table1')
 # ---------------------------------------------
 #@ TableInsert: valid operations after empty insert
 crud = table.insert()
-validate_crud_functions(crud, ['values'])
+validate_crud_functions(crud, ['values', 'values_from'])
 
 #@ TableInsert: valid operations after empty insert and values
 crud = crud.values('john', 25, 'male')
-validate_crud_functions(crud, ['values', 'execute'])
+validate_crud_functions(crud, ['values', 'values_from', 'execute'])
 
 #@ TableInsert: valid operations after empty insert and values 2
 crud = crud.values('alma', 23, 'female')
-validate_crud_functions(crud, ['values', 'execute'])
+validate_crud_functions(crud, ['values', 'values_from', 'execute'])
 
 #@ TableInsert: valid operations after insert with field list
 crud = table.insert(['name', 'age', 'gender'])
-validate_crud_functions(crud, ['values'])
+validate_crud_functions(crud, ['values', 'values_from'])
 
 #@ TableInsert: valid operations after insert with field list and values
 crud = crud.values('john', 25, 'male')
-validate_crud_functions(crud, ['values', 'execute'])
+validate_crud_functions(crud, ['values', 'values_from', 'execute'])
 
 #@ TableInsert: valid operations after insert with field list and values 2
 crud = crud.values('alma', 23, 'female')
-validate_crud_functions(crud, ['values', 'execute'])
+validate_crud_functions(crud, ['values', 'values_from', 'execute'])
 
 #@ TableInsert: valid operations after insert with fields and values
 crud = table.insert({"name":'john', "age":25, "gender":'male'})
@@ -105,6 +105,19 @@ try:
 except Exception, err:
   print "get_last_document_ids():", str(err), "\n"
 
+#@ Table.insert values_from execution
+result = table.insert('name', 'age', 'gender').values_from([['ann', 31, 'female'], ['bob', 32, 'male'], ['cid', 33, 'male']], {'batchRows': 2}).execute()
+print "Affected Rows From List:", result.affected_item_count, "\n"
+
+rows = iter([['dan', age, 'male'] for age in range(40, 45)])
+result = table.insert('name', 'age', 'gender').values('dan', 39, 'male').values_from(lambda: next(rows, None), {'batchRows': 2, 'pipelineDepth': 1}).execute()
+print "Affected Rows From Function:", result.affected_item_count, "\n"
+
+try:
+  table.insert('name', 'age', 'gender').values_from(5)
+except Exception, err:
+  print str(err), "\n"
+
 #@ Table.insert execution on a View
 view = schema.get_table('view1')
 result = view.insert({ 'my_age': 15, 'my_name': 'jhonny', 'my_gender': 'male' }).execute()
@@ -1,10 +1,11 @@
 #@ Cluster: validating members
-|Cluster Members: 14|
+|Cluster Members: 15|
 |name: OK|
 |get_name: OK|
 |admin_type: OK|
 |get_admin_type: OK|
 |add_instance: OK|
+|add_instances: OK|
 |remove_instance: OK|
 |rejoin_instance: OK|
 |check_instance_state: OK|
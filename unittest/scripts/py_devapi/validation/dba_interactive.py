@@ -1,8 +1,9 @@
 #@ Session: validating members
-|Session Members: 14|
+|Session Members: 15|
 |create_cluster: OK|
 |delete_sandbox_instance: OK|
 |deploy_sandbox_instance: OK|
+|deploy_sandbox_instances: OK|
 |get_cluster: OK|
 |help: OK|
 |kill_sandbox_instance: OK|
@@ -15,6 +15,7 @@
 |get_info: OK|
 |fetch_one: OK|
 |fetch_all: OK|
+|fetch_many: OK|
 |has_data: OK|
 |next_data_set: OK|
 |affected_row_count: OK|
@@ -63,4 +64,32 @@
 # Resultset property access
 |Name with property: jack|
 |Age with property: 17|
-|Unable to get length with property: 4|
\ No newline at end of file
+|Unable to get length with property: 4|
+
+#@ Resultset fetch_many
+|First chunk: 3 adam angel|
+|Second chunk: 3 brian donna|
+|Third chunk: 1 jack|
+|Last chunk: 0|
+
+#@ Resultset fetch_many with maxBytes
+|Rows within limit: 2|
+
+#@# Resultset fetch_many errors
+||Invalid number of arguments in ClassicResult.fetch_many, expected 1 to 2 but got 0
+||ClassicResult.fetch_many: The row count must be greater than 0
+||ClassicResult.fetch_many: Invalid values in fetch options: rows
+
+#@ Session run_sql_paged
+|Paged rows: 7 adam,alma,angel,brian,carol,donna,jack|
+
+#@ Session run_sql_paged with composite key and fetch_many
+|First chunk: 4 alma carol|
+|Second chunk: 3 adam jack|
+
+#@# Session run_sql_paged errors
+||Invalid number of arguments in ClassicSession.run_sql_paged, expected 2 to 3 but got 1
+||Argument #2 is expected to be either a string or a list of strings
+||At least one key column is required
+||The key column 'age' is not part of the query result
+||The value for 'chunkSize' must be greater than 0
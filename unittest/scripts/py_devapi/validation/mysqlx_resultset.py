@@ -13,6 +13,7 @@
 |get_columns: OK|
 |fetch_one: OK|
 |fetch_all: OK|
+|fetch_columns: OK|
 |has_data: OK|
 |next_data_set: OK|
 |affected_row_count: OK|
@@ -50,6 +51,7 @@
 |get_columns: OK|
 |fetch_one: OK|
 |fetch_all: OK|
+|fetch_columns: OK|
 
 #@ DocResult member validation
 |execution_time: OK|
@@ -60,6 +62,7 @@
 |get_warnings: OK|
 |fetch_one: OK|
 |fetch_all: OK|
+|fetch_raw: OK|
 
 #@ Resultset has_data() False
 |has_data(): False|
@@ -143,4 +146,22 @@
 # Resultset property access
 |Name with property: jack|
 |Age with property: 17|
-|Unable to get length with property: 4|
\ No newline at end of file
+|Unable to get length with property: 4|
+
+#@ Resultset row fields after the result is consumed
+|Remaining rows: 0|
+|Fields from consumed result: jack 17|
+|Fields read again: jack 17|
+
+#@ Resultset fetch_columns
+|Column values: 7 7|
+|Null count: 0 None|
+|First values: adam 15|
+|Buffer format: q 8 7|
+|Buffer values: [15, 13, 14, 14, 14, 16, 17]|
+|Remaining rows: 0|
+
+#@ DocResult fetch_raw
+|Raw type: str|
+|Raw parsed: jack 2|
+|Raw after last: None|
@@ -5,6 +5,7 @@
 |get_default_schema: OK|
 |get_schema: OK|
 |get_schemas: OK|
+|get_stats: OK|
 |get_uri: OK|
 |set_current_schema: OK|
 |set_fetch_warnings: OK|
@@ -74,4 +75,13 @@
 |`sam``ple`|
 |```sample```|
 |```sample`|
-|`sample```|
\ No newline at end of file
+|`sample```|
+
+#@ NodeSession: execute_async
+|3|
+|True|
+|1|
+|2|
+
+#@ NodeSession: execute_async failed statement
+||Table 'unexisting.tbl' doesn't exist
\ No newline at end of file
@@ -49,5 +49,10 @@
 |last_document_ids: LogicError: Result.get_last_document_ids: document ids are not available.|
 |get_last_document_ids(): LogicError: Result.get_last_document_ids: document ids are not available.|
 
+#@ Table.insert values_from execution
+|Affected Rows From List: 3|
+|Affected Rows From Function: 6|
+|TableInsert.values_from: Argument #1 is expected to be either a list of rows, a function or a file path|
+
 #@ Table.insert execution on a View
 |Affected Rows Through View: 1|
@@ -127,6 +127,10 @@ public:
       return AS__STRING(options->recreate_database);
     else if (option == "trace_protocol")
       return AS__STRING(options->trace_protocol);
+    else if (option == "compression")
+      return options->compression;
+    else if (option == "trace_protocol_file")
+      return options->trace_protocol_file;
     else if (option == "log_level")
       return AS__STRING(options->log_level);
     else if (option == "initial-mode")
@@ -441,6 +445,7 @@ TEST(Shell_cmdline_options, default_values) {
   EXPECT_TRUE(options.ssl_info.ciphers.empty());
   EXPECT_TRUE(options.ssl_info.tls_version.empty());
   EXPECT_FALSE(options.trace_protocol);
+  EXPECT_TRUE(options.trace_protocol_file.empty());
   EXPECT_TRUE(options.uri.empty());
   EXPECT_TRUE(options.user.empty());
   EXPECT_TRUE(options.execute_statement.empty());
@@ -475,6 +480,7 @@ TEST_F(Shell_cmdline_options_t, app) {
   test_option_with_value("ssl", "", "yes", "1", IS_CONNECTION_DATA, !IS_NULLABLE, "", "1");
   //test_option_with_value("ssl", "", "no", "1", !IS_CONNECTION_DATA, !IS_NULLABLE, "", "0");
 
+  test_option_with_value("trace-proto-file", "", "/tmp/x.trace", "", !IS_CONNECTION_DATA, !IS_NULLABLE, "trace_protocol_file");
   test_option_with_value("execute", "e", "show databases;", "", !IS_CONNECTION_DATA, !IS_NULLABLE, "execute_statement");
 
   test_option_with_no_value("--classic", "session-type", session_type_name(mysqlsh::SessionType::Classic));
@@ -499,11 +505,13 @@ TEST_F(Shell_cmdline_options_t, app) {
 
   test_option_with_value("json", "", "pretty", "json", !IS_CONNECTION_DATA, IS_NULLABLE, "output_format", "json");
   test_option_with_value("json", "", "raw", "json", !IS_CONNECTION_DATA, IS_NULLABLE, "output_format", "json/raw");
+  test_option_with_value("json", "", "ndjson", "json", !IS_CONNECTION_DATA, IS_NULLABLE, "output_format", "json/ndjson");
   test_option_with_no_value("--json", "output_format", "json");
   test_option_with_no_value("--table", "output_format", "table");
   test_option_with_no_value("--vertical", "output_format", "vertical");
   test_option_with_no_value("-E", "output_format", "vertical");
   test_option_with_no_value("--trace-proto", "trace_protocol", "1");
+  test_option_with_no_value("--compress", "compression", "auto");
   test_option_with_no_value("--force", "force", "1");
   test_option_with_no_value("--interactive", "interactive", "1");
   test_option_with_no_value("-i", "interactive", "1");
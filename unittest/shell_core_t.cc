@@ -26,12 +26,14 @@
 #include "shellcore/common.h"
 
 #include "shellcore/shell_core.h"
+#include "shellcore/shell_core_options.h"
 #include "shellcore/shell_sql.h"
 #include "../modules/base_session.h"
 #include "../modules/base_resultset.h"
 #include "shell/shell_resultset_dumper.h"
 #include "test_utils.h"
 #include "utils/utils_file.h"
+#include "utils/utils_memory.h"
 
 namespace shcore {
 namespace shell_core_tests {
@@ -326,5 +328,26 @@ TEST_F(Shell_core_test, autocache_shell_connect_node) {
   wipe_all();
   execute("session.close();");
 }
+
+TEST(Shell_core_options, typed_follows_map) {
+  auto options = Shell_core_options::get();
+
+  // Writes to the map are seen by the typed options
+  (*options)[SHCORE_OUTPUT_STREAMING] = Value::True();
+  (*options)[SHCORE_OUTPUT_FORMAT] = Value("json/raw");
+  EXPECT_TRUE(Shell_core_options::typed().output_streaming);
+  EXPECT_TRUE(Shell_core_options::typed().output_format == Typed_core_options::Output_format::Json_raw);
+
+  (*options)[SHCORE_OUTPUT_STREAMING] = Value::False();
+  (*options)[SHCORE_OUTPUT_FORMAT] = Value("table");
+  EXPECT_FALSE(Shell_core_options::typed().output_streaming);
+  EXPECT_TRUE(Shell_core_options::typed().output_format == Typed_core_options::Output_format::Table);
+
+  // The memory budget is applied when the option is set
+  Shell_core_options::set(SHCORE_MEMORY_BUDGET, Value(2));
+  EXPECT_EQ(2u * 1024 * 1024, Memory_budget::get().limit());
+  Shell_core_options::set(SHCORE_MEMORY_BUDGET, Value(0));
+  EXPECT_EQ(0u, Memory_budget::get().limit());
+}
 }
 }
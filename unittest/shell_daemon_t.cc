@@ -0,0 +1,332 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+
+#ifndef WIN32
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "src/shell_daemon.h"
+
+namespace mysqlsh {
+namespace daemon {
+// The two ends of a connected Unix socket
+class Shell_daemon_test : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    // A write to a closed socket must fail, not end the test
+    signal(SIGPIPE, SIG_IGN);
+
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    _local = fds[0];
+    _peer = fds[1];
+  }
+
+  virtual void TearDown() {
+    close_peer();
+    if (_local >= 0)
+      ::close(_local);
+  }
+
+  void close_peer() {
+    if (_peer >= 0)
+      ::close(_peer);
+    _peer = -1;
+  }
+
+  int _local;
+  int _peer;
+};
+
+TEST_F(Shell_daemon_test, send_and_receive) {
+  ASSERT_TRUE(write_frame(_local, k_statement, "print('hello')"));
+  ASSERT_TRUE(write_frame(_local, k_argument, ""));
+
+  char type;
+  std::string data;
+  ASSERT_TRUE(read_frame(_peer, &type, &data));
+  EXPECT_EQ(k_statement, type);
+  EXPECT_EQ("print('hello')", data);
+
+  ASSERT_TRUE(read_frame(_peer, &type, &data));
+  EXPECT_EQ(k_argument, type);
+  EXPECT_EQ("", data);
+
+  // And the other way
+  ASSERT_TRUE(write_frame(_peer, k_exit_code, "0"));
+  ASSERT_TRUE(read_frame(_local, &type, &data));
+  EXPECT_EQ(k_exit_code, type);
+  EXPECT_EQ("0", data);
+}
+
+TEST_F(Shell_daemon_test, large_frame) {
+  // Larger than the buffer of the socket, so it is written and read in parts
+  std::string sent(4 * 1024 * 1024, 'x');
+  for (size_t index = 0; index < sent.size(); index += 4093)
+    sent[index] = static_cast<char>(index % 251);
+
+  bool written = false;
+  std::thread writer([this, &sent, &written]() { written = write_frame(_peer, k_stdout, sent); });
+
+  char type;
+  std::string data;
+  bool received = read_frame(_local, &type, &data);
+  writer.join();
+
+  EXPECT_TRUE(written);
+  ASSERT_TRUE(received);
+  EXPECT_EQ(k_stdout, type);
+  EXPECT_TRUE(sent == data);
+}
+
+TEST_F(Shell_daemon_test, partial_reads) {
+  std::string frame;
+  {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_TRUE(write_frame(fds[0], k_stderr, "split in pieces"));
+    ::close(fds[0]);
+
+    char buffer[64];
+    ssize_t size;
+    while ((size = ::read(fds[1], buffer, sizeof(buffer))) > 0)
+      frame.append(buffer, size);
+    ::close(fds[1]);
+  }
+  ASSERT_EQ(5u + 15u, frame.size());
+
+  // The frame arrives a byte at a time, the header included
+  std::thread writer([this, &frame]() {
+    for (char byte : frame) {
+      if (::write(_peer, &byte, 1) != 1)
+        return;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  char type;
+  std::string data;
+  bool received = read_frame(_local, &type, &data);
+  writer.join();
+
+  ASSERT_TRUE(received);
+  EXPECT_EQ(k_stderr, type);
+  EXPECT_EQ("split in pieces", data);
+}
+
+TEST_F(Shell_daemon_test, closed) {
+  char type;
+  std::string data;
+
+  // Closed in the middle of the data
+  const char truncated[] = { k_stdout, 0, 0, 0, 10, 'a', 'b', 'c' };
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(truncated)), ::write(_peer, truncated, sizeof(truncated)));
+  close_peer();
+  EXPECT_FALSE(read_frame(_local, &type, &data));
+
+  // Closed with no frame at all
+  EXPECT_FALSE(read_frame(_local, &type, &data));
+
+  // Nothing can be written to it
+  EXPECT_FALSE(write_frame(_local, k_statement, "select 1"));
+}
+
+TEST_F(Shell_daemon_test, closed_in_header) {
+  const char header[] = { k_stdout, 0, 0 };
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(header)), ::write(_peer, header, sizeof(header)));
+  close_peer();
+
+  char type;
+  std::string data;
+  EXPECT_FALSE(read_frame(_local, &type, &data));
+}
+
+TEST_F(Shell_daemon_test, frame_too_large) {
+  const unsigned char header[] = { static_cast<unsigned char>(k_stdin), 0xff, 0xff, 0xff, 0xff };
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(header)), ::write(_peer, header, sizeof(header)));
+
+  char type;
+  std::string data;
+  EXPECT_FALSE(read_frame(_local, &type, &data));
+}
+
+// The client against a daemon stand-in listening on a socket file, which
+// streams back the output of the job before its exit code, or closes the
+// connection half way
+class Shell_daemon_client_test : public ::testing::Test {
+protected:
+  virtual void SetUp() {
+    signal(SIGPIPE, SIG_IGN);
+
+    char path[] = "/tmp/mysqlsh_daemon_t_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    ::close(fd);
+    ::unlink(path);
+    _path = path;
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, _path.c_str());
+
+    _listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_LE(0, _listener);
+    ASSERT_EQ(0, bind(_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+    ASSERT_EQ(0, listen(_listener, 1));
+  }
+
+  virtual void TearDown() {
+    if (_listener >= 0)
+      ::close(_listener);
+    ::unlink(_path.c_str());
+  }
+
+  // Runs the client with the statement, the daemon answers with the
+  // frames given until the exit code, if any
+  int run(const std::string &statement, const std::string &exit_code, std::string *job, std::string *out,
+          std::string *err) {
+    std::thread daemon([&]() {
+      int client = accept(_listener, NULL, NULL);
+      if (client < 0)
+        return;
+
+      char type;
+      std::string data;
+      if (read_frame(client, &type, &data) && type == k_statement) {
+        *job = data;
+        write_frame(client, k_stdout, "first ");
+        write_frame(client, k_stderr, "warning");
+        write_frame(client, k_stdout, "second");
+        if (!exit_code.empty())
+          write_frame(client, k_exit_code, exit_code);
+      }
+
+      ::close(client);
+    });
+
+    Shell_options options;
+    options.execute_statement = statement;
+
+    std::stringstream cout_stream;
+    std::stringstream cerr_stream;
+    std::streambuf *old_cout = std::cout.rdbuf(cout_stream.rdbuf());
+    std::streambuf *old_cerr = std::cerr.rdbuf(cerr_stream.rdbuf());
+    int ret_val = run_client(options, _path);
+    std::cout.rdbuf(old_cout);
+    std::cerr.rdbuf(old_cerr);
+
+    daemon.join();
+
+    *out = cout_stream.str();
+    *err = cerr_stream.str();
+    return ret_val;
+  }
+
+  std::string _path;
+  int _listener;
+};
+
+TEST_F(Shell_daemon_client_test, job) {
+  std::string job, out, err;
+  EXPECT_EQ(3, run("select 1", "3", &job, &out, &err));
+  EXPECT_EQ("select 1", job);
+  EXPECT_EQ("first second", out);
+  EXPECT_EQ("warning", err);
+}
+
+TEST_F(Shell_daemon_client_test, closed_by_daemon) {
+  std::string job, out, err;
+  EXPECT_EQ(1, run("select 1", "", &job, &out, &err));
+  EXPECT_EQ("first second", out);
+  EXPECT_EQ("warningThe shell daemon closed the connection before the job ended\n", err);
+}
+
+TEST_F(Shell_daemon_client_test, no_daemon) {
+  ::close(_listener);
+  _listener = -1;
+
+  Shell_options options;
+  options.execute_statement = "select 1";
+
+  std::stringstream cerr_stream;
+  std::streambuf *old_cerr = std::cerr.rdbuf(cerr_stream.rdbuf());
+  int ret_val = run_client(options, _path);
+  std::cerr.rdbuf(old_cerr);
+
+  EXPECT_EQ(1, ret_val);
+  EXPECT_EQ(0u, cerr_stream.str().find("Unable to connect to the shell daemon at " + _path));
+}
+
+TEST_F(Shell_daemon_client_test, socket_in_use) {
+  std::string error;
+  EXPECT_FALSE(free_socket_path(_path, &error));
+  EXPECT_EQ("A shell daemon is already listening on " + _path, error);
+  EXPECT_EQ(0, access(_path.c_str(), F_OK));
+}
+
+TEST_F(Shell_daemon_client_test, stale_socket) {
+  // The socket file stays once nothing listens on it
+  ::close(_listener);
+  _listener = -1;
+  ASSERT_EQ(0, access(_path.c_str(), F_OK));
+
+  std::string error;
+  EXPECT_TRUE(free_socket_path(_path, &error));
+  EXPECT_EQ("", error);
+  EXPECT_NE(0, access(_path.c_str(), F_OK));
+
+  // Nothing to free
+  EXPECT_TRUE(free_socket_path(_path, &error));
+}
+
+TEST(Shell_daemon, socket_path_is_a_file) {
+  char path[] = "/tmp/mysqlsh_daemon_t_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_LE(0, fd);
+  ASSERT_EQ(4, ::write(fd, "data", 4));
+  ::close(fd);
+
+  std::string error;
+  EXPECT_FALSE(free_socket_path(path, &error));
+  EXPECT_EQ(std::string("The path of the daemon socket exists and is not a socket: ") + path, error);
+
+  struct stat info;
+  EXPECT_EQ(0, stat(path, &info));
+  EXPECT_EQ(4, info.st_size);
+  ::unlink(path);
+}
+}
+}
+
+#endif
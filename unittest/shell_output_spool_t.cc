@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "shell/shell_output_spool.h"
+
+namespace mysqlsh {
+namespace {
+std::string replay(Output_spool &spool) {
+  std::string output;
+  spool.replay([&output](const char *data, size_t length) {
+    output.append(data, length);
+    return true;
+  });
+
+  return output;
+}
+}
+
+TEST(Output_spool, memory) {
+  Output_spool spool(1024);
+  Output_spool::print(&spool, "first\n");
+  spool.append(std::string("second\n"));
+
+  EXPECT_FALSE(spool.spilled());
+  EXPECT_EQ(13u, spool.size());
+  EXPECT_EQ("first\nsecond\n", replay(spool));
+}
+
+TEST(Output_spool, spilled) {
+  Output_spool spool(100);
+  std::string expected;
+  for (int index = 0; index < 1000; index++) {
+    std::string line = "| " + std::to_string(index) + " |\n";
+    spool.append(line);
+    expected += line;
+  }
+
+  EXPECT_TRUE(spool.spilled());
+  EXPECT_EQ(expected.size(), spool.size());
+  EXPECT_EQ(expected, replay(spool));
+}
+
+TEST(Output_spool, stop_replay) {
+  Output_spool spool(10);
+  spool.append(std::string(200 * 1024, 'x'));
+
+  size_t written = 0;
+  EXPECT_FALSE(spool.replay([&written](const char *, size_t length) {
+    written += length;
+    return false;
+  }));
+  EXPECT_EQ(64u * 1024, written);
+}
+}
@@ -166,5 +166,37 @@ a: 13)";
   MY_EXPECT_STDOUT_CONTAINS(expected_output);
 }
 
+TEST_F(Shell_output_test, output_streaming_option) {
+  (*options)[SHCORE_OUTPUT_STREAMING] = Value::True();
+
+  std::stringstream stream("select 'x' as a union all select 'long';");
+  _ret_val = _interactive_shell->process_stream(stream, "STDIN", {});
+  EXPECT_EQ(0, _ret_val);
+
+  std::string expected_output =
+R"(+------+
+| a    |
++------+
+| x    |
+| long |
++------+
+2 rows in set)";
+  MY_EXPECT_STDOUT_CONTAINS(expected_output);
+
+  wipe_all();
+  stream.clear();
+  stream.str("select 11 as a, 12 as second\\G");
+  _ret_val = _interactive_shell->process_stream(stream, "STDIN", {});
+
+  expected_output =
+R"(*************************** 1. row ***************************
+     a: 11
+second: 12
+1 row in set)";
+  MY_EXPECT_STDOUT_CONTAINS(expected_output);
+
+  (*options)[SHCORE_OUTPUT_STREAMING] = Value::False();
+}
+
 } //namespace Shell_output_tests
 } //namespace shcore
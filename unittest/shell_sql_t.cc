@@ -13,6 +13,7 @@
  along with this program; if not, write to the Free Software
  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -26,7 +27,9 @@
 
 #include "shellcore/shell_core.h"
 #include "shellcore/shell_sql.h"
+#include "shellcore/shell_core_options.h"
 #include "../modules/base_session.h"
+#include "../modules/base_resultset.h"
 //#include "../modules/mod_session.h"
 //#include "../modules/mod_schema.h"
 #include "shellcore/common.h"
@@ -70,6 +73,11 @@ protected:
     _returned_value = result;
   }
 
+  // The bound process_result(), the tests can not take its address
+  std::function<void(shcore::Value)> result_processor() {
+    return std::bind(&Shell_sql_test::process_result, this, _1);
+  }
+
   shcore::Value handle_input(std::string& query, Input_state& state) {
     env.shell_sql->handle_input(query, state, std::bind(&Shell_sql_test::process_result, this, _1));
 
@@ -488,5 +496,106 @@ TEST_F(Shell_sql_test, continued_stmt_hash_comment_batch) {
   EXPECT_EQ("mysql-sql> ", env.shell_sql->prompt());
 }
 
+TEST_F(Shell_sql_test, script_resumes_cached_statement) {
+  Input_state state;
+  std::string query = "select 1 as one,";
+  handle_input(query, state);
+  EXPECT_EQ(Input_state::ContinuedSingle, state);
+
+  // The script continues the cached statement without scanning it again
+  std::string script = "2 as two -- sample comment\n;select 3 as three;\nselect";
+  env.shell_sql->handle_script(script.data(), script.size(), state, result_processor());
+  EXPECT_EQ(Input_state::ContinuedSingle, state);
+  EXPECT_EQ("select 1 as one,\n2 as two \n;select 3 as three;",
+      env.shell_sql->get_handled_input());
+  EXPECT_EQ("        -> ", env.shell_sql->prompt());
+
+  query = "4 as four;";
+  handle_input(query, state);
+  EXPECT_EQ(Input_state::Ok, state);
+  EXPECT_EQ("select\n4 as four;", env.shell_sql->get_handled_input());
+}
+
+TEST_F(Shell_sql_test, pipelined_statements_node_session) {
+  shcore::Argument_list no_args;
+  env.shell_core->get_dev_session()->close(no_args);
+
+  const char *uri = getenv("MYSQL_URI");
+  const char *pwd = getenv("MYSQL_PWD");
+  const char *xport = getenv("MYSQLX_PORT");
+
+  std::string mysqlx_uri = "mysqlx://";
+  mysqlx_uri.append(uri);
+  if (xport) {
+    mysqlx_uri.append(":");
+    mysqlx_uri.append(xport);
+  }
+
+  Argument_list args;
+  args.push_back(Value(mysqlx_uri));
+  if (pwd)
+    args.push_back(Value(pwd));
+
+  env.shell_core->connect_dev_session(args, mysqlsh::SessionType::Node);
+
+  Shell_core_options::set(SHCORE_BATCH_PIPELINE, Value(3));
+
+  Input_state state;
+  std::string query = "select 1 as one;select 2 as two;select 3 as three;select 4 as four\\G";
+  shcore::Value result = handle_input(query, state);
+
+  Shell_core_options::set(SHCORE_BATCH_PIPELINE, Value(1));
+
+  // All the statements were processed in order and the last result is returned
+  EXPECT_EQ(Input_state::Ok, state);
+  EXPECT_EQ("", query);
+  EXPECT_EQ("select 1 as one;select 2 as two;select 3 as three;select 4 as four\\G",
+      env.shell_sql->get_handled_input());
+  EXPECT_EQ(shcore::Object, result.type);
+  EXPECT_EQ("SqlResult", result.as_object()->class_name());
+}
+
+TEST_F(Shell_sql_test, batch_commit_replays_failed_run) {
+  Shell_core_options::set(SHCORE_INTERACTIVE, Value::False());
+  Shell_core_options::set(SHCORE_BATCH_COMMIT, Value(3));
+
+  // The duplicate rolls back the run, the rows before it are inserted again
+  Input_state state;
+  std::string query = "drop schema if exists shell_sql_batch;create schema shell_sql_batch;"
+      "create table shell_sql_batch.t (id int primary key) engine=innodb;"
+      "insert into shell_sql_batch.t values (1);insert into shell_sql_batch.t values (2);"
+      "insert into shell_sql_batch.t values (1);insert into shell_sql_batch.t values (3);";
+  handle_input(query, state);
+  env.shell_sql->end_input(result_processor());
+
+  Shell_core_options::set(SHCORE_BATCH_COMMIT, Value(0));
+  Shell_core_options::set(SHCORE_INTERACTIVE, Value::True());
+
+  query = "select count(*), @@autocommit from shell_sql_batch.t;";
+  shcore::Value result = handle_input(query, state);
+  auto row = result.as_object()->call("fetchOne", shcore::Argument_list()).as_object<mysqlsh::Row>();
+  EXPECT_EQ(3, row->get_member(0).as_int());
+  EXPECT_EQ(1, row->get_member(1).as_int());
+
+  query = "drop schema shell_sql_batch;";
+  handle_input(query, state);
+}
+
+TEST(Shell_sql_globals, scripting_globals_on_demand) {
+  Shell_test_output_handler output_handler;
+  Shell_core shell_core(&output_handler.deleg);
+
+  // The SQL mode does not initialize any scripting language
+  bool lang_initialized;
+  shell_core.switch_mode(IShell_core::Mode::SQL, lang_initialized);
+  EXPECT_FALSE(lang_initialized);
+
+  // The scripting globals are still available when requested
+  EXPECT_EQ(shcore::Object, shell_core.get_global("dba").type);
+  EXPECT_EQ(shcore::Object, shell_core.get_global("shell").type);
+
+  std::vector<std::string> globals = shell_core.get_global_objects(IShell_core::Mode::JScript);
+  EXPECT_NE(globals.end(), std::find(globals.begin(), globals.end(), "sys"));
+}
 }
 }
@@ -0,0 +1,132 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "../mysqlxtest/common/expr_parser.h"
+#include "../mysqlxtest/common/sql_generator.h"
+
+using namespace mysqlx;
+
+namespace shcore {
+namespace sql_generator_tests {
+static std::string expression(const std::string& input, bool document_mode = true,
+                              const ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar>& args =
+                                ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar>()) {
+  Expr_parser parser(input, document_mode);
+  std::unique_ptr<Mysqlx::Expr::Expr> expr(parser.expr());
+  return Sql_generator::expression(*expr, document_mode, args);
+}
+
+static Mysqlx::Expr::Expr* parse(const std::string& input, bool document_mode = true) {
+  Expr_parser parser(input, document_mode);
+  return parser.expr();
+}
+
+TEST(Sql_generator, expressions) {
+  EXPECT_EQ("(JSON_EXTRACT(doc,'$.name') = 'x')", expression("name = 'x'"));
+  EXPECT_EQ("((JSON_EXTRACT(doc,'$.age') > 18) AND (JSON_EXTRACT(doc,'$.address.city') IN ('a','b')))",
+            expression("age > 18 and address.city in ('a', 'b')"));
+  EXPECT_EQ("(JSON_EXTRACT(doc,'$.tags[0]') LIKE 'a%' ESCAPE '\\\\')", expression("tags[0] like 'a%' escape '\\\\'"));
+  EXPECT_EQ("(NOT (JSON_EXTRACT(doc,'$.a') BETWEEN 1 AND 2))", expression("a not between 1 and 2"));
+  EXPECT_EQ("(NOT (JSON_EXTRACT(doc,'$.done') IS TRUE))", expression("not (done is true)"));
+  EXPECT_EQ("(`age` >= 21)", expression("age >= 21", false));
+  EXPECT_EQ("JSON_EXTRACT(`info`,'$.name')", expression("info->'$.name'", false));
+}
+
+TEST(Sql_generator, quoting) {
+  EXPECT_EQ("concat(JSON_EXTRACT(doc,'$.a'),'it\\'s')", expression("concat(a, \"it's\")"));
+  EXPECT_EQ("(`a``b` = 1)", expression("`a``b` = 1", false));
+}
+
+TEST(Sql_generator, placeholders) {
+  ::google::protobuf::RepeatedPtrField< ::Mysqlx::Datatypes::Scalar> args;
+  Mysqlx::Datatypes::Scalar* value = args.Add();
+  value->set_type(Mysqlx::Datatypes::Scalar::V_SINT);
+  value->set_v_signed_int(-5);
+  value = args.Add();
+  value->set_type(Mysqlx::Datatypes::Scalar::V_STRING);
+  value->mutable_v_string()->set_value("x");
+
+  EXPECT_EQ("((JSON_EXTRACT(doc,'$.a') = -5) OR (JSON_EXTRACT(doc,'$.b') = 'x'))", expression("a = :a or b = :b", true, args));
+  EXPECT_THROW(expression("a = :a or b = :b or c = :c", true, args), Sql_generator_error);
+}
+
+TEST(Sql_generator, find) {
+  Mysqlx::Crud::Find find;
+  find.mutable_collection()->set_schema("test");
+  find.mutable_collection()->set_name("people");
+  find.set_data_model(Mysqlx::Crud::DOCUMENT);
+  EXPECT_EQ("SELECT doc FROM `test`.`people`", Sql_generator::find(find));
+
+  find.set_allocated_criteria(parse("age > 18"));
+  Mysqlx::Crud::Projection* projection = find.add_projection();
+  projection->set_alias("name");
+  projection->set_allocated_source(parse("name"));
+  Mysqlx::Crud::Order* order = find.add_order();
+  order->set_allocated_expr(parse("age"));
+  order->set_direction(Mysqlx::Crud::Order::DESC);
+  find.mutable_limit()->set_row_count(10);
+  find.mutable_limit()->set_offset(20);
+
+  EXPECT_EQ("SELECT JSON_OBJECT('name',JSON_EXTRACT(doc,'$.name')) AS doc FROM `test`.`people` "
+            "WHERE (JSON_EXTRACT(doc,'$.age') > 18) ORDER BY JSON_EXTRACT(doc,'$.age') DESC LIMIT 20,10",
+            Sql_generator::find(find));
+}
+
+TEST(Sql_generator, update) {
+  Mysqlx::Crud::Update update;
+  update.mutable_collection()->set_schema("test");
+  update.mutable_collection()->set_name("people");
+  update.set_data_model(Mysqlx::Crud::DOCUMENT);
+  update.set_allocated_criteria(parse("_id = '1'"));
+
+  Mysqlx::Crud::UpdateOperation* operation = update.add_operation();
+  operation->set_operation(Mysqlx::Crud::UpdateOperation::ITEM_SET);
+  std::unique_ptr<Mysqlx::Expr::Expr> name(parse("name"));
+  operation->mutable_source()->CopyFrom(name->identifier());
+  operation->set_allocated_value(parse("'bob'"));
+  operation = update.add_operation();
+  operation->set_operation(Mysqlx::Crud::UpdateOperation::ITEM_REMOVE);
+  std::unique_ptr<Mysqlx::Expr::Expr> age(parse("age"));
+  operation->mutable_source()->CopyFrom(age->identifier());
+  update.mutable_limit()->set_row_count(1);
+
+  EXPECT_EQ("UPDATE `test`.`people` SET doc=JSON_REMOVE(JSON_SET(doc,'$.name','bob'),'$.age') "
+            "WHERE (JSON_EXTRACT(doc,'$._id') = '1') LIMIT 1",
+            Sql_generator::update(update));
+
+  // Updates on whole columns are only allowed on tables
+  operation->set_operation(Mysqlx::Crud::UpdateOperation::SET);
+  EXPECT_THROW(Sql_generator::update(update), Sql_generator_error);
+}
+
+TEST(Sql_generator, remove) {
+  Mysqlx::Crud::Delete remove;
+  remove.mutable_collection()->set_schema("test");
+  remove.mutable_collection()->set_name("t");
+  remove.set_data_model(Mysqlx::Crud::TABLE);
+  remove.set_allocated_criteria(parse("id < 10", false));
+  remove.mutable_limit()->set_row_count(2);
+
+  EXPECT_EQ("DELETE FROM `test`.`t` WHERE (`id` < 10) LIMIT 2", Sql_generator::remove(remove));
+
+  remove.mutable_limit()->set_offset(1);
+  EXPECT_THROW(Sql_generator::remove(remove), Sql_generator_error);
+}
+}
+}
@@ -13,17 +13,24 @@
  along with this program; if not, write to the Free Software
  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <unordered_set>
+#include <vector>
 #include <boost/lexical_cast.hpp>
 
 #include "gtest/gtest.h"
 #include "shellcore/types.h"
 #include "shellcore/types_cpp.h"
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
 using namespace ::testing;
+using namespace std::placeholders;
 
 namespace shcore {
 namespace tests {
@@ -151,6 +158,86 @@ TEST(Functions, function_wrappers) {
       }
 }
 
+class Dispatch_object : public Cpp_object_bridge {
+public:
+  Dispatch_object() {
+    add_method("fetchOne", std::bind(&Dispatch_object::name_of, this, _1, "fetchOne"), NULL);
+    add_method("getAffectedRowCount", std::bind(&Dispatch_object::name_of, this, _1, "getAffectedRowCount"), NULL);
+    add_method("nextDataSet|next_result", std::bind(&Dispatch_object::name_of, this, _1, "nextDataSet"), NULL);
+    add_property("columnCount", "getColumnCount");
+  }
+
+  virtual std::string class_name() const { return "Dispatch"; }
+  virtual bool operator == (const Object_bridge &UNUSED(other)) const { return false; }
+  virtual Value get_member(const std::string &prop) const {
+    if (prop == "columnCount")
+      return Value(3);
+    return Cpp_object_bridge::get_member(prop);
+  }
+
+  Value name_of(const Argument_list &UNUSED(args), const std::string &name) { return Value(name); }
+
+  void late_method() { add_method("lateMethod", std::bind(&Dispatch_object::name_of, this, _1, "lateMethod"), NULL); }
+  void drop_property() { delete_property("columnCount", "getColumnCount"); }
+  void add_methods(int count) {
+    for (int index = 0; index < count; index++)
+      add_method("getSessionMethod" + std::to_string(index), std::bind(&Dispatch_object::name_of, this, _1, "other"), NULL);
+  }
+};
+
+TEST(Functions, naming_style_dispatch) {
+  Dispatch_object object;
+  Argument_list args;
+
+  EXPECT_TRUE(object.has_method_advanced("fetchOne", LowerCamelCase));
+  EXPECT_TRUE(object.has_method_advanced("fetch_one", LowerCaseUnderscores));
+  EXPECT_FALSE(object.has_method_advanced("fetch_one", LowerCamelCase));
+  EXPECT_FALSE(object.has_method_advanced("fetchOne", LowerCaseUnderscores));
+
+  EXPECT_EQ(Value("fetchOne"), object.call_advanced("fetch_one", args, LowerCaseUnderscores));
+  EXPECT_EQ(Value("getAffectedRowCount"), object.call_advanced("get_affected_row_count", args, LowerCaseUnderscores));
+  EXPECT_EQ(Value("getAffectedRowCount"), object.call_advanced("getAffectedRowCount", args, LowerCamelCase));
+
+  // Functions registered with explicit names for each style
+  EXPECT_EQ(Value("nextDataSet"), object.call_advanced("next_result", args, LowerCaseUnderscores));
+  EXPECT_EQ(Value("nextDataSet"), object.call_advanced("nextDataSet", args, LowerCamelCase));
+  EXPECT_THROW(object.call_advanced("next_data_set", args, LowerCaseUnderscores), Exception);
+
+  EXPECT_EQ(Value(3), object.call_advanced("get_column_count", args, LowerCaseUnderscores));
+  EXPECT_TRUE(object.has_member_advanced("column_count", LowerCaseUnderscores));
+  EXPECT_EQ(Value(3), object.get_member_advanced("column_count", LowerCaseUnderscores));
+
+  // Functions added or removed after the first lookups are found
+  object.late_method();
+  EXPECT_EQ(Value("lateMethod"), object.call_advanced("late_method", args, LowerCaseUnderscores));
+
+  object.drop_property();
+  EXPECT_FALSE(object.has_method_advanced("get_column_count", LowerCaseUnderscores));
+  EXPECT_THROW(object.call_advanced("get_column_count", args, LowerCaseUnderscores), Exception);
+}
+
+// Calls methods with the Python naming style as the Python object wrapper
+// does, run with --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST(Functions, DISABLED_bench_naming_style_dispatch) {
+  Dispatch_object object;
+  Argument_list args;
+
+  // Sessions and results register around twenty methods
+  object.add_methods(20);
+  const int count = 300000;
+  size_t total = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++) {
+    if (object.has_method_advanced("fetch_one", LowerCaseUnderscores))
+      total += object.call_advanced("fetch_one", args, LowerCaseUnderscores).as_string().size();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(count * 8u, total);
+  std::printf("dispatch: %.1f ns/call\n", std::chrono::duration<double, std::nano>(elapsed).count() / count);
+}
+
 TEST(Parsing, Integer) {
   const std::string data = "1984";
   shcore::Value v = shcore::Value::parse(data);
@@ -348,6 +435,439 @@ TEST(Parsing, Array) {
   EXPECT_EQ(array2->size(), 0);
 }
 
+TEST(Parsing, Json) {
+  const std::string data = "{\"null\" : null, \"false\" : false, \"true\" : true, \"string\" : \"string value\", "
+    "\"integer\":560, \"float\": -2.5e3, \"array\": [1, \"two\", [3], {\"four\": 4}], \"nested\": {\"inner\": \"value\"}}";
+
+  // Strict JSON documents produce the same values with both parsers
+  shcore::Value v = shcore::Value::parse_json(data);
+  EXPECT_EQ(shcore::Map, v.type);
+  EXPECT_EQ(shcore::Value::parse(data), v);
+  EXPECT_EQ(shcore::Value::parse(data).repr(), v.repr());
+
+  Value::Map_type_ref map = v.as_map();
+  EXPECT_EQ(shcore::Integer, (*map)["integer"].type);
+  EXPECT_EQ(560, (*map)["integer"].as_int());
+  EXPECT_EQ(shcore::Float, (*map)["float"].type);
+  EXPECT_EQ(-2500.0, (*map)["float"].as_double());
+  EXPECT_EQ(4, (*map)["array"].as_array()->size());
+
+  EXPECT_EQ(shcore::Null, shcore::Value::parse_json("null").type);
+  EXPECT_EQ(-9223372036854775807LL - 1, shcore::Value::parse_json("-9223372036854775808").as_int());
+
+  shcore::Value big = shcore::Value::parse_json("18446744073709551615");
+  EXPECT_EQ(shcore::UInteger, big.type);
+  EXPECT_EQ(18446744073709551615ULL, big.as_uint());
+
+  EXPECT_EQ("caf\xc3\xa9 \"quoted\"", shcore::Value::parse_json("\"caf\\u00e9 \\\"quoted\\\"\"").as_string());
+
+  // The repr() only syntax is not JSON
+  EXPECT_THROW(shcore::Value::parse_json("['single']"), shcore::Exception);
+  EXPECT_THROW(shcore::Value::parse_json("undefined"), shcore::Exception);
+  EXPECT_THROW(shcore::Value::parse_json("{\"a\": 1"), shcore::Exception);
+  EXPECT_THROW(shcore::Value::parse_json("[1] 2"), shcore::Exception);
+
+  try {
+    shcore::Value::parse_json("[1, }");
+    ADD_FAILURE() << "Expected a parser error";
+  } catch (shcore::Exception &e) {
+    EXPECT_EQ("Error parsing JSON: Invalid value. at offset 4", std::string(e.what()));
+  }
+}
+
+TEST(ValueTests, MapType) {
+  Value::Map_type map;
+
+  map["delta"] = Value(4);
+  map["alpha"] = Value(1);
+  map["charlie"] = Value(3);
+  map["bravo"] = Value(2);
+
+  // Existing keys are updated in place
+  map["alpha"] = Value("one");
+
+  EXPECT_EQ(4, map.size());
+  EXPECT_EQ(1, map.count("bravo"));
+  EXPECT_EQ(0, map.count("echo"));
+  EXPECT_TRUE(map.find("echo") == map.end());
+  EXPECT_EQ("one", map.at("alpha").as_string());
+  EXPECT_THROW(map.at("echo"), std::out_of_range);
+
+  // Iteration is in key order
+  std::string keys;
+  for (Value::Map_type::const_iterator iter = map.begin(); iter != map.end(); ++iter)
+    keys += iter->first + " ";
+  EXPECT_EQ("alpha bravo charlie delta ", keys);
+
+  map.erase("charlie");
+  map.erase("echo");
+  EXPECT_EQ(3, map.size());
+  EXPECT_FALSE(map.has_key("charlie"));
+  EXPECT_EQ(4, map.get_int("delta"));
+
+  Value::Map_type other;
+  other["delta"] = Value(4);
+  other["bravo"] = Value(2);
+  other["alpha"] = Value("one");
+  EXPECT_TRUE(map == other);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+
+  // The JSON output keeps the key order
+  Value doc = Value::parse("{\"b\": 1, \"a\": {\"d\": [1, 2], \"c\": null}}");
+  EXPECT_EQ("{\"a\":{\"c\":null,\"d\":[1,2]},\"b\":1}", doc.json());
+}
+
+TEST(ValueTests, MoveValue) {
+  Value source(std::string("moved string"));
+  Value target(std::move(source));
+
+  EXPECT_EQ(shcore::Undefined, source.type);
+  EXPECT_EQ("moved string", target.as_string());
+
+  Value other(5);
+  other = std::move(target);
+  EXPECT_EQ("moved string", other.as_string());
+}
+
+// Parses a document like the ones returned by a collection find and dumps it
+// back to JSON, run with --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST(ValueTests, DISABLED_bench_document_round_trip) {
+  const std::string doc = "{\"_id\": \"00000000000000000000000000000001\", \"name\": \"Sample document\", "
+    "\"age\": 42, \"active\": true, \"score\": 12.5, \"tags\": [\"a\", \"b\", \"c\"], "
+    "\"address\": {\"street\": \"Main\", \"number\": 10, \"city\": \"Springfield\", \"zip\": \"12345\"}, "
+    "\"owner\": null, \"visits\": 1500, \"rating\": 4, \"status\": \"open\", \"group\": \"admins\"}";
+  const int count = 20000;
+  size_t total = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++)
+    total += Value::parse(doc).as_map()->size();
+  auto parse = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++)
+    total += Value::parse_json(doc).as_map()->size();
+  auto parse_json = std::chrono::steady_clock::now() - start;
+
+  Value value = Value::parse(doc);
+  start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++)
+    total += value.json().size();
+  auto json = std::chrono::steady_clock::now() - start;
+
+  EXPECT_LT(0, total);
+  std::printf("parse: %.0f ns/doc, parse_json: %.0f ns/doc, json: %.0f ns/doc\n",
+    std::chrono::duration<double, std::nano>(parse).count() / count,
+    std::chrono::duration<double, std::nano>(parse_json).count() / count,
+    std::chrono::duration<double, std::nano>(json).count() / count);
+}
+
+TEST(ValueTests, SharedString) {
+  Value original(std::string("a string long enough to live out of the std::string buffer"));
+  Value copy(original);
+
+  // Copies share the string data
+  EXPECT_EQ(original.value.s, copy.value.s);
+  EXPECT_EQ(2u, original.value.s->refs.load());
+  EXPECT_EQ(&original.as_string(), &copy.as_string());
+
+  Value assigned("other");
+  assigned = copy;
+  EXPECT_EQ(original.value.s, assigned.value.s);
+  EXPECT_EQ(3u, original.value.s->refs.load());
+
+  assigned = assigned;
+  EXPECT_EQ(3u, original.value.s->refs.load());
+
+  assigned = Value(5);
+  copy = Value("replaced");
+  EXPECT_EQ(1u, original.value.s->refs.load());
+  EXPECT_EQ("replaced", copy.as_string());
+  EXPECT_EQ("a string long enough to live out of the std::string buffer", original.as_string());
+
+  // Equal strings compare equal whether they are shared or not
+  EXPECT_EQ(Value("replaced"), copy);
+  EXPECT_NE(Value("replace"), copy);
+
+  std::string moved("moved into the value without a copy of the characters");
+  const char *data = moved.data();
+  Value from_moved(std::move(moved));
+  EXPECT_EQ(data, from_moved.as_string().data());
+}
+
+// Copies the values of a result like set of rows with string columns, run
+// with --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST(ValueTests, DISABLED_bench_copy_strings) {
+  Value::Array_type row;
+  row.push_back(Value(1));
+  row.push_back(Value("Sample name of a customer"));
+  row.push_back(Value("customer.email@example.com"));
+  row.push_back(Value("A longer description that is kept with the record and copied with it"));
+  row.push_back(Value("open"));
+  const int count = 200000;
+
+  size_t total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++) {
+    Value::Array_type copy(row);
+    total += copy.size();
+  }
+  auto copy = std::chrono::steady_clock::now() - start;
+
+  EXPECT_LT(0u, total);
+  std::printf("copy: %.1f ns/row\n", std::chrono::duration<double, std::nano>(copy).count() / count);
+}
+
+TEST(ValueTests, Arena) {
+  Value document;
+  Value outside("created outside of the scope, from the heap as usual");
+  {
+    shcore::Arena_scope scope;
+    Arena *arena = scope.arena();
+    EXPECT_EQ(arena, Arena::current());
+
+    document = Value::parse_json("{\"name\": \"a string long enough to live out of the std::string buffer\", "
+                                 "\"list\": [1, \"two\"], \"nested\": {\"key\": \"value\"}}");
+    EXPECT_EQ(arena, document.as_map()->at("name").value.s->arena);
+    EXPECT_EQ(arena, document.as_map()->get_array("list")->at(1).value.s->arena);
+
+    Value map = Value::new_map();
+    (*map.as_map())["copied"] = outside;
+    EXPECT_EQ(nullptr, outside.value.s->arena);
+  }
+  EXPECT_EQ(nullptr, Arena::current());
+
+  // The values outlive the scope, the arena goes with the last of them
+  EXPECT_EQ("value", document.as_map()->get_map("nested")->get_string("key"));
+  Value copy(document.as_map()->at("name"));
+  document = Value();
+  EXPECT_EQ("a string long enough to live out of the std::string buffer", copy.as_string());
+}
+
+// Builds and goes through a million documents the way fetchAll() does, with
+// the values on the heap and then in an arena per batch of 4096 documents,
+// run with --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST(ValueTests, DISABLED_bench_fetch_all_arena) {
+  const std::string doc = "{\"_id\": \"00000000000000000000000000000001\", \"name\": \"Sample document\", "
+    "\"age\": 42, \"active\": true, \"tags\": [\"a\", \"b\", \"c\"], "
+    "\"address\": {\"street\": \"Main\", \"number\": 10, \"city\": \"Springfield\"}}";
+  const size_t count = 1000000;
+  const size_t batch = 4096;
+
+  for (int use_arena = 0; use_arena < 2; use_arena++) {
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    {
+      Value::Array_type documents;
+      documents.reserve(count);
+      for (size_t index = 0; index < count; index += batch) {
+        std::unique_ptr<shcore::Arena_scope> scope(use_arena ? new shcore::Arena_scope() : nullptr);
+        for (size_t row = index; row < std::min(count, index + batch); row++)
+          documents.push_back(Value::parse_json(doc));
+      }
+      auto built = std::chrono::steady_clock::now();
+
+      for (auto &document : documents)
+        total += document.as_map()->get_string("name").size();
+      auto iterated = std::chrono::steady_clock::now();
+
+      std::printf("%s: build %.0f ms, iterate %.0f ms, ", use_arena ? "arena" : "heap",
+        std::chrono::duration<double, std::milli>(built - start).count(),
+        std::chrono::duration<double, std::milli>(iterated - built).count());
+      start = std::chrono::steady_clock::now();
+    }
+    std::printf("release %.0f ms\n",
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    EXPECT_EQ(count * 15, total);
+  }
+}
+
+TEST(ValueTests, JsonStrings) {
+  EXPECT_EQ("\"plain text, no escaping needed\"", Value("plain text, no escaping needed").json());
+  EXPECT_EQ("\"a \\\"quoted\\\" back\\\\slash\\n\\ttab\\u0001\\u001F caf\xc3\xa9\"",
+            Value("a \"quoted\" back\\slash\n\ttab\x01\x1f caf\xc3\xa9").json());
+  EXPECT_EQ("\"\\u0000\"", Value(std::string("\0", 1)).json());
+
+  // Strings escaped the same way the rapidjson writer does, with the special
+  // characters at every position of the 8 byte words that are skipped
+  const std::string specials("\"\\\n\r\t\b\f\x01\x1f\x7f\xc3", 11);
+  for (size_t length = 0; length < 20; length++) {
+    for (size_t position = 0; position < length; position++) {
+      for (size_t special = 0; special < specials.size(); special++) {
+        std::string data(length, 'x');
+        data[position] = specials[special];
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        writer.String(data.c_str(), unsigned(data.size()));
+
+        EXPECT_EQ(std::string(buffer.GetString()), Value(data).json());
+      }
+    }
+  }
+}
+
+TEST(ValueTests, JsonStreaming) {
+  Value value = Value::parse("{\"name\": \"chunked \\\"output\\\"\", \"list\": [1, 2.5, true, null, \"text\"], \"nested\": {\"key\": \"value\"}}");
+
+  for (int pprint = 0; pprint < 2; pprint++) {
+    std::vector<std::string> chunks;
+    std::string output;
+    {
+      JSON_dumper dumper(pprint == 1, [&chunks](const std::string &chunk) { chunks.push_back(chunk); }, 8);
+      dumper.append_value(value);
+      dumper.flush();
+      EXPECT_EQ("", dumper.str());
+    }
+
+    for (size_t index = 0; index < chunks.size(); index++) {
+      if (index + 1 < chunks.size()) {
+        EXPECT_LE(8u, chunks[index].size());
+      }
+      output += chunks[index];
+    }
+
+    EXPECT_LT(1u, chunks.size());
+    EXPECT_EQ(value.json(pprint == 1), output);
+  }
+}
+
+TEST(ValueTests, Hash) {
+  // Equal values hash the same, also across the number types
+  EXPECT_EQ(Value(1).hash(), Value(true).hash());
+  EXPECT_EQ(Value(2).hash(), Value(2.0).hash());
+  EXPECT_EQ(Value(static_cast<uint64_t>(3)).hash(), Value(3.0).hash());
+  EXPECT_EQ(Value(0.0).hash(), Value(-0.0).hash());
+  EXPECT_EQ(Value("text").hash(), Value(std::string("text")).hash());
+  EXPECT_EQ(Value::parse("{\"a\": [1, \"b\"], \"c\": null}").hash(),
+            Value::parse("{\"c\": null, \"a\": [1, \"b\"]}").hash());
+
+  EXPECT_NE(Value("text").hash(), Value("other").hash());
+  EXPECT_NE(Value::parse("[1, 2]").hash(), Value::parse("[2, 1]").hash());
+  EXPECT_NE(Value::parse("{\"a\": 1}").hash(), Value::parse("{\"b\": 1}").hash());
+
+  std::unordered_set<Value> values;
+  values.insert(Value::parse("[1, \"b\"]"));
+  values.insert(Value::parse("[1, \"b\"]"));
+  values.insert(Value::parse("[1, \"c\"]"));
+  values.insert(Value::Null());
+  EXPECT_EQ(3u, values.size());
+  EXPECT_EQ(1u, values.count(Value::parse("[1, \"c\"]")));
+}
+
+TEST(ValueTests, DescrPrinter) {
+  Value value = Value::parse("{\"list\": [1, [2, 3], \"text\"], \"map\": {\"a\": {\"b\": null}}, \"empty\": []}");
+
+  auto print = [&value](size_t max_depth, size_t max_elements, size_t max_bytes, bool complete) {
+    std::string output;
+    Descr_printer printer([&output](const std::string &chunk) { output += chunk; }, max_depth, max_elements, max_bytes, 8);
+    EXPECT_EQ(complete, printer.print(value));
+    return output;
+  };
+
+  // Without limits it prints what descr() does
+  EXPECT_EQ(value.descr(true), print(0, 0, 0, true));
+
+  EXPECT_EQ("{\n"
+            "    \"empty\": [], \n"
+            "    \"list\": [... 3 items], \n"
+            "    \"map\": {... 1 keys}\n"
+            "}", print(1, 0, 0, true));
+
+  EXPECT_EQ("{\n"
+            "    \"empty\": [], \n"
+            "    \"list\": [\n"
+            "        1,\n"
+            "        [\n"
+            "            2,\n"
+            "            3\n"
+            "        ],\n"
+            "        ... 1 more\n"
+            "    ], \n"
+            "    ... 1 more\n"
+            "}", print(0, 2, 0, true));
+
+  EXPECT_EQ("{\n    \"empty\n... (output truncated after 12 bytes, print() shows the whole value)", print(0, 0, 12, false));
+}
+
+// Dumps a result like set of rows with string columns, run with
+// --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST(ValueTests, DISABLED_bench_json_strings) {
+  std::shared_ptr<Value::Array_type> rows(new Value::Array_type());
+  for (int index = 0; index < 2000; index++) {
+    std::shared_ptr<Value::Map_type> row(new Value::Map_type());
+    (*row)["id"] = Value(index);
+    (*row)["title"] = Value("A reasonably long title for the exported record number " + std::to_string(index));
+    (*row)["body"] = Value(std::string(400, 'b') + "\n\"quoted\" and a tab\t" + std::string(200, 'c'));
+    rows->push_back(Value(row));
+  }
+  Value value(rows);
+  const int count = 20;
+
+  size_t total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++)
+    total += value.json().size();
+  auto json = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int index = 0; index < count; index++) {
+    JSON_dumper dumper(false, [&total](const std::string &chunk) { total += chunk.size(); });
+    dumper.append_value(value);
+    dumper.flush();
+  }
+  auto streamed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_LT(0u, total);
+  std::printf("json: %.1f us/result, streamed: %.1f us/result\n",
+    std::chrono::duration<double, std::micro>(json).count() / count,
+    std::chrono::duration<double, std::micro>(streamed).count() / count);
+}
+
+TEST(Argument_list, storage) {
+  Argument_list args;
+  EXPECT_EQ(0u, args.size());
+  EXPECT_EQ(args.begin(), args.end());
+
+  // The first arguments are kept inline, the rest go to the heap
+  for (int index = 0; index < 10; index++) {
+    args.emplace_back(index);
+    ASSERT_EQ(static_cast<size_t>(index + 1), args.size());
+    for (int i = 0; i <= index; i++)
+      EXPECT_EQ(i, args.int_at(i));
+  }
+
+  int expected = 0;
+  for (auto &arg : args)
+    EXPECT_EQ(Value(expected++), arg);
+  EXPECT_EQ(10, expected);
+
+  // An element of the list can be added again
+  args.push_back(args[2]);
+  EXPECT_EQ(2, args.int_at(10));
+
+  while (args.size() > 2)
+    args.pop_back();
+  EXPECT_EQ(1, args.int_at(1));
+  EXPECT_THROW(args.at(2), std::out_of_range);
+
+  Argument_list copy(args);
+  args.clear();
+  EXPECT_EQ(0u, args.size());
+  args.push_back(Value("string"));
+  EXPECT_EQ("string", args.string_at(0));
+
+  ASSERT_EQ(2u, copy.size());
+  EXPECT_EQ(0, copy.int_at(0));
+  EXPECT_EQ(1, copy.int_at(1));
+
+  Argument_list moved(std::move(copy));
+  ASSERT_EQ(2u, moved.size());
+  EXPECT_EQ(1, moved.int_at(1));
+}
+
 TEST(Argument_map, all) {
   {
     Argument_map args;
@@ -387,5 +387,26 @@ TEST(Uri_parser, parse_query) {
   atts["sample5"] = {"/what/e/ver"};
   validate_uri("mysqlx://user@10.150.123.45:2845/world?sample=value&sample2=my%20space&sample3&sample4=[one,two,three]&sample5=(/what/e/ver)", "mysqlx", "user", NO_PASSWORD, "10.150.123.45", 2845, NO_SOCK, "world", HAS_NO_PASSWORD, HAS_PORT, uri::Tcp, &atts);
 }
+TEST(Uri_parser, parse_host_list) {
+  uri::Uri_parser parser;
+  uri::Uri_data data = parser.parse("mysqlx://user@[host1:3307,10.150.123.45,[::1]:2845]/world");
+
+  ASSERT_TRUE(data.has_host_list());
+  ASSERT_EQ(3, data.get_hosts().size());
+  ASSERT_STREQ("host1", data.get_hosts()[0].first.c_str());
+  ASSERT_EQ(3307, data.get_hosts()[0].second);
+  ASSERT_STREQ("10.150.123.45", data.get_hosts()[1].first.c_str());
+  ASSERT_EQ(0, data.get_hosts()[1].second);
+  ASSERT_STREQ("::1", data.get_hosts()[2].first.c_str());
+  ASSERT_EQ(2845, data.get_hosts()[2].second);
+
+  // The first host is the one reported as the target
+  ASSERT_STREQ("host1", data.get_host().c_str());
+  ASSERT_STREQ("world", data.get_db().c_str());
+
+  // A single IPv6 address is not a list
+  data = parser.parse("mysqlx://user@[::1]:2845");
+  ASSERT_FALSE(data.has_host_list());
+}
 };
 };
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_arrow.h"
+
+namespace shcore {
+namespace {
+struct Message {
+  std::string metadata;
+  std::string body;
+};
+
+uint32_t read_u32(const std::string &data, size_t offset) {
+  uint32_t value;
+  memcpy(&value, data.data() + offset, sizeof(value));
+  return value;
+}
+
+int64_t read_i64(const std::string &data, size_t offset) {
+  int64_t value;
+  memcpy(&value, data.data() + offset, sizeof(value));
+  return value;
+}
+
+// The body length is the last field of the Message table, the one at the
+// highest offset of its vtable
+int64_t body_length(const std::string &metadata) {
+  size_t table = read_u32(metadata, 0);
+  size_t vtable = table - static_cast<int32_t>(read_u32(metadata, table));
+  uint16_t field;
+  memcpy(&field, metadata.data() + vtable + 4 + 2 * 3, sizeof(field));
+  return field ? read_i64(metadata, table + field) : 0;
+}
+
+// Splits the stream into its messages, checking the framing and the end of
+// stream marker
+std::vector<Message> read_stream(const std::string &stream) {
+  std::vector<Message> messages;
+  size_t offset = 0;
+  while (true) {
+    EXPECT_LE(offset + 8, stream.size());
+    EXPECT_EQ(0xFFFFFFFFu, read_u32(stream, offset));
+    uint32_t length = read_u32(stream, offset + 4);
+    offset += 8;
+    if (!length)
+      break;
+
+    EXPECT_EQ(0u, length % 8);
+    Message message;
+    message.metadata = stream.substr(offset, length);
+    offset += length;
+
+    int64_t body = body_length(message.metadata);
+    EXPECT_EQ(0, body % 8);
+    message.body = stream.substr(offset, static_cast<size_t>(body));
+    offset += static_cast<size_t>(body);
+
+    messages.push_back(message);
+  }
+
+  EXPECT_EQ(stream.size(), offset);
+  return messages;
+}
+
+std::vector<Arrow_stream_writer::Field> test_fields() {
+  return {
+    Arrow_stream_writer::Field("id", Arrow_stream_writer::Type::Int64),
+    Arrow_stream_writer::Field("name", Arrow_stream_writer::Type::Utf8),
+    Arrow_stream_writer::Field("ratio", Arrow_stream_writer::Type::Double)
+  };
+}
+}
+
+TEST(utils_arrow, validity_from_nulls) {
+  uint8_t nulls[] = { 0, 1, 0, 0, 0, 0, 0, 0, 1, 0 };
+  std::string bitmap;
+  EXPECT_EQ(2u, Arrow_stream_writer::validity_from_nulls(nulls, sizeof(nulls), &bitmap));
+  ASSERT_EQ(2u, bitmap.size());
+  EXPECT_EQ(0xFD, static_cast<uint8_t>(bitmap[0]));
+  EXPECT_EQ(0x02, static_cast<uint8_t>(bitmap[1]));
+}
+
+TEST(utils_arrow, empty_stream) {
+  std::string stream;
+  Arrow_stream_writer writer(test_fields(), [&stream](const char *data, size_t size) { stream.append(data, size); });
+  writer.write_batch(0, {});
+  writer.finish();
+
+  auto messages = read_stream(stream);
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_NE(std::string::npos, messages[0].metadata.find("ratio"));
+  EXPECT_TRUE(messages[0].body.empty());
+}
+
+TEST(utils_arrow, batches) {
+  std::string stream;
+  Arrow_stream_writer writer(test_fields(), [&stream](const char *data, size_t size) { stream.append(data, size); });
+
+  Arrow_batch_builder builder(test_fields());
+  for (int64_t row = 0; row < 3; row++) {
+    builder.append(0, row);
+    if (row == 1)
+      builder.append_null(1);
+    else
+      builder.append(1, "text", static_cast<size_t>(row + 1));
+    builder.append(2, row * 0.5);
+    builder.end_row();
+  }
+  EXPECT_EQ(3u, builder.rows());
+  builder.flush(&writer);
+  EXPECT_EQ(0u, builder.rows());
+
+  // A second batch written from buffers as they are
+  int64_t ids[] = { 7, 8 };
+  int64_t offsets[] = { 0, 2, 2 };
+  double ratios[] = { 1.5, 2.5 };
+  std::vector<Arrow_stream_writer::Column> columns(3);
+  columns[0].values = ids;
+  columns[0].values_size = sizeof(ids);
+  columns[1].values = offsets;
+  columns[1].values_size = sizeof(offsets);
+  columns[1].data = "ab";
+  columns[1].data_size = 2;
+  columns[2].values = ratios;
+  columns[2].values_size = sizeof(ratios);
+  writer.write_batch(2, columns);
+  writer.finish();
+
+  auto messages = read_stream(stream);
+  ASSERT_EQ(3u, messages.size());
+
+  // Validity of name, then values, offsets and data, each padded to 8 bytes
+  const std::string &first = messages[1].body;
+  ASSERT_EQ(24u + 8u + 32u + 8u + 24u, first.size());
+  EXPECT_EQ(2, read_i64(first, 16));
+  EXPECT_EQ(0x05, static_cast<uint8_t>(first[24]));
+  EXPECT_EQ(0, read_i64(first, 32));
+  EXPECT_EQ(1, read_i64(first, 40));
+  EXPECT_EQ(1, read_i64(first, 48));
+  EXPECT_EQ(4, read_i64(first, 56));
+  EXPECT_EQ("ttex", first.substr(64, 4));
+
+  const std::string &second = messages[2].body;
+  ASSERT_EQ(16u + 24u + 8u + 16u, second.size());
+  EXPECT_EQ(0, memcmp(ids, second.data(), sizeof(ids)));
+  EXPECT_EQ(0, memcmp(offsets, second.data() + 16, sizeof(offsets)));
+  EXPECT_EQ("ab", second.substr(40, 2));
+  EXPECT_EQ(0, memcmp(ratios, second.data() + 48, sizeof(ratios)));
+}
+}
@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_cancel.h"
+#include "shellcore/types.h"
+
+namespace shcore {
+TEST(utils_cancel, no_scope) {
+  EXPECT_EQ(nullptr, Cancellation_token::current());
+
+  // Nothing to cancel
+  Cancellation_token::cancel_all();
+  EXPECT_EQ(nullptr, Cancellation_token::current());
+}
+
+TEST(utils_cancel, cancel_nested) {
+  Cancellation_scope outer(std::chrono::milliseconds(0), std::chrono::seconds(5));
+  EXPECT_EQ(&outer.token(), Cancellation_token::current());
+
+  {
+    Cancellation_scope inner(std::chrono::milliseconds(0), std::chrono::milliseconds(0));
+    EXPECT_EQ(&inner.token(), Cancellation_token::current());
+    EXPECT_EQ(std::chrono::milliseconds(std::chrono::seconds(5)), inner.token().step_timeout());
+    EXPECT_FALSE(inner.token().cancelled());
+    EXPECT_NO_THROW(inner.token().check("testing"));
+
+    // Cancels the outer operation too
+    Cancellation_token::cancel_all();
+    EXPECT_TRUE(inner.token().cancelled());
+    EXPECT_THROW(inner.token().check("testing"), shcore::Exception);
+  }
+
+  EXPECT_EQ(&outer.token(), Cancellation_token::current());
+  EXPECT_TRUE(outer.token().cancelled());
+}
+
+TEST(utils_cancel, deadlines) {
+  Cancellation_scope outer(std::chrono::milliseconds(50), std::chrono::milliseconds(0));
+  Cancellation_scope inner(std::chrono::seconds(60), std::chrono::milliseconds(0));
+
+  // The deadline of the outer operation bounds the inner one
+  EXPECT_EQ(outer.token().deadline(), inner.token().deadline());
+  EXPECT_EQ(inner.token().deadline(), inner.token().step_deadline());
+  EXPECT_FALSE(inner.token().cancelled());
+
+  // A step deadline only applies to its step
+  auto step = Cancellation_token::Clock::now();
+  EXPECT_THROW(inner.token().check("testing", step), shcore::Exception);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_TRUE(inner.token().cancelled());
+  EXPECT_TRUE(outer.token().cancelled());
+}
+}
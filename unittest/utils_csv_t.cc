@@ -0,0 +1,138 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_csv.h"
+
+namespace shcore {
+TEST(utils_csv, find_record_end) {
+  std::string data = "1,\"a\nb\",c\n2,\"x\"\"\ny\",z\n3";
+  Text_dialect csv = Text_dialect::csv();
+
+  size_t second = find_record_end(data.data(), data.size(), 0, csv);
+  EXPECT_EQ(std::string("2,"), data.substr(second, 2));
+
+  size_t third = find_record_end(data.data(), data.size(), second, csv);
+  EXPECT_EQ(std::string("3"), data.substr(third));
+  EXPECT_EQ(data.size(), find_record_end(data.data(), data.size(), third, csv));
+
+  std::string tsv_data = "1\ta\\\nb\n2\tc\n";
+  size_t next = find_record_end(tsv_data.data(), tsv_data.size(), 0, Text_dialect::tsv());
+  EXPECT_EQ(std::string("2\tc\n"), tsv_data.substr(next));
+}
+
+TEST(utils_csv, split_records) {
+  std::string data;
+  for (int index = 0; index < 100; index++)
+    data += std::to_string(index) + ",\"line\nbreak, and comma\"\n";
+
+  Text_dialect csv = Text_dialect::csv();
+  size_t start = skip_records(data.data(), data.size(), 0, 1, csv);
+  auto chunks = split_records(data.data(), data.size(), start, 100, csv);
+
+  ASSERT_LT(1u, chunks.size());
+
+  // The chunks are contiguous and each one holds whole records
+  size_t offset = start;
+  size_t records = 0;
+  for (auto &chunk : chunks) {
+    EXPECT_EQ(offset, chunk.first);
+    offset += chunk.second;
+
+    Record_reader reader(data.data() + chunk.first, chunk.second, csv);
+    std::vector<std::string> fields;
+    std::vector<bool> nulls;
+    while (reader.next(fields, nulls)) {
+      ASSERT_EQ(2u, fields.size());
+      EXPECT_EQ(std::to_string(records + 1), fields[0]);
+      EXPECT_EQ("line\nbreak, and comma", fields[1]);
+      records++;
+    }
+  }
+
+  EXPECT_EQ(data.size(), offset);
+  EXPECT_EQ(99u, records);
+}
+
+TEST(utils_csv, record_reader) {
+  std::vector<std::string> fields;
+  std::vector<bool> nulls;
+
+  std::string csv_data = "a,\"b \"\"quoted\"\"\",NULL,\"NULL\",\n";
+  Record_reader csv(csv_data.data(), csv_data.size(), Text_dialect::csv());
+  ASSERT_TRUE(csv.next(fields, nulls));
+  ASSERT_EQ(5u, fields.size());
+  EXPECT_EQ("a", fields[0]);
+  EXPECT_EQ("b \"quoted\"", fields[1]);
+  EXPECT_TRUE(nulls[2]);
+  EXPECT_FALSE(nulls[3]);
+  EXPECT_EQ("NULL", fields[3]);
+  EXPECT_EQ("", fields[4]);
+  EXPECT_FALSE(csv.next(fields, nulls));
+
+  std::string tsv_data = "a\\tb\t\\N\t\\Nx\n";
+  Record_reader tsv(tsv_data.data(), tsv_data.size(), Text_dialect::tsv());
+  ASSERT_TRUE(tsv.next(fields, nulls));
+  ASSERT_EQ(3u, fields.size());
+  EXPECT_EQ("a\tb", fields[0]);
+  EXPECT_TRUE(nulls[1]);
+  EXPECT_FALSE(nulls[2]);
+  EXPECT_EQ("Nx", fields[2]);
+}
+
+TEST(utils_csv, append_field) {
+  std::string value("tab\there\nnew line \\ and \0 zero", 30);
+  std::vector<std::string> fields;
+  std::vector<bool> nulls;
+
+  for (auto dialect : { Text_dialect::csv(), Text_dialect::tsv() }) {
+    std::string record;
+    append_field(record, value.data(), value.size(), dialect);
+    record.append(1, dialect.fields_terminated_by);
+    append_field(record, NULL, 0, dialect);
+    record.append(1, dialect.fields_terminated_by);
+    append_field(record, "NULL", 4, dialect);
+    record.append(1, dialect.fields_terminated_by);
+    append_field(record, "\"a\",b", 5, dialect);
+    record.append(1, dialect.lines_terminated_by);
+
+    // A single record, the terminators within the values do not split it
+    EXPECT_EQ(record.size(), find_record_end(record.data(), record.size(), 0, dialect));
+
+    Record_reader reader(record.data(), record.size(), dialect);
+    ASSERT_TRUE(reader.next(fields, nulls));
+    ASSERT_EQ(4u, fields.size());
+    EXPECT_EQ(value, fields[0]);
+    EXPECT_TRUE(nulls[1]);
+    EXPECT_FALSE(nulls[2]);
+    EXPECT_EQ("NULL", fields[2]);
+    EXPECT_EQ("\"a\",b", fields[3]);
+  }
+}
+
+TEST(utils_csv, load_data_clauses) {
+  EXPECT_EQ("FIELDS TERMINATED BY ',' OPTIONALLY ENCLOSED BY '\"' ESCAPED BY '' LINES TERMINATED BY '\\n'",
+            Text_dialect::csv().load_data_clauses());
+  EXPECT_EQ("FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n'",
+            Text_dialect::tsv().load_data_clauses());
+}
+}
@@ -19,11 +19,13 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <stack>
 
 #include "gtest/gtest.h"
+#include "../utils/utils_file.h"
 #include "../utils/utils_general.h"
 
 namespace shcore {
@@ -116,4 +118,110 @@ TEST(utils_general, make_account) {
     EXPECT_EQ(t.account, make_account(t.user, t.host));
   }
 }
+
+TEST(utils_general, display_width) {
+  EXPECT_EQ(0u, display_width(""));
+  EXPECT_EQ(5u, display_width("hello"));
+
+  // Latin with a precomposed and a combining accent
+  EXPECT_EQ(4u, display_width("caf\xc3\xa9"));
+  EXPECT_EQ(4u, display_width("cafe\xcc\x81"));
+
+  // CJK and emoji use two columns
+  EXPECT_EQ(4u, display_width("\xe6\x97\xa5\xe6\x9c\xac"));
+  EXPECT_EQ(3u, display_width("a\xf0\x9f\x98\x80"));
+
+  // Invalid and truncated sequences count a column per byte
+  EXPECT_EQ(2u, display_width("\xff\xfe"));
+  EXPECT_EQ(3u, display_width("a\xe6\x97"));
+}
+
+TEST(utils_general, append_hex) {
+  std::string out;
+  append_hex(out, "", 0);
+  EXPECT_EQ("0x", out);
+
+  out = "id: ";
+  append_hex(out, "\x00\x01\xab\xff", 4);
+  EXPECT_EQ("id: 0x0001ABFF", out);
+
+  // Past the blocks of eight bytes
+  out.clear();
+  append_hex(out, "0123456789", 10);
+  EXPECT_EQ("0x30313233343536373839", out);
+}
+
+TEST(utils_general, append_base64) {
+  const char *inputs[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+  const char *outputs[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+
+  for (size_t index = 0; index < sizeof(inputs) / sizeof(inputs[0]); index++) {
+    std::string out;
+    append_base64(out, inputs[index], strlen(inputs[index]));
+    EXPECT_EQ(outputs[index], out);
+  }
+
+  std::string out("x");
+  append_base64(out, "\xff\xfe\x00", 3);
+  EXPECT_EQ("x//4A", out);
+}
+
+TEST(utils_general, connection_options) {
+  Connection_options options = Connection_options::parse("root:pwd@localhost:3306/test?sslMode=REQUIRED");
+  EXPECT_EQ("root", options.user);
+  EXPECT_TRUE(options.has_password);
+  EXPECT_EQ("pwd", options.password);
+  EXPECT_EQ("localhost", options.host);
+  EXPECT_EQ(3306, options.port);
+  EXPECT_EQ("test", options.schema);
+  EXPECT_EQ("root@localhost:3306/test?sslMode=REQUIRED", options.uri(false));
+
+  // A second parse gives the same options, from the cache when the URI has
+  // no password
+  EXPECT_EQ("root:pwd@localhost:3306/test?sslMode=REQUIRED",
+            Connection_options::parse("root:pwd@localhost:3306/test?sslMode=REQUIRED").uri(true));
+  EXPECT_EQ("root@localhost:3306/test", Connection_options::parse("root@localhost:3306/test").uri(true));
+  EXPECT_EQ("root@localhost:3306/test", Connection_options::parse("root@localhost:3306/test").uri(true));
+
+  // Round trip through the connection data dictionary
+  Value::Map_type_ref data = options.to_map();
+  EXPECT_EQ("root", (*data)[kDbUser].as_string());
+  EXPECT_EQ(3306, (*data)[kPort].as_int());
+  EXPECT_EQ(options.uri(true), build_connection_string(data, true));
+  EXPECT_EQ(options.uri(true), Connection_options::from_map(data).uri(true));
+
+  EXPECT_EQ("", Connection_options::parse("localhost", false).user);
+  EXPECT_THROW(Connection_options::parse("root@localhost:3306?sslMode=WRONG"), shcore::Exception);
+}
+
+TEST(utils_general, local_sockets) {
+  std::string path;
+  std::string socket = get_user_config_path() + "local_sockets";
+  std::map<std::string, std::string> variables = {
+    {"port", "65301"}, {"socket", socket}, {"named_pipe", "OFF"},
+    {"mysqlx_port", "65302"}, {"mysqlx_socket", "/no/such/mysqlx.sock"}
+  };
+
+  // Through a forwarded port the server paths are not used
+  remember_local_sockets(65303, variables);
+  EXPECT_TRUE(get_local_socket(65303, &path));
+  EXPECT_EQ("", path);
+  EXPECT_FALSE(get_local_socket(65301, &path));
+
+  remember_local_sockets(65301, variables);
+  EXPECT_TRUE(get_local_socket(65301, &path));
+#ifdef _WIN32
+  EXPECT_EQ("", path);
+#else
+  // Any existing file passes for the socket
+  EXPECT_EQ(socket, path);
+#endif
+  EXPECT_TRUE(get_local_socket(65302, &path));
+  EXPECT_EQ("", path);
+
+  for (int port : {65301, 65302, 65303}) {
+    forget_local_socket(port);
+    EXPECT_FALSE(get_local_socket(port, &path));
+  }
+}
 }
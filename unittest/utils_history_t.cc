@@ -0,0 +1,86 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_history.h"
+
+namespace shcore {
+TEST(utils_history, append_and_reopen) {
+  std::string path = "utils_history_test";
+  delete_file(path);
+
+  {
+    History_store history(path);
+    EXPECT_TRUE(history.last(10).empty());
+
+    history.append("select 1");
+    history.append("select *\nfrom t");
+    history.append("select 2");
+
+    EXPECT_EQ(std::vector<std::string>({"select *\nfrom t", "select 2"}), history.last(2));
+  }
+
+  // A crash in the middle of an entry leaves it without its terminator
+  {
+    std::ofstream file(path.c_str(), std::ios::app | std::ios::binary);
+    file << "select 3";
+  }
+
+  {
+    History_store history(path);
+    EXPECT_EQ(std::vector<std::string>({"select 1", "select *\nfrom t", "select 2"}), history.last(10));
+
+    history.append("show tables");
+    EXPECT_EQ(std::vector<std::string>({"select 2", "show tables"}), history.last(2));
+  }
+
+  {
+    History_store history(path);
+    EXPECT_EQ(std::vector<std::string>({"select 2", "select 3", "show tables"}), history.last(3));
+  }
+
+  delete_file(path);
+}
+
+TEST(utils_history, search) {
+  std::string path = "utils_history_test";
+  delete_file(path);
+
+  {
+    History_store history(path);
+    history.append("select * from city");
+    history.append("select * from country");
+    history.append("select * from city");
+  }
+
+  History_store history(path);
+  history.append("show create table city");
+
+  EXPECT_EQ(std::vector<std::string>({"show create table city", "select * from city"}), history.search("city", 10));
+  EXPECT_EQ(std::vector<std::string>({"show create table city"}), history.search("city", 1));
+  EXPECT_EQ(std::vector<std::string>({"select * from country"}), history.search("count", 10));
+  EXPECT_TRUE(history.search("cities", 10).empty());
+
+  delete_file(path);
+}
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_json_scan.h"
+
+namespace shcore {
+namespace {
+std::vector<std::string> read_documents(const std::string &data, const std::pair<size_t, size_t> &chunk,
+                                        std::vector<bool> *ids) {
+  std::vector<std::string> documents;
+  Json_document_reader reader(data.data() + chunk.first, chunk.second);
+  const char *document;
+  size_t length;
+  bool has_id;
+  while (reader.next(&document, &length, &has_id)) {
+    documents.push_back(std::string(document, length));
+    ids->push_back(has_id);
+  }
+  return documents;
+}
+}
+
+TEST(utils_json_scan, find_json_value_end) {
+  bool has_id;
+  std::string data = "{\"a\": \"}\\\"\", \"b\": {\"_id\": 1}, \"_id\": [1, \"]\"]} next";
+  EXPECT_EQ(data.find(" next"), find_json_value_end(data.data(), data.size(), 0, &has_id));
+  EXPECT_TRUE(has_id);
+
+  // Only the members of the top level object are the ids
+  data = "{\"b\": {\"_id\": 1}, \"c\": \"_id\"}";
+  EXPECT_EQ(data.size(), find_json_value_end(data.data(), data.size(), 0, &has_id));
+  EXPECT_FALSE(has_id);
+
+  data = "\"a\\\\\"b";
+  EXPECT_EQ(5u, find_json_value_end(data.data(), data.size(), 0, &has_id));
+
+  data = "12.5,3";
+  EXPECT_EQ(4u, find_json_value_end(data.data(), data.size(), 0, &has_id));
+
+  data = "{\"a\": [1, 2}";
+  EXPECT_THROW(find_json_value_end(data.data(), data.size(), 0, &has_id), std::runtime_error);
+}
+
+TEST(utils_json_scan, split_ndjson) {
+  std::string data;
+  for (int index = 0; index < 100; index++)
+    data += "{\"n\": " + std::to_string(index) + ", \"s\": \"line\\nbreak, }\"" +
+            (index % 2 ? ", \"_id\": \"" + std::to_string(index) + "\"" : std::string()) + "}\n";
+
+  auto chunks = split_json_documents(data.data(), data.size(), 100);
+  ASSERT_LT(1u, chunks.size());
+
+  // The chunks are contiguous and each one holds whole documents
+  size_t offset = 0;
+  std::vector<std::string> documents;
+  std::vector<bool> ids;
+  for (auto &chunk : chunks) {
+    EXPECT_EQ(offset, chunk.first);
+    offset = chunk.first + chunk.second;
+
+    auto chunk_documents = read_documents(data, chunk, &ids);
+    documents.insert(documents.end(), chunk_documents.begin(), chunk_documents.end());
+  }
+
+  ASSERT_EQ(100u, documents.size());
+  for (size_t index = 0; index < documents.size(); index++) {
+    EXPECT_EQ(0u, documents[index].find("{\"n\": " + std::to_string(index) + ","));
+    EXPECT_EQ(index % 2 == 1, ids[index]);
+  }
+}
+
+TEST(utils_json_scan, split_array) {
+  std::string data = " [ {\"a\": 1},\n {\"a\": [2]} , {\"_id\": \"x\"} ]\n";
+
+  auto chunks = split_json_documents(data.data(), data.size(), 1);
+  ASSERT_EQ(3u, chunks.size());
+
+  std::vector<bool> ids;
+  EXPECT_EQ(std::vector<std::string>({"{\"a\": 1}"}), read_documents(data, chunks[0], &ids));
+  EXPECT_EQ(std::vector<std::string>({"{\"a\": [2]}"}), read_documents(data, chunks[1], &ids));
+  EXPECT_EQ(std::vector<std::string>({"{\"_id\": \"x\"}"}), read_documents(data, chunks[2], &ids));
+  EXPECT_EQ(std::vector<bool>({false, false, true}), ids);
+
+  EXPECT_TRUE(split_json_documents("[ ]", 3, 1).empty());
+
+  data = "[{\"a\": 1}";
+  EXPECT_THROW(split_json_documents(data.data(), data.size(), 1), std::runtime_error);
+
+  data = "[{\"a\": 1}] {}";
+  EXPECT_THROW(split_json_documents(data.data(), data.size(), 1), std::runtime_error);
+}
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_memory.h"
+
+namespace shcore {
+TEST(utils_memory, budget) {
+  Memory_budget &budget = Memory_budget::get();
+  uint64_t used = budget.used();
+  budget.set_limit(used + 1000);
+
+  EXPECT_TRUE(budget.reserve(Memory_budget::Results, 600));
+  EXPECT_FALSE(budget.reserve(Memory_budget::Results, 600));
+  EXPECT_EQ(used + 600, budget.used());
+
+  // Measured usages are followed even past the limit
+  budget.update(Memory_budget::JavaScript, 0, 500);
+  EXPECT_TRUE(budget.exceeded());
+  EXPECT_LE(used + 1100, budget.peak());
+
+  {
+    Memory_reservation reservation(Memory_budget::Values);
+    EXPECT_THROW(reservation.add(1), std::runtime_error);
+  }
+
+  budget.update(Memory_budget::JavaScript, 500, 0);
+  budget.release(Memory_budget::Results, 600);
+  EXPECT_FALSE(budget.exceeded());
+
+  {
+    Memory_reservation reservation(Memory_budget::Values);
+    reservation.add(1000);
+    EXPECT_EQ(used + 1000, budget.used());
+  }
+  EXPECT_EQ(used, budget.used());
+
+  budget.set_limit(0);
+}
+}
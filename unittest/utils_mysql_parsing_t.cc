@@ -667,5 +667,34 @@ TEST_F(TestMySQLSplitter, continued_stmt_hash_comment_batch) {
   EXPECT_EQ(expected, sql.substr(ranges[2].offset(), ranges[2].length()));
 }
 
+TEST_F(TestMySQLSplitter, long_runs_between_special_bytes) {
+  // The text between quotes, comments and delimiters is skipped several
+  // bytes at a time, these cross those blocks at every offset
+  std::string values = "'a long value with a ; and an escaped \\' quote in it'";
+  std::string script;
+  for (size_t padding = 0; padding < 20; padding++)
+    script += "insert into t values (" + std::string(padding, '1') + ", " + values + ");\n" +
+              "/* a long comment with a ; " + std::string(padding, ' ') + "*/\n";
+  script += "delimiter $$\n" + std::string(40, ' ') + "select 1$$\ndelimiter ;\n";
+
+  send_sql(script);
+  EXPECT_TRUE(multiline_flags.empty());
+  ASSERT_EQ(21, static_cast<int>(ranges.size()));
+  for (int index = 0; index < 20; index++) {
+    EXPECT_EQ("insert into t values (" + std::string(index, '1') + ", " + values + ")",
+              sql.substr(ranges[index].offset(), ranges[index].length()));
+    EXPECT_EQ(";", ranges[index].get_delimiter());
+  }
+  EXPECT_EQ("select 1", sql.substr(ranges[20].offset(), ranges[20].length()));
+  EXPECT_EQ("$$", ranges[20].get_delimiter());
+
+  // A quote left open on a long line continues on the next one
+  send_sql("select '" + std::string(50, 'x'));
+  EXPECT_EQ("'", multiline_flags.top());
+  send_sql(std::string(50, 'y') + "';");
+  EXPECT_TRUE(multiline_flags.empty());
+  ASSERT_EQ(1, static_cast<int>(ranges.size()));
+  EXPECT_EQ(std::string(50, 'y') + "'", sql.substr(ranges[0].offset(), ranges[0].length()));
+}
 }
 }
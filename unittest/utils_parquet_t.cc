@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_parquet.h"
+
+namespace shcore {
+namespace {
+std::vector<Parquet_writer::Column> test_columns() {
+  return {
+    Parquet_writer::Column("id", Parquet_writer::Type::Int64),
+    Parquet_writer::Column("name", Parquet_writer::Type::Utf8),
+    Parquet_writer::Column("ratio", Parquet_writer::Type::Double)
+  };
+}
+
+// The metadata at the end of the file, checking the magic bytes around it
+std::string footer(const std::string &file) {
+  EXPECT_LE(12u, file.size());
+  EXPECT_EQ("PAR1", file.substr(0, 4));
+  EXPECT_EQ("PAR1", file.substr(file.size() - 4));
+
+  uint32_t length;
+  memcpy(&length, file.data() + file.size() - 8, sizeof(length));
+  EXPECT_LE(length + 12u, file.size());
+  return file.substr(file.size() - 8 - length, length);
+}
+
+void fill(Parquet_row_group *group, int64_t first, int64_t rows) {
+  static const char *names[] = { "alpha", "beta", "gamma" };
+  for (int64_t row = first; row < first + rows; row++) {
+    group->append(0, row);
+    if (row % 4 == 3)
+      group->append_null(1);
+    else
+      group->append(1, names[row % 3], strlen(names[row % 3]));
+    group->append(2, row * 0.5);
+    group->end_row();
+  }
+}
+}
+
+TEST(utils_parquet, compression) {
+  EXPECT_TRUE(Parquet_writer::is_compression_supported("none"));
+  EXPECT_FALSE(Parquet_writer::is_compression_supported("lzma"));
+  EXPECT_THROW(Parquet_writer(test_columns(), "lzma", [](const char *, size_t) {}), std::runtime_error);
+}
+
+TEST(utils_parquet, empty_file) {
+  std::string file;
+  Parquet_writer writer(test_columns(), "none", [&file](const char *data, size_t size) { file.append(data, size); });
+  writer.write(Parquet_row_group(test_columns()));
+  writer.finish();
+
+  EXPECT_EQ(0u, writer.rows());
+  std::string metadata = footer(file);
+  EXPECT_NE(std::string::npos, metadata.find("ratio"));
+  EXPECT_NE(std::string::npos, metadata.find("mysqlsh"));
+}
+
+TEST(utils_parquet, row_groups) {
+  std::string file;
+  Parquet_writer writer(test_columns(), "none", [&file](const char *data, size_t size) { file.append(data, size); });
+
+  Parquet_row_group group(test_columns());
+  fill(&group, 0, 100);
+  EXPECT_EQ(100u, group.rows());
+  auto encoded = writer.encode(group);
+  group.clear();
+  EXPECT_EQ(0u, group.rows());
+  EXPECT_EQ(0u, group.data_size());
+
+  fill(&group, 100, 50);
+  writer.write(*encoded);
+  writer.write(group);
+  writer.finish();
+
+  EXPECT_EQ(150u, writer.rows());
+  std::string metadata = footer(file);
+
+  // The names are dictionary encoded, so each is in the file once for each
+  // row group and once more as the maximum of each
+  size_t count = 0;
+  for (size_t offset = file.find("gamma"); offset != std::string::npos; offset = file.find("gamma", offset + 1))
+    count++;
+  EXPECT_EQ(4u, count);
+
+  // The maximum and minimum of the second row group of ids
+  int64_t max = 149;
+  int64_t min = 100;
+  EXPECT_NE(std::string::npos, metadata.find(std::string(reinterpret_cast<const char*>(&max), sizeof(max))));
+  EXPECT_NE(std::string::npos, metadata.find(std::string(reinterpret_cast<const char*>(&min), sizeof(min))));
+}
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_profile.h"
+
+namespace shcore {
+namespace {
+void convert(int depth) {
+  Profile_frame frame("convert");
+  if (depth)
+    convert(depth - 1);
+}
+}
+
+TEST(utils_profile, disabled) {
+  Profiler::get().stop();
+  {
+    Profile_frame frame("statement");
+  }
+
+  Profiler::get().start();
+  Profiler::get().stop();
+  EXPECT_EQ("", Profiler::get().collapsed_stacks());
+}
+
+TEST(utils_profile, collapsed_stacks) {
+  Profiler::get().start();
+  {
+    Profile_frame statement("js statement");
+    for (int index = 0; index < 3; index++) {
+      Profile_frame call(std::string("ClassicSession.runSql"));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      convert(3);
+    }
+  }
+  Profiler::get().stop();
+
+  std::string stacks = Profiler::get().collapsed_stacks();
+  EXPECT_NE(std::string::npos, stacks.find("js statement;ClassicSession.runSql "));
+
+  // The recursion of a frame is accounted to the outer one
+  EXPECT_EQ(std::string::npos, stacks.find("convert;convert"));
+
+  std::string report = Profiler::get().flat_report();
+  EXPECT_NE(std::string::npos, report.find("         3  ClassicSession.runSql\n"));
+  EXPECT_NE(std::string::npos, report.find("         1  js statement\n"));
+}
+
+TEST(utils_profile, other_threads) {
+  Profiler::get().start();
+  std::thread([]() { Profile_frame frame("worker"); }).join();
+  Profiler::get().stop();
+
+  EXPECT_EQ(std::string::npos, Profiler::get().flat_report().find("worker"));
+}
+}
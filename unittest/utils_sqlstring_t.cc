@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_sqlstring.h"
+
+namespace shcore {
+TEST(utils_sqlstring, escape_sql_string) {
+  EXPECT_EQ("", escape_sql_string(""));
+  EXPECT_EQ("plain", escape_sql_string("plain"));
+  EXPECT_EQ("it\\'s \\\"quoted\\\"", escape_sql_string("it's \"quoted\""));
+  EXPECT_EQ("\\0\\n\\r\\\\\\Z", escape_sql_string(std::string("\0\n\r\\\032", 5)));
+  EXPECT_EQ("50% of_all", escape_sql_string("50% of_all"));
+  EXPECT_EQ("50\\% of\\_all", escape_sql_string("50% of_all", true));
+
+  // Special bytes on both sides of the 16 byte blocks
+  std::string value(40, 'x');
+  value[0] = '\'';
+  value[15] = '\n';
+  value[16] = '\\';
+  value[39] = '"';
+  EXPECT_EQ("\\'" + std::string(14, 'x') + "\\n\\\\" + std::string(22, 'x') + "\\\"", escape_sql_string(value));
+
+  std::string buffer("prefix ");
+  append_escaped_sql_string(buffer, "a'b", 3);
+  EXPECT_EQ("prefix a\\'b", buffer);
+}
+
+TEST(utils_sqlstring, format) {
+  std::string query = sqlstring("SELECT ? FROM ! WHERE id = ? AND name = ?", 0)
+                      << "it's" << "my table" << 5 << std::string("a\nb");
+  EXPECT_EQ("SELECT 'it\\'s' FROM `my table` WHERE id = 5 AND name = 'a\\nb'", query);
+
+  EXPECT_EQ("SELECT \"x\"", (sqlstring("SELECT ?", UseAnsiQuotes) << "x").str());
+  EXPECT_EQ("SELECT NULL", (sqlstring("SELECT ?", 0) << static_cast<const char *>(nullptr)).str());
+
+  sqlstring partial("INSERT INTO t VALUES (?, ?)", 0);
+  partial << "a";
+  EXPECT_FALSE(partial.done());
+  EXPECT_EQ("INSERT INTO t VALUES ('a', ?)", partial.str());
+
+  partial << 1;
+  EXPECT_TRUE(partial.done());
+  EXPECT_THROW(partial << 2, std::invalid_argument);
+
+  std::string script;
+  for (int index = 0; index < 2; index++)
+    (sqlstring("INSERT INTO t VALUES (?);\n", 0) << index).append_to(script);
+  EXPECT_EQ("INSERT INTO t VALUES (0);\nINSERT INTO t VALUES (1);\n", script);
+}
+}
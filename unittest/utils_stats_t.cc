@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_stats.h"
+
+namespace shcore {
+TEST(utils_stats, digest) {
+  EXPECT_EQ("select ?", Statement_stats::digest("select 1"));
+  EXPECT_EQ("SELECT ?", Statement_stats::digest("  SELECT\n\t1 /* comment */  "));
+  EXPECT_EQ("select ? from t", Statement_stats::digest("select 'it''s' from t # comment"));
+  EXPECT_EQ("select * from t where a in (?)", Statement_stats::digest("select * from t where a in (1, 2, 3)"));
+  EXPECT_EQ("select * from t where a in (?)", Statement_stats::digest("select * from t where a in ('x', \"y\")"));
+  EXPECT_EQ("select col1 from `t 1` where x = ?", Statement_stats::digest("select col1 from `t 1` where x = -- c\n1.5e+3"));
+  EXPECT_EQ("select ? - ?", Statement_stats::digest("select 5 - 3"));
+
+  std::string big = "select '" + std::string(5000, 'x') + "', " + std::string(2000, 'a');
+  EXPECT_EQ(Statement_stats::k_max_digest_length, Statement_stats::digest(big).length());
+}
+
+TEST(utils_stats, histogram_buckets) {
+  // Every value is within its bucket with at most 1/16 of error
+  uint64_t values[] = { 0, 1, 31, 32, 33, 1000, 123456, 1ULL << 39 };
+  for (auto value : values) {
+    size_t index = Latency_histogram::bucket_index(value);
+    uint64_t upper = Latency_histogram::bucket_upper_bound(index);
+    EXPECT_LE(value, upper);
+    EXPECT_LE(upper - value, value / 16);
+
+    if (index > 0) {
+      EXPECT_LT(Latency_histogram::bucket_upper_bound(index - 1), value);
+    }
+  }
+
+  EXPECT_EQ(Latency_histogram::bucket_index(1ULL << 40), Latency_histogram::bucket_index(1ULL << 60));
+  EXPECT_LT(Latency_histogram::bucket_index((1ULL << 40) - 1), Latency_histogram::bucket_index(1ULL << 40));
+}
+
+TEST(utils_stats, histogram_percentiles) {
+  Latency_histogram histogram;
+  EXPECT_EQ(0u, histogram.percentile(50));
+
+  for (uint64_t value = 1; value <= 1000; value++)
+    histogram.record(value);
+
+  EXPECT_EQ(1000u, histogram.count());
+  EXPECT_EQ(1u, histogram.min());
+  EXPECT_EQ(1000u, histogram.max());
+  EXPECT_EQ(500500u, histogram.total());
+  EXPECT_DOUBLE_EQ(500.5, histogram.mean());
+
+  EXPECT_NEAR(500, histogram.percentile(50), 32);
+  EXPECT_NEAR(900, histogram.percentile(90), 57);
+  EXPECT_NEAR(990, histogram.percentile(99), 62);
+  EXPECT_EQ(1000u, histogram.percentile(100));
+}
+
+TEST(utils_stats, slow_statement_explainable) {
+  EXPECT_TRUE(Slow_statement_log::explainable("select 1"));
+  EXPECT_TRUE(Slow_statement_log::explainable("  /* hint */ UPDATE t SET a = 1"));
+  EXPECT_TRUE(Slow_statement_log::explainable("(select 1) union (select 2)"));
+  EXPECT_TRUE(Slow_statement_log::explainable("with x as (select 1) select * from x"));
+  EXPECT_FALSE(Slow_statement_log::explainable("show tables"));
+  EXPECT_FALSE(Slow_statement_log::explainable("call p()"));
+  EXPECT_FALSE(Slow_statement_log::explainable(""));
+}
+
+TEST(utils_stats, slow_statement_format) {
+  Statement_timing timing;
+  timing.phases[Statement_timing::Server] = 1500000;
+  timing.phases[Statement_timing::Network] = 2000;
+  timing.phases[Statement_timing::Decode] = 300;
+
+  // The values of the statement are not logged
+  Value entry = Value::parse(Slow_statement_log::format("select * from t where name = 'secret'", timing, 3,
+                                                        "{\"query_block\": {\"select_id\": 1}}"));
+  Value::Map_type_ref map = entry.as_map();
+  EXPECT_EQ("select * from t where name = ?", map->get_string("statement"));
+  EXPECT_EQ(1500000, map->get_int("server_us"));
+  EXPECT_EQ(2000, map->get_int("network_us"));
+  EXPECT_EQ(1502300, map->get_int("total_us"));
+  EXPECT_EQ(3, map->get_int("rows"));
+  EXPECT_EQ(Map, (*map)["explain"].type);
+  EXPECT_EQ(20u, map->get_string("time").length());
+
+  entry = Value::parse(Slow_statement_log::format("show tables", timing, 0, "not explainable"));
+  EXPECT_EQ("not explainable", entry.as_map()->get_string("explain"));
+}
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_trace.h"
+#include <rapidjson/document.h>
+
+namespace shcore {
+namespace {
+const char *kTraceFile = "utils_trace_t.json";
+
+// The events of the trace by name
+std::map<std::string, const rapidjson::Value*> events_by_name(const rapidjson::Document &trace) {
+  std::map<std::string, const rapidjson::Value*> events;
+  const rapidjson::Value &list = trace["traceEvents"];
+  for (rapidjson::SizeType index = 0; index < list.Size(); index++)
+    events[list[index]["name"].GetString()] = &list[index];
+
+  return events;
+}
+
+void load_trace(rapidjson::Document *trace) {
+  std::ifstream file(kTraceFile);
+  std::stringstream data;
+  data << file.rdbuf();
+  trace->Parse(data.str().c_str());
+  std::remove(kTraceFile);
+}
+}
+
+TEST(utils_trace, not_recording) {
+  EXPECT_FALSE(Trace_session::active());
+
+  Trace_span span("nothing");
+  EXPECT_FALSE(span.recording());
+  EXPECT_EQ(0u, Trace_span::current());
+}
+
+TEST(utils_trace, nested_spans) {
+  {
+    Trace_session session(kTraceFile);
+    EXPECT_TRUE(Trace_session::active());
+
+    Trace_span outer("outer");
+    EXPECT_TRUE(outer.recording());
+    EXPECT_EQ(outer.id(), Trace_span::current());
+
+    {
+      // Ignored, the outer session records everything
+      Trace_session inner_session("ignored.json");
+
+      Trace_span inner("inner");
+      inner.set("sql", "SELECT \"quoted\"\n");
+      EXPECT_EQ(inner.id(), Trace_span::current());
+    }
+    EXPECT_EQ(outer.id(), Trace_span::current());
+
+    uint64_t parent = Trace_span::current();
+    std::thread([parent]() {
+      Trace_span worker("worker", parent);
+    }).join();
+  }
+
+  EXPECT_FALSE(Trace_session::active());
+  EXPECT_FALSE(std::ifstream("ignored.json").good());
+
+  rapidjson::Document trace;
+  load_trace(&trace);
+  ASSERT_FALSE(trace.HasParseError());
+
+  auto events = events_by_name(trace);
+  ASSERT_EQ(3u, events.size());
+
+  auto &outer = *events["outer"];
+  auto &inner = *events["inner"];
+  auto &worker = *events["worker"];
+  EXPECT_STREQ("X", outer["ph"].GetString());
+  EXPECT_FALSE(outer["args"].HasMember("parent"));
+  EXPECT_EQ(outer["args"]["id"].GetUint64(), inner["args"]["parent"].GetUint64());
+  EXPECT_EQ(outer["args"]["id"].GetUint64(), worker["args"]["parent"].GetUint64());
+  EXPECT_STREQ("SELECT \"quoted\"\n", inner["args"]["sql"].GetString());
+
+  // Each thread has a timeline of its own, the inner span is within the outer
+  EXPECT_EQ(outer["tid"].GetUint(), inner["tid"].GetUint());
+  EXPECT_NE(outer["tid"].GetUint(), worker["tid"].GetUint());
+  EXPECT_LE(outer["ts"].GetInt64(), inner["ts"].GetInt64());
+  EXPECT_LE(inner["ts"].GetInt64() + inner["dur"].GetInt64(), outer["ts"].GetInt64() + outer["dur"].GetInt64());
+}
+
+TEST(utils_trace, span_outliving_session) {
+  std::unique_ptr<Trace_span> span;
+  {
+    Trace_session session(kTraceFile);
+    span.reset(new Trace_span("open"));
+  }
+
+  // Written as ending with the session, and no longer recorded
+  span->set("late", "ignored");
+  span.reset();
+  EXPECT_EQ(0u, Trace_span::current());
+
+  rapidjson::Document trace;
+  load_trace(&trace);
+  ASSERT_FALSE(trace.HasParseError());
+
+  auto events = events_by_name(trace);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_FALSE((*events["open"])["args"].HasMember("late"));
+}
+}
@@ -13,6 +13,7 @@
  along with this program; if not, write to the Free Software
  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -144,6 +145,42 @@ public:
   }
 };
 
+// Object registering its methods the way session objects do, used to measure
+// the cost of calling methods from JavaScript
+class Session_like : public shcore::Cpp_object_bridge {
+public:
+  Session_like() : _calls(0) {
+    add_method("getUri", std::bind(&Session_like::get_uri, this, _1), NULL);
+    add_method("getDefaultSchema", std::bind(&Session_like::get_uri, this, _1), NULL);
+    add_method("isOpen", std::bind(&Session_like::is_open, this, _1), NULL);
+    add_method("setFetchWarnings", std::bind(&Session_like::is_open, this, _1), "enable", shcore::Bool, NULL);
+    add_method("startTransaction", std::bind(&Session_like::is_open, this, _1), NULL);
+    add_method("quoteName", std::bind(&Session_like::quote_name, this, _1), "id", shcore::String, NULL);
+  }
+
+  virtual std::string class_name() const { return "SessionLike"; }
+  virtual bool operator == (const Object_bridge &UNUSED(other)) const { return false; }
+
+  shcore::Value get_uri(const shcore::Argument_list &args) {
+    args.ensure_count(0, "SessionLike.getUri");
+    _calls++;
+    return shcore::Value("mysqlx://root@localhost:33060");
+  }
+
+  shcore::Value is_open(const shcore::Argument_list &UNUSED(args)) {
+    _calls++;
+    return shcore::Value::True();
+  }
+
+  shcore::Value quote_name(const shcore::Argument_list &args) {
+    args.ensure_count(1, "SessionLike.quoteName");
+    _calls++;
+    return shcore::Value("`" + args.string_at(0) + "`");
+  }
+
+  int _calls;
+};
+
 namespace shcore {
 namespace tests {
 class Environment {
@@ -285,6 +322,38 @@ TEST_F(JavaScript, array_to_js) {
   ASSERT_EQ(result.repr(), "[1, 2, 3]");
 }
 
+TEST_F(JavaScript, wrappers_are_collected) {
+  v8::Isolate::Scope isolate_scope(env.js->isolate());
+  v8::HandleScope handle_scope(env.js->isolate());
+  v8::Context::Scope context_scope(v8::Local<v8::Context>::New(env.js->isolate(),
+                                                               env.js->context()));
+
+  std::shared_ptr<Value::Array_type> arr(new Value::Array_type);
+  std::shared_ptr<Value::Map_type> map(new Value::Map_type);
+  std::shared_ptr<Object_bridge> object(new Test_object(1));
+  arr->push_back(Value(object));
+  (*map)["row"] = Value(arr);
+
+  // The wrappers only hold weak handles, once JS is done with them they
+  // are collected and release the native data they wrap
+  for (int i = 0; i < 1000; i++) {
+    v8::HandleScope inner_scope(env.js->isolate());
+    env.js->shcore_value_to_v8_value(Value(map));
+    env.js->shcore_value_to_v8_value(Value(arr));
+    env.js->shcore_value_to_v8_value(Value(object));
+  }
+
+  env.js->set_global("rows", Value(arr));
+  env.js->execute("for (var i = 0; i < 1000; i++) { rows[0].value; }");
+  env.js->execute("rows = null;");
+
+  env.js->isolate()->LowMemoryNotification();
+
+  EXPECT_EQ(1, map.use_count());
+  EXPECT_EQ(2, arr.use_count());
+  EXPECT_EQ(2, object.use_count());
+}
+
 TEST_F(JavaScript, map_to_js) {
   v8::Isolate::Scope isolate_scope(env.js->isolate());
   v8::HandleScope handle_scope(env.js->isolate());
@@ -439,5 +508,28 @@ TEST_F(JavaScript, js_date_object) {
   ASSERT_TRUE(object.as_object()->class_name() == "Date");
   ASSERT_EQ("\"2014-01-01 0:00:00\"", object.repr());
 }
+// Tight loop calling methods of a session like object from JavaScript, run
+// with --gtest_also_run_disabled_tests --gtest_filter=*bench*
+TEST_F(JavaScript, DISABLED_bench_method_calls) {
+  v8::Isolate::Scope isolate_scope(env.js->isolate());
+  v8::HandleScope handle_scope(env.js->isolate());
+  v8::TryCatch try_catch;
+  v8::Context::Scope context_scope(v8::Local<v8::Context>::New(env.js->isolate(),
+                                                               env.js->context()));
+
+  std::shared_ptr<Session_like> session(new Session_like());
+  env.js->set_global("bench_session", Value(std::static_pointer_cast<Object_bridge>(session)));
+
+  const int count = 100000;
+  auto start = std::chrono::steady_clock::now();
+  env.js->execute((boost::format("for (var i = 0; i < %1%; i++) {"
+                                 "  bench_session.getUri(); bench_session.quoteName('table'); bench_session.isOpen();"
+                                 "}") % count).str());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(3 * count, session->_calls);
+  std::printf("method call: %.0f ns/call\n",
+    std::chrono::duration<double, std::nano>(elapsed).count() / (3 * count));
+}
 }
 }
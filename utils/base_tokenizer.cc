@@ -60,21 +60,18 @@
 
 using namespace shcore;
 
-BaseToken::BaseToken(const std::string& type, const std::string& text, int cur_pos) : _type(type), _text(text), _pos(cur_pos) {}
-
-BaseTokenizer::BaseTokenizer() : _allow_spaces(true), _allow_unknown_tokens(false) {
+BaseTokenizer::BaseTokenizer() : _allow_spaces(true), _allow_unknown_tokens(false), _unknown_start(0),
+  _unknown_length(0), _final_type(Token_unknown), _final_name("") {
   _pos = 0;
   _parent_offset = 0;
 }
 
 void BaseTokenizer::reset() {
-  _base_tokens.clear();
-  _custom_tokens.clear();
-  _token_sequences.clear();
-  _token_vectors.clear();
-  _token_functions.clear();
-  _final_type.clear();
-  _final_group.clear();
+  _simple_tokens.reset();
+  _rules.clear();
+  _final_type = Token_unknown;
+  _final_name = "";
+  _final_group.reset();
 }
 
 void BaseTokenizer::process(const std::pair<size_t, size_t> range) {
@@ -90,30 +87,46 @@ bool BaseTokenizer::next_char_is(tokens_t::size_type i, int tok) {
   return (i + 1) < _input.size() && _input[i + 1] == tok;
 }
 
-void BaseTokenizer::assert_cur_token(const std::string& type) {
+std::string BaseTokenizer::type_name(Token_kind type) const {
+  if (type < Token_unknown)
+    return std::string(1, static_cast<char>(type));
+
+  if (type == Token_unknown)
+    return "unknown";
+
+  if (type == _final_type)
+    return _final_name;
+
+  for (auto &rule : _rules) {
+    if (rule.type == type)
+      return rule.name;
+  }
+
+  return std::to_string(type);
+}
+
+void BaseTokenizer::assert_cur_token(Token_kind type) {
   assert_tok_position();
   const BaseToken& tok = _tokens.at(_pos);
-  std::string tok_type = tok.get_type();
-  if (tok_type != type)
-    throw std::runtime_error((boost::format("Expected token type %1% at position %2% but found type %3% (%4%)") % type % tok.get_pos() % tok_type % tok.get_text()).str());
+  if (tok.get_type() != type)
+    throw std::runtime_error((boost::format("Expected token type %1% at position %2% but found type %3% (%4%)") % type_name(type) % tok.get_pos() % type_name(tok.get_type()) % tok.get_text()).str());
 }
 
-bool BaseTokenizer::cur_token_type_is(const std::string& type) {
+bool BaseTokenizer::cur_token_type_is(Token_kind type) {
   return pos_token_type_is(_pos, type);
 }
 
-bool BaseTokenizer::next_token_type(const std::string& type, size_t pos) {
+bool BaseTokenizer::next_token_type(Token_kind type, size_t pos) {
   return pos_token_type_is(_pos + pos, type);
 }
 
-bool BaseTokenizer::pos_token_type_is(tokens_t::size_type pos, const std::string& type) {
+bool BaseTokenizer::pos_token_type_is(tokens_t::size_type pos, Token_kind type) {
   return (pos < _tokens.size()) && (_tokens[pos].get_type() == type);
 }
 
-const std::string& BaseTokenizer::consume_token(const std::string& type) {
+const BaseToken& BaseTokenizer::consume_token(Token_kind type) {
   assert_cur_token(type);
-  const std::string& v = _tokens[_pos++].get_text();
-  return v;
+  return _tokens[_pos++];
 }
 
 const BaseToken& BaseTokenizer::peek_token() {
@@ -133,26 +146,31 @@ void BaseTokenizer::unget_token() {
 }
 
 void BaseTokenizer::get_tokens(size_t start, size_t end) {
+  const char *input = _input.data();
+  size_t length = _input.length();
+
+  _unknown_length = 0;
+
   for (size_t i = start; i <= end; ++i) {
 
     // Safety measure, trying to parse ahead of the limit makes this end
-    if (i >= _input.length())
+    if (i >= length)
       break;
 
-    if (std::isspace(_input[i]) && !_allow_spaces)
+    unsigned char c = static_cast<unsigned char>(input[i]);
+    if (std::isspace(c) && !_allow_spaces)
         throw std::runtime_error((boost::format("Illegal space found at position %1%") % (_parent_offset + i)).str());
     else {
-      std::string type(&_input[i], 1);
-      if (_base_tokens.find(type) != _base_tokens.end())
-        add_token(BaseToken(type, _base_tokens[type], i));
+      if (_simple_tokens[c])
+        add_token(BaseToken(c, input + i, 1, i));
       else {
         bool found = false;
-        for (auto token_type : _custom_tokens) {
-          if (_token_functions.find(token_type) != _token_functions.end()) {
-            std::string text;
-            size_t start = i;
-            if (_token_functions[token_type](_input, i, text)) {
-              add_token(BaseToken(token_type, text, start));
+        for (auto &rule : _rules) {
+          size_t start = i;
+
+          if (rule.method == Rule::Function) {
+            if (rule.function(_input, i)) {
+              add_token(BaseToken(rule.type, input + start, i - start, start));
               found = true;
               i--;
               break;
@@ -161,33 +179,28 @@ void BaseTokenizer::get_tokens(size_t start, size_t end) {
           }
 
           // Token sequences are to create a single token with many characters as long as they belong to the given sequence
-          else if (_token_sequences.find(token_type) != _token_sequences.end()) {
-            size_t start = i;
-
-            while (i < _input.length() && _token_sequences[token_type].find(_input[i]) != std::string::npos)
+          else if (rule.method == Rule::Sequence) {
+            while (i < length && rule.groups[0][static_cast<unsigned char>(input[i])])
               i++;
 
             found = i > start;
             if (found) {
-              add_token(BaseToken(token_type, _input.substr(start, i - start), start));
+              add_token(BaseToken(rule.type, input + start, i - start, start));
               i--;
               break;
             }
           }
 
-          else if (_token_vectors.find(token_type) != _token_vectors.end()) {
-            std::string text;
-            size_t start = i;
-            for (auto item : _token_vectors[token_type]) {
-              if (item.find(_input[i]) != std::string::npos) {
-                text += _input[i];
+          else {
+            for (size_t group = 0; group < rule.group_count; group++) {
+              if (i < length && rule.groups[group][static_cast<unsigned char>(input[i])])
                 i++;
-              } else
+              else
                 break;
             }
 
-            if ((i - start) == _token_vectors[token_type].size()) {
-              add_token(BaseToken(token_type, text, start));
+            if ((i - start) == rule.group_count) {
+              add_token(BaseToken(rule.type, input + start, i - start, start));
               found = true;
               i--;
               break;
@@ -196,38 +209,36 @@ void BaseTokenizer::get_tokens(size_t start, size_t end) {
           }
         }
 
-        if (_final_group.find(type) != std::string::npos) {
-          add_token(BaseToken(_final_type, _input.substr(i), i));
+        if (_final_group[c]) {
+          add_token(BaseToken(_final_type, input + i, length - i, i));
           found = true;
           break;
         }
 
         if (!found) {
-          if ( _allow_unknown_tokens)
-            _unknown_token += _input[i];
-          else
-            throw std::runtime_error((boost::format("Illegal character [%1%] found at position %2%") % _input[i] % (_parent_offset + i)).str());
+          if (_allow_unknown_tokens) {
+            if (!_unknown_length)
+              _unknown_start = i;
+            _unknown_length++;
+          } else
+            throw std::runtime_error((boost::format("Illegal character [%1%] found at position %2%") % input[i] % (_parent_offset + i)).str());
         }
       }
     }
   }
 
-  if (_allow_unknown_tokens && !_unknown_token.empty()) {
-    size_t position = 0;
-
-    if (!_tokens.empty())
-      position = _tokens[_tokens.size()-1].get_pos() + _tokens[_tokens.size()-1].get_text().length();
-
-    _tokens.push_back(BaseToken("unknown", _unknown_token, position));
+  if (_allow_unknown_tokens && _unknown_length) {
+    _tokens.push_back(BaseToken(Token_unknown, input + _unknown_start, _unknown_length, _unknown_start));
+    _unknown_length = 0;
   }
 }
 
 void BaseTokenizer::add_token(const BaseToken& token) {
 
   // If unknown tokens are allowed and there's one, adds it
-  if (_allow_unknown_tokens && !_unknown_token.empty()) {
-    _tokens.push_back(BaseToken("unknown", _unknown_token, token.get_pos() - _unknown_token.length()));
-    _unknown_token.clear();
+  if (_allow_unknown_tokens && _unknown_length) {
+    _tokens.push_back(BaseToken(Token_unknown, _input.data() + _unknown_start, _unknown_length, _unknown_start));
+    _unknown_length = 0;
   }
 
   _tokens.push_back(token);
@@ -253,35 +264,74 @@ bool BaseTokenizer::tokens_available() {
   return _pos < _tokens.size();
 }
 
-void BaseTokenizer::set_complex_token(const std::string &type, std::function<bool(const std::string& input, size_t&, std::string&)>function) {
-  if (std::find(_custom_tokens.begin(), _custom_tokens.end(), type) == _custom_tokens.end()) {
-    _custom_tokens.push_back(type);
-    _token_functions[type] = function;
+BaseTokenizer::Char_group BaseTokenizer::char_group(const std::string &chars) {
+  Char_group group;
+  for (auto c : chars)
+    group.set(static_cast<unsigned char>(c));
+
+  return group;
+}
+
+bool BaseTokenizer::has_rule(Token_kind type) const {
+  for (auto &rule : _rules) {
+    if (rule.type == type)
+      return true;
   }
+
+  return false;
 }
 
-void BaseTokenizer::set_complex_token(const std::string &type, const std::string& group) {
-  if (std::find(_custom_tokens.begin(), _custom_tokens.end(), type) == _custom_tokens.end()) {
-    _custom_tokens.push_back(type);
-    _token_sequences[type] = group;
+void BaseTokenizer::set_complex_token(Token_kind type, const char *name, Token_function function) {
+  if (!has_rule(type)) {
+    _rules.emplace_back();
+    Rule &rule = _rules.back();
+    rule.type = type;
+    rule.name = name;
+    rule.method = Rule::Function;
+    rule.group_count = 0;
+    rule.function = function;
   }
 }
 
-void BaseTokenizer::set_complex_token(const std::string &type, const std::vector<std::string>& groups) {
-  if (std::find(_custom_tokens.begin(), _custom_tokens.end(), type) == _custom_tokens.end()) {
-    _custom_tokens.push_back(type);
-    _token_vectors[type] = groups;
+void BaseTokenizer::set_complex_token(Token_kind type, const char *name, const std::string& group) {
+  if (!has_rule(type)) {
+    _rules.emplace_back();
+    Rule &rule = _rules.back();
+    rule.type = type;
+    rule.name = name;
+    rule.method = Rule::Sequence;
+    rule.groups[0] = char_group(group);
+    rule.group_count = 1;
   }
 }
 
-void BaseTokenizer::remove_complex_token(const std::string& name) {
-  if (_token_functions.find(name) != _token_functions.end()) {
-    _token_functions.erase(name);
-    _custom_tokens.erase(std::find(_custom_tokens.begin(), _custom_tokens.end(), name));
+void BaseTokenizer::set_complex_token(Token_kind type, const char *name, std::initializer_list<std::string> groups) {
+  if (groups.size() > k_max_groups)
+    throw std::logic_error("Too many groups for a token");
+
+  if (!has_rule(type)) {
+    _rules.emplace_back();
+    Rule &rule = _rules.back();
+    rule.type = type;
+    rule.name = name;
+    rule.method = Rule::Groups;
+    rule.group_count = 0;
+    for (auto &group : groups)
+      rule.groups[rule.group_count++] = char_group(group);
   }
+}
 
-  if (_token_vectors.find(name) != _token_vectors.end()) {
-    _token_vectors.erase(name);
-    _custom_tokens.erase(std::find(_custom_tokens.begin(), _custom_tokens.end(), name));
+void BaseTokenizer::remove_complex_token(Token_kind type) {
+  for (auto rule = _rules.begin(); rule != _rules.end(); ++rule) {
+    if (rule->type == type) {
+      _rules.erase(rule);
+      break;
+    }
   }
 }
+
+void BaseTokenizer::set_final_token_group(Token_kind type, const char *name, const std::string& group) {
+  _final_type = type;
+  _final_name = name;
+  _final_group = char_group(group);
+}
@@ -20,13 +20,13 @@
 #ifndef _BASE_TOKENIZER_H_
 #define _BASE_TOKENIZER_H_
 
-#include <string>
-#include <vector>
-#include <map>
-#include <set>
+#include <bitset>
+#include <functional>
+#include <initializer_list>
 #include <memory>
 #include <stdexcept>
-#include <functional>
+#include <string>
+#include <vector>
 
 // Avoid warnings from includes of other project and protobuf
 #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)
@@ -45,17 +45,31 @@
 #endif
 
 namespace shcore {
+// The kind of a token: the simple tokens are of the kind of their char, the
+// others are of the kinds given by the users of the tokenizer, starting at
+// Token_first_custom
+typedef int Token_kind;
+const Token_kind Token_unknown = 256;
+const Token_kind Token_first_custom = 257;
+
+// The text of the token is a span of the input of the tokenizer, it is
+// valid until the input is changed
 class BaseToken {
 public:
-  BaseToken(const std::string &type, const std::string& text, int cur_pos);
-
-  const std::string& get_text() const { return _text; }
-  const std::string& get_type() const { return _type; }
-  int get_pos() const { return _pos; }
+  BaseToken(Token_kind type, const char *text, size_t length, size_t cur_pos)
+    : _type(type), _text(text), _length(length), _pos(cur_pos) {}
+
+  Token_kind get_type() const { return _type; }
+  const char *get_data() const { return _text; }
+  size_t get_length() const { return _length; }
+  std::string get_text() const { return std::string(_text, _length); }
+  void append_text(std::string &out) const { out.append(_text, _length); }
+  size_t get_pos() const { return _pos; }
 private:
-  std::string _type;
-  std::string _text;
-  int _pos;
+  Token_kind _type;
+  const char *_text;
+  size_t _length;
+  size_t _pos;
 };
 
 /**
@@ -74,11 +88,11 @@ public:
   typedef std::vector<BaseToken> tokens_t;
 
   bool next_char_is(tokens_t::size_type i, int tok);
-  void assert_cur_token(const std::string& type);
-  bool cur_token_type_is(const std::string& type);
-  bool next_token_type(const std::string& type, size_t pos = 1);
-  bool pos_token_type_is(tokens_t::size_type pos, const std::string& type);
-  const std::string& consume_token(const std::string& type);
+  void assert_cur_token(Token_kind type);
+  bool cur_token_type_is(Token_kind type);
+  bool next_token_type(Token_kind type, size_t pos = 1);
+  bool pos_token_type_is(tokens_t::size_type pos, Token_kind type);
+  const BaseToken& consume_token(Token_kind type);
   const BaseToken& peek_token();
   const BaseToken* peek_last_token();
   void unget_token();
@@ -91,44 +105,49 @@ public:
   std::vector<BaseToken>::const_iterator begin() const { return _tokens.begin(); }
   std::vector<BaseToken>::const_iterator end() const { return _tokens.end(); }
 
-  //int get_quoted_token(char quote, size_t &index);
   void get_tokens(size_t start, size_t end);
   const std::string& get_input() { return _input; }
   void add_token(const BaseToken& token);
 
+  // The name of the kind, as given to its rule, for the error messages
+  std::string type_name(Token_kind type) const;
+
 protected:
   std::vector<BaseToken> _tokens;
   std::string _input;
   tokens_t::size_type _pos;
   size_t _parent_offset;
 public:
+  typedef std::bitset<256> Char_group;
+  typedef std::function<bool(const std::string& input, size_t& index)> Token_function;
 
   // These functions set the rulse to be followed when tokenizing a string.
-  // Sets a rule for a token that would generate a fixed string
-  void set_custom_token(const std::string &type, const std::string &text) { _base_tokens[type] = text; }
+  // The rules are kept in flat tables, so setting them again on the same
+  // tokenizer after reset() reuses their memory.
 
   // Sets rule for single char tokens returning the token itself
   // Every received char creates a separate token
-  void set_simple_tokens(const std::string &tokens) { for (auto token : tokens) { _base_tokens[std::string(&token, 1)] = token; } };
+  void set_simple_tokens(const std::string &tokens) { for (auto token : tokens) _simple_tokens.set(static_cast<unsigned char>(token)); };
 
   // To remove simple tokens
-  void remove_simple_tokens(const std::string &tokens) { for (auto token : tokens) { _base_tokens.erase(std::string(&token, 1)); } };
+  void remove_simple_tokens(const std::string &tokens) { for (auto token : tokens) _simple_tokens.reset(static_cast<unsigned char>(token)); };
 
   // Sets rule for tokens formed based on several single tokens, each token must fall into a specified set
-  // Example if the next rule is defined: "PCTE", ["%", "01234567890ABCDEF", "01234567890ABCDEF"]
-  // A token of type "PCTE will be created whenever a sequence like %XX appears on the string, X is "
-  void set_complex_token(const std::string &type, const std::vector<std::string>& groups);
+  // Example if the next rule is defined: Pct_encoded, {"%", "01234567890ABCDEF", "01234567890ABCDEF"}
+  // A token of kind Pct_encoded will be created whenever a sequence like %XX appears on the string
+  void set_complex_token(Token_kind type, const char *name, std::initializer_list<std::string> groups);
 
-  // Sets rule for tokens created based on a custom function
+  // Sets rule for tokens created based on a custom function, which moves the
+  // index past the token and returns true if there is one at the index
   // this is meant o be used with labndas defning a token based on whatever logic, so for complicated cases
-  void set_complex_token(const std::string &type, std::function<bool(const std::string& input, size_t&, std::string&)> function);
+  void set_complex_token(Token_kind type, const char *name, Token_function function);
 
   // Sets rule for tokens created with sequences of chars
   // A token of the given type would be created with all the consecutive characters that contained in the defined group
-  // IE: "DIGITS", "01234567890"
-  void set_complex_token(const std::string &type, const std::string& group);
+  // IE: Digits, "01234567890"
+  void set_complex_token(Token_kind type, const char *name, const std::string& group);
 
-  void remove_complex_token(const std::string& name);
+  void remove_complex_token(Token_kind type);
 
   // Enable or disable spaces, i.e. if disabled and found, an error will be raised
   void set_allow_spaces(bool allow = true) { _allow_spaces = allow; }
@@ -138,19 +157,37 @@ public:
 
   // Sets the tokens that mark the end of the parsing, remaining input is returned as
   // a final type token
-  void set_final_token_group(const std::string &type, const std::string& group) { _final_type = type; _final_group = group; };
+  void set_final_token_group(Token_kind type, const char *name, const std::string& group);
 private:
+  // Up to the chars of a percent encoded value
+  static const size_t k_max_groups = 3;
+
+  struct Rule {
+    enum Method { Sequence, Groups, Function };
+
+    Token_kind type;
+    const char *name;
+    Method method;
+    // The chars of a sequence, or those of each position
+    Char_group groups[k_max_groups];
+    size_t group_count;
+    Token_function function;
+  };
+
+  static Char_group char_group(const std::string &chars);
+  bool has_rule(Token_kind type) const;
+
   bool _allow_spaces;
   bool _allow_unknown_tokens;
-  std::string _unknown_token;
-  std::string _final_type;
-  std::string _final_group;
-
-  std::map<std::string, std::string> _base_tokens;
-  std::vector<std::string> _custom_tokens;
-  std::map<std::string, std::string> _token_sequences;
-  std::map<std::string, std::vector<std::string> > _token_vectors;
-  std::map<std::string, std::function<bool(const std::string& input, size_t&, std::string&)> > _token_functions;
+  // Start and length of the chars with no rule found since the last token
+  size_t _unknown_start;
+  size_t _unknown_length;
+  Token_kind _final_type;
+  const char *_final_name;
+  Char_group _final_group;
+
+  Char_group _simple_tokens;
+  std::vector<Rule> _rules;
 };
 }
 
@@ -46,7 +46,6 @@
 #pragma warning (pop)
 #endif
 
-#include <boost/lexical_cast.hpp>
 using namespace shcore::uri;
 
 std::string Uri_parser::DELIMITERS = ":/?#[]@";
@@ -73,6 +72,31 @@ std::string Uri_parser::UNRESERVED = ALPHANUMERIC + "-._~";
 #define IS_RESERVED(x) RESERVED.find(x)!=std::string::npos
 #define IS_UNRESERVED(x) UNRESERVED.find(x)!=std::string::npos
 
+namespace {
+// The kinds of the tokens in the URI, besides the single char ones
+enum Uri_token {
+  Alphanumeric = shcore::Token_first_custom,
+  Pct_encoded,
+  Unreserved,
+  Sub_delims,
+  Digits,
+  Hex_digits,
+  Delims,
+  Password,
+  Pause,
+  End
+};
+
+// The value of a token of digits, any value over limit is returned as limit + 1
+int digits_value(const shcore::BaseToken &token, int limit) {
+  int value = 0;
+  for (size_t index = 0; index < token.get_length() && value <= limit; index++)
+    value = value * 10 + (token.get_data()[index] - '0');
+
+  return value > limit ? limit + 1 : value;
+}
+}
+
 std::map<char, char> Uri_parser::hex_literals = {
   {'1', 1}, {'2', 2}, {'3', 3}, {'4', 4},
   {'5', 5}, {'6', 6}, {'7', 7}, {'8', 8},
@@ -124,15 +148,15 @@ void Uri_parser::parse_scheme() {
     // RFC3986 Defines the next valid chars: +.-
     // However, in the Specification we only consider alphanumerics and + for extensions
     _tokenizer.set_simple_tokens("+");
-    _tokenizer.set_complex_token("alphanumeric", ALPHANUMERIC);
+    _tokenizer.set_complex_token(Alphanumeric, "alphanumeric", ALPHANUMERIC);
 
     _tokenizer.process(_chunks[URI_SCHEME]);
 
-    _data->_scheme = _tokenizer.consume_token("alphanumeric");
+    _data->_scheme = _tokenizer.consume_token(Alphanumeric).get_text();
 
     if (_tokenizer.tokens_available()) {
-      _tokenizer.consume_token("+");
-      _data->_scheme_ext = _tokenizer.consume_token("alphanumeric");
+      _tokenizer.consume_token('+');
+      _data->_scheme_ext = _tokenizer.consume_token(Alphanumeric).get_text();
 
       if (_tokenizer.tokens_available())
         throw Parser_error((boost::format("Invalid scheme format [%1%], only one extension is supported") % get_input_chunk(_chunks[URI_SCHEME])).str());
@@ -152,21 +176,21 @@ void Uri_parser::parse_userinfo() {
     _tokenizer.reset();
 
     _tokenizer.set_allow_spaces(false);
-    _tokenizer.set_complex_token("pct-encoded", {"%", HEXDIG, HEXDIG});
-    _tokenizer.set_complex_token("unreserved", UNRESERVED);
-    _tokenizer.set_complex_token("sub-delims", SUBDELIMITERS);
+    _tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", HEXDIG, HEXDIG});
+    _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED);
+    _tokenizer.set_complex_token(Sub_delims, "sub-delims", SUBDELIMITERS);
     _tokenizer.set_simple_tokens(":");
-    _tokenizer.set_final_token_group("password", ":");
+    _tokenizer.set_final_token_group(Password, "password", ":");
 
     _tokenizer.process(_chunks[URI_USER_INFO]);
 
     while (_tokenizer.tokens_available()) {
-      if (_tokenizer.cur_token_type_is(":"))
+      if (_tokenizer.cur_token_type_is(':'))
         _data->_has_password = true;
-      else if (_tokenizer.cur_token_type_is("pct-encoded"))
-        (_data->_has_password ? _data->_password : _data->_user) += percent_decode(_tokenizer.peek_token().get_text());
+      else if (_tokenizer.cur_token_type_is(Pct_encoded))
+        (_data->_has_password ? _data->_password : _data->_user) += percent_decode(_tokenizer.peek_token().get_data());
       else
-        (_data->_has_password ? _data->_password : _data->_user) += _tokenizer.peek_token().get_text();
+        _tokenizer.peek_token().append_text(_data->_has_password ? _data->_password : _data->_user);
 
       _tokenizer.consume_any_token();
     }
@@ -213,32 +237,91 @@ void Uri_parser::parse_target() {
 
       if (offset <= _chunks[URI_TARGET].second)
         throw Parser_error("Unexpected data [" + get_input_chunk({offset, _chunks[URI_TARGET].second}) + "] at position " + std::to_string(offset));
-    } else
+    } else if (is_host_list(start, end))
+      parse_host_list();
+    else
       parse_host();
   }
 }
 
+bool Uri_parser::is_host_list(size_t start, size_t end) {
+  // A list is enclosed in brackets and has commas out of the brackets of
+  // its IPv6 addresses
+  if (_input[start] != '[' || _input[end] != ']')
+    return false;
+
+  int depth = 0;
+  for (size_t index = start; index <= end; index++) {
+    if (_input[index] == '[')
+      depth++;
+    else if (_input[index] == ']')
+      depth--;
+    else if (_input[index] == ',' && depth == 1)
+      return true;
+  }
+
+  return false;
+}
+
+void Uri_parser::parse_host_list() {
+  auto target = _chunks[URI_TARGET];
+
+  // Ranges of the hosts, between the brackets and the commas of the list
+  std::vector<std::pair<size_t, size_t> > ranges;
+  size_t start = target.first + 1;
+  int depth = 0;
+  for (size_t index = start; index <= target.second; index++) {
+    if (_input[index] == '[') {
+      depth++;
+    } else if (_input[index] == ']' && depth > 0) {
+      depth--;
+    } else if (_input[index] == ',' || index == target.second) {
+      if (index == start)
+        throw Parser_error("Missing host at position " + std::to_string(start));
+
+      ranges.push_back({start, index - 1});
+      start = index + 1;
+    }
+  }
+
+  for (auto &range : ranges) {
+    // Every host is parsed as a target of its own
+    _chunks[URI_TARGET] = range;
+    _data->_host.clear();
+    _data->_has_port = false;
+    _data->_port = 0;
+
+    parse_host();
+    _data->_hosts.push_back({_data->_host, _data->_has_port ? _data->_port : 0});
+  }
+
+  _chunks[URI_TARGET] = target;
+
+  _data->_host = _data->_hosts.front().first;
+  _data->_port = _data->_hosts.front().second;
+  _data->_has_port = _data->_port != 0;
+}
+
 bool Uri_parser::parse_ipv4(shcore::BaseTokenizer &tok, size_t &offset) {
   bool ret_val = false;
 
-  if (tok.cur_token_type_is("digits") &&
-      tok.next_token_type(".") &&
-      tok.next_token_type("digits", 2) &&
-      tok.next_token_type(".", 3) &&
-      tok.next_token_type("digits", 4) &&
-      tok.next_token_type(".", 5) &&
-      tok.next_token_type("digits", 6)) {
+  if (tok.cur_token_type_is(Digits) &&
+      tok.next_token_type('.') &&
+      tok.next_token_type(Digits, 2) &&
+      tok.next_token_type('.', 3) &&
+      tok.next_token_type(Digits, 4) &&
+      tok.next_token_type('.', 5) &&
+      tok.next_token_type(Digits, 6)) {
     for (size_t index = 0; index < 4; index++) {
-      std::string octet = tok.consume_token("digits");
-      int value = boost::lexical_cast<int>(octet);
-      if (value < 0 || value >255)
-        throw Parser_error("Octect value out of bounds [" + octet + "], valid range for IPv4 is 0 to 255 at position " + std::to_string(offset));
+      const shcore::BaseToken &octet = tok.consume_token(Digits);
+      if (digits_value(octet, 255) > 255)
+        throw Parser_error("Octect value out of bounds [" + octet.get_text() + "], valid range for IPv4 is 0 to 255 at position " + std::to_string(offset));
       else {
-        _data->_host += octet;
-        offset += octet.length();
+        octet.append_text(_data->_host);
+        offset += octet.get_length();
 
         if (index < 3) {
-          _data->_host += tok.consume_token(".");
+          tok.consume_token('.').append_text(_data->_host);
           offset++;
         }
       }
@@ -254,12 +337,12 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
   _tokenizer.reset();
   _tokenizer.set_allow_spaces(false);
   _tokenizer.set_simple_tokens(":.[]");
-  _tokenizer.set_complex_token("digits", DIGIT);
-  _tokenizer.set_complex_token("hex-digits", HEXDIG);
+  _tokenizer.set_complex_token(Digits, "digits", DIGIT);
+  _tokenizer.set_complex_token(Hex_digits, "hex-digits", HEXDIG);
 
   _tokenizer.process(range);
 
-  _tokenizer.consume_token("[");
+  _tokenizer.consume_token('[');
   offset++;
 
   std::vector<std::string> values;
@@ -270,12 +353,12 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
   bool double_colon_allowed = true;
   bool last_was_colon = false;
   int segment_count = 0;
-  while (!_tokenizer.cur_token_type_is("]")) {
+  while (!_tokenizer.cur_token_type_is(']')) {
     if (_data->_host.empty()) {
       // An IP Address may begin with ::
-      if (_tokenizer.cur_token_type_is(":")) {
-        _data->_host += _tokenizer.consume_token(":");
-        _data->_host += _tokenizer.consume_token(":");
+      if (_tokenizer.cur_token_type_is(':')) {
+        _tokenizer.consume_token(':').append_text(_data->_host);
+        _tokenizer.consume_token(':').append_text(_data->_host);
         offset += 2;
         colon_allowed = false;
         double_colon_allowed = false;
@@ -283,10 +366,10 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
         last_was_colon = true;
       } else {
         std::string value;
-        auto token = _tokenizer.peek_token();
-        while (token.get_type() == "hex-digits" || token.get_type() == "digits") {
-          value += _tokenizer.consume_any_token().get_text();
-          token = _tokenizer.peek_token();
+        const shcore::BaseToken *token = &_tokenizer.peek_token();
+        while (token->get_type() == Hex_digits || token->get_type() == Digits) {
+          _tokenizer.consume_any_token().append_text(value);
+          token = &_tokenizer.peek_token();
         }
 
         if (value.length() > 4)
@@ -309,8 +392,8 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
       }
 
       // Colon is allowed after each hex-digit or after one colon
-      else if (colon_allowed && _tokenizer.cur_token_type_is(":")) {
-        _data->_host += _tokenizer.consume_token(":");
+      else if (colon_allowed && _tokenizer.cur_token_type_is(':')) {
+        _tokenizer.consume_token(':').append_text(_data->_host);
         offset++;
 
         if (last_was_colon)
@@ -325,10 +408,10 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
       } else {
         if (last_was_colon) {
           std::string value;
-          auto token = _tokenizer.peek_token();
-          while (token.get_type() == "hex-digits" || token.get_type() == "digits") {
-            value += _tokenizer.consume_any_token().get_text();
-            token = _tokenizer.peek_token();
+          const shcore::BaseToken *token = &_tokenizer.peek_token();
+          while (token->get_type() == Hex_digits || token->get_type() == Digits) {
+            _tokenizer.consume_any_token().append_text(value);
+            token = &_tokenizer.peek_token();
           }
           if (value.empty())
             throw Parser_error((boost::format("Unexpected data [" + _tokenizer.peek_token().get_text() + "] found at position %1%") % offset).str());
@@ -340,7 +423,7 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
 
           segment_count++;
         } else {
-          _data->_host += _tokenizer.consume_token(":");
+          _tokenizer.consume_token(':').append_text(_data->_host);
           offset++;
         }
 
@@ -356,7 +439,7 @@ void Uri_parser::parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offs
   }
 
   // At this point we should be done wiht the IPv6 Address
-  _tokenizer.consume_token("]");
+  _tokenizer.consume_token(']');
   offset++;
 
   // The shortcut :: was not used
@@ -373,18 +456,18 @@ void Uri_parser::parse_port(const std::pair<size_t, size_t> &range, size_t &offs
   _tokenizer.reset();
   _tokenizer.set_allow_spaces(false);
   _tokenizer.set_simple_tokens(":");
-  _tokenizer.set_complex_token("digits", DIGIT);
+  _tokenizer.set_complex_token(Digits, "digits", DIGIT);
   _tokenizer.process(range);
 
-  _tokenizer.consume_token(":");
+  _tokenizer.consume_token(':');
   offset++;
 
   if (_tokenizer.tokens_available()) {
-    std::string port = _tokenizer.consume_token("digits");
-    offset += port.length();
-    _data->_port = boost::lexical_cast<int>(port);
+    const shcore::BaseToken &port = _tokenizer.consume_token(Digits);
+    offset += port.get_length();
+    _data->_port = digits_value(port, 65535);
 
-    if (_data->_port < 0 || _data->_port > 65535)
+    if (_data->_port > 65535)
       throw Parser_error("Port is out of the valid range: 0 - 65535");
 
     _data->_has_port = true;
@@ -406,23 +489,23 @@ void Uri_parser::parse_host() {
     _tokenizer.reset();
     _tokenizer.set_allow_spaces(false);
     _tokenizer.set_simple_tokens(".:");
-    _tokenizer.set_complex_token("pct-encoded", {"%", HEXDIG, HEXDIG});
-    _tokenizer.set_complex_token("digits", DIGIT);
-    _tokenizer.set_complex_token("hex-digits", HEXDIG);
-    _tokenizer.set_complex_token("sub-delims", SUBDELIMITERS);
-    _tokenizer.set_complex_token("unreserved", UNRESERVED);
+    _tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", HEXDIG, HEXDIG});
+    _tokenizer.set_complex_token(Digits, "digits", DIGIT);
+    _tokenizer.set_complex_token(Hex_digits, "hex-digits", HEXDIG);
+    _tokenizer.set_complex_token(Sub_delims, "sub-delims", SUBDELIMITERS);
+    _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED);
 
     _tokenizer.process(_chunks[URI_TARGET]);
 
     if (!parse_ipv4(_tokenizer, offset)) {
-      while (_tokenizer.tokens_available() && !_tokenizer.cur_token_type_is(":")) {
-        std::string data = _tokenizer.peek_token().get_text();
-        if (_tokenizer.cur_token_type_is("pct-encoded"))
-          _data->_host += percent_decode(data);
+      while (_tokenizer.tokens_available() && !_tokenizer.cur_token_type_is(':')) {
+        const shcore::BaseToken &data = _tokenizer.peek_token();
+        if (_tokenizer.cur_token_type_is(Pct_encoded))
+          _data->_host += percent_decode(data.get_data());
         else
-          _data->_host += data;
+          data.append_text(_data->_host);
 
-        offset += data.length();
+        offset += data.get_length();
 
         _tokenizer.consume_any_token();
       }
@@ -438,17 +521,17 @@ void Uri_parser::parse_path() {
     _tokenizer.reset();
     _tokenizer.set_allow_spaces(false);
     _tokenizer.set_simple_tokens(":@");
-    _tokenizer.set_complex_token("pct-encoded", {"%", HEXDIG, HEXDIG});
-    _tokenizer.set_complex_token("unreserved", UNRESERVED);
-    _tokenizer.set_complex_token("sub-delims", SUBDELIMITERS);
+    _tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", HEXDIG, HEXDIG});
+    _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED);
+    _tokenizer.set_complex_token(Sub_delims, "sub-delims", SUBDELIMITERS);
 
     _tokenizer.process(_chunks[URI_PATH]);
 
     while (_tokenizer.tokens_available()) {
-      if (_tokenizer.cur_token_type_is("pct-encoded"))
-        _data->_db += percent_decode(_tokenizer.peek_token().get_text());
+      if (_tokenizer.cur_token_type_is(Pct_encoded))
+        _data->_db += percent_decode(_tokenizer.peek_token().get_data());
       else
-        _data->_db += _tokenizer.peek_token().get_text();
+        _tokenizer.peek_token().append_text(_data->_db);
 
       _tokenizer.consume_any_token();
     }
@@ -464,14 +547,14 @@ void Uri_parser::parse_query() {
 void Uri_parser::parse_attribute(const std::pair<size_t, size_t>& range, size_t &offset) {
   _tokenizer.reset();
   _tokenizer.set_allow_spaces(false);
-  _tokenizer.set_complex_token("pct-encoded", {"%", HEXDIG, HEXDIG});
-  _tokenizer.set_complex_token("unreserved", UNRESERVED);
+  _tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", HEXDIG, HEXDIG});
+  _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED);
   // NOTE: The URI grammar specifies that sub-delims should be included on the key production rule
   //       However sub-delims include the = and & chars which are used to join several key/value pairs
   //       and to associate a key's value, so we have excluded them.
-  //tok.set_complex_token("sub-delims", SUBDELIMITERS);
-  _tokenizer.set_complex_token("sub-delims", std::string("!$'()*+,;"));
-  _tokenizer.set_final_token_group("pause", "=&");
+  //tok.set_complex_token(Sub_delims, "sub-delims", SUBDELIMITERS);
+  _tokenizer.set_complex_token(Sub_delims, "sub-delims", std::string("!$'()*+,;"));
+  _tokenizer.set_final_token_group(Pause, "pause", "=&");
 
   // We will skip the first char which is always a delimiter
   offset++;
@@ -482,15 +565,15 @@ void Uri_parser::parse_attribute(const std::pair<size_t, size_t>& range, size_t
   std::string attribute;
   bool has_value = false;
   while (_tokenizer.tokens_available()) {
-    if (_tokenizer.cur_token_type_is("pause")) {
-      if (_tokenizer.peek_token().get_text()[0] == '=')
+    if (_tokenizer.cur_token_type_is(Pause)) {
+      if (_tokenizer.peek_token().get_data()[0] == '=')
         has_value = true;
 
       break;
-    } else if (_tokenizer.cur_token_type_is("pct-encoded"))
-      attribute += percent_decode(_tokenizer.peek_token().get_text());
+    } else if (_tokenizer.cur_token_type_is(Pct_encoded))
+      attribute += percent_decode(_tokenizer.peek_token().get_data());
     else
-      attribute += _tokenizer.peek_token().get_text();
+      _tokenizer.peek_token().append_text(attribute);
 
     _tokenizer.consume_any_token();
   }
@@ -541,7 +624,7 @@ std::string Uri_parser::parse_value(const std::pair<size_t, size_t>& range, size
   return ret_val;
 }
 
-char Uri_parser::percent_decode(const std::string& value) {
+char Uri_parser::percent_decode(const char *value) {
   int ret_val = 0;
 
   ret_val += hex_literals[value[1]] * 16;
@@ -556,16 +639,16 @@ std::string Uri_parser::get_input_chunk(const std::pair<size_t, size_t>& range)
 
 std::string Uri_parser::parse_unencoded_value(const std::pair<size_t, size_t>& range, size_t &offset, const std::string& finalizers) {
   _tokenizer.reset();
-  _tokenizer.set_complex_token("pct-encoded", {"%", HEXDIG, HEXDIG});
+  _tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", HEXDIG, HEXDIG});
 #ifdef _WIN32
-  _tokenizer.set_complex_token("unreserved", UNRESERVED + "\\:");
+  _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED + "\\:");
 #else
-  _tokenizer.set_complex_token("unreserved", UNRESERVED + "/");
+  _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED + "/");
 #endif
-  _tokenizer.set_complex_token("delims", DELIMITERS);
+  _tokenizer.set_complex_token(Delims, "delims", DELIMITERS);
 
   if (!finalizers.empty())
-    _tokenizer.set_final_token_group("end", finalizers);
+    _tokenizer.set_final_token_group(End, "end", finalizers);
 
   _tokenizer.process(range);
 
@@ -574,18 +657,18 @@ std::string Uri_parser::parse_unencoded_value(const std::pair<size_t, size_t>& r
   // Reserves enough space for the value
   auto last_token = _tokenizer.peek_last_token();
   if (last_token)
-    value.reserve((last_token->get_pos() + last_token->get_text().size()) - range.first);
+    value.reserve((last_token->get_pos() + last_token->get_length()) - range.first);
 
   // TODO: Add encoding logic for each appended token
   //       Yes it is unencoded value, but we support encoded stuff as well
   while (_tokenizer.tokens_available()) {
-    auto token = _tokenizer.consume_any_token();
-    if (token.get_type() == "pct-encoded")
-      value += percent_decode(token.get_text());
+    const shcore::BaseToken &token = _tokenizer.consume_any_token();
+    if (token.get_type() == Pct_encoded)
+      value += percent_decode(token.get_data());
     else
-      value += token.get_text();
+      token.append_text(value);
 
-    offset += token.get_text().length();
+    offset += token.get_length();
   }
 
   return value;
@@ -593,12 +676,12 @@ std::string Uri_parser::parse_unencoded_value(const std::pair<size_t, size_t>& r
 
 std::string Uri_parser::parse_encoded_value(const std::pair<size_t, size_t>& range, size_t &offset, const std::string& finalizers) {
   _tokenizer.reset();
-  _tokenizer.set_complex_token("pct-encoded", {"%", HEXDIG, HEXDIG});
-  _tokenizer.set_complex_token("unreserved", UNRESERVED);
-  _tokenizer.set_complex_token("delims", std::string("!$'()*+;="));
+  _tokenizer.set_complex_token(Pct_encoded, "pct-encoded", {"%", HEXDIG, HEXDIG});
+  _tokenizer.set_complex_token(Unreserved, "unreserved", UNRESERVED);
+  _tokenizer.set_complex_token(Delims, "delims", std::string("!$'()*+;="));
 
   if (!finalizers.empty())
-    _tokenizer.set_final_token_group("end", finalizers);
+    _tokenizer.set_final_token_group(End, "end", finalizers);
 
   _tokenizer.process(range);
 
@@ -611,14 +694,14 @@ std::string Uri_parser::parse_encoded_value(const std::pair<size_t, size_t>& ran
 
   // TODO: Add encoding logic for each appended token
   //       Yes it is unencoded value, but we support encoded stuff as well
-  while (_tokenizer.tokens_available() && !_tokenizer.cur_token_type_is("end")) {
-    auto token = _tokenizer.consume_any_token();
-    if (token.get_type() == "pct-encoded")
-      value += percent_decode(token.get_text());
+  while (_tokenizer.tokens_available() && !_tokenizer.cur_token_type_is(End)) {
+    const shcore::BaseToken &token = _tokenizer.consume_any_token();
+    if (token.get_type() == Pct_encoded)
+      value += percent_decode(token.get_data());
     else
-      value += token.get_text();
+      token.append_text(value);
 
-    offset += token.get_text().length();
+    offset += token.get_length();
   }
 
   return value;
@@ -75,6 +75,11 @@ public:
 
   std::string get_db() { return _db; }
 
+  // The hosts of a multi-host target: [host1:port1,host2,...], with port 0
+  // on those with no port. The first one is also the one of get_host()
+  bool has_host_list() { return _hosts.size() > 1; }
+  const std::vector<std::pair<std::string, int> > &get_hosts() { return _hosts; }
+
   bool has_password() { return _has_password; }
 
   bool has_attribute(const std::string& name) { return _attributes.find(name) != _attributes.end(); }
@@ -94,6 +99,7 @@ private:
   int _port;
   int _ssl_mode;
   std::string _db;
+  std::vector<std::pair<std::string, int> > _hosts;
 
   std::map<std::string, std::vector< std::string > > _attributes;
 
@@ -115,6 +121,8 @@ private:
   void parse_userinfo();
   void parse_target();
   void parse_host();
+  bool is_host_list(size_t start, size_t end);
+  void parse_host_list();
   bool parse_ipv4(BaseTokenizer &tok, size_t &offset);
   void parse_ipv6(const std::pair<size_t, size_t> &range, size_t &offset);
   void parse_port(const std::pair<size_t, size_t> &range, size_t &offset);
@@ -128,7 +136,7 @@ private:
   std::string parse_unencoded_value(const std::pair<size_t, size_t>& range, size_t &offset, const std::string& finalizers = "");
   std::string parse_encoded_value(const std::pair<size_t, size_t>& range, size_t &offset, const std::string& finalizers = "");
 
-  char percent_decode(const std::string& value);
+  char percent_decode(const char *value);
   std::string get_input_chunk(const std::pair<size_t, size_t>& range);
 
   bool input_contains(const std::string& what, size_t position = std::string::npos);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace shcore {
+namespace {
+thread_local Arena *current_arena = nullptr;
+}
+
+Arena::Arena(size_t chunk_size)
+  : _refs(1), _chunk_size(chunk_size), _size(0), _next(nullptr), _end(nullptr) {
+}
+
+Arena::~Arena() {
+  for (auto chunk : _chunks)
+    delete[] chunk;
+}
+
+Arena *Arena::create(size_t chunk_size) {
+  return new Arena(chunk_size);
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+  uintptr_t next = (reinterpret_cast<uintptr_t>(_next) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  if (!_next || next + size > reinterpret_cast<uintptr_t>(_end)) {
+    // Objects larger than a chunk get one of their own
+    size_t chunk_size = std::max(_chunk_size, size + alignment);
+    char *chunk = new char[chunk_size];
+    _chunks.push_back(chunk);
+    _size += chunk_size;
+    _end = chunk + chunk_size;
+    next = (reinterpret_cast<uintptr_t>(chunk) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  }
+
+  _next = reinterpret_cast<char *>(next + size);
+  _refs.fetch_add(1, std::memory_order_relaxed);
+  return reinterpret_cast<void *>(next);
+}
+
+void Arena::unref() {
+  if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    delete this;
+}
+
+Arena *Arena::current() {
+  return current_arena;
+}
+
+Arena_scope::Arena_scope(size_t chunk_size)
+  : _arena(Arena::create(chunk_size)), _previous(current_arena) {
+  current_arena = _arena;
+}
+
+Arena_scope::~Arena_scope() {
+  current_arena = _previous;
+  _arena->release();
+}
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_ARENA_H_
+#define _UTILS_ARENA_H_
+
+#include "shellcore/common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace shcore {
+// Memory for many small objects sharing a lifetime, like the values of a
+// result or a parsed document. Allocating bumps a pointer in the current
+// chunk and freeing only drops a reference: all the chunks go back to the
+// heap in one operation once the owner of the arena and everything
+// allocated from it are gone. Allocating is meant for a single thread at a
+// time, freeing may happen on any thread.
+class SHCORE_PUBLIC Arena {
+public:
+  static const size_t k_default_chunk_size = 64 * 1024;
+
+  // The arena starts with the reference of its owner, given up by release()
+  static Arena *create(size_t chunk_size = k_default_chunk_size);
+
+  void *allocate(size_t size, size_t alignment);
+  void deallocate(void *) { unref(); }
+  void release() { unref(); }
+
+  // Bytes taken from the heap by the chunks
+  size_t size() const { return _size; }
+
+  // The arena of the innermost Arena_scope of the thread, NULL if none
+  static Arena *current();
+
+private:
+  friend class Arena_scope;
+
+  explicit Arena(size_t chunk_size);
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator = (const Arena &) = delete;
+
+  void unref();
+
+  std::atomic<size_t> _refs;
+  size_t _chunk_size;
+  size_t _size;
+  std::vector<char *> _chunks;
+  char *_next;
+  char *_end;
+};
+
+// Makes a new arena the current one of the thread while in scope, so the
+// values created meanwhile come from it. They keep the arena alive past
+// the end of the scope.
+class SHCORE_PUBLIC Arena_scope {
+public:
+  explicit Arena_scope(size_t chunk_size = Arena::k_default_chunk_size);
+  ~Arena_scope();
+
+  Arena *arena() const { return _arena; }
+
+private:
+  Arena_scope(const Arena_scope &) = delete;
+  Arena_scope &operator = (const Arena_scope &) = delete;
+
+  Arena *_arena;
+  Arena *_previous;
+};
+
+// Standard allocator taking the memory from an arena, for allocate_shared
+template <class T>
+struct Arena_allocator {
+  typedef T value_type;
+
+  explicit Arena_allocator(Arena *a) : arena(a) {}
+  template <class U>
+  Arena_allocator(const Arena_allocator<U> &other) : arena(other.arena) {}
+
+  T *allocate(size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T *p, size_t) { arena->deallocate(p); }
+
+  template <class U>
+  bool operator == (const Arena_allocator<U> &other) const { return arena == other.arena; }
+  template <class U>
+  bool operator != (const Arena_allocator<U> &other) const { return arena != other.arena; }
+
+  Arena *arena;
+};
+}
+
+#endif
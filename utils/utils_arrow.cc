@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_arrow.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace shcore {
+namespace {
+// The metadata of the messages is a flatbuffer, of the tables defined by
+// Message.fbs and Schema.fbs in the Arrow sources. The few that are needed
+// are put together here rather than depending on the flatbuffers library.
+// Values are written in the byte order of the host, which is declared as
+// little endian on the schema.
+const int16_t kMetadataV5 = 4;
+
+enum Message_header : uint8_t {
+  Header_schema = 1,
+  Header_record_batch = 3
+};
+
+enum Type_id : uint8_t {
+  Type_int = 2,
+  Type_floating_point = 3,
+  Type_large_binary = 19,
+  Type_large_utf8 = 20
+};
+
+const int16_t kPrecisionDouble = 2;
+
+struct Fb_object;
+typedef std::shared_ptr<Fb_object> Fb_ref;
+
+// A table, a string, or a vector of tables or structs
+struct Fb_object {
+  enum Kind { Table, String, Table_vector, Struct_vector };
+
+  // A field of a table, absent when it has neither size nor child
+  struct Slot {
+    Slot() : size(0), value(0) {}
+
+    size_t size;
+    uint64_t value;
+    Fb_ref child;
+  };
+
+  explicit Fb_object(Kind kind) : kind(kind), count(0) {}
+
+  Fb_object &scalar(size_t id, size_t size, uint64_t value) {
+    slot(id).size = size;
+    slot(id).value = value;
+    return *this;
+  }
+
+  Fb_object &child(size_t id, const Fb_ref &object) {
+    slot(id).child = object;
+    return *this;
+  }
+
+  Slot &slot(size_t id) {
+    if (slots.size() <= id)
+      slots.resize(id + 1);
+    return slots[id];
+  }
+
+  Kind kind;
+  std::vector<Slot> slots;
+  // String: the text. Struct_vector: the elements, count of them
+  std::string bytes;
+  size_t count;
+  std::vector<Fb_ref> items;
+};
+
+Fb_ref fb_table() {
+  return std::make_shared<Fb_object>(Fb_object::Table);
+}
+
+Fb_ref fb_string(const std::string &text) {
+  auto object = std::make_shared<Fb_object>(Fb_object::String);
+  object->bytes = text;
+  return object;
+}
+
+Fb_ref fb_tables(const std::vector<Fb_ref> &items) {
+  auto object = std::make_shared<Fb_object>(Fb_object::Table_vector);
+  object->items = items;
+  return object;
+}
+
+// Structs of two int64, the FieldNode and Buffer structs of RecordBatch
+Fb_ref fb_pairs(const std::vector<std::pair<int64_t, int64_t>> &pairs) {
+  auto object = std::make_shared<Fb_object>(Fb_object::Struct_vector);
+  object->count = pairs.size();
+  for (auto &pair : pairs) {
+    object->bytes.append(reinterpret_cast<const char*>(&pair.first), 8);
+    object->bytes.append(reinterpret_cast<const char*>(&pair.second), 8);
+  }
+  return object;
+}
+
+// Objects are written parent first, so every offset points forward as
+// flatbuffers require, each vtable right before its table. Every value is
+// aligned to its size from the start of the buffer.
+class Fb_writer {
+public:
+  std::string finish(const Fb_object &root) {
+    _buffer.assign(4, '\0');
+    link(0, write(root));
+    return _buffer;
+  }
+
+private:
+  void pad(size_t align) {
+    while (_buffer.size() % align)
+      _buffer.push_back('\0');
+  }
+
+  void put(size_t position, const void *value, size_t size) {
+    memcpy(&_buffer[position], value, size);
+  }
+
+  template <typename T>
+  void append(T value) {
+    _buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void link(size_t position, size_t target) {
+    uint32_t offset = static_cast<uint32_t>(target - position);
+    put(position, &offset, 4);
+  }
+
+  size_t write(const Fb_object &object) {
+    switch (object.kind) {
+      case Fb_object::Table:
+        return write_table(object);
+
+      case Fb_object::String: {
+        pad(4);
+        size_t position = _buffer.size();
+        append(static_cast<uint32_t>(object.bytes.size()));
+        _buffer.append(object.bytes);
+        _buffer.push_back('\0');
+        return position;
+      }
+
+      case Fb_object::Table_vector: {
+        pad(4);
+        size_t position = _buffer.size();
+        append(static_cast<uint32_t>(object.items.size()));
+        _buffer.append(object.items.size() * 4, '\0');
+        for (size_t index = 0; index < object.items.size(); index++) {
+          size_t item = position + 4 + index * 4;
+          link(item, write(*object.items[index]));
+        }
+        return position;
+      }
+
+      case Fb_object::Struct_vector: {
+        // The elements are 8 bytes aligned, after the length
+        while ((_buffer.size() + 4) % 8)
+          _buffer.push_back('\0');
+        size_t position = _buffer.size();
+        append(static_cast<uint32_t>(object.count));
+        _buffer.append(object.bytes);
+        return position;
+      }
+    }
+
+    return 0;
+  }
+
+  size_t write_table(const Fb_object &table) {
+    pad(2);
+    size_t vtable = _buffer.size();
+    _buffer.append(4 + 2 * table.slots.size(), '\0');
+
+    pad(4);
+    size_t start = _buffer.size();
+    append(static_cast<int32_t>(start - vtable));
+
+    std::vector<std::pair<size_t, const Fb_object*>> children;
+    for (size_t id = 0; id < table.slots.size(); id++) {
+      const Fb_object::Slot &slot = table.slots[id];
+      size_t size = slot.child ? 4 : slot.size;
+      if (!size)
+        continue;
+
+      pad(size);
+      uint16_t field_offset = static_cast<uint16_t>(_buffer.size() - start);
+      put(vtable + 4 + 2 * id, &field_offset, 2);
+
+      if (slot.child) {
+        children.emplace_back(_buffer.size(), slot.child.get());
+        _buffer.append(4, '\0');
+      } else {
+        // The low bytes of the value, the host is little endian
+        _buffer.append(reinterpret_cast<const char*>(&slot.value), size);
+      }
+    }
+
+    uint16_t vtable_size = static_cast<uint16_t>(4 + 2 * table.slots.size());
+    uint16_t table_size = static_cast<uint16_t>(_buffer.size() - start);
+    put(vtable, &vtable_size, 2);
+    put(vtable + 2, &table_size, 2);
+
+    for (auto &child : children)
+      link(child.first, write(*child.second));
+
+    return start;
+  }
+
+  std::string _buffer;
+};
+
+Fb_ref message(Message_header type, const Fb_ref &header, int64_t body_length) {
+  auto table = fb_table();
+  table->scalar(0, 2, kMetadataV5)
+    .scalar(1, 1, type)
+    .child(2, header)
+    .scalar(3, 8, static_cast<uint64_t>(body_length));
+  return table;
+}
+
+Fb_ref field(const Arrow_stream_writer::Field &field) {
+  auto type = fb_table();
+  Type_id type_id;
+  switch (field.type) {
+    case Arrow_stream_writer::Type::Int64:
+    case Arrow_stream_writer::Type::UInt64:
+      type_id = Type_int;
+      type->scalar(0, 4, 64).scalar(1, 1, field.type == Arrow_stream_writer::Type::Int64 ? 1 : 0);
+      break;
+    case Arrow_stream_writer::Type::Double:
+      type_id = Type_floating_point;
+      type->scalar(0, 2, kPrecisionDouble);
+      break;
+    case Arrow_stream_writer::Type::Binary:
+      type_id = Type_large_binary;
+      break;
+    case Arrow_stream_writer::Type::Utf8:
+    default:
+      type_id = Type_large_utf8;
+      break;
+  }
+
+  // Readers require the children, even if empty
+  auto table = fb_table();
+  table->child(0, fb_string(field.name))
+    .scalar(1, 1, 1)
+    .scalar(2, 1, type_id)
+    .child(3, type)
+    .child(5, fb_tables({}));
+  return table;
+}
+
+bool is_variable(Arrow_stream_writer::Type type) {
+  return type == Arrow_stream_writer::Type::Utf8 || type == Arrow_stream_writer::Type::Binary;
+}
+
+size_t padded(size_t size) {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+const char kPadding[8] = { 0 };
+}
+
+Arrow_stream_writer::Arrow_stream_writer(const std::vector<Field> &fields, const Output &output)
+  : _fields(fields), _output(output) {
+  std::vector<Fb_ref> schema_fields;
+  for (auto &field_ : _fields)
+    schema_fields.push_back(field(field_));
+
+  auto schema = fb_table();
+  schema->scalar(0, 2, 0).child(1, fb_tables(schema_fields));
+
+  write_message(Fb_writer().finish(*message(Header_schema, schema, 0)));
+}
+
+void Arrow_stream_writer::write_batch(size_t length, const std::vector<Column> &columns) {
+  if (!length)
+    return;
+
+  if (columns.size() != _fields.size())
+    throw std::logic_error("Arrow record batch with a wrong number of columns");
+
+  // The buffers of every column go one after the other on the body,
+  // validity, values and data, each padded to 8 bytes
+  std::vector<std::pair<int64_t, int64_t>> nodes;
+  std::vector<std::pair<int64_t, int64_t>> buffers;
+  int64_t body_length = 0;
+
+  auto add_buffer = [&buffers, &body_length](size_t size) {
+    buffers.emplace_back(body_length, static_cast<int64_t>(size));
+    body_length += padded(size);
+  };
+
+  for (size_t index = 0; index < columns.size(); index++) {
+    const Column &column = columns[index];
+    nodes.emplace_back(static_cast<int64_t>(length), static_cast<int64_t>(column.null_count));
+
+    add_buffer(column.null_count ? (length + 7) / 8 : 0);
+    add_buffer(column.values_size);
+    if (is_variable(_fields[index].type))
+      add_buffer(column.data_size);
+  }
+
+  auto batch = fb_table();
+  batch->scalar(0, 8, static_cast<uint64_t>(length))
+    .child(1, fb_pairs(nodes))
+    .child(2, fb_pairs(buffers));
+
+  write_message(Fb_writer().finish(*message(Header_record_batch, batch, body_length)));
+
+  for (size_t index = 0; index < columns.size(); index++) {
+    const Column &column = columns[index];
+    write_padded(column.validity, column.null_count ? (length + 7) / 8 : 0);
+    write_padded(column.values, column.values_size);
+    if (is_variable(_fields[index].type))
+      write_padded(column.data, column.data_size);
+  }
+}
+
+void Arrow_stream_writer::finish() {
+  const uint32_t end_of_stream[2] = { 0xFFFFFFFF, 0 };
+  _output(reinterpret_cast<const char*>(end_of_stream), sizeof(end_of_stream));
+}
+
+void Arrow_stream_writer::write_message(const std::string &metadata) {
+  // The continuation marker and the length of the metadata, which is padded
+  // so the body that follows starts 8 bytes aligned
+  uint32_t prefix[2] = { 0xFFFFFFFF, static_cast<uint32_t>(padded(metadata.size())) };
+  _output(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+  write_padded(metadata.data(), metadata.size());
+}
+
+void Arrow_stream_writer::write_padded(const void *data, size_t size) {
+  if (!size)
+    return;
+
+  _output(static_cast<const char*>(data), size);
+  if (padded(size) != size)
+    _output(kPadding, padded(size) - size);
+}
+
+size_t Arrow_stream_writer::validity_from_nulls(const uint8_t *nulls, size_t count, std::string *bitmap) {
+  bitmap->assign((count + 7) / 8, '\0');
+
+  size_t null_count = 0;
+  for (size_t row = 0; row < count; row++) {
+    if (nulls[row])
+      null_count++;
+    else
+      (*bitmap)[row / 8] |= static_cast<char>(1 << (row % 8));
+  }
+
+  return null_count;
+}
+
+Arrow_batch_builder::Arrow_batch_builder(const std::vector<Arrow_stream_writer::Field> &fields)
+  : _columns(fields.size()), _rows(0), _data_size(0) {
+  for (size_t index = 0; index < fields.size(); index++) {
+    _columns[index].variable = is_variable(fields[index].type);
+    _columns[index].offsets.push_back(0);
+  }
+}
+
+void Arrow_batch_builder::append_null(size_t column) {
+  Column_data &data = _columns[column];
+  data.nulls.push_back(1);
+
+  // The slot of the value is kept, as an empty or zero value
+  if (data.variable)
+    data.offsets.push_back(data.offsets.back());
+  else
+    data.values.append(sizeof(int64_t), '\0');
+}
+
+void Arrow_batch_builder::append(size_t column, int64_t value) {
+  _columns[column].nulls.push_back(0);
+  _columns[column].values.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  _data_size += sizeof(value);
+}
+
+void Arrow_batch_builder::append(size_t column, uint64_t value) {
+  _columns[column].nulls.push_back(0);
+  _columns[column].values.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  _data_size += sizeof(value);
+}
+
+void Arrow_batch_builder::append(size_t column, double value) {
+  _columns[column].nulls.push_back(0);
+  _columns[column].values.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  _data_size += sizeof(value);
+}
+
+void Arrow_batch_builder::append(size_t column, const char *data, size_t size) {
+  Column_data &column_data = _columns[column];
+  column_data.nulls.push_back(0);
+  column_data.data.append(data, size);
+  column_data.offsets.push_back(static_cast<int64_t>(column_data.data.size()));
+  _data_size += size + sizeof(int64_t);
+}
+
+void Arrow_batch_builder::flush(Arrow_stream_writer *writer) {
+  std::vector<std::string> bitmaps(_columns.size());
+  std::vector<Arrow_stream_writer::Column> columns(_columns.size());
+
+  for (size_t index = 0; index < _columns.size(); index++) {
+    Column_data &data = _columns[index];
+    Arrow_stream_writer::Column &column = columns[index];
+
+    column.null_count = Arrow_stream_writer::validity_from_nulls(data.nulls.data(), _rows, &bitmaps[index]);
+    column.validity = bitmaps[index].data();
+
+    if (data.variable) {
+      column.values = data.offsets.data();
+      column.values_size = data.offsets.size() * sizeof(int64_t);
+      column.data = data.data.data();
+      column.data_size = data.data.size();
+    } else {
+      column.values = data.values.data();
+      column.values_size = data.values.size();
+    }
+  }
+
+  writer->write_batch(_rows, columns);
+
+  for (auto &data : _columns) {
+    data.nulls.clear();
+    data.values.clear();
+    data.offsets.resize(1);
+    data.data.clear();
+  }
+  _rows = 0;
+  _data_size = 0;
+}
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_ARROW_H_
+#define _UTILS_ARROW_H_
+
+#include "shellcore/common.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace shcore {
+// Writes data in the Apache Arrow IPC stream format: the schema, a record
+// batch message for every batch and the end of stream marker. The buffers
+// of the columns are handed to the output as they are, without copying
+// them. Only the types the results are converted to are supported, strings
+// use 64 bit offsets (LargeUtf8 and LargeBinary).
+class SHCORE_PUBLIC Arrow_stream_writer {
+public:
+  enum class Type { Int64, UInt64, Double, Utf8, Binary };
+
+  struct Field {
+    Field(const std::string &name, Type type) : name(name), type(type) {}
+
+    std::string name;
+    Type type;
+  };
+
+  // The buffers of a column of a batch. values holds the fixed width values,
+  // or for Utf8 and Binary the int64 offsets of every row into data, one
+  // more than rows and starting at 0. validity is a bitmap with a bit set
+  // for every row that is not null, NULL if there are no nulls.
+  struct Column {
+    Column() : validity(NULL), null_count(0), values(NULL), values_size(0), data(NULL), data_size(0) {}
+
+    const void *validity;
+    size_t null_count;
+    const void *values;
+    size_t values_size;
+    const char *data;
+    size_t data_size;
+  };
+
+  typedef std::function<void(const char *data, size_t size)> Output;
+
+  // Writes the schema message
+  Arrow_stream_writer(const std::vector<Field> &fields, const Output &output);
+
+  const std::vector<Field> &fields() const { return _fields; }
+
+  // Empty batches are not written
+  void write_batch(size_t length, const std::vector<Column> &columns);
+
+  // Writes the end of stream marker
+  void finish();
+
+  // The validity bitmap of the rows from one byte per row, non zero for the
+  // nulls, as the result batches keep them. Returns the number of nulls.
+  static size_t validity_from_nulls(const uint8_t *nulls, size_t count, std::string *bitmap);
+
+private:
+  void write_message(const std::string &metadata);
+  void write_padded(const void *data, size_t size);
+
+  std::vector<Field> _fields;
+  Output _output;
+};
+
+// Collects the values of a record batch one row at a time, for the results
+// that are not already read by column
+class SHCORE_PUBLIC Arrow_batch_builder {
+public:
+  explicit Arrow_batch_builder(const std::vector<Arrow_stream_writer::Field> &fields);
+
+  void append_null(size_t column);
+  void append(size_t column, int64_t value);
+  void append(size_t column, uint64_t value);
+  void append(size_t column, double value);
+  void append(size_t column, const char *data, size_t size);
+
+  // Every column must have a value for the row
+  void end_row() { _rows++; }
+
+  size_t rows() const { return _rows; }
+  size_t data_size() const { return _data_size; }
+
+  // Writes the collected rows as a batch and clears them
+  void flush(Arrow_stream_writer *writer);
+
+private:
+  struct Column_data {
+    bool variable;
+    std::vector<uint8_t> nulls;
+    std::string values;
+    std::vector<int64_t> offsets;
+    std::string data;
+  };
+
+  std::vector<Column_data> _columns;
+  size_t _rows;
+  size_t _data_size;
+};
+}
+
+#endif
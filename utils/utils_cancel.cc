@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_cancel.h"
+#include "shellcore/types.h"
+
+#include <algorithm>
+
+namespace shcore {
+namespace {
+// Read by cancel_all() from signal handlers, so a plain atomic pointer
+std::atomic<Cancellation_token *> current_token(nullptr);
+}
+
+Cancellation_token::Cancellation_token(Cancellation_token *parent, std::chrono::milliseconds timeout,
+                                       std::chrono::milliseconds step_timeout)
+    : _parent(parent), _cancelled(false), _deadline(Clock::time_point::max()), _step_timeout(step_timeout) {
+  if (timeout.count() > 0)
+    _deadline = Clock::now() + timeout;
+
+  if (_parent) {
+    _deadline = std::min(_deadline, _parent->_deadline);
+    if (_step_timeout.count() == 0)
+      _step_timeout = _parent->_step_timeout;
+  }
+}
+
+bool Cancellation_token::cancelled() const {
+  for (const Cancellation_token *token = this; token; token = token->_parent) {
+    if (token->_cancelled)
+      return true;
+  }
+
+  return _deadline != Clock::time_point::max() && Clock::now() >= _deadline;
+}
+
+void Cancellation_token::check(const std::string &step, Clock::time_point step_deadline) const {
+  for (const Cancellation_token *token = this; token; token = token->_parent) {
+    if (token->_cancelled)
+      throw Exception::runtime_error("The operation was cancelled while " + step);
+  }
+
+  auto now = Clock::now();
+  if (now >= _deadline)
+    throw Exception::runtime_error("The operation timed out while " + step);
+
+  if (now >= step_deadline)
+    throw Exception::runtime_error("Timed out while " + step);
+}
+
+Cancellation_token::Clock::time_point Cancellation_token::step_deadline() const {
+  if (_step_timeout.count() == 0)
+    return _deadline;
+
+  return std::min(_deadline, Clock::now() + _step_timeout);
+}
+
+Cancellation_token *Cancellation_token::current() {
+  return current_token.load();
+}
+
+void Cancellation_token::cancel_all() {
+  for (Cancellation_token *token = current_token.load(); token; token = token->_parent)
+    token->cancel();
+}
+
+Cancellation_scope::Cancellation_scope(std::chrono::milliseconds timeout, std::chrono::milliseconds step_timeout)
+    : _token(current_token.load(), timeout, step_timeout) {
+  current_token.store(&_token);
+}
+
+Cancellation_scope::~Cancellation_scope() {
+  current_token.store(_token._parent);
+}
+}
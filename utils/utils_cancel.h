@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_CANCEL_H_
+#define _UTILS_CANCEL_H_
+
+#include "shellcore/common.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace shcore {
+// Cooperative cancellation of a long operation, like the AdminAPI ones.
+// Nothing is interrupted from the outside: the operation checks its token
+// between steps, and bounds the steps that may block (a query, a child
+// process) by the step timeout. A token nested in another is cancelled with
+// it and never outlives its deadline.
+class SHCORE_PUBLIC Cancellation_token {
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Zero timeouts mean no limit, the step timeout is otherwise the one of
+  // the parent
+  Cancellation_token(Cancellation_token *parent, std::chrono::milliseconds timeout,
+                     std::chrono::milliseconds step_timeout);
+
+  // Only sets a flag, so it can be called from a signal handler
+  void cancel() { _cancelled = true; }
+
+  // Whether the token or a parent was cancelled or the deadline passed
+  bool cancelled() const;
+
+  // Throws if cancelled(), or if the step deadline passed, naming the step
+  void check(const std::string &step, Clock::time_point step_deadline = Clock::time_point::max()) const;
+
+  Clock::time_point deadline() const { return _deadline; }
+  std::chrono::milliseconds step_timeout() const { return _step_timeout; }
+  // The deadline of a step starting now
+  Clock::time_point step_deadline() const;
+
+  // The token of the innermost operation running, null if none
+  static Cancellation_token *current();
+
+  // Cancels the operations running, i.e. on Ctrl-C
+  static void cancel_all();
+
+private:
+  Cancellation_token(const Cancellation_token &) = delete;
+  Cancellation_token &operator = (const Cancellation_token &) = delete;
+
+  friend class Cancellation_scope;
+
+  Cancellation_token *_parent;
+  std::atomic<bool> _cancelled;
+  Clock::time_point _deadline;
+  std::chrono::milliseconds _step_timeout;
+};
+
+// Makes a new token the current one while an operation runs. Scopes are
+// opened by the thread running the scripts, the threads an operation starts
+// use its token through current() and must end with it.
+class SHCORE_PUBLIC Cancellation_scope {
+public:
+  Cancellation_scope(std::chrono::milliseconds timeout, std::chrono::milliseconds step_timeout);
+  ~Cancellation_scope();
+
+  Cancellation_token &token() { return _token; }
+
+private:
+  Cancellation_scope(const Cancellation_scope &) = delete;
+  Cancellation_scope &operator = (const Cancellation_scope &) = delete;
+
+  Cancellation_token _token;
+};
+}
+
+#endif
@@ -122,6 +122,14 @@ const std::string kSslCiphers = "sslCiphers";
 const std::string kSslTlsVersion = "sslTlsVersion";
 const std::string kSslMode = "sslMode";
 const std::string kAuthMethod = "authMethod";
+const std::string kBufferPageSize = "bufferPageSize";
+const std::string kBufferMemoryLimit = "bufferMemoryLimit";
+const std::string kCancelAbandonedRows = "cancelAbandonedRows";
+const std::string kCancelAbandonedBytes = "cancelAbandonedBytes";
+const std::string kPrefetchRows = "prefetchRows";
+const std::string kCompression = "compression";
+const std::string kCompressionLevel = "compressionLevel";
+const std::string kTimeout = "timeout";
 
 
 
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_csv.h"
+#include "shellcore/types.h"
+
+#include <cstring>
+
+namespace shcore {
+namespace {
+// The character as a SQL string literal
+std::string quote_char(char c) {
+  switch (c) {
+    case '\0':
+      return "''";
+    case '\t':
+      return "'\\t'";
+    case '\n':
+      return "'\\n'";
+    case '\r':
+      return "'\\r'";
+    case '\\':
+      return "'\\\\'";
+    case '\'':
+      return "'\\''";
+    default:
+      return std::string("'") + c + "'";
+  }
+}
+
+// The character an escape sequence stands for, as LOAD DATA reads it
+char unescape(char c) {
+  switch (c) {
+    case '0':
+      return '\0';
+    case 'b':
+      return '\b';
+    case 'n':
+      return '\n';
+    case 'r':
+      return '\r';
+    case 't':
+      return '\t';
+    case 'Z':
+      return '\x1a';
+    default:
+      return c;
+  }
+}
+}
+
+Text_dialect Text_dialect::csv() {
+  Text_dialect dialect = { ',', '"', '\0', '\n' };
+  return dialect;
+}
+
+Text_dialect Text_dialect::tsv() {
+  Text_dialect dialect = { '\t', '\0', '\\', '\n' };
+  return dialect;
+}
+
+Text_dialect Text_dialect::from_name(const std::string &name) {
+  if (name == "csv")
+    return csv();
+  else if (name == "tsv")
+    return tsv();
+
+  throw Exception::argument_error("Unknown dialect '" + name + "', the supported ones are csv and tsv");
+}
+
+std::string Text_dialect::load_data_clauses() const {
+  std::string clauses = "FIELDS TERMINATED BY " + quote_char(fields_terminated_by);
+
+  if (fields_enclosed_by)
+    clauses += " OPTIONALLY ENCLOSED BY " + quote_char(fields_enclosed_by);
+
+  clauses += " ESCAPED BY " + quote_char(fields_escaped_by);
+  clauses += " LINES TERMINATED BY " + quote_char(lines_terminated_by);
+
+  return clauses;
+}
+
+size_t find_record_end(const char *data, size_t size, size_t offset, const Text_dialect &dialect) {
+  // Without enclosing or escaping the next line terminator ends the record
+  if (!dialect.fields_enclosed_by && !dialect.fields_escaped_by) {
+    const void *end = offset < size ? std::memchr(data + offset, dialect.lines_terminated_by, size - offset) : NULL;
+    return end ? static_cast<const char*>(end) - data + 1 : size;
+  }
+
+  bool field_start = true;
+  size_t index = offset;
+
+  while (index < size) {
+    char c = data[index];
+
+    if (dialect.fields_escaped_by && c == dialect.fields_escaped_by) {
+      index += 2;
+      field_start = false;
+    } else if (dialect.fields_enclosed_by && c == dialect.fields_enclosed_by && field_start) {
+      index++;
+      while (index < size) {
+        c = data[index];
+        if (dialect.fields_escaped_by && c == dialect.fields_escaped_by) {
+          index += 2;
+        } else if (c == dialect.fields_enclosed_by) {
+          index++;
+          // A doubled enclosing character is part of the value
+          if (index >= size || data[index] != dialect.fields_enclosed_by)
+            break;
+          index++;
+        } else {
+          index++;
+        }
+      }
+      field_start = false;
+    } else if (c == dialect.fields_terminated_by) {
+      index++;
+      field_start = true;
+    } else if (c == dialect.lines_terminated_by) {
+      return index + 1;
+    } else {
+      index++;
+      field_start = false;
+    }
+  }
+
+  return size;
+}
+
+size_t skip_records(const char *data, size_t size, size_t offset, size_t count, const Text_dialect &dialect) {
+  for (size_t record = 0; record < count && offset < size; record++)
+    offset = find_record_end(data, size, offset, dialect);
+
+  return offset;
+}
+
+std::vector<std::pair<size_t, size_t> > split_records(const char *data, size_t size, size_t offset,
+                                                      size_t chunk_size, const Text_dialect &dialect) {
+  std::vector<std::pair<size_t, size_t> > chunks;
+  bool plain = !dialect.fields_enclosed_by && !dialect.fields_escaped_by;
+
+  if (chunk_size == 0)
+    chunk_size = 1;
+
+  while (offset < size) {
+    size_t end;
+    if (offset + chunk_size >= size) {
+      end = size;
+    } else if (plain) {
+      // Any line terminator is a record boundary, so it jumps straight there
+      end = find_record_end(data, size, offset + chunk_size - 1, dialect);
+    } else {
+      // Whether a line terminator is enclosed depends on all the data before
+      // it, so the records are walked one by one
+      end = offset;
+      while (end < size && end - offset < chunk_size)
+        end = find_record_end(data, size, end, dialect);
+    }
+
+    chunks.push_back(std::make_pair(offset, end - offset));
+    offset = end;
+  }
+
+  return chunks;
+}
+
+void append_field(std::string &record, const char *data, size_t length, const Text_dialect &dialect) {
+  if (!data) {
+    record.append(dialect.fields_escaped_by ? std::string(1, dialect.fields_escaped_by) + "N" : "NULL");
+    return;
+  }
+
+  if (dialect.fields_escaped_by) {
+    for (size_t index = 0; index < length; index++) {
+      char c = data[index];
+      if (c == '\0') {
+        record.append(1, dialect.fields_escaped_by).append(1, '0');
+      } else if (c == '\r') {
+        record.append(1, dialect.fields_escaped_by).append(1, 'r');
+      } else if (c == dialect.lines_terminated_by && c == '\n') {
+        record.append(1, dialect.fields_escaped_by).append(1, 'n');
+      } else if (c == dialect.fields_terminated_by && c == '\t') {
+        record.append(1, dialect.fields_escaped_by).append(1, 't');
+      } else if (c == dialect.fields_escaped_by || c == dialect.fields_terminated_by ||
+                 c == dialect.lines_terminated_by || c == dialect.fields_enclosed_by) {
+        record.append(1, dialect.fields_escaped_by).append(1, c);
+      } else {
+        record.append(1, c);
+      }
+    }
+  } else if (dialect.fields_enclosed_by) {
+    // Enclosed when the value could be read as something else
+    bool enclose = (length == 4 && std::memcmp(data, "NULL", 4) == 0) ||
+                   (length > 0 && data[0] == dialect.fields_enclosed_by);
+    for (size_t index = 0; index < length && !enclose; index++)
+      enclose = data[index] == dialect.fields_terminated_by || data[index] == dialect.lines_terminated_by;
+
+    if (!enclose) {
+      record.append(data, length);
+      return;
+    }
+
+    record.append(1, dialect.fields_enclosed_by);
+    for (size_t index = 0; index < length; index++) {
+      if (data[index] == dialect.fields_enclosed_by)
+        record.append(1, dialect.fields_enclosed_by);
+      record.append(1, data[index]);
+    }
+    record.append(1, dialect.fields_enclosed_by);
+  } else {
+    record.append(data, length);
+  }
+}
+
+Record_reader::Record_reader(const char *data, size_t size, const Text_dialect &dialect)
+  : _data(data), _size(size), _offset(0), _dialect(dialect) {
+}
+
+bool Record_reader::next(std::vector<std::string> &fields, std::vector<bool> &nulls) {
+  fields.clear();
+  nulls.clear();
+
+  if (_offset >= _size)
+    return false;
+
+  std::string field;
+  bool enclosed = false;
+  bool escaped_null = false;
+
+  auto end_field = [&]() {
+    bool null = escaped_null && field.size() == 1 && field[0] == 'N';
+    if (!_dialect.fields_escaped_by && !enclosed && field == "NULL")
+      null = true;
+
+    fields.push_back(null ? std::string() : field);
+    nulls.push_back(null);
+    field.clear();
+    enclosed = false;
+    escaped_null = false;
+  };
+
+  while (_offset < _size) {
+    char c = _data[_offset];
+
+    if (_dialect.fields_escaped_by && c == _dialect.fields_escaped_by && _offset + 1 < _size) {
+      char next = _data[_offset + 1];
+      // \N is a NULL only when it is the whole field
+      if (next == 'N' && field.empty() && !enclosed) {
+        escaped_null = true;
+        field.append(1, 'N');
+      } else {
+        escaped_null = false;
+        field.append(1, unescape(next));
+      }
+      _offset += 2;
+    } else if (_dialect.fields_enclosed_by && c == _dialect.fields_enclosed_by && field.empty() && !enclosed) {
+      enclosed = true;
+      _offset++;
+      while (_offset < _size) {
+        c = _data[_offset];
+        if (_dialect.fields_escaped_by && c == _dialect.fields_escaped_by && _offset + 1 < _size) {
+          field.append(1, unescape(_data[_offset + 1]));
+          _offset += 2;
+        } else if (c == _dialect.fields_enclosed_by) {
+          _offset++;
+          if (_offset >= _size || _data[_offset] != _dialect.fields_enclosed_by)
+            break;
+          field.append(1, c);
+          _offset++;
+        } else {
+          field.append(1, c);
+          _offset++;
+        }
+      }
+    } else if (c == _dialect.fields_terminated_by) {
+      end_field();
+      _offset++;
+    } else if (c == _dialect.lines_terminated_by) {
+      _offset++;
+      break;
+    } else {
+      escaped_null = false;
+      field.append(1, c);
+      _offset++;
+    }
+  }
+
+  end_field();
+  return true;
+}
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_CSV_H_
+#define _UTILS_CSV_H_
+
+#include "shellcore/common.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shcore {
+// The format of a delimited text file, with the meaning LOAD DATA gives to
+// the FIELDS and LINES clauses: a field may be enclosed, and when it is the
+// enclosing character is doubled to be part of the value. A 0 disables the
+// enclosing or the escaping characters
+struct SHCORE_PUBLIC Text_dialect {
+  char fields_terminated_by;
+  char fields_enclosed_by;
+  char fields_escaped_by;
+  char lines_terminated_by;
+
+  // Comma separated, optionally enclosed by double quotes, with no escaping
+  static Text_dialect csv();
+
+  // Tab separated with backslash escaping, the defaults of LOAD DATA
+  static Text_dialect tsv();
+
+  // Returns the dialect with the given name (csv or tsv), throws
+  // shcore::Exception for unknown names
+  static Text_dialect from_name(const std::string &name);
+
+  // The FIELDS and LINES clauses of a LOAD DATA statement reading this dialect
+  std::string load_data_clauses() const;
+};
+
+// Returns the offset of the record following the one starting at offset,
+// line terminators within enclosed fields or escaped are part of the record
+size_t SHCORE_PUBLIC find_record_end(const char *data, size_t size, size_t offset, const Text_dialect &dialect);
+
+// Returns the offset of the record following count records from offset
+size_t SHCORE_PUBLIC skip_records(const char *data, size_t size, size_t offset, size_t count, const Text_dialect &dialect);
+
+// Splits the data from offset in consecutive ranges (offset, length) of at
+// least chunk_size bytes, except the last one, each ending on a record boundary
+std::vector<std::pair<size_t, size_t> > SHCORE_PUBLIC split_records(const char *data, size_t size, size_t offset,
+                                                                    size_t chunk_size, const Text_dialect &dialect);
+
+// Appends a field to a record in the given dialect, escaping or enclosing
+// it as needed so Record_reader and LOAD DATA read it back unchanged. A
+// NULL data stands for a NULL value
+void SHCORE_PUBLIC append_field(std::string &record, const char *data, size_t length, const Text_dialect &dialect);
+
+// Reads the fields of the records on a block of data, the values are
+// unescaped the way LOAD DATA does
+class SHCORE_PUBLIC Record_reader {
+public:
+  Record_reader(const char *data, size_t size, const Text_dialect &dialect);
+
+  // Reads the next record, nulls tells which fields are NULL: \N when there
+  // is an escape character or an unenclosed NULL otherwise. Returns false
+  // when there are no more records
+  bool next(std::vector<std::string> &fields, std::vector<bool> &nulls);
+
+private:
+  const char *_data;
+  size_t _size;
+  size_t _offset;
+  Text_dialect _dialect;
+};
+}
+
+#endif
@@ -35,6 +35,9 @@
 #  include <sys/types.h>
 #  include <dirent.h>
 #  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
 #  include <stdio.h>
 
 #ifdef __APPLE__
@@ -440,4 +443,76 @@ std::string get_home_dir() {
 
   return path;
 }
+
+Mapped_file::Mapped_file(const std::string &path) : _data(NULL), _size(0) {
+#ifdef WIN32
+  _mapping = NULL;
+  _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (_file == INVALID_HANDLE_VALUE)
+    throw std::runtime_error("Unable to open file '" + path + "': " + get_last_error());
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(_file, &size)) {
+    std::string error = get_last_error();
+    CloseHandle(_file);
+    throw std::runtime_error("Unable to read the size of file '" + path + "': " + error);
+  }
+  _size = static_cast<size_t>(size.QuadPart);
+
+  // Empty files can not be mapped
+  if (_size) {
+    _mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (_mapping)
+      _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (!_data) {
+      std::string error = get_last_error();
+      if (_mapping)
+        CloseHandle(_mapping);
+      CloseHandle(_file);
+      throw std::runtime_error("Unable to map file '" + path + "': " + error);
+    }
+  }
+#else
+  _fd = ::open(path.c_str(), O_RDONLY);
+  if (_fd < 0)
+    throw std::runtime_error("Unable to open file '" + path + "': " + get_last_error());
+
+  struct stat file_stat;
+  if (fstat(_fd, &file_stat) != 0) {
+    std::string error = get_last_error();
+    ::close(_fd);
+    throw std::runtime_error("Unable to read the size of file '" + path + "': " + error);
+  }
+  _size = static_cast<size_t>(file_stat.st_size);
+
+  // Empty files can not be mapped
+  if (_size) {
+    void *mapping = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (mapping == MAP_FAILED) {
+      std::string error = get_last_error();
+      ::close(_fd);
+      throw std::runtime_error("Unable to map file '" + path + "': " + error);
+    }
+
+    // The file is read once from start to end
+    madvise(mapping, _size, MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(mapping);
+  }
+#endif
+}
+
+Mapped_file::~Mapped_file() {
+#ifdef WIN32
+  if (_data)
+    UnmapViewOfFile(_data);
+  if (_mapping)
+    CloseHandle(_mapping);
+  CloseHandle(_file);
+#else
+  if (_data)
+    munmap(const_cast<char*>(_data), _size);
+  ::close(_fd);
+#endif
+}
 }
@@ -35,5 +35,29 @@ std::string SHCORE_PUBLIC get_last_error();
 bool SHCORE_PUBLIC load_text_file(const std::string& path, std::string& data);
 void SHCORE_PUBLIC delete_file(const std::string& filename);
 std::string SHCORE_PUBLIC get_home_dir();
+
+// A file mapped in memory for reading, throws std::runtime_error if the file
+// can not be opened or mapped
+class SHCORE_PUBLIC Mapped_file {
+public:
+  explicit Mapped_file(const std::string &path);
+  ~Mapped_file();
+
+  const char *data() const { return _data; }
+  size_t size() const { return _size; }
+
+private:
+  Mapped_file(const Mapped_file &) = delete;
+  Mapped_file &operator = (const Mapped_file &) = delete;
+
+  const char *_data;
+  size_t _size;
+#ifdef WIN32
+  void *_file;
+  void *_mapping;
+#else
+  int _fd;
+#endif
+};
 }
 #endif /* defined(__mysh__utils_file__) */
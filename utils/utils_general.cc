@@ -35,6 +35,12 @@
 #endif
 #include "utils_connection.h"
 #include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
 
 #include <boost/format.hpp>
 
@@ -58,106 +64,181 @@ bool is_valid_identifier(const std::string& name) {
 }
 
 std::string build_connection_string(Value::Map_type_ref data, bool with_password) {
-  std::string uri;
-
-  // If needed we construct the URi from the individual parameters
-  if (data) {
-    if (data->has_key(kDbUser))
-      uri.append((*data)[kDbUser].as_string());
-    else if (data->has_key(kUser))
-      uri.append((*data)[kUser].as_string());
-
-    // Appends password definition, either if it is empty or not
-    // only if a user was specified
-    if (with_password && !uri.empty()) {
-      uri.append(":");
-      if (data->has_key(kDbPassword))
-        uri.append((*data)[kDbPassword].as_string());
-      else if (data->has_key(kPassword))
-        uri.append((*data)[kPassword].as_string());
-    }
+  if (!data)
+    return "";
 
-    // Appends the user@host separator, if a user has specified
-    if (!uri.empty())
-      uri.append("@");
+  return Connection_options::from_map(data).uri(with_password);
+}
 
-    // Sets the socket
-    if (data->has_key(kSocket))
-      uri.append((*data)[kSocket].as_string());
+Connection_options Connection_options::from_map(const Value::Map_type_ref &data) {
+  Connection_options ret_val;
 
-    else{ // the uri either has a socket, or an hostname and port
-      // Sets the host
-      if (data->has_key(kHost))
-        uri.append((*data)[kHost].as_string());
+  auto string_at = [&data](const std::string &key, std::string *value) {
+    if (!data->has_key(key))
+      return false;
 
-      // Sets the port
-      if (data->has_key(kPort)) {
-        uri.append(":");
-        uri.append((*data)[kPort].descr(true));
-      }
-    }
+    *value = (*data)[key].as_string();
+    return true;
+  };
 
-    // Sets the database
-    if (data->has_key(kSchema)) {
-      uri.append("/");
-      uri.append((*data)[kSchema].as_string());
-    }
+  if (!string_at(kDbUser, &ret_val.user))
+    string_at(kUser, &ret_val.user);
 
-    bool has_ssl = false;
-    struct SslInfo ssl_info;
+  ret_val.has_password = string_at(kDbPassword, &ret_val.password) || string_at(kPassword, &ret_val.password);
 
-    if (data->has_key(kSslCa)) {
-      ssl_info.ca = (*data)[kSslCa].as_string();
-      has_ssl = true;
-    }
+  string_at(kHost, &ret_val.host);
+  string_at(kSocket, &ret_val.socket);
+  string_at(kSchema, &ret_val.schema);
 
-    if (data->has_key(kSslCert)) {
-      ssl_info.cert = (*data)[kSslCert].as_string();
-      has_ssl = true;
-    }
+  if (data->has_key(kPort)) {
+    const Value &port = (*data)[kPort];
+    ret_val.port = port.type == String ? std::stoi(port.as_string()) : static_cast<int>(port.as_int());
+  }
 
-    if (data->has_key(kSslKey)) {
-      ssl_info.key = (*data)[kSslKey].as_string();
-      has_ssl = true;
-    }
+  bool has_ssl = string_at(kSslCa, &ret_val.ssl.ca);
+  has_ssl = string_at(kSslCert, &ret_val.ssl.cert) || has_ssl;
+  has_ssl = string_at(kSslKey, &ret_val.ssl.key) || has_ssl;
+  has_ssl = string_at(kSslCaPath, &ret_val.ssl.capath) || has_ssl;
+  has_ssl = string_at(kSslCrl, &ret_val.ssl.crl) || has_ssl;
+  has_ssl = string_at(kSslCrlPath, &ret_val.ssl.crlpath) || has_ssl;
+  has_ssl = string_at(kSslCiphers, &ret_val.ssl.ciphers) || has_ssl;
+  has_ssl = string_at(kSslTlsVersion, &ret_val.ssl.tls_version) || has_ssl;
+
+  std::string mode;
+  if (string_at(kSslMode, &mode)) {
+    ret_val.ssl.mode = shcore::MapSslModeNameToValue::get_value(mode);
+    has_ssl = true;
+  }
 
-    if (data->has_key(kSslCaPath)) {
-      ssl_info.capath = (*data)[kSslCaPath].as_string();
-      has_ssl = true;
-    }
+  ret_val.ssl.skip = !has_ssl;
 
-    if (data->has_key(kSslCrl)) {
-      ssl_info.crl = (*data)[kSslCrl].as_string();
-      has_ssl = true;
-    }
+  return ret_val;
+}
 
-    if (data->has_key(kSslCrlPath)) {
-      ssl_info.crlpath = (*data)[kSslCrlPath].as_string();
-      has_ssl = true;
-    }
+Value::Map_type_ref Connection_options::to_map() const {
+  Value::Map_type_ref ret_val(new shcore::Value::Map_type);
 
-    if (data->has_key(kSslCiphers)) {
-      ssl_info.ciphers = (*data)[kSslCiphers].as_string();
-      has_ssl = true;
-    }
+  if (!scheme.empty())
+    (*ret_val)[kScheme] = Value(scheme);
 
-    if (data->has_key(kSslTlsVersion)) {
-      ssl_info.tls_version = (*data)[kSslTlsVersion].as_string();
-      has_ssl = true;
-    }
+  if (!user.empty())
+    (*ret_val)[kDbUser] = Value(user);
+
+  if (!host.empty())
+    (*ret_val)[kHost] = Value(host);
+
+  if (port != 0)
+    (*ret_val)[kPort] = Value(port);
+
+  if (has_password)
+    (*ret_val)[kDbPassword] = Value(password);
+
+  if (!schema.empty())
+    (*ret_val)[kSchema] = Value(schema);
+
+  if (!socket.empty())
+    (*ret_val)[kSocket] = Value(socket);
+
+  if (!ssl.ca.empty())
+    (*ret_val)[kSslCa] = Value(ssl.ca);
+
+  if (!ssl.cert.empty())
+    (*ret_val)[kSslCert] = Value(ssl.cert);
+
+  if (!ssl.key.empty())
+    (*ret_val)[kSslKey] = Value(ssl.key);
+
+  if (!ssl.capath.empty())
+    (*ret_val)[kSslCaPath] = Value(ssl.capath);
+
+  if (!ssl.crl.empty())
+    (*ret_val)[kSslCrl] = Value(ssl.crl);
+
+  if (!ssl.crlpath.empty())
+    (*ret_val)[kSslCrlPath] = Value(ssl.crlpath);
+
+  if (!ssl.ciphers.empty())
+    (*ret_val)[kSslCiphers] = Value(ssl.ciphers);
 
-    if (data->has_key(kSslMode)) {
-      ssl_info.mode = shcore::MapSslModeNameToValue::get_value((*data)[kSslMode].as_string());
-      has_ssl = true;
+  if (!ssl.tls_version.empty())
+    (*ret_val)[kSslTlsVersion] = Value(ssl.tls_version);
+
+  if (ssl.mode != 0)
+    (*ret_val)[kSslMode] = Value(shcore::MapSslModeNameToValue::get_value(ssl.mode));
+
+  return ret_val;
+}
+
+std::string Connection_options::uri(bool with_password) const {
+  std::string ret_val(user);
+
+  // Appends password definition, either if it is empty or not
+  // only if a user was specified
+  if (with_password && !ret_val.empty())
+    ret_val.append(":").append(password);
+
+  // Appends the user@host separator, if a user has specified
+  if (!ret_val.empty())
+    ret_val.append("@");
+
+  // the uri either has a socket, or an hostname and port
+  if (!socket.empty()) {
+    ret_val.append(socket);
+  } else if (host.find(',') != std::string::npos) {
+    // A list of hosts goes in brackets and carries the ports
+    ret_val.append("[" + host + "]");
+  } else {
+    ret_val.append(host);
+
+    if (port != 0)
+      ret_val.append(":").append(std::to_string(port));
+  }
+
+  if (!schema.empty())
+    ret_val.append("/").append(schema);
+
+  conn_str_cat_ssl_data(ret_val, ssl);
+
+  return ret_val;
+}
+
+Connection_options Connection_options::parse(const std::string &uri, bool set_defaults) {
+  static std::mutex cache_mutex;
+  static std::map<std::string, Connection_options> cache;
+  const size_t k_max_cached = 256;
+
+  Connection_options ret_val;
+  bool cached = false;
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto entry = cache.find(uri);
+    if (entry != cache.end()) {
+      ret_val = entry->second;
+      cached = true;
     }
+  }
 
-    if (has_ssl)
-    {
-      conn_str_cat_ssl_data(uri, ssl_info);
+  if (!cached) {
+    int pwd_found = 0;
+    parse_mysql_connstring(uri, ret_val.scheme, ret_val.user, ret_val.password, ret_val.host, ret_val.port,
+                           ret_val.socket, ret_val.schema, pwd_found, ret_val.ssl, false);
+    ret_val.has_password = pwd_found != 0;
+
+    // Passwords are not kept around for the life of the process
+    if (!ret_val.has_password) {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      if (cache.size() >= k_max_cached)
+        cache.clear();
+      cache[uri] = ret_val;
     }
   }
 
-  return uri;
+  // Applied after the cache, the system user is not part of the URI
+  if (set_defaults && ret_val.user.empty())
+    ret_val.user = get_system_user();
+
+  return ret_val;
 }
 
 void conn_str_cat_ssl_data(std::string& uri, const SslInfo &ssl_info) {
@@ -234,9 +315,22 @@ void parse_mysql_connstring(const std::string &connstring,
 
     switch (data.get_type()) {
       case uri::Tcp:
-        host = data.get_host();
-        if (data.has_port())
-          port = data.get_port();
+        if (data.has_host_list()) {
+          // The list goes on the host as host[:port] entries separated by
+          // commas, X protocol sessions try them all
+          host.clear();
+          for (auto &entry : data.get_hosts()) {
+            if (!host.empty())
+              host.append(",");
+            host.append(entry.first.find(':') == std::string::npos ? entry.first : "[" + entry.first + "]");
+            if (entry.second)
+              host.append(":" + std::to_string(entry.second));
+          }
+        } else {
+          host = data.get_host();
+          if (data.has_port())
+            port = data.get_port();
+        }
         break;
       case uri::Socket:
         sock = data.get_socket();
@@ -425,76 +519,10 @@ bool SHCORE_PUBLIC validate_uri(const std::string &uri) {
 
 // Builds a connection data dictionary using the URI
 Value::Map_type_ref get_connection_data(const std::string &uri, bool set_defaults) {
-  // NOTE: protocol is left in case an URI still uses it, however, it is ignored everywhere
-  std::string uri_scheme;
-  std::string uri_user;
-  std::string uri_password;
-  std::string uri_host;
-  int uri_port = 0;
-  std::string uri_sock;
-  std::string uri_database;
-  struct SslInfo uri_ssl_info;
-  int pwd_found = 0;
-
-  // Creates the connection dictionary
-  Value::Map_type_ref ret_val(new shcore::Value::Map_type);
-
-  // Parses the URI if provided
-  if (!uri.empty()) {
-    parse_mysql_connstring(uri, uri_scheme, uri_user, uri_password, uri_host, uri_port, uri_sock, uri_database, pwd_found,
-                           uri_ssl_info, set_defaults);
-
-    if (!uri_scheme.empty())
-      (*ret_val)[kScheme] = Value(uri_scheme);
-
-    if (!uri_user.empty())
-      (*ret_val)[kDbUser] = Value(uri_user);
-
-    if (!uri_host.empty())
-      (*ret_val)[kHost] = Value(uri_host);
-
-    if (uri_port != 0)
-      (*ret_val)[kPort] = Value(uri_port);
-
-    if (pwd_found)
-      (*ret_val)[kDbPassword] = Value(uri_password);
-
-    if (!uri_database.empty())
-      (*ret_val)[kSchema] = Value(uri_database);
-
-    if (!uri_sock.empty())
-      (*ret_val)[kSocket] = Value(uri_sock);
-
-    if (!uri_ssl_info.ca.empty())
-      (*ret_val)[kSslCa] = Value(uri_ssl_info.ca);
-
-    if (!uri_ssl_info.cert.empty())
-      (*ret_val)[kSslCert] = Value(uri_ssl_info.cert);
-
-    if (!uri_ssl_info.key.empty())
-      (*ret_val)[kSslKey] = Value(uri_ssl_info.key);
-
-    if (!uri_ssl_info.capath.empty())
-      (*ret_val)[kSslCaPath] = Value(uri_ssl_info.capath);
-
-    if (!uri_ssl_info.crl.empty())
-      (*ret_val)[kSslCrl] = Value(uri_ssl_info.crl);
-
-    if (!uri_ssl_info.crlpath.empty())
-      (*ret_val)[kSslCrlPath] = Value(uri_ssl_info.crlpath);
-
-    if (!uri_ssl_info.ciphers.empty())
-      (*ret_val)[kSslCiphers] = Value(uri_ssl_info.ciphers);
-
-    if (!uri_ssl_info.tls_version.empty())
-      (*ret_val)[kSslTlsVersion] = Value(uri_ssl_info.tls_version);
-
-    if (uri_ssl_info.mode != 0)
-      (*ret_val)[kSslMode] = Value(shcore::MapSslModeNameToValue::get_value(uri_ssl_info.mode));
-  }
+  if (uri.empty())
+    return Value::Map_type_ref(new shcore::Value::Map_type);
 
-  // If needed we construct the URi from the individual parameters
-  return ret_val;
+  return Connection_options::parse(uri, set_defaults).to_map();
 }
 
 // Overrides connection data parameters with specific values, also adds parameters with default values if missing
@@ -839,6 +867,153 @@ std::string replace_text(const std::string& source, const std::string& from, con
   return ret_val;
 }
 
+static size_t code_point_width(uint32_t cp) {
+  // Combining marks and zero width spaces
+  if ((cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x1AB0 && cp <= 0x1AFF) ||
+      (cp >= 0x1DC0 && cp <= 0x1DFF) || (cp >= 0x200B && cp <= 0x200F) ||
+      (cp >= 0x20D0 && cp <= 0x20FF) || (cp >= 0xFE20 && cp <= 0xFE2F))
+    return 0;
+
+  // Wide characters: Hangul, CJK, fullwidth forms and emoji
+  if ((cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF && cp != 0x303F) ||
+      (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+      (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF60) ||
+      (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x1F300 && cp <= 0x1F64F) ||
+      (cp >= 0x1F900 && cp <= 0x1F9FF) || (cp >= 0x20000 && cp <= 0x3FFFD))
+    return 2;
+
+  return 1;
+}
+
+size_t display_width(const char *text, size_t length) {
+  size_t width = 0;
+  size_t index = 0;
+
+  while (index < length) {
+    unsigned char c = static_cast<unsigned char>(text[index]);
+
+    // ASCII needs no decoding
+    if (c < 0x80) {
+      width++;
+      index++;
+      continue;
+    }
+
+    size_t size = 0;
+    uint32_t cp = 0;
+    if ((c & 0xE0) == 0xC0) {
+      size = 2;
+      cp = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+      size = 3;
+      cp = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+      size = 4;
+      cp = c & 0x07;
+    }
+
+    bool valid = size && index + size <= length;
+    for (size_t next = 1; valid && next < size; next++) {
+      unsigned char cont = static_cast<unsigned char>(text[index + next]);
+      valid = (cont & 0xC0) == 0x80;
+      cp = (cp << 6) | (cont & 0x3F);
+    }
+
+    // Bytes that are not valid UTF-8 are displayed as one column each
+    if (valid) {
+      width += code_point_width(cp);
+      index += size;
+    } else {
+      width++;
+      index++;
+    }
+  }
+
+  return width;
+}
+
+namespace {
+// The two hex digits of every byte value
+struct Hex_table {
+  Hex_table() {
+    static const char digits[] = "0123456789ABCDEF";
+    for (int byte = 0; byte < 256; byte++) {
+      pairs[byte * 2] = digits[byte >> 4];
+      pairs[byte * 2 + 1] = digits[byte & 0x0F];
+    }
+  }
+
+  char pairs[512];
+};
+
+const char k_base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// The two base64 characters of every 12 bit value
+struct Base64_table {
+  Base64_table() {
+    for (int value = 0; value < 4096; value++) {
+      pairs[value * 2] = k_base64_alphabet[value >> 6];
+      pairs[value * 2 + 1] = k_base64_alphabet[value & 0x3F];
+    }
+  }
+
+  char pairs[8192];
+};
+}
+
+void append_hex(std::string &out, const char *data, size_t length) {
+  static const Hex_table table;
+
+  size_t start = out.size();
+  out.resize(start + 2 + length * 2);
+
+  char *target = &out[start];
+  *target++ = '0';
+  *target++ = 'x';
+
+  const unsigned char *source = reinterpret_cast<const unsigned char *>(data);
+  const unsigned char *end = source + length;
+
+  // Eight bytes per iteration, the compiler keeps the loads and stores in
+  // registers
+  for (; end - source >= 8; source += 8, target += 16) {
+    for (int index = 0; index < 8; index++)
+      memcpy(target + index * 2, table.pairs + source[index] * 2, 2);
+  }
+
+  for (; source < end; source++, target += 2)
+    memcpy(target, table.pairs + *source * 2, 2);
+}
+
+void append_base64(std::string &out, const char *data, size_t length) {
+  static const Base64_table table;
+
+  size_t start = out.size();
+  out.resize(start + (length + 2) / 3 * 4);
+
+  char *target = &out[start];
+  const unsigned char *source = reinterpret_cast<const unsigned char *>(data);
+  const unsigned char *end = source + length - length % 3;
+
+  // Every three bytes are two 12 bit halves, each written as a pair
+  for (; source < end; source += 3, target += 4) {
+    uint32_t block = (uint32_t(source[0]) << 16) | (uint32_t(source[1]) << 8) | source[2];
+    memcpy(target, table.pairs + (block >> 12) * 2, 2);
+    memcpy(target + 2, table.pairs + (block & 0xFFF) * 2, 2);
+  }
+
+  size_t rest = length % 3;
+  if (rest) {
+    uint32_t block = uint32_t(source[0]) << 16;
+    if (rest == 2)
+      block |= uint32_t(source[1]) << 8;
+
+    memcpy(target, table.pairs + (block >> 12) * 2, 2);
+    target[2] = rest == 2 ? k_base64_alphabet[(block >> 6) & 0x3F] : '=';
+    target[3] = '=';
+  }
+}
+
 std::string get_my_hostname() {
   char hostname[1024]  {'\0'};
 
@@ -909,6 +1084,112 @@ bool is_local_host(const std::string &host, bool check_hostname) {
 }
 
 
+namespace {
+// The sockets of the local servers by port, loaded from the user
+// configuration folder on first use. Each line of the file is a port and
+// its path, which is empty for the servers without one.
+std::mutex local_sockets_mutex;
+std::map<int, std::string> *local_sockets = nullptr;
+
+std::string local_sockets_path() {
+  return get_user_config_path() + "local_sockets";
+}
+
+std::map<int, std::string> &load_local_sockets() {
+  if (!local_sockets) {
+    local_sockets = new std::map<int, std::string>();
+
+    std::string data;
+    if (load_text_file(local_sockets_path(), data)) {
+      std::stringstream lines(data);
+      std::string line;
+
+      while (std::getline(lines, line)) {
+        size_t separator = line.find(' ');
+        if (separator == std::string::npos)
+          continue;
+
+        int port = std::atoi(line.substr(0, separator).c_str());
+        if (port > 0)
+          (*local_sockets)[port] = line.substr(separator + 1);
+      }
+    }
+  }
+
+  return *local_sockets;
+}
+
+void save_local_sockets() {
+  std::ofstream file(local_sockets_path(), std::ofstream::trunc);
+
+  for (auto &socket : *local_sockets)
+    file << socket.first << " " << socket.second << "\n";
+}
+}
+
+bool get_local_socket(int port, std::string *path) {
+  std::lock_guard<std::mutex> lock(local_sockets_mutex);
+  std::map<int, std::string> &sockets = load_local_sockets();
+
+  auto socket = sockets.find(port);
+  if (socket == sockets.end())
+    return false;
+
+  *path = socket->second;
+  return true;
+}
+
+void set_local_socket(int port, const std::string &path) {
+  std::lock_guard<std::mutex> lock(local_sockets_mutex);
+  std::map<int, std::string> &sockets = load_local_sockets();
+
+  auto socket = sockets.find(port);
+  if (socket != sockets.end() && socket->second == path)
+    return;
+
+  sockets[port] = path;
+  save_local_sockets();
+}
+
+void forget_local_socket(int port) {
+  std::lock_guard<std::mutex> lock(local_sockets_mutex);
+
+  if (load_local_sockets().erase(port))
+    save_local_sockets();
+}
+
+void remember_local_sockets(int port, const std::map<std::string, std::string> &variables) {
+  auto value = [&variables](const char *name) {
+    auto variable = variables.find(name);
+    return variable == variables.end() ? std::string() : variable->second;
+  };
+
+  int classic_port = std::atoi(value("port").c_str());
+  int x_port = std::atoi(value("mysqlx_port").c_str());
+
+  // A forwarded port leads to a server elsewhere, like in a container,
+  // whose socket paths are not valid here
+  if (port != classic_port && port != x_port) {
+    set_local_socket(port, "");
+    return;
+  }
+
+#ifdef _WIN32
+  set_local_socket(classic_port, value("named_pipe") == "ON" ? value("socket") : "");
+  // The X protocol has no named pipes
+  if (x_port)
+    set_local_socket(x_port, "");
+#else
+  auto existing = [](const std::string &path) {
+    return !path.empty() && file_exists(path) ? path : std::string();
+  };
+
+  set_local_socket(classic_port, existing(value("socket")));
+  if (x_port)
+    set_local_socket(x_port, existing(value("mysqlx_socket")));
+#endif
+}
+
 static std::size_t span_quotable_identifier(const std::string &s, std::size_t p,
       std::string *out_string) {
 
@@ -24,12 +24,37 @@
 #include "shellcore/types.h"
 #include "shellcore/types_cpp.h"
 #include "utils/utils_connection.h"
+#include <map>
 #include <string>
 #include <set>
 #include <vector>
 
 namespace shcore {
 
+// Connection data parsed once and handed around as is, rather than turned
+// into a dictionary and back into an URI at every step
+struct SHCORE_PUBLIC Connection_options {
+  Connection_options() : has_password(false), port(0) {}
+
+  // Parsed URIs are cached, so the AdminAPI can go through the addresses of
+  // the instances as often as it needs
+  static Connection_options parse(const std::string &uri, bool set_defaults = true);
+  static Connection_options from_map(const Value::Map_type_ref &data);
+
+  Value::Map_type_ref to_map() const;
+  std::string uri(bool with_password) const;
+
+  std::string scheme;
+  std::string user;
+  std::string password;
+  bool has_password;
+  std::string host;
+  int port;
+  std::string socket;
+  std::string schema;
+  SslInfo ssl;
+};
+
 bool SHCORE_PUBLIC is_valid_identifier(const std::string& name);
 std::string SHCORE_PUBLIC build_connection_string(Value::Map_type_ref data, bool with_password);
 void SHCORE_PUBLIC conn_str_cat_ssl_data(std::string& uri, const SslInfo &ssl_info);
@@ -71,8 +96,37 @@ std::string SHCORE_PUBLIC get_member_name(const std::string& name, shcore::Namin
 std::string SHCORE_PUBLIC format_text(const std::vector<std::string>& lines, size_t width, size_t left_padding, bool paragraph_per_line);
 std::string SHCORE_PUBLIC format_markup_text(const std::vector<std::string>& lines, size_t width, size_t left_padding);
 std::string SHCORE_PUBLIC replace_text(const std::string& source, const std::string& from, const std::string& to);
+
+// Number of terminal columns used to display the UTF-8 text: wide (East
+// Asian) characters use two columns and combining marks none
+size_t SHCORE_PUBLIC display_width(const char *text, size_t length);
+inline size_t display_width(const std::string &text) { return display_width(text.data(), text.size()); }
+
+// Append the bytes as text: 0x followed by two uppercase hex digits per
+// byte, or standard base64 with padding. The output is sized once and the
+// input is taken in blocks (two bytes for hex, three for base64) through
+// lookup tables, so long values cost a table lookup per output pair.
+void SHCORE_PUBLIC append_hex(std::string &out, const char *data, size_t length);
+void SHCORE_PUBLIC append_base64(std::string &out, const char *data, size_t length);
 std::string get_my_hostname();
 bool is_local_host(const std::string &host, bool check_hostname);
+
+// The socket (the named pipe on Windows) of the local server listening on
+// the TCP port, as found by an earlier connection to it. Returns false when
+// the port is unknown, an empty path means the server has none.
+bool SHCORE_PUBLIC get_local_socket(int port, std::string *path);
+// Remembers the socket of the port in the user configuration folder, so
+// later processes find it too
+void SHCORE_PUBLIC set_local_socket(int port, const std::string &path);
+void SHCORE_PUBLIC forget_local_socket(int port);
+
+// Gives the name and value of the server variables with its sockets
+const char *const k_local_sockets_query =
+    "SHOW GLOBAL VARIABLES WHERE Variable_name IN "
+    "('port', 'socket', 'named_pipe', 'mysqlx_port', 'mysqlx_socket')";
+// Remembers the sockets of the server reached through the port, given the
+// results of k_local_sockets_query
+void SHCORE_PUBLIC remember_local_sockets(int port, const std::map<std::string, std::string> &variables);
 }
 
 #endif /* defined(__mysh__utils_general__) */
@@ -19,11 +19,14 @@
 
 #include "utils_help.h"
 #include "utils_general.h"
-#include <vector>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <vector>
 
 namespace shcore {
 Shell_help *Shell_help::_instance = nullptr;
+Help_register *Shell_help::_registered = nullptr;
 
 Shell_help *Shell_help::get() {
   if (!_instance)
@@ -40,13 +43,40 @@ std::string Shell_help::get_token(const std::string& token) {
   std::string ret_val;
 
   if (_help_data.find(token) != _help_data.end())
-      ret_val = _help_data[token];
+    ret_val = _help_data[token];
+  else if (const char *data = find_registered(token))
+    ret_val = data;
 
   return ret_val;
 }
 
-Help_register::Help_register(const std::string &token, const std::string &data) {
-  shcore::Shell_help::get()->add_help(token, data);
+const char *Shell_help::find_registered(const std::string& token) {
+  // Rebuilt if libraries loaded after the last lookup registered more help
+  if (_indexed != _registered) {
+    _indexed = _registered;
+    _index.clear();
+    for (const Help_register *entry = _registered; entry; entry = entry->next)
+      _index.push_back(entry);
+
+    // Stable so the last registered entry of a token is the one found
+    std::stable_sort(_index.begin(), _index.end(), [](const Help_register *a, const Help_register *b) {
+      return strcmp(a->token, b->token) < 0;
+    });
+  }
+
+  auto entry = std::lower_bound(_index.begin(), _index.end(), token, [](const Help_register *a, const std::string &b) {
+    return strcmp(a->token, b.c_str()) < 0;
+  });
+
+  if (entry != _index.end() && token == (*entry)->token)
+    return (*entry)->data;
+
+  return nullptr;
+}
+
+Help_register::Help_register(const char *token, const char *data)
+  : token(token), data(data), next(Shell_help::_registered) {
+  Shell_help::_registered = this;
 };
 
 std::vector<std::string> get_help_text(const std::string& token) {
@@ -26,6 +26,8 @@
 #include <vector>
 
 namespace shcore {
+struct Help_register;
+
 class SHCORE_PUBLIC  Shell_help {
 public:
   virtual ~Shell_help() {};
@@ -38,18 +40,36 @@ public:
   void add_help(const std::string& token, const std::string& data);
 
 private:
+  friend struct Help_register;
+
   // Private constructor since this is a singleton
-  Shell_help() {};
+  Shell_help() : _indexed(nullptr) {};
+
+  const char *find_registered(const std::string& token);
 
-  // Options will be stored on a MAP
+  // Help added at runtime
   std::map<std::string, std::string> _help_data;
 
+  // The REGISTER_HELP entries sorted by token, built on the first lookup
+  std::vector<const Help_register*> _index;
+  const Help_register *_indexed;
+
+  // The REGISTER_HELP entries as they were registered, the last one first
+  static Help_register* _registered;
+
   // The only available instance
   static Shell_help* _instance;
 };
 
-struct Help_register {
-  Help_register(const std::string &token, const std::string &data);
+// Registration of help text on static initialization: it only links the
+// entry, the literals stay in the read only data and nothing is copied
+// until the help is looked up
+struct SHCORE_PUBLIC Help_register {
+  Help_register(const char *token, const char *data);
+
+  const char *token;
+  const char *data;
+  Help_register *next;
 };
 
 std::vector<std::string> SHCORE_PUBLIC get_help_text(const std::string& token);
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_history.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+namespace shcore {
+namespace {
+// Calls the function with the entries of the block, newest first, until it
+// returns false. The block is a sequence of NUL terminated entries.
+template <typename Function>
+bool for_each_entry_reversed(const char *data, size_t size, Function function) {
+  // A last entry without its NUL was cut short by a crash, it is skipped
+  const char *end = data + size;
+  while (end > data && end[-1] != '\0')
+    end--;
+
+  while (end > data) {
+    const char *start = end - 1;
+    while (start > data && start[-1] != '\0')
+      start--;
+
+    if (!function(start, static_cast<size_t>(end - 1 - start)))
+      return false;
+
+    end = start;
+  }
+
+  return true;
+}
+
+bool contains(const char *entry, size_t length, const std::string &text) {
+  if (text.size() > length)
+    return false;
+
+  if (text.empty())
+    return true;
+
+  // memchr() skips most of the entry at once
+  const char *last = entry + length - text.size();
+  for (const char *next = entry; next <= last; next++) {
+    next = static_cast<const char*>(memchr(next, text[0], last - next + 1));
+    if (!next)
+      return false;
+
+    if (memcmp(next, text.data(), text.size()) == 0)
+      return true;
+  }
+
+  return false;
+}
+}
+
+History_store::History_store(const std::string &path) : _path(path), _file(NULL) {
+  if (file_exists(path))
+    _mapped.reset(new Mapped_file(path));
+}
+
+History_store::~History_store() {
+  if (_file)
+    fclose(_file);
+}
+
+void History_store::append(const std::string &entry) {
+  if (!_file) {
+    _file = fopen(_path.c_str(), "ab");
+    if (!_file)
+      throw std::runtime_error("Unable to open file '" + _path + "': " + get_last_error());
+  }
+
+  // Written at once, so other shells appending to the same file do not
+  // split the entry
+  std::string record(entry.data(), entry.size() + 1);
+
+  // Ends an entry cut short by a crash, so it is not joined to this one
+  std::string written(record);
+  if (_appended.empty() && _mapped && _mapped->size() && _mapped->data()[_mapped->size() - 1] != '\0')
+    written.insert(0, 1, '\0');
+
+  if (fwrite(written.data(), 1, written.size(), _file) != written.size() || fflush(_file) != 0)
+    throw std::runtime_error("Unable to write to file '" + _path + "': " + get_last_error());
+
+  _appended.append(record);
+}
+
+std::vector<std::string> History_store::last(size_t count) const {
+  std::vector<std::string> ret_val;
+
+  auto collect = [&ret_val, count](const char *entry, size_t length) {
+    if (ret_val.size() >= count)
+      return false;
+
+    ret_val.push_back(std::string(entry, length));
+    return true;
+  };
+
+  if (for_each_entry_reversed(_appended.data(), _appended.size(), collect) && _mapped)
+    for_each_entry_reversed(_mapped->data(), _mapped->size(), collect);
+
+  std::reverse(ret_val.begin(), ret_val.end());
+  return ret_val;
+}
+
+std::vector<std::string> History_store::search(const std::string &text, size_t max_matches) const {
+  std::vector<std::string> ret_val;
+  std::unordered_set<std::string> found;
+
+  // A plain scan of the mapped file is faster than the terminal shows the
+  // result, even for years of history
+  auto collect = [&](const char *entry, size_t length) {
+    if (ret_val.size() >= max_matches)
+      return false;
+
+    if (contains(entry, length, text)) {
+      std::string match(entry, length);
+      if (found.insert(match).second)
+        ret_val.push_back(match);
+    }
+
+    return true;
+  };
+
+  if (for_each_entry_reversed(_appended.data(), _appended.size(), collect) && _mapped)
+    for_each_entry_reversed(_mapped->data(), _mapped->size(), collect);
+
+  return ret_val;
+}
+}
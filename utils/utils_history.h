@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_HISTORY_H_
+#define _UTILS_HISTORY_H_
+
+#include "shellcore/common.h"
+#include "utils/utils_file.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace shcore {
+// The statements typed on the interactive shell, kept in a file that is
+// only appended to. Every entry ends with a NUL byte, so entries may span
+// several lines. The file is mapped rather than read, so opening it takes
+// the same time no matter how long the history is.
+class SHCORE_PUBLIC History_store {
+public:
+  // A missing file is created on the first append
+  explicit History_store(const std::string &path);
+  ~History_store();
+
+  void append(const std::string &entry);
+
+  // The last entries, oldest first, found from the end of the file
+  std::vector<std::string> last(size_t count) const;
+
+  // The distinct entries containing the text, newest first
+  std::vector<std::string> search(const std::string &text, size_t max_matches) const;
+
+private:
+  History_store(const History_store &) = delete;
+  History_store &operator = (const History_store &) = delete;
+
+  std::string _path;
+  // The file as it was when opened, and the entries appended since
+  std::unique_ptr<Mapped_file> _mapped;
+  std::string _appended;
+  FILE *_file;
+};
+}
+
+#endif
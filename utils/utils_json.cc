@@ -31,6 +31,11 @@ JSON_dumper::JSON_dumper(bool pprint) {
     _writer = new Raw_writer();
 }
 
+JSON_dumper::JSON_dumper(bool pprint, const Writer_base::Output_handler &output, size_t chunk_size) :
+JSON_dumper(pprint) {
+  _writer->set_output(output, chunk_size);
+}
+
 JSON_dumper::~JSON_dumper() {
   if (_writer)
     delete (_writer);
@@ -57,7 +62,7 @@ void JSON_dumper::append_value(const Value &value) {
       _writer->append_float(value.as_double());
       break;
     case String:
-      _writer->append_string(value.as_string().c_str());
+      _writer->append_string(value.as_string());
       break;
     case Object:
     {
@@ -183,6 +188,11 @@ void JSON_dumper::append_string(const std::string& key, const std::string& data)
   _writer->append_string(data);
 }
 
+void JSON_dumper::append_string(const std::string& key, const char *data, size_t length) const {
+  _writer->append_string(key);
+  _writer->append_string(data, length);
+}
+
 void JSON_dumper::append_float(double data) const {
   _writer->append_float(data);
 }
@@ -20,6 +20,8 @@
 #ifndef __MYSH__UTILS_JSON__
 #define __MYSH__UTILS_JSON__
 
+#include <cstring>
+#include <functional>
 #include <string>
 #include <rapidjson/writer.h>
 #include <rapidjson/prettywriter.h>
@@ -27,19 +29,95 @@
 #include "shellcore/common.h"
 
 namespace shcore {
+// Writes str as a quoted and escaped JSON string, the same way rapidjson does
+// but appending the runs of bytes that need no escaping at once
+template <typename Stream>
+void write_json_string(Stream &stream, const char *str, size_t length) {
+  static const char hex_digits[] = "0123456789ABCDEF";
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t high_bits = 0x8080808080808080ULL;
+
+  stream.Put('"');
+
+  size_t run_start = 0;
+  size_t index = 0;
+  while (index < length) {
+    // Skips 8 bytes at a time while none of them is a control character,
+    // a quote or a backslash
+    if (index + 8 <= length) {
+      uint64_t word;
+      memcpy(&word, str + index, sizeof(word));
+      uint64_t quotes = word ^ (ones * '"');
+      uint64_t backslashes = word ^ (ones * '\\');
+      if ((((word - ones * 0x20) | (quotes - ones) | (backslashes - ones)) & ~word & high_bits) == 0) {
+        index += 8;
+        continue;
+      }
+    }
+
+    unsigned char c = static_cast<unsigned char>(str[index]);
+    if (c < 0x20 || c == '"' || c == '\\') {
+      stream.Put(str + run_start, index - run_start);
+      stream.Put('\\');
+      switch (c) {
+        case '"': stream.Put('"'); break;
+        case '\\': stream.Put('\\'); break;
+        case '\b': stream.Put('b'); break;
+        case '\t': stream.Put('t'); break;
+        case '\n': stream.Put('n'); break;
+        case '\f': stream.Put('f'); break;
+        case '\r': stream.Put('r'); break;
+        default:
+          stream.Put('u');
+          stream.Put('0');
+          stream.Put('0');
+          stream.Put(hex_digits[c >> 4]);
+          stream.Put(hex_digits[c & 15]);
+      }
+      run_start = index + 1;
+    }
+    index++;
+  }
+
+  stream.Put(str + run_start, length - run_start);
+  stream.Put('"');
+}
+
 // This class is to wrap the Raw and Pretty writers from rapidjson since
 // they
 class SHCORE_PUBLIC Writer_base {
+public:
+  // Receives the generated JSON in chunks when the writer is streaming
+  typedef std::function<void(const std::string &chunk)> Output_handler;
+
 protected:
 
   class SStream {
   public:
+    SStream() : chunk_size(0) {}
+
     void Put(char c) {
       data += c;
+      if (chunk_size && data.size() >= chunk_size)
+        flush_chunk();
+    }
+    void Put(const char *str, size_t length) {
+      data.append(str, length);
+      if (chunk_size && data.size() >= chunk_size)
+        flush_chunk();
     }
     void Flush() {}
 
+    void flush_chunk() {
+      if (!data.empty()) {
+        output(data);
+        data.clear();
+      }
+    }
+
     std::string data;
+    Output_handler output;
+    size_t chunk_size;
   };
 
   SStream _data;
@@ -58,8 +136,22 @@ public:
   virtual void append_uint(unsigned int data) = 0;
   virtual void append_uint64(uint64_t data) = 0;
   virtual void append_string(const std::string& data) = 0;
+  virtual void append_string(const char *data, size_t length) = 0;
   virtual void append_float(double data) = 0;
 
+  // Sends the data to output every time chunk_size bytes are generated
+  // instead of keeping the whole document
+  void set_output(const Output_handler &output, size_t chunk_size) {
+    _data.output = output;
+    _data.chunk_size = chunk_size;
+  }
+
+  // Sends the data not yet sent to the output
+  void flush() {
+    if (_data.output)
+      _data.flush_chunk();
+  }
+
 public:
   std::string str() { return _data.data; }
 };
@@ -81,10 +173,21 @@ public:
   virtual void append_uint(unsigned int data) { _writer.Uint(data); };
   virtual void append_uint64(uint64_t data) { _writer.Uint64(data); };
   virtual void append_string(const std::string& data) { _writer.String(data.c_str(), unsigned(data.length())); };
+  virtual void append_string(const char *data, size_t length) { _writer.String(data, unsigned(length)); };
   virtual void append_float(double data) { _writer.Double(data); };
 
 private:
-  rapidjson::Writer<SStream>_writer;
+  class Writer : public rapidjson::Writer<SStream> {
+  public:
+    Writer(SStream &stream) : rapidjson::Writer<SStream>(stream) {}
+    bool String(const char *str, rapidjson::SizeType length) {
+      Prefix(rapidjson::kStringType);
+      write_json_string(*os_, str, length);
+      return true;
+    }
+  };
+
+  Writer _writer;
 };
 
 class SHCORE_PUBLIC Pretty_writer :public Writer_base {
@@ -104,16 +207,31 @@ public:
   virtual void append_uint(unsigned int data) { _writer.Uint(data); }
   virtual void append_uint64(uint64_t data) { _writer.Uint64(data); }
   virtual void append_string(const std::string& data) { _writer.String(data.c_str(), unsigned(data.length())); }
+  virtual void append_string(const char *data, size_t length) { _writer.String(data, unsigned(length)); }
   virtual void append_float(double data) { _writer.Double(data); }
 
 private:
-  rapidjson::PrettyWriter<SStream>_writer;
+  class Writer : public rapidjson::PrettyWriter<SStream> {
+  public:
+    Writer(SStream &stream) : rapidjson::PrettyWriter<SStream>(stream) {}
+    bool String(const char *str, rapidjson::SizeType length) {
+      PrettyPrefix(rapidjson::kStringType);
+      write_json_string(*os_, str, length);
+      return true;
+    }
+  };
+
+  Writer _writer;
 };
 
+#define JSON_DUMPER_CHUNK_SIZE 16384
+
 struct Value;
 class SHCORE_PUBLIC JSON_dumper {
 public:
   JSON_dumper(bool pprint = false);
+  // Streams the generated JSON to output in chunks of chunk_size bytes
+  JSON_dumper(bool pprint, const Writer_base::Output_handler &output, size_t chunk_size = JSON_DUMPER_CHUNK_SIZE);
   virtual ~JSON_dumper();
 
   void start_array() { _deep_level++;  _writer->start_array(); }
@@ -144,6 +262,8 @@ public:
 
   void append_string(const std::string& data)const;
   void append_string(const std::string& key, const std::string& data)const;
+  // The string is written from data as it is, no copy of it is made
+  void append_string(const std::string& key, const char *data, size_t length)const;
 
   void append_float(double data)const;
   void append_float(const std::string& key, double data)const;
@@ -154,6 +274,9 @@ public:
     return _writer->str();
   }
 
+  // Sends the pending data to the output when streaming
+  void flush() { _writer->flush(); }
+
 private:
   int _deep_level;
 
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_json_scan.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace shcore {
+namespace {
+bool is_separator(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',';
+}
+
+size_t skip_separators(const char *data, size_t size, size_t offset) {
+  while (offset < size && is_separator(data[offset]))
+    offset++;
+  return offset;
+}
+
+// Returns the offset following the string starting at offset, memchr()
+// finds the quotes, which end the string unless escaped
+size_t find_string_end(const char *data, size_t size, size_t offset) {
+  size_t next = offset + 1;
+  while (next < size) {
+    const char *quote = static_cast<const char*>(memchr(data + next, '"', size - next));
+    if (!quote)
+      break;
+
+    size_t backslashes = 0;
+    while (quote - backslashes - 1 >= data + next && quote[-static_cast<ptrdiff_t>(backslashes) - 1] == '\\')
+      backslashes++;
+
+    next = static_cast<size_t>(quote - data) + 1;
+    if (backslashes % 2 == 0)
+      return next;
+  }
+
+  throw std::runtime_error("Unterminated JSON string at offset " + std::to_string(offset));
+}
+}
+
+size_t find_json_value_end(const char *data, size_t size, size_t offset, bool *has_id) {
+  *has_id = false;
+
+  if (offset >= size)
+    throw std::runtime_error("Missing JSON value at offset " + std::to_string(offset));
+
+  char first = data[offset];
+  if (first == '"')
+    return find_string_end(data, size, offset);
+
+  // Scalars end on the next separator or the end of the enclosing array
+  if (first != '{' && first != '[') {
+    size_t next = offset;
+    while (next < size && !is_separator(data[next]) && data[next] != ']' && data[next] != '}')
+      next++;
+    return next;
+  }
+
+  // The strings of the object following a { or a , at its top level are
+  // the keys of its members
+  bool is_object = first == '{';
+  bool key_expected = is_object;
+  int depth = 1;
+  size_t next = offset + 1;
+  while (next < size) {
+    char c = data[next];
+    if (c == '"') {
+      size_t end = find_string_end(data, size, next);
+      if (depth == 1 && key_expected) {
+        if (end - next == 5 && memcmp(data + next, "\"_id\"", 5) == 0)
+          *has_id = true;
+        key_expected = false;
+      }
+      next = end;
+      continue;
+    }
+
+    if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0)
+        return next + 1;
+    } else if (c == ',' && depth == 1) {
+      key_expected = is_object;
+    }
+    next++;
+  }
+
+  throw std::runtime_error("Unterminated JSON document at offset " + std::to_string(offset));
+}
+
+std::vector<std::pair<size_t, size_t> > split_json_documents(const char *data, size_t size, size_t chunk_size) {
+  std::vector<std::pair<size_t, size_t> > chunks;
+
+  size_t offset = skip_separators(data, size, 0);
+  bool in_array = offset < size && data[offset] == '[';
+  if (in_array)
+    offset++;
+
+  size_t chunk_start = offset;
+  size_t chunk_end = offset;
+  bool has_id;
+  while ((offset = skip_separators(data, size, offset)) < size) {
+    if (in_array && data[offset] == ']') {
+      in_array = false;
+      if (skip_separators(data, size, offset + 1) != size)
+        throw std::runtime_error("Unexpected data after the JSON array at offset " + std::to_string(offset + 1));
+      break;
+    }
+
+    offset = chunk_end = find_json_value_end(data, size, offset, &has_id);
+    if (chunk_end - chunk_start >= chunk_size) {
+      chunks.push_back(std::make_pair(chunk_start, chunk_end - chunk_start));
+      chunk_start = chunk_end;
+    }
+  }
+
+  if (in_array)
+    throw std::runtime_error("Unterminated JSON array");
+
+  if (chunk_end > chunk_start)
+    chunks.push_back(std::make_pair(chunk_start, chunk_end - chunk_start));
+
+  return chunks;
+}
+
+bool Json_document_reader::next(const char **document, size_t *length, bool *has_id) {
+  _offset = skip_separators(_data, _size, _offset);
+  if (_offset >= _size)
+    return false;
+
+  size_t end = find_json_value_end(_data, _size, _offset, has_id);
+  *document = _data + _offset;
+  *length = end - _offset;
+  _offset = end;
+
+  return true;
+}
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_JSON_SCAN_H_
+#define _UTILS_JSON_SCAN_H_
+
+#include "shellcore/common.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace shcore {
+// The documents of a JSON file, either one after the other (NDJSON) or the
+// elements of a top level array, are found following only the structure of
+// the data: strings and nesting. The documents are not validated, that is
+// left to whoever parses them.
+
+// Returns the offset following the JSON value starting at offset, has_id
+// tells whether the value is an object with a top level _id member. Throws
+// std::runtime_error when the value does not end.
+size_t SHCORE_PUBLIC find_json_value_end(const char *data, size_t size, size_t offset, bool *has_id);
+
+// Splits the documents of the data in consecutive ranges (offset, length) of
+// at least chunk_size bytes, except the last one, each holding whole
+// documents separated by whitespace or commas
+std::vector<std::pair<size_t, size_t> > SHCORE_PUBLIC split_json_documents(const char *data, size_t size,
+                                                                           size_t chunk_size);
+
+// Reads the documents of a range given by split_json_documents
+class SHCORE_PUBLIC Json_document_reader {
+public:
+  Json_document_reader(const char *data, size_t size) : _data(data), _size(size), _offset(0) {}
+
+  // Returns false when there are no more documents
+  bool next(const char **document, size_t *length, bool *has_id);
+
+private:
+  const char *_data;
+  size_t _size;
+  size_t _offset;
+};
+}
+
+#endif
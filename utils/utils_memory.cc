@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_memory.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef WIN32
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#else
+#  include <unistd.h>
+#  ifdef __linux__
+#    include <malloc.h>
+#  endif
+#endif
+
+namespace shcore {
+namespace {
+std::string megabytes(uint64_t bytes) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.1f MB", static_cast<double>(bytes) / (1024 * 1024));
+  return text;
+}
+}
+
+Memory_budget::Memory_budget() : _limit(0), _total(0), _peak(0) {
+  for (auto &used : _used)
+    used = 0;
+}
+
+Memory_budget &Memory_budget::get() {
+  static Memory_budget budget;
+  return budget;
+}
+
+bool Memory_budget::reserve(Subsystem subsystem, uint64_t size) {
+  uint64_t total = _total.fetch_add(size) + size;
+  uint64_t limit = _limit;
+  if (limit && total > limit) {
+    _total -= size;
+    return false;
+  }
+
+  _used[subsystem] += size;
+  update_peak(total);
+  return true;
+}
+
+void Memory_budget::release(Subsystem subsystem, uint64_t size) {
+  _used[subsystem] -= size;
+  _total -= size;
+}
+
+void Memory_budget::update(Subsystem subsystem, uint64_t previous, uint64_t current) {
+  _used[subsystem] += current - previous;
+  update_peak(_total += current - previous);
+}
+
+void Memory_budget::update_peak(uint64_t total) {
+  uint64_t peak = _peak;
+  while (total > peak && !_peak.compare_exchange_weak(peak, total)) {
+  }
+}
+
+std::string Memory_budget::exceeded_message(Subsystem subsystem) const {
+  std::string message = "The memory budget of " + megabytes(_limit) + " was exceeded by the " + name(subsystem) + " (";
+  for (int index = 0; index < Subsystem_count; index++) {
+    if (index)
+      message += ", ";
+    message += std::string(name(static_cast<Subsystem>(index))) + ": " + megabytes(_used[index]);
+  }
+
+  return message + ")";
+}
+
+const char *Memory_budget::name(Subsystem subsystem) {
+  switch (subsystem) {
+    case Results:
+      return "buffered results";
+    case Values:
+      return "result values";
+    case JavaScript:
+      return "JavaScript heap";
+    default:
+      return "unknown";
+  }
+}
+
+void Memory_reservation::add(uint64_t size) {
+  Memory_budget &budget = Memory_budget::get();
+  if (!budget.reserve(_subsystem, size))
+    throw std::runtime_error(budget.exceeded_message(_subsystem));
+
+  _size += size;
+}
+
+uint64_t resident_memory() {
+#ifdef WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return counters.WorkingSetSize;
+  return 0;
+#elif defined(__APPLE__)
+  mach_task_basic_info info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+    return info.resident_size;
+  return 0;
+#else
+  // The second field of statm is the resident size in pages
+  FILE *statm = std::fopen("/proc/self/statm", "r");
+  if (!statm)
+    return 0;
+
+  unsigned long long size = 0, resident = 0;
+  int count = std::fscanf(statm, "%llu %llu", &size, &resident);
+  std::fclose(statm);
+
+  return count == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
+
+void trim_heap() {
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+}
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_MEMORY_H_
+#define _UTILS_MEMORY_H_
+
+#include "shellcore/common.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace shcore {
+// The memory budget of the process, shared by the subsystems that may hold
+// large amounts of data. Each one accounts what it keeps: the buffered
+// results reserve their rows (spilling to disk the ones that do not fit),
+// the results converted to values reserve them while they are built and
+// the JavaScript heap reports its size after every garbage collection.
+// A limit of 0 is no limit, the usage is accounted anyway.
+class SHCORE_PUBLIC Memory_budget {
+public:
+  enum Subsystem { Results, Values, JavaScript, Subsystem_count };
+
+  static Memory_budget &get();
+
+  void set_limit(uint64_t bytes) { _limit = bytes; }
+  uint64_t limit() const { return _limit; }
+
+  // Adds the bytes to the subsystem if they fit in the budget
+  bool reserve(Subsystem subsystem, uint64_t size);
+  void release(Subsystem subsystem, uint64_t size);
+
+  // Follows a usage measured as a whole, like a heap, which changed from
+  // previous to current bytes. Never fails, exceeded() tells whether it fits.
+  void update(Subsystem subsystem, uint64_t previous, uint64_t current);
+
+  uint64_t used(Subsystem subsystem) const { return _used[subsystem]; }
+  uint64_t used() const { return _total; }
+  uint64_t peak() const { return _peak; }
+  bool exceeded() const { return _limit && _total > _limit; }
+
+  // Describes the budget and what uses it, for the errors of the subsystems
+  // that go past it
+  std::string exceeded_message(Subsystem subsystem) const;
+
+  static const char *name(Subsystem subsystem);
+
+private:
+  Memory_budget();
+  Memory_budget(const Memory_budget &) = delete;
+  Memory_budget &operator = (const Memory_budget &) = delete;
+
+  void update_peak(uint64_t total);
+
+  std::atomic<uint64_t> _limit;
+  std::atomic<uint64_t> _total;
+  std::atomic<uint64_t> _peak;
+  std::atomic<uint64_t> _used[Subsystem_count];
+};
+
+// Memory reserved while some data is built, released when it goes out of
+// scope. Throws once the data does not fit in the budget.
+class SHCORE_PUBLIC Memory_reservation {
+public:
+  explicit Memory_reservation(Memory_budget::Subsystem subsystem) : _subsystem(subsystem), _size(0) {}
+  ~Memory_reservation() { Memory_budget::get().release(_subsystem, _size); }
+
+  void add(uint64_t size);
+
+private:
+  Memory_reservation(const Memory_reservation &) = delete;
+  Memory_reservation &operator = (const Memory_reservation &) = delete;
+
+  Memory_budget::Subsystem _subsystem;
+  uint64_t _size;
+};
+
+// The resident set size of the process, 0 where it is not known
+uint64_t SHCORE_PUBLIC resident_memory();
+
+// Gives the free memory of the heap back to the system, where the allocator
+// would keep it otherwise (i.e. after a large result was released)
+void SHCORE_PUBLIC trim_heap();
+}
+
+#endif
@@ -20,6 +20,17 @@
 #include "utils_mysql_parsing.h"
 #include <boost/algorithm/string/trim.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define SPLITTER_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SPLITTER_NEON 1
+#endif
+
 namespace shcore {
 namespace mysql {
 namespace splitter {
@@ -97,6 +108,112 @@ bool is_line_break(const unsigned char *head, const unsigned char *line_break) {
 
 //--------------------------------------------------------------------------------------------------
 
+#ifdef SPLITTER_SSE2
+static inline unsigned first_bit(unsigned mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/**
+ * Returns the first position from head holding one of the given bytes, or the end if none does.
+ * If content is given it is set when any of the bytes skipped is not a blank.
+ *
+ * Most of a script is text the splitter has nothing to do with (values, names, comments), so it
+ * is looked through 16 bytes at a time where the cpu allows it.
+ */
+static const unsigned char *find_any(const unsigned char *head, const unsigned char *end,
+                                     const std::string &bytes, bool *content) {
+#if defined(SPLITTER_SSE2)
+  if (bytes.size() <= 16) {
+    __m128i needles[16];
+    for (size_t index = 0; index < bytes.size(); index++)
+      needles[index] = _mm_set1_epi8(bytes[index]);
+    const __m128i space = _mm_set1_epi8(' ');
+
+    while (end - head >= 16) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(head));
+      __m128i found = _mm_setzero_si128();
+      for (size_t index = 0; index < bytes.size(); index++)
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, needles[index]));
+
+      unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(found));
+      if (mask) {
+        if (!content || *content)
+          return head + first_bit(mask);
+
+        // The blanks before the match are left to the byte loop below
+        break;
+      }
+
+      if (content && !*content &&
+          _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space)) != 0xFFFF)
+        *content = true;
+
+      head += 16;
+    }
+  }
+#elif defined(SPLITTER_NEON)
+  if (bytes.size() <= 16) {
+    uint8x16_t needles[16];
+    for (size_t index = 0; index < bytes.size(); index++)
+      needles[index] = vdupq_n_u8(static_cast<unsigned char>(bytes[index]));
+
+    while (end - head >= 16) {
+      uint8x16_t chunk = vld1q_u8(head);
+      uint8x16_t found = vdupq_n_u8(0);
+      for (size_t index = 0; index < bytes.size(); index++)
+        found = vorrq_u8(found, vceqq_u8(chunk, needles[index]));
+
+      // The exact position is left to the byte loop below
+      if (vmaxvq_u8(found))
+        break;
+
+      if (content && vmaxvq_u8(chunk) > ' ')
+        *content = true;
+
+      head += 16;
+    }
+  }
+#endif
+
+  for (; head < end; head++) {
+    if (bytes.find(static_cast<char>(*head)) != std::string::npos)
+      return head;
+
+    if (content && *head > ' ')
+      *content = true;
+  }
+
+  return head;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+ * Returns the position of the next line break from head, or the end if there is none.
+ */
+static const unsigned char *find_line_break(const unsigned char *head, const unsigned char *end,
+                                            const unsigned char *line_break) {
+  const std::string first(1, static_cast<char>(*line_break));
+
+  while (head < end) {
+    head = find_any(head, end, first, nullptr);
+    if (head < end && is_line_break(head, line_break))
+      break;
+    head++;
+  }
+
+  return head < end ? head : end;
+}
+
+//--------------------------------------------------------------------------------------------------
+
 /**
  * A statement splitter to take a list of sql statements and split them into individual statements,
  * return their position and length in the original string (instead the copied strings).
@@ -115,9 +232,32 @@ std::vector<Statement_range> determineStatementRanges(
   const unsigned char *new_line = (unsigned char*)line_break.c_str();
   bool have_content = false; // Set when anything else but comments were found for the current statement.
 
+  // The bytes that start something the loop below handles, plus the first byte of each delimiter.
+  // Any other byte only counts as content of the statement, so the runs of them are skipped at once.
+  const std::string syntax_bytes = "*/-#\"'`dD";
+  std::string special_bytes;
+  auto update_special_bytes = [&]() {
+    special_bytes = syntax_bytes;
+    for (size_t index = 0; index < delimiters.size(); index++) {
+      const char first = delimiters[index][0];
+      if (special_bytes.find(first) == std::string::npos)
+        special_bytes += first;
+    }
+  };
+  update_special_bytes();
+
+  const std::string quote_bytes[] = { "\"\\", "'\\", "`" };
+
   std::vector<Statement_range> ranges;
 
   while (tail < end) {
+    bool content = false;
+    tail = find_any(tail, end, special_bytes, have_content ? nullptr : &content);
+    if (content && (input_context_stack.empty() || input_context_stack.top() != "/*"))
+      have_content = true;
+    if (tail >= end)
+      break;
+
     switch (*tail) {
       case '*': // Comes from a multiline comment and comment is done
         if (*(tail + 1) == '/' && !input_context_stack.empty()) {
@@ -145,8 +285,7 @@ std::vector<Statement_range> determineStatementRanges(
             context.append("+");
 
           while (true) {
-            while (tail < end && *tail != '*')
-              tail++;
+            tail = find_any(tail, end, "*", nullptr);
             if (tail == end) // Unfinished comment.
             {
               // If valid content was found before the comment
@@ -194,9 +333,7 @@ std::vector<Statement_range> determineStatementRanges(
 
 
           // Skip everything until the end of the line.
-          tail += 2;
-          while (tail < end && !is_line_break(tail, new_line))
-            tail++;
+          tail = find_line_break(tail + 2, end, new_line);
 
           head = tail;
         }
@@ -214,8 +351,7 @@ std::vector<Statement_range> determineStatementRanges(
           have_content = false;
         }
 
-        while (tail < end && !is_line_break(tail, new_line))
-          tail++;
+        tail = find_line_break(tail, end, new_line);
 
         head = tail;
         break;
@@ -230,7 +366,12 @@ std::vector<Statement_range> determineStatementRanges(
         if (input_context_stack.empty() || input_context_stack.top() == "-" ||
             input_context_stack.top() == "/*!") {
           // Quoted string/id. Skip this in a local loop if is opening quote.
+          const std::string &stops = quote_bytes[quote == '"' ? 0 : quote == '\'' ? 1 : 2];
           while (tail < end ) {
+            tail = find_any(tail, end, stops, nullptr);
+            if (tail >= end)
+              break;
+
             // Handle consecutive double quotes within a quoted string (for ' and ")
             // Consecutive double quotes for identifiers should not be handled, i. e., in case of `
             // See http://dev.mysql.com/doc/refman/5.7/en/string-literals.html#character-escape-sequences
@@ -288,6 +429,7 @@ std::vector<Statement_range> determineStatementRanges(
             std::string delimiter = std::string((char *)tail, run - tail);
             boost::trim(delimiter);
             delimiters.set_main_delimiter(delimiter);
+            update_special_bytes();
 
             // Skip over the delimiter statement and any following line breaks.
             while (is_line_break(run, new_line))
@@ -0,0 +1,716 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_parquet.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace shcore {
+namespace {
+// Enumerations of parquet.thrift in the Parquet format sources
+enum Physical_type { Type_int64 = 2, Type_double = 5, Type_byte_array = 6 };
+enum Converted_type { Converted_utf8 = 0, Converted_uint64 = 14, Converted_json = 19 };
+enum Repetition { Repetition_optional = 1 };
+enum Encoding { Encoding_plain = 0, Encoding_plain_dictionary = 2, Encoding_rle = 3 };
+enum Codec { Codec_uncompressed = 0, Codec_gzip = 2 };
+enum Page_type { Page_data = 0, Page_dictionary = 2 };
+
+// Pages end once they reach either limit
+const size_t k_page_rows = 20000;
+const size_t k_page_size = 1024 * 1024;
+
+// Columns with more distinct values than this, or more than half of their
+// values distinct, are written plain
+const size_t k_max_dictionary_values = 65535;
+const size_t k_max_dictionary_size = 1024 * 1024;
+
+// Longer minimums and maximums are not written to the statistics
+const size_t k_max_statistics_size = 256;
+
+// The Thrift compact protocol, in which the page headers and the footer of
+// the file are written. Fields are written in the order of their ids.
+class Thrift_writer {
+public:
+  enum Type : uint8_t { Bool_true = 1, Bool_false = 2, I32 = 5, I64 = 6, Binary = 8, List = 9, Struct = 12 };
+
+  Thrift_writer() : _last_ids(1, 0) {}
+
+  void field_i32(int16_t id, int32_t value) {
+    field(id, I32);
+    varint(zigzag(value));
+  }
+
+  void field_i64(int16_t id, int64_t value) {
+    field(id, I64);
+    varint(zigzag(value));
+  }
+
+  void field_binary(int16_t id, const std::string &value) {
+    field(id, Binary);
+    binary(value);
+  }
+
+  void begin_struct(int16_t id) {
+    field(id, Struct);
+    _last_ids.push_back(0);
+  }
+
+  void begin_list(int16_t id, Type type, size_t size) {
+    field(id, List);
+    if (size < 15) {
+      _data.push_back(static_cast<char>((size << 4) | type));
+    } else {
+      _data.push_back(static_cast<char>(0xF0 | type));
+      varint(size);
+    }
+  }
+
+  void list_i32(int32_t value) {
+    varint(zigzag(value));
+  }
+
+  void list_binary(const std::string &value) {
+    binary(value);
+  }
+
+  // A struct that is an element of a list
+  void begin_element() {
+    _last_ids.push_back(0);
+  }
+
+  void end_struct() {
+    _data.push_back('\0');
+    _last_ids.pop_back();
+  }
+
+  // Ends the outer struct
+  const std::string &finish() {
+    _data.push_back('\0');
+    return _data;
+  }
+
+private:
+  static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  }
+
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      _data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    _data.push_back(static_cast<char>(value));
+  }
+
+  void binary(const std::string &value) {
+    varint(value.size());
+    _data.append(value);
+  }
+
+  void field(int16_t id, Type type) {
+    int16_t delta = id - _last_ids.back();
+    if (delta > 0 && delta <= 15) {
+      _data.push_back(static_cast<char>((delta << 4) | type));
+    } else {
+      _data.push_back(static_cast<char>(type));
+      varint(zigzag(id));
+    }
+    _last_ids.back() = id;
+  }
+
+  std::string _data;
+  std::vector<int16_t> _last_ids;
+};
+
+// The RLE / bit packing hybrid encoding of the definition levels and the
+// dictionary indexes: runs of 8 or more repeated values are written as
+// RLE runs, the rest bit packed in groups of 8
+void encode_hybrid(const uint32_t *values, size_t count, int bit_width, std::string *out) {
+  auto varint = [out](uint64_t value) {
+    while (value >= 0x80) {
+      out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+  };
+
+  auto repeated = [values, count](size_t start, size_t limit) {
+    size_t run = 1;
+    while (start + run < count && run < limit && values[start + run] == values[start])
+      run++;
+    return run;
+  };
+
+  size_t index = 0;
+  while (index < count) {
+    size_t run = repeated(index, count);
+    if (run >= 8) {
+      varint(static_cast<uint64_t>(run) << 1);
+      for (int byte = 0; byte < (bit_width + 7) / 8; byte++)
+        out->push_back(static_cast<char>(values[index] >> (byte * 8)));
+      index += run;
+      continue;
+    }
+
+    // Groups of 8 up to the next run, the last group is padded with zeros
+    size_t start = index;
+    size_t groups = 0;
+    do {
+      index = std::min(index + 8, count);
+      groups++;
+    } while (index < count && repeated(index, 8) < 8);
+
+    varint((static_cast<uint64_t>(groups) << 1) | 1);
+    uint64_t bits = 0;
+    int pending = 0;
+    for (size_t position = start; position < start + groups * 8; position++) {
+      bits |= static_cast<uint64_t>(position < count ? values[position] : 0) << pending;
+      pending += bit_width;
+      while (pending >= 8) {
+        out->push_back(static_cast<char>(bits & 0xFF));
+        bits >>= 8;
+        pending -= 8;
+      }
+    }
+  }
+}
+
+#ifdef HAVE_ZLIB
+std::string gzip(const std::string &data) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+
+  // 16 added to the window bits writes the gzip header and trailer
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    throw std::runtime_error("Unable to initialize the compression");
+
+  std::string compressed(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = static_cast<uInt>(compressed.size());
+
+  int rc = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  if (rc != Z_STREAM_END)
+    throw std::runtime_error("Unable to compress the Parquet page");
+
+  return compressed;
+}
+#endif
+
+bool is_fixed(Parquet_writer::Type type) {
+  return type == Parquet_writer::Type::Int64 || type == Parquet_writer::Type::UInt64 ||
+         type == Parquet_writer::Type::Double;
+}
+
+Physical_type physical_type(Parquet_writer::Type type) {
+  switch (type) {
+    case Parquet_writer::Type::Int64:
+    case Parquet_writer::Type::UInt64:
+      return Type_int64;
+    case Parquet_writer::Type::Double:
+      return Type_double;
+    default:
+      return Type_byte_array;
+  }
+}
+
+// The values of a column that are not null
+struct Column_values {
+  Parquet_writer::Type type;
+  const uint8_t *nulls;
+  size_t rows;
+  const uint64_t *numbers;
+  const size_t *offsets;
+  const char *data;
+  size_t count;
+
+  const char *value(size_t index, size_t *size) const {
+    if (is_fixed(type)) {
+      *size = sizeof(uint64_t);
+      return reinterpret_cast<const char*>(numbers + index);
+    }
+
+    *size = offsets[index + 1] - offsets[index];
+    return data + offsets[index];
+  }
+
+  void append_plain(size_t index, std::string *out) const {
+    size_t size;
+    const char *bytes = value(index, &size);
+    if (!is_fixed(type)) {
+      uint32_t length = static_cast<uint32_t>(size);
+      out->append(reinterpret_cast<const char*>(&length), sizeof(length));
+    }
+    out->append(bytes, size);
+  }
+
+  // Whether the value at index sorts before the one at other
+  bool less(size_t index, size_t other) const {
+    switch (type) {
+      case Parquet_writer::Type::Int64:
+        return static_cast<int64_t>(numbers[index]) < static_cast<int64_t>(numbers[other]);
+      case Parquet_writer::Type::UInt64:
+        return numbers[index] < numbers[other];
+      case Parquet_writer::Type::Double: {
+        double a, b;
+        memcpy(&a, numbers + index, sizeof(a));
+        memcpy(&b, numbers + other, sizeof(b));
+        return a < b;
+      }
+      default: {
+        size_t a_size, b_size;
+        const char *a = value(index, &a_size);
+        const char *b = value(other, &b_size);
+        int cmp = memcmp(a, b, std::min(a_size, b_size));
+        return cmp < 0 || (cmp == 0 && a_size < b_size);
+      }
+    }
+  }
+
+  bool is_nan(size_t index) const {
+    if (type != Parquet_writer::Type::Double)
+      return false;
+
+    double number;
+    memcpy(&number, numbers + index, sizeof(number));
+    return std::isnan(number);
+  }
+};
+
+struct Chunk_metadata {
+  Physical_type type;
+  std::string path;
+  Codec codec;
+  std::vector<int32_t> encodings;
+  int64_t num_values;
+  int64_t uncompressed_size;
+  int64_t compressed_size;
+  int64_t data_page_offset;
+  int64_t dictionary_page_offset;   // -1 when there is no dictionary
+  int64_t null_count;
+  bool has_min_max;
+  std::string min;
+  std::string max;
+};
+
+void write_statistics(const Column_values &values, Chunk_metadata *metadata) {
+  metadata->null_count = static_cast<int64_t>(values.rows - values.count);
+  metadata->has_min_max = false;
+
+  size_t min = values.count;
+  size_t max = values.count;
+  for (size_t index = 0; index < values.count; index++) {
+    if (values.is_nan(index))
+      continue;
+
+    if (min == values.count || values.less(index, min))
+      min = index;
+    if (max == values.count || values.less(max, index))
+      max = index;
+  }
+
+  if (min == values.count)
+    return;
+
+  size_t min_size, max_size;
+  const char *min_value = values.value(min, &min_size);
+  const char *max_value = values.value(max, &max_size);
+  if (min_size > k_max_statistics_size || max_size > k_max_statistics_size)
+    return;
+
+  metadata->has_min_max = true;
+  metadata->min.assign(min_value, min_size);
+  metadata->max.assign(max_value, max_size);
+}
+
+struct Page {
+  Page_type type;
+  int32_t num_values;
+  Encoding encoding;
+  std::string body;
+};
+
+// The pages of a column chunk, the dictionary first if it is used
+std::vector<Page> column_pages(const Column_values &values) {
+  std::vector<Page> pages;
+
+  std::vector<uint32_t> indexes;
+  std::unordered_map<std::string, uint32_t> ids;
+  Page dictionary = { Page_dictionary, 0, Encoding_plain_dictionary, std::string() };
+  bool use_dictionary = values.count > 0;
+
+  indexes.reserve(values.count);
+  for (size_t index = 0; index < values.count && use_dictionary; index++) {
+    size_t size;
+    const char *value = values.value(index, &size);
+    auto id = ids.emplace(std::string(value, size), static_cast<uint32_t>(ids.size()));
+    if (id.second) {
+      values.append_plain(index, &dictionary.body);
+      if (ids.size() > k_max_dictionary_values || dictionary.body.size() > k_max_dictionary_size)
+        use_dictionary = false;
+    }
+    indexes.push_back(id.first->second);
+  }
+
+  if (use_dictionary && ids.size() * 2 > values.count + 1)
+    use_dictionary = false;
+
+  int bit_width = 1;
+  if (use_dictionary) {
+    while (bit_width < 32 && (static_cast<uint64_t>(1) << bit_width) < ids.size())
+      bit_width++;
+
+    dictionary.num_values = static_cast<int32_t>(ids.size());
+    pages.push_back(std::move(dictionary));
+  }
+
+  size_t row = 0;
+  size_t next_value = 0;
+  std::vector<uint32_t> levels;
+  while (row < values.rows || pages.empty()) {
+    // Definition levels, 1 for the values that are not null
+    size_t first_value = next_value;
+    size_t page_size = 0;
+    levels.clear();
+    while (row < values.rows && levels.size() < k_page_rows && page_size < k_page_size) {
+      bool is_null = values.nulls[row++] != 0;
+      levels.push_back(is_null ? 0 : 1);
+      if (!is_null) {
+        size_t size;
+        values.value(next_value++, &size);
+        page_size += size + 4;
+      }
+    }
+
+    Page page = { Page_data, static_cast<int32_t>(levels.size()),
+                  use_dictionary ? Encoding_plain_dictionary : Encoding_plain, std::string() };
+
+    std::string encoded_levels;
+    encode_hybrid(levels.data(), levels.size(), 1, &encoded_levels);
+    uint32_t levels_size = static_cast<uint32_t>(encoded_levels.size());
+    page.body.append(reinterpret_cast<const char*>(&levels_size), sizeof(levels_size));
+    page.body.append(encoded_levels);
+
+    if (use_dictionary) {
+      page.body.push_back(static_cast<char>(bit_width));
+      encode_hybrid(indexes.data() + first_value, next_value - first_value, bit_width, &page.body);
+    } else {
+      for (size_t index = first_value; index < next_value; index++)
+        values.append_plain(index, &page.body);
+    }
+
+    pages.push_back(std::move(page));
+  }
+
+  return pages;
+}
+
+std::string page_header(const Page &page, size_t compressed_size) {
+  Thrift_writer header;
+  header.field_i32(1, page.type);
+  header.field_i32(2, static_cast<int32_t>(page.body.size()));
+  header.field_i32(3, static_cast<int32_t>(compressed_size));
+
+  if (page.type == Page_data) {
+    header.begin_struct(5);
+    header.field_i32(1, page.num_values);
+    header.field_i32(2, page.encoding);
+    header.field_i32(3, Encoding_rle);
+    header.field_i32(4, Encoding_rle);
+    header.end_struct();
+  } else {
+    header.begin_struct(7);
+    header.field_i32(1, page.num_values);
+    header.field_i32(2, page.encoding);
+    header.end_struct();
+  }
+
+  return header.finish();
+}
+
+// Appends the column chunk to the data, with the offsets of its pages
+// relative to the start of the data
+void encode_column(const Parquet_writer::Column &column, const Column_values &values, bool gzip_pages,
+                   std::string *data, Chunk_metadata *metadata) {
+  metadata->type = physical_type(column.type);
+  metadata->path = column.name;
+  metadata->num_values = static_cast<int64_t>(values.rows);
+  metadata->dictionary_page_offset = -1;
+  write_statistics(values, metadata);
+
+  std::vector<Page> pages = column_pages(values);
+
+  // The chunk is only compressed if that saves at least a tenth of it
+  std::vector<std::string> compressed(pages.size());
+  metadata->codec = Codec_uncompressed;
+#ifdef HAVE_ZLIB
+  if (gzip_pages) {
+    size_t plain_size = 0;
+    size_t compressed_size = 0;
+    for (size_t index = 0; index < pages.size(); index++) {
+      compressed[index] = gzip(pages[index].body);
+      plain_size += pages[index].body.size();
+      compressed_size += compressed[index].size();
+    }
+
+    if (compressed_size < plain_size - plain_size / 10)
+      metadata->codec = Codec_gzip;
+  }
+#endif
+
+  metadata->uncompressed_size = 0;
+  metadata->compressed_size = 0;
+  for (size_t index = 0; index < pages.size(); index++) {
+    const Page &page = pages[index];
+    const std::string &body = metadata->codec == Codec_gzip ? compressed[index] : page.body;
+    std::string header = page_header(page, body.size());
+
+    if (page.type == Page_dictionary)
+      metadata->dictionary_page_offset = static_cast<int64_t>(data->size());
+    else if (index == 0 || pages[index - 1].type == Page_dictionary)
+      metadata->data_page_offset = static_cast<int64_t>(data->size());
+
+    data->append(header);
+    data->append(body);
+    metadata->uncompressed_size += static_cast<int64_t>(header.size() + page.body.size());
+    metadata->compressed_size += static_cast<int64_t>(header.size() + body.size());
+  }
+
+  if (metadata->dictionary_page_offset >= 0)
+    metadata->encodings = { Encoding_plain_dictionary, Encoding_rle };
+  else
+    metadata->encodings = { Encoding_plain, Encoding_rle };
+}
+
+const char k_magic[] = "PAR1";
+}
+
+struct Parquet_writer::Encoded_row_group {
+  std::string data;
+  uint64_t rows;
+  std::vector<Chunk_metadata> chunks;
+};
+
+struct Parquet_writer::Written_row_group {
+  uint64_t rows;
+  int64_t file_offset;
+  int64_t total_byte_size;
+  int64_t compressed_size;
+  std::vector<Chunk_metadata> chunks;
+};
+
+Parquet_writer::Parquet_writer(const std::vector<Column> &columns, const std::string &compression, const Output &output)
+  : _columns(columns), _gzip(compression == "gzip"), _output(output), _offset(0), _rows(0) {
+  if (!is_compression_supported(compression))
+    throw std::runtime_error("The compression '" + compression + "' is not supported");
+
+  _output(k_magic, 4);
+  _offset = 4;
+}
+
+Parquet_writer::~Parquet_writer() {}
+
+std::shared_ptr<Parquet_writer::Encoded_row_group> Parquet_writer::encode(const Parquet_row_group &group) const {
+  auto encoded = std::make_shared<Encoded_row_group>();
+  encoded->rows = group.rows();
+  if (!group.rows())
+    return encoded;
+
+  encoded->chunks.resize(_columns.size());
+  for (size_t index = 0; index < _columns.size(); index++) {
+    const Parquet_row_group::Column_data &data = group._columns[index];
+    Column_values values = { _columns[index].type, data.nulls.data(), group.rows(), data.numbers.data(),
+                             data.offsets.data(), data.data.data(),
+                             is_fixed(_columns[index].type) ? data.numbers.size() : data.offsets.size() - 1 };
+    encode_column(_columns[index], values, _gzip, &encoded->data, &encoded->chunks[index]);
+  }
+
+  return encoded;
+}
+
+void Parquet_writer::write(const Encoded_row_group &group) {
+  if (!group.rows)
+    return;
+
+  std::unique_ptr<Written_row_group> written(new Written_row_group());
+  written->rows = group.rows;
+  written->file_offset = static_cast<int64_t>(_offset);
+  written->total_byte_size = 0;
+  written->compressed_size = static_cast<int64_t>(group.data.size());
+  written->chunks = group.chunks;
+
+  for (auto &chunk : written->chunks) {
+    chunk.data_page_offset += written->file_offset;
+    if (chunk.dictionary_page_offset >= 0)
+      chunk.dictionary_page_offset += written->file_offset;
+    written->total_byte_size += chunk.uncompressed_size;
+  }
+
+  _output(group.data.data(), group.data.size());
+  _offset += group.data.size();
+  _rows += group.rows;
+  _row_groups.push_back(std::move(written));
+}
+
+void Parquet_writer::finish() {
+  Thrift_writer footer;
+  footer.field_i32(1, 1);
+
+  // The schema is a root element with the columns as its children
+  footer.begin_list(2, Thrift_writer::Struct, _columns.size() + 1);
+  footer.begin_element();
+  footer.field_binary(4, "schema");
+  footer.field_i32(5, static_cast<int32_t>(_columns.size()));
+  footer.end_struct();
+  for (auto &column : _columns) {
+    footer.begin_element();
+    footer.field_i32(1, physical_type(column.type));
+    footer.field_i32(3, Repetition_optional);
+    footer.field_binary(4, column.name);
+    if (column.type == Type::Utf8)
+      footer.field_i32(6, Converted_utf8);
+    else if (column.type == Type::Json)
+      footer.field_i32(6, Converted_json);
+    else if (column.type == Type::UInt64)
+      footer.field_i32(6, Converted_uint64);
+    footer.end_struct();
+  }
+
+  footer.field_i64(3, static_cast<int64_t>(_rows));
+
+  footer.begin_list(4, Thrift_writer::Struct, _row_groups.size());
+  for (auto &group : _row_groups) {
+    footer.begin_element();
+    footer.begin_list(1, Thrift_writer::Struct, group->chunks.size());
+    for (auto &chunk : group->chunks) {
+      footer.begin_element();
+      footer.field_i64(2, chunk.dictionary_page_offset >= 0 ? chunk.dictionary_page_offset : chunk.data_page_offset);
+      footer.begin_struct(3);
+      footer.field_i32(1, chunk.type);
+      footer.begin_list(2, Thrift_writer::I32, chunk.encodings.size());
+      for (auto encoding : chunk.encodings)
+        footer.list_i32(encoding);
+      footer.begin_list(3, Thrift_writer::Binary, 1);
+      footer.list_binary(chunk.path);
+      footer.field_i32(4, chunk.codec);
+      footer.field_i64(5, chunk.num_values);
+      footer.field_i64(6, chunk.uncompressed_size);
+      footer.field_i64(7, chunk.compressed_size);
+      footer.field_i64(9, chunk.data_page_offset);
+      if (chunk.dictionary_page_offset >= 0)
+        footer.field_i64(11, chunk.dictionary_page_offset);
+      footer.begin_struct(12);
+      footer.field_i64(3, chunk.null_count);
+      if (chunk.has_min_max) {
+        footer.field_binary(5, chunk.max);
+        footer.field_binary(6, chunk.min);
+      }
+      footer.end_struct();
+      footer.end_struct();
+      footer.end_struct();
+    }
+    footer.field_i64(2, group->total_byte_size);
+    footer.field_i64(3, static_cast<int64_t>(group->rows));
+    footer.field_i64(5, group->file_offset);
+    footer.field_i64(6, group->compressed_size);
+    footer.end_struct();
+  }
+
+  footer.field_binary(6, "mysqlsh");
+
+  // The minimums and maximums follow the order of their types
+  footer.begin_list(7, Thrift_writer::Struct, _columns.size());
+  for (size_t index = 0; index < _columns.size(); index++) {
+    footer.begin_element();
+    footer.begin_struct(1);
+    footer.end_struct();
+    footer.end_struct();
+  }
+
+  const std::string &metadata = footer.finish();
+  uint32_t length = static_cast<uint32_t>(metadata.size());
+  _output(metadata.data(), metadata.size());
+  _output(reinterpret_cast<const char*>(&length), sizeof(length));
+  _output(k_magic, 4);
+}
+
+bool Parquet_writer::is_compression_supported(const std::string &compression) {
+#ifdef HAVE_ZLIB
+  if (compression == "gzip")
+    return true;
+#endif
+  return compression == "none";
+}
+
+Parquet_row_group::Parquet_row_group(const std::vector<Parquet_writer::Column> &columns)
+  : _columns(columns.size()), _rows(0), _data_size(0) {
+  for (auto &column : _columns)
+    column.offsets.push_back(0);
+}
+
+void Parquet_row_group::append_null(size_t column) {
+  _columns[column].nulls.push_back(1);
+}
+
+void Parquet_row_group::append(size_t column, int64_t value) {
+  append(column, static_cast<uint64_t>(value));
+}
+
+void Parquet_row_group::append(size_t column, uint64_t value) {
+  _columns[column].nulls.push_back(0);
+  _columns[column].numbers.push_back(value);
+  _data_size += sizeof(value);
+}
+
+void Parquet_row_group::append(size_t column, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  append(column, bits);
+}
+
+void Parquet_row_group::append(size_t column, const char *data, size_t size) {
+  Column_data &column_data = _columns[column];
+  column_data.nulls.push_back(0);
+  column_data.data.append(data, size);
+  column_data.offsets.push_back(column_data.data.size());
+  _data_size += size;
+}
+
+void Parquet_row_group::clear() {
+  for (auto &column : _columns) {
+    column.nulls.clear();
+    column.numbers.clear();
+    column.offsets.resize(1);
+    column.data.clear();
+  }
+  _rows = 0;
+  _data_size = 0;
+}
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_PARQUET_H_
+#define _UTILS_PARQUET_H_
+
+#include "shellcore/common.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace shcore {
+class Parquet_row_group;
+
+// Writes Apache Parquet files of flat, nullable columns. Every column chunk
+// is dictionary encoded unless it has too many distinct values, and is only
+// compressed if that makes it smaller. The statistics of every column chunk
+// (minimum, maximum and null count) are taken from the values as they are
+// encoded.
+class SHCORE_PUBLIC Parquet_writer {
+public:
+  enum class Type { Int64, UInt64, Double, Utf8, Json, Binary };
+
+  struct Column {
+    Column(const std::string &name, Type type) : name(name), type(type) {}
+
+    std::string name;
+    Type type;
+  };
+
+  typedef std::function<void(const char *data, size_t size)> Output;
+
+  // A row group encoded into its pages, ready to be written
+  struct Encoded_row_group;
+
+  // compression is none or gzip. Writes the header of the file.
+  Parquet_writer(const std::vector<Column> &columns, const std::string &compression, const Output &output);
+  ~Parquet_writer();
+
+  const std::vector<Column> &columns() const { return _columns; }
+
+  // Encoding does not change the writer, so several threads may encode the
+  // row groups they collect while another one writes
+  std::shared_ptr<Encoded_row_group> encode(const Parquet_row_group &group) const;
+  void write(const Encoded_row_group &group);
+  void write(const Parquet_row_group &group) { write(*encode(group)); }
+
+  // Writes the footer with the metadata of the row groups
+  void finish();
+
+  uint64_t rows() const { return _rows; }
+
+  static bool is_compression_supported(const std::string &compression);
+
+private:
+  Parquet_writer(const Parquet_writer &) = delete;
+  Parquet_writer &operator = (const Parquet_writer &) = delete;
+
+  struct Written_row_group;
+
+  std::vector<Column> _columns;
+  bool _gzip;
+  Output _output;
+  uint64_t _offset;
+  uint64_t _rows;
+  std::vector<std::unique_ptr<Written_row_group>> _row_groups;
+};
+
+// Collects the values of a row group one row at a time, kept by column
+class SHCORE_PUBLIC Parquet_row_group {
+public:
+  explicit Parquet_row_group(const std::vector<Parquet_writer::Column> &columns);
+
+  void append_null(size_t column);
+  void append(size_t column, int64_t value);
+  void append(size_t column, uint64_t value);
+  void append(size_t column, double value);
+  void append(size_t column, const char *data, size_t size);
+
+  // Every column must have a value for the row
+  void end_row() { _rows++; }
+
+  size_t rows() const { return _rows; }
+  size_t data_size() const { return _data_size; }
+
+  void clear();
+
+private:
+  friend class Parquet_writer;
+
+  // Only the values that are not null are kept, the integers and doubles
+  // as their 8 bytes
+  struct Column_data {
+    std::vector<uint8_t> nulls;
+    std::vector<uint64_t> numbers;
+    std::vector<size_t> offsets;
+    std::string data;
+  };
+
+  std::vector<Column_data> _columns;
+  size_t _rows;
+  size_t _data_size;
+};
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_profile.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace shcore {
+std::atomic<bool> Profiler::_enabled(false);
+
+Profiler &Profiler::get() {
+  // Never destroyed, so frames closed at exit can still be accounted
+  static Profiler *instance = new Profiler();
+  return *instance;
+}
+
+void Profiler::start() {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  _thread = std::this_thread::get_id();
+  _stack.clear();
+  _frames.clear();
+  _stacks.clear();
+  _started = std::chrono::steady_clock::now();
+  _elapsed = 0;
+  _enabled = true;
+}
+
+void Profiler::stop() {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  if (!_enabled)
+    return;
+
+  // The frames still open are discarded
+  _enabled = false;
+  _stack.clear();
+  _elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _started).count();
+}
+
+uint64_t Profiler::elapsed() const {
+  if (!_enabled)
+    return _elapsed;
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _started).count();
+}
+
+bool Profiler::enter(const std::string &name) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  if (!_enabled || std::this_thread::get_id() != _thread)
+    return false;
+
+  // Recursive conversions of nested values are accounted to the outer one
+  if (!_stack.empty() && _stack.back().name == name)
+    return false;
+
+  Frame frame;
+  frame.name = name;
+  frame.path = _stack.empty() ? name : _stack.back().path + ";" + name;
+  frame.children = 0;
+  _stack.push_back(frame);
+
+  // Taken last so the bookkeeping above is not accounted to the frame
+  _stack.back().start = std::chrono::steady_clock::now();
+
+  return true;
+}
+
+void Profiler::leave() {
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // Profiling was stopped or restarted while the frame was open
+  if (_stack.empty())
+    return;
+
+  const Frame &frame = _stack.back();
+  uint64_t time = std::chrono::duration_cast<std::chrono::microseconds>(now - frame.start).count();
+  uint64_t self = time > frame.children ? time - frame.children : 0;
+
+  Frame_stats &stats = _frames[frame.name];
+  stats.calls++;
+  stats.self += self;
+
+  // The total of a frame also found below on the stack is already accounted
+  // by that outer call
+  bool nested = false;
+  for (size_t index = 0; index + 1 < _stack.size() && !nested; index++)
+    nested = _stack[index].name == frame.name;
+
+  if (!nested)
+    stats.total += time;
+
+  _stacks[frame.path] += self;
+  _stack.pop_back();
+
+  if (!_stack.empty())
+    _stack.back().children += time;
+}
+
+std::string Profiler::flat_report() {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  std::vector<std::pair<std::string, Frame_stats> > frames(_frames.begin(), _frames.end());
+  std::sort(frames.begin(), frames.end(),
+            [](const std::pair<std::string, Frame_stats> &a, const std::pair<std::string, Frame_stats> &b) {
+              return a.second.self > b.second.self;
+            });
+
+  uint64_t elapsed = this->elapsed();
+  char line[256];
+  std::string ret_val;
+
+  snprintf(line, sizeof(line), "Profiled time: %.3f ms\n\n", elapsed / 1000.0);
+  ret_val += line;
+
+  snprintf(line, sizeof(line), "%12s %7s %12s %10s  %s\n", "self (ms)", "self %", "total (ms)", "calls", "frame");
+  ret_val += line;
+
+  for (auto &frame : frames) {
+    snprintf(line, sizeof(line), "%12.3f %6.1f%% %12.3f %10llu  ", frame.second.self / 1000.0,
+             elapsed ? 100.0 * frame.second.self / elapsed : 0.0, frame.second.total / 1000.0,
+             static_cast<unsigned long long>(frame.second.calls));
+    ret_val += line + frame.first + "\n";
+  }
+
+  return ret_val;
+}
+
+std::string Profiler::collapsed_stacks() {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  std::string ret_val;
+  for (auto &stack : _stacks) {
+    if (stack.second)
+      ret_val += stack.first + " " + std::to_string(stack.second) + "\n";
+  }
+
+  return ret_val;
+}
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_PROFILE_H_
+#define _UTILS_PROFILE_H_
+
+#include "shellcore/common.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace shcore {
+// Profile of the time spent by the shell in its instrumented frames: the
+// statements, the calls from the scripting languages into the native
+// objects, the value conversions and the printing of results. Only the
+// thread that started the profile is accounted.
+class SHCORE_PUBLIC Profiler {
+public:
+  static Profiler &get();
+
+  static bool enabled() { return _enabled; }
+
+  // Clears the previous profile and starts a new one
+  void start();
+  void stop();
+
+  // Returns false if the frame is not accounted: profiling is off, it comes
+  // from another thread or it is a recursion of the current frame
+  bool enter(const std::string &name);
+  void leave();
+
+  // Frames sorted by their self time, with their total time and calls
+  std::string flat_report();
+
+  // One line per stack with its self time in microseconds, in the format
+  // taken by flamegraph.pl: frame;frame;frame time
+  std::string collapsed_stacks();
+
+private:
+  Profiler() : _elapsed(0) {}
+
+  struct Frame {
+    std::string name;
+    std::string path;
+    std::chrono::steady_clock::time_point start;
+    uint64_t children;
+  };
+
+  struct Frame_stats {
+    Frame_stats() : calls(0), total(0), self(0) {}
+
+    uint64_t calls;
+    uint64_t total;
+    uint64_t self;
+  };
+
+  uint64_t elapsed() const;
+
+  static std::atomic<bool> _enabled;
+
+  std::mutex _mutex;
+  std::thread::id _thread;
+  std::vector<Frame> _stack;
+  std::map<std::string, Frame_stats> _frames;
+  std::map<std::string, uint64_t> _stacks;
+  std::chrono::steady_clock::time_point _started;
+  uint64_t _elapsed;
+};
+
+// Accounts the time spent in its scope to the named frame, when profiling
+class Profile_frame {
+public:
+  explicit Profile_frame(const char *name)
+    : _active(Profiler::enabled() && Profiler::get().enter(name)) {}
+  explicit Profile_frame(const std::string &name)
+    : _active(Profiler::enabled() && !name.empty() && Profiler::get().enter(name)) {}
+
+  ~Profile_frame() {
+    if (_active)
+      Profiler::get().leave();
+  }
+
+private:
+  bool _active;
+};
+}
+
+#endif
@@ -20,6 +20,18 @@
 #include "utils_sqlstring.h"
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define SQLSTRING_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SQLSTRING_NEON 1
+#endif
 
 // updated as of 5.7
 static const char *reserved_keywords[] = {
@@ -261,6 +273,109 @@ static const char *reserved_keywords[] = {
 namespace shcore {
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+// The escape sequence character for the byte, 0 if it goes as is
+inline char sql_escape(char ch, bool wildcards) {
+  switch (ch) {
+    case 0:                             /* Must be escaped for 'mysql' */
+      return '0';
+    case '\n':                          /* Must be escaped for logs */
+      return 'n';
+    case '\r':
+      return 'r';
+    case '\\':
+      return '\\';
+    case '\'':
+      return '\'';
+    case '"':                           /* Better safe than sorry */
+      return '"';
+    case '\032':                        /* This gives problems on Win32 */
+      return 'Z';
+    case '_':
+      return wildcards ? '_' : 0;
+    case '%':
+      return wildcards ? '%' : 0;
+  }
+  return 0;
+}
+
+#ifdef SQLSTRING_SSE2
+inline unsigned first_bit(unsigned mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Length of the leading bytes of the data that need no escaping, looked for
+// 16 bytes at a time where the cpu allows it
+size_t clean_span(const char *data, size_t length, bool wildcards) {
+  size_t offset = 0;
+
+#if defined(SQLSTRING_SSE2)
+  const __m128i nul = _mm_setzero_si128();
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i quote = _mm_set1_epi8('\'');
+  const __m128i double_quote = _mm_set1_epi8('"');
+  const __m128i ctrl_z = _mm_set1_epi8('\032');
+  const __m128i underscore = _mm_set1_epi8('_');
+  const __m128i percent = _mm_set1_epi8('%');
+
+  for (; offset + 16 <= length; offset += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, nul), _mm_cmpeq_epi8(chunk, newline)),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage), _mm_cmpeq_epi8(chunk, backslash))),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, double_quote)),
+                     _mm_cmpeq_epi8(chunk, ctrl_z)));
+    if (wildcards)
+      special = _mm_or_si128(special, _mm_or_si128(_mm_cmpeq_epi8(chunk, underscore),
+                                                   _mm_cmpeq_epi8(chunk, percent)));
+
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask)
+      return offset + first_bit(mask);
+  }
+#elif defined(SQLSTRING_NEON)
+  const uint8x16_t nul = vdupq_n_u8(0);
+  const uint8x16_t newline = vdupq_n_u8('\n');
+  const uint8x16_t carriage = vdupq_n_u8('\r');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t quote = vdupq_n_u8('\'');
+  const uint8x16_t double_quote = vdupq_n_u8('"');
+  const uint8x16_t ctrl_z = vdupq_n_u8('\032');
+  const uint8x16_t underscore = vdupq_n_u8('_');
+  const uint8x16_t percent = vdupq_n_u8('%');
+
+  for (; offset + 16 <= length; offset += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(data + offset));
+    uint8x16_t special = vorrq_u8(
+        vorrq_u8(vorrq_u8(vceqq_u8(chunk, nul), vceqq_u8(chunk, newline)),
+                 vorrq_u8(vceqq_u8(chunk, carriage), vceqq_u8(chunk, backslash))),
+        vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, double_quote)),
+                 vceqq_u8(chunk, ctrl_z)));
+    if (wildcards)
+      special = vorrq_u8(special, vorrq_u8(vceqq_u8(chunk, underscore), vceqq_u8(chunk, percent)));
+
+    // The exact position is left to the byte loop below
+    if (vmaxvq_u8(special))
+      break;
+  }
+#endif
+
+  while (offset < length && !sql_escape(data[offset], wildcards))
+    ++offset;
+
+  return offset;
+}
+}
+
 /**
 * Escape a string to be used in a SQL query
 * Same code as used by mysql. Handles null bytes in the middle of the string.
@@ -270,47 +385,25 @@ std::string escape_sql_string(const std::string &s, bool wildcards) {
   std::string result;
   result.reserve(s.size());
 
-  for (std::string::const_iterator ch = s.begin(); ch != s.end(); ++ch) {
-    char escape = 0;
+  append_escaped_sql_string(result, s.data(), s.size(), wildcards);
 
-    switch (*ch) {
-      case 0:                             /* Must be escaped for 'mysql' */
-        escape = '0';
-        break;
-      case '\n':                          /* Must be escaped for logs */
-        escape = 'n';
-        break;
-      case '\r':
-        escape = 'r';
-        break;
-      case '\\':
-        escape = '\\';
-        break;
-      case '\'':
-        escape = '\'';
-        break;
-      case '"':                           /* Better safe than sorry */
-        escape = '"';
-        break;
-      case '\032':                        /* This gives problems on Win32 */
-        escape = 'Z';
-        break;
-      case '_':
-        if (wildcards)
-          escape = '_';
-        break;
-      case '%':
-        if (wildcards)
-          escape = '%';
-        break;
+  return result;
+}
+
+void append_escaped_sql_string(std::string &buffer, const char *data, size_t length, bool wildcards) {
+  size_t offset = 0;
+
+  while (offset < length) {
+    size_t clean = clean_span(data + offset, length - offset, wildcards);
+    buffer.append(data + offset, clean);
+    offset += clean;
+
+    if (offset < length) {
+      buffer.push_back('\\');
+      buffer.push_back(sql_escape(data[offset], wildcards));
+      ++offset;
     }
-    if (escape) {
-      result.push_back('\\');
-      result.push_back(escape);
-    } else
-      result.push_back(*ch);
   }
-  return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -403,41 +496,31 @@ std::string quote_identifier_if_needed(const std::string &ident, const char quot
 const sqlstring sqlstring::null(sqlstring("NULL", 0));
 
 sqlstring::sqlstring(const char* format_string, const sqlstringformat format)
-  : _format_string_left(format_string), _format(format) {
-  append(consume_until_next_escape());
+  : _format_string(format_string), _format_offset(0), _format(format) {
+  _formatted.reserve(_format_string.size());
+  consume_until_next_escape();
 }
 
 sqlstring::sqlstring(const sqlstring &copy)
-  : _formatted(copy._formatted), _format_string_left(copy._format_string_left), _format(copy._format) {}
+  : _formatted(copy._formatted), _format_string(copy._format_string), _format_offset(copy._format_offset),
+    _format(copy._format) {}
 
 sqlstring::sqlstring()
-  : _format(0) {}
+  : _format_offset(0), _format(0) {}
 
-std::string sqlstring::consume_until_next_escape() {
-  std::string::size_type e = _format_string_left.length(), p = 0;
-  while (p < e) {
-    char ch = _format_string_left[p];
-    if (ch == '?' || ch == '!')
-      break;
-    ++p;
-  }
-  if (p > 0) {
-    std::string s = _format_string_left.substr(0, p);
-    if (p < e)
-      _format_string_left = _format_string_left.substr(p);
-    else
-      _format_string_left.clear();
-    return s;
-  }
-  return "";
+void sqlstring::consume_until_next_escape() {
+  std::string::size_type p = _format_string.find_first_of("?!", _format_offset);
+  if (p == std::string::npos)
+    p = _format_string.length();
+
+  _formatted.append(_format_string, _format_offset, p - _format_offset);
+  _format_offset = p;
 }
 
 int sqlstring::next_escape() {
-  if (_format_string_left.empty())
+  if (_format_offset >= _format_string.length())
     throw std::invalid_argument("Error formatting SQL query: more arguments than escapes");
-  int c = _format_string_left[0];
-  _format_string_left = _format_string_left.substr(1);
-  return c;
+  return _format_string[_format_offset++];
 }
 
 sqlstring &sqlstring::append(const std::string &s) {
@@ -445,18 +528,32 @@ sqlstring &sqlstring::append(const std::string &s) {
   return *this;
 }
 
+void sqlstring::append_quoted(const char *data, size_t length) {
+  char quote = (_format._flags & UseAnsiQuotes) ? '"' : '\'';
+
+  _formatted.push_back(quote);
+  append_escaped_sql_string(_formatted, data, length);
+  _formatted.push_back(quote);
+}
+
 sqlstring::operator std::string() const {
-  return _formatted + _format_string_left;
+  return str();
 }
 
 std::string sqlstring::str() const {
-  return _formatted + _format_string_left;
+  std::string ret_val;
+  append_to(ret_val);
+  return ret_val;
+}
+
+void sqlstring::append_to(std::string &buffer) const {
+  buffer.append(_formatted).append(_format_string, _format_offset, std::string::npos);
 }
 
 bool sqlstring::done() const {
-  if (_format_string_left.empty())
+  if (_format_offset >= _format_string.length())
     return true;
-  return _format_string_left[0] != '!' && _format_string_left[0] != '?';
+  return _format_string[_format_offset] != '!' && _format_string[_format_offset] != '?';
 }
 
 sqlstring &sqlstring::operator <<(const double v) {
@@ -465,7 +562,7 @@ sqlstring &sqlstring::operator <<(const double v) {
     throw std::invalid_argument("Error formatting SQL query: invalid escape for numeric argument");
 
   append(boost::lexical_cast<std::string>(v));
-  append(consume_until_next_escape());
+  consume_until_next_escape();
 
   return *this;
 }
@@ -484,13 +581,10 @@ sqlstring &sqlstring::operator <<(const std::string& v) {
     else
       append(quote_identifier(escaped, '`'));
   } else if (esc == '?') {
-    if (_format._flags & UseAnsiQuotes)
-      append("\"").append(escape_sql_string(v)).append("\"");
-    else
-      append("'").append(escape_sql_string(v)).append("'");
+    append_quoted(v.data(), v.size());
   } else // shouldn't happen
     throw std::invalid_argument("Error formatting SQL query: internal error, expected ? or ! escape got something else");
-  append(consume_until_next_escape());
+  consume_until_next_escape();
 
   return *this;
 }
@@ -498,8 +592,8 @@ sqlstring &sqlstring::operator <<(const std::string& v) {
 sqlstring &sqlstring::operator <<(const sqlstring& v) {
   next_escape();
 
-  append(v);
-  append(consume_until_next_escape());
+  v.append_to(_formatted);
+  consume_until_next_escape();
 
   return *this;
 }
@@ -516,16 +610,13 @@ sqlstring &sqlstring::operator <<(const char* v) {
     else
       append("`").append(quoted).append("`");
   } else if (esc == '?') {
-    if (v) {
-      if (_format._flags & UseAnsiQuotes)
-        append("\"").append(escape_sql_string(v)).append("\"");
-      else
-        append("'").append(escape_sql_string(v)).append("'");
-    } else
+    if (v)
+      append_quoted(v, strlen(v));
+    else
       append("NULL");
   } else // shouldn't happen
     throw std::invalid_argument("Error formatting SQL query: internal error, expected ? or ! escape got something else");
-  append(consume_until_next_escape());
+  consume_until_next_escape();
 
   return *this;
 }
@@ -39,6 +39,9 @@ enum SqlStringFlags {
 };
 
 SHCORE_PUBLIC std::string escape_sql_string(const std::string &string, bool wildcards = false); // "strings" or 'strings'
+// Same as escape_sql_string, appending the escaped data to the buffer
+SHCORE_PUBLIC void append_escaped_sql_string(std::string &buffer, const char *data, size_t length,
+                                             bool wildcards = false);
 SHCORE_PUBLIC std::string escape_backticks(const std::string &string);  // `identifier`
 SHCORE_PUBLIC std::string quote_identifier(const std::string& identifier, const char quote_char);
 SHCORE_PUBLIC std::string quote_identifier_if_needed(const std::string &ident, const char quote_char);
@@ -52,13 +55,16 @@ public:
 
 private:
   std::string _formatted;
-  std::string _format_string_left;
+  // The format string is consumed up to the offset
+  std::string _format_string;
+  std::string::size_type _format_offset;
   sqlstringformat _format;
 
-  std::string consume_until_next_escape();
+  void consume_until_next_escape();
   int next_escape();
 
   sqlstring& append(const std::string &s);
+  void append_quoted(const char *data, size_t length);
 public:
   static const sqlstring null;
 
@@ -69,6 +75,8 @@ public:
 
   operator std::string() const;
   std::string str() const;
+  //! appends the formatted string to the buffer, to build large statements without a copy per part
+  void append_to(std::string &buffer) const;
 
   //! modifies formatting options
   sqlstring &operator <<(const sqlstringformat);
@@ -81,7 +89,7 @@ public:
     if (esc != '?')
         throw std::invalid_argument("Error formatting SQL query: invalid escape for numeric argument");
     append(std::to_string(value));
-    append(consume_until_next_escape());
+    consume_until_next_escape();
     return *this;
   }
   //! replaces a ? in the format string with a float numeric value
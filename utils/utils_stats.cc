@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_stats.h"
+#include "utils_file.h"
+#include "shellcore/shell_core_options.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace shcore {
+namespace {
+// Values below 2 * k_sub_buckets have a bucket each, every power of two
+// above is split into k_sub_buckets buckets
+const int k_sub_bucket_bits = 4;
+const uint64_t k_sub_buckets = 1 << k_sub_bucket_bits;
+
+// Values of 2^40 microseconds (12 days) or more go to an extra last bucket
+const int k_max_value_bits = 40;
+const size_t k_bucket_count = 2 * k_sub_buckets + (k_max_value_bits - k_sub_bucket_bits - 1) * k_sub_buckets + 1;
+
+int highest_bit(uint64_t value) {
+  int bit = 0;
+  while (value >>= 1)
+    bit++;
+  return bit;
+}
+
+bool is_identifier_char(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$' ||
+    static_cast<unsigned char>(c) >= 0x80;
+}
+}
+
+const size_t Statement_stats::k_max_digests;
+const size_t Statement_stats::k_max_digest_length;
+
+Latency_histogram::Latency_histogram()
+  : _buckets(k_bucket_count, 0), _count(0), _min(std::numeric_limits<uint64_t>::max()), _max(0), _total(0) {
+}
+
+size_t Latency_histogram::bucket_index(uint64_t value) {
+  if (value < 2 * k_sub_buckets)
+    return static_cast<size_t>(value);
+
+  int bit = highest_bit(value);
+  if (bit >= k_max_value_bits)
+    return k_bucket_count - 1;
+
+  int shift = bit - k_sub_bucket_bits;
+  return static_cast<size_t>(2 * k_sub_buckets + (shift - 1) * k_sub_buckets + ((value >> shift) - k_sub_buckets));
+}
+
+uint64_t Latency_histogram::bucket_upper_bound(size_t index) {
+  if (index < 2 * k_sub_buckets)
+    return index;
+
+  if (index >= k_bucket_count - 1)
+    return std::numeric_limits<uint64_t>::max();
+
+  uint64_t shift = (index - 2 * k_sub_buckets) / k_sub_buckets + 1;
+  uint64_t sub_bucket = (index - 2 * k_sub_buckets) % k_sub_buckets + k_sub_buckets;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void Latency_histogram::record(uint64_t value) {
+  _buckets[bucket_index(value)]++;
+  _count++;
+  _total += value;
+  if (value < _min)
+    _min = value;
+  if (value > _max)
+    _max = value;
+}
+
+uint64_t Latency_histogram::percentile(double percentile) const {
+  if (!_count)
+    return 0;
+
+  uint64_t target = static_cast<uint64_t>(percentile / 100.0 * _count + 0.5);
+  if (target < 1)
+    target = 1;
+
+  uint64_t seen = 0;
+  for (size_t index = 0; index < _buckets.size(); index++) {
+    seen += _buckets[index];
+    if (seen >= target)
+      return std::min(bucket_upper_bound(index), _max);
+  }
+
+  return _max;
+}
+
+Value Latency_histogram::get_stats() const {
+  Value ret_val = Value::new_map();
+  Value::Map_type_ref map = ret_val.as_map();
+
+  (*map)["min"] = Value(min());
+  (*map)["mean"] = Value(mean());
+  (*map)["max"] = Value(max());
+  (*map)["total"] = Value(total());
+  (*map)["p50"] = Value(percentile(50));
+  (*map)["p90"] = Value(percentile(90));
+  (*map)["p99"] = Value(percentile(99));
+  (*map)["p999"] = Value(percentile(99.9));
+
+  return ret_val;
+}
+
+Statement_timing::Statement_timing() {
+  std::memset(phases, 0, sizeof(phases));
+}
+
+Statement_stats &Statement_stats::get() {
+  // Never destroyed, so results released at exit can still be recorded
+  static Statement_stats *instance = new Statement_stats();
+  return *instance;
+}
+
+const char *Statement_stats::phase_name(Statement_timing::Phase phase) {
+  switch (phase) {
+    case Statement_timing::Network:
+      return "network";
+    case Statement_timing::Server:
+      return "server";
+    case Statement_timing::Decode:
+      return "decode";
+    case Statement_timing::Format:
+      return "format";
+    default:
+      return "unknown";
+  }
+}
+
+std::string Statement_stats::digest(const std::string &statement) {
+  std::string result;
+  size_t length = statement.length();
+  size_t index = 0;
+  bool space = false;
+
+  while (index < length && result.length() < k_max_digest_length) {
+    char c = statement[index];
+    char next = index + 1 < length ? statement[index + 1] : '\0';
+    std::string token;
+
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      space = true;
+      index++;
+      continue;
+    } else if (c == '#' || (c == '-' && next == '-' &&
+               (index + 2 >= length || std::isspace(static_cast<unsigned char>(statement[index + 2]))))) {
+      index = statement.find('\n', index);
+      if (index == std::string::npos)
+        index = length;
+      space = true;
+      continue;
+    } else if (c == '/' && next == '*') {
+      index = statement.find("*/", index + 2);
+      index = index == std::string::npos ? length : index + 2;
+      space = true;
+      continue;
+    } else if (c == '\'' || c == '"') {
+      index++;
+      while (index < length) {
+        if (statement[index] == '\\') {
+          index += 2;
+        } else if (statement[index] == c) {
+          index++;
+          // A doubled quote is part of the string
+          if (index >= length || statement[index] != c)
+            break;
+          index++;
+        } else {
+          index++;
+        }
+      }
+      token = "?";
+    } else if (c == '`') {
+      size_t end = statement.find('`', index + 1);
+      end = end == std::string::npos ? length : end + 1;
+      token = statement.substr(index, end - index);
+      index = end;
+    } else if ((std::isdigit(static_cast<unsigned char>(c)) ||
+                (c == '.' && std::isdigit(static_cast<unsigned char>(next)))) &&
+               (result.empty() || space || !is_identifier_char(result[result.length() - 1]))) {
+      while (index < length && (is_identifier_char(statement[index]) || statement[index] == '.' ||
+             ((statement[index] == '+' || statement[index] == '-') &&
+              (statement[index - 1] == 'e' || statement[index - 1] == 'E'))))
+        index++;
+      token = "?";
+    } else if (is_identifier_char(c)) {
+      size_t start = index;
+      while (index < length && is_identifier_char(statement[index]))
+        index++;
+      token = statement.substr(start, index - start);
+    } else {
+      token = std::string(1, c);
+      index++;
+    }
+
+    // Lists of values are collapsed into a single one, so IN lists of a
+    // different size share the digest
+    if (token == "?") {
+      size_t comma = result.find_last_not_of(' ');
+      if (comma != std::string::npos && comma > 0 && result[comma] == ',') {
+        size_t value = result.find_last_not_of(' ', comma - 1);
+        if (value != std::string::npos && result[value] == '?') {
+          result.resize(value + 1);
+          space = false;
+          continue;
+        }
+      }
+    }
+
+    if (space && !result.empty())
+      result.append(" ");
+    result.append(token);
+    space = false;
+  }
+
+  if (result.length() > k_max_digest_length)
+    result.resize(k_max_digest_length);
+
+  return result;
+}
+
+void Statement_stats::record(const Statement_timing &timing) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto digest = _digests.find(timing.digest);
+  if (digest == _digests.end()) {
+    // Once the limit is reached new digests are all accounted together
+    if (_digests.size() >= k_max_digests)
+      digest = _digests.insert(std::make_pair(std::string("(other)"), Digest_stats())).first;
+    else
+      digest = _digests.insert(std::make_pair(timing.digest, Digest_stats())).first;
+  }
+
+  for (int phase = 0; phase < Statement_timing::Phase_count; phase++)
+    digest->second.phases[phase].record(timing.phases[phase]);
+}
+
+Value Statement_stats::get_stats(bool reset) {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  Value ret_val = Value::new_map();
+  Value::Map_type_ref map = ret_val.as_map();
+
+  for (auto &digest : _digests) {
+    Value stats = Value::new_map();
+    Value::Map_type_ref stats_map = stats.as_map();
+
+    (*stats_map)["count"] = Value(digest.second.phases[0].count());
+    for (int phase = 0; phase < Statement_timing::Phase_count; phase++)
+      (*stats_map)[phase_name(Statement_timing::Phase(phase))] = digest.second.phases[phase].get_stats();
+
+    (*map)[digest.first] = stats;
+  }
+
+  if (reset)
+    _digests.clear();
+
+  return ret_val;
+}
+
+const uint64_t Slow_statement_log::k_max_log_size;
+const int Slow_statement_log::k_max_log_files;
+
+Slow_statement_log &Slow_statement_log::get() {
+  // Never destroyed, as the statement stats
+  static Slow_statement_log *instance = new Slow_statement_log();
+  return *instance;
+}
+
+bool Slow_statement_log::enabled() {
+  return Shell_core_options::typed().slow_statement_threshold > 0;
+}
+
+bool Slow_statement_log::explainable(const std::string &statement) {
+  std::string digest = Statement_stats::digest(statement.substr(0, 256));
+  size_t start = digest.find_first_not_of("( ");
+  if (start == std::string::npos)
+    return false;
+  std::string keyword = digest.substr(start, digest.find_first_of(" (", start) - start);
+  std::transform(keyword.begin(), keyword.end(), keyword.begin(), ::tolower);
+
+  return keyword == "select" || keyword == "insert" || keyword == "replace" || keyword == "update" ||
+         keyword == "delete" || keyword == "with" || keyword == "table";
+}
+
+std::string Slow_statement_log::format(const std::string &statement, const Statement_timing &timing, uint64_t rows,
+                                       const std::string &plan) {
+  char now[32];
+  time_t seconds = time(NULL);
+  struct tm utc;
+#ifdef WIN32
+  gmtime_s(&utc, &seconds);
+#else
+  gmtime_r(&seconds, &utc);
+#endif
+  strftime(now, sizeof(now), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+  Value entry = Value::new_map();
+  Value::Map_type_ref map = entry.as_map();
+
+  (*map)["time"] = Value(now);
+  (*map)["statement"] = Value(Statement_stats::digest(statement));
+
+  uint64_t total = 0;
+  for (int phase = 0; phase < Statement_timing::Phase_count; phase++) {
+    (*map)[std::string(Statement_stats::phase_name(Statement_timing::Phase(phase))) + "_us"] = Value(timing.phases[phase]);
+    total += timing.phases[phase];
+  }
+  (*map)["total_us"] = Value(total);
+  (*map)["rows"] = Value(rows);
+
+  // The plan is kept as a document when it is one
+  Value parsed;
+  if (!plan.empty() && plan[0] == '{') {
+    try {
+      parsed = Value::parse(plan);
+    } catch (...) {
+    }
+  }
+  (*map)["explain"] = parsed.type == Map ? parsed : Value(plan);
+
+  return entry.json(false);
+}
+
+void Slow_statement_log::log(const std::string &statement, const Statement_timing &timing, uint64_t rows,
+                             const Explain &explain) {
+  int64_t threshold = Shell_core_options::typed().slow_statement_threshold;
+  if (threshold <= 0)
+    return;
+
+  // Formatting the result is up to the shell, not the statement
+  uint64_t elapsed = timing.phases[Statement_timing::Server] + timing.phases[Statement_timing::Network] +
+                     timing.phases[Statement_timing::Decode];
+  if (elapsed < static_cast<uint64_t>(threshold) * 1000)
+    return;
+
+  std::string plan;
+  if (!explain || !explainable(statement)) {
+    plan = "not explainable";
+  } else {
+    try {
+      plan = explain(statement);
+    } catch (std::exception &e) {
+      plan = std::string("EXPLAIN failed: ") + e.what();
+    }
+  }
+
+  write(format(statement, timing, rows, plan));
+}
+
+void Slow_statement_log::write(const std::string &line) {
+  std::string path = (*Shell_core_options::get())[SHCORE_SLOW_STATEMENT_LOG].as_string();
+  if (path.empty())
+    path = get_user_config_path() + "slow_statements.log";
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  FILE *file = fopen(path.c_str(), "a");
+  if (!file)
+    return;
+
+  fwrite(line.data(), 1, line.size(), file);
+  fputc('\n', file);
+  long size = ftell(file);
+  fclose(file);
+
+  // The oldest file goes away, the others move one place up
+  if (size >= 0 && static_cast<uint64_t>(size) >= k_max_log_size) {
+    std::remove((path + "." + std::to_string(k_max_log_files - 1)).c_str());
+    for (int index = k_max_log_files - 2; index > 0; index--)
+      std::rename((path + "." + std::to_string(index)).c_str(), (path + "." + std::to_string(index + 1)).c_str());
+    std::rename(path.c_str(), (path + ".1").c_str());
+  }
+}
+}
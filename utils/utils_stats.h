@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_STATS_H_
+#define _UTILS_STATS_H_
+
+#include "shellcore/types_common.h"
+#include "shellcore/types.h"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace shcore {
+// Histogram of latencies in microseconds with log-linear buckets: every power
+// of two range is split in 16 buckets, so the values reported are within 6%
+// of the recorded ones, whatever their magnitude
+class SHCORE_PUBLIC Latency_histogram {
+public:
+  Latency_histogram();
+
+  void record(uint64_t value);
+
+  uint64_t count() const { return _count; }
+  uint64_t min() const { return _count ? _min : 0; }
+  uint64_t max() const { return _max; }
+  uint64_t total() const { return _total; }
+  double mean() const { return _count ? double(_total) / _count : 0.0; }
+
+  // Highest value equivalent to the one at the given percentile (0 to 100)
+  uint64_t percentile(double percentile) const;
+
+  Value get_stats() const;
+
+  static size_t bucket_index(uint64_t value);
+  static uint64_t bucket_upper_bound(size_t index);
+
+private:
+  std::vector<uint64_t> _buckets;
+  uint64_t _count;
+  uint64_t _min;
+  uint64_t _max;
+  uint64_t _total;
+};
+
+// Times spent by a statement in each phase, in microseconds:
+// - Server: from sending the statement until its first response is read
+// - Network: waiting for the rest of the result to be read
+// - Decode: converting the rows into shell values
+// - Format: printing the result, excluding the time fetching it
+struct SHCORE_PUBLIC Statement_timing {
+  enum Phase {
+    Network,
+    Server,
+    Decode,
+    Format,
+    Phase_count
+  };
+
+  Statement_timing();
+
+  std::string digest;
+  uint64_t phases[Phase_count];
+};
+
+// Process wide latency histograms of the SQL statements executed by the
+// shell, grouped by statement digest
+class SHCORE_PUBLIC Statement_stats {
+public:
+  static const size_t k_max_digests = 1000;
+  static const size_t k_max_digest_length = 1024;
+
+  static Statement_stats &get();
+
+  // The statement with literals replaced by '?', comments removed and the
+  // whitespace collapsed, so executions of the same statement are grouped
+  static std::string digest(const std::string &statement);
+
+  static const char *phase_name(Statement_timing::Phase phase);
+
+  void record(const Statement_timing &timing);
+
+  // Returns the stats of every digest, clearing them if reset is true
+  Value get_stats(bool reset = false);
+
+private:
+  struct Digest_stats {
+    Latency_histogram phases[Statement_timing::Phase_count];
+  };
+
+  std::mutex _mutex;
+  std::map<std::string, Digest_stats> _digests;
+};
+
+// Statements that took longer than the slowStatementThreshold option to
+// run and read, written to the slowStatementLog file as a JSON document per
+// line: the digest of the statement, so its values are not logged, the time
+// of each phase, the rows read and the plan of the statement
+class SHCORE_PUBLIC Slow_statement_log {
+public:
+  static const uint64_t k_max_log_size = 10 * 1024 * 1024;
+  // The current file and the rotated ones, .1 being the newest
+  static const int k_max_log_files = 5;
+
+  // Returns the plan of the statement as JSON, run on a session other than
+  // the one of the statement, which may be busy or gone
+  typedef std::function<std::string(const std::string &statement)> Explain;
+
+  static Slow_statement_log &get();
+
+  // Whether the statements are being watched, so the callers keep what
+  // log() needs only while they are
+  static bool enabled();
+
+  // Writes the statement if it was slow, explaining it if it can be
+  void log(const std::string &statement, const Statement_timing &timing, uint64_t rows, const Explain &explain);
+
+  // Statements that EXPLAIN accepts
+  static bool explainable(const std::string &statement);
+
+  // The line logged for the statement, plan being the JSON given by EXPLAIN
+  // or an error message
+  static std::string format(const std::string &statement, const Statement_timing &timing, uint64_t rows,
+                            const std::string &plan);
+
+private:
+  void write(const std::string &line);
+
+  std::mutex _mutex;
+};
+
+// Adds the microseconds spent in its scope to the given counter
+class Phase_timer {
+public:
+  explicit Phase_timer(uint64_t &target)
+    : _target(target), _start(std::chrono::steady_clock::now()) {}
+  ~Phase_timer() { _target += elapsed(); }
+
+  uint64_t elapsed() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count();
+  }
+
+private:
+  uint64_t &_target;
+  std::chrono::steady_clock::time_point _start;
+};
+}
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "utils_trace.h"
+#include "utils_json.h"
+#include "utils_file.h"
+#include "logger/logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace shcore {
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+struct Span_record {
+  std::string name;
+  uint64_t id;
+  uint64_t parent;
+  Clock::time_point start;
+  Clock::time_point end;
+  std::vector<std::pair<std::string, std::string>> attributes;
+};
+
+// Only the thread of the buffer adds to it, the lock is taken by the
+// session when collecting the spans, so it is never waited on otherwise
+struct Buffer {
+  explicit Buffer(unsigned thread) : thread(thread) {}
+
+  std::mutex mutex;
+  unsigned thread;
+  std::vector<Span_record> spans;
+};
+
+// 0 while no session is open
+std::atomic<unsigned> current_session(0);
+std::atomic<unsigned> last_session(0);
+std::atomic<uint64_t> next_span(0);
+std::atomic<unsigned> next_thread(0);
+
+std::mutex buffers_mutex;
+std::vector<std::shared_ptr<Buffer>> buffers;
+Clock::time_point session_start;
+
+struct Thread_state {
+  Thread_state() : session(0), current(0) {}
+
+  // The buffer of the session it was created on, replaced on the next one
+  std::shared_ptr<Buffer> buffer;
+  unsigned session;
+  uint64_t current;
+};
+
+thread_local Thread_state thread_state;
+
+Buffer *buffer_of(unsigned session) {
+  if (thread_state.session != session) {
+    thread_state.buffer.reset(new Buffer(++next_thread));
+    thread_state.session = session;
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    buffers.push_back(thread_state.buffer);
+  }
+
+  return thread_state.buffer.get();
+}
+
+int64_t microseconds(Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+}
+
+Trace_span::Trace_span(const char *name) : _id(0), _previous(0), _session(0), _index(0) {
+  if (current_session.load(std::memory_order_relaxed))
+    start(name, thread_state.current);
+}
+
+Trace_span::Trace_span(const char *name, uint64_t parent) : _id(0), _previous(0), _session(0), _index(0) {
+  if (current_session.load(std::memory_order_relaxed))
+    start(name, parent);
+}
+
+void Trace_span::start(const char *name, uint64_t parent) {
+  unsigned session = current_session.load();
+  if (!session)
+    return;
+
+  Buffer *buffer = buffer_of(session);
+
+  Span_record span;
+  span.name = name;
+  span.id = _id = ++next_span;
+  span.parent = parent;
+  span.start = Clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    _index = buffer->spans.size();
+    buffer->spans.push_back(std::move(span));
+  }
+
+  _session = session;
+  _previous = thread_state.current;
+  thread_state.current = _id;
+}
+
+Trace_span::~Trace_span() {
+  if (!_id)
+    return;
+
+  thread_state.current = _previous;
+
+  // The session may have ended, and another started, meanwhile
+  if (thread_state.session == _session) {
+    Buffer *buffer = thread_state.buffer.get();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (_index < buffer->spans.size())
+      buffer->spans[_index].end = Clock::now();
+  }
+}
+
+void Trace_span::set(const char *key, const std::string &value) {
+  if (!_id || thread_state.session != _session)
+    return;
+
+  Buffer *buffer = thread_state.buffer.get();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  if (_index < buffer->spans.size())
+    buffer->spans[_index].attributes.emplace_back(key, value);
+}
+
+uint64_t Trace_span::current() {
+  return thread_state.current;
+}
+
+Trace_session::Trace_session(const std::string &path) : _path(path), _owner(false) {
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  if (current_session.load())
+    return;
+
+  buffers.clear();
+  session_start = Clock::now();
+  current_session = ++last_session;
+  _owner = true;
+}
+
+Trace_session::~Trace_session() {
+  if (!_owner)
+    return;
+
+  std::vector<std::shared_ptr<Buffer>> recorded;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    current_session = 0;
+    recorded.swap(buffers);
+  }
+
+  std::ofstream file(_path, std::ofstream::trunc);
+  if (!file.good()) {
+    log_warning("Unable to write the trace to '%s': %s", _path.c_str(), get_last_error().c_str());
+    return;
+  }
+
+  // Complete events, the spans still open end now
+  auto now = Clock::now();
+  JSON_dumper dumper(false, [&file](const std::string &chunk) { file << chunk; });
+  dumper.start_object();
+  dumper.append_string("traceEvents");
+  dumper.start_array();
+  for (auto &buffer : recorded) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    for (auto &span : buffer->spans) {
+      auto end = span.end == Clock::time_point() ? now : span.end;
+
+      dumper.start_object();
+      dumper.append_string("name", span.name);
+      dumper.append_string("cat", "mysqlsh");
+      dumper.append_string("ph", "X");
+      dumper.append_int64("ts", microseconds(span.start - session_start));
+      dumper.append_int64("dur", microseconds(end - span.start));
+      dumper.append_int("pid", 1);
+      dumper.append_uint("tid", buffer->thread);
+      dumper.append_string("args");
+      dumper.start_object();
+      dumper.append_uint64("id", span.id);
+      if (span.parent)
+        dumper.append_uint64("parent", span.parent);
+      for (auto &attribute : span.attributes)
+        dumper.append_string(attribute.first, attribute.second);
+      dumper.end_object();
+      dumper.end_object();
+    }
+  }
+  dumper.end_array();
+  dumper.end_object();
+  dumper.flush();
+
+  if (!file.good())
+    log_warning("Unable to write the trace to '%s': %s", _path.c_str(), get_last_error().c_str());
+}
+
+bool Trace_session::active() {
+  return current_session.load() != 0;
+}
+}
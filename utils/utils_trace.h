@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _UTILS_TRACE_H_
+#define _UTILS_TRACE_H_
+
+#include "shellcore/common.h"
+
+#include <cstdint>
+#include <string>
+
+namespace shcore {
+// A timed step of an operation, like a query or a child process. Spans are
+// only recorded while a Trace_session is open, otherwise creating one costs
+// an atomic load. Each thread records into a buffer of its own, the spans
+// nest in the one open on the same thread when they start.
+class SHCORE_PUBLIC Trace_span {
+public:
+  explicit Trace_span(const char *name);
+  explicit Trace_span(const std::string &name) : Trace_span(name.c_str()) {}
+  // For the spans of a thread started by the operation, whose parent is on
+  // another thread
+  Trace_span(const char *name, uint64_t parent);
+  ~Trace_span();
+
+  bool recording() const { return _id != 0; }
+  uint64_t id() const { return _id; }
+
+  void set(const char *key, const std::string &value);
+
+  // The span open on this thread, 0 if none
+  static uint64_t current();
+
+private:
+  Trace_span(const Trace_span &) = delete;
+  Trace_span &operator = (const Trace_span &) = delete;
+
+  void start(const char *name, uint64_t parent);
+
+  uint64_t _id;
+  uint64_t _previous;
+  // Where the span is on the buffer of the thread, of the session open
+  // when it started
+  unsigned _session;
+  size_t _index;
+};
+
+// Records the spans of the threads while open, and writes them to the file
+// as a Chrome trace (chrome://tracing, Perfetto) when closed. Sessions do
+// not nest, the inner ones are ignored.
+class SHCORE_PUBLIC Trace_session {
+public:
+  explicit Trace_session(const std::string &path);
+  ~Trace_session();
+
+  static bool active();
+
+private:
+  Trace_session(const Trace_session &) = delete;
+  Trace_session &operator = (const Trace_session &) = delete;
+
+  std::string _path;
+  bool _owner;
+};
+}
+
+#endif